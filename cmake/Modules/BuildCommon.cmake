@@ -334,7 +334,7 @@ if (KATANA_STRICT_CONFIG)
   endif ()
 endif ()
 
-find_package(Boost 1.58.0 REQUIRED COMPONENTS filesystem serialization iostreams)
+find_package(Boost 1.58.0 REQUIRED COMPONENTS filesystem serialization)
 
 find_package(mongoc-1.0 1.6)
 if (NOT mongoc-1.0_FOUND)
@@ -386,6 +386,19 @@ else()
   add_library(arrow::python ALIAS arrow_python_shared)
 endif()
 
+if(TARGET arrow::arrow)
+  if(NOT TARGET arrow::flight)
+    message(STATUS "Library Arrow Flight not found, not building the Flight server")
+  endif()
+else()
+  find_package(ArrowFlight QUIET HINTS ${ARROW_CONFIG_DIR})
+  if(ArrowFlight_FOUND)
+    add_library(arrow::flight ALIAS arrow_flight_shared)
+  else()
+    message(STATUS "Library Arrow Flight not found, not building the Flight server")
+  endif()
+endif()
+
 # Testing-only dependencies
 if (CMAKE_PROJECT_NAME STREQUAL PROJECT_NAME AND cpp IN_LIST KATANA_LANG_TESTING)
   find_package(benchmark REQUIRED)
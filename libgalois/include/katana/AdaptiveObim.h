@@ -0,0 +1,189 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ADAPTIVEOBIM_H_
+#define KATANA_LIBGALOIS_KATANA_ADAPTIVEOBIM_H_
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+#include "katana/Chunk.h"
+#include "katana/Obim.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/WorkListHelpers.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/**
+ * Approximate priority scheduling like \ref OrderedByIntegerMetric, but the
+ * width of the priority buckets adapts to the work the threads find in them
+ * instead of being fixed up front, e.g., by the delta of delta stepping.
+ *
+ * Items with priorities p in [k, k + 2^shift) share the bucket k. Threads
+ * count the items they pop from each bucket; when, on average, a thread
+ * finds fewer than MinWork items in a bucket, the buckets are too narrow
+ * and threads spend their time moving between buckets, so shift grows. With
+ * more than MaxWork items, the buckets are too wide and many items are
+ * processed out of order, so shift shrinks. Buckets are keyed by their
+ * lowest priority, so buckets of different widths stay ordered.
+ *
+ * Indexer returns the unscaled integer priority of an item, i.e., it should
+ * not divide by a delta itself; pass the initial shift to the constructor
+ * instead.
+ *
+ * @tparam Indexer    Indexer class
+ * @tparam Container  Scheduler for each bucket
+ * @tparam MinWork    Widen buckets below this many items per thread
+ * @tparam MaxWork    Narrow buckets above this many items per thread
+ */
+template <
+    class Indexer = DummyIndexer<int>,
+    typename Container = PerSocketChunkFIFO<>, unsigned MinWork = 64,
+    unsigned MaxWork = 1024, typename T = int, typename Index = unsigned,
+    bool Concurrent = true>
+class AdaptiveOrderedByIntegerMetric {
+  static_assert(
+      std::is_integral<Index>::value, "only integral index types supported");
+  static_assert(MinWork < MaxWork, "MinWork must be less than MaxWork");
+
+public:
+  template <typename _T>
+  using retype = AdaptiveOrderedByIntegerMetric<
+      Indexer, typename Container::template retype<_T>, MinWork, MaxWork, _T,
+      typename std::result_of<Indexer(_T)>::type, Concurrent>;
+
+  template <bool _b>
+  using rethread = AdaptiveOrderedByIntegerMetric<
+      Indexer, Container, MinWork, MaxWork, T, Index, _b>;
+
+  template <typename _container>
+  struct with_container {
+    typedef AdaptiveOrderedByIntegerMetric<
+        Indexer, _container, MinWork, MaxWork, T, Index, Concurrent>
+        type;
+  };
+
+  template <typename _indexer>
+  struct with_indexer {
+    typedef AdaptiveOrderedByIntegerMetric<
+        _indexer, Container, MinWork, MaxWork, T, Index, Concurrent>
+        type;
+  };
+
+  typedef T value_type;
+  typedef Index index_type;
+
+  //! largest shift, so that bucket keys remain valid indices
+  static constexpr unsigned kMaxShift = std::numeric_limits<Index>::digits - 1;
+
+private:
+  //! buckets a thread drains before it reconsiders the bucket width
+  static constexpr unsigned kWindow = 16;
+
+  //! maps the priority of an item to the key of its current bucket
+  struct BucketIndexer {
+    Indexer indexer;
+    const std::atomic<unsigned>* shift;
+
+    Index operator()(const T& val) {
+      Index p = indexer(val);
+      unsigned s = shift->load(std::memory_order_relaxed);
+      Index mask = static_cast<Index>((Index{1} << s) - 1);
+      return p & static_cast<Index>(~mask);
+    }
+  };
+
+  struct ThreadData {
+    Index key{};
+    //! items popped from the bucket key so far
+    size_t pops{0};
+    //! buckets and items of the current window
+    size_t buckets{0};
+    size_t items{0};
+    unsigned windowShift{0};
+  };
+
+  std::atomic<unsigned> shift_;
+  BucketIndexer key_;
+  OrderedByIntegerMetric<
+      BucketIndexer, Container, 0, true, T, Index, false, false, false,
+      Concurrent>
+      wl_;
+  PerThreadStorage<ThreadData> data_;
+
+  void adapt(ThreadData& p) {
+    size_t avg = p.items / p.buckets;
+    unsigned s = p.windowShift;
+    // only adapt if no other thread did during the window, so that threads
+    // reaching the same verdict change the width by one step, not many
+    if (avg < MinWork && s < kMaxShift) {
+      shift_.compare_exchange_strong(s, s + 1, std::memory_order_relaxed);
+    } else if (avg > MaxWork && s > 0) {
+      shift_.compare_exchange_strong(s, s - 1, std::memory_order_relaxed);
+    }
+    p.buckets = 0;
+    p.items = 0;
+    p.windowShift = shift_.load(std::memory_order_relaxed);
+  }
+
+  void observe(const T& item) {
+    ThreadData& p = *data_.getLocal();
+    Index key = key_(item);
+    if (p.pops && key == p.key) {
+      ++p.pops;
+      return;
+    }
+    if (p.pops) {
+      p.items += p.pops;
+      if (++p.buckets == kWindow) {
+        adapt(p);
+      }
+    } else {
+      p.windowShift = shift_.load(std::memory_order_relaxed);
+    }
+    p.key = key;
+    p.pops = 1;
+  }
+
+public:
+  AdaptiveOrderedByIntegerMetric(
+      const Indexer& x = Indexer(), unsigned initial_shift = 0)
+      : shift_(std::min(initial_shift, kMaxShift)),
+        key_{x, &shift_},
+        wl_(key_) {}
+
+  AdaptiveOrderedByIntegerMetric(const AdaptiveOrderedByIntegerMetric&) =
+      delete;
+  AdaptiveOrderedByIntegerMetric& operator=(
+      const AdaptiveOrderedByIntegerMetric&) = delete;
+
+  //! \returns log2 of the current bucket width
+  unsigned shift() const { return shift_.load(std::memory_order_relaxed); }
+
+  void push(const value_type& val) { wl_.push(val); }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    wl_.push(b, e);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    wl_.push_initial(range);
+  }
+
+  std::optional<value_type> pop() {
+    std::optional<value_type> item = wl_.pop();
+    if (item) {
+      observe(*item);
+    }
+    return item;
+  }
+};
+KATANA_WLCOMPILECHECK(AdaptiveOrderedByIntegerMetric)
+
+}  // namespace katana
+
+#endif
@@ -82,6 +82,9 @@ public:
     for (unsigned int i = 0; i < heaps.size(); i++)
       heaps.getRemote(i)->clear();
   }
+
+  //! clear only the heap of the calling thread
+  void clearLocal() { heaps.getLocal()->clear(); }
 };
 
 //! Apply a lock to a heap
@@ -997,6 +1000,26 @@ public:
   SerialNumaAllocator() : Super(&heap) {}
 };
 
+/**
+ * Per-thread bump allocation for the temporaries of a round of an
+ * algorithm, e.g., the maps of neighboring communities that Louvain
+ * clustering builds for each node. Memory is not freed piecewise; clear
+ * releases everything allocated by all threads and clearLocal everything
+ * allocated by the calling thread. Released blocks stay on per-thread free
+ * lists, so later rounds reuse them without malloc contention or page
+ * faults.
+ *
+ * Containers use it through \ref PerThreadArenaAllocator and must be gone
+ * before the memory that they use is cleared.
+ */
+class PerThreadArena
+    : public ThreadPrivateHeap<BumpWithMallocHeap<FreeListHeap<SystemHeap>>> {
+};
+
+//! STL allocator that allocates from the arena of the calling thread
+template <typename T>
+using PerThreadArenaAllocator = ExternalHeapAllocator<T, PerThreadArena>;
+
 }  // end namespace katana
 
 #endif
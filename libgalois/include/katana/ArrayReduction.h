@@ -0,0 +1,165 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ARRAYREDUCTION_H_
+#define KATANA_LIBGALOIS_KATANA_ARRAYREDUCTION_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/**
+ * Sums per-index contributions into an array of values, e.g., the in-degree
+ * of every node or the total weight of every community, without a
+ * per-thread copy of the array as a Reducible of vectors would need.
+ *
+ * Each thread combines its updates in a direct-mapped cache of CacheSize
+ * (index, value) slots. A slot counts the updates it has combined; an
+ * update to another index that maps to the slot only takes it over once
+ * such misses have used up that count, and is otherwise added to the shared
+ * array with an atomic add. A stream of distinct indices thus costs one
+ * atomic add per update, as without the cache, but cannot push hot
+ * indices, such as the hubs of a power-law graph, out of the cache, so
+ * those rarely touch the shared array. An array with at most CacheSize
+ * indices, such as a histogram, is only touched by reduce. Memory is
+ * O(size + threads * CacheSize).
+ *
+ * The values may only be read after reduce, outside of parallel regions.
+ *
+ * @tparam T          Value type; must support + and katana::atomicAdd
+ * @tparam CacheSize  Slots per thread, a power of two
+ */
+template <typename T, size_t CacheSize = 1024>
+class GArrayAccumulator {
+  static_assert(
+      CacheSize > 0 && (CacheSize & (CacheSize - 1)) == 0,
+      "CacheSize must be a power of two");
+
+  static constexpr size_t kEmpty = std::numeric_limits<size_t>::max();
+
+  struct Slot {
+    size_t index{kEmpty};
+    //! updates combined into value, less the misses since
+    uint32_t hits{0};
+    T value{};
+  };
+
+  katana::NUMAArray<std::atomic<T>> data_;
+  //! allocated by each thread on its first update, so that the cache is
+  //! local to the thread
+  katana::PerThreadStorage<std::unique_ptr<Slot[]>> caches_;
+
+  Slot* getCache() {
+    std::unique_ptr<Slot[]>& cache = *caches_.getLocal();
+    if (!cache) {
+      cache = std::make_unique<Slot[]>(CacheSize);
+    }
+    return cache.get();
+  }
+
+public:
+  using value_type = T;
+
+  explicit GArrayAccumulator(size_t size) {
+    data_.allocateInterleaved(size);
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t i) { data_.constructAt(i, T{}); }, katana::no_stats());
+  }
+
+  GArrayAccumulator(const GArrayAccumulator&) = delete;
+  GArrayAccumulator& operator=(const GArrayAccumulator&) = delete;
+
+  size_t size() const { return data_.size(); }
+
+  /// Adds value to the element index
+  void update(size_t index, const T& value) {
+    KATANA_LOG_DEBUG_ASSERT(index < data_.size());
+    Slot& slot = getCache()[index & (CacheSize - 1)];
+    if (slot.index == index) {
+      slot.value = slot.value + value;
+      if (slot.hits < std::numeric_limits<uint32_t>::max()) {
+        ++slot.hits;
+      }
+      return;
+    }
+    if (slot.hits > 0) {
+      --slot.hits;
+      katana::atomicAdd(data_[index], value);
+      return;
+    }
+    if (slot.index != kEmpty) {
+      katana::atomicAdd(data_[slot.index], slot.value);
+    }
+    slot.index = index;
+    slot.value = value;
+  }
+
+  /**
+   * Adds the values left in the caches of all threads to the array. Only
+   * valid outside the parallel region.
+   *
+   * @returns *this, to read the reduced elements
+   */
+  GArrayAccumulator& reduce() {
+    for (unsigned i = 0; i < caches_.size(); ++i) {
+      Slot* cache = caches_.getRemote(i)->get();
+      if (!cache) {
+        continue;
+      }
+      for (size_t s = 0; s < CacheSize; ++s) {
+        if (cache[s].index != kEmpty) {
+          katana::atomicAdd(data_[cache[s].index], cache[s].value);
+          cache[s] = Slot{};
+        }
+      }
+    }
+    return *this;
+  }
+
+  /// \returns the element index; only valid after reduce
+  T operator[](size_t index) const {
+    return data_[index].load(std::memory_order_relaxed);
+  }
+
+  void reset() {
+    for (unsigned i = 0; i < caches_.size(); ++i) {
+      Slot* cache = caches_.getRemote(i)->get();
+      if (cache) {
+        std::fill(cache, cache + CacheSize, Slot{});
+      }
+    }
+    katana::do_all(
+        katana::iterate(size_t{0}, data_.size()),
+        [&](size_t i) { data_[i].store(T{}, std::memory_order_relaxed); },
+        katana::no_stats());
+  }
+};
+
+/**
+ * Counts occurrences of bins, e.g., of the labels of the neighbors of a node
+ * or of node degrees. With no more than CacheSize bins, each thread counts
+ * in its own cache until reduce; with more, see \ref GArrayAccumulator.
+ */
+template <size_t CacheSize = 1024>
+class GHistogram : public GArrayAccumulator<uint64_t, CacheSize> {
+  using base_type = GArrayAccumulator<uint64_t, CacheSize>;
+
+public:
+  explicit GHistogram(size_t num_bins) : base_type(num_bins) {}
+
+  using base_type::update;
+
+  void update(size_t bin) { base_type::update(bin, 1); }
+};
+
+}  // namespace katana
+
+#endif
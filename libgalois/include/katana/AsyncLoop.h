@@ -0,0 +1,146 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ASYNCLOOP_H_
+#define KATANA_LIBGALOIS_KATANA_ASYNCLOOP_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/WorkList.h"
+#include "katana/config.h"
+
+namespace katana {
+
+template <typename T>
+class AsyncContext;
+
+namespace internal {
+
+template <typename T>
+struct AsyncLoopState {
+  struct Pending {
+    virtual ~Pending() = default;
+    virtual bool WaitFor(std::chrono::microseconds timeout) = 0;
+    virtual void Resume(AsyncContext<T>& ctx) = 0;
+  };
+
+  template <typename U, typename Fn>
+  struct PendingOp : public Pending {
+    std::future<U> future;
+    Fn then;
+
+    PendingOp(std::future<U>&& f, Fn&& fn)
+        : future(std::move(f)), then(std::move(fn)) {}
+
+    bool WaitFor(std::chrono::microseconds timeout) override {
+      return future.wait_for(timeout) == std::future_status::ready;
+    }
+    void Resume(AsyncContext<T>& ctx) override { then(future.get(), ctx); }
+  };
+
+  PerSocketChunkFIFO<8, T> items;
+  //! operations each thread waits for; only touched by that thread
+  PerThreadStorage<std::vector<std::unique_ptr<Pending>>> pending;
+  //! items not yet processed plus operations not yet resumed
+  std::atomic<uint64_t> outstanding{0};
+};
+
+}  // namespace internal
+
+/// The context an operator of ForEachAsync gets with each item
+template <typename T>
+class AsyncContext {
+public:
+  /// Add item to the loop
+  void push(const T& item) {
+    state_->outstanding.fetch_add(1);
+    state_->items.push(item);
+  }
+
+  /// Call then(future.get(), *this) on this thread once future is ready,
+  /// instead of blocking on it; meanwhile the thread processes other items
+  template <typename U, typename Fn>
+  void Await(std::future<U> future, Fn then) {
+    using Op = typename internal::AsyncLoopState<T>::template PendingOp<U, Fn>;
+    state_->outstanding.fetch_add(1);
+    state_->pending.getLocal()->emplace_back(
+        std::make_unique<Op>(std::move(future), std::move(then)));
+  }
+
+private:
+  template <typename Range, typename Fn, typename... Args>
+  friend void ForEachAsync(const Range& range, Fn fn, Args&&... args);
+
+  explicit AsyncContext(internal::AsyncLoopState<T>* state) : state_(state) {}
+
+  internal::AsyncLoopState<T>* state_;
+};
+
+/// Unordered loop whose operator can wait for asynchronous operations, such
+/// as the futures of FileGetAsync, FileStoreAsync or FileStorage::PutAsync,
+/// without blocking its thread, so that I/O overlaps with computation.
+///
+/// fn(item, ctx) is called for each item of range and each item pushed
+/// with ctx.push. Instead of waiting on a future, fn passes it with a
+/// continuation to ctx.Await; the continuation runs on the same thread once
+/// the future is ready and may push items and await futures in turn. A
+/// thread only blocks on its futures when it has no items to process. The
+/// loop returns when no items are left and all continuations ran.
+///
+/// args are loop options for on_each, e.g., katana::loopname.
+template <typename Range, typename Fn, typename... Args>
+void
+ForEachAsync(const Range& range, Fn fn, Args&&... args) {
+  using T = typename Range::value_type;
+  using Pending = typename internal::AsyncLoopState<T>::Pending;
+  // short enough to notice new items quickly, long enough to not spin
+  constexpr std::chrono::microseconds kWaitTimeout{50};
+
+  internal::AsyncLoopState<T> state;
+  // count all initial items up front, so that no thread sees the loop as
+  // finished before every thread pushed its share
+  state.outstanding = std::distance(range.begin(), range.end());
+
+  katana::on_each(
+      [&](unsigned, unsigned) {
+        state.items.push(range.local_begin(), range.local_end());
+        AsyncContext<T> ctx(&state);
+        auto& mine = *state.pending.getLocal();
+
+        while (state.outstanding.load() != 0) {
+          // resume continuations whose operations completed
+          for (size_t i = 0; i < mine.size();) {
+            if (!mine[i]->WaitFor(std::chrono::microseconds(0))) {
+              ++i;
+              continue;
+            }
+            std::unique_ptr<Pending> op = std::move(mine[i]);
+            mine[i] = std::move(mine.back());
+            mine.pop_back();
+            op->Resume(ctx);
+            state.outstanding.fetch_sub(1);
+          }
+
+          if (auto item = state.items.pop()) {
+            fn(*item, ctx);
+            state.outstanding.fetch_sub(1);
+          } else if (!mine.empty()) {
+            mine.front()->WaitFor(kWaitTimeout);
+          } else {
+            std::this_thread::yield();
+          }
+        }
+      },
+      std::forward<Args>(args)...);
+}
+
+}  // namespace katana
+
+#endif
@@ -21,13 +21,16 @@
 #define KATANA_LIBGALOIS_KATANA_BAG_H_
 
 #include <algorithm>
+#include <cstddef>
 #include <stdexcept>
+#include <vector>
 
 #include <boost/iterator/iterator_facade.hpp>
 
 #include "katana/Executor_OnEach.h"
 #include "katana/Mem.h"
 #include "katana/PerThreadStorage.h"
+#include "katana/Range.h"
 #include "katana/config.h"
 #include "katana/gIO.h"
 #include "katana/gstl.h"
@@ -37,6 +40,13 @@ namespace katana {
 /**
  * Unordered collection of elements. This data structure supports scalable
  * concurrent pushes but reading the bag can only be done serially.
+ *
+ * Each thread pushes into blocks of its own, taken from its per-thread page
+ * pool (or the FixedSizeHeap when BlockSize is given), so blocks are on the
+ * NUMA node of the thread that filled them. Iterating with
+ * katana::iterate(bag) gives each thread the blocks it pushed; use
+ * katana::iterate(bag.Blocks()) to split the elements evenly among threads
+ * instead, e.g., when a few threads pushed most of them.
  */
 template <typename T, unsigned int BlockSize = 0>
 class InsertBag {
@@ -121,6 +131,115 @@ public:
     }
   };
 
+  /**
+   * A snapshot of the blocks of a bag as one random access range. Parallel
+   * loops over it split the elements evenly and steal in constant time
+   * regardless of which threads pushed them. Pushing to the bag may make
+   * the snapshot miss elements; removing elements invalidates it.
+   */
+  template <typename U>
+  class BlockRange {
+    struct Span {
+      U* begin;
+      U* end;
+      //! position of begin in the range
+      size_t offset;
+    };
+
+    //! the non-empty blocks of the bag
+    std::vector<Span> spans_;
+    size_t size_{};
+
+  public:
+    class Iterator
+        : public boost::iterator_facade<
+              Iterator, U, boost::random_access_traversal_tag> {
+      friend class boost::iterator_core_access;
+
+      const BlockRange* range_{};
+      size_t block_{};
+      U* v_{};
+      size_t pos_{};
+
+      void seek(size_t pos) {
+        pos_ = pos;
+        const std::vector<Span>& spans = range_->spans_;
+        if (spans.empty()) {
+          return;
+        }
+        if (pos >= range_->size_) {
+          block_ = spans.size() - 1;
+          v_ = spans.back().end;
+          return;
+        }
+        auto it = std::upper_bound(
+            spans.begin(), spans.end(), pos,
+            [](size_t p, const Span& s) { return p < s.offset; });
+        block_ = std::distance(spans.begin(), it) - 1;
+        v_ = spans[block_].begin + (pos - spans[block_].offset);
+      }
+
+      void increment() {
+        ++pos_;
+        ++v_;
+        if (v_ == range_->spans_[block_].end &&
+            block_ + 1 < range_->spans_.size()) {
+          ++block_;
+          v_ = range_->spans_[block_].begin;
+        }
+      }
+
+      void decrement() {
+        --pos_;
+        if (v_ == range_->spans_[block_].begin) {
+          --block_;
+          v_ = range_->spans_[block_].end;
+        }
+        --v_;
+      }
+
+      void advance(std::ptrdiff_t n) { seek(pos_ + n); }
+
+      std::ptrdiff_t distance_to(const Iterator& o) const {
+        return static_cast<std::ptrdiff_t>(o.pos_) -
+               static_cast<std::ptrdiff_t>(pos_);
+      }
+
+      bool equal(const Iterator& o) const { return pos_ == o.pos_; }
+
+      U& dereference() const { return *v_; }
+
+    public:
+      Iterator() = default;
+      Iterator(const BlockRange* range, size_t pos) : range_(range) {
+        seek(pos);
+      }
+    };
+
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+    using value_type = U;
+
+    template <typename Head>
+    explicit BlockRange(Head& heads) {
+      for (unsigned x = 0; x < heads.size(); ++x) {
+        for (header* h = heads.getRemote(x)->first; h; h = h->next) {
+          if (h->dbegin != h->dend) {
+            spans_.emplace_back(Span{h->dbegin, h->dend, size_});
+            size_ += h->dend - h->dbegin;
+          }
+        }
+      }
+    }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, size_); }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    //! the number of non-empty blocks
+    size_t num_blocks() const { return spans_.size(); }
+  };
+
 private:
   katana::FixedSizeHeap heap;
   katana::PerThreadStorage<PerThread> heads;
@@ -244,6 +363,51 @@ public:
     return local_iterator(&heads, katana::ThreadPool::getTID() + 1);
   }
 
+  /**
+   * The elements of the bag as an evenly splittable range; computing it
+   * takes time linear in the number of blocks. See BlockRange.
+   */
+  BlockRange<T> Blocks() { return BlockRange<T>(heads); }
+  BlockRange<const T> Blocks() const { return BlockRange<const T>(heads); }
+
+  //! The number of elements; takes time linear in the number of blocks
+  size_t size() const {
+    size_t ret = 0;
+    for (unsigned x = 0; x < heads.size(); ++x) {
+      for (header* h = heads.getRemote(x)->first; h; h = h->next) {
+        ret += h->dend - h->dbegin;
+      }
+    }
+    return ret;
+  }
+
+  /**
+   * Move the elements into array, a NUMAArray<T>, and clear the bag. The
+   * array is reallocated blocked and each active thread moves an even
+   * share into the part of it on its own node.
+   *
+   * Elements live in linked blocks rather than one buffer, so this is a
+   * parallel copy, not a pointer swap.
+   */
+  template <typename Array>
+  void MoveTo(Array* array) {
+    BlockRange<T> range = Blocks();
+    array->destroy();
+    array->deallocate();
+    array->allocateBlocked(range.size());
+    katana::on_each_gen(
+        [&](const unsigned int tid, const unsigned int num) {
+          auto [b, e] =
+              katana::block_range(range.begin(), range.end(), tid, num);
+          size_t i = std::distance(range.begin(), b);
+          for (; b != e; ++b, ++i) {
+            array->constructAt(i, std::move(*b));
+          }
+        },
+        std::make_tuple(katana::no_stats()));
+    clear();
+  }
+
   bool empty() const {
     for (unsigned x = 0; x < heads.size(); ++x) {
       header* h = heads.getRemote(x)->first;
@@ -70,6 +70,15 @@ KATANA_EXPORT std::unique_ptr<Barrier> CreateTopoBarrier(unsigned);
 KATANA_EXPORT std::unique_ptr<Barrier> CreateCountingBarrier(unsigned);
 KATANA_EXPORT std::unique_ptr<Barrier> CreateDisseminationBarrier(unsigned);
 
+/**
+ * Create a barrier that, whenever it is reinitialized, picks the barrier
+ * with the lowest latency for the number of threads and the sockets they
+ * span; see internal::ChooseBarrier. GetBarrier() uses one. The environment
+ * variable KATANA_BARRIER, one of counting, mcs, topo or dissemination,
+ * forces a specific barrier.
+ */
+KATANA_EXPORT std::unique_ptr<Barrier> CreateAutoBarrier(unsigned);
+
 /**
  * Creates a new simple barrier. This barrier is not designed to be fast but
  * does guarantee that all threads have left the barrier before returning
@@ -83,6 +92,18 @@ namespace internal {
 
 void SetBarrier(Barrier* barrier);
 
+enum class BarrierKind { kCounting, kMCS, kTopo, kDissemination };
+
+/**
+ * The barrier CreateAutoBarrier uses for active_threads threads on
+ * num_sockets sockets: a single counter while few threads share a socket,
+ * an MCS arrival tree when the counter would be contended, and the socket
+ * tree of the topo barrier when threads span sockets, so that only socket
+ * leaders exchange cache lines across sockets.
+ */
+KATANA_EXPORT BarrierKind
+ChooseBarrier(unsigned active_threads, unsigned num_sockets);
+
 }  // namespace internal
 
 }  // namespace katana
@@ -0,0 +1,57 @@
+#ifndef KATANA_LIBGALOIS_KATANA_BATCHEDGATHER_H_
+#define KATANA_LIBGALOIS_KATANA_BATCHEDGATHER_H_
+
+#include <cstddef>
+#include <type_traits>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Edges per batch of GatherBatched: enough prefetches in flight to cover
+/// the latency of a miss to memory, few enough that the prefetched lines
+/// are still in L1 when they are visited
+constexpr size_t kGatherBatchSize = 16;
+
+/// Visit the edges of a pull-style gather, e.g., the in-neighbors of a node
+/// in PageRank, in batches that hide the latency of reading the data of
+/// random neighbors. For each batch of kBatchSize edges, GatherBatched reads
+/// the destination of every edge with dst_of and prefetches address_of(dst)
+/// before it calls visit(edge, dst) on any of them, so that the misses of a
+/// batch overlap instead of stalling the gather one at a time.
+///
+/// The edges are visited in order. address_of must not have side effects;
+/// it is only a hint of what visit is going to read.
+template <
+    size_t kBatchSize = kGatherBatchSize, typename EdgeRange, typename DstFn,
+    typename AddressFn, typename VisitFn>
+void
+GatherBatched(
+    const EdgeRange& edges, DstFn&& dst_of, AddressFn&& address_of,
+    VisitFn&& visit) {
+  static_assert(kBatchSize > 0, "batches must hold some edges");
+
+  auto it = edges.begin();
+  auto end = edges.end();
+  using Edge = std::decay_t<decltype(*it)>;
+  using Node = std::decay_t<decltype(dst_of(*it))>;
+
+  Edge batch_edges[kBatchSize];
+  Node batch_dsts[kBatchSize];
+  while (it != end) {
+    size_t size = 0;
+    for (; size < kBatchSize && it != end; ++size, ++it) {
+      batch_edges[size] = *it;
+      batch_dsts[size] = dst_of(batch_edges[size]);
+      prefetchForRead(address_of(batch_dsts[size]));
+    }
+    for (size_t i = 0; i < size; ++i) {
+      visit(batch_edges[i], batch_dsts[i]);
+    }
+  }
+}
+
+}  // namespace katana
+
+#endif
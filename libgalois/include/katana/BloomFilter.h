@@ -0,0 +1,129 @@
+#ifndef KATANA_LIBGALOIS_KATANA_BLOOMFILTER_H_
+#define KATANA_LIBGALOIS_KATANA_BLOOMFILTER_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+
+namespace katana {
+
+/// A blocked Bloom filter over 64-bit key hashes, for rejecting lookups of
+/// absent keys before searching the structure that holds the keys. Each
+/// key sets its bits in a single 512-bit block, one cache line, so a
+/// lookup touches one line at a false positive rate a little above that
+/// of a classic Bloom filter with as many bits: about 1% at 10 bits per
+/// key.
+///
+/// Insert may be called concurrently; MayContain may be called
+/// concurrently with other MayContain calls.
+class BloomFilter {
+public:
+  static constexpr uint32_t kDefaultBitsPerKey = 10;
+
+  /// An empty filter, which contains every key
+  BloomFilter() = default;
+
+  /// A filter for num_keys keys with about bits_per_key bits each
+  explicit BloomFilter(
+      uint64_t num_keys, uint32_t bits_per_key = kDefaultBitsPerKey) {
+    uint64_t num_bits = std::max<uint64_t>(1, num_keys) * bits_per_key;
+    num_blocks_ = (num_bits + kBlockBits - 1) / kBlockBits;
+    // ln 2 bits per key minimizes false positives
+    num_probes_ = std::clamp<uint32_t>(
+        std::lround(bits_per_key * 0.69), 1, kMaxProbes);
+    words_.allocateBlocked(num_blocks_ * kBlockWords);
+    ParallelSTL::fill(words_.begin(), words_.end(), uint64_t{0});
+  }
+
+  BloomFilter(BloomFilter&&) = default;
+  BloomFilter& operator=(BloomFilter&&) = default;
+
+  BloomFilter(const BloomFilter&) = delete;
+  BloomFilter& operator=(const BloomFilter&) = delete;
+
+  /// \returns a well mixed hash of an integer key, since filters need all 64
+  /// bits of their hashes to be random
+  static uint64_t Hash(uint64_t key) noexcept {
+    // the finalizer of MurmurHash3
+    key ^= key >> 33;
+    key *= UINT64_C(0xff51afd7ed558ccd);
+    key ^= key >> 33;
+    key *= UINT64_C(0xc4ceb9fe1a85ec53);
+    key ^= key >> 33;
+    return key;
+  }
+
+  /// Add a key by its hash; the filter must not be empty
+  void Insert(uint64_t hash) noexcept {
+    uint64_t* block = words_.data() + BlockOffset(hash);
+    ForEachBit(hash, [block](uint32_t bit) {
+      uint64_t mask = uint64_t{1} << (bit % 64);
+      // skip the atomic when the bit is set, as it is for repeated keys
+      if (!(block[bit / 64] & mask)) {
+        __atomic_fetch_or(&block[bit / 64], mask, __ATOMIC_RELAXED);
+      }
+      return true;
+    });
+  }
+
+  /// \returns false if no key with this hash was inserted; true if one was
+  /// or, rarely, if none was
+  bool MayContain(uint64_t hash) const noexcept {
+    if (empty()) {
+      return true;
+    }
+    const uint64_t* block = words_.data() + BlockOffset(hash);
+    bool found = true;
+    ForEachBit(hash, [block, &found](uint32_t bit) {
+      found = (block[bit / 64] >> (bit % 64)) & 1;
+      return found;
+    });
+    return found;
+  }
+
+  bool empty() const noexcept { return num_blocks_ == 0; }
+
+  uint64_t SizeBytes() const noexcept {
+    return words_.size() * sizeof(uint64_t);
+  }
+
+private:
+  static constexpr uint32_t kBlockBits = 512;
+  static constexpr uint32_t kBlockWords = kBlockBits / 64;
+  static constexpr uint32_t kMaxProbes = 16;
+
+  /// \returns the position of the first word of the block of hash
+  uint64_t BlockOffset(uint64_t hash) const noexcept {
+    // the high bits choose the block by multiplication instead of modulo
+    uint64_t block =
+        (static_cast<unsigned __int128>(hash) * num_blocks_) >> 64;
+    return block * kBlockWords;
+  }
+
+  /// Call fn with each bit of the block of hash until it returns false. The
+  /// bits are double hashed from the low half of hash, which the choice of
+  /// block leaves nearly independent.
+  template <typename Fn>
+  void ForEachBit(uint64_t hash, const Fn& fn) const noexcept {
+    uint32_t bit = static_cast<uint32_t>(hash);
+    // odd steps visit distinct bits for up to 512 probes
+    uint32_t step = (static_cast<uint32_t>(hash >> 16) & 0x1ff) | 1;
+    for (uint32_t i = 0; i < num_probes_; ++i) {
+      if (!fn(bit % kBlockBits)) {
+        return;
+      }
+      bit += step;
+    }
+  }
+
+  NUMAArray<uint64_t> words_;
+  uint64_t num_blocks_{0};
+  uint32_t num_probes_{0};
+};
+
+}  // namespace katana
+
+#endif
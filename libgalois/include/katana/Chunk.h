@@ -29,18 +29,18 @@
 
 namespace katana {
 
-extern unsigned activeThreads;
-
 namespace internal {
 // This overly complex specialization avoids a pointer indirection for
 // non-distributed WL when accessing PerLevel
 template <bool, template <typename> class PS, typename TQ>
 struct squeue {
   PS<TQ> queues;
+  //! threads of the loop, read once since steals ask for it often
+  int num_threads{static_cast<int>(ThreadPool::getActiveThreads())};
   TQ& get(int i) { return *queues.getRemote(i); }
   TQ& get() { return *queues.getLocal(); }
   int myEffectiveID() { return ThreadPool::getTID(); }
-  int size() { return activeThreads; }
+  int size() { return num_threads; }
 };
 
 template <template <typename> class PS, typename TQ>
@@ -0,0 +1,107 @@
+#ifndef KATANA_LIBGALOIS_KATANA_COMPRESSEDINPUT_H_
+#define KATANA_LIBGALOIS_KATANA_COMPRESSEDINPUT_H_
+
+#include <istream>
+#include <memory>
+#include <optional>
+#include <streambuf>
+#include <string>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The compression of an input file, as told by its first and last bytes
+enum class InputCompression {
+  kNone,
+  /// gzip, whose members are decompressed one after another
+  kGzip,
+  /// BGZF (as written by bgzip), gzip members of at most 64 KiB that each
+  /// record their compressed size; they are decompressed in parallel
+  kBgzf,
+  /// zstd frames, which are decompressed one after another
+  kZstd,
+  /// The zstd seekable format (as written by t2sz or zstd's seekable
+  /// contrib), zstd frames indexed by a trailing seek table; they are
+  /// decompressed in parallel
+  kZstdSeekable,
+};
+
+/// \returns the name of a compression, for messages
+KATANA_EXPORT const char* InputCompressionName(InputCompression compression);
+
+/// A read-only std::streambuf of the decompressed contents of a file, whose
+/// compression is detected from its contents rather than its name.
+///
+/// Files of independent blocks, BGZF and seekable zstd, are decompressed
+/// in batches of blocks with a parallel loop; the other formats are
+/// decompressed by a single stream. Decompression goes through the codecs
+/// of Arrow, so a format is only readable if Arrow was built with it.
+///
+/// Seeking to the start, e.g., to read a file twice, always works. Files
+/// of independent blocks can seek to any position.
+class KATANA_EXPORT DecompressingStreamBuf : public std::streambuf {
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+
+  DecompressingStreamBuf();
+
+public:
+  /// Decompressed bytes per parallel batch of blocks
+  static constexpr size_t kDefaultBatchSize = size_t{64} << 20;
+
+  static Result<std::unique_ptr<DecompressingStreamBuf>> Make(
+      const std::string& path, size_t batch_size = kDefaultBatchSize);
+
+  ~DecompressingStreamBuf() override;
+
+  DecompressingStreamBuf(const DecompressingStreamBuf&) = delete;
+  DecompressingStreamBuf& operator=(const DecompressingStreamBuf&) = delete;
+
+  InputCompression compression() const noexcept;
+
+  /// \returns the error that stopped decompression, if any; the stream
+  /// ends at the error
+  const std::optional<CopyableErrorInfo>& error() const noexcept;
+
+protected:
+  int_type underflow() override;
+  pos_type seekoff(
+      off_type off, std::ios_base::seekdir dir,
+      std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+  Result<void> Fill();
+  Result<void> Seek(uint64_t pos);
+};
+
+/// An input stream of a possibly compressed file, which can replace a
+/// std::ifstream in parsers of text inputs. As with std::ifstream, failing
+/// to open the file sets failbit. A stream that fails to decompress ends
+/// early; parsers should check error() once they reach its end.
+///
+/// Decompression needs the katana runtime, e.g., a SharedMemSys.
+class KATANA_EXPORT DecompressingIfstream : public std::istream {
+public:
+  explicit DecompressingIfstream(
+      const std::string& path,
+      size_t batch_size = DecompressingStreamBuf::kDefaultBatchSize);
+
+  ~DecompressingIfstream() override;
+
+  /// \returns the compression of the file, or kNone if it failed to open
+  InputCompression compression() const noexcept;
+
+  /// \returns why the file failed to open or to decompress, if it did
+  const std::optional<CopyableErrorInfo>& error() const noexcept;
+
+private:
+  std::unique_ptr<DecompressingStreamBuf> buf_;
+  std::optional<CopyableErrorInfo> open_error_;
+};
+
+}  // namespace katana
+
+#endif
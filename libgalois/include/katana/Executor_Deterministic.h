@@ -38,7 +38,7 @@
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
 #include "katana/Threads.h"
-#include "katana/UnionFind.h"
+#include "katana/UnionFindNode.h"
 #include "katana/UserContextAccess.h"
 #include "katana/WorkList.h"
 #include "katana/config.h"
@@ -559,8 +559,8 @@ class DAGManagerBase<OptionsTy, true> {
 
 public:
   DAGManagerBase()
-      : term(GetTerminationDetection(activeThreads)),
-        barrier(GetBarrier(activeThreads)) {}
+      : term(GetTerminationDetection(ThreadPool::getActiveThreads())),
+        barrier(GetBarrier(ThreadPool::getActiveThreads())) {}
 
   void destroyDAGManager() { data.getLocal()->heap.clear(); }
 
@@ -755,7 +755,7 @@ class BreakManagerBase<OptionsTy, true> {
 public:
   BreakManagerBase(const OptionsTy& o)
       : breakFn(get_trait_value<det_parallel_break_tag>(o.args).value),
-        barrier(GetBarrier(activeThreads)) {}
+        barrier(GetBarrier(ThreadPool::getActiveThreads())) {}
 
   bool checkBreak() {
     if (ThreadPool::getTID() == 0)
@@ -785,7 +785,8 @@ class IntentToReadManagerBase<OptionsTy, true> {
   Barrier& barrier;
 
 public:
-  IntentToReadManagerBase() : barrier(GetBarrier(activeThreads)) {}
+  IntentToReadManagerBase()
+      : barrier(GetBarrier(ThreadPool::getActiveThreads())) {}
 
   void pushIntentToReadTask(Context* ctx) {
     pending.getLocal()->push_back(ctx);
@@ -1262,7 +1263,7 @@ public:
         alloc(&heap),
         mergeBuf(alloc),
         distributeBuf(alloc),
-        barrier(GetBarrier(activeThreads)) {
+        barrier(GetBarrier(ThreadPool::getActiveThreads())) {
     numActive = getActiveThreads();
   }
 
@@ -1393,7 +1394,7 @@ public:
       : BreakManager<OptionsTy>(o),
         NewWorkManager<OptionsTy>(o),
         options(o),
-        barrier(GetBarrier(activeThreads)),
+        barrier(GetBarrier(ThreadPool::getActiveThreads())),
         loopname(katana::internal::getLoopName(o.args)) {
     static_assert(
         !OptionsTy::needsBreak || OptionsTy::hasBreak,
@@ -23,6 +23,7 @@
 #include "katana/Barrier.h"
 #include "katana/CompilerSpecific.h"
 #include "katana/Executor_OnEach.h"
+#include "katana/LoopProfile.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/PaddedLock.h"
 #include "katana/PerThreadStorage.h"
@@ -58,6 +59,7 @@ class DoAllStealingExec {
     Iter shared_end;
     Diff_ty m_size;
     size_t num_iter;
+    size_t num_chunks;
 
     // Stats
 
@@ -67,7 +69,8 @@ class DoAllStealingExec {
           shared_beg(),
           shared_end(),
           m_size(0),
-          num_iter(0) {
+          num_iter(0),
+          num_chunks(0) {
       // TODO: fix this initialization problem,
       // see initThread
     }
@@ -78,7 +81,8 @@ class DoAllStealingExec {
           shared_beg(beg),
           shared_end(end),
           m_size(std::distance(beg, end)),
-          num_iter(0) {}
+          num_iter(0),
+          num_chunks(0) {}
 
     bool doWork(F func, const unsigned chunk_size) {
       Iter beg(shared_beg);
@@ -88,6 +92,7 @@ class DoAllStealingExec {
 
       while (getWork(beg, end, chunk_size)) {
         didwork = true;
+        ++num_chunks;
 
         for (; beg != end; ++beg) {
           if (NEED_STATS) {
@@ -368,18 +373,21 @@ private:
   PerThreadTimer<MORE_STATS> stealTime;
   PerThreadTimer<MORE_STATS> termTime;
 
+  LoopProfile profile;
+
 public:
   DoAllStealingExec(const R& _range, F _func, const ArgsTuple& argsTuple)
       : range(_range),
         func(_func),
         loopname(katana::internal::getLoopName(argsTuple)),
         chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
-        term(GetTerminationDetection(activeThreads)),
+        term(GetTerminationDetection(ThreadPool::getActiveThreads())),
         totalTime(loopname, "Total"),
         initTime(loopname, "Init"),
         execTime(loopname, "Execute"),
         stealTime(loopname, "Steal"),
-        termTime(loopname, "Term") {
+        termTime(loopname, "Term"),
+        profile(loopname) {
     KATANA_LOG_DEBUG_ASSERT(chunk_size > 0);
   }
 
@@ -411,7 +419,9 @@ public:
 
   void operator()(void) {
     ThreadContext& ctx = *workers.getLocal();
+    size_t num_steals = 0;
     totalTime.start();
+    profile.BeginThread();
 
     while (true) {
       bool workHappened = false;
@@ -431,6 +441,7 @@ public:
       stealTime.stop();
 
       if (stole) {
+        ++num_steals;
         continue;
 
       } else {
@@ -451,6 +462,7 @@ public:
       }
     }
 
+    profile.EndThread(ctx.num_chunks, num_steals);
     totalTime.stop();
     KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
 
@@ -468,10 +480,10 @@ struct ChooseDoAllImpl {
         R, OperatorReferenceType<decltype(std::forward<F>(func))>, ArgsT>
         exec(range, std::forward<F>(func), argsTuple);
 
-    Barrier& barrier = GetBarrier(activeThreads);
+    Barrier& barrier = GetBarrier(ThreadPool::getActiveThreads());
 
     GetThreadPool().run(
-        activeThreads, [&exec]() { exec.initThread(); },
+        ThreadPool::getActiveThreads(), [&exec]() { exec.initThread(); },
         [&barrier]() { barrier.Wait(); }, std::ref(exec));
   }
 };
@@ -480,6 +492,7 @@ template <>
 struct ChooseDoAllImpl<false> {
   template <typename R, typename F, typename ArgsT>
   static void call(const R& range, F func, const ArgsT& argsTuple) {
+    LoopProfile profile(katana::internal::getLoopName(argsTuple));
     on_each_gen(
         [&](const unsigned int, const unsigned int) {
           static constexpr bool NEED_STATS =
@@ -494,6 +507,7 @@ struct ChooseDoAllImpl<false> {
           PerThreadTimer<MORE_STATS> execTime(loopname, "Work");
 
           totalTime.start();
+          profile.BeginThread();
           initTime.start();
 
           auto begin = range.local_begin();
@@ -513,6 +527,8 @@ struct ChooseDoAllImpl<false> {
           }
           execTime.stop();
 
+          // each thread runs its local range as a single chunk
+          profile.EndThread(1, 0);
           totalTime.stop();
 
           if (NEED_STATS) {
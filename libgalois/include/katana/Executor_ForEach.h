@@ -28,6 +28,7 @@
 #include "katana/Barrier.h"
 #include "katana/Chunk.h"
 #include "katana/Context.h"
+#include "katana/LoopProfile.h"
 #include "katana/LoopStatistics.h"
 #include "katana/Mem.h"
 #include "katana/OperatorReferenceTypes.h"
@@ -194,6 +195,8 @@ protected:
   PerThreadTimer<MORE_STATS> initTime;
   PerThreadTimer<MORE_STATS> execTime;
 
+  LoopProfile profile;
+
   inline void commitIteration(ThreadLocalData& tld) {
     if (needsPush) {
       // auto ii = tld.facing.getPushBuffer().begin();
@@ -300,6 +303,7 @@ protected:
   template <bool couldAbort, bool isLeader>
   void go() {
     execTime.start();
+    profile.BeginThread();
 
     // Thread-local data goes on the local stack to be NUMA friendly
     ThreadLocalData tld(origFunction, loopname);
@@ -351,6 +355,9 @@ protected:
 
     if (couldAbort)
       setThreadContext(0);
+
+    // the worklist hands out chunks; all threads share it, so none steals
+    profile.EndThread(0, 0);
   }
 
   struct T1 {};
@@ -358,14 +365,15 @@ protected:
 
   template <typename... WArgsTy>
   ForEachExecutor(T2, FunctionTy f, const ArgsTy& args, WArgsTy... wargs)
-      : term(GetTerminationDetection(activeThreads)),
-        barrier(GetBarrier(activeThreads)),
+      : term(GetTerminationDetection(ThreadPool::getActiveThreads())),
+        barrier(GetBarrier(ThreadPool::getActiveThreads())),
         wl(std::forward<WArgsTy>(wargs)...),
         origFunction(f),
         loopname(katana::internal::getLoopName(args)),
         broke(false),
         initTime(loopname, "Init"),
-        execTime(loopname, "Execute") {}
+        execTime(loopname, "Execute"),
+        profile(loopname) {}
 
   template <typename WArgsTy, size_t... Is>
   ForEachExecutor(
@@ -401,7 +409,7 @@ public:
 
   void operator()() {
     bool isLeader = ThreadPool::isLeader();
-    bool couldAbort = needsAborts && activeThreads > 1;
+    bool couldAbort = needsAborts && ThreadPool::getActiveThreads() > 1;
     if (couldAbort && isLeader)
       go<true, true>();
     else if (couldAbort && !isLeader)
@@ -450,15 +458,24 @@ for_each_impl(const RangeTy& range, FunctionTy&& fn, const ArgsTy& args) {
       OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))>;
   typedef ForEachExecutor<WorkListTy, FuncRefType, ArgsTy> WorkTy;
 
-  auto& barrier = GetBarrier(activeThreads);
+  auto& barrier = GetBarrier(ThreadPool::getActiveThreads());
   FuncRefType fn_ref = fn;
   WorkTy W(fn_ref, args);
   W.init(range);
   GetThreadPool().run(
-      activeThreads, [&W, &range]() { W.initThread(range); },
+      ThreadPool::getActiveThreads(), [&W, &range]() { W.initThread(range); },
       [&barrier] { barrier.Wait(); }, std::ref(W));
 }
 
+namespace parameter {
+
+/// Run a for_each loop with the ParaMeter executor and report its available
+/// parallelism; defined in Executor_ParaMeter.h
+template <typename RangeTy, typename FunctionTy, typename ArgsTy>
+void ProfileForEach(const RangeTy& range, FunctionTy&& fn, const ArgsTy& args);
+
+}  // namespace parameter
+
 //! Normalize arguments to for_each
 template <typename RangeTy, typename FunctionTy, typename TupleTy>
 void
@@ -479,7 +496,11 @@ for_each_gen(const RangeTy& r, FunctionTy&& fn, const TupleTy& tpl) {
 
   timer.start();
 
-  for_each_impl(r, std::forward<FunctionTy>(fn), xtpl);
+  if (IsParallelismProfiling()) {
+    parameter::ProfileForEach(r, std::forward<FunctionTy>(fn), xtpl);
+  } else {
+    for_each_impl(r, std::forward<FunctionTy>(fn), xtpl);
+  }
 
   timer.stop();
 }
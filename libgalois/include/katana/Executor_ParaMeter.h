@@ -21,11 +21,16 @@
 #define KATANA_LIBGALOIS_KATANA_EXECUTORPARAMETER_H_
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
 #include <deque>
+#include <iterator>
 #include <random>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "katana/Context.h"
@@ -33,6 +38,7 @@
 #include "katana/Executor_ForEach.h"
 #include "katana/Executor_OnEach.h"
 #include "katana/Mem.h"
+#include "katana/OperatorReferenceTypes.h"
 #include "katana/Reduction.h"
 #include "katana/Simple.h"
 #include "katana/Traits.h"
@@ -109,6 +115,38 @@ struct UnorderedStepStats : public StepStatsBase {
 KATANA_EXPORT FILE* getStatsFile();
 KATANA_EXPORT void closeStatsFile();
 
+/// \returns the stats file if KATANA_PARAMETER_OUTFILE names one, otherwise
+/// nullptr
+KATANA_EXPORT FILE* getNamedStatsFile();
+
+/// Available parallelism of a for_each loop run with the ParaMeter executor
+struct ParallelismProfile {
+  /// iterations committed in each round
+  std::vector<uint64_t> parallelism;
+  uint64_t iterations{0};
+  uint64_t aborts{0};
+  uint64_t max_parallelism{0};
+
+  void AddRound(uint64_t committed, uint64_t attempted) {
+    parallelism.push_back(committed);
+    iterations += committed;
+    aborts += attempted - committed;
+    max_parallelism = std::max(max_parallelism, committed);
+  }
+
+  /// \returns the number of rounds, the critical path length of the loop
+  uint64_t rounds() const { return parallelism.size(); }
+
+  double mean_parallelism() const {
+    return parallelism.empty() ? 0.0
+                               : static_cast<double>(iterations) / rounds();
+  }
+};
+
+/// Report the profile of a loop as described at SetParallelismProfiling
+KATANA_EXPORT void ReportParallelismProfile(
+    const char* loopname, const ParallelismProfile& profile);
+
 template <typename T>
 class FIFO_WL {
   using PTcont = katana::PerThreadStorage<katana::gstl::Vector<T>>;
@@ -237,6 +275,7 @@ private:
   FunctionTy m_func;
   const char* loopname;
   FILE* m_statsFile;
+  ParallelismProfile* m_profile;
   FixedSizeAllocator<IterationContext> m_iterAlloc;
   katana::GReduceLogicalOr m_broken;
 
@@ -318,7 +357,7 @@ private:
           if ((flag = setjmp(execFrame)) == 0) {
             m_func(it->item, it->facing.data());
           } else
-#elif KATANA_USE_EXCEPTION_ABORT
+#elif defined(KATANA_USE_EXCEPTION_ABORT)
           try {
             m_func(it->item, it->facing.data());
 
@@ -389,7 +428,12 @@ private:
       KATANA_LOG_DEBUG_VASSERT(
           stats.parallelism.reduce(), "ERROR: No Progress");
 
-      stats.dump(m_statsFile, loopname);
+      if (m_statsFile) {
+        stats.dump(m_statsFile, loopname);
+      }
+      if (m_profile) {
+        m_profile->AddRound(stats.parallelism.reduce(), stats.wlSize.reduce());
+      }
       stats.nextStep();
 
       if (needsBreak && m_broken.reduce()) {
@@ -398,14 +442,24 @@ private:
 
     }  // end while
 
-    closeStatsFile();
+    if (m_statsFile) {
+      closeStatsFile();
+    }
   }
 
 public:
   ParaMeterExecutor(const FunctionTy& f, const ArgsTy& args)
+      : ParaMeterExecutor(f, args, getStatsFile(), nullptr) {}
+
+  /// Record each round in statsFile and in profile, either of which may be
+  /// null
+  ParaMeterExecutor(
+      const FunctionTy& f, const ArgsTy& args, FILE* statsFile,
+      ParallelismProfile* profile)
       : m_func(f),
         loopname(katana::internal::getLoopName(args)),
-        m_statsFile(getStatsFile()) {}
+        m_statsFile(statsFile),
+        m_profile(profile) {}
 
   // called serially once
   template <typename RangeTy>
@@ -468,6 +522,60 @@ for_each_ParaMeter(const R& range, const F& func, const ArgsTuple& argsTuple) {
   exec.execute(range);
 }
 
+namespace parameter {
+
+template <typename T>
+auto
+WithoutWorkList(const T& arg) {
+  if constexpr (std::is_base_of_v<wl_tag, T>) {
+    return std::make_tuple();
+  } else {
+    return std::make_tuple(arg);
+  }
+}
+
+template <typename ArgsTy, size_t... Ints>
+auto
+WithParaMeterWorkList(const ArgsTy& args, std::index_sequence<Ints...>) {
+  return std::tuple_cat(
+      WithoutWorkList(std::get<Ints>(args))...,
+      std::make_tuple(wl<katana::ParaMeter<>>()));
+}
+
+/// Run a for_each loop, with its arguments normalized by for_each_gen, with
+/// the ParaMeter executor in place of its worklist
+///
+/// \returns the available parallelism of the loop
+template <typename RangeTy, typename FunctionTy, typename ArgsTy>
+ParallelismProfile
+RunParallelismProfile(
+    const RangeTy& range, FunctionTy&& fn, const ArgsTy& args) {
+  using value_type =
+      typename std::iterator_traits<typename RangeTy::iterator>::value_type;
+  using FuncRefType =
+      OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))>;
+
+  auto tpl = WithParaMeterWorkList(
+      args, std::make_index_sequence<std::tuple_size_v<ArgsTy>>());
+
+  ParallelismProfile profile;
+  FuncRefType fn_ref = fn;
+  ParaMeterExecutor<value_type, FuncRefType, decltype(tpl)> exec(
+      fn_ref, tpl, getNamedStatsFile(), &profile);
+  exec.init(range);
+  return profile;
+}
+
+template <typename RangeTy, typename FunctionTy, typename ArgsTy>
+void
+ProfileForEach(const RangeTy& range, FunctionTy&& fn, const ArgsTy& args) {
+  ParallelismProfile profile =
+      RunParallelismProfile(range, std::forward<FunctionTy>(fn), args);
+  ReportParallelismProfile(katana::internal::getLoopName(args), profile);
+}
+
+}  // namespace parameter
+
 }  // end namespace katana
 #endif
 
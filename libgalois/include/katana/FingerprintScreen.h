@@ -0,0 +1,42 @@
+#ifndef KATANA_LIBGALOIS_KATANA_FINGERPRINTSCREEN_H_
+#define KATANA_LIBGALOIS_KATANA_FINGERPRINTSCREEN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Screens of molecule fingerprints against a query fingerprint, for
+/// substructure and similarity search over many molecules. The kernels
+/// compare whole rows at once with AVX-512 (counting bits with VPOPCNTDQ
+/// where available) or AVX2 (counting bits with nibble lookups) and are
+/// chosen once for this machine; rows are screened in parallel.
+
+/// Fingerprints of num_words words each, stored row by row in a contiguous
+/// matrix whose rows start stride words apart. Bits are numbered from the
+/// lowest bit of the first word, as in DynamicBitset.
+struct FingerprintRows {
+  const uint64_t* words{};
+  size_t num_rows{};
+  size_t num_words{};
+  size_t stride{};
+};
+
+/// \returns the rows that have every bit of query set, in increasing order:
+/// the candidates that may contain the substructure query describes. query
+/// has rows.num_words words.
+KATANA_EXPORT std::vector<uint64_t> ScreenSubstructures(
+    const FingerprintRows& rows, const uint64_t* query);
+
+/// \returns the Tanimoto similarity of each row to query, the number of bits
+/// set in both over the number set in either, or 0 where neither has a bit
+/// set. query has rows.num_words words.
+KATANA_EXPORT std::vector<double> TanimotoSimilarities(
+    const FingerprintRows& rows, const uint64_t* query);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef KATANA_LIBGALOIS_KATANA_HYPERLOGLOG_H_
+#define KATANA_LIBGALOIS_KATANA_HYPERLOGLOG_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "katana/Logging.h"
+
+namespace katana {
+
+/// A HyperLogLog sketch, which estimates the number of distinct keys in a
+/// stream from 2^precision one-byte registers, whatever the length of the
+/// stream. The relative standard error of an estimate is about
+/// 1.04 / sqrt(2^precision): 0.8% at the default precision, in 16 KiB.
+///
+/// A sketch is not thread safe. Parallel loops should fill a sketch per
+/// thread, with the same precision, and Merge them afterwards; the merged
+/// sketch is the sketch of the concatenated streams.
+class HyperLogLog {
+public:
+  static constexpr uint32_t kDefaultPrecision = 14;
+  static constexpr uint32_t kMinPrecision = 4;
+  static constexpr uint32_t kMaxPrecision = 18;
+
+  explicit HyperLogLog(uint32_t precision = kDefaultPrecision)
+      : precision_(std::clamp(precision, kMinPrecision, kMaxPrecision)),
+        registers_(size_t{1} << precision_, 0) {}
+
+  /// \returns a well mixed hash of an integer key, since the sketch needs
+  /// all 64 bits of its hashes to be random
+  static uint64_t Hash(uint64_t key) noexcept {
+    // the finalizer of MurmurHash3
+    key ^= key >> 33;
+    key *= UINT64_C(0xff51afd7ed558ccd);
+    key ^= key >> 33;
+    key *= UINT64_C(0xc4ceb9fe1a85ec53);
+    key ^= key >> 33;
+    return key;
+  }
+
+  /// Add a key by its hash
+  void Insert(uint64_t hash) noexcept {
+    uint64_t index = hash >> (64 - precision_);
+    // the position of the first set bit of the rest of the hash; the
+    // sentinel bit bounds it by 64 - precision + 1
+    uint64_t rest = (hash << precision_) | (uint64_t{1} << (precision_ - 1));
+    uint8_t rank = __builtin_clzll(rest) + 1;
+    registers_[index] = std::max(registers_[index], rank);
+  }
+
+  /// Add the keys of other, which must have the same precision
+  void Merge(const HyperLogLog& other) {
+    KATANA_LOG_VASSERT(
+        other.precision_ == precision_, "merging precision {} into {}",
+        other.precision_, precision_);
+    for (size_t i = 0; i < registers_.size(); ++i) {
+      registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+  }
+
+  /// \returns the estimated number of distinct keys inserted
+  double Estimate() const noexcept {
+    double m = registers_.size();
+    double sum = 0;
+    uint64_t zeros = 0;
+    for (uint8_t r : registers_) {
+      sum += std::ldexp(1.0, -r);
+      zeros += r == 0;
+    }
+    double alpha = 0.7213 / (1 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    // small cardinalities leave registers empty, and linear counting of
+    // the empty registers is more accurate for them
+    if (estimate <= 2.5 * m && zeros != 0) {
+      return m * std::log(m / zeros);
+    }
+    return estimate;
+  }
+
+  uint32_t precision() const noexcept { return precision_; }
+
+private:
+  uint32_t precision_;
+  std::vector<uint8_t> registers_;
+};
+
+}  // namespace katana
+
+#endif
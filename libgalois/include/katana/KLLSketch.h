@@ -0,0 +1,166 @@
+#ifndef KATANA_LIBGALOIS_KATANA_KLLSKETCH_H_
+#define KATANA_LIBGALOIS_KATANA_KLLSKETCH_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+
+namespace katana {
+
+/// A KLL sketch (Karnin, Lang and Liberty, "Optimal Quantile Approximation
+/// in Streams"), which estimates the quantiles of a stream of values in
+/// O(k) space. Values are kept in a stack of compactors; a compactor that
+/// fills up sorts its values and promotes every other one, at random, to
+/// the next level, where each value stands for twice as many. The rank
+/// error of a quantile is about 1.7 / k of the length of the stream with
+/// high probability: under 1% at the default k.
+///
+/// A sketch is not thread safe. Parallel loops should fill a sketch per
+/// thread and Merge them afterwards.
+template <typename T>
+class KLLSketch {
+public:
+  static constexpr uint32_t kDefaultK = 200;
+
+  explicit KLLSketch(uint32_t k = kDefaultK, uint64_t seed = 0)
+      : k_(std::max<uint32_t>(k, 8)), rng_(seed) {
+    Grow();
+  }
+
+  void Insert(const T& value) {
+    if (count_ == 0 || value < min_) {
+      min_ = value;
+    }
+    if (count_ == 0 || max_ < value) {
+      max_ = value;
+    }
+    ++count_;
+    compactors_[0].emplace_back(value);
+    if (++size_ >= max_size_) {
+      Compress();
+    }
+  }
+
+  /// Add the values of other
+  void Merge(const KLLSketch& other) {
+    if (other.count_ == 0) {
+      return;
+    }
+    while (compactors_.size() < other.compactors_.size()) {
+      Grow();
+    }
+    for (size_t h = 0; h < other.compactors_.size(); ++h) {
+      compactors_[h].insert(
+          compactors_[h].end(), other.compactors_[h].begin(),
+          other.compactors_[h].end());
+    }
+    if (count_ == 0 || other.min_ < min_) {
+      min_ = other.min_;
+    }
+    if (count_ == 0 || max_ < other.max_) {
+      max_ = other.max_;
+    }
+    count_ += other.count_;
+    size_ += other.size_;
+    while (size_ >= max_size_) {
+      Compress();
+    }
+  }
+
+  /// \returns the estimated q-quantile of the values, for q in [0, 1]: a
+  /// value with an estimated q * count() values at most it. The 0- and
+  /// 1-quantiles are exact. The sketch must not be empty.
+  T Quantile(double q) const {
+    KATANA_LOG_ASSERT(count_ != 0);
+    if (q <= 0) {
+      return min_;
+    }
+    if (q >= 1) {
+      return max_;
+    }
+    std::vector<std::pair<T, uint64_t>> weighted;
+    weighted.reserve(size_);
+    uint64_t total = 0;
+    for (size_t h = 0; h < compactors_.size(); ++h) {
+      for (const T& value : compactors_[h]) {
+        weighted.emplace_back(value, uint64_t{1} << h);
+      }
+      total += compactors_[h].size() << h;
+    }
+    std::sort(weighted.begin(), weighted.end());
+    double target = q * total;
+    uint64_t rank = 0;
+    for (const auto& [value, weight] : weighted) {
+      rank += weight;
+      if (rank >= target) {
+        return value;
+      }
+    }
+    return max_;
+  }
+
+  /// \returns the number of values inserted
+  uint64_t count() const noexcept { return count_; }
+  bool empty() const noexcept { return count_ == 0; }
+
+  const T& min() const noexcept { return min_; }
+  const T& max() const noexcept { return max_; }
+
+private:
+  /// \returns the number of values level h holds before it is compacted.
+  /// Capacities shrink by 2/3 per level down from the top, so that most of
+  /// the space goes to the levels whose values weigh the most.
+  uint64_t Capacity(size_t h) const {
+    double depth = compactors_.size() - h - 1;
+    return std::ceil(std::pow(2.0 / 3.0, depth) * k_) + 1;
+  }
+
+  void Grow() {
+    compactors_.emplace_back();
+    max_size_ = 0;
+    for (size_t h = 0; h < compactors_.size(); ++h) {
+      max_size_ += Capacity(h);
+    }
+  }
+
+  /// Compact the lowest full level; its values move up with half of them
+  void Compress() {
+    for (size_t h = 0; h < compactors_.size(); ++h) {
+      if (compactors_[h].size() < Capacity(h)) {
+        continue;
+      }
+      if (h + 1 == compactors_.size()) {
+        Grow();
+      }
+      std::vector<T>& level = compactors_[h];
+      std::vector<T>& next = compactors_[h + 1];
+      std::sort(level.begin(), level.end());
+      // an odd value out stays behind
+      size_t end = level.size() & ~size_t{1};
+      for (size_t i = rng_() & 1; i < end; i += 2) {
+        next.emplace_back(level[i]);
+      }
+      size_ -= end / 2;
+      level.erase(level.begin(), level.begin() + end);
+      return;
+    }
+  }
+
+  uint32_t k_;
+  std::minstd_rand rng_;
+  std::vector<std::vector<T>> compactors_;
+  uint64_t size_{0};
+  uint64_t max_size_{0};
+  uint64_t count_{0};
+  T min_{};
+  T max_{};
+};
+
+}  // namespace katana
+
+#endif
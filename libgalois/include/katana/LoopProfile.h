@@ -0,0 +1,113 @@
+#ifndef KATANA_LIBGALOIS_KATANA_LOOPPROFILE_H_
+#define KATANA_LIBGALOIS_KATANA_LOOPPROFILE_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Turn loop profiling on or off for the loops started from now on. It is
+/// initially on if the environment variable KATANA_LOOP_PROFILE is true.
+///
+/// While on, do_all and for_each record for each thread how long it worked
+/// on the loop, how long it then waited for the other threads to finish,
+/// and, for do_all, how many chunks it ran and how many times it stole work.
+/// The per-thread busy times, chunks and steals of a loop are reported as
+/// the statistics ProfileBusyNs, ProfileChunks and ProfileSteals of its
+/// loopname, the totals as ProfileIdleNs, ProfileMaxIdleNs and
+/// ProfileImbalance, the largest busy time over the mean, and the totals
+/// are logged to the active ProgressTracer span.
+///
+/// While off, a loop only checks the setting when it starts.
+KATANA_EXPORT void SetLoopProfiling(bool enabled);
+
+KATANA_EXPORT bool IsLoopProfiling();
+
+/// Turn parallelism profiling on or off for the for_each loops started from
+/// now on. It is initially on if the environment variable
+/// KATANA_PARALLELISM_PROFILE is true.
+///
+/// While on, for_each ignores its worklist and runs each loop with the
+/// ParaMeter executor (see Executor_ParaMeter.h), in rounds that each
+/// commit a maximal set of pending iterations that do not conflict with
+/// each other. The number of rounds, which is the critical path length of
+/// the loop, the number of iterations and the largest number of iterations
+/// committed in a round are reported as the statistics ParaMeterRounds,
+/// ParaMeterIterations and ParaMeterMaxParallelism of its loopname, and are
+/// logged with the mean and the profile of parallelism over the rounds to
+/// the active ProgressTracer span. The ParaMeter stats file is written too
+/// if KATANA_PARAMETER_OUTFILE names it. Profiled loops compute the same
+/// results as usual but run much slower.
+KATANA_EXPORT void SetParallelismProfiling(bool enabled);
+
+KATANA_EXPORT bool IsParallelismProfiling();
+
+/// Profile of one parallel loop, created by the executor before the loop
+/// starts and finished after all threads return
+class KATANA_EXPORT LoopProfile {
+public:
+  struct Summary {
+    unsigned num_threads{0};
+    uint64_t wall_ns{0};
+    uint64_t busy_ns{0};
+    uint64_t max_busy_ns{0};
+    uint64_t idle_ns{0};
+    uint64_t max_idle_ns{0};
+    uint64_t chunks{0};
+    uint64_t steals{0};
+
+    /// \returns the largest busy time over the mean; 1 is perfect balance
+    double imbalance() const;
+  };
+
+  explicit LoopProfile(const char* loopname);
+  ~LoopProfile();
+
+  LoopProfile(const LoopProfile&) = delete;
+  LoopProfile& operator=(const LoopProfile&) = delete;
+  LoopProfile(LoopProfile&&) = delete;
+  LoopProfile& operator=(LoopProfile&&) = delete;
+
+  bool enabled() const { return records_ != nullptr; }
+
+  /// Called by each thread when it starts working on the loop
+  void BeginThread() {
+    if (enabled()) {
+      BeginThreadImpl();
+    }
+  }
+
+  /// Called by each thread when it runs out of work for the loop
+  void EndThread(uint64_t chunks, uint64_t steals) {
+    if (enabled()) {
+      EndThreadImpl(chunks, steals);
+    }
+  }
+
+  /// Report the profile; called serially once the loop is over, by the
+  /// destructor if not called before. Later calls return an empty summary.
+  Summary Finish();
+
+private:
+  struct alignas(KATANA_CACHE_LINE_SIZE) Record {
+    uint64_t begin_ns{0};
+    uint64_t end_ns{0};
+    uint64_t chunks{0};
+    uint64_t steals{0};
+  };
+
+  void BeginThreadImpl();
+  void EndThreadImpl(uint64_t chunks, uint64_t steals);
+
+  const char* loopname_;
+  uint64_t begin_ns_{0};
+  unsigned num_records_{0};
+  std::unique_ptr<Record[]> records_;
+};
+
+}  // namespace katana
+
+#endif
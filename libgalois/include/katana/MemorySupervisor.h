@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "katana/Cache.h"
@@ -11,7 +12,12 @@
 #include "katana/config.h"
 
 namespace katana {
-/// The memory supervisor singleton (MS).  Not thread safe.
+/// The memory supervisor singleton (MS).
+///
+/// The bookkeeping calls are serialized by one lock, which is held while
+/// the MS asks managers to free standby memory; managers may call back into
+/// the MS from FreeStandbyMemory but must not hold locks of their own when
+/// they call the MS.
 ///
 /// The MS controls policy and does bookkeeping.  All memory allocation
 /// is done by the system, mostly the C++ standard library.
@@ -58,6 +64,13 @@ public:
   /// Managers are always allowed to transition from standby to active
   void StandbyToActive(const std::string& name, count_t bytes);
 
+  /// Hold the lock of the MS, e.g., across a change of the state of a
+  /// manager and the call that accounts for it, so that a reclaim cannot
+  /// observe one without the other. Take it before any lock of the manager.
+  std::unique_lock<std::recursive_mutex> Lock() {
+    return std::unique_lock<std::recursive_mutex>(mutex_);
+  }
+
   /// Give the memory supervisor a chance to release memory.  This is useful to call
   /// If you will be calling a series of allocations for active memory, you can use
   /// this to make sure we aren't holding on to too much standby memory.
@@ -104,6 +117,9 @@ private:
   count_t standby_{};
   void StandbyMinus(ManagerInfo& info, count_t bytes);
   void StandbyPlus(ManagerInfo& info, count_t bytes);
+  /// Rather than being collected, which would need the lock, the metrics
+  /// are set whenever they change; see Metrics.h
+  void UpdateStandbyMetrics(const ManagerInfo& info);
 
   /// The maximum amount of physical memory the MS plans to use, which should be less
   /// than or equal to the total physical memory in the machine.  There are users of
@@ -112,6 +128,9 @@ private:
 
   /// Statistics: bytes reclaimed
   count_t bytes_reclaimed_{};
+
+  /// Recursive because FreeStandbyMemory of managers calls PutStandby
+  std::recursive_mutex mutex_;
 };
 
 }  // namespace katana
@@ -0,0 +1,213 @@
+#ifndef KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+#define KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/PaddedLock.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/WorkListHelpers.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/**
+ * Relaxed concurrent priority queue, following "MultiQueues: Simple Relaxed
+ * Concurrent Priority Queues" (Rihani et al., SPAA 2015). There are
+ * QueuesPerThread locked binary heaps per thread. A push goes to a random
+ * heap; a pop looks at the tops of two random heaps and takes the item with
+ * the smaller priority. Items come out close to priority order without a
+ * global bucket structure, so, unlike \ref OrderedByIntegerMetric, there is
+ * no bucket width to choose.
+ *
+ * Indexer is as for \ref OrderedByIntegerMetric; items with smaller indices
+ * come first.
+ *
+ * @tparam Indexer          Indexer class
+ * @tparam QueuesPerThread  Heaps per thread
+ */
+template <
+    class Indexer = DummyIndexer<int>, unsigned QueuesPerThread = 2,
+    typename T = int, typename Index = unsigned, bool Concurrent = true>
+class MultiQueue {
+  static_assert(QueuesPerThread > 0, "need at least one queue per thread");
+
+public:
+  template <typename _T>
+  using retype = MultiQueue<
+      Indexer, QueuesPerThread, _T,
+      typename std::result_of<Indexer(_T)>::type, Concurrent>;
+
+  template <bool _b>
+  using rethread = MultiQueue<Indexer, QueuesPerThread, T, Index, _b>;
+
+  template <typename _indexer>
+  struct with_indexer {
+    typedef MultiQueue<_indexer, QueuesPerThread, T, Index, Concurrent> type;
+  };
+
+  typedef T value_type;
+  typedef Index index_type;
+
+private:
+  //! random two-choice pops before scanning all heaps
+  static constexpr unsigned kPopAttempts = 4;
+
+  typedef std::pair<Index, T> Entry;
+
+  struct Later {
+    bool operator()(const Entry& a, const Entry& b) const {
+      return b.first < a.first;
+    }
+  };
+
+  struct alignas(KATANA_CACHE_LINE_SIZE) Queue {
+    PaddedLock<Concurrent> lock;
+    std::vector<Entry> heap;
+    //! copies of the heap size and top priority, which are read without
+    //! the lock to choose a heap
+    std::atomic<size_t> size{0};
+    std::atomic<Index> top{};
+  };
+
+  std::unique_ptr<Queue[]> queues_;
+  size_t num_;
+  //! xorshift state of each thread
+  PerThreadStorage<uint64_t> rng_;
+  Indexer indexer_;
+
+  Queue& pick(uint64_t& s) {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    return queues_[s % num_];
+  }
+
+  uint64_t& rng() {
+    uint64_t& s = *rng_.getLocal();
+    if (!s) {
+      s = (ThreadPool::getTID() + 1) * UINT64_C(0x9E3779B97F4A7C15);
+    }
+    return s;
+  }
+
+  //! q must be locked
+  static void update(Queue& q) {
+    if (!q.heap.empty()) {
+      q.top.store(q.heap.front().first, std::memory_order_relaxed);
+    }
+    q.size.store(q.heap.size(), std::memory_order_relaxed);
+  }
+
+  //! q must be locked
+  static std::optional<value_type> popLocked(Queue& q) {
+    if (q.heap.empty()) {
+      return std::nullopt;
+    }
+    std::pop_heap(q.heap.begin(), q.heap.end(), Later());
+    std::optional<value_type> item(std::move(q.heap.back().second));
+    q.heap.pop_back();
+    update(q);
+    return item;
+  }
+
+  //! look at every heap, so that no item is left behind when the loop
+  //! checks for termination
+  KATANA_ATTRIBUTE_NOINLINE
+  std::optional<value_type> slowPop(uint64_t& s) {
+    size_t start = &pick(s) - queues_.get();
+    for (size_t i = 0; i < num_; ++i) {
+      Queue& q = queues_[(start + i) % num_];
+      if (!q.size.load(std::memory_order_relaxed)) {
+        continue;
+      }
+      q.lock.lock();
+      std::optional<value_type> item = popLocked(q);
+      q.lock.unlock();
+      if (item) {
+        return item;
+      }
+    }
+    return std::nullopt;
+  }
+
+public:
+  MultiQueue(const Indexer& x = Indexer())
+      : num_(QueuesPerThread * std::max(getActiveThreads(), 1U)),
+        indexer_(x) {
+    queues_.reset(new Queue[num_]);
+  }
+
+  MultiQueue(const MultiQueue&) = delete;
+  MultiQueue& operator=(const MultiQueue&) = delete;
+
+  void push(const value_type& val) {
+    Index index = indexer_(val);
+    uint64_t& s = rng();
+    while (true) {
+      Queue& q = pick(s);
+      if (!q.lock.try_lock()) {
+        continue;
+      }
+      q.heap.emplace_back(index, val);
+      std::push_heap(q.heap.begin(), q.heap.end(), Later());
+      update(q);
+      q.lock.unlock();
+      return;
+    }
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e) {
+      push(*b++);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    uint64_t& s = rng();
+    for (unsigned i = 0; i < kPopAttempts; ++i) {
+      Queue* a = &pick(s);
+      Queue* b = &pick(s);
+      bool has_a = a->size.load(std::memory_order_relaxed);
+      bool has_b = b->size.load(std::memory_order_relaxed);
+      if (!has_a && !has_b) {
+        continue;
+      }
+      Queue* q = a;
+      if (!has_a || (has_b && b->top.load(std::memory_order_relaxed) <
+                                  a->top.load(std::memory_order_relaxed))) {
+        q = b;
+      }
+      if (!q->lock.try_lock()) {
+        continue;
+      }
+      std::optional<value_type> item = popLocked(*q);
+      q->lock.unlock();
+      if (item) {
+        return item;
+      }
+    }
+    return slowPop(s);
+  }
+};
+KATANA_WLCOMPILECHECK(MultiQueue)
+
+}  // namespace katana
+
+#endif
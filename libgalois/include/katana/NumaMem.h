@@ -21,6 +21,7 @@
 #define KATANA_LIBGALOIS_KATANA_NUMAMEM_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -29,8 +30,22 @@
 namespace katana {
 
 namespace internal {
+
+/// How the pages of a large allocation were faulted in
+enum class LargePlacement : uint8_t {
+  /// not retained by the ScratchPool when freed
+  kNone,
+  kFloating,
+  kLocal,
+  kInterleaved,
+  kBlocked,
+};
+
 struct KATANA_EXPORT largeFreer {
   size_t bytes;
+  LargePlacement placement{LargePlacement::kNone};
+  /// threads for interleaved and blocked placements, the socket for local
+  unsigned num_threads{};
   void operator()(void* ptr) const;
 };
 }  // namespace internal
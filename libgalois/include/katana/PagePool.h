@@ -70,7 +70,7 @@ class PageAllocState {
   void* allocFromOS() {
     void* ptr = katana::allocPages(1, true);
     KATANA_LOG_DEBUG_ASSERT(ptr);
-    auto tid = katana::ThreadPool::getTID();
+    auto tid = katana::ThreadPool::getPoolTID();
     counts[tid] += 1;
     std::lock_guard<katana::SimpleLock> lg(mapLock);
     ownerMap[ptr] = tid;
@@ -101,7 +101,7 @@ public:
   }
 
   void* pageAlloc() {
-    auto tid = katana::ThreadPool::getTID();
+    auto tid = katana::ThreadPool::getPoolTID();
     HeadPtr& hp = pool[tid].data;
     if (hp.getValue()) {
       hp.lock();
@@ -20,7 +20,13 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PARALLELSTL_H_
 #define KATANA_LIBGALOIS_KATANA_PARALLELSTL_H_
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 #include "katana/Chunk.h"
 #include "katana/LoopsDecl.h"
@@ -274,6 +280,293 @@ sort(RandomAccessIterator first, RandomAccessIterator last) {
           typename std::iterator_traits<RandomAccessIterator>::value_type>());
 }
 
+//! ranges at most this long are sorted by a single thread
+constexpr size_t kSerialSortSize = 16 * 1024;
+
+//! \returns the number of blocks that radix and sample sort split n items
+//! into; a few per thread for load balance, but not too small
+inline size_t
+sort_blocks(size_t n) {
+  size_t blocks = 4 * static_cast<size_t>(katana::getActiveThreads());
+  return std::max<size_t>(1, std::min(blocks, n / 4096));
+}
+
+//! Maps an integer to an unsigned integer of the same width and order
+template <typename T>
+std::make_unsigned_t<T>
+radix_key(T v) {
+  using U = std::make_unsigned_t<T>;
+  if constexpr (std::is_signed_v<T>) {
+    return static_cast<U>(v) ^ (U{1} << (std::numeric_limits<U>::digits - 1));
+  } else {
+    return v;
+  }
+}
+
+constexpr unsigned kRadixBits = 8;
+constexpr size_t kRadixBuckets = size_t{1} << kRadixBits;
+
+/**
+ * Stable counting sort of in[0, n) into out by the digit of their keys at
+ * shift. Each block counts its digits, and the offsets of block b for digit
+ * d follow those of all blocks for smaller digits and of the blocks before
+ * b for d, which keeps equal digits in order.
+ *
+ * @returns false, without moving anything, if all keys have the same digit
+ */
+template <typename InIt, typename OutIt, typename KeyFn>
+bool
+radix_pass(
+    InIt in, OutIt out, size_t n, const KeyFn& key_fn, unsigned shift,
+    std::vector<std::array<size_t, kRadixBuckets>>* counts) {
+  const size_t num_blocks = counts->size();
+  const size_t block_size = (n + num_blocks - 1) / num_blocks;
+  auto digit = [&](const auto& v) {
+    return (key_fn(v) >> shift) & (kRadixBuckets - 1);
+  };
+
+  katana::do_all(
+      katana::iterate(size_t{0}, num_blocks),
+      [&](size_t b) {
+        auto& count = (*counts)[b];
+        count.fill(0);
+        size_t end = std::min(n, (b + 1) * block_size);
+        for (size_t i = b * block_size; i < end; ++i) {
+          ++count[digit(in[i])];
+        }
+      },
+      katana::no_stats());
+
+  for (size_t d = 0; d < kRadixBuckets; ++d) {
+    size_t total = 0;
+    for (size_t b = 0; b < num_blocks; ++b) {
+      total += (*counts)[b][d];
+    }
+    if (total == n) {
+      return false;
+    }
+  }
+
+  size_t offset = 0;
+  for (size_t d = 0; d < kRadixBuckets; ++d) {
+    for (size_t b = 0; b < num_blocks; ++b) {
+      size_t count = (*counts)[b][d];
+      (*counts)[b][d] = offset;
+      offset += count;
+    }
+  }
+
+  katana::do_all(
+      katana::iterate(size_t{0}, num_blocks),
+      [&](size_t b) {
+        auto& next = (*counts)[b];
+        size_t end = std::min(n, (b + 1) * block_size);
+        for (size_t i = b * block_size; i < end; ++i) {
+          out[next[digit(in[i])]++] = std::move(in[i]);
+        }
+      },
+      katana::no_stats());
+  return true;
+}
+
+/**
+ * Stable parallel LSD radix sort of [first, last) by key_fn, which maps
+ * each item to an unsigned integer, e.g., the destination of an edge, one
+ * byte per pass. Passes in which all keys share a byte are skipped, so small
+ * keys in wide types cost few passes. Needs a buffer of last - first items,
+ * so the value type must be default constructible.
+ */
+template <class RandomAccessIterator, class KeyFn>
+void
+radix_sort(
+    RandomAccessIterator first, RandomAccessIterator last, KeyFn key_fn) {
+  using T = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  using Key = std::decay_t<std::invoke_result_t<KeyFn, const T&>>;
+  static_assert(
+      std::is_integral_v<Key> && std::is_unsigned_v<Key>,
+      "radix_sort keys must be unsigned integers");
+
+  const size_t n = std::distance(first, last);
+  if (n <= kSerialSortSize) {
+    std::stable_sort(first, last, [&](const T& a, const T& b) {
+      return key_fn(a) < key_fn(b);
+    });
+    return;
+  }
+
+  std::vector<T> buffer(n);
+  std::vector<std::array<size_t, kRadixBuckets>> counts(sort_blocks(n));
+  bool in_buffer = false;
+  for (unsigned shift = 0; shift < std::numeric_limits<Key>::digits;
+       shift += kRadixBits) {
+    bool moved =
+        in_buffer
+            ? radix_pass(buffer.begin(), first, n, key_fn, shift, &counts)
+            : radix_pass(first, buffer.begin(), n, key_fn, shift, &counts);
+    in_buffer ^= moved;
+  }
+
+  if (in_buffer) {
+    katana::do_all(
+        katana::iterate(size_t{0}, n),
+        [&](size_t i) { first[i] = std::move(buffer[i]); }, katana::no_stats());
+  }
+}
+
+//! Stable parallel radix sort of integers
+template <class RandomAccessIterator>
+void
+radix_sort(RandomAccessIterator first, RandomAccessIterator last) {
+  using T = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  static_assert(std::is_integral_v<T>, "radix_sort needs integers");
+  radix_sort(first, last, [](const T& v) { return radix_key(v); });
+}
+
+/**
+ * Stable parallel radix sort of the integers [keys_first, keys_last) that
+ * applies the same permutation to the values starting at values_first.
+ */
+template <class KeyIterator, class ValueIterator>
+void
+radix_sort_by_key(
+    KeyIterator keys_first, KeyIterator keys_last, ValueIterator values_first) {
+  using K = typename std::iterator_traits<KeyIterator>::value_type;
+  using V = typename std::iterator_traits<ValueIterator>::value_type;
+  static_assert(std::is_integral_v<K>, "radix_sort_by_key needs integers");
+
+  const size_t n = std::distance(keys_first, keys_last);
+  std::vector<std::pair<K, V>> items(n);
+  katana::do_all(
+      katana::iterate(size_t{0}, n),
+      [&](size_t i) {
+        items[i].first = keys_first[i];
+        items[i].second = std::move(values_first[i]);
+      },
+      katana::no_stats());
+
+  radix_sort(items.begin(), items.end(), [](const std::pair<K, V>& kv) {
+    return radix_key(kv.first);
+  });
+
+  katana::do_all(
+      katana::iterate(size_t{0}, n),
+      [&](size_t i) {
+        keys_first[i] = items[i].first;
+        values_first[i] = std::move(items[i].second);
+      },
+      katana::no_stats());
+}
+
+/**
+ * Parallel sample sort for any comparator. A sorted random sample gives
+ * splitters for a few buckets per thread; threads move their blocks of
+ * items to the buckets and then sort the buckets independently, so each
+ * item moves twice and there is no recursion. When many items are equal,
+ * they fall in the bucket of their splitter and are split off from the
+ * rest of the bucket without sorting. Needs a buffer of last - first items,
+ * so the value type must be default constructible.
+ */
+template <class RandomAccessIterator, class Compare>
+void
+sample_sort(
+    RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+  using T = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  constexpr size_t kOversample = 32;
+
+  const size_t n = std::distance(first, last);
+  const size_t num_buckets = sort_blocks(n);
+  if (n <= kSerialSortSize || num_buckets == 1) {
+    std::sort(first, last, comp);
+    return;
+  }
+
+  // a fixed seed keeps the splitters, and so the timings, reproducible
+  std::vector<T> sample(num_buckets * kOversample);
+  uint64_t state = UINT64_C(0x9E3779B97F4A7C15);
+  for (T& v : sample) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    v = first[state % n];
+  }
+  std::sort(sample.begin(), sample.end(), comp);
+  std::vector<T> splitters(num_buckets - 1);
+  for (size_t i = 0; i < splitters.size(); ++i) {
+    splitters[i] = sample[(i + 1) * kOversample];
+  }
+
+  // the blocks of the input are the same as the buckets in number
+  const size_t block_size = (n + num_buckets - 1) / num_buckets;
+  std::vector<uint32_t> bucket_of(n);
+  std::vector<size_t> next(num_buckets * num_buckets);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_buckets),
+      [&](size_t b) {
+        size_t* count = &next[b * num_buckets];
+        size_t end = std::min(n, (b + 1) * block_size);
+        for (size_t i = b * block_size; i < end; ++i) {
+          uint32_t bucket = std::upper_bound(
+                                splitters.begin(), splitters.end(), first[i],
+                                comp) -
+                            splitters.begin();
+          bucket_of[i] = bucket;
+          ++count[bucket];
+        }
+      },
+      katana::no_stats());
+
+  std::vector<size_t> bucket_begin(num_buckets + 1);
+  size_t offset = 0;
+  for (size_t d = 0; d < num_buckets; ++d) {
+    bucket_begin[d] = offset;
+    for (size_t b = 0; b < num_buckets; ++b) {
+      size_t count = next[b * num_buckets + d];
+      next[b * num_buckets + d] = offset;
+      offset += count;
+    }
+  }
+  bucket_begin[num_buckets] = n;
+
+  std::vector<T> buffer(n);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_buckets),
+      [&](size_t b) {
+        size_t* bucket_next = &next[b * num_buckets];
+        size_t end = std::min(n, (b + 1) * block_size);
+        for (size_t i = b * block_size; i < end; ++i) {
+          buffer[bucket_next[bucket_of[i]]++] = std::move(first[i]);
+        }
+      },
+      katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(size_t{0}, num_buckets),
+      [&](size_t d) {
+        auto b = buffer.begin() + bucket_begin[d];
+        auto e = buffer.begin() + bucket_begin[d + 1];
+        if (d > 0 && size_t(e - b) > 2 * (n / num_buckets)) {
+          // bucket d starts at splitters[d - 1]; items equal to it need no
+          // sorting
+          const T& lower = splitters[d - 1];
+          b = std::partition(
+              b, e, [&](const T& v) { return !comp(lower, v); });
+        }
+        std::sort(b, e, comp);
+        std::move(
+            buffer.begin() + bucket_begin[d], e, first + bucket_begin[d]);
+      },
+      katana::steal(), katana::no_stats());
+}
+
+template <class RandomAccessIterator>
+void
+sample_sort(RandomAccessIterator first, RandomAccessIterator last) {
+  katana::ParallelSTL::sample_sort(
+      first, last,
+      std::less<
+          typename std::iterator_traits<RandomAccessIterator>::value_type>());
+}
+
 template <class InputIterator, class T, typename BinaryOperation>
 T
 accumulate(
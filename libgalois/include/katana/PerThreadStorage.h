@@ -179,26 +179,31 @@ public:
 
   //! Like getLocal() but optimized for when you already know the thread id
   T* getLocal(unsigned int thread) {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::toPoolTID(thread));
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getLocal(unsigned int thread) const {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::toPoolTID(thread));
     return reinterpret_cast<T*>(ditem);
   }
 
+  //! thread counts like ThreadPool::getTID, so inside a thread group only
+  //! the storage of the threads of the group is reachable
   T* getRemote(unsigned int thread) {
-    void* ditem = b->getRemote(thread, offset);
+    void* ditem = b->getRemote(ThreadPool::toPoolTID(thread), offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getRemote(unsigned int thread) const {
-    void* ditem = b->getRemote(thread, offset);
+    void* ditem = b->getRemote(ThreadPool::toPoolTID(thread), offset);
     return reinterpret_cast<T*>(ditem);
   }
 
-  unsigned size() const { return GetThreadPool().getMaxThreads(); }
+  unsigned size() const {
+    return ThreadPool::getGroup() ? GetThreadPool().getMaxUsableThreads()
+                                  : GetThreadPool().getMaxThreads();
+  }
 
   iterator begin() { return iterator(*this, 0); }
 
@@ -217,7 +222,7 @@ class PerSocketStorage {
   void destruct() {
     auto& tp = GetThreadPool();
     for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(tp.getLeaderForSocket(n), offset))
+      reinterpret_cast<T*>(b->getRemote(tp.getPoolLeaderForSocket(n), offset))
           ->~T();
     }
     b->deallocOffset(offset, sizeof(T));
@@ -235,7 +240,7 @@ public:
     offset = b->allocOffset(sizeof(T));
     auto& tp = GetThreadPool();
     for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      new (b->getRemote(tp.getLeaderForSocket(n), offset))
+      new (b->getRemote(tp.getPoolLeaderForSocket(n), offset))
           T(std::forward<Args>(args)...);
     }
   }
@@ -267,32 +272,34 @@ public:
 
   //! Like getLocal() but optimized for when you already know the thread id
   T* getLocal(unsigned int thread) {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::toPoolTID(thread));
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getLocal(unsigned int thread) const {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::toPoolTID(thread));
     return reinterpret_cast<T*>(ditem);
   }
 
   T* getRemote(unsigned int thread) {
-    void* ditem = b->getRemote(thread, offset);
+    void* ditem = b->getRemote(ThreadPool::toPoolTID(thread), offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getRemote(unsigned int thread) const {
-    void* ditem = b->getRemote(thread, offset);
+    void* ditem = b->getRemote(ThreadPool::toPoolTID(thread), offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   T* getRemoteByPkg(unsigned int pkg) {
-    void* ditem = b->getRemote(GetThreadPool().getLeaderForSocket(pkg), offset);
+    void* ditem =
+        b->getRemote(GetThreadPool().getPoolLeaderForSocket(pkg), offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getRemoteByPkg(unsigned int pkg) const {
-    void* ditem = b->getRemote(GetThreadPool().getLeaderForSocket(pkg), offset);
+    void* ditem =
+        b->getRemote(GetThreadPool().getPoolLeaderForSocket(pkg), offset);
     return reinterpret_cast<T*>(ditem);
   }
 
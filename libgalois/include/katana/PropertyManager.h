@@ -1,7 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 
 #include "katana/Cache.h"
 #include "katana/Manager.h"
@@ -10,6 +18,21 @@
 namespace katana {
 
 /// Manager for property memory
+///
+/// When asked to free standby memory the manager evicts cached properties by
+/// how much they are worth keeping: the time it took to load them (estimated
+/// from size and storage location if unknown) scaled by how often they have
+/// been reused, per byte they occupy. A large column that is cheap to reload
+/// from local storage goes before a small one that was slow to fetch.
+///
+/// If KATANA_PROPERTY_SPILL_DIR names a directory, evicted properties are
+/// written there as Arrow IPC files instead of being dropped, and a later
+/// request for one memory maps it back rather than refetching it from its
+/// original, possibly remote, location. Spill files are written by a
+/// background thread, so eviction does not wait for them; a property
+/// requested before its file is written is handed back from memory. Evicted
+/// properties waiting to be written are bounded in size; beyond that, they
+/// are dropped instead of spilled.
 class KATANA_EXPORT PropertyManager : public Manager {
 public:
   PropertyManager();
@@ -25,8 +48,23 @@ public:
   /// Returns nullptr if manager does not have it in the cache
   std::shared_ptr<arrow::Table> GetProperty(const katana::URI& property_path);
 
-  /// The property data has come into memory from storage.
-  void PropertyLoadedActive(const std::shared_ptr<arrow::Table>& property);
+  /// The property data at \p property_path has come into memory from storage,
+  /// which took \p load_us microseconds.
+  void PropertyLoadedActive(
+      const std::shared_ptr<arrow::Table>& property,
+      const katana::URI& property_path, uint64_t load_us);
+
+  /// A property loaded from \p property_path that a graph still holds, or
+  /// nullptr. Graphs that load the same file, such as versions of a graph
+  /// that did not change the property, can share one copy of it this way.
+  std::shared_ptr<arrow::Table> GetSharedProperty(
+      const katana::URI& property_path);
+
+  /// Make \p property, loaded from \p property_path, available to
+  /// GetSharedProperty for as long as some graph holds its column.
+  void ShareProperty(
+      const std::shared_ptr<arrow::Table>& property,
+      const katana::URI& property_path);
 
   /// We are done with the property.  Put it in the cache if we have room.
   void PutProperty(
@@ -34,6 +72,10 @@ public:
       const std::shared_ptr<arrow::Table>& property);
 
   CacheStats GetPropertyCacheStats() const { return cache_->GetStats(); }
+
+  /// Directory that evicted properties are spilled to, empty if spilling is
+  /// disabled
+  const std::string& spill_dir() const { return spill_dir_; }
   void LogMemoryStats(const std::string& message);
   struct Stats {
     void Log() const {
@@ -42,16 +84,95 @@ public:
           {
               {"bytes_loaded", bytes_loaded},
               {"gb_loaded", katana::ToGB(bytes_loaded)},
+              {"bytes_shared", bytes_shared},
           });
     }
     count_t bytes_loaded{0LL};
+    /// Bytes of properties handed out by GetSharedProperty instead of being
+    /// loaded again
+    count_t bytes_shared{0LL};
   };
-  Stats GetStats() const { return stats; }
+  Stats GetStats() const {
+    return Stats{
+        .bytes_loaded = bytes_loaded_.load(std::memory_order_relaxed),
+        .bytes_shared = bytes_shared_.load(std::memory_order_relaxed)};
+  }
 
 private:
+  struct ReloadCost {
+    uint64_t load_us{};
+    uint64_t reuse_count{};
+    /// Value of reload_costs_clock_ when the property was last used
+    uint64_t last_use{};
+  };
+
+  /// The reload cost of property_path, added if it is missing, with its use
+  /// recorded. The caller holds reload_costs_mutex_.
+  ReloadCost& TouchReloadCost(const katana::URI& property_path);
+
+  /// Higher is more worth keeping; see class comment
+  double RetentionScore(
+      const katana::URI& property_path,
+      const std::shared_ptr<arrow::Table>& property) const;
+
   void MakePropertyCache();
+
+  /// Queue an evicted property to be written to the spill directory by the
+  /// spill thread, or drop it if the queue is full
+  void SpillProperty(
+      const katana::URI& property_path,
+      std::shared_ptr<arrow::Table>&& property);
+  /// Write a queued property to the spill directory; on failure the property
+  /// is simply dropped
+  void WriteSpill(
+      const katana::URI& property_path,
+      const std::shared_ptr<arrow::Table>& property);
+  /// Body of spill_thread_: write queued properties until stop_spilling_
+  void SpillLoop();
+  /// Map a spilled property back in, nullptr if it was not spilled
+  std::shared_ptr<arrow::Table> UnspillProperty(
+      const katana::URI& property_path);
+  /// Report the property cache statistics as metrics; see Metrics.h
+  void AddMetricsCollector();
+
   std::unique_ptr<PropertyCache> cache_;
-  Stats stats;
+  // Properties are loaded by many graphs at once
+  std::atomic<count_t> bytes_loaded_{0LL};
+  std::atomic<count_t> bytes_shared_{0LL};
+
+  // Outlives cache entries so that a property keeps its history across
+  // evictions, but only for the most recently used properties; see
+  // TouchReloadCost. Lock order: cache shard lock, then this mutex.
+  mutable std::mutex reload_costs_mutex_;
+  std::unordered_map<katana::URI, ReloadCost, katana::URI::Hash> reload_costs_;
+  uint64_t reload_costs_clock_{0};
+
+  std::string spill_dir_;
+  // Spill file for each spilled property
+  std::mutex spilled_mutex_;
+  std::unordered_map<katana::URI, std::string, katana::URI::Hash> spilled_;
+  // Evicted properties waiting for spill_thread_, oldest first; guarded by
+  // spilled_mutex_
+  std::deque<std::pair<katana::URI, std::shared_ptr<arrow::Table>>>
+      spill_queue_;
+  // Approximate bytes of the queued properties and of the one being written;
+  // guarded by spilled_mutex_
+  uint64_t spill_queue_bytes_{0};
+  std::condition_variable spill_cv_;
+  bool stop_spilling_{false};
+  std::thread spill_thread_;
+
+  // Shared properties are held by the graphs using them; the table a
+  // property was loaded as does not outlive adding it to a graph, so the
+  // column is what is tracked
+  struct SharedProperty {
+    std::shared_ptr<arrow::Field> field;
+    std::weak_ptr<arrow::ChunkedArray> column;
+  };
+  std::mutex shared_mutex_;
+  std::unordered_map<katana::URI, SharedProperty, katana::URI::Hash> shared_;
+
+  uint64_t metrics_collector_id_{};
 };
 
 }  // namespace katana
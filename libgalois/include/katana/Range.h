@@ -206,7 +206,7 @@ public:
 private:
   std::pair<local_iterator, local_iterator> local_pair() const {
     return katana::block_range(
-        begin_, end_, ThreadPool::getTID(), katana::activeThreads);
+        begin_, end_, ThreadPool::getTID(), ThreadPool::getActiveThreads());
   }
 
   Iterator begin_;
@@ -244,7 +244,7 @@ private:
    */
   std::pair<local_iterator, local_iterator> local_pair() const {
     uint32_t my_thread_id = ThreadPool::getTID();
-    uint32_t total_threads = activeThreads;
+    uint32_t total_threads = ThreadPool::getActiveThreads();
 
     iterator local_begin = thread_beginnings_[my_thread_id];
     iterator local_end = thread_beginnings_[my_thread_id + 1];
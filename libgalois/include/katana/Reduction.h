@@ -20,8 +20,10 @@
 #ifndef KATANA_LIBGALOIS_KATANA_REDUCTION_H_
 #define KATANA_LIBGALOIS_KATANA_REDUCTION_H_
 
+#include <algorithm>
 #include <functional>
 #include <limits>
+#include <vector>
 
 #include "katana/PerThreadStorage.h"
 #include "katana/config.h"
@@ -226,5 +228,71 @@ public:
       : base_type(std::logical_or<bool>(), identity_value<bool, false>()) {}
 };
 
+/**
+ * Keeps the k greatest values under Compare passed to update, e.g., the
+ * nodes with the highest scores. Each thread keeps a bounded heap of at
+ * most k values, so, unlike a Reducible of vectors, updates do not
+ * allocate once a thread holds k values and reduce merges at most k values
+ * per thread.
+ */
+template <typename T, typename Compare = std::less<T>>
+class GTopK {
+  //! orders the heaps so that their front is the least value kept
+  struct Greater {
+    Compare comp;
+    bool operator()(const T& lhs, const T& rhs) const {
+      return comp(rhs, lhs);
+    }
+  };
+
+  katana::PerThreadStorage<std::vector<T>> data_;
+  size_t k_;
+  Greater greater_;
+
+  void push(std::vector<T>& heap, const T& value) {
+    if (heap.size() < k_) {
+      heap.push_back(value);
+      std::push_heap(heap.begin(), heap.end(), greater_);
+    } else if (k_ > 0 && greater_.comp(heap.front(), value)) {
+      std::pop_heap(heap.begin(), heap.end(), greater_);
+      heap.back() = value;
+      std::push_heap(heap.begin(), heap.end(), greater_);
+    }
+  }
+
+public:
+  using value_type = T;
+
+  explicit GTopK(size_t k, Compare comp = Compare())
+      : k_(k), greater_{comp} {}
+
+  void update(const T& value) { push(*data_.getLocal(), value); }
+
+  /**
+   * Returns the k greatest values, greatest first. Only valid outside the
+   * parallel region.
+   */
+  std::vector<T> reduce() {
+    std::vector<T>& lhs = *data_.getLocal();
+    for (unsigned int i = 1; i < data_.size(); ++i) {
+      std::vector<T>& rhs = *data_.getRemote(i);
+      for (const T& value : rhs) {
+        push(lhs, value);
+      }
+      rhs.clear();
+    }
+
+    std::vector<T> result(lhs);
+    std::sort_heap(result.begin(), result.end(), greater_);
+    return result;
+  }
+
+  void reset() {
+    for (unsigned int i = 0; i < data_.size(); ++i) {
+      data_.getRemote(i)->clear();
+    }
+  }
+};
+
 }  // namespace katana
 #endif
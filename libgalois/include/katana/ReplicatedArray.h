@@ -0,0 +1,111 @@
+#ifndef KATANA_LIBGALOIS_KATANA_REPLICATEDARRAY_H_
+#define KATANA_LIBGALOIS_KATANA_REPLICATEDARRAY_H_
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "katana/Loops.h"
+#include "katana/NumaMem.h"
+#include "katana/Range.h"
+#include "katana/ThreadPool.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A read-only array with one copy per socket, for data that is read at
+/// random by every thread, like the topology of a graph, where reading a
+/// replica on the socket of the reading thread avoids remote memory traffic
+/// at the cost of one copy of the array per socket.
+///
+/// Each replica is allocated and copied by threads of its socket, so that
+/// its pages are placed there. Replicas of sockets without active threads
+/// are made by the calling thread.
+template <typename T>
+class ReplicatedArray {
+  static_assert(
+      std::is_trivially_copyable<T>::value,
+      "ReplicatedArray copies its elements bytewise");
+
+public:
+  ReplicatedArray() = default;
+
+  /// Replicate the size elements at data on every socket of the machine.
+  static ReplicatedArray Make(const T* data, size_t size) {
+    ReplicatedArray ret;
+    ret.size_ = size;
+    if (size == 0) {
+      return ret;
+    }
+
+    auto& tp = GetThreadPool();
+    unsigned num_sockets = tp.getMaxSockets();
+    ret.memory_.resize(num_sockets);
+    ret.replicas_.resize(num_sockets, nullptr);
+    size_t bytes = size * sizeof(T);
+
+    // the first active thread of each socket allocates its replica...
+    on_each([&](unsigned tid, unsigned) {
+      unsigned socket = tp.getSocket(tid);
+      for (unsigned t = 0; t < tid; ++t) {
+        if (tp.getSocket(t) == socket) {
+          return;
+        }
+      }
+      ret.memory_[socket] = largeMallocLocal(bytes);
+      ret.replicas_[socket] = static_cast<T*>(ret.memory_[socket].get());
+    });
+
+    // ...and all of them copy their share of it
+    on_each([&](unsigned tid, unsigned num) {
+      unsigned socket = tp.getSocket(tid);
+      unsigned rank = 0;
+      unsigned peers = 0;
+      for (unsigned t = 0; t < num; ++t) {
+        if (tp.getSocket(t) == socket) {
+          rank += t < tid;
+          ++peers;
+        }
+      }
+      auto [begin, end] = block_range(size_t{0}, size, rank, peers);
+      std::memcpy(
+          ret.replicas_[socket] + begin, data + begin,
+          (end - begin) * sizeof(T));
+    });
+
+    for (unsigned socket = 0; socket < num_sockets; ++socket) {
+      if (!ret.replicas_[socket]) {
+        ret.memory_[socket] = largeMallocLocal(bytes);
+        ret.replicas_[socket] = static_cast<T*>(ret.memory_[socket].get());
+        std::memcpy(ret.replicas_[socket], data, bytes);
+      }
+    }
+
+    return ret;
+  }
+
+  /// The replica on the socket of the calling thread
+  const T* local() const { return on(ThreadPool::getSocket()); }
+
+  /// The replica on socket, or nullptr if the array is empty
+  const T* on(unsigned socket) const {
+    return replicas_.empty() ? nullptr : replicas_[socket];
+  }
+
+  size_t size() const { return size_; }
+
+  size_t num_replicas() const { return replicas_.size(); }
+
+  /// The memory taken by all the replicas
+  size_t SizeBytes() const { return num_replicas() * size_ * sizeof(T); }
+
+private:
+  size_t size_{0};
+  std::vector<LAptr> memory_;
+  std::vector<T*> replicas_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ROARINGBITMAP_H_
+#define KATANA_LIBGALOIS_KATANA_ROARINGBITMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// A compressed set of uint32 values laid out as a Roaring bitmap:
+///   Daniel Lemire, Gregory Ssi-Yan-Kai, and Owen Kaser. Consistently
+///   faster and smaller compressed bitmaps with Roaring. Software: Practice
+///   and Experience 46(11), 2016.
+///
+/// Values are grouped by their high 16 bits into containers of their low 16
+/// bits. A container of at most kMaxArrayValues values is a sorted array
+/// and a fuller one is a bitmap of 2^16 bits, whose unions and
+/// intersections are word by word loops the compiler vectorizes. Sets of
+/// clustered values, such as the neighborhoods or reachable sets of nodes
+/// numbered by locality, take far less memory than a DynamicBitset over all
+/// nodes, and sparse ones far less than one bit per node.
+///
+/// A bitmap is not safe to modify concurrently; the static bulk operations
+/// work on many containers in parallel.
+class KATANA_EXPORT RoaringBitmap {
+public:
+  /// Containers with more values than this are bitmaps
+  static constexpr uint32_t kMaxArrayValues = 4096;
+
+  RoaringBitmap() = default;
+
+  /// \returns the set of values, which must be sorted
+  static RoaringBitmap FromSorted(const std::vector<uint32_t>& values);
+
+  /// Add value to the set. \returns whether it was not in the set.
+  bool Add(uint32_t value);
+
+  /// Remove value from the set. \returns whether it was in the set.
+  bool Remove(uint32_t value);
+
+  bool Contains(uint32_t value) const;
+
+  /// \returns the number of values in the set
+  uint64_t Cardinality() const;
+
+  bool empty() const { return keys_.empty(); }
+
+  void clear();
+
+  /// Add the values of other
+  RoaringBitmap& operator|=(const RoaringBitmap& other);
+
+  /// Remove the values not in other
+  RoaringBitmap& operator&=(const RoaringBitmap& other);
+
+  /// Remove the values in other
+  RoaringBitmap& operator-=(const RoaringBitmap& other);
+
+  /// \returns whether every value of this set is in other
+  bool IsSubsetOf(const RoaringBitmap& other) const;
+
+  /// \returns whether the sets share a value, without building their
+  /// intersection
+  bool Intersects(const RoaringBitmap& other) const;
+
+  bool operator==(const RoaringBitmap& other) const;
+  bool operator!=(const RoaringBitmap& other) const {
+    return !(*this == other);
+  }
+
+  /// Call func on each value in increasing order
+  template <typename Func>
+  void ForEach(Func func) const {
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      uint32_t high = static_cast<uint32_t>(keys_[i]) << 16;
+      const Container& container = containers_[i];
+      if (container.IsBitmap()) {
+        for (size_t w = 0; w < kBitmapWords; ++w) {
+          uint64_t word = container.words[w];
+          while (word) {
+            uint32_t low = w * 64 + __builtin_ctzll(word);
+            func(high | low);
+            word &= word - 1;
+          }
+        }
+      } else {
+        for (uint16_t low : container.values) {
+          func(high | low);
+        }
+      }
+    }
+  }
+
+  /// \returns the values in increasing order
+  std::vector<uint32_t> ToVector() const;
+
+  /// \returns the number of bytes the containers hold
+  size_t SizeInBytes() const;
+
+  /// \returns the union of bitmaps, computed a container key at a time in
+  /// parallel
+  static RoaringBitmap ParallelUnion(
+      const std::vector<const RoaringBitmap*>& bitmaps);
+
+  /// \returns the intersection of a and b, computed a container key at a
+  /// time in parallel
+  static RoaringBitmap ParallelIntersection(
+      const RoaringBitmap& a, const RoaringBitmap& b);
+
+private:
+  static constexpr size_t kBitmapWords = (1 << 16) / 64;
+
+  /// The low 16 bits of the values with the same high 16 bits: a sorted
+  /// array, or a bitmap of kBitmapWords words when words is not empty
+  struct Container {
+    std::vector<uint16_t> values;
+    std::vector<uint64_t> words;
+    uint32_t cardinality{0};
+
+    bool IsBitmap() const { return !words.empty(); }
+
+    bool Add(uint16_t low);
+    bool Remove(uint16_t low);
+    bool Contains(uint16_t low) const;
+
+    void UnionWith(const Container& other);
+    void IntersectWith(const Container& other);
+    void SubtractWith(const Container& other);
+    bool IsSubsetOf(const Container& other) const;
+    bool Intersects(const Container& other) const;
+    bool operator==(const Container& other) const;
+
+    /// Switch to the representation that suits cardinality
+    void Normalize();
+    void ToBitmap();
+    void ToArray();
+  };
+
+  /// The index of the container for key, or of where it would go
+  size_t Find(uint16_t key) const;
+
+  /// Move the container at index from to index to, which is not after it
+  void Keep(size_t from, size_t to);
+
+  /// Drop the containers at and after index size
+  void Truncate(size_t size);
+
+  /// The sorted high 16 bits of the values and their containers
+  std::vector<uint16_t> keys_;
+  std::vector<Container> containers_;
+};
+
+}  // namespace katana
+
+#endif
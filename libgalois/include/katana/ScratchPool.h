@@ -0,0 +1,113 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SCRATCHPOOL_H_
+#define KATANA_LIBGALOIS_KATANA_SCRATCHPOOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "katana/Manager.h"
+#include "katana/NumaMem.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Retains large allocations, e.g., the scratch NUMAArrays of analytics,
+/// after they are freed so that a later allocation of the same size and
+/// placement reuses pages that are already faulted in instead of mapping
+/// and faulting in new ones.
+///
+/// The pool belongs to the GaloisRuntime and serves the largeMalloc
+/// functions, except largeMallocSpecified. It keeps at most capacity bytes,
+/// KATANA_SCRATCH_POOL_BYTES or a sixteenth of physical memory by default,
+/// and its bytes count as standby memory of the "scratch" manager of the
+/// MemorySupervisor, which reclaims them, oldest first, under memory
+/// pressure. Because the supervisor needs a ProgressTracer, nothing is
+/// retained until one is set, e.g., by SharedMemSys. Reused memory is not
+/// zeroed.
+class KATANA_EXPORT ScratchPool {
+public:
+  struct Key {
+    size_t bytes;
+    internal::LargePlacement placement;
+    unsigned num_threads;
+
+    bool operator<(const Key& o) const {
+      return std::tie(bytes, placement, num_threads) <
+             std::tie(o.bytes, o.placement, o.num_threads);
+    }
+  };
+
+  struct Stats {
+    uint64_t hits{};
+    uint64_t misses{};
+    size_t retained_bytes{};
+  };
+
+  explicit ScratchPool(size_t capacity);
+  ~ScratchPool();
+
+  ScratchPool(const ScratchPool&) = delete;
+  ScratchPool& operator=(const ScratchPool&) = delete;
+  ScratchPool(ScratchPool&&) = delete;
+  ScratchPool& operator=(ScratchPool&&) = delete;
+
+  /// \returns a retained allocation that matches key or nullptr
+  void* Take(const Key& key);
+
+  /// Retain ptr, unless that would exceed the capacity
+  /// \returns true if ptr was retained, false if the caller must free it
+  bool Put(const Key& key, void* ptr);
+
+  /// Free retained allocations, oldest first, until at least goal bytes are
+  /// freed or none are left
+  /// \returns the number of bytes freed
+  size_t Release(size_t goal);
+
+  /// Change the capacity, releasing retained bytes above it
+  void SetCapacity(size_t capacity);
+  size_t capacity() const;
+
+  Stats GetStats() const;
+
+  /// The capacity from the environment
+  static size_t DefaultCapacity();
+
+private:
+  struct Entry {
+    Key key;
+    void* ptr;
+  };
+  using Entries = std::list<Entry>;
+
+  /// taken after the lock of the MemorySupervisor, if at all
+  mutable std::mutex mutex_;
+  /// oldest first
+  Entries entries_;
+  std::multimap<Key, Entries::iterator> by_key_;
+  size_t capacity_;
+  Stats stats_;
+};
+
+/// Manager for the memory retained by the ScratchPool of the current
+/// GaloisRuntime
+class KATANA_EXPORT ScratchManager : public Manager {
+public:
+  static const std::string name_;
+  const std::string& Name() const override { return name_; }
+  count_t FreeStandbyMemory(count_t goal) override;
+};
+
+namespace internal {
+
+KATANA_EXPORT void SetScratchPool(ScratchPool* pool);
+KATANA_EXPORT ScratchPool* GetScratchPool();
+
+}  // namespace internal
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SORTEDINTERSECTION_H_
+#define KATANA_LIBGALOIS_KATANA_SORTEDINTERSECTION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Intersections of sets of 32-bit integers, e.g., node IDs in sorted edge
+/// lists, given as strictly increasing arrays. Duplicate elements are not
+/// supported.
+///
+/// Sets of similar size are intersected in blocks of 16 (AVX-512F) or 8
+/// (AVX2) elements, which compares every element of a block of one set with
+/// every element of a block of the other at once, or merged on machines
+/// without them. When one set is much smaller than the other, each of its
+/// elements is searched for in the larger one with galloping (exponential)
+/// search instead. The kernels are chosen once for this machine.
+
+/// \returns the number of elements common to a and b
+KATANA_EXPORT size_t SortedIntersectionSize(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size);
+
+/// Write the elements common to a and b to out in increasing order; out
+/// must have room for the smaller of a_size and b_size elements
+/// \returns the end of the elements written to out
+KATANA_EXPORT uint32_t* SortedIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out);
+
+/// A set of integers as a bitmap for intersecting a set with many others
+/// in time linear in the size of the other, e.g., the edge list of a high
+/// degree node (hub) with the edge lists of its neighbors. Reusing the
+/// bitmap for another set only clears the words of the previous one.
+class KATANA_EXPORT SortedSetBitmap {
+public:
+  /// Replace the set with the size elements of set, which need not be
+  /// sorted
+  void Assign(const uint32_t* set, size_t size);
+
+  /// Remove all elements
+  void Clear();
+
+  bool Contains(uint32_t x) const {
+    size_t word = x / 64;
+    return word < words_.size() && (words_[word] >> (x % 64)) & 1;
+  }
+
+  /// \returns the number of elements of b in the set
+  size_t IntersectionSize(const uint32_t* b, size_t b_size) const;
+
+  /// Write the elements of b in the set to out in the order of b; out must
+  /// have room for b_size elements
+  /// \returns the end of the elements written to out
+  uint32_t* Intersection(const uint32_t* b, size_t b_size, uint32_t* out) const;
+
+private:
+  std::vector<uint64_t> words_;
+  /// the elements of the set, to clear them
+  std::vector<uint32_t> set_;
+};
+
+}  // namespace katana
+
+#endif
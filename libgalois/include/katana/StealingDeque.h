@@ -0,0 +1,301 @@
+#ifndef KATANA_LIBGALOIS_KATANA_STEALINGDEQUE_H_
+#define KATANA_LIBGALOIS_KATANA_STEALINGDEQUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/FixedSizeRing.h"
+#include "katana/Mem.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+/// Chase-Lev work-stealing deque of pointers, following "Correct and
+/// Efficient Work-Stealing for Weak Memory Models" (Le et al., PPoPP 2013).
+/// The owning thread pushes and pops at the bottom, which only needs a CAS
+/// to take the last element; other threads steal from the top with a CAS.
+///
+/// The circular buffer doubles when full. Replaced buffers may still be
+/// read by thieves, so they are kept until the deque is destroyed.
+template <typename T>
+class ChaseLevDeque {
+  struct Buffer {
+    int64_t capacity;
+    std::unique_ptr<std::atomic<T*>[]> slots;
+
+    explicit Buffer(int64_t c)
+        : capacity(c), slots(new std::atomic<T*>[static_cast<size_t>(c)]) {}
+
+    T* get(int64_t i) const {
+      return slots[i & (capacity - 1)].load(std::memory_order_relaxed);
+    }
+    void put(int64_t i, T* x) {
+      slots[i & (capacity - 1)].store(x, std::memory_order_relaxed);
+    }
+  };
+
+  alignas(KATANA_CACHE_LINE_SIZE) std::atomic<int64_t> top_{0};
+  alignas(KATANA_CACHE_LINE_SIZE) std::atomic<int64_t> bottom_{0};
+  std::atomic<Buffer*> buffer_;
+  //! current and replaced buffers; only touched by the owner
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+
+  KATANA_ATTRIBUTE_NOINLINE
+  Buffer* grow(Buffer* old, int64_t t, int64_t b) {
+    auto bigger = std::make_unique<Buffer>(2 * old->capacity);
+    for (int64_t i = t; i < b; ++i) {
+      bigger->put(i, old->get(i));
+    }
+    Buffer* ret = bigger.get();
+    buffers_.emplace_back(std::move(bigger));
+    buffer_.store(ret, std::memory_order_release);
+    return ret;
+  }
+
+public:
+  static constexpr int64_t kInitialCapacity = 64;
+
+  ChaseLevDeque() {
+    buffers_.emplace_back(std::make_unique<Buffer>(kInitialCapacity));
+    buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+  }
+
+  ChaseLevDeque(const ChaseLevDeque&) = delete;
+  ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+  //! (approximately) empty; exact when called by the owner
+  bool empty() const {
+    return bottom_.load(std::memory_order_relaxed) <=
+           top_.load(std::memory_order_relaxed);
+  }
+
+  //! owner only: push x at the bottom
+  void push(T* x) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    Buffer* a = buffer_.load(std::memory_order_relaxed);
+    if (b - t > a->capacity - 1) {
+      a = grow(a, t, b);
+    }
+    a->put(b, x);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  //! owner only: pop the most recently pushed element, or nullptr
+  T* pop() {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Buffer* a = buffer_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    T* x = a->get(b);
+    if (t == b) {
+      // last element: race thieves for it
+      if (!top_.compare_exchange_strong(
+              t, t + 1, std::memory_order_seq_cst,
+              std::memory_order_relaxed)) {
+        x = nullptr;
+      }
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return x;
+  }
+
+  //! any thread: take the least recently pushed element, or nullptr if
+  //! empty or another thread took it first
+  T* steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+    Buffer* a = buffer_.load(std::memory_order_acquire);
+    T* x = a->get(t);
+    if (!top_.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return x;
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Work-stealing worklist. Each thread pushes and pops chunks of ChunkSize
+ * items LIFO on its own lock-free Chase-Lev deque; a thread that runs out
+ * of work steals the oldest full chunk of another thread, trying threads on
+ * its socket first, then threads on its NUMA node and then the rest.
+ *
+ * Compared to \ref PerSocketChunkLIFO, pushing and popping never touch
+ * shared queues, and idle threads take the coarse, old work of busy
+ * threads, which suits irregular, recursive workloads.
+ *
+ * @tparam ChunkSize chunk size
+ */
+template <int ChunkSize = 64, typename T = int, bool Concurrent = true>
+class StealingDeque {
+public:
+  template <typename _T>
+  using retype = StealingDeque<ChunkSize, _T, Concurrent>;
+
+  template <bool _Concurrent>
+  using rethread = StealingDeque<ChunkSize, T, _Concurrent>;
+
+  template <int _chunk_size>
+  using with_chunk_size = StealingDeque<_chunk_size, T, Concurrent>;
+
+  typedef T value_type;
+
+private:
+  using Chunk = FixedSizeRing<T, ChunkSize>;
+
+  struct ThreadData {
+    //! chunk pushed and popped by this thread, not visible to thieves
+    Chunk* cur{nullptr};
+    internal::ChaseLevDeque<Chunk> deque;
+    //! threads to steal from, nearest first
+    std::vector<unsigned> victims;
+  };
+
+  FixedSizeAllocator<Chunk> alloc;
+  PerThreadStorage<ThreadData> data;
+
+  Chunk* mkChunk() {
+    Chunk* ptr = alloc.allocate(1);
+    alloc.construct(ptr);
+    return ptr;
+  }
+
+  void delChunk(Chunk* ptr) {
+    alloc.destroy(ptr);
+    alloc.deallocate(ptr, 1);
+  }
+
+  //! order the other threads by distance from tid; within the same
+  //! distance, start after tid so that thieves spread over victims
+  static std::vector<unsigned> orderVictims(unsigned tid, unsigned num) {
+    auto& tp = GetThreadPool();
+    auto distance = [&](unsigned eid) {
+      if (tp.getSocket(eid) == tp.getSocket(tid)) {
+        return 0;
+      }
+      if (tp.getNumaNode(eid) == tp.getNumaNode(tid)) {
+        return 1;
+      }
+      return 2;
+    };
+    std::vector<unsigned> victims;
+    for (unsigned i = 1; i < num; ++i) {
+      victims.push_back((tid + i) % num);
+    }
+    std::stable_sort(
+        victims.begin(), victims.end(), [&](unsigned a, unsigned b) {
+          return distance(a) < distance(b);
+        });
+    return victims;
+  }
+
+  template <typename... Args>
+  void emplacei(ThreadData& tld, Args&&... args) {
+    if (tld.cur && tld.cur->emplace_back(std::forward<Args>(args)...)) {
+      return;
+    }
+    if (tld.cur) {
+      tld.deque.push(tld.cur);
+    }
+    tld.cur = mkChunk();
+    [[maybe_unused]] T* retval =
+        tld.cur->emplace_back(std::forward<Args>(args)...);
+    KATANA_LOG_DEBUG_ASSERT(retval);
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE
+  Chunk* steal(ThreadData& tld) {
+    for (unsigned eid : tld.victims) {
+      if (Chunk* c = data.getRemote(eid)->deque.steal()) {
+        return c;
+      }
+    }
+    return nullptr;
+  }
+
+public:
+  StealingDeque() {
+    unsigned num = getActiveThreads();
+    for (unsigned i = 0; i < num; ++i) {
+      data.getRemote(i)->victims = orderVictims(i, num);
+    }
+  }
+
+  StealingDeque(const StealingDeque&) = delete;
+  StealingDeque& operator=(const StealingDeque&) = delete;
+
+  ~StealingDeque() {
+    for (unsigned i = 0; i < data.size(); ++i) {
+      ThreadData& tld = *data.getRemote(i);
+      if (tld.cur) {
+        delChunk(tld.cur);
+      }
+      while (Chunk* c = tld.deque.steal()) {
+        delChunk(c);
+      }
+    }
+  }
+
+  void push(const value_type& val) { emplacei(*data.getLocal(), val); }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    ThreadData& tld = *data.getLocal();
+    while (b != e) {
+      emplacei(tld, *b++);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    ThreadData& tld = *data.getLocal();
+    std::optional<value_type> retval;
+    if (tld.cur && (retval = tld.cur->extract_back())) {
+      return retval;
+    }
+    if (tld.cur) {
+      delChunk(tld.cur);
+    }
+    tld.cur = tld.deque.pop();
+    if (!tld.cur) {
+      tld.cur = steal(tld);
+    }
+    if (tld.cur) {
+      return tld.cur->extract_back();
+    }
+    return std::nullopt;
+  }
+};
+KATANA_WLCOMPILECHECK(StealingDeque)
+
+}  // end namespace katana
+
+#endif
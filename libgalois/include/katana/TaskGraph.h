@@ -0,0 +1,174 @@
+#ifndef KATANA_LIBGALOIS_KATANA_TASKGRAPH_H_
+#define KATANA_LIBGALOIS_KATANA_TASKGRAPH_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class TaskGraph;
+
+/// Refers to a task of a TaskGraph, e.g., to make other tasks depend on it
+class KATANA_EXPORT TaskRef {
+public:
+  TaskRef() = default;
+
+private:
+  friend class TaskGraph;
+  explicit TaskRef(size_t id) : id_(id) {}
+
+  size_t id_{0};
+};
+
+/// A task of a TaskGraph that computes a T
+template <typename T>
+class Task : public TaskRef {
+public:
+  Task() = default;
+
+  /// \returns the value computed by the task; only valid once the task
+  /// succeeded, i.e., in tasks that depend on it and after TaskGraph::Run
+  /// returns success
+  const T& value() const {
+    KATANA_LOG_DEBUG_ASSERT(value_ && *value_);
+    return **value_;
+  }
+
+  T& value() {
+    KATANA_LOG_DEBUG_ASSERT(value_ && *value_);
+    return **value_;
+  }
+
+private:
+  friend class TaskGraph;
+  Task(TaskRef ref, std::shared_ptr<std::optional<T>> value)
+      : TaskRef(ref), value_(std::move(value)) {}
+
+  std::shared_ptr<std::optional<T>> value_;
+};
+
+template <>
+class Task<void> : public TaskRef {
+public:
+  Task() = default;
+
+private:
+  friend class TaskGraph;
+  explicit Task(TaskRef ref) : TaskRef(ref) {}
+};
+
+/// A TaskGraph runs dependent tasks, such as loading two properties in
+/// parallel, then building a view of them and then running several
+/// analytics on that view at the same time, so that stages that do not
+/// depend on each other overlap instead of running one after the other.
+///
+/// Each task runs once all of its dependencies succeeded, on a ThreadGroup
+/// of the number of threads it asks for, so the parallel loops it runs
+/// only use those threads. Tasks that are ready run at the same time as
+/// long as there are free threads for their groups. A task that does not
+/// fit while nothing else runs, e.g., when the pool has a single thread,
+/// runs on the whole pool instead.
+///
+/// Tasks return nothing, a value, a Result<void> or a Result of a value.
+/// Task<T>::value gives the value to tasks that depend on it. Once a task
+/// fails, no more tasks start and Run returns the first error after the
+/// running tasks finish.
+///
+///     katana::TaskGraph graph;
+///     auto a = graph.Add([&]() { return LoadA(); }, {}, 4);
+///     auto b = graph.Add([&]() { return LoadB(); }, {}, 4);
+///     auto view = graph.Add(
+///         [&]() { return MakeView(a.value(), b.value()); }, {a, b}, 8);
+///     graph.Add([&]() { return RunBfs(view.value()); }, {view}, 8);
+///     graph.Add([&]() { return RunPageRank(view.value()); }, {view}, 8);
+///     KATANA_CHECKED(graph.Run());
+class KATANA_EXPORT TaskGraph {
+  template <typename R>
+  struct TaskResult {
+    using type = R;
+    static constexpr bool kIsResult = false;
+  };
+
+  template <typename T>
+  struct TaskResult<Result<T>> {
+    using type = T;
+    static constexpr bool kIsResult = true;
+  };
+
+public:
+  /// Add a task that runs fn on num_threads threads once all of deps
+  /// succeeded; deps must be tasks of this graph, so the graph has no
+  /// cycles
+  template <typename Fn>
+  auto Add(
+      Fn fn, const std::vector<TaskRef>& deps = {}, unsigned num_threads = 1)
+      -> Task<typename TaskResult<std::invoke_result_t<Fn&>>::type> {
+    using R = std::invoke_result_t<Fn&>;
+    using T = typename TaskResult<R>::type;
+
+    if constexpr (std::is_void_v<T>) {
+      TaskRef ref = AddNode(
+          [fn = std::move(fn)]() mutable -> Result<void> {
+            if constexpr (TaskResult<R>::kIsResult) {
+              return fn();
+            } else {
+              fn();
+              return ResultSuccess();
+            }
+          },
+          deps, num_threads);
+      return Task<void>(ref);
+    } else {
+      auto value = std::make_shared<std::optional<T>>();
+      TaskRef ref = AddNode(
+          [fn = std::move(fn), value]() mutable -> Result<void> {
+            if constexpr (TaskResult<R>::kIsResult) {
+              auto res = fn();
+              if (!res) {
+                return res.error();
+              }
+              value->emplace(std::move(res.value()));
+            } else {
+              value->emplace(fn());
+            }
+            return ResultSuccess();
+          },
+          deps, num_threads);
+      return Task<T>(ref, std::move(value));
+    }
+  }
+
+  size_t size() const { return nodes_.size(); }
+
+  /// Run all tasks and wait for them to finish. Must be called from the
+  /// master thread outside of parallel loops.
+  Result<void> Run();
+
+private:
+  struct Node {
+    std::function<Result<void>()> fn;
+    std::vector<size_t> successors;
+    size_t num_deps{0};
+    unsigned num_threads{1};
+  };
+
+  TaskRef AddNode(
+      std::function<Result<void>()> fn, const std::vector<TaskRef>& deps,
+      unsigned num_threads);
+
+  std::vector<Node> nodes_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef KATANA_LIBGALOIS_KATANA_THREADGROUP_H_
+#define KATANA_LIBGALOIS_KATANA_THREADGROUP_H_
+
+#include <memory>
+
+#include "katana/Barrier.h"
+#include "katana/TerminationDetection.h"
+#include "katana/ThreadPool.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A set of threads taken out of the thread pool that runs parallel loops on
+/// its own, so that loops started from different threads run at the same
+/// time on disjoint cores instead of one after the other.
+///
+/// A thread runs its loops on a group while a ThreadGroup::Scope for it is
+/// alive. The calling thread then only waits; the first thread of the group
+/// runs the loop as the master thread does for the whole pool. Inside the
+/// loops of a group, ThreadPool::getTID and getActiveThreads count the
+/// threads of the group, PerThreadStorage only reaches their storage, and
+/// barriers and termination detection are the group's own, so loops and
+/// reductions written for the pool work unchanged.
+///
+/// Threads in a group are not used by loops outside of it until the group
+/// is destroyed. Groups must be made while no loop runs, and only one loop
+/// at a time runs on a group.
+class KATANA_EXPORT ThreadGroup {
+public:
+  /// Make the calling thread run its loops on a group until destroyed;
+  /// scopes nest
+  class KATANA_EXPORT Scope {
+  public:
+    explicit Scope(ThreadGroup* group);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    Scope(Scope&&) = delete;
+    Scope& operator=(Scope&&) = delete;
+
+  private:
+    ThreadGroup* prev_group_;
+    unsigned prev_group_begin_;
+    unsigned prev_group_size_;
+    unsigned prev_tid_base_;
+    unsigned prev_group_threads_;
+    char* prev_pts_base_;
+    char* prev_pss_base_;
+  };
+
+  /// \returns a group of num_threads threads, or nullptr if fewer free
+  /// threads are left in a row. Thread 0 is never in a group.
+  static std::unique_ptr<ThreadGroup> Make(unsigned num_threads);
+
+  ~ThreadGroup();
+
+  ThreadGroup(const ThreadGroup&) = delete;
+  ThreadGroup& operator=(const ThreadGroup&) = delete;
+  ThreadGroup(ThreadGroup&&) = delete;
+  ThreadGroup& operator=(ThreadGroup&&) = delete;
+
+  /// \returns the group the calling thread runs its loops on, or nullptr
+  static ThreadGroup* Current() { return ThreadPool::getGroup(); }
+
+  unsigned size() const { return size_; }
+
+  /// \returns the number of threads loops on the group run on, which is
+  /// size() unless setActiveThreads asked for fewer in a Scope of the group
+  unsigned active_threads() const { return active_threads_; }
+
+  /// Run loops on num of the threads of the group, like setActiveThreads
+  /// does for the pool; the calling thread must be in a Scope of the group
+  void SetActiveThreads(unsigned num);
+
+  /// \returns the pool id of the first thread of the group
+  unsigned begin() const { return begin_; }
+
+  /// Like GetBarrier but for the threads of this group
+  Barrier& GetBarrier(unsigned active_threads);
+
+  TerminationDetection& termination_detection() { return *term_; }
+
+private:
+  ThreadGroup(unsigned begin, unsigned size);
+
+  unsigned begin_;
+  unsigned size_;
+  unsigned active_threads_;
+  unsigned barrier_threads_;
+  std::unique_ptr<Barrier> barrier_;
+  std::unique_ptr<TerminationDetection> term_;
+};
+
+}  // namespace katana
+
+#endif
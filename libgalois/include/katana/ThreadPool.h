@@ -20,15 +20,20 @@
 #ifndef KATANA_LIBGALOIS_KATANA_THREADPOOL_H_
 #define KATANA_LIBGALOIS_KATANA_THREADPOOL_H_
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
+#include <mutex>
 #include <thread>
 #include <vector>
 
 #include "katana/CacheLineStorage.h"
+#include "katana/CompilerSpecific.h"
 #include "katana/HWTopo.h"
 #include "katana/Logging.h"
 
@@ -51,9 +56,14 @@ struct ExecuteTupleImpl<tpl, s, 0> {
 
 namespace katana {
 
+extern unsigned activeThreads;
+
+class ThreadGroup;
+
 class KATANA_EXPORT ThreadPool {
 private:
   friend class GaloisRuntime;
+  friend class ThreadGroup;
 
   struct shutdown_ty {};  //! type for shutting down thread
   struct fastmode_ty {
@@ -72,28 +82,116 @@ private:
     std::atomic<int> fastRelease;
     ThreadTopoInfo topo;
 
+    //! work of the current region, passed down the wakeup tree
+    std::function<void(void)>* work{nullptr};
+    //! the thread count of group, which overrides katana::activeThreads
+    //! while group is set
+    unsigned activeThreads{1};
+    //! group of the current region, if any, and its first pool thread
+    ThreadGroup* group{nullptr};
+    unsigned groupBegin{0};
+    unsigned groupSize{0};
+    //! subtracted from topo.tid by getTID
+    unsigned tidBase{0};
+
+    //! take the region of parent
+    void inherit(const per_signal& parent) {
+      work = parent.work;
+      activeThreads = parent.activeThreads;
+      group = parent.group;
+      groupBegin = parent.groupBegin;
+      groupSize = parent.groupSize;
+      tidBase = parent.groupBegin;
+    }
+
+    //! whether the thread blocks on cv; only changed under m
+    std::atomic<bool> parked{false};
+    //! when the thread was last woken up without fastmode, in ns
+    std::atomic<uint64_t> wakeTime{0};
+    //! idle statistics, only written by the thread itself
+    std::atomic<uint64_t> spinWakeups{0};
+    std::atomic<uint64_t> parkWakeups{0};
+    std::atomic<uint64_t> parkLatencyNs{0};
+    std::atomic<uint64_t> maxParkLatencyNs{0};
+
     void wakeup(bool fastmode) {
       if (fastmode) {
         done = 0;
         fastRelease = 1;
       } else {
-        std::lock_guard<std::mutex> lg(m);
+        wakeTime.store(nowNs(), std::memory_order_relaxed);
         done = 0;
-        cv.notify_one();
-        // start.release();
+        // seq_cst done and parked pair with park: either the thread sees
+        // done cleared before it blocks or we see it parked and notify
+        if (parked) {
+          std::lock_guard<std::mutex> lg(m);
+          cv.notify_one();
+        }
       }
     }
 
-    void wait(bool fastmode) {
+    //! wait for wakeup; without fastmode spin for up to spinNs first
+    void wait(bool fastmode, uint64_t spinNs) {
       if (fastmode) {
         while (!fastRelease.load(std::memory_order_relaxed)) {
           asmPause();
         }
         fastRelease = 0;
-      } else {
-        std::unique_lock<std::mutex> lg(m);
-        cv.wait(lg, [=] { return !done; });
-        // start.acquire();
+      } else if (!spin(spinNs)) {
+        park();
+      }
+    }
+
+  private:
+    //! most pauses between two checks while spinning
+    static constexpr unsigned kMaxPauses = 64;
+
+    static uint64_t nowNs() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now().time_since_epoch())
+          .count();
+    }
+
+    static void increment(std::atomic<uint64_t>& stat, uint64_t value = 1) {
+      stat.store(
+          stat.load(std::memory_order_relaxed) + value,
+          std::memory_order_relaxed);
+    }
+
+    //! spin with exponential backoff until woken up or spinNs ran out;
+    //! returns whether woken up
+    bool spin(uint64_t spinNs) {
+      if (!spinNs) {
+        return false;
+      }
+      uint64_t start = nowNs();
+      unsigned pauses = 1;
+      do {
+        if (!done.load(std::memory_order_acquire)) {
+          increment(spinWakeups);
+          return true;
+        }
+        for (unsigned i = 0; i < pauses; ++i) {
+          asmPause();
+        }
+        pauses = std::min(2 * pauses, kMaxPauses);
+      } while (nowNs() - start < spinNs);
+      return false;
+    }
+
+    void park() {
+      std::unique_lock<std::mutex> lg(m);
+      parked = true;
+      cv.wait(lg, [=] { return !done; });
+      parked = false;
+
+      uint64_t now = nowNs();
+      uint64_t woken = wakeTime.load(std::memory_order_relaxed);
+      uint64_t latency = now > woken ? now - woken : 0;
+      increment(parkWakeups);
+      increment(parkLatencyNs, latency);
+      if (latency > maxParkLatencyNs.load(std::memory_order_relaxed)) {
+        maxParkLatencyNs.store(latency, std::memory_order_relaxed);
       }
     }
   };
@@ -107,6 +205,17 @@ private:
   unsigned masterFastmode;
   bool running;
   std::function<void(void)> work;
+  //! threads taken by thread groups
+  std::vector<bool> grouped;
+  //! lowest thread taken by a thread group, or mi.maxThreads
+  unsigned groupedBegin;
+  std::mutex groupLock;
+  //! how long idle threads spin before blocking when not in fastmode
+  std::atomic<uint64_t> spinNs;
+  //! see RunStats; read by other threads, e.g., to export metrics
+  std::atomic<uint64_t> runs{0};
+  std::atomic<uint64_t> runNs{0};
+  std::atomic<uint64_t> threadNs{0};
 
   //! destroy all threads
   void destroyCommon();
@@ -124,7 +233,17 @@ private:
   void decascade();
 
   //! execute work on num threads
-  void runInternal(unsigned num);
+  void runInternal(unsigned num, std::function<void(void)>* work);
+
+  //! execute work on num threads of the group of the calling thread
+  void runInGroup(unsigned num);
+
+  //! take num threads for a thread group; returns the first one or 0 if
+  //! there are not num free threads in a row
+  unsigned acquireGroup(unsigned num);
+
+  //! return the threads of a thread group
+  void releaseGroup(unsigned begin, unsigned num);
 
   ThreadPool();
 
@@ -155,11 +274,9 @@ public:
     // paying for an indirection in work allows small-object optimization in
     // std::function to kick in and avoid a heap allocation
     ExecuteTuple lwork(std::forward<Args>(args)...);
-    work = std::ref(lwork);
-    // work =
-    // std::function<void(void)>(ExecuteTuple(std::forward<Args>(args)...));
+    std::function<void(void)> fn = std::ref(lwork);
     KATANA_LOG_DEBUG_ASSERT(num <= getMaxThreads());
-    runInternal(num);
+    runInternal(num, &fn);
   }
 
   //! run function in a dedicated thread until the threadpool exits
@@ -170,8 +287,58 @@ public:
   // experimental: leave busy wait
   void beKind();
 
-  //! return the number of non-reserved threads in the pool
-  unsigned getMaxUsableThreads() const { return mi.maxThreads - reserved; }
+  //! How idle threads waited for work since the pool started
+  struct IdleStats {
+    //! wakeups that found the thread spinning
+    uint64_t spinWakeups{0};
+    //! wakeups that found the thread blocked
+    uint64_t parkWakeups{0};
+    //! total and largest time from wakeup until a blocked thread ran
+    uint64_t parkLatencyNs{0};
+    uint64_t maxParkLatencyNs{0};
+  };
+
+  //! When not in fastmode, idle threads spin with exponential backoff for
+  //! up to spin before blocking, so that loops started in short succession
+  //! do not pay for waking up blocked threads while idle processes do not
+  //! burn cores. Zero always blocks. Defaults to KATANA_THREAD_SPIN_US or
+  //! kDefaultSpin; threads pick up a change the next time they go idle.
+  void setIdleSpin(std::chrono::microseconds spin) {
+    spinNs = std::chrono::duration_cast<std::chrono::nanoseconds>(spin).count();
+  }
+
+  static constexpr std::chrono::microseconds kDefaultSpin{200};
+
+  //! return the idle statistics summed over all threads
+  IdleStats getIdleStats() const;
+
+  //! Parallel regions run since the pool started, excluding those of thread
+  //! groups
+  struct RunStats {
+    uint64_t runs{0};
+    //! total wall time of the regions
+    uint64_t runNs{0};
+    //! total wall time of the regions times the threads they ran on, which
+    //! over runNs is the average parallelism
+    uint64_t threadNs{0};
+  };
+
+  RunStats getRunStats() const {
+    return RunStats{
+        runs.load(std::memory_order_relaxed),
+        runNs.load(std::memory_order_relaxed),
+        threadNs.load(std::memory_order_relaxed)};
+  }
+
+  //! return the number of threads the calling thread can run a region on:
+  //! the size of its thread group, if any, and otherwise the threads that
+  //! are neither reserved nor in a thread group
+  unsigned getMaxUsableThreads() const {
+    if (my_box.groupSize) {
+      return my_box.groupSize;
+    }
+    return std::min(mi.maxThreads - reserved, groupedBegin);
+  }
   //! return the number of threads supported by the thread pool on the current
   //! machine
   unsigned getMaxThreads() const { return mi.maxThreads; }
@@ -179,30 +346,66 @@ public:
   unsigned getMaxSockets() const { return mi.maxSockets; }
   unsigned getMaxNumaNodes() const { return mi.maxNumaNodes; }
 
+  // The thread ids below count like getTID, so inside a thread group the
+  // leader of a socket is the first thread of the group on it.
+
   unsigned getLeaderForSocket(unsigned pid) const {
-    for (unsigned i = 0; i < getMaxThreads(); ++i)
+    if (!my_box.groupSize) {
+      return getPoolLeaderForSocket(pid);
+    }
+    for (unsigned i = 0; i < my_box.groupSize; ++i)
       if (getSocket(i) == pid && isLeader(i))
         return i;
+    // no thread of the group is on socket pid
+    return 0;
+  }
+
+  //! like getLeaderForSocket but in pool ids, for storage shared by the
+  //! whole pool
+  unsigned getPoolLeaderForSocket(unsigned pid) const {
+    for (unsigned i = 0; i < getMaxThreads(); ++i)
+      if (signals[i]->topo.socket == pid && signals[i]->topo.socketLeader == i)
+        return i;
     abort();
   }
 
-  bool isLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader == tid;
+  bool isLeader(unsigned tid) const { return getLeader(tid) == tid; }
+  unsigned getSocket(unsigned tid) const {
+    return signals[toPoolTID(tid)]->topo.socket;
   }
-  unsigned getSocket(unsigned tid) const { return signals[tid]->topo.socket; }
   unsigned getLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader;
+    return toRegionTID(signals[toPoolTID(tid)]->topo.socketLeader);
   }
   unsigned getCumulativeMaxSocket(unsigned tid) const {
-    return signals[tid]->topo.cumulativeMaxSocket;
+    return signals[toPoolTID(tid)]->topo.cumulativeMaxSocket;
   }
   unsigned getNumaNode(unsigned tid) const {
-    return signals[tid]->topo.numaNode;
+    return signals[toPoolTID(tid)]->topo.numaNode;
   }
 
-  static unsigned getTID() { return my_box.topo.tid; }
-  static bool isLeader() { return my_box.topo.tid == my_box.topo.socketLeader; }
-  static unsigned getLeader() { return my_box.topo.socketLeader; }
+  //! return the id of the calling thread among the threads of the region,
+  //! which inside a thread group counts from the first thread of the group
+  static unsigned getTID() { return my_box.topo.tid - my_box.tidBase; }
+  //! return the id of the calling thread in the pool, which unlike getTID
+  //! is unique across thread groups
+  static unsigned getPoolTID() { return my_box.topo.tid; }
+  //! return the pool id of thread tid of the region of the calling thread
+  static unsigned toPoolTID(unsigned tid) { return tid + my_box.groupBegin; }
+  //! return the id in the region of the calling thread of pool thread tid,
+  //! or of the first thread of the group for threads before the group
+  static unsigned toRegionTID(unsigned tid) {
+    return std::max(tid, my_box.groupBegin) - my_box.groupBegin;
+  }
+  //! return the thread group of the calling thread, or nullptr
+  static ThreadGroup* getGroup() { return my_box.group; }
+  //! return the number of threads loops of the calling thread run on: the
+  //! count set for its thread group if it has one, and the process-wide
+  //! katana::activeThreads otherwise
+  static unsigned getActiveThreads() {
+    return my_box.group ? my_box.activeThreads : katana::activeThreads;
+  }
+  static bool isLeader() { return getTID() == getLeader(); }
+  static unsigned getLeader() { return toRegionTID(my_box.topo.socketLeader); }
   static unsigned getSocket() { return my_box.topo.socket; }
   static unsigned getCumulativeMaxSocket() {
     return my_box.topo.cumulativeMaxSocket;
@@ -20,6 +20,8 @@
 #ifndef KATANA_LIBGALOIS_KATANA_THREADS_H_
 #define KATANA_LIBGALOIS_KATANA_THREADS_H_
 
+#include <string>
+
 #include "katana/config.h"
 
 namespace katana {
@@ -27,15 +29,64 @@ namespace katana {
 /**
  * Sets the number of threads to use when running any Galois iterator. Returns
  * the actual value of threads used, which could be less than the requested
- * value. System behavior is undefined if this function is called during
- * parallel execution or after the first parallel execution.
+ * value, e.g., with elastic threads. System behavior is undefined if this
+ * function is called during parallel execution.
  */
 KATANA_EXPORT unsigned int setActiveThreads(unsigned int num) noexcept;
 
 /**
- * Returns the number of threads in use.
+ * Returns the number of threads in use. Within a ThreadGroup, this and
+ * setActiveThreads count the threads of the group.
  */
 KATANA_EXPORT unsigned int getActiveThreads() noexcept;
 
+/**
+ * Enables or disables elastic threads, which follow the CPU quota of the
+ * cgroup of the process, e.g., when a container orchestrator resizes the
+ * CPU limits of a pod: setActiveThreads and UpdateElasticThreads then run
+ * loops on the threads requested with setActiveThreads but on no more than
+ * the quota allows. Defaults to the value of KATANA_ELASTIC_THREADS or
+ * false.
+ *
+ * The thread pool and per-thread storage cover all the CPUs the process
+ * could run on at startup, so threads come and go without moving storage.
+ * The threads only change at these calls because per-thread containers,
+ * like an InsertBag, filled by one loop and iterated by the next must see
+ * the same threads in both.
+ */
+KATANA_EXPORT void SetElasticThreads(bool enabled) noexcept;
+KATANA_EXPORT bool IsElasticThreads() noexcept;
+
+/**
+ * Checks the CPU quota again and shrinks or grows the active threads to
+ * match, if elastic threads are enabled. Call it outside of loops at points
+ * where no per-thread container is live, e.g., between algorithms of a
+ * long running service. Returns the number of active threads.
+ */
+KATANA_EXPORT unsigned int UpdateElasticThreads() noexcept;
+
+/**
+ * Returns the number of CPUs the CPU quota of the cgroup of the process
+ * allows, rounded up, or 0 if there is no quota, e.g., outside of Linux.
+ */
+KATANA_EXPORT unsigned int GetCPUQuota() noexcept;
+
+namespace internal {
+
+/// The threads last asked for with setActiveThreads, which elastic threads
+/// may not all run
+KATANA_EXPORT unsigned int GetRequestedThreads() noexcept;
+
+/// The CPUs of the cpu.max file of a cgroup v2, e.g., "150000 100000" is 2
+/// and "max 100000" is 0
+KATANA_EXPORT unsigned int ParseCgroupCPUMax(const std::string& cpu_max);
+
+/// The CPUs of a cgroup v1 cpu.cfs_quota_us and cpu.cfs_period_us; a
+/// negative quota is 0
+KATANA_EXPORT unsigned int ParseCgroupCFSQuota(
+    const std::string& quota_us, const std::string& period_us);
+
+}  // namespace internal
+
 }  // namespace katana
 #endif
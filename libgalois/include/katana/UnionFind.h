@@ -20,106 +20,166 @@
 #ifndef KATANA_LIBGALOIS_KATANA_UNIONFIND_H_
 #define KATANA_LIBGALOIS_KATANA_UNIONFIND_H_
 
+#include <algorithm>
 #include <atomic>
-
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <utility>
+
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/Range.h"
+#include "katana/Reduction.h"
+#include "katana/UnionFindNode.h"
 #include "katana/config.h"
 
 namespace katana {
+
 /**
- * Intrusive union-find implementation. Users subclass this to get disjoint
- * functionality for the subclass object.
+ * Lock-free union-find over the integers [0, size), e.g., node ids, stored
+ * as an array of parents, which takes less memory and gives better locality
+ * than an intrusive UnionFindNode per element.
+ *
+ * Union is Rem's algorithm with splicing: it walks up from both elements at
+ * once and, at each step, points the element with the larger parent to the
+ * smaller parent, which shortens the paths of later operations. Parents
+ * are never larger than their children, so concurrent operations cannot
+ * create cycles and the root of each set is its smallest element. Find
+ * splits the path it walks.
+ *
+ * Union, Find and Compress may be called concurrently.
  */
-template <typename T>
-class UnionFindNode {
-  T* findImpl() const {
-    if (isRep())
-      return m_component.load(std::memory_order_relaxed);
-
-    T* rep = m_component;
-    while (rep->m_component != rep) {
-      T* next = rep->m_component.load(std::memory_order_relaxed);
-      rep = next;
-    }
-    return rep;
-  }
-
-protected:
-  std::atomic<T*> m_component;
-
-  UnionFindNode(T* s) : m_component(s) {}
+template <typename T = uint32_t>
+class UnionFind {
+  katana::NUMAArray<std::atomic<T>> parents_;
 
 public:
-  typedef UnionFindNode<T> SuperTy;
+  using value_type = T;
 
-  bool isRep() const {
-    return m_component.load(std::memory_order_relaxed) == this;
-  }
+  UnionFind() = default;
+  explicit UnionFind(size_t size) { Reset(size); }
 
-  T* get() const { return m_component.load(std::memory_order_relaxed); }
+  UnionFind(const UnionFind&) = delete;
+  UnionFind& operator=(const UnionFind&) = delete;
 
-  const T* find() const { return findImpl(); }
+  size_t size() const { return parents_.size(); }
 
-  T* find() { return findImpl(); }
+  /// Make every element of [0, size) a set of its own
+  void Reset(size_t size) {
+    if (size != parents_.size()) {
+      parents_.destroy();
+      parents_.deallocate();
+      parents_.allocateBlocked(size);
+    }
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t x) { parents_.constructAt(x, T(x)); },
+        katana::no_stats());
+  }
 
-  //! Compress ONLY node to point directly to the root of the tree;
-  //! nodes on path are not altered
-  void compress() {
-    if (isRep())
-      return;
+  T Parent(T x) const { return parents_[x].load(std::memory_order_relaxed); }
 
-    // my current component
-    T* rep = m_component;
+  bool IsRoot(T x) const { return Parent(x) == x; }
 
-    // loop until rep == itself; i.e. get root
-    while (rep->m_component.load(std::memory_order_relaxed) != rep) {
-      // get next parent
-      T* next = rep->m_component.load(std::memory_order_relaxed);
-      rep = next;
+  /// \returns the root of the set of x
+  T Find(T x) {
+    while (true) {
+      T parent = Parent(x);
+      T grandparent = Parent(parent);
+      if (parent == grandparent) {
+        return parent;
+      }
+      // path splitting: failing means another thread moved x closer to
+      // the root already
+      parents_[x].compare_exchange_weak(
+          parent, grandparent, std::memory_order_relaxed);
+      x = parent;
     }
-
-    // at this point rep is the parent: save as my parent
-    m_component.store(rep, std::memory_order_relaxed);
   }
 
-  T* findAndCompress() {
-    // Basic outline of race in synchronous path compression is that two path
-    // compressions along two different paths to the root can create a cycle
-    // in the union-find tree. Prevent that from happening by compressing
-    // incrementally.
-    if (isRep())
-      return m_component.load(std::memory_order_relaxed);
-
-    T* rep = m_component;
-    T* prev = 0;
-    while (rep->m_component.load(std::memory_order_relaxed) != rep) {
-      T* next = rep->m_component.load(std::memory_order_relaxed);
-
-      if (prev && prev->m_component.load(std::memory_order_relaxed) == rep) {
-        prev->m_component.store(next, std::memory_order_relaxed);
+  /// Merge the sets of x and y
+  ///
+  /// \returns true if they were different sets
+  bool Union(T x, T y) {
+    while (true) {
+      T px = Parent(x);
+      T py = Parent(y);
+      if (px == py) {
+        return false;
+      }
+      if (px < py) {
+        std::swap(x, y);
+        std::swap(px, py);
       }
-      prev = rep;
-      rep = next;
+      if (x == px) {
+        // x is a root; link it under the smaller parent of y
+        if (parents_[x].compare_exchange_strong(
+                px, py, std::memory_order_relaxed)) {
+          return true;
+        }
+        continue;
+      }
+      // splice: x leaves its parent for the smaller one, then walk up
+      parents_[x].compare_exchange_strong(px, py, std::memory_order_relaxed);
+      x = px;
     }
+  }
 
-    return rep;
+  bool SameSet(T x, T y) { return Find(x) == Find(y); }
+
+  /// Point x directly to the root of its set
+  void Compress(T x) {
+    T root = Find(x);
+    if (Parent(x) != root) {
+      parents_[x].store(root, std::memory_order_relaxed);
+    }
   }
 
-  //! Lock-free merge. Returns if merge was done.
-  T* merge(T* b) {
-    T* a = m_component.load(std::memory_order_relaxed);
-    while (true) {
-      a = a->findAndCompress();
-      b = b->findAndCompress();
-      if (a == b)
-        return 0;
-      // Avoid cycles by directing edges consistently
-      if (a < b)
-        std::swap(a, b);
-      if (a->m_component.compare_exchange_strong(a, b)) {
-        return b;
-      }
+  /// Merge the sets of the elements of each pair of pairs in parallel
+  ///
+  /// \returns the number of merges, i.e., how many sets fewer there are
+  template <typename Pairs, typename... Args>
+  size_t UnionAll(const Pairs& pairs, Args&&... args) {
+    katana::GAccumulator<size_t> merges;
+    katana::do_all(
+        katana::iterate(pairs),
+        [&](const auto& pair) {
+          if (Union(pair.first, pair.second)) {
+            merges += 1;
+          }
+        },
+        std::forward<Args>(args)...);
+    return merges.reduce();
+  }
+
+  /// Point every element directly to its root; call once no more unions
+  /// are in flight so that Parent of each element is its root
+  void CompressAll() {
+    katana::do_all(
+        katana::iterate(size_t{0}, parents_.size()),
+        [&](size_t x) { Compress(T(x)); }, katana::steal(),
+        katana::no_stats());
+  }
+
+  /// \returns the root of the set that most of num_samples elements, drawn
+  /// at random, belong to; with a few hundred samples, this is the largest
+  /// set with high probability when it is much larger than the others, as
+  /// the giant component of a graph usually is
+  T SampleLargestSet(uint32_t num_samples, uint64_t seed = 0) {
+    KATANA_LOG_DEBUG_ASSERT(size() > 0);
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<size_t> dist(0, size() - 1);
+    std::unordered_map<T, uint32_t> counts;
+    for (uint32_t i = 0; i < num_samples; ++i) {
+      ++counts[Find(T(dist(gen)))];
     }
+    return std::max_element(
+               counts.begin(), counts.end(),
+               [](const auto& a, const auto& b) { return a.second < b.second; })
+        ->first;
   }
 };
+
 }  // namespace katana
 #endif
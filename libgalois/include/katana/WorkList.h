@@ -22,24 +22,31 @@
 
 #include <optional>
 
+#include "katana/AdaptiveObim.h"
 #include "katana/BulkSynchronous.h"
 #include "katana/Chunk.h"
 #include "katana/LocalQueue.h"
+#include "katana/MultiQueue.h"
 #include "katana/Obim.h"
 #include "katana/OrderedList.h"
 #include "katana/OwnerComputes.h"
 #include "katana/PerThreadChunk.h"
 #include "katana/Simple.h"
 #include "katana/StableIterator.h"
+#include "katana/StealingDeque.h"
 #include "katana/config.h"
 
 namespace katana {
 /**
  * Scheduling policies for Galois iterators. Unless you have very specific
  * scheduling requirement, \ref PerSocketChunkLIFO or \ref PerSocketChunkFIFO is
- * a reasonable scheduling policy. If you need approximate priority scheduling,
- * use \ref OrderedByIntegerMetric. For debugging, you may be interested in
- * \ref FIFO or \ref LIFO, which try to follow serial order exactly.
+ * a reasonable scheduling policy. If threads generate very uneven amounts of
+ * work, \ref StealingDeque balances them by work stealing. If you need
+ * approximate priority scheduling, use \ref OrderedByIntegerMetric, or
+ * \ref AdaptiveOrderedByIntegerMetric if a good bucket width is hard to
+ * know up front; \ref MultiQueue needs no buckets at all. For debugging,
+ * you may be interested in \ref FIFO or \ref LIFO, which try to follow
+ * serial order exactly.
  *
  * The way to use a worklist is to pass it as a template parameter to
  * \ref for_each(). For example,
@@ -20,6 +20,7 @@
 #include "katana/Barrier.h"
 
 #include "katana/Logging.h"
+#include "katana/ThreadGroup.h"
 #include "katana/ThreadPool.h"
 
 // anchor vtable
@@ -43,6 +44,9 @@ katana::internal::SetBarrier(katana::Barrier* barrier) {
 
 katana::Barrier&
 katana::GetBarrier(unsigned active_threads) {
+  if (auto* group = ThreadGroup::Current()) {
+    return group->GetBarrier(active_threads);
+  }
   KATANA_LOG_VASSERT(kBarrier, "Barrier not initialized");
   active_threads =
       std::min(active_threads, GetThreadPool().getMaxUsableThreads());
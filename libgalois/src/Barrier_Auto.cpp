@@ -0,0 +1,109 @@
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "katana/Barrier.h"
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+/// Threads that may share the counter of a counting barrier before the
+/// arrivals on its cache line take longer than climbing an MCS tree
+constexpr unsigned kMaxCountingThreads = 8;
+
+std::optional<katana::internal::BarrierKind>
+KindFromEnv() {
+  using katana::internal::BarrierKind;
+
+  std::string name;
+  if (!katana::GetEnv("KATANA_BARRIER", &name) || name == "auto") {
+    return std::nullopt;
+  }
+  if (name == "counting") {
+    return BarrierKind::kCounting;
+  }
+  if (name == "mcs") {
+    return BarrierKind::kMCS;
+  }
+  if (name == "topo") {
+    return BarrierKind::kTopo;
+  }
+  if (name == "dissemination") {
+    return BarrierKind::kDissemination;
+  }
+  KATANA_LOG_WARN("unknown KATANA_BARRIER {}; choosing automatically", name);
+  return std::nullopt;
+}
+
+class AutoBarrier : public katana::Barrier {
+  using BarrierKind = katana::internal::BarrierKind;
+
+  std::optional<BarrierKind> forced_;
+  std::unique_ptr<katana::Barrier> barriers_[4];
+  katana::Barrier* current_{nullptr};
+
+  katana::Barrier& Get(BarrierKind kind, unsigned active_threads) {
+    auto& barrier = barriers_[static_cast<int>(kind)];
+    if (!barrier) {
+      switch (kind) {
+      case BarrierKind::kCounting:
+        barrier = katana::CreateCountingBarrier(active_threads);
+        break;
+      case BarrierKind::kMCS:
+        barrier = katana::CreateMCSBarrier(active_threads);
+        break;
+      case BarrierKind::kTopo:
+        barrier = katana::CreateTopoBarrier(active_threads);
+        break;
+      case BarrierKind::kDissemination:
+        barrier = katana::CreateDisseminationBarrier(active_threads);
+        break;
+      }
+    } else {
+      barrier->Reinit(active_threads);
+    }
+    return *barrier;
+  }
+
+public:
+  explicit AutoBarrier(unsigned active_threads) : forced_(KindFromEnv()) {
+    Reinit(active_threads);
+  }
+
+  void Reinit(unsigned active_threads) override {
+    BarrierKind kind;
+    if (forced_) {
+      kind = *forced_;
+    } else {
+      unsigned num_sockets =
+          katana::GetThreadPool().getCumulativeMaxSocket(active_threads - 1) +
+          1;
+      kind = katana::internal::ChooseBarrier(active_threads, num_sockets);
+    }
+    current_ = &Get(kind, active_threads);
+  }
+
+  void Wait() override { current_->Wait(); }
+
+  const char* name() const override { return current_->name(); }
+};
+
+}  // namespace
+
+katana::internal::BarrierKind
+katana::internal::ChooseBarrier(unsigned active_threads, unsigned num_sockets) {
+  if (num_sockets > 1) {
+    return BarrierKind::kTopo;
+  }
+  if (active_threads <= kMaxCountingThreads) {
+    return BarrierKind::kCounting;
+  }
+  return BarrierKind::kMCS;
+}
+
+std::unique_ptr<katana::Barrier>
+katana::CreateAutoBarrier(unsigned active_threads) {
+  return std::make_unique<AutoBarrier>(active_threads);
+}
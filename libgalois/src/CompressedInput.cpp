@@ -0,0 +1,500 @@
+#include "katana/CompressedInput.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <arrow/buffer.h>
+#include <arrow/io/compressed.h>
+#include <arrow/io/file.h>
+#include <arrow/util/compression.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ResultReduction.h"
+
+namespace {
+
+/// Decompressed bytes per read of a decompressing stream
+constexpr size_t kStreamChunkSize = size_t{1} << 20;
+
+constexpr uint32_t kZstdMagic = 0xFD2FB528;
+/// The magic number of the skippable frame that holds a seek table
+constexpr uint32_t kZstdSeekTableMagic = 0x184D2A5E;
+constexpr uint32_t kZstdSeekableMagic = 0x8F92EAB1;
+/// Number_Of_Frames, Seek_Table_Descriptor and Seekable_Magic_Number
+constexpr size_t kZstdSeekTableFooterSize = 9;
+constexpr size_t kZstdSkippableHeaderSize = 8;
+
+/// The fixed gzip header, XLEN and the BC subfield
+constexpr size_t kBgzfHeaderSize = 18;
+/// CRC32 and ISIZE
+constexpr size_t kBgzfFooterSize = 8;
+
+/// A block of a file that decompresses independently of the others
+struct Block {
+  /// Where the block starts in the file
+  uint64_t offset;
+  uint64_t size;
+  /// Where the block starts in the decompressed contents
+  uint64_t start;
+  uint64_t decompressed_size;
+};
+
+uint16_t
+Load16(const uint8_t* p) {
+  return p[0] | (uint16_t{p[1]} << 8);
+}
+
+uint32_t
+Load32(const uint8_t* p) {
+  return p[0] | (uint32_t{p[1]} << 8) | (uint32_t{p[2]} << 16) |
+         (uint32_t{p[3]} << 24);
+}
+
+/// \returns the size of the BGZF block at data, or 0 if data does not start
+/// with a gzip member with a BC subfield
+size_t
+BgzfBlockSize(const uint8_t* data, size_t size) {
+  constexpr uint8_t kFlagExtra = 4;
+  if (size < kBgzfHeaderSize || data[0] != 0x1f || data[1] != 0x8b ||
+      data[2] != 8 || (data[3] & kFlagExtra) == 0) {
+    return 0;
+  }
+  size_t extra_end = 12 + Load16(data + 10);
+  if (extra_end > size) {
+    return 0;
+  }
+  for (size_t p = 12; p + 4 <= extra_end;) {
+    uint16_t length = Load16(data + p + 2);
+    if (data[p] == 'B' && data[p + 1] == 'C' && length == 2 &&
+        p + 6 <= extra_end) {
+      return Load16(data + p + 4) + 1;
+    }
+    p += 4 + length;
+  }
+  return 0;
+}
+
+/// \returns the number of frames of the seek table that ends a zstd
+/// seekable file, and the size of their entries, or nullopt if the file
+/// does not end with a seek table
+std::optional<std::pair<uint32_t, size_t>>
+ZstdSeekTable(const uint8_t* data, size_t size) {
+  constexpr uint8_t kFlagChecksum = 0x80;
+  if (size < kZstdSkippableHeaderSize + kZstdSeekTableFooterSize) {
+    return std::nullopt;
+  }
+  const uint8_t* footer = data + size - kZstdSeekTableFooterSize;
+  if (Load32(footer + 5) != kZstdSeekableMagic) {
+    return std::nullopt;
+  }
+  uint32_t num_frames = Load32(footer);
+  size_t entry_size = (footer[4] & kFlagChecksum) != 0 ? 12 : 8;
+  uint64_t table_size =
+      uint64_t{num_frames} * entry_size + kZstdSeekTableFooterSize;
+  if (table_size + kZstdSkippableHeaderSize > size) {
+    return std::nullopt;
+  }
+  const uint8_t* header = data + size - table_size - kZstdSkippableHeaderSize;
+  if (Load32(header) != kZstdSeekTableMagic ||
+      Load32(header + 4) != table_size) {
+    return std::nullopt;
+  }
+  return std::make_pair(num_frames, entry_size);
+}
+
+katana::InputCompression
+DetectCompression(const uint8_t* data, size_t size) {
+  if (size >= 4 && (Load32(data) == kZstdMagic ||
+                    Load32(data) == kZstdSeekTableMagic)) {
+    if (ZstdSeekTable(data, size)) {
+      return katana::InputCompression::kZstdSeekable;
+    }
+    if (Load32(data) == kZstdMagic) {
+      return katana::InputCompression::kZstd;
+    }
+  }
+  if (size >= 2 && data[0] == 0x1f && data[1] == 0x8b) {
+    if (BgzfBlockSize(data, size) != 0) {
+      return katana::InputCompression::kBgzf;
+    }
+    return katana::InputCompression::kGzip;
+  }
+  return katana::InputCompression::kNone;
+}
+
+katana::Result<std::vector<Block>>
+IndexBgzf(const uint8_t* data, size_t size) {
+  std::vector<Block> blocks;
+  uint64_t start = 0;
+  for (uint64_t offset = 0; offset < size;) {
+    size_t block_size = BgzfBlockSize(data + offset, size - offset);
+    if (block_size < kBgzfHeaderSize + kBgzfFooterSize ||
+        block_size > size - offset) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "corrupt BGZF block at offset {}", offset);
+    }
+    uint32_t decompressed_size = Load32(data + offset + block_size - 4);
+    blocks.emplace_back(Block{offset, block_size, start, decompressed_size});
+    offset += block_size;
+    start += decompressed_size;
+  }
+  return blocks;
+}
+
+katana::Result<std::vector<Block>>
+IndexZstdSeekable(const uint8_t* data, size_t size) {
+  auto [num_frames, entry_size] = ZstdSeekTable(data, size).value();
+  size_t table_size = num_frames * entry_size + kZstdSeekTableFooterSize;
+  const uint8_t* entry = data + size - table_size;
+  uint64_t frames_end = size - table_size - kZstdSkippableHeaderSize;
+
+  std::vector<Block> blocks;
+  blocks.reserve(num_frames);
+  uint64_t offset = 0;
+  uint64_t start = 0;
+  for (uint32_t i = 0; i < num_frames; ++i, entry += entry_size) {
+    uint32_t frame_size = Load32(entry);
+    uint32_t decompressed_size = Load32(entry + 4);
+    blocks.emplace_back(Block{offset, frame_size, start, decompressed_size});
+    offset += frame_size;
+    start += decompressed_size;
+  }
+  if (offset != frames_end) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "zstd seek table covers {} bytes of {} bytes of frames", offset,
+        frames_end);
+  }
+  return blocks;
+}
+
+arrow::Compression::type
+ArrowCompression(katana::InputCompression compression) {
+  switch (compression) {
+  case katana::InputCompression::kGzip:
+  case katana::InputCompression::kBgzf:
+    return arrow::Compression::GZIP;
+  case katana::InputCompression::kZstd:
+  case katana::InputCompression::kZstdSeekable:
+    return arrow::Compression::ZSTD;
+  default:
+    return arrow::Compression::UNCOMPRESSED;
+  }
+}
+
+bool
+IsIndexed(katana::InputCompression compression) {
+  return compression == katana::InputCompression::kBgzf ||
+         compression == katana::InputCompression::kZstdSeekable;
+}
+
+}  // namespace
+
+const char*
+katana::InputCompressionName(InputCompression compression) {
+  switch (compression) {
+  case InputCompression::kNone:
+    return "none";
+  case InputCompression::kGzip:
+    return "gzip";
+  case InputCompression::kBgzf:
+    return "bgzf";
+  case InputCompression::kZstd:
+    return "zstd";
+  case InputCompression::kZstdSeekable:
+    return "zstd-seekable";
+  }
+  return "unknown";
+}
+
+struct katana::DecompressingStreamBuf::Impl {
+  std::string path;
+  size_t batch_size{kDefaultBatchSize};
+  InputCompression compression{InputCompression::kNone};
+  std::optional<CopyableErrorInfo> error;
+
+  std::shared_ptr<arrow::io::MemoryMappedFile> file;
+  /// The whole file, mapped
+  std::shared_ptr<arrow::Buffer> contents;
+  /// The size of the decompressed contents, if known
+  uint64_t size{0};
+
+  /// The blocks of BGZF and zstd seekable files, and the next one to
+  /// decompress
+  std::vector<Block> blocks;
+  size_t next_block{0};
+  /// The bytes of the next block to skip, after a seek into it
+  uint64_t skip{0};
+  PerThreadStorage<std::unique_ptr<arrow::util::Codec>> codecs;
+
+  /// The stream of the other compressed files
+  std::unique_ptr<arrow::util::Codec> codec;
+  std::shared_ptr<arrow::io::InputStream> stream;
+
+  std::vector<char> buffer;
+  /// Where the get area starts in the decompressed contents
+  uint64_t buffer_start{0};
+
+  const uint8_t* data() const { return contents->data(); }
+};
+
+katana::DecompressingStreamBuf::DecompressingStreamBuf()
+    : impl_(std::make_unique<Impl>()) {}
+
+katana::DecompressingStreamBuf::~DecompressingStreamBuf() = default;
+
+katana::Result<std::unique_ptr<katana::DecompressingStreamBuf>>
+katana::DecompressingStreamBuf::Make(
+    const std::string& path, size_t batch_size) {
+  std::unique_ptr<DecompressingStreamBuf> buf(new DecompressingStreamBuf());
+  Impl& impl = *buf->impl_;
+  impl.path = path;
+  impl.batch_size = std::max<size_t>(batch_size, 1);
+
+  impl.file = KATANA_CHECKED_CONTEXT(
+      arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ),
+      "opening {}", path);
+  int64_t file_size = KATANA_CHECKED(impl.file->GetSize());
+  impl.contents = KATANA_CHECKED(impl.file->ReadAt(0, file_size));
+  impl.compression = DetectCompression(impl.data(), file_size);
+
+  if (impl.compression == InputCompression::kNone) {
+    impl.size = file_size;
+  } else if (!arrow::util::Codec::IsAvailable(
+                 ArrowCompression(impl.compression))) {
+    return KATANA_ERROR(
+        ErrorCode::FeatureNotEnabled, "{} is {}, which arrow cannot decompress",
+        path, InputCompressionName(impl.compression));
+  } else if (impl.compression == InputCompression::kBgzf) {
+    impl.blocks = KATANA_CHECKED_CONTEXT(
+        IndexBgzf(impl.data(), file_size), "reading {}", path);
+  } else if (impl.compression == InputCompression::kZstdSeekable) {
+    impl.blocks = KATANA_CHECKED_CONTEXT(
+        IndexZstdSeekable(impl.data(), file_size), "reading {}", path);
+  } else {
+    impl.codec = KATANA_CHECKED(
+        arrow::util::Codec::Create(ArrowCompression(impl.compression)));
+  }
+  if (!impl.blocks.empty()) {
+    const Block& last = impl.blocks.back();
+    impl.size = last.start + last.decompressed_size;
+  }
+
+  KATANA_CHECKED(buf->Seek(0));
+  return std::unique_ptr<DecompressingStreamBuf>(std::move(buf));
+}
+
+katana::InputCompression
+katana::DecompressingStreamBuf::compression() const noexcept {
+  return impl_->compression;
+}
+
+const std::optional<katana::CopyableErrorInfo>&
+katana::DecompressingStreamBuf::error() const noexcept {
+  return impl_->error;
+}
+
+katana::Result<void>
+katana::DecompressingStreamBuf::Fill() {
+  Impl& impl = *impl_;
+  impl.buffer_start += egptr() - eback();
+
+  if (impl.compression == InputCompression::kNone) {
+    // the mapped file is the get area, and it has ended
+    return ResultSuccess();
+  }
+
+  if (!IsIndexed(impl.compression)) {
+    impl.buffer.resize(kStreamChunkSize);
+    int64_t read = KATANA_CHECKED_CONTEXT(
+        impl.stream->Read(impl.buffer.size(), impl.buffer.data()),
+        "decompressing {}", impl.path);
+    setg(impl.buffer.data(), impl.buffer.data(), impl.buffer.data() + read);
+    return ResultSuccess();
+  }
+
+  // decompress the next batch of blocks in parallel, each straight to its
+  // place in the buffer
+  size_t first = impl.next_block;
+  size_t last = first;
+  uint64_t batch_size = 0;
+  while (last < impl.blocks.size() && batch_size < impl.batch_size) {
+    batch_size += impl.blocks[last++].decompressed_size;
+  }
+  if (impl.buffer.size() < batch_size) {
+    impl.buffer.resize(batch_size);
+  }
+  impl.next_block = last;
+  if (first != last) {
+    impl.buffer_start = impl.blocks[first].start;
+  }
+
+  char* out = impl.buffer.data();
+  const uint8_t* data = impl.data();
+  uint64_t batch_start = impl.buffer_start;
+  arrow::Compression::type type = ArrowCompression(impl.compression);
+  CombinedErrorInfo errors;
+  katana::do_all(
+      katana::iterate(first, last),
+      [&](size_t i) {
+        const Block& block = impl.blocks[i];
+        if (block.decompressed_size == 0) {
+          return;
+        }
+        std::unique_ptr<arrow::util::Codec>& codec = *impl.codecs.getLocal();
+        if (!codec) {
+          codec = KATANA_COMBINE_ERROR(
+              errors, arrow::util::Codec::Create(type));
+        }
+        int64_t decompressed = KATANA_COMBINE_ERROR_CONTEXT(
+            errors,
+            codec->Decompress(
+                block.size, data + block.offset, block.decompressed_size,
+                reinterpret_cast<uint8_t*>(out + block.start - batch_start)),
+            "decompressing the block at offset {}", block.offset);
+        if (static_cast<uint64_t>(decompressed) != block.decompressed_size) {
+          errors.update(KATANA_ERROR(
+              ErrorCode::InvalidArgument,
+              "block at offset {} decompressed to {} bytes rather than {}",
+              block.offset, decompressed, block.decompressed_size));
+        }
+      },
+      katana::steal(), katana::no_stats());
+  uint64_t skip = std::min(impl.skip, batch_size);
+  impl.skip = 0;
+  if (auto error = errors()) {
+    setg(out, out, out);
+    return ErrorInfo(error.value()).WithContext("reading {}", impl.path);
+  }
+  setg(out, out + skip, out + batch_size);
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::DecompressingStreamBuf::Seek(uint64_t pos) {
+  Impl& impl = *impl_;
+  uint64_t buffered = egptr() - eback();
+  if (pos >= impl.buffer_start && pos - impl.buffer_start <= buffered &&
+      eback() != nullptr) {
+    setg(eback(), eback() + (pos - impl.buffer_start), egptr());
+    return ResultSuccess();
+  }
+
+  if (impl.compression == InputCompression::kNone) {
+    if (pos > impl.size) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "position {} is past the end of {}",
+          pos, impl.path);
+    }
+    // the contents are never written through the get area
+    char* data = reinterpret_cast<char*>(const_cast<uint8_t*>(impl.data()));
+    setg(data, data + pos, data + impl.size);
+    impl.buffer_start = 0;
+    return ResultSuccess();
+  }
+
+  if (!IsIndexed(impl.compression)) {
+    if (pos != 0) {
+      return KATANA_ERROR(
+          ErrorCode::NotImplemented, "{} streams only seek to their start",
+          InputCompressionName(impl.compression));
+    }
+    KATANA_CHECKED(impl.file->Seek(0));
+    impl.stream = KATANA_CHECKED_CONTEXT(
+        arrow::io::CompressedInputStream::Make(impl.codec.get(), impl.file),
+        "decompressing {}", impl.path);
+    impl.buffer_start = 0;
+    setg(nullptr, nullptr, nullptr);
+    return ResultSuccess();
+  }
+
+  if (pos > impl.size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "position {} is past the end of {}", pos,
+        impl.path);
+  }
+  // the last block that starts at or before pos, which the next Fill
+  // decompresses from
+  auto it = std::upper_bound(
+      impl.blocks.begin(), impl.blocks.end(), pos,
+      [](uint64_t p, const Block& block) { return p < block.start; });
+  impl.next_block = it - impl.blocks.begin();
+  impl.skip = 0;
+  if (pos != impl.size && impl.next_block != 0) {
+    --impl.next_block;
+    impl.skip = pos - impl.blocks[impl.next_block].start;
+  }
+  impl.buffer_start = pos;
+  setg(nullptr, nullptr, nullptr);
+  return ResultSuccess();
+}
+
+katana::DecompressingStreamBuf::int_type
+katana::DecompressingStreamBuf::underflow() {
+  if (gptr() == egptr() && !impl_->error) {
+    if (auto res = Fill(); !res) {
+      impl_->error = res.error();
+    }
+  }
+  if (gptr() == egptr()) {
+    return traits_type::eof();
+  }
+  return traits_type::to_int_type(*gptr());
+}
+
+katana::DecompressingStreamBuf::pos_type
+katana::DecompressingStreamBuf::seekoff(
+    off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+  off_type base = 0;
+  if (dir == std::ios_base::cur) {
+    base = impl_->buffer_start + (gptr() - eback());
+  } else if (dir == std::ios_base::end) {
+    if (!IsIndexed(impl_->compression) &&
+        impl_->compression != InputCompression::kNone) {
+      return pos_type(off_type(-1));
+    }
+    base = impl_->size;
+  }
+  if (base + off < 0) {
+    return pos_type(off_type(-1));
+  }
+  return seekpos(pos_type(base + off), which);
+}
+
+katana::DecompressingStreamBuf::pos_type
+katana::DecompressingStreamBuf::seekpos(
+    pos_type pos, std::ios_base::openmode which) {
+  if ((which & std::ios_base::in) == 0 || !Seek(off_type(pos))) {
+    return pos_type(off_type(-1));
+  }
+  return pos;
+}
+
+katana::DecompressingIfstream::DecompressingIfstream(
+    const std::string& path, size_t batch_size)
+    : std::istream(nullptr) {
+  auto res = DecompressingStreamBuf::Make(path, batch_size);
+  if (!res) {
+    open_error_ = res.error();
+    setstate(std::ios_base::failbit);
+    return;
+  }
+  buf_ = std::move(res.value());
+  rdbuf(buf_.get());
+}
+
+katana::DecompressingIfstream::~DecompressingIfstream() = default;
+
+katana::InputCompression
+katana::DecompressingIfstream::compression() const noexcept {
+  return buf_ ? buf_->compression() : InputCompression::kNone;
+}
+
+const std::optional<katana::CopyableErrorInfo>&
+katana::DecompressingIfstream::error() const noexcept {
+  return buf_ ? buf_->error() : open_error_;
+}
@@ -0,0 +1,250 @@
+#include "katana/FingerprintScreen.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "katana/Galois.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define KATANA_FINGERPRINT_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/// rows per unit of parallel work; also the number below which screens run
+/// on the calling thread only
+constexpr size_t kBlockRows = 1 << 10;
+
+/// The numbers of bits set in both and in either of two fingerprints
+struct Counts {
+  uint64_t both{};
+  uint64_t either{};
+};
+
+using ContainsFn =
+    bool (*)(const uint64_t* row, const uint64_t* query, size_t n);
+using CountFn =
+    Counts (*)(const uint64_t* row, const uint64_t* query, size_t n);
+
+bool
+ContainsScalar(const uint64_t* row, const uint64_t* query, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    if (query[i] & ~row[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Counts
+CountScalar(const uint64_t* row, const uint64_t* query, size_t n) {
+  Counts counts;
+  for (size_t i = 0; i < n; ++i) {
+    counts.both += __builtin_popcountll(row[i] & query[i]);
+    counts.either += __builtin_popcountll(row[i] | query[i]);
+  }
+  return counts;
+}
+
+#ifdef KATANA_FINGERPRINT_X86
+
+__attribute__((target("popcnt"))) Counts
+CountPopcnt(const uint64_t* row, const uint64_t* query, size_t n) {
+  Counts counts;
+  for (size_t i = 0; i < n; ++i) {
+    counts.both += __builtin_popcountll(row[i] & query[i]);
+    counts.either += __builtin_popcountll(row[i] | query[i]);
+  }
+  return counts;
+}
+
+__attribute__((target("avx2"))) bool
+ContainsAvx2(const uint64_t* row, const uint64_t* query, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+    __m256i q =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(query + i));
+    // testc is set when every bit of q is set in r
+    if (!_mm256_testc_si256(r, q)) {
+      return false;
+    }
+  }
+  return ContainsScalar(row + i, query + i, n - i);
+}
+
+/// The number of bits of each 64-bit lane of v, with nibble lookups in a
+/// shuffle as in DynamicBitset
+__attribute__((target("avx2"))) __m256i
+PopCountAvx2(__m256i v) {
+  const __m256i lookup = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+      1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i lo = _mm256_and_si256(v, low_mask);
+  __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+  __m256i bytes = _mm256_add_epi8(
+      _mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+  return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2"))) uint64_t
+SumAvx2(__m256i v) {
+  return _mm256_extract_epi64(v, 0) + _mm256_extract_epi64(v, 1) +
+         _mm256_extract_epi64(v, 2) + _mm256_extract_epi64(v, 3);
+}
+
+__attribute__((target("avx2,popcnt"))) Counts
+CountAvx2(const uint64_t* row, const uint64_t* query, size_t n) {
+  __m256i both = _mm256_setzero_si256();
+  __m256i either = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+    __m256i q =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(query + i));
+    both = _mm256_add_epi64(both, PopCountAvx2(_mm256_and_si256(r, q)));
+    either = _mm256_add_epi64(either, PopCountAvx2(_mm256_or_si256(r, q)));
+  }
+  Counts counts = CountPopcnt(row + i, query + i, n - i);
+  counts.both += SumAvx2(both);
+  counts.either += SumAvx2(either);
+  return counts;
+}
+
+__attribute__((target("avx512f"))) bool
+ContainsAvx512(const uint64_t* row, const uint64_t* query, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i q = _mm512_loadu_si512(query + i);
+    __m512i common = _mm512_and_si512(_mm512_loadu_si512(row + i), q);
+    if (_mm512_cmpneq_epi64_mask(common, q)) {
+      return false;
+    }
+  }
+  return ContainsScalar(row + i, query + i, n - i);
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt"))) Counts
+CountAvx512(const uint64_t* row, const uint64_t* query, size_t n) {
+  __m512i both = _mm512_setzero_si512();
+  __m512i either = _mm512_setzero_si512();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i r = _mm512_loadu_si512(row + i);
+    __m512i q = _mm512_loadu_si512(query + i);
+    both = _mm512_add_epi64(both, _mm512_popcnt_epi64(_mm512_and_si512(r, q)));
+    either =
+        _mm512_add_epi64(either, _mm512_popcnt_epi64(_mm512_or_si512(r, q)));
+  }
+  uint64_t both_lanes[8];
+  uint64_t either_lanes[8];
+  _mm512_storeu_si512(both_lanes, both);
+  _mm512_storeu_si512(either_lanes, either);
+  Counts counts = CountPopcnt(row + i, query + i, n - i);
+  counts.both += std::accumulate(both_lanes, both_lanes + 8, uint64_t{0});
+  counts.either += std::accumulate(either_lanes, either_lanes + 8, uint64_t{0});
+  return counts;
+}
+
+#endif
+
+/// The implementations of the screens for the instruction sets of this
+/// machine
+struct Kernels {
+  ContainsFn contains{ContainsScalar};
+  CountFn count{CountScalar};
+
+  Kernels() {
+#ifdef KATANA_FINGERPRINT_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("popcnt")) {
+      count = CountPopcnt;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      contains = ContainsAvx2;
+      if (__builtin_cpu_supports("popcnt")) {
+        count = CountAvx2;
+      }
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+      contains = ContainsAvx512;
+      if (__builtin_cpu_supports("avx512vpopcntdq")) {
+        count = CountAvx512;
+      }
+    }
+#endif
+  }
+};
+
+const Kernels&
+GetKernels() {
+  static const Kernels kernels;
+  return kernels;
+}
+
+/// Call fn(block, begin, end) on blocks of rows [0, num_rows), in parallel if
+/// there is more than one block
+template <typename Fn>
+void
+ForEachBlock(size_t num_rows, const Fn& fn) {
+  size_t num_blocks = (num_rows + kBlockRows - 1) / kBlockRows;
+  if (num_blocks <= 1) {
+    fn(size_t{0}, size_t{0}, num_rows);
+    return;
+  }
+  katana::do_all(
+      katana::iterate(size_t{0}, num_blocks),
+      [&](size_t block) {
+        size_t begin = block * kBlockRows;
+        fn(block, begin, std::min(begin + kBlockRows, num_rows));
+      },
+      katana::steal(), katana::no_stats());
+}
+
+}  // namespace
+
+std::vector<uint64_t>
+katana::ScreenSubstructures(
+    const FingerprintRows& rows, const uint64_t* query) {
+  ContainsFn contains = GetKernels().contains;
+  // Each block collects its matches so that they stay in order.
+  std::vector<std::vector<uint64_t>> matches(
+      (rows.num_rows + kBlockRows - 1) / kBlockRows);
+  ForEachBlock(rows.num_rows, [&](size_t block, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      if (contains(rows.words + i * rows.stride, query, rows.num_words)) {
+        matches[block].emplace_back(i);
+      }
+    }
+  });
+
+  size_t num_matches = 0;
+  for (const auto& block_matches : matches) {
+    num_matches += block_matches.size();
+  }
+  std::vector<uint64_t> screened;
+  screened.reserve(num_matches);
+  for (const auto& block_matches : matches) {
+    screened.insert(screened.end(), block_matches.begin(), block_matches.end());
+  }
+  return screened;
+}
+
+std::vector<double>
+katana::TanimotoSimilarities(
+    const FingerprintRows& rows, const uint64_t* query) {
+  CountFn count = GetKernels().count;
+  std::vector<double> similarities(rows.num_rows);
+  ForEachBlock(rows.num_rows, [&](size_t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      Counts counts =
+          count(rows.words + i * rows.stride, query, rows.num_words);
+      similarities[i] = counts.either == 0 ? 0.0
+                                           : static_cast<double>(counts.both) /
+                                                 counts.either;
+    }
+  });
+  return similarities;
+}
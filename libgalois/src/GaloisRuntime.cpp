@@ -22,7 +22,10 @@
 #include <memory>
 
 #include "katana/Barrier.h"
+#include "katana/Env.h"
+#include "katana/Metrics.h"
 #include "katana/PagePool.h"
+#include "katana/ScratchPool.h"
 #include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
@@ -203,18 +206,86 @@ public:
   }
 };
 
+void
+ReportIdleStats(const katana::ThreadPool& pool) {
+  auto stats = pool.getIdleStats();
+  katana::ReportStatSingle("ThreadPool", "SpinWakeups", stats.spinWakeups);
+  katana::ReportStatSingle("ThreadPool", "ParkWakeups", stats.parkWakeups);
+  katana::ReportStatSingle("ThreadPool", "ParkLatencyNs", stats.parkLatencyNs);
+  katana::ReportStatSingle(
+      "ThreadPool", "MaxParkLatencyNs", stats.maxParkLatencyNs);
+}
+
+/// Report the utilization of the thread pool as metrics; see Metrics.h
+void
+CollectThreadPoolMetrics(
+    const katana::ThreadPool& pool,
+    std::vector<katana::MetricFamily>* families) {
+  using katana::MetricType;
+  auto add = [&](const char* name, const char* help, MetricType type) {
+    families->emplace_back(katana::MetricFamily{name, help, type, {}, {}});
+    return &families->back();
+  };
+  constexpr double kNsPerSecond = 1e9;
+  auto run_stats = pool.getRunStats();
+  auto idle_stats = pool.getIdleStats();
+
+  add("katana_thread_pool_threads", "Threads of the thread pool",
+      MetricType::kGauge)
+      ->AddSample(pool.getMaxThreads());
+  add("katana_thread_pool_runs_total", "Parallel regions run",
+      MetricType::kCounter)
+      ->AddSample(run_stats.runs);
+  add("katana_thread_pool_run_seconds_total",
+      "Wall time spent in parallel regions", MetricType::kCounter)
+      ->AddSample(run_stats.runNs / kNsPerSecond);
+  // Its rate over the number of threads is the utilization of the pool
+  add("katana_thread_pool_thread_seconds_total",
+      "Wall time spent in parallel regions times the threads they ran on",
+      MetricType::kCounter)
+      ->AddSample(run_stats.threadNs / kNsPerSecond);
+  auto* wakeups = add(
+      "katana_thread_pool_wakeups_total", "Wakeups of idle threads",
+      MetricType::kCounter);
+  wakeups->AddSample(idle_stats.spinWakeups, {{"mode", "spin"}});
+  wakeups->AddSample(idle_stats.parkWakeups, {{"mode", "park"}});
+  add("katana_thread_pool_park_latency_seconds_total",
+      "Time from wakeup until a blocked thread ran", MetricType::kCounter)
+      ->AddSample(idle_stats.parkLatencyNs / kNsPerSecond);
+}
+
+void
+ReportScratchStats(const katana::ScratchPool& pool) {
+  auto stats = pool.GetStats();
+  // nothing is retained in programs without a memory supervisor
+  if (stats.hits == 0 && stats.retained_bytes == 0) {
+    return;
+  }
+  katana::ReportStatSingle("ScratchPool", "Hits", stats.hits);
+  katana::ReportStatSingle("ScratchPool", "Misses", stats.misses);
+  katana::ReportStatSingle(
+      "ScratchPool", "RetainedBytes", stats.retained_bytes);
+}
+
 }  // namespace
 
+std::unique_ptr<katana::TerminationDetection>
+katana::internal::CreateTerminationDetection() {
+  return std::make_unique<LocalTerminationDetection>();
+}
+
 struct katana::GaloisRuntime::Impl {
   struct Dependents {
     LocalTerminationDetection term;
     std::unique_ptr<Barrier> barrier;
     internal::PageAllocState<> page_pool;
+    ScratchPool scratch_pool{ScratchPool::DefaultCapacity()};
     katana::StatManager stat_manager;
   };
 
   ThreadPool thread_pool;
   std::unique_ptr<Dependents> deps;
+  uint64_t metrics_collector_id{};
 };
 
 katana::GaloisRuntime::GaloisRuntime() : impl_(std::make_unique<Impl>()) {
@@ -224,17 +295,29 @@ katana::GaloisRuntime::GaloisRuntime() : impl_(std::make_unique<Impl>()) {
   // may call GetThreadPool() in their constructors
   impl_->deps = std::make_unique<Impl::Dependents>();
   impl_->deps->barrier =
-      katana::CreateTopoBarrier(impl_->thread_pool.getMaxUsableThreads());
+      katana::CreateAutoBarrier(impl_->thread_pool.getMaxUsableThreads());
 
   internal::SetBarrier(impl_->deps->barrier.get());
   internal::SetTerminationDetection(&impl_->deps->term);
   internal::setPagePoolState(&impl_->deps->page_pool);
+  internal::SetScratchPool(&impl_->deps->scratch_pool);
   katana::internal::setSysStatManager(&impl_->deps->stat_manager);
+
+  impl_->metrics_collector_id = MetricsRegistry::Get().AddCollector(
+      [pool = &impl_->thread_pool](std::vector<MetricFamily>* families) {
+        CollectThreadPoolMetrics(*pool, families);
+      });
 }
 
 katana::GaloisRuntime::~GaloisRuntime() {
+  MetricsRegistry::Get().RemoveCollector(impl_->metrics_collector_id);
+  if (katana::GetEnv("KATANA_REPORT_IDLE_STATS")) {
+    ReportIdleStats(impl_->thread_pool);
+  }
+  ReportScratchStats(impl_->deps->scratch_pool);
   katana::PrintStats();
   katana::internal::setSysStatManager(nullptr);
+  internal::SetScratchPool(nullptr);
   internal::setPagePoolState(nullptr);
   internal::SetTerminationDetection(nullptr);
   internal::SetBarrier(nullptr);
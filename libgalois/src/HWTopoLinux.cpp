@@ -17,6 +17,7 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <dirent.h>
 #include <dlfcn.h>
 
 #include <algorithm>
@@ -26,6 +27,7 @@
 #include <cstring>
 #include <fstream>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -51,7 +53,7 @@ struct cpuinfo {
   unsigned sib;
   unsigned coreid;
   unsigned cpucores;
-  unsigned numaNode;  // from libnuma
+  unsigned numaNode;  // from libnuma or sysfs
   bool valid;         // from cpuset
   bool smt;           // computed
 };
@@ -91,8 +93,56 @@ LoadLibNuma() {
 }
 #endif
 
+//! Read a non-negative integer from a sysfs file
+bool
+readSysfsUnsigned(const std::string& path, unsigned* ret) {
+  std::ifstream in(path);
+  long val = -1;
+  if (!(in >> val) || val < 0) {
+    return false;
+  }
+  *ret = val;
+  return true;
+}
+
+//! Map cpus to their numa nodes from /sys/devices/system/node, which exists
+//! without libnuma
+std::map<unsigned, unsigned>
+parseSysfsNumaNodes() {
+  std::map<unsigned, unsigned> nodes;
+  const std::string dir = "/sys/devices/system/node";
+  DIR* d = opendir(dir.c_str());
+  if (!d) {
+    return nodes;
+  }
+  while (dirent* entry = readdir(d)) {
+    unsigned node{};
+    if (sscanf(entry->d_name, "node%u", &node) != 1) {
+      continue;
+    }
+    std::ifstream in(dir + "/" + entry->d_name + "/cpulist");
+    std::string line;
+    if (std::getline(in, line)) {
+      for (int cpu : katana::parseCPUList(line)) {
+        nodes[cpu] = node;
+      }
+    }
+  }
+  closedir(d);
+  return nodes;
+}
+
 unsigned
-getNumaNode(const cpuinfo& c) {
+getNumaNode(
+    const cpuinfo& c, const std::map<unsigned, unsigned>& sysfs_nodes) {
+  auto from_sysfs = [&](const char* warning) {
+    auto it = sysfs_nodes.find(c.proc);
+    if (it != sysfs_nodes.end()) {
+      return it->second;
+    }
+    KATANA_WARN_ONCE("{}", warning);
+    return c.physid;
+  };
 #ifdef KATANA_USE_NUMA
   static std::once_flag load_numa_once;
   static bool numa_avail = false;
@@ -101,15 +151,12 @@ getNumaNode(const cpuinfo& c) {
     LoadLibNuma();
     numa_avail = dynamic_numa_available && dynamic_numa_available() >= 0;
     numa_avail = numa_avail && dynamic_numa_num_configured_nodes() > 0;
-    if (!numa_avail) {
-      KATANA_LOG_WARN(
-          "Numa support configured but not present at runtime.  "
-          "Assuming numa topology matches socket topology.");
-    }
   });
 
   if (!numa_avail) {
-    return c.physid;
+    return from_sysfs(
+        "Numa support configured but not present at runtime.  "
+        "Assuming numa topology matches socket topology.");
   }
   int i = dynamic_numa_node_of_cpu(c.proc);
   if (i < 0) {
@@ -117,13 +164,24 @@ getNumaNode(const cpuinfo& c) {
   }
   return i;
 #else
-  KATANA_WARN_ONCE(
+  return from_sysfs(
       "Numa Support Not configured (install libnuma-dev).  "
       "Assuming numa topology matches socket topology.");
-  return c.physid;
 #endif
 }
 
+//! Prefer the topology in sysfs to /proc/cpuinfo, which lacks physical and
+//! core ids on some architectures and hypervisors
+void
+readSysfsTopology(std::vector<cpuinfo>& info) {
+  for (auto& c : info) {
+    std::string dir =
+        "/sys/devices/system/cpu/cpu" + std::to_string(c.proc) + "/topology/";
+    readSysfsUnsigned(dir + "physical_package_id", &c.physid);
+    readSysfsUnsigned(dir + "core_id", &c.coreid);
+  }
+}
+
 //! Parse /proc/cpuinfo
 std::vector<cpuinfo>
 parseCPUInfo() {
@@ -156,8 +214,11 @@ parseCPUInfo() {
     }
   }
 
+  readSysfsTopology(vals);
+
+  auto sysfs_nodes = parseSysfsNumaNodes();
   for (auto& c : vals) {
-    c.numaNode = getNumaNode(c);
+    c.numaNode = getNumaNode(c, sysfs_nodes);
   }
 
   return vals;
@@ -202,8 +263,9 @@ markSMT(std::vector<cpuinfo>& info) {
   }
 }
 
+//! Parse a list, like Cpus_allowed_list, of /proc/self/status
 std::vector<int>
-parseCPUSet() {
+parseStatusList(const std::string& prefix) {
   std::vector<int> vals;
 
   std::ifstream data("/proc/self/status");
@@ -213,7 +275,6 @@ parseCPUSet() {
   }
 
   std::string line;
-  std::string prefix("Cpus_allowed_list:");
   bool found = false;
   while (true) {
     std::getline(data, line);
@@ -236,6 +297,26 @@ parseCPUSet() {
   return katana::parseCPUList(line);
 }
 
+//! The cpus the process may run on: its affinity mask, which container
+//! runtimes set from the cpuset of the cgroup
+std::vector<int>
+parseCPUSet() {
+  std::vector<int> vals;
+#ifdef KATANA_USE_SCHED_SETAFFINITY
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+    for (int i = 0; i < CPU_SETSIZE; ++i) {
+      if (CPU_ISSET(i, &mask)) {
+        vals.push_back(i);
+      }
+    }
+    return vals;
+  }
+#endif
+  return parseStatusList("Cpus_allowed_list:");
+}
+
 void
 markValid(std::vector<cpuinfo>& info) {
   auto v = parseCPUSet();
@@ -251,6 +332,52 @@ markValid(std::vector<cpuinfo>& info) {
   }
 }
 
+//! The distances from numa node to the other nodes, by node
+std::vector<unsigned>
+parseNumaDistances(unsigned node) {
+  std::vector<unsigned> distances;
+  std::ifstream in(
+      "/sys/devices/system/node/node" + std::to_string(node) + "/distance");
+  unsigned d{};
+  while (in >> d) {
+    distances.push_back(d);
+  }
+  return distances;
+}
+
+//! Threads on numa nodes that the cpuset of the process does not let it
+//! allocate memory from get their memory from the nearest allowed node, so
+//! give them that node
+void
+markAllowedNumaNodes(std::vector<cpuinfo>& info) {
+  auto mems = parseStatusList("Mems_allowed_list:");
+  if (mems.empty()) {
+    return;
+  }
+  std::sort(mems.begin(), mems.end());
+
+  std::map<unsigned, unsigned> nearest;
+  for (auto& c : info) {
+    if (std::binary_search(mems.begin(), mems.end(), c.numaNode)) {
+      continue;
+    }
+    auto it = nearest.find(c.numaNode);
+    if (it == nearest.end()) {
+      auto distances = parseNumaDistances(c.numaNode);
+      unsigned best = mems.front();
+      for (int m : mems) {
+        if (static_cast<size_t>(m) < distances.size() &&
+            static_cast<size_t>(best) < distances.size() &&
+            distances[m] < distances[best]) {
+          best = m;
+        }
+      }
+      it = nearest.emplace(c.numaNode, best).first;
+    }
+    c.numaNode = it->second;
+  }
+}
+
 katana::HWTopoInfo
 makeHWTopo() {
   katana::MachineTopoInfo retMTI;
@@ -264,6 +391,7 @@ makeHWTopo() {
       std::partition(
           info.begin(), info.end(), [](const cpuinfo& c) { return c.valid; }),
       info.end());
+  markAllowedNumaNodes(info);
 
   std::sort(info.begin(), info.end());
   markSMT(info);
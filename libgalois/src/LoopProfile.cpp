@@ -0,0 +1,153 @@
+#include "katana/LoopProfile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/ProgressTracer.h"
+#include "katana/Statistics.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+bool
+ProfilingFromEnv(const std::string& var_name) {
+  bool enabled = false;
+  katana::GetEnv(var_name, &enabled);
+  return enabled;
+}
+
+std::atomic<bool>&
+ProfilingFlag() {
+  static std::atomic<bool> flag(ProfilingFromEnv("KATANA_LOOP_PROFILE"));
+  return flag;
+}
+
+std::atomic<bool>&
+ParallelismProfilingFlag() {
+  static std::atomic<bool> flag(
+      ProfilingFromEnv("KATANA_PARALLELISM_PROFILE"));
+  return flag;
+}
+
+uint64_t
+NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+void
+katana::SetLoopProfiling(bool enabled) {
+  ProfilingFlag().store(enabled, std::memory_order_relaxed);
+}
+
+bool
+katana::IsLoopProfiling() {
+  return ProfilingFlag().load(std::memory_order_relaxed);
+}
+
+void
+katana::SetParallelismProfiling(bool enabled) {
+  ParallelismProfilingFlag().store(enabled, std::memory_order_relaxed);
+}
+
+bool
+katana::IsParallelismProfiling() {
+  return ParallelismProfilingFlag().load(std::memory_order_relaxed);
+}
+
+double
+katana::LoopProfile::Summary::imbalance() const {
+  if (busy_ns == 0) {
+    return 1.0;
+  }
+  return static_cast<double>(max_busy_ns) * num_threads / busy_ns;
+}
+
+katana::LoopProfile::LoopProfile(const char* loopname) : loopname_(loopname) {
+  if (!IsLoopProfiling()) {
+    return;
+  }
+  num_records_ = GetThreadPool().getMaxThreads();
+  records_ = std::make_unique<Record[]>(num_records_);
+  begin_ns_ = NowNs();
+}
+
+katana::LoopProfile::~LoopProfile() { Finish(); }
+
+void
+katana::LoopProfile::BeginThreadImpl() {
+  unsigned tid = ThreadPool::getTID();
+  KATANA_LOG_DEBUG_ASSERT(tid < num_records_);
+  records_[tid].begin_ns = NowNs();
+}
+
+void
+katana::LoopProfile::EndThreadImpl(uint64_t chunks, uint64_t steals) {
+  Record& record = records_[ThreadPool::getTID()];
+  record.end_ns = NowNs();
+  record.chunks = chunks;
+  record.steals = steals;
+
+  // reported from the thread itself so that the statistics show the values
+  // of each thread
+  ReportStatSum(loopname_, "ProfileBusyNs", record.end_ns - record.begin_ns);
+  ReportStatSum(loopname_, "ProfileChunks", chunks);
+  ReportStatSum(loopname_, "ProfileSteals", steals);
+}
+
+katana::LoopProfile::Summary
+katana::LoopProfile::Finish() {
+  Summary summary;
+  if (!enabled()) {
+    return summary;
+  }
+
+  uint64_t end_ns = NowNs();
+  summary.wall_ns = end_ns - begin_ns_;
+  for (unsigned i = 0; i < num_records_; ++i) {
+    const Record& record = records_[i];
+    if (record.end_ns == 0) {
+      // did not take part in the loop
+      continue;
+    }
+    uint64_t busy = record.end_ns - record.begin_ns;
+    uint64_t idle = end_ns - record.end_ns;
+    ++summary.num_threads;
+    summary.busy_ns += busy;
+    summary.max_busy_ns = std::max(summary.max_busy_ns, busy);
+    summary.idle_ns += idle;
+    summary.max_idle_ns = std::max(summary.max_idle_ns, idle);
+    summary.chunks += record.chunks;
+    summary.steals += record.steals;
+  }
+  records_.reset();
+
+  ReportStatSum(loopname_, "ProfileIdleNs", summary.idle_ns);
+  ReportStatMax(loopname_, "ProfileMaxIdleNs", summary.max_idle_ns);
+  ReportStatMax(loopname_, "ProfileImbalance", summary.imbalance());
+
+  if (!ProgressTracer::IsSet()) {
+    return summary;
+  }
+  GetTracer().GetActiveSpan().Log(
+      "loop profile", {
+                          {"loop", loopname_},
+                          {"threads", summary.num_threads},
+                          {"wall_ns", summary.wall_ns},
+                          {"busy_ns", summary.busy_ns},
+                          {"max_busy_ns", summary.max_busy_ns},
+                          {"idle_ns", summary.idle_ns},
+                          {"max_idle_ns", summary.max_idle_ns},
+                          {"chunks", summary.chunks},
+                          {"steals", summary.steals},
+                          {"imbalance", summary.imbalance()},
+                      });
+
+  return summary;
+}
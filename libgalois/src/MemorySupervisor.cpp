@@ -1,10 +1,13 @@
 #include "katana/MemorySupervisor.h"
 
 #include <fstream>
+#include <mutex>
 
 #include "katana/Cache.h"
 #include "katana/MemoryPolicy.h"
+#include "katana/Metrics.h"
 #include "katana/PropertyManager.h"
+#include "katana/ScratchPool.h"
 #include "katana/Time.h"
 
 using katana::count_t;
@@ -64,6 +67,14 @@ katana::MemorySupervisor::MemorySupervisor() {
   auto pr = std::make_unique<PropertyManager>();
   const auto& name = pr->Name();
   managers_[name].manager_ = std::move(pr);
+  auto scratch = std::make_unique<ScratchManager>();
+  managers_[scratch->Name()].manager_ = std::move(scratch);
+
+  MetricsRegistry::Get()
+      .GetGauge(
+          "katana_memory_physical_bytes",
+          "Physical memory the memory supervisor plans to use")
+      .Set(physical_);
 
   auto& tracer = katana::GetTracer();
   tracer.GetActiveSpan().Log(
@@ -76,11 +87,26 @@ void
 katana::MemorySupervisor::StandbyMinus(ManagerInfo& info, count_t bytes) {
   info.standby -= bytes;
   standby_ -= bytes;
+  UpdateStandbyMetrics(info);
 }
 void
 katana::MemorySupervisor::StandbyPlus(ManagerInfo& info, count_t bytes) {
   info.standby += bytes;
   standby_ += bytes;
+  UpdateStandbyMetrics(info);
+}
+
+void
+katana::MemorySupervisor::UpdateStandbyMetrics(const ManagerInfo& info) {
+  static Gauge& total_standby = MetricsRegistry::Get().GetGauge(
+      "katana_memory_standby_total_bytes",
+      "Standby memory of all memory managers");
+  total_standby.Set(standby_);
+  MetricsRegistry::Get()
+      .GetGauge(
+          "katana_memory_standby_bytes", "Standby memory of a memory manager",
+          {{"manager", info.manager_->Name()}})
+      .Set(info.standby);
 }
 
 void
@@ -101,10 +127,15 @@ katana::MemorySupervisor::ReclaimMemory(count_t goal) {
     }
   }
   bytes_reclaimed_ += reclaimed;
+  static Counter& reclaimed_total = MetricsRegistry::Get().GetCounter(
+      "katana_memory_reclaimed_bytes_total",
+      "Standby memory reclaimed from memory managers");
+  reclaimed_total.Add(static_cast<uint64_t>(reclaimed));
 }
 
 count_t
 katana::MemorySupervisor::GetStandby(const std::string& name, count_t goal) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto it = managers_.find(name);
   if (it == managers_.end()) {
     KATANA_LOG_WARN("no manager with name {}\n", name);
@@ -126,6 +157,7 @@ katana::MemorySupervisor::GetStandby(const std::string& name, count_t goal) {
 
 void
 katana::MemorySupervisor::PutStandby(const std::string& name, count_t bytes) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto it = managers_.find(name);
   if (it == managers_.end()) {
     KATANA_LOG_WARN("no manager with name {}\n", name);
@@ -144,6 +176,7 @@ katana::MemorySupervisor::PutStandby(const std::string& name, count_t bytes) {
 void
 katana::MemorySupervisor::ActiveToStandby(
     const std::string& name, count_t bytes) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto it = managers_.find(name);
   if (it == managers_.end()) {
     KATANA_LOG_WARN("no manager with name {}\n", name);
@@ -161,6 +194,7 @@ katana::MemorySupervisor::ActiveToStandby(
 void
 katana::MemorySupervisor::StandbyToActive(
     const std::string& name, count_t bytes) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto it = managers_.find(name);
   if (it == managers_.end()) {
     KATANA_LOG_WARN("no manager with name {}\n", name);
@@ -177,12 +211,14 @@ katana::MemorySupervisor::StandbyToActive(
 
 void
 katana::MemorySupervisor::CheckPressure() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   count_t try_reclaim = policy_->ReclaimForMemoryPressure(standby_);
   ReclaimMemory(try_reclaim);
 }
 
 void
 katana::MemorySupervisor::SetPolicy(std::unique_ptr<MemoryPolicy> policy) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   policy_.swap(policy);
   CheckPressure();
   SanityCheck();
@@ -203,6 +239,7 @@ katana::MemorySupervisor::GetPropertyCacheStats() const {
 
 void
 katana::MemorySupervisor::LogMemoryStats(const std::string& message) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   policy_->LogMemoryStats(message, standby_);
 }
 
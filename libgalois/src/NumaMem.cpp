@@ -22,11 +22,14 @@
 #include <cassert>
 
 #include "katana/PageAlloc.h"
+#include "katana/ScratchPool.h"
 #include "katana/ThreadPool.h"
 #include "katana/gIO.h"
 
 using namespace katana;
 
+using katana::internal::LargePlacement;
+
 /* Access pages on each thread so each thread has some pages already loaded
  * (preferably ones it will use) */
 static void
@@ -142,9 +145,22 @@ largeFree(void* ptr, size_t bytes) {
 
 void
 katana::internal::largeFreer::operator()(void* ptr) const {
+  ScratchPool* pool = internal::GetScratchPool();
+  if (pool && placement != LargePlacement::kNone &&
+      pool->Put({bytes, placement, num_threads}, ptr)) {
+    return;
+  }
   largeFree(ptr, bytes);
 }
 
+// an allocation of the same shape retained by the scratch pool, if any
+static LAptr
+takeScratch(size_t bytes, LargePlacement placement, unsigned numThreads) {
+  ScratchPool* pool = internal::GetScratchPool();
+  void* data = pool ? pool->Take({bytes, placement, numThreads}) : nullptr;
+  return LAptr{data, internal::largeFreer{bytes, placement, numThreads}};
+}
+
 // round data to a multiple of mult
 static size_t
 roundup(size_t data, size_t mult) {
@@ -159,6 +175,10 @@ LAptr
 katana::largeMallocInterleaved(size_t bytes, unsigned numThreads) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
+  if (LAptr reused =
+          takeScratch(bytes, LargePlacement::kInterleaved, numThreads)) {
+    return reused;
+  }
 
 #ifdef KATANA_USE_NUMA
   // We don't use numa_alloc_interleaved_subset because we really want huge
@@ -174,37 +194,54 @@ katana::largeMallocInterleaved(size_t bytes, unsigned numThreads) {
     // true = round robin paging
     pageIn(data, bytes, allocSize(), numThreads, true);
 
-  return LAptr{data, internal::largeFreer{bytes}};
+  return LAptr{
+      data, internal::largeFreer{
+                bytes, LargePlacement::kInterleaved, numThreads}};
 }
 
 LAptr
 katana::largeMallocLocal(size_t bytes) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
+  // local pages are only worth reusing on the same socket
+  unsigned socket = ThreadPool::getSocket();
+  if (LAptr reused = takeScratch(bytes, LargePlacement::kLocal, socket)) {
+    return reused;
+  }
   // Get a prefaulted allocation
   return LAptr{
-      allocPages(bytes / allocSize(), true), internal::largeFreer{bytes}};
+      allocPages(bytes / allocSize(), true),
+      internal::largeFreer{bytes, LargePlacement::kLocal, socket}};
 }
 
 LAptr
 katana::largeMallocFloating(size_t bytes) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
+  if (LAptr reused = takeScratch(bytes, LargePlacement::kFloating, 0)) {
+    return reused;
+  }
   // Get a non-prefaulted allocation
   return LAptr{
-      allocPages(bytes / allocSize(), false), internal::largeFreer{bytes}};
+      allocPages(bytes / allocSize(), false),
+      internal::largeFreer{bytes, LargePlacement::kFloating, 0}};
 }
 
 LAptr
 katana::largeMallocBlocked(size_t bytes, unsigned numThreads) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
+  if (LAptr reused = takeScratch(bytes, LargePlacement::kBlocked, numThreads)) {
+    return reused;
+  }
   // Get a non-prefaulted allocation
   void* data = allocPages(bytes / allocSize(), false);
   if (data)
     // false = blocked paging
     pageIn(data, bytes, allocSize(), numThreads, false);
-  return LAptr{data, internal::largeFreer{bytes}};
+  return LAptr{
+      data,
+      internal::largeFreer{bytes, LargePlacement::kBlocked, numThreads}};
 }
 
 /**
@@ -100,17 +100,27 @@ katana::allocPages(unsigned num, bool preFault) {
   }
 
   void* ptr = trymmap(num * hugePageSize, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+  bool hand_map = doHandMap;
   if (!ptr) {
     KATANA_DEBUG_WARN_ONCE(
         "huge page alloc failed, falling back to regular pages");
-    ptr = trymmap(num * hugePageSize, preFault ? _MAP_POP : _MAP);
+    // Map without populating so that transparent huge pages can back the
+    // region when it is first touched; populating first would fault it in
+    // as small pages
+    ptr = trymmap(num * hugePageSize, _MAP);
+#ifdef MADV_HUGEPAGE
+    if (ptr) {
+      madvise(ptr, num * hugePageSize, MADV_HUGEPAGE);
+    }
+#endif
+    hand_map = true;
   }
 
   if (!ptr) {
     KATANA_LOG_FATAL("failed to allocate: {}", errno);
   }
 
-  if (preFault && doHandMap) {
+  if (preFault && hand_map) {
     for (size_t x = 0; x < num * hugePageSize; x += 4096) {
       static_cast<char*>(ptr)[x] = 0;
     }
@@ -17,12 +17,42 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
 #include <ctime>
+#include <string>
+#include <vector>
 
 #include "katana/Env.h"
 #include "katana/Executor_ParaMeter.h"
+#include "katana/ProgressTracer.h"
+#include "katana/Statistics.h"
 #include "katana/gIO.h"
 
+namespace {
+
+/// Most entries in the logged profile of parallelism over the rounds of a
+/// loop; longer loops log the mean of consecutive rounds
+constexpr size_t kMaxProfileSamples = 256;
+
+std::string
+FormatParallelism(const std::vector<uint64_t>& parallelism, size_t per_sample) {
+  std::string ret;
+  for (size_t i = 0; i < parallelism.size(); i += per_sample) {
+    size_t end = std::min(i + per_sample, parallelism.size());
+    uint64_t sum = 0;
+    for (size_t j = i; j < end; ++j) {
+      sum += parallelism[j];
+    }
+    if (!ret.empty()) {
+      ret += ",";
+    }
+    ret += std::to_string(sum / (end - i));
+  }
+  return ret;
+}
+
+}  // namespace
+
 struct StatsFileManager {
   bool init = false;
   bool isOpen = false;
@@ -98,3 +128,40 @@ void
 katana::parameter::closeStatsFile(void) {
   getStatsFileManager().close();
 }
+
+FILE*
+katana::parameter::getNamedStatsFile(void) {
+  std::string name;
+  if (!katana::GetEnv("KATANA_PARAMETER_OUTFILE", &name)) {
+    return nullptr;
+  }
+  return getStatsFileManager().get();
+}
+
+void
+katana::parameter::ReportParallelismProfile(
+    const char* loopname, const ParallelismProfile& profile) {
+  ReportStatSum(loopname, "ParaMeterRounds", profile.rounds());
+  ReportStatSum(loopname, "ParaMeterIterations", profile.iterations);
+  ReportStatMax(loopname, "ParaMeterMaxParallelism", profile.max_parallelism);
+
+  if (!ProgressTracer::IsSet()) {
+    return;
+  }
+  size_t per_sample =
+      (profile.parallelism.size() + kMaxProfileSamples - 1) /
+      kMaxProfileSamples;
+  per_sample = std::max<size_t>(per_sample, 1);
+  GetTracer().GetActiveSpan().Log(
+      "parallelism profile",
+      {
+          {"loop", loopname},
+          {"rounds", profile.rounds()},
+          {"iterations", profile.iterations},
+          {"aborts", profile.aborts},
+          {"max_parallelism", profile.max_parallelism},
+          {"mean_parallelism", profile.mean_parallelism()},
+          {"rounds_per_sample", static_cast<uint64_t>(per_sample)},
+          {"parallelism", FormatParallelism(profile.parallelism, per_sample)},
+      });
+}
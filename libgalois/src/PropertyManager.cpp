@@ -1,12 +1,71 @@
 #include "katana/PropertyManager.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+
 #include "katana/ArrowInterchange.h"
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/MemorySupervisor.h"
+#include "katana/Metrics.h"
 #include "katana/ProgressTracer.h"
+#include "katana/Random.h"
 
 const std::string katana::PropertyManager::name_ = "property";
 
+namespace {
+
+// Rough bandwidths, in bytes per microsecond, used to guess what a reload
+// would cost for properties whose load time was never measured
+constexpr double kLocalBytesPerUs = 1000.0;  // ~1 GB/s
+constexpr double kRemoteBytesPerUs = 100.0;  // ~100 MB/s
+
+// Properties whose reload costs are remembered; past this many, the half
+// used least recently is forgotten
+constexpr size_t kMaxReloadCosts = 1 << 16;
+
+// Bytes of evicted properties that may wait for the spill thread at once.
+// The supervisor counts evicted bytes as freed right away, so past this,
+// evicted properties are dropped as they are without a spill directory
+// rather than held until the disk catches up.
+constexpr uint64_t kMaxSpillQueueBytes = uint64_t{1} << 30;
+
+katana::Result<void>
+WriteSpillFile(
+    const std::string& file_name, const std::shared_ptr<arrow::Table>& table) {
+  std::shared_ptr<arrow::io::FileOutputStream> out =
+      KATANA_CHECKED(arrow::io::FileOutputStream::Open(file_name));
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer =
+      KATANA_CHECKED(arrow::ipc::MakeFileWriter(out, table->schema()));
+  KATANA_CHECKED(writer->WriteTable(*table));
+  KATANA_CHECKED(writer->Close());
+  KATANA_CHECKED(out->Close());
+  return katana::ResultSuccess();
+}
+
+/// The returned table references the mapping directly, so its pages are
+/// backed by the file rather than by anonymous memory
+katana::Result<std::shared_ptr<arrow::Table>>
+MapSpillFile(const std::string& file_name) {
+  std::shared_ptr<arrow::io::MemoryMappedFile> file = KATANA_CHECKED(
+      arrow::io::MemoryMappedFile::Open(file_name, arrow::io::FileMode::READ));
+  std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader =
+      KATANA_CHECKED(arrow::ipc::RecordBatchFileReader::Open(file));
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (int i = 0; i < reader->num_record_batches(); ++i) {
+    batches.emplace_back(KATANA_CHECKED(reader->ReadRecordBatch(i)));
+  }
+  return KATANA_CHECKED(
+      arrow::Table::FromRecordBatches(reader->schema(), batches));
+}
+
+}  // namespace
+
 // Anchor manager vtable
 katana::Manager::~Manager() = default;
 
@@ -19,15 +78,245 @@ katana::PropertyManager::MakePropertyCache() {
       [](const std::shared_ptr<arrow::Table>& table) {
         return ApproxTableMemUse(table);
       });
+  cache_->SetEvictionScore(
+      [this](
+          const katana::URI& property_path,
+          const std::shared_ptr<arrow::Table>& property) {
+        return RetentionScore(property_path, property);
+      });
+  if (!spill_dir_.empty()) {
+    cache_->SetEvictionCallback(
+        [this](
+            const katana::URI& property_path,
+            std::shared_ptr<arrow::Table>&& property) {
+          SpillProperty(property_path, std::move(property));
+        });
+  }
+}
+
+void
+katana::PropertyManager::SpillProperty(
+    const katana::URI& property_path,
+    std::shared_ptr<arrow::Table>&& property) {
+  uint64_t bytes = katana::ApproxTableMemUse(property);
+  {
+    std::lock_guard<std::mutex> lock(spilled_mutex_);
+    if (spill_queue_bytes_ + bytes > kMaxSpillQueueBytes) {
+      KATANA_LOG_DEBUG(
+          "spill queue is full, dropping {}", property_path.BaseName());
+      return;
+    }
+    spill_queue_bytes_ += bytes;
+    spill_queue_.emplace_back(property_path, std::move(property));
+  }
+  spill_cv_.notify_one();
+}
+
+void
+katana::PropertyManager::SpillLoop() {
+  std::unique_lock<std::mutex> lock(spilled_mutex_);
+  while (true) {
+    spill_cv_.wait(
+        lock, [this] { return stop_spilling_ || !spill_queue_.empty(); });
+    if (stop_spilling_) {
+      return;
+    }
+    auto [property_path, property] = std::move(spill_queue_.front());
+    spill_queue_.pop_front();
+    lock.unlock();
+    WriteSpill(property_path, property);
+    // Free the property before waiting for the next one
+    uint64_t bytes = katana::ApproxTableMemUse(property);
+    property.reset();
+    lock.lock();
+    spill_queue_bytes_ -= bytes;
+  }
+}
+
+void
+katana::PropertyManager::WriteSpill(
+    const katana::URI& property_path,
+    const std::shared_ptr<arrow::Table>& property) {
+  std::string file_name = fmt::format(
+      "{}/{}-{}.arrow", spill_dir_, property_path.BaseName(),
+      katana::RandomAlphanumericString(12));
+  if (auto res = WriteSpillFile(file_name, property); !res) {
+    KATANA_LOG_WARN("spilling property to {}: {}", file_name, res.error());
+    std::remove(file_name.c_str());
+    return;
+  }
+  katana::GetTracer().GetActiveSpan().Log(
+      "property cache spill",
+      {
+          {"storage_name", property_path.BaseName()},
+          {"spill_file", file_name},
+          {"approx_size_gb", ToGB(katana::ApproxTableMemUse(property))},
+      });
+
+  std::string old_file;
+  {
+    std::lock_guard<std::mutex> lock(spilled_mutex_);
+    std::string& spilled = spilled_[property_path];
+    old_file = std::move(spilled);
+    spilled = std::move(file_name);
+  }
+  if (!old_file.empty()) {
+    std::remove(old_file.c_str());
+  }
+}
+
+std::shared_ptr<arrow::Table>
+katana::PropertyManager::UnspillProperty(const katana::URI& property_path) {
+  std::string file_name;
+  {
+    std::lock_guard<std::mutex> lock(spilled_mutex_);
+    // Not written yet: take it back from the queue
+    for (auto it = spill_queue_.begin(); it != spill_queue_.end(); ++it) {
+      if (it->first == property_path) {
+        std::shared_ptr<arrow::Table> property = std::move(it->second);
+        spill_queue_.erase(it);
+        spill_queue_bytes_ -= katana::ApproxTableMemUse(property);
+        return property;
+      }
+    }
+    auto it = spilled_.find(property_path);
+    if (it == spilled_.end()) {
+      return nullptr;
+    }
+    file_name = std::move(it->second);
+    spilled_.erase(it);
+  }
+  auto res = MapSpillFile(file_name);
+  // The mapping stays valid after the name is gone
+  std::remove(file_name.c_str());
+  if (!res) {
+    KATANA_LOG_WARN("mapping spilled property {}: {}", file_name, res.error());
+    return nullptr;
+  }
+  katana::GetTracer().GetActiveSpan().Log(
+      "property cache unspill",
+      {
+          {"storage_name", property_path.BaseName()},
+          {"spill_file", file_name},
+      });
+  return res.value();
 }
 
-katana::PropertyManager::PropertyManager() { MakePropertyCache(); }
-katana::PropertyManager::~PropertyManager() { cache_.reset(); }
+katana::PropertyManager::ReloadCost&
+katana::PropertyManager::TouchReloadCost(const katana::URI& property_path) {
+  if (reload_costs_.size() >= kMaxReloadCosts &&
+      reload_costs_.find(property_path) == reload_costs_.end()) {
+    std::vector<uint64_t> last_uses;
+    last_uses.reserve(reload_costs_.size());
+    for (const auto& [path, cost] : reload_costs_) {
+      last_uses.emplace_back(cost.last_use);
+    }
+    auto median = last_uses.begin() + last_uses.size() / 2;
+    std::nth_element(last_uses.begin(), median, last_uses.end());
+    uint64_t cutoff = *median;
+    for (auto it = reload_costs_.begin(); it != reload_costs_.end();) {
+      it = it->second.last_use < cutoff ? reload_costs_.erase(it) : ++it;
+    }
+  }
+  ReloadCost& cost = reload_costs_[property_path];
+  cost.last_use = ++reload_costs_clock_;
+  return cost;
+}
+
+double
+katana::PropertyManager::RetentionScore(
+    const katana::URI& property_path,
+    const std::shared_ptr<arrow::Table>& property) const {
+  auto bytes = static_cast<double>(katana::ApproxTableMemUse(property));
+  if (bytes < 1.0) {
+    bytes = 1.0;
+  }
+
+  ReloadCost cost;
+  {
+    std::lock_guard<std::mutex> lock(reload_costs_mutex_);
+    auto it = reload_costs_.find(property_path);
+    if (it != reload_costs_.end()) {
+      cost = it->second;
+    }
+  }
+
+  double load_us = static_cast<double>(cost.load_us);
+  if (cost.load_us == 0) {
+    bool is_local = property_path.scheme() == katana::URI::kFileScheme;
+    load_us = bytes / (is_local ? kLocalBytesPerUs : kRemoteBytesPerUs);
+  }
+  return load_us * static_cast<double>(1 + cost.reuse_count) / bytes;
+}
+
+katana::PropertyManager::PropertyManager() {
+  katana::GetEnv("KATANA_PROPERTY_SPILL_DIR", &spill_dir_);
+  MakePropertyCache();
+  AddMetricsCollector();
+  if (!spill_dir_.empty()) {
+    spill_thread_ = std::thread([this] { SpillLoop(); });
+  }
+}
+
+katana::PropertyManager::~PropertyManager() {
+  MetricsRegistry::Get().RemoveCollector(metrics_collector_id_);
+  cache_.reset();
+  if (spill_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(spilled_mutex_);
+      stop_spilling_ = true;
+    }
+    spill_cv_.notify_one();
+    spill_thread_.join();
+  }
+  for (const auto& [property_path, file_name] : spilled_) {
+    std::remove(file_name.c_str());
+  }
+}
+
+void
+katana::PropertyManager::AddMetricsCollector() {
+  metrics_collector_id_ = MetricsRegistry::Get().AddCollector(
+      [this](std::vector<MetricFamily>* families) {
+        CacheStats stats = cache_->GetStats();
+        auto add = [&](const char* name, const char* help, MetricType type,
+                       double value) {
+          MetricFamily family{name, help, type, {}, {}};
+          family.AddSample(value);
+          families->emplace_back(std::move(family));
+        };
+        add("katana_property_cache_gets_total",
+            "Property cache lookups", MetricType::kCounter, stats.get_count);
+        add("katana_property_cache_get_hits_total",
+            "Property cache lookups that found the property",
+            MetricType::kCounter, stats.get_hit_count);
+        add("katana_property_cache_inserts_total",
+            "Properties put in the property cache", MetricType::kCounter,
+            stats.insert_count);
+        add("katana_property_cache_insert_hits_total",
+            "Properties put in the property cache that were already there",
+            MetricType::kCounter, stats.insert_hit_count);
+        add("katana_property_cache_bytes",
+            "Approximate bytes of the properties in the property cache",
+            MetricType::kGauge, cache_->size());
+        add("katana_property_loaded_bytes_total",
+            "Bytes of properties loaded from storage", MetricType::kCounter,
+            bytes_loaded_.load(std::memory_order_relaxed));
+        add("katana_property_shared_bytes_total",
+            "Bytes of properties shared with a graph that already held them",
+            MetricType::kCounter,
+            bytes_shared_.load(std::memory_order_relaxed));
+      });
+}
 
 std::shared_ptr<arrow::Table>
 katana::PropertyManager::GetProperty(const katana::URI& property_path) {
   auto property = cache_->GetAndEvict(property_path);
   if (property.has_value()) {
+    {
+      std::lock_guard<std::mutex> lock(reload_costs_mutex_);
+      TouchReloadCost(property_path).reuse_count++;
+    }
     auto bytes =
         static_cast<count_t>(katana::ApproxTableMemUse(property.value()));
     MemorySupervisor::Get().StandbyToActive(Name(), bytes);
@@ -40,6 +329,13 @@ katana::PropertyManager::GetProperty(const katana::URI& property_path) {
         });
     return property.value();
   }
+  if (auto spilled = UnspillProperty(property_path); spilled) {
+    // Spilled bytes were already returned to the supervisor when they were
+    // evicted so there is no standby memory to transition here
+    std::lock_guard<std::mutex> lock(reload_costs_mutex_);
+    TouchReloadCost(property_path).reuse_count++;
+    return spilled;
+  }
   MemorySupervisor::Get().CheckPressure();
   katana::GetTracer().GetActiveSpan().Log(
       "property cache get not found",
@@ -52,10 +348,15 @@ katana::PropertyManager::GetProperty(const katana::URI& property_path) {
 
 void
 katana::PropertyManager::PropertyLoadedActive(
-    const std::shared_ptr<arrow::Table>& property) {
+    const std::shared_ptr<arrow::Table>& property,
+    const katana::URI& property_path, uint64_t load_us) {
   KATANA_LOG_DEBUG_ASSERT(property);
   auto sz = katana::ApproxTableMemUse(property);
-  stats.bytes_loaded += sz;
+  bytes_loaded_ += sz;
+  {
+    std::lock_guard<std::mutex> lock(reload_costs_mutex_);
+    TouchReloadCost(property_path).load_us = load_us;
+  }
   katana::GetTracer().GetActiveSpan().Log(
       "property cache loaded active", {
                                           {"name", property->field(0)->name()},
@@ -63,6 +364,58 @@ katana::PropertyManager::PropertyLoadedActive(
                                       });
 }
 
+std::shared_ptr<arrow::Table>
+katana::PropertyManager::GetSharedProperty(const katana::URI& property_path) {
+  std::shared_ptr<arrow::Field> field;
+  std::shared_ptr<arrow::ChunkedArray> column;
+  {
+    std::lock_guard<std::mutex> lock(shared_mutex_);
+    auto it = shared_.find(property_path);
+    if (it == shared_.end()) {
+      return nullptr;
+    }
+    column = it->second.column.lock();
+    if (!column) {
+      shared_.erase(it);
+      return nullptr;
+    }
+    field = it->second.field;
+  }
+  {
+    std::lock_guard<std::mutex> lock(reload_costs_mutex_);
+    TouchReloadCost(property_path).reuse_count++;
+  }
+  auto property = arrow::Table::Make(arrow::schema({field}), {column});
+  auto bytes = katana::ApproxTableMemUse(property);
+  bytes_shared_ += bytes;
+  katana::GetTracer().GetActiveSpan().Log(
+      "property shared", {
+                             {"storage_name", property_path.BaseName()},
+                             {"approx_size_gb", ToGB(bytes)},
+                         });
+  return property;
+}
+
+void
+katana::PropertyManager::ShareProperty(
+    const std::shared_ptr<arrow::Table>& property,
+    const katana::URI& property_path) {
+  KATANA_LOG_DEBUG_ASSERT(property && property->num_columns() == 1);
+  std::lock_guard<std::mutex> lock(shared_mutex_);
+  // Drop the entries of properties no graph holds anymore
+  for (auto it = shared_.begin(); it != shared_.end();) {
+    if (it->second.column.expired()) {
+      it = shared_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  SharedProperty& shared = shared_[property_path];
+  if (shared.column.expired()) {
+    shared = SharedProperty{property->field(0), property->column(0)};
+  }
+}
+
 void
 katana::PropertyManager::PutProperty(
     const katana::URI& property_path,
@@ -0,0 +1,551 @@
+#include "katana/RoaringBitmap.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "katana/Galois.h"
+
+namespace {
+
+/// The number of containers below which the bulk operations run on the
+/// calling thread only
+constexpr size_t kParallelContainers = 16;
+
+uint32_t
+PopCount(const std::vector<uint64_t>& words) {
+  uint32_t count = 0;
+  for (uint64_t word : words) {
+    count += __builtin_popcountll(word);
+  }
+  return count;
+}
+
+bool
+TestBit(const std::vector<uint64_t>& words, uint16_t low) {
+  return (words[low / 64] >> (low % 64)) & 1;
+}
+
+template <typename Fn>
+void
+ForEachContainer(size_t num_containers, const Fn& fn) {
+  if (num_containers < kParallelContainers) {
+    for (size_t i = 0; i < num_containers; ++i) {
+      fn(i);
+    }
+    return;
+  }
+  katana::do_all(
+      katana::iterate(size_t{0}, num_containers), fn, katana::steal(),
+      katana::no_stats());
+}
+
+}  // namespace
+
+bool
+katana::RoaringBitmap::Container::Add(uint16_t low) {
+  if (IsBitmap()) {
+    uint64_t mask = uint64_t{1} << (low % 64);
+    uint64_t& word = words[low / 64];
+    if (word & mask) {
+      return false;
+    }
+    word |= mask;
+    ++cardinality;
+    return true;
+  }
+  auto it = std::lower_bound(values.begin(), values.end(), low);
+  if (it != values.end() && *it == low) {
+    return false;
+  }
+  values.insert(it, low);
+  ++cardinality;
+  if (cardinality > kMaxArrayValues) {
+    ToBitmap();
+  }
+  return true;
+}
+
+bool
+katana::RoaringBitmap::Container::Remove(uint16_t low) {
+  if (IsBitmap()) {
+    uint64_t mask = uint64_t{1} << (low % 64);
+    uint64_t& word = words[low / 64];
+    if (!(word & mask)) {
+      return false;
+    }
+    word &= ~mask;
+    --cardinality;
+    if (cardinality <= kMaxArrayValues) {
+      ToArray();
+    }
+    return true;
+  }
+  auto it = std::lower_bound(values.begin(), values.end(), low);
+  if (it == values.end() || *it != low) {
+    return false;
+  }
+  values.erase(it);
+  --cardinality;
+  return true;
+}
+
+bool
+katana::RoaringBitmap::Container::Contains(uint16_t low) const {
+  if (IsBitmap()) {
+    return TestBit(words, low);
+  }
+  return std::binary_search(values.begin(), values.end(), low);
+}
+
+void
+katana::RoaringBitmap::Container::UnionWith(const Container& other) {
+  if (!IsBitmap() && !other.IsBitmap() &&
+      cardinality + other.cardinality <= kMaxArrayValues) {
+    std::vector<uint16_t> merged;
+    merged.reserve(cardinality + other.cardinality);
+    std::set_union(
+        values.begin(), values.end(), other.values.begin(),
+        other.values.end(), std::back_inserter(merged));
+    values = std::move(merged);
+    cardinality = values.size();
+    return;
+  }
+  ToBitmap();
+  if (other.IsBitmap()) {
+    for (size_t w = 0; w < kBitmapWords; ++w) {
+      words[w] |= other.words[w];
+    }
+  } else {
+    for (uint16_t low : other.values) {
+      words[low / 64] |= uint64_t{1} << (low % 64);
+    }
+  }
+  cardinality = PopCount(words);
+  Normalize();
+}
+
+void
+katana::RoaringBitmap::Container::IntersectWith(const Container& other) {
+  if (IsBitmap() && other.IsBitmap()) {
+    for (size_t w = 0; w < kBitmapWords; ++w) {
+      words[w] &= other.words[w];
+    }
+    cardinality = PopCount(words);
+    Normalize();
+    return;
+  }
+  std::vector<uint16_t> common;
+  if (IsBitmap() || other.IsBitmap()) {
+    const Container& array = IsBitmap() ? other : *this;
+    const Container& bitmap = IsBitmap() ? *this : other;
+    for (uint16_t low : array.values) {
+      if (TestBit(bitmap.words, low)) {
+        common.emplace_back(low);
+      }
+    }
+  } else {
+    std::set_intersection(
+        values.begin(), values.end(), other.values.begin(),
+        other.values.end(), std::back_inserter(common));
+  }
+  words.clear();
+  values = std::move(common);
+  cardinality = values.size();
+}
+
+void
+katana::RoaringBitmap::Container::SubtractWith(const Container& other) {
+  if (IsBitmap()) {
+    if (other.IsBitmap()) {
+      for (size_t w = 0; w < kBitmapWords; ++w) {
+        words[w] &= ~other.words[w];
+      }
+    } else {
+      for (uint16_t low : other.values) {
+        words[low / 64] &= ~(uint64_t{1} << (low % 64));
+      }
+    }
+    cardinality = PopCount(words);
+    Normalize();
+    return;
+  }
+  std::vector<uint16_t> remaining;
+  if (other.IsBitmap()) {
+    for (uint16_t low : values) {
+      if (!TestBit(other.words, low)) {
+        remaining.emplace_back(low);
+      }
+    }
+  } else {
+    std::set_difference(
+        values.begin(), values.end(), other.values.begin(),
+        other.values.end(), std::back_inserter(remaining));
+  }
+  values = std::move(remaining);
+  cardinality = values.size();
+}
+
+bool
+katana::RoaringBitmap::Container::IsSubsetOf(const Container& other) const {
+  if (cardinality > other.cardinality) {
+    return false;
+  }
+  if (IsBitmap()) {
+    // other has at least as many values, so it is a bitmap too
+    for (size_t w = 0; w < kBitmapWords; ++w) {
+      if (words[w] & ~other.words[w]) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (other.IsBitmap()) {
+    return std::all_of(values.begin(), values.end(), [&](uint16_t low) {
+      return TestBit(other.words, low);
+    });
+  }
+  return std::includes(
+      other.values.begin(), other.values.end(), values.begin(), values.end());
+}
+
+bool
+katana::RoaringBitmap::Container::Intersects(const Container& other) const {
+  if (IsBitmap() && other.IsBitmap()) {
+    for (size_t w = 0; w < kBitmapWords; ++w) {
+      if (words[w] & other.words[w]) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (IsBitmap() || other.IsBitmap()) {
+    const Container& array = IsBitmap() ? other : *this;
+    const Container& bitmap = IsBitmap() ? *this : other;
+    return std::any_of(
+        array.values.begin(), array.values.end(),
+        [&](uint16_t low) { return TestBit(bitmap.words, low); });
+  }
+  auto a = values.begin();
+  auto b = other.values.begin();
+  while (a != values.end() && b != other.values.end()) {
+    if (*a < *b) {
+      ++a;
+    } else if (*b < *a) {
+      ++b;
+    } else {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+katana::RoaringBitmap::Container::operator==(const Container& other) const {
+  // Containers are normalized, so equal sets have the same representation
+  return cardinality == other.cardinality && values == other.values &&
+         words == other.words;
+}
+
+void
+katana::RoaringBitmap::Container::Normalize() {
+  if (cardinality > kMaxArrayValues) {
+    ToBitmap();
+  } else {
+    ToArray();
+  }
+}
+
+void
+katana::RoaringBitmap::Container::ToBitmap() {
+  if (IsBitmap()) {
+    return;
+  }
+  words.assign(kBitmapWords, 0);
+  for (uint16_t low : values) {
+    words[low / 64] |= uint64_t{1} << (low % 64);
+  }
+  values.clear();
+  values.shrink_to_fit();
+}
+
+void
+katana::RoaringBitmap::Container::ToArray() {
+  if (!IsBitmap()) {
+    return;
+  }
+  values.reserve(cardinality);
+  for (size_t w = 0; w < kBitmapWords; ++w) {
+    uint64_t word = words[w];
+    while (word) {
+      values.emplace_back(w * 64 + __builtin_ctzll(word));
+      word &= word - 1;
+    }
+  }
+  words.clear();
+  words.shrink_to_fit();
+}
+
+katana::RoaringBitmap
+katana::RoaringBitmap::FromSorted(const std::vector<uint32_t>& values) {
+  RoaringBitmap bitmap;
+  for (size_t i = 0; i < values.size();) {
+    uint16_t key = values[i] >> 16;
+    Container container;
+    for (; i < values.size() && (values[i] >> 16) == key; ++i) {
+      uint16_t low = values[i] & 0xffff;
+      if (container.values.empty() || container.values.back() != low) {
+        container.values.emplace_back(low);
+      }
+    }
+    container.cardinality = container.values.size();
+    container.Normalize();
+    bitmap.keys_.emplace_back(key);
+    bitmap.containers_.emplace_back(std::move(container));
+  }
+  return bitmap;
+}
+
+size_t
+katana::RoaringBitmap::Find(uint16_t key) const {
+  return std::lower_bound(keys_.begin(), keys_.end(), key) - keys_.begin();
+}
+
+void
+katana::RoaringBitmap::Keep(size_t from, size_t to) {
+  if (from != to) {
+    keys_[to] = keys_[from];
+    containers_[to] = std::move(containers_[from]);
+  }
+}
+
+void
+katana::RoaringBitmap::Truncate(size_t size) {
+  keys_.resize(size);
+  containers_.resize(size);
+}
+
+bool
+katana::RoaringBitmap::Add(uint32_t value) {
+  uint16_t key = value >> 16;
+  size_t i = Find(key);
+  if (i == keys_.size() || keys_[i] != key) {
+    keys_.insert(keys_.begin() + i, key);
+    containers_.insert(containers_.begin() + i, Container{});
+  }
+  return containers_[i].Add(value & 0xffff);
+}
+
+bool
+katana::RoaringBitmap::Remove(uint32_t value) {
+  uint16_t key = value >> 16;
+  size_t i = Find(key);
+  if (i == keys_.size() || keys_[i] != key) {
+    return false;
+  }
+  if (!containers_[i].Remove(value & 0xffff)) {
+    return false;
+  }
+  if (containers_[i].cardinality == 0) {
+    keys_.erase(keys_.begin() + i);
+    containers_.erase(containers_.begin() + i);
+  }
+  return true;
+}
+
+bool
+katana::RoaringBitmap::Contains(uint32_t value) const {
+  uint16_t key = value >> 16;
+  size_t i = Find(key);
+  return i != keys_.size() && keys_[i] == key &&
+         containers_[i].Contains(value & 0xffff);
+}
+
+uint64_t
+katana::RoaringBitmap::Cardinality() const {
+  uint64_t count = 0;
+  for (const Container& container : containers_) {
+    count += container.cardinality;
+  }
+  return count;
+}
+
+void
+katana::RoaringBitmap::clear() {
+  keys_.clear();
+  containers_.clear();
+}
+
+katana::RoaringBitmap&
+katana::RoaringBitmap::operator|=(const RoaringBitmap& other) {
+  std::vector<uint16_t> keys;
+  std::vector<Container> containers;
+  keys.reserve(keys_.size() + other.keys_.size());
+  containers.reserve(keys_.size() + other.keys_.size());
+  size_t a = 0;
+  size_t b = 0;
+  while (a < keys_.size() || b < other.keys_.size()) {
+    if (b == other.keys_.size() ||
+        (a < keys_.size() && keys_[a] < other.keys_[b])) {
+      keys.emplace_back(keys_[a]);
+      containers.emplace_back(std::move(containers_[a++]));
+    } else if (a == keys_.size() || other.keys_[b] < keys_[a]) {
+      keys.emplace_back(other.keys_[b]);
+      containers.emplace_back(other.containers_[b++]);
+    } else {
+      keys.emplace_back(keys_[a]);
+      containers.emplace_back(std::move(containers_[a++]));
+      containers.back().UnionWith(other.containers_[b++]);
+    }
+  }
+  keys_ = std::move(keys);
+  containers_ = std::move(containers);
+  return *this;
+}
+
+katana::RoaringBitmap&
+katana::RoaringBitmap::operator&=(const RoaringBitmap& other) {
+  size_t out = 0;
+  size_t b = 0;
+  for (size_t a = 0; a < keys_.size(); ++a) {
+    while (b < other.keys_.size() && other.keys_[b] < keys_[a]) {
+      ++b;
+    }
+    if (b == other.keys_.size() || other.keys_[b] != keys_[a]) {
+      continue;
+    }
+    containers_[a].IntersectWith(other.containers_[b]);
+    if (containers_[a].cardinality != 0) {
+      Keep(a, out++);
+    }
+  }
+  Truncate(out);
+  return *this;
+}
+
+katana::RoaringBitmap&
+katana::RoaringBitmap::operator-=(const RoaringBitmap& other) {
+  size_t out = 0;
+  size_t b = 0;
+  for (size_t a = 0; a < keys_.size(); ++a) {
+    while (b < other.keys_.size() && other.keys_[b] < keys_[a]) {
+      ++b;
+    }
+    if (b < other.keys_.size() && other.keys_[b] == keys_[a]) {
+      containers_[a].SubtractWith(other.containers_[b]);
+    }
+    if (containers_[a].cardinality != 0) {
+      Keep(a, out++);
+    }
+  }
+  Truncate(out);
+  return *this;
+}
+
+bool
+katana::RoaringBitmap::IsSubsetOf(const RoaringBitmap& other) const {
+  size_t b = 0;
+  for (size_t a = 0; a < keys_.size(); ++a) {
+    while (b < other.keys_.size() && other.keys_[b] < keys_[a]) {
+      ++b;
+    }
+    if (b == other.keys_.size() || other.keys_[b] != keys_[a] ||
+        !containers_[a].IsSubsetOf(other.containers_[b])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+katana::RoaringBitmap::Intersects(const RoaringBitmap& other) const {
+  size_t a = 0;
+  size_t b = 0;
+  while (a < keys_.size() && b < other.keys_.size()) {
+    if (keys_[a] < other.keys_[b]) {
+      ++a;
+    } else if (other.keys_[b] < keys_[a]) {
+      ++b;
+    } else if (containers_[a++].Intersects(other.containers_[b++])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+katana::RoaringBitmap::operator==(const RoaringBitmap& other) const {
+  return keys_ == other.keys_ && containers_ == other.containers_;
+}
+
+std::vector<uint32_t>
+katana::RoaringBitmap::ToVector() const {
+  std::vector<uint32_t> values;
+  values.reserve(Cardinality());
+  ForEach([&](uint32_t value) { values.emplace_back(value); });
+  return values;
+}
+
+size_t
+katana::RoaringBitmap::SizeInBytes() const {
+  size_t bytes = keys_.size() * (sizeof(uint16_t) + sizeof(Container));
+  for (const Container& container : containers_) {
+    bytes += container.values.size() * sizeof(uint16_t) +
+             container.words.size() * sizeof(uint64_t);
+  }
+  return bytes;
+}
+
+katana::RoaringBitmap
+katana::RoaringBitmap::ParallelUnion(
+    const std::vector<const RoaringBitmap*>& bitmaps) {
+  RoaringBitmap result;
+  for (const RoaringBitmap* bitmap : bitmaps) {
+    std::vector<uint16_t> keys;
+    std::set_union(
+        result.keys_.begin(), result.keys_.end(), bitmap->keys_.begin(),
+        bitmap->keys_.end(), std::back_inserter(keys));
+    result.keys_ = std::move(keys);
+  }
+  result.containers_.resize(result.keys_.size());
+
+  // Each container is the union of the containers for its key, so the
+  // containers are independent work
+  ForEachContainer(result.keys_.size(), [&](size_t i) {
+    uint16_t key = result.keys_[i];
+    Container& container = result.containers_[i];
+    for (const RoaringBitmap* bitmap : bitmaps) {
+      size_t j = bitmap->Find(key);
+      if (j != bitmap->keys_.size() && bitmap->keys_[j] == key) {
+        container.UnionWith(bitmap->containers_[j]);
+      }
+    }
+  });
+  return result;
+}
+
+katana::RoaringBitmap
+katana::RoaringBitmap::ParallelIntersection(
+    const RoaringBitmap& a, const RoaringBitmap& b) {
+  RoaringBitmap result;
+  std::set_intersection(
+      a.keys_.begin(), a.keys_.end(), b.keys_.begin(), b.keys_.end(),
+      std::back_inserter(result.keys_));
+  result.containers_.resize(result.keys_.size());
+
+  ForEachContainer(result.keys_.size(), [&](size_t i) {
+    uint16_t key = result.keys_[i];
+    Container& container = result.containers_[i];
+    container = a.containers_[a.Find(key)];
+    container.IntersectWith(b.containers_[b.Find(key)]);
+  });
+
+  // Drop the keys whose containers share no values
+  size_t out = 0;
+  for (size_t i = 0; i < result.keys_.size(); ++i) {
+    if (result.containers_[i].cardinality != 0) {
+      result.Keep(i, out++);
+    }
+  }
+  result.Truncate(out);
+  return result;
+}
@@ -0,0 +1,171 @@
+#include "katana/ScratchPool.h"
+
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/PageAlloc.h"
+#include "katana/ProgressTracer.h"
+
+const std::string katana::ScratchManager::name_ = "scratch";
+
+namespace {
+
+katana::ScratchPool* pool_instance;
+
+/// Fraction of physical memory retained by default
+constexpr uint64_t kDefaultCapacityDivisor = 16;
+
+/// The lock of the memory supervisor, which is taken before the lock of the
+/// pool so that a reclaim never sees the retained bytes and their
+/// accounting disagree. Without a tracer nothing is retained and there is
+/// no supervisor.
+std::unique_lock<std::recursive_mutex>
+LockSupervisor() {
+  if (!katana::ProgressTracer::IsSet()) {
+    return {};
+  }
+  return katana::MemorySupervisor::Get().Lock();
+}
+
+}  // namespace
+
+void
+katana::internal::SetScratchPool(ScratchPool* pool) {
+  KATANA_LOG_DEBUG_ASSERT(!(pool && pool_instance));
+  pool_instance = pool;
+}
+
+katana::ScratchPool*
+katana::internal::GetScratchPool() {
+  return pool_instance;
+}
+
+size_t
+katana::ScratchPool::DefaultCapacity() {
+  std::string bytes;
+  if (katana::GetEnv("KATANA_SCRATCH_POOL_BYTES", &bytes)) {
+    return std::strtoull(bytes.c_str(), nullptr, 10);
+  }
+  return MemorySupervisor::GetTotalSystemMemory() / kDefaultCapacityDivisor;
+}
+
+katana::ScratchPool::ScratchPool(size_t capacity) : capacity_(capacity) {}
+
+katana::ScratchPool::~ScratchPool() { Release(stats_.retained_bytes); }
+
+void*
+katana::ScratchPool::Take(const Key& key) {
+  void* ptr = nullptr;
+  auto supervisor_lock = LockSupervisor();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = by_key_.find(key);
+    if (it == by_key_.end()) {
+      stats_.misses += 1;
+      return nullptr;
+    }
+    ptr = it->second->ptr;
+    entries_.erase(it->second);
+    by_key_.erase(it);
+    stats_.hits += 1;
+    stats_.retained_bytes -= key.bytes;
+  }
+  // Outside the lock of the pool: the supervisor may ask us to release
+  // memory
+  MemorySupervisor::Get().StandbyToActive(
+      ScratchManager::name_, static_cast<count_t>(key.bytes));
+  return ptr;
+}
+
+bool
+katana::ScratchPool::Put(const Key& key, void* ptr) {
+  // Without a tracer, e.g., with only a GaloisRuntime, there is no memory
+  // supervisor to account for retained memory
+  if (!ProgressTracer::IsSet()) {
+    return false;
+  }
+  auto supervisor_lock = LockSupervisor();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stats_.retained_bytes + key.bytes > capacity_) {
+      return false;
+    }
+    auto entry = entries_.emplace(entries_.end(), Entry{key, ptr});
+    by_key_.emplace(key, entry);
+    stats_.retained_bytes += key.bytes;
+  }
+  MemorySupervisor::Get().ActiveToStandby(
+      ScratchManager::name_, static_cast<count_t>(key.bytes));
+  return true;
+}
+
+size_t
+katana::ScratchPool::Release(size_t goal) {
+  std::vector<Entry> to_free;
+  size_t freed = 0;
+  auto supervisor_lock = LockSupervisor();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (freed < goal && !entries_.empty()) {
+      Entry& entry = entries_.front();
+      auto [begin, end] = by_key_.equal_range(entry.key);
+      for (auto it = begin; it != end; ++it) {
+        if (it->second == entries_.begin()) {
+          by_key_.erase(it);
+          break;
+        }
+      }
+      freed += entry.key.bytes;
+      to_free.emplace_back(entry);
+      entries_.pop_front();
+    }
+    stats_.retained_bytes -= freed;
+  }
+  if (freed == 0) {
+    return 0;
+  }
+  for (const Entry& entry : to_free) {
+    katana::freePages(entry.ptr, entry.key.bytes / katana::allocSize());
+  }
+  MemorySupervisor::Get().PutStandby(
+      ScratchManager::name_, static_cast<count_t>(freed));
+  return freed;
+}
+
+void
+katana::ScratchPool::SetCapacity(size_t capacity) {
+  size_t excess = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    if (stats_.retained_bytes > capacity) {
+      excess = stats_.retained_bytes - capacity;
+    }
+  }
+  Release(excess);
+}
+
+size_t
+katana::ScratchPool::capacity() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return capacity_;
+}
+
+katana::ScratchPool::Stats
+katana::ScratchPool::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+katana::count_t
+katana::ScratchManager::FreeStandbyMemory(count_t goal) {
+  ScratchPool* pool = internal::GetScratchPool();
+  if (!pool || goal <= 0) {
+    return 0;
+  }
+  return static_cast<count_t>(pool->Release(static_cast<size_t>(goal)));
+}
@@ -0,0 +1,246 @@
+#include "katana/SortedIntersection.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define KATANA_INTERSECTION_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/// Search each element of the smaller set in the larger one instead of
+/// merging them when the larger one is this many times larger
+constexpr size_t kGallopRatio = 32;
+
+using IntersectFn = size_t (*)(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out);
+
+/// Merge without branches on the comparisons, which are unpredictable
+template <bool kOutput>
+size_t
+MergeScalar(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t k = 0;
+  while (i < a_size && j < b_size) {
+    uint32_t x = a[i];
+    uint32_t y = b[j];
+    if constexpr (kOutput) {
+      out[k] = x;
+    }
+    k += x == y;
+    i += x <= y;
+    j += y <= x;
+  }
+  return k;
+}
+
+/// small is the smaller set
+template <bool kOutput>
+size_t
+Gallop(
+    const uint32_t* small, size_t small_size, const uint32_t* large,
+    size_t large_size, uint32_t* out) {
+  size_t j = 0;
+  size_t k = 0;
+  for (size_t i = 0; i < small_size && j < large_size; ++i) {
+    uint32_t x = small[i];
+    // Every element before j + bound / 2 is smaller than x
+    size_t bound = 1;
+    while (j + bound < large_size && large[j + bound] < x) {
+      bound *= 2;
+    }
+    const uint32_t* lo = large + j + bound / 2;
+    const uint32_t* hi = large + std::min(j + bound + 1, large_size);
+    j = std::lower_bound(lo, hi, x) - large;
+    if (j < large_size && large[j] == x) {
+      if constexpr (kOutput) {
+        out[k] = x;
+      }
+      ++k;
+      ++j;
+    }
+  }
+  return k;
+}
+
+#ifdef KATANA_INTERSECTION_X86
+
+/// Compare a block of 8 elements of a with all rotations of a block of 8
+/// elements of b and advance the block with the smaller last element,
+/// following "SIMD Compression and the Intersection of Sorted Integers"
+/// (Lemire et al., 2016)
+template <bool kOutput>
+__attribute__((target("avx2,popcnt"))) size_t
+BlockAvx2(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out) {
+  const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+  size_t i = 0;
+  size_t j = 0;
+  size_t k = 0;
+  while (i + 8 <= a_size && j + 8 <= b_size) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+    __m256i eq = _mm256_cmpeq_epi32(va, vb);
+    for (int r = 1; r < 8; ++r) {
+      vb = _mm256_permutevar8x32_epi32(vb, rotate);
+      eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+    }
+    auto mask =
+        static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+    if constexpr (kOutput) {
+      for (; mask; mask &= mask - 1) {
+        out[k++] = a[i + __builtin_ctz(mask)];
+      }
+    } else {
+      k += __builtin_popcount(mask);
+    }
+    uint32_t a_last = a[i + 7];
+    uint32_t b_last = b[j + 7];
+    i += a_last <= b_last ? 8 : 0;
+    j += b_last <= a_last ? 8 : 0;
+  }
+  return k + MergeScalar<kOutput>(
+                 a + i, a_size - i, b + j, b_size - j, out + k);
+}
+
+template <bool kOutput>
+__attribute__((target("avx512f,popcnt"))) size_t
+BlockAvx512(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t k = 0;
+  while (i + 16 <= a_size && j + 16 <= b_size) {
+    __m512i va = _mm512_loadu_si512(a + i);
+    __m512i vb = _mm512_loadu_si512(b + j);
+    __mmask16 mask = _mm512_cmpeq_epi32_mask(va, vb);
+    for (int r = 1; r < 16; ++r) {
+      vb = _mm512_maskz_alignr_epi32(0xffff, vb, vb, 1);
+      mask |= _mm512_cmpeq_epi32_mask(va, vb);
+    }
+    if constexpr (kOutput) {
+      _mm512_mask_compressstoreu_epi32(out + k, mask, va);
+    }
+    k += __builtin_popcount(mask);
+    uint32_t a_last = a[i + 15];
+    uint32_t b_last = b[j + 15];
+    i += a_last <= b_last ? 16 : 0;
+    j += b_last <= a_last ? 16 : 0;
+  }
+  return k + MergeScalar<kOutput>(
+                 a + i, a_size - i, b + j, b_size - j, out + k);
+}
+
+#endif
+
+/// The intersection kernels for sets of similar size for the instruction
+/// sets of this machine
+struct Kernels {
+  IntersectFn count{MergeScalar<false>};
+  IntersectFn output{MergeScalar<true>};
+
+  Kernels() {
+#ifdef KATANA_INTERSECTION_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      count = BlockAvx2<false>;
+      output = BlockAvx2<true>;
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+      count = BlockAvx512<false>;
+      output = BlockAvx512<true>;
+    }
+#endif
+  }
+};
+
+const Kernels&
+GetKernels() {
+  static const Kernels kernels;
+  return kernels;
+}
+
+template <bool kOutput>
+size_t
+Intersect(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out) {
+  if (a_size > b_size) {
+    std::swap(a, b);
+    std::swap(a_size, b_size);
+  }
+  if (a_size == 0) {
+    return 0;
+  }
+  if (a_size * kGallopRatio < b_size) {
+    return Gallop<kOutput>(a, a_size, b, b_size, out);
+  }
+  const Kernels& kernels = GetKernels();
+  return (kOutput ? kernels.output : kernels.count)(a, a_size, b, b_size, out);
+}
+
+}  // namespace
+
+size_t
+katana::SortedIntersectionSize(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size) {
+  return Intersect<false>(a, a_size, b, b_size, nullptr);
+}
+
+uint32_t*
+katana::SortedIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    uint32_t* out) {
+  return out + Intersect<true>(a, a_size, b, b_size, out);
+}
+
+void
+katana::SortedSetBitmap::Assign(const uint32_t* set, size_t size) {
+  Clear();
+  set_.assign(set, set + size);
+  if (size == 0) {
+    return;
+  }
+  uint32_t max = *std::max_element(set, set + size);
+  if (words_.size() <= max / 64) {
+    words_.resize(max / 64 + 1);
+  }
+  for (uint32_t x : set_) {
+    words_[x / 64] |= uint64_t{1} << (x % 64);
+  }
+}
+
+void
+katana::SortedSetBitmap::Clear() {
+  for (uint32_t x : set_) {
+    words_[x / 64] = 0;
+  }
+  set_.clear();
+}
+
+size_t
+katana::SortedSetBitmap::IntersectionSize(
+    const uint32_t* b, size_t b_size) const {
+  size_t k = 0;
+  for (size_t i = 0; i < b_size; ++i) {
+    k += Contains(b[i]);
+  }
+  return k;
+}
+
+uint32_t*
+katana::SortedSetBitmap::Intersection(
+    const uint32_t* b, size_t b_size, uint32_t* out) const {
+  for (size_t i = 0; i < b_size; ++i) {
+    *out = b[i];
+    out += Contains(b[i]);
+  }
+  return out;
+}
@@ -0,0 +1,123 @@
+#include "katana/TaskGraph.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "katana/ThreadGroup.h"
+#include "katana/Threads.h"
+
+katana::TaskRef
+katana::TaskGraph::AddNode(
+    std::function<Result<void>()> fn, const std::vector<TaskRef>& deps,
+    unsigned num_threads) {
+  size_t id = nodes_.size();
+  for (const auto& dep : deps) {
+    KATANA_LOG_VASSERT(dep.id_ < id, "dependency is not a task of this graph");
+    nodes_[dep.id_].successors.emplace_back(id);
+  }
+  Node& node = nodes_.emplace_back();
+  node.fn = std::move(fn);
+  node.num_deps = deps.size();
+  node.num_threads = std::max(num_threads, 1U);
+  return TaskRef(id);
+}
+
+katana::Result<void>
+katana::TaskGraph::Run() {
+  struct Running {
+    size_t id;
+    std::unique_ptr<ThreadGroup> group;
+    std::thread thread;
+  };
+
+  // making thread groups shrinks the threads of the calling thread
+  unsigned active_threads = internal::GetRequestedThreads();
+
+  std::vector<size_t> pending(nodes_.size());
+  std::deque<size_t> ready;
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    pending[i] = nodes_[i].num_deps;
+    if (!pending[i]) {
+      ready.emplace_back(i);
+    }
+  }
+
+  std::vector<Running> running;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<std::pair<size_t, Result<void>>> finished;
+  Result<void> ret = ResultSuccess();
+
+  auto complete = [&](size_t id, Result<void> res) {
+    if (!res) {
+      if (ret) {
+        ret = std::move(res);
+      }
+      return;
+    }
+    for (size_t succ : nodes_[id].successors) {
+      if (--pending[succ] == 0) {
+        ready.emplace_back(succ);
+      }
+    }
+  };
+
+  while (true) {
+    // start every ready task that fits on the free threads
+    auto it = ready.begin();
+    while (ret && it != ready.end()) {
+      size_t id = *it;
+      auto group = ThreadGroup::Make(nodes_[id].num_threads);
+      if (!group && !running.empty()) {
+        ++it;
+        continue;
+      }
+      it = ready.erase(it);
+      if (!group) {
+        // nothing else runs, so the task may use the whole pool
+        setActiveThreads(active_threads);
+        complete(id, nodes_[id].fn());
+        it = ready.begin();
+        continue;
+      }
+      ThreadGroup* g = group.get();
+      std::thread thread([this, id, g, &mutex, &cv, &finished]() {
+        Result<void> res = ResultSuccess();
+        {
+          ThreadGroup::Scope scope(g);
+          res = nodes_[id].fn();
+        }
+        std::lock_guard<std::mutex> lg(mutex);
+        finished.emplace_back(id, std::move(res));
+        cv.notify_one();
+      });
+      running.emplace_back(Running{id, std::move(group), std::move(thread)});
+    }
+
+    if (running.empty()) {
+      break;
+    }
+
+    std::vector<std::pair<size_t, Result<void>>> done;
+    {
+      std::unique_lock<std::mutex> lg(mutex);
+      cv.wait(lg, [&]() { return !finished.empty(); });
+      done.swap(finished);
+    }
+    for (auto& [id, res] : done) {
+      auto r = std::find_if(running.begin(), running.end(), [&](auto& x) {
+        return x.id == id;
+      });
+      KATANA_LOG_DEBUG_ASSERT(r != running.end());
+      r->thread.join();
+      running.erase(r);
+      complete(id, std::move(res));
+    }
+  }
+
+  setActiveThreads(active_threads);
+  return ret;
+}
@@ -19,6 +19,7 @@
 
 #include "katana/Logging.h"
 #include "katana/TerminationDetection.h"
+#include "katana/ThreadGroup.h"
 
 // vtable anchoring
 katana::TerminationDetection::~TerminationDetection() = default;
@@ -35,6 +36,11 @@ katana::internal::SetTerminationDetection(katana::TerminationDetection* t) {
 
 katana::TerminationDetection&
 katana::GetTerminationDetection(unsigned active_threads) {
+  if (auto* group = ThreadGroup::Current()) {
+    auto& term = group->termination_detection();
+    term.Init(active_threads);
+    return term;
+  }
   kTerminationDetection->Init(active_threads);
   return *kTerminationDetection;
 }
@@ -0,0 +1,82 @@
+#include "katana/ThreadGroup.h"
+
+#include <algorithm>
+
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+
+katana::ThreadGroup::ThreadGroup(unsigned begin, unsigned size)
+    : begin_(begin),
+      size_(size),
+      active_threads_(size),
+      barrier_threads_(size),
+      // the topology barrier follows the socket leaders of the whole pool,
+      // which need not be in the group
+      barrier_(CreateMCSBarrier(size)),
+      term_(internal::CreateTerminationDetection()) {}
+
+katana::ThreadGroup::~ThreadGroup() {
+  KATANA_LOG_VASSERT(
+      Current() != this, "Can't destroy a thread group while in its scope");
+  GetThreadPool().releaseGroup(begin_, size_);
+}
+
+std::unique_ptr<katana::ThreadGroup>
+katana::ThreadGroup::Make(unsigned num_threads) {
+  num_threads = std::max(num_threads, 1U);
+  unsigned begin = GetThreadPool().acquireGroup(num_threads);
+  if (begin == 0) {
+    return nullptr;
+  }
+  return std::unique_ptr<ThreadGroup>(new ThreadGroup(begin, num_threads));
+}
+
+void
+katana::ThreadGroup::SetActiveThreads(unsigned num) {
+  KATANA_LOG_DEBUG_ASSERT(Current() == this);
+  active_threads_ = std::clamp(num, 1U, size_);
+  ThreadPool::my_box.activeThreads = active_threads_;
+}
+
+katana::Barrier&
+katana::ThreadGroup::GetBarrier(unsigned active_threads) {
+  active_threads = std::clamp(active_threads, 1U, size_);
+  if (active_threads != barrier_threads_) {
+    barrier_threads_ = active_threads;
+    barrier_->Reinit(barrier_threads_);
+  }
+  return *barrier_;
+}
+
+katana::ThreadGroup::Scope::Scope(ThreadGroup* group) {
+  auto& me = ThreadPool::my_box;
+  prev_group_ = me.group;
+  prev_group_begin_ = me.groupBegin;
+  prev_group_size_ = me.groupSize;
+  prev_tid_base_ = me.tidBase;
+  prev_group_threads_ = me.activeThreads;
+  prev_pts_base_ = ptsBase;
+  prev_pss_base_ = pssBase;
+
+  me.group = group;
+  me.groupBegin = group->begin_;
+  me.groupSize = group->size_;
+  // the calling thread stands in for the first thread of the group between
+  // loops, e.g., when reducing per-thread values, and it need not be a pool
+  // thread with storage of its own
+  me.tidBase = me.topo.tid;
+  ptsBase = static_cast<char*>(getPTSBackend().getRemote(group->begin_, 0));
+  pssBase = static_cast<char*>(getPPSBackend().getRemote(group->begin_, 0));
+  me.activeThreads = group->active_threads_;
+}
+
+katana::ThreadGroup::Scope::~Scope() {
+  auto& me = ThreadPool::my_box;
+  me.group = prev_group_;
+  me.groupBegin = prev_group_begin_;
+  me.groupSize = prev_group_size_;
+  me.tidBase = prev_tid_base_;
+  me.activeThreads = prev_group_threads_;
+  ptsBase = prev_pts_base_;
+  pssBase = prev_pss_base_;
+}
@@ -31,6 +31,7 @@
 namespace katana {
 
 extern void initPTS(unsigned);
+extern unsigned activeThreads;
 
 }
 
@@ -42,7 +43,15 @@ ThreadPool::ThreadPool()
     : mi(getHWTopo().machineTopoInfo),
       reserved(0),
       masterFastmode(0),
-      running(false) {
+      running(false),
+      grouped(mi.maxThreads, false),
+      groupedBegin(mi.maxThreads) {
+  int spin_us = 0;
+  if (GetEnv("KATANA_THREAD_SPIN_US", &spin_us) && spin_us >= 0) {
+    setIdleSpin(std::chrono::microseconds(spin_us));
+  } else {
+    setIdleSpin(kDefaultSpin);
+  }
   signals.resize(mi.maxThreads);
   initThread(0);
 
@@ -69,7 +78,10 @@ ThreadPool::~ThreadPool() {
 void
 ThreadPool::destroyCommon() {
   beKind();  // reset fastmode
-  run(mi.maxThreads, []() { throw shutdown_ty(); });
+  // the master thread returns without waiting for the others, so their work
+  // must outlive this call
+  work = []() { throw shutdown_ty(); };
+  runInternal(mi.maxThreads, &work);
 }
 
 void
@@ -158,10 +170,10 @@ ThreadPool::threadLoop(unsigned tid) {
   bool fastmode = false;
   auto& me = my_box;
   do {
-    me.wait(fastmode);
+    me.wait(fastmode, spinNs.load(std::memory_order_relaxed));
     cascade(fastmode);
     try {
-      work();
+      (*me.work)();
     } catch (const shutdown_ty&) {
       return;
     } catch (const fastmode_ty& fm) {
@@ -214,12 +226,14 @@ ThreadPool::cascade(bool fastmode) {
   auto midpoint = me.wbegin + (1 + me.wend - me.wbegin) / 2;
 
   auto* child1 = signals[me.wbegin];
+  child1->inherit(me);
   child1->wbegin = me.wbegin + 1;
   child1->wend = midpoint;
   child1->wakeup(fastmode);
 
   if (midpoint < me.wend) {
     auto* child2 = signals[midpoint];
+    child2->inherit(me);
     child2->wbegin = midpoint + 1;
     child2->wend = me.wend;
     child2->wakeup(fastmode);
@@ -227,36 +241,119 @@ ThreadPool::cascade(bool fastmode) {
 }
 
 void
-ThreadPool::runInternal(unsigned num) {
+ThreadPool::runInternal(unsigned num, std::function<void(void)>* work) {
+  auto& me = my_box;
+  me.work = work;
+  if (me.group) {
+    runInGroup(num);
+    return;
+  }
+
   // sanitize num
   // seq write to starting should make work safe
   KATANA_LOG_VASSERT(!running, "Recursive thread pool execution not supported");
   running = true;
   num = std::min(std::max(1U, num), getMaxUsableThreads());
   // my_box is tid 0
-  auto& me = my_box;
   me.wbegin = 1;
   me.wend = num;
 
   KATANA_LOG_VASSERT(
       !masterFastmode || masterFastmode == num,
       "fastmode threads {} != num threads {}", masterFastmode, num);
+  auto start = std::chrono::steady_clock::now();
   // launch threads
   cascade(masterFastmode);
   // Do master thread work
   try {
-    work();
+    (*work)();
   } catch (const shutdown_ty&) {
     return;
   } catch (const fastmode_ty& fm) {
   }
   // wait for children
   decascade();
+  uint64_t elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  runs.fetch_add(1, std::memory_order_relaxed);
+  runNs.fetch_add(elapsedNs, std::memory_order_relaxed);
+  threadNs.fetch_add(elapsedNs * num, std::memory_order_relaxed);
   // Clean up
-  work = nullptr;
+  me.work = nullptr;
   running = false;
 }
 
+void
+ThreadPool::runInGroup(unsigned num) {
+  auto& me = my_box;
+  num = std::min(std::max(1U, num), me.groupSize);
+
+  // the first thread of the group runs the region like the master thread
+  // does for the pool; the calling thread may not be a pool thread at all
+  auto* leader = signals[me.groupBegin];
+  KATANA_LOG_VASSERT(
+      leader->done, "Recursive thread group execution not supported");
+  leader->inherit(me);
+  leader->wbegin = me.groupBegin + 1;
+  leader->wend = me.groupBegin + num;
+  leader->wakeup(false);
+  while (!leader->done) {
+    std::this_thread::yield();
+  }
+  me.work = nullptr;
+}
+
+ThreadPool::IdleStats
+ThreadPool::getIdleStats() const {
+  IdleStats stats;
+  for (const auto* s : signals) {
+    stats.spinWakeups += s->spinWakeups.load(std::memory_order_relaxed);
+    stats.parkWakeups += s->parkWakeups.load(std::memory_order_relaxed);
+    stats.parkLatencyNs += s->parkLatencyNs.load(std::memory_order_relaxed);
+    stats.maxParkLatencyNs = std::max<uint64_t>(
+        stats.maxParkLatencyNs,
+        s->maxParkLatencyNs.load(std::memory_order_relaxed));
+  }
+  return stats;
+}
+
+unsigned
+ThreadPool::acquireGroup(unsigned num) {
+  KATANA_LOG_VASSERT(
+      !running && !my_box.group,
+      "Can't make a thread group during parallel section");
+  // group threads must wait for work in the kind, blocking mode
+  beKind();
+
+  std::lock_guard<std::mutex> lg(groupLock);
+  // take the highest free threads below the dedicated ones; thread 0 is the
+  // master thread and never in a group
+  unsigned end = mi.maxThreads - reserved;
+  while (end > num) {
+    unsigned begin = end - num;
+    auto taken =
+        std::find(grouped.begin() + begin, grouped.begin() + end, true);
+    if (taken == grouped.begin() + end) {
+      std::fill(grouped.begin() + begin, grouped.begin() + end, true);
+      groupedBegin = std::min(groupedBegin, begin);
+      katana::activeThreads =
+          std::min(katana::activeThreads, getMaxUsableThreads());
+      return begin;
+    }
+    end = taken - grouped.begin();
+  }
+  return 0;
+}
+
+void
+ThreadPool::releaseGroup(unsigned begin, unsigned num) {
+  std::lock_guard<std::mutex> lg(groupLock);
+  std::fill(grouped.begin() + begin, grouped.begin() + begin + num, false);
+  groupedBegin =
+      std::find(grouped.begin(), grouped.end(), true) - grouped.begin();
+}
+
 void
 ThreadPool::runDedicated(std::function<void(void)>& f) {
   // TODO(ddn): update katana::activeThreads to reflect the dedicated
@@ -267,8 +364,11 @@ ThreadPool::runDedicated(std::function<void(void)>& f) {
   ++reserved;
 
   KATANA_LOG_VASSERT(reserved < mi.maxThreads, "Too many dedicated threads");
+  KATANA_LOG_VASSERT(
+      !grouped[mi.maxThreads - reserved], "Dedicated thread is in a group");
   work = [&f]() { throw dedicated_ty{f}; };
   auto* child = signals[mi.maxThreads - reserved];
+  child->work = &work;
   child->wbegin = 0;
   child->wend = 0;
   child->done = 0;
@@ -20,25 +20,214 @@
 #include "katana/Threads.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
 
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/ThreadGroup.h"
 #include "katana/ThreadPool.h"
 namespace katana {
+// loops in a thread group run on the count set for the group instead, see
+// ThreadPool::getActiveThreads
 KATANA_EXPORT unsigned int activeThreads = 1;
 }  // namespace katana
 
+namespace {
+
+// the threads asked for with setActiveThreads outside of thread groups,
+// which elastic threads may run fewer of
+unsigned int requested_threads = 1;
+
+bool
+ElasticThreadsFromEnv() {
+  bool enabled = false;
+  katana::GetEnv("KATANA_ELASTIC_THREADS", &enabled);
+  return enabled;
+}
+
+std::atomic<bool> elastic_threads{ElasticThreadsFromEnv()};
+
+bool
+ReadLine(const std::string& path, std::string* line) {
+  std::ifstream in(path);
+  return static_cast<bool>(std::getline(in, *line));
+}
+
+/// Calls fn with each directory from the cgroup of the process under root
+/// up to root, as limits of parent cgroups apply too
+template <typename F>
+void
+ForEachCgroupDir(const std::string& root, const std::string& path, F fn) {
+  std::string dir = path;
+  while (true) {
+    fn(root + dir);
+    if (dir.empty() || dir == "/") {
+      return;
+    }
+    dir.erase(dir.find_last_of('/'));
+  }
+}
+
+/// The paths of the cgroups of the process for cgroup v2 and for the cpu
+/// controller of cgroup v1, from /proc/self/cgroup
+void
+CgroupPaths(std::string* v2, std::string* v1_cpu) {
+  std::ifstream in("/proc/self/cgroup");
+  std::string line;
+  while (std::getline(in, line)) {
+    // hierarchy-id:controllers:path
+    auto first = line.find(':');
+    auto second = line.find(':', first + 1);
+    if (first == std::string::npos || second == std::string::npos) {
+      continue;
+    }
+    std::string controllers = line.substr(first + 1, second - first - 1);
+    std::string path = line.substr(second + 1);
+    if (controllers.empty()) {
+      *v2 = path;
+      continue;
+    }
+    std::istringstream names(controllers);
+    std::string name;
+    while (std::getline(names, name, ',')) {
+      if (name == "cpu") {
+        *v1_cpu = path;
+      }
+    }
+  }
+}
+
 unsigned int
-katana::setActiveThreads(unsigned int num) noexcept {
+QuotaCPUs(int64_t quota, int64_t period) {
+  if (quota <= 0 || period <= 0) {
+    return 0;
+  }
+  return (quota + period - 1) / period;
+}
+
+unsigned int
+ElasticThreads(unsigned int requested) {
+  unsigned int quota = katana::GetCPUQuota();
+  if (quota == 0) {
+    return requested;
+  }
+  return std::min(requested, quota);
+}
+
+void
+SetThreads(unsigned int num) {
   // Reset "burn power"/"busy wait" mode since it might be configured for a
   // different number of threads than we have after this call. That can cause
   // crashes.
   katana::GetThreadPool().beKind();
+  katana::activeThreads = num;
+}
+
+}  // namespace
+
+unsigned int
+katana::setActiveThreads(unsigned int num) noexcept {
   num = std::min(num, katana::GetThreadPool().getMaxUsableThreads());
   num = std::max(num, 1U);
-  katana::activeThreads = num;
+  if (katana::ThreadGroup* group = katana::ThreadGroup::Current()) {
+    // thread groups never busy wait, and elastic threads leave them alone
+    group->SetActiveThreads(num);
+    return num;
+  }
+  requested_threads = num;
+  if (elastic_threads) {
+    num = ElasticThreads(num);
+  }
+  SetThreads(num);
   return num;
 }
 
 unsigned int
 katana::getActiveThreads() noexcept {
-  return katana::activeThreads;
+  return katana::ThreadPool::getActiveThreads();
+}
+
+unsigned int
+katana::internal::GetRequestedThreads() noexcept {
+  return requested_threads;
+}
+
+void
+katana::SetElasticThreads(bool enabled) noexcept {
+  elastic_threads = enabled;
+}
+
+bool
+katana::IsElasticThreads() noexcept {
+  return elastic_threads;
+}
+
+unsigned int
+katana::UpdateElasticThreads() noexcept {
+  if (!elastic_threads || katana::ThreadPool::getGroup()) {
+    return katana::ThreadPool::getActiveThreads();
+  }
+  unsigned int num = ElasticThreads(requested_threads);
+  if (num != katana::activeThreads) {
+    KATANA_LOG_VERBOSE(
+        "elastic threads: {} -> {} of {} requested", katana::activeThreads,
+        num, requested_threads);
+    SetThreads(num);
+  }
+  return num;
+}
+
+unsigned int
+katana::GetCPUQuota() noexcept {
+  unsigned int quota = 0;
+  auto limit = [&](unsigned int cpus) {
+    if (cpus != 0 && (quota == 0 || cpus < quota)) {
+      quota = cpus;
+    }
+  };
+
+  std::string v2;
+  std::string v1_cpu;
+  CgroupPaths(&v2, &v1_cpu);
+  std::string line;
+  std::string period;
+  if (!v2.empty()) {
+    ForEachCgroupDir("/sys/fs/cgroup", v2, [&](const std::string& dir) {
+      if (ReadLine(dir + "/cpu.max", &line)) {
+        limit(internal::ParseCgroupCPUMax(line));
+      }
+    });
+  }
+  if (!v1_cpu.empty()) {
+    ForEachCgroupDir("/sys/fs/cgroup/cpu", v1_cpu, [&](const std::string& dir) {
+      if (ReadLine(dir + "/cpu.cfs_quota_us", &line) &&
+          ReadLine(dir + "/cpu.cfs_period_us", &period)) {
+        limit(internal::ParseCgroupCFSQuota(line, period));
+      }
+    });
+  }
+  return quota;
+}
+
+unsigned int
+katana::internal::ParseCgroupCPUMax(const std::string& cpu_max) {
+  std::istringstream in(cpu_max);
+  std::string quota;
+  int64_t period = 0;
+  if (!(in >> quota >> period) || quota == "max") {
+    return 0;
+  }
+  return QuotaCPUs(std::strtoll(quota.c_str(), nullptr, 10), period);
+}
+
+unsigned int
+katana::internal::ParseCgroupCFSQuota(
+    const std::string& quota_us, const std::string& period_us) {
+  return QuotaCPUs(
+      std::strtoll(quota_us.c_str(), nullptr, 10),
+      std::strtoll(period_us.c_str(), nullptr, 10));
 }
@@ -0,0 +1,91 @@
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+
+#include "katana/AsyncLoop.h"
+#include "katana/Galois.h"
+#include "katana/Result.h"
+
+namespace {
+
+constexpr uint32_t kNumItems = 1024;
+
+/// Item 0 waits for a future that only the other items complete, which
+/// deadlocks unless threads keep processing items while it waits
+void
+TestOverlap() {
+  std::promise<katana::CopyableResult<uint32_t>> promise;
+  std::atomic<uint32_t> processed{0};
+  std::atomic<uint64_t> resumed{0};
+  std::atomic<bool> pushed_ran{false};
+
+  katana::ForEachAsync(
+      katana::iterate(uint32_t{0}, kNumItems),
+      [&](uint32_t i, katana::AsyncContext<uint32_t>& ctx) {
+        if (i == kNumItems) {
+          // pushed by the continuation below
+          pushed_ran = true;
+          return;
+        }
+        if (i == 0) {
+          ctx.Await(
+              promise.get_future(),
+              [&](katana::CopyableResult<uint32_t> res,
+                  katana::AsyncContext<uint32_t>& ctx) {
+                KATANA_LOG_ASSERT(res);
+                resumed = res.value();
+                ctx.push(kNumItems);
+              });
+          return;
+        }
+        if (++processed == kNumItems - 1) {
+          promise.set_value(processed.load());
+        }
+      },
+      katana::no_stats());
+
+  KATANA_LOG_ASSERT(processed == kNumItems - 1);
+  KATANA_LOG_ASSERT(resumed == kNumItems - 1);
+  KATANA_LOG_ASSERT(pushed_ran);
+}
+
+/// Continuations may await further operations
+void
+TestChain() {
+  constexpr uint32_t kChainLength = 4;
+  std::atomic<uint64_t> sum{0};
+
+  using Context = katana::AsyncContext<uint32_t>;
+  std::function<void(uint32_t, uint32_t, Context&)> step =
+      [&](uint32_t i, uint32_t left, Context& ctx) {
+        ctx.Await(
+            std::async(std::launch::async, [i]() { return uint64_t{i}; }),
+            [&, i, left](uint64_t v, Context& ctx) {
+              sum += v;
+              if (left > 1) {
+                step(i, left - 1, ctx);
+              }
+            });
+      };
+
+  katana::ForEachAsync(
+      katana::iterate(uint32_t{0}, uint32_t{64}),
+      [&](uint32_t i, Context& ctx) { step(i, kChainLength, ctx); },
+      katana::no_stats());
+
+  KATANA_LOG_ASSERT(sum == uint64_t{kChainLength} * 63 * 64 / 2);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestOverlap();
+  TestChain();
+
+  return 0;
+}
@@ -24,6 +24,7 @@
 
 #include "katana/Barrier.h"
 #include "katana/Galois.h"
+#include "katana/Logging.h"
 #include "katana/Timer.h"
 
 unsigned iter = 0;
@@ -69,8 +70,10 @@ test(std::unique_ptr<katana::Barrier> b) {
     emp e{*b.get()};
     katana::on_each(e);
     t.stop();
+    // latency of one barrier episode
+    double ns_per_wait = 1e6 * t.get() / iter;
     std::cout << bname << "," << b->name() << "," << M << "," << t.get()
-              << "\n";
+              << "," << ns_per_wait << "\n";
     M -= 1;
   }
 }
@@ -89,6 +92,14 @@ main(int argc, char** argv) {
 
   gethostname(bname, sizeof(bname));
   using namespace katana;
+
+  using internal::BarrierKind;
+  KATANA_LOG_ASSERT(internal::ChooseBarrier(2, 1) == BarrierKind::kCounting);
+  KATANA_LOG_ASSERT(internal::ChooseBarrier(64, 1) == BarrierKind::kMCS);
+  KATANA_LOG_ASSERT(internal::ChooseBarrier(4, 2) == BarrierKind::kTopo);
+
+  std::cout << "host,barrier,threads,ms,ns_per_wait\n";
+  test(CreateAutoBarrier(1));
   test(CreateCountingBarrier(1));
   test(CreateMCSBarrier(1));
   test(CreateTopoBarrier(1));
@@ -0,0 +1,46 @@
+#include "katana/BloomFilter.h"
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+void
+TestFilter(uint64_t num_keys, uint32_t bits_per_key, double max_rate) {
+  katana::BloomFilter filter(num_keys, bits_per_key);
+  KATANA_LOG_ASSERT(!filter.empty());
+  // even keys are inserted, twice, and odd keys are not
+  katana::do_all(
+      katana::iterate(uint64_t{0}, 2 * num_keys), [&](uint64_t i) {
+        filter.Insert(katana::BloomFilter::Hash((i % num_keys) * 2));
+      });
+
+  uint64_t false_positives = 0;
+  for (uint64_t i = 0; i < num_keys; ++i) {
+    KATANA_LOG_ASSERT(filter.MayContain(katana::BloomFilter::Hash(i * 2)));
+    false_positives += filter.MayContain(katana::BloomFilter::Hash(i * 2 + 1));
+  }
+  double rate = static_cast<double>(false_positives) / num_keys;
+  KATANA_LOG_VASSERT(
+      rate <= max_rate, "{} keys at {} bits: false positive rate {}",
+      num_keys, bits_per_key, rate);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  katana::BloomFilter empty;
+  KATANA_LOG_ASSERT(empty.empty());
+  KATANA_LOG_ASSERT(empty.MayContain(0));
+
+  TestFilter(1, 10, 0.01);
+  TestFilter(100000, 10, 0.02);
+  TestFilter(100000, 16, 0.005);
+  TestFilter(100000, 4, 0.2);
+
+  return 0;
+}
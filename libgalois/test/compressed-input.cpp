@@ -0,0 +1,203 @@
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <arrow/util/compression.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/CompressedInput.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/URI.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+using Bytes = std::vector<uint8_t>;
+
+void
+Append32(Bytes* out, uint32_t v) {
+  for (int i = 0; i < 4; ++i) {
+    out->emplace_back(v >> (8 * i));
+  }
+}
+
+Bytes
+Compress(arrow::Compression::type type, const std::string& text) {
+  auto codec = arrow::util::Codec::Create(type).ValueOrDie();
+  const auto* data = reinterpret_cast<const uint8_t*>(text.data());
+  Bytes out(codec->MaxCompressedLen(text.size(), data));
+  auto size =
+      codec->Compress(text.size(), data, out.size(), out.data()).ValueOrDie();
+  out.resize(size);
+  return out;
+}
+
+/// Cut text into pieces of at most piece_size bytes and compress each
+/// with fn
+template <typename Fn>
+Bytes
+CompressPieces(const std::string& text, size_t piece_size, const Fn& fn) {
+  Bytes out;
+  for (size_t i = 0; i < text.size(); i += piece_size) {
+    Bytes piece = fn(text.substr(i, piece_size));
+    out.insert(out.end(), piece.begin(), piece.end());
+  }
+  return out;
+}
+
+/// A BGZF block from a gzip member, with the BC subfield added to its
+/// 10-byte header
+Bytes
+BgzfBlock(const std::string& text) {
+  Bytes member = Compress(arrow::Compression::GZIP, text);
+  Bytes block(member.begin(), member.begin() + 10);
+  block[3] |= 4;
+  uint16_t size = member.size() + 8 - 1;
+  Bytes extra{6, 0, 'B', 'C', 2, 0, uint8_t(size), uint8_t(size >> 8)};
+  block.insert(block.end(), extra.begin(), extra.end());
+  block.insert(block.end(), member.begin() + 10, member.end());
+  return block;
+}
+
+Bytes
+ZstdSeekable(const std::string& text, size_t frame_size) {
+  Bytes out;
+  Bytes table;
+  uint32_t num_frames = 0;
+  for (size_t i = 0; i < text.size(); i += frame_size, ++num_frames) {
+    std::string piece = text.substr(i, frame_size);
+    Bytes frame = Compress(arrow::Compression::ZSTD, piece);
+    out.insert(out.end(), frame.begin(), frame.end());
+    Append32(&table, frame.size());
+    Append32(&table, piece.size());
+  }
+  Append32(&out, 0x184D2A5E);
+  Append32(&out, table.size() + 9);
+  out.insert(out.end(), table.begin(), table.end());
+  Append32(&out, num_frames);
+  out.emplace_back(0);
+  Append32(&out, 0x8F92EAB1);
+  return out;
+}
+
+std::string
+WriteFile(const katana::URI& dir, const std::string& name, const Bytes& bytes) {
+  std::string path = dir.Join(name).path();
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  KATANA_LOG_ASSERT(out);
+  return path;
+}
+
+std::string
+ReadAll(std::istream& in) {
+  std::string text;
+  std::string line;
+  while (std::getline(in, line)) {
+    text += line;
+    text += '\n';
+  }
+  return text;
+}
+
+void
+TestFile(
+    const std::string& path, const std::string& text,
+    katana::InputCompression compression, bool seekable) {
+  // a small batch, so that reading takes many batches
+  katana::DecompressingIfstream in(path, 100000);
+  KATANA_LOG_VASSERT(in, "{}", path);
+  KATANA_LOG_ASSERT(in.compression() == compression);
+
+  KATANA_LOG_ASSERT(ReadAll(in) == text);
+  KATANA_LOG_ASSERT(!in.error());
+
+  // read again, as converters do
+  in.clear();
+  in.seekg(0, std::ios::beg);
+  KATANA_LOG_ASSERT(ReadAll(in) == text);
+
+  in.clear();
+  size_t pos = text.size() / 3 + 7;
+  in.seekg(pos, std::ios::beg);
+  if (!seekable) {
+    KATANA_LOG_ASSERT(!in);
+    return;
+  }
+  KATANA_LOG_ASSERT(in);
+  KATANA_LOG_ASSERT(static_cast<size_t>(in.tellg()) == pos);
+  std::string rest(std::istreambuf_iterator<char>(in), {});
+  KATANA_LOG_ASSERT(rest == text.substr(pos));
+}
+
+void
+TestFormats(const katana::URI& dir) {
+  std::string text;
+  for (int i = 0; i < 100000; ++i) {
+    text += std::to_string(i) + " " + std::to_string(i * 7 % 1000) + "\n";
+  }
+  auto gzip = [](const std::string& piece) {
+    return Compress(arrow::Compression::GZIP, piece);
+  };
+
+  Bytes plain(text.begin(), text.end());
+  TestFile(
+      WriteFile(dir, "plain.txt", plain), text,
+      katana::InputCompression::kNone, true);
+
+  if (arrow::util::Codec::IsAvailable(arrow::Compression::GZIP)) {
+    // a multi-member gzip file, as pigz and cat write
+    TestFile(
+        WriteFile(dir, "text.gz", CompressPieces(text, 500000, gzip)), text,
+        katana::InputCompression::kGzip, false);
+
+    // with the empty block that ends BGZF files
+    Bytes bgzf = CompressPieces(text, 60000, BgzfBlock);
+    Bytes eof = BgzfBlock("");
+    bgzf.insert(bgzf.end(), eof.begin(), eof.end());
+    TestFile(
+        WriteFile(dir, "text.bgz", bgzf), text, katana::InputCompression::kBgzf,
+        true);
+
+    // a corrupt block ends the stream with an error
+    bgzf[100] ^= 0xff;
+    katana::DecompressingIfstream corrupt(WriteFile(dir, "corrupt.bgz", bgzf));
+    KATANA_LOG_ASSERT(corrupt);
+    KATANA_LOG_ASSERT(ReadAll(corrupt).size() < text.size());
+    KATANA_LOG_ASSERT(corrupt.error());
+  }
+
+  if (arrow::util::Codec::IsAvailable(arrow::Compression::ZSTD)) {
+    TestFile(
+        WriteFile(dir, "text.zst", Compress(arrow::Compression::ZSTD, text)),
+        text, katana::InputCompression::kZstd, false);
+    TestFile(
+        WriteFile(dir, "seekable.zst", ZstdSeekable(text, 70000)), text,
+        katana::InputCompression::kZstdSeekable, true);
+  }
+
+  katana::DecompressingIfstream missing(dir.Join("missing").path());
+  KATANA_LOG_ASSERT(!missing);
+  KATANA_LOG_ASSERT(missing.error());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  auto uri_res = katana::URI::MakeRand("/tmp/compressed-input");
+  KATANA_LOG_ASSERT(uri_res);
+  katana::URI dir = uri_res.value();
+  fs::create_directories(dir.path());
+
+  TestFormats(dir);
+
+  fs::remove_all(dir.path());
+  return 0;
+}
@@ -1,3 +1,5 @@
+#include <random>
+
 #include "katana/DynamicBitset.h"
 #include "katana/Result.h"
 
@@ -74,9 +76,27 @@ const TestCaseGenerator TestBitsetFive = []() {
   return test;
 };
 
+// random and large enough to be processed in parallel blocks, with a size
+// that is not a multiple of any vector width
+const TestCaseGenerator TestBitsetSix = []() {
+  katana::DynamicBitset test;
+  test.resize((1 << 20) + 77);
+  test.reset();
+
+  std::mt19937 gen(0);
+  std::bernoulli_distribution coin(0.3);
+  for (size_t i = 0; i < test.size(); ++i) {
+    if (coin(gen)) {
+      test.set(i);
+    }
+  }
+
+  return test;
+};
+
 const std::vector<TestCaseGenerator> test_case_generators = {
-    TestBitsetEmpty, TestBitsetOne,  TestBitsetTwo,
-    TestBitsetThree, TestBitsetFour, TestBitsetFive};
+    TestBitsetEmpty, TestBitsetOne,  TestBitsetTwo, TestBitsetThree,
+    TestBitsetFour,  TestBitsetFive, TestBitsetSix};
 
 const Invariant NotAndCount =
     [](katana::DynamicBitset* test) -> katana::Result<void> {
@@ -133,7 +153,107 @@ const Invariant NotValues =
   return katana::ResultSuccess();
 };
 
-const std::vector<Invariant> invariants = {NotAndCount, NotValues};
+size_t
+CountBits(const katana::DynamicBitset& bitset) {
+  size_t count = 0;
+  for (size_t i = 0, size = bitset.size(); i < size; ++i) {
+    count += bitset.test(i);
+  }
+  return count;
+}
+
+const Invariant Counts =
+    [](katana::DynamicBitset* test) -> katana::Result<void> {
+  size_t expected = CountBits(*test);
+  if (test->count() != expected || test->SerialCount() != expected) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "wrong count - expected: {}, count: {}, serial count: {}", expected,
+        test->count(), test->SerialCount());
+  }
+
+  return katana::ResultSuccess();
+};
+
+// combine the bitset with a shifted copy of itself and compare each bit
+const Invariant BinaryValues =
+    [](katana::DynamicBitset* test) -> katana::Result<void> {
+  size_t size = test->size();
+  katana::DynamicBitset other;
+  other.resize(size);
+  other.reset();
+  for (size_t i = 0; i + 1 < size; ++i) {
+    if (test->test(i + 1)) {
+      other.set(i);
+    }
+  }
+
+  katana::DynamicBitset ored, anded, xored;
+  for (auto* b : {&ored, &anded, &xored}) {
+    b->resize(size);
+    b->reset();
+    b->bitwise_or(*test);
+  }
+  ored.bitwise_or(other);
+  anded.bitwise_and(other);
+  xored.bitwise_xor(other);
+
+  katana::DynamicBitset anded2, xored2;
+  anded2.resize(size);
+  xored2.resize(size);
+  anded2.bitwise_and(*test, other);
+  xored2.bitwise_xor(*test, other);
+
+  for (size_t i = 0; i < size; ++i) {
+    bool a = test->test(i);
+    bool b = other.test(i);
+    if (ored.test(i) != (a || b) || anded.test(i) != (a && b) ||
+        xored.test(i) != (a != b) || anded2.test(i) != (a && b) ||
+        xored2.test(i) != (a != b)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "bitwise operation computed the wrong value for bit {}", i);
+    }
+  }
+
+  return katana::ResultSuccess();
+};
+
+template <typename Integer>
+katana::Result<void>
+CheckOffsets(const katana::DynamicBitset& test) {
+  std::vector<Integer> expected{42};
+  for (size_t i = 0, size = test.size(); i < size; ++i) {
+    if (test.test(i)) {
+      expected.emplace_back(i);
+    }
+  }
+
+  std::vector<Integer> appended{42};
+  test.AppendOffsets(&appended);
+  std::vector<Integer> offsets = test.GetOffsets<Integer>();
+  if (appended != expected ||
+      !std::equal(
+          offsets.begin(), offsets.end(), expected.begin() + 1,
+          expected.end())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "wrong offsets - expected {} offsets, got {} and {} appended",
+        expected.size() - 1, offsets.size(), appended.size() - 1);
+  }
+
+  return katana::ResultSuccess();
+}
+
+const Invariant Offsets =
+    [](katana::DynamicBitset* test) -> katana::Result<void> {
+  KATANA_CHECKED(CheckOffsets<uint32_t>(*test));
+  KATANA_CHECKED(CheckOffsets<uint64_t>(*test));
+  return katana::ResultSuccess();
+};
+
+const std::vector<Invariant> invariants = {
+    NotAndCount, NotValues, Counts, BinaryValues, Offsets};
 
 katana::Result<void>
 TestAll() {
@@ -152,6 +272,7 @@ TestAll() {
 int
 main() {
   katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
 
   auto res = TestAll();
   KATANA_LOG_VASSERT(res, "{}", res.error());
@@ -0,0 +1,63 @@
+#include <atomic>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Threads.h"
+
+namespace {
+
+void
+TestParse() {
+  using katana::internal::ParseCgroupCFSQuota;
+  using katana::internal::ParseCgroupCPUMax;
+
+  KATANA_LOG_ASSERT(ParseCgroupCPUMax("max 100000") == 0);
+  KATANA_LOG_ASSERT(ParseCgroupCPUMax("100000 100000") == 1);
+  KATANA_LOG_ASSERT(ParseCgroupCPUMax("150000 100000") == 2);
+  KATANA_LOG_ASSERT(ParseCgroupCPUMax("400000 100000\n") == 4);
+  KATANA_LOG_ASSERT(ParseCgroupCPUMax("") == 0);
+
+  KATANA_LOG_ASSERT(ParseCgroupCFSQuota("-1", "100000") == 0);
+  KATANA_LOG_ASSERT(ParseCgroupCFSQuota("50000", "100000") == 1);
+  KATANA_LOG_ASSERT(ParseCgroupCFSQuota("250000", "100000") == 3);
+  KATANA_LOG_ASSERT(ParseCgroupCFSQuota("250000", "0") == 0);
+}
+
+unsigned
+ThreadsInLoop() {
+  std::atomic<unsigned> threads{0};
+  katana::on_each([&](unsigned, unsigned) { ++threads; });
+  return threads;
+}
+
+void
+TestElastic() {
+  unsigned max_threads = katana::GetThreadPool().getMaxUsableThreads();
+  unsigned quota = katana::GetCPUQuota();
+  unsigned expected =
+      quota == 0 ? max_threads : std::min(max_threads, quota);
+
+  katana::SetElasticThreads(true);
+  KATANA_LOG_ASSERT(katana::IsElasticThreads());
+  KATANA_LOG_ASSERT(katana::setActiveThreads(max_threads) == expected);
+  KATANA_LOG_ASSERT(katana::internal::GetRequestedThreads() == max_threads);
+  KATANA_LOG_ASSERT(katana::UpdateElasticThreads() == expected);
+  KATANA_LOG_ASSERT(ThreadsInLoop() == expected);
+
+  katana::SetElasticThreads(false);
+  KATANA_LOG_ASSERT(katana::setActiveThreads(max_threads) == max_threads);
+  KATANA_LOG_ASSERT(katana::UpdateElasticThreads() == max_threads);
+  KATANA_LOG_ASSERT(ThreadsInLoop() == max_threads);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+
+  TestParse();
+  TestElastic();
+
+  return 0;
+}
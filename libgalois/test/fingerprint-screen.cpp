@@ -0,0 +1,103 @@
+#include "katana/FingerprintScreen.h"
+
+#include <random>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// num_rows random fingerprints of num_words words, stride words apart,
+/// with about one bit in density set
+std::vector<uint64_t>
+RandomRows(
+    size_t num_rows, size_t num_words, size_t stride, uint32_t density,
+    std::mt19937_64* gen) {
+  std::vector<uint64_t> words(num_rows * stride, 0);
+  for (size_t i = 0; i < num_rows; ++i) {
+    for (size_t w = 0; w < num_words; ++w) {
+      uint64_t word = 0;
+      for (uint32_t bit = 0; bit < 64; ++bit) {
+        if ((*gen)() % density == 0) {
+          word |= uint64_t{1} << bit;
+        }
+      }
+      words[i * stride + w] = word;
+    }
+  }
+  return words;
+}
+
+void
+TestScreens(size_t num_rows, size_t num_words, size_t stride) {
+  std::mt19937_64 gen(num_rows * 131 + num_words);
+  std::vector<uint64_t> words =
+      RandomRows(num_rows, num_words, stride, 2, &gen);
+  katana::FingerprintRows rows{
+      .words = words.data(),
+      .num_rows = num_rows,
+      .num_words = num_words,
+      .stride = stride,
+  };
+
+  // A sparse query, and a query that is a row itself so that it matches
+  std::vector<uint64_t> query = RandomRows(1, num_words, num_words, 32, &gen);
+  std::vector<std::vector<uint64_t>> queries{query};
+  if (num_rows > 0) {
+    queries.emplace_back(words.begin(), words.begin() + num_words);
+  }
+
+  for (const auto& q : queries) {
+    std::vector<uint64_t> expected;
+    std::vector<double> expected_similarities;
+    for (size_t i = 0; i < num_rows; ++i) {
+      bool contains = true;
+      uint64_t both = 0;
+      uint64_t either = 0;
+      for (size_t w = 0; w < num_words; ++w) {
+        uint64_t row_word = words[i * stride + w];
+        contains &= (q[w] & ~row_word) == 0;
+        both += __builtin_popcountll(q[w] & row_word);
+        either += __builtin_popcountll(q[w] | row_word);
+      }
+      if (contains) {
+        expected.emplace_back(i);
+      }
+      expected_similarities.emplace_back(
+          either == 0 ? 0.0 : static_cast<double>(both) / either);
+    }
+
+    std::vector<uint64_t> screened =
+        katana::ScreenSubstructures(rows, q.data());
+    KATANA_LOG_VASSERT(
+        screened == expected, "{} rows of {} words: {} != {} matches",
+        num_rows, num_words, screened.size(), expected.size());
+    KATANA_LOG_ASSERT(
+        katana::TanimotoSimilarities(rows, q.data()) == expected_similarities);
+  }
+  if (num_rows > 0) {
+    KATANA_LOG_ASSERT(
+        katana::TanimotoSimilarities(rows, queries.back().data())[0] == 1.0 ||
+        num_words == 0);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  // Word counts around the vector widths, and row counts around the block
+  // size of the parallel screens
+  for (size_t num_words : {0, 1, 3, 4, 5, 8, 9, 16, 32, 33}) {
+    for (size_t num_rows : {0, 1, 100, 1024, 3000}) {
+      TestScreens(num_rows, num_words, num_words);
+      TestScreens(num_rows, num_words, num_words + 1);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,51 @@
+#include "katana/HyperLogLog.h"
+
+#include <cmath>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+
+namespace {
+
+void
+AssertNear(const katana::HyperLogLog& sketch, uint64_t expected, double tol) {
+  double error = std::abs(sketch.Estimate() - expected) / expected;
+  KATANA_LOG_VASSERT(
+      error <= tol, "expected {} distinct keys, estimated {}", expected,
+      sketch.Estimate());
+}
+
+/// Every key is inserted three times, by sketches of different threads
+void
+TestEstimate(uint64_t num_keys, uint32_t precision, double tol) {
+  katana::PerThreadStorage<katana::HyperLogLog> sketches(precision);
+  katana::do_all(katana::iterate(uint64_t{0}, 3 * num_keys), [&](uint64_t i) {
+    sketches.getLocal()->Insert(katana::HyperLogLog::Hash(i % num_keys));
+  });
+
+  katana::HyperLogLog merged(precision);
+  for (unsigned t = 0; t < sketches.size(); ++t) {
+    merged.Merge(*sketches.getRemote(t));
+  }
+  AssertNear(merged, num_keys, tol);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  katana::HyperLogLog empty;
+  KATANA_LOG_ASSERT(empty.Estimate() == 0);
+
+  // linear counting is close to exact for few keys
+  TestEstimate(10, katana::HyperLogLog::kDefaultPrecision, 0.01);
+  TestEstimate(1000, katana::HyperLogLog::kDefaultPrecision, 0.02);
+  TestEstimate(1000000, katana::HyperLogLog::kDefaultPrecision, 0.03);
+  TestEstimate(1000000, 10, 0.1);
+
+  return 0;
+}
@@ -0,0 +1,49 @@
+#include <chrono>
+
+#include "katana/Galois.h"
+
+namespace {
+
+constexpr unsigned kNumLoops = 16;
+
+void
+RunLoops() {
+  for (unsigned i = 0; i < kNumLoops; ++i) {
+    katana::on_each([](unsigned, unsigned) {});
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+  auto& pool = katana::GetThreadPool();
+  unsigned num_threads = katana::setActiveThreads(pool.getMaxThreads());
+  if (num_threads < 2) {
+    return 0;
+  }
+
+  // without spinning, every idle thread blocks and each loop wakes them up
+  pool.setIdleSpin(std::chrono::microseconds(0));
+  katana::on_each([](unsigned, unsigned) {});
+  auto before = pool.getIdleStats();
+  RunLoops();
+  auto after = pool.getIdleStats();
+  KATANA_LOG_ASSERT(after.spinWakeups == before.spinWakeups);
+  KATANA_LOG_ASSERT(
+      after.parkWakeups - before.parkWakeups ==
+      kNumLoops * (num_threads - 1));
+  KATANA_LOG_ASSERT(after.maxParkLatencyNs <= after.parkLatencyNs);
+
+  // with a long spin, threads that went idle spinning are woken up spinning
+  pool.setIdleSpin(std::chrono::seconds(10));
+  katana::on_each([](unsigned, unsigned) {});
+  before = pool.getIdleStats();
+  RunLoops();
+  after = pool.getIdleStats();
+  KATANA_LOG_ASSERT(after.spinWakeups > before.spinWakeups);
+
+  pool.setIdleSpin(katana::ThreadPool::kDefaultSpin);
+  return 0;
+}
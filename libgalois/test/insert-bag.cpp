@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+
+namespace {
+
+/// Small blocks so that the bag has many of them
+using Bag = katana::InsertBag<uint64_t, 256>;
+
+/// Thread 0 pushes most of the elements, the others a few each
+void
+FillUnevenly(Bag* bag, uint64_t size) {
+  katana::on_each([&](unsigned tid, unsigned num) {
+    uint64_t e = size - num + tid + 1;
+    uint64_t b = tid == 0 ? 0 : e - 1;
+    for (uint64_t i = b; i < e; ++i) {
+      bag->push(i);
+    }
+  });
+}
+
+void
+TestIterators(const Bag& bag) {
+  std::vector<uint64_t> serial(bag.begin(), bag.end());
+  auto blocks = bag.Blocks();
+  KATANA_LOG_ASSERT(blocks.size() == serial.size());
+  KATANA_LOG_ASSERT(blocks.num_blocks() > 1);
+  KATANA_LOG_ASSERT(std::equal(serial.begin(), serial.end(), blocks.begin()));
+
+  auto begin = blocks.begin();
+  for (size_t i = 0; i < serial.size(); i += 97) {
+    auto it = begin + i;
+    KATANA_LOG_ASSERT(*it == serial[i]);
+    KATANA_LOG_ASSERT(std::distance(begin, it) == static_cast<ptrdiff_t>(i));
+    if (i > 0) {
+      --it;
+      KATANA_LOG_ASSERT(*it == serial[i - 1]);
+    }
+  }
+  auto last = blocks.end();
+  --last;
+  KATANA_LOG_ASSERT(*last == serial.back());
+  KATANA_LOG_ASSERT(blocks.end() - blocks.begin() ==
+                    static_cast<ptrdiff_t>(serial.size()));
+}
+
+void
+TestParallel(const Bag& bag, uint64_t size) {
+  std::vector<std::atomic<uint32_t>> visits(size);
+  auto blocks = bag.Blocks();
+  katana::do_all(
+      katana::iterate(blocks), [&](uint64_t i) { visits[i] += 1; },
+      katana::steal(), katana::no_stats());
+  for (uint64_t i = 0; i < size; ++i) {
+    KATANA_LOG_VASSERT(visits[i] == 1, "element {} visited {}", i, visits[i]);
+  }
+}
+
+void
+TestMoveTo(Bag* bag, uint64_t size) {
+  katana::NUMAArray<uint64_t> array;
+  array.allocateInterleaved(1);
+  bag->MoveTo(&array);
+  KATANA_LOG_ASSERT(bag->empty());
+  KATANA_LOG_ASSERT(array.size() == size);
+  std::sort(array.begin(), array.end());
+  for (uint64_t i = 0; i < size; ++i) {
+    KATANA_LOG_ASSERT(array[i] == i);
+  }
+
+  Bag empty;
+  empty.MoveTo(&array);
+  KATANA_LOG_ASSERT(array.size() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  constexpr uint64_t kSize = 100000;
+  Bag bag;
+  KATANA_LOG_ASSERT(bag.Blocks().empty());
+  FillUnevenly(&bag, kSize);
+  KATANA_LOG_ASSERT(bag.size() == kSize);
+
+  TestIterators(bag);
+  TestParallel(bag, kSize);
+  TestMoveTo(&bag, kSize);
+
+  return 0;
+}
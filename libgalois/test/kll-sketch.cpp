@@ -0,0 +1,60 @@
+#include "katana/KLLSketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+
+namespace {
+
+/// The values are a shuffle of 0 to num_values - 1, so the q-quantile is
+/// about q * num_values
+void
+TestQuantiles(uint64_t num_values, uint32_t k, double max_error) {
+  std::vector<uint64_t> values(num_values);
+  std::iota(values.begin(), values.end(), 0);
+  std::shuffle(values.begin(), values.end(), std::mt19937_64(7));
+
+  katana::PerThreadStorage<katana::KLLSketch<uint64_t>> sketches(k);
+  katana::do_all(katana::iterate(values), [&](uint64_t v) {
+    sketches.getLocal()->Insert(v);
+  });
+  katana::KLLSketch<uint64_t> merged(k);
+  for (unsigned t = 0; t < sketches.size(); ++t) {
+    merged.Merge(*sketches.getRemote(t));
+  }
+
+  KATANA_LOG_ASSERT(merged.count() == num_values);
+  KATANA_LOG_ASSERT(merged.Quantile(0) == 0);
+  KATANA_LOG_ASSERT(merged.Quantile(1) == num_values - 1);
+  for (double q : {0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99}) {
+    double rank = merged.Quantile(q);
+    double error = std::abs(rank - q * num_values) / num_values;
+    KATANA_LOG_VASSERT(
+        error <= max_error, "{} values at k {}: {}-quantile is {}",
+        num_values, k, q, rank);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  katana::KLLSketch<uint64_t> empty;
+  KATANA_LOG_ASSERT(empty.empty());
+
+  // short streams are kept whole
+  TestQuantiles(100, katana::KLLSketch<uint64_t>::kDefaultK, 0.015);
+  TestQuantiles(1000000, katana::KLLSketch<uint64_t>::kDefaultK, 0.02);
+  TestQuantiles(1000000, 50, 0.06);
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+#include <cstdint>
+#include <vector>
+
+#include "katana/Executor_ParaMeter.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/LoopProfile.h"
+
+namespace {
+
+void
+TestDisabled() {
+  katana::SetLoopProfiling(false);
+  KATANA_LOG_ASSERT(!katana::IsLoopProfiling());
+
+  katana::LoopProfile profile("disabled");
+  KATANA_LOG_ASSERT(!profile.enabled());
+  katana::on_each([&](unsigned, unsigned) {
+    profile.BeginThread();
+    profile.EndThread(1, 1);
+  });
+  KATANA_LOG_ASSERT(profile.Finish().num_threads == 0);
+}
+
+void
+TestSummary() {
+  katana::SetLoopProfiling(true);
+
+  katana::LoopProfile profile("summary");
+  KATANA_LOG_ASSERT(profile.enabled());
+  katana::on_each([&](unsigned tid, unsigned) {
+    profile.BeginThread();
+    profile.EndThread(tid + 1, tid);
+  });
+  auto summary = profile.Finish();
+
+  uint64_t num_threads = katana::getActiveThreads();
+  KATANA_LOG_ASSERT(summary.num_threads == num_threads);
+  KATANA_LOG_ASSERT(summary.chunks == num_threads * (num_threads + 1) / 2);
+  KATANA_LOG_ASSERT(summary.steals == num_threads * (num_threads - 1) / 2);
+  KATANA_LOG_ASSERT(summary.max_busy_ns <= summary.wall_ns);
+  KATANA_LOG_ASSERT(summary.max_idle_ns <= summary.wall_ns);
+  KATANA_LOG_ASSERT(summary.busy_ns <= summary.wall_ns * num_threads);
+  KATANA_LOG_ASSERT(summary.imbalance() >= 1.0);
+
+  KATANA_LOG_ASSERT(profile.Finish().num_threads == 0);
+}
+
+/// Loops must compute the same results while being profiled
+void
+TestLoops() {
+  katana::SetLoopProfiling(true);
+
+  constexpr size_t kSize = 100000;
+  std::vector<uint64_t> values(kSize, 0);
+
+  katana::do_all(
+      katana::iterate(size_t{0}, kSize), [&](size_t i) { values[i] += i; },
+      katana::steal(), katana::loopname("ProfiledSteal"));
+  katana::do_all(
+      katana::iterate(size_t{0}, kSize), [&](size_t i) { values[i] += i; },
+      katana::loopname("ProfiledNoSteal"));
+  for (size_t i = 0; i < kSize; ++i) {
+    KATANA_LOG_ASSERT(values[i] == 2 * i);
+  }
+
+  katana::GAccumulator<uint64_t> visited;
+  std::vector<uint32_t> root{1};
+  katana::for_each(
+      katana::iterate(root),
+      [&](uint32_t n, auto& ctx) {
+        visited += 1;
+        if (n < (1U << 12)) {
+          ctx.push(2 * n);
+          ctx.push(2 * n + 1);
+        }
+      },
+      katana::disable_conflict_detection(), katana::loopname("ProfiledFor"));
+  KATANA_LOG_ASSERT(visited.reduce() == (uint64_t{1} << 13) - 1);
+
+  katana::SetLoopProfiling(false);
+}
+
+/// for_each loops must compute the same results while their parallelism is
+/// profiled
+void
+TestParallelism() {
+  katana::SetParallelismProfiling(true);
+  KATANA_LOG_ASSERT(katana::IsParallelismProfiling());
+
+  katana::GAccumulator<uint64_t> visited;
+  std::vector<uint32_t> root{1};
+  auto expand = [&](uint32_t n, auto& ctx) {
+    visited += 1;
+    if (n < (1U << 12)) {
+      ctx.push(2 * n);
+      ctx.push(2 * n + 1);
+    }
+  };
+  katana::for_each(
+      katana::iterate(root), expand, katana::disable_conflict_detection(),
+      katana::loopname("ProfiledParallelism"));
+  KATANA_LOG_ASSERT(visited.reduce() == (uint64_t{1} << 13) - 1);
+
+  katana::SetParallelismProfiling(false);
+  KATANA_LOG_ASSERT(!katana::IsParallelismProfiling());
+
+  // a round for each level of the tree, whatever the worklist
+  auto profile = katana::parameter::RunParallelismProfile(
+      katana::iterate(root), expand,
+      std::make_tuple(
+          katana::disable_conflict_detection(),
+          katana::wl<katana::PerSocketChunkFIFO<>>()));
+  KATANA_LOG_ASSERT(profile.rounds() == 13);
+  KATANA_LOG_ASSERT(profile.iterations == (uint64_t{1} << 13) - 1);
+  KATANA_LOG_ASSERT(profile.max_parallelism == uint64_t{1} << 12);
+  KATANA_LOG_ASSERT(profile.aborts == 0);
+  for (size_t i = 0; i < profile.rounds(); ++i) {
+    KATANA_LOG_ASSERT(profile.parallelism[i] == uint64_t{1} << i);
+  }
+
+  // iterations that all conflict run one per round
+  constexpr uint32_t kConflicting = 8;
+  katana::Lockable lock;
+  profile = katana::parameter::RunParallelismProfile(
+      katana::iterate(uint32_t{0}, kConflicting),
+      [&](uint32_t, auto&) {
+        katana::acquire(&lock, katana::MethodFlag::WRITE);
+      },
+      std::make_tuple());
+  KATANA_LOG_ASSERT(profile.rounds() == kConflicting);
+  KATANA_LOG_ASSERT(profile.iterations == kConflicting);
+  KATANA_LOG_ASSERT(profile.max_parallelism == 1);
+  KATANA_LOG_ASSERT(
+      profile.aborts == kConflicting * (kConflicting - 1) / 2);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestDisabled();
+  TestSummary();
+  TestLoops();
+  TestParallelism();
+
+  return 0;
+}
@@ -19,6 +19,9 @@
 
 #include "katana/Mem.h"
 
+#include <map>
+#include <vector>
+
 #include "katana/Galois.h"
 #include "katana/gIO.h"
 
@@ -70,5 +73,33 @@ main() {
     KATANA_LOG_ASSERT(allocated);
   }
 
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+  PerThreadArena arena;
+  for (int round = 0; round < 3; ++round) {
+    katana::GAccumulator<size_t> sum;
+    katana::do_all(katana::iterate(0u, 1000u), [&](unsigned i) {
+      using Alloc = PerThreadArenaAllocator<std::pair<const unsigned, size_t>>;
+      std::map<unsigned, size_t, std::less<unsigned>, Alloc> m{Alloc(&arena)};
+      std::vector<unsigned, PerThreadArenaAllocator<unsigned>> v{
+          PerThreadArenaAllocator<unsigned>(&arena)};
+      for (unsigned j = 0; j < i % 100; ++j) {
+        m[j % 10] += j;
+        v.push_back(j);
+      }
+      for (auto& kv : m) {
+        sum += kv.second;
+      }
+      KATANA_LOG_ASSERT(v.size() == i % 100);
+    });
+    // each i contributes (i % 100) choose 2
+    KATANA_LOG_ASSERT(sum.reduce() == 10 * 161700);
+    arena.clear();
+  }
+
+  // clearLocal reuses the block of the thread
+  void* first = arena.allocate(16);
+  arena.clearLocal();
+  KATANA_LOG_ASSERT(arena.allocate(16) == first);
+
   return 0;
 }
@@ -0,0 +1,74 @@
+#include <cstdint>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/WorkList.h"
+
+namespace {
+
+struct Identity {
+  uint32_t operator()(uint32_t n) const { return n; }
+};
+
+using Adaptive = katana::AdaptiveOrderedByIntegerMetric<
+    Identity, katana::PerSocketChunkFIFO<16>>::retype<uint32_t>;
+
+/// Expand a binary tree from its root; every node must be visited once
+template <typename WL, typename... Args>
+void
+TestForEach(Args&&... args) {
+  constexpr uint32_t kDepth = 16;
+
+  katana::GAccumulator<uint64_t> visited;
+  std::vector<uint32_t> root{1};
+  katana::for_each(
+      katana::iterate(root),
+      [&](uint32_t n, auto& ctx) {
+        visited += 1;
+        if (n < (1U << kDepth)) {
+          ctx.push(2 * n);
+          ctx.push(2 * n + 1);
+        }
+      },
+      katana::wl<WL>(std::forward<Args>(args)...),
+      katana::disable_conflict_detection(), katana::no_stats());
+
+  KATANA_LOG_ASSERT(visited.reduce() == (uint64_t{1} << (kDepth + 1)) - 1);
+}
+
+/// Drain n items of consecutive priorities and return the final shift
+unsigned
+Drain(uint32_t n, unsigned initial_shift) {
+  Adaptive wl(Identity(), initial_shift);
+  for (uint32_t i = 0; i < n; ++i) {
+    wl.push(i);
+  }
+  uint32_t popped = 0;
+  while (wl.pop()) {
+    ++popped;
+  }
+  KATANA_LOG_ASSERT(popped == n);
+  return wl.shift();
+}
+
+/// Buckets with a single item each widen; buckets with many items narrow
+void
+TestAdaptation() {
+  KATANA_LOG_ASSERT(Drain(1 << 12, 0) > 0);
+  KATANA_LOG_ASSERT(Drain(1 << 21, 16) < 16);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestAdaptation();
+  TestForEach<Adaptive>(Identity(), 4);
+  TestForEach<katana::MultiQueue<Identity>>();
+  TestForEach<katana::MultiQueue<Identity, 1>>();
+
+  return 0;
+}
@@ -4,6 +4,7 @@
 #include <functional>
 #include <iostream>
 
+#include "katana/ArrayReduction.h"
 #include "katana/Galois.h"
 
 struct Move {
@@ -86,6 +87,77 @@ test_accum() {
   KATANA_LOG_ASSERT(accum.reduce() == num);
 }
 
+void
+test_array_accum() {
+  // more indices than cache slots, and a hot index that is never evicted
+  constexpr size_t size = 5000;
+  constexpr uint32_t num = 200000;
+  katana::GArrayAccumulator<uint64_t, 64> accum(size);
+
+  for (int round = 0; round < 2; ++round) {
+    katana::do_all(katana::iterate(uint32_t{0}, num), [&](uint32_t i) {
+      accum.update(i % size, 1);
+      accum.update(0, 2);
+    });
+    accum.reduce();
+
+    KATANA_LOG_ASSERT(accum[0] == num / size + 2 * num);
+    for (size_t i = 1; i < size; ++i) {
+      KATANA_LOG_ASSERT(accum[i] == num / size);
+    }
+    accum.reset();
+  }
+
+  // a miss on a slot that has combined several updates does not evict it
+  for (int i = 0; i < 10; ++i) {
+    accum.update(0, 1);
+  }
+  accum.update(64, 1);
+  KATANA_LOG_ASSERT(accum[0] == 0);
+  KATANA_LOG_ASSERT(accum[64] == 1);
+  accum.reduce();
+  KATANA_LOG_ASSERT(accum[0] == 10);
+  KATANA_LOG_ASSERT(accum[64] == 1);
+}
+
+void
+test_histogram() {
+  constexpr size_t num_bins = 10;
+  constexpr int num = 123456;
+  katana::GHistogram<> histogram(num_bins);
+
+  katana::do_all(
+      katana::iterate(0, num), [&](int i) { histogram.update(i % num_bins); });
+  histogram.reduce();
+
+  uint64_t total = 0;
+  for (size_t bin = 0; bin < num_bins; ++bin) {
+    total += histogram[bin];
+    uint64_t expected = num / num_bins + (bin < num % num_bins ? 1 : 0);
+    KATANA_LOG_ASSERT(histogram[bin] == expected);
+  }
+  KATANA_LOG_ASSERT(total == num);
+}
+
+void
+test_top_k() {
+  constexpr int num = 100000;
+  katana::GTopK<int> top(5);
+  katana::do_all(katana::iterate(0, num), [&](int i) { top.update(i); });
+
+  std::vector<int> result = top.reduce();
+  std::vector<int> expected{num - 1, num - 2, num - 3, num - 4, num - 5};
+  KATANA_LOG_ASSERT(result == expected);
+
+  katana::GTopK<int, std::greater<int>> bottom(3);
+  katana::do_all(katana::iterate(0, num), [&](int i) { bottom.update(i); });
+  KATANA_LOG_ASSERT(bottom.reduce() == std::vector<int>({0, 1, 2}));
+
+  katana::GTopK<int> none(0);
+  none.update(1);
+  KATANA_LOG_ASSERT(none.reduce().empty());
+}
+
 int
 main() {
   katana::GaloisRuntime sys;
@@ -99,6 +171,9 @@ main() {
   test_move();
   test_max();
   test_accum();
+  test_array_accum();
+  test_histogram();
+  test_top_k();
 
   return 0;
 }
@@ -0,0 +1,156 @@
+#include "katana/RoaringBitmap.h"
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// A random set of about num_values values below 2^bits, in increasing
+/// order
+std::vector<uint32_t>
+RandomValues(size_t num_values, uint32_t bits, std::mt19937* gen) {
+  std::uniform_int_distribution<uint32_t> dist(
+      0, bits == 32 ? UINT32_MAX : (uint32_t{1} << bits) - 1);
+  std::set<uint32_t> values;
+  for (size_t i = 0; i < num_values; ++i) {
+    values.emplace(dist(*gen));
+  }
+  return {values.begin(), values.end()};
+}
+
+katana::RoaringBitmap
+Build(const std::vector<uint32_t>& values) {
+  katana::RoaringBitmap bitmap;
+  for (uint32_t value : values) {
+    KATANA_LOG_ASSERT(bitmap.Add(value));
+    KATANA_LOG_ASSERT(!bitmap.Add(value));
+  }
+  KATANA_LOG_ASSERT(bitmap == katana::RoaringBitmap::FromSorted(values));
+  return bitmap;
+}
+
+void
+AssertEqual(
+    const katana::RoaringBitmap& bitmap, const std::vector<uint32_t>& values) {
+  KATANA_LOG_VASSERT(
+      bitmap.Cardinality() == values.size(), "{} values, expected {}",
+      bitmap.Cardinality(), values.size());
+  KATANA_LOG_ASSERT(bitmap.ToVector() == values);
+  KATANA_LOG_ASSERT(bitmap == katana::RoaringBitmap::FromSorted(values));
+}
+
+void
+TestSetOperations(size_t a_values, size_t b_values, uint32_t bits) {
+  std::mt19937 gen(a_values * 31 + b_values + bits);
+  std::vector<uint32_t> a_list = RandomValues(a_values, bits, &gen);
+  std::vector<uint32_t> b_list = RandomValues(b_values, bits, &gen);
+  katana::RoaringBitmap a = Build(a_list);
+  katana::RoaringBitmap b = Build(b_list);
+  AssertEqual(a, a_list);
+
+  std::vector<uint32_t> expected;
+  std::set_union(
+      a_list.begin(), a_list.end(), b_list.begin(), b_list.end(),
+      std::back_inserter(expected));
+  katana::RoaringBitmap result = a;
+  result |= b;
+  AssertEqual(result, expected);
+  AssertEqual(katana::RoaringBitmap::ParallelUnion({&a, &b}), expected);
+  KATANA_LOG_ASSERT(a.IsSubsetOf(result) && b.IsSubsetOf(result));
+
+  expected.clear();
+  std::set_intersection(
+      a_list.begin(), a_list.end(), b_list.begin(), b_list.end(),
+      std::back_inserter(expected));
+  result = a;
+  result &= b;
+  AssertEqual(result, expected);
+  AssertEqual(katana::RoaringBitmap::ParallelIntersection(a, b), expected);
+  KATANA_LOG_ASSERT(a.Intersects(b) == !expected.empty());
+  KATANA_LOG_ASSERT(result.IsSubsetOf(a) && result.IsSubsetOf(b));
+
+  expected.clear();
+  std::set_difference(
+      a_list.begin(), a_list.end(), b_list.begin(), b_list.end(),
+      std::back_inserter(expected));
+  result = a;
+  result -= b;
+  AssertEqual(result, expected);
+  KATANA_LOG_ASSERT(!result.Intersects(b));
+
+  // Removing every other value shrinks full containers back to arrays
+  for (size_t i = 0; i < a_list.size(); i += 2) {
+    KATANA_LOG_ASSERT(a.Remove(a_list[i]));
+    KATANA_LOG_ASSERT(!a.Remove(a_list[i]));
+    KATANA_LOG_ASSERT(!a.Contains(a_list[i]));
+  }
+  expected.clear();
+  for (size_t i = 1; i < a_list.size(); i += 2) {
+    expected.emplace_back(a_list[i]);
+  }
+  AssertEqual(a, expected);
+}
+
+void
+TestParallelUnion() {
+  // Many overlapping sets spread over many containers
+  std::mt19937 gen(7);
+  std::vector<katana::RoaringBitmap> bitmaps;
+  std::set<uint32_t> expected;
+  for (size_t i = 0; i < 32; ++i) {
+    std::vector<uint32_t> values = RandomValues(1000 * (i + 1), 22, &gen);
+    expected.insert(values.begin(), values.end());
+    bitmaps.emplace_back(Build(values));
+  }
+  std::vector<const katana::RoaringBitmap*> inputs;
+  for (const auto& bitmap : bitmaps) {
+    inputs.emplace_back(&bitmap);
+  }
+  katana::RoaringBitmap all = katana::RoaringBitmap::ParallelUnion(inputs);
+  AssertEqual(all, {expected.begin(), expected.end()});
+  for (const auto& bitmap : bitmaps) {
+    KATANA_LOG_ASSERT(bitmap.IsSubsetOf(all));
+  }
+  KATANA_LOG_ASSERT(
+      katana::RoaringBitmap::ParallelIntersection(all, bitmaps[3]) ==
+      bitmaps[3]);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  katana::RoaringBitmap empty;
+  KATANA_LOG_ASSERT(empty.empty());
+  KATANA_LOG_ASSERT(empty.Cardinality() == 0);
+  KATANA_LOG_ASSERT(!empty.Contains(0));
+  KATANA_LOG_ASSERT(empty.IsSubsetOf(empty));
+
+  // Sparse values, dense values whose containers are bitmaps, and values
+  // around the array limit
+  TestSetOperations(1000, 1000, 32);
+  TestSetOperations(50000, 20000, 18);
+  TestSetOperations(
+      katana::RoaringBitmap::kMaxArrayValues,
+      katana::RoaringBitmap::kMaxArrayValues, 16);
+  TestSetOperations(0, 100, 20);
+  TestParallelUnion();
+
+  // A run of values is a single bitmap container, far smaller than its
+  // values
+  katana::RoaringBitmap run;
+  for (uint32_t value = 0; value < (1 << 16); ++value) {
+    run.Add(value);
+  }
+  KATANA_LOG_ASSERT(run.SizeInBytes() < (1 << 16) * sizeof(uint32_t) / 4);
+
+  return 0;
+}
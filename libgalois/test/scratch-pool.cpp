@@ -0,0 +1,107 @@
+#include "katana/ScratchPool.h"
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/PageAlloc.h"
+#include "katana/ProgressTracer.h"
+#include "katana/TextTracer.h"
+
+namespace {
+
+constexpr size_t kSize = 1 << 20;
+
+katana::ScratchPool&
+Pool() {
+  katana::ScratchPool* pool = katana::internal::GetScratchPool();
+  KATANA_LOG_ASSERT(pool);
+  return *pool;
+}
+
+/// Without a tracer there is no memory supervisor and nothing is retained
+void
+TestWithoutTracer() {
+  {
+    katana::NUMAArray<uint64_t> array;
+    array.allocateBlocked(kSize);
+  }
+  KATANA_LOG_ASSERT(Pool().GetStats().retained_bytes == 0);
+}
+
+void
+TestReuse() {
+  auto before = Pool().GetStats();
+
+  uint64_t* data = nullptr;
+  {
+    katana::NUMAArray<uint64_t> array;
+    array.allocateBlocked(kSize);
+    data = array.data();
+  }
+  KATANA_LOG_ASSERT(
+      Pool().GetStats().retained_bytes >=
+      before.retained_bytes + kSize * sizeof(uint64_t));
+
+  katana::NUMAArray<uint64_t> same;
+  same.allocateBlocked(kSize);
+  KATANA_LOG_ASSERT(same.data() == data);
+
+  // a different size or placement does not match
+  katana::NUMAArray<uint64_t> other_size;
+  other_size.allocateBlocked(kSize * 4);
+  katana::NUMAArray<uint64_t> other_placement;
+  other_placement.allocateInterleaved(kSize);
+
+  auto after = Pool().GetStats();
+  KATANA_LOG_ASSERT(after.hits == before.hits + 1);
+  KATANA_LOG_ASSERT(after.misses == before.misses + 3);
+}
+
+void
+TestCapacity() {
+  size_t capacity = Pool().capacity();
+  Pool().SetCapacity(0);
+  KATANA_LOG_ASSERT(Pool().GetStats().retained_bytes == 0);
+  {
+    katana::NUMAArray<uint64_t> array;
+    array.allocateLocal(kSize);
+  }
+  KATANA_LOG_ASSERT(Pool().GetStats().retained_bytes == 0);
+  Pool().SetCapacity(capacity);
+}
+
+void
+TestSupervisorReclaim() {
+  {
+    katana::NUMAArray<uint64_t> array;
+    array.allocateFloating(kSize);
+  }
+  size_t retained = Pool().GetStats().retained_bytes;
+  KATANA_LOG_ASSERT(retained > 0);
+
+  katana::ScratchManager manager;
+  katana::count_t freed = manager.FreeStandbyMemory(1);
+  KATANA_LOG_ASSERT(freed > 0);
+  KATANA_LOG_ASSERT(
+      Pool().GetStats().retained_bytes + static_cast<size_t>(freed) ==
+      retained);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+  Pool().SetCapacity(kSize * sizeof(uint64_t) * 16);
+
+  TestWithoutTracer();
+  katana::ProgressTracer::Set(katana::TextTracer::Make());
+
+  TestReuse();
+  TestCapacity();
+  TestSupervisorReclaim();
+
+  katana::GetTracer().Finish();
+  return 0;
+}
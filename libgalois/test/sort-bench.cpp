@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Threads.h"
+
+namespace {
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long size : {64 * 1024, 1024 * 1024, 16 * 1024 * 1024}) {
+    b->Args({size});
+  }
+}
+
+std::vector<uint64_t>
+MakeInput(long size) {
+  std::mt19937_64 gen(size);
+  // like edge destinations or node degrees: wide type, narrower values
+  std::uniform_int_distribution<uint64_t> dist(0, uint64_t{1} << 40);
+  std::vector<uint64_t> ret(size);
+  for (auto& v : ret) {
+    v = dist(gen);
+  }
+  return ret;
+}
+
+void
+VerifyOutput(const std::vector<uint64_t>& output) {
+  KATANA_LOG_VASSERT(
+      std::is_sorted(output.begin(), output.end()), "output is not sorted");
+}
+
+template <typename SortFn>
+void
+RunSort(benchmark::State& state, const SortFn& sort_fn) {
+  long size = state.range(0);
+  const auto input = MakeInput(size);
+  std::vector<uint64_t> output;
+
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    output = input;
+    state.ResumeTiming();
+    sort_fn(output);
+  }
+
+  VerifyOutput(output);
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+void
+StdSort(benchmark::State& state) {
+  RunSort(state, [](auto& v) { std::sort(v.begin(), v.end()); });
+}
+
+void
+ParallelSort(benchmark::State& state) {
+  RunSort(
+      state, [](auto& v) { katana::ParallelSTL::sort(v.begin(), v.end()); });
+}
+
+void
+SampleSort(benchmark::State& state) {
+  RunSort(state, [](auto& v) {
+    katana::ParallelSTL::sample_sort(v.begin(), v.end());
+  });
+}
+
+void
+RadixSort(benchmark::State& state) {
+  RunSort(state, [](auto& v) {
+    katana::ParallelSTL::radix_sort(v.begin(), v.end());
+  });
+}
+
+BENCHMARK(StdSort)->Apply(MakeArguments);
+BENCHMARK(ParallelSort)->Apply(MakeArguments);
+BENCHMARK(SampleSort)->Apply(MakeArguments);
+BENCHMARK(RadixSort)->Apply(MakeArguments);
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::GaloisRuntime G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -17,9 +17,13 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <numeric>
+#include <vector>
 
 #include "katana/Galois.h"
 #include "katana/ParallelSTL.h"
@@ -92,6 +96,107 @@ do_sort() {
   return 0;
 }
 
+int
+do_radix_sort() {
+  unsigned M = katana::GetThreadPool().getMaxThreads();
+  std::cout << "radix_sort:\n";
+
+  while (M) {
+    katana::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    // negative numbers and keys that differ only in their high bytes
+    std::vector<int64_t> V(vectorSize);
+    std::generate(V.begin(), V.end(), []() {
+      return (int64_t{RandomNumber()} - 500000) << (RandomNumber() % 40);
+    });
+    std::vector<int64_t> C = V;
+
+    katana::Timer t;
+    t.start();
+    katana::ParallelSTL::radix_sort(V.begin(), V.end());
+    t.stop();
+
+    katana::Timer t2;
+    t2.start();
+    std::sort(C.begin(), C.end());
+    t2.stop();
+
+    bool eq = V == C;
+    std::cout << "Galois: " << t.get() << " STL: " << t2.get()
+              << " Equal: " << eq << "\n";
+    if (!eq) {
+      return 1;
+    }
+
+    // values record the input position, so the sort must keep them
+    // ascending among equal keys
+    std::vector<uint16_t> K(vectorSize);
+    std::generate(K.begin(), K.end(), RandomNumber);
+    std::vector<uint32_t> I(vectorSize);
+    std::iota(I.begin(), I.end(), 0);
+    katana::ParallelSTL::radix_sort_by_key(K.begin(), K.end(), I.begin());
+    for (size_t i = 1; i < K.size(); ++i) {
+      if (K[i - 1] > K[i] || (K[i - 1] == K[i] && I[i - 1] > I[i])) {
+        std::cout << "radix_sort_by_key not stable at " << i << "\n";
+        return 1;
+      }
+    }
+
+    M >>= 1;
+  }
+
+  return 0;
+}
+
+int
+do_sample_sort() {
+  unsigned M = katana::GetThreadPool().getMaxThreads();
+  std::cout << "sample_sort:\n";
+
+  while (M) {
+    katana::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    std::vector<unsigned> V(vectorSize);
+    std::generate(V.begin(), V.end(), RandomNumber);
+    std::vector<unsigned> C = V;
+
+    katana::Timer t;
+    t.start();
+    katana::ParallelSTL::sample_sort(V.begin(), V.end(), std::greater<>());
+    t.stop();
+
+    katana::Timer t2;
+    t2.start();
+    std::sort(C.begin(), C.end(), std::greater<>());
+    t2.stop();
+
+    bool eq = V == C;
+    std::cout << "Galois: " << t.get() << " STL: " << t2.get()
+              << " Equal: " << eq << "\n";
+    if (!eq) {
+      return 1;
+    }
+
+    // mostly one value, which lands in a single bucket
+    std::generate(V.begin(), V.end(), []() {
+      return RandomNumber() % 8 ? 7u : unsigned(RandomNumber());
+    });
+    C = V;
+    katana::ParallelSTL::sample_sort(V.begin(), V.end());
+    std::sort(C.begin(), C.end());
+    if (V != C) {
+      std::cout << "sample_sort failed with duplicates\n";
+      return 1;
+    }
+
+    M >>= 1;
+  }
+
+  return 0;
+}
+
 int
 do_count_if() {
   unsigned M = katana::GetThreadPool().getMaxThreads();
@@ -176,5 +281,7 @@ main(int argc, char** argv) {
   //  ret |= do_sort();
   //  ret |= do_count_if();
   ret |= do_accumulate();
+  ret |= do_radix_sort();
+  ret |= do_sample_sort();
   return ret;
 }
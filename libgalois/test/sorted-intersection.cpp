@@ -0,0 +1,121 @@
+#include "katana/SortedIntersection.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "katana/Logging.h"
+
+namespace {
+
+/// size distinct elements from [0, universe) in increasing order
+std::vector<uint32_t>
+RandomSet(size_t size, uint32_t universe, std::mt19937_64* gen) {
+  std::uniform_int_distribution<uint32_t> dist(0, universe - 1);
+  std::set<uint32_t> set;
+  while (set.size() < size) {
+    set.emplace(dist(*gen));
+  }
+  return {set.begin(), set.end()};
+}
+
+void
+TestPair(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+  std::vector<uint32_t> expected;
+  std::set_intersection(
+      a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+  size_t count =
+      katana::SortedIntersectionSize(a.data(), a.size(), b.data(), b.size());
+  KATANA_LOG_VASSERT(
+      count == expected.size(), "|a| = {}, |b| = {}: {} != {}", a.size(),
+      b.size(), count, expected.size());
+
+  std::vector<uint32_t> common(std::min(a.size(), b.size()));
+  uint32_t* end = katana::SortedIntersection(
+      a.data(), a.size(), b.data(), b.size(), common.data());
+  common.resize(end - common.data());
+  KATANA_LOG_ASSERT(common == expected);
+
+  katana::SortedSetBitmap bitmap;
+  bitmap.Assign(a.data(), a.size());
+  KATANA_LOG_ASSERT(bitmap.IntersectionSize(b.data(), b.size()) == count);
+  std::vector<uint32_t> from_bitmap(b.size());
+  end = bitmap.Intersection(b.data(), b.size(), from_bitmap.data());
+  from_bitmap.resize(end - from_bitmap.data());
+  KATANA_LOG_ASSERT(from_bitmap == expected);
+}
+
+/// Sizes around the block sizes and ratios around the one that switches to
+/// galloping
+void
+TestRandom() {
+  std::mt19937_64 gen(0);
+  for (size_t a_size : {0, 1, 7, 8, 9, 15, 16, 17, 33, 100, 1000}) {
+    for (size_t b_size : {0, 1, 8, 16, 31, 100, 1000, 5000, 40000}) {
+      for (uint32_t universe : {50000, 200000}) {
+        TestPair(
+            RandomSet(a_size, universe, &gen),
+            RandomSet(b_size, universe, &gen));
+      }
+    }
+  }
+}
+
+void
+TestExtremes() {
+  std::vector<uint32_t> all(1000);
+  for (uint32_t i = 0; i < all.size(); ++i) {
+    all[i] = i;
+  }
+  std::vector<uint32_t> evens;
+  std::vector<uint32_t> odds;
+  for (uint32_t x : all) {
+    (x % 2 ? odds : evens).emplace_back(x);
+  }
+  TestPair(all, all);
+  TestPair(all, evens);
+  TestPair(evens, odds);
+
+  // elements that are negative as signed integers; not for bitmaps, which
+  // have a bit for each integer up to the largest element
+  std::vector<uint32_t> high(all);
+  for (uint32_t& x : high) {
+    x += UINT32_MAX - 2000;
+  }
+  std::vector<uint32_t> common(high.size());
+  KATANA_LOG_ASSERT(
+      katana::SortedIntersectionSize(
+          high.data(), high.size(), high.data() + 500, 500) == 500);
+  uint32_t* end = katana::SortedIntersection(
+      high.data() + 1, 999, high.data(), high.size(), common.data());
+  KATANA_LOG_ASSERT(
+      std::equal(common.data(), end, high.data() + 1, high.data() + 1000));
+}
+
+void
+TestBitmapReuse() {
+  katana::SortedSetBitmap bitmap;
+  std::vector<uint32_t> large{3, 64, 500, 10000};
+  std::vector<uint32_t> small{2, 3, 65};
+  bitmap.Assign(large.data(), large.size());
+  bitmap.Assign(small.data(), small.size());
+  KATANA_LOG_ASSERT(bitmap.Contains(2) && bitmap.Contains(65));
+  KATANA_LOG_ASSERT(!bitmap.Contains(64) && !bitmap.Contains(10000));
+  KATANA_LOG_ASSERT(!bitmap.Contains(UINT32_MAX));
+  bitmap.Clear();
+  KATANA_LOG_ASSERT(!bitmap.Contains(3));
+}
+
+}  // namespace
+
+int
+main() {
+  TestRandom();
+  TestExtremes();
+  TestBitmapReuse();
+  return 0;
+}
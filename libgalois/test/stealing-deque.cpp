@@ -0,0 +1,94 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/StealingDeque.h"
+
+namespace {
+
+/// The owner pushes and pops while other threads steal; every element must
+/// be taken exactly once
+void
+TestDeque() {
+  constexpr uint32_t kNumElements = 1 << 16;
+  constexpr unsigned kNumThieves = 3;
+
+  std::vector<uint32_t> elements(kNumElements);
+  std::vector<std::atomic<uint32_t>> taken(kNumElements);
+  for (uint32_t i = 0; i < kNumElements; ++i) {
+    elements[i] = i;
+    taken[i] = 0;
+  }
+
+  katana::internal::ChaseLevDeque<uint32_t> deque;
+  std::atomic<bool> pushing{true};
+  std::vector<std::thread> thieves;
+  for (unsigned i = 0; i < kNumThieves; ++i) {
+    thieves.emplace_back([&]() {
+      while (pushing || !deque.empty()) {
+        if (uint32_t* x = deque.steal()) {
+          ++taken[*x];
+        }
+      }
+    });
+  }
+
+  for (uint32_t i = 0; i < kNumElements; ++i) {
+    deque.push(&elements[i]);
+    // pop every third element back to race thieves on a short deque
+    if (i % 3 == 0) {
+      if (uint32_t* x = deque.pop()) {
+        ++taken[*x];
+      }
+    }
+  }
+  while (uint32_t* x = deque.pop()) {
+    ++taken[*x];
+  }
+  pushing = false;
+  for (auto& t : thieves) {
+    t.join();
+  }
+
+  for (uint32_t i = 0; i < kNumElements; ++i) {
+    KATANA_LOG_VASSERT(taken[i] == 1, "element {} taken {} times", i, taken[i]);
+  }
+}
+
+/// Expand a binary tree from its root, which only spreads over threads by
+/// stealing
+void
+TestForEach() {
+  constexpr uint32_t kDepth = 16;
+
+  katana::GAccumulator<uint64_t> visited;
+  std::vector<uint32_t> root{1};
+  katana::for_each(
+      katana::iterate(root),
+      [&](uint32_t n, auto& ctx) {
+        visited += 1;
+        if (n < (1U << kDepth)) {
+          ctx.push(2 * n);
+          ctx.push(2 * n + 1);
+        }
+      },
+      katana::wl<katana::StealingDeque<16>>(),
+      katana::disable_conflict_detection(), katana::no_stats());
+
+  KATANA_LOG_ASSERT(visited.reduce() == (uint64_t{1} << (kDepth + 1)) - 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestDeque();
+  TestForEach();
+
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include <atomic>
+#include <cstdint>
+
+#include "katana/Galois.h"
+#include "katana/TaskGraph.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 1 << 16;
+
+uint64_t
+ParallelSum(uint64_t offset) {
+  katana::GAccumulator<uint64_t> accum;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNumItems),
+      [&](uint64_t i) { accum += i + offset; }, katana::no_stats());
+  return accum.reduce();
+}
+
+uint64_t
+ExpectedSum(uint64_t offset) {
+  return kNumItems * (kNumItems - 1) / 2 + kNumItems * offset;
+}
+
+/// Two sources, a join and two sinks; every task runs its own loop
+void
+TestDiamond(unsigned threads_per_task) {
+  katana::TaskGraph graph;
+  auto a = graph.Add([]() { return ParallelSum(1); }, {}, threads_per_task);
+  auto b = graph.Add(
+      []() -> katana::Result<uint64_t> { return ParallelSum(2); }, {},
+      threads_per_task);
+  auto join = graph.Add(
+      [&]() { return a.value() + b.value(); }, {a, b}, threads_per_task);
+
+  std::atomic<uint64_t> sinks{0};
+  graph.Add(
+      [&]() { sinks += join.value() + ParallelSum(0); }, {join},
+      threads_per_task);
+  graph.Add(
+      [&]() -> katana::Result<void> {
+        sinks += join.value();
+        return katana::ResultSuccess();
+      },
+      {join}, threads_per_task);
+  KATANA_LOG_ASSERT(graph.size() == 5);
+
+  auto res = graph.Run();
+  KATANA_LOG_ASSERT(res);
+  KATANA_LOG_ASSERT(join.value() == ExpectedSum(1) + ExpectedSum(2));
+  KATANA_LOG_ASSERT(sinks == 2 * join.value() + ExpectedSum(0));
+}
+
+/// Tasks after a failed task do not run and Run returns its error
+void
+TestError() {
+  katana::TaskGraph graph;
+  bool ran_after_error = false;
+  auto fail = graph.Add([]() -> katana::Result<void> {
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "failed task");
+  });
+  graph.Add([&]() { ran_after_error = true; }, {fail});
+
+  auto res = graph.Run();
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(res.error() == katana::ErrorCode::InvalidArgument);
+  KATANA_LOG_ASSERT(!ran_after_error);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+  unsigned max_threads = katana::GetThreadPool().getMaxThreads();
+  katana::setActiveThreads(max_threads);
+
+  TestDiamond(1);
+  TestDiamond(2);
+  // larger than the pool, so each task runs on the whole pool in turn
+  TestDiamond(max_threads + 1);
+  TestError();
+
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == max_threads);
+
+  return 0;
+}
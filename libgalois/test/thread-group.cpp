@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "katana/Galois.h"
+#include "katana/ThreadGroup.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 1 << 20;
+constexpr uint64_t kSum = kNumItems * (kNumItems - 1) / 2;
+
+/// Sum the first kNumItems integers in parallel and check that every thread
+/// of the loops is a thread of group
+void
+SumOnGroup(katana::ThreadGroup* group, uint64_t* sum, bool* ids_in_group) {
+  katana::ThreadGroup::Scope scope(group);
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == group->size());
+  KATANA_LOG_ASSERT(katana::ThreadGroup::Current() == group);
+
+  std::atomic<bool> in_group{true};
+  auto check_ids = [&]() {
+    unsigned pool_tid = katana::ThreadPool::getPoolTID();
+    unsigned group_end = group->begin() + group->size();
+    if (katana::ThreadPool::getTID() >= group->size() ||
+        pool_tid < group->begin() || pool_tid >= group_end) {
+      in_group = false;
+    }
+  };
+
+  katana::GAccumulator<uint64_t> accum;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNumItems),
+      [&](uint64_t i) {
+        accum += i;
+        check_ids();
+      },
+      katana::steal(), katana::no_stats());
+  katana::on_each([&](unsigned tid, unsigned num) {
+    if (tid >= num || num != group->size()) {
+      in_group = false;
+    }
+    check_ids();
+  });
+
+  *sum = accum.reduce();
+  *ids_in_group = in_group;
+
+  // the count of a group is its own
+  unsigned pool_threads = katana::activeThreads;
+  KATANA_LOG_ASSERT(katana::setActiveThreads(1) == 1);
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == 1);
+  KATANA_LOG_ASSERT(katana::activeThreads == pool_threads);
+  katana::setActiveThreads(group->size());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+
+  unsigned max_threads = katana::GetThreadPool().getMaxThreads();
+  // leave the master thread and some more to the rest of the pool
+  unsigned group_size = std::min(2U, (max_threads - 1) / 3);
+  if (group_size == 0) {
+    return 0;
+  }
+
+  auto group_a = katana::ThreadGroup::Make(group_size);
+  auto group_b = katana::ThreadGroup::Make(group_size);
+  KATANA_LOG_ASSERT(group_a && group_b);
+  KATANA_LOG_ASSERT(
+      group_a->begin() >= group_b->begin() + group_size ||
+      group_b->begin() >= group_a->begin() + group_size);
+  KATANA_LOG_ASSERT(katana::ThreadGroup::Make(max_threads) == nullptr);
+
+  unsigned rest = max_threads - 2 * group_size;
+  KATANA_LOG_ASSERT(katana::setActiveThreads(max_threads) == rest);
+
+  // a thread outside of groups runs its loops on the process-wide count
+  unsigned other_thread_threads = 0;
+  std::thread([&]() {
+    other_thread_threads = katana::getActiveThreads();
+  }).join();
+  KATANA_LOG_ASSERT(other_thread_threads == rest);
+
+  uint64_t sum_a = 0;
+  uint64_t sum_b = 0;
+  bool ids_in_a = false;
+  bool ids_in_b = false;
+  std::thread thread_a(SumOnGroup, group_a.get(), &sum_a, &ids_in_a);
+  std::thread thread_b(SumOnGroup, group_b.get(), &sum_b, &ids_in_b);
+
+  // meanwhile the rest of the pool runs loops as usual
+  katana::GAccumulator<uint64_t> accum;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNumItems), [&](uint64_t i) { accum += i; },
+      katana::no_stats());
+
+  thread_a.join();
+  thread_b.join();
+
+  KATANA_LOG_ASSERT(accum.reduce() == kSum);
+  KATANA_LOG_ASSERT(sum_a == kSum && ids_in_a);
+  KATANA_LOG_ASSERT(sum_b == kSum && ids_in_b);
+
+  group_a.reset();
+  group_b.reset();
+  KATANA_LOG_ASSERT(katana::setActiveThreads(max_threads) == max_threads);
+
+  return 0;
+}
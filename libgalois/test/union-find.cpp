@@ -0,0 +1,113 @@
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/UnionFind.h"
+
+namespace {
+
+using Pairs = std::vector<std::pair<uint32_t, uint32_t>>;
+
+/// The smallest element of the set of each element, computed serially
+std::vector<uint32_t>
+SerialMinimums(size_t size, const Pairs& pairs) {
+  std::vector<uint32_t> parent(size);
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&](uint32_t x) {
+    while (parent[x] != x) {
+      x = parent[x] = parent[parent[x]];
+    }
+    return x;
+  };
+  for (const auto& [x, y] : pairs) {
+    uint32_t rx = find(x);
+    uint32_t ry = find(y);
+    if (rx != ry) {
+      parent[std::max(rx, ry)] = std::min(rx, ry);
+    }
+  }
+  std::vector<uint32_t> ret(size);
+  for (uint32_t x = 0; x < size; ++x) {
+    ret[x] = find(x);
+  }
+  return ret;
+}
+
+Pairs
+RandomPairs(size_t size, size_t num_pairs, uint64_t seed) {
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<uint32_t> dist(0, size - 1);
+  Pairs pairs(num_pairs);
+  for (auto& p : pairs) {
+    p = {dist(gen), dist(gen)};
+  }
+  return pairs;
+}
+
+void
+TestUnionAll(size_t size, size_t num_pairs) {
+  Pairs pairs = RandomPairs(size, num_pairs, size);
+  std::vector<uint32_t> expected = SerialMinimums(size, pairs);
+
+  katana::UnionFind<uint32_t> uf(size);
+  size_t merges = uf.UnionAll(pairs, katana::steal(), katana::no_stats());
+  uf.CompressAll();
+
+  size_t num_sets = 0;
+  for (uint32_t x = 0; x < size; ++x) {
+    KATANA_LOG_VASSERT(
+        uf.Parent(x) == expected[x], "element {}: root {} expected {}", x,
+        uf.Parent(x), expected[x]);
+    num_sets += uf.IsRoot(x);
+  }
+  KATANA_LOG_ASSERT(merges == size - num_sets);
+
+  uf.Reset(size);
+  for (uint32_t x = 0; x < size; ++x) {
+    KATANA_LOG_ASSERT(uf.IsRoot(x));
+  }
+}
+
+void
+TestSingleOperations() {
+  katana::UnionFind<uint64_t> uf(10);
+  KATANA_LOG_ASSERT(uf.Union(7, 3));
+  KATANA_LOG_ASSERT(uf.Union(3, 9));
+  KATANA_LOG_ASSERT(!uf.Union(9, 7));
+  KATANA_LOG_ASSERT(uf.SameSet(7, 9));
+  KATANA_LOG_ASSERT(!uf.SameSet(7, 2));
+  KATANA_LOG_ASSERT(uf.Find(9) == 3);
+  uf.Compress(9);
+  KATANA_LOG_ASSERT(uf.Parent(9) == 3);
+}
+
+/// One set covering most elements must be found by sampling
+void
+TestSampleLargestSet() {
+  constexpr size_t kSize = 10000;
+  katana::UnionFind<uint32_t> uf(kSize);
+  katana::do_all(
+      katana::iterate(size_t{100}, kSize - 1),
+      [&](size_t x) { uf.Union(x, x + 1); }, katana::no_stats());
+  KATANA_LOG_ASSERT(uf.SampleLargestSet(256, 42) == 100);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestSingleOperations();
+  // sparse, mostly singletons, and dense, a giant set
+  TestUnionAll(100000, 20000);
+  TestUnionAll(100000, 300000);
+  TestSampleLargestSet();
+
+  return 0;
+}
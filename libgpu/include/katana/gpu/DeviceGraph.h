@@ -0,0 +1,85 @@
+#ifndef KATANA_LIBGPU_KATANA_GPU_DEVICEGRAPH_H_
+#define KATANA_LIBGPU_KATANA_GPU_DEVICEGRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana::gpu {
+
+/// Host to device copies are staged through pinned buffers of this many
+/// bytes, so that filling one buffer overlaps the transfer of the other
+constexpr size_t kTransferBatchBytes = size_t{1} << 25;
+
+/// Copy bytes from host memory to device memory. Pinned memory (see
+/// PinnedMemory.h) is copied directly; pageable memory in batches of
+/// kTransferBatchBytes.
+KATANA_EXPORT Result<void> CopyToDevice(
+    void* device, const void* host, size_t bytes);
+
+/// Copy bytes from device memory to host memory
+KATANA_EXPORT Result<void> CopyToHost(
+    void* host, const void* device, size_t bytes);
+
+/// An allocation in the memory of the current device. This header does not
+/// need the CUDA headers, so that host code can hold device memory.
+class KATANA_EXPORT DeviceBuffer {
+public:
+  DeviceBuffer() = default;
+  DeviceBuffer(const DeviceBuffer&) = delete;
+  DeviceBuffer& operator=(const DeviceBuffer&) = delete;
+  DeviceBuffer(DeviceBuffer&& other) noexcept;
+  DeviceBuffer& operator=(DeviceBuffer&& other) noexcept;
+  ~DeviceBuffer();
+
+  /// \returns an uninitialized allocation of bytes
+  static Result<DeviceBuffer> Make(size_t bytes);
+
+  /// \returns an allocation holding a copy of bytes of host memory
+  static Result<DeviceBuffer> FromHost(const void* host, size_t bytes);
+
+  template <typename T>
+  static Result<DeviceBuffer> FromHost(const T* host, size_t num_values) {
+    return FromHost(static_cast<const void*>(host), num_values * sizeof(T));
+  }
+
+  /// Copy the whole allocation to host
+  Result<void> ToHost(void* host) const {
+    return CopyToHost(host, data_, size_);
+  }
+
+  void* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  template <typename T>
+  T* as() const {
+    return static_cast<T*>(data_);
+  }
+
+private:
+  void* data_{nullptr};
+  size_t size_{0};
+};
+
+/// A CSR topology in device memory, laid out as GraphTopology: the edges of
+/// node n are [adj_indices[n-1], adj_indices[n]) with adj_indices[-1] = 0
+struct KATANA_EXPORT DeviceTopology {
+  DeviceBuffer adj_indices;
+  DeviceBuffer dests;
+  uint32_t num_nodes{0};
+  uint64_t num_edges{0};
+
+  const uint64_t* adj_data() const { return adj_indices.as<uint64_t>(); }
+  const uint32_t* dest_data() const { return dests.as<uint32_t>(); }
+
+  /// Copy a host CSR topology to the device
+  static Result<DeviceTopology> Make(
+      const uint64_t* adj_indices, const uint32_t* dests, uint64_t num_nodes,
+      uint64_t num_edges);
+};
+
+}  // namespace katana::gpu
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef KATANA_LIBGPU_KATANA_GPU_PINNEDMEMORY_H_
+#define KATANA_LIBGPU_KATANA_GPU_PINNEDMEMORY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <arrow/memory_pool.h>
+
+#include "katana/HostAllocator.h"
+#include "katana/config.h"
+
+namespace katana::gpu {
+
+/// A HostHeap of page-locked host memory, which the device reads directly
+/// and copies asynchronously to and from. Page locking makes allocation
+/// slow, so containers with this heap should grow geometrically and be
+/// reused.
+///
+///     PODVector<uint64_t> adj(HostAllocator<uint64_t>(GetPinnedHostHeap()));
+class KATANA_EXPORT PinnedHostHeap : public HostHeap {
+public:
+  void* Malloc(const size_t n_bytes) override;
+  void* Calloc(const size_t n_items, const size_t item_size) override;
+  void* Realloc(void* ptr, const size_t new_bytes) override;
+  void Free(void* ptr) override;
+  bool IsFastAlloc() const override { return false; }
+
+  ~PinnedHostHeap() override;
+};
+
+KATANA_EXPORT HostHeap* GetPinnedHostHeap();
+
+inline HostAllocator<char>
+GetPinnedAllocator() {
+  return HostAllocator<char>(GetPinnedHostHeap());
+}
+
+/// An arrow::MemoryPool of page-locked host memory, so that the buffers of
+/// property columns built with it can be copied to the device
+/// asynchronously. Pass it to the arrow builders or to arrow::AllocateBuffer.
+class KATANA_EXPORT PinnedMemoryPool : public arrow::MemoryPool {
+public:
+  arrow::Status Allocate(int64_t size, uint8_t** out) override;
+  arrow::Status Reallocate(
+      int64_t old_size, int64_t new_size, uint8_t** ptr) override;
+  void Free(uint8_t* buffer, int64_t size) override;
+
+  int64_t bytes_allocated() const override { return bytes_allocated_; }
+  int64_t max_memory() const override { return max_memory_; }
+  std::string backend_name() const override { return "cuda_pinned"; }
+
+private:
+  void Record(int64_t diff);
+
+  std::atomic<int64_t> bytes_allocated_{0};
+  std::atomic<int64_t> max_memory_{0};
+};
+
+KATANA_EXPORT PinnedMemoryPool* GetPinnedMemoryPool();
+
+/// \returns true if ptr points into page-locked host memory, whether from
+/// this header or registered with the CUDA runtime elsewhere
+KATANA_EXPORT bool IsPinned(const void* ptr);
+
+}  // namespace katana::gpu
+
+#endif
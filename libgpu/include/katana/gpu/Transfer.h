@@ -0,0 +1,125 @@
+#ifndef KATANA_LIBGPU_KATANA_GPU_TRANSFER_H_
+#define KATANA_LIBGPU_KATANA_GPU_TRANSFER_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include <arrow/api.h>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "katana/gpu/DeviceGraph.h"
+
+namespace katana::gpu {
+
+/// A CUDA stream. This header does not need the CUDA headers; handle() is
+/// the cudaStream_t for code that does.
+class KATANA_EXPORT Stream {
+public:
+  Stream() = default;
+  Stream(const Stream&) = delete;
+  Stream& operator=(const Stream&) = delete;
+  Stream(Stream&& other) noexcept;
+  Stream& operator=(Stream&& other) noexcept;
+  ~Stream();
+
+  /// \returns a new non-blocking stream
+  static Result<Stream> Make();
+
+  /// Wait for the work enqueued on the stream so far
+  Result<void> Synchronize() const;
+
+  void* handle() const { return handle_; }
+
+private:
+  void* handle_{nullptr};
+};
+
+/// Enqueue a copy of bytes from host to device memory on stream. The copy
+/// is asynchronous only if host is pinned (see PinnedMemory.h); pageable
+/// memory is staged like CopyToDevice and copied before this returns.
+KATANA_EXPORT Result<void> CopyToDeviceAsync(
+    void* device, const void* host, size_t bytes, const Stream& stream);
+
+/// Enqueue a copy of bytes from device to host memory on stream, which is
+/// asynchronous with respect to the host only if host is pinned
+KATANA_EXPORT Result<void> CopyToHostAsync(
+    void* host, const void* device, size_t bytes, const Stream& stream);
+
+/// \returns a device copy of the values of array, which must have a fixed
+/// width type of whole bytes. The values of null slots are copied as they
+/// are; the validity bitmap is not. If stream is given, the copy is enqueued
+/// on it and the buffer must not be read before it is synchronized.
+KATANA_EXPORT Result<DeviceBuffer> ArrayToDevice(
+    const arrow::Array& array, const Stream* stream = nullptr);
+
+/// \returns a device copy of the values of the chunks of array laid out
+/// contiguously, as ArrayToDevice
+KATANA_EXPORT Result<DeviceBuffer> ChunkedArrayToDevice(
+    const arrow::ChunkedArray& array, const Stream* stream = nullptr);
+
+/// Streams host data to the device in batches while kernels consume them:
+/// the copy of batch i + 1 runs on a copy stream while batch i is processed
+/// on a compute stream. Two device buffers of batch_bytes are reused, and
+/// pageable input goes through two pinned staging buffers.
+///
+///     auto pipeline = KATANA_CHECKED(TransferPipeline::Make(1 << 24));
+///     KATANA_CHECKED(pipeline->Run(
+///         weights, num_edges,
+///         [&](const float* batch, size_t first, size_t count,
+///             const Stream& stream) -> Result<void> {
+///           // launch kernels on stream.handle()
+///         }));
+class KATANA_EXPORT TransferPipeline {
+public:
+  /// compute enqueues the work on a batch on stream and must not wait for
+  /// it; offset and bytes locate the batch in the input
+  using Compute = std::function<Result<void>(
+      const void* device_batch, size_t offset, size_t bytes,
+      const Stream& stream)>;
+
+  TransferPipeline(const TransferPipeline&) = delete;
+  TransferPipeline& operator=(const TransferPipeline&) = delete;
+  ~TransferPipeline();
+
+  static Result<std::unique_ptr<TransferPipeline>> Make(
+      size_t batch_bytes = kTransferBatchBytes);
+
+  /// Run compute on each batch of [host, host + bytes) and wait for the
+  /// last one. Batches hold a multiple of item_bytes.
+  Result<void> Run(
+      const void* host, size_t bytes, size_t item_bytes,
+      const Compute& compute);
+
+  template <typename T, typename F>
+  Result<void> Run(const T* host, size_t num_items, F&& compute) {
+    return Run(
+        host, num_items * sizeof(T), sizeof(T),
+        [&](const void* device_batch, size_t offset, size_t bytes,
+            const Stream& stream) -> Result<void> {
+          return compute(
+              static_cast<const T*>(device_batch), offset / sizeof(T),
+              bytes / sizeof(T), stream);
+        });
+  }
+
+  size_t batch_bytes() const { return batch_bytes_; }
+
+private:
+  explicit TransferPipeline(size_t batch_bytes) : batch_bytes_(batch_bytes) {}
+
+  size_t batch_bytes_;
+  DeviceBuffer buffers_[2];
+  void* staging_[2]{nullptr, nullptr};
+  Stream copy_stream_;
+  Stream compute_stream_;
+  /// cudaEvent_t: batch b has arrived in buffers_[b] and left staging_[b]
+  void* copied_[2]{nullptr, nullptr};
+  /// cudaEvent_t: the work on buffers_[b] is done
+  void* computed_[2]{nullptr, nullptr};
+};
+
+}  // namespace katana::gpu
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef KATANA_LIBGPU_CUDA_H_
+#define KATANA_LIBGPU_CUDA_H_
+
+#include <cuda_runtime.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Result.h"
+
+/// Return a GpuError from the enclosing function if the CUDA runtime call
+/// expr fails
+#define KATANA_CUDA_CHECKED(expr)                                              \
+  do {                                                                         \
+    cudaError_t katana_cuda_error_ = (expr);                                   \
+    if (katana_cuda_error_ != cudaSuccess) {                                   \
+      return KATANA_ERROR(                                                     \
+          katana::ErrorCode::GpuError, "{}: {}", #expr,                        \
+          cudaGetErrorString(katana_cuda_error_));                             \
+    }                                                                          \
+  } while (0)
+
+namespace katana::gpu {
+
+constexpr uint32_t kThreadsPerBlock = 256;
+constexpr uint32_t kWarpSize = 32;
+constexpr uint32_t kWarpsPerBlock = kThreadsPerBlock / kWarpSize;
+
+/// \returns the number of blocks of kThreadsPerBlock threads for a thread
+/// per item
+inline uint32_t
+BlocksFor(uint64_t num_items) {
+  return (num_items + kThreadsPerBlock - 1) / kThreadsPerBlock;
+}
+
+/// \returns the number of blocks for a warp per item
+inline uint32_t
+WarpBlocksFor(uint64_t num_items) {
+  return (num_items + kWarpsPerBlock - 1) / kWarpsPerBlock;
+}
+
+/// \returns whether the last kernel launch failed
+inline Result<void>
+CheckLaunch(const char* kernel) {
+  cudaError_t error = cudaGetLastError();
+  if (error != cudaSuccess) {
+    return KATANA_ERROR(
+        ErrorCode::GpuError, "launching {}: {}", kernel,
+        cudaGetErrorString(error));
+  }
+  return ResultSuccess();
+}
+
+__device__ inline uint64_t
+EdgeBegin(const uint64_t* adj_indices, uint32_t node) {
+  return node == 0 ? 0 : adj_indices[node - 1];
+}
+
+/// The id of the warp of the calling thread over the grid
+__device__ inline uint64_t
+GlobalWarp() {
+  return (uint64_t{blockIdx.x} * blockDim.x + threadIdx.x) / kWarpSize;
+}
+
+__device__ inline uint32_t
+Lane() {
+  return threadIdx.x % kWarpSize;
+}
+
+/// A single value in device memory, read back by the host between kernels
+template <typename T>
+class DeviceValue {
+public:
+  DeviceValue() = default;
+  DeviceValue(const DeviceValue&) = delete;
+  DeviceValue& operator=(const DeviceValue&) = delete;
+
+  Result<void> Init() {
+    KATANA_CUDA_CHECKED(cudaMalloc(&ptr_, sizeof(T)));
+    return ResultSuccess();
+  }
+
+  ~DeviceValue() { cudaFree(ptr_); }
+
+  T* get() const { return ptr_; }
+
+  Result<void> Set(T value) {
+    KATANA_CUDA_CHECKED(
+        cudaMemcpy(ptr_, &value, sizeof(T), cudaMemcpyHostToDevice));
+    return ResultSuccess();
+  }
+
+  Result<T> Get() const {
+    T value;
+    KATANA_CUDA_CHECKED(
+        cudaMemcpy(&value, ptr_, sizeof(T), cudaMemcpyDeviceToHost));
+    return value;
+  }
+
+private:
+  T* ptr_{nullptr};
+};
+
+}  // namespace katana::gpu
+
+#endif
@@ -0,0 +1,162 @@
+#include "katana/gpu/DeviceGraph.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+#include "Cuda.h"
+#include "katana/gpu/PinnedMemory.h"
+
+namespace {
+
+/// Two pinned host buffers, each with a stream that copies it to the
+/// device, shared by all host to device copies of the process
+class Staging {
+public:
+  static Staging& Get() {
+    static Staging staging;
+    return staging;
+  }
+
+  std::mutex& mutex() { return mutex_; }
+
+  /// \returns false if pinned memory could not be allocated, in which case
+  /// copies go through the CUDA runtime's own staging
+  bool Init() {
+    if (initialized_) {
+      return buffers_[0] != nullptr;
+    }
+    initialized_ = true;
+    for (size_t i = 0; i < 2; ++i) {
+      if (cudaMallocHost(&buffers_[i], katana::gpu::kTransferBatchBytes) !=
+              cudaSuccess ||
+          cudaStreamCreate(&streams_[i]) != cudaSuccess) {
+        Release();
+        cudaGetLastError();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void* buffer(size_t i) const { return buffers_[i]; }
+  cudaStream_t stream(size_t i) const { return streams_[i]; }
+
+  ~Staging() { Release(); }
+
+private:
+  void Release() {
+    for (size_t i = 0; i < 2; ++i) {
+      if (buffers_[i]) {
+        cudaFreeHost(buffers_[i]);
+        buffers_[i] = nullptr;
+      }
+      if (streams_[i]) {
+        cudaStreamDestroy(streams_[i]);
+        streams_[i] = nullptr;
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  bool initialized_{false};
+  void* buffers_[2]{nullptr, nullptr};
+  cudaStream_t streams_[2]{nullptr, nullptr};
+};
+
+}  // namespace
+
+katana::Result<void>
+katana::gpu::CopyToDevice(void* device, const void* host, size_t bytes) {
+  Staging& staging = Staging::Get();
+  std::lock_guard<std::mutex> lock(staging.mutex());
+  if (bytes <= kTransferBatchBytes || IsPinned(host) || !staging.Init()) {
+    KATANA_CUDA_CHECKED(
+        cudaMemcpy(device, host, bytes, cudaMemcpyHostToDevice));
+    return ResultSuccess();
+  }
+
+  // Batch i is copied into buffer i % 2 while the other buffer is on its
+  // way to the device
+  auto* dst = static_cast<char*>(device);
+  const auto* src = static_cast<const char*>(host);
+  for (size_t offset = 0, i = 0; offset < bytes;
+       offset += kTransferBatchBytes, ++i) {
+    size_t batch = std::min(kTransferBatchBytes, bytes - offset);
+    size_t b = i % 2;
+    KATANA_CUDA_CHECKED(cudaStreamSynchronize(staging.stream(b)));
+    std::memcpy(staging.buffer(b), src + offset, batch);
+    KATANA_CUDA_CHECKED(cudaMemcpyAsync(
+        dst + offset, staging.buffer(b), batch, cudaMemcpyHostToDevice,
+        staging.stream(b)));
+  }
+  KATANA_CUDA_CHECKED(cudaStreamSynchronize(staging.stream(0)));
+  KATANA_CUDA_CHECKED(cudaStreamSynchronize(staging.stream(1)));
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::gpu::CopyToHost(void* host, const void* device, size_t bytes) {
+  KATANA_CUDA_CHECKED(cudaMemcpy(host, device, bytes, cudaMemcpyDeviceToHost));
+  return ResultSuccess();
+}
+
+katana::gpu::DeviceBuffer::DeviceBuffer(DeviceBuffer&& other) noexcept
+    : data_(other.data_), size_(other.size_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+katana::gpu::DeviceBuffer&
+katana::gpu::DeviceBuffer::operator=(DeviceBuffer&& other) noexcept {
+  if (this != &other) {
+    cudaFree(data_);
+    data_ = other.data_;
+    size_ = other.size_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+katana::gpu::DeviceBuffer::~DeviceBuffer() { cudaFree(data_); }
+
+katana::Result<katana::gpu::DeviceBuffer>
+katana::gpu::DeviceBuffer::Make(size_t bytes) {
+  DeviceBuffer buffer;
+  // Allocate at least a byte so that empty graphs have valid pointers
+  cudaError_t error = cudaMalloc(&buffer.data_, std::max<size_t>(bytes, 1));
+  if (error != cudaSuccess) {
+    return KATANA_ERROR(
+        ErrorCode::OutOfMemory, "allocating {} bytes on the device: {}", bytes,
+        cudaGetErrorString(error));
+  }
+  buffer.size_ = bytes;
+  return buffer;
+}
+
+katana::Result<katana::gpu::DeviceBuffer>
+katana::gpu::DeviceBuffer::FromHost(const void* host, size_t bytes) {
+  DeviceBuffer buffer = KATANA_CHECKED(Make(bytes));
+  KATANA_CHECKED(CopyToDevice(buffer.data(), host, bytes));
+  return buffer;
+}
+
+katana::Result<katana::gpu::DeviceTopology>
+katana::gpu::DeviceTopology::Make(
+    const uint64_t* adj_indices, const uint32_t* dests, uint64_t num_nodes,
+    uint64_t num_edges) {
+  if (num_nodes > std::numeric_limits<uint32_t>::max()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "too many nodes for the device: {}",
+        num_nodes);
+  }
+  DeviceTopology topo;
+  topo.num_nodes = num_nodes;
+  topo.num_edges = num_edges;
+  topo.adj_indices =
+      KATANA_CHECKED(DeviceBuffer::FromHost(adj_indices, num_nodes));
+  topo.dests = KATANA_CHECKED(DeviceBuffer::FromHost(dests, num_edges));
+  return topo;
+}
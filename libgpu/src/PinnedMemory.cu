@@ -0,0 +1,128 @@
+#include "katana/gpu/PinnedMemory.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Cuda.h"
+
+namespace {
+
+/// PinnedHostHeap keeps the size of each allocation in a header before it,
+/// since Realloc must copy the old contents. The header keeps the cache line
+/// alignment of cudaMallocHost.
+constexpr size_t kHeaderBytes = 64;
+
+size_t&
+AllocationSize(void* ptr) {
+  return *reinterpret_cast<size_t*>(static_cast<char*>(ptr) - kHeaderBytes);
+}
+
+}  // namespace
+
+void*
+katana::gpu::PinnedHostHeap::Malloc(const size_t n_bytes) {
+  void* base = nullptr;
+  if (cudaMallocHost(&base, n_bytes + kHeaderBytes) != cudaSuccess) {
+    cudaGetLastError();
+    return nullptr;
+  }
+  void* ptr = static_cast<char*>(base) + kHeaderBytes;
+  AllocationSize(ptr) = n_bytes;
+  return ptr;
+}
+
+void*
+katana::gpu::PinnedHostHeap::Calloc(
+    const size_t n_items, const size_t item_size) {
+  size_t n_bytes = n_items * item_size;
+  void* ptr = Malloc(n_bytes);
+  if (ptr) {
+    std::memset(ptr, 0, n_bytes);
+  }
+  return ptr;
+}
+
+void*
+katana::gpu::PinnedHostHeap::Realloc(void* ptr, const size_t new_bytes) {
+  void* new_ptr = Malloc(new_bytes);
+  if (new_ptr && ptr) {
+    std::memcpy(new_ptr, ptr, std::min(AllocationSize(ptr), new_bytes));
+    Free(ptr);
+  }
+  return new_ptr;
+}
+
+void
+katana::gpu::PinnedHostHeap::Free(void* ptr) {
+  if (ptr) {
+    cudaFreeHost(static_cast<char*>(ptr) - kHeaderBytes);
+  }
+}
+
+katana::gpu::PinnedHostHeap::~PinnedHostHeap() = default;
+
+katana::HostHeap*
+katana::gpu::GetPinnedHostHeap() {
+  static PinnedHostHeap pinned_host_heap;
+  return &pinned_host_heap;
+}
+
+arrow::Status
+katana::gpu::PinnedMemoryPool::Allocate(int64_t size, uint8_t** out) {
+  if (size < 0) {
+    return arrow::Status::Invalid("negative allocation size");
+  }
+  // Arrow hands out a shared address for empty buffers; any valid pinned
+  // address does
+  cudaError_t error =
+      cudaMallocHost(reinterpret_cast<void**>(out), std::max<int64_t>(size, 1));
+  if (error != cudaSuccess) {
+    cudaGetLastError();
+    return arrow::Status::OutOfMemory(
+        "pinning ", size, " bytes: ", cudaGetErrorString(error));
+  }
+  Record(size);
+  return arrow::Status::OK();
+}
+
+arrow::Status
+katana::gpu::PinnedMemoryPool::Reallocate(
+    int64_t old_size, int64_t new_size, uint8_t** ptr) {
+  uint8_t* new_ptr = nullptr;
+  ARROW_RETURN_NOT_OK(Allocate(new_size, &new_ptr));
+  std::memcpy(new_ptr, *ptr, std::min(old_size, new_size));
+  Free(*ptr, old_size);
+  *ptr = new_ptr;
+  return arrow::Status::OK();
+}
+
+void
+katana::gpu::PinnedMemoryPool::Free(uint8_t* buffer, int64_t size) {
+  cudaFreeHost(buffer);
+  Record(-size);
+}
+
+void
+katana::gpu::PinnedMemoryPool::Record(int64_t diff) {
+  int64_t allocated = bytes_allocated_.fetch_add(diff) + diff;
+  int64_t max = max_memory_.load();
+  while (allocated > max &&
+         !max_memory_.compare_exchange_weak(max, allocated)) {
+  }
+}
+
+katana::gpu::PinnedMemoryPool*
+katana::gpu::GetPinnedMemoryPool() {
+  static PinnedMemoryPool pinned_memory_pool;
+  return &pinned_memory_pool;
+}
+
+bool
+katana::gpu::IsPinned(const void* ptr) {
+  cudaPointerAttributes attributes;
+  if (cudaPointerGetAttributes(&attributes, ptr) != cudaSuccess) {
+    cudaGetLastError();
+    return false;
+  }
+  return attributes.type == cudaMemoryTypeHost;
+}
@@ -0,0 +1,229 @@
+#include "katana/gpu/Transfer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Cuda.h"
+#include "katana/gpu/PinnedMemory.h"
+
+namespace {
+
+cudaStream_t
+Handle(const katana::gpu::Stream& stream) {
+  return static_cast<cudaStream_t>(stream.handle());
+}
+
+cudaEvent_t
+Event(void* event) {
+  return static_cast<cudaEvent_t>(event);
+}
+
+/// \returns the address and size of the values of array
+katana::Result<std::pair<const uint8_t*, size_t>>
+Values(const arrow::Array& array) {
+  const auto* type =
+      dynamic_cast<const arrow::FixedWidthType*>(array.type().get());
+  if (!type || type->bit_width() % 8 != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "only fixed width types of whole bytes can be copied to the device: "
+        "{}",
+        array.type()->ToString());
+  }
+  size_t byte_width = type->bit_width() / 8;
+  const auto& values = array.data()->buffers[1];
+  if (array.length() == 0 || !values) {
+    return std::make_pair(static_cast<const uint8_t*>(nullptr), size_t{0});
+  }
+  return std::make_pair(
+      values->data() + array.offset() * byte_width,
+      array.length() * byte_width);
+}
+
+}  // namespace
+
+katana::gpu::Stream::Stream(Stream&& other) noexcept : handle_(other.handle_) {
+  other.handle_ = nullptr;
+}
+
+katana::gpu::Stream&
+katana::gpu::Stream::operator=(Stream&& other) noexcept {
+  if (this != &other) {
+    if (handle_) {
+      cudaStreamDestroy(Handle(*this));
+    }
+    handle_ = other.handle_;
+    other.handle_ = nullptr;
+  }
+  return *this;
+}
+
+katana::gpu::Stream::~Stream() {
+  if (handle_) {
+    cudaStreamDestroy(Handle(*this));
+  }
+}
+
+katana::Result<katana::gpu::Stream>
+katana::gpu::Stream::Make() {
+  Stream stream;
+  cudaStream_t handle;
+  KATANA_CUDA_CHECKED(
+      cudaStreamCreateWithFlags(&handle, cudaStreamNonBlocking));
+  stream.handle_ = handle;
+  return stream;
+}
+
+katana::Result<void>
+katana::gpu::Stream::Synchronize() const {
+  KATANA_CUDA_CHECKED(cudaStreamSynchronize(Handle(*this)));
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::gpu::CopyToDeviceAsync(
+    void* device, const void* host, size_t bytes, const Stream& stream) {
+  if (!IsPinned(host)) {
+    // Ordered after the work already on stream
+    KATANA_CHECKED(stream.Synchronize());
+    return CopyToDevice(device, host, bytes);
+  }
+  KATANA_CUDA_CHECKED(cudaMemcpyAsync(
+      device, host, bytes, cudaMemcpyHostToDevice, Handle(stream)));
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::gpu::CopyToHostAsync(
+    void* host, const void* device, size_t bytes, const Stream& stream) {
+  KATANA_CUDA_CHECKED(cudaMemcpyAsync(
+      host, device, bytes, cudaMemcpyDeviceToHost, Handle(stream)));
+  return ResultSuccess();
+}
+
+katana::Result<katana::gpu::DeviceBuffer>
+katana::gpu::ArrayToDevice(const arrow::Array& array, const Stream* stream) {
+  auto [values, bytes] = KATANA_CHECKED(Values(array));
+  DeviceBuffer buffer = KATANA_CHECKED(DeviceBuffer::Make(bytes));
+  if (bytes == 0) {
+    return buffer;
+  }
+  if (stream) {
+    KATANA_CHECKED(CopyToDeviceAsync(buffer.data(), values, bytes, *stream));
+  } else {
+    KATANA_CHECKED(CopyToDevice(buffer.data(), values, bytes));
+  }
+  return buffer;
+}
+
+katana::Result<katana::gpu::DeviceBuffer>
+katana::gpu::ChunkedArrayToDevice(
+    const arrow::ChunkedArray& array, const Stream* stream) {
+  size_t total_bytes = 0;
+  for (const auto& chunk : array.chunks()) {
+    total_bytes += KATANA_CHECKED(Values(*chunk)).second;
+  }
+  DeviceBuffer buffer = KATANA_CHECKED(DeviceBuffer::Make(total_bytes));
+  auto* dst = buffer.as<uint8_t>();
+  for (const auto& chunk : array.chunks()) {
+    auto [values, bytes] = KATANA_CHECKED(Values(*chunk));
+    if (bytes == 0) {
+      continue;
+    }
+    if (stream) {
+      KATANA_CHECKED(CopyToDeviceAsync(dst, values, bytes, *stream));
+    } else {
+      KATANA_CHECKED(CopyToDevice(dst, values, bytes));
+    }
+    dst += bytes;
+  }
+  return buffer;
+}
+
+katana::gpu::TransferPipeline::~TransferPipeline() {
+  // Buffers must outlive the work queued on them
+  if (compute_stream_.handle()) {
+    cudaStreamSynchronize(Handle(compute_stream_));
+  }
+  if (copy_stream_.handle()) {
+    cudaStreamSynchronize(Handle(copy_stream_));
+  }
+  for (size_t b = 0; b < 2; ++b) {
+    GetPinnedHostHeap()->Free(staging_[b]);
+    if (copied_[b]) {
+      cudaEventDestroy(Event(copied_[b]));
+    }
+    if (computed_[b]) {
+      cudaEventDestroy(Event(computed_[b]));
+    }
+  }
+}
+
+katana::Result<std::unique_ptr<katana::gpu::TransferPipeline>>
+katana::gpu::TransferPipeline::Make(size_t batch_bytes) {
+  if (batch_bytes == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "batches must not be empty");
+  }
+  std::unique_ptr<TransferPipeline> pipeline(
+      new TransferPipeline(batch_bytes));
+  pipeline->copy_stream_ = KATANA_CHECKED(Stream::Make());
+  pipeline->compute_stream_ = KATANA_CHECKED(Stream::Make());
+  for (size_t b = 0; b < 2; ++b) {
+    pipeline->buffers_[b] = KATANA_CHECKED(DeviceBuffer::Make(batch_bytes));
+    pipeline->staging_[b] = GetPinnedHostHeap()->Malloc(batch_bytes);
+    if (!pipeline->staging_[b]) {
+      return KATANA_ERROR(
+          ErrorCode::OutOfMemory, "pinning {} bytes of staging", batch_bytes);
+    }
+    cudaEvent_t copied;
+    cudaEvent_t computed;
+    KATANA_CUDA_CHECKED(
+        cudaEventCreateWithFlags(&copied, cudaEventDisableTiming));
+    pipeline->copied_[b] = copied;
+    KATANA_CUDA_CHECKED(
+        cudaEventCreateWithFlags(&computed, cudaEventDisableTiming));
+    pipeline->computed_[b] = computed;
+  }
+  return pipeline;
+}
+
+katana::Result<void>
+katana::gpu::TransferPipeline::Run(
+    const void* host, size_t bytes, size_t item_bytes,
+    const Compute& compute) {
+  size_t batch = batch_bytes_ - batch_bytes_ % item_bytes;
+  if (batch == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "items of {} bytes exceed batches of {}",
+        item_bytes, batch_bytes_);
+  }
+  bool pinned = IsPinned(host);
+  const auto* src = static_cast<const char*>(host);
+  for (size_t offset = 0, i = 0; offset < bytes; offset += batch, ++i) {
+    size_t b = i % 2;
+    size_t size = std::min(batch, bytes - offset);
+    // buffers_[b] is free once the work on batch i - 2 is done
+    KATANA_CUDA_CHECKED(cudaStreamWaitEvent(
+        Handle(copy_stream_), Event(computed_[b]), 0));
+    const void* from = src + offset;
+    if (!pinned) {
+      // and staging_[b] once batch i - 2 has left it
+      KATANA_CUDA_CHECKED(cudaEventSynchronize(Event(copied_[b])));
+      std::memcpy(staging_[b], from, size);
+      from = staging_[b];
+    }
+    KATANA_CUDA_CHECKED(cudaMemcpyAsync(
+        buffers_[b].data(), from, size, cudaMemcpyHostToDevice,
+        Handle(copy_stream_)));
+    KATANA_CUDA_CHECKED(
+        cudaEventRecord(Event(copied_[b]), Handle(copy_stream_)));
+
+    KATANA_CUDA_CHECKED(cudaStreamWaitEvent(
+        Handle(compute_stream_), Event(copied_[b]), 0));
+    KATANA_CHECKED(compute(buffers_[b].data(), offset, size, compute_stream_));
+    KATANA_CUDA_CHECKED(
+        cudaEventRecord(Event(computed_[b]), Handle(compute_stream_)));
+  }
+  return compute_stream_.Synchronize();
+}
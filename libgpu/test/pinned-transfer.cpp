@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Logging.h"
+#include "katana/PODVector.h"
+#include "katana/gpu/PinnedMemory.h"
+#include "katana/gpu/Transfer.h"
+
+namespace {
+
+template <typename T>
+T
+Unwrap(katana::Result<T>&& result) {
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  return std::move(result.value());
+}
+
+/// Stream values through a pipeline with batches of a prime number of bytes
+/// and copy each batch back, which checks that every batch arrives before
+/// the compute stream reads it and stays until the copy back is done
+void
+TestPipeline(const uint64_t* values, size_t num_values) {
+  auto pipeline = Unwrap(katana::gpu::TransferPipeline::Make(8191));
+  std::vector<uint64_t> copied(num_values, 0);
+  auto result = pipeline->Run(
+      values, num_values,
+      [&](const uint64_t* batch, size_t first, size_t count,
+          const katana::gpu::Stream& stream) -> katana::Result<void> {
+        return katana::gpu::CopyToHostAsync(
+            copied.data() + first, batch, count * sizeof(uint64_t), stream);
+      });
+  KATANA_LOG_VASSERT(result, "pipeline failed: {}", result.error());
+  for (size_t i = 0; i < num_values; ++i) {
+    KATANA_LOG_VASSERT(
+        copied[i] == values[i], "value {} is {}, expected {}", i, copied[i],
+        values[i]);
+  }
+}
+
+void
+TestPinnedHostHeap() {
+  katana::PODVector<uint64_t> pinned(
+      katana::HostAllocator<uint64_t>(katana::gpu::GetPinnedHostHeap()));
+  // Grow through several reallocations
+  for (uint64_t i = 0; i < 100000; ++i) {
+    pinned.push_back(i);
+  }
+  KATANA_LOG_ASSERT(katana::gpu::IsPinned(pinned.data()));
+  TestPipeline(pinned.data(), pinned.size());
+}
+
+void
+TestPageable() {
+  std::vector<uint64_t> pageable(100000);
+  std::iota(pageable.begin(), pageable.end(), 7);
+  KATANA_LOG_ASSERT(!katana::gpu::IsPinned(pageable.data()));
+  TestPipeline(pageable.data(), pageable.size());
+}
+
+void
+TestArrowPool() {
+  arrow::UInt32Builder builder(katana::gpu::GetPinnedMemoryPool());
+  for (uint32_t i = 0; i < 5000; ++i) {
+    KATANA_LOG_ASSERT(builder.Append(i * 3).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  KATANA_LOG_ASSERT(katana::gpu::GetPinnedMemoryPool()->bytes_allocated() > 0);
+
+  // A slice checks that the offset of the array is applied
+  auto slice = array->Slice(100, 4000);
+  auto stream = Unwrap(katana::gpu::Stream::Make());
+  auto device = Unwrap(katana::gpu::ArrayToDevice(*slice, &stream));
+  std::vector<uint32_t> copied(4000);
+  KATANA_LOG_ASSERT(katana::gpu::CopyToHostAsync(
+      copied.data(), device.data(), device.size(), stream));
+  KATANA_LOG_ASSERT(stream.Synchronize());
+  for (uint32_t i = 0; i < copied.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        copied[i] == (i + 100) * 3, "value {} is {}", i, copied[i]);
+  }
+
+  auto chunked = std::make_shared<arrow::ChunkedArray>(
+      arrow::ArrayVector{array->Slice(0, 10), array->Slice(4990, 10)});
+  auto chunks = Unwrap(katana::gpu::ChunkedArrayToDevice(*chunked));
+  KATANA_LOG_ASSERT(chunks.size() == 20 * sizeof(uint32_t));
+  KATANA_LOG_ASSERT(chunks.ToHost(copied.data()));
+  KATANA_LOG_ASSERT(copied[9] == 27 && copied[10] == 4990 * 3);
+
+  arrow::BooleanBuilder bools;
+  KATANA_LOG_ASSERT(bools.Append(true).ok());
+  std::shared_ptr<arrow::Array> bool_array;
+  KATANA_LOG_ASSERT(bools.Finish(&bool_array).ok());
+  KATANA_LOG_ASSERT(!katana::gpu::ArrayToDevice(*bool_array));
+}
+
+}  // namespace
+
+int
+main() {
+  TestPinnedHostHeap();
+  TestPageable();
+  TestArrowPool();
+  return 0;
+}
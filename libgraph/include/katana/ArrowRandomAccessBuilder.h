@@ -1,60 +1,137 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ARROWRANDOMACCESSBUILDER_H_
+#define KATANA_LIBGRAPH_KATANA_ARROWRANDOMACCESSBUILDER_H_
+
+#include <algorithm>
+
 #include <arrow/api.h>
+#include <arrow/util/bit_util.h>
 
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
+#include "katana/Loops.h"
 #include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
 #include "katana/Properties.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
 
 namespace katana {
 
 namespace {
 
-/// NoNullBuilder uses std::vector for storage
-/// Finalize() makes a copy of the data
-/// Does not support null values
-template <typename ValueType, typename StorageType, typename ArrowType>
-class NoNullBuilder {
+/// FixedWidthBuilder writes values in place into an arrow::Buffer allocated
+/// up front, and Finalize() makes an array of that buffer without copying
+/// it, so the array shares the buffer with the builder.
+///
+/// When nullable, validity is tracked with a byte per element, so that
+/// concurrent writes to neighboring elements do not race, and Finalize()
+/// packs it into a validity bitmap in parallel; an array with no nulls has
+/// no bitmap. Otherwise, every element is valid.
+template <typename ValueType, typename ArrowType, bool kNullable>
+class FixedWidthBuilder {
 public:
   using value_type = ValueType;
   using reference = ValueType&;
 
-  NoNullBuilder(size_t length) : data_(length) {
-    static_assert(sizeof(ValueType) == sizeof(StorageType));
+  FixedWidthBuilder(size_t length)
+      : values_(AllocateValues(length)), length_(length) {
+    static_assert(
+        sizeof(ValueType) ==
+        sizeof(typename arrow::TypeTraits<ArrowType>::CType));
+    if constexpr (kNullable) {
+      valid_.allocateBlocked(length);
+      katana::ParallelSTL::fill(valid_.begin(), valid_.end(), uint8_t{0});
+    }
   }
 
+  // NOTE this operator has side-effects when nullable. It can safely be used
+  // in two ways:
+  // 1) builder[index] = value; where it creates a non-null entry
+  // 2) value = builder[index]; ONLY IF option 1 has already used that index
   reference operator[](size_t index) {
     KATANA_LOG_DEBUG_VASSERT(
         index < size(), "index: {}, size: {}", index, size());
-    return static_cast<ValueType*>(data_.data())[index];
+    if constexpr (kNullable) {
+      valid_[index] = 1;
+    }
+    return data()[index];
   }
 
-  bool IsValid(size_t) { return true; }
+  void UnsetValue(size_t index) {
+    static_assert(kNullable, "every value of the builder is valid");
+    KATANA_LOG_DEBUG_ASSERT(index < size());
+    valid_[index] = 0;
+  }
 
-  size_t size() const { return data_.size(); }
+  bool IsValid(size_t index) {
+    if constexpr (kNullable) {
+      return valid_[index];
+    }
+    return true;
+  }
+
+  /// The values, for writing in bulk; writes through data() do not make
+  /// elements valid
+  ValueType* data() {
+    return reinterpret_cast<ValueType*>(values_->mutable_data());
+  }
+
+  size_t size() const { return length_; }
 
   katana::Result<std::shared_ptr<arrow::Array>> Finalize() const {
-    using ArrowBuilder = typename arrow::TypeTraits<ArrowType>::BuilderType;
-    ArrowBuilder builder;
-    if (data_.size() > 0) {
-      if (auto r = builder.AppendValues(data_); !r.ok()) {
-        KATANA_LOG_DEBUG("arrow error: {}", r);
-        return katana::ErrorCode::ArrowError;
-      }
+    std::shared_ptr<arrow::Buffer> bitmap;
+    int64_t null_count = 0;
+    if constexpr (kNullable) {
+      bitmap = KATANA_CHECKED(PackValidity(&null_count));
     }
-    std::shared_ptr<arrow::Array> array;
-    if (auto r = builder.Finish(&array); !r.ok()) {
-      KATANA_LOG_DEBUG("arrow error: {}", r);
-      return katana::ErrorCode::ArrowError;
-    }
-    return array;
+    return arrow::MakeArray(arrow::ArrayData::Make(
+        arrow::TypeTraits<ArrowType>::type_singleton(), length_,
+        {null_count > 0 ? bitmap : nullptr, values_}, null_count));
   }
 
 private:
-  std::vector<StorageType> data_;
+  static std::shared_ptr<arrow::Buffer> AllocateValues(size_t length) {
+    auto res = arrow::AllocateBuffer(length * sizeof(ValueType));
+    if (!res.ok()) {
+      KATANA_LOG_FATAL(
+          "failed to allocate {} values: {}", length, res.status());
+    }
+    return std::move(res).ValueOrDie();
+  }
+
+  katana::Result<std::shared_ptr<arrow::Buffer>> PackValidity(
+      int64_t* null_count) const {
+    size_t num_bytes = arrow::BitUtil::BytesForBits(length_);
+    std::shared_ptr<arrow::Buffer> bitmap =
+        KATANA_CHECKED(arrow::AllocateBuffer(num_bytes));
+    uint8_t* bits = bitmap->mutable_data();
+    katana::GAccumulator<int64_t> nulls;
+    katana::do_all(
+        katana::iterate(size_t{0}, num_bytes),
+        [&](size_t byte) {
+          uint8_t packed = 0;
+          size_t end = std::min(8 * byte + 8, length_);
+          for (size_t i = 8 * byte; i < end; ++i) {
+            if (valid_[i]) {
+              packed |= arrow::BitUtil::kBitmask[i % 8];
+            } else {
+              nulls += 1;
+            }
+          }
+          bits[byte] = packed;
+        },
+        katana::no_stats());
+    *null_count = nulls.reduce();
+    return bitmap;
+  }
+
+  std::shared_ptr<arrow::Buffer> values_;
+  size_t length_;
+  NUMAArray<uint8_t> valid_;
 };
 
-/// NullableBuilder uses std::vector for storage
+/// NullableBuilder uses std::vector for storage, for types whose arrays do
+/// not store one value of ValueType per element
 /// Finalize() makes a copy of the data
 /// Supports null values
 template <typename ValueType, typename StorageType, typename ArrowType>
@@ -86,7 +163,7 @@ public:
 
   size_t size() const { return data_.size(); }
 
-  katana::Result<void> Finalize(std::shared_ptr<arrow::Array>* array) const {
+  katana::Result<std::shared_ptr<arrow::Array>> Finalize() const {
     using ArrowBuilder = typename arrow::TypeTraits<ArrowType>::BuilderType;
     ArrowBuilder builder;
     if (data_.size() > 0) {
@@ -113,11 +190,12 @@ public:
         }
       }
     }
-    if (auto r = builder.Finish(array); !r.ok()) {
+    std::shared_ptr<arrow::Array> array;
+    if (auto r = builder.Finish(&array); !r.ok()) {
       KATANA_LOG_DEBUG("arrow error: {}", r);
       return katana::ErrorCode::ArrowError;
     }
-    return katana::ResultSuccess();
+    return array;
   }
 
 private:
@@ -128,46 +206,59 @@ private:
 template <typename ArrowType>
 struct ArrowTypeConfig;
 
+#define FIXED_WIDTH(ValueType, ArrowType)                                      \
+  template <>                                                                  \
+  struct ArrowTypeConfig<ArrowType> {                                          \
+    using RandomBuilderType = FixedWidthBuilder<ValueType, ArrowType, true>;   \
+    using NoNullBuilderType = FixedWidthBuilder<ValueType, ArrowType, false>;  \
+  }
+
+// There is no builder without nulls for these types
 #define NULLABLE(ValueType, StorageType, ArrowType)                            \
   template <>                                                                  \
   struct ArrowTypeConfig<ArrowType> {                                          \
     using RandomBuilderType =                                                  \
         NullableBuilder<ValueType, StorageType, ArrowType>;                    \
+    using NoNullBuilderType = void;                                            \
   }
 
-NULLABLE(int8_t, int8_t, arrow::Int8Type);
-NULLABLE(uint8_t, uint8_t, arrow::UInt8Type);
-NULLABLE(int16_t, int16_t, arrow::Int16Type);
-NULLABLE(uint16_t, uint16_t, arrow::UInt16Type);
-NULLABLE(int32_t, int32_t, arrow::Int32Type);
-NULLABLE(uint32_t, uint32_t, arrow::UInt32Type);
-NULLABLE(int64_t, int64_t, arrow::Int64Type);
-NULLABLE(uint64_t, uint64_t, arrow::UInt64Type);
-NULLABLE(float, float, arrow::FloatType);
-NULLABLE(double, double, arrow::DoubleType);
+FIXED_WIDTH(int8_t, arrow::Int8Type);
+FIXED_WIDTH(uint8_t, arrow::UInt8Type);
+FIXED_WIDTH(int16_t, arrow::Int16Type);
+FIXED_WIDTH(uint16_t, arrow::UInt16Type);
+FIXED_WIDTH(int32_t, arrow::Int32Type);
+FIXED_WIDTH(uint32_t, arrow::UInt32Type);
+FIXED_WIDTH(int64_t, arrow::Int64Type);
+FIXED_WIDTH(uint64_t, arrow::UInt64Type);
+FIXED_WIDTH(float, arrow::FloatType);
+FIXED_WIDTH(double, arrow::DoubleType);
 NULLABLE(bool, uint8_t, arrow::BooleanType);
 NULLABLE(std::string, std::string, arrow::StringType);
 NULLABLE(std::string, std::string, arrow::LargeStringType);
 
 #undef NULLABLE
+#undef FIXED_WIDTH
 
 }  // namespace
 
 /// ArrowRandomAccessBuilder encapsulates the concept of building
 /// an arrow::Array from <index, value> pairs arriving in unknown order
-/// Functions as a wrapper for NullableBuilder currently, TODO(danielmawhirter)
-template <typename ArrowType>
+///
+/// Values of numeric types are written in place into the buffer of the
+/// array, so Finalize() copies nothing and the array can be added to a
+/// graph as it is. Without kNullable, which numeric types support, every
+/// element is valid and no validity is tracked.
+template <typename ArrowType, bool kNullable = true>
 class ArrowRandomAccessBuilder {
 public:
-  using RandomBuilderType =
-      typename ArrowTypeConfig<ArrowType>::RandomBuilderType;
+  using RandomBuilderType = std::conditional_t<
+      kNullable, typename ArrowTypeConfig<ArrowType>::RandomBuilderType,
+      typename ArrowTypeConfig<ArrowType>::NoNullBuilderType>;
   using value_type = typename RandomBuilderType::value_type;
 
   ArrowRandomAccessBuilder(size_t length) : builder_(length) {}
 
-  void SetValue(size_t index, value_type value) {
-    builder_.SetValue(index, value);
-  }
+  void SetValue(size_t index, value_type value) { builder_[index] = value; }
 
   void UnsetValue(size_t index) { builder_.UnsetValue(index); }
 
@@ -175,17 +266,17 @@ public:
 
   bool IsValid(size_t index) { return builder_.IsValid(index); }
 
+  /// The values of a numeric builder, for writing in bulk; see
+  /// FixedWidthBuilder::data
+  value_type* data() { return builder_.data(); }
+
   katana::Result<void> Finalize(std::shared_ptr<arrow::Array>* array) {
-    return builder_.Finalize(array);
+    *array = KATANA_CHECKED(builder_.Finalize());
+    return katana::ResultSuccess();
   }
 
   katana::Result<std::shared_ptr<arrow::Array>> Finalize() {
-    std::shared_ptr<arrow::Array> array;
-    auto res = Finalize(&array);
-    if (!res) {
-      return res.error();
-    }
-    return array;
+    return builder_.Finalize();
   }
 
   size_t size() const { return builder_.size(); }
@@ -195,3 +286,5 @@ private:
 };
 
 }  // namespace katana
+
+#endif
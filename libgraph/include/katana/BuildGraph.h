@@ -7,6 +7,7 @@
 
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <utility>
 #include <variant>
@@ -97,6 +98,14 @@ struct LabelRule {
   LabelRule(const std::string& label) : LabelRule(label, false, false, label) {}
 };
 
+/// The columns of a graph, as inferred by a scan of its input before it is
+/// built. Applying the schema to a builder creates every column up front,
+/// in a fixed order, so that the build only appends to them.
+struct ImportSchema {
+  std::vector<PropertyKey> keys;
+  std::vector<LabelRule> labels;
+};
+
 struct PropertiesState {
   std::unordered_map<std::string, size_t> keys;
   ArrowFields schema;
@@ -216,6 +225,11 @@ public:
   size_t AddLabelBuilder(const LabelRule& rule);
   size_t AddBuilder(const PropertyKey& key);
 
+  /// Add the columns of schema that are not already present, in order
+  void ApplySchema(const ImportSchema& schema);
+  /// Reserve the topology for num_nodes nodes and num_edges edges
+  void Reserve(size_t num_nodes, size_t num_edges);
+
   void AddValue(
       const std::string& id, std::function<PropertyKey()> ProcessElement,
       std::function<ImportData(ImportDataType, bool)> ResolveValue);
@@ -228,8 +242,36 @@ public:
   size_t GetEdges();
 
 private:
+  friend class ShardedPropertyGraphBuilder;
+
   void ResolveIntermediateIDs();
-  GraphComponent BuildFinalEdges(bool verbose);
+  Result<GraphComponent> BuildFinalEdges(bool verbose);
+};
+
+/// Builds a graph from several PropertyGraphBuilders, its shards, that
+/// different threads fill at the same time, one thread per shard, for
+/// importing large inputs with all cores. Each shard holds its nodes and
+/// edges with its own builders and node id map. Finish merges them in
+/// parallel: the nodes of each shard follow those of the shards before it,
+/// string node ids resolve across shards, with unknown ids becoming new
+/// nodes as they do in a single builder, and graph-wide CSR topology and
+/// property tables are assembled from the chunks of the shards.
+///
+/// Numeric node indexes given to a shard, as in AddEdge(uint32_t, ...),
+/// refer to the nodes of that shard. When shards add nodes with the same id,
+/// edges of other shards refer to the node of the first of them.
+class KATANA_EXPORT ShardedPropertyGraphBuilder {
+  std::vector<std::unique_ptr<PropertyGraphBuilder>> shards_;
+  WriterProperties properties_;
+
+public:
+  ShardedPropertyGraphBuilder(size_t num_shards, size_t chunk_size);
+
+  size_t num_shards() const { return shards_.size(); }
+  PropertyGraphBuilder& shard(size_t i) { return *shards_[i]; }
+
+  /// Merge the shards; the shards are left in an unspecified state
+  Result<GraphComponents> Finish(bool verbose = true);
 };
 
 KATANA_EXPORT Result<std::unique_ptr<katana::PropertyGraph>>
@@ -0,0 +1,50 @@
+#ifndef KATANA_LIBGRAPH_KATANA_BULKLOADER_H_
+#define KATANA_LIBGRAPH_KATANA_BULKLOADER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/TxnContext.h"
+#include "katana/URI.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The columns LoadGraphFromTables finds the topology of a graph in
+struct BulkLoadOptions {
+  /// The column of node tables with the external id of each node
+  std::string node_id_column{"id"};
+  /// The columns of edge tables with the external ids of the endpoints of
+  /// each edge
+  std::string source_column{"source"};
+  std::string destination_column{"destination"};
+  /// If true, edges with an endpoint that no node has are dropped instead of
+  /// failing the load
+  bool drop_dangling_edges{false};
+};
+
+/// Load a graph from tables of nodes and tables of edges. Tables are
+/// Parquet files, or CSV files with a header row if their names end in
+/// ".csv", which may be local or in any storage katana supports, such as
+/// S3. Files are read in parallel and the tables of nodes, and of edges,
+/// must have the same columns.
+///
+/// Nodes are numbered in order of table and row. External ids are integers
+/// or strings; the endpoints of edges are looked up in a parallel index over
+/// the node ids, and refer to the first node with an id. The CSR is built
+/// with a parallel counting sort of the edges by source, which keeps the
+/// out-edges of each node in table order.
+///
+/// The columns of the node tables, including the ids, become node
+/// properties. The columns of the edge tables other than the endpoints
+/// become edge properties.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> LoadGraphFromTables(
+    const std::vector<URI>& node_tables, const std::vector<URI>& edge_tables,
+    const BulkLoadOptions& options, TxnContext* txn_ctx);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef KATANA_LIBGRAPH_KATANA_DYNAMICTOPOLOGY_H_
+#define KATANA_LIBGRAPH_KATANA_DYNAMICTOPOLOGY_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A topology that takes batches of edge insertions and deletions. It is a
+/// segmented CSR: the out-edges of each node live in a segment of a shared
+/// pool with room to grow, so most insertions write into free slots of their
+/// node's segment. A node that runs out of room moves to a segment twice as
+/// large at the end of the pool, and the pool is repacked once abandoned
+/// segments outnumber the edges.
+///
+/// Edges are identified by their slot in the pool, which is stable until the
+/// next batch. Edge ids are not dense, so use ToCSR for analytics that index
+/// arrays by edge.
+class KATANA_EXPORT DynamicTopology : public GraphTopologyTypes {
+public:
+  DynamicTopology() = default;
+  DynamicTopology(DynamicTopology&&) = default;
+  DynamicTopology& operator=(DynamicTopology&&) = default;
+
+  DynamicTopology(const DynamicTopology&) = delete;
+  DynamicTopology& operator=(const DynamicTopology&) = delete;
+
+  static DynamicTopology Make(const GraphTopology& csr) noexcept;
+
+  uint64_t NumNodes() const noexcept { return segments_.size(); }
+
+  uint64_t NumEdges() const noexcept { return num_edges_; }
+
+  nodes_range Nodes() const noexcept {
+    return MakeStandardRange<node_iterator>(
+        Node{0}, static_cast<Node>(NumNodes()));
+  }
+
+  edges_range OutEdges(Node node) const noexcept {
+    const Segment& segment = segments_[node];
+    return MakeStandardRange<edge_iterator>(
+        segment.begin, segment.begin + segment.degree);
+  }
+
+  Node OutEdgeDst(Edge edge) const noexcept { return dests_[edge]; }
+
+  size_t OutDegree(Node node) const noexcept { return segments_[node].degree; }
+
+  PropertyIndex GetEdgePropertyIndexFromOutEdge(Edge edge) const noexcept {
+    return edge_prop_indices_[edge];
+  }
+
+  PropertyIndex GetNodePropertyIndex(Node node) const noexcept {
+    return node_prop_indices_[node];
+  }
+
+  /// Add edges in parallel. Out-edges keep their order, with the inserted
+  /// ones after the existing ones.
+  void InsertEdges(const std::vector<EdgeDeltas::Insertion>& edges) noexcept;
+
+  /// Remove every edge from src to dst of each deletion in parallel
+  void DeleteEdges(const std::vector<EdgeDeltas::Deletion>& edges) noexcept;
+
+  /// \returns the edges as a CSR, with the property index of every edge
+  GraphTopology ToCSR() const noexcept;
+
+  /// \returns the bytes of memory of the segments and of the edge pool,
+  /// including its free slots
+  uint64_t SizeBytes() const noexcept {
+    return segments_.size() * sizeof(Segment) +
+           dests_.capacity() * sizeof(Node) +
+           edge_prop_indices_.capacity() * sizeof(PropertyIndex) +
+           node_prop_indices_.size() * sizeof(PropertyIndex);
+  }
+
+private:
+  /// 64-bit like Edge, since a hub can have more than 2^32 out-edges
+  struct Segment {
+    Edge begin;
+    uint64_t degree;
+    uint64_t capacity;
+  };
+
+  /// Move every segment into a new pool with room to grow
+  void Repack() noexcept;
+
+  NUMAArray<Segment> segments_;
+  std::vector<Node> dests_;
+  std::vector<PropertyIndex> edge_prop_indices_;
+  PropIndexVec node_prop_indices_;
+  uint64_t num_edges_{0};
+  /// slots of segments abandoned by nodes that outgrew them
+  uint64_t num_abandoned_slots_{0};
+};
+
+}  // namespace katana
+
+#endif
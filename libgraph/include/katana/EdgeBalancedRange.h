@@ -0,0 +1,131 @@
+#ifndef KATANA_LIBGRAPH_KATANA_EDGEBALANCEDRANGE_H_
+#define KATANA_LIBGRAPH_KATANA_EDGEBALANCEDRANGE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "katana/Loops.h"
+#include "katana/Range.h"
+
+namespace katana {
+
+/// Splits the work of visiting every node and out-edge of a topology into
+/// blocks of the same size, counting one unit for each node and one for
+/// each edge, so that loops over graphs with skewed degrees stay balanced
+/// without per-algorithm tiling.
+///
+/// A node whose out-edges span several blocks is visited once per block
+/// with the part of its edges in that block, possibly by several threads
+/// at once, so loop bodies must combine the partial results of a node with
+/// atomics or reductions. Every node is visited at least once, nodes
+/// without out-edges exactly once.
+///
+/// The adjacency indices of a topology are already a prefix sum of its
+/// degrees, so finding where a block starts is a binary search over them
+/// and nothing needs to be precomputed. Works with any topology or view
+/// whose out-edges are consecutive edge ids in node order, and refers to
+/// topo, which must outlive it.
+template <typename Topo>
+class EdgeBalancedRange {
+public:
+  using Node = typename Topo::Node;
+  using Edge = typename Topo::Edge;
+  using edges_range = typename Topo::edges_range;
+
+  static constexpr uint64_t kDefaultBlockSize = 1024;
+
+  explicit EdgeBalancedRange(
+      const Topo& topo, uint64_t block_size = kDefaultBlockSize) noexcept
+      : topo_(&topo),
+        num_nodes_(topo.NumNodes()),
+        work_(topo.NumNodes() + topo.NumEdges()),
+        block_size_(std::max<uint64_t>(block_size, 1)) {}
+
+  uint64_t NumBlocks() const noexcept {
+    return (work_ + block_size_ - 1) / block_size_;
+  }
+
+  /// Call fn(node, edges) for each node in block with its edges in block
+  template <typename Fn>
+  void ForEachInBlock(uint64_t block, const Fn& fn) const {
+    uint64_t lo = block * block_size_;
+    uint64_t hi = std::min(work_, lo + block_size_);
+    for (Node n = FindNode(lo); n < num_nodes_; ++n) {
+      auto edges = topo_->OutEdges(n);
+      Edge e_begin = *edges.begin();
+      Edge e_end = *edges.end();
+      if (n + e_begin >= hi) {
+        break;
+      }
+      Edge first = lo > n + 1 ? std::max<Edge>(e_begin, lo - n - 1) : e_begin;
+      Edge last = std::min<Edge>(e_end, hi - n - 1);
+      fn(n, MakeStandardRange(
+                edges.begin() + (first - e_begin),
+                edges.begin() + (std::max(first, last) - e_begin)));
+    }
+  }
+
+  /// \returns where each of num_threads threads begins in the nodes so that
+  /// each gets about the same work, followed by the number of nodes, for
+  /// MakeSpecificRange. Unlike the blocks, threads get whole nodes.
+  std::vector<uint32_t> ThreadRanges(
+      unsigned num_threads = activeThreads) const {
+    std::vector<uint32_t> ranges(num_threads + 1, num_nodes_);
+    for (unsigned t = 0; t < num_threads; ++t) {
+      uint64_t position = work_ * t / num_threads;
+      Node n = FindNode(position);
+      // start after a node that mostly falls before position
+      if (n < num_nodes_ &&
+          position - WorkBegin(n) > WorkBegin(n + 1) - position) {
+        ++n;
+      }
+      ranges[t] = n;
+    }
+    return ranges;
+  }
+
+private:
+  /// \returns where the work of node n begins; node n takes the unit at
+  /// n + its first edge and edge e the one at n + 1 + e
+  uint64_t WorkBegin(uint64_t n) const noexcept {
+    return n < num_nodes_ ? n + *topo_->OutEdges(n).begin() : work_;
+  }
+
+  /// \returns the first node whose work ends after position
+  Node FindNode(uint64_t position) const noexcept {
+    uint64_t lo = 0;
+    uint64_t hi = num_nodes_;
+    while (lo < hi) {
+      uint64_t mid = lo + (hi - lo) / 2;
+      if (mid + 1 + *topo_->OutEdges(mid).end() <= position) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  const Topo* topo_;
+  uint64_t num_nodes_;
+  /// one unit for each node and each edge
+  uint64_t work_;
+  uint64_t block_size_;
+};
+
+/// do_all over the blocks of range, calling fn(node, edges) for each node
+/// and part of its out-edges, see EdgeBalancedRange. args are do_all
+/// options such as katana::steal().
+template <typename Topo, typename Fn, typename... Args>
+void
+DoAllEdgeBalanced(
+    const EdgeBalancedRange<Topo>& range, const Fn& fn, const Args&... args) {
+  katana::do_all(
+      katana::iterate(uint64_t{0}, range.NumBlocks()),
+      [&](uint64_t block) { range.ForEachInBlock(block, fn); }, args...);
+}
+
+}  // namespace katana
+
+#endif
@@ -1,9 +1,18 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ENTITYINDEX_H_
 #define KATANA_LIBGRAPH_KATANA_ENTITYINDEX_H_
 
-#include <set>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #include <arrow/api.h>
 #include <arrow/array.h>
@@ -11,37 +20,54 @@
 #include <boost/iterator/iterator_categories.hpp>
 #include <boost/iterator/iterator_facade.hpp>
 
+#include "katana/BloomFilter.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/NUMAArray.h"
 #include "katana/Result.h"
 #include "katana/config.h"
 
 namespace katana {
 
+// The structure of an EntityIndex.
+enum class EntityIndexKind {
+  // Sorted by property value, for ordered searches.
+  kSorted,
+  // A hash table over the property values, for equality lookups only.
+  kHash,
+  // Sorted by several properties and possibly the entity type.
+  kComposite,
+};
+
 // EntityIndex provides an interface similar to an ordered container
 // over a single property.
+//
+// The index is a sorted array of the ids of the entities whose property is
+// not null, ordered by property value and then by id, so lookups are binary
+// searches over contiguous memory rather than walks down a tree.
 template <typename node_or_edge>
 class KATANA_EXPORT EntityIndex {
 public:
-  // Type-safe container for node and edge ids to avoid overlap with the
-  // primitive types we are indexing.
-  struct IndexID {
-    node_or_edge id;
-  };
-
-  // The set key type is either a node/edge id (all the keys in the actual set)
-  // or a value representing the search key.
-  using set_key_type = typename std::variant<
-      IndexID, bool, uint8_t, int16_t, int32_t, int64_t, uint64_t, double_t,
-      float_t, std::string_view*>;
-
   // EntityIndex::iterator returns a sequence of node or edge ids.
-  using base_iterator = typename std::multiset<set_key_type>::iterator;
-  class iterator : public base_iterator {
+  class iterator
+      : public boost::iterator_facade<
+            iterator, const node_or_edge, boost::random_access_traversal_tag> {
   public:
-    explicit iterator(const base_iterator& base) : base_iterator(base) {}
-    iterator() : base_iterator(0) {}
-    const node_or_edge& operator*() const {
-      return std::get<IndexID>(base_iterator::operator*()).id;
+    iterator() = default;
+    explicit iterator(const node_or_edge* pos) : pos_(pos) {}
+
+  private:
+    friend class boost::iterator_core_access;
+
+    const node_or_edge& dereference() const { return *pos_; }
+    bool equal(const iterator& other) const { return pos_ == other.pos_; }
+    void increment() { ++pos_; }
+    void decrement() { --pos_; }
+    void advance(std::ptrdiff_t n) { pos_ += n; }
+    std::ptrdiff_t distance_to(const iterator& other) const {
+      return other.pos_ - pos_;
     }
+
+    const node_or_edge* pos_{nullptr};
   };
 
   EntityIndex(std::string property_name)
@@ -57,180 +83,436 @@ public:
   // The name of the indexed property.
   std::string property_name() { return property_name_; }
 
-  virtual iterator begin() = 0;
-  virtual iterator end() = 0;
+  iterator begin() const { return iterator(ids_.data()); }
+  iterator end() const { return iterator(ids_.data() + ids_.size()); }
+
+  // The number of entities in the index, i.e., those whose property is not
+  // null.
+  size_t size() const { return ids_.size(); }
+
+  // The sorted ids, as written to storage.
+  const NUMAArray<node_or_edge>& ids() const { return ids_; }
+
+  // The keys in the order of the ids and their size in bytes, as written to
+  // storage, or nullptr if the index does not copy its keys.
+  virtual std::pair<const void*, size_t> key_data() const {
+    return {nullptr, 0};
+  }
+
+  // The indexed property.
+  virtual const arrow::Array& property() const = 0;
+
+  virtual EntityIndexKind kind() const { return EntityIndexKind::kSorted; }
+
+  // The bytes of memory the index holds, not counting the indexed property.
+  virtual size_t SizeBytes() const {
+    return ids_.size() * sizeof(node_or_edge);
+  }
 
   virtual Result<void> BuildFromProperty() = 0;
-  // virtual Result<void> BuildFromFile() = 0;
+
+  // Restore the index from the ids() and key_data() of an earlier build over
+  // the same property values, without sorting.
+  virtual Result<void> BuildFromFile(
+      const void* ids, size_t ids_size, const void* keys,
+      size_t keys_size) = 0;
+
+protected:
+  NUMAArray<node_or_edge> ids_;
 
 private:
   std::string property_name_;
 };
 
 // PrimitiveEntityIndex provides a EntityIndex for primitive types.
+//
+// The property values are copied next to the sorted ids, so searches never
+// touch the Arrow property. NaNs sort after every other value. Large indexes
+// also keep a Bloom filter of their values, so that Find rejects most absent
+// values without a binary search.
 template <typename node_or_edge, typename c_type>
 class KATANA_EXPORT PrimitiveEntityIndex : public EntityIndex<node_or_edge> {
 public:
   using ArrowArrayType = typename arrow::CTypeTraits<c_type>::ArrayType;
-  using IndexID = typename EntityIndex<node_or_edge>::IndexID;
   using iterator = typename EntityIndex<node_or_edge>::iterator;
-  using set_key_type = typename EntityIndex<node_or_edge>::set_key_type;
 
   PrimitiveEntityIndex(
       const std::string& column, size_t num_entities,
       std::shared_ptr<arrow::Array> property)
       : EntityIndex<node_or_edge>(column),
         num_entities_(num_entities),
-        property_(std::static_pointer_cast<ArrowArrayType>(property)),
-        set_(PropertyCompare(property_)) {}
+        property_(std::static_pointer_cast<ArrowArrayType>(property)) {}
 
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
-
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not seem to specify that
-  // multiset::find returns the first value, though it appears so in practice.
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
   iterator Find(c_type key) {
-    auto it = set_.lower_bound(key);
-    if (it == set_.end() ||
-        property_->Value(std::get<IndexID>(*it).id) != key) {
-      return end();
+    if (!filter_.MayContain(KeyHash(key))) {
+      return this->end();
+    }
+    auto it = std::lower_bound(keys_.begin(), keys_.end(), key, KeyLess);
+    if (it == keys_.end() || KeyLess(key, *it)) {
+      return this->end();
     }
-    return iterator(it);
+    return ToIterator(it);
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
-  iterator LowerBound(c_type key) { return iterator(set_.lower_bound(key)); }
+  // Returns an iterator to the first element in the index that is greater
+  // than or equal to `key`.
+  iterator LowerBound(c_type key) {
+    return ToIterator(
+        std::lower_bound(keys_.begin(), keys_.end(), key, KeyLess));
+  }
 
-  // Returns an iterator to the first element in the set that is greater than
-  // `key`.
-  iterator UpperBound(c_type key) { return iterator(set_.upper_bound(key)); }
+  // Returns an iterator to the first element in the index that is greater
+  // than `key`.
+  iterator UpperBound(c_type key) {
+    return ToIterator(
+        std::upper_bound(keys_.begin(), keys_.end(), key, KeyLess));
+  }
 
 private:
-  class PropertyCompare {
-  public:
-    PropertyCompare(std::shared_ptr<ArrowArrayType> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a literal key_type or a node/edge.
-      c_type val_a = GetValue(a);
-      c_type val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<c_type>{}(val_a, val_b);
+  // std::less, except that NaN is greater than every other value, which
+  // makes it a strict weak order for floating point keys too.
+  static bool KeyLess(c_type a, c_type b) {
+    if constexpr (std::is_floating_point_v<c_type>) {
+      if (std::isnan(a)) {
+        return false;
+      }
+      if (std::isnan(b)) {
+        return true;
+      }
     }
+    return std::less<c_type>{}(a, b);
+  }
 
-  private:
-    c_type GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        node_or_edge id = std::get<IndexID>(a).id;
-        c_type val = property_->Value(id);
-        return val;
+  // Hashes keys that are equivalent under KeyLess equally.
+  static uint64_t KeyHash(c_type key) {
+    if constexpr (std::is_floating_point_v<c_type>) {
+      if (std::isnan(key)) {
+        key = std::numeric_limits<c_type>::quiet_NaN();
+      } else if (key == 0) {
+        // -0 equals 0
+        key = 0;
       }
-      return std::get<c_type>(a);
     }
+    uint64_t bits = 0;
+    std::memcpy(&bits, &key, sizeof(key));
+    return BloomFilter::Hash(bits);
+  }
 
-    std::shared_ptr<ArrowArrayType> property_;
-  };
+  iterator ToIterator(const c_type* key) const {
+    return iterator(this->ids_.data() + (key - keys_.data()));
+  }
+
+  std::pair<const void*, size_t> key_data() const override {
+    return {keys_.data(), keys_.size() * sizeof(c_type)};
+  }
+
+  const arrow::Array& property() const override { return *property_; }
+
+  size_t SizeBytes() const override {
+    return EntityIndex<node_or_edge>::SizeBytes() +
+           keys_.size() * sizeof(c_type) + filter_.SizeBytes();
+  }
 
   Result<void> BuildFromProperty() override;
-  // Result<void> BuildFromFile(...) override;
+  Result<void> BuildFromFile(
+      const void* ids, size_t ids_size, const void* keys,
+      size_t keys_size) override;
 
   size_t num_entities_;
   std::shared_ptr<ArrowArrayType> property_;
-  std::multiset<set_key_type, PropertyCompare> set_;
+  // keys_[i] is the property value of ids_[i]
+  NUMAArray<c_type> keys_;
+  // Over the keys, or empty for small indexes
+  BloomFilter filter_;
 };
 
-// StringEntityIndex provides a EntityIndex for strings.
+// StringEntityIndex provides a EntityIndex for strings. Like
+// PrimitiveEntityIndex, large indexes keep a Bloom filter of their values
+// for Find.
 template <typename node_or_edge>
 class KATANA_EXPORT StringEntityIndex : public EntityIndex<node_or_edge> {
 public:
   using ArrowArrayType =
       typename arrow::TypeTraits<arrow::LargeStringType>::ArrayType;
-  using IndexID = typename EntityIndex<node_or_edge>::IndexID;
   using iterator = typename EntityIndex<node_or_edge>::iterator;
-  using set_key_type = typename EntityIndex<node_or_edge>::set_key_type;
 
   StringEntityIndex(
       const std::string& property_name, size_t num_entities,
       const std::shared_ptr<arrow::Array>& property)
       : EntityIndex<node_or_edge>(property_name),
         num_entities_(num_entities),
-        property_(std::static_pointer_cast<arrow::LargeStringArray>(property)),
-        set_(StringCompare(property_)) {}
-
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
+        property_(
+            std::static_pointer_cast<arrow::LargeStringArray>(property)) {}
 
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not appear to specify that
-  // multiset::find returns the first value, though it appears so in practice.
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
   iterator Find(std::string_view key) {
-    auto it = set_.lower_bound(&key);
-    if (it != set_.end()) {
-      arrow::util::string_view arrow_view =
-          property_->GetView(std::get<IndexID>(*it).id);
-      if (std::string_view(arrow_view.data(), arrow_view.length()) != key) {
-        return end();
-      }
+    if (!filter_.MayContain(std::hash<std::string_view>{}(key))) {
+      return this->end();
     }
-    return iterator(it);
+    iterator it = LowerBound(key);
+    if (it == this->end() || GetValue(*it) != key) {
+      return this->end();
+    }
+    return it;
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
+  // Returns an iterator to the first element in the index that is greater
+  // than or equal to `key`.
   iterator LowerBound(std::string_view key) {
-    return iterator(set_.lower_bound(&key));
+    return iterator(std::lower_bound(
+        this->ids_.begin(), this->ids_.end(), key,
+        [this](node_or_edge id, std::string_view k) {
+          return GetValue(id) < k;
+        }));
   }
 
-  // Returns an iterator to the first element in the set that is greater than
-  // `key`.
+  // Returns an iterator to the first element in the index that is greater
+  // than `key`.
   iterator UpperBound(std::string_view key) {
-    return iterator(set_.upper_bound(&key));
+    return iterator(std::upper_bound(
+        this->ids_.begin(), this->ids_.end(), key,
+        [this](std::string_view k, node_or_edge id) {
+          return k < GetValue(id);
+        }));
   }
 
 private:
-  class StringCompare {
-  public:
-    StringCompare(std::shared_ptr<arrow::LargeStringArray> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a pointer to a string_view or a node/edge.
-      std::string_view val_a = GetValue(a);
-      std::string_view val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<std::string_view>{}(val_a, val_b);
-    }
+  std::string_view GetValue(node_or_edge id) const {
+    arrow::util::string_view arrow_view = property_->GetView(id);
+    return std::string_view(arrow_view.data(), arrow_view.length());
+  }
 
-  private:
-    std::string_view GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        arrow::util::string_view arrow_view =
-            property_->GetView(std::get<IndexID>(a).id);
-        return std::string_view(arrow_view.data(), arrow_view.length());
-      }
-      return *std::get<std::string_view*>(a);
-    }
+  const arrow::Array& property() const override { return *property_; }
 
-    std::shared_ptr<arrow::LargeStringArray> property_;
-  };
+  size_t SizeBytes() const override {
+    return EntityIndex<node_or_edge>::SizeBytes() + filter_.SizeBytes();
+  }
 
   Result<void> BuildFromProperty() override;
-  // virtual Result<void> BuildFromFile(...) override;
+  // The keys are not copied since strings vary in length, so keys is
+  // ignored.
+  Result<void> BuildFromFile(
+      const void* ids, size_t ids_size, const void* keys,
+      size_t keys_size) override;
+
+  void BuildFilter();
 
   size_t num_entities_;
   std::shared_ptr<arrow::LargeStringArray> property_;
-  std::multiset<set_key_type, StringCompare> set_;
-};  // namespace katana
+  // Over the values, or empty for small indexes
+  BloomFilter filter_;
+};
+
+// StringHashEntityIndex provides a EntityIndex for equality lookups on
+// strings, such as mapping external ids to entities.
+//
+// The ids are grouped by property value, with the groups in no particular
+// order, and an open addressing table maps each distinct value to its
+// group. Each slot of the table has a tag of seven bits of the hash of its
+// value, and lookups compare the tags of sixteen slots at once, so most
+// lookups compare a single string.
+template <typename node_or_edge>
+class KATANA_EXPORT StringHashEntityIndex : public EntityIndex<node_or_edge> {
+public:
+  using iterator = typename EntityIndex<node_or_edge>::iterator;
+
+  // The id FindBatch returns for keys that are null or not in the index.
+  static constexpr node_or_edge kNotFound =
+      std::numeric_limits<node_or_edge>::max();
+
+  StringHashEntityIndex(
+      const std::string& property_name, size_t num_entities,
+      const std::shared_ptr<arrow::Array>& property)
+      : EntityIndex<node_or_edge>(property_name),
+        num_entities_(num_entities),
+        property_(
+            std::static_pointer_cast<arrow::LargeStringArray>(property)) {}
+
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`. Unlike the sorted indexes, only the elements up to
+  // the end of EqualRange(key) have that value.
+  iterator Find(std::string_view key) const {
+    auto [first, last] = EqualRange(key);
+    return first == last ? this->end() : first;
+  }
+
+  // Returns the elements in the index with their property value equal to
+  // `key`, in order of id.
+  std::pair<iterator, iterator> EqualRange(std::string_view key) const;
+
+  // Looks up each value of `keys`, a string or large string array, in
+  // parallel. Returns the least id with each value, or kNotFound.
+  Result<NUMAArray<node_or_edge>> FindBatch(const arrow::Array& keys) const;
+
+private:
+  static constexpr size_t kNoGroup = std::numeric_limits<size_t>::max();
+
+  std::string_view GetValue(node_or_edge id) const {
+    arrow::util::string_view arrow_view = property_->GetView(id);
+    return std::string_view(arrow_view.data(), arrow_view.length());
+  }
+
+  // The group of ids with value `key`, or kNoGroup.
+  size_t FindGroup(std::string_view key) const;
+
+  // Find the groups of the grouped ids_ and fill the table with them.
+  void BuildTable();
+
+  const arrow::Array& property() const override { return *property_; }
+
+  size_t SizeBytes() const override {
+    return EntityIndex<node_or_edge>::SizeBytes() +
+           (group_starts_.size() + slots_.size()) * sizeof(node_or_edge) +
+           tags_.size();
+  }
+
+  EntityIndexKind kind() const override { return EntityIndexKind::kHash; }
+
+  Result<void> BuildFromProperty() override;
+  // Only the grouped ids are stored; the table is rebuilt from them, which
+  // takes a pass over the values but no sorting. keys is ignored.
+  Result<void> BuildFromFile(
+      const void* ids, size_t ids_size, const void* keys,
+      size_t keys_size) override;
+
+  size_t num_entities_;
+  std::shared_ptr<arrow::LargeStringArray> property_;
+  // Group g is ids_[group_starts_[g], group_starts_[g + 1]), with the last
+  // group ending at the end of ids_
+  NUMAArray<node_or_edge> group_starts_;
+  // The tag of each slot of the table, or an empty tag; the number of slots
+  // is a power of two and at least sixteen
+  NUMAArray<uint8_t> tags_;
+  // The group of each full slot of the table
+  NUMAArray<node_or_edge> slots_;
+};
+
+// A value of one column of the key of a CompositeEntityIndex. Values are
+// converted to the type of their column, and values that it cannot
+// represent match nothing.
+using EntityIndexKeyValue =
+    std::variant<bool, int64_t, uint64_t, double, std::string_view>;
+
+// The property_name of a CompositeEntityIndex over property_names, by
+// entity type if by_type.
+KATANA_EXPORT std::string CompositeEntityIndexName(
+    const std::vector<std::string>& property_names, bool by_type);
+
+// CompositeEntityIndex provides a EntityIndex over several properties and,
+// optionally, the most specific entity type.
+//
+// The key of an entity is its type, if the index is by type, followed by
+// its properties in order, and the entities are sorted by key and then by
+// id. Lookups give a prefix of the key, so an index over (name, age) also
+// serves lookups by name, and in an index by type the entities of a type
+// are contiguous. Entities with a null property are not indexed.
+template <typename node_or_edge>
+class KATANA_EXPORT CompositeEntityIndex : public EntityIndex<node_or_edge> {
+public:
+  using iterator = typename EntityIndex<node_or_edge>::iterator;
+  using Key = std::vector<EntityIndexKeyValue>;
+  using Range = std::pair<iterator, iterator>;
+
+  // entity_types holds the most specific type of each entity if the index is
+  // by type and is null otherwise.
+  CompositeEntityIndex(
+      const std::vector<std::string>& property_names, size_t num_entities,
+      std::vector<std::shared_ptr<arrow::Array>> properties,
+      std::shared_ptr<const NUMAArray<EntityTypeID>> entity_types);
+
+  bool by_type() const { return by_type_; }
+
+  // The number of columns of a key: the properties and the type.
+  size_t num_columns() const { return columns_.size(); }
+
+  // Returns the elements in the index whose keys begin with `prefix`. In an
+  // index by type, prefix[0] is an EntityTypeID, given as a uint64_t.
+  Range EqualRange(const Key& prefix) const;
+
+  // Returns, for an index by type, the elements in the index of each entity
+  // type that has the type `entity_type`, such as an atomic type it
+  // combines, and whose properties begin with `prefix`. Only the entries of
+  // those types are searched.
+  std::vector<Range> EqualRanges(
+      const EntityTypeManager& manager, EntityTypeID entity_type,
+      const Key& prefix) const;
+
+private:
+  // One column of the key. Integers, floating point values and bools are
+  // compared as order-preserving unsigned integers, and strings as strings.
+  struct Column {
+    // Null for the entity type
+    std::shared_ptr<arrow::Array> property;
+    bool is_string{};
+    // The key of each entry for columns that are not strings
+    NUMAArray<uint64_t> keys;
+  };
+
+  // A value of a key prefix converted to the type of its column
+  struct ColumnValue {
+    uint64_t key{};
+    std::string_view str;
+  };
+
+  std::string_view GetString(size_t column, node_or_edge id) const;
+
+  // Compares the columns of entry from first_column on to prefix.
+  int Compare(
+      size_t entry, const std::vector<ColumnValue>& prefix,
+      size_t first_column) const;
+
+  // Returns the entries in [first, last) whose columns from first_column on
+  // begin with prefix.
+  std::pair<size_t, size_t> Search(
+      const std::vector<ColumnValue>& prefix, size_t first_column,
+      size_t first, size_t last) const;
+
+  // Converts prefix to the types of the columns starting at first_column.
+  // Returns std::nullopt if a value cannot be represented by its column.
+  std::optional<std::vector<ColumnValue>> ConvertPrefix(
+      const Key& prefix, size_t first_column) const;
+
+  const arrow::Array& property() const override { return *properties_[0]; }
+
+  size_t SizeBytes() const override {
+    size_t bytes = EntityIndex<node_or_edge>::SizeBytes() +
+                   type_starts_.size() * sizeof(node_or_edge) +
+                   types_.size() * sizeof(EntityTypeID);
+    for (const auto& column : columns_) {
+      bytes += column.keys.size() * sizeof(uint64_t);
+    }
+    return bytes;
+  }
+
+  EntityIndexKind kind() const override { return EntityIndexKind::kComposite; }
+
+  Result<void> BuildFromProperty() override;
+  // Composite indexes are not stored.
+  Result<void> BuildFromFile(
+      const void* ids, size_t ids_size, const void* keys,
+      size_t keys_size) override;
+
+  size_t num_entities_;
+  bool by_type_;
+  std::vector<std::shared_ptr<arrow::Array>> properties_;
+  std::shared_ptr<const NUMAArray<EntityTypeID>> entity_types_;
+  std::vector<Column> columns_;
+  // For an index by type, the first entry of each entity type present and
+  // that type, in order
+  NUMAArray<node_or_edge> type_starts_;
+  std::vector<EntityTypeID> types_;
+};
 
 // Create a EntityIndex with the appropriate type for 'property'. Does not
-// build the index.
+// build the index. Hash indexes are only supported for strings.
 template <typename node_or_edge>
 Result<std::unique_ptr<EntityIndex<node_or_edge>>> MakeTypedEntityIndex(
     const std::string& property_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property,
+    EntityIndexKind kind = EntityIndexKind::kSorted);
 
 }  // namespace katana
 
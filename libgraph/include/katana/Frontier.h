@@ -0,0 +1,247 @@
+#ifndef KATANA_LIBGRAPH_KATANA_FRONTIER_H_
+#define KATANA_LIBGRAPH_KATANA_FRONTIER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Loops.h"
+#include "katana/Range.h"
+#include "katana/Reduction.h"
+
+namespace katana {
+
+/// The set of active nodes of a round of a bulk-synchronous algorithm, such
+/// as the nodes discovered in the last level of BFS, like the vertexSubset
+/// of Ligra or the frontiers of the GAP benchmark suite.
+///
+/// A frontier is either sparse, a bag of node ids, which is cheap to fill
+/// and to iterate when few nodes are active, or dense, a bitset over all
+/// nodes, which supports membership tests for pull-style rounds and takes
+/// less memory than a bag when many nodes are active. ToDense and ToSparse
+/// convert between the two in parallel.
+///
+/// Push may be called concurrently from a parallel loop. Each node should
+/// be pushed at most once per frontier; EdgeMap guarantees this through
+/// the Cond and UpdateAtomic of its operator.
+class Frontier {
+public:
+  using Node = uint32_t;
+
+  /// A frontier is dense when it has more than NumNodes / kDenseDivisor
+  /// nodes, as in Ligra
+  static constexpr uint64_t kDenseDivisor = 20;
+
+  explicit Frontier(size_t num_nodes, bool dense = false)
+      : num_nodes_(num_nodes), dense_(dense) {
+    if (dense_) {
+      bitset_.resize(num_nodes_);
+    }
+  }
+
+  Frontier(Frontier&&) = default;
+  Frontier& operator=(Frontier&&) = default;
+
+  size_t num_nodes() const { return num_nodes_; }
+  bool is_dense() const { return dense_; }
+
+  /// \returns the number of nodes in the frontier; must not be called while
+  /// nodes are pushed
+  size_t size() const {
+    return dense_ ? bitset_.count() : num_pushed_.reduce();
+  }
+
+  bool empty() const { return dense_ ? bitset_.count() == 0 : bag_.empty(); }
+
+  void Push(Node n) {
+    if (dense_) {
+      bitset_.set(n);
+    } else {
+      bag_.push(n);
+      num_pushed_ += 1;
+    }
+  }
+
+  /// \returns true if n is in the frontier; only for dense frontiers
+  bool Contains(Node n) const {
+    KATANA_LOG_DEBUG_ASSERT(dense_);
+    return bitset_.test(n);
+  }
+
+  /// Remove all nodes and keep the representation
+  void Clear() {
+    if (dense_) {
+      bitset_.reset();
+    } else {
+      bag_.clear();
+      num_pushed_.reset();
+    }
+  }
+
+  void ToDense() {
+    if (dense_) {
+      return;
+    }
+    bitset_.resize(num_nodes_);
+    bitset_.reset();
+    katana::do_all(
+        katana::iterate(bag_), [&](Node n) { bitset_.set(n); },
+        katana::no_stats());
+    bag_.clear();
+    num_pushed_.reset();
+    dense_ = true;
+  }
+
+  void ToSparse() {
+    if (!dense_) {
+      return;
+    }
+    const auto& words = bitset_.get_vec();
+    katana::do_all(
+        katana::iterate(size_t{0}, words.size()),
+        [&](size_t w) {
+          uint64_t bits = words[w].load(std::memory_order_relaxed);
+          for (; bits; bits &= bits - 1) {
+            bag_.push(static_cast<Node>(
+                w * DynamicBitset::kNumBitsInUint64 +
+                __builtin_ctzll(bits)));
+            num_pushed_ += 1;
+          }
+        },
+        katana::no_stats());
+    // keep the allocation for the next time the frontier becomes dense
+    bitset_.reset();
+    dense_ = false;
+  }
+
+  /// Convert to the representation that suits the current size
+  void Adapt() {
+    if (size() > num_nodes_ / kDenseDivisor) {
+      ToDense();
+    } else {
+      ToSparse();
+    }
+  }
+
+  /// Call fn(n) in parallel for each node n of the frontier
+  template <typename Fn, typename... Args>
+  void ForEach(const Fn& fn, Args&&... args) const {
+    if (!dense_) {
+      katana::do_all(katana::iterate(bag_), fn, std::forward<Args>(args)...);
+      return;
+    }
+    const auto& words = bitset_.get_vec();
+    katana::do_all(
+        katana::iterate(size_t{0}, words.size()),
+        [&](size_t w) {
+          uint64_t bits = words[w].load(std::memory_order_relaxed);
+          for (; bits; bits &= bits - 1) {
+            fn(static_cast<Node>(
+                w * DynamicBitset::kNumBitsInUint64 + __builtin_ctzll(bits)));
+          }
+        },
+        std::forward<Args>(args)...);
+  }
+
+  /// \returns the sum of the out-degrees of the nodes of the frontier
+  template <typename Graph>
+  uint64_t OutDegreeSum(const Graph& graph) const {
+    katana::GAccumulator<uint64_t> sum;
+    ForEach([&](Node n) { sum += graph.OutDegree(n); }, katana::no_stats());
+    return sum.reduce();
+  }
+
+  const katana::InsertBag<Node>& sparse() const { return bag_; }
+  const katana::DynamicBitset& dense() const { return bitset_; }
+
+  void swap(Frontier& other) {
+    std::swap(num_nodes_, other.num_nodes_);
+    std::swap(dense_, other.dense_);
+    bag_.swap(other.bag_);
+    std::swap(bitset_, other.bitset_);
+    std::swap(num_pushed_, other.num_pushed_);
+  }
+
+private:
+  size_t num_nodes_;
+  bool dense_;
+  katana::InsertBag<Node> bag_;
+  katana::DynamicBitset bitset_;
+  mutable katana::GAccumulator<size_t> num_pushed_;
+};
+
+/// Push-style round: for each node src of frontier and each out-edge
+/// (src, dst) with op.Cond(dst), call op.UpdateAtomic(src, dst) and push
+/// dst to the returned sparse frontier if it returns true. UpdateAtomic may
+/// run concurrently for the same dst and must return true for at most one
+/// of them.
+template <typename Graph, typename Op, typename... Args>
+Frontier
+EdgeMapPush(
+    const Graph& graph, const Frontier& frontier, Op& op, Args&&... args) {
+  Frontier next(graph.NumNodes());
+  frontier.ForEach(
+      [&](Frontier::Node src) {
+        for (auto e : graph.OutEdges(src)) {
+          auto dst = graph.OutEdgeDst(e);
+          if (op.Cond(dst) && op.UpdateAtomic(src, dst)) {
+            next.Push(dst);
+          }
+        }
+      },
+      katana::steal(), std::forward<Args>(args)...);
+  return next;
+}
+
+/// Pull-style round: for each node dst with op.Cond(dst), call
+/// op.Update(src, dst) for its in-edges (src, dst) with src in frontier
+/// until Cond(dst) becomes false, and add dst to the returned dense
+/// frontier if an Update returned true. Only one thread handles each dst,
+/// so Update needs no atomics. Converts frontier to a dense frontier.
+template <typename Graph, typename Op, typename... Args>
+Frontier
+EdgeMapPull(const Graph& graph, Frontier* frontier, Op& op, Args&&... args) {
+  frontier->ToDense();
+  Frontier next(graph.NumNodes(), true);
+  katana::do_all(
+      katana::iterate(Frontier::Node{0}, Frontier::Node(graph.NumNodes())),
+      [&](Frontier::Node dst) {
+        if (!op.Cond(dst)) {
+          return;
+        }
+        for (auto e : graph.InEdges(dst)) {
+          auto src = graph.InEdgeSrc(e);
+          if (frontier->Contains(src) && op.Update(src, dst)) {
+            next.Push(dst);
+            if (!op.Cond(dst)) {
+              break;
+            }
+          }
+        }
+      },
+      katana::steal(), std::forward<Args>(args)...);
+  return next;
+}
+
+/// Run a round of op on the edges leaving frontier in the cheaper
+/// direction, as chosen by Ligra: pull when the frontier and its out-edges
+/// exceed NumEdges / Frontier::kDenseDivisor, which avoids touching the
+/// edges of a large frontier one by one, and push otherwise. Graph needs
+/// both out- and in-edges, e.g., a bidirectional view; on undirected
+/// graphs, the in-edges of a node are its out-edges.
+template <typename Graph, typename Op, typename... Args>
+Frontier
+EdgeMap(const Graph& graph, Frontier* frontier, Op& op, Args&&... args) {
+  uint64_t work = frontier->size() + frontier->OutDegreeSum(graph);
+  if (work > graph.NumEdges() / Frontier::kDenseDivisor) {
+    return EdgeMapPull(graph, frontier, op, std::forward<Args>(args)...);
+  }
+  frontier->ToSparse();
+  return EdgeMapPush(graph, *frontier, op, std::forward<Args>(args)...);
+}
+
+}  // namespace katana
+
+#endif
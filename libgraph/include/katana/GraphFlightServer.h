@@ -0,0 +1,87 @@
+#ifndef KATANA_LIBGRAPH_KATANA_GRAPHFLIGHTSERVER_H_
+#define KATANA_LIBGRAPH_KATANA_GRAPHFLIGHTSERVER_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <arrow/flight/api.h>
+
+#include "katana/GraphSnapshot.h"
+#include "katana/GraphStreams.h"
+#include "katana/config.h"
+
+namespace katana {
+
+struct GraphFlightServerOptions {
+  /// The number of endpoints, each a stream of one partition of the rows,
+  /// that GetFlightInfo offers per flight for clients to read in parallel
+  uint32_t num_streams{4};
+  /// The most rows of a record batch
+  int64_t max_batch_rows{int64_t{1} << 16};
+  /// How many of the latest published versions stay readable, so that a
+  /// client reading the streams of one flight info reads a single version
+  /// even if a newer one is published meanwhile
+  uint32_t retained_versions{4};
+};
+
+/// An Arrow Flight service that streams the graphs published by a
+/// SnapshotPublisher straight from memory, so that clients such as Spark
+/// or pyarrow read results without waiting for them to be written to
+/// storage and read back.
+///
+/// Flights are named by descriptor paths:
+///
+///   ["nodes"] or ["nodes", property, ...]: node property rows
+///   ["edges"] or ["edges", property, ...]: edge property rows
+///   ["topology"]: one row of src, dst and property_index per edge
+///
+/// GetFlightInfo pins the latest published snapshot and describes a flight
+/// as options.num_streams endpoints whose tickets name the version and a
+/// partition of the rows; DoGet streams them with MakeGraphStreamReader.
+/// Endpoints carry no locations, so clients fetch them from this server.
+///
+/// Start the server with Init and Serve of arrow::flight::FlightServerBase.
+class KATANA_EXPORT GraphFlightServer
+    : public arrow::flight::FlightServerBase {
+public:
+  /// publisher must outlive the server
+  explicit GraphFlightServer(
+      const SnapshotPublisher* publisher,
+      const GraphFlightServerOptions& options = {});
+
+  arrow::Status ListFlights(
+      const arrow::flight::ServerCallContext& context,
+      const arrow::flight::Criteria* criteria,
+      std::unique_ptr<arrow::flight::FlightListing>* listings) override;
+
+  arrow::Status GetFlightInfo(
+      const arrow::flight::ServerCallContext& context,
+      const arrow::flight::FlightDescriptor& request,
+      std::unique_ptr<arrow::flight::FlightInfo>* info) override;
+
+  arrow::Status DoGet(
+      const arrow::flight::ServerCallContext& context,
+      const arrow::flight::Ticket& request,
+      std::unique_ptr<arrow::flight::FlightDataStream>* stream) override;
+
+private:
+  /// Pin the latest snapshot and retain it for DoGet
+  std::shared_ptr<const GraphSnapshot> Pin();
+
+  arrow::Result<arrow::flight::FlightInfo> MakeInfo(
+      const std::shared_ptr<const GraphSnapshot>& snapshot,
+      const arrow::flight::FlightDescriptor& descriptor);
+
+  const SnapshotPublisher* publisher_;
+  GraphFlightServerOptions options_;
+
+  std::mutex mutex_;
+  /// The latest pinned snapshots by version
+  std::map<uint64_t, std::shared_ptr<const GraphSnapshot>> retained_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef KATANA_LIBGRAPH_KATANA_GRAPHIMAGE_H_
+#define KATANA_LIBGRAPH_KATANA_GRAPHIMAGE_H_
+
+#include <memory>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Write pg as it is in memory to a single local image file at path, for
+/// LoadGraphImage to map back on a warm restart instead of loading the RDG
+/// and rebuilding what was derived from it. The image holds the topology,
+/// the entity types, the loaded properties, every derived topology cached
+/// for views, and a manifest that records them together with the version of
+/// the RDG that pg was loaded from. Entity indexes are recorded by property
+/// and kind.
+///
+/// pg must have been loaded from an RDG; writing fails if it has
+/// uncommitted changes (see PropertyGraph::HasUncommittedChanges). The
+/// file appears atomically, complete or not at all, and replaces any file at
+/// path.
+KATANA_EXPORT Result<void> WriteGraphImage(
+    PropertyGraph* pg, const std::string& path);
+
+/// Load a graph of the RDG at rdg_dir from an image written by
+/// WriteGraphImage. The image is refused if it was written from another RDG
+/// or from a version of it other than the latest.
+///
+/// The topology, entity types and properties of the returned graph are
+/// read-only mappings of the image, which the graph keeps alive; derived
+/// topologies are copied into its view cache, and entity indexes, other than
+/// composite ones, are rebuilt. As with AttachSharedGraph, operations that
+/// modify the topology, types or properties in place are not supported. The
+/// graph has no RDG handle, so it can be written to a new location but not
+/// committed.
+KATANA_EXPORT Result<std::shared_ptr<PropertyGraph>> LoadGraphImage(
+    const std::string& path, const URI& rdg_dir);
+
+}  // namespace katana
+
+#endif
@@ -15,11 +15,16 @@ namespace katana {
 ///     memory usage when converting large inputs
 /// \param verbose If true, print graph data to the standard out while
 ///     converting.
+/// \param num_pieces The number of pieces the graph element of the file is
+///     split into, at node and edge element boundaries, to be parsed in
+///     parallel. 1 parses the file serially and 0 picks a few pieces per
+///     thread for large files. Files with comments or CDATA sections in
+///     their graph element are always parsed serially.
 /// \returns A collection of Arrow tables of node properties/labels, edge
 ///     properties/types, and CSR topology
 KATANA_EXPORT katana::Result<katana::GraphComponents> ConvertGraphML(
     const std::string& infilename, size_t chunk_size = 25000,
-    bool verbose = false);
+    bool verbose = false, size_t num_pieces = 0);
 
 /// ConvertGraphML converts a GraphML file into katana form
 ///
@@ -0,0 +1,47 @@
+#ifndef KATANA_LIBGRAPH_KATANA_GRAPHMEMORYUSAGE_H_
+#define KATANA_LIBGRAPH_KATANA_GRAPHMEMORYUSAGE_H_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// The bytes of memory held by one part of a PropertyGraph
+struct KATANA_EXPORT MemoryUsageItem {
+  std::string name;
+  uint64_t bytes{};
+};
+
+/// The bytes of memory a PropertyGraph holds, by part, as returned by
+/// PropertyGraph::GetMemoryUsage. Memory shared between parts, e.g., a
+/// property of a graph and of its projection, is counted in each.
+struct KATANA_EXPORT GraphMemoryUsage {
+  /// The default topology
+  uint64_t topology{};
+  /// The derived topologies and indexes cached for views
+  std::vector<MemoryUsageItem> views;
+  /// The loaded properties, by name
+  std::vector<MemoryUsageItem> node_properties;
+  std::vector<MemoryUsageItem> edge_properties;
+  /// The node and edge entity type ids
+  uint64_t entity_type_ids{};
+  /// The entity and vector indexes, not counting the properties they index
+  std::vector<MemoryUsageItem> indexes;
+  /// The other optional datastructures, e.g., the dynamic topology that
+  /// edge updates go to and the maps of a projection
+  std::vector<MemoryUsageItem> other;
+
+  /// \returns the sum of all the parts
+  uint64_t TotalBytes() const;
+
+  /// Print the usage in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+}  // namespace katana
+
+#endif
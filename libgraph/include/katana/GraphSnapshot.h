@@ -0,0 +1,127 @@
+#ifndef KATANA_LIBGRAPH_KATANA_GRAPHSNAPSHOT_H_
+#define KATANA_LIBGRAPH_KATANA_GRAPHSNAPSHOT_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/EntityTypeManager.h"
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class PropertyGraph;
+
+/// The topology, loaded properties and entity types of a PropertyGraph at
+/// one point in time. Taking a snapshot copies no topology or property
+/// data: a PropertyGraph replaces rather than modifies its topology,
+/// property tables and type arrays when they change, so the snapshot keeps
+/// the ones it was taken from alive and unchanged.
+///
+/// Changes made in place are the exception and show through: writes to an
+/// existing property through a view (new properties are fine), the
+/// mutable_*_entity_type_ids arrays and in place topology sorts, e.g.,
+/// SortAllEdgesByDest. Writers that share a graph with snapshots replace
+/// properties with UpsertNodeProperties and friends instead.
+class KATANA_EXPORT GraphSnapshot {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+  using EntityTypeIDArray = NUMAArray<EntityTypeID>;
+
+  /// Take a snapshot of pg. Properties pg has not loaded yet are not in it.
+  /// Projected graphs are not supported.
+  static Result<std::shared_ptr<const GraphSnapshot>> Make(
+      const PropertyGraph& pg, uint64_t version = 0);
+
+  /// The number SnapshotPublisher gave this snapshot, or the version passed
+  /// to Make
+  uint64_t version() const { return version_; }
+
+  const GraphTopology& topology() const { return *topology_; }
+  uint64_t NumNodes() const { return topology_->NumNodes(); }
+  uint64_t NumEdges() const { return topology_->NumEdges(); }
+
+  const std::shared_ptr<arrow::Table>& node_properties() const {
+    return node_properties_;
+  }
+  const std::shared_ptr<arrow::Table>& edge_properties() const {
+    return edge_properties_;
+  }
+
+  Result<std::shared_ptr<arrow::ChunkedArray>> GetNodeProperty(
+      const std::string& name) const;
+  Result<std::shared_ptr<arrow::ChunkedArray>> GetEdgeProperty(
+      const std::string& name) const;
+
+  const EntityTypeManager& GetNodeTypeManager() const {
+    return node_type_manager_;
+  }
+  const EntityTypeManager& GetEdgeTypeManager() const {
+    return edge_type_manager_;
+  }
+
+  /// \return the most specific node entity type of node
+  EntityTypeID GetTypeOfNode(Node node) const {
+    return (*node_entity_type_ids_)[topology_->GetNodePropertyIndex(node)];
+  }
+
+  /// \return the most specific edge entity type of the out edge edge
+  EntityTypeID GetTypeOfEdge(Edge edge) const {
+    auto idx = topology_->GetEdgePropertyIndexFromOutEdge(edge);
+    return (*edge_entity_type_ids_)[idx];
+  }
+
+private:
+  GraphSnapshot() = default;
+
+  uint64_t version_{0};
+  std::shared_ptr<const GraphTopology> topology_;
+  std::shared_ptr<arrow::Table> node_properties_;
+  std::shared_ptr<arrow::Table> edge_properties_;
+  std::shared_ptr<const EntityTypeIDArray> node_entity_type_ids_;
+  std::shared_ptr<const EntityTypeIDArray> edge_entity_type_ids_;
+  // Copied since types are added to the managers of a graph in place
+  EntityTypeManager node_type_manager_;
+  EntityTypeManager edge_type_manager_;
+};
+
+/// Publish snapshots of a graph that a writer changes to readers on other
+/// threads. A reader pins the latest snapshot with Pin and reads it for as
+/// long as it likes; the writer meanwhile changes its PropertyGraph, which
+/// readers never touch, and calls Publish when the changes are complete,
+/// e.g., right after PropertyGraph::Commit. Neither waits for the other
+/// beyond swapping a pointer, and a snapshot is freed once the last reader
+/// pinning it lets go.
+///
+/// Publish must not run concurrently with changes to the graph it
+/// publishes; one writer thread at a time is the intended use.
+class KATANA_EXPORT SnapshotPublisher {
+public:
+  /// Publish a first snapshot of pg as version 0
+  static Result<std::unique_ptr<SnapshotPublisher>> Make(
+      const PropertyGraph& pg);
+
+  /// \return the latest published snapshot
+  std::shared_ptr<const GraphSnapshot> Pin() const;
+
+  /// Publish a snapshot of the current state of pg
+  /// \return the version of the new snapshot
+  Result<uint64_t> Publish(const PropertyGraph& pg);
+
+private:
+  SnapshotPublisher() = default;
+
+  mutable std::mutex mutex_;
+  std::shared_ptr<const GraphSnapshot> latest_;
+};
+
+}  // namespace katana
+
+#endif
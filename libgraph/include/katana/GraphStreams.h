@@ -0,0 +1,73 @@
+#ifndef KATANA_LIBGRAPH_KATANA_GRAPHSTREAMS_H_
+#define KATANA_LIBGRAPH_KATANA_GRAPHSTREAMS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/GraphSnapshot.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// What a graph stream carries
+enum class GraphStreamKind {
+  /// Rows of the node property table, e.g., the outputs of analytics
+  kNodeProperties,
+  /// Rows of the edge property table
+  kEdgeProperties,
+  /// One row per edge: src and dst nodes and the edge property row
+  kTopology,
+};
+
+/// One of num_partitions streams of a kind that together carry all of its
+/// rows; the partitions are contiguous ranges of about equal numbers of
+/// rows, so that clients can read them in parallel.
+struct KATANA_EXPORT GraphStreamTicket {
+  GraphStreamKind kind{GraphStreamKind::kNodeProperties};
+  uint32_t partition{0};
+  uint32_t num_partitions{1};
+  /// The property columns to stream, in order, or all of them if empty.
+  /// Ignored for kTopology.
+  std::vector<std::string> columns;
+
+  /// A string that Parse turns back into this ticket
+  std::string ToString() const;
+  static Result<GraphStreamTicket> Parse(const std::string& str);
+};
+
+/// The rows [first, second) of partition of num_partitions equal parts of
+/// num_rows rows
+KATANA_EXPORT std::pair<uint64_t, uint64_t> GraphStreamRows(
+    uint64_t num_rows, uint32_t partition, uint32_t num_partitions);
+
+/// The number of rows of kind in snapshot
+KATANA_EXPORT uint64_t
+GraphStreamNumRows(const GraphSnapshot& snapshot, GraphStreamKind kind);
+
+/// The schema of the record batches of the stream of ticket
+KATANA_EXPORT Result<std::shared_ptr<arrow::Schema>> GraphStreamSchema(
+    const GraphSnapshot& snapshot, const GraphStreamTicket& ticket);
+
+/// Read the stream of ticket from snapshot as record batches of at most
+/// max_batch_rows rows.
+///
+/// Batches of properties are zero copy slices of the property tables of
+/// the snapshot, and the dst column of topology batches is the destination
+/// array of its topology; only src and the property rows of edges are
+/// computed. Batches keep the snapshot alive, so they stay valid however
+/// the graph changes after the snapshot was taken.
+KATANA_EXPORT Result<std::shared_ptr<arrow::RecordBatchReader>>
+MakeGraphStreamReader(
+    std::shared_ptr<const GraphSnapshot> snapshot,
+    const GraphStreamTicket& ticket,
+    int64_t max_batch_rows = int64_t{1} << 16);
+
+}  // namespace katana
+
+#endif
@@ -1,19 +1,27 @@
 #ifndef KATANA_LIBGRAPH_KATANA_GRAPHTOPOLOGY_H_
 #define KATANA_LIBGRAPH_KATANA_GRAPHTOPOLOGY_H_
 
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <boost/iterator/counting_iterator.hpp>
 
 #include "arrow/util/bitmap.h"
+#include "katana/BloomFilter.h"
 #include "katana/CompileTimeIntrospection.h"
 #include "katana/DynamicBitset.h"
+#include "katana/GraphMemoryUsage.h"
 #include "katana/Iterators.h"
 #include "katana/Logging.h"
+#include "katana/MemoryPlacement.h"
 #include "katana/NUMAArray.h"
 #include "katana/RDGTopology.h"
+#include "katana/ReplicatedArray.h"
 #include "katana/Result.h"
 #include "katana/config.h"
 
@@ -45,6 +53,29 @@ struct KATANA_EXPORT GraphTopologyTypes {
   using EntityTypeIDVec = NUMAArray<EntityTypeID>;
 };
 
+/// A batch of edits to the edges of a topology. Deletions are applied
+/// before insertions, so a batch can replace the edges between two nodes.
+struct KATANA_EXPORT EdgeDeltas : public GraphTopologyTypes {
+  struct Insertion {
+    Node src;
+    Node dst;
+    /// the row of the new edge's properties and type
+    PropertyIndex prop_index;
+  };
+  /// removes every edge from src to dst
+  struct Deletion {
+    Node src;
+    Node dst;
+  };
+
+  std::vector<Insertion> insertions;
+  std::vector<Deletion> deletions;
+
+  bool empty() const noexcept {
+    return insertions.empty() && deletions.empty();
+  }
+};
+
 class KATANA_EXPORT EdgeShuffleTopology;
 class KATANA_EXPORT EdgeTypeAwareTopology;
 
@@ -68,6 +99,13 @@ public:
       const Edge* adj_indices, size_t num_nodes, const Node* dests,
       size_t num_edges) noexcept;
 
+  /// Copy adj_indices and dests into memory placed per placement. With
+  /// kBlocked each thread gets the nodes of an equal share of node ids and
+  /// the edges of those nodes.
+  GraphTopology(
+      const Edge* adj_indices, size_t num_nodes, const Node* dests,
+      size_t num_edges, MemoryPlacement placement) noexcept;
+
   GraphTopology(
       const Edge* adj_indices, size_t num_nodes, const Node* dests,
       size_t num_edges, const PropertyIndex* edge_prop_indices,
@@ -80,11 +118,24 @@ public:
       PropIndexVec&& edge_prop_indices,
       PropIndexVec&& node_prop_indices) noexcept;
 
+  /// Build a topology of arrays that view memory owned by mapping, e.g., a
+  /// mapped file, rather than memory of their own. The topology keeps mapping
+  /// alive as long as the topology lives.
+  GraphTopology(
+      AdjIndexVec&& adj_indices, EdgeDestVec&& dests,
+      PropIndexVec&& edge_prop_indices, PropIndexVec&& node_prop_indices,
+      std::shared_ptr<const void> mapping) noexcept;
+
   static GraphTopology Copy(const GraphTopology& that) noexcept;
 
   static GraphTopology CopyWithoutPropertyIndexes(
       const GraphTopology& that) noexcept;
 
+  /// \returns a copy of that with deltas applied. The kept out-edges of a
+  /// node stay in order and are followed by the inserted ones.
+  static GraphTopology MakePatched(
+      const GraphTopology& that, const EdgeDeltas& deltas) noexcept;
+
   uint64_t NumNodes() const noexcept { return adj_indices_.size(); }
 
   uint64_t NumEdges() const noexcept { return dests_.size(); }
@@ -93,6 +144,22 @@ public:
 
   const Node* DestData() const noexcept { return dests_.data(); }
 
+  /// \returns the NumEdges() property indexes of the out-edges, or nullptr
+  /// if each out-edge is its own property index
+  const PropertyIndex* EdgePropertyIndexData() const noexcept {
+    return edge_prop_indices_.empty() ? nullptr : edge_prop_indices_.data();
+  }
+
+  /// \returns the NumNodes() property indexes of the nodes, or nullptr if
+  /// each node is its own property index
+  const PropertyIndex* NodePropertyIndexData() const noexcept {
+    return node_prop_indices_.empty() ? nullptr : node_prop_indices_.data();
+  }
+
+  /// \returns the bytes of memory the arrays of the topology hold;
+  /// subclasses add those of their own arrays
+  virtual uint64_t SizeBytes() const noexcept;
+
   /// Checks equality against another instance of GraphTopology.
   /// WARNING: Expensive operation due to element-wise checks on large arrays
   /// @param that: GraphTopology instance to compare against
@@ -225,6 +292,10 @@ private:
   PropIndexVec& GetEdgePropIndices() noexcept { return edge_prop_indices_; }
   PropIndexVec& GetNodePropIndices() noexcept { return node_prop_indices_; }
 
+  /// The owner of the memory of the arrays below when they are views; it is
+  /// declared first so that it outlives them
+  std::shared_ptr<const void> mapping_;
+
   NUMAArray<Edge> adj_indices_;
   NUMAArray<Node> dests_;
 
@@ -243,6 +314,65 @@ private:
   PropIndexVec node_prop_indices_;
 };
 
+/// A read-only copy of the adjacency indices and destinations of a
+/// GraphTopology on every socket, for algorithms that read the topology at
+/// random from all sockets of a machine of several sockets. OutEdges and
+/// OutEdgeDst read the copy on the socket of the calling thread, which costs
+/// a socket lookup per call and one copy of the topology per socket;
+/// GraphTopology itself does not pay for it.
+///
+/// A ReplicatedTopology does not change once made, so threads may share it
+/// without locks. It does not follow later changes to the topology it was
+/// made from.
+class KATANA_EXPORT ReplicatedTopology : public GraphTopologyTypes {
+public:
+  ReplicatedTopology() = default;
+
+  static ReplicatedTopology Make(const GraphTopology& topo) noexcept;
+
+  uint64_t NumNodes() const noexcept { return adj_indices_.size(); }
+
+  uint64_t NumEdges() const noexcept { return dests_.size(); }
+
+  edges_range OutEdges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < NumNodes());
+    const Edge* adj_indices = adj_indices_.local();
+    edge_iterator e_beg{node > 0 ? adj_indices[node - 1] : 0};
+    edge_iterator e_end{adj_indices[node]};
+
+    return MakeStandardRange(e_beg, e_end);
+  }
+
+  Node OutEdgeDst(Edge edge_id) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(edge_id < NumEdges());
+    return dests_.local()[edge_id];
+  }
+
+  size_t OutDegree(Node node) const noexcept { return OutEdges(node).size(); }
+
+  nodes_range Nodes() const noexcept {
+    return MakeStandardRange<node_iterator>(
+        Node{0}, static_cast<Node>(NumNodes()));
+  }
+
+  node_iterator begin() const noexcept { return node_iterator(0); }
+
+  node_iterator end() const noexcept { return node_iterator(NumNodes()); }
+
+  size_t size() const noexcept { return NumNodes(); }
+
+  bool empty() const noexcept { return NumNodes() == 0; }
+
+  /// \returns the bytes of memory all the copies hold
+  uint64_t SizeBytes() const noexcept {
+    return adj_indices_.SizeBytes() + dests_.SizeBytes();
+  }
+
+private:
+  ReplicatedArray<Edge> adj_indices_;
+  ReplicatedArray<Node> dests_;
+};
+
 // TODO(amber): In the future, when we group properties e.g., by node or edge type,
 // this class might get merged with ShuffleTopology. Not doing it at the moment to
 // avoid having to keep unnecessary arrays like node_property_indices_
@@ -285,6 +415,12 @@ public:
            (kind == edge_sort_state());
   }
 
+  /// The edge property the edges are sorted by if edge_sort_state() is
+  /// kSortedByEdgeProperty, empty otherwise
+  const std::string& edge_sort_property() const noexcept {
+    return edge_sort_property_;
+  }
+
   using Base::GetLocalEdgeIDFromOutEdge;
 
   static std::shared_ptr<EdgeShuffleTopology> MakeTransposeCopy(
@@ -313,6 +449,29 @@ public:
 
   static std::shared_ptr<EdgeShuffleTopology> Make(RDGTopology* rdg_topo);
 
+  /// \returns the edges of pg, transposed if tpose_todo is kYes, with the
+  /// edges of each node sorted by the value of the numeric edge property
+  /// property_name and then by destination. Sorted by a weight, the edges
+  /// of a node lighter than some bound are a prefix of its edges.
+  static Result<std::shared_ptr<EdgeShuffleTopology>> MakeSortedByEdgeProperty(
+      const PropertyGraph* pg, const RDGTopology::TransposeKind& tpose_todo,
+      const std::string& property_name);
+
+  /// \returns a copy of that with deltas, given in the orientation of the
+  /// original graph, applied. Edges sorted by destination stay sorted, which
+  /// takes a merge per node rather than a sort; any other sort is lost.
+  static std::shared_ptr<EdgeShuffleTopology> MakePatched(
+      const EdgeShuffleTopology& that, const EdgeDeltas& deltas) noexcept;
+
+  /// \returns the edges of edge_type in topo, in the orientation of topo and
+  /// sorted by destination. The edges of one type of a node are contiguous
+  /// in an EdgeTypeAwareTopology, so they are copied a range at a time
+  /// without reading the type of each edge. The nodes and the property
+  /// indexes of the edges are those of topo; a type topo does not have
+  /// leaves no edges.
+  static std::shared_ptr<EdgeShuffleTopology> MakeOfEdgeType(
+      const EdgeTypeAwareTopology& topo, const EntityTypeID& edge_type);
+
   katana::Result<RDGTopology> ToRDGTopology() const;
 
   edge_iterator FindEdge(const Node& src, const Node& dst) const noexcept;
@@ -331,6 +490,11 @@ protected:
   void SortEdgesByDestType(
       const PropertyGraph* pg, const PropIndexVec& node_prop_indices) noexcept;
 
+  /// Sort the edges of each node by keys[property index of the edge], then
+  /// by destination
+  template <typename T>
+  void SortEdgesByKey(const T* keys) noexcept;
+
   void sortEdges(
       const PropertyGraph* pg,
       const RDGTopology::EdgeSortKind& edge_sort_todo) noexcept {
@@ -346,6 +510,11 @@ protected:
     case RDGTopology::EdgeSortKind::kSortedByNodeType:
       KATANA_LOG_FATAL("Not implemented yet");
       return;
+    case RDGTopology::EdgeSortKind::kSortedByEdgeProperty:
+      KATANA_LOG_FATAL(
+          "sorting by an edge property needs its name, see "
+          "MakeSortedByEdgeProperty");
+      return;
     default:
       KATANA_LOG_FATAL("switch-case fell through");
       return;
@@ -368,6 +537,7 @@ protected:
 private:
   RDGTopology::TransposeKind tpose_state_{RDGTopology::TransposeKind::kNo};
   RDGTopology::EdgeSortKind edge_sort_state_{RDGTopology::EdgeSortKind::kAny};
+  std::string edge_sort_property_;
 
   bool is_valid_ = true;
 };
@@ -404,9 +574,45 @@ public:
   static std::shared_ptr<ShuffleTopology> MakeSortedByDegree(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
 
+  /// Nodes sorted by type, each type in its previous order
   static std::shared_ptr<ShuffleTopology> MakeSortedByNodeType(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
 
+  /// \returns a copy of the loaded node properties of pg permuted to match
+  /// the nodes, where row i holds the properties of node i. Scans of the
+  /// nodes of a type in a topology sorted by node type then read their
+  /// properties sequentially instead of gathering them through the node
+  /// property index. The copy does not see later writes to the properties
+  /// of pg, so take it right before the scan.
+  Result<std::shared_ptr<arrow::Table>> PermutedNodeProperties(
+      const PropertyGraph* pg) const;
+
+  // The orders below only improve locality: neighbors get nearby node ids, so
+  // traversals over the topology touch fewer cache lines and pages. Node
+  // properties stay where they are and are reached through the node property
+  // index. All of them follow out-edges only, so they are best on symmetric
+  // graphs.
+
+  /// Reverse Cuthill-McKee order: a breadth first numbering of each
+  /// component, started from a node of least degree and taking the children
+  /// of a node in ascending degree, then reversed. It keeps the bandwidth of
+  /// the adjacency matrix small. Each level is numbered in parallel.
+  static std::shared_ptr<ShuffleTopology> MakeInReverseCuthillMcKeeOrder(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  /// Hub clustering: nodes of more than average degree first, then the rest,
+  /// each group in its previous order. The frequently visited hubs share
+  /// cache lines without destroying the locality already in the ids.
+  static std::shared_ptr<ShuffleTopology> MakeHubClustered(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  /// Community order: nodes grouped by the communities found by a few rounds
+  /// of synchronous label propagation, in the spirit of Rabbit order and
+  /// Gorder but much cheaper to compute. Within a community nodes keep their
+  /// previous order.
+  static std::shared_ptr<ShuffleTopology> MakeClusteredByCommunity(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
   static std::shared_ptr<ShuffleTopology> MakeFromTopo(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo,
       const RDGTopology::NodeSortKind& node_sort_todo,
@@ -423,6 +629,15 @@ public:
     case RDGTopology::NodeSortKind::kSortedByNodeType:
       ret = MakeSortedByNodeType(pg, seed_topo);
       break;
+    case RDGTopology::NodeSortKind::kReverseCuthillMcKee:
+      ret = MakeInReverseCuthillMcKeeOrder(pg, seed_topo);
+      break;
+    case RDGTopology::NodeSortKind::kHubClustered:
+      ret = MakeHubClustered(pg, seed_topo);
+      break;
+    case RDGTopology::NodeSortKind::kClusteredByCommunity:
+      ret = MakeClusteredByCommunity(pg, seed_topo);
+      break;
     default:
       KATANA_LOG_FATAL("switch case fell through");
     }
@@ -448,74 +663,20 @@ private:
         new_to_old.begin(), new_to_old.end(),
         GraphTopologyTypes::PropertyIndex{0});
 
-    katana::ParallelSTL::sort(
+    katana::ParallelSTL::sample_sort(
         new_to_old.begin(), new_to_old.end(),
         [&](const auto& i1, const auto& i2) { return cmp(i1, i2); });
 
-    GraphTopology::AdjIndexVec degrees;
-    degrees.allocateInterleaved(seed_topo.NumNodes());
-
-    NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
-    old_to_new_map.allocateInterleaved(seed_topo.NumNodes());
-
-    PropIndexVec node_prop_indices;
-    node_prop_indices.allocateInterleaved(seed_topo.NumNodes());
-
-    // TODO(amber): given 32-bit node ids, put a check here that
-    // new_to_old.size() < 2^32
-    katana::do_all(
-        katana::iterate(size_t{0}, new_to_old.size()),
-        [&](auto i) {
-          // new_to_old[i] gives old node id
-          old_to_new_map[new_to_old[i]] = i;
-          degrees[i] = seed_topo.OutDegree(new_to_old[i]);
-          node_prop_indices[i] = seed_topo.GetNodePropertyIndex(new_to_old[i]);
-        },
-        katana::no_stats());
-
-    KATANA_LOG_DEBUG_ASSERT(
-        std::is_sorted(degrees.begin(), degrees.end(), std::greater<>()));
-
-    katana::ParallelSTL::partial_sum(
-        degrees.begin(), degrees.end(), degrees.begin());
-
-    GraphTopologyTypes::EdgeDestVec new_dest_vec;
-    new_dest_vec.allocateInterleaved(seed_topo.NumEdges());
-
-    GraphTopologyTypes::PropIndexVec edge_prop_indices;
-    edge_prop_indices.allocateInterleaved(seed_topo.NumEdges());
-
-    katana::do_all(
-        katana::iterate(seed_topo.Nodes()),
-        [&](auto old_src_id) {
-          auto new_srd_id = old_to_new_map[old_src_id];
-          auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
-
-          for (auto e : seed_topo.OutEdges(old_src_id)) {
-            auto new_edge_dest = old_to_new_map[seed_topo.OutEdgeDst(e)];
-            KATANA_LOG_DEBUG_ASSERT(new_edge_dest < seed_topo.NumNodes());
-
-            auto new_edge_id = new_out_index;
-            ++new_out_index;
-            KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
-
-            new_dest_vec[new_edge_id] = new_edge_dest;
-
-            // copy over edge_property_index mapping from old edge to new edge
-            edge_prop_indices[new_edge_id] =
-                seed_topo.GetEdgePropertyIndexFromOutEdge(e);
-          }
-          KATANA_LOG_DEBUG_ASSERT(new_out_index == degrees[new_srd_id]);
-        },
-        katana::steal(), katana::no_stats());
-
-    return std::make_shared<ShuffleTopology>(ShuffleTopology{
-        seed_topo.transpose_state(), node_sort_todo,
-        seed_topo.edge_sort_state(), std::move(degrees),
-        std::move(node_prop_indices), std::move(new_dest_vec),
-        std::move(edge_prop_indices)});
+    return MakeNodePermutedTopo(seed_topo, new_to_old, node_sort_todo);
   }
 
+  /// Renumber the nodes of seed_topo so that node i is seed_topo's node
+  /// new_to_old[i]; edges keep their order within each node
+  static std::shared_ptr<ShuffleTopology> MakeNodePermutedTopo(
+      const EdgeShuffleTopology& seed_topo,
+      const GraphTopology::PropIndexVec& new_to_old,
+      const RDGTopology::NodeSortKind& node_sort_todo);
+
   ShuffleTopology(
       const RDGTopology::TransposeKind& tpose_todo,
       const RDGTopology::NodeSortKind& node_sort_todo,
@@ -583,6 +744,9 @@ public:
 
   size_t num_unique_types() const noexcept { return index_to_type_map_.size(); }
 
+  /// \returns an estimate of the bytes of memory of the maps
+  uint64_t SizeBytes() const noexcept;
+
   /// @param edge_type: edge_type to check
   /// @returns true iff there exists some edge in the graph with that edge_type
   bool has_edge_type_id(const EntityTypeID& edge_type) const noexcept {
@@ -635,6 +799,94 @@ private:
   bool is_valid_ = true;
 };
 
+/// An index over the out-edges of the high degree nodes of a topology whose
+/// edges are sorted by destination that answers whether an edge exists in
+/// constant time. A node with at least kMinDegree out-edges gets a bitmap
+/// over all nodes if at least one in kBitmapDensity nodes is its neighbor
+/// and an open-addressing hash set of its destinations otherwise, so the index
+/// takes at most 4 bytes per bitmap edge and 16 bytes per hashed edge. For
+/// the other nodes, Covers is false and a search of the out-edges is cheap;
+/// a blocked Bloom filter over the edges of those with at least
+/// kMinFilteredDegree out-edges, at about 10 bits per edge, lets MayContain
+/// reject most absent edges before the search.
+class KATANA_EXPORT EdgeLookupIndex : public GraphTopologyTypes {
+public:
+  static constexpr uint64_t kMinDegree = 32;
+  static constexpr uint64_t kBitmapDensity = 32;
+  static constexpr uint64_t kMinFilteredDegree = 4;
+
+  EdgeLookupIndex() = default;
+  EdgeLookupIndex(EdgeLookupIndex&&) = default;
+  EdgeLookupIndex& operator=(EdgeLookupIndex&&) = default;
+
+  EdgeLookupIndex(const EdgeLookupIndex&) = delete;
+  EdgeLookupIndex& operator=(const EdgeLookupIndex&) = delete;
+
+  /// Build the index of topo in parallel
+  static std::shared_ptr<EdgeLookupIndex> Make(
+      const EdgeShuffleTopology& topo) noexcept;
+
+  bool Covers(Node src) const noexcept {
+    return kinds_[src] >= Kind::kBitmap;
+  }
+
+  /// \returns false if there is no edge from src to dst; src must not be
+  /// covered
+  bool MayContain(Node src, Node dst) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(!Covers(src));
+    return kinds_[src] != Kind::kFiltered ||
+           filter_.MayContain(EdgeHash(src, dst));
+  }
+
+  /// \returns true iff there is an edge from src to dst; src must be covered
+  bool Contains(Node src, Node dst) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(Covers(src));
+    const uint64_t* words = words_.data() + offsets_[src];
+    if (kinds_[src] == Kind::kBitmap) {
+      return (words[dst / 64] >> (dst % 64)) & 1;
+    }
+    const auto* slots = reinterpret_cast<const Node*>(words);
+    uint64_t mask = (offsets_[src + 1] - offsets_[src]) * 2 - 1;
+    for (uint64_t i = HashSlot(dst, mask);; i = (i + 1) & mask) {
+      if (slots[i] == dst) {
+        return true;
+      }
+      if (slots[i] == kEmptySlot) {
+        return false;
+      }
+    }
+  }
+
+  /// \returns the number of bytes of the per node kinds and offsets, the
+  /// bitmaps and hash sets, and the filter
+  uint64_t SizeBytes() const noexcept {
+    return kinds_.size() * sizeof(Kind) +
+           (offsets_.size() + words_.size()) * sizeof(uint64_t) +
+           filter_.SizeBytes();
+  }
+
+private:
+  /// Covered nodes have the kinds from kBitmap on
+  enum class Kind : uint8_t { kNone, kFiltered, kBitmap, kHash };
+
+  static uint64_t EdgeHash(Node src, Node dst) noexcept {
+    return BloomFilter::Hash((uint64_t{src} << 32) | dst);
+  }
+
+  static constexpr Node kEmptySlot = std::numeric_limits<Node>::max();
+
+  static uint64_t HashSlot(Node dst, uint64_t mask) noexcept {
+    // Fibonacci hashing spreads consecutive ids, which sorted inputs have
+    return ((dst * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & mask;
+  }
+
+  NUMAArray<Kind> kinds_;
+  /// where the words of each node start in words_, NumNodes() + 1 entries
+  NUMAArray<uint64_t> offsets_;
+  NUMAArray<uint64_t> words_;
+  BloomFilter filter_;
+};
+
 /// store adjacency indices per each node such that they are divided by edge edge_type type.
 /// Requires sorting the graph by edge edge_type type
 class KATANA_EXPORT EdgeTypeAwareTopology : public EdgeShuffleTopology {
@@ -649,6 +901,12 @@ public:
 
   virtual ~EdgeTypeAwareTopology();
 
+  /// Includes the per type adjacency indices but not the shared edge type
+  /// index
+  uint64_t SizeBytes() const noexcept override {
+    return Base::SizeBytes() + per_type_adj_indices_.size() * sizeof(Edge);
+  }
+
   static std::shared_ptr<EdgeTypeAwareTopology> MakeFrom(
       const PropertyGraph* pg,
       std::shared_ptr<const CondensedTypeIDMap> edge_type_index,
@@ -914,6 +1172,14 @@ public:
     return topo().OutEdgeDst(eid);
   }
 
+  /// \returns the destinations of the out-edges of src as an array of
+  /// OutDegree(src) nodes in edge order, which is increasing in views with
+  /// edges sorted by destination, e.g., for the intersections in
+  /// katana/SortedIntersection.h
+  const Node* OutEdgeDsts(const Node& src) const noexcept {
+    return topo().DestData() + *topo().OutEdges(src).begin();
+  }
+
   auto GetEdgeSrc(const Edge& eid) const noexcept {
     return topo().GetEdgeSrc(eid);
   }
@@ -952,6 +1218,12 @@ public:
   }
   void Print() const noexcept { topo_ptr_->Print(); }
 
+  /// The topology of the view, which outlives the view cache entry it came
+  /// from for as long as it is held
+  const std::shared_ptr<const Topo>& topo_ptr() const noexcept {
+    return topo_ptr_;
+  }
+
 protected:
   const Topo& topo() const noexcept { return *topo_ptr_.get(); }
 
@@ -1168,6 +1440,33 @@ public:
   }
 };
 
+/// A SortedTopologyWrapper whose HasEdge looks up high degree nodes in an
+/// EdgeLookupIndex and screens the others with its filter
+template <typename Topo>
+class IndexedSortedTopologyWrapper : public SortedTopologyWrapper<Topo> {
+  using Base = SortedTopologyWrapper<Topo>;
+
+public:
+  using typename Base::Node;
+
+  IndexedSortedTopologyWrapper(
+      std::shared_ptr<const Topo> t,
+      std::shared_ptr<const EdgeLookupIndex> index) noexcept
+      : Base(std::move(t)), index_(std::move(index)) {
+    KATANA_LOG_DEBUG_ASSERT(index_);
+  }
+
+  bool HasEdge(const Node& src, const Node& dst) const noexcept {
+    if (index_->Covers(src)) {
+      return index_->Contains(src, dst);
+    }
+    return index_->MayContain(src, dst) && Base::HasEdge(src, dst);
+  }
+
+private:
+  std::shared_ptr<const EdgeLookupIndex> index_;
+};
+
 class KATANA_EXPORT EdgeTypeAwareBiDirTopology
     : public BasicBiDirTopoWrapper<
           EdgeTypeAwareTopology, EdgeTypeAwareTopology> {
@@ -1450,6 +1749,30 @@ struct PGViewBuilder<PGViewEdgesSortedByDestID> {
   }
 };
 
+// Edges sorted by destination view with constant time HasEdge
+
+using EdgesSortedByDestIndexedTopology =
+    IndexedSortedTopologyWrapper<EdgeShuffleTopology>;
+using PGViewEdgesSortedByDestIDIndexed =
+    BasicPropGraphViewWrapper<EdgesSortedByDestIndexedTopology>;
+
+template <>
+struct PGViewBuilder<PGViewEdgesSortedByDestIDIndexed> {
+  template <typename ViewCache>
+  static PGViewEdgesSortedByDestIDIndexed BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetEdgeShuffTopo(
+        pg, RDGTopology::TransposeKind::kNo,
+        RDGTopology::EdgeSortKind::kSortedByDestID);
+
+    viewCache.ReseatDefaultTopo(sorted_topo);
+
+    auto index = viewCache.BuildOrGetEdgeLookupIndex(sorted_topo);
+    return PGViewEdgesSortedByDestIDIndexed{
+        pg, EdgesSortedByDestIndexedTopology{sorted_topo, index}};
+  }
+};
+
 // Nodes sorted by degree, edges sorted by destination view
 
 using NodesSortedByDegreeEdgesSortedByDestIDTopology =
@@ -1472,6 +1795,60 @@ struct PGViewBuilder<PGViewNodesSortedByDegreeEdgesSortedByDestID> {
   }
 };
 
+// Nodes sorted by type, edges sorted by type view
+
+using NodesSortedByNodeTypeEdgesSortedByEdgeTypeTopology =
+    BasicTopologyWrapper<ShuffleTopology>;
+using PGViewNodesSortedByNodeTypeEdgesSortedByEdgeType =
+    BasicPropGraphViewWrapper<
+        NodesSortedByNodeTypeEdgesSortedByEdgeTypeTopology>;
+
+template <>
+struct PGViewBuilder<PGViewNodesSortedByNodeTypeEdgesSortedByEdgeType> {
+  template <typename ViewCache>
+  static PGViewNodesSortedByNodeTypeEdgesSortedByEdgeType BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetShuffTopo(
+        pg, RDGTopology::TransposeKind::kNo,
+        RDGTopology::NodeSortKind::kSortedByNodeType,
+        RDGTopology::EdgeSortKind::kSortedByEdgeType);
+
+    return PGViewNodesSortedByNodeTypeEdgesSortedByEdgeType{
+        pg, NodesSortedByNodeTypeEdgesSortedByEdgeTypeTopology{sorted_topo}};
+  }
+};
+
+// Nodes in a locality improving order, edges sorted by destination view
+
+template <RDGTopology::NodeSortKind kNodeOrder>
+class NodesInLocalityOrderTopology
+    : public SortedTopologyWrapper<ShuffleTopology> {
+  using Base = SortedTopologyWrapper<ShuffleTopology>;
+
+public:
+  explicit NodesInLocalityOrderTopology(
+      std::shared_ptr<const ShuffleTopology> t) noexcept
+      : Base(std::move(t)) {}
+};
+
+template <RDGTopology::NodeSortKind kNodeOrder>
+using PGViewNodesInLocalityOrder =
+    BasicPropGraphViewWrapper<NodesInLocalityOrderTopology<kNodeOrder>>;
+
+template <RDGTopology::NodeSortKind kNodeOrder>
+struct PGViewBuilder<PGViewNodesInLocalityOrder<kNodeOrder>> {
+  template <typename ViewCache>
+  static PGViewNodesInLocalityOrder<kNodeOrder> BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetShuffTopo(
+        pg, RDGTopology::TransposeKind::kNo, kNodeOrder,
+        RDGTopology::EdgeSortKind::kSortedByDestID);
+
+    return PGViewNodesInLocalityOrder<kNodeOrder>{
+        pg, NodesInLocalityOrderTopology<kNodeOrder>{sorted_topo}};
+  }
+};
+
 // Bidirectional view
 
 using SimpleBiDirTopology =
@@ -1543,12 +1920,40 @@ struct PropertyGraphViews {
   using BiDirectional = internal::PGViewBiDirectional;
   using Undirected = internal::PGViewUnDirected;
   using EdgesSortedByDestID = internal::PGViewEdgesSortedByDestID;
+  /// EdgesSortedByDestID with an EdgeLookupIndex for HasEdge, built the first
+  /// time the view is asked for and cached with the topology
+  using EdgesSortedByDestIDIndexed = internal::PGViewEdgesSortedByDestIDIndexed;
   using EdgeTypeAwareBiDir = internal::PGViewEdgeTypeAwareBiDir;
   using NodesSortedByDegreeEdgesSortedByDestID =
       internal::PGViewNodesSortedByDegreeEdgesSortedByDestID;
+  /// Stored with the graph, this view's topology lets
+  /// PropertyGraph::MakeProjectedGraph read only the projected node types
+  using NodesSortedByNodeTypeEdgesSortedByEdgeType =
+      internal::PGViewNodesSortedByNodeTypeEdgesSortedByEdgeType;
+  /// Views over a renumbering of the nodes that puts neighbors close
+  /// together, see ShuffleTopology::MakeInReverseCuthillMcKeeOrder and its
+  /// siblings. Edges are sorted by destination. Like every derived topology
+  /// they are stored with the graph so they are only computed once.
+  using NodesInReverseCuthillMcKeeOrder = internal::PGViewNodesInLocalityOrder<
+      RDGTopology::NodeSortKind::kReverseCuthillMcKee>;
+  using NodesHubClustered = internal::PGViewNodesInLocalityOrder<
+      RDGTopology::NodeSortKind::kHubClustered>;
+  using NodesClusteredByCommunity = internal::PGViewNodesInLocalityOrder<
+      RDGTopology::NodeSortKind::kClusteredByCommunity>;
 };
 
 class KATANA_EXPORT PGViewCache {
+public:
+  /// Which cached derived topologies ToRDGTopology hands to Write and Commit
+  enum class PersistPolicy {
+    /// none; every process builds the derived topologies it needs
+    kNone,
+    /// those built since the graph was loaded or last written; topologies
+    /// loaded from storage are already there and are not rewritten
+    kNewlyBuilt,
+  };
+
+private:
   std::shared_ptr<GraphTopology> original_topo_{
       std::make_shared<GraphTopology>()};
 
@@ -1557,6 +1962,17 @@ class KATANA_EXPORT PGViewCache {
   std::vector<std::shared_ptr<EdgeTypeAwareTopology>> edge_type_aware_topos_;
   std::shared_ptr<CondensedTypeIDMap> edge_type_id_map_;
   // TODO(amber): define a node_type_id_map_;
+  /// lookup indices and the topology each one was built from; indices of
+  /// topologies that are gone are dropped when the next one is built
+  std::vector<std::pair<
+      std::weak_ptr<const EdgeShuffleTopology>,
+      std::shared_ptr<EdgeLookupIndex>>>
+      edge_lookup_indices_;
+
+  /// cached topologies that are already in the RDG, either because they were
+  /// loaded from it or because they have been written since they were built
+  std::unordered_set<const GraphTopology*> stored_topos_;
+  PersistPolicy persist_policy_{PersistPolicy::kNewlyBuilt};
 
   template <typename>
   friend struct internal::PGViewBuilder;
@@ -1577,8 +1993,31 @@ public:
     return internal::PGViewBuilder<PGView>::BuildView(pg, *this);
   }
 
+  /// \returns the cached derived topologies that should be stored with the
+  /// graph under the current PersistPolicy
   katana::Result<std::vector<RDGTopology>> ToRDGTopology();
 
+  /// Note that everything returned by ToRDGTopology has been stored, so
+  /// later writes do not store it again
+  void MarkTopologiesStored() noexcept;
+
+  /// \returns every cached derived topology whatever the PersistPolicy,
+  /// e.g., for a graph image. Each edge type aware topology is preceded by
+  /// the edge shuffle topology it extends, which is not cached on its own.
+  /// The results point into the cached topologies.
+  katana::Result<std::vector<RDGTopology>> CachedRDGTopologies() const;
+
+  /// Cache the topologies returned by CachedRDGTopologies of a graph with
+  /// the same default topology and entity types as pg. Their arrays are
+  /// copied, so rdg_topos may go away afterwards.
+  katana::Result<void> AddRDGTopologies(
+      const PropertyGraph* pg, std::vector<RDGTopology>* rdg_topos);
+
+  PersistPolicy persist_policy() const noexcept { return persist_policy_; }
+  void set_persist_policy(PersistPolicy policy) noexcept {
+    persist_policy_ = policy;
+  }
+
   template <typename PGView>
   PGView BuildView(
       const PropertyGraph* pg, const std::vector<std::string>& node_types,
@@ -1587,12 +2026,47 @@ public:
         pg, node_types, edge_types, *this);
   }
 
+  /// \returns the out-edges (kNo) or in-edges (kYes) of edge_type, see
+  /// EdgeShuffleTopology::MakeOfEdgeType. The edge type aware topology it
+  /// is built from is cached; the result is not.
+  std::shared_ptr<EdgeShuffleTopology> BuildEdgeTypeTopo(
+      PropertyGraph* pg, const RDGTopology::TransposeKind& tpose_kind,
+      const EntityTypeID& edge_type) noexcept;
+
+  /// \returns the out-edges (kNo) or in-edges (kYes) of pg with the edges
+  /// of each node sorted by the edge property name, see
+  /// EdgeShuffleTopology::MakeSortedByEdgeProperty. Like the other cached
+  /// topologies, the result is stored with the graph and loaded from it.
+  Result<std::shared_ptr<EdgeShuffleTopology>> BuildOrGetEdgesSortedByProperty(
+      PropertyGraph* pg, const RDGTopology::TransposeKind& tpose_kind,
+      const std::string& name);
+
+  /// Drop the cached topologies sorted by the edge property name, e.g.,
+  /// after its values changed
+  void DropTopologiesSortedBy(const std::string& name) noexcept;
+
   // Avoids a copy of the default topology.
   const GraphTopology& GetDefaultTopologyRef() const noexcept;
 
+  /// The default topology, kept alive by the caller after this cache
+  /// replaces it, e.g., by ApplyEdgeDeltas
+  std::shared_ptr<const GraphTopology> ShareDefaultTopology() const noexcept {
+    return original_topo_;
+  }
+
   // Purge cache and construct an empty topology as the default one.
   void DropAllTopologies() noexcept;
 
+  /// Apply deltas to the default topology in a pass over its edges. The
+  /// cached topologies it derives are dropped and rebuilt when a view next
+  /// asks for them.
+  void ApplyEdgeDeltas(const EdgeDeltas& deltas) noexcept;
+
+  /// \returns the bytes of memory of each cached derived topology and index,
+  /// named after its kind. The default topology is not included, even when
+  /// it is one of the cached topologies.
+  std::vector<MemoryUsageItem> GetMemoryUsage() const;
+
 private:
   std::shared_ptr<GraphTopology> GetDefaultTopology() const noexcept;
 
@@ -1623,6 +2097,9 @@ private:
 
   std::shared_ptr<EdgeTypeAwareTopology> BuildOrGetEdgeTypeAwareTopo(
       PropertyGraph* pg, const RDGTopology::TransposeKind& tpose_kind) noexcept;
+
+  std::shared_ptr<EdgeLookupIndex> BuildOrGetEdgeLookupIndex(
+      const std::shared_ptr<EdgeShuffleTopology>& topo) noexcept;
 };
 
 /// Creates a uniform-random CSR GraphTopology instance, where each node as
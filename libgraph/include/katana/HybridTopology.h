@@ -0,0 +1,159 @@
+#ifndef KATANA_LIBGRAPH_KATANA_HYBRIDTOPOLOGY_H_
+#define KATANA_LIBGRAPH_KATANA_HYBRIDTOPOLOGY_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A read-only topology laid out for power-law graphs. Each node has a
+/// record of one cache line that holds the destinations of up to
+/// kInlineDegree out-edges, so visiting a low-degree node touches a single
+/// cache line instead of an index array and a destination array. The
+/// destinations of higher degree nodes live in a separate array, one
+/// contiguous segment per node.
+///
+/// Destinations are sorted within each node. The out-edges of a node keep
+/// the range of ids [first, first + degree) they had in the CSR they were
+/// built from, but sorting moves edges within that range, so an edge id
+/// names a different edge than in the seed unless the seed was already
+/// sorted by destination. Node ids and property indexes do carry over:
+/// reach edge properties through GetEdgePropertyIndexFromOutEdge, never
+/// through the edge id. Since the out-edges of a node are not reached
+/// through a global destination array, an Edge here is a handle to the
+/// edge's destination that converts to the edge id.
+///
+/// No PropertyGraph view is backed by a HybridTopology; algorithms that
+/// want one build it from the topology of a view with Make.
+class KATANA_EXPORT HybridTopology {
+public:
+  using Node = GraphTopologyTypes::Node;
+  using PropertyIndex = GraphTopologyTypes::PropertyIndex;
+  using nodes_range = GraphTopologyTypes::nodes_range;
+
+  /// Out-edges with at most this many edges are stored in the node record
+  static constexpr uint32_t kInlineDegree = 11;
+
+  class edge_iterator;
+
+  class Edge {
+  public:
+    Edge() = default;
+    Edge(GraphTopologyTypes::Edge id, const Node* dst) noexcept
+        : id_(id), dst_(dst) {}
+
+    GraphTopologyTypes::Edge id() const noexcept { return id_; }
+    operator GraphTopologyTypes::Edge() const noexcept { return id_; }
+
+  private:
+    friend class HybridTopology;
+    friend class edge_iterator;
+
+    GraphTopologyTypes::Edge id_{0};
+    const Node* dst_{nullptr};
+  };
+
+  /// Like boost::counting_iterator, dereferencing gives a reference to the
+  /// iterator's own current edge
+  class edge_iterator
+      : public boost::iterator_facade<
+            edge_iterator, const Edge, boost::random_access_traversal_tag> {
+  public:
+    edge_iterator() = default;
+    edge_iterator(GraphTopologyTypes::Edge id, const Node* dst) noexcept
+        : current_(id, dst) {}
+
+  private:
+    friend class boost::iterator_core_access;
+
+    const Edge& dereference() const noexcept { return current_; }
+    bool equal(const edge_iterator& that) const noexcept {
+      return current_.id_ == that.current_.id_;
+    }
+    void increment() noexcept { advance(1); }
+    void decrement() noexcept { advance(-1); }
+    void advance(std::ptrdiff_t n) noexcept {
+      current_.id_ += n;
+      current_.dst_ += n;
+    }
+    std::ptrdiff_t distance_to(const edge_iterator& that) const noexcept {
+      return static_cast<std::ptrdiff_t>(that.current_.id_ - current_.id_);
+    }
+
+    Edge current_;
+  };
+
+  using edges_range = StandardRange<edge_iterator>;
+
+  HybridTopology() = default;
+  HybridTopology(HybridTopology&&) = default;
+  HybridTopology& operator=(HybridTopology&&) = default;
+
+  HybridTopology(const HybridTopology&) = delete;
+  HybridTopology& operator=(const HybridTopology&) = delete;
+
+  /// Lay out seed in parallel. The result does not refer to seed.
+  static HybridTopology Make(const GraphTopology& seed) noexcept;
+
+  uint64_t NumNodes() const noexcept { return records_.size(); }
+
+  uint64_t NumEdges() const noexcept { return edge_prop_indices_.size(); }
+
+  nodes_range Nodes() const noexcept {
+    return MakeStandardRange<GraphTopologyTypes::node_iterator>(
+        Node{0}, static_cast<Node>(NumNodes()));
+  }
+
+  edges_range OutEdges(Node node) const noexcept {
+    const NodeRecord& record = records_[node];
+    const Node* dsts = record.degree <= kInlineDegree
+                           ? record.inline_dests
+                           : hub_dests_.data() + record.segment_begin;
+    return MakeStandardRange(
+        edge_iterator{record.first_edge, dsts},
+        edge_iterator{record.first_edge + record.degree, dsts + record.degree});
+  }
+
+  Node OutEdgeDst(const Edge& edge) const noexcept { return *edge.dst_; }
+
+  size_t OutDegree(Node node) const noexcept { return records_[node].degree; }
+
+  PropertyIndex GetEdgePropertyIndexFromOutEdge(
+      const Edge& edge) const noexcept {
+    return edge_prop_indices_[edge.id_];
+  }
+
+  PropertyIndex GetNodePropertyIndex(Node node) const noexcept {
+    return node_prop_indices_[node];
+  }
+
+  /// \returns the number of nodes whose out-edges are not inline
+  uint64_t NumHubs() const noexcept { return num_hubs_; }
+
+private:
+  struct alignas(64) NodeRecord {
+    GraphTopologyTypes::Edge first_edge;
+    /// where the destinations of a node with more than kInlineDegree
+    /// out-edges start in hub_dests_
+    uint64_t segment_begin;
+    uint32_t degree;
+    Node inline_dests[kInlineDegree];
+  };
+  static_assert(sizeof(NodeRecord) == 64);
+
+  NUMAArray<NodeRecord> records_;
+  GraphTopologyTypes::EdgeDestVec hub_dests_;
+  GraphTopologyTypes::PropIndexVec edge_prop_indices_;
+  GraphTopologyTypes::PropIndexVec node_prop_indices_;
+  uint64_t num_hubs_{0};
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef KATANA_LIBGRAPH_KATANA_HYPERGRAPHTOPOLOGY_H_
+#define KATANA_LIBGRAPH_KATANA_HYPERGRAPHTOPOLOGY_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/Range.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A read-only hypergraph over a bipartite graph whose nodes are either
+/// nets (hyperedges) or pins (the vertices the nets connect). An edge in
+/// either direction between a net and a pin puts the pin on the net; edges
+/// between two nets or two pins are ignored. The hypergraph is stored as
+/// two CSRs, the pins of each net and the nets of each pin, so that both
+/// the moves of a partitioner and the gains of the moves are scans of
+/// contiguous arrays.
+///
+/// Nets and pins are numbered from 0 separately, in the order of their
+/// nodes. The pins of a net and the nets of a pin are sorted and distinct.
+class KATANA_EXPORT HyperGraphTopology {
+public:
+  using Node = GraphTopologyTypes::Node;
+  using Net = uint32_t;
+  using Pin = uint32_t;
+  using pins_range = StandardRange<const Pin*>;
+  using nets_range = StandardRange<const Net*>;
+
+  HyperGraphTopology() = default;
+  HyperGraphTopology(HyperGraphTopology&&) = default;
+  HyperGraphTopology& operator=(HyperGraphTopology&&) = default;
+
+  HyperGraphTopology(const HyperGraphTopology&) = delete;
+  HyperGraphTopology& operator=(const HyperGraphTopology&) = delete;
+
+  /// Build the hypergraph whose nets are the nodes of pg of the atomic node
+  /// type net_node_type and whose pins are the other nodes
+  static Result<HyperGraphTopology> Make(
+      const PropertyGraph* pg, const std::string& net_node_type);
+
+  /// Build the hypergraph whose nets are the nodes n of topology for which
+  /// is_net[n] is not 0 and whose pins are the other nodes, in parallel. The
+  /// result does not refer to topology or is_net.
+  static HyperGraphTopology Make(
+      const GraphTopology& topology, const uint8_t* is_net) noexcept;
+
+  uint32_t NumNets() const noexcept { return net_nodes_.size(); }
+
+  uint32_t NumPins() const noexcept { return pin_nodes_.size(); }
+
+  /// \returns the number of (net, pin) pairs where the pin is on the net
+  uint64_t NumIncidences() const noexcept { return net_pins_.size(); }
+
+  pins_range Pins(Net net) const noexcept {
+    return MakeStandardRange(
+        net_pins_.data() + NetBegin(net), net_pins_.data() + net_ends_[net]);
+  }
+
+  nets_range Nets(Pin pin) const noexcept {
+    return MakeStandardRange(
+        pin_nets_.data() + PinBegin(pin), pin_nets_.data() + pin_ends_[pin]);
+  }
+
+  uint64_t NetSize(Net net) const noexcept {
+    return net_ends_[net] - NetBegin(net);
+  }
+
+  uint64_t PinDegree(Pin pin) const noexcept {
+    return pin_ends_[pin] - PinBegin(pin);
+  }
+
+  Node NetNode(Net net) const noexcept { return net_nodes_[net]; }
+
+  Node PinNode(Pin pin) const noexcept { return pin_nodes_[pin]; }
+
+  bool IsNetNode(Node node) const noexcept { return is_net_[node]; }
+
+  /// \returns the net number of node if it is a net and its pin number
+  /// otherwise
+  uint32_t IdOfNode(Node node) const noexcept { return node_ids_[node]; }
+
+private:
+  uint64_t NetBegin(Net net) const noexcept {
+    return net == 0 ? 0 : net_ends_[net - 1];
+  }
+
+  uint64_t PinBegin(Pin pin) const noexcept {
+    return pin == 0 ? 0 : pin_ends_[pin - 1];
+  }
+
+  /// The end of the pins of each net in net_pins_
+  NUMAArray<uint64_t> net_ends_;
+  NUMAArray<Pin> net_pins_;
+  /// The end of the nets of each pin in pin_nets_
+  NUMAArray<uint64_t> pin_ends_;
+  NUMAArray<Net> pin_nets_;
+
+  NUMAArray<Node> net_nodes_;
+  NUMAArray<Node> pin_nodes_;
+  NUMAArray<uint8_t> is_net_;
+  NUMAArray<uint32_t> node_ids_;
+};
+
+}  // namespace katana
+
+#endif
@@ -437,6 +437,12 @@ public:
     }
   }
 
+  /// Allocate for the topology of a PropertyGraph with the same NUMA
+  /// placement as allocateFrom(FileGraph&)
+  void allocateFrom(const GraphTopology& topology) {
+    allocateFrom(topology.NumNodes(), topology.NumEdges());
+  }
+
   void allocateFrom(uint32_t nNodes, uint64_t nEdges) {
     numNodes = nNodes;
     numEdges = nEdges;
@@ -700,6 +706,42 @@ public:
     }
   }
 
+  /// Construct the share tid of total of the nodes of topology, divided by
+  /// the same node and edge weights as constructFrom(FileGraph&), so that
+  /// each thread first touches the pages it later works on. Edge e gets the
+  /// data edge_value(e), which is not called when EdgeTy is void.
+  template <typename EdgeValueFn>
+  void constructFrom(
+      const GraphTopology& topology, unsigned tid, unsigned total,
+      EdgeValueFn edge_value) {
+    const uint64_t* adj = topology.AdjData();
+    const uint32_t* dests = topology.DestData();
+    auto r = katana::DivideNodesBinarySearch(
+                 numNodes, numEdges,
+                 NodeData::size_of::value + EdgeIndData::size_of::value +
+                     LC_CSR_Graph::size_of_out_of_line::value,
+                 EdgeDst::size_of::value + EdgeData::size_of::value, tid,
+                 total, adj)
+                 .first;
+
+    this->setLocalRange(*r.first, *r.second);
+
+    for (auto ii = r.first, ei = r.second; ii != ei; ++ii) {
+      uint32_t n = *ii;
+      nodeData.constructAt(n);
+      edgeIndData[n] = adj[n];
+
+      this->outOfLineConstructAt(n);
+
+      for (uint64_t e = n == 0 ? 0 : adj[n - 1]; e < adj[n]; ++e) {
+        if constexpr (EdgeData::has_value) {
+          edgeData.set(e, edge_value(e));
+        }
+        edgeDst[e] = dests[e];
+      }
+    }
+  }
+
   /**
    * Returns the reference to the edgeIndData NUMAArray
    * (a prefix sum of edges)
@@ -24,6 +24,7 @@
 
 #include "katana/Details.h"
 #include "katana/FileGraph.h"
+#include "katana/GraphHelpers.h"
 #include "katana/NUMAArray.h"
 #include "katana/config.h"
 
@@ -345,6 +346,23 @@ public:
     }
   }
 
+  /// Allocate for the topology of a PropertyGraph with the same NUMA
+  /// placement as allocateFrom(FileGraph&)
+  void allocateFrom(const GraphTopology& topology) {
+    numNodes = topology.NumNodes();
+    numEdges = topology.NumEdges();
+
+    if (UseNumaAlloc) {
+      nodeData.allocateBlocked(numNodes);
+      edgeData.allocateBlocked(numEdges);
+      this->outOfLineAllocateBlocked(numNodes);
+    } else {
+      nodeData.allocateInterleaved(numNodes);
+      edgeData.allocateInterleaved(numEdges);
+      this->outOfLineAllocateInterleaved(numNodes);
+    }
+  }
+
   void constructFrom(FileGraph& graph, unsigned tid, unsigned total) {
     auto r = graph
                  .divideByNode(
@@ -371,6 +389,43 @@ public:
       nodeData[*ii].edgeEnd() = curEdge;
     }
   }
+
+  /// Construct the share tid of total of the nodes of topology as
+  /// constructFrom(FileGraph&). Edge e gets the data edge_value(e), which is
+  /// not called when EdgeTy is void.
+  template <typename EdgeValueFn>
+  void constructFrom(
+      const GraphTopology& topology, unsigned tid, unsigned total,
+      EdgeValueFn edge_value) {
+    const uint64_t* adj = topology.AdjData();
+    const uint32_t* dests = topology.DestData();
+    auto r = katana::DivideNodesBinarySearch(
+                 numNodes, numEdges,
+                 NodeData::size_of::value +
+                     LC_InlineEdge_Graph::size_of_out_of_line::value,
+                 EdgeData::size_of::value, tid, total, adj)
+                 .first;
+
+    uint64_t e = *r.first == 0 ? 0 : adj[*r.first - 1];
+    EdgeInfo* curEdge = edgeData.data() + e;
+
+    this->setLocalRange(*r.first, *r.second);
+
+    for (auto ii = r.first, ei = r.second; ii != ei; ++ii) {
+      uint32_t n = *ii;
+      nodeData.constructAt(n);
+      this->outOfLineConstructAt(n);
+      nodeData[n].edgeBegin() = curEdge;
+      for (; e < adj[n]; ++e) {
+        if constexpr (EdgeInfo::has_value) {
+          curEdge->construct(edge_value(e));
+        }
+        setEdgeDst(nodeData, curEdge, dests[e]);
+        ++curEdge;
+      }
+      nodeData[n].edgeEnd() = curEdge;
+    }
+  }
 };
 
 }  // namespace katana
@@ -0,0 +1,125 @@
+#ifndef KATANA_LIBGRAPH_KATANA_PROJECTEDGRAPHVIEW_H_
+#define KATANA_LIBGRAPH_KATANA_PROJECTEDGRAPHVIEW_H_
+
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "katana/DynamicBitset.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A projection of a PropertyGraph that is a view of it: the selection of
+/// its nodes and, optionally, of its edges, as bitsets indexed by property
+/// index like the ones PropertyFilter makes. Nothing is copied, so the view
+/// costs a bit per node (and per edge if edges are selected) and shares the
+/// topology and properties of the graph. An edge is in the view if it is
+/// selected and both of its endpoints are.
+///
+/// Code that can test membership walks the parent topology with
+/// ContainsNode, ContainsEdge and ForEachOutEdge. An algorithm that needs a
+/// topology of its own gets it from Materialize, which builds the compacted
+/// projection, as PropertyGraph::MakeProjectedGraph does, the first time it
+/// is called and keeps it until ReleaseMaterialized.
+///
+/// The graph must outlive the view and its topology must not change while
+/// the view is in use.
+class KATANA_EXPORT ProjectedGraphView {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+
+  /// View the nodes of pg in node_selection and the edges between them in
+  /// edge_selection, or all of them if there is none
+  static Result<std::unique_ptr<ProjectedGraphView>> Make(
+      PropertyGraph* pg, DynamicBitset&& node_selection,
+      std::optional<DynamicBitset>&& edge_selection = std::nullopt);
+
+  /// View the nodes of pg with one of node_types and the edges between them
+  /// with one of edge_types; no types means all nodes or edges
+  static Result<std::unique_ptr<ProjectedGraphView>> Make(
+      PropertyGraph* pg, const std::optional<SetOfEntityTypeIDs>& node_types,
+      const std::optional<SetOfEntityTypeIDs>& edge_types);
+
+  PropertyGraph& parent() const { return *pg_; }
+
+  /// The number of nodes in the view
+  uint64_t NumNodes() const { return num_nodes_; }
+
+  /// \returns true if node, a node of the parent topology, is in the view
+  bool ContainsNode(Node node) const {
+    return node_selection_.test(pg_->GetNodePropertyIndex(node));
+  }
+
+  /// \returns true if edge, an out-edge of src in the parent topology, is in
+  /// the view
+  bool ContainsEdge(Node src, Edge edge) const {
+    return ContainsNode(src) &&
+           ContainsNode(pg_->topology().OutEdgeDst(edge)) &&
+           IsEdgeSelected(edge);
+  }
+
+  /// Call fn(edge, dst) for every out-edge of src in the view, in parent
+  /// topology IDs
+  template <typename Fn>
+  void ForEachOutEdge(Node src, Fn fn) const {
+    if (!ContainsNode(src)) {
+      return;
+    }
+    const GraphTopology& topo = pg_->topology();
+    for (Edge e : topo.OutEdges(src)) {
+      Node dst = topo.OutEdgeDst(e);
+      if (ContainsNode(dst) && IsEdgeSelected(e)) {
+        fn(e, dst);
+      }
+    }
+  }
+
+  const DynamicBitset& node_selection() const { return node_selection_; }
+
+  /// The edge selection, or null if every edge between nodes in the view is
+  /// in it
+  const DynamicBitset* edge_selection() const {
+    return edge_selection_ ? &edge_selection_.value() : nullptr;
+  }
+
+  /// \returns the projection as a graph with a compacted topology of its
+  /// own that shares the properties of the parent, building it on the first
+  /// call. Safe to call concurrently.
+  Result<PropertyGraph*> Materialize();
+
+  bool IsMaterialized() const;
+
+  /// Free the compacted topology; a later Materialize builds it again
+  void ReleaseMaterialized();
+
+private:
+  ProjectedGraphView(
+      PropertyGraph* pg, DynamicBitset&& node_selection,
+      std::optional<DynamicBitset>&& edge_selection)
+      : pg_(pg),
+        node_selection_(std::move(node_selection)),
+        edge_selection_(std::move(edge_selection)),
+        num_nodes_(node_selection_.count()) {}
+
+  bool IsEdgeSelected(Edge edge) const {
+    return !edge_selection_ ||
+           edge_selection_->test(pg_->GetEdgePropertyIndexFromOutEdge(edge));
+  }
+
+  PropertyGraph* pg_;
+  DynamicBitset node_selection_;
+  std::optional<DynamicBitset> edge_selection_;
+  uint64_t num_nodes_;
+
+  mutable std::mutex materialized_mutex_;
+  std::unique_ptr<PropertyGraph> materialized_;
+};
+
+}  // namespace katana
+
+#endif
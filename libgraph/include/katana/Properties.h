@@ -1,11 +1,16 @@
 #ifndef KATANA_LIBGRAPH_KATANA_PROPERTIES_H_
 #define KATANA_LIBGRAPH_KATANA_PROPERTIES_H_
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
 #include <string_view>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <arrow/array.h>
+#include <arrow/chunked_array.h>
 #include <arrow/stl.h>
 #include <arrow/type_fwd.h>
 #include <arrow/type_traits.h>
@@ -152,6 +157,63 @@ ConstructPropertyView(arrow::Array* array) {
   return ViewType::Make(*t);
 }
 
+namespace internal {
+
+template <typename View, typename ArrowArrayType, typename = void>
+struct HasChunkedMake : std::false_type {};
+
+template <typename View, typename ArrowArrayType>
+struct HasChunkedMake<
+    View, ArrowArrayType,
+    std::void_t<decltype(View::Make(
+        std::declval<const std::vector<const ArrowArrayType*>&>()))>>
+    : std::true_type {};
+
+/// IsWritableView is true for property views that write through their
+/// references and so need mutable buffers
+template <typename View, typename = void>
+struct IsWritableView : std::false_type {};
+
+template <typename View>
+struct IsWritableView<View, std::void_t<typename View::reference>>
+    : std::bool_constant<
+          std::is_lvalue_reference_v<typename View::reference> &&
+          !std::is_const_v<std::remove_reference_t<typename View::reference>>> {
+};
+
+}  // namespace internal
+
+/// ConstructPropertyView applies a property view to the arrays of an
+/// arrow::ChunkedArray. Views with a Make over a vector of chunks, like
+/// PODPropertyView, read the chunks in place; the others need a single chunk.
+template <typename Prop>
+Result<PropertyViewType<Prop>>
+ConstructPropertyView(arrow::ChunkedArray* array) {
+  using ArrowArrayType = PropertyArrowArrayType<Prop>;
+  using ViewType = PropertyViewType<Prop>;
+  if (array->num_chunks() == 1) {
+    return ConstructPropertyView<Prop>(array->chunk(0).get());
+  }
+  if constexpr (internal::HasChunkedMake<ViewType, ArrowArrayType>::value) {
+    std::vector<const ArrowArrayType*> chunks;
+    for (const auto& chunk : array->chunks()) {
+      const auto* t = dynamic_cast<const ArrowArrayType*>(chunk.get());
+      if (!t) {
+        return KATANA_ERROR(
+            katana::ErrorCode::TypeError, "Incorrect arrow::Array type: {}",
+            chunk->type()->ToString());
+      }
+      chunks.emplace_back(t);
+    }
+    if (!chunks.empty()) {
+      return ViewType::Make(chunks);
+    }
+  }
+  return KATANA_ERROR(
+      ErrorCode::NotImplemented, "property with {} chunks of {}",
+      array->num_chunks(), array->type()->ToString());
+}
+
 /// ConstructPropertyViews applies ConstructPropertyView to a tuple of
 /// properties.
 ///
@@ -161,14 +223,14 @@ ConstructPropertyView(arrow::Array* array) {
 template <typename PropTuple>
 Result<std::tuple<>>
 ConstructPropertyViews(
-    const std::vector<arrow::Array*>&, std::index_sequence<>) {
+    const std::vector<arrow::ChunkedArray*>&, std::index_sequence<>) {
   return Result<std::tuple<>>(std::tuple<>());
 }
 
 template <typename PropTuple, size_t head, size_t... tail>
 Result<TupleElements<PropertyViewTuple<PropTuple>, head, tail...>>
 ConstructPropertyViews(
-    const std::vector<arrow::Array*>& arrays,
+    const std::vector<arrow::ChunkedArray*>& arrays,
     std::index_sequence<head, tail...>) {
   using Prop = std::tuple_element_t<head, PropTuple>;
   using View = PropertyViewType<Prop>;
@@ -191,7 +253,7 @@ ConstructPropertyViews(
 
 template <typename PropTuple>
 Result<PropertyViewTuple<PropTuple>>
-ConstructPropertyViews(const std::vector<arrow::Array*>& arrays) {
+ConstructPropertyViews(const std::vector<arrow::ChunkedArray*>& arrays) {
   return ConstructPropertyViews<PropTuple>(
       arrays, std::make_index_sequence<std::tuple_size_v<PropTuple>>());
 }
@@ -337,6 +399,10 @@ AllocateTable(
 /// POD types as a concept are deprecated in C++20, but POD so much shorter to
 /// say than trivial and standard.
 ///
+/// A view of const T is read-only and also accepts arrays whose values are in
+/// immutable buffers, e.g., ones mapped from a file or shared memory; other
+/// views need mutable buffers.
+///
 /// \tparam T A plain old C datatype type like double or int32_t
 template <typename T>
 class PODPropertyView {
@@ -355,13 +421,8 @@ public:
           ErrorCode::ArrowError, "offset must be positive, given {}",
           array.offset());
     }
-    if (array.data()->buffers.size() <= 1 ||
-        !array.data()->buffers[1]->is_mutable()) {
-      return KATANA_ERROR(
-          ErrorCode::ArrowError, "immutable buffers not supported");
-    }
     return PODPropertyView(
-        internal::GetMutableValuesWorkAround<T>(array.data(), 1, 0),
+        KATANA_CHECKED(Values(array.data())),
         array.data()->template GetValues<uint8_t>(0, 0), array.length(),
         array.offset(), array.null_count());
   }
@@ -378,36 +439,119 @@ public:
           ErrorCode::ArrowError, "offset must be positive, given {}",
           array.offset());
     }
-    if (array.data()->buffers.size() <= 1 ||
-        !array.data()->buffers[1]->is_mutable()) {
-      return KATANA_ERROR(
-          ErrorCode::ArrowError, "immutable buffers not supported");
-    }
     return PODPropertyView(
-        internal::GetMutableValuesWorkAround<T>(array.data(), 1, 0),
+        KATANA_CHECKED(Values(array.data())),
         array.data()->template GetValues<uint8_t>(0, 0), array.length(),
         array.offset(), array.null_count());
   }
 
+  /// Make a view of the chunks of a property, which are not copied. Finding
+  /// the chunk of an element takes a division when all the chunks but the
+  /// last have the same length, as the row groups of a Parquet file do, and a
+  /// binary search over the chunk offsets otherwise.
+  template <typename ArrowArrayType>
+  static Result<PODPropertyView> Make(
+      const std::vector<const ArrowArrayType*>& chunks) {
+    if (chunks.empty()) {
+      return KATANA_ERROR(ErrorCode::ArrowError, "property has no chunks");
+    }
+    auto table = std::make_shared<std::vector<Chunk>>();
+    size_t length = 0;
+    size_t null_count = 0;
+    for (const ArrowArrayType* chunk : chunks) {
+      if (chunk->length() == 0) {
+        continue;
+      }
+      PODPropertyView view = KATANA_CHECKED(Make(*chunk));
+      table->emplace_back(Chunk{
+          view.values_, view.null_bitmap_, view.offset_, view.null_count_,
+          length});
+      length += view.length_;
+      null_count += view.null_count_;
+    }
+    if (table->size() <= 1) {
+      // nothing to look up
+      for (const ArrowArrayType* chunk : chunks) {
+        if (chunk->length() != 0 || table->empty()) {
+          return Make(*chunk);
+        }
+      }
+    }
+
+    size_t chunk_length = (*table)[1].begin;
+    for (size_t c = 1; c + 1 < table->size(); ++c) {
+      if ((*table)[c + 1].begin - (*table)[c].begin != chunk_length) {
+        chunk_length = 0;
+        break;
+      }
+    }
+    if (length - table->back().begin > chunk_length) {
+      chunk_length = 0;
+    }
+    return PODPropertyView(std::move(table), length, null_count, chunk_length);
+  }
+
   bool IsValid(size_t i) const {
     KATANA_LOG_DEBUG_ASSERT(i < length_);
-    // if there is no null_bitmap, then we have either all nulls or no nulls
-    return null_bitmap_ == nullptr
-               ? null_count_ == 0
-               : arrow::BitUtil::GetBit(null_bitmap_, i + offset_);
+    if (chunks_ == nullptr) {
+      return IsValid(null_bitmap_, null_count_, i + offset_);
+    }
+    const Chunk& chunk = FindChunk(i);
+    return IsValid(
+        chunk.null_bitmap, chunk.null_count, i - chunk.begin + chunk.offset);
   }
 
   size_t size() const { return length_; }
 
-  reference GetValue(size_t i) { return values_[i + offset_]; }
+  /// The number of arrays the values are in
+  size_t num_chunks() const { return chunks_ == nullptr ? 1 : num_chunks_; }
 
-  const_reference GetValue(size_t i) const { return values_[i + offset_]; }
+  reference GetValue(size_t i) {
+    if (chunks_ == nullptr) {
+      return values_[i + offset_];
+    }
+    const Chunk& chunk = FindChunk(i);
+    return chunk.values[i - chunk.begin + chunk.offset];
+  }
+
+  const_reference GetValue(size_t i) const {
+    if (chunks_ == nullptr) {
+      return values_[i + offset_];
+    }
+    const Chunk& chunk = FindChunk(i);
+    return chunk.values[i - chunk.begin + chunk.offset];
+  }
 
   reference operator[](size_t i) { return GetValue(i); }
 
   const_reference operator[](size_t i) const { return GetValue(i); }
 
 private:
+  static Result<T*> Values(const std::shared_ptr<arrow::ArrayData>& data) {
+    if (data->buffers.size() <= 1 || !data->buffers[1]) {
+      return KATANA_ERROR(ErrorCode::ArrowError, "array has no values");
+    }
+    if constexpr (std::is_const_v<T>) {
+      return data->template GetValues<std::remove_const_t<T>>(1, 0);
+    } else {
+      if (!data->buffers[1]->is_mutable()) {
+        return KATANA_ERROR(
+            ErrorCode::ArrowError,
+            "immutable buffers not supported, except by read-only views");
+      }
+      return internal::GetMutableValuesWorkAround<T>(data, 1, 0);
+    }
+  }
+
+  struct Chunk {
+    T* values;
+    const uint8_t* null_bitmap;
+    size_t offset;
+    size_t null_count;
+    /// The index in the view of the first element of the chunk
+    size_t begin;
+  };
+
   PODPropertyView(
       T* values, const uint8_t* null_bitmap, size_t length, size_t offset,
       size_t null_count)
@@ -417,9 +561,47 @@ private:
         offset_(offset),
         null_count_(null_count) {}
 
+  PODPropertyView(
+      std::shared_ptr<const std::vector<Chunk>> chunk_table, size_t length,
+      size_t null_count, size_t chunk_length)
+      : values_(nullptr),
+        null_bitmap_(nullptr),
+        length_(length),
+        offset_(0),
+        null_count_(null_count),
+        chunk_table_(std::move(chunk_table)),
+        chunks_(chunk_table_->data()),
+        num_chunks_(chunk_table_->size()),
+        chunk_length_(chunk_length) {}
+
+  static bool IsValid(
+      const uint8_t* null_bitmap, size_t null_count, size_t bit) {
+    // if there is no null_bitmap, then we have either all nulls or no nulls
+    return null_bitmap == nullptr ? null_count == 0
+                                  : arrow::BitUtil::GetBit(null_bitmap, bit);
+  }
+
+  const Chunk& FindChunk(size_t i) const {
+    if (chunk_length_ != 0) {
+      return chunks_[i / chunk_length_];
+    }
+    const Chunk* next = std::upper_bound(
+        chunks_, chunks_ + num_chunks_, i,
+        [](size_t index, const Chunk& chunk) { return index < chunk.begin; });
+    return *(next - 1);
+  }
+
   T* values_;
   const uint8_t* null_bitmap_;
   size_t length_, offset_, null_count_;
+
+  /// Set for views of more than one chunk, in which case values_ and
+  /// null_bitmap_ are not
+  std::shared_ptr<const std::vector<Chunk>> chunk_table_;
+  const Chunk* chunks_{nullptr};
+  size_t num_chunks_{0};
+  /// The length of every chunk but the last, if they are all the same
+  size_t chunk_length_{0};
 };
 
 /// BooleanPropertyReadOnlyView provides a read-only property view over
@@ -460,6 +642,130 @@ private:
   const arrow::BooleanArray& array_;
 };
 
+/// AtomicBitPropertyView provides a property view over arrow::BooleanArrays
+/// that reads and writes their bits in place, one bit per element, so flags
+/// like visited or alive take an eighth of the space of a uint8_t property.
+/// Writes are atomic read-modify-writes of the byte holding the bit, so
+/// concurrent writes to neighboring elements do not clobber each other.
+/// The view needs mutable buffers.
+class KATANA_EXPORT AtomicBitPropertyView {
+public:
+  // use uint8_t instead of bool for value_type for the same reason as
+  // BooleanPropertyReadOnlyView
+  using value_type = uint8_t;
+  using const_reference = bool;
+
+  /// A reference to one bit; its reads and writes are relaxed atomics
+  class reference {
+  public:
+    reference(uint8_t* byte, uint8_t mask) : byte_(byte), mask_(mask) {}
+
+    operator bool() const {
+      return (__atomic_load_n(byte_, __ATOMIC_RELAXED) & mask_) != 0;
+    }
+
+    reference& operator=(bool value) {
+      if (value) {
+        Set();
+      } else {
+        Reset();
+      }
+      return *this;
+    }
+
+    reference& operator=(const reference& other) {
+      return *this = static_cast<bool>(other);
+    }
+
+    /// Set the bit \returns its previous value
+    bool Set() {
+      return (__atomic_fetch_or(byte_, mask_, __ATOMIC_RELAXED) & mask_) != 0;
+    }
+
+    /// Clear the bit \returns its previous value
+    bool Reset() {
+      return (__atomic_fetch_and(
+                  byte_, static_cast<uint8_t>(~mask_), __ATOMIC_RELAXED) &
+              mask_) != 0;
+    }
+
+  private:
+    uint8_t* byte_;
+    uint8_t mask_;
+  };
+
+  static Result<AtomicBitPropertyView> Make(const arrow::BooleanArray& array) {
+    const auto& data = array.data();
+    if (data->buffers.size() <= 1 || !data->buffers[1]) {
+      return KATANA_ERROR(ErrorCode::ArrowError, "array has no values");
+    }
+    if (!data->buffers[1]->is_mutable()) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "immutable buffers not supported");
+    }
+    return AtomicBitPropertyView(
+        internal::GetMutableValuesWorkAround<uint8_t>(data, 1, 0),
+        data->template GetValues<uint8_t>(0, 0), array.length(),
+        array.offset(), array.null_count());
+  }
+
+  bool IsValid(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(i < length_);
+    return null_bitmap_ == nullptr
+               ? null_count_ == 0
+               : arrow::BitUtil::GetBit(null_bitmap_, i + offset_);
+  }
+
+  size_t size() const { return length_; }
+
+  bool Test(size_t i) const { return GetValue(i); }
+
+  /// Set bit i \returns its previous value
+  bool Set(size_t i) { return GetValue(i).Set(); }
+
+  /// Clear bit i \returns its previous value
+  bool Reset(size_t i) { return GetValue(i).Reset(); }
+
+  reference GetValue(size_t i) {
+    KATANA_LOG_DEBUG_ASSERT(i < length_);
+    size_t bit = i + offset_;
+    return reference(&bits_[bit / 8], arrow::BitUtil::kBitmask[bit % 8]);
+  }
+
+  const_reference GetValue(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(i < length_);
+    size_t bit = i + offset_;
+    return (__atomic_load_n(&bits_[bit / 8], __ATOMIC_RELAXED) &
+            arrow::BitUtil::kBitmask[bit % 8]) != 0;
+  }
+
+  reference operator[](size_t i) { return GetValue(i); }
+
+  const_reference operator[](size_t i) const { return GetValue(i); }
+
+private:
+  AtomicBitPropertyView(
+      uint8_t* bits, const uint8_t* null_bitmap, size_t length, size_t offset,
+      size_t null_count)
+      : bits_(bits),
+        null_bitmap_(null_bitmap),
+        length_(length),
+        offset_(offset),
+        null_count_(null_count) {}
+
+  uint8_t* bits_;
+  const uint8_t* null_bitmap_;
+  size_t length_, offset_, null_count_;
+};
+
+namespace internal {
+
+/// AtomicBitPropertyView writes through its proxy references
+template <>
+struct IsWritableView<AtomicBitPropertyView> : std::true_type {};
+
+}  // namespace internal
+
 /// StringPropertyReadOnlyView provides a read-only property view over
 /// arrow::Arrays of string elements
 /// (i.e., arrow::StringArray or arrow::LargeStringArray).
@@ -494,6 +800,89 @@ private:
   const ArrowArrayType& array_;
 };
 
+/// DictionaryStringPropertyReadOnlyView provides a read-only property view
+/// over arrow::DictionaryArrays of strings with int32 indices, as
+/// ParquetReader reads string properties when asked to keep their
+/// dictionaries. Each element has the code of its string in the dictionary,
+/// so equality tests and grouping can compare codes and only materialize the
+/// strings they need.
+///
+/// \tparam DictionaryArrayType the type of the dictionary values
+///   (i.e., arrow::StringArray or arrow::LargeStringArray)
+template <typename DictionaryArrayType>
+class DictionaryStringPropertyReadOnlyView {
+public:
+  using value_type = std::string;
+  using code_type = int32_t;
+
+  static Result<DictionaryStringPropertyReadOnlyView> Make(
+      const arrow::DictionaryArray& array) {
+    if (array.indices()->type_id() != arrow::Type::INT32) {
+      return KATANA_ERROR(
+          ErrorCode::TypeError, "expected int32 indices found {}",
+          array.indices()->type()->ToString());
+    }
+    auto dictionary =
+        std::dynamic_pointer_cast<DictionaryArrayType>(array.dictionary());
+    if (!dictionary) {
+      return KATANA_ERROR(
+          ErrorCode::TypeError, "unexpected dictionary of {}",
+          array.dictionary()->type()->ToString());
+    }
+    return DictionaryStringPropertyReadOnlyView(
+        std::static_pointer_cast<arrow::Int32Array>(array.indices()),
+        std::move(dictionary));
+  }
+
+  bool IsValid(size_t i) const { return indices_->IsValid(i); }
+
+  size_t size() const { return indices_->length(); }
+
+  /// The code of element i, the index of its string in the dictionary
+  code_type GetCode(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(IsValid(i));
+    return indices_->Value(i);
+  }
+
+  /// The number of codes, some of which may be unused
+  size_t num_codes() const { return dictionary_->length(); }
+
+  /// \returns the code of value, or -1 if it is not in the dictionary
+  code_type FindCode(std::string_view value) const {
+    for (int64_t c = 0, n = dictionary_->length(); c < n; ++c) {
+      if (dictionary_->IsValid(c) && dictionary_->GetView(c) == value) {
+        return static_cast<code_type>(c);
+      }
+    }
+    return -1;
+  }
+
+  std::string_view GetCodeView(code_type code) const {
+    return dictionary_->GetView(code);
+  }
+
+  /// A view of the string of element i, valid as long as the array is
+  std::string_view GetView(size_t i) const { return GetCodeView(GetCode(i)); }
+
+  value_type GetValue(size_t i) const { return value_type(GetView(i)); }
+
+  value_type operator[](size_t i) const {
+    if (!IsValid(i)) {
+      return value_type{};
+    }
+    return GetValue(i);
+  }
+
+private:
+  DictionaryStringPropertyReadOnlyView(
+      std::shared_ptr<arrow::Int32Array> indices,
+      std::shared_ptr<DictionaryArrayType> dictionary)
+      : indices_(std::move(indices)), dictionary_(std::move(dictionary)) {}
+
+  std::shared_ptr<arrow::Int32Array> indices_;
+  std::shared_ptr<DictionaryArrayType> dictionary_;
+};
+
 template <typename ArrowT, typename ViewT>
 struct Property {
   using ArrowType = ArrowT;
@@ -539,6 +928,17 @@ struct UInt32Property : public PODProperty<uint32_t> {};
 
 struct UInt64Property : public PODProperty<uint64_t> {};
 
+/// A PODReadOnlyProperty is a PODProperty whose view cannot write, so it can
+/// be made over immutable buffers without copying them.
+///
+/// \tparam T the C type of the backing Arrow property
+/// \tparam U (optional) the C type of the viewed value
+template <typename T, typename U = T>
+struct PODReadOnlyProperty
+    : public Property<
+          typename arrow::CTypeTraits<T>::ArrowType, PODPropertyView<const U>> {
+};
+
 template <typename T, typename U = T>
 struct AtomicPODProperty : public Property<
                                typename arrow::CTypeTraits<T>::ArrowType,
@@ -549,6 +949,21 @@ struct BooleanReadOnlyProperty
           typename arrow::CTypeTraits<bool>::ArrowType,
           BooleanPropertyReadOnlyView> {};
 
+/// An AtomicBitProperty is a boolean property whose view reads and writes
+/// single bits; see AtomicBitPropertyView. It suits flags of algorithms,
+/// e.g., a temporary property named by a TemporaryPropertyGuard:
+///
+///   struct Visited : public katana::AtomicBitProperty {};
+///
+///   TemporaryPropertyGuard visited{pg->NodeMutablePropertyView()};
+///   KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<Visited>>(
+///       txn_ctx, {visited.name()}));
+///
+/// Narrow integer state, like a few bits of flags per node, fits in
+/// PODProperty<uint8_t> or PODProperty<uint16_t> rather than uint32_t.
+struct AtomicBitProperty
+    : public Property<arrow::BooleanType, AtomicBitPropertyView> {};
+
 struct StringReadOnlyProperty
     : public Property<
           arrow::StringType, StringPropertyReadOnlyView<arrow::StringArray>> {};
@@ -558,6 +973,16 @@ struct LargeStringReadOnlyProperty
           arrow::LargeStringType,
           StringPropertyReadOnlyView<arrow::LargeStringArray>> {};
 
+struct DictionaryStringReadOnlyProperty
+    : public Property<
+          arrow::DictionaryType,
+          DictionaryStringPropertyReadOnlyView<arrow::StringArray>> {};
+
+struct DictionaryLargeStringReadOnlyProperty
+    : public Property<
+          arrow::DictionaryType,
+          DictionaryStringPropertyReadOnlyView<arrow::LargeStringArray>> {};
+
 template <typename T>
 struct StructProperty
     : public Property<arrow::FixedSizeBinaryType, katana::PODPropertyView<T>> {
@@ -0,0 +1,110 @@
+#ifndef KATANA_LIBGRAPH_KATANA_PROPERTYFILTER_H_
+#define KATANA_LIBGRAPH_KATANA_PROPERTYFILTER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/type_fwd.h>
+
+#include "katana/DynamicBitset.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class PropertyGraph;
+
+/// A PropertyFilter is a predicate over the properties and entity types of
+/// the nodes or the edges of a PropertyGraph. Evaluating it selects the nodes
+/// or edges that satisfy it as a DynamicBitset indexed by property index,
+/// i.e., by row of the property tables, which for a graph that is not a
+/// projection is the node or edge ID. The selection can be handed to
+/// PropertyGraph::MakeProjectedGraph or combined with other selections.
+///
+/// Property predicates are evaluated with Arrow compute kernels on blocks of
+/// the property in parallel; a dictionary encoded property is evaluated on
+/// its dictionary once and rows are selected by their codes. A null value
+/// satisfies only IsNull.
+///
+/// Example:
+///
+///     auto adults = PropertyFilter::And({
+///         PropertyFilter::Compare(
+///             "age", PropertyFilter::CompareOp::kGreaterEqual,
+///             arrow::MakeScalar(int64_t{18})),
+///         PropertyFilter::HasType(person_types),
+///     });
+///     DynamicBitset nodes = KATANA_CHECKED(adults.SelectNodes(pg));
+///     auto projected = KATANA_CHECKED(
+///         PropertyGraph::MakeProjectedGraph(pg, nodes, std::nullopt));
+class KATANA_EXPORT PropertyFilter {
+public:
+  enum class CompareOp {
+    kEqual,
+    kNotEqual,
+    kLess,
+    kLessEqual,
+    kGreater,
+    kGreaterEqual,
+  };
+
+  /// The value of property compared to value with op
+  static PropertyFilter Compare(
+      std::string property, CompareOp op, std::shared_ptr<arrow::Scalar> value);
+
+  /// The value of property is one of values
+  static PropertyFilter In(
+      std::string property, std::shared_ptr<arrow::Array> values);
+
+  static PropertyFilter IsNull(std::string property);
+
+  static PropertyFilter IsValid(std::string property);
+
+  /// The entity has one of types (need not be its most specific type)
+  static PropertyFilter HasType(SetOfEntityTypeIDs types);
+
+  static PropertyFilter And(std::vector<PropertyFilter> operands);
+
+  static PropertyFilter Or(std::vector<PropertyFilter> operands);
+
+  static PropertyFilter Not(PropertyFilter operand);
+
+  /// \returns the nodes of pg that satisfy this, by node property index
+  Result<DynamicBitset> SelectNodes(const PropertyGraph& pg) const;
+
+  /// \returns the edges of pg that satisfy this, by edge property index
+  Result<DynamicBitset> SelectEdges(const PropertyGraph& pg) const;
+
+  /// Where the properties and types of the entities filtered come from
+  struct Entities;
+
+private:
+  enum class Kind {
+    kCompare,
+    kIn,
+    kIsNull,
+    kIsValid,
+    kHasType,
+    kAnd,
+    kOr,
+    kNot,
+  };
+
+  explicit PropertyFilter(Kind kind) : kind_(kind) {}
+
+  Result<DynamicBitset> Select(const Entities& entities) const;
+
+  Kind kind_;
+  std::string property_;
+  CompareOp op_{CompareOp::kEqual};
+  std::shared_ptr<arrow::Scalar> value_;
+  std::shared_ptr<arrow::Array> values_;
+  SetOfEntityTypeIDs types_;
+  std::vector<PropertyFilter> operands_;
+};
+
+}  // namespace katana
+
+#endif
@@ -10,9 +10,11 @@
 
 #include "katana/ArrowInterchange.h"
 #include "katana/Details.h"
+#include "katana/DynamicTopology.h"
 #include "katana/EntityIndex.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
+#include "katana/GraphMemoryUsage.h"
 #include "katana/GraphTopology.h"
 #include "katana/Iterators.h"
 #include "katana/Logging.h"
@@ -21,10 +23,15 @@
 #include "katana/RDG.h"
 #include "katana/RDGTopology.h"
 #include "katana/Result.h"
+#include "katana/VectorIndex.h"
 #include "katana/config.h"
 
 namespace katana {
 
+namespace analytics {
+struct GraphStatistics;
+}  // namespace analytics
+
 // TODO(amber): find a better place to put this
 template <
     typename T,
@@ -62,6 +69,7 @@ DefaultPropertyNames() {
 /// comprise the physical representation of the logical property graph.
 class KATANA_EXPORT PropertyGraph {
   friend class PGViewCache;
+  friend class GraphSnapshot;
 
   // Regular methods
 public:
@@ -233,6 +241,28 @@ public:
     return pg_view_cache_.BuildView<PGView>(this);
   }
 
+  /// \returns a topology of the out-edges (kNo) or in-edges (kYes) of
+  /// edge_type over the nodes of this graph, for views that walk the edges
+  /// of one type without projecting the graph, see
+  /// EdgeShuffleTopology::MakeOfEdgeType
+  std::shared_ptr<EdgeShuffleTopology> BuildEdgeTypeTopology(
+      const RDGTopology::TransposeKind& tpose_kind,
+      const EntityTypeID& edge_type) noexcept {
+    return pg_view_cache_.BuildEdgeTypeTopo(this, tpose_kind, edge_type);
+  }
+
+  /// \returns a topology of the out-edges (kNo) or in-edges (kYes) of this
+  /// graph with the edges of each node sorted by the numeric edge property
+  /// name, e.g., by weight, see EdgeShuffleTopology::MakeSortedByEdgeProperty.
+  /// It is cached and stored with the graph until the property is upserted
+  /// or removed; writes into the values of the property in place are not
+  /// noticed.
+  Result<std::shared_ptr<const EdgeShuffleTopology>>
+  BuildEdgesSortedByProperty(
+      const std::string& name,
+      const RDGTopology::TransposeKind& tpose_kind =
+          RDGTopology::TransposeKind::kNo);
+
   /// Make a property graph from a constructed RDG. Take ownership of the RDG
   /// and its underlying resources.
   static Result<std::unique_ptr<PropertyGraph>> Make(
@@ -274,6 +304,11 @@ public:
       EntityTypeManager&& node_type_manager,
       EntityTypeManager&& edge_type_manager);
 
+  /// Make a property graph from the version of an RDG named by
+  /// rdg_manifest, such as an earlier one from RDGManifest::Make(uri,
+  /// view_type, version). The graph is opened read only. Versions opened
+  /// with RDGLoadOptions::share_loaded_properties hold one copy of the
+  /// properties they have in common.
   static Result<std::unique_ptr<katana::PropertyGraph>> Make(
       const katana::RDGManifest& rdg_manifest,
       const katana::RDGLoadOptions& opts, katana::TxnContext* txn_ctx);
@@ -294,6 +329,40 @@ public:
       PropertyGraph& pg, std::optional<SetOfEntityTypeIDs> node_types,
       std::optional<SetOfEntityTypeIDs> edge_types);
 
+  /// Make a projected graph of the nodes of pg in node_selection and the
+  /// edges between them in edge_selection, or all of them if it is null.
+  /// The selections are indexed by property index, like the ones made by
+  /// PropertyFilter, and have a bit for every node or edge of the graph pg
+  /// is a projection of, if it is one. Shares state with the original graph.
+  static Result<std::unique_ptr<PropertyGraph>> MakeProjectedGraph(
+      PropertyGraph& pg, const DynamicBitset& node_selection,
+      const DynamicBitset* edge_selection = nullptr);
+
+  /// Make a projected graph from a property graph and the topology of the
+  /// projection, in which the property index of every node and edge is the
+  /// one of the node or edge of pg it stands for. Shares state with the
+  /// original graph. Unlike projecting by type, this does not visit the
+  /// topology of pg, so it is cheap for small projections of large graphs.
+  static Result<std::unique_ptr<PropertyGraph>> MakeProjectedGraph(
+      PropertyGraph& pg, GraphTopology&& projected_topo);
+
+  /// Load a projection of the RDG at rdg_dir: the nodes with one of
+  /// node_types and the edges between them with one of edge_types, as a
+  /// graph of its own that shares no state with storage. The properties
+  /// named in opts are loaded and compacted to the projected nodes and edges,
+  /// so opts cannot ask for lazy loading.
+  ///
+  /// If the RDG stores an uncompressed topology with nodes sorted by type,
+  /// such as the one behind PropertyGraphViews::
+  /// NodesSortedByNodeTypeEdgesSortedByEdgeType, only the parts of it that
+  /// hold the projected nodes and their edges are read. Otherwise the whole
+  /// topology is loaded and projected in memory.
+  static Result<std::unique_ptr<PropertyGraph>> MakeProjectedGraph(
+      const URI& rdg_dir, std::optional<std::vector<std::string>> node_types,
+      std::optional<std::vector<std::string>> edge_types,
+      katana::TxnContext* txn_ctx,
+      const RDGLoadOptions& opts = RDGLoadOptions());
+
   /// \return A copy of this with the same set of properties. The copy shares no
   ///       state with this.
   Result<std::unique_ptr<PropertyGraph>> Copy(
@@ -363,6 +432,10 @@ public:
     return rdg_->part_metadata().policy_id_;
   }
 
+  /// \returns true if the graph was changed since it was loaded or last
+  /// written
+  bool HasUncommittedChanges() const { return uncommitted_changes_; }
+
   /// \returns the current version of the graph (does not access storage)
   Result<uint64_t> CurrentVersion() {
     if (file_ == nullptr) {
@@ -603,6 +676,24 @@ public:
         edge_entity_type_id, GetTypeOfEdgeFromPropertyIndex(edge));
   }
 
+  /// Set @param has_type[i] to 1 if the node @param begin + i has the given
+  /// entity type @param node_entity_type_id and to 0 otherwise, for each
+  /// node in [begin, end). The sets of atomic types are compared once per
+  /// node type rather than once per node, so this is much cheaper than
+  /// calling DoesNodeHaveType on each node.
+  /// (assumes that the node entity type exists)
+  void DoNodesHaveType(
+      Node begin, Node end, EntityTypeID node_entity_type_id,
+      uint8_t* has_type) const;
+
+  /// Set @param has_type[i] to 1 if the edge @param begin + i has the given
+  /// entity type @param edge_entity_type_id and to 0 otherwise, for each
+  /// edge in [begin, end) of the topology
+  /// (assumes that the edge entity type exists)
+  void DoEdgesHaveTypeFromTopoIndex(
+      Edge begin, Edge end, EntityTypeID edge_entity_type_id,
+      uint8_t* has_type) const;
+
   // Return type dictated by arrow
   /// Returns the number of node properties
   /// Does not include types managed by the EntityTypeManager
@@ -642,7 +733,9 @@ public:
     return loaded_edge_schema()->GetFieldIndex(name) != -1;
   }
 
-  /// Get a node property by name.
+  /// Get a node property by name. If the graph was loaded with
+  /// RDGLoadOptions::lazy_load_properties, a property that has not been loaded
+  /// yet is loaded from storage first.
   ///
   /// \param name The name of the property to get.
   /// \return The property data or NULL if the property is not found.
@@ -651,10 +744,26 @@ public:
 
   Result<URI> GetNodePropertyStorageLocation(const std::string& name) const;
 
+  /// Get the statistics of a node property without loading it, if they were
+  /// stored with the graph. The per-block min and max let a scan skip rows
+  /// via PropertyStats::CandidateRanges, and the totals give a query planner
+  /// a cheap cardinality estimate.
+  Result<PropertyStats> GetNodePropertyStats(const std::string& name) const;
+
+  /// Read rows [begin, end) of a node property. Unlike GetNodeProperty, this
+  /// never loads the property: an unloaded property is read from storage one
+  /// slice at a time (only the row groups holding the rows are fetched), so
+  /// callers can scan properties too large to load. Rows are property
+  /// indexes, not node ids (see GetNodePropertyIndex).
+  Result<std::shared_ptr<arrow::ChunkedArray>> ReadNodePropertyRows(
+      const std::string& name, uint64_t begin, uint64_t end) const;
+
   std::string GetNodePropertyName(int32_t i) const {
     return loaded_node_schema()->field(i)->name();
   }
 
+  /// Get an edge property by name, loading it first if the graph loads
+  /// properties lazily (see GetNodeProperty).
   Result<std::shared_ptr<arrow::ChunkedArray>> GetEdgeProperty(
       const std::string& name) const;
 
@@ -664,7 +773,16 @@ public:
 
   Result<URI> GetEdgePropertyStorageLocation(const std::string& name) const;
 
-  /// Get a node property by name and cast it to a type.
+  /// Get the statistics of an edge property; see GetNodePropertyStats
+  Result<PropertyStats> GetEdgePropertyStats(const std::string& name) const;
+
+  /// Read rows of an edge property without loading it; see
+  /// ReadNodePropertyRows
+  Result<std::shared_ptr<arrow::ChunkedArray>> ReadEdgePropertyRows(
+      const std::string& name, uint64_t begin, uint64_t end) const;
+
+  /// Get a node property by name and cast it to a type. A property in
+  /// several chunks is returned as a copy, which writes do not reach.
   ///
   /// \tparam T The type of the property.
   /// \param name The name of the property.
@@ -679,10 +797,14 @@ public:
     }
     auto chunked_array = chunked_array_result.assume_value();
     KATANA_LOG_ASSERT(chunked_array);
+    auto unchunked_result = UnchunkedArray(chunked_array);
+    if (!unchunked_result) {
+      return unchunked_result.assume_error();
+    }
 
     auto array =
         std::dynamic_pointer_cast<typename arrow::CTypeTraits<T>::ArrayType>(
-            chunked_array->chunk(0));
+            unchunked_result.assume_value());
     if (!array) {
       return KATANA_ERROR(
           katana::ErrorCode::TypeError, "Incorrect arrow::Array type: {}",
@@ -691,7 +813,8 @@ public:
     return MakeResult(std::move(array));
   }
 
-  /// Get an edge property by name and cast it to a type.
+  /// Get an edge property by name and cast it to a type. A property in
+  /// several chunks is returned as a copy, which writes do not reach.
   ///
   /// \tparam T The type of the property.
   /// \param name The name of the property.
@@ -706,10 +829,14 @@ public:
     }
     auto chunked_array = chunked_array_result.assume_value();
     KATANA_LOG_ASSERT(chunked_array);
+    auto unchunked_result = UnchunkedArray(chunked_array);
+    if (!unchunked_result) {
+      return unchunked_result.assume_error();
+    }
 
     auto array =
         std::dynamic_pointer_cast<typename arrow::CTypeTraits<T>::ArrayType>(
-            chunked_array->chunk(0));
+            unchunked_result.assume_value());
     if (!array) {
       return KATANA_ERROR(
           katana::ErrorCode::TypeError, "Incorrect arrow::Array type: {}",
@@ -723,10 +850,90 @@ public:
     return pg_view_cache_.DropAllTopologies();
   }
 
+  /// Insert and delete edges in place. Inserted edges name existing rows of
+  /// the edge properties and types, such as rows of deleted edges or rows
+  /// added ahead of the edit. Only topology() is patched, other views are
+  /// rebuilt on next use, see PGViewCache::ApplyEdgeDeltas; views built
+  /// before the edit keep the old topology. Write and Commit reorder the
+  /// edge properties to match the edited topology. Fails if edits of
+  /// InsertEdges or DeleteEdges are pending, see CompactTopology.
+  katana::Result<void> ApplyEdgeDeltas(const EdgeDeltas& deltas);
+
+  /// Add a batch of edges, edges[i] of type types[i] with the edge property
+  /// values in row i of properties. Properties without a column in
+  /// properties are null for the new edges, and properties may be null when
+  /// no values are given. The edges go into dynamic_topology() and are not
+  /// visible to topology() or to views until CompactTopology.
+  katana::Result<void> InsertEdges(
+      const std::vector<std::pair<Node, Node>>& edges,
+      const std::vector<EntityTypeID>& types,
+      const std::shared_ptr<arrow::Table>& properties,
+      katana::TxnContext* txn_ctx);
+
+  /// Remove every edge from src to dst of each pair in edges from
+  /// dynamic_topology(). Their property rows are dropped by CompactTopology.
+  katana::Result<void> DeleteEdges(
+      const std::vector<std::pair<Node, Node>>& edges);
+
+  /// \returns the topology with the edges inserted and deleted since the
+  /// last CompactTopology, or nullptr if there are none
+  const DynamicTopology* dynamic_topology() const noexcept {
+    return dynamic_topo_.get();
+  }
+
+  /// Replace topology() with dynamic_topology() as a CSR, and reorder the
+  /// edge properties and types to match, as for the edges of topology()
+  /// after ApplyEdgeDeltas. Drops every cached view, edge index and stored
+  /// derived topology. Write and Commit compact the topology first.
+  katana::Result<void> CompactTopology(katana::TxnContext* txn_ctx);
+
+  /// Control whether derived topologies built for views (transposed, sorted,
+  /// edge type aware) are stored by Write and Commit so that later loads of
+  /// the graph reuse them instead of rebuilding. Stores newly built ones by
+  /// default.
+  void set_derived_topology_persist_policy(
+      PGViewCache::PersistPolicy policy) noexcept {
+    pg_view_cache_.set_persist_policy(policy);
+  }
+
+  /// \returns every derived topology cached for views, whatever the persist
+  /// policy, see PGViewCache::CachedRDGTopologies
+  Result<std::vector<RDGTopology>> GetCachedTopologies() const {
+    return pg_view_cache_.CachedRDGTopologies();
+  }
+
+  /// Cache the topologies returned by GetCachedTopologies of a graph with
+  /// the same topology and entity types as this one, so that views do not
+  /// rebuild them
+  Result<void> AddCachedTopologies(std::vector<RDGTopology>* rdg_topos) {
+    return pg_view_cache_.AddRDGTopologies(this, rdg_topos);
+  }
+
   const GraphTopology& topology() const noexcept {
     return pg_view_cache_.GetDefaultTopologyRef();
   }
 
+  /// The statistics of topology() cached by analytics::GetGraphStatistics,
+  /// or nullptr if they have not been computed since the topology last
+  /// changed. Like views, the cache is not synchronized.
+  const std::shared_ptr<const analytics::GraphStatistics>&
+  cached_graph_statistics() const noexcept {
+    return graph_statistics_;
+  }
+
+  void set_cached_graph_statistics(
+      std::shared_ptr<const analytics::GraphStatistics> statistics)
+      const noexcept {
+    graph_statistics_ = std::move(statistics);
+  }
+
+  /// \returns the bytes of memory held by each part of this graph: its
+  /// topology, the views cached for it, its loaded properties, entity type
+  /// ids, indexes and other optional datastructures. The sizes are of the
+  /// buffers the parts own, not of the allocations made for them, and are
+  /// computed on each call.
+  GraphMemoryUsage GetMemoryUsage() const;
+
   GraphTopology::PropertyIndex GetEdgePropertyIndexFromOutEdge(
       const Edge& eid) const noexcept;
 
@@ -778,6 +985,17 @@ public:
   Result<void> UpsertEdgeProperties(
       const std::shared_ptr<arrow::Table>& props, katana::TxnContext* txn_ctx);
 
+  /// Overwrite the rows of a loaded node property listed in \p row_ids
+  /// (property indexes) with the matching entries of \p values. The next
+  /// write stores only the changed rows, as a delta on the stored property.
+  Result<void> UpdateNodePropertyRows(
+      const std::string& name, const std::vector<uint64_t>& row_ids,
+      const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx);
+  /// Overwrite rows of a loaded edge property; see UpdateNodePropertyRows
+  Result<void> UpdateEdgePropertyRows(
+      const std::string& name, const std::vector<uint64_t>& row_ids,
+      const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx);
+
   Result<void> RemoveNodeProperty(int i, katana::TxnContext* txn_ctx);
   Result<void> RemoveNodeProperty(
       const std::string& prop_name, katana::TxnContext* txn_ctx);
@@ -810,6 +1028,45 @@ public:
   /// the table do nothing otherwise
   Result<void> EnsureEdgePropertyLoaded(const std::string& name);
 
+  /// Copy the values of a node property into mutable buffers if they are in
+  /// immutable ones, e.g., ones mapped from storage, so that views can write
+  /// to it; do nothing otherwise. Read-only views need not call this.
+  Result<void> EnsureNodePropertyMutable(
+      const std::string& name, katana::TxnContext* txn_ctx);
+
+  /// Copy the values of an edge property into mutable buffers if needed; see
+  /// EnsureNodePropertyMutable
+  Result<void> EnsureEdgePropertyMutable(
+      const std::string& name, katana::TxnContext* txn_ctx);
+
+  /// Store the named node property as \p format from the next write on.
+  /// Arrow IPC trades storage size for loading without any decoding.
+  Result<void> SetNodePropertyStorageFormat(
+      const std::string& name, katana::PropertyStorageFormat format);
+
+  /// Store the named edge property as \p format from the next write on
+  Result<void> SetEdgePropertyStorageFormat(
+      const std::string& name, katana::PropertyStorageFormat format);
+
+  /// \returns true if properties are loaded on first access by name rather
+  /// than when the graph is made (RDGLoadOptions::lazy_load_properties)
+  bool IsLazyLoadingProperties() const { return lazy_loader_ != nullptr; }
+
+  /// Block until the background prefetch requested at load time has
+  /// finished. Operations that modify the set of loaded properties call this
+  /// first; while a prefetch is running only by-name property access is safe
+  /// to use concurrently. Any number of threads may wait at once.
+  void WaitForPropertyPrefetch();
+
+  /// Load the named properties in the background, as the prefetch of a lazy
+  /// load does, after any running prefetch. From then on, properties are
+  /// loaded on first access by name (see IsLazyLoadingProperties). Properties
+  /// that fail to load are logged and left unloaded. If progress is set, the
+  /// prefetch reports to it and stops early once it is cancelled.
+  void PrefetchProperties(
+      std::vector<std::string> node_names, std::vector<std::string> edge_names,
+      const std::shared_ptr<RDGLoadProgress>& progress = nullptr);
+
   std::vector<std::string> ListFullNodeProperties() const {
     return rdg_->ListFullNodeProperties();
   }
@@ -936,27 +1193,48 @@ public:
     return node_iterator(node_id);
   }
 
-  // Creates an index over a node property.
-  Result<void> MakeNodeIndex(const std::string& property_name);
+  // Creates an index over a node property. Hash indexes answer only
+  // equality lookups, and only over string properties.
+  Result<void> MakeNodeIndex(
+      const std::string& property_name,
+      EntityIndexKind kind = EntityIndexKind::kSorted);
 
   // Delete an existing index over a node property.
   Result<void> DeleteNodeIndex(const std::string& property_name);
 
-  // Creates an index over an edge property.
-  Result<void> MakeEdgeIndex(const std::string& property_name);
+  // Creates an index over an edge property. Hash indexes answer only
+  // equality lookups, and only over string properties.
+  Result<void> MakeEdgeIndex(
+      const std::string& property_name,
+      EntityIndexKind kind = EntityIndexKind::kSorted);
 
   // Delete an existing index over an edge property.
   Result<void> DeleteEdgeIndex(const std::string& property_name);
 
-  // Returns the list of node indexes.
+  // Creates an index over several node properties, sorted by each in turn
+  // and, if by_type, by entity type first so that lookups of a type touch
+  // only its nodes. Nodes with a null in any of the properties are left out.
+  // The index is named by CompositeEntityIndexName.
+  Result<void> MakeNodeCompositeIndex(
+      const std::vector<std::string>& property_names, bool by_type);
+
+  // Creates an index over several edge properties: see
+  // MakeNodeCompositeIndex.
+  Result<void> MakeEdgeCompositeIndex(
+      const std::vector<std::string>& property_names, bool by_type);
+
+  // Returns the list of node indexes. The indexes stored with the graph are
+  // restored the first time they are asked for.
   const std::vector<std::shared_ptr<EntityIndex<GraphTopology::Node>>>&
   node_indexes() const {
+    RestoreIndexes();
     return node_indexes_;
   }
 
-  // Returns the list of edge indexes.
+  // Returns the list of edge indexes; see node_indexes.
   const std::vector<std::shared_ptr<EntityIndex<GraphTopology::Edge>>>&
   edge_indexes() const {
+    RestoreIndexes();
     return edge_indexes_;
   }
 
@@ -978,6 +1256,29 @@ public:
   katana::Result<std::shared_ptr<katana::EntityIndex<GraphTopology::Edge>>>
   GetEdgeIndex(const std::string& property_name) const;
 
+  /// Creates an approximate nearest neighbor index over a node property of
+  /// fixed size lists of floats or doubles, such as embeddings
+  Result<void> MakeNodeVectorIndex(
+      const std::string& property_name,
+      const VectorIndex::Options& options = VectorIndex::Options());
+
+  /// Delete an existing vector index over a node property
+  Result<void> DeleteNodeVectorIndex(const std::string& property_name);
+
+  /// Returns the list of node vector indexes
+  const std::vector<std::shared_ptr<VectorIndex>>& node_vector_indexes() const {
+    return node_vector_indexes_;
+  }
+
+  /// Returns true if a vector index exists for the named node property
+  bool HasNodeVectorIndex(const std::string& property_name) const;
+
+  /// Returns the vector index over the named node property.
+  ///
+  /// The graph retains ownership of the index.
+  Result<std::shared_ptr<VectorIndex>> GetNodeVectorIndex(
+      const std::string& property_name) const;
+
   GraphTopology::Node OriginalToTransformedNodeID(
       GraphTopology::Node node) const {
     return IsTransformed() ? original_to_transformed_nodes_[node] : node;
@@ -999,15 +1300,19 @@ protected:
   //            Alternative solution: provide mutable access
   //            to the array buffer instead of the array
   EntityTypeManager& mutable_node_entity_type_manager() {
+    uncommitted_changes_ = true;
     return *node_entity_type_manager_;
   }
   EntityTypeManager& mutable_edge_entity_type_manager() {
+    uncommitted_changes_ = true;
     return *edge_entity_type_manager_;
   }
   EntityTypeIDArray& mutable_node_entity_type_ids() {
+    uncommitted_changes_ = true;
     return *node_entity_type_ids_;
   }
   EntityTypeIDArray& mutable_edge_entity_type_ids() {
+    uncommitted_changes_ = true;
     return *edge_entity_type_ids_;
   }
 
@@ -1035,7 +1340,8 @@ protected:
         original_to_transformed_edges_(
             std::move(original_to_transformed_edges)),
         node_bitmask_data_(std::move(node_bitmask_data)),
-        edge_bitmask_data_(std::move(edge_bitmask_data)) {
+        edge_bitmask_data_(std::move(edge_bitmask_data)),
+        lazy_loader_(parent.lazy_loader_) {
     auto n_nodes = original_to_transformed_nodes_.size();
     node_bitmask_ = std::make_shared<arrow::Buffer>(
         node_bitmask_data_.data(), arrow::BitUtil::BytesForBits(n_nodes));
@@ -1049,6 +1355,13 @@ protected:
   PropertyGraph* Parent() const { return parent_; }
 
 private:
+  /// Make a projected graph of the nodes of pg for which node_selected(node)
+  /// holds and the edges between them for which edge_selected(edge) holds
+  template <typename NodeSelected, typename EdgeSelected>
+  static Result<std::unique_ptr<PropertyGraph>> ProjectGraph(
+      PropertyGraph& pg, NodeSelected node_selected,
+      EdgeSelected edge_selected);
+
   /// this function creates an empty projection with num_new_nodes nodes
   static std::unique_ptr<PropertyGraph> MakeEmptyEdgeProjectedGraph(
       PropertyGraph& pg, uint32_t num_new_nodes,
@@ -1064,8 +1377,31 @@ private:
   /// Validate performs a sanity check on the the graph after loading
   Result<void> Validate();
 
+  /// Forget the topologies sorted by the edge property name, cached or
+  /// stored, after its values changed
+  void InvalidateTopologiesSortedBy(const std::string& name);
+
   Result<void> DoWriteTopologies();
 
+  /// Persist the node and edge indexes as an optional datastructure of the
+  /// RDG so that loading the graph does not have to rebuild them
+  Result<void> DoWriteIndexes();
+
+  /// Restore the indexes persisted by DoWriteIndexes
+  Result<void> LoadIndexes() const;
+
+  /// Restore the stored indexes if they have not been restored yet, so that
+  /// loading a graph, lazily or not, does not read them. A failure is
+  /// logged and leaves the graph without them. Like views, this is not
+  /// synchronized.
+  void RestoreIndexes() const;
+
+  /// Persist the node vector indexes as an optional datastructure of the RDG
+  Result<void> DoWriteVectorIndexes();
+
+  /// Restore the vector indexes persisted by DoWriteVectorIndexes
+  Result<void> LoadVectorIndexes();
+
   Result<void> DoWrite(
       katana::RDGHandle handle, const std::string& command_line,
       katana::RDG::RDGVersioningPolicy versioning_action,
@@ -1096,6 +1432,15 @@ private:
 
   Result<RDGTopology*> LoadTopology(const RDGTopology& shadow);
 
+  struct LazyPropertyLoader;
+
+  /// Switch to on-demand property loading and start prefetching the named
+  /// properties in the background
+  void StartLazyPropertyLoading(
+      const std::optional<std::vector<std::string>>& node_prefetch,
+      const std::optional<std::vector<std::string>>& edge_prefetch,
+      const std::shared_ptr<RDGLoadProgress>& progress);
+
   // Data
   std::shared_ptr<katana::RDG> rdg_{std::make_shared<katana::RDG>()};
   std::shared_ptr<katana::RDGFile> file_;
@@ -1121,11 +1466,30 @@ private:
   EntityTypeID* edge_entity_data_;
 
   // List of node and edge indexes on this graph.
-  std::vector<std::shared_ptr<EntityIndex<Node>>> node_indexes_;
-  std::vector<std::shared_ptr<EntityIndex<Edge>>> edge_indexes_;
+  mutable std::vector<std::shared_ptr<EntityIndex<Node>>> node_indexes_;
+  mutable std::vector<std::shared_ptr<EntityIndex<Edge>>> edge_indexes_;
+  /// Whether the indexes stored with the RDG have yet to be restored
+  mutable bool indexes_pending_{false};
+
+  // List of node vector indexes on this graph.
+  std::vector<std::shared_ptr<VectorIndex>> node_vector_indexes_;
 
   PGViewCache pg_view_cache_;
 
+  /// See cached_graph_statistics()
+  mutable std::shared_ptr<const analytics::GraphStatistics> graph_statistics_;
+
+  /// Edges inserted and deleted since the last CompactTopology
+  std::unique_ptr<DynamicTopology> dynamic_topo_;
+  /// Types of the edges inserted since the last CompactTopology, by
+  /// property index past the end of edge_entity_type_ids_
+  std::vector<EntityTypeID> inserted_edge_types_;
+  /// Whether ApplyEdgeDeltas left topology() naming edge property rows out
+  /// of order since the last CompactTopology
+  bool edges_patched_{false};
+  /// See HasUncommittedChanges()
+  bool uncommitted_changes_{false};
+
   // Transformation related data.
   PropertyGraph* parent_{nullptr};
 
@@ -1136,6 +1500,11 @@ private:
   std::shared_ptr<arrow::Buffer> node_bitmask_;
   NUMAArray<uint8_t> edge_bitmask_data_{};
   std::shared_ptr<arrow::Buffer> edge_bitmask_;
+
+  /// Non-null when properties are loaded lazily. Shared with transformed
+  /// views since they share rdg_. Declared last so that it is destroyed first
+  /// and any prefetch in flight finishes before the rest of the graph goes.
+  std::shared_ptr<LazyPropertyLoader> lazy_loader_;
 };
 
 /// SortAllEdgesByDest sorts edges for each node by destination
@@ -1,22 +1,24 @@
 #ifndef KATANA_LIBGRAPH_KATANA_PROPERTYVIEWS_H_
 #define KATANA_LIBGRAPH_KATANA_PROPERTYVIEWS_H_
 
+#include <array>
+
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
+#include "katana/TxnContext.h"
 
 namespace katana::internal {
 
-/// ExtractArrays returns the array for each column of a table. It returns an
-/// error if there is more than one array for any column.
-KATANA_EXPORT Result<std::vector<arrow::Array*>> ExtractArrays(
+/// ExtractArrays returns the chunked array for each column of a table
+KATANA_EXPORT Result<std::vector<arrow::ChunkedArray*>> ExtractArrays(
     const arrow::Table* table, const std::vector<std::string>& properties);
-KATANA_EXPORT Result<std::vector<arrow::Array*>> ExtractArrays(
+KATANA_EXPORT Result<std::vector<arrow::ChunkedArray*>> ExtractArrays(
     const PropertyGraph::ReadOnlyPropertyView& pview,
     const std::vector<std::string>& properties);
 
 template <typename PropTuple>
 Result<katana::PropertyViewTuple<PropTuple>>
-PropertyViewsFromArrays(std::vector<arrow::Array*> arrays) {
+PropertyViewsFromArrays(std::vector<arrow::ChunkedArray*> arrays) {
   if (arrays.size() < std::tuple_size_v<PropTuple>) {
     return std::errc::invalid_argument;
   }
@@ -28,13 +30,65 @@ PropertyViewsFromArrays(std::vector<arrow::Array*> arrays) {
   return views_result.value();
 }
 
+template <typename PropTuple, size_t... indices>
+constexpr std::array<bool, sizeof...(indices)>
+WritableViews(std::index_sequence<indices...>) {
+  return {IsWritableView<
+      PropertyViewType<std::tuple_element_t<indices, PropTuple>>>::value...};
+}
+
+/// EnsureWritablePropertiesMutable calls ensure_mutable on the properties
+/// whose elements of PropTuple have views that write, so that immutable
+/// buffers are copied only for those; read-only views use them in place.
+template <typename PropTuple, typename EnsureMutableFn>
+Result<void>
+EnsureWritablePropertiesMutable(
+    const std::vector<std::string>& properties,
+    const EnsureMutableFn& ensure_mutable) {
+  constexpr auto writable = WritableViews<PropTuple>(
+      std::make_index_sequence<std::tuple_size_v<PropTuple>>());
+  for (size_t i = 0; i < writable.size() && i < properties.size(); ++i) {
+    if (writable[i]) {
+      KATANA_CHECKED(ensure_mutable(properties[i]));
+    }
+  }
+  return ResultSuccess();
+}
+
+/// EnsureWritableNodePropertiesMutable promotes the node properties that
+/// PropTuple writes to mutable buffers; see
+/// PropertyGraph::EnsureNodePropertyMutable
+template <typename PropTuple>
+Result<void>
+EnsureWritableNodePropertiesMutable(
+    PropertyGraph* pg, const std::vector<std::string>& properties) {
+  katana::TxnContext txn_ctx;
+  return EnsureWritablePropertiesMutable<PropTuple>(
+      properties, [pg, &txn_ctx](const std::string& name) {
+        return pg->EnsureNodePropertyMutable(name, &txn_ctx);
+      });
+}
+
+/// EnsureWritableEdgePropertiesMutable promotes the edge properties that
+/// PropTuple writes to mutable buffers
+template <typename PropTuple>
+Result<void>
+EnsureWritableEdgePropertiesMutable(
+    PropertyGraph* pg, const std::vector<std::string>& properties) {
+  katana::TxnContext txn_ctx;
+  return EnsureWritablePropertiesMutable<PropTuple>(
+      properties, [pg, &txn_ctx](const std::string& name) {
+        return pg->EnsureEdgePropertyMutable(name, &txn_ctx);
+      });
+}
+
 /// MakeNodePropertyViews asserts a typed view on top of runtime properties.
 /// This version selects a specific set of properties to include in the typed
 /// view.
 ///
 /// It returns an error if there are fewer properties than elements of the
 /// view or if the underlying arrow::ChunkedArray has more than one
-/// arrow::Array.
+/// arrow::Array and the view cannot read chunks in place.
 template <typename PropTuple>
 Result<katana::PropertyViewTuple<PropTuple>>
 MakePropertyViews(
@@ -56,7 +110,7 @@ MakePropertyViews(
 ///
 /// It returns an error if there are fewer properties than elements of the
 /// view or if the underlying arrow::ChunkedArray has more than one
-/// arrow::Array.
+/// arrow::Array and the view cannot read chunks in place.
 template <typename PropTuple>
 static Result<katana::PropertyViewTuple<PropTuple>>
 MakeNodePropertyViews(
@@ -20,9 +20,14 @@
 #ifndef KATANA_LIBGRAPH_KATANA_READGRAPH_H_
 #define KATANA_LIBGRAPH_KATANA_READGRAPH_H_
 
+#include <type_traits>
+
+#include <arrow/type_traits.h>
+
 #include "katana/Details.h"
 #include "katana/FileGraph.h"
 #include "katana/Galois.h"
+#include "katana/PropertyGraph.h"
 #include "katana/Timer.h"
 #include "katana/config.h"
 
@@ -81,6 +86,90 @@ readGraphDispatch(
   katana::on_each(reader);
 }
 
+namespace internal {
+
+/// Whether T is stored in a primitive arrow array with raw_values()
+template <typename T, typename = void>
+struct HasArrowCType : std::false_type {};
+
+template <typename T>
+struct HasArrowCType<T, std::void_t<typename arrow::CTypeTraits<T>::ArrowType>>
+    : std::bool_constant<!std::is_same_v<T, bool>> {};
+
+template <typename EdgeTy>
+struct ValueInitializedEdge {
+  EdgeTy operator()(uint64_t) const { return EdgeTy{}; }
+};
+
+template <>
+struct ValueInitializedEdge<void> {
+  void operator()(uint64_t) const {}
+};
+
+}  // namespace internal
+
+/**
+ * Constructs a graph from the topology of a PropertyGraph without going
+ * through a .gr file, so that operators written against LC_CSR_Graph or
+ * LC_InlineEdge_Graph run on graphs loaded from RDGs. The topology is copied
+ * into the layout of the graph type with the NUMA placement it chooses, and
+ * each thread constructs the nodes it would get from a FileGraph.
+ *
+ * If edge_property_name is not empty, the edge data is read from that
+ * property, which must have the arrow type of the edge data type; otherwise
+ * the edge data is value initialized.
+ */
+template <typename GraphTy>
+void
+readGraphDispatch(
+    GraphTy& graph, read_default_graph_tag, const PropertyGraph& pg,
+    const std::string& edge_property_name = "") {
+  using EdgeTy = typename GraphTy::edge_data_type;
+  const GraphTopology& topology = pg.topology();
+  graph.allocateFrom(topology);
+
+  auto construct = [&](auto edge_value) {
+    katana::on_each([&](unsigned tid, unsigned total) {
+      graph.constructFrom(topology, tid, total, edge_value);
+    });
+  };
+
+  if (edge_property_name.empty()) {
+    construct(internal::ValueInitializedEdge<EdgeTy>());
+    return;
+  }
+  if constexpr (internal::HasArrowCType<EdgeTy>::value) {
+    using ArrayType = typename arrow::CTypeTraits<EdgeTy>::ArrayType;
+    auto property_result = pg.GetEdgeProperty(edge_property_name);
+    if (!property_result) {
+      KATANA_LOG_FATAL(
+          "reading edge property {}: {}", edge_property_name,
+          property_result.error());
+    }
+    auto unchunked_result = UnchunkedArray(property_result.value());
+    if (!unchunked_result) {
+      KATANA_LOG_FATAL(
+          "reading edge property {}: {}", edge_property_name,
+          unchunked_result.error());
+    }
+    auto array =
+        std::dynamic_pointer_cast<ArrayType>(unchunked_result.value());
+    if (!array) {
+      KATANA_LOG_FATAL(
+          "edge property {} is not an array of {}", edge_property_name,
+          arrow::CTypeTraits<EdgeTy>::type_singleton()->ToString());
+    }
+    const EdgeTy* values = array->raw_values();
+    construct([&pg, values](uint64_t e) {
+      return values[pg.GetEdgePropertyIndexFromOutEdge(e)];
+    });
+  } else {
+    KATANA_LOG_FATAL(
+        "edge property {} cannot be read into this edge data type",
+        edge_property_name);
+  }
+}
+
 template <typename GraphTy, typename Aux>
 struct ReadGraphConstructNodesFrom {
   GraphTy& graph;
@@ -0,0 +1,37 @@
+#ifndef KATANA_LIBGRAPH_KATANA_SHAREDGRAPH_H_
+#define KATANA_LIBGRAPH_KATANA_SHAREDGRAPH_H_
+
+#include <memory>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Write the topology and the loaded properties of pg to the directory dir,
+/// for processes on the same host to attach with AttachSharedGraph. The
+/// directory should be on a memory file system, e.g., /dev/shm, so that the
+/// graph is hosted in shared memory; on other file systems it is hosted in
+/// the page cache.
+///
+/// The directory appears atomically, complete or not at all, and must not
+/// exist yet. Entity types are not exported.
+KATANA_EXPORT Result<void> ExportSharedGraph(
+    const PropertyGraph& pg, const std::string& dir);
+
+/// Attach to a graph exported by ExportSharedGraph. The topology and
+/// properties of the returned graph are read-only mappings of the files in
+/// dir, so every process that attaches the graph shares one copy of it; the
+/// graph keeps its mappings alive.
+///
+/// Properties added to the graph are private to the process. Operations
+/// that modify the topology or the shared properties in place, e.g.,
+/// SortAllEdgesByDest, are not supported.
+KATANA_EXPORT Result<std::shared_ptr<PropertyGraph>> AttachSharedGraph(
+    const std::string& dir);
+
+}  // namespace katana
+
+#endif
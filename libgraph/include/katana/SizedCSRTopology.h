@@ -0,0 +1,161 @@
+#ifndef KATANA_LIBGRAPH_KATANA_SIZEDCSRTOPOLOGY_H_
+#define KATANA_LIBGRAPH_KATANA_SIZEDCSRTOPOLOGY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include "katana/ErrorCode.h"
+#include "katana/GraphTopology.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Result.h"
+
+namespace katana {
+
+/// A read-only CSR whose edge ids, adjacency indices and edge property
+/// indexes are EdgeIndex wide. GraphTopology spends 64 bits on each; a graph
+/// with fewer than 4 billion edges can use CSRTopology32 instead, which
+/// halves the bytes read from the adjacency indices when walking edges.
+///
+/// The topology is a copy of the one it was made from, with the same edge
+/// order and property indexes, so algorithms written against a view work
+/// unchanged on it.
+template <typename EdgeIndex>
+class SizedCSRTopology {
+  static_assert(std::is_unsigned_v<EdgeIndex>);
+
+public:
+  using Node = GraphTopologyTypes::Node;
+  using Edge = EdgeIndex;
+  using PropertyIndex = GraphTopologyTypes::PropertyIndex;
+  using node_iterator = GraphTopologyTypes::node_iterator;
+  using edge_iterator = boost::counting_iterator<Edge>;
+  using nodes_range = GraphTopologyTypes::nodes_range;
+  using edges_range = StandardRange<edge_iterator>;
+  using iterator = node_iterator;
+
+  /// The most edges, and the largest edge property index, that fit
+  static constexpr uint64_t kMaxEdges = std::numeric_limits<EdgeIndex>::max();
+
+  SizedCSRTopology() = default;
+  SizedCSRTopology(SizedCSRTopology&&) = default;
+  SizedCSRTopology& operator=(SizedCSRTopology&&) = default;
+
+  SizedCSRTopology(const SizedCSRTopology&) = delete;
+  SizedCSRTopology& operator=(const SizedCSRTopology&) = delete;
+
+  /// Copy seed, a topology or view, in parallel
+  ///
+  /// \returns an error if seed has too many edges or property indexes too
+  /// large for EdgeIndex
+  template <typename Topo>
+  static Result<SizedCSRTopology> Make(const Topo& seed) noexcept;
+
+  uint64_t NumNodes() const noexcept { return adj_indices_.size(); }
+
+  uint64_t NumEdges() const noexcept { return dests_.size(); }
+
+  /// Number of nodes, like GraphTopology::size
+  uint64_t size() const noexcept { return NumNodes(); }
+
+  nodes_range Nodes() const noexcept {
+    return MakeStandardRange<node_iterator>(
+        Node{0}, static_cast<Node>(NumNodes()));
+  }
+
+  node_iterator begin() const noexcept { return node_iterator(0); }
+
+  node_iterator end() const noexcept {
+    return node_iterator(static_cast<Node>(NumNodes()));
+  }
+
+  edges_range OutEdges(Node node) const noexcept {
+    Edge e_beg = node > 0 ? adj_indices_[node - 1] : 0;
+    Edge e_end = adj_indices_[node];
+    return MakeStandardRange<edge_iterator>(e_beg, e_end);
+  }
+
+  Node OutEdgeDst(Edge edge) const noexcept { return dests_[edge]; }
+
+  size_t OutDegree(Node node) const noexcept {
+    return OutEdges(node).size();
+  }
+
+  PropertyIndex GetEdgePropertyIndexFromOutEdge(Edge edge) const noexcept {
+    return edge_prop_indices_[edge];
+  }
+
+  PropertyIndex GetNodePropertyIndex(Node node) const noexcept {
+    return node_prop_indices_[node];
+  }
+
+private:
+  NUMAArray<EdgeIndex> adj_indices_;
+  NUMAArray<Node> dests_;
+  NUMAArray<EdgeIndex> edge_prop_indices_;
+  /// node ids are 32 bits, so node property indexes of any topology fit
+  NUMAArray<Node> node_prop_indices_;
+};
+
+using CSRTopology32 = SizedCSRTopology<uint32_t>;
+
+template <typename EdgeIndex>
+template <typename Topo>
+Result<SizedCSRTopology<EdgeIndex>>
+SizedCSRTopology<EdgeIndex>::Make(const Topo& seed) noexcept {
+  if (seed.NumEdges() > kMaxEdges) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} edges do not fit {}-bit edge indices",
+        seed.NumEdges(), 8 * sizeof(EdgeIndex));
+  }
+
+  SizedCSRTopology topo;
+  uint64_t num_nodes = seed.NumNodes();
+  topo.adj_indices_.allocateInterleaved(num_nodes);
+  topo.dests_.allocateInterleaved(seed.NumEdges());
+  topo.edge_prop_indices_.allocateInterleaved(seed.NumEdges());
+  topo.node_prop_indices_.allocateInterleaved(num_nodes);
+
+  katana::do_all(
+      katana::iterate(seed.Nodes()),
+      [&](Node n) { topo.adj_indices_[n] = seed.OutDegree(n); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      topo.adj_indices_.begin(), topo.adj_indices_.end(),
+      topo.adj_indices_.begin());
+
+  std::atomic<bool> prop_index_overflow{false};
+  katana::do_all(
+      katana::iterate(seed.Nodes()),
+      [&](Node n) {
+        Edge slot = n > 0 ? topo.adj_indices_[n - 1] : 0;
+        for (auto e : seed.OutEdges(n)) {
+          PropertyIndex prop_index = seed.GetEdgePropertyIndexFromOutEdge(e);
+          if (prop_index > kMaxEdges) {
+            prop_index_overflow = true;
+          }
+          topo.dests_[slot] = seed.OutEdgeDst(e);
+          topo.edge_prop_indices_[slot] = prop_index;
+          ++slot;
+        }
+        topo.node_prop_indices_[n] = seed.GetNodePropertyIndex(n);
+      },
+      katana::steal(), katana::no_stats());
+
+  if (prop_index_overflow) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edge property indices do not fit {}-bit edge indices",
+        8 * sizeof(EdgeIndex));
+  }
+  return MakeResult(std::move(topo));
+}
+
+}  // namespace katana
+
+#endif
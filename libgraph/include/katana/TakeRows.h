@@ -0,0 +1,52 @@
+#ifndef KATANA_LIBGRAPH_KATANA_TAKEROWS_H_
+#define KATANA_LIBGRAPH_KATANA_TAKEROWS_H_
+
+#include <cstdint>
+#include <memory>
+
+#include <arrow/type_fwd.h>
+
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Gather rows of the columns of a table in parallel: row i of the result is
+/// row rows[i] of table, and each column of the result is a single chunk.
+/// This is the permutation or selection of properties done when a topology
+/// is sorted or projected or a sub-graph is extracted.
+///
+/// The rows are taken in blocks of consecutive indices and each block is
+/// gathered for every column before moving on, so the indices are read once
+/// for the table. Fixed width, boolean and (large) string and binary columns
+/// are gathered directly, null bitmaps included, and may be chunked; other
+/// columns fall back to arrow::compute::Take.
+///
+/// Every row must be less than the number of rows of table.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> TakeRows(
+    const std::shared_ptr<arrow::Table>& table, const uint64_t* rows,
+    uint64_t num_rows);
+
+inline Result<std::shared_ptr<arrow::Table>>
+TakeRows(
+    const std::shared_ptr<arrow::Table>& table,
+    const NUMAArray<uint64_t>& rows) {
+  return TakeRows(table, rows.data(), rows.size());
+}
+
+/// TakeRows for a single column
+KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> TakeRows(
+    const std::shared_ptr<arrow::ChunkedArray>& column, const uint64_t* rows,
+    uint64_t num_rows);
+
+inline Result<std::shared_ptr<arrow::ChunkedArray>>
+TakeRows(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const NUMAArray<uint64_t>& rows) {
+  return TakeRows(column, rows.data(), rows.size());
+}
+
+}  // namespace katana
+
+#endif
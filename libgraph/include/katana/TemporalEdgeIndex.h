@@ -0,0 +1,107 @@
+#ifndef KATANA_LIBGRAPH_KATANA_TEMPORALEDGEINDEX_H_
+#define KATANA_LIBGRAPH_KATANA_TEMPORALEDGEINDEX_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/Range.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class PropertyGraph;
+
+/// The out-edges of a graph ordered by a time-valued edge property, for
+/// temporal range scans. Timestamp, date32, date64 and 32 and 64 bit integer
+/// properties are indexed by their stored values, in the units of their type;
+/// edges whose property is null are not indexed.
+///
+/// The index holds two orders of the edges:
+///  - per node, the out-edges of each node sorted by time, like an edge
+///    shuffle topology sorted by the property, so that the edges of a node in
+///    a window are a binary search away;
+///  - globally, every edge sorted by time and range partitioned into buckets
+///    of equal time width, with the position of the first edge of each
+///    bucket, so that the edges of a window are found by searching only the
+///    buckets at its ends. Buckets are also units of work for windowed
+///    analytics.
+///
+/// Edges are topology edge ids of the graph, as OutEdges returns them.
+class KATANA_EXPORT TemporalEdgeIndex {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+  using Timestamp = int64_t;
+  using EdgeRange = katana::StandardRange<const Edge*>;
+
+  /// Index the edges of pg by the edge property property_name in
+  /// num_buckets global buckets; 0 picks about one bucket per few thousand
+  /// edges
+  static Result<std::unique_ptr<TemporalEdgeIndex>> Make(
+      const PropertyGraph& pg, const std::string& property_name,
+      uint64_t num_buckets = 0);
+
+  /// \returns the out-edges of node with times in [first, last], in time
+  /// order
+  EdgeRange OutEdgesInWindow(Node node, Timestamp first, Timestamp last) const;
+
+  /// \returns every edge with a time in [first, last], in time order
+  EdgeRange EdgesInWindow(Timestamp first, Timestamp last) const;
+
+  /// \returns the time of the edge at it, a position in a range returned by
+  /// this index
+  Timestamp TimeOf(const Edge* it) const;
+
+  /// The global buckets, for windowed analytics: bucket b holds the edges
+  /// with times in BucketWindow(b)
+  uint64_t num_buckets() const { return bucket_offsets_.size() - 1; }
+  EdgeRange BucketEdges(uint64_t bucket) const;
+  std::pair<Timestamp, Timestamp> BucketWindow(uint64_t bucket) const;
+
+  const std::string& property_name() const { return property_name_; }
+
+  /// The number of indexed edges
+  uint64_t size() const { return edges_.size(); }
+
+  /// The least and greatest indexed times; meaningless if size() is 0
+  Timestamp min_time() const { return min_time_; }
+  Timestamp max_time() const { return max_time_; }
+
+private:
+  explicit TemporalEdgeIndex(std::string property_name)
+      : property_name_(std::move(property_name)) {}
+
+  /// \returns the bucket of time, which must be between min_time_ and
+  /// max_time_
+  uint64_t BucketOf(Timestamp time) const {
+    return (static_cast<uint64_t>(time) - static_cast<uint64_t>(min_time_)) /
+           bucket_width_;
+  }
+
+  std::string property_name_;
+
+  /// node_offsets_[n] is the position of the first out-edge of node n in
+  /// node_edges_
+  NUMAArray<uint64_t> node_offsets_;
+  NUMAArray<Edge> node_edges_;
+  NUMAArray<Timestamp> node_times_;
+
+  NUMAArray<Edge> edges_;
+  NUMAArray<Timestamp> times_;
+  /// bucket_offsets_[b] is the position of the first edge of bucket b in
+  /// edges_, and the last entry is the number of edges
+  std::vector<uint64_t> bucket_offsets_{0};
+  Timestamp min_time_{};
+  Timestamp max_time_{};
+  uint64_t bucket_width_{1};
+};
+
+}  // namespace katana
+
+#endif
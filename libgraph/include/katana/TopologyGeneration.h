@@ -3,6 +3,7 @@
 
 #include <arrow/type_traits.h>
 
+#include "katana/Loops.h"
 #include "katana/PropertyGraph.h"
 
 namespace katana {
@@ -35,6 +36,73 @@ KATANA_EXPORT std::unique_ptr<katana::PropertyGraph> MakeClique(
 KATANA_EXPORT std::unique_ptr<katana::PropertyGraph> MakeTriangle(
     size_t num_rows) noexcept;
 
+/**********************************************************/
+/* Functions for generating large random graph topologies */
+/**********************************************************/
+
+/// Options of the random topology generators. A generated topology depends
+/// only on the parameters of its generator and these options, not on the
+/// number of threads that generate it.
+struct RandomTopologyOptions {
+  uint64_t seed{0};
+  /// Add the reverse of every edge
+  bool symmetric{false};
+  bool remove_self_loops{false};
+  /// Keep only one of the edges with the same source and destination
+  bool remove_multi_edges{false};
+  /// Relabel nodes with a pseudo-random permutation, so that the ids of
+  /// nodes say nothing about their degrees or communities
+  bool scramble_ids{true};
+};
+
+/// Generates a stochastic Kronecker graph (Leskovec et al.) with k^levels
+/// nodes and num_edges edges, from a k x k initiator matrix of non-negative
+/// weights in row-major order. Each edge picks a cell of the initiator
+/// levels times, with probabilities proportional to the weights; the rows
+/// and columns of the cells are the digits of its source and destination
+/// in base k. Edges are generated in parallel.
+KATANA_EXPORT Result<GraphTopology> CreateKroneckerTopology(
+    const std::vector<double>& initiator, uint32_t levels, uint64_t num_edges,
+    const RandomTopologyOptions& options);
+
+/// Generates an R-MAT graph (Chakrabarti et al.) with 2^scale nodes and
+/// edge_factor * 2^scale edges: the Kronecker graph of the initiator
+/// [[a, b], [c, 1 - a - b - c]]. The default probabilities are those of
+/// Graph500.
+KATANA_EXPORT Result<GraphTopology> CreateRmatTopology(
+    uint32_t scale, uint64_t edge_factor, const RandomTopologyOptions& options,
+    double a = 0.57, double b = 0.19, double c = 0.19);
+
+/// Parameters of LFR benchmark graphs
+struct LfrParameters {
+  uint32_t num_nodes{0};
+  /// Degrees follow a power law with this exponent between the bounds
+  double degree_exponent{2};
+  uint32_t min_degree{5};
+  uint32_t max_degree{50};
+  /// Community sizes follow a power law with this exponent between the
+  /// bounds
+  double community_exponent{1};
+  uint32_t min_community{20};
+  uint32_t max_community{100};
+  /// The fraction of the edges of each node that leave its community
+  double mixing{0.1};
+};
+
+/// Generates a symmetric graph with planted communities after the benchmark
+/// of Lancichinetti, Fortunato and Radicchi. communities is filled with the
+/// community of each node.
+///
+/// The original benchmark wires stubs with a configuration model and
+/// rewires them until every node has its exact degree. Here each node
+/// draws half of its edges inside its community, and half outside, with
+/// endpoints chosen in proportion to their internal or external degrees,
+/// so that nodes have their degrees in expectation and all nodes draw
+/// their edges in parallel. The symmetric option is implied.
+KATANA_EXPORT Result<GraphTopology> CreateLfrTopology(
+    const LfrParameters& params, const RandomTopologyOptions& options,
+    NUMAArray<uint32_t>* communities);
+
 /***********************************************************/
 /* Functions for adding node and edge properties to graphs */
 /***********************************************************/
@@ -117,24 +185,41 @@ AddGraphProperties(
     fields.emplace_back(generator.MakeField());
 
     // For property values
-    auto builder = generator.MakeBuilder();
-    if constexpr (is_node) {
-      KATANA_CHECKED(builder->Reserve(pg->NumNodes()));
-      for (Node n : pg->Nodes()) {
-        KATANA_CHECKED(builder->Append(generator(n)));
-      }
+    using Generator = decltype(generator);
+    using ValueType = typename Generator::ValueType;
+    std::shared_ptr<arrow::Array> array;
+    if constexpr (
+        std::is_arithmetic_v<ValueType> && !std::is_same_v<ValueType, bool>) {
+      // Numbers are written in place by a parallel loop, since these are the
+      // properties of the synthetic graphs large enough to need one.
+      uint64_t size = is_node ? pg->NumNodes() : pg->NumEdges();
+      std::shared_ptr<arrow::Buffer> buffer =
+          KATANA_CHECKED(arrow::AllocateBuffer(size * sizeof(ValueType)));
+      auto* values = reinterpret_cast<ValueType*>(buffer->mutable_data());
+      katana::do_all(
+          katana::iterate(uint64_t{0}, size),
+          [&](uint64_t i) { values[i] = generator(static_cast<ArgType>(i)); },
+          katana::no_stats());
+      using ArrayType =
+          typename arrow::TypeTraits<typename Generator::ArrowType>::ArrayType;
+      array = std::make_shared<ArrayType>(size, std::move(buffer));
     } else {
-      KATANA_CHECKED(builder->Reserve(pg->NumEdges()));
-      for (Edge e : pg->OutEdges()) {
-        KATANA_CHECKED(builder->Append(generator(e)));
+      auto builder = generator.MakeBuilder();
+      if constexpr (is_node) {
+        KATANA_CHECKED(builder->Reserve(pg->NumNodes()));
+        for (Node n : pg->Nodes()) {
+          KATANA_CHECKED(builder->Append(generator(n)));
+        }
+      } else {
+        KATANA_CHECKED(builder->Reserve(pg->NumEdges()));
+        for (Edge e : pg->OutEdges()) {
+          KATANA_CHECKED(builder->Append(generator(e)));
+        }
       }
+      KATANA_CHECKED(builder->Finish(&array));
     }
 
-    std::shared_ptr<arrow::Array> array;
-    KATANA_CHECKED(builder->Finish(&array));
-
-    // We anticipate that this API is going to be used for small synthetic graphs,
-    // so columns are made up of a single chunk.
+    // Columns are made up of a single chunk.
     columns.emplace_back(std::make_shared<arrow::ChunkedArray>(array));
 
     return katana::ResultSuccess();
@@ -187,6 +272,7 @@ private:
 
 /// Convenience function to add node properties to pre-constructed property graphs.
 /// It is a variadic function, it will add a node property for every provided PropertyGenerator.
+/// The value functions of numeric properties are called in parallel.
 ///
 /// For example:
 ///
@@ -206,6 +292,7 @@ AddNodeProperties(
 
 /// Convenience function to add edge properties to pre-constructed property graphs.
 /// It is a variadic function, it will add an edge property for every passed PropertyGenerator.
+/// The value functions of numeric properties are called in parallel.
 ///
 /// For example:
 ///
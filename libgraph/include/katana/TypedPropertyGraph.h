@@ -1,6 +1,7 @@
 #ifndef KATANA_LIBGRAPH_KATANA_TYPEDPROPERTYGRAPH_H_
 #define KATANA_LIBGRAPH_KATANA_TYPEDPROPERTYGRAPH_H_
 
+#include <memory>
 #include <tuple>
 
 #include <arrow/type_fwd.h>
@@ -35,12 +36,17 @@ class TypedPropertyGraph {
   using EdgeView = PropertyViewTuple<EdgeProps>;
 
   PropertyGraph* pg_;
+  /// walked in place of the topology of pg_ if not null
+  std::shared_ptr<const GraphTopology> topology_;
 
   NodeView node_view_;
   EdgeView edge_view_;
 
-  TypedPropertyGraph(PropertyGraph* pg, NodeView node_view, EdgeView edge_view)
+  TypedPropertyGraph(
+      PropertyGraph* pg, std::shared_ptr<const GraphTopology> topology,
+      NodeView node_view, EdgeView edge_view)
       : pg_(pg),
+        topology_(std::move(topology)),
         node_view_(std::move(node_view)),
         edge_view_(std::move(edge_view)) {}
 
@@ -77,7 +83,7 @@ public:
   PropertyReferenceType<NodeIndex> GetData(const Node& node) {
     constexpr size_t prop_col_index = find_trait<NodeIndex, NodeProps>();
     auto& property = std::get<prop_col_index>(node_view_);
-    auto idx = pg_->GetNodePropertyIndex(node);
+    auto idx = topology().GetNodePropertyIndex(node);
     KATANA_LOG_DEBUG_ASSERT(idx < property.size());
     return property.GetValue(idx);
   }
@@ -97,7 +103,7 @@ public:
   PropertyConstReferenceType<NodeIndex> GetData(const Node& node) const {
     constexpr size_t prop_col_index = find_trait<NodeIndex, NodeProps>();
     const auto& property = std::get<prop_col_index>(node_view_);
-    auto idx = pg_->GetNodePropertyIndex(node);
+    auto idx = topology().GetNodePropertyIndex(node);
     KATANA_LOG_DEBUG_ASSERT(idx < property.size());
     return property.GetValue(idx);
   }
@@ -118,7 +124,7 @@ public:
   PropertyReferenceType<EdgeIndex> GetEdgeData(const edge_iterator& edge) {
     constexpr size_t prop_col_index = find_trait<EdgeIndex, EdgeProps>();
     auto& property = std::get<prop_col_index>(edge_view_);
-    auto idx = pg_->GetEdgePropertyIndexFromOutEdge(*edge);
+    auto idx = topology().GetEdgePropertyIndexFromOutEdge(*edge);
     KATANA_LOG_DEBUG_ASSERT(idx < property.size());
     return property.GetValue(idx);
   }
@@ -134,7 +140,7 @@ public:
       const edge_iterator& edge) const {
     constexpr size_t prop_col_index = find_trait<EdgeIndex, EdgeProps>();
     const auto& property = std::get<prop_col_index>(edge_view_);
-    auto idx = pg_->GetEdgePropertyIndexFromOutEdge(*edge);
+    auto idx = topology().GetEdgePropertyIndexFromOutEdge(*edge);
     KATANA_LOG_DEBUG_ASSERT(idx < property.size());
     return property.GetValue(idx);
   }
@@ -145,23 +151,19 @@ public:
    * @param edge edge id to get the destination of
    * @returns node id of the edge destination
    */
-  Node OutEdgeDst(Edge e) const noexcept {
-    return pg_->topology().OutEdgeDst(e);
-  }
+  Node OutEdgeDst(Edge e) const noexcept { return topology().OutEdgeDst(e); }
 
-  size_t OutDegree(Node n) const noexcept {
-    return pg_->topology().OutDegree(n);
-  }
+  size_t OutDegree(Node n) const noexcept { return topology().OutDegree(n); }
 
   uint64_t NumNodes() const { return pg_->NumNodes(); }
-  uint64_t NumEdges() const { return pg_->NumEdges(); }
+  uint64_t NumEdges() const { return topology().NumEdges(); }
 
   /**
    * Gets all out-edges.
    *
    * @returns iterable edge range for the entire graph.
    */
-  edges_range OutEdges() const noexcept { return pg_->topology().OutEdges(); }
+  edges_range OutEdges() const noexcept { return topology().OutEdges(); }
 
   /**
    * Gets the edge range of some node.
@@ -169,9 +171,16 @@ public:
    * @param node node to get the edge range of
    * @returns iterable edge range for node.
    */
-  edges_range OutEdges(Node node) const { return pg_->OutEdges(node); }
+  edges_range OutEdges(Node node) const { return topology().OutEdges(node); }
+
+  nodes_range Nodes() const noexcept { return topology().Nodes(); }
+
+  /// The topology the graph walks: that of the underlying PropertyGraph
+  /// unless another one was given to Make
+  const GraphTopology& topology() const noexcept {
+    return topology_ ? *topology_ : pg_->topology();
+  }
 
-  nodes_range Nodes() const noexcept { return pg_->topology().Nodes(); }
   /**
    * Accessor for the underlying PropertyGraph.
    *
@@ -185,6 +194,12 @@ public:
       const std::vector<std::string>& edge_properties);
   static Result<TypedPropertyGraph<NodeProps, EdgeProps>> Make(
       PropertyGraph* pg);
+  /// A graph of the properties of pg that walks topology, which must have
+  /// the nodes of pg, e.g., one from PropertyGraph::BuildEdgeTypeTopology
+  static Result<TypedPropertyGraph<NodeProps, EdgeProps>> Make(
+      PropertyGraph* pg, std::shared_ptr<const GraphTopology> topology,
+      const std::vector<std::string>& node_properties,
+      const std::vector<std::string>& edge_properties);
 };
 
 template <typename PGView, typename NodeProps, typename EdgeProps>
@@ -320,6 +335,20 @@ Result<TypedPropertyGraph<NodeProps, EdgeProps>>
 TypedPropertyGraph<NodeProps, EdgeProps>::Make(
     PropertyGraph* pg, const std::vector<std::string>& node_properties,
     const std::vector<std::string>& edge_properties) {
+  return Make(pg, nullptr, node_properties, edge_properties);
+}
+
+template <typename NodeProps, typename EdgeProps>
+Result<TypedPropertyGraph<NodeProps, EdgeProps>>
+TypedPropertyGraph<NodeProps, EdgeProps>::Make(
+    PropertyGraph* pg, std::shared_ptr<const GraphTopology> topology,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties) {
+  KATANA_LOG_DEBUG_ASSERT(!topology || topology->NumNodes() == pg->NumNodes());
+  KATANA_CHECKED(internal::EnsureWritableNodePropertiesMutable<NodeProps>(
+      pg, node_properties));
+  KATANA_CHECKED(internal::EnsureWritableEdgePropertiesMutable<EdgeProps>(
+      pg, edge_properties));
   auto node_view_result =
       internal::MakeNodePropertyViews<NodeProps>(pg, node_properties);
   if (!node_view_result) {
@@ -333,7 +362,7 @@ TypedPropertyGraph<NodeProps, EdgeProps>::Make(
   }
 
   return TypedPropertyGraph(
-      pg, std::move(node_view_result.value()),
+      pg, std::move(topology), std::move(node_view_result.value()),
       std::move(edge_view_result.value()));
 }
 
@@ -352,6 +381,10 @@ TypedPropertyGraphView<PGView, NodeProps, EdgeProps>::Make(
     const std::vector<std::string>& edge_properties) {
   auto pg_view = pg->BuildView<PGView>();
   KATANA_LOG_DEBUG_ASSERT(pg);
+  KATANA_CHECKED(internal::EnsureWritableNodePropertiesMutable<NodeProps>(
+      pg, node_properties));
+  KATANA_CHECKED(internal::EnsureWritableEdgePropertiesMutable<EdgeProps>(
+      pg, edge_properties));
   auto node_view_result =
       internal::MakeNodePropertyViews<NodeProps>(pg, node_properties);
   if (!node_view_result) {
@@ -0,0 +1,144 @@
+#ifndef KATANA_LIBGRAPH_KATANA_VECTORINDEX_H_
+#define KATANA_LIBGRAPH_KATANA_VECTORINDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/GraphTopology.h"
+#include "katana/PackedLists.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/VectorIndexPrimitive.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The distances a VectorIndex ranks neighbors by; smaller is nearer
+enum class VectorMetric {
+  /// The squared Euclidean distance
+  kL2,
+  /// The negated inner product
+  kInnerProduct,
+  /// One minus the cosine similarity; zero vectors are at distance 1 from
+  /// everything
+  kCosine,
+};
+
+/// \returns the name VectorMetric is stored and parsed by: "l2",
+/// "inner_product" or "cosine"
+KATANA_EXPORT std::string VectorMetricName(VectorMetric metric);
+KATANA_EXPORT Result<VectorMetric> ParseVectorMetric(const std::string& name);
+
+/// An approximate nearest neighbor index over a node property of fixed size
+/// lists of floats or doubles, such as embeddings. The index is an inverted
+/// file: k-means, run in parallel, clusters the vectors, and a query is
+/// compared only with the vectors of the clusters whose centroids are
+/// nearest to it. The vectors of each cluster are copied next to each other
+/// so that a query reads them sequentially. Nodes whose property is null are
+/// not indexed.
+class KATANA_EXPORT VectorIndex {
+public:
+  using Node = GraphTopology::Node;
+
+  /// The id of a missing neighbor, for queries with fewer than k neighbors
+  static constexpr Node kNoNeighbor = std::numeric_limits<Node>::max();
+
+  struct Options {
+    VectorMetric metric{VectorMetric::kL2};
+    /// The number of clusters; 0 picks about the square root of the number
+    /// of vectors
+    uint32_t num_lists{0};
+    /// The number of k-means iterations
+    uint32_t num_iterations{10};
+    /// Seeds the choice of the vectors k-means trains on and starts from
+    uint64_t seed{0};
+  };
+
+  /// The k nearest neighbors of each of a batch of queries, row by row from
+  /// the nearest, with kNoNeighbor and infinite distances after the last
+  /// neighbor of queries with fewer than k
+  struct Neighbors {
+    size_t num_queries{};
+    size_t k{};
+    std::vector<Node> ids;
+    std::vector<float> distances;
+  };
+
+  /// Build an index over property, the values of a node property of a graph
+  /// with num_entities nodes
+  static Result<std::shared_ptr<VectorIndex>> Make(
+      const std::string& property_name, uint64_t num_entities,
+      const arrow::Array& property, const Options& options);
+
+  /// Map an index stored by Store
+  static Result<std::shared_ptr<VectorIndex>> Load(
+      const katana::URI& rdg_dir,
+      const VectorIndexPrimitive::IndexFiles& files);
+
+  /// Persist the index in rdg_dir and add it to stored
+  Result<void> Store(
+      const katana::URI& rdg_dir, VectorIndexPrimitive* stored) const;
+
+  /// Find the k nearest neighbors of each of num_queries queries, stored row
+  /// by row with dimension() floats each, among the vectors of the
+  /// num_probes clusters nearest to each query. Probing more clusters finds
+  /// more of the true neighbors at the cost of more comparisons; probing all
+  /// of them is an exact search. Queries run in parallel.
+  Result<Neighbors> Search(
+      const float* queries, size_t num_queries, size_t k,
+      size_t num_probes) const;
+
+  /// Search for queries given as an array of fixed size lists of floats or
+  /// doubles, none of which may be null
+  Result<Neighbors> Search(
+      const arrow::Array& queries, size_t k, size_t num_probes) const;
+
+  const std::string& property_name() const { return property_name_; }
+  VectorMetric metric() const { return metric_; }
+  size_t dimension() const { return dimension_; }
+  /// The number of nodes in the graph the index was built for
+  uint64_t num_entities() const { return num_entities_; }
+  /// The number of indexed vectors
+  size_t size() const { return size_; }
+  size_t num_lists() const { return centroids_.size(); }
+
+  /// The bytes of memory the centroids, lists and vectors hold
+  uint64_t SizeBytes() const {
+    return centroids_.size_bytes() + lists_.size_bytes() +
+           vectors_.size_bytes();
+  }
+
+private:
+  VectorIndex(
+      std::string property_name, VectorMetric metric, size_t dimension,
+      uint64_t num_entities)
+      : property_name_(std::move(property_name)),
+        metric_(metric),
+        dimension_(dimension),
+        num_entities_(num_entities) {}
+
+  std::string property_name_;
+  VectorMetric metric_;
+  size_t dimension_;
+  uint64_t num_entities_;
+  size_t size_{};
+
+  /// The centroid of each cluster
+  PackedLists<float> centroids_;
+  /// The nodes of each cluster, in increasing order
+  PackedLists<uint32_t> lists_;
+  /// The vectors of the nodes of each cluster, in the order of lists_;
+  /// normalized for kCosine
+  PackedLists<float> vectors_;
+};
+
+}  // namespace katana
+
+#endif
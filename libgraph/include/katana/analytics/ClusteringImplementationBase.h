@@ -20,15 +20,29 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <random>
 #include <set>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/BatchedGather.h"
+#include "katana/DynamicBitset.h"
 #include "katana/Galois.h"
 #include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ProgressTracer.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -64,6 +78,104 @@ using EdgeWeight = katana::PODProperty<EdgeWeightType>;
 struct CurrentSubCommunityID : public katana::PODProperty<uint64_t> {};
 struct NodeWeight : public katana::PODProperty<uint64_t> {};
 
+/// The total weight of the edges from a node to each cluster around it, with
+/// the cluster of the node itself first. A thread reuses one NeighborClusters
+/// for all of its nodes: weights go to the entry of their cluster through an
+/// index as large as the number of clusters, and only the clusters touched
+/// by the last node are reset, so a node costs time in its degree and no
+/// allocation once the buffers have grown. Hubs, whose edges would be spread
+/// over the whole index, sort their (cluster, weight) pairs instead.
+template <typename EdgeTy>
+class NeighborClusters {
+public:
+  /// Nodes of at least this many edges are aggregated by sorting
+  static constexpr uint64_t kSortDegree = uint64_t{1} << 14;
+
+  /// Start the clusters of a node of the given degree in own_cluster, with
+  /// all clusters less than num_clusters
+  void Start(uint64_t num_clusters, uint64_t own_cluster, uint64_t degree) {
+    Start(num_clusters, degree);
+    has_own_cluster_ = true;
+    entries_.emplace_back(own_cluster, 0);
+    if (indexed_) {
+      index_[own_cluster] = 1;
+    }
+  }
+
+  /// Start the clusters of edges that do not come from a single node, e.g.,
+  /// all the edges out of a cluster, so that no cluster comes first
+  void Start(uint64_t num_clusters, uint64_t degree) {
+    if (indexed_) {
+      for (const auto& entry : entries_) {
+        index_[entry.first] = 0;
+      }
+    }
+    entries_.clear();
+    has_own_cluster_ = false;
+    indexed_ = degree < kSortDegree;
+    if (indexed_) {
+      if (index_.size() < num_clusters) {
+        index_.resize(num_clusters, 0);
+      }
+    } else {
+      pairs_.clear();
+      pairs_.reserve(degree);
+    }
+  }
+
+  void Add(uint64_t cluster, EdgeTy weight) {
+    if (!indexed_) {
+      pairs_.emplace_back(cluster, weight);
+      return;
+    }
+    KATANA_LOG_DEBUG_ASSERT(cluster < index_.size());
+    uint32_t& position = index_[cluster];
+    if (position == 0) {
+      entries_.emplace_back(cluster, 0);
+      position = entries_.size();
+    }
+    entries_[position - 1].second += weight;
+  }
+
+  /// Sum up the weights added since Start
+  void Finish() {
+    if (indexed_) {
+      return;
+    }
+    // Stable, so that each cluster adds up its weights in edge order as with
+    // the index
+    std::stable_sort(
+        pairs_.begin(), pairs_.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (const auto& [cluster, weight] : pairs_) {
+      if (has_own_cluster_ && cluster == entries_[0].first) {
+        entries_[0].second += weight;
+      } else if (!entries_.empty() && entries_.back().first == cluster) {
+        entries_.back().second += weight;
+      } else {
+        entries_.emplace_back(cluster, weight);
+      }
+    }
+  }
+
+  /// The number of clusters around the node, including its own
+  size_t size() const { return entries_.size(); }
+
+  /// The (cluster, total edge weight) of cluster i; cluster 0 is the node's,
+  /// if Start was given one
+  const std::pair<uint64_t, EdgeTy>& operator[](size_t i) const {
+    return entries_[i];
+  }
+
+private:
+  std::vector<std::pair<uint64_t, EdgeTy>> entries_;
+  /// One plus the entry of each cluster, if it has one
+  std::vector<uint32_t> index_;
+  std::vector<std::pair<uint64_t, EdgeTy>> pairs_;
+  bool indexed_{false};
+  bool has_own_cluster_{false};
+};
+
 template <typename _Graph, typename _EdgeType, typename _CommunityType>
 struct ClusteringImplementationBase {
   using Graph = _Graph;
@@ -75,52 +187,51 @@ struct ClusteringImplementationBase {
       std::numeric_limits<GNode>::max() / 4;
   constexpr static const double INFINITY_DOUBLE =
       std::numeric_limits<double>::max() / 4;
+  /// Leiden communities also total the weights of their nodes
+  constexpr static bool kHasNodeWeight =
+      std::is_same_v<CommunityType, LeidenCommunityType<EdgeTy>>;
 
   using CommunityArray = katana::NUMAArray<CommunityType>;
 
+  /// The clusters around a node for each thread
+  using PerThreadNeighborClusters =
+      katana::PerThreadStorage<NeighborClusters<EdgeTy>>;
+
   /**
    * Algorithm to find the best cluster for the node
    * to move to among its neighbors in the graph and moves.
    *
-   * It updates the mapping of neighboring nodes clusters
-   * in cluster_local_map, total unique cluster edge weights
-   * in counter as well as total weight of self edges in self_loop_wt.
+   * It updates the total edge weights of the neighboring
+   * clusters in clusters as well as total weight of self
+   * edges in self_loop_wt.
    */
   template <typename EdgeWeightType>
   static void FindNeighboringClusters(
-      const Graph& graph, const GNode& n,
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, EdgeTy& self_loop_wt) {
-    uint64_t num_unique_clusters = 0;
-
+      const Graph& graph, const GNode& n, NeighborClusters<EdgeTy>* clusters,
+      EdgeTy& self_loop_wt) {
     // Add the node's current cluster to be considered
     // for movement as well
-    cluster_local_map[graph.template GetData<CurrentCommunityID>(n)] =
-        0;                 // Add n's current cluster
-    counter.push_back(0);  // Initialize the counter to zero (no edges incident
-                           // yet)
-    num_unique_clusters++;
-
-    // Assuming we have grabbed lock on all the neighbors
-    for (auto e : Edges(graph, n)) {
-      auto dst = EdgeDst(graph, e);
-      // Self loop weights is recorded
-      auto edge_wt = graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
-      if (dst == n) {
-        self_loop_wt += edge_wt;  // Self loop weights is recorded
-      }
-      auto stored_already =
-          cluster_local_map.find(graph.template GetData<CurrentCommunityID>(
-              dst));  // Check if it already exists
-      if (stored_already != cluster_local_map.end()) {
-        counter[stored_already->second] += edge_wt;
-      } else {
-        cluster_local_map[graph.template GetData<CurrentCommunityID>(dst)] =
-            num_unique_clusters;
-        counter.push_back(edge_wt);
-        num_unique_clusters++;
-      }
-    }  // End edge loop
+    clusters->Start(
+        graph.NumNodes(), graph.template GetData<CurrentCommunityID>(n),
+        Degree(graph, n));
+
+    // Assuming we have grabbed lock on all the neighbors; their communities
+    // are read at random, so they are prefetched in batches
+    katana::GatherBatched(
+        Edges(graph, n), [&](auto e) { return EdgeDst(graph, e); },
+        [&](auto dst) {
+          return &graph.template GetData<CurrentCommunityID>(dst);
+        },
+        [&](auto e, auto dst) {
+          auto edge_wt =
+              graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
+          if (dst == n) {
+            self_loop_wt += edge_wt;  // Self loop weights is recorded
+          }
+          clusters->Add(
+              graph.template GetData<CurrentCommunityID>(dst), edge_wt);
+        });
+    clusters->Finish();
   }
 
   /**
@@ -276,44 +387,38 @@ struct ClusteringImplementationBase {
    * without swapping the cluster assignment.
    */
   static uint64_t MaxModularityWithoutSwaps(
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, uint64_t self_loop_wt,
+      const NeighborClusters<EdgeTy>& clusters, uint64_t self_loop_wt,
       CommunityArray& c_info, EdgeTy degree_wt, uint64_t sc, double constant) {
     uint64_t max_index = sc;  // Assign the intial value as self community
     double cur_gain = 0;
     double max_gain = 0;
-    double eix = counter[0] - self_loop_wt;
+    double eix = clusters[0].second - self_loop_wt;
     double ax = c_info[sc].degree_wt - degree_wt;
     double eiy = 0;
     double ay = 0;
 
-    auto stored_already = cluster_local_map.begin();
-    do {
-      if (sc != stored_already->first) {
-        ay = c_info[stored_already->first].degree_wt;  // Degree wt of cluster y
+    // Explore the clusters other than the self community
+    for (size_t i = 1; i < clusters.size(); ++i) {
+      uint64_t cluster = clusters[i].first;
+      ay = c_info[cluster].degree_wt;  // Degree wt of cluster y
 
-        if (ay < (ax + degree_wt)) {
-          stored_already++;
-          continue;
-        } else if (ay == (ax + degree_wt) && stored_already->first > sc) {
-          stored_already++;
-          continue;
-        }
+      if (ay < (ax + degree_wt)) {
+        continue;
+      } else if (ay == (ax + degree_wt) && cluster > sc) {
+        continue;
+      }
 
-        eiy = counter[stored_already
-                          ->second];  // Total edges incident on cluster y
-        cur_gain = 2 * constant * (eiy - eix) +
-                   2 * degree_wt * ((ax - ay) * constant * constant);
+      eiy = clusters[i].second;  // Total edges incident on cluster y
+      cur_gain = 2 * constant * (eiy - eix) +
+                 2 * degree_wt * ((ax - ay) * constant * constant);
 
-        if ((cur_gain > max_gain) ||
-            ((cur_gain == max_gain) && (cur_gain != 0) &&
-             (stored_already->first < max_index))) {
-          max_gain = cur_gain;
-          max_index = stored_already->first;
-        }
+      if ((cur_gain > max_gain) ||
+          ((cur_gain == max_gain) && (cur_gain != 0) &&
+           (cluster < max_index))) {
+        max_gain = cur_gain;
+        max_index = cluster;
       }
-      stored_already++;  // Explore next cluster
-    } while (stored_already != cluster_local_map.end());
+    }
 
     if ((c_info[max_index].size == 1 && c_info[sc].size == 1 &&
          max_index > sc)) {
@@ -324,6 +429,231 @@ struct ClusteringImplementationBase {
     return max_index;
   }
 
+  /**
+   * The nodes of the deterministic clustering rounds grouped into batches;
+   * batch b holds nodes[offsets[b]] to nodes[offsets[b + 1]] in increasing
+   * order.
+   */
+  struct DeterministicBatches {
+    std::vector<GNode> nodes;
+    std::vector<size_t> offsets;
+
+    size_t num_batches() const { return offsets.size() - 1; }
+    const GNode* begin(size_t b) const { return nodes.data() + offsets[b]; }
+    const GNode* end(size_t b) const { return nodes.data() + offsets[b + 1]; }
+  };
+
+  /**
+   * Groups the nodes into batches for the deterministic clustering rounds
+   * by a greedy coloring (Jones-Plassmann): in each round, the nodes whose
+   * neighbors of higher priority all have colors take the smallest color
+   * that none of those neighbors has. Priorities hash the node ids, so the
+   * batches do not depend on the number of threads, and the two ends of an
+   * edge are never in the same batch, so neighbors never move at once.
+   */
+  static DeterministicBatches ColorIntoBatches(const Graph& graph) {
+    constexpr uint32_t kUncolored = std::numeric_limits<uint32_t>::max();
+    auto priority = [](GNode n) {
+      uint64_t x = (uint64_t{n} + 1) * UINT64_C(0x9E3779B97F4A7C15);
+      x = (x ^ (x >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+      x = (x ^ (x >> 27)) * UINT64_C(0x94D049BB133111EB);
+      return std::make_pair(x ^ (x >> 31), n);
+    };
+
+    katana::NUMAArray<uint32_t> color;
+    color.allocateBlocked(graph.NumNodes());
+    katana::InsertBag<GNode> uncolored[2];
+    katana::InsertBag<GNode> ready;
+    katana::do_all(katana::iterate(graph), [&](GNode n) {
+      color[n] = kUncolored;
+      uncolored[0].push(n);
+    });
+
+    katana::PerThreadStorage<std::vector<uint32_t>> neighbor_colors;
+    katana::GReduceMax<uint32_t> max_color;
+    for (size_t round = 0; !uncolored[round % 2].empty(); ++round) {
+      auto& current = uncolored[round % 2];
+      auto& next = uncolored[(round + 1) % 2];
+
+      // colors are only read here and only written below, so a node sees
+      // the same neighbors colored for any schedule
+      katana::do_all(
+          katana::iterate(current),
+          [&](GNode n) {
+            auto p = priority(n);
+            for (auto e : Edges(graph, n)) {
+              auto dst = EdgeDst(graph, e);
+              if (priority(dst) > p && color[dst] == kUncolored) {
+                next.push(n);
+                return;
+              }
+            }
+            ready.push(n);
+          },
+          katana::steal(), katana::no_stats());
+
+      katana::do_all(
+          katana::iterate(ready),
+          [&](GNode n) {
+            auto p = priority(n);
+            auto& colors = *neighbor_colors.getLocal();
+            colors.clear();
+            for (auto e : Edges(graph, n)) {
+              auto dst = EdgeDst(graph, e);
+              if (priority(dst) > p) {
+                colors.push_back(color[dst]);
+              }
+            }
+            std::sort(colors.begin(), colors.end());
+            uint32_t c = 0;
+            for (uint32_t used : colors) {
+              if (used > c) {
+                break;
+              }
+              c = used + 1;
+            }
+            color[n] = c;
+            max_color.update(c);
+          },
+          katana::steal(), katana::no_stats());
+
+      current.clear();
+      ready.clear();
+    }
+
+    DeterministicBatches batches;
+    batches.nodes.resize(graph.NumNodes());
+    katana::do_all(
+        katana::iterate(graph), [&](GNode n) { batches.nodes[n] = n; },
+        katana::no_stats());
+    // stable, so each batch stays in node order
+    katana::ParallelSTL::radix_sort(
+        batches.nodes.begin(), batches.nodes.end(),
+        [&](GNode n) { return color[n]; });
+
+    size_t num_nodes = batches.nodes.size();
+    batches.offsets.resize(num_nodes == 0 ? 1 : max_color.reduce() + 2);
+    batches.offsets.back() = num_nodes;
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t i) {
+          uint32_t c = color[batches.nodes[i]];
+          if (i == 0 || color[batches.nodes[i - 1]] != c) {
+            batches.offsets[c] = i;
+          }
+        },
+        katana::no_stats());
+    return batches;
+  }
+
+  /**
+   * Moves the nodes [first, last) of a batch to their targets and updates
+   * the totals of the communities they leave and join. The changes to each
+   * community are applied in batch order by one thread, so floating point
+   * weights come out the same for any number of threads, and communities
+   * are updated in parallel. Nodes that keep their community or have an
+   * UNASSIGNED target take the target as community without updating the
+   * totals.
+   *
+   * \returns the number of nodes that moved
+   */
+  template <typename EdgeWeightType, typename TargetArray>
+  static uint64_t CommitBatch(
+      Graph* graph, const GNode* first, const GNode* last,
+      const TargetArray& target, CommunityArray& c_info) {
+    struct Update {
+      /// the community plus one, or zero for no update
+      uint64_t key;
+      GNode node;
+      bool join;
+    };
+
+    const size_t size = last - first;
+    std::vector<Update> updates(2 * size);
+    katana::GAccumulator<uint64_t> num_moves;
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t i) {
+          GNode n = first[i];
+          auto& comm_id = graph->template GetData<CurrentCommunityID>(n);
+          uint64_t to = target[n];
+          bool moves = to != comm_id && to != UNASSIGNED;
+          updates[2 * i] = {moves ? comm_id + 1 : 0, n, false};
+          updates[2 * i + 1] = {moves ? to + 1 : 0, n, true};
+          num_moves += moves;
+          comm_id = to;
+        },
+        katana::no_stats());
+
+    katana::ParallelSTL::radix_sort(
+        updates.begin(), updates.end(), [](const Update& u) { return u.key; });
+
+    katana::do_all(
+        katana::iterate(size_t{0}, updates.size()),
+        [&](size_t i) {
+          uint64_t key = updates[i].key;
+          if (key == 0 || (i > 0 && updates[i - 1].key == key)) {
+            return;
+          }
+          auto& comm = c_info[key - 1];
+          uint64_t comm_size = comm.size;
+          EdgeTy degree_wt = comm.degree_wt;
+          [[maybe_unused]] uint64_t node_wt = 0;
+          if constexpr (kHasNodeWeight) {
+            node_wt = comm.node_wt;
+          }
+          for (size_t j = i; j < updates.size() && updates[j].key == key;
+               ++j) {
+            GNode n = updates[j].node;
+            auto n_degree_wt =
+                graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
+            if (updates[j].join) {
+              comm_size += 1;
+              degree_wt += n_degree_wt;
+            } else {
+              comm_size -= 1;
+              degree_wt -= n_degree_wt;
+            }
+            if constexpr (kHasNodeWeight) {
+              auto n_node_wt = graph->template GetData<NodeWeight>(n);
+              node_wt = updates[j].join ? node_wt + n_node_wt
+                                        : node_wt - n_node_wt;
+            }
+          }
+          comm.size = comm_size;
+          comm.degree_wt = degree_wt;
+          if constexpr (kHasNodeWeight) {
+            comm.node_wt = node_wt;
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    return num_moves.reduce();
+  }
+
+  /**
+   * Reports a round of a deterministic algorithm, i.e., a pass over all
+   * batches: the counts add up in the statistics of region and each round
+   * is logged to the active span when there is a tracer.
+   */
+  static void ReportDeterministicRound(
+      const std::string& region, uint32_t round, size_t num_batches,
+      uint64_t num_moves, double modularity) {
+    katana::ReportStatSum(region, "Rounds", 1);
+    katana::ReportStatSum(region, "Batches", num_batches);
+    katana::ReportStatSum(region, "Moves", num_moves);
+    if (katana::ProgressTracer::IsSet()) {
+      katana::GetTracer().GetActiveSpan().Log(
+          "deterministic round", {
+                                     {"region", region},
+                                     {"round", round},
+                                     {"batches", num_batches},
+                                     {"moves", num_moves},
+                                     {"modularity", modularity},
+                                 });
+    }
+  }
+
   template <
       typename EdgeWeightType, typename CommunityIDType,
       typename NodeWeightFunc>
@@ -433,34 +763,42 @@ struct ClusteringImplementationBase {
   /**
  * Renumbers the cluster to contiguous cluster ids
  * to fill the holes in the cluster id assignments.
+ * The new ids keep the order of the old ones: a bitset
+ * marks the ids in use and its prefix sum ranks them.
  */
   template <typename CommunityIDType>
   static uint64_t RenumberClustersContiguously(Graph* graph) {
-    std::map<uint64_t, uint64_t> cluster_local_map;
-    uint64_t num_unique_clusters = 0;
+    katana::GReduceMax<uint64_t> max_comm_id;
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      uint64_t comm_id = graph->template GetData<CommunityIDType>(n);
+      if (comm_id != UNASSIGNED) {
+        max_comm_id.update(comm_id);
+      }
+    });
 
-    // TODO(amber): parallelize
-    for (GNode n : graph->Nodes()) {
-      auto& n_data_curr_comm_id = graph->template GetData<CommunityIDType>(n);
-      if (n_data_curr_comm_id != UNASSIGNED) {
-        auto stored_already = cluster_local_map.find(n_data_curr_comm_id);
-        if (stored_already == cluster_local_map.end()) {
-          cluster_local_map[n_data_curr_comm_id] = num_unique_clusters;
-          num_unique_clusters++;
-        }
+    katana::DynamicBitset comm_ids_in_use;
+    comm_ids_in_use.resize(max_comm_id.reduce() + 1);
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      uint64_t comm_id = graph->template GetData<CommunityIDType>(n);
+      if (comm_id != UNASSIGNED) {
+        comm_ids_in_use.set(comm_id);
       }
-    }
+    });
 
-    uint64_t new_comm_id = 0;
-    for (std::pair<uint64_t, uint64_t> old_comm_id : cluster_local_map) {
-      cluster_local_map[old_comm_id.first] = new_comm_id;
-      new_comm_id++;
-    }
+    // new_comm_ids[c] is one plus the new id of c, if c is in use
+    katana::NUMAArray<uint64_t> new_comm_ids;
+    new_comm_ids.allocateBlocked(comm_ids_in_use.size());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{comm_ids_in_use.size()}),
+        [&](uint64_t c) { new_comm_ids[c] = comm_ids_in_use.test(c); });
+    katana::ParallelSTL::partial_sum(
+        new_comm_ids.begin(), new_comm_ids.end(), new_comm_ids.begin());
+    const uint64_t num_unique_clusters = new_comm_ids[new_comm_ids.size() - 1];
 
     katana::do_all(katana::iterate(*graph), [&](GNode n) {
       auto& n_data_curr_comm_id = graph->template GetData<CommunityIDType>(n);
       if (n_data_curr_comm_id != UNASSIGNED) {
-        n_data_curr_comm_id = cluster_local_map[n_data_curr_comm_id];
+        n_data_curr_comm_id = new_comm_ids[n_data_curr_comm_id] - 1;
       }
     });
 
@@ -561,72 +899,89 @@ struct ClusteringImplementationBase {
 
     const uint64_t num_nodes_next = num_unique_clusters;
 
-    std::vector<std::vector<GNode>> cluster_bags(num_unique_clusters);
-    // TODO(amber): This loop can be parallelized when using a concurrent container
-    // for cluster_bags, but something like katana::InsertBag exhausts the
-    // per-thread-storage memory
-    for (GNode n = 0; n < graph.NumNodes(); ++n) {
-      auto n_data_curr_comm_id = graph.template GetData<CommunityIDType>(n);
-      if (n_data_curr_comm_id != UNASSIGNED) {
-        cluster_bags[n_data_curr_comm_id].push_back(n);
-      }
-    }
+    // Group the nodes by cluster; the sort is stable, so the nodes of a
+    // cluster stay in order and their edge weights add up the same way on
+    // any number of threads
+    auto cluster_of = [&](GNode n) -> uint64_t {
+      uint64_t c = graph.template GetData<CommunityIDType>(n);
+      return c == UNASSIGNED ? num_unique_clusters : c;
+    };
+    katana::NUMAArray<GNode> cluster_nodes;
+    cluster_nodes.allocateBlocked(graph.NumNodes());
+    katana::ParallelSTL::iota(
+        cluster_nodes.begin(), cluster_nodes.end(), GNode{0});
+    katana::ParallelSTL::radix_sort(
+        cluster_nodes.begin(), cluster_nodes.end(), cluster_of);
+
+    // The nodes of cluster c are cluster_nodes[cluster_begin[c],
+    // cluster_begin[c + 1]); unassigned nodes come after all clusters
+    katana::NUMAArray<uint64_t> cluster_begin;
+    cluster_begin.allocateBlocked(num_unique_clusters + 1);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{graph.NumNodes() + 1}),
+        [&](uint64_t i) {
+          uint64_t first = i == 0 ? 0 : cluster_of(cluster_nodes[i - 1]) + 1;
+          uint64_t last = i == graph.NumNodes() ? num_unique_clusters
+                                                : cluster_of(cluster_nodes[i]);
+          for (uint64_t c = first; c <= last; ++c) {
+            cluster_begin[c] = i;
+          }
+        });
 
-    std::vector<katana::gstl::Vector<uint32_t>> edges_id(num_unique_clusters);
-    std::vector<katana::gstl::Vector<EdgeTy>> edges_data(num_unique_clusters);
+    // Each thread sums up the edges out of its clusters and appends them to
+    // its own buffer, which is copied into the CSR once all are counted
+    using ClusterEdges = std::vector<std::pair<uint32_t, EdgeTy>>;
+    katana::PerThreadStorage<ClusterEdges> thread_edges;
+    PerThreadNeighborClusters neighbor_clusters;
+    katana::NUMAArray<const ClusterEdges*> edges_buffer;
+    edges_buffer.allocateInterleaved(num_unique_clusters);
+    katana::NUMAArray<uint64_t> edges_offset;
+    edges_offset.allocateInterleaved(num_unique_clusters);
+    katana::NUMAArray<uint64_t> prefix_edges_count;
+    prefix_edges_count.allocateInterleaved(num_unique_clusters);
 
-    /* First pass to find the number of edges */
     katana::do_all(
         katana::iterate(uint64_t{0}, num_unique_clusters),
         [&](uint64_t c) {
-          katana::gstl::Map<uint64_t, uint64_t> cluster_local_map;
-          uint64_t num_unique_clusters = 0;
-          for (auto node : cluster_bags[c]) {
-            KATANA_LOG_DEBUG_ASSERT(
-                graph.template GetData<CommunityIDType>(node) ==
-                c);  // All nodes in this bag must have same cluster id
+          uint64_t degree = 0;
+          for (uint64_t i = cluster_begin[c]; i < cluster_begin[c + 1]; ++i) {
+            degree += Degree(graph, cluster_nodes[i]);
+          }
 
+          auto* clusters = neighbor_clusters.getLocal();
+          clusters->Start(num_unique_clusters, degree);
+          for (uint64_t i = cluster_begin[c]; i < cluster_begin[c + 1]; ++i) {
+            GNode node = cluster_nodes[i];
+            KATANA_LOG_DEBUG_ASSERT(
+                graph.template GetData<CommunityIDType>(node) == c);
             for (auto e : Edges(graph, node)) {
               auto dst = EdgeDst(graph, e);
               auto dst_data_curr_comm_id =
                   graph.template GetData<CommunityIDType>(dst);
               KATANA_LOG_DEBUG_ASSERT(dst_data_curr_comm_id != UNASSIGNED);
-              auto stored_already = cluster_local_map.find(
-                  dst_data_curr_comm_id);  // Check if it already exists
-              if (stored_already != cluster_local_map.end()) {
-                edges_data[c][stored_already->second] +=
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
-              } else {
-                cluster_local_map[dst_data_curr_comm_id] = num_unique_clusters;
-                edges_id[c].push_back(dst_data_curr_comm_id);
-                edges_data[c].push_back(
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e));
-                num_unique_clusters++;
-              }
+              clusters->Add(
+                  dst_data_curr_comm_id,
+                  graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e));
             }  // End edge loop
           }
+          clusters->Finish();
+
+          auto* edges = thread_edges.getLocal();
+          edges_buffer[c] = edges;
+          edges_offset[c] = edges->size();
+          prefix_edges_count[c] = clusters->size();
+          for (size_t k = 0; k < clusters->size(); ++k) {
+            edges->emplace_back((*clusters)[k].first, (*clusters)[k].second);
+          }
         },
         katana::steal(), katana::loopname("BuildGraph: Find edges"));
 
-    /* Serial loop to reduce all the edge counts */
-    katana::NUMAArray<uint64_t> prefix_edges_count;
-    prefix_edges_count.allocateInterleaved(num_unique_clusters);
-
-    katana::GAccumulator<uint64_t> num_edges_acc;
-    katana::do_all(
-        katana::iterate(uint64_t{0}, num_nodes_next), [&](uint64_t c) {
-          prefix_edges_count[c] = edges_id[c].size();
-          num_edges_acc += prefix_edges_count[c];
-        });
-
-    const uint64_t num_edges_next = num_edges_acc.reduce();
-
     katana::ParallelSTL::partial_sum(
         prefix_edges_count.begin(), prefix_edges_count.end(),
         prefix_edges_count.begin());
 
-    KATANA_LOG_DEBUG_ASSERT(
-        prefix_edges_count[num_unique_clusters - 1] == num_edges_next);
+    const uint64_t num_edges_next =
+        num_nodes_next == 0 ? 0 : prefix_edges_count[num_nodes_next - 1];
     katana::StatTimer TimerConstructFrom("Timer_Construct_From");
     TimerConstructFrom.start();
 
@@ -657,27 +1012,22 @@ struct ClusteringImplementationBase {
 
     katana::do_all(
         katana::iterate(uint64_t{0}, num_nodes_next), [&](uint64_t n) {
-          uint64_t number_of_edges =
-              (n == 0) ? prefix_edges_count[0]
-                       : (prefix_edges_count[n] - prefix_edges_count[n - 1]);
           uint64_t start_index = (n == 0) ? 0 : prefix_edges_count[n - 1];
+          uint64_t number_of_edges = prefix_edges_count[n] - start_index;
+          const auto& edges = *edges_buffer[n];
           for (uint64_t k = 0; k < number_of_edges; ++k) {
-            out_dests_next[start_index + k] = edges_id[n][k];
-            edge_data_next[start_index + k] = edges_data[n][k];
+            const auto& [dst, weight] = edges[edges_offset[n] + k];
+            out_dests_next[start_index + k] = dst;
+            edge_data_next[start_index + k] = weight;
           }
         });
 
     TimerConstructFrom.stop();
 
-    // TODO(amber): This is a lame attempt at freeing the memory back to each
-    // thread's pool of free pages and blocks. Due to stealing, the execution of
-    // do_all above that populates these containers may be different from the
-    // do_all below that frees them.
-    katana::do_all(
-        katana::iterate(uint64_t{0}, num_unique_clusters), [&](uint64_t c) {
-          edges_id[c] = gstl::Vector<uint32_t>();
-          edges_data[c] = gstl::Vector<EdgeTy>();
-        });
+    // The edges are in the CSR now; free their buffers before the properties
+    // of the next level are allocated
+    katana::on_each(
+        [&](unsigned, unsigned) { *thread_edges.getLocal() = ClusterEdges(); });
 
     GraphTopology topo_next{
         std::move(prefix_edges_count), std::move(out_dests_next)};
@@ -741,369 +1091,267 @@ struct ClusteringImplementationBase {
     });
   }
 
-  template <typename ValTy>
-  static double GenerateRandonNumber(ValTy min, ValTy max) {
-    std::random_device
-        rd;  // Will be used to obtain a seed for the random number engine
-    std::mt19937 gen(
-        rd());  // Standard mersenne_twister_engine seeded with rd()
-    std::uniform_real_distribution<> dis(
-        min,
-        max);  // distribution in range [min, max]
-    return dis(gen);
+  /**
+   * A number in [0, 1) drawn from n and seed alone, so that random choices
+   * do not depend on the schedule
+   */
+  static double RandomUnit(GNode n, uint64_t seed) {
+    uint64_t x = (uint64_t{n} + 1) * UINT64_C(0x9E3779B97F4A7C15) ^ seed;
+    x = (x ^ (x >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94D049BB133111EB);
+    x ^= x >> 31;
+    return static_cast<double>(x >> 11) * 0x1.0p-53;
   }
 
+  /**
+   * Picks the subcommunity that node n merges into during refinement, or
+   * its own if it stays. Only a singleton that is well connected to the
+   * rest of its community moves, and only into the subcommunity of a
+   * neighbor in the same community that is itself well connected and that
+   * the move does not make worse. Among those, a subcommunity is picked
+   * with probability proportional to exp(gain / randomness).
+   *
+   * The degree weights are those within the community and external_wt
+   * holds the weight of the edges from each subcommunity to the rest of
+   * its community. link_wt is set to the weight of the edges from n to the
+   * subcommunity picked.
+   */
   template <typename EdgeWeightType>
-  static uint64_t GetSubcommunity(
-      const Graph& graph, GNode n, CommunityArray& subcomm_info,
-      uint64_t comm_id, double constant_for_second_term, double resolution,
-      std::vector<GNode>& subcomms, std::vector<EdgeWeightType>* counter) {
-    auto& n_current_subcomm_id =
-        graph.template GetData<CurrentSubCommunityID>(n);
-
-    std::vector<GNode> destinations;
+  static uint64_t ChooseSubcommunity(
+      const Graph& graph, GNode n, const CommunityArray& subcomm_info,
+      const katana::NUMAArray<std::atomic<EdgeTy>>& external_wt,
+      const katana::NUMAArray<std::atomic<double>>& comm_constant_term,
+      NeighborClusters<EdgeTy>* clusters, double resolution,
+      double randomness, uint64_t seed, EdgeTy* link_wt) {
+    uint64_t own = graph.template GetData<CurrentSubCommunityID>(n);
+    uint64_t comm_id = graph.template GetData<CurrentCommunityID>(n);
+    *link_wt = 0;
+    // nodes that were joined by a neighbor are no longer singletons
+    if (comm_id == UNASSIGNED || subcomm_info[own].size != 1) {
+      return own;
+    }
 
-    EdgeTy self_loop_wt = 0;
+    // 1/(2 * weight of the community), the community's constant for the
+    // second term
+    double constant = comm_constant_term[comm_id];
+    auto well_connected = [&](double external, double degree) {
+      return external >= resolution * degree * (1.0 - degree * constant);
+    };
+    double n_degree_wt = subcomm_info[own].degree_wt;
+    if (!well_connected(external_wt[own], n_degree_wt)) {
+      return own;
+    }
 
+    clusters->Start(graph.NumNodes(), own, Degree(graph, n));
     for (auto e : Edges(graph, n)) {
       auto dst = EdgeDst(graph, e);
-      // Self loop weights is recorded
-      EdgeWeightType edge_wt =
-          graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
-      auto& n_current_comm = graph.template GetData<CurrentCommunityID>(dst);
-      auto& n_current_subcomm =
-          graph.template GetData<CurrentSubCommunityID>(dst);
-
-      if (n_current_comm == comm_id) {
-        if (dst == n) {
-          self_loop_wt += edge_wt;  // Self loop weights is recorded
-          continue;
-        }
-
-        (*counter)[n_current_subcomm] += edge_wt;
-        destinations.push_back(n_current_subcomm);
-      }
-    }  // End edge loop
-
-    uint64_t best_cluster = n_current_subcomm_id;
-    double max_quality_value_increment = -INFINITY_DOUBLE;
-    double quality_value_increment = 0;
-
-    auto& n_degree_wt = graph.template GetData<DegreeWeight<EdgeWeightType>>(n);
-
-    for (auto subcomm : subcomms) {
-      if (n_current_subcomm_id == subcomm || subcomm_info[subcomm].size == 0) {
+      if (dst == n ||
+          graph.template GetData<CurrentCommunityID>(dst) != comm_id) {
         continue;
       }
-
-      double subcomm_degree_wt = subcomm_info[subcomm].degree_wt;
-
-      quality_value_increment =
-          (*counter)[subcomm] - (*counter)[n_current_subcomm_id] -
-          n_degree_wt *
-              (subcomm_degree_wt -
-               subcomm_info[n_current_subcomm_id].degree_wt + n_degree_wt) *
-              constant_for_second_term * resolution;
-
-      if (quality_value_increment > max_quality_value_increment) {
-        best_cluster = subcomm;
-        max_quality_value_increment = quality_value_increment;
-      }
-
-      (*counter)[subcomm] = 0;
+      clusters->Add(
+          graph.template GetData<CurrentSubCommunityID>(dst),
+          graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e));
     }
+    clusters->Finish();
 
-    bool is_dest_subcomm = false;
-
-    for (auto subcomm : destinations) {
-      if (n_current_subcomm_id == subcomm || subcomm_info[subcomm].size == 0) {
-        continue;
-      }
-
+    // the gain of joining the subcommunity of entry i, or a negative number
+    // if n may not join it
+    auto gain = [&](size_t i) {
+      uint64_t subcomm = (*clusters)[i].first;
       double subcomm_degree_wt = subcomm_info[subcomm].degree_wt;
-
-      quality_value_increment =
-          (*counter)[subcomm] - (*counter)[n_current_subcomm_id] -
-          n_degree_wt *
-              (subcomm_degree_wt -
-               subcomm_info[n_current_subcomm_id].degree_wt + n_degree_wt) *
-              constant_for_second_term * resolution;
-
-      if (quality_value_increment > max_quality_value_increment) {
-        best_cluster = subcomm;
-        max_quality_value_increment = quality_value_increment;
-        is_dest_subcomm = true;
+      if (!well_connected(external_wt[subcomm], subcomm_degree_wt)) {
+        return -1.0;
       }
+      return static_cast<double>((*clusters)[i].second) -
+             n_degree_wt * subcomm_degree_wt * constant * resolution;
+    };
 
-      (*counter)[subcomm] = 0;
-    }
-
-    if (is_dest_subcomm) {
-      subcomms.push_back(best_cluster);
+    double max_gain = -1.0;
+    size_t best = 0;
+    for (size_t i = 1; i < clusters->size(); ++i) {
+      double g = gain(i);
+      if (g > max_gain) {
+        max_gain = g;
+        best = i;
+      }
     }
-
-    for (GNode node : destinations) {
-      (*counter)[node] = 0;
+    if (max_gain < 0) {
+      return own;
     }
-    return best_cluster;
-  }
-
-  /**
- * Finds a clustering of the nodes in a network using the local merging
- * algorithm.
- *
- * <p>
- * The local merging algorithm starts from a singleton partition. It
- * performs a single iteration over the nodes in a network. Each node
- * belonging to a singleton cluster is considered for merging with another
- * cluster. This cluster is chosen randomly from all clusters that do not
- * result in a decrease in the quality function. The larger the increase in
- * the quality function, the more likely a cluster is to be chosen. The
- * strength of this effect is determined by the randomness parameter. The
- * higher the value of the randomness parameter, the stronger the
- * randomness in the choice of a cluster. The lower the value of the
- * randomness parameter, the more likely the cluster resulting in the
- * largest increase in the quality function is to be chosen. A node is
- * merged with a cluster only if both are sufficiently well connected to
- * the rest of the network.
- * </p>
- *
- * @param
- *
- * @return : Number of unique subcommunities formed
- * DO NOT parallelize as it is called within Galois parallel loops
- *
- */
-  template <typename EdgeWeightType>
-  static void MergeNodesSubset(
-      Graph* graph, std::vector<GNode>& cluster_nodes, uint64_t comm_id,
-      CommunityArray& subcomm_info,
-      katana::NUMAArray<std::atomic<double>>& constant_for_second_term,
-      double resolution) {
-    for (GNode i = 0; i < cluster_nodes.size(); ++i) {
-      GNode n = cluster_nodes[i];
-      const auto& n_degree_wt =
-          graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
-      const auto& n_node_wt = graph->template GetData<NodeWeight>(n);
-      /*
-     * Initialize with singleton sub-communities
-     */
-      EdgeWeightType node_edge_weight_within_cluster = 0;
-      uint64_t num_edges_within_cluster = 0;
 
-      for (auto e : Edges(*graph, n)) {
-        auto dst = EdgeDst(*graph, e);
-        EdgeWeightType edge_wt =
-            graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
-        /*
-       * Must include the edge weight of all neighbors excluding self loops
-       * belonging to the community comm_id
-       */
-        if (dst != n &&
-            graph->template GetData<CurrentCommunityID>(dst) == comm_id) {
-          node_edge_weight_within_cluster += edge_wt;
-          num_edges_within_cluster++;
+    if (randomness > 0) {
+      // weights relative to the largest gain, so they cannot overflow
+      double total = 0;
+      for (size_t i = 1; i < clusters->size(); ++i) {
+        double g = gain(i);
+        if (g >= 0) {
+          total += std::exp((g - max_gain) / randomness);
+        }
+      }
+      double r = RandomUnit(n, seed) * total;
+      for (size_t i = 1; i < clusters->size(); ++i) {
+        double g = gain(i);
+        if (g < 0) {
+          continue;
+        }
+        best = i;
+        r -= std::exp((g - max_gain) / randomness);
+        if (r < 0) {
+          break;
         }
       }
-
-      uint64_t node_wt = n_node_wt;
-      uint64_t degree_wt = n_degree_wt;
-      /*
-     * Additionally, only nodes that are well connected with
-     * the rest of the network are considered for moving.
-     * (externalEdgeWeightPerCluster[j] >= clusterWeights[j] * (totalNodeWeight
-     * - clusterWeights[j]) * resolution
-     */
-
-      subcomm_info[n].node_wt = node_wt;
-      subcomm_info[n].internal_edge_wt = node_edge_weight_within_cluster;
-      subcomm_info[n].num_internal_edges = num_edges_within_cluster;
-      subcomm_info[n].size = 1;
-      subcomm_info[n].degree_wt = degree_wt;
     }
 
-    std::vector<GNode> subcomms;
-
-    std::vector<EdgeWeightType> counter(graph->size(), 0);
-
-    for (GNode n : cluster_nodes) {
-      const auto& n_degree_wt =
-          graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
-      const auto& n_node_wt = graph->template GetData<NodeWeight>(n);
-      auto& n_current_subcomm_id =
-          graph->template GetData<CurrentSubCommunityID>(n);
-      /*
-     * Only consider singleton communities
-     */
-      if (subcomm_info[n_current_subcomm_id].size == 1) {
-        uint64_t new_subcomm_ass = GetSubcommunity<EdgeWeightType>(
-            *graph, n, subcomm_info, comm_id, constant_for_second_term[comm_id],
-            resolution, subcomms, &counter);
-        if (new_subcomm_ass != UNASSIGNED &&
-            new_subcomm_ass != n_current_subcomm_id) {
-          /*
-         * Move the currently selected node to its new cluster and
-         * update the clustering statistics.
-         */
-          katana::atomicAdd(subcomm_info[new_subcomm_ass].node_wt, n_node_wt);
-          katana::atomicAdd(subcomm_info[new_subcomm_ass].size, uint64_t{1});
-          katana::atomicAdd(
-              subcomm_info[new_subcomm_ass].degree_wt, n_degree_wt);
-
-          katana::atomicSub(
-              subcomm_info[n_current_subcomm_id].node_wt, n_node_wt);
-          katana::atomicSub(
-              subcomm_info[n_current_subcomm_id].size, uint64_t{1});
-          katana::atomicSub(
-              subcomm_info[n_current_subcomm_id].degree_wt, n_degree_wt);
-
-          for (auto e : Edges(*graph, n)) {
-            auto dst = EdgeDst(*graph, e);
-            auto edge_wt =
-                graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
-            if (dst != n &&
-                graph->template GetData<CurrentCommunityID>(dst) == comm_id) {
-              if (graph->template GetData<CurrentSubCommunityID>(dst) ==
-                  new_subcomm_ass) {
-                subcomm_info[new_subcomm_ass].internal_edge_wt -= edge_wt;
-                subcomm_info[new_subcomm_ass].num_internal_edges--;
-              } else {
-                subcomm_info[new_subcomm_ass].internal_edge_wt += edge_wt;
-                subcomm_info[new_subcomm_ass].num_internal_edges++;
-              }
-            }  //end outer if
-
-            if (dst != n &&
-                graph->template GetData<CurrentCommunityID>(dst) == comm_id) {
-              if (graph->template GetData<CurrentSubCommunityID>(dst) ==
-                  n_current_subcomm_id) {
-                subcomm_info[n_current_subcomm_id].internal_edge_wt += edge_wt;
-                subcomm_info[n_current_subcomm_id].num_internal_edges++;
-              } else {
-                subcomm_info[n_current_subcomm_id].internal_edge_wt -= edge_wt;
-                subcomm_info[n_current_subcomm_id].num_internal_edges--;
-              }
-            }  //end outer if
-          }
-        }  //end for
-
-        n_current_subcomm_id = new_subcomm_ass;
-      }  // end outer if
-    }
+    *link_wt = (*clusters)[best].second;
+    return (*clusters)[best].first;
   }
 
-  /*
- * Refine the clustering by iterating over the clusters and by
- * trying to split up each cluster into multiple clusters.
- */
+  /**
+   * Refines the communities into subcommunities (CurrentSubCommunityID) as
+   * in the refinement phase of Leiden: every node starts as a singleton
+   * subcommunity, and singletons may then merge into subcommunities of
+   * their community as picked by ChooseSubcommunity. Only singletons move,
+   * so subcommunities never split up and stay within their community.
+   *
+   * Nodes are visited in the batches of ColorIntoBatches. The nodes of a
+   * batch are never neighbors and a node only joins the subcommunity of a
+   * neighbor, so the nodes of a batch pick from the totals left by earlier
+   * batches in parallel and then move together, updating the totals of the
+   * subcommunities they join with atomics. Random choices hash the node and
+   * seed, so with integral edge weights the subcommunities do not depend on
+   * the number of threads.
+   *
+   * The time of each phase is reported in the statistics, along with the
+   * number of batches and moves under the region Leiden-Refine.
+   */
   template <typename EdgeWeightType>
-  static void RefinePartition(Graph* graph, double resolution) {
-    // set singleton subcommunities
-    katana::do_all(katana::iterate(*graph), [&](GNode n) {
-      graph->template GetData<CurrentSubCommunityID>(n) = n;
-    });
-
-    // populate nodes into communities
-    std::vector<std::vector<GNode>> cluster_bags(graph->size());
-    CommunityArray comm_info;
-
-    comm_info.allocateBlocked(graph->size());
-
-    katana::do_all(katana::iterate(size_t{0}, (graph->size())), [&](size_t n) {
-      comm_info[n].node_wt = 0ull;
-      comm_info[n].degree_wt = 0ull;
-    });
-
-    //TODO (gill): Can be parallelized using do_all.
-    for (GNode n : *graph) {
-      const auto& n_current_comm =
-          graph->template GetData<CurrentCommunityID>(n);
-      const auto& n_node_wt = graph->template GetData<NodeWeight>(n);
-      const auto& n_degree_wt =
-          graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
-      if (n_current_comm != UNASSIGNED) {
-        cluster_bags[n_current_comm].push_back(n);
-
-        katana::atomicAdd(comm_info[n_current_comm].node_wt, n_node_wt);
-        katana::atomicAdd(comm_info[n_current_comm].degree_wt, n_degree_wt);
-      }
-    }
-
-    uint64_t total = 0;
-    for (size_t n = 0; n < graph->size(); ++n) {
-      total += cluster_bags[n].size();
-    }
-
-    CommunityArray subcomm_info;
-
-    subcomm_info.allocateBlocked(graph->size());
+  static void RefinePartition(
+      Graph* graph, double resolution, double randomness, uint64_t seed) {
+    katana::StatTimer timer_setup("Timer_Refine_Setup");
+    timer_setup.start();
+    const size_t num_nodes = graph->NumNodes();
 
+    // degree weights within each community
     SumVertexDegreeWeightCommunity<EdgeWeightType>(graph);
 
     katana::NUMAArray<std::atomic<double>> comm_constant_term;
-
-    comm_constant_term.allocateBlocked(graph->size());
-
+    comm_constant_term.allocateBlocked(num_nodes);
     CalConstantForSecondTerm<EdgeWeightType>(*graph, &comm_constant_term);
 
-    // call MergeNodesSubset for each community in parallel
+    // set singleton subcommunities
+    CommunityArray subcomm_info;
+    subcomm_info.allocateBlocked(num_nodes);
+    katana::NUMAArray<std::atomic<EdgeTy>> external_wt;
+    external_wt.allocateBlocked(num_nodes);
     katana::do_all(
-        katana::iterate(size_t{0}, graph->size()),
-        [&](size_t c) {
-          /*
-                    * Only nodes belonging to singleton clusters can be moved to
-                    * a different cluster. This guarantees that clusters will
-                    * never be split up.
-                    */
-          comm_info[c].num_sub_communities = 0;
-          if (cluster_bags[c].size() > 1) {
-            MergeNodesSubset<EdgeWeightType>(
-                graph, cluster_bags[c], c, subcomm_info, comm_constant_term,
-                resolution);
+        katana::iterate(*graph),
+        [&](GNode n) {
+          graph->template GetData<CurrentSubCommunityID>(n) = n;
+          auto comm_id = graph->template GetData<CurrentCommunityID>(n);
+          EdgeTy external = 0;
+          for (auto e : Edges(*graph, n)) {
+            auto dst = EdgeDst(*graph, e);
+            if (dst != n &&
+                graph->template GetData<CurrentCommunityID>(dst) == comm_id) {
+              external +=
+                  graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
+            }
           }
+          subcomm_info[n].size = 1;
+          subcomm_info[n].degree_wt =
+              graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
+          subcomm_info[n].node_wt = graph->template GetData<NodeWeight>(n);
+          external_wt[n] = external;
         },
-        katana::steal());
-
-    subcomm_info.deallocate();
-    subcomm_info.destroy();
+        katana::loopname("Leiden-Refine-Init"));
+    timer_setup.stop();
+
+    katana::StatTimer timer_color("Timer_Refine_Color");
+    timer_color.start();
+    auto batches = ColorIntoBatches(*graph);
+    timer_color.stop();
+
+    katana::StatTimer timer_merge("Timer_Refine_Merge");
+    timer_merge.start();
+    katana::NUMAArray<GNode> target;
+    target.allocateBlocked(num_nodes);
+    katana::NUMAArray<EdgeTy> link_wt;
+    link_wt.allocateBlocked(num_nodes);
+    PerThreadNeighborClusters neighbor_clusters;
+    katana::GAccumulator<uint64_t> num_moves;
+
+    for (size_t b = 0; b < batches.num_batches(); ++b) {
+      katana::do_all(
+          katana::iterate(batches.begin(b), batches.end(b)),
+          [&](GNode n) {
+            target[n] = ChooseSubcommunity<EdgeWeightType>(
+                *graph, n, subcomm_info, external_wt, comm_constant_term,
+                neighbor_clusters.getLocal(), resolution, randomness, seed,
+                &link_wt[n]);
+          },
+          katana::steal(), katana::loopname("Leiden-Refine-Choose"));
+
+      katana::do_all(
+          katana::iterate(batches.begin(b), batches.end(b)),
+          [&](GNode n) {
+            auto& own = graph->template GetData<CurrentSubCommunityID>(n);
+            uint64_t to = target[n];
+            if (to == own) {
+              return;
+            }
+            auto& from_info = subcomm_info[own];
+            auto& to_info = subcomm_info[to];
+            katana::atomicAdd(to_info.size, uint64_t{1});
+            katana::atomicAdd(to_info.degree_wt, from_info.degree_wt.load());
+            katana::atomicAdd(to_info.node_wt, from_info.node_wt.load());
+            // the edges between n and the subcommunity become internal
+            katana::atomicAdd(external_wt[to], external_wt[own].load());
+            katana::atomicSub(external_wt[to], EdgeTy(2 * link_wt[n]));
+            from_info.size = 0;
+            from_info.degree_wt = 0;
+            from_info.node_wt = 0;
+            external_wt[own] = 0;
+            own = to;
+            num_moves += 1;
+          },
+          katana::loopname("Leiden-Refine-Move"));
+    }
+    timer_merge.stop();
 
-    comm_constant_term.deallocate();
-    comm_constant_term.destroy();
+    katana::ReportStatSum("Leiden-Refine", "Batches", batches.num_batches());
+    katana::ReportStatSum("Leiden-Refine", "Moves", num_moves.reduce());
   }
 
   template <typename EdgeWeightType>
   uint64_t MaxCPMQualityWithoutSwaps(
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeWeightType>& counter, EdgeWeightType self_loop_wt,
-      CommunityArray& c_info, uint64_t node_wt, uint64_t sc,
-      double resolution) {
+      const NeighborClusters<EdgeWeightType>& clusters,
+      EdgeWeightType self_loop_wt, CommunityArray& c_info, uint64_t node_wt,
+      uint64_t sc, double resolution) {
     uint64_t max_index = sc;  // Assign the initial value as self community
     double cur_gain = 0;
     double max_gain = 0;
-    double eix = counter[0] - self_loop_wt;
+    double eix = clusters[0].second - self_loop_wt;
     double eiy = 0;
     auto size_x = static_cast<double>(c_info[sc].node_wt - node_wt);
     double size_y = 0;
 
-    auto stored_already = cluster_local_map.begin();
-    do {
-      if (sc != stored_already->first) {
-        eiy = counter[stored_already
-                          ->second];  // Total edges incident on cluster y
-        size_y = c_info[stored_already->first].node_wt;
-
-        cur_gain = 2.0 * (eiy - eix) - resolution *
-                                           static_cast<double>(node_wt) *
-                                           (size_y - size_x);
-        if ((cur_gain > max_gain) ||
-            ((cur_gain == max_gain) && (cur_gain != 0) &&
-             (stored_already->first < max_index))) {
-          max_gain = cur_gain;
-          max_index = stored_already->first;
-        }
+    // Explore the clusters other than the self community
+    for (size_t i = 1; i < clusters.size(); ++i) {
+      uint64_t cluster = clusters[i].first;
+      eiy = clusters[i].second;  // Total edges incident on cluster y
+      size_y = c_info[cluster].node_wt;
+
+      cur_gain = 2.0 * (eiy - eix) - resolution *
+                                         static_cast<double>(node_wt) *
+                                         (size_y - size_x);
+      if ((cur_gain > max_gain) ||
+          ((cur_gain == max_gain) && (cur_gain != 0) &&
+           (cluster < max_index))) {
+        max_gain = cur_gain;
+        max_index = cluster;
       }
-      stored_already++;  // Explore next cluster
-    } while (stored_already != cluster_local_map.end());
+    }
 
     if ((c_info[max_index].size == 1 && c_info[sc].size == 1 &&
          max_index > sc)) {
@@ -0,0 +1,73 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_GRAPHSTATISTICS_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_GRAPHSTATISTICS_H_
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+
+#include "katana/PropertyGraph.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// Cheap statistics of the topology of a graph, for the automatic plans of
+/// analytics to choose an algorithm and its parameters from. Compute them
+/// with GetGraphStatistics, which caches them in the graph.
+struct KATANA_EXPORT GraphStatistics {
+  /// Graphs whose estimated diameter is above this are treated as
+  /// high-diameter (e.g., road networks and meshes) rather than small-world
+  static constexpr uint32_t kHighDiameter = 64;
+  /// Graphs whose average degree is at least this are treated as dense
+  static constexpr double kDenseAverageDegree = 16;
+
+  uint64_t num_nodes{};
+  uint64_t num_edges{};
+  /// The average out-degree
+  double average_degree{};
+  /// The largest out-degree
+  uint64_t max_degree{};
+  /// The fraction of the possible edges between distinct nodes present
+  double density{};
+  /// The ratio of the average to the median out-degree of a random sample of
+  /// the nodes with out-edges; 1 for a regular graph
+  double degree_skew{};
+  /// Whether the out-degrees look like a power law: see
+  /// IsApproximateDegreeDistributionPowerLaw
+  bool power_law{};
+  /// A lower bound on the diameter in hops along out-edges: the eccentricity
+  /// of the farthest node a BFS from a node of the largest degree reaches.
+  /// It takes two BFS, so it is only computed by GetDiameterEstimate.
+  std::optional<uint32_t> diameter_estimate;
+
+  bool dense() const { return average_degree >= kDenseAverageDegree; }
+
+  /// \returns true if some node has more out-edges than an edge tile of
+  /// edge_tile_size, so that tiling splits the work of a node
+  bool NeedsEdgeTiles(uint64_t edge_tile_size) const {
+    return max_degree > edge_tile_size;
+  }
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  /// Compute the statistics of pg but its diameter estimate
+  static GraphStatistics Compute(const PropertyGraph& pg);
+};
+
+/// \returns the statistics of the topology of pg, computing them only if
+/// they are not cached in pg since its topology last changed
+KATANA_EXPORT GraphStatistics GetGraphStatistics(const PropertyGraph& pg);
+
+/// \returns the diameter estimate of pg, computing it and adding it to the
+/// statistics cached in pg only if it is not there
+KATANA_EXPORT uint32_t GetDiameterEstimate(const PropertyGraph& pg);
+
+/// \returns true if pg is high-diameter: see GraphStatistics::kHighDiameter
+inline bool
+IsHighDiameter(const PropertyGraph& pg) {
+  return GetDiameterEstimate(pg) > GraphStatistics::kHighDiameter;
+}
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_MEMOIZE_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_MEMOIZE_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/k_core/k_core.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// The names of the node properties holding memoized results start with
+/// this
+inline const std::string kMemoizedPropertyPrefix = "__katana_memo_";
+
+/// \returns a hash of the topology and edge types of pg that does not
+/// depend on the order of the out-edges of a node. It takes a pass over the
+/// edges, which is far cheaper than the analytics it keys.
+KATANA_EXPORT uint64_t TopologyFingerprint(const PropertyGraph& pg);
+
+/// Compute a node property, or reuse the result of an earlier computation
+/// of the same thing.
+///
+/// Results are kept in pg as node properties named after a hash of
+/// algorithm_key and TopologyFingerprint(pg), so they are written with the
+/// graph and found again when a later version of it with the same topology
+/// is loaded; loading one goes through the PropertyManager cache like any
+/// other property. algorithm_key must name the algorithm and every
+/// parameter that changes its result, and the algorithm must read nothing
+/// but the topology and edge types of pg.
+///
+/// A memoized result becomes output_property_name without a copy. Otherwise
+/// compute(pg, output_property_name, txn_ctx) makes output_property_name
+/// and its column is kept as the memoized result. Projected graphs are
+/// computed without memoizing.
+///
+/// \returns true if a memoized result was used
+KATANA_EXPORT Result<bool> MemoizeNodeProperty(
+    PropertyGraph* pg, const std::string& algorithm_key,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const std::function<Result<void>(
+        PropertyGraph*, const std::string&, katana::TxnContext*)>& compute);
+
+/// Unload the memoized results that are loaded, to storage if they are not
+/// there yet; see PropertyGraph::UnloadNodeProperty. They are loaded again
+/// when they are next used.
+KATANA_EXPORT Result<void> UnloadMemoizedResults(PropertyGraph* pg);
+
+/// Remove every memoized result from pg
+KATANA_EXPORT Result<void> RemoveMemoizedResults(
+    PropertyGraph* pg, katana::TxnContext* txn_ctx);
+
+/// Pagerank through MemoizeNodeProperty
+KATANA_EXPORT Result<bool> MemoizedPagerank(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, PagerankPlan plan = {});
+
+/// ConnectedComponents through MemoizeNodeProperty
+KATANA_EXPORT Result<bool> MemoizedConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric = false,
+    ConnectedComponentsPlan plan = ConnectedComponentsPlan());
+
+/// KCore through MemoizeNodeProperty
+KATANA_EXPORT Result<bool> MemoizedKCore(
+    PropertyGraph* pg, uint32_t k_core_number,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const bool& is_symmetric = false, KCorePlan plan = KCorePlan());
+
+}  // namespace katana::analytics
+
+#endif
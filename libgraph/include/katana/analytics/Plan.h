@@ -1,6 +1,12 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_PLAN_H_
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_PLAN_H_
 
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+#include "katana/EntityTypeManager.h"
+
 namespace katana::analytics {
 
 enum Architecture {
@@ -14,6 +20,32 @@ enum Architecture {
   kDistributedGPU
 };
 
+/// The width of the edge indices of the topology an algorithm walks. Narrower
+/// indices halve the bytes read from the adjacency indices, see
+/// SizedCSRTopology.
+enum EdgeIndexWidth {
+  /// 32 bits if the graph fits in them, 64 bits otherwise
+  kAutoEdgeIndexWidth,
+  /// 32 bits; fails on graphs with too many edges
+  k32BitEdgeIndex,
+  /// 64 bits, walking the graph's own topology without making a copy
+  k64BitEdgeIndex
+};
+
+/// \returns true if an algorithm planned with width should walk a copy of a
+/// graph with num_edges edges with 32-bit edge indices
+inline bool
+Use32BitEdgeIndex(EdgeIndexWidth width, uint64_t num_edges) {
+  switch (width) {
+  case k32BitEdgeIndex:
+    return true;
+  case k64BitEdgeIndex:
+    return false;
+  default:
+    return num_edges <= std::numeric_limits<uint32_t>::max();
+  }
+}
+
 /// The base class for abstract algorithm execution plans.
 ///
 /// Execution plans contain any tuning parameters the abstract algorithm requires. In general, this will include
@@ -29,13 +61,22 @@ enum Architecture {
 /// larger graph.
 class Plan {
   Architecture architecture_;
+  std::optional<EntityTypeID> edge_type_;
 
 protected:
   explicit Plan(Architecture architecture) : architecture_(architecture) {}
 
+  void set_edge_type(EntityTypeID edge_type) { edge_type_ = edge_type; }
+
 public:
   /// The architecture on which the algorithm will run.
   Architecture architecture() const { return architecture_; }
+
+  /// The type of the only edges the algorithm walks, or none to walk every
+  /// edge. Plans that take an edge type set it with WithEdgeType; the
+  /// algorithm then walks a topology of those edges, see
+  /// MakeGraphOfEdgeType in katana/analytics/Utils.h.
+  const std::optional<EntityTypeID>& edge_type() const { return edge_type_; }
 };
 
 }  // namespace katana::analytics
@@ -0,0 +1,126 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_RUNSTATISTICS_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_RUNSTATISTICS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/ProgressTracer.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// The phases analytics split their runs into
+constexpr char kPhaseViewBuild[] = "view build";
+constexpr char kPhaseInit[] = "init";
+constexpr char kPhaseMainLoop[] = "main loop";
+constexpr char kPhaseOutput[] = "output";
+
+/// The time and memory of one phase of an analytics call
+struct KATANA_EXPORT PhaseStatistics {
+  std::string name;
+  double seconds{};
+  /// The resident set size at the end of the phase minus that at the start
+  /// of the call
+  int64_t rss_delta_bytes{};
+};
+
+/// Where one analytics call spent its time and memory, as recorded into a
+/// RunStatisticsCollector
+struct KATANA_EXPORT RunStatistics {
+  /// The algorithm and plan, e.g., "PagerankPullResidual"
+  std::string algorithm;
+  /// The phases in the order they ran
+  std::vector<PhaseStatistics> phases;
+  /// The rounds of the main loop, for algorithms that run in rounds
+  uint64_t iterations{};
+  /// The nodes or edges visited, by the algorithm's own count
+  uint64_t work_items{};
+  /// The peak resident set size during the call minus that at its start, in
+  /// bytes. The peak is the process high-water mark if the call raised it,
+  /// and the largest resident set size at a phase boundary otherwise.
+  uint64_t peak_memory_bytes{};
+
+  /// \returns the total time of the phases
+  double seconds() const;
+
+  /// \returns the phase named name, or nullptr if there is none
+  const PhaseStatistics* GetPhase(const std::string& name) const;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/// While a RunStatisticsCollector is alive, the statistics of the analytics
+/// called on its thread are appended to it. Collectors nest: only the
+/// innermost one collects.
+///
+///     RunStatisticsCollector collector;
+///     KATANA_CHECKED(Pagerank(pg, "rank", &txn_ctx));
+///     collector.runs().back().Print();
+class KATANA_EXPORT RunStatisticsCollector {
+public:
+  RunStatisticsCollector();
+  ~RunStatisticsCollector();
+  RunStatisticsCollector(const RunStatisticsCollector&) = delete;
+  RunStatisticsCollector& operator=(const RunStatisticsCollector&) = delete;
+
+  const std::vector<RunStatistics>& runs() const { return runs_; }
+
+  /// \returns the innermost collector of this thread, or nullptr
+  static RunStatisticsCollector* Current();
+
+private:
+  friend class RunRecorder;
+
+  RunStatisticsCollector* previous_;
+  std::vector<RunStatistics> runs_;
+};
+
+/// RunRecorder records an analytics call as a ProgressTracer span named after
+/// the algorithm, with a child span per phase, and, if a
+/// RunStatisticsCollector is active, as a RunStatistics. A phase lasts until
+/// the next one starts or the recorder finishes.
+///
+///     RunRecorder recorder("Bfs");
+///     recorder.StartPhase(kPhaseViewBuild);
+///     ...
+///     recorder.StartPhase(kPhaseMainLoop);
+///     ...
+///     recorder.AddIterations(rounds);
+class KATANA_EXPORT RunRecorder {
+public:
+  explicit RunRecorder(const std::string& algorithm);
+  ~RunRecorder();
+  RunRecorder(const RunRecorder&) = delete;
+  RunRecorder& operator=(const RunRecorder&) = delete;
+
+  void StartPhase(const std::string& name);
+
+  void AddIterations(uint64_t iterations) { stats_.iterations += iterations; }
+  void AddWorkItems(uint64_t work_items) { stats_.work_items += work_items; }
+
+  /// End the last phase and record the call. This is called by ~RunRecorder
+  /// if not called explicitly.
+  void Finish();
+
+private:
+  void EndPhase();
+
+  RunStatistics stats_;
+  bool in_phase_{false};
+  bool finished_{false};
+  uint64_t start_rss_bytes_;
+  long start_max_rss_kb_;
+  uint64_t max_rss_bytes_;
+  std::chrono::steady_clock::time_point phase_start_;
+  std::unique_ptr<ProgressScope> run_scope_;
+  std::unique_ptr<ProgressScope> phase_scope_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -2,13 +2,17 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_UTILS_H_
 
 #include <algorithm>
+#include <optional>
 #include <random>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <arrow/type.h>
 
 #include "arrow/util/bitmap.h"
 #include "katana/ErrorCode.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
 #include "katana/Result.h"
 #include "katana/TypedPropertyGraph.h"
@@ -111,6 +115,114 @@ public:
   ~TemporaryPropertyGuard() { Deinit(); }
 };
 
+/// The edges inserted into and deleted from a graph since an analytics result
+/// was computed on it, as (source, destination) node pairs, for the
+/// incremental variants of analytics. The graph passed with them already
+/// reflects them; its nodes must not have changed.
+struct EdgeUpdates {
+  std::vector<std::pair<uint32_t, uint32_t>> inserted;
+  std::vector<std::pair<uint32_t, uint32_t>> deleted;
+};
+
+/// \returns true if some node of graph, whose edges must be sorted by
+/// destination, has an edge to itself or more than one edge to another
+/// node; the intersections of katana/SortedIntersection.h require neither
+template <typename Graph>
+bool
+HasSelfLoopsOrParallelEdges(const Graph& graph) {
+  auto is_bad = [&graph](const typename Graph::Node& n) {
+    const auto* dsts = graph.OutEdgeDsts(n);
+    const auto* end = dsts + graph.OutDegree(n);
+    return std::adjacent_find(dsts, end) != end ||
+           std::binary_search(dsts, end, n);
+  };
+  return katana::ParallelSTL::find_if(graph.begin(), graph.end(), is_bad) !=
+         graph.end();
+}
+
+/// \returns view PGView of pg with only the edges of edge_type, for the
+/// Default, Transposed, EdgesSortedByDestID, BiDirectional and Undirected
+/// views. Its topologies come from PropertyGraph::BuildEdgeTypeTopology.
+template <typename PGView>
+PGView
+MakeViewOfEdgeType(PropertyGraph* pg, const EntityTypeID& edge_type) {
+  using TransposeKind = RDGTopology::TransposeKind;
+  auto out = [&] {
+    return pg->BuildEdgeTypeTopology(TransposeKind::kNo, edge_type);
+  };
+  auto in = [&] {
+    return pg->BuildEdgeTypeTopology(TransposeKind::kYes, edge_type);
+  };
+  if constexpr (std::is_same_v<PGView, PropertyGraphViews::Default>) {
+    return PGView{pg, katana::internal::DefaultPGTopology{out()}};
+  } else if constexpr (std::is_same_v<PGView, PropertyGraphViews::Transposed>) {
+    return PGView{pg, katana::internal::TransposedTopology{in()}};
+  } else if constexpr (std::is_same_v<
+                           PGView, PropertyGraphViews::EdgesSortedByDestID>) {
+    return PGView{pg, katana::internal::EdgesSortedByDestTopology{out()}};
+  } else if constexpr (std::is_same_v<
+                           PGView, PropertyGraphViews::BiDirectional>) {
+    return PGView{pg, katana::internal::SimpleBiDirTopology{out(), in()}};
+  } else {
+    static_assert(
+        std::is_same_v<PGView, PropertyGraphViews::Undirected>,
+        "no view of one edge type of this kind");
+    return PGView{pg, katana::internal::UndirectedTopology{out(), in()}};
+  }
+}
+
+namespace internal {
+
+template <typename Graph>
+struct GraphOfEdgeTypeMaker;
+
+template <typename NodeProps, typename EdgeProps>
+struct GraphOfEdgeTypeMaker<TypedPropertyGraph<NodeProps, EdgeProps>> {
+  static Result<TypedPropertyGraph<NodeProps, EdgeProps>> Make(
+      PropertyGraph* pg, const EntityTypeID& edge_type,
+      const std::vector<std::string>& node_properties,
+      const std::vector<std::string>& edge_properties) {
+    return TypedPropertyGraph<NodeProps, EdgeProps>::Make(
+        pg,
+        pg->BuildEdgeTypeTopology(RDGTopology::TransposeKind::kNo, edge_type),
+        node_properties, edge_properties);
+  }
+};
+
+template <typename PGView, typename NodeProps, typename EdgeProps>
+struct GraphOfEdgeTypeMaker<
+    TypedPropertyGraphView<PGView, NodeProps, EdgeProps>> {
+  static Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>> Make(
+      PropertyGraph* pg, const EntityTypeID& edge_type,
+      const std::vector<std::string>& node_properties,
+      const std::vector<std::string>& edge_properties) {
+    return TypedPropertyGraphView<PGView, NodeProps, EdgeProps>::Make(
+        MakeViewOfEdgeType<PGView>(pg, edge_type), node_properties,
+        edge_properties);
+  }
+};
+
+}  // namespace internal
+
+/// \returns Graph::Make(pg, node_properties, edge_properties), walking only
+/// the edges of edge_type if there is one. The edges of a type are gathered
+/// from the ranges of the edge type aware topology, so an analytic planned
+/// for one edge type reads neither a projected copy of the graph nor the
+/// type of each edge. Graph is a TypedPropertyGraph or a
+/// TypedPropertyGraphView of a view MakeViewOfEdgeType makes.
+template <typename Graph>
+Result<Graph>
+MakeGraphOfEdgeType(
+    PropertyGraph* pg, const std::optional<EntityTypeID>& edge_type,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties) {
+  if (!edge_type) {
+    return Graph::Make(pg, node_properties, edge_properties);
+  }
+  return internal::GraphOfEdgeTypeMaker<Graph>::Make(
+      pg, *edge_type, node_properties, edge_properties);
+}
+
 KATANA_EXPORT void SplitStringByComma(
     std::string& str, std::vector<std::string>* vec);
 
@@ -18,16 +18,31 @@ public:
   enum Algorithm {
     kLevel,
     kOuter,
-    // TODO(gill): Reinstate async and auto once we have bidirectional graphs.
-    // kAsynchronous,
+    kApproximate,
+    kAsynchronous,
+    // TODO(gill): Reinstate auto once it can choose between level and async.
     // kAutomatic,
   };
 
+  static constexpr double kDefaultEpsilon = 0.01;
+  static constexpr double kDefaultDelta = 0.1;
+  static constexpr uint64_t kDefaultSeed = 0;
+
 private:
   Algorithm algorithm_;
-
-  BetweennessCentralityPlan(Architecture architecture, Algorithm algorithm)
-      : Plan(architecture), algorithm_(algorithm) {}
+  double epsilon_;
+  double delta_;
+  uint64_t seed_;
+
+  BetweennessCentralityPlan(
+      Architecture architecture, Algorithm algorithm,
+      double epsilon = kDefaultEpsilon, double delta = kDefaultDelta,
+      uint64_t seed = kDefaultSeed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        epsilon_(epsilon),
+        delta_(delta),
+        seed_(seed) {}
 
 public:
   BetweennessCentralityPlan() : BetweennessCentralityPlan{kCPU, kLevel} {}
@@ -50,11 +65,39 @@ public:
   }
 
   Algorithm algorithm() const { return algorithm_; }
+  /// The bound on the error of kApproximate, as a fraction of n * (n - 1)
+  double epsilon() const { return epsilon_; }
+  /// The probability that kApproximate exceeds its error bound
+  double delta() const { return delta_; }
+  /// The seed of the random sources of kApproximate
+  uint64_t seed() const { return seed_; }
 
   static BetweennessCentralityPlan Level() { return {kCPU, kLevel}; }
 
   static BetweennessCentralityPlan Outer() { return {kCPU, kOuter}; }
 
+  /// Process each source with worklists instead of levels: distances by a
+  /// search ordered by distance, then shortest path counts pushed down and
+  /// dependencies pushed up the shortest path DAG, each node going once its
+  /// last DAG neighbor on the near side is done. There is no barrier per
+  /// level, which pays off on graphs of high diameter, such as road
+  /// networks. Only the nodes a source reaches are reset after it.
+  static BetweennessCentralityPlan Asynchronous() {
+    return {kCPU, kAsynchronous};
+  }
+
+  /// Estimate betweenness centrality from the dependencies of uniformly
+  /// sampled sources, computed as by kLevel. With probability at least
+  /// 1 - delta, the estimate of every node is within epsilon * n * (n - 1)
+  /// of its exact centrality. Sampling stops early once an empirical
+  /// Bernstein bound on the observed variances meets epsilon, or after
+  /// ln(4n / delta) / (2 epsilon^2) sources, where a Hoeffding bound does.
+  static BetweennessCentralityPlan Approximate(
+      double epsilon = kDefaultEpsilon, double delta = kDefaultDelta,
+      uint64_t seed = kDefaultSeed) {
+    return {kCPU, kApproximate, epsilon, delta, seed};
+  }
+
   static BetweennessCentralityPlan FromAlgorithm(Algorithm algo) {
     return BetweennessCentralityPlan(kCPU, algo);
   }
@@ -78,6 +121,8 @@ KATANA_EXPORT extern const BetweennessCentralitySources
 /// @param sources Only process some sources, producing an approximate
 ///          betweenness centrality. If this is a vector process those source
 ///          nodes; if this is an int process that number of source nodes.
+///          With kApproximate, an int caps the number of sampled sources and
+///          a vector is an error.
 /// @param plan
 KATANA_EXPORT Result<void> BetweennessCentrality(
     PropertyGraph* pg, const std::string& output_property_name,
@@ -2,7 +2,9 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_BFS_BFS_H_
 
 #include <iostream>
+#include <vector>
 
+#include "katana/analytics/GraphStatistics.h"
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
 
@@ -45,6 +47,20 @@ public:
             kCPU, kSynchronousDirectOpt, kDefaultEdgeTileSize, kDefaultAlpha,
             kDefaultBeta} {}
 
+  /// Choose an algorithm from the statistics of pg: direction-optimizing
+  /// BFS for small-world graphs, whose frontiers soon cover much of the
+  /// graph, and asynchronous BFS for high-diameter ones, tiled if some node
+  /// has more edges than a tile
+  BfsPlan(const katana::PropertyGraph* pg) : Plan(kCPU) {
+    if (!IsHighDiameter(*pg)) {
+      *this = SynchronousDirectOpt();
+    } else if (GetGraphStatistics(*pg).NeedsEdgeTiles(kDefaultEdgeTileSize)) {
+      *this = AsynchronousTile();
+    } else {
+      *this = Asynchronous();
+    }
+  }
+
   Algorithm algorithm() const { return algorithm_; }
   ptrdiff_t edge_tile_size() const { return edge_tile_size_; }
   uint32_t alpha() const { return alpha_; }
@@ -68,6 +84,13 @@ public:
       uint32_t alpha = kDefaultAlpha, uint32_t beta = kDefaultBeta) {
     return {kCPU, kSynchronousDirectOpt, 0, alpha, beta};
   }
+
+  /// This plan searching along the edges of edge_type only
+  BfsPlan WithEdgeType(EntityTypeID edge_type) const {
+    BfsPlan plan = *this;
+    plan.set_edge_type(edge_type);
+    return plan;
+  }
 };
 
 /// Compute BFS parent of nodes in the graph pg starting from start_node. The
@@ -100,6 +123,79 @@ struct KATANA_EXPORT BfsStatistics {
       katana::PropertyGraph* pg, const std::string& property_name);
 };
 
+/// A computational plan for BFS from many sources at once
+class MultiSourceBfsPlan : public Plan {
+public:
+  enum Algorithm {
+    kBitParallel = 0,
+  };
+
+  static constexpr uint32_t kDefaultBatchSize = 256;
+  static constexpr uint32_t kMaxBatchSize = 512;
+
+private:
+  Algorithm algorithm_;
+  uint32_t batch_size_;
+
+  MultiSourceBfsPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t batch_size)
+      : Plan(architecture), algorithm_(algorithm), batch_size_(batch_size) {}
+
+public:
+  MultiSourceBfsPlan()
+      : MultiSourceBfsPlan{kCPU, kBitParallel, kDefaultBatchSize} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  uint32_t batch_size() const { return batch_size_; }
+
+  /// Run batch_size searches at a time, a multiple of 64 up to
+  /// kMaxBatchSize. Each node keeps one bit per search in each of three bit
+  /// sets (seen, frontier and next frontier), so that one scan of the edges
+  /// of a node advances every search that has it in its frontier.
+  static MultiSourceBfsPlan BitParallel(
+      uint32_t batch_size = kDefaultBatchSize) {
+    return {kCPU, kBitParallel, batch_size};
+  }
+};
+
+/// Results of a BFS from each of many sources
+struct KATANA_EXPORT MultiSourceBfsStatistics {
+  /// For each source, the number of nodes it reaches, including itself
+  std::vector<uint64_t> n_reached_nodes;
+  /// For each source, the sum of the levels of the nodes it reaches
+  std::vector<uint64_t> level_sums;
+  /// For each source, the largest level of a node it reaches
+  std::vector<uint32_t> max_levels;
+
+  /// The closeness centrality of source i within the nodes it reaches, i.e.,
+  /// the inverse of their average level; 0 if it reaches no other node
+  double Closeness(size_t i) const;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/// Compute a BFS from each node in sources, in batches of searches that share
+/// each scan of the edges as set by the plan. For each node, the number of
+/// searches from sources that reach it is stored in a property named by
+/// output_property_name (as uint32_t), which is created by this function and
+/// may not exist before the call. The levels of the nodes reached by each
+/// search are summarized in the returned statistics, in the order of
+/// sources.
+KATANA_EXPORT Result<MultiSourceBfsStatistics> MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MultiSourceBfsPlan plan = {});
+
+/// Check the results of MultiSourceBfs from sources stored in property_name
+/// against the number of searches that reach each node, recomputed with a
+/// separate BFS from each source.
+/// @return a failure if the results do not pass validation or if there is a
+///     failure during checking.
+KATANA_EXPORT Result<void> MultiSourceBfsAssertValid(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& property_name);
+
 }  // namespace katana::analytics
 
 #endif
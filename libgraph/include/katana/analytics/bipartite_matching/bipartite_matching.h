@@ -0,0 +1,86 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+
+#include <iostream>
+
+#include <katana/analytics/Plan.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for maximum bipartite matchings, specifying the
+/// algorithm and any parameters associated with it.
+class BipartiteMatchingPlan : public Plan {
+public:
+  /// Algorithm selectors for bipartite matchings
+  enum Algorithm { kPothenFan };
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+
+  BipartiteMatchingPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  BipartiteMatchingPlan() : BipartiteMatchingPlan(PothenFan()) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// A greedy initial matching followed by phases of parallel depth first
+  /// searches for augmenting paths from every unmatched left node, with
+  /// lookahead and alternating search directions (PF+):
+  ///   Ariful Azad, Mahantesh Halappanavar, Sivasankaran Rajamanickam, Erik
+  ///   G. Boman, Arif Khan, and Alex Pothen. Multithreaded Algorithms for
+  ///   Maximum Matching in Bipartite Graphs. IPDPS 2012.
+  ///
+  /// The searches of a phase claim right nodes atomically, so their paths
+  /// are disjoint and are augmented without locks. The matching is maximum
+  /// once a phase augments no path.
+  static BipartiteMatchingPlan PothenFan() { return {kCPU, kPothenFan}; }
+};
+
+/// Compute a maximum matching of the bipartite graph whose left nodes are
+/// the nodes of pg with the node type left_node_type and whose right nodes
+/// are all other nodes. Edges in either direction between a left and a
+/// right node may be matched; edges between two nodes of the same side are
+/// ignored.
+///
+/// The uint32 node property named output_property_name holds the partner
+/// of each node, or std::numeric_limits<uint32_t>::max() for unmatched
+/// nodes. It is created by this function and may not exist before the
+/// call.
+KATANA_EXPORT Result<void> BipartiteMatching(
+    PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    BipartiteMatchingPlan plan = {});
+
+/// Check that the partners in output_property_name are mutual, join a left
+/// and a right node by an edge and leave no augmenting path.
+KATANA_EXPORT Result<void> BipartiteMatchingAssertValid(
+    PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& output_property_name);
+
+struct KATANA_EXPORT BipartiteMatchingStatistics {
+  /// The number of left and of right nodes
+  uint64_t num_left_nodes;
+  uint64_t num_right_nodes;
+  /// The number of matched pairs
+  uint64_t num_matched;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<BipartiteMatchingStatistics> Compute(
+      PropertyGraph* pg, const std::string& left_node_type,
+      const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -2,6 +2,7 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_CDLP_CDLP_H_
 
 #include <iostream>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
@@ -18,6 +19,7 @@ public:
   enum Algorithm {
     kSynchronous,
     kAsynchronous,
+    kFrontier,
   };
 
   /// Limited number of iterations to limit the oscillation of the label
@@ -92,15 +94,26 @@ public:
   /// their neighbors have, then stop the algorithm
 
   static CdlpPlan Asynchronous() { return {kCPU, kAsynchronous}; }
+
+  /// Synchronous community detection that only revisits the nodes with a
+  /// neighbor whose label changed in the previous iteration. The label a node
+  /// picks depends only on the labels of its neighbors, so the result is the
+  /// same as that of Synchronous, but once most labels have settled an
+  /// iteration costs time in the edges of the few nodes still changing
+  /// rather than in the whole graph.
+  static CdlpPlan Frontier() { return {kCPU, kFrontier}; }
 };
 
 /// Compute the Community Detection for pg. The pg can be either directed or undirected
 /// The property named output_property_name is created by this function and may
-/// not exist before the call.
+/// not exist before the call. If changed_per_iteration is not null, it is set
+/// to the number of nodes whose label changed in each iteration; it ends in 0
+/// if the labels converged within max_iterations.
 KATANA_EXPORT Result<void> Cdlp(
     PropertyGraph* pg, const std::string& output_property_name,
     size_t max_iterations, katana::TxnContext* txn_ctx,
-    const bool& is_symmetric = false, CdlpPlan plan = CdlpPlan());
+    const bool& is_symmetric = false, CdlpPlan plan = CdlpPlan(),
+    std::vector<uint64_t>* changed_per_iteration = nullptr);
 
 /// TODO (Yasin): This Struct (Compute function) is now being used by louvain,
 /// cc, and cdlp, basically everything which is calculating communities. Explore
@@ -115,12 +128,16 @@ struct KATANA_EXPORT CdlpStatistics {
   uint64_t largest_community_size;
   /// The ratio of nodes present in the largest community.
   double largest_community_ratio;
+  /// The number of nodes whose label changed in each iteration, as given by
+  /// Cdlp; empty if that is not known.
+  std::vector<uint64_t> changed_per_iteration;
 
   /// Print the statistics in a human readable form.
   void Print(std::ostream& os = std::cout) const;
 
   static katana::Result<CdlpStatistics> Compute(
-      katana::PropertyGraph* pg, const std::string& property_name);
+      katana::PropertyGraph* pg, const std::string& property_name,
+      std::vector<uint64_t> changed_per_iteration = {});
 };
 
 }  // namespace katana::analytics
@@ -0,0 +1,92 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_CLIQUECOUNT_CLIQUECOUNT_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_CLIQUECOUNT_CLIQUECOUNT_H_
+
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for counting the k-cliques of a graph.
+class CliqueCountPlan : public Plan {
+public:
+  enum Algorithm {
+    kOrderedListing,
+  };
+
+  /// The largest clique size counted
+  static const uint32_t kMaxCliqueSize = 16;
+  /// Nodes with at least this many smaller neighbors are split into a task
+  /// for each neighbor
+  static const uint32_t kDefaultHubDegree = 1024;
+
+private:
+  Algorithm algorithm_;
+  uint32_t hub_degree_;
+
+  CliqueCountPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t hub_degree)
+      : Plan(architecture), algorithm_(algorithm), hub_degree_(hub_degree) {}
+
+public:
+  CliqueCountPlan() : CliqueCountPlan{OrderedListing()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  uint32_t hub_degree() const { return hub_degree_; }
+
+  /**
+   * List the cliques in the orientation of the graph by degree that
+   * TriangleCountPlan::OrderedCount uses, in which each clique is found
+   * once, from its largest node: the candidates for the next node of a
+   * clique are the intersection of the smaller neighbors of its nodes, by
+   * the intersection kernels of katana/SortedIntersection.h. From the
+   * following:
+   *   Maximilien Danisch, Oana Balalau, and Mauro Sozio. Listing k-cliques in
+   *   Sparse Real-World Graphs. WWW 2018.
+   *
+   * @param hub_degree Nodes with at least this many smaller neighbors have
+   *     the cliques of each neighbor listed by a task of its own.
+   */
+  static CliqueCountPlan OrderedListing(
+      uint32_t hub_degree = kDefaultHubDegree) {
+    return {kCPU, kOrderedListing, hub_degree};
+  }
+};
+
+/**
+ * Count the cliques of clique_size nodes in the graph, e.g., 4 for the
+ * 4-cliques. Self loops and parallel edges are ignored. The graph must be
+ * symmetric!
+ *
+ * @param pg The graph to process.
+ * @param clique_size The number of nodes of the cliques, from 2 to
+ *     CliqueCountPlan::kMaxCliqueSize
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<uint64_t> CliqueCount(
+    PropertyGraph* pg, uint32_t clique_size, CliqueCountPlan plan = {});
+
+/**
+ * Count the cliques of clique_size nodes in the graph and the number of
+ * them each node is in, into a new uint64 node property. The graph must be
+ * symmetric!
+ *
+ * @param pg The graph to process.
+ * @param clique_size The number of nodes of the cliques, from 2 to
+ *     CliqueCountPlan::kMaxCliqueSize
+ * @param output_property_name The node property of the counts of each node
+ * @param txn_ctx
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<uint64_t> CliqueCount(
+    PropertyGraph* pg, uint32_t clique_size,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    CliqueCountPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/analytics/GraphStatistics.h"
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
 
@@ -59,6 +60,18 @@ public:
             kCPU, kAfforest, 0, kDefaultNeighborSampleSize,
             kDefaultComponentSampleFrequency} {}
 
+  /// Choose an algorithm from the statistics of pg: Afforest, with tiles of
+  /// edges as work items for power-law graphs where some node has more
+  /// edges than a tile
+  ConnectedComponentsPlan(const katana::PropertyGraph* pg) : Plan(kCPU) {
+    GraphStatistics stats = GetGraphStatistics(*pg);
+    if (stats.power_law && stats.NeedsEdgeTiles(kDefaultEdgeTileSize)) {
+      *this = EdgeTiledAfforest();
+    } else {
+      *this = Afforest();
+    }
+  }
+
   Algorithm algorithm() const { return algorithm_; }
   ptrdiff_t edge_tile_size() const { return edge_tile_size_; }
   uint32_t neighbor_sample_size() const { return neighbor_sample_size_; }
@@ -148,10 +161,19 @@ public:
         kCPU, kEdgeAfforest, edge_tile_size, neighbor_sample_size,
         component_sample_frequency};
   }
+
+  /// This plan connecting nodes along the edges of edge_type only
+  ConnectedComponentsPlan WithEdgeType(EntityTypeID edge_type) const {
+    ConnectedComponentsPlan plan = *this;
+    plan.set_edge_type(edge_type);
+    return plan;
+  }
 };
 
-/// Compute the Connected-components for pg. The pg is expected to be
-/// symmetric.
+/// Compute the Connected-components for pg. Unless is_symmetric, these are
+/// the weakly connected components: Afforest works on the out-edges alone,
+/// LabelProp adds the transposed topology, and the other algorithms run on
+/// the undirected view, which also builds the transpose.
 /// The algorithm, neighbor sample size and component sample frequency and tile size
 /// parameters can be specified, but have reasonable defaults. Not all parameters
 /// are used by the algorithms.
@@ -162,6 +184,18 @@ KATANA_EXPORT Result<void> ConnectedComponents(
     katana::TxnContext* txn_ctx, const bool& is_symmetric = false,
     ConnectedComponentsPlan plan = ConnectedComponentsPlan());
 
+/// Update the components in the property named previous_property_name, which
+/// ConnectedComponents computed before updates were applied to pg, and store
+/// them in the property named output_property_name, which is created by this
+/// function and may not exist before the call. Inserted edges merge the
+/// previous components of their endpoints; only the components that lose an
+/// edge are recomputed from their edges. Component IDs are not preserved:
+/// each component is identified by its smallest node ID.
+KATANA_EXPORT Result<void> ConnectedComponentsIncremental(
+    PropertyGraph* pg, const std::string& previous_property_name,
+    const EdgeUpdates& updates, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric = false);
+
 KATANA_EXPORT Result<void> ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
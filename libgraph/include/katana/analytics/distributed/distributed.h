@@ -0,0 +1,257 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_DISTRIBUTED_DISTRIBUTED_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_DISTRIBUTED_DISTRIBUTED_H_
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/TxnContext.h"
+#include "katana/URI.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// The part of a graph that one host of a distributed job works on, for
+/// bulk-synchronous analytics across hosts.
+///
+/// The graph is split with an outgoing edge cut: host h owns, or is the
+/// master of, the contiguous range of global nodes [node_bounds()[h],
+/// node_bounds()[h + 1]) and holds all of their out edges. The other
+/// endpoints of those edges that belong to other hosts are mirrors, local
+/// proxies of nodes mastered elsewhere. Local node ids number the masters
+/// first, in global order, then the mirrors, sorted by global id, so the
+/// mirrors of each other host are a contiguous range. Mirrors have no out
+/// edges.
+///
+/// Analytics keep a value per local node. A round computes on the local
+/// topology, updating masters and mirrors alike and marking what changed in
+/// a DynamicBitset, and then synchronizes: Reduce combines the changed
+/// mirror values into their masters and Broadcast copies the changed master
+/// values out to their mirrors. Only marked values are sent.
+///
+/// Every host must make the same calls in the same order, since the
+/// synchronization uses the collectives of the CommBackend.
+class KATANA_EXPORT DistributedGraph {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+
+  /// Partition the graph at rdg_dir across the hosts of comm, each owning a
+  /// range of nodes with roughly equal numbers of nodes plus edges. Each
+  /// host reads the adjacency indices of all nodes once to find the ranges
+  /// but keeps only its own nodes and their out edges in memory, so graphs
+  /// larger than one host can be analyzed.
+  ///
+  /// Requires an uncompressed CSR topology on storage, as OutOfCoreTopology
+  /// does.
+  static Result<std::unique_ptr<DistributedGraph>> Make(
+      CommBackend* comm, const URI& rdg_dir, TxnContext* txn_ctx);
+
+  /// Partition topology, which every host has in memory, like the Make
+  /// above. Mostly for testing; the local graph is a copy of part of it.
+  static Result<std::unique_ptr<DistributedGraph>> Make(
+      CommBackend* comm, const GraphTopology& topology);
+
+  /// Make the part of a graph owned by this host from its node ranges, the
+  /// out edges of its nodes and their destinations as global node ids.
+  ///
+  /// \param node_bounds the first global node of each host followed by the
+  ///     number of global nodes
+  /// \param out_indices one past the last out edge of each master, counting
+  ///     from the first edge of this host
+  /// \param global_dests the global destination of each of those edges
+  static Result<std::unique_ptr<DistributedGraph>> Make(
+      CommBackend* comm, std::vector<uint64_t> node_bounds,
+      const std::vector<uint64_t>& out_indices,
+      const std::vector<Node>& global_dests);
+
+  CommBackend* comm() const { return comm_; }
+
+  /// The local topology. Nodes at or after NumMasters() are mirrors.
+  const GraphTopology& topology() const { return topology_; }
+
+  uint64_t NumMasters() const { return num_masters_; }
+  uint64_t NumMirrors() const { return topology_.NumNodes() - num_masters_; }
+  uint64_t NumLocalNodes() const { return topology_.NumNodes(); }
+  uint64_t NumLocalEdges() const { return topology_.NumEdges(); }
+  uint64_t NumGlobalNodes() const { return node_bounds_.back(); }
+
+  const std::vector<uint64_t>& node_bounds() const { return node_bounds_; }
+
+  /// The global id of the first out edge of this host, in the CSR order of
+  /// the whole graph; local edges follow in the same order, e.g., for
+  /// loading edge properties with RDGSlice
+  uint64_t first_global_edge() const { return first_global_edge_; }
+
+  bool IsMaster(Node node) const { return node < num_masters_; }
+  Node GlobalId(Node node) const { return local_to_global_[node]; }
+
+  /// The host that masters global node
+  uint32_t HostOf(Node global_node) const;
+
+  /// The local id of global_node if it is a master or mirror here
+  std::optional<Node> LocalId(Node global_node) const;
+
+  /// Combine the values of the mirrors marked in dirty into their masters
+  /// with op, which must be kMin, kMax or kSum. Masters whose value changes
+  /// are marked in dirty and the marks of the mirrors are cleared. For kSum
+  /// the values of the sent mirrors are reset to 0, so that they are not
+  /// added twice.
+  template <typename T>
+  Result<void> Reduce(T* values, DynamicBitset* dirty, ReduceOp op);
+
+  /// Copy the values of the masters marked in dirty, or of every master if
+  /// dirty is null, to their mirrors on other hosts
+  template <typename T>
+  Result<void> Broadcast(T* values, const DynamicBitset* dirty);
+
+private:
+  DistributedGraph() = default;
+
+  /// Send send[h] to each host h and return what each host sent here
+  Result<std::vector<std::vector<uint8_t>>> Exchange(
+      const std::vector<std::vector<uint8_t>>& send);
+
+  template <typename T>
+  static void Append(std::vector<uint8_t>* buf, uint32_t index, const T& val) {
+    size_t off = buf->size();
+    buf->resize(off + sizeof(uint32_t) + sizeof(T));
+    std::memcpy(buf->data() + off, &index, sizeof(uint32_t));
+    std::memcpy(buf->data() + off + sizeof(uint32_t), &val, sizeof(T));
+  }
+
+  /// Call fn(index, value) for each entry appended to buf
+  template <typename T, typename Fn>
+  static void ForEachEntry(const std::vector<uint8_t>& buf, const Fn& fn) {
+    constexpr size_t kEntrySize = sizeof(uint32_t) + sizeof(T);
+    for (size_t off = 0; off + kEntrySize <= buf.size(); off += kEntrySize) {
+      uint32_t index;
+      T val;
+      std::memcpy(&index, buf.data() + off, sizeof(uint32_t));
+      std::memcpy(&val, buf.data() + off + sizeof(uint32_t), sizeof(T));
+      fn(index, val);
+    }
+  }
+
+  CommBackend* comm_{nullptr};
+  std::vector<uint64_t> node_bounds_;
+  uint64_t first_global_edge_{0};
+  uint64_t num_masters_{0};
+  GraphTopology topology_;
+  std::vector<Node> local_to_global_;
+  /// The first local id of the mirrors of each host, followed by
+  /// NumLocalNodes()
+  std::vector<uint64_t> mirror_bounds_;
+  /// The local masters mirrored on each host, in the order of the mirrors
+  /// there
+  std::vector<std::vector<Node>> masters_for_;
+};
+
+template <typename T>
+Result<void>
+DistributedGraph::Reduce(T* values, DynamicBitset* dirty, ReduceOp op) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  if (op != ReduceOp::kMin && op != ReduceOp::kMax && op != ReduceOp::kSum) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "mirrors reduce with min, max or sum");
+  }
+
+  uint32_t num_hosts = comm_->num();
+  std::vector<std::vector<uint8_t>> send(num_hosts);
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    for (uint64_t n = mirror_bounds_[h]; n < mirror_bounds_[h + 1]; ++n) {
+      if (!dirty->test(n)) {
+        continue;
+      }
+      Append(&send[h], n - mirror_bounds_[h], values[n]);
+      dirty->reset(n);
+      if (op == ReduceOp::kSum) {
+        values[n] = T{};
+      }
+    }
+  }
+
+  auto recv = KATANA_CHECKED(Exchange(send));
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    ForEachEntry<T>(recv[h], [&](uint32_t index, const T& val) {
+      Node master = masters_for_[h][index];
+      T old = values[master];
+      if (op == ReduceOp::kSum) {
+        values[master] = old + val;
+      } else if (op == ReduceOp::kMin) {
+        values[master] = val < old ? val : old;
+      } else {
+        values[master] = old < val ? val : old;
+      }
+      if (values[master] != old) {
+        dirty->set(master);
+      }
+    });
+  }
+  return ResultSuccess();
+}
+
+template <typename T>
+Result<void>
+DistributedGraph::Broadcast(T* values, const DynamicBitset* dirty) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  uint32_t num_hosts = comm_->num();
+  std::vector<std::vector<uint8_t>> send(num_hosts);
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    const auto& masters = masters_for_[h];
+    for (uint32_t i = 0; i < masters.size(); ++i) {
+      if (dirty == nullptr || dirty->test(masters[i])) {
+        Append(&send[h], i, values[masters[i]]);
+      }
+    }
+  }
+
+  auto recv = KATANA_CHECKED(Exchange(send));
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    ForEachEntry<T>(recv[h], [&](uint32_t index, const T& val) {
+      values[mirror_bounds_[h] + index] = val;
+    });
+  }
+  return ResultSuccess();
+}
+
+/// The BFS level of each local node from the global node source along out
+/// edges, or std::numeric_limits<uint32_t>::max() for nodes it does not
+/// reach. Mirrors hold the levels of their masters. One round per level.
+KATANA_EXPORT Result<NUMAArray<uint32_t>> DistributedBfs(
+    DistributedGraph* graph, uint32_t source);
+
+/// The shortest distance of each local node from the global node source
+/// along out edges with weights[e] the weight of local edge e, computed with
+/// a frontier based Bellman-Ford; std::numeric_limits<uint32_t>::max() for
+/// nodes it does not reach. Mirrors hold the distances of their masters.
+KATANA_EXPORT Result<NUMAArray<uint32_t>> DistributedSssp(
+    DistributedGraph* graph, uint32_t source,
+    const std::vector<uint32_t>& weights);
+
+/// The PageRank of each local node computed like OutOfCorePagerank, with
+/// the tolerance, maximum iterations and alpha of plan. Mirrors hold the
+/// ranks of their masters.
+KATANA_EXPORT Result<NUMAArray<float>> DistributedPagerank(
+    DistributedGraph* graph, const PagerankPlan& plan = {});
+
+/// The weakly connected component of each local node, labeled by the
+/// smallest global node in it, computed by label propagation along both
+/// directions of the local edges. Takes a round per hop of the longest
+/// path a label travels.
+KATANA_EXPORT Result<NUMAArray<uint32_t>> DistributedConnectedComponents(
+    DistributedGraph* graph);
+
+}  // namespace katana::analytics
+
+#endif
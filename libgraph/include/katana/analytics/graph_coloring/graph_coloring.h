@@ -0,0 +1,76 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_GRAPHCOLORING_GRAPHCOLORING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_GRAPHCOLORING_GRAPHCOLORING_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for GraphColoring, specifying the algorithm and any
+/// parameters associated with it.
+class GraphColoringPlan : public Plan {
+public:
+  enum Algorithm {
+    kJonesPlassmann,
+    kSpeculative,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  GraphColoringPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  GraphColoringPlan() : GraphColoringPlan{JonesPlassmann()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Color each node once all of its neighbors of higher priority are
+  /// colored, with the smallest color none of them has. Priorities put
+  /// larger degrees first and break ties by the hash of the node that the
+  /// priority algorithms of IndependentSet use, so the coloring does not
+  /// depend on the number of threads or the schedule. From:
+  ///   Mark T. Jones and Paul E. Plassmann. A Parallel Graph Coloring
+  ///   Heuristic. SIAM Journal on Scientific Computing 14(3). 1993.
+  static GraphColoringPlan JonesPlassmann() { return {kCPU, kJonesPlassmann}; }
+
+  /// Color all nodes at once with the smallest color none of their neighbors
+  /// has yet, then recolor the node of lower priority of each edge whose
+  /// nodes got the same color, until there are none. This usually takes few
+  /// rounds but the coloring depends on the schedule. From:
+  ///   Assefaw Hadish Gebremedhin and Fredrik Manne. Scalable Parallel Graph
+  ///   Coloring Algorithms. Concurrency: Practice and Experience 12(12). 2000.
+  static GraphColoringPlan Speculative() { return {kCPU, kSpeculative}; }
+};
+
+/// Color the nodes of the graph so that no edge joins two nodes of the same
+/// color, with few colors (not the fewest), into a new uint32 node property
+/// of colors from 0. Self loops are ignored. The graph must be symmetric.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> GraphColoring(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, GraphColoringPlan plan = {});
+
+KATANA_EXPORT Result<void> GraphColoringAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT GraphColoringStatistics {
+  /// The number of colors used.
+  uint32_t num_colors;
+  /// The number of nodes of the most common color.
+  uint32_t largest_color_size;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<GraphColoringStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_GRAPHPARTITIONING_GRAPHPARTITIONING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_GRAPHPARTITIONING_GRAPHPARTITIONING_H_
+
+#include <iostream>
+#include <vector>
+
+#include <katana/analytics/Plan.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for partitioning a graph into k parts, specifying the
+/// algorithm and any parameters associated with it.
+class GraphPartitioningPlan : public Plan {
+public:
+  /// Algorithm selectors for graph partitioning
+  enum Algorithm { kMultilevel };
+
+  /// What is assigned to parts
+  enum CutKind {
+    /// Assign nodes to parts and cut the edges between parts
+    kEdgeCut,
+    /// Assign edges to parts and replicate the nodes of edges in several
+    /// parts
+    kVertexCut,
+  };
+
+  static const double kDefaultImbalance;
+  static const uint32_t kDefaultRefineIterations;
+  static const uint64_t kDefaultSeed;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  CutKind cut_kind_;
+  double imbalance_;
+  uint32_t refine_iterations_;
+  bool balance_edges_;
+  uint64_t seed_;
+
+  GraphPartitioningPlan(
+      Architecture architecture, Algorithm algorithm, CutKind cut_kind,
+      double imbalance, uint32_t refine_iterations, bool balance_edges,
+      uint64_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        cut_kind_(cut_kind),
+        imbalance_(imbalance),
+        refine_iterations_(refine_iterations),
+        balance_edges_(balance_edges),
+        seed_(seed) {}
+
+public:
+  GraphPartitioningPlan() : GraphPartitioningPlan(Multilevel()) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  CutKind cut_kind() const { return cut_kind_; }
+  /// The largest part may weigh this many times the average part
+  double imbalance() const { return imbalance_; }
+  /// The most refinement passes at each level
+  uint32_t refine_iterations() const { return refine_iterations_; }
+  /// Weigh each node by one plus its out degree instead of one, so that parts
+  /// get about the same number of nodes plus edges
+  bool balance_edges() const { return balance_edges_; }
+  uint64_t seed() const { return seed_; }
+
+  /// Multilevel k-way partitioning in the style of METIS, and of the gmetis
+  /// and bipart applications:
+  ///   George Karypis and Vipin Kumar. Multilevel k-way Partitioning Scheme
+  ///   for Irregular Graphs. JPDC 1998.
+  ///
+  /// The graph, taken as undirected, is coarsened by heavy edge matching
+  /// until it has a few nodes per part. The coarsest graph is split by
+  /// greedy graph growing and the parts are projected back one level at a
+  /// time, refining each level with boundary moves that cut fewer edges
+  /// while keeping parts under the balance bound.
+  ///
+  /// For a vertex cut, each edge then goes to the part of its source and
+  /// destination if they agree, and otherwise to the one of their two parts
+  /// holding fewer edges, so that only nodes on cut edges are replicated.
+  static GraphPartitioningPlan Multilevel(
+      CutKind cut_kind = kEdgeCut, double imbalance = kDefaultImbalance,
+      uint32_t refine_iterations = kDefaultRefineIterations,
+      bool balance_edges = false, uint64_t seed = kDefaultSeed) {
+    return GraphPartitioningPlan(
+        kCPU, kMultilevel, cut_kind, imbalance, refine_iterations,
+        balance_edges, seed);
+  }
+};
+
+/// Partition pg into num_parts parts as described by plan.
+/// With an edge cut the uint32 node property named output_property_name
+/// holds the part of each node; with a vertex cut the uint32 edge property
+/// of that name holds the part of each edge. The property is created by this
+/// function and may not exist before the call.
+///
+/// Part ids are a partition id property in the sense of RDGSlice: a graph
+/// stored with its nodes sorted by part can be loaded one part per host with
+/// RDGSlice::ComputeSliceArgs and the node boundaries computed from
+/// GraphPartitioningStatistics::part_nodes.
+KATANA_EXPORT Result<void> GraphPartitioning(
+    PropertyGraph* pg, uint32_t num_parts,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    GraphPartitioningPlan plan = GraphPartitioningPlan());
+
+/// Check that every id in the property is a part below num_parts and that,
+/// for an edge cut, no part is empty when there are at least num_parts nodes
+KATANA_EXPORT Result<void> GraphPartitioningAssertValid(
+    PropertyGraph* pg, uint32_t num_parts, const std::string& property_name,
+    GraphPartitioningPlan plan = GraphPartitioningPlan());
+
+struct KATANA_EXPORT GraphPartitioningStatistics {
+  /// The nodes that belong to each part; with a vertex cut, the nodes with
+  /// an edge in the part, so nodes are counted once per replica
+  std::vector<uint64_t> part_nodes;
+  /// The edges that belong to each part; with an edge cut, the out edges of
+  /// the nodes of the part
+  std::vector<uint64_t> part_edges;
+  /// The edges whose endpoints are in different parts; zero with a vertex
+  /// cut
+  uint64_t cut_edges;
+  /// The largest part over the average part, by nodes and by edges
+  double node_imbalance;
+  double edge_imbalance;
+  /// The average number of parts that hold each node: its own part and the
+  /// parts of its edges
+  double replication_factor;
+
+  /// For an edge cut, the node boundaries of the parts in a graph stored
+  /// with its nodes sorted by part: the prefix sums of part_nodes
+  std::vector<uint64_t> NodeBoundaries() const;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<GraphPartitioningStatistics> Compute(
+      PropertyGraph* pg, uint32_t num_parts, const std::string& property_name,
+      GraphPartitioningPlan plan = GraphPartitioningPlan());
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_GROUPBY_GROUPBY_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_GROUPBY_GROUPBY_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for grouping the nodes of a graph by a key property,
+/// e.g., the community of Louvain clustering or the label of CDLP, and
+/// aggregating the nodes of each group.
+class GroupByPlan : public Plan {
+public:
+  enum Algorithm {
+    kHash,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  GroupByPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  GroupByPlan() : GroupByPlan{Hash()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Each thread aggregates the nodes it visits in a hash table of its own,
+  /// and the tables are merged at the end. Fast when there are far fewer
+  /// groups than nodes.
+  static GroupByPlan Hash() { return {kCPU, kHash}; }
+};
+
+/// An aggregate of a node property over the nodes of each group. Null values
+/// are skipped.
+struct GroupByAggregate {
+  enum Function {
+    /// The number of values of the property that are not null
+    kCount,
+    kSum,
+    kMin,
+    kMax,
+    kMean,
+  };
+
+  Function function;
+  /// A numeric node property
+  std::string property_name;
+};
+
+/// Group the nodes of pg by the value of an integer node property and
+/// aggregate each group. Nodes whose key is null are in no group.
+///
+/// The result has a row for each group, in order of key, with the columns:
+///   - the key, named key_property_name, of the type of the key property
+///   - "count", the number of nodes in the group
+///   - for each aggregate, "<function>_<property_name>" (e.g., "sum_age"): a
+///     uint64 for kCount and a double for the others, null if no value of
+///     the group is valid
+///   - with cut_metrics, the metrics of the group as a cut of the graph,
+///     along out-edges: "internal_edges", the edges between nodes of the
+///     group; "cut_edges", the edges that leave it; "volume", the sum of the
+///     out-degrees of its nodes; and "conductance", cut_edges divided by the
+///     smaller of the volume of the group and the volume of the other
+///     groups, null if that is 0. For the usual conductance, pass a
+///     symmetric graph.
+///
+/// @param pg The graph to process.
+/// @param key_property_name The node property to group by
+/// @param aggregates The aggregates computed for each group
+/// @param cut_metrics Also compute edge based metrics of each group
+/// @param plan
+KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> GroupBy(
+    katana::PropertyGraph* pg, const std::string& key_property_name,
+    const std::vector<GroupByAggregate>& aggregates, bool cut_metrics = false,
+    GroupByPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
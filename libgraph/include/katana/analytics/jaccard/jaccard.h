@@ -2,6 +2,7 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_JACCARD_JACCARD_H_
 
 #include <iostream>
+#include <memory>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
@@ -65,6 +66,85 @@ KATANA_EXPORT Result<void> Jaccard(
 KATANA_EXPORT Result<void> JaccardAssertValid(
     PropertyGraph* pg, uint32_t compare_node, const std::string& property_name);
 
+/// A computational plan for JaccardSimilarityJoin, specifying the similarity
+/// threshold and how many of the most similar nodes to keep per node.
+class JaccardSimilarityJoinPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Probe an index of the rarest neighbors of each node (its prefix) for
+    /// candidates and verify them with sorted intersections.
+    kPrefixFilter,
+  };
+
+  static constexpr double kDefaultThreshold = 0.5;
+  static constexpr uint32_t kDefaultTopK = 0;
+
+private:
+  Algorithm algorithm_;
+  double threshold_;
+  uint32_t top_k_;
+
+  JaccardSimilarityJoinPlan(
+      Architecture architecture, Algorithm algorithm, double threshold,
+      uint32_t top_k)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        threshold_(threshold),
+        top_k_(top_k) {}
+
+public:
+  JaccardSimilarityJoinPlan()
+      : JaccardSimilarityJoinPlan(
+            kCPU, kPrefixFilter, kDefaultThreshold, kDefaultTopK) {}
+
+  JaccardSimilarityJoinPlan& operator=(const JaccardSimilarityJoinPlan&) =
+      default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Pairs with a similarity below threshold are pruned.
+  double threshold() const { return threshold_; }
+  /// The number of most similar nodes to keep per node; 0 keeps all pairs.
+  uint32_t top_k() const { return top_k_; }
+
+  /// Find every pair of nodes with a similarity of at least threshold.
+  /// Higher thresholds prune more candidates.
+  static JaccardSimilarityJoinPlan PrefixFilter(
+      double threshold = kDefaultThreshold) {
+    return {kCPU, kPrefixFilter, threshold, kDefaultTopK};
+  }
+
+  /// Find the top_k most similar nodes of each node among those with a
+  /// similarity of at least threshold. A threshold of 0 considers every pair
+  /// of nodes with a common neighbor, which is expensive on large graphs.
+  static JaccardSimilarityJoinPlan TopK(
+      uint32_t top_k, double threshold = kDefaultThreshold) {
+    return {kCPU, kPrefixFilter, threshold, top_k};
+  }
+};
+
+/// Compute the Jaccard similarity of the out-neighbor sets of all pairs of
+/// nodes whose similarity is at least the threshold of the plan, e.g., for
+/// entity resolution. Duplicate edges are ignored and pairs without a common
+/// neighbor are never reported.
+///
+/// The result is an edge list table with the columns "source" and
+/// "destination" (uint32) and "similarity" (double). Without a top_k, each
+/// pair appears once with source < destination. With a top_k, each node has
+/// a row for each of its top_k most similar other nodes, as source, in
+/// decreasing similarity; ties go to the smaller node.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> JaccardSimilarityJoin(
+    PropertyGraph* pg, JaccardSimilarityJoinPlan plan = {});
+
+/// Check the result of JaccardSimilarityJoin with plan against the pairs
+/// found by comparing each node with every node that shares a neighbor with
+/// it: the rows must be exactly those JaccardSimilarityJoin is documented to
+/// return, in the same order and with the same similarities.
+/// @return a failure if the result does not pass validation or if there is
+///     a failure during checking.
+KATANA_EXPORT Result<void> JaccardSimilarityJoinAssertValid(
+    PropertyGraph* pg, const std::shared_ptr<arrow::Table>& result,
+    JaccardSimilarityJoinPlan plan = {});
+
 struct KATANA_EXPORT JaccardStatistics {
   /// The maximum similarity excluding the comparison node.
   double max_similarity;
@@ -17,7 +17,7 @@ namespace katana::analytics {
 class KCorePlan : public Plan {
 public:
   /// Algorithm selectors for KCore
-  enum Algorithm { kSynchronous, kAsynchronous };
+  enum Algorithm { kSynchronous, kAsynchronous, kBucketDecomposition };
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -40,6 +40,18 @@ public:
 
   /// Asynchronous k-core algorithm.
   static KCorePlan Asynchronous() { return {kCPU, kAsynchronous}; }
+
+  /// Compute the core number of every node in one pass by peeling nodes a
+  /// level at a time from parallel buckets of nodes by degree, following:
+  ///   Laxman Dhulipala, Guy E. Blelloch, and Julian Shun. Julienne: A
+  ///   Framework for Parallel Graph Algorithms using Work-efficient
+  ///   Bucketing. SPAA 2017.
+  ///
+  /// This is the only algorithm of KCoreDecomposition. With KCore, the
+  /// k-core is the nodes of core number at least k.
+  static KCorePlan BucketDecomposition() {
+    return {kCPU, kBucketDecomposition};
+  }
 };
 
 /// Compute the k-core for pg. The pg must be symmetric.
@@ -52,6 +64,17 @@ KATANA_EXPORT Result<void> KCore(
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     const bool& is_symmetric = false, KCorePlan plan = KCorePlan());
 
+/// Compute the core number of each node of pg, the largest k such that the
+/// node is in the k-core. The pg must be symmetric.
+/// The uint32 property named output_property_name is created by this
+/// function and may not exist before the call.
+///
+/// @param plan Must be a kBucketDecomposition plan
+KATANA_EXPORT Result<void> KCoreDecomposition(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric = false,
+    KCorePlan plan = KCorePlan::BucketDecomposition());
+
 KATANA_EXPORT Result<void> KCoreAssertValid(
     PropertyGraph* pg, uint32_t k_core_number,
     const std::string& property_name);
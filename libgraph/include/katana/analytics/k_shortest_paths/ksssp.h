@@ -2,6 +2,7 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_KSHORTESTPATHS_KSSSP_H_
 
 #include "katana/AtomicHelpers.h"
+#include "katana/analytics/GraphStatistics.h"
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
 
@@ -48,12 +49,15 @@ private:
 public:
   KssspPlan() : KssspPlan{kCPU, kDeltaTile, kDefaultReach, 0, 0} {}
 
+  /// Choose an algorithm from the statistics of pg, as SsspPlan does
   KssspPlan(const katana::PropertyGraph* pg) : Plan(kCPU) {
-    bool isPowerLaw = IsApproximateDegreeDistributionPowerLaw(*pg);
-    if (isPowerLaw) {
-      *this = DeltaStep();
-    } else {
+    GraphStatistics stats = GetGraphStatistics(*pg);
+    if (!stats.power_law) {
       *this = DeltaStepBarrier();
+    } else if (stats.NeedsEdgeTiles(kDefaultEdgeTileSize)) {
+      *this = DeltaTile();
+    } else {
+      *this = DeltaStep();
     }
   }
 
@@ -0,0 +1,73 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_KSHORTESTSIMPLEPATHS_KSHORTESTSIMPLEPATHS_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_KSHORTESTSIMPLEPATHS_KSHORTESTSIMPLEPATHS_H_
+
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for KShortestSimplePaths, specifying the algorithm
+/// and any parameters associated with it.
+class KShortestSimplePathsPlan : public Plan {
+public:
+  enum Algorithm {
+    kYen,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  KShortestSimplePathsPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  KShortestSimplePathsPlan() : KShortestSimplePathsPlan{Yen()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Find each path after the first from the paths found before it: for
+  /// each node of the last path found, a shortest path from that node (the
+  /// spur) to the target that avoids the nodes before it on the last path
+  /// and the edges from it taken by the paths found so far that share
+  /// those nodes, joined to them, is a candidate, and the shortest
+  /// candidate is the next path. The spur searches of a path are
+  /// bidirectional Dijkstra searches run in parallel, and only start from
+  /// the node where the path leaves the path it was found from, as the
+  /// earlier spurs give the candidates of that path. From:
+  ///   Jin Y. Yen. Finding the K Shortest Loopless Paths in a Network.
+  ///   Management Science 17(11). 1971.
+  ///   Eugene L. Lawler. A Procedure for Computing the K Best Solutions to
+  ///   Discrete Optimization Problems and Its Application to the Shortest
+  ///   Path Problem. Management Science 18(7). 1972.
+  static KShortestSimplePathsPlan Yen() { return {kCPU, kYen}; }
+};
+
+/// Find the num_paths shortest paths from source to target that visit no
+/// node twice, shortest first and ties broken by the sequence of nodes.
+/// Paths are sequences of nodes; of parallel edges, a path takes the
+/// lightest.
+///
+/// @param pg The graph
+/// @param source The first node of each path
+/// @param target The last node of each path
+/// @param num_paths The number of paths to find; fewer are found if there
+///     are fewer simple paths
+/// @param edge_weight_property_name The non-negative edge weights, which may
+///     be of any numeric type, or all 1 if empty; edges whose weight is null
+///     are left out of every path
+/// @param plan
+/// @return A table of one row per path, in order, with the columns
+///     "length" (double) and "nodes" (list of uint32)
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> KShortestSimplePaths(
+    PropertyGraph* pg, uint32_t source, uint32_t target, uint32_t num_paths,
+    const std::string& edge_weight_property_name,
+    KShortestSimplePathsPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -16,7 +16,7 @@ namespace katana::analytics {
 class KTrussPlan : public Plan {
 public:
   /// Algorithm selectors for KCore
-  enum Algorithm { kBsp, kBspJacobi, kBspCoreThenTruss };
+  enum Algorithm { kBsp, kBspJacobi, kBspCoreThenTruss, kBucketDecomposition };
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -39,6 +39,21 @@ public:
 
   /// Compute k-1 core and then k-truss algorithm.
   static KTrussPlan BspCoreThenTruss() { return {kCPU, kBspCoreThenTruss}; }
+
+  /// Truss decomposition: peel the edges in parallel rounds in the order of
+  /// their support, the number of triangles they are in, taken from buckets
+  /// of edges by support. The support of every edge is counted once and
+  /// then only decremented, so one pass finds the trussness of all edges,
+  /// i.e., the k-truss for every k. See
+  ///
+  ///   S. Kabir and K. Madduri. Shared-memory Graph Truss Decomposition.
+  ///   HiPC 2017.
+  ///
+  /// This is the only algorithm of KTrussDecomposition. With KTruss, the
+  /// k-truss is the edges of trussness at least k.
+  static KTrussPlan BucketDecomposition() {
+    return {kCPU, kBucketDecomposition};
+  }
 };
 
 /// Compute the k-truss for pg. The pg is expected to be
@@ -53,6 +68,18 @@ KATANA_EXPORT Result<void> KTruss(
     katana::TxnContext* txn_ctx, PropertyGraph* pg, uint32_t k_truss_number,
     const std::string& output_property_name, KTrussPlan plan = KTrussPlan());
 
+/// Compute the trussness of every edge of pg, the largest k such that the
+/// edge is in the k-truss; edges in no triangle, such as self loops, have
+/// trussness 2, and parallel edges count as one. The pg must be symmetric.
+/// The uint32 edge property named output_property_name is created by this
+/// function and may not exist before the call.
+///
+/// @param plan Must be a kBucketDecomposition plan
+KATANA_EXPORT Result<void> KTrussDecomposition(
+    katana::TxnContext* txn_ctx, PropertyGraph* pg,
+    const std::string& output_property_name,
+    KTrussPlan plan = KTrussPlan::BucketDecomposition());
+
 KATANA_EXPORT Result<void> KTrussAssertValid(
     PropertyGraph* pg, uint32_t k_truss_number,
     const std::string& property_name);
@@ -85,7 +85,8 @@ public:
   /// Resolution for calculating the modularity
   double resolution() const { return resolution_; }
 
-  /// Randomness for picking subcommunities
+  /// Randomness for picking subcommunities: during refinement a node joins
+  /// one with probability proportional to exp(gain / randomness)
   double randomness() const { return randomness_; }
 
   /// Nondeterministic algorithm for louvain clustering
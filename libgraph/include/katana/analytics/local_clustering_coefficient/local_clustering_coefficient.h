@@ -14,7 +14,11 @@ namespace katana::analytics {
 /// Clustering Coefficient of the nodes in the graph.
 class LocalClusteringCoefficientPlan : public Plan {
 public:
-  enum Algorithm { kOrderedCountAtomics, kOrderedCountPerThread };
+  enum Algorithm {
+    kOrderedCountAtomics,
+    kOrderedCountPerThread,
+    kWedgeSampling,
+  };
 
   enum Relabeling {
     kRelabel,
@@ -24,19 +28,26 @@ public:
 
   static const Relabeling kDefaultRelabeling = kAutoRelabel;
   static const bool kDefaultEdgesSorted = false;
+  static constexpr uint32_t kDefaultNumSamples = 1024;
+  static constexpr uint64_t kDefaultSeed = 0;
 
 private:
   Algorithm algorithm_;
   bool edges_sorted_;
   Relabeling relabeling_;
+  uint32_t num_samples_;
+  uint64_t seed_;
 
   LocalClusteringCoefficientPlan(
       Architecture architecture, Algorithm algorithm, bool edges_sorted,
-      Relabeling relabeling)
+      Relabeling relabeling, uint32_t num_samples = kDefaultNumSamples,
+      uint64_t seed = kDefaultSeed)
       : Plan(architecture),
         algorithm_(algorithm),
         edges_sorted_(edges_sorted),
-        relabeling_(relabeling) {}
+        relabeling_(relabeling),
+        num_samples_(num_samples),
+        seed_(seed) {}
 
 public:
   LocalClusteringCoefficientPlan()
@@ -48,6 +59,10 @@ public:
   // TODO(amp): These parameters should be documented.
   bool edges_sorted() const { return edges_sorted_; }
   Relabeling relabeling() const { return relabeling_; }
+  /// The number of wedges sampled per node by kWedgeSampling
+  uint32_t num_samples() const { return num_samples_; }
+  /// The seed of the samples of kWedgeSampling
+  uint64_t seed() const { return seed_; }
 
   /**
    * An ordered count algorithm that sorts the nodes by degree before
@@ -69,6 +84,28 @@ public:
       Relabeling relabeling = kDefaultRelabeling) {
     return {kCPU, kOrderedCountPerThread, edges_sorted, relabeling};
   }
+
+  /**
+   * Estimate the coefficient of each node as the fraction of num_samples
+   * uniformly sampled wedges (pairs of neighbors) centered at the node that
+   * are closed by an edge, which has a standard error of at most
+   * 0.5 / sqrt(num_samples). Nodes with at most num_samples wedges are
+   * computed exactly. The graph must not have self loops or parallel edges.
+   * From the following:
+   *   C. Seshadhri, Ali Pinar, and Tamara G. Kolda. Wedge Sampling for
+   *   Computing Clustering Coefficients and Triangle Counts on Large Graphs.
+   *   Statistical Analysis and Data Mining 7(4). 2014.
+   *
+   * @param num_samples The number of wedges to sample at each node.
+   * @param seed The seed of the samples.
+   */
+  static LocalClusteringCoefficientPlan WedgeSampling(
+      uint32_t num_samples = kDefaultNumSamples,
+      uint64_t seed = kDefaultSeed) {
+    return LocalClusteringCoefficientPlan(
+        kCPU, kWedgeSampling, kDefaultEdgesSorted, kDefaultRelabeling,
+        num_samples, seed);
+  }
 };
 
 /**
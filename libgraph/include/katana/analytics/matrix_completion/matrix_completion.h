@@ -16,6 +16,8 @@ class MatrixCompletionPlan : public Plan {
 public:
   enum Algorithm {
     kSGDByItems,
+    kSGDTiled,
+    kALS,
   };
 
   enum Step { kBold, kBottou, kIntel, kInverse, kPurdue };
@@ -122,12 +124,70 @@ public:
         use_det_init,
         learning_rate_function};
   }
+
+  /// Stratified SGD on a grid of tiles of item blocks by user blocks, one
+  /// block per thread. The tiles of a stratum share no items or users and
+  /// are updated in parallel without atomics, so each thread keeps its
+  /// latent vectors in cache. Users must have higher node IDs than all
+  /// items.
+  static MatrixCompletionPlan SGDTiled(
+      double learning_rate = kDefaultLearningRate,
+      double decay_rate = kDefaultDecayRate, double lambda = kDefaultLambda,
+      double tolerance = kDefaultTolerance,
+      bool use_same_latent_vector = kDefaultUseSameLatentVector,
+      uint32_t max_updates = kDefaultMaxUpdates,
+      uint32_t fixed_rounds = kDefaultFixedRounds,
+      bool use_det_init = kDefaultUseDetInit,
+      Step learning_rate_function = kDefaultLearningRateFunction) {
+    return {
+        kCPU,
+        kSGDTiled,
+        learning_rate,
+        decay_rate,
+        lambda,
+        tolerance,
+        use_same_latent_vector,
+        max_updates,
+        kDefaultUpdatesPerEdge,
+        fixed_rounds,
+        false,
+        use_det_init,
+        learning_rate_function};
+  }
+
+  /// Alternating least squares with weighted-lambda regularization: each
+  /// round solves for all item vectors with the user vectors fixed, and
+  /// then for all user vectors. Users must have higher node IDs than all
+  /// items.
+  static MatrixCompletionPlan ALS(
+      double lambda = kDefaultLambda, double tolerance = kDefaultTolerance,
+      bool use_same_latent_vector = kDefaultUseSameLatentVector,
+      uint32_t max_updates = kDefaultMaxUpdates,
+      uint32_t fixed_rounds = kDefaultFixedRounds,
+      bool use_det_init = kDefaultUseDetInit) {
+    return {
+        kCPU,
+        kALS,
+        kDefaultLearningRate,
+        kDefaultDecayRate,
+        lambda,
+        tolerance,
+        use_same_latent_vector,
+        max_updates,
+        kDefaultUpdatesPerEdge,
+        fixed_rounds,
+        false,
+        use_det_init,
+        kDefaultLearningRateFunction};
+  }
 };
 
 /// Performs matrix completion using stochastic gradient descent (SGD) algortihm
 /// on a bipartite graph and learns latent vectors for each node that is stored in
 /// an ArrayProperty.
 /// The plan controls the algorithm and parameters used to compute the latent vectors.
+/// The elapsed time and root-mean-square error after each round are reported
+/// as statistics of the algorithm.
 KATANA_EXPORT Result<void> MatrixCompletion(
     katana::PropertyGraph* pg, katana::TxnContext* txn_ctx,
     MatrixCompletionPlan plan = {});
@@ -0,0 +1,111 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+
+#include <iostream>
+
+#include <katana/analytics/Plan.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for maximum flows, specifying the algorithm and any
+/// parameters associated with it.
+class MaxFlowPlan : public Plan {
+public:
+  /// Algorithm selectors for maximum flows
+  enum Algorithm { kPreflowPush };
+
+  /// A global relabel interval of 0 lets the interval follow the size of the
+  /// graph
+  static const uint32_t kDefaultGlobalRelabelInterval;
+  static const bool kDefaultGapHeuristic;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint32_t global_relabel_interval_;
+  bool gap_heuristic_;
+
+  MaxFlowPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t global_relabel_interval, bool gap_heuristic)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        global_relabel_interval_(global_relabel_interval),
+        gap_heuristic_(gap_heuristic) {}
+
+public:
+  MaxFlowPlan() : MaxFlowPlan(PreflowPush()) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The amount of discharge work between two global relabels; each
+  /// discharge counts 1 and each relabel in a discharge counts 12 more
+  uint32_t global_relabel_interval() const { return global_relabel_interval_; }
+  /// Whether heights that empty out lift the nodes above them out of reach
+  /// of the sink
+  bool gap_heuristic() const { return gap_heuristic_; }
+
+  /// Parallel preflow-push (push-relabel) in two phases: the first moves as
+  /// much flow as possible to the sink and the second returns the excess
+  /// left at cut off nodes to the source. Active nodes are discharged in
+  /// parallel without locks after:
+  ///   Bo Hong and Zhengyu He. An Asynchronous Multithreaded Algorithm for
+  ///   the Maximum Network Flow Problem with Nonblocking Global Relabeling
+  ///   Heuristic. IEEE TPDS 22(6), 2011.
+  ///
+  /// Every global_relabel_interval work the heights are reset to exact
+  /// residual distances by a parallel breadth first search from the sink
+  /// over the in-edges of the residual network.
+  static MaxFlowPlan PreflowPush(
+      uint32_t global_relabel_interval = kDefaultGlobalRelabelInterval,
+      bool gap_heuristic = kDefaultGapHeuristic) {
+    return {kCPU, kPreflowPush, global_relabel_interval, gap_heuristic};
+  }
+};
+
+/// Compute a maximum flow from source to sink in pg with the capacities in
+/// the edge property named capacity_property_name, which must be a 32- or
+/// 64-bit signed or unsigned int. Capacities may not be negative and the
+/// capacities of the out-edges of source must sum to less than 2^63. Without
+/// a capacity property every edge has capacity 1.
+///
+/// The uint64 edge property named output_property_name holds the flow on
+/// each edge. It is created by this function and may not exist before the
+/// call.
+KATANA_EXPORT Result<void> MaxFlow(
+    PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MaxFlowPlan plan = {});
+
+/// Check that the flow in output_property_name is within the capacities, is
+/// conserved at every node other than source and sink, and leaves no
+/// augmenting path from source to sink.
+KATANA_EXPORT Result<void> MaxFlowAssertValid(
+    PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_property_name);
+
+struct KATANA_EXPORT MaxFlowStatistics {
+  /// The net flow into the sink
+  uint64_t flow_value;
+  /// The number of edges of positive capacity whose flow equals it
+  uint64_t saturated_edges;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MaxFlowStatistics> Compute(
+      PropertyGraph* pg, uint32_t source, uint32_t sink,
+      const std::string& capacity_property_name,
+      const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+
+#include <iostream>
+
+#include <katana/analytics/Plan.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for minimum spanning forests, specifying the
+/// algorithm and any parameters associated with it.
+class MinimumSpanningForestPlan : public Plan {
+public:
+  /// Algorithm selectors for minimum spanning forests
+  enum Algorithm { kBoruvka, kFilterKruskal };
+
+  static const uint64_t kDefaultBaseCaseEdges;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint64_t base_case_edges_;
+
+  MinimumSpanningForestPlan(
+      Architecture architecture, Algorithm algorithm, uint64_t base_case_edges)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        base_case_edges_(base_case_edges) {}
+
+public:
+  MinimumSpanningForestPlan() : MinimumSpanningForestPlan(Boruvka()) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Filter-Kruskal sorts edge sets of at most this many edges instead of
+  /// partitioning them further
+  uint64_t base_case_edges() const { return base_case_edges_; }
+
+  /// Parallel Boruvka: in each round every component picks its lightest
+  /// edge to another component in parallel and the components are merged
+  /// along those edges, until no edges join two components. Each round at
+  /// least halves the number of components, and edges within a component
+  /// are dropped as rounds go.
+  static MinimumSpanningForestPlan Boruvka() {
+    return {kCPU, kBoruvka, kDefaultBaseCaseEdges};
+  }
+
+  /// Filter-Kruskal, a Kruskal variant that suits graphs with many more
+  /// edges than nodes:
+  ///   Vitaly Osipov, Peter Sanders, and Johannes Singler. The
+  ///   Filter-Kruskal Minimum Spanning Tree Algorithm. ALENEX 2009.
+  ///
+  /// The edges are split in parallel around a pivot weight; the light half
+  /// is solved first and the heavy half is then filtered in parallel of
+  /// edges whose endpoints are already connected before it is solved. Sets
+  /// of at most base_case_edges edges are sorted in parallel and scanned by
+  /// Kruskal's algorithm.
+  static MinimumSpanningForestPlan FilterKruskal(
+      uint64_t base_case_edges = kDefaultBaseCaseEdges) {
+    return {kCPU, kFilterKruskal, base_case_edges};
+  }
+};
+
+/// Compute a minimum spanning forest of pg taken as undirected, with the
+/// weights in the edge property named edge_weight_property_name (an integer
+/// or floating point type). Edges of equal weight are ordered by their ids,
+/// so the forest is unique, and self loops are never in it. Of the two
+/// directions of an undirected edge only one is taken.
+///
+/// The uint8 edge property named output_property_name is 1 for the edges of
+/// the forest and 0 otherwise. It is created by this function and may not
+/// exist before the call.
+KATANA_EXPORT Result<void> MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MinimumSpanningForestPlan plan = {});
+
+/// Check that the forest edges in output_property_name are acyclic, span the
+/// components of pg and weigh as much as a forest found by sequential
+/// Kruskal's algorithm.
+KATANA_EXPORT Result<void> MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name);
+
+struct KATANA_EXPORT MinimumSpanningForestStatistics {
+  /// The number of trees in the forest, counting isolated nodes
+  uint64_t num_trees;
+  /// The number of edges in the forest
+  uint64_t num_edges;
+  /// The sum of the weights of the edges in the forest
+  double total_weight;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MinimumSpanningForestStatistics> Compute(
+      PropertyGraph* pg, const std::string& edge_weight_property_name,
+      const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
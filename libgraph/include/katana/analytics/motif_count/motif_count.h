@@ -0,0 +1,76 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_MOTIFCOUNT_MOTIFCOUNT_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_MOTIFCOUNT_MOTIFCOUNT_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for counting the motifs of a graph.
+class MotifCountPlan : public Plan {
+public:
+  enum Algorithm {
+    kEdgeCentric,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  MotifCountPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  MotifCountPlan() : MotifCountPlan{EdgeCentric()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /**
+   * Count the motifs from the triangles through each edge, found by
+   * intersecting the neighbors of its nodes, and the 4-cycles from the
+   * wedges of each node to smaller ones in the orientation of the graph by
+   * degree; 4-cliques are counted by CliqueCount. Counts of subgraphs are
+   * turned into counts of induced subgraphs as in:
+   *   Mark Ortmann and Ulrik Brandes. Efficient Orbit-Aware Triad and Quad
+   *   Census in Directed and Undirected Graphs. Applied Network Science 2017.
+   */
+  static MotifCountPlan EdgeCentric() { return {kCPU, kEdgeCentric}; }
+};
+
+/// The number of connected induced subgraphs of 3 and 4 nodes of a graph of
+/// each shape
+struct KATANA_EXPORT MotifCounts {
+  uint64_t triangles{};
+  /// Paths of 3 nodes whose ends are not adjacent
+  uint64_t open_wedges{};
+  /// Paths of 4 nodes
+  uint64_t paths{};
+  /// A node and 3 neighbors
+  uint64_t three_stars{};
+  uint64_t four_cycles{};
+  /// A triangle and an edge from one of its nodes
+  uint64_t tailed_triangles{};
+  /// A 4-clique without an edge
+  uint64_t diamonds{};
+  uint64_t four_cliques{};
+
+  /// Print the counts to a stream for human consumption.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/**
+ * Count the connected induced subgraphs of 3 and 4 nodes of the graph, by
+ * shape. The graph must be symmetric, without self loops or parallel edges!
+ *
+ * @param pg The graph to process.
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<MotifCounts> MotifCount(
+    PropertyGraph* pg, MotifCountPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_NEIGHBORSAMPLING_NEIGHBORSAMPLING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_NEIGHBORSAMPLING_NEIGHBORSAMPLING_H_
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for sampling the k-hop neighborhoods of seed nodes,
+/// as mini-batches for training graph neural networks.
+class NeighborSamplingPlan : public Plan {
+public:
+  /// Algorithm selectors for neighbor sampling
+  enum Algorithm {
+    /// Every edge is equally likely to be sampled
+    kUniform,
+    /// Edges are sampled in proportion to an edge weight property
+    kWeighted,
+  };
+
+  /// The edges of a node its neighbors are sampled along
+  enum EdgeDirection {
+    /// Sample the sources of the in-edges of a node, the nodes that send it
+    /// messages in a graph neural network
+    kInEdges,
+    /// Sample the destinations of the out-edges of a node
+    kOutEdges,
+  };
+
+  static const uint64_t kDefaultSeed = 0;
+
+private:
+  Algorithm algorithm_;
+  EdgeDirection edge_direction_;
+  std::string edge_weight_property_name_;
+  uint64_t seed_;
+
+  NeighborSamplingPlan(
+      Architecture architecture, Algorithm algorithm,
+      EdgeDirection edge_direction, std::string edge_weight_property_name,
+      uint64_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        edge_direction_(edge_direction),
+        edge_weight_property_name_(std::move(edge_weight_property_name)),
+        seed_(seed) {}
+
+public:
+  NeighborSamplingPlan() : NeighborSamplingPlan{Uniform()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  EdgeDirection edge_direction() const { return edge_direction_; }
+
+  /// The numeric edge property that weighs the edges for kWeighted. Edges
+  /// whose weight is null or not positive are never sampled.
+  const std::string& edge_weight_property_name() const {
+    return edge_weight_property_name_;
+  }
+
+  /// Seed of the random numbers. Each node draws its numbers in each hop
+  /// from its own stream, so the sample depends only on the seed and not on
+  /// the number of threads.
+  uint64_t seed() const { return seed_; }
+
+  /// Sample neighbors uniformly, without replacement
+  static NeighborSamplingPlan Uniform(
+      EdgeDirection edge_direction = kInEdges, uint64_t seed = kDefaultSeed) {
+    return {kCPU, kUniform, edge_direction, "", seed};
+  }
+
+  /// Sample neighbors without replacement, each next one with probability
+  /// proportional to the weight of its edge (Efraimidis and Spirakis, 2006)
+  static NeighborSamplingPlan Weighted(
+      const std::string& edge_weight_property_name,
+      EdgeDirection edge_direction = kInEdges, uint64_t seed = kDefaultSeed) {
+    return {
+        kCPU, kWeighted, edge_direction, edge_weight_property_name, seed};
+  }
+};
+
+/// The number of neighbors sampled for each node in one hop
+struct NeighborSamplingFanout {
+  /// Sample all neighbors
+  static const uint32_t kAll = std::numeric_limits<uint32_t>::max();
+
+  /// The number of neighbors sampled among all edges of a node, unused if
+  /// edge_type_fanouts is not empty
+  uint32_t fanout{kAll};
+
+  /// The number of neighbors sampled separately among the edges of each of
+  /// these types, by atomic edge type name; other edges are ignored
+  std::vector<std::pair<std::string, uint32_t>> edge_type_fanouts;
+};
+
+/// The edges sampled in one hop, as a CSR matrix from the nodes sampled up
+/// to that hop to the nodes sampled up to the next one. Nodes are given by
+/// their index into NeighborSample::nodes.
+struct NeighborSampleBlock {
+  /// The destinations of the block are nodes [0, num_dst) of the sample
+  uint64_t num_dst{};
+  /// The sources of the block are nodes [0, num_src) of the sample,
+  /// which begin with its destinations
+  uint64_t num_src{};
+  /// The edges of destination i are [indptr[i], indptr[i + 1])
+  std::shared_ptr<arrow::UInt64Array> indptr;
+  /// The source of each edge
+  std::shared_ptr<arrow::UInt32Array> indices;
+  /// The property index in the graph of each edge
+  std::shared_ptr<arrow::UInt64Array> edge_ids;
+};
+
+/// A mini-batch sampled from the neighborhoods of some seed nodes
+struct NeighborSample {
+  /// The nodes of the sample: the seeds, in order, followed by the nodes
+  /// first reached in each hop, in order of node ID
+  std::shared_ptr<arrow::UInt32Array> nodes;
+  /// blocks[h] holds the edges sampled in hop h; hop 0 samples the
+  /// neighbors of the seeds. A graph neural network consumes them from the
+  /// last to the first.
+  std::vector<NeighborSampleBlock> blocks;
+  /// Row i holds the requested node properties of nodes[i]
+  std::shared_ptr<arrow::Table> node_features;
+};
+
+/// Sample the k-hop neighborhoods of the seeds, one hop for each entry of
+/// fanouts. Hop h samples the neighbors of every node sampled before it,
+/// so each hop of the sample is a block for one layer of a graph neural
+/// network. Nodes are sampled in parallel.
+///
+/// @param pg The graph to sample
+/// @param seeds The distinct nodes to sample the neighborhoods of
+/// @param fanouts The number of neighbors sampled in each hop
+/// @param node_feature_properties Node properties gathered into the
+///     features of the sample
+/// @param plan
+KATANA_EXPORT katana::Result<NeighborSample> NeighborSampling(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& seeds,
+    const std::vector<NeighborSamplingFanout>& fanouts,
+    const std::vector<std::string>& node_feature_properties,
+    NeighborSamplingPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_NODEEMBEDDING_NODEEMBEDDING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_NODEEMBEDDING_NODEEMBEDDING_H_
+
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/random_walks/random_walks.h"
+
+namespace katana::analytics {
+
+/// A computational plan for NodeEmbedding, specifying the algorithm and any
+/// parameters associated with it.
+class NodeEmbeddingPlan : public Plan {
+public:
+  enum Algorithm {
+    kSkipGram,
+  };
+
+  static const uint32_t kDefaultDimensions = 128;
+  static const uint32_t kDefaultWindowSize = 5;
+  static const uint32_t kDefaultNegativeSamples = 5;
+  static const uint32_t kDefaultEpochs = 1;
+  static constexpr double kDefaultLearningRate = 0.025;
+  static const uint64_t kDefaultSeed = 0;
+  static const uint64_t kDefaultWalksPerBatch = uint64_t{1} << 20;
+
+private:
+  Algorithm algorithm_;
+  uint32_t dimensions_;
+  uint32_t window_size_;
+  uint32_t negative_samples_;
+  uint32_t epochs_;
+  double learning_rate_;
+  uint64_t seed_;
+  uint64_t walks_per_batch_;
+
+  NodeEmbeddingPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t dimensions,
+      uint32_t window_size, uint32_t negative_samples, uint32_t epochs,
+      double learning_rate, uint64_t seed, uint64_t walks_per_batch)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        dimensions_(dimensions),
+        window_size_(window_size),
+        negative_samples_(negative_samples),
+        epochs_(epochs),
+        learning_rate_(learning_rate),
+        seed_(seed),
+        walks_per_batch_(walks_per_batch) {}
+
+public:
+  NodeEmbeddingPlan() : NodeEmbeddingPlan{SkipGram()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The number of elements of each embedding
+  uint32_t dimensions() const { return dimensions_; }
+
+  /// The most nodes on each side of a node in a walk that are its context.
+  /// Each occurrence of a node draws a window of up to this size, so nearer
+  /// nodes are its context more often.
+  uint32_t window_size() const { return window_size_; }
+
+  /// The number of noise nodes drawn against each (node, context) pair
+  uint32_t negative_samples() const { return negative_samples_; }
+
+  /// The number of passes over the walks
+  uint32_t epochs() const { return epochs_; }
+
+  /// The starting learning rate, which decays linearly to nearly 0 over the
+  /// epochs
+  double learning_rate() const { return learning_rate_; }
+
+  /// Seed of the initial embeddings and of the windows and noise nodes of
+  /// each walk
+  uint64_t seed() const { return seed_; }
+
+  /// The number of walks NodeEmbedding generates at a time, which bounds the
+  /// memory the walks take
+  uint64_t walks_per_batch() const { return walks_per_batch_; }
+
+  /// Skip-gram with negative sampling (Mikolov et al., "Distributed
+  /// Representations of Words and Phrases and their Compositionality",
+  /// 2013) over the walks as sentences. Threads take walks and update the
+  /// shared embeddings without locks (Hogwild, Niu et al., 2011): the
+  /// updates of a walk touch few of the nodes, so they rarely collide.
+  static NodeEmbeddingPlan SkipGram(
+      uint32_t dimensions = kDefaultDimensions,
+      uint32_t window_size = kDefaultWindowSize,
+      uint32_t negative_samples = kDefaultNegativeSamples,
+      uint32_t epochs = kDefaultEpochs,
+      double learning_rate = kDefaultLearningRate, uint64_t seed = kDefaultSeed,
+      uint64_t walks_per_batch = kDefaultWalksPerBatch) {
+    return {
+        kCPU,
+        kSkipGram,
+        dimensions,
+        window_size,
+        negative_samples,
+        epochs,
+        learning_rate,
+        seed,
+        walks_per_batch};
+  }
+};
+
+/// Embed the nodes of pg by training on node2vec walks as they are
+/// generated, without the walks leaving memory. Each batch of walks of
+/// RandomWalksStream is trained on and dropped, and the walks are generated
+/// again for each epoch. The noise nodes are drawn in proportion to the
+/// degree of each node, raised to the power 0.75, since a walk on a
+/// symmetric graph visits each node about as often as its degree.
+///
+/// @param pg The graph to embed
+/// @param output_property_name The node property to create, a
+///     fixed_size_list<float> of plan.dimensions() elements
+/// @param txn_ctx The transaction of the new property
+/// @param edge_weight_property_name See RandomWalksTable
+/// @param walks_plan The walks to train on, which must be a kNode2Vec plan
+/// @param plan The training to use
+KATANA_EXPORT Result<void> NodeEmbedding(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx,
+    const std::string& edge_weight_property_name = "",
+    RandomWalksPlan walks_plan = RandomWalksPlan(),
+    NodeEmbeddingPlan plan = {});
+
+/// Embed the nodes of pg by training on walks already in memory, such as
+/// the table of RandomWalksTable. The noise nodes are drawn in proportion
+/// to the number of times each node is in the walks, raised to the power
+/// 0.75.
+///
+/// @param walks A table with a column "walk" of list<uint32> or
+///     large_list<uint32> walks of the nodes of pg. Null walks are skipped.
+/// @see NodeEmbedding for the other parameters
+KATANA_EXPORT Result<void> NodeEmbeddingFromWalks(
+    PropertyGraph* pg, const std::shared_ptr<arrow::Table>& walks,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    NodeEmbeddingPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_OUTOFCORE_OUTOFCORE_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_OUTOFCORE_OUTOFCORE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "katana/NUMAArray.h"
+#include "katana/RDG.h"
+#include "katana/RDGTopology.h"
+#include "katana/Result.h"
+#include "katana/TxnContext.h"
+#include "katana/URI.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/config.h"
+#include "katana/tsuba.h"
+
+namespace katana::analytics {
+
+struct OutOfCoreOptions {
+  /// Memory for topology partitions. Two partitions are resident at a time,
+  /// the one being processed and the one being read, so each holds about half
+  /// of this. Storage is read in whole pages of the topology file, so small
+  /// budgets are rounded up to a couple of pages.
+  uint64_t memory_budget_bytes{UINT64_C(1) << 30};
+};
+
+/// The nodes [begin, end) of a topology and their out edges, resident in
+/// memory while an OutOfCoreTopology visits it
+class KATANA_EXPORT OutOfCorePartition {
+public:
+  OutOfCorePartition(
+      uint64_t begin, uint64_t end, uint64_t first_edge,
+      const uint64_t* adj_indices, const uint32_t* dests)
+      : begin_(begin),
+        end_(end),
+        first_edge_(first_edge),
+        adj_indices_(adj_indices),
+        dests_(dests) {}
+
+  uint64_t begin() const { return begin_; }
+  uint64_t end() const { return end_; }
+
+  /// The first out edge of node, which must be in the partition
+  uint64_t EdgesBegin(uint64_t node) const {
+    return node == begin_ ? first_edge_ : adj_indices_[node - 1];
+  }
+  uint64_t EdgesEnd(uint64_t node) const { return adj_indices_[node]; }
+  uint64_t OutDegree(uint64_t node) const {
+    return EdgesEnd(node) - EdgesBegin(node);
+  }
+  uint32_t OutEdgeDst(uint64_t edge) const { return dests_[edge]; }
+
+private:
+  uint64_t begin_;
+  uint64_t end_;
+  /// Where the edges of begin start; the adj_indices entry before begin may
+  /// have been released with the previous partition
+  uint64_t first_edge_;
+  const uint64_t* adj_indices_;
+  const uint32_t* dests_;
+};
+
+/// The CSR topology of an RDG on storage, read one partition of nodes at a
+/// time so that graphs larger than memory can be analyzed. Only per node
+/// state has to fit in memory.
+///
+/// The topology is split into contiguous ranges of nodes that, together with
+/// their edges, fit in half of the memory budget. ForEachPartition reads the
+/// next partition in the background while the current one is processed and
+/// gives back the memory of each partition when it is done.
+///
+/// Requires an uncompressed, non-transposed CSR topology on storage; see
+/// RDGTopology::BindSections.
+class KATANA_EXPORT OutOfCoreTopology {
+public:
+  static Result<std::unique_ptr<OutOfCoreTopology>> Make(
+      const URI& rdg_dir, TxnContext* txn_ctx,
+      const OutOfCoreOptions& options = {});
+
+  uint64_t NumNodes() const { return num_nodes_; }
+  uint64_t NumEdges() const { return num_edges_; }
+
+  /// The first node of each partition followed by NumNodes()
+  const std::vector<uint64_t>& partition_bounds() const {
+    return partition_bounds_;
+  }
+  uint32_t NumPartitions() const { return partition_bounds_.size() - 1; }
+
+  /// The partition that holds node
+  uint32_t PartitionOf(uint64_t node) const;
+
+  /// Call fn on each partition p, in order, for which wanted(p) is true, or
+  /// on all of them if wanted is empty. fn is called from this thread and
+  /// can use parallel loops over the nodes of the partition.
+  Result<void> ForEachPartition(
+      const std::function<bool(uint32_t)>& wanted,
+      const std::function<void(const OutOfCorePartition&)>& fn);
+
+private:
+  OutOfCoreTopology(std::unique_ptr<RDGFile> rdg_file, RDG&& rdg);
+
+  Result<void> Partition(uint64_t partition_bytes);
+
+  /// Read partition from storage
+  Result<OutOfCorePartition> Fill(uint32_t partition);
+  Result<void> Release(const OutOfCorePartition& partition);
+
+  std::unique_ptr<RDGFile> rdg_file_;
+  RDG rdg_;
+  RDGTopology* topology_{nullptr};
+  uint64_t num_nodes_{0};
+  uint64_t num_edges_{0};
+  std::vector<uint64_t> partition_bounds_;
+};
+
+/// The BFS level of each node from source along out edges, or
+/// std::numeric_limits<uint32_t>::max() for nodes it does not reach. Each
+/// level reads only the partitions with nodes in the frontier.
+KATANA_EXPORT Result<NUMAArray<uint32_t>> OutOfCoreBfs(
+    OutOfCoreTopology* topology, uint32_t source);
+
+/// The PageRank of each node computed like PagerankPlan::PullTopological,
+/// but by pushing the rank of each node along its out edges so that no
+/// transposed topology is needed. Uses the tolerance, maximum iterations and
+/// alpha of plan; one iteration reads the whole topology.
+KATANA_EXPORT Result<NUMAArray<float>> OutOfCorePagerank(
+    OutOfCoreTopology* topology, const PagerankPlan& plan = {});
+
+/// The weakly connected component of each node, labeled by the smallest node
+/// in it, computed with a concurrent union-find in a single read of the
+/// topology
+KATANA_EXPORT Result<NUMAArray<uint32_t>> OutOfCoreConnectedComponents(
+    OutOfCoreTopology* topology);
+
+}  // namespace katana::analytics
+
+#endif
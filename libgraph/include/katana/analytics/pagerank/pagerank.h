@@ -2,10 +2,13 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_PAGERANK_PAGERANK_H_
 
 #include <iostream>
+#include <vector>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
+#include "katana/analytics/GraphStatistics.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
 
@@ -29,16 +32,19 @@ private:
   float tolerance_;
   unsigned int max_iterations_;
   float alpha_;
+  EdgeIndexWidth edge_index_width_;
 
 public:
   PagerankPlan(
       Architecture architecture, Algorithm algorithm, float tolerance,
-      unsigned int max_iterations, float alpha)
+      unsigned int max_iterations, float alpha,
+      EdgeIndexWidth edge_index_width = k64BitEdgeIndex)
       : Plan(architecture),
         algorithm_(algorithm),
         tolerance_(tolerance),
         max_iterations_(max_iterations),
-        alpha_(alpha) {}
+        alpha_(alpha),
+        edge_index_width_(edge_index_width) {}
 
   constexpr static const unsigned kChunkSize = 16U;
 
@@ -48,6 +54,19 @@ public:
             kCPU, kPushAsynchronous, kDefaultTolerance, kDefaultMaxIterations,
             kDefaultAlpha) {}
 
+  /// Choose an algorithm from the statistics of pg: the residual pull
+  /// algorithm for dense graphs, where pulling saves an atomic update per
+  /// edge, and the asynchronous push algorithm otherwise
+  PagerankPlan(const katana::PropertyGraph* pg) : Plan(kCPU) {
+    if (GetGraphStatistics(*pg).dense()) {
+      *this = PullResidual(
+          kDefaultTolerance, kDefaultMaxIterations, kDefaultAlpha,
+          kAutoEdgeIndexWidth);
+    } else {
+      *this = PushAsynchronous();
+    }
+  }
+
   PagerankPlan& operator=(const PagerankPlan&) = default;
 
   Algorithm algorithm() const { return algorithm_; }
@@ -55,6 +74,9 @@ public:
   unsigned int max_iterations() const { return max_iterations_; }
   float alpha() const { return alpha_; }
   float initial_residual() const { return 1 - alpha_; }
+  /// The pull algorithms walk a 32-bit copy of the transposed topology when
+  /// this allows it; the push algorithms ignore it
+  EdgeIndexWidth edge_index_width() const { return edge_index_width_; }
 
   /// Topological pull algorithm
   ///
@@ -62,8 +84,10 @@ public:
   static PagerankPlan PullTopological(
       float tolerance = kDefaultTolerance,
       unsigned int max_iterations = kDefaultMaxIterations,
-      float alpha = kDefaultAlpha) {
-    return {kCPU, kPullTopological, tolerance, max_iterations, alpha};
+      float alpha = kDefaultAlpha,
+      EdgeIndexWidth edge_index_width = k64BitEdgeIndex) {
+    return {kCPU,  kPullTopological, tolerance, max_iterations,
+            alpha, edge_index_width};
   }
 
   /// Delta-residual pull algorithm
@@ -72,8 +96,10 @@ public:
   static PagerankPlan PullResidual(
       float tolerance = kDefaultTolerance,
       unsigned int max_iterations = kDefaultMaxIterations,
-      float alpha = kDefaultAlpha) {
-    return {kCPU, kPullResidual, tolerance, max_iterations, alpha};
+      float alpha = kDefaultAlpha,
+      EdgeIndexWidth edge_index_width = k64BitEdgeIndex) {
+    return {kCPU,  kPullResidual, tolerance, max_iterations,
+            alpha, edge_index_width};
   }
 
   /// Asynchronous push algorithm
@@ -103,6 +129,14 @@ public:
       float alpha = kDefaultAlpha) {
     return {kCPU, kPushSynchronous, tolerance, max_iterations, alpha};
   }
+
+  /// This plan ranking along the edges of edge_type only, as if the graph
+  /// had no other edges. PagerankIncremental ignores it.
+  PagerankPlan WithEdgeType(EntityTypeID edge_type) const {
+    PagerankPlan plan = *this;
+    plan.set_edge_type(edge_type);
+    return plan;
+  }
 };
 
 /// Compute the Page Rank of each node in the graph.
@@ -112,6 +146,19 @@ KATANA_EXPORT Result<void> Pagerank(
     PropertyGraph* pg, const std::string& output_property_name,
     katana::TxnContext* txn_ctx, PagerankPlan plan = {});
 
+/// Update the Page Rank in the property named previous_property_name, which
+/// Pagerank computed before updates were applied to pg, and store it in the
+/// property named output_property_name, which is created by this function
+/// and may not exist before the call. Only the residuals that updates create
+/// at the destinations of nodes whose out-edges changed are pushed, as in
+/// PagerankPlan::PushAsynchronous but with signed residuals, so the work is
+/// proportional to the region the updates affect. The alpha and tolerance
+/// of plan are used; they should match those of the previous result.
+KATANA_EXPORT Result<void> PagerankIncremental(
+    PropertyGraph* pg, const std::string& previous_property_name,
+    const EdgeUpdates& updates, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, PagerankPlan plan = {});
+
 KATANA_EXPORT Result<void> PagerankAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
@@ -130,6 +177,107 @@ struct KATANA_EXPORT PagerankStatistics {
       katana::PropertyGraph* pg, const std::string& property_name);
 };
 
+/// A computational plan for Personalized Page Rank from each of many seeds.
+/// Each seed is computed locally, touching only the nodes near it, and seeds
+/// are computed in parallel.
+class PersonalizedPagerankPlan : public Plan {
+public:
+  enum Algorithm {
+    kForwardPush,
+    kMonteCarlo,
+  };
+
+  static constexpr double kDefaultEpsilon = 1.0e-6;
+  static constexpr uint32_t kDefaultNumWalks = 10000;
+  static constexpr double kDefaultAlpha = PagerankPlan::kDefaultAlpha;
+  static constexpr uint32_t kDefaultTopK = 10;
+  static constexpr uint64_t kDefaultSeed = 0;
+
+private:
+  Algorithm algorithm_;
+  double epsilon_;
+  uint32_t num_walks_;
+  double alpha_;
+  uint32_t top_k_;
+  uint64_t seed_;
+
+  PersonalizedPagerankPlan(
+      Architecture architecture, Algorithm algorithm, double epsilon,
+      uint32_t num_walks, double alpha, uint32_t top_k, uint64_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        epsilon_(epsilon),
+        num_walks_(num_walks),
+        alpha_(alpha),
+        top_k_(top_k),
+        seed_(seed) {}
+
+public:
+  PersonalizedPagerankPlan() : PersonalizedPagerankPlan(ForwardPush()) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The residual per out-edge below which kForwardPush stops pushing
+  double epsilon() const { return epsilon_; }
+  /// The number of random walks of kMonteCarlo from each seed
+  uint32_t num_walks() const { return num_walks_; }
+  /// The probability of following an edge rather than returning to the seed
+  double alpha() const { return alpha_; }
+  /// The number of highest ranked nodes kept for each seed
+  uint32_t top_k() const { return top_k_; }
+  /// The seed of the random walks of kMonteCarlo
+  uint64_t seed() const { return seed_; }
+
+  /// Local forward push (Andersen, Chung and Lang): move the residual of a
+  /// node into its rank and push it to its out-neighbors until every residual
+  /// is below epsilon times the out-degree. The rank of each node is then
+  /// within epsilon times its out-degree of the exact value.
+  ///
+  /// ANDERSEN, Reid; CHUNG, Fan; LANG, Kevin. Local graph partitioning using
+  /// PageRank vectors. In: 47th Annual IEEE Symposium on Foundations of
+  /// Computer Science (FOCS'06). IEEE, 2006. p. 475-486.
+  static PersonalizedPagerankPlan ForwardPush(
+      double epsilon = kDefaultEpsilon, double alpha = kDefaultAlpha,
+      uint32_t top_k = kDefaultTopK) {
+    return {kCPU, kForwardPush, epsilon, 0, alpha, top_k, 0};
+  }
+
+  /// Estimate the rank of each node as the fraction of num_walks random
+  /// walks from the seed that end there, each walk ending at each step with
+  /// probability 1 - alpha
+  static PersonalizedPagerankPlan MonteCarlo(
+      uint32_t num_walks = kDefaultNumWalks, double alpha = kDefaultAlpha,
+      uint32_t top_k = kDefaultTopK, uint64_t seed = kDefaultSeed) {
+    return {kCPU, kMonteCarlo, 0, num_walks, alpha, top_k, seed};
+  }
+};
+
+/// Compute the Personalized Page Rank of each node in seeds, i.e., the Page
+/// Rank whose random walks return to the seed rather than to a random node,
+/// and keep the top_k highest ranked nodes of each. Walks from a node without
+/// out-edges also return to the seed.
+///
+/// Two node properties are created by this function, and may not exist
+/// before the call: output_property_name + "_nodes", a list of the top ranked
+/// node IDs (as uint32_t) of each seed in decreasing rank, and
+/// output_property_name + "_ranks", their ranks (as float). The lists of
+/// nodes that are not seeds are empty.
+KATANA_EXPORT Result<void> PersonalizedPagerank(
+    PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    PersonalizedPagerankPlan plan = {});
+
+/// Check the results of PersonalizedPagerank from seeds with plan against
+/// the Personalized Page Rank of each seed computed by power iteration: each
+/// reported rank must be within tolerance of the exact rank of its node, and
+/// no node left out of the top_k of a seed may rank higher than tolerance
+/// above the lowest reported rank.
+/// @return a failure if the results do not pass validation or if there is a
+///     failure during checking.
+KATANA_EXPORT Result<void> PersonalizedPagerankAssertValid(
+    PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    const std::string& output_property_name, PersonalizedPagerankPlan plan,
+    double tolerance);
+
 }  // namespace katana::analytics
 
 #endif
@@ -0,0 +1,137 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_PATTERNMATCHING_PATTERNMATCHING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_PATTERNMATCHING_PATTERNMATCHING_H_
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/PropertyFilter.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A node of a Pattern
+struct PatternNode {
+  /// The name of the column of the node in FindPatternMatches; empty for
+  /// "node_<index>"
+  std::string name;
+  /// An atomic node type the matched node must have; empty for any node
+  std::string type_name;
+  /// A predicate the matched node must satisfy
+  std::optional<katana::PropertyFilter> filter;
+};
+
+/// An edge of a Pattern, between nodes given by their index in
+/// Pattern::nodes
+struct PatternEdge {
+  uint32_t src;
+  uint32_t dst;
+  /// The atomic edge type of the matched edge; empty for any edge
+  std::string type_name;
+  /// A predicate the matched edge must satisfy
+  std::optional<katana::PropertyFilter> filter;
+};
+
+/// A small connected pattern of typed nodes and directed edges, e.g., a path,
+/// a star, a triangle or a cycle.
+///
+/// A match assigns a distinct node of the graph to each node of the pattern
+/// such that there is an edge of the graph matching each edge of the
+/// pattern between the nodes assigned to its endpoints. Other edges between
+/// them do not matter. Each assignment is a match, so a pattern with
+/// symmetries matches the same nodes several times: an undirected triangle
+/// given as a directed 3-cycle matches each triangle of a symmetric graph 6
+/// times.
+struct Pattern {
+  static constexpr uint32_t kMaxNodes = 8;
+
+  std::vector<PatternNode> nodes;
+  std::vector<PatternEdge> edges;
+};
+
+/// A computational plan for matching a pattern.
+class PatternMatchingPlan : public Plan {
+public:
+  enum Algorithm {
+    kGenericJoin,
+  };
+
+  /// Partial matches whose next node has more candidates than this are
+  /// extended by separate tasks, so threads can steal the work of hubs
+  static const uint32_t kDefaultSpawnDegree = 256;
+
+private:
+  Algorithm algorithm_;
+  uint32_t spawn_degree_;
+
+  PatternMatchingPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t spawn_degree)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        spawn_degree_(spawn_degree) {}
+
+public:
+  PatternMatchingPlan() : PatternMatchingPlan{GenericJoin()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  uint32_t spawn_degree() const { return spawn_degree_; }
+
+  /// Match the nodes of the pattern one at a time, in an order where each
+  /// node has an edge to the ones before it, as in worst-case optimal joins:
+  /// the candidates for a node are the neighbors of a matched node along the
+  /// smallest of the adjacency ranges, of the edge type of its pattern edges,
+  /// that constrain it, checked against the other ranges by binary search.
+  static PatternMatchingPlan GenericJoin(
+      uint32_t spawn_degree = kDefaultSpawnDegree) {
+    return {kCPU, kGenericJoin, spawn_degree};
+  }
+};
+
+/// \returns the number of matches of pattern in pg
+///
+/// @param pg The graph to process.
+/// @param pattern The pattern to match
+/// @param plan
+KATANA_EXPORT katana::Result<uint64_t> CountPatternMatches(
+    katana::PropertyGraph* pg, const Pattern& pattern,
+    PatternMatchingPlan plan = {});
+
+/// Call callback with every match of pattern in pg, as the nodes assigned to
+/// the nodes of the pattern, in order. Matches are found in parallel, so
+/// callback is called concurrently from several threads.
+///
+/// @param pg The graph to process.
+/// @param pattern The pattern to match
+/// @param callback Called with each match
+/// @param plan
+KATANA_EXPORT katana::Result<void> ForEachPatternMatch(
+    katana::PropertyGraph* pg, const Pattern& pattern,
+    const std::function<void(const std::vector<katana::PropertyGraph::Node>&)>&
+        callback,
+    PatternMatchingPlan plan = {});
+
+/// \returns up to max_matches matches of pattern in pg as a table with a
+/// uint32 column of nodes for each node of the pattern. Which matches are
+/// returned when there are more is unspecified.
+///
+/// @param pg The graph to process.
+/// @param pattern The pattern to match
+/// @param max_matches The most matches returned
+/// @param plan
+KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> FindPatternMatches(
+    katana::PropertyGraph* pg, const Pattern& pattern,
+    uint64_t max_matches = std::numeric_limits<uint64_t>::max(),
+    PatternMatchingPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
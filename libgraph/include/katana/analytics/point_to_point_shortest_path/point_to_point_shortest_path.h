@@ -0,0 +1,122 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_POINTTOPOINTSHORTESTPATH_POINTTOPOINTSHORTESTPATH_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_POINTTOPOINTSHORTESTPATH_POINTTOPOINTSHORTESTPATH_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for answering shortest path queries between pairs
+/// of nodes, specifying the algorithm and any parameters associated with it.
+class PointToPointShortestPathPlan : public Plan {
+public:
+  /// Algorithm selectors for point-to-point shortest paths
+  enum Algorithm {
+    /// Dijkstra from the source along out-edges and from the target along
+    /// in-edges until the two searches meet
+    kBidirectionalDijkstra,
+    /// Breadth-first search from both ends; counts hops and ignores the edge
+    /// weights
+    kBidirectionalBfs,
+    /// Bidirectional Dijkstra guided by lower bounds derived from landmark
+    /// distances (A*, landmarks and the triangle inequality)
+    kAlt,
+  };
+
+private:
+  Algorithm algorithm_;
+  std::string landmark_property_prefix_;
+  uint32_t num_landmarks_;
+
+  PointToPointShortestPathPlan(
+      Architecture architecture, Algorithm algorithm,
+      std::string landmark_property_prefix, uint32_t num_landmarks)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        landmark_property_prefix_(std::move(landmark_property_prefix)),
+        num_landmarks_(num_landmarks) {}
+
+public:
+  PointToPointShortestPathPlan()
+      : PointToPointShortestPathPlan{BidirectionalDijkstra()} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The prefix of the landmark distance properties for kAlt, as given to
+  /// ShortestPathLandmarks
+  const std::string& landmark_property_prefix() const {
+    return landmark_property_prefix_;
+  }
+
+  /// The number of landmarks for kAlt
+  uint32_t num_landmarks() const { return num_landmarks_; }
+
+  static PointToPointShortestPathPlan BidirectionalDijkstra() {
+    return {kCPU, kBidirectionalDijkstra, "", 0};
+  }
+
+  static PointToPointShortestPathPlan BidirectionalBfs() {
+    return {kCPU, kBidirectionalBfs, "", 0};
+  }
+
+  /// Use the distances of num_landmarks landmarks stored by
+  /// ShortestPathLandmarks under landmark_property_prefix. The distances
+  /// must have been computed with the same edge weights as the queries.
+  static PointToPointShortestPathPlan Alt(
+      const std::string& landmark_property_prefix, uint32_t num_landmarks) {
+    return {kCPU, kAlt, landmark_property_prefix, num_landmarks};
+  }
+};
+
+/// Choose num_landmarks landmark nodes for kAlt queries and store their
+/// distances as node properties (as double, infinity if unreachable): the
+/// distance from landmark i to each node in a property named
+/// output_property_prefix + "_from_" + i and the distance from each node to
+/// landmark i in one named output_property_prefix + "_to_" + i. These
+/// properties are created by this function and may not exist before the
+/// call. Each landmark is the node of the highest degree that no landmark
+/// chosen so far reaches or is reached from, if any, or else the node
+/// farthest from them, in the sum of its finite distances to and from its
+/// nearest one.
+///
+/// @param pg The graph
+/// @param edge_weight_property_name The non-negative edge weights, which may
+///     be of any numeric type, or all 1 if empty; edges whose weight is null
+///     are left out of every path
+/// @param num_landmarks The number of landmarks
+/// @param output_property_prefix The prefix of the distance properties
+/// @param txn_ctx
+/// @return The landmarks, in order
+KATANA_EXPORT Result<std::vector<uint32_t>> ShortestPathLandmarks(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    uint32_t num_landmarks, const std::string& output_property_prefix,
+    katana::TxnContext* txn_ctx);
+
+/// Compute the length of a shortest path from source to target for each
+/// (source, target) pair in queries, or infinity if there is none. Each
+/// query is a serial search from both of its ends that stops as soon as the
+/// shortest path is known, which usually settles far fewer nodes than a
+/// single-source search; the queries are answered in parallel, and each
+/// thread reuses its scratch memory from one query to the next.
+///
+/// @param pg The graph
+/// @param queries The (source, target) pairs
+/// @param edge_weight_property_name The edge weights, as for
+///     ShortestPathLandmarks; unused by kBidirectionalBfs
+/// @param plan
+/// @return The shortest path length of each query, in order
+KATANA_EXPORT Result<std::vector<double>> PointToPointShortestPaths(
+    PropertyGraph* pg,
+    const std::vector<std::pair<uint32_t, uint32_t>>& queries,
+    const std::string& edge_weight_property_name,
+    PointToPointShortestPathPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -1,11 +1,16 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
 
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include <katana/analytics/Plan.h>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/URI.h"
 #include "katana/analytics/Utils.h"
 
 // API
@@ -26,6 +31,7 @@ public:
   constexpr static const double kDefaultForwardProbability = 1.0;
   static const uint32_t kDefaultMaxIterations = 10;
   static const uint32_t kDefaultNumberOfEdgeTypes = 1;
+  static const uint64_t kDefaultSeed = 0;
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -40,12 +46,14 @@ private:
   // Only need for edge2vec
   // TODO(gill) Find number of edge types automatically
   uint32_t number_of_edge_types_;
+  // Only used by node2vec
+  uint64_t seed_;
 
   RandomWalksPlan(
       Architecture architecture, Algorithm algorithm, uint32_t walk_length,
       uint32_t number_of_walks, double backward_probability,
       double forward_probability, uint32_t max_iterations,
-      uint32_t number_of_edge_types)
+      uint32_t number_of_edge_types, uint64_t seed = kDefaultSeed)
       : Plan(architecture),
         algorithm_(algorithm),
         walk_length_(walk_length),
@@ -53,7 +61,8 @@ private:
         backward_probability_(backward_probability),
         forward_probability_(forward_probability),
         max_iterations_(max_iterations),
-        number_of_edge_types_(number_of_edge_types) {}
+        number_of_edge_types_(number_of_edge_types),
+        seed_(seed) {}
 
 public:
   // kChunkSize is fixed at 1
@@ -95,12 +104,17 @@ public:
 
   uint32_t number_of_edge_types() const { return number_of_edge_types_; }
 
+  /// Seed of the random numbers of node2vec. Each walk draws its numbers
+  /// from its own stream, so the walks depend only on the seed.
+  uint64_t seed() const { return seed_; }
+
   /// Node2Vec algorithm to generate random walks on the graph
   static RandomWalksPlan Node2Vec(
       uint32_t walk_length = kDefaultWalkLength,
       uint32_t number_of_walks = kDefaultNumberOfWalks,
       double backward_probability = kDefaultBackwardProbability,
-      double forward_probability = kDefaultBackwardProbability) {
+      double forward_probability = kDefaultBackwardProbability,
+      uint64_t seed = kDefaultSeed) {
     return {
         kCPU,
         kNode2Vec,
@@ -109,7 +123,8 @@ public:
         backward_probability,
         forward_probability,
         0,
-        1};
+        1,
+        seed};
   }
 
   /// Edge2Vec algorithm to generate random walks on the graph.
@@ -123,7 +138,7 @@ public:
       uint32_t number_of_edge_types = kDefaultNumberOfEdgeTypes) {
     return {
         kCPU,
-        kNode2Vec,
+        kEdge2Vec,
         walk_length,
         number_of_walks,
         backward_probability,
@@ -131,6 +146,14 @@ public:
         max_iterations,
         number_of_edge_types};
   }
+
+  /// This plan walking along the edges of edge_type only. Edge2Vec, which
+  /// walks over all the edge types, ignores it.
+  RandomWalksPlan WithEdgeType(EntityTypeID edge_type) const {
+    RandomWalksPlan plan = *this;
+    plan.set_edge_type(edge_type);
+    return plan;
+  }
 };
 
 /// Compute the random-walks for pg. The pg is expected to be symmetric. The
@@ -140,6 +163,67 @@ public:
 KATANA_EXPORT Result<std::vector<std::vector<uint32_t>>> RandomWalks(
     PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
 
+/// \returns the edge2vec transition matrix that plan estimates for pg, whose
+/// entry i * (n + 1) + j, for n the number_of_edge_types of plan, weighs
+/// taking an edge of type j right after an edge of type i. Edges whose
+/// entity type is above n count as type 0. The matrix is the one the final
+/// walks of RandomWalks with plan are taken with.
+///
+/// @param plan Must be a kEdge2Vec plan
+KATANA_EXPORT Result<std::vector<double>> Edge2VecTransitionMatrix(
+    PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan::Edge2Vec());
+
+/// Compute node2vec random-walks for pg into a table with one row per walk
+/// and a single large_list<uint32> column "walk". Unlike RandomWalks, the
+/// walks are written to preallocated memory and compacted into the buffers
+/// of the table, without an allocation per walk.
+///
+/// @param edge_weight_property_name If not empty, a numeric edge property
+///     that biases the choice of each next node in proportion to the weight
+///     of the edge to it, before the node2vec return and in-out biases
+/// @param plan Must be a kNode2Vec plan
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> RandomWalksTable(
+    PropertyGraph* pg, const std::string& edge_weight_property_name = "",
+    RandomWalksPlan plan = RandomWalksPlan());
+
+/// Receives each batch of walks of RandomWalksStream as a table like the
+/// one of RandomWalksTable. An error stops the walks and is returned.
+using RandomWalksBatchCallback =
+    std::function<Result<void>(const std::shared_ptr<arrow::Table>& batch)>;
+
+/// Compute node2vec random-walks for pg like RandomWalksTable, but pass them
+/// to callback in order, in batches of the walks of at most walks_per_batch
+/// (node, walk number) pairs, so that a consumer such as embedding training
+/// can start on the first batch while memory stays bounded by one batch.
+/// Walks that end before their first step are dropped, so batches can have
+/// fewer rows. The walks are the same for every walks_per_batch.
+///
+/// @param walks_per_batch The number of walks generated at a time
+/// @param callback Called with each batch, which is not reused after it
+///     returns
+/// @param edge_weight_property_name See RandomWalksTable
+/// @param plan Must be a kNode2Vec plan
+KATANA_EXPORT Result<void> RandomWalksStream(
+    PropertyGraph* pg, uint64_t walks_per_batch,
+    const RandomWalksBatchCallback& callback,
+    const std::string& edge_weight_property_name = "",
+    RandomWalksPlan plan = RandomWalksPlan());
+
+/// The largest walks_per_batch of RandomWalksToParquet, below the number of
+/// rows the Parquet writer splits a file at
+constexpr uint64_t kMaxWalksPerParquetPart = uint64_t{1} << 29;
+
+/// Stream node2vec random-walks for pg to a Parquet table at uri with the
+/// column of RandomWalksTable, one part file per batch. Each batch is
+/// encoded while the previous ones upload, and generation waits when too
+/// many bytes are in flight. The table can be read with ParquetReader.
+///
+/// @param walks_per_batch At most kMaxWalksPerParquetPart
+KATANA_EXPORT Result<void> RandomWalksToParquet(
+    PropertyGraph* pg, const katana::URI& uri, uint64_t walks_per_batch,
+    const std::string& edge_weight_property_name = "",
+    RandomWalksPlan plan = RandomWalksPlan());
+
 KATANA_EXPORT Result<void> RandomWalksAssertValid(PropertyGraph* pg);
 
 }  // namespace katana::analytics
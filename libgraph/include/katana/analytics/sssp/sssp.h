@@ -2,8 +2,10 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_SSSP_SSSP_H_
 
 #include <iostream>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/analytics/GraphStatistics.h"
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
 
@@ -19,6 +21,8 @@ public:
     kDeltaStep,
     kDeltaStepBarrier,
     kDeltaStepFusion,
+    kDeltaStepAdaptive,
+    kMultiQueue,
     // TODO(gill): Do we want to expose serial implementations at all?
     kSerialDeltaTile,
     kSerialDelta,
@@ -55,12 +59,17 @@ private:
 public:
   SsspPlan() : SsspPlan{kCPU, kAutomatic, 0, 0} {}
 
+  /// Choose an algorithm from the statistics of pg: delta stepping for
+  /// power-law graphs, tiled if some node has more edges than a tile, and
+  /// delta stepping with a barrier between buckets otherwise
   SsspPlan(const katana::PropertyGraph* pg) : Plan(kCPU) {
-    bool isPowerLaw = IsApproximateDegreeDistributionPowerLaw(*pg);
-    if (isPowerLaw) {
-      *this = DeltaStep();
-    } else {
+    GraphStatistics stats = GetGraphStatistics(*pg);
+    if (!stats.power_law) {
       *this = DeltaStepBarrier();
+    } else if (stats.NeedsEdgeTiles(kDefaultEdgeTileSize)) {
+      *this = DeltaTile();
+    } else {
+      *this = DeltaStep();
     }
   }
 
@@ -88,6 +97,16 @@ public:
     return {kCPU, kDeltaStepFusion, delta, 0};
   }
 
+  /// Delta stepping whose bucket width starts at 2^delta and then adapts to
+  /// the work found in each bucket
+  static SsspPlan DeltaStepAdaptive(unsigned delta = kDefaultDelta) {
+    return {kCPU, kDeltaStepAdaptive, delta, 0};
+  }
+
+  /// Asynchronous SSSP on a relaxed concurrent priority queue; needs no
+  /// delta
+  static SsspPlan MultiQueue() { return {kCPU, kMultiQueue, 0, 0}; }
+
   static SsspPlan SerialDeltaTile(
       unsigned delta = kDefaultDelta,
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
@@ -111,6 +130,13 @@ public:
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
     return {kCPU, kTopologicalTile, 0, edge_tile_size};
   }
+
+  /// This plan relaxing the edges of edge_type only
+  SsspPlan WithEdgeType(EntityTypeID edge_type) const {
+    SsspPlan plan = *this;
+    plan.set_edge_type(edge_type);
+    return plan;
+  }
 };
 
 /// Compute the Single-Source Shortest Path for pg starting from start_node.
@@ -147,6 +173,90 @@ struct KATANA_EXPORT SsspStatistics {
       PropertyGraph* pg, const std::string& output_property_name);
 };
 
+/// A computational plan for SSSP from many sources at once
+class MultiSourceSsspPlan : public Plan {
+public:
+  enum Algorithm {
+    kBatchedDeltaStep = 0,
+  };
+
+  static constexpr uint32_t kDefaultBatchSize = 64;
+  static constexpr uint32_t kMaxBatchSize = 512;
+
+private:
+  Algorithm algorithm_;
+  unsigned delta_;
+  uint32_t batch_size_;
+
+  MultiSourceSsspPlan(
+      Architecture architecture, Algorithm algorithm, unsigned delta,
+      uint32_t batch_size)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        delta_(delta),
+        batch_size_(batch_size) {}
+
+public:
+  MultiSourceSsspPlan()
+      : MultiSourceSsspPlan{
+            kCPU, kBatchedDeltaStep, SsspPlan::kDefaultDelta,
+            kDefaultBatchSize} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The exponent of the delta step size (2 based), as in SsspPlan
+  unsigned delta() const { return delta_; }
+  uint32_t batch_size() const { return batch_size_; }
+
+  /// Delta stepping of batch_size searches at a time, a multiple of 64 up to
+  /// kMaxBatchSize. The work items are nodes, not (node, search) pairs: a
+  /// node keeps a bit per search whose distance improved since the node was
+  /// last processed, and processing it scans its edges once to relax every
+  /// such search. Each node keeps a distance per search, so the scratch
+  /// memory grows with the number of nodes times batch_size.
+  static MultiSourceSsspPlan BatchedDeltaStep(
+      unsigned delta = SsspPlan::kDefaultDelta,
+      uint32_t batch_size = kDefaultBatchSize) {
+    return {kCPU, kBatchedDeltaStep, delta, batch_size};
+  }
+};
+
+/// Results of an SSSP from each of many sources
+struct KATANA_EXPORT MultiSourceSsspStatistics {
+  /// For each source, the number of nodes it reaches, including itself
+  std::vector<uint64_t> n_reached_nodes;
+  /// For each source, the sum of the distances of the nodes it reaches
+  std::vector<double> distance_sums;
+  /// For each source, the largest distance of a node it reaches
+  std::vector<double> max_distances;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/// Compute the Single-Source Shortest Path from each node in sources, in
+/// batches of searches that share each scan of the edges as set by the plan.
+/// The edge weights are taken from the property named
+/// edge_weight_property_name as in Sssp, or are all 1 if it is empty. For
+/// each node, the number of searches from sources that reach it is stored in
+/// a property named by output_property_name (as uint32_t), which is created
+/// by this function and may not exist before the call. The distances found
+/// by each search are summarized in the returned statistics, in the order of
+/// sources.
+KATANA_EXPORT Result<MultiSourceSsspStatistics> MultiSourceSssp(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MultiSourceSsspPlan plan = {});
+
+/// Check the results of MultiSourceSssp from sources stored in property_name.
+/// Which nodes a search reaches does not depend on the edge weights, so this
+/// is the check of MultiSourceBfsAssertValid.
+/// @return a failure if the results do not pass validation or if there is a
+///     failure during checking.
+KATANA_EXPORT Result<void> MultiSourceSsspAssertValid(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& property_name);
+
 }  // namespace katana::analytics
 
 #endif
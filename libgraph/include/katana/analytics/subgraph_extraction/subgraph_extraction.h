@@ -45,8 +45,9 @@ public:
 /**
  * Construct a new sub-graph from the original graph.
  *
- * By default only topology of the sub-graph is constructed.
- * The new sub-graph is independent of the original graph.
+ * By default only topology and types of the sub-graph are constructed.
+ * The new sub-graph is independent of the original graph. Node i of the
+ * sub-graph is the i-th distinct node of node_vec.
  *
  * @param pg The graph to process.
  * @param node_vec Set of node IDs
@@ -57,7 +58,42 @@ SubGraphExtraction(
     katana::PropertyGraph* pg,
     const std::vector<katana::PropertyGraph::Node>& node_vec,
     SubGraphExtractionPlan plan = {});
-// const std::vector<std::string>& node_properties_to_copy, const std::vector<std::string>& edge_properties_to_copy);
+
+/**
+ * Construct a new sub-graph from the original graph, like the overload
+ * above, and copy the rows of the named properties into it. Rows are taken
+ * in parallel chunks.
+ *
+ * @param pg The graph to process.
+ * @param node_vec Set of node IDs
+ * @param node_properties_to_copy Node properties the sub-graph gets
+ * @param edge_properties_to_copy Edge properties the sub-graph gets
+ * @param txn_ctx The transaction context for adding the properties
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtraction(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& node_vec,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
+    katana::TxnContext* txn_ctx, SubGraphExtractionPlan plan = {});
+
+/**
+ * Construct the sub-graph as a projection of the original graph, see
+ * PropertyGraph::MakeProjectedGraph. Only its topology is built; types and
+ * all properties are read from the arrays of the original graph without
+ * copying them, so the original graph must outlive the sub-graph.
+ *
+ * @param pg The graph to process.
+ * @param node_vec Set of node IDs
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtractionView(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& node_vec,
+    SubGraphExtractionPlan plan = {});
 
 }  // namespace katana::analytics
 
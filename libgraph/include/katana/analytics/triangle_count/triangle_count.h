@@ -15,6 +15,8 @@ public:
     kNodeIteration,
     kEdgeIteration,
     kOrderedCount,
+    kEdgeSampling,
+    kWedgeSampling,
   };
 
   enum Relabeling {
@@ -25,19 +27,29 @@ public:
 
   static const Relabeling kDefaultRelabeling = kAutoRelabel;
   static const bool kDefaultEdgeSorted = false;
+  static constexpr uint64_t kDefaultNumSamples = uint64_t{1} << 20;
+  static constexpr double kDefaultConfidence = 0.95;
+  static constexpr uint64_t kDefaultSeed = 0;
 
 private:
   Algorithm algorithm_;
   Relabeling relabeling_;
   bool edges_sorted_;
+  uint64_t num_samples_;
+  double confidence_;
+  uint64_t seed_;
 
   TriangleCountPlan(
       Architecture architecture, Algorithm algorithm, bool edges_sorted,
-      Relabeling relabeling)
+      Relabeling relabeling, uint64_t num_samples = kDefaultNumSamples,
+      double confidence = kDefaultConfidence, uint64_t seed = kDefaultSeed)
       : Plan(architecture),
         algorithm_(algorithm),
         relabeling_(relabeling),
-        edges_sorted_(edges_sorted) {}
+        edges_sorted_(edges_sorted),
+        num_samples_(num_samples),
+        confidence_(confidence),
+        seed_(seed) {}
 
 public:
   TriangleCountPlan()
@@ -47,6 +59,13 @@ public:
   Algorithm algorithm() const { return algorithm_; }
   Relabeling relabeling() const { return relabeling_; }
   bool edges_sorted() const { return edges_sorted_; }
+  /// The number of edges or wedges sampled by the sampling algorithms
+  uint64_t num_samples() const { return num_samples_; }
+  /// The probability that the confidence interval of the sampling
+  /// algorithms contains the exact count
+  double confidence() const { return confidence_; }
+  /// The seed of the samples of the sampling algorithms
+  uint64_t seed() const { return seed_; }
 
   /**
    * The node-iterator algorithm from the following:
@@ -90,6 +109,63 @@ public:
       Relabeling relabeling = kDefaultRelabeling) {
     return {kCPU, kOrderedCount, edges_sorted, relabeling};
   }
+
+  /**
+   * Estimate the count from the common neighbors of the endpoints of
+   * uniformly sampled edges: each triangle is counted once by each of its
+   * six directed edges. The graph must not have self loops or parallel
+   * edges. Sampling an edge costs an intersection of two edge lists.
+   *
+   * @param num_samples The number of edges to sample.
+   * @param confidence The confidence level of the interval reported by
+   *     EstimateTriangleCount.
+   * @param seed The seed of the samples.
+   */
+  static TriangleCountPlan EdgeSampling(
+      uint64_t num_samples = kDefaultNumSamples,
+      double confidence = kDefaultConfidence, uint64_t seed = kDefaultSeed) {
+    return TriangleCountPlan(
+        kCPU, kEdgeSampling, kDefaultEdgeSorted, kDefaultRelabeling,
+        num_samples, confidence, seed);
+  }
+
+  /**
+   * Estimate the count from the fraction of uniformly sampled wedges (paths
+   * of two edges) that are closed by a third edge, which is three times the
+   * number of triangles over the number of wedges. From the following:
+   *   C. Seshadhri, Ali Pinar, and Tamara G. Kolda. Wedge Sampling for
+   *   Computing Clustering Coefficients and Triangle Counts on Large Graphs.
+   *   Statistical Analysis and Data Mining 7(4). 2014.
+   *
+   * The graph must not have self loops or parallel edges. Sampling a wedge
+   * costs a binary search, so this is the faster estimator on graphs with
+   * high degree nodes.
+   *
+   * @param num_samples The number of wedges to sample.
+   * @param confidence The confidence level of the interval reported by
+   *     EstimateTriangleCount.
+   * @param seed The seed of the samples.
+   */
+  static TriangleCountPlan WedgeSampling(
+      uint64_t num_samples = kDefaultNumSamples,
+      double confidence = kDefaultConfidence, uint64_t seed = kDefaultSeed) {
+    return TriangleCountPlan(
+        kCPU, kWedgeSampling, kDefaultEdgeSorted, kDefaultRelabeling,
+        num_samples, confidence, seed);
+  }
+};
+
+/// An estimate of the number of triangles of a graph
+struct TriangleCountEstimate {
+  double estimate;
+  /// The confidence interval [lower, upper] of the estimate at the
+  /// confidence level of the plan, from the normal approximation of the
+  /// mean of the samples
+  double lower;
+  double upper;
+  /// The number of samples of the estimate; 0 for exact counts, whose
+  /// interval is the count itself
+  uint64_t num_samples;
 };
 
 /**
@@ -104,6 +180,18 @@ public:
 KATANA_EXPORT katana::Result<uint64_t> TriangleCount(
     PropertyGraph* pg, TriangleCountPlan plan = {});
 
+/**
+ * Count or, with kEdgeSampling or kWedgeSampling, estimate the number of
+ * triangles in the graph with a confidence interval. TriangleCount returns
+ * the rounded estimate of the sampling algorithms. The graph must be
+ * symmetric!
+ *
+ * @param pg The graph to process.
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<TriangleCountEstimate> EstimateTriangleCount(
+    PropertyGraph* pg, TriangleCountPlan plan = {});
+
 }  // namespace katana::analytics
 
 #endif
@@ -11,6 +11,9 @@
 #include <optional>
 #include <random>
 #include <sstream>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -30,6 +33,7 @@
 #include "katana/Logging.h"
 #include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
+#include "katana/ResultReduction.h"
 #include "katana/SharedMemSys.h"
 #include "katana/Threads.h"
 
@@ -589,85 +593,6 @@ AddFalses(
   }
 }
 
-// Add nulls until the array is even and then append val so that length = total
-// + 1 at the end
-template <typename T, typename W>
-void
-AddTypedValue(
-    const W& val, std::shared_ptr<T> builder, ArrowArrays* chunks,
-    std::shared_ptr<arrow::Array> null_array, WriterProperties* properties,
-    size_t total) {
-  AddNulls(builder, chunks, null_array, properties, total);
-  auto st = builder->Append(val);
-  if (!st.ok()) {
-    KATANA_LOG_FATAL(
-        "Error appending to an arrow array builder: {}", st.ToString());
-  }
-
-  // if we filled up a chunk, flush it
-  if (static_cast<size_t>(builder->length()) == properties->chunk_size) {
-    chunks->emplace_back(BuildArray(builder));
-  }
-}
-
-// Add nulls until the array is even and then append a list so that length =
-// total + 1 at the end
-template <typename T, typename W>
-void
-AddArray(
-    const std::shared_ptr<arrow::ListArray>& list_vals,
-    const std::shared_ptr<W>& vals, size_t index,
-    std::shared_ptr<arrow::ListBuilder> list_builder, T* type_builder,
-    ArrowArrays* chunks, std::shared_ptr<arrow::Array> null_array,
-    WriterProperties* properties, size_t total) {
-  AddNulls(list_builder, chunks, null_array, properties, total);
-
-  int32_t start = list_vals->value_offset(index);
-  int32_t end = list_vals->value_offset(index + 1);
-
-  auto st = list_builder->Append();
-  for (int32_t s = start; s < end; s++) {
-    st = type_builder->Append(vals->Value(s));
-    if (!st.ok()) {
-      KATANA_LOG_FATAL(
-          "Error appending value to an arrow array builder: {}", st.ToString());
-    }
-  }
-  // if we filled up a chunk, flush it
-  if (static_cast<size_t>(list_builder->length()) == properties->chunk_size) {
-    chunks->emplace_back(BuildArray(list_builder));
-  }
-}
-
-// Add nulls until the array is even and then append a list so that length =
-// total + 1 at the end
-void
-AddArray(
-    const std::shared_ptr<arrow::ListArray>& list_vals,
-    const std::shared_ptr<arrow::StringArray>& vals, size_t index,
-    std::shared_ptr<arrow::ListBuilder> list_builder,
-    arrow::StringBuilder* type_builder, ArrowArrays* chunks,
-    std::shared_ptr<arrow::Array> null_array, WriterProperties* properties,
-    size_t total) {
-  AddNulls(list_builder, chunks, null_array, properties, total);
-
-  int32_t start = list_vals->value_offset(index);
-  int32_t end = list_vals->value_offset(index + 1);
-
-  auto st = list_builder->Append();
-  for (int32_t s = start; s < end; s++) {
-    st = type_builder->Append(vals->GetView(s));
-    if (!st.ok()) {
-      KATANA_LOG_FATAL(
-          "Error appending value to an arrow array builder: {}", st.ToString());
-    }
-  }
-  // if we filled up a chunk, flush it
-  if (static_cast<size_t>(list_builder->length()) == properties->chunk_size) {
-    chunks->emplace_back(BuildArray(list_builder));
-  }
-}
-
 // Add nulls until the array is even and then append val so that length = total
 // + 1 at the end
 void
@@ -724,32 +649,6 @@ SetEdgeID(
 /* Functions for ensuring all arrow arrays are of the right length in the end */
 /******************************************************************************/
 
-// Adds nulls to the array until its length == total
-template <typename T>
-void
-EvenOutArray(
-    ArrowArrays* chunks, std::shared_ptr<T> builder,
-    std::shared_ptr<arrow::Array> null_array, WriterProperties* properties,
-    size_t total) {
-  AddNulls(builder, chunks, null_array, properties, total);
-
-  if (total % properties->chunk_size != 0) {
-    chunks->emplace_back(BuildArray(builder));
-  }
-}
-
-// Adds falses to the array until its length == total
-void
-EvenOutArray(
-    ArrowArrays* chunks, std::shared_ptr<arrow::BooleanBuilder> builder,
-    WriterProperties* properties, size_t total) {
-  AddFalses(builder, chunks, properties, total);
-
-  if (total % properties->chunk_size != 0) {
-    chunks->emplace_back(BuildArray(builder));
-  }
-}
-
 // Adds nulls to the arrays until each length == total
 void
 EvenOutChunkBuilders(
@@ -786,332 +685,145 @@ EvenOutChunkBuilders(
 /* Functions for reordering edges into CSR format */
 /**************************************************/
 
-// Rearrange an array's entries to match up with those of mapping
-template <typename T, typename W>
-ArrowArrays
-RearrangeArray(
-    std::shared_ptr<T> builder,
-    const std::shared_ptr<arrow::ChunkedArray>& chunked_array,
-    const std::vector<size_t>& mapping, WriterProperties* properties) {
-  auto chunk_size = properties->chunk_size;
-  ArrowArrays chunks;
-  auto st = builder->Reserve(chunk_size);
-  if (!st.ok()) {
-    KATANA_LOG_FATAL(
-        "Error reserving space for arrow array: {}", st.ToString());
-  }
-  // cast and store array chunks for use in loop
-  std::vector<std::shared_ptr<W>> arrays;
-  for (auto chunk : chunked_array->chunks()) {
-    arrays.emplace_back(std::static_pointer_cast<W>(chunk));
-  }
-  std::shared_ptr<arrow::Array> null_array =
-      properties->null_arrays.first.find(builder->type()->id())->second;
-
-  // add non-null values
-  for (size_t i = 0; i < mapping.size(); i++) {
-    auto array = arrays[mapping[i] / chunk_size];
-
-    if (!array->IsNull(mapping[i] % chunk_size)) {
-      auto val = array->Value(mapping[i] % chunk_size);
-      AddTypedValue(val, builder, &chunks, null_array, properties, i);
-    }
-  }
-  EvenOutArray(&chunks, builder, null_array, properties, mapping.size());
-  return chunks;
-}
-
-// Rearrange an array's entries to match up with those of mapping
-ArrowArrays
-RearrangeArray(
-    std::shared_ptr<arrow::StringBuilder> builder,
-    const std::shared_ptr<arrow::ChunkedArray>& chunked_array,
-    const std::vector<size_t>& mapping, WriterProperties* properties) {
-  auto chunk_size = properties->chunk_size;
-  ArrowArrays chunks;
-  auto st = builder->Reserve(chunk_size);
-  if (!st.ok()) {
-    KATANA_LOG_FATAL(
-        "Error reserving space for arrow array: {}", st.ToString());
-  }
-  // cast and store array chunks for use in loop
-  std::vector<std::shared_ptr<arrow::StringArray>> arrays;
-  for (auto chunk : chunked_array->chunks()) {
-    arrays.emplace_back(std::static_pointer_cast<arrow::StringArray>(chunk));
-  }
-  std::shared_ptr<arrow::Array> null_array =
-      properties->null_arrays.first.find(builder->type()->id())->second;
-
-  // add non-null values
-  for (size_t i = 0; i < mapping.size(); i++) {
-    auto array = arrays[mapping[i] / chunk_size];
-
-    if (!array->IsNull(mapping[i] % chunk_size)) {
-      auto val = array->GetView(mapping[i] % chunk_size);
-      AddTypedValue(val, builder, &chunks, null_array, properties, i);
-    }
+// Appends row i, which is not null, of array to a builder of its type
+using RowAppender = arrow::Status (*)(
+    arrow::ArrayBuilder* builder, const arrow::Array& array, int64_t i);
+
+template <typename ArrowType>
+arrow::Status
+AppendRow(arrow::ArrayBuilder* builder, const arrow::Array& array, int64_t i) {
+  using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+  using BuilderType = typename arrow::TypeTraits<ArrowType>::BuilderType;
+  const auto& typed = static_cast<const ArrayType&>(array);
+  if constexpr (std::is_same_v<ArrowType, arrow::StringType>) {
+    return static_cast<BuilderType*>(builder)->Append(typed.GetView(i));
+  } else {
+    return static_cast<BuilderType*>(builder)->Append(typed.Value(i));
+  }
+}
+
+template <typename ArrowType>
+arrow::Status
+AppendListRow(
+    arrow::ArrayBuilder* builder, const arrow::Array& array, int64_t i) {
+  const auto& list = static_cast<const arrow::ListArray&>(array);
+  auto* list_builder = static_cast<arrow::ListBuilder*>(builder);
+  auto* value_builder = list_builder->value_builder();
+  const arrow::Array& values = *list.values();
+  arrow::Status st = list_builder->Append();
+  int32_t end = list.value_offset(i + 1);
+  for (int32_t v = list.value_offset(i); st.ok() && v < end; ++v) {
+    st = values.IsNull(v) ? value_builder->AppendNull()
+                          : AppendRow<ArrowType>(value_builder, values, v);
+  }
+  return st;
+}
+
+// The appender of rows of type, or nullptr if the type is not supported
+RowAppender
+GetRowAppender(const arrow::DataType& type) {
+  bool is_list = type.id() == arrow::Type::LIST;
+  auto id = type.id();
+  if (is_list) {
+    id = static_cast<const arrow::ListType&>(type).value_type()->id();
+  }
+  switch (id) {
+  case arrow::Type::STRING:
+    return is_list ? AppendListRow<arrow::StringType>
+                   : AppendRow<arrow::StringType>;
+  case arrow::Type::INT64:
+    return is_list ? AppendListRow<arrow::Int64Type>
+                   : AppendRow<arrow::Int64Type>;
+  case arrow::Type::INT32:
+    return is_list ? AppendListRow<arrow::Int32Type>
+                   : AppendRow<arrow::Int32Type>;
+  case arrow::Type::DOUBLE:
+    return is_list ? AppendListRow<arrow::DoubleType>
+                   : AppendRow<arrow::DoubleType>;
+  case arrow::Type::FLOAT:
+    return is_list ? AppendListRow<arrow::FloatType>
+                   : AppendRow<arrow::FloatType>;
+  case arrow::Type::BOOL:
+    return is_list ? AppendListRow<arrow::BooleanType>
+                   : AppendRow<arrow::BooleanType>;
+  case arrow::Type::TIMESTAMP:
+    return is_list ? AppendListRow<arrow::TimestampType>
+                   : AppendRow<arrow::TimestampType>;
+  case arrow::Type::UINT8:
+    return is_list ? AppendListRow<arrow::UInt8Type>
+                   : AppendRow<arrow::UInt8Type>;
+  default:
+    return nullptr;
   }
-  EvenOutArray(&chunks, builder, null_array, properties, mapping.size());
-  return chunks;
 }
 
-// Rearrange an array's entries to match up with those of mapping, for labels
-ArrowArrays
-RearrangeArray(
-    std::shared_ptr<arrow::BooleanBuilder> builder,
-    const std::shared_ptr<arrow::ChunkedArray>& chunked_array,
-    const std::vector<size_t>& mapping, WriterProperties* properties) {
-  auto chunk_size = properties->chunk_size;
-  ArrowArrays chunks;
-  auto st = builder->Reserve(chunk_size);
-  if (!st.ok()) {
-    KATANA_LOG_FATAL(
-        "Error reserving space for arrow array: {}", st.ToString());
-  }
-  // cast and store array chunks for use in loop
-  std::vector<std::shared_ptr<arrow::BooleanArray>> arrays;
-  for (auto chunk : chunked_array->chunks()) {
-    arrays.emplace_back(std::static_pointer_cast<arrow::BooleanArray>(chunk));
-  }
-
-  // add non-null values
-  for (size_t i = 0; i < mapping.size(); i++) {
-    auto val = arrays[mapping[i] / chunk_size]->Value(mapping[i] % chunk_size);
-    if (val) {
-      AddLabelInternal(builder, &chunks, properties, i);
+// Gather rows mapping[begin, end) of column, whose chunks all hold
+// chunk_size rows but the last, into one array of the given type
+katana::Result<std::shared_ptr<arrow::Array>>
+GatherChunk(
+    const ArrowArrays& column, const std::shared_ptr<arrow::DataType>& type,
+    RowAppender append, const std::vector<size_t>& mapping, size_t begin,
+    size_t end, size_t chunk_size) {
+  std::unique_ptr<arrow::ArrayBuilder> builder;
+  KATANA_CHECKED(
+      arrow::MakeBuilder(arrow::default_memory_pool(), type, &builder));
+  KATANA_CHECKED(builder->Reserve(end - begin));
+  for (size_t i = begin; i < end; ++i) {
+    const arrow::Array& array = *column[mapping[i] / chunk_size];
+    int64_t row = mapping[i] % chunk_size;
+    if (array.IsNull(row)) {
+      KATANA_CHECKED(builder->AppendNull());
+    } else {
+      KATANA_CHECKED(append(builder.get(), array, row));
     }
   }
-  EvenOutArray(&chunks, builder, properties, mapping.size());
-  return chunks;
+  std::shared_ptr<arrow::Array> chunk;
+  KATANA_CHECKED(builder->Finish(&chunk));
+  return chunk;
 }
 
-// Rearrange a list array's entries to match up with those of mapping
-template <typename T, typename W>
-ArrowArrays
-RearrangeArray(
-    const std::shared_ptr<arrow::ListBuilder>& builder, T* type_builder,
-    const std::shared_ptr<arrow::ChunkedArray>& chunked_array,
+// Rearrange each column in a table so that row i of the result is row
+// mapping[i] of the column. The columns are cut into chunks of
+// properties->chunk_size rows, and every chunk of every column is gathered
+// in parallel straight into a builder of its final size.
+katana::Result<std::vector<ArrowArrays>>
+GatherTable(
+    const std::vector<ArrowArrays>& columns, const ArrowFields& schema,
     const std::vector<size_t>& mapping, WriterProperties* properties) {
-  auto chunk_size = properties->chunk_size;
-  ArrowArrays chunks;
-  auto st = builder->Reserve(chunk_size);
-  if (!st.ok()) {
-    KATANA_LOG_FATAL(
-        "Error reserving space for arrow array: {}", st.ToString());
-  }
-  // cast and store array chunks for use in loop
-  std::vector<std::shared_ptr<arrow::ListArray>> list_arrays;
-  std::vector<std::shared_ptr<W>> sub_arrays;
-  for (auto chunk : chunked_array->chunks()) {
-    auto array_temp = std::static_pointer_cast<arrow::ListArray>(chunk);
-    list_arrays.emplace_back(array_temp);
-    sub_arrays.emplace_back(std::static_pointer_cast<W>(array_temp->values()));
-  }
-  std::shared_ptr<arrow::Array> null_array =
-      properties->null_arrays.second.find(type_builder->type()->id())->second;
-
-  // add values
-  for (size_t i = 0; i < mapping.size(); i++) {
-    auto list_array = list_arrays[mapping[i] / chunk_size];
-    auto sub_array = sub_arrays[mapping[i] / chunk_size];
-    auto index = mapping[i] % chunk_size;
-    if (!list_array->IsNull(index)) {
-      AddArray(
-          list_array, sub_array, index, builder, type_builder, &chunks,
-          null_array, properties, i);
+  size_t chunk_size = properties->chunk_size;
+  size_t num_chunks = (mapping.size() + chunk_size - 1) / chunk_size;
+
+  std::vector<RowAppender> appenders(columns.size());
+  for (size_t n = 0; n < columns.size(); ++n) {
+    appenders[n] = GetRowAppender(*schema[n]->type());
+    if (appenders[n] == nullptr) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "unsupported type of column {}: {}",
+          schema[n]->name(), schema[n]->type()->ToString());
     }
   }
-  EvenOutArray(&chunks, builder, null_array, properties, mapping.size());
-  return chunks;
-}
-
-// Rearrange a list array's entries to match up with those of mapping
-ArrowArrays
-RearrangeListArray(
-    const std::shared_ptr<arrow::ChunkedArray>& list_chunked_array,
-    const std::vector<size_t>& mapping, WriterProperties* properties) {
-  auto* pool = arrow::default_memory_pool();
-  ArrowArrays chunks;
-  auto list_type =
-      std::static_pointer_cast<arrow::BaseListType>(list_chunked_array->type())
-          ->value_type();
-
-  switch (list_type->id()) {
-  case arrow::Type::STRING: {
-    auto builder = std::make_shared<arrow::ListBuilder>(
-        pool, std::make_shared<arrow::StringBuilder>());
-    auto sb = static_cast<arrow::StringBuilder*>(builder->value_builder());
-    chunks = RearrangeArray<arrow::StringBuilder, arrow::StringArray>(
-        builder, sb, list_chunked_array, mapping, properties);
-    break;
-  }
-  case arrow::Type::INT64: {
-    auto builder = std::make_shared<arrow::ListBuilder>(
-        pool, std::make_shared<arrow::Int64Builder>());
-    auto lb = static_cast<arrow::Int64Builder*>(builder->value_builder());
-    chunks = RearrangeArray<arrow::Int64Builder, arrow::Int64Array>(
-        builder, lb, list_chunked_array, mapping, properties);
-    break;
-  }
-  case arrow::Type::INT32: {
-    auto builder = std::make_shared<arrow::ListBuilder>(
-        pool, std::make_shared<arrow::Int32Builder>());
-    auto ib = static_cast<arrow::Int32Builder*>(builder->value_builder());
-    chunks = RearrangeArray<arrow::Int32Builder, arrow::Int32Array>(
-        builder, ib, list_chunked_array, mapping, properties);
-    break;
-  }
-  case arrow::Type::DOUBLE: {
-    auto builder = std::make_shared<arrow::ListBuilder>(
-        pool, std::make_shared<arrow::DoubleBuilder>());
-    auto db = static_cast<arrow::DoubleBuilder*>(builder->value_builder());
-    chunks = RearrangeArray<arrow::DoubleBuilder, arrow::DoubleArray>(
-        builder, db, list_chunked_array, mapping, properties);
-    break;
-  }
-  case arrow::Type::FLOAT: {
-    auto builder = std::make_shared<arrow::ListBuilder>(
-        pool, std::make_shared<arrow::FloatBuilder>());
-    auto fb = static_cast<arrow::FloatBuilder*>(builder->value_builder());
-    chunks = RearrangeArray<arrow::FloatBuilder, arrow::FloatArray>(
-        builder, fb, list_chunked_array, mapping, properties);
-    break;
-  }
-  case arrow::Type::BOOL: {
-    auto builder = std::make_shared<arrow::ListBuilder>(
-        pool, std::make_shared<arrow::BooleanBuilder>());
-    auto bb = static_cast<arrow::BooleanBuilder*>(builder->value_builder());
-    chunks = RearrangeArray<arrow::BooleanBuilder, arrow::BooleanArray>(
-        builder, bb, list_chunked_array, mapping, properties);
-    break;
-  }
-  case arrow::Type::TIMESTAMP: {
-    auto builder = std::make_shared<arrow::ListBuilder>(
-        pool, std::make_shared<arrow::TimestampBuilder>(list_type, pool));
-    auto tb = static_cast<arrow::TimestampBuilder*>(builder->value_builder());
-    chunks = RearrangeArray<arrow::TimestampBuilder, arrow::TimestampArray>(
-        builder, tb, list_chunked_array, mapping, properties);
-    break;
-  }
-  case arrow::Type::UINT8: {
-    auto builder = std::make_shared<arrow::ListBuilder>(
-        pool, std::make_shared<arrow::UInt8Builder>());
-    auto bb = static_cast<arrow::UInt8Builder*>(builder->value_builder());
-    chunks = RearrangeArray<arrow::UInt8Builder, arrow::UInt8Array>(
-        builder, bb, list_chunked_array, mapping, properties);
-    break;
-  }
-  default: {
-    KATANA_LOG_FATAL(
-        "Unsupported arrow array type passed to RearrangeListArray: {}",
-        list_type);
-  }
-  }
-  return chunks;
-}
-
-// Rearrange each column in a table so that their entries match up with those of
-// mapping
-std::vector<ArrowArrays>
-RearrangeTable(
-    const ChunkedArrays& initial, const std::vector<size_t>& mapping,
-    WriterProperties* properties) {
-  std::vector<ArrowArrays> rearranged;
-  rearranged.resize(initial.size());
 
+  std::vector<ArrowArrays> gathered(columns.size(), ArrowArrays(num_chunks));
+  katana::CombinedErrorInfo errors;
   katana::do_all(
-      katana::iterate(static_cast<size_t>(0), initial.size()),
-      [&](const size_t& n) {
-        auto array = initial[n];
-        auto arrayType = array->type()->id();
-        ArrowArrays ca;
-
-        switch (arrayType) {
-        case arrow::Type::STRING: {
-          auto sb = std::make_shared<arrow::StringBuilder>();
-          ca = RearrangeArray(sb, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::INT64: {
-          auto lb = std::make_shared<arrow::Int64Builder>();
-          ca = RearrangeArray<arrow::Int64Builder, arrow::Int64Array>(
-              lb, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::INT32: {
-          auto ib = std::make_shared<arrow::Int32Builder>();
-          ca = RearrangeArray<arrow::Int32Builder, arrow::Int32Array>(
-              ib, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::DOUBLE: {
-          auto db = std::make_shared<arrow::DoubleBuilder>();
-          ca = RearrangeArray<arrow::DoubleBuilder, arrow::DoubleArray>(
-              db, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::FLOAT: {
-          auto fb = std::make_shared<arrow::FloatBuilder>();
-          ca = RearrangeArray<arrow::FloatBuilder, arrow::FloatArray>(
-              fb, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::BOOL: {
-          auto bb = std::make_shared<arrow::BooleanBuilder>();
-          ca = RearrangeArray<arrow::BooleanBuilder, arrow::BooleanArray>(
-              bb, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::TIMESTAMP: {
-          auto tb = std::make_shared<arrow::TimestampBuilder>(
-              array->type(), arrow::default_memory_pool());
-          ca = RearrangeArray<arrow::TimestampBuilder, arrow::TimestampArray>(
-              tb, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::UINT8: {
-          auto bb = std::make_shared<arrow::UInt8Builder>();
-          ca = RearrangeArray<arrow::UInt8Builder, arrow::UInt8Array>(
-              bb, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::LIST: {
-          ca = RearrangeListArray(array, mapping, properties);
-          break;
-        }
-        default: {
-          KATANA_LOG_FATAL(
-              "Unsupported arrow array type passed to RearrangeTable: {}",
-              arrayType);
-        }
-        }
-        rearranged[n] = ca;
-        array.reset();
-      });
-  return rearranged;
-}
-
-// Rearrange each column in a table so that their entries match up with those of
-// mapping, for labels
-std::vector<ArrowArrays>
-RearrangeTypeTable(
-    const ChunkedArrays& initial, const std::vector<size_t>& mapping,
-    WriterProperties* properties) {
-  std::vector<ArrowArrays> rearranged;
-  rearranged.resize(initial.size());
-
-  katana::do_all(
-      katana::iterate(static_cast<size_t>(0), initial.size()),
-      [&](const size_t& n) {
-        auto array = initial[n];
-
-        auto bb = std::make_shared<arrow::BooleanBuilder>();
-        auto ca = RearrangeArray(bb, array, mapping, properties);
-        rearranged[n] = ca;
-
-        array.reset();
-      });
-  return rearranged;
+      katana::iterate(size_t{0}, columns.size() * num_chunks),
+      [&](size_t task) {
+        size_t n = task / num_chunks;
+        size_t c = task % num_chunks;
+        size_t begin = c * chunk_size;
+        size_t end = std::min(begin + chunk_size, mapping.size());
+        gathered[n][c] = KATANA_COMBINE_ERROR_CONTEXT(
+            errors,
+            GatherChunk(
+                columns[n], schema[n]->type(), appenders[n], mapping, begin,
+                end, chunk_size),
+            "gathering column {}", schema[n]->name());
+      },
+      katana::steal(), katana::no_stats());
+  if (auto error = errors()) {
+    return katana::ErrorInfo(error.value());
+  }
+  return gathered;
 }
 
 template <typename BuilderType, typename ValueType>
@@ -1148,6 +860,98 @@ BuildImportVec(
   return array;
 }
 
+
+/******************************************************/
+/* Functions for merging the shards of a sharded build */
+/******************************************************/
+
+// length nulls of type, in chunks of at most chunk_size
+ArrowArrays
+NullChunks(
+    const std::shared_ptr<arrow::DataType>& type, size_t length,
+    size_t chunk_size) {
+  ArrowArrays chunks;
+  for (size_t start = 0; start < length; start += chunk_size) {
+    auto res =
+        arrow::MakeArrayOfNull(type, std::min(chunk_size, length - start));
+    if (!res.ok()) {
+      KATANA_LOG_FATAL("Error building null array: {}", res.status());
+    }
+    chunks.emplace_back(res.ValueOrDie());
+  }
+  return chunks;
+}
+
+// length falses, in chunks of at most properties->chunk_size
+ArrowArrays
+FalseChunks(size_t length, WriterProperties* properties) {
+  ArrowArrays chunks;
+  for (size_t start = 0; start < length; start += properties->chunk_size) {
+    chunks.emplace_back(properties->false_array->Slice(
+        0, std::min(properties->chunk_size, length - start)));
+  }
+  return chunks;
+}
+
+struct MergedColumns {
+  ArrowFields schema;
+  std::vector<ArrowArrays> chunks;
+};
+
+// Concatenate the columns of the shard tables states, with lengths[s] rows
+// in shard s, into columns over every shard followed by num_extra rows.
+// Columns are matched by name, in order of first appearance, and
+// fill(type, length) provides the rows a shard has no column for.
+template <typename State, typename Fill>
+katana::Result<MergedColumns>
+MergeColumns(
+    const std::vector<State*>& states, const std::vector<size_t>& lengths,
+    size_t num_extra, const Fill& fill) {
+  constexpr size_t kMissing = std::numeric_limits<size_t>::max();
+  MergedColumns merged;
+  std::unordered_map<std::string, size_t> columns;
+  // shard_columns[c][s] is the index of column c in shard s
+  std::vector<std::vector<size_t>> shard_columns;
+  for (size_t s = 0; s < states.size(); ++s) {
+    const ArrowFields& schema = states[s]->schema;
+    for (size_t i = 0; i < schema.size(); ++i) {
+      auto [it, inserted] =
+          columns.emplace(schema[i]->name(), merged.schema.size());
+      if (inserted) {
+        merged.schema.emplace_back(schema[i]);
+        shard_columns.emplace_back(states.size(), kMissing);
+      } else if (!merged.schema[it->second]->type()->Equals(
+                     schema[i]->type())) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "shards disagree on the type of {}: {} and {}", schema[i]->name(),
+            merged.schema[it->second]->type()->ToString(),
+            schema[i]->type()->ToString());
+      }
+      shard_columns[it->second][s] = i;
+    }
+  }
+
+  merged.chunks.resize(merged.schema.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, merged.schema.size()),
+      [&](size_t c) {
+        const auto& type = merged.schema[c]->type();
+        ArrowArrays& out = merged.chunks[c];
+        for (size_t s = 0; s < states.size(); ++s) {
+          ArrowArrays shard_chunks =
+              shard_columns[c][s] == kMissing
+                  ? fill(type, lengths[s])
+                  : states[s]->chunks[shard_columns[c][s]];
+          out.insert(out.end(), shard_chunks.begin(), shard_chunks.end());
+        }
+        ArrowArrays extra = fill(type, num_extra);
+        out.insert(out.end(), extra.begin(), extra.end());
+      },
+      katana::no_stats());
+  return katana::MakeResult(std::move(merged));
+}
+
 }  // end of unnamed namespace
 
 katana::PropertyGraphBuilder::PropertyGraphBuilder(size_t chunk_size)
@@ -1560,6 +1364,31 @@ katana::PropertyGraphBuilder::AddBuilder(const PropertyKey& key) {
   return index;
 }
 
+void
+katana::PropertyGraphBuilder::ApplySchema(const ImportSchema& schema) {
+  for (const PropertyKey& key : schema.keys) {
+    PropertiesState* properties =
+        key.for_node ? &node_properties_ : &edge_properties_;
+    if (properties->keys.find(key.id) == properties->keys.end()) {
+      this->AddBuilder(key);
+    }
+  }
+  for (const LabelRule& rule : schema.labels) {
+    LabelsState* labels = rule.for_node ? &node_labels_ : &edge_types_;
+    if (labels->keys.find(rule.id) == labels->keys.end()) {
+      this->AddLabelBuilder(rule);
+    }
+  }
+}
+
+void
+katana::PropertyGraphBuilder::Reserve(size_t num_nodes, size_t num_edges) {
+  topology_builder_.node_indexes.reserve(num_nodes);
+  topology_builder_.out_indices.reserve(num_nodes);
+  topology_builder_.sources.reserve(num_edges);
+  topology_builder_.destinations.reserve(num_edges);
+}
+
 /*************************************************/
 /* Functions for adding values to arrow builders */
 /*************************************************/
@@ -1661,7 +1490,7 @@ katana::PropertyGraphBuilder::ResolveIntermediateIDs() {
 }
 
 // Build CSR format and rearrange edge tables to correspond to the CSR
-katana::GraphComponent
+katana::Result<katana::GraphComponent>
 katana::PropertyGraphBuilder::BuildFinalEdges(bool verbose) {
   katana::ParallelSTL::partial_sum(
       topology_builder_.out_indices.begin(),
@@ -1680,13 +1509,11 @@ katana::PropertyGraphBuilder::BuildFinalEdges(bool verbose) {
     edge_mapping[edgeID] = i;
   }
 
-  auto initial_edges = BuildChunks(&edge_properties_.chunks);
-  auto initial_types = BuildChunks(&edge_types_.chunks);
-
-  auto final_edge_builders =
-      RearrangeTable(initial_edges, edge_mapping, &properties_);
-  auto final_type_builders =
-      RearrangeTypeTable(initial_types, edge_mapping, &properties_);
+  auto final_edge_builders = KATANA_CHECKED(GatherTable(
+      edge_properties_.chunks, edge_properties_.schema, edge_mapping,
+      &properties_));
+  auto final_type_builders = KATANA_CHECKED(GatherTable(
+      edge_types_.chunks, edge_types_.schema, edge_mapping, &properties_));
 
   if (verbose) {
     std::cout << "Edge Properties Post:\n";
@@ -1741,7 +1568,7 @@ katana::PropertyGraphBuilder::Finish(bool verbose) {
   }
 
   // rearrange edges to match implicit edge IDs
-  auto edges_tables = this->BuildFinalEdges(verbose);
+  auto edges_tables = KATANA_CHECKED(this->BuildFinalEdges(verbose));
 
   if (verbose) {
     std::cout << "Finished topology and ordering edges\n";
@@ -1769,6 +1596,265 @@ katana::PropertyGraphBuilder::Finish(bool verbose) {
       nodes_tables, edges_tables, std::move(pg_topo)};
 }
 
+/*********************************/
+/* Functions for sharded builds  */
+/*********************************/
+
+katana::ShardedPropertyGraphBuilder::ShardedPropertyGraphBuilder(
+    size_t num_shards, size_t chunk_size)
+    : properties_(GetWriterProperties(chunk_size)) {
+  for (size_t i = 0; i < num_shards; ++i) {
+    shards_.emplace_back(std::make_unique<PropertyGraphBuilder>(chunk_size));
+  }
+}
+
+katana::Result<GraphComponents>
+katana::ShardedPropertyGraphBuilder::Finish(bool verbose) {
+  size_t num_shards = shards_.size();
+  size_t chunk_size = properties_.chunk_size;
+
+  // The nodes and edges of each shard follow those of the shards before it.
+  // Edge property tables are indexed by chunk, so edges are also numbered
+  // by position in the concatenated, chunk aligned, edge tables of the
+  // shards.
+  std::vector<size_t> node_offsets(num_shards + 1, 0);
+  std::vector<size_t> edge_offsets(num_shards + 1, 0);
+  std::vector<size_t> edge_chunk_offsets(num_shards + 1, 0);
+  for (size_t s = 0; s < num_shards; ++s) {
+    PropertyGraphBuilder& shard = *shards_[s];
+    const TopologyState& topology = shard.topology_builder_;
+    if (shard.building_node_ || shard.building_edge_ ||
+        topology.sources.size() != shard.edges_ ||
+        topology.destinations.size() != shard.edges_) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "shard {} has an unfinished node or edge or an edge without a "
+          "source or destination",
+          s);
+    }
+    EvenOutChunkBuilders(
+        &shard.node_properties_.builders, &shard.node_properties_.chunks,
+        &shard.properties_, shard.nodes_);
+    EvenOutChunkBuilders(
+        &shard.node_labels_.builders, &shard.node_labels_.chunks,
+        &shard.properties_, shard.nodes_);
+    EvenOutChunkBuilders(
+        &shard.edge_properties_.builders, &shard.edge_properties_.chunks,
+        &shard.properties_, shard.edges_);
+    EvenOutChunkBuilders(
+        &shard.edge_types_.builders, &shard.edge_types_.chunks,
+        &shard.properties_, shard.edges_);
+    node_offsets[s + 1] = node_offsets[s] + shard.nodes_;
+    edge_offsets[s + 1] = edge_offsets[s] + shard.edges_;
+    edge_chunk_offsets[s + 1] =
+        edge_chunk_offsets[s] + (shard.edges_ + chunk_size - 1) / chunk_size;
+  }
+  size_t num_shard_nodes = node_offsets[num_shards];
+  size_t num_edges = edge_offsets[num_shards];
+  auto shard_of_edge = [&](size_t e) {
+    return std::upper_bound(edge_offsets.begin(), edge_offsets.end(), e) -
+           edge_offsets.begin() - 1;
+  };
+
+  // Merge the node id maps of the shards into maps of partitions of the ids
+  // by hash, in parallel, keeping the first node with each id.
+  using IDMap = std::unordered_map<std::string_view, uint32_t>;
+  using IDEntries = std::vector<std::pair<std::string_view, uint32_t>>;
+  size_t num_partitions = 4 * katana::getActiveThreads();
+  auto partition_of = [num_partitions](std::string_view id) {
+    return std::hash<std::string_view>{}(id) % num_partitions;
+  };
+  std::vector<std::vector<IDEntries>> shard_partitions(num_shards);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_shards),
+      [&](size_t s) {
+        shard_partitions[s].resize(num_partitions);
+        const TopologyState& topology = shards_[s]->topology_builder_;
+        for (const auto& [id, index] : topology.node_indexes) {
+          shard_partitions[s][partition_of(id)].emplace_back(
+              id, static_cast<uint32_t>(node_offsets[s] + index));
+        }
+      },
+      katana::steal(), katana::no_stats());
+  std::vector<IDMap> partitions(num_partitions);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_partitions),
+      [&](size_t p) {
+        for (size_t s = 0; s < num_shards; ++s) {
+          for (const auto& entry : shard_partitions[s][p]) {
+            partitions[p].emplace(entry);
+          }
+          IDEntries().swap(shard_partitions[s][p]);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  // Resolve the endpoints of the edges. Ids that no shard has a node for
+  // become new nodes after those of the shards, in order of id.
+  constexpr uint32_t kUnresolved = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> sources(num_edges);
+  std::vector<uint32_t> destinations(num_edges);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t e) {
+        size_t s = shard_of_edge(e);
+        const TopologyState& topology = shards_[s]->topology_builder_;
+        size_t local = e - edge_offsets[s];
+        uint32_t src = topology.sources[local];
+        uint32_t dst = topology.destinations[local];
+        sources[e] = src == kUnresolved ? src : src + node_offsets[s];
+        destinations[e] = dst == kUnresolved ? dst : dst + node_offsets[s];
+      },
+      katana::no_stats());
+
+  // (edge, whether the id is of its source, id) for each unknown id
+  using Unknown = std::tuple<size_t, bool, std::string_view>;
+  std::vector<std::vector<Unknown>> shard_unknowns(num_shards);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_shards),
+      [&](size_t s) {
+        const TopologyState& topology = shards_[s]->topology_builder_;
+        auto resolve = [&](size_t local, const std::string& id, bool is_src) {
+          size_t e = edge_offsets[s] + local;
+          const IDMap& ids = partitions[partition_of(id)];
+          auto it = ids.find(id);
+          if (it == ids.end()) {
+            shard_unknowns[s].emplace_back(e, is_src, id);
+          } else {
+            (is_src ? sources : destinations)[e] = it->second;
+          }
+        };
+        for (const auto& [local, id] : topology.sources_intermediate) {
+          resolve(local, id, true);
+        }
+        for (const auto& [local, id] : topology.destinations_intermediate) {
+          resolve(local, id, false);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<std::string_view> unknown_ids;
+  for (const auto& unknowns : shard_unknowns) {
+    for (const auto& unknown : unknowns) {
+      unknown_ids.emplace_back(std::get<2>(unknown));
+    }
+  }
+  katana::ParallelSTL::sort(unknown_ids.begin(), unknown_ids.end());
+  unknown_ids.erase(
+      std::unique(unknown_ids.begin(), unknown_ids.end()), unknown_ids.end());
+  size_t num_nodes = num_shard_nodes + unknown_ids.size();
+  if (num_nodes > kUnresolved) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "too many nodes for 32-bit ids: {}",
+        num_nodes);
+  }
+  katana::do_all(
+      katana::iterate(size_t{0}, num_shards),
+      [&](size_t s) {
+        for (const auto& [e, is_src, id] : shard_unknowns[s]) {
+          auto node = num_shard_nodes +
+                      (std::lower_bound(
+                           unknown_ids.begin(), unknown_ids.end(), id) -
+                       unknown_ids.begin());
+          (is_src ? sources : destinations)[e] = node;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  // Build the CSR. A stable sort by source keeps the out-edges of each node
+  // in the order the shards added them, as a single builder does.
+  std::vector<uint64_t> out_indices(num_nodes, 0);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t e) {
+        __atomic_fetch_add(&out_indices[sources[e]], 1, __ATOMIC_RELAXED);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+
+  std::vector<size_t> order(num_edges);
+  katana::ParallelSTL::iota(order.begin(), order.end(), size_t{0});
+  katana::ParallelSTL::radix_sort(
+      order.begin(), order.end(), [&](size_t e) { return sources[e]; });
+
+  std::vector<uint32_t> out_dests(num_edges);
+  std::vector<size_t> edge_mapping(num_edges);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t i) {
+        size_t e = order[i];
+        size_t s = shard_of_edge(e);
+        out_dests[i] = destinations[e];
+        edge_mapping[i] =
+            edge_chunk_offsets[s] * chunk_size + (e - edge_offsets[s]);
+      },
+      katana::no_stats());
+  std::vector<size_t>().swap(order);
+
+  // Concatenate the tables of the shards, with the edge tables rearranged
+  // into CSR order.
+  std::vector<size_t> shard_nodes(num_shards);
+  std::vector<size_t> shard_edges(num_shards);
+  std::vector<PropertiesState*> node_properties(num_shards);
+  std::vector<LabelsState*> node_labels(num_shards);
+  std::vector<PropertiesState*> edge_properties(num_shards);
+  std::vector<LabelsState*> edge_types(num_shards);
+  for (size_t s = 0; s < num_shards; ++s) {
+    shard_nodes[s] = shards_[s]->nodes_;
+    shard_edges[s] = shards_[s]->edges_;
+    node_properties[s] = &shards_[s]->node_properties_;
+    node_labels[s] = &shards_[s]->node_labels_;
+    edge_properties[s] = &shards_[s]->edge_properties_;
+    edge_types[s] = &shards_[s]->edge_types_;
+  }
+  auto nulls = [chunk_size](const auto& type, size_t length) {
+    return NullChunks(type, length, chunk_size);
+  };
+  auto falses = [this](const auto&, size_t length) {
+    return FalseChunks(length, &properties_);
+  };
+  MergedColumns nodes = KATANA_CHECKED(
+      MergeColumns(node_properties, shard_nodes, unknown_ids.size(), nulls));
+  MergedColumns labels = KATANA_CHECKED(
+      MergeColumns(node_labels, shard_nodes, unknown_ids.size(), falses));
+  MergedColumns edges =
+      KATANA_CHECKED(MergeColumns(edge_properties, shard_edges, 0, nulls));
+  MergedColumns types =
+      KATANA_CHECKED(MergeColumns(edge_types, shard_edges, 0, falses));
+
+  GraphComponent nodes_tables{
+      BuildTable(&nodes.chunks, &nodes.schema),
+      BuildTable(&labels.chunks, &labels.schema)};
+  auto final_edges = KATANA_CHECKED(
+      GatherTable(edges.chunks, edges.schema, edge_mapping, &properties_));
+  auto final_types = KATANA_CHECKED(
+      GatherTable(types.chunks, types.schema, edge_mapping, &properties_));
+  GraphComponent edges_tables{
+      BuildTable(&final_edges, &edges.schema),
+      BuildTable(&final_types, &types.schema)};
+
+  katana::GraphTopology pg_topo(
+      out_indices.data(), out_indices.size(), out_dests.data(),
+      out_dests.size());
+
+  if (verbose) {
+    std::cout << "Finished merging " << num_shards << " shards\n";
+    std::cout << "Nodes: " << pg_topo.NumNodes() << " ("
+              << unknown_ids.size() << " placeholders)\n";
+    std::cout << "Node Properties: " << nodes_tables.properties->num_columns()
+              << "\n";
+    std::cout << "Node Labels: " << nodes_tables.labels->num_columns() << "\n";
+    std::cout << "Edges: " << pg_topo.NumEdges() << "\n";
+    std::cout << "Edge Properties: " << edges_tables.properties->num_columns()
+              << "\n";
+    std::cout << "Edge Types: " << edges_tables.labels->num_columns() << "\n";
+  }
+
+  return katana::GraphComponents{
+      nodes_tables, edges_tables, std::move(pg_topo)};
+}
+
 // NB: is_list is always initialized
 void
 ImportData::ValueFromArrowScalar(std::shared_ptr<arrow::Scalar> scalar) {
@@ -0,0 +1,304 @@
+#include "katana/BulkLoader.h"
+
+#include <limits>
+#include <optional>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+#include <arrow/csv/api.h>
+#include <arrow/io/api.h>
+#include <arrow/type_traits.h>
+
+#include "katana/EntityIndex.h"
+#include "katana/FileView.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/ParquetReader.h"
+#include "katana/TakeRows.h"
+#include "katana/Timer.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+constexpr Node kNotFound = std::numeric_limits<Node>::max();
+
+bool
+IsCsv(const katana::URI& uri) {
+  std::string name = uri.BaseName();
+  return name.size() >= 4 && name.compare(name.size() - 4, 4, ".csv") == 0;
+}
+
+/// Strings and binaries are stored as their large variants, as the
+/// ParquetReader returns them
+katana::Result<std::shared_ptr<arrow::Table>>
+Canonicalize(const std::shared_ptr<arrow::Table>& table) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i = 0; i < table->num_columns(); ++i) {
+    std::shared_ptr<arrow::Field> field = table->schema()->field(i);
+    std::shared_ptr<arrow::ChunkedArray> column = table->column(i);
+    std::shared_ptr<arrow::DataType> type;
+    if (field->type()->id() == arrow::Type::STRING) {
+      type = arrow::large_utf8();
+    } else if (field->type()->id() == arrow::Type::BINARY) {
+      type = arrow::large_binary();
+    }
+    if (type) {
+      arrow::Datum cast = KATANA_CHECKED(arrow::compute::Cast(column, type));
+      column = cast.chunked_array();
+      field = field->WithType(type);
+    }
+    fields.emplace_back(std::move(field));
+    columns.emplace_back(std::move(column));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadCsv(const katana::URI& uri) {
+  auto file = std::make_shared<katana::FileView>();
+  KATANA_CHECKED_CONTEXT(file->Bind(uri.string(), false), "opening {}", uri);
+  auto read_options = arrow::csv::ReadOptions::Defaults();
+  read_options.use_threads = true;
+  std::shared_ptr<arrow::csv::TableReader> reader =
+      KATANA_CHECKED(arrow::csv::TableReader::Make(
+          arrow::io::default_io_context(), file, read_options,
+          arrow::csv::ParseOptions::Defaults(),
+          arrow::csv::ConvertOptions::Defaults()));
+  std::shared_ptr<arrow::Table> table =
+      KATANA_CHECKED_CONTEXT(reader->Read(), "reading {}", uri);
+  return Canonicalize(table);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadTable(const katana::URI& uri) {
+  if (IsCsv(uri)) {
+    return ReadCsv(uri);
+  }
+  std::unique_ptr<katana::ParquetReader> reader =
+      KATANA_CHECKED(katana::ParquetReader::Make());
+  return reader->ReadTable(uri);
+}
+
+/// Read tables in parallel and concatenate them into one table of a single
+/// chunk
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadTables(const std::vector<katana::URI>& uris) {
+  if (uris.empty()) {
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "no tables");
+  }
+  std::vector<std::shared_ptr<arrow::Table>> tables(uris.size());
+  std::vector<std::optional<katana::CopyableErrorInfo>> errors(uris.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, uris.size()),
+      [&](size_t i) {
+        if (auto res = ReadTable(uris[i]); res) {
+          tables[i] = std::move(res.value());
+        } else {
+          errors[i] = res.error();
+        }
+      },
+      katana::steal(), katana::no_stats());
+  for (size_t i = 0; i < uris.size(); ++i) {
+    if (errors[i]) {
+      return errors[i]->WithContext("reading {}", uris[i]);
+    }
+  }
+
+  std::shared_ptr<arrow::Table> table = KATANA_CHECKED_CONTEXT(
+      arrow::ConcatenateTables(tables), "tables have different columns");
+  return KATANA_CHECKED(table->CombineChunks());
+}
+
+/// The external ids of the rows of a table, as int64s or large strings
+katana::Result<std::shared_ptr<arrow::Array>>
+GetKeys(const arrow::Table& table, const std::string& column_name) {
+  std::shared_ptr<arrow::ChunkedArray> column =
+      table.GetColumnByName(column_name);
+  if (!column) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no column {}", column_name);
+  }
+  // tables without rows have no chunks
+  std::shared_ptr<arrow::Array> keys =
+      column->num_chunks() == 1
+          ? column->chunk(0)
+          : KATANA_CHECKED(arrow::MakeArrayOfNull(column->type(), 0));
+  const arrow::DataType& type = *keys->type();
+  if (type.id() == arrow::Type::LARGE_STRING) {
+    return keys;
+  }
+  if (!arrow::is_integer(type.id())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "ids must be integers or strings; {} has type {}", column_name,
+        type.ToString());
+  }
+  arrow::Datum cast = KATANA_CHECKED_CONTEXT(
+      arrow::compute::Cast(keys, arrow::int64()), "column {}", column_name);
+  return cast.make_array();
+}
+
+/// An index from external ids to the nodes with them
+class NodeIdIndex {
+public:
+  static katana::Result<NodeIdIndex> Make(
+      const std::string& column_name, std::shared_ptr<arrow::Array> ids) {
+    bool strings = ids->type_id() == arrow::Type::LARGE_STRING;
+    NodeIdIndex index;
+    index.index_ = KATANA_CHECKED(katana::MakeTypedEntityIndex<Node>(
+        column_name, ids->length(), ids,
+        strings ? katana::EntityIndexKind::kHash
+                : katana::EntityIndexKind::kSorted));
+    KATANA_CHECKED(index.index_->BuildFromProperty());
+    return katana::MakeResult(std::move(index));
+  }
+
+  /// The first node with each of keys, which must have the type of the
+  /// indexed ids, or kNotFound
+  katana::Result<katana::NUMAArray<Node>> Find(
+      const arrow::Array& keys) const {
+    if (keys.type_id() == arrow::Type::LARGE_STRING) {
+      return static_cast<const katana::StringHashEntityIndex<Node>&>(*index_)
+          .FindBatch(keys);
+    }
+    auto& index =
+        static_cast<katana::PrimitiveEntityIndex<Node, int64_t>&>(*index_);
+    const auto& typed = static_cast<const arrow::Int64Array&>(keys);
+    katana::NUMAArray<Node> nodes;
+    nodes.allocateBlocked(keys.length());
+    katana::do_all(
+        katana::iterate(size_t{0}, nodes.size()),
+        [&](size_t i) {
+          auto it = typed.IsNull(i) ? index.end() : index.Find(typed.Value(i));
+          nodes[i] = it == index.end() ? kNotFound : *it;
+        },
+        katana::no_stats());
+    return katana::MakeResult(std::move(nodes));
+  }
+
+private:
+  std::unique_ptr<katana::EntityIndex<Node>> index_;
+};
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::LoadGraphFromTables(
+    const std::vector<URI>& node_tables, const std::vector<URI>& edge_tables,
+    const BulkLoadOptions& options, TxnContext* txn_ctx) {
+  katana::Timer timer;
+  timer.start();
+
+  std::shared_ptr<arrow::Table> nodes =
+      KATANA_CHECKED_CONTEXT(ReadTables(node_tables), "node tables");
+  std::shared_ptr<arrow::Table> edges =
+      KATANA_CHECKED_CONTEXT(ReadTables(edge_tables), "edge tables");
+  uint64_t num_nodes = nodes->num_rows();
+  if (num_nodes >= kNotFound) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "too many nodes for 32-bit ids: {}",
+        num_nodes);
+  }
+
+  std::shared_ptr<arrow::Array> ids =
+      KATANA_CHECKED(GetKeys(*nodes, options.node_id_column));
+  NodeIdIndex index =
+      KATANA_CHECKED(NodeIdIndex::Make(options.node_id_column, ids));
+  std::shared_ptr<arrow::Array> source_keys =
+      KATANA_CHECKED(GetKeys(*edges, options.source_column));
+  std::shared_ptr<arrow::Array> destination_keys =
+      KATANA_CHECKED(GetKeys(*edges, options.destination_column));
+  if (!source_keys->type()->Equals(ids->type()) ||
+      !destination_keys->type()->Equals(ids->type())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edge endpoints and node ids must both be integers or strings");
+  }
+  NUMAArray<Node> sources = KATANA_CHECKED(index.Find(*source_keys));
+  NUMAArray<Node> destinations = KATANA_CHECKED(index.Find(*destination_keys));
+
+  // The rows of the edges to keep, in table order
+  uint64_t num_rows = edges->num_rows();
+  NUMAArray<uint64_t> kept;
+  kept.allocateBlocked(num_rows + 1);
+  kept[0] = 0;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_rows),
+      [&](uint64_t row) {
+        kept[row + 1] =
+            sources[row] != kNotFound && destinations[row] != kNotFound;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(kept.begin(), kept.end(), kept.begin());
+  uint64_t num_edges = kept[num_rows];
+  if (num_edges != num_rows && !options.drop_dangling_edges) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "{} of {} edges have an endpoint that is not a node",
+        num_rows - num_edges, num_rows);
+  }
+  NUMAArray<uint64_t> rows;
+  rows.allocateBlocked(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_rows),
+      [&](uint64_t row) {
+        if (kept[row] != kept[row + 1]) {
+          rows[kept[row]] = row;
+        }
+      },
+      katana::no_stats());
+
+  // Counting sort the edges by source: a stable radix sort of the rows by
+  // source keeps the out-edges of each node in table order.
+  NUMAArray<Edge> adj_indices;
+  adj_indices.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(adj_indices.begin(), adj_indices.end(), Edge{0});
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        __atomic_fetch_add(
+            &adj_indices[sources[rows[e]]], 1, __ATOMIC_RELAXED);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+  katana::ParallelSTL::radix_sort(
+      rows.begin(), rows.end(), [&](uint64_t row) { return sources[row]; });
+  NUMAArray<Node> dests;
+  dests.allocateBlocked(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { dests[e] = destinations[rows[e]]; },
+      katana::no_stats());
+
+  // Edge properties, in CSR order
+  std::vector<std::string> endpoint_columns{
+      options.source_column, options.destination_column};
+  for (const std::string& name : endpoint_columns) {
+    int i = edges->schema()->GetFieldIndex(name);
+    if (i >= 0) {
+      edges = KATANA_CHECKED(edges->RemoveColumn(i));
+    }
+  }
+  if (edges->num_columns() > 0) {
+    edges = KATANA_CHECKED(katana::TakeRows(edges, rows));
+  }
+
+  std::unique_ptr<PropertyGraph> pg = KATANA_CHECKED(PropertyGraph::Make(
+      GraphTopology(adj_indices.data(), num_nodes, dests.data(), num_edges)));
+  KATANA_CHECKED(pg->AddNodeProperties(nodes, txn_ctx));
+  if (edges->num_columns() > 0) {
+    KATANA_CHECKED(pg->AddEdgeProperties(edges, txn_ctx));
+  }
+
+  timer.stop();
+  KATANA_LOG_VERBOSE(
+      "loaded {} nodes and {} edges from {} tables in {} ms", num_nodes,
+      num_edges, node_tables.size() + edge_tables.size(), timer.get());
+  return MakeResult(std::move(pg));
+}
@@ -0,0 +1,271 @@
+#include "katana/DynamicTopology.h"
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+
+namespace {
+
+constexpr uint64_t kMinCapacity = 4;
+
+/// room for half again as many edges as degree
+uint64_t
+SlackCapacity(uint64_t degree) {
+  return std::max(kMinCapacity, degree + degree / 2);
+}
+
+/// \returns where each run of deltas with the same src starts in deltas,
+/// followed by deltas.size()
+template <typename Delta>
+std::vector<size_t>
+GroupBySrc(const std::vector<Delta>& deltas) {
+  std::vector<size_t> group_begin;
+  for (size_t i = 0; i < deltas.size(); ++i) {
+    if (i == 0 || deltas[i].src != deltas[i - 1].src) {
+      group_begin.emplace_back(i);
+    }
+  }
+  group_begin.emplace_back(deltas.size());
+  return group_begin;
+}
+
+}  // namespace
+
+katana::DynamicTopology
+katana::DynamicTopology::Make(const GraphTopology& csr) noexcept {
+  DynamicTopology topo;
+  uint64_t num_nodes = csr.NumNodes();
+  topo.segments_.allocateInterleaved(num_nodes);
+  topo.node_prop_indices_.allocateInterleaved(num_nodes);
+
+  NUMAArray<Edge> ends;
+  ends.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(csr.Nodes()),
+      [&](Node n) { ends[n] = SlackCapacity(csr.OutDegree(n)); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(ends.begin(), ends.end(), ends.begin());
+
+  uint64_t pool_size = num_nodes == 0 ? 0 : ends[num_nodes - 1];
+  topo.dests_.resize(pool_size);
+  topo.edge_prop_indices_.resize(pool_size);
+
+  katana::do_all(
+      katana::iterate(csr.Nodes()),
+      [&](Node n) {
+        uint64_t capacity = SlackCapacity(csr.OutDegree(n));
+        Segment& segment = topo.segments_[n];
+        segment.begin = ends[n] - capacity;
+        segment.degree = csr.OutDegree(n);
+        segment.capacity = capacity;
+        Edge slot = segment.begin;
+        for (Edge e : csr.OutEdges(n)) {
+          topo.dests_[slot] = csr.OutEdgeDst(e);
+          topo.edge_prop_indices_[slot] =
+              csr.GetEdgePropertyIndexFromOutEdge(e);
+          ++slot;
+        }
+        topo.node_prop_indices_[n] = csr.GetNodePropertyIndex(n);
+      },
+      katana::steal(), katana::no_stats());
+
+  topo.num_edges_ = csr.NumEdges();
+  return topo;
+}
+
+void
+katana::DynamicTopology::InsertEdges(
+    const std::vector<EdgeDeltas::Insertion>& edges) noexcept {
+  if (edges.empty()) {
+    return;
+  }
+
+  std::vector<EdgeDeltas::Insertion> sorted = edges;
+  std::stable_sort(
+      sorted.begin(), sorted.end(),
+      [](const auto& a, const auto& b) { return a.src < b.src; });
+  std::vector<size_t> group_begin = GroupBySrc(sorted);
+  size_t num_groups = group_begin.size() - 1;
+
+  // first fill segments that have room and size the ones that do not
+  std::vector<uint64_t> new_capacity(num_groups, 0);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_groups),
+      [&](size_t g) {
+        Segment& segment = segments_[sorted[group_begin[g]].src];
+        uint64_t count = group_begin[g + 1] - group_begin[g];
+        uint64_t degree = segment.degree + count;
+        if (degree > segment.capacity) {
+          new_capacity[g] =
+              std::max<uint64_t>(2 * segment.capacity, SlackCapacity(degree));
+          return;
+        }
+        Edge slot = segment.begin + segment.degree;
+        for (size_t i = group_begin[g]; i < group_begin[g + 1]; ++i, ++slot) {
+          dests_[slot] = sorted[i].dst;
+          edge_prop_indices_[slot] = sorted[i].prop_index;
+        }
+        segment.degree = degree;
+      },
+      katana::steal(), katana::no_stats());
+
+  // then move the others to the end of the pool
+  std::vector<Edge> new_begin(num_groups, 0);
+  Edge pool_end = dests_.size();
+  for (size_t g = 0; g < num_groups; ++g) {
+    if (new_capacity[g] == 0) {
+      continue;
+    }
+    new_begin[g] = pool_end;
+    pool_end += new_capacity[g];
+    num_abandoned_slots_ += segments_[sorted[group_begin[g]].src].capacity;
+  }
+  dests_.resize(pool_end);
+  edge_prop_indices_.resize(pool_end);
+
+  katana::do_all(
+      katana::iterate(size_t{0}, num_groups),
+      [&](size_t g) {
+        if (new_capacity[g] == 0) {
+          return;
+        }
+        Segment& segment = segments_[sorted[group_begin[g]].src];
+        Edge slot = new_begin[g];
+        std::copy_n(dests_.begin() + segment.begin, segment.degree,
+                    dests_.begin() + slot);
+        std::copy_n(edge_prop_indices_.begin() + segment.begin, segment.degree,
+                    edge_prop_indices_.begin() + slot);
+        slot += segment.degree;
+        for (size_t i = group_begin[g]; i < group_begin[g + 1]; ++i, ++slot) {
+          dests_[slot] = sorted[i].dst;
+          edge_prop_indices_[slot] = sorted[i].prop_index;
+        }
+        segment.begin = new_begin[g];
+        segment.degree = slot - new_begin[g];
+        segment.capacity = new_capacity[g];
+      },
+      katana::steal(), katana::no_stats());
+
+  num_edges_ += edges.size();
+  if (num_abandoned_slots_ > std::max(num_edges_, NumNodes() * kMinCapacity)) {
+    Repack();
+  }
+}
+
+void
+katana::DynamicTopology::DeleteEdges(
+    const std::vector<EdgeDeltas::Deletion>& edges) noexcept {
+  if (edges.empty()) {
+    return;
+  }
+
+  std::vector<EdgeDeltas::Deletion> sorted = edges;
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+    return std::tie(a.src, a.dst) < std::tie(b.src, b.dst);
+  });
+  std::vector<size_t> group_begin = GroupBySrc(sorted);
+  size_t num_groups = group_begin.size() - 1;
+
+  katana::PerThreadStorage<uint64_t> removed;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_groups),
+      [&](size_t g) {
+        auto dels_begin = sorted.begin() + group_begin[g];
+        auto dels_end = sorted.begin() + group_begin[g + 1];
+        Node src = dels_begin->src;
+        Segment& segment = segments_[src];
+        Edge kept = segment.begin;
+        for (Edge e = segment.begin; e < segment.begin + segment.degree; ++e) {
+          bool deleted = std::binary_search(
+              dels_begin, dels_end, EdgeDeltas::Deletion{src, dests_[e]},
+              [](const auto& a, const auto& b) { return a.dst < b.dst; });
+          if (deleted) {
+            continue;
+          }
+          dests_[kept] = dests_[e];
+          edge_prop_indices_[kept] = edge_prop_indices_[e];
+          ++kept;
+        }
+        *removed.getLocal() += segment.begin + segment.degree - kept;
+        segment.degree = kept - segment.begin;
+      },
+      katana::steal(), katana::no_stats());
+
+  for (unsigned i = 0; i < katana::getActiveThreads(); ++i) {
+    num_edges_ -= *removed.getRemote(i);
+  }
+}
+
+void
+katana::DynamicTopology::Repack() noexcept {
+  uint64_t num_nodes = NumNodes();
+  NUMAArray<Edge> ends;
+  ends.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(Nodes()),
+      [&](Node n) { ends[n] = SlackCapacity(segments_[n].degree); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(ends.begin(), ends.end(), ends.begin());
+
+  uint64_t pool_size = num_nodes == 0 ? 0 : ends[num_nodes - 1];
+  std::vector<Node> dests(pool_size);
+  std::vector<PropertyIndex> edge_prop_indices(pool_size);
+  katana::do_all(
+      katana::iterate(Nodes()),
+      [&](Node n) {
+        Segment& segment = segments_[n];
+        uint64_t capacity = SlackCapacity(segment.degree);
+        Edge begin = ends[n] - capacity;
+        std::copy_n(dests_.begin() + segment.begin, segment.degree,
+                    dests.begin() + begin);
+        std::copy_n(edge_prop_indices_.begin() + segment.begin, segment.degree,
+                    edge_prop_indices.begin() + begin);
+        segment.begin = begin;
+        segment.capacity = capacity;
+      },
+      katana::steal(), katana::no_stats());
+
+  dests_ = std::move(dests);
+  edge_prop_indices_ = std::move(edge_prop_indices);
+  num_abandoned_slots_ = 0;
+}
+
+katana::GraphTopology
+katana::DynamicTopology::ToCSR() const noexcept {
+  uint64_t num_nodes = NumNodes();
+  AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(Nodes()),
+      [&](Node n) { adj_indices[n] = segments_[n].degree; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  EdgeDestVec dests;
+  PropIndexVec edge_prop_indices;
+  PropIndexVec node_prop_indices;
+  dests.allocateInterleaved(num_edges_);
+  edge_prop_indices.allocateInterleaved(num_edges_);
+  node_prop_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(Nodes()),
+      [&](Node n) {
+        const Segment& segment = segments_[n];
+        Edge begin = n == 0 ? 0 : adj_indices[n - 1];
+        std::copy_n(dests_.begin() + segment.begin, segment.degree,
+                    dests.begin() + begin);
+        std::copy_n(edge_prop_indices_.begin() + segment.begin, segment.degree,
+                    edge_prop_indices.begin() + begin);
+        node_prop_indices[n] = node_prop_indices_[n];
+      },
+      katana::steal(), katana::no_stats());
+
+  return GraphTopology(
+      std::move(adj_indices), std::move(dests), std::move(edge_prop_indices),
+      std::move(node_prop_indices));
+}
@@ -1,6 +1,26 @@
 #include "katana/EntityIndex.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
+#include "katana/Range.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
 
 namespace katana {
 
@@ -9,9 +29,22 @@ template <typename node_or_edge>
 Result<std::unique_ptr<EntityIndex<node_or_edge>>>
 MakeTypedEntityIndex(
     const std::string& property_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property) {
+    std::shared_ptr<arrow::Array> property, EntityIndexKind kind) {
   std::unique_ptr<EntityIndex<node_or_edge>> index;
 
+  if (kind == EntityIndexKind::kHash) {
+    if (property->type_id() != arrow::Type::LARGE_STRING) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "Hash indexes are only supported for strings, not {}",
+          property->type()->ToString());
+    }
+    index = std::make_unique<StringHashEntityIndex<node_or_edge>>(
+        property_name, num_entities, property);
+    return Result<std::unique_ptr<EntityIndex<node_or_edge>>>(
+        std::move(index));
+  }
+
   switch (property->type_id()) {
   case arrow::Type::BOOL:
     index = std::make_unique<PrimitiveEntityIndex<node_or_edge, bool>>(
@@ -59,6 +92,284 @@ MakeTypedEntityIndex(
   return Result<std::unique_ptr<EntityIndex<node_or_edge>>>(std::move(index));
 }
 
+namespace {
+
+// Sorted indexes over fewer entries than this search their keys in about as
+// few cache misses as a filter takes, so they are not filtered.
+constexpr size_t kMinFilteredEntries = 1 << 12;
+
+// A Bloom filter over the hash_of(i) of the num_entries entries of an index,
+// or an empty filter for small indexes.
+template <typename HashOf>
+BloomFilter
+MakeFilter(size_t num_entries, const HashOf& hash_of) {
+  if (num_entries < kMinFilteredEntries) {
+    return BloomFilter();
+  }
+  BloomFilter filter(num_entries);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_entries),
+      [&](size_t i) { filter.Insert(hash_of(i)); }, katana::no_stats());
+  return filter;
+}
+
+// Fill out with the i in [0, n) for which pred(i) holds, in order. Each
+// thread counts the matches in its block and then writes them at its
+// offset.
+template <typename T, typename Pred>
+void
+GatherIf(size_t n, Pred pred, NUMAArray<T>* out) {
+  std::vector<size_t> offsets(katana::getActiveThreads() + 1);
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = katana::block_range(size_t{0}, n, tid, total);
+    size_t count = 0;
+    for (size_t i = begin; i < end; ++i) {
+      count += pred(i);
+    }
+    offsets[tid + 1] = count;
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  out->allocateBlocked(offsets.back());
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = katana::block_range(size_t{0}, n, tid, total);
+    size_t next = offsets[tid];
+    for (size_t i = begin; i < end; ++i) {
+      if (pred(i)) {
+        (*out)[next++] = i;
+      }
+    }
+  });
+}
+
+// Fill ids with the entities in [0, num_entities) whose property is not
+// null, in order.
+template <typename node_or_edge>
+void
+GatherValidIds(
+    const arrow::Array& property, size_t num_entities,
+    NUMAArray<node_or_edge>* ids) {
+  if (property.null_count() == 0) {
+    ids->allocateBlocked(num_entities);
+    ParallelSTL::iota(ids->begin(), ids->end(), node_or_edge{0});
+    return;
+  }
+  GatherIf(
+      num_entities, [&](size_t i) { return property.IsValid(i); }, ids);
+}
+
+// Maps a key to an unsigned integer of the same order for radix sorting,
+// with NaN greatest as in PrimitiveEntityIndex::KeyLess.
+template <typename c_type>
+auto
+RadixKey(c_type v) {
+  if constexpr (std::is_same_v<c_type, bool>) {
+    return static_cast<uint8_t>(v);
+  } else if constexpr (std::is_integral_v<c_type>) {
+    return ParallelSTL::radix_key(v);
+  } else {
+    using U = std::conditional_t<sizeof(c_type) == 4, uint32_t, uint64_t>;
+    constexpr U kSignBit = U{1} << (std::numeric_limits<U>::digits - 1);
+    if (std::isnan(v)) {
+      return std::numeric_limits<U>::max();
+    }
+    // -0 and 0 are equal, so they must share a key to stay in id order.
+    c_type canonical = v == 0 ? c_type{0} : v;
+    U bits;
+    std::memcpy(&bits, &canonical, sizeof(bits));
+    // Negative values order the other way around, below the positive ones.
+    return (bits & kSignBit) ? ~bits : bits | kSignBit;
+  }
+}
+
+// The first eight bytes of a string as a big-endian integer, padded with
+// zeros. Strings whose prefixes differ compare as their prefixes do.
+uint64_t
+StringPrefix(std::string_view str) {
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < sizeof(prefix); ++i) {
+    uint8_t c = i < str.size() ? static_cast<uint8_t>(str[i]) : 0;
+    prefix = (prefix << 8) | c;
+  }
+  return prefix;
+}
+
+void
+ReportBuildStats(
+    const std::string& property_name, size_t num_entries,
+    const katana::Timer& timer) {
+  std::string region = "EntityIndex_" + property_name;
+  uint64_t usec = std::max<uint64_t>(1, timer.get_usec());
+  katana::ReportStatSingle(region, "Entries", num_entries);
+  katana::ReportStatSingle(region, "BuildMicroseconds", usec);
+  katana::ReportStatSingle(
+      region, "EntriesPerSecond",
+      static_cast<uint64_t>(num_entries * 1e6 / usec));
+}
+
+// Copy the ids of a stored index, checking that each names a non-null
+// entity of property so that lookups cannot read out of bounds.
+template <typename node_or_edge>
+Result<void>
+CopyIds(
+    const void* data, size_t size, const arrow::Array& property,
+    size_t num_entities, NUMAArray<node_or_edge>* ids) {
+  if (size % sizeof(node_or_edge) != 0 ||
+      static_cast<uint64_t>(property.length()) < num_entities) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "stored index does not match the property: {} bytes of ids",
+        size);
+  }
+  NUMAArray<node_or_edge> copy;
+  copy.allocateBlocked(size / sizeof(node_or_edge));
+  const auto* stored = static_cast<const node_or_edge*>(data);
+  ParallelSTL::copy(stored, stored + copy.size(), copy.begin());
+
+  katana::GReduceLogicalOr invalid;
+  katana::do_all(
+      katana::iterate(size_t{0}, copy.size()),
+      [&](size_t i) {
+        invalid.update(copy[i] >= num_entities || !property.IsValid(copy[i]));
+      },
+      katana::no_stats());
+  if (invalid.reduce()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "stored index names entities missing from the property");
+  }
+  *ids = std::move(copy);
+  return katana::ResultSuccess();
+}
+
+// The slots of a hash table are probed in blocks of this many tags.
+constexpr size_t kBlockWidth = 16;
+// Full slots have tags below 0x80.
+constexpr uint8_t kEmptyTag = 0x80;
+
+uint64_t
+HashKey(std::string_view key) {
+  return std::hash<std::string_view>{}(key);
+}
+
+// The low seven bits of a hash tag its slot; the rest choose the block.
+uint8_t
+HashTag(uint64_t hash) {
+  return hash & 0x7f;
+}
+
+// A bit mask of the slots of the block at tags whose tag is tag.
+uint32_t
+MatchTags(const uint8_t* tags, uint8_t tag) {
+#if defined(__SSE2__)
+  __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(tag)));
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < kBlockWidth; ++i) {
+    mask |= uint32_t{tags[i] == tag} << i;
+  }
+  return mask;
+#endif
+}
+
+// Visits the blocks of a table of num_blocks blocks, a power of two, in the
+// probe order of hash, until visit returns true. Triangular steps visit
+// every block.
+template <typename Visit>
+void
+ProbeBlocks(uint64_t hash, size_t num_blocks, Visit visit) {
+  size_t mask = num_blocks - 1;
+  size_t block = (hash >> 7) & mask;
+  for (size_t step = 1; !visit(block * kBlockWidth); ++step) {
+    block = (block + step) & mask;
+  }
+}
+
+// Calls fn with a value of the type of the primitive properties of type id
+// that indexes support. Returns false if there is no such type.
+template <typename Fn>
+bool
+VisitPrimitiveType(arrow::Type::type id, Fn fn) {
+  switch (id) {
+  case arrow::Type::BOOL:
+    fn(bool{});
+    return true;
+  case arrow::Type::UINT8:
+    fn(uint8_t{});
+    return true;
+  case arrow::Type::INT16:
+    fn(int16_t{});
+    return true;
+  case arrow::Type::INT32:
+    fn(int32_t{});
+    return true;
+  case arrow::Type::INT64:
+    fn(int64_t{});
+    return true;
+  case arrow::Type::UINT64:
+    fn(uint64_t{});
+    return true;
+  case arrow::Type::DOUBLE:
+    fn(double_t{});
+    return true;
+  case arrow::Type::FLOAT:
+    fn(float_t{});
+    return true;
+  default:
+    return false;
+  }
+}
+
+// The value v as a c_type, if it is one exactly.
+template <typename c_type, typename V>
+std::optional<c_type>
+ExactCast(V v) {
+  if constexpr (std::is_same_v<V, bool> || std::is_same_v<c_type, bool>) {
+    if (!std::is_same_v<V, c_type>) {
+      return std::nullopt;
+    }
+    return v;
+  } else if constexpr (std::is_floating_point_v<c_type>) {
+    c_type converted = static_cast<c_type>(v);
+    if constexpr (std::is_integral_v<V>) {
+      // Rounding up to 2^digits would not convert back.
+      if (converted >= std::ldexp(c_type{1}, std::numeric_limits<V>::digits)) {
+        return std::nullopt;
+      }
+    }
+    if (static_cast<V>(converted) != v && !std::isnan(converted)) {
+      return std::nullopt;
+    }
+    return converted;
+  } else if constexpr (std::is_floating_point_v<V>) {
+    constexpr int kDigits = std::numeric_limits<c_type>::digits;
+    V lowest = std::is_signed_v<c_type> ? -std::ldexp(V{1}, kDigits) : 0;
+    if (!(v >= lowest && v < std::ldexp(V{1}, kDigits)) ||
+        static_cast<V>(static_cast<c_type>(v)) != v) {
+      return std::nullopt;
+    }
+    return static_cast<c_type>(v);
+  } else {
+    if constexpr (std::is_signed_v<V>) {
+      if (v < 0) {
+        if (!std::is_signed_v<c_type> ||
+            v < static_cast<V>(std::numeric_limits<c_type>::min())) {
+          return std::nullopt;
+        }
+        return static_cast<c_type>(v);
+      }
+    }
+    if (static_cast<uint64_t>(v) >
+        static_cast<uint64_t>(std::numeric_limits<c_type>::max())) {
+      return std::nullopt;
+    }
+    return static_cast<c_type>(v);
+  }
+}
+
+}  // namespace
+
 template <typename node_or_edge, typename c_type>
 Result<void>
 PrimitiveEntityIndex<node_or_edge, c_type>::BuildFromProperty() {
@@ -67,15 +378,62 @@ PrimitiveEntityIndex<node_or_edge, c_type>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
-    }
-  }
+  katana::Timer timer;
+  timer.start();
+
+  NUMAArray<node_or_edge>& ids = this->ids_;
+  GatherValidIds(*property_, num_entities_, &ids);
+  std::vector<std::pair<c_type, node_or_edge>> entries(ids.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, ids.size()),
+      [&](size_t i) { entries[i] = {property_->Value(ids[i]), ids[i]}; },
+      katana::no_stats());
+
+  // The ids are in increasing order, so a stable sort by key leaves equal
+  // keys ordered by id.
+  ParallelSTL::radix_sort(
+      entries.begin(), entries.end(),
+      [](const std::pair<c_type, node_or_edge>& entry) {
+        return RadixKey(entry.first);
+      });
 
+  keys_.allocateBlocked(ids.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, ids.size()),
+      [&](size_t i) {
+        keys_[i] = entries[i].first;
+        ids[i] = entries[i].second;
+      },
+      katana::no_stats());
+  filter_ =
+      MakeFilter(ids.size(), [this](size_t i) { return KeyHash(keys_[i]); });
+
+  timer.stop();
+  ReportBuildStats(this->property_name(), ids.size(), timer);
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename c_type>
+Result<void>
+PrimitiveEntityIndex<node_or_edge, c_type>::BuildFromFile(
+    const void* ids, size_t ids_size, const void* keys, size_t keys_size) {
+  size_t num_entries = ids_size / sizeof(node_or_edge);
+  if (keys_size != num_entries * sizeof(c_type)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "stored index over {} has {} bytes of keys for {} ids",
+        this->property_name(), keys_size, num_entries);
+  }
+  KATANA_CHECKED(
+      CopyIds(ids, ids_size, *property_, num_entities_, &this->ids_));
+  NUMAArray<c_type> copy;
+  copy.allocateBlocked(num_entries);
+  const auto* stored_keys = static_cast<const c_type*>(keys);
+  ParallelSTL::copy(stored_keys, stored_keys + copy.size(), copy.begin());
+  keys_ = std::move(copy);
+  filter_ =
+      MakeFilter(keys_.size(), [this](size_t i) { return KeyHash(keys_[i]); });
   return katana::ResultSuccess();
 }
 
@@ -87,18 +445,583 @@ StringEntityIndex<node_or_edge>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
+  katana::Timer timer;
+  timer.start();
+
+  // Sorting (prefix, id) pairs settles most comparisons without touching
+  // the string data; only strings with equal prefixes are compared in full.
+  NUMAArray<node_or_edge>& ids = this->ids_;
+  GatherValidIds(*property_, num_entities_, &ids);
+  std::vector<std::pair<uint64_t, node_or_edge>> entries(ids.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, ids.size()),
+      [&](size_t i) { entries[i] = {StringPrefix(GetValue(ids[i])), ids[i]}; },
+      katana::no_stats());
+
+  ParallelSTL::sample_sort(
+      entries.begin(), entries.end(),
+      [this](
+          const std::pair<uint64_t, node_or_edge>& a,
+          const std::pair<uint64_t, node_or_edge>& b) {
+        if (a.first != b.first) {
+          return a.first < b.first;
+        }
+        int order = GetValue(a.second).compare(GetValue(b.second));
+        return order < 0 || (order == 0 && a.second < b.second);
+      });
+
+  katana::do_all(
+      katana::iterate(size_t{0}, ids.size()),
+      [&](size_t i) { ids[i] = entries[i].second; }, katana::no_stats());
+  BuildFilter();
+
+  timer.stop();
+  ReportBuildStats(this->property_name(), ids.size(), timer);
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+Result<void>
+StringEntityIndex<node_or_edge>::BuildFromFile(
+    const void* ids, size_t ids_size, const void*, size_t) {
+  KATANA_CHECKED(
+      CopyIds(ids, ids_size, *property_, num_entities_, &this->ids_));
+  BuildFilter();
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+void
+StringEntityIndex<node_or_edge>::BuildFilter() {
+  filter_ = MakeFilter(this->ids_.size(), [this](size_t i) {
+    return std::hash<std::string_view>{}(GetValue(this->ids_[i]));
+  });
+}
+
+template <typename node_or_edge>
+size_t
+StringHashEntityIndex<node_or_edge>::FindGroup(std::string_view key) const {
+  if (tags_.empty()) {
+    return kNoGroup;
+  }
+  uint64_t hash = HashKey(key);
+  uint8_t tag = HashTag(hash);
+  size_t group = kNoGroup;
+  ProbeBlocks(hash, tags_.size() / kBlockWidth, [&](size_t first_slot) {
+    const uint8_t* block = tags_.data() + first_slot;
+    for (uint32_t match = MatchTags(block, tag); match != 0;
+         match &= match - 1) {
+      size_t slot = first_slot + __builtin_ctz(match);
+      if (GetValue(this->ids_[group_starts_[slots_[slot]]]) == key) {
+        group = slots_[slot];
+        return true;
+      }
+    }
+    // A key is in the first block of its probe order with an empty slot or
+    // in one before it.
+    return MatchTags(block, kEmptyTag) != 0;
+  });
+  return group;
+}
+
+template <typename node_or_edge>
+std::pair<
+    typename StringHashEntityIndex<node_or_edge>::iterator,
+    typename StringHashEntityIndex<node_or_edge>::iterator>
+StringHashEntityIndex<node_or_edge>::EqualRange(std::string_view key) const {
+  size_t group = FindGroup(key);
+  if (group == kNoGroup) {
+    return {this->end(), this->end()};
+  }
+  size_t last = group + 1 < group_starts_.size() ? group_starts_[group + 1]
+                                                 : this->ids_.size();
+  return {
+      iterator(this->ids_.data() + group_starts_[group]),
+      iterator(this->ids_.data() + last)};
+}
+
+template <typename node_or_edge>
+Result<NUMAArray<node_or_edge>>
+StringHashEntityIndex<node_or_edge>::FindBatch(
+    const arrow::Array& keys) const {
+  NUMAArray<node_or_edge> ids;
+  ids.allocateBlocked(keys.length());
+  auto find_all = [&](const auto& typed_keys) {
+    katana::do_all(
+        katana::iterate(size_t{0}, ids.size()),
+        [&](size_t i) {
+          if (typed_keys.IsNull(i)) {
+            ids[i] = kNotFound;
+            return;
+          }
+          auto view = typed_keys.GetView(i);
+          size_t group = FindGroup(std::string_view(view.data(), view.size()));
+          ids[i] = group == kNoGroup ? kNotFound
+                                     : this->ids_[group_starts_[group]];
+        },
+        katana::no_stats());
+  };
+
+  switch (keys.type_id()) {
+  case arrow::Type::STRING:
+    find_all(static_cast<const arrow::StringArray&>(keys));
+    break;
+  case arrow::Type::LARGE_STRING:
+    find_all(static_cast<const arrow::LargeStringArray&>(keys));
+    break;
+  default:
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "Keys have type {}, not a string type",
+        keys.type()->ToString());
+  }
+  return Result<NUMAArray<node_or_edge>>(std::move(ids));
+}
+
+template <typename node_or_edge>
+void
+StringHashEntityIndex<node_or_edge>::BuildTable() {
+  const NUMAArray<node_or_edge>& ids = this->ids_;
+  GatherIf(
+      ids.size(),
+      [&](size_t i) {
+        return i == 0 || GetValue(ids[i]) != GetValue(ids[i - 1]);
+      },
+      &group_starts_);
+
+  // At most 7/8 of the slots are full, so every probe ends.
+  size_t num_slots = kBlockWidth;
+  while (num_slots * 7 < group_starts_.size() * 8) {
+    num_slots *= 2;
+  }
+  tags_.allocateBlocked(num_slots);
+  ParallelSTL::fill(tags_.begin(), tags_.end(), kEmptyTag);
+  slots_.allocateBlocked(num_slots);
+
+  katana::do_all(
+      katana::iterate(size_t{0}, group_starts_.size()),
+      [&](size_t group) {
+        uint64_t hash = HashKey(GetValue(ids[group_starts_[group]]));
+        uint8_t tag = HashTag(hash);
+        ProbeBlocks(hash, num_slots / kBlockWidth, [&](size_t first_slot) {
+          for (size_t slot = first_slot; slot < first_slot + kBlockWidth;
+               ++slot) {
+            uint8_t expected = kEmptyTag;
+            if (__atomic_load_n(&tags_[slot], __ATOMIC_RELAXED) ==
+                    kEmptyTag &&
+                __atomic_compare_exchange_n(
+                    &tags_[slot], &expected, tag, false, __ATOMIC_RELAXED,
+                    __ATOMIC_RELAXED)) {
+              slots_[slot] = group;
+              return true;
+            }
+          }
+          return false;
+        });
+      },
+      katana::steal(), katana::no_stats());
+}
+
+template <typename node_or_edge>
+Result<void>
+StringHashEntityIndex<node_or_edge>::BuildFromProperty() {
+  if (static_cast<uint64_t>(property_->length()) < num_entities_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "Property does not contain all entities");
+  }
+
+  katana::Timer timer;
+  timer.start();
+
+  // Sorting (hash, id) pairs groups equal values, keeping their ids in
+  // order.
+  NUMAArray<node_or_edge>& ids = this->ids_;
+  GatherValidIds(*property_, num_entities_, &ids);
+  std::vector<std::pair<uint64_t, node_or_edge>> entries(ids.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, ids.size()),
+      [&](size_t i) { entries[i] = {HashKey(GetValue(ids[i])), ids[i]}; },
+      katana::no_stats());
+  ParallelSTL::radix_sort(
+      entries.begin(), entries.end(),
+      [](const std::pair<uint64_t, node_or_edge>& entry) {
+        return entry.first;
+      });
+
+  // Distinct values with the same hash may interleave; order them by value
+  // in the rare case that they do.
+  katana::GReduceLogicalOr collides;
+  katana::do_all(
+      katana::iterate(size_t{1}, std::max<size_t>(ids.size(), 1)),
+      [&](size_t i) {
+        collides.update(
+            entries[i].first == entries[i - 1].first &&
+            GetValue(entries[i].second) != GetValue(entries[i - 1].second));
+      },
+      katana::no_stats());
+  if (collides.reduce()) {
+    std::stable_sort(
+        entries.begin(), entries.end(),
+        [this](
+            const std::pair<uint64_t, node_or_edge>& a,
+            const std::pair<uint64_t, node_or_edge>& b) {
+          if (a.first != b.first) {
+            return a.first < b.first;
+          }
+          return GetValue(a.second) < GetValue(b.second);
+        });
+  }
+
+  katana::do_all(
+      katana::iterate(size_t{0}, ids.size()),
+      [&](size_t i) { ids[i] = entries[i].second; }, katana::no_stats());
+  BuildTable();
+
+  timer.stop();
+  ReportBuildStats(this->property_name(), ids.size(), timer);
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+Result<void>
+StringHashEntityIndex<node_or_edge>::BuildFromFile(
+    const void* ids, size_t ids_size, const void*, size_t) {
+  KATANA_CHECKED(
+      CopyIds(ids, ids_size, *property_, num_entities_, &this->ids_));
+  BuildTable();
+
+  // Equal values that are not adjacent would form several groups, and
+  // lookups would find only one of them.
+  katana::GReduceLogicalOr split;
+  katana::do_all(
+      katana::iterate(size_t{0}, group_starts_.size()),
+      [&](size_t group) {
+        split.update(
+            FindGroup(GetValue(this->ids_[group_starts_[group]])) != group);
+      },
+      katana::no_stats());
+  if (split.reduce()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "stored hash index over {} does not group equal values",
+        this->property_name());
+  }
+  return katana::ResultSuccess();
+}
+
+std::string
+CompositeEntityIndexName(
+    const std::vector<std::string>& property_names, bool by_type) {
+  std::string name = by_type ? "type:" : "";
+  for (size_t i = 0; i < property_names.size(); ++i) {
+    name += (i == 0 ? "" : ",") + property_names[i];
+  }
+  return name;
+}
+
+template <typename node_or_edge>
+CompositeEntityIndex<node_or_edge>::CompositeEntityIndex(
+    const std::vector<std::string>& property_names, size_t num_entities,
+    std::vector<std::shared_ptr<arrow::Array>> properties,
+    std::shared_ptr<const NUMAArray<EntityTypeID>> entity_types)
+    : EntityIndex<node_or_edge>(
+          CompositeEntityIndexName(property_names, entity_types != nullptr)),
+      num_entities_(num_entities),
+      by_type_(entity_types != nullptr),
+      properties_(std::move(properties)),
+      entity_types_(std::move(entity_types)) {
+  if (by_type_) {
+    columns_.emplace_back();
+  }
+  for (const auto& property : properties_) {
+    columns_.emplace_back();
+    columns_.back().property = property;
+    columns_.back().is_string =
+        property->type_id() == arrow::Type::LARGE_STRING;
+  }
+}
+
+template <typename node_or_edge>
+std::string_view
+CompositeEntityIndex<node_or_edge>::GetString(
+    size_t column, node_or_edge id) const {
+  arrow::util::string_view arrow_view =
+      static_cast<const arrow::LargeStringArray&>(*columns_[column].property)
+          .GetView(id);
+  return std::string_view(arrow_view.data(), arrow_view.length());
+}
+
+template <typename node_or_edge>
+int
+CompositeEntityIndex<node_or_edge>::Compare(
+    size_t entry, const std::vector<ColumnValue>& prefix,
+    size_t first_column) const {
+  for (size_t i = 0; i < prefix.size(); ++i) {
+    const Column& column = columns_[first_column + i];
+    if (column.is_string) {
+      int order =
+          GetString(first_column + i, this->ids_[entry]).compare(prefix[i].str);
+      if (order != 0) {
+        return order;
+      }
+    } else if (column.keys[entry] != prefix[i].key) {
+      return column.keys[entry] < prefix[i].key ? -1 : 1;
     }
   }
+  return 0;
+}
+
+template <typename node_or_edge>
+std::pair<size_t, size_t>
+CompositeEntityIndex<node_or_edge>::Search(
+    const std::vector<ColumnValue>& prefix, size_t first_column, size_t first,
+    size_t last) const {
+  auto partition_point = [&](size_t begin, size_t end, auto before) {
+    while (begin < end) {
+      size_t mid = begin + (end - begin) / 2;
+      if (before(Compare(mid, prefix, first_column))) {
+        begin = mid + 1;
+      } else {
+        end = mid;
+      }
+    }
+    return begin;
+  };
+  size_t lower =
+      partition_point(first, last, [](int order) { return order < 0; });
+  size_t upper =
+      partition_point(lower, last, [](int order) { return order <= 0; });
+  return {lower, upper};
+}
+
+template <typename node_or_edge>
+std::optional<
+    std::vector<typename CompositeEntityIndex<node_or_edge>::ColumnValue>>
+CompositeEntityIndex<node_or_edge>::ConvertPrefix(
+    const Key& prefix, size_t first_column) const {
+  if (first_column + prefix.size() > columns_.size()) {
+    return std::nullopt;
+  }
+  std::vector<ColumnValue> converted(prefix.size());
+  for (size_t i = 0; i < prefix.size(); ++i) {
+    const Column& column = columns_[first_column + i];
+    if (column.is_string) {
+      if (!std::holds_alternative<std::string_view>(prefix[i])) {
+        return std::nullopt;
+      }
+      converted[i].str = std::get<std::string_view>(prefix[i]);
+      continue;
+    }
+    if (std::holds_alternative<std::string_view>(prefix[i])) {
+      return std::nullopt;
+    }
+    std::optional<uint64_t> key;
+    auto convert = [&](auto c_type_value) {
+      using c_type = decltype(c_type_value);
+      std::visit(
+          [&](auto v) {
+            if constexpr (!std::is_same_v<decltype(v), std::string_view>) {
+              if (auto exact = ExactCast<c_type>(v)) {
+                key = RadixKey(*exact);
+              }
+            }
+          },
+          prefix[i]);
+    };
+    if (column.property == nullptr) {
+      convert(EntityTypeID{});
+    } else {
+      VisitPrimitiveType(column.property->type_id(), convert);
+    }
+    if (!key) {
+      return std::nullopt;
+    }
+    converted[i].key = *key;
+  }
+  return converted;
+}
+
+template <typename node_or_edge>
+typename CompositeEntityIndex<node_or_edge>::Range
+CompositeEntityIndex<node_or_edge>::EqualRange(const Key& prefix) const {
+  auto converted = ConvertPrefix(prefix, 0);
+  if (!converted) {
+    return {this->end(), this->end()};
+  }
+  auto [lower, upper] = Search(*converted, 0, 0, this->size());
+  return {
+      iterator(this->ids_.data() + lower),
+      iterator(this->ids_.data() + upper)};
+}
+
+template <typename node_or_edge>
+std::vector<typename CompositeEntityIndex<node_or_edge>::Range>
+CompositeEntityIndex<node_or_edge>::EqualRanges(
+    const EntityTypeManager& manager, EntityTypeID entity_type,
+    const Key& prefix) const {
+  KATANA_LOG_DEBUG_ASSERT(by_type_);
+  std::vector<Range> ranges;
+  auto converted = ConvertPrefix(prefix, 1);
+  if (!by_type_ || !converted) {
+    return ranges;
+  }
+  for (size_t block = 0; block < types_.size(); ++block) {
+    if (!manager.IsSubtypeOf(entity_type, types_[block])) {
+      continue;
+    }
+    size_t last = block + 1 < types_.size() ? type_starts_[block + 1]
+                                            : this->size();
+    auto [lower, upper] =
+        Search(*converted, 1, type_starts_[block], last);
+    if (lower != upper) {
+      ranges.emplace_back(
+          iterator(this->ids_.data() + lower),
+          iterator(this->ids_.data() + upper));
+    }
+  }
+  return ranges;
+}
+
+template <typename node_or_edge>
+Result<void>
+CompositeEntityIndex<node_or_edge>::BuildFromProperty() {
+  if (properties_.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "Composite index needs at least one property");
+  }
+  for (const auto& property : properties_) {
+    if (static_cast<uint64_t>(property->length()) < num_entities_) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "Property does not contain all entities");
+    }
+    if (property->type_id() != arrow::Type::LARGE_STRING &&
+        !VisitPrimitiveType(property->type_id(), [](auto) {})) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "Column has type unknown for indexing: {}",
+          property->type()->ToString());
+    }
+  }
+  if (by_type_ && entity_types_->size() < num_entities_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "Entity types do not cover all entities");
+  }
+
+  katana::Timer timer;
+  timer.start();
+
+  NUMAArray<node_or_edge> ids;
+  bool any_nulls = std::any_of(
+      properties_.begin(), properties_.end(),
+      [](const auto& property) { return property->null_count() != 0; });
+  if (any_nulls) {
+    GatherIf(
+        num_entities_,
+        [&](size_t i) {
+          return std::all_of(
+              properties_.begin(), properties_.end(),
+              [i](const auto& property) { return property->IsValid(i); });
+        },
+        &ids);
+  } else {
+    ids.allocateBlocked(num_entities_);
+    ParallelSTL::iota(ids.begin(), ids.end(), node_or_edge{0});
+  }
+  size_t num_entries = ids.size();
+
+  // Fill in the keys of the columns that are not strings in order of id.
+  std::vector<NUMAArray<uint64_t>> keys(columns_.size());
+  for (size_t c = 0; c < columns_.size(); ++c) {
+    const Column& column = columns_[c];
+    if (column.is_string) {
+      continue;
+    }
+    keys[c].allocateBlocked(num_entries);
+    auto fill = [&](auto c_type_value) {
+      using c_type = decltype(c_type_value);
+      using ArrowArrayType = typename arrow::CTypeTraits<c_type>::ArrayType;
+      const auto& typed =
+          static_cast<const ArrowArrayType&>(*column.property);
+      katana::do_all(
+          katana::iterate(size_t{0}, num_entries),
+          [&](size_t i) { keys[c][i] = RadixKey(typed.Value(ids[i])); },
+          katana::no_stats());
+    };
+    if (column.property == nullptr) {
+      katana::do_all(
+          katana::iterate(size_t{0}, num_entries),
+          [&](size_t i) { keys[c][i] = (*entity_types_)[ids[i]]; },
+          katana::no_stats());
+    } else {
+      VisitPrimitiveType(column.property->type_id(), fill);
+    }
+  }
+
+  // Sort positions rather than ids so that the precomputed keys are at hand;
+  // positions are in order of id, which breaks ties.
+  std::vector<size_t> order(num_entries);
+  ParallelSTL::iota(order.begin(), order.end(), size_t{0});
+  ParallelSTL::sample_sort(
+      order.begin(), order.end(), [&](size_t a, size_t b) {
+        for (size_t c = 0; c < columns_.size(); ++c) {
+          if (columns_[c].is_string) {
+            int cmp = GetString(c, ids[a]).compare(GetString(c, ids[b]));
+            if (cmp != 0) {
+              return cmp < 0;
+            }
+          } else if (keys[c][a] != keys[c][b]) {
+            return keys[c][a] < keys[c][b];
+          }
+        }
+        return a < b;
+      });
+
+  this->ids_.allocateBlocked(num_entries);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_entries),
+      [&](size_t i) { this->ids_[i] = ids[order[i]]; }, katana::no_stats());
+  for (size_t c = 0; c < columns_.size(); ++c) {
+    if (columns_[c].is_string) {
+      continue;
+    }
+    NUMAArray<uint64_t>& sorted = columns_[c].keys;
+    sorted.allocateBlocked(num_entries);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_entries),
+        [&](size_t i) { sorted[i] = keys[c][order[i]]; }, katana::no_stats());
+  }
+
+  if (by_type_) {
+    const NUMAArray<uint64_t>& type_keys = columns_[0].keys;
+    GatherIf(
+        num_entries,
+        [&](size_t i) { return i == 0 || type_keys[i] != type_keys[i - 1]; },
+        &type_starts_);
+    types_.resize(type_starts_.size());
+    for (size_t block = 0; block < types_.size(); ++block) {
+      types_[block] = type_keys[type_starts_[block]];
+    }
+    // Only the sorted copy of the types is needed from here on.
+    entity_types_.reset();
+  }
+
+  timer.stop();
+  ReportBuildStats(this->property_name(), num_entries, timer);
 
   return katana::ResultSuccess();
 }
 
+template <typename node_or_edge>
+Result<void>
+CompositeEntityIndex<node_or_edge>::BuildFromFile(
+    const void*, size_t, const void*, size_t) {
+  return KATANA_ERROR(
+      ErrorCode::NotImplemented, "composite indexes are not stored");
+}
+
 // Forward declare template types to allow implementation in .cpp.
 template class PrimitiveEntityIndex<GraphTopology::Node, bool>;
 template class PrimitiveEntityIndex<GraphTopology::Edge, bool>;
@@ -120,13 +1043,19 @@ template class PrimitiveEntityIndex<GraphTopology::Edge, float_t>;
 template class StringEntityIndex<GraphTopology::Node>;
 template class StringEntityIndex<GraphTopology::Edge>;
 
+template class StringHashEntityIndex<GraphTopology::Node>;
+template class StringHashEntityIndex<GraphTopology::Edge>;
+
+template class CompositeEntityIndex<GraphTopology::Node>;
+template class CompositeEntityIndex<GraphTopology::Edge>;
+
 template Result<std::unique_ptr<EntityIndex<GraphTopology::Node>>>
 MakeTypedEntityIndex(
     const std::string& property_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, EntityIndexKind kind);
 template Result<std::unique_ptr<EntityIndex<GraphTopology::Edge>>>
 MakeTypedEntityIndex(
     const std::string& property_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, EntityIndexKind kind);
 
 }  // namespace katana
@@ -0,0 +1,161 @@
+#include "katana/GraphFlightServer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr const char* kFlightNames[] = {"nodes", "edges", "topology"};
+
+/// The ticket of a stream of version
+std::string
+EncodeTicket(uint64_t version, const katana::GraphStreamTicket& ticket) {
+  return std::to_string(version) + "\n" + ticket.ToString();
+}
+
+arrow::Status
+DecodeTicket(
+    const std::string& str, uint64_t* version,
+    katana::GraphStreamTicket* ticket) {
+  size_t newline = str.find('\n');
+  if (newline == std::string::npos) {
+    return arrow::Status::Invalid("malformed ticket");
+  }
+  const char* last = str.data() + newline;
+  auto [ptr, ec] = std::from_chars(str.data(), last, *version);
+  if (ec != std::errc() || ptr != last) {
+    return arrow::Status::Invalid("malformed ticket");
+  }
+  auto ticket_res = katana::GraphStreamTicket::Parse(str.substr(newline + 1));
+  if (!ticket_res) {
+    return arrow::Status::Invalid(fmt::format("{}", ticket_res.error()));
+  }
+  *ticket = std::move(ticket_res.value());
+  return arrow::Status::OK();
+}
+
+/// The stream of a flight descriptor, partition aside
+arrow::Status
+DescriptorTicket(
+    const arrow::flight::FlightDescriptor& descriptor,
+    katana::GraphStreamTicket* ticket) {
+  const auto& path = descriptor.path;
+  if (descriptor.type != arrow::flight::FlightDescriptor::PATH ||
+      path.empty()) {
+    return arrow::Status::KeyError("flights are named by paths");
+  }
+  for (int kind = 0; kind < 3; ++kind) {
+    if (path[0] == kFlightNames[kind]) {
+      ticket->kind = static_cast<katana::GraphStreamKind>(kind);
+      ticket->columns.assign(path.begin() + 1, path.end());
+      if (ticket->kind == katana::GraphStreamKind::kTopology &&
+          !ticket->columns.empty()) {
+        return arrow::Status::KeyError("the topology has no columns");
+      }
+      return arrow::Status::OK();
+    }
+  }
+  return arrow::Status::KeyError("no flight named ", path[0]);
+}
+
+}  // namespace
+
+katana::GraphFlightServer::GraphFlightServer(
+    const SnapshotPublisher* publisher, const GraphFlightServerOptions& options)
+    : publisher_(publisher), options_(options) {}
+
+std::shared_ptr<const katana::GraphSnapshot>
+katana::GraphFlightServer::Pin() {
+  std::shared_ptr<const GraphSnapshot> snapshot = publisher_->Pin();
+  std::lock_guard<std::mutex> lock(mutex_);
+  retained_.emplace(snapshot->version(), snapshot);
+  while (retained_.size() > std::max(options_.retained_versions, 1U)) {
+    retained_.erase(retained_.begin());
+  }
+  return snapshot;
+}
+
+arrow::Result<arrow::flight::FlightInfo>
+katana::GraphFlightServer::MakeInfo(
+    const std::shared_ptr<const GraphSnapshot>& snapshot,
+    const arrow::flight::FlightDescriptor& descriptor) {
+  GraphStreamTicket ticket;
+  ARROW_RETURN_NOT_OK(DescriptorTicket(descriptor, &ticket));
+  auto schema_res = GraphStreamSchema(*snapshot, ticket);
+  if (!schema_res) {
+    return arrow::Status::KeyError(fmt::format("{}", schema_res.error()));
+  }
+
+  ticket.num_partitions = std::max(options_.num_streams, 1U);
+  std::vector<arrow::flight::FlightEndpoint> endpoints;
+  for (uint32_t p = 0; p < ticket.num_partitions; ++p) {
+    ticket.partition = p;
+    endpoints.emplace_back(arrow::flight::FlightEndpoint{
+        arrow::flight::Ticket{EncodeTicket(snapshot->version(), ticket)},
+        {}});
+  }
+  return arrow::flight::FlightInfo::Make(
+      *schema_res.value(), descriptor, endpoints,
+      static_cast<int64_t>(GraphStreamNumRows(*snapshot, ticket.kind)), -1);
+}
+
+arrow::Status
+katana::GraphFlightServer::ListFlights(
+    const arrow::flight::ServerCallContext&, const arrow::flight::Criteria*,
+    std::unique_ptr<arrow::flight::FlightListing>* listings) {
+  std::shared_ptr<const GraphSnapshot> snapshot = Pin();
+  std::vector<arrow::flight::FlightInfo> infos;
+  for (const char* name : kFlightNames) {
+    ARROW_ASSIGN_OR_RAISE(
+        auto info,
+        MakeInfo(snapshot, arrow::flight::FlightDescriptor::Path({name})));
+    infos.emplace_back(std::move(info));
+  }
+  *listings = std::make_unique<arrow::flight::SimpleFlightListing>(
+      std::move(infos));
+  return arrow::Status::OK();
+}
+
+arrow::Status
+katana::GraphFlightServer::GetFlightInfo(
+    const arrow::flight::ServerCallContext&,
+    const arrow::flight::FlightDescriptor& request,
+    std::unique_ptr<arrow::flight::FlightInfo>* info) {
+  ARROW_ASSIGN_OR_RAISE(auto flight_info, MakeInfo(Pin(), request));
+  *info = std::make_unique<arrow::flight::FlightInfo>(std::move(flight_info));
+  return arrow::Status::OK();
+}
+
+arrow::Status
+katana::GraphFlightServer::DoGet(
+    const arrow::flight::ServerCallContext&,
+    const arrow::flight::Ticket& request,
+    std::unique_ptr<arrow::flight::FlightDataStream>* stream) {
+  uint64_t version = 0;
+  GraphStreamTicket ticket;
+  ARROW_RETURN_NOT_OK(DecodeTicket(request.ticket, &version, &ticket));
+
+  std::shared_ptr<const GraphSnapshot> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = retained_.find(version);
+    if (it != retained_.end()) {
+      snapshot = it->second;
+    }
+  }
+  if (!snapshot) {
+    return arrow::Status::KeyError(
+        "version ", version, " is no longer served; get the flight again");
+  }
+
+  auto reader_res =
+      MakeGraphStreamReader(snapshot, ticket, options_.max_batch_rows);
+  if (!reader_res) {
+    return arrow::Status::Invalid(fmt::format("{}", reader_res.error()));
+  }
+  *stream = std::make_unique<arrow::flight::RecordBatchStream>(
+      std::move(reader_res.value()));
+  return arrow::Status::OK();
+}
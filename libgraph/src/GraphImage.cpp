@@ -0,0 +1,632 @@
+#include "katana/GraphImage.h"
+
+#include <unistd.h>
+
+#include <cstring>
+#include <iomanip>
+#include <string_view>
+
+#include <arrow/io/file.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/table.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/ErrorCode.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/ParallelSTL.h"
+#include "katana/RDGManifest.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+// An image is its sections, each at an offset aligned to kAlignment, then the
+// manifest that locates them, then an ImageTrailer that locates the manifest
+constexpr uint64_t kImageMagic = 0x6b61746e494d4147;  // "katnIMAG"
+constexpr uint64_t kImageVersion = 1;
+constexpr uint64_t kAlignment = 64;
+
+struct ImageTrailer {
+  uint64_t manifest_offset{0};
+  uint64_t manifest_size{0};
+  uint64_t version{kImageVersion};
+  uint64_t magic{kImageMagic};
+};
+
+/// Where an array or a table is in the image; empty sections stand for
+/// arrays that are absent
+struct ImageSection {
+  uint64_t offset{0};
+  uint64_t size{0};
+};
+
+/// A derived topology, with the fields of the RDGTopology it came from
+struct ImageTopology {
+  int kind{-1};
+  int transpose{-1};
+  int edge_sort{-1};
+  int node_sort{-1};
+  std::string edge_sort_property;
+  uint64_t num_edge_types{0};
+  ImageSection adj_indices;
+  ImageSection dests;
+  ImageSection edge_prop_indices;
+  ImageSection node_prop_indices;
+  ImageSection edge_types;
+};
+
+/// An entity index to rebuild: its property and EntityIndexKind
+struct ImageIndex {
+  std::string property;
+  int kind{0};
+};
+
+struct ImageManifest {
+  std::string rdg_dir;
+  uint64_t rdg_version{0};
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+
+  ImageSection adj_indices;
+  ImageSection dests;
+  ImageSection edge_prop_indices;
+  ImageSection node_prop_indices;
+  std::vector<ImageTopology> derived_topologies;
+
+  ImageSection node_types;
+  ImageSection edge_types;
+  katana::EntityTypeIDToSetOfEntityTypeIDsStorageMap node_type_dict;
+  katana::EntityTypeIDToAtomicTypeNameMap node_type_names;
+  katana::EntityTypeIDToSetOfEntityTypeIDsStorageMap edge_type_dict;
+  katana::EntityTypeIDToAtomicTypeNameMap edge_type_names;
+
+  ImageSection node_properties;
+  ImageSection edge_properties;
+  std::vector<ImageIndex> node_indexes;
+  std::vector<ImageIndex> edge_indexes;
+};
+
+void
+to_json(nlohmann::json& j, const ImageSection& section) {
+  j = nlohmann::json{section.offset, section.size};
+}
+
+void
+from_json(const nlohmann::json& j, ImageSection& section) {
+  j.at(0).get_to(section.offset);
+  j.at(1).get_to(section.size);
+}
+
+void
+to_json(nlohmann::json& j, const ImageTopology& topo) {
+  j = nlohmann::json{
+      {"kind", topo.kind},
+      {"transpose", topo.transpose},
+      {"edge_sort", topo.edge_sort},
+      {"node_sort", topo.node_sort},
+      {"edge_sort_property", topo.edge_sort_property},
+      {"num_edge_types", topo.num_edge_types},
+      {"adj_indices", topo.adj_indices},
+      {"dests", topo.dests},
+      {"edge_prop_indices", topo.edge_prop_indices},
+      {"node_prop_indices", topo.node_prop_indices},
+      {"edge_types", topo.edge_types},
+  };
+}
+
+void
+from_json(const nlohmann::json& j, ImageTopology& topo) {
+  j.at("kind").get_to(topo.kind);
+  j.at("transpose").get_to(topo.transpose);
+  j.at("edge_sort").get_to(topo.edge_sort);
+  j.at("node_sort").get_to(topo.node_sort);
+  if (auto it = j.find("edge_sort_property"); it != j.end()) {
+    it->get_to(topo.edge_sort_property);
+  }
+  j.at("num_edge_types").get_to(topo.num_edge_types);
+  j.at("adj_indices").get_to(topo.adj_indices);
+  j.at("dests").get_to(topo.dests);
+  j.at("edge_prop_indices").get_to(topo.edge_prop_indices);
+  j.at("node_prop_indices").get_to(topo.node_prop_indices);
+  j.at("edge_types").get_to(topo.edge_types);
+}
+
+void
+to_json(nlohmann::json& j, const ImageIndex& index) {
+  j = nlohmann::json{index.property, index.kind};
+}
+
+void
+from_json(const nlohmann::json& j, ImageIndex& index) {
+  j.at(0).get_to(index.property);
+  j.at(1).get_to(index.kind);
+}
+
+void
+to_json(nlohmann::json& j, const ImageManifest& manifest) {
+  j = nlohmann::json{
+      {"rdg_dir", manifest.rdg_dir},
+      {"rdg_version", manifest.rdg_version},
+      {"num_nodes", manifest.num_nodes},
+      {"num_edges", manifest.num_edges},
+      {"adj_indices", manifest.adj_indices},
+      {"dests", manifest.dests},
+      {"edge_prop_indices", manifest.edge_prop_indices},
+      {"node_prop_indices", manifest.node_prop_indices},
+      {"derived_topologies", manifest.derived_topologies},
+      {"node_types", manifest.node_types},
+      {"edge_types", manifest.edge_types},
+      {"node_type_dict", manifest.node_type_dict},
+      {"node_type_names", manifest.node_type_names},
+      {"edge_type_dict", manifest.edge_type_dict},
+      {"edge_type_names", manifest.edge_type_names},
+      {"node_properties", manifest.node_properties},
+      {"edge_properties", manifest.edge_properties},
+      {"node_indexes", manifest.node_indexes},
+      {"edge_indexes", manifest.edge_indexes},
+  };
+}
+
+void
+from_json(const nlohmann::json& j, ImageManifest& manifest) {
+  j.at("rdg_dir").get_to(manifest.rdg_dir);
+  j.at("rdg_version").get_to(manifest.rdg_version);
+  j.at("num_nodes").get_to(manifest.num_nodes);
+  j.at("num_edges").get_to(manifest.num_edges);
+  j.at("adj_indices").get_to(manifest.adj_indices);
+  j.at("dests").get_to(manifest.dests);
+  j.at("edge_prop_indices").get_to(manifest.edge_prop_indices);
+  j.at("node_prop_indices").get_to(manifest.node_prop_indices);
+  j.at("derived_topologies").get_to(manifest.derived_topologies);
+  j.at("node_types").get_to(manifest.node_types);
+  j.at("edge_types").get_to(manifest.edge_types);
+  j.at("node_type_dict").get_to(manifest.node_type_dict);
+  j.at("node_type_names").get_to(manifest.node_type_names);
+  j.at("edge_type_dict").get_to(manifest.edge_type_dict);
+  j.at("edge_type_names").get_to(manifest.edge_type_names);
+  j.at("node_properties").get_to(manifest.node_properties);
+  j.at("edge_properties").get_to(manifest.edge_properties);
+  j.at("node_indexes").get_to(manifest.node_indexes);
+  j.at("edge_indexes").get_to(manifest.edge_indexes);
+}
+
+class ImageWriter {
+public:
+  explicit ImageWriter(std::shared_ptr<arrow::io::FileOutputStream> out)
+      : out_(std::move(out)) {}
+
+  katana::Result<uint64_t> Tell() {
+    return static_cast<uint64_t>(KATANA_CHECKED(out_->Tell()));
+  }
+
+  /// Pad the image to the next aligned offset
+  /// \returns the offset
+  katana::Result<uint64_t> Align() {
+    static const uint8_t kZeros[kAlignment] = {};
+    uint64_t offset = KATANA_CHECKED(Tell());
+    uint64_t aligned = (offset + kAlignment - 1) & ~(kAlignment - 1);
+    KATANA_CHECKED(out_->Write(kZeros, aligned - offset));
+    return aligned;
+  }
+
+  /// Write count values of type T; data may be null if count is zero
+  template <typename T>
+  katana::Result<ImageSection> WriteArray(const T* data, uint64_t count) {
+    ImageSection section{KATANA_CHECKED(Align()), count * sizeof(T)};
+    KATANA_CHECKED(out_->Write(data, section.size));
+    return section;
+  }
+
+  /// Write the columns of schema as an Arrow IPC stream, which unlike the
+  /// file format does not depend on where it starts
+  template <typename GetColumn>
+  katana::Result<ImageSection> WriteProperties(
+      const std::shared_ptr<arrow::Schema>& schema, GetColumn get_column) {
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    for (int i = 0; i < schema->num_fields(); ++i) {
+      columns.emplace_back(get_column(i));
+    }
+    std::shared_ptr<arrow::Table> table = arrow::Table::Make(schema, columns);
+
+    ImageSection section{KATANA_CHECKED(Align()), 0};
+    auto writer =
+        KATANA_CHECKED(arrow::ipc::MakeStreamWriter(out_.get(), schema));
+    KATANA_CHECKED(writer->WriteTable(*table));
+    KATANA_CHECKED(writer->Close());
+    section.size = KATANA_CHECKED(Tell()) - section.offset;
+    return section;
+  }
+
+  katana::Result<void> Write(const void* data, uint64_t size) {
+    KATANA_CHECKED(out_->Write(data, size));
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> Close() {
+    KATANA_CHECKED(out_->Close());
+    return katana::ResultSuccess();
+  }
+
+private:
+  std::shared_ptr<arrow::io::FileOutputStream> out_;
+};
+
+katana::Result<ImageTopology>
+WriteDerivedTopology(ImageWriter* writer, const katana::RDGTopology& topo) {
+  using TopologyKind = katana::RDGTopology::TopologyKind;
+  ImageTopology image_topo;
+  image_topo.kind = static_cast<int>(topo.topology_state());
+  image_topo.transpose = static_cast<int>(topo.transpose_state());
+  image_topo.edge_sort = static_cast<int>(topo.edge_sort_state());
+  image_topo.node_sort = static_cast<int>(topo.node_sort_state());
+  image_topo.edge_sort_property = topo.edge_sort_property();
+  image_topo.num_edge_types = topo.edge_condensed_type_id_map_size();
+
+  // The accessors of the arrays insist that they are present, so arrays
+  // that are empty are not asked for
+  uint64_t num_nodes = topo.num_nodes();
+  uint64_t num_edges = topo.num_edges();
+  uint64_t num_adj_indices = num_nodes;
+  if (topo.topology_state() == TopologyKind::kEdgeTypeAwareTopology) {
+    // one entry per node and edge type
+    num_adj_indices *= image_topo.num_edge_types;
+  }
+  image_topo.adj_indices = KATANA_CHECKED(writer->WriteArray(
+      num_adj_indices > 0 ? topo.adj_indices() : nullptr, num_adj_indices));
+  image_topo.dests = KATANA_CHECKED(writer->WriteArray(
+      num_edges > 0 ? topo.dests() : nullptr, num_edges));
+  image_topo.edge_prop_indices = KATANA_CHECKED(writer->WriteArray(
+      num_edges > 0 ? topo.edge_index_to_property_index_map() : nullptr,
+      num_edges));
+  if (topo.topology_state() == TopologyKind::kShuffleTopology &&
+      num_nodes > 0) {
+    image_topo.node_prop_indices = KATANA_CHECKED(writer->WriteArray(
+        topo.node_index_to_property_index_map(), num_nodes));
+  }
+  image_topo.edge_types = KATANA_CHECKED(writer->WriteArray(
+      topo.edge_condensed_type_id_map(), image_topo.num_edge_types));
+  return image_topo;
+}
+
+template <typename Indexes>
+std::vector<ImageIndex>
+ImageIndexes(const Indexes& indexes) {
+  std::vector<ImageIndex> image_indexes;
+  for (const auto& index : indexes) {
+    // composite indexes are not rebuilt; like Write, the image leaves them
+    // out
+    if (index->kind() == katana::EntityIndexKind::kComposite) {
+      continue;
+    }
+    image_indexes.emplace_back(
+        ImageIndex{index->property_name(), static_cast<int>(index->kind())});
+  }
+  return image_indexes;
+}
+
+katana::Result<void>
+WriteImage(katana::PropertyGraph* pg, const fs::path& path) {
+  // the image is stamped with the version of the RDG, so it must hold
+  // nothing that version does not
+  if (pg->HasUncommittedChanges()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "graph has uncommitted changes; commit it before writing an image");
+  }
+  ImageManifest manifest;
+  manifest.rdg_dir = pg->rdg_dir().string();
+  manifest.rdg_version = KATANA_CHECKED_CONTEXT(
+      pg->CurrentVersion(), "graph images need a graph loaded from an RDG");
+  manifest.num_nodes = pg->NumNodes();
+  manifest.num_edges = pg->NumEdges();
+
+  ImageWriter writer(
+      KATANA_CHECKED(arrow::io::FileOutputStream::Open(path.string())));
+
+  const katana::GraphTopology& topo = pg->topology();
+  manifest.adj_indices =
+      KATANA_CHECKED(writer.WriteArray(topo.AdjData(), topo.NumNodes()));
+  manifest.dests =
+      KATANA_CHECKED(writer.WriteArray(topo.DestData(), topo.NumEdges()));
+  if (topo.EdgePropertyIndexData() != nullptr) {
+    manifest.edge_prop_indices = KATANA_CHECKED(
+        writer.WriteArray(topo.EdgePropertyIndexData(), topo.NumEdges()));
+  }
+  if (topo.NodePropertyIndexData() != nullptr) {
+    manifest.node_prop_indices = KATANA_CHECKED(
+        writer.WriteArray(topo.NodePropertyIndexData(), topo.NumNodes()));
+  }
+  for (const auto& rdg_topo : KATANA_CHECKED(pg->GetCachedTopologies())) {
+    manifest.derived_topologies.emplace_back(
+        KATANA_CHECKED(WriteDerivedTopology(&writer, rdg_topo)));
+  }
+
+  manifest.node_types =
+      KATANA_CHECKED(writer.WriteArray(pg->node_type_data(), pg->NumNodes()));
+  manifest.edge_types =
+      KATANA_CHECKED(writer.WriteArray(pg->edge_type_data(), pg->NumEdges()));
+  KATANA_CHECKED(pg->GetNodeTypeManager().ExtractEntityTypeInfo(
+      &manifest.node_type_dict, &manifest.node_type_names));
+  KATANA_CHECKED(pg->GetEdgeTypeManager().ExtractEntityTypeInfo(
+      &manifest.edge_type_dict, &manifest.edge_type_names));
+
+  manifest.node_properties = KATANA_CHECKED(writer.WriteProperties(
+      pg->loaded_node_schema(), [&](int i) { return pg->GetNodeProperty(i); }));
+  manifest.edge_properties = KATANA_CHECKED(writer.WriteProperties(
+      pg->loaded_edge_schema(), [&](int i) { return pg->GetEdgeProperty(i); }));
+  manifest.node_indexes = ImageIndexes(pg->node_indexes());
+  manifest.edge_indexes = ImageIndexes(pg->edge_indexes());
+
+  std::string manifest_str = KATANA_CHECKED(katana::JsonDump(manifest));
+  ImageTrailer trailer;
+  trailer.manifest_offset = KATANA_CHECKED(writer.Align());
+  trailer.manifest_size = manifest_str.size();
+  KATANA_CHECKED(writer.Write(manifest_str.data(), manifest_str.size()));
+  KATANA_CHECKED(writer.Write(&trailer, sizeof(trailer)));
+  KATANA_CHECKED(writer.Close());
+  return katana::ResultSuccess();
+}
+
+class ImageReader {
+public:
+  ImageReader(
+      std::shared_ptr<arrow::io::MemoryMappedFile> file, uint64_t size,
+      const std::string& path)
+      : file_(std::move(file)), size_(size), path_(path) {}
+
+  /// \returns the section, which shares the mapping of the image
+  katana::Result<std::shared_ptr<arrow::Buffer>> Read(
+      const ImageSection& section) {
+    if (section.offset > size_ || section.size > size_ - section.offset) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "graph image {} is truncated: expected {} bytes at {}",
+          std::quoted(path_), section.size, section.offset);
+    }
+    return KATANA_CHECKED(file_->ReadAt(section.offset, section.size));
+  }
+
+  /// \returns a pointer to the count values of type T of section, or null if
+  /// it is empty
+  template <typename T>
+  katana::Result<const T*> MapPointer(
+      const ImageSection& section, uint64_t count) {
+    if (section.size == 0) {
+      return static_cast<const T*>(nullptr);
+    }
+    if (section.size != count * sizeof(T)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "graph image {} is corrupt: {} bytes at {} should hold {} values",
+          std::quoted(path_), section.size, section.offset, count);
+    }
+    auto buffer = KATANA_CHECKED(Read(section));
+    return reinterpret_cast<const T*>(buffer->data());
+  }
+
+  /// \returns a read-only view of the values of section; the view does not
+  /// own its memory, so whatever holds it must hold mapping() too
+  template <typename T>
+  katana::Result<katana::NUMAArray<T>> MapArray(
+      const ImageSection& section, uint64_t count) {
+    const T* data = KATANA_CHECKED(MapPointer<T>(section, count));
+    if (data == nullptr) {
+      return katana::NUMAArray<T>();
+    }
+    return katana::NUMAArray<T>(const_cast<T*>(data), count);
+  }
+
+  /// \returns a copy of the values of section, for arrays that may outlive
+  /// every owner of the mapping
+  template <typename T>
+  katana::Result<katana::NUMAArray<T>> CopyArray(
+      const ImageSection& section, uint64_t count) {
+    const T* data = KATANA_CHECKED(MapPointer<T>(section, count));
+    katana::NUMAArray<T> array;
+    if (data == nullptr) {
+      return katana::Result<katana::NUMAArray<T>>(std::move(array));
+    }
+    array.allocateInterleaved(count);
+    katana::ParallelSTL::copy(data, data + count, array.begin());
+    return katana::Result<katana::NUMAArray<T>>(std::move(array));
+  }
+
+  const std::shared_ptr<arrow::io::MemoryMappedFile>& mapping() const {
+    return file_;
+  }
+
+  katana::Result<std::shared_ptr<arrow::Table>> MapProperties(
+      const ImageSection& section) {
+    std::shared_ptr<arrow::Buffer> buffer = KATANA_CHECKED(Read(section));
+    auto input = std::make_shared<arrow::io::BufferReader>(buffer);
+    auto reader =
+        KATANA_CHECKED(arrow::ipc::RecordBatchStreamReader::Open(input));
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    for (;;) {
+      std::shared_ptr<arrow::RecordBatch> batch;
+      KATANA_CHECKED(reader->ReadNext(&batch));
+      if (!batch) {
+        break;
+      }
+      batches.emplace_back(std::move(batch));
+    }
+    return KATANA_CHECKED(
+        arrow::Table::FromRecordBatches(reader->schema(), batches));
+  }
+
+  katana::Result<katana::RDGTopology> MapTopology(
+      const ImageTopology& topo, uint64_t num_nodes, uint64_t num_edges) {
+    using RDGTopology = katana::RDGTopology;
+    uint64_t num_adj_indices = num_nodes;
+    if (static_cast<RDGTopology::TopologyKind>(topo.kind) ==
+        RDGTopology::TopologyKind::kEdgeTypeAwareTopology) {
+      num_adj_indices *= topo.num_edge_types;
+    }
+    RDGTopology rdg_topo = KATANA_CHECKED(RDGTopology::Make(
+        KATANA_CHECKED(MapPointer<uint64_t>(topo.adj_indices, num_adj_indices)),
+        num_nodes, KATANA_CHECKED(MapPointer<uint32_t>(topo.dests, num_edges)),
+        num_edges, static_cast<RDGTopology::TopologyKind>(topo.kind),
+        static_cast<RDGTopology::TransposeKind>(topo.transpose),
+        static_cast<RDGTopology::EdgeSortKind>(topo.edge_sort),
+        static_cast<RDGTopology::NodeSortKind>(topo.node_sort),
+        KATANA_CHECKED(MapPointer<uint64_t>(topo.edge_prop_indices, num_edges)),
+        KATANA_CHECKED(MapPointer<uint64_t>(topo.node_prop_indices, num_nodes)),
+        topo.num_edge_types,
+        KATANA_CHECKED(MapPointer<katana::EntityTypeID>(
+            topo.edge_types, topo.num_edge_types)),
+        0, nullptr));
+    rdg_topo.set_edge_sort_property(topo.edge_sort_property);
+    return katana::Result<RDGTopology>(std::move(rdg_topo));
+  }
+
+private:
+  std::shared_ptr<arrow::io::MemoryMappedFile> file_;
+  uint64_t size_;
+  std::string path_;
+};
+
+katana::Result<ImageManifest>
+ReadManifest(ImageReader* reader, uint64_t size, const std::string& path) {
+  if (size < sizeof(ImageTrailer)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} is not a graph image",
+        std::quoted(path));
+  }
+  ImageTrailer trailer;
+  auto trailer_buffer = KATANA_CHECKED(
+      reader->Read({size - sizeof(trailer), sizeof(trailer)}));
+  std::memcpy(&trailer, trailer_buffer->data(), sizeof(trailer));
+  if (trailer.magic != kImageMagic || trailer.version != kImageVersion) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} is not a graph image of version {}: magic {:#x} version {}",
+        std::quoted(path), kImageVersion, trailer.magic, trailer.version);
+  }
+
+  auto manifest_buffer = KATANA_CHECKED(
+      reader->Read({trailer.manifest_offset, trailer.manifest_size}));
+  std::string_view manifest_str(
+      reinterpret_cast<const char*>(manifest_buffer->data()),
+      manifest_buffer->size());
+  return KATANA_CHECKED_CONTEXT(
+      katana::JsonParse<ImageManifest>(manifest_str),
+      "reading the manifest of graph image {}", std::quoted(path));
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::WriteGraphImage(PropertyGraph* pg, const std::string& path) {
+  // Write next to the final file and rename it into place, so that loaders
+  // never see a partial image
+  fs::path final_path(path);
+  fs::path tmp_path = final_path;
+  tmp_path += fmt::format(".tmp-{}", getpid());
+  boost::system::error_code ec;
+  if (auto res = WriteImage(pg, tmp_path); !res) {
+    fs::remove(tmp_path, ec);
+    return res.error().WithContext("writing graph image {}", std::quoted(path));
+  }
+  fs::rename(tmp_path, final_path, ec);
+  if (ec) {
+    fs::remove(tmp_path, ec);
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "renaming {} to {}: {}",
+        tmp_path.string(), path, ec.message());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<katana::PropertyGraph>>
+katana::LoadGraphImage(const std::string& path, const URI& rdg_dir) {
+  std::shared_ptr<arrow::io::MemoryMappedFile> file = KATANA_CHECKED_CONTEXT(
+      arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ),
+      "loading graph image {}", std::quoted(path));
+  uint64_t size = KATANA_CHECKED(file->GetSize());
+  ImageReader reader(std::move(file), size, path);
+  ImageManifest manifest = KATANA_CHECKED(ReadManifest(&reader, size, path));
+
+  URI image_rdg_dir = KATANA_CHECKED(URI::Make(manifest.rdg_dir));
+  if (!(image_rdg_dir.StripSep() == rdg_dir.StripSep())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "graph image {} is of {}, not {}",
+        std::quoted(path), manifest.rdg_dir, rdg_dir);
+  }
+  RDGManifest rdg_manifest = KATANA_CHECKED(RDGManifest::Make(rdg_dir));
+  if (rdg_manifest.version() != manifest.rdg_version) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "graph image {} is of version {} of {}, which is now at version {}",
+        std::quoted(path), manifest.rdg_version, rdg_dir,
+        rdg_manifest.version());
+  }
+
+  using Edge = GraphTopology::Edge;
+  using Node = GraphTopology::Node;
+  using PropertyIndex = GraphTopology::PropertyIndex;
+  uint64_t num_nodes = manifest.num_nodes;
+  uint64_t num_edges = manifest.num_edges;
+  // The topology owns the mapping, so that views of the topology, e.g., its
+  // arrays in Python, may outlive the graph. The entity type ids are shared
+  // with snapshots, which hold no reference to the topology, so they are
+  // copied; they are the smallest of the arrays.
+  GraphTopology topo(
+      KATANA_CHECKED(reader.MapArray<Edge>(manifest.adj_indices, num_nodes)),
+      KATANA_CHECKED(reader.MapArray<Node>(manifest.dests, num_edges)),
+      KATANA_CHECKED(reader.MapArray<PropertyIndex>(
+          manifest.edge_prop_indices, num_edges)),
+      KATANA_CHECKED(reader.MapArray<PropertyIndex>(
+          manifest.node_prop_indices, num_nodes)),
+      reader.mapping());
+  auto node_types = KATANA_CHECKED(
+      reader.CopyArray<EntityTypeID>(manifest.node_types, num_nodes));
+  auto edge_types = KATANA_CHECKED(
+      reader.CopyArray<EntityTypeID>(manifest.edge_types, num_edges));
+  if (node_types.size() != num_nodes || edge_types.size() != num_edges) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "graph image {} has no entity types",
+        std::quoted(path));
+  }
+  std::shared_ptr<PropertyGraph> graph = KATANA_CHECKED(PropertyGraph::Make(
+      rdg_dir, std::move(topo), std::move(node_types), std::move(edge_types),
+      KATANA_CHECKED(EntityTypeManager::Make(
+          manifest.node_type_dict, manifest.node_type_names)),
+      KATANA_CHECKED(EntityTypeManager::Make(
+          manifest.edge_type_dict, manifest.edge_type_names))));
+
+  // The property arrays keep their own references to the mapping
+  katana::TxnContext txn_ctx;
+  auto node_props =
+      KATANA_CHECKED(reader.MapProperties(manifest.node_properties));
+  if (node_props->num_columns() > 0) {
+    KATANA_CHECKED(graph->AddNodeProperties(node_props, &txn_ctx));
+  }
+  auto edge_props =
+      KATANA_CHECKED(reader.MapProperties(manifest.edge_properties));
+  if (edge_props->num_columns() > 0) {
+    KATANA_CHECKED(graph->AddEdgeProperties(edge_props, &txn_ctx));
+  }
+
+  std::vector<RDGTopology> rdg_topos;
+  for (const auto& image_topo : manifest.derived_topologies) {
+    rdg_topos.emplace_back(
+        KATANA_CHECKED(reader.MapTopology(image_topo, num_nodes, num_edges)));
+  }
+  KATANA_CHECKED_CONTEXT(
+      graph->AddCachedTopologies(&rdg_topos),
+      "restoring derived topologies of graph image {}", std::quoted(path));
+
+  for (const auto& index : manifest.node_indexes) {
+    KATANA_CHECKED(graph->MakeNodeIndex(
+        index.property, static_cast<EntityIndexKind>(index.kind)));
+  }
+  for (const auto& index : manifest.edge_indexes) {
+    KATANA_CHECKED(graph->MakeEdgeIndex(
+        index.property, static_cast<EntityIndexKind>(index.kind)));
+  }
+
+  return graph;
+}
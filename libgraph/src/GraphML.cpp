@@ -1,11 +1,20 @@
 #include "katana/GraphML.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <cctype>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <optional>
+#include <string_view>
+#include <unordered_set>
 #include <vector>
 
 #include <boost/algorithm/string.hpp>
@@ -16,6 +25,7 @@
 #include "katana/GraphMLSchema.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
 #include "katana/SharedMemSys.h"
 #include "katana/Threads.h"
 
@@ -592,30 +602,19 @@ ProcessGraph(
   }
 }
 
-}  // end of unnamed namespace
-
-katana::Result<katana::GraphComponents>
-katana::ConvertGraphML(
-    const std::string& infilename, size_t chunk_size, bool verbose) {
-  xmlTextReaderPtr reader;
-
-  reader = xmlNewTextReaderFilename(infilename.c_str());
-  if (reader == NULL) {
-    return KATANA_ERROR(ErrorCode::NotFound, "Unable to open {}", infilename);
-  }
-  auto res = ConvertGraphML(reader, chunk_size, verbose);
-  xmlFreeTextReader(reader);
-  return res;
-}
-
-katana::Result<katana::GraphComponents>
-katana::ConvertGraphML(
-    xmlTextReaderPtr reader, size_t chunk_size, bool verbose) {
+/*
+ * reader should be pointing at the start of the document before calling
+ *
+ * parses the keys and the first graph of a GraphML document into builder;
+ * the columns of schema, if any, are added after the declared keys
+ */
+katana::Result<void>
+ProcessDocument(
+    xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder,
+    const katana::ImportSchema* schema, bool verbose) {
   int ret = 0;
   bool finishedGraph = false;
 
-  katana::PropertyGraphBuilder builder{chunk_size};
-
   // procedure:
   // read in "key" xml nodes and add them to nodeKeys and edgeKeys
   // once we reach the first "graph" xml node we parse it using the above keys
@@ -633,16 +632,19 @@ katana::ConvertGraphML(
         if (!key.id.empty() && key.id != std::string("label") &&
             key.id != std::string("IGNORE")) {
           if (key.for_node) {
-            builder.AddBuilder(std::move(key));
+            builder->AddBuilder(std::move(key));
           } else if (key.for_edge) {
-            builder.AddBuilder(std::move(key));
+            builder->AddBuilder(std::move(key));
           }
         }
       } else if (xmlStrEqual(name, BAD_CAST "graph")) {
         if (verbose) {
           std::cout << "Finished processing property headers\n";
         }
-        ProcessGraph(reader, &builder, false);
+        if (schema != nullptr) {
+          builder->ApplySchema(*schema);
+        }
+        ProcessGraph(reader, builder, false);
         finishedGraph = true;
       }
     }
@@ -656,5 +658,549 @@ katana::ConvertGraphML(
         "To remove invalid characters use: \"sed -i $'s/[^[:print:]\t]//g' "
         "<file>\", warning this will alter the original file");
   }
+  return katana::ResultSuccess();
+}
+
+/*********************************************/
+/* Functions for parsing GraphML in parallel */
+/*********************************************/
+
+// files smaller than this are parsed serially unless asked otherwise
+constexpr size_t kMinParallelBytes = size_t{64} << 20;
+// the least size of a piece when the number of pieces is picked
+constexpr size_t kMinPieceBytes = size_t{16} << 20;
+constexpr size_t kPiecesPerThread = 4;
+
+// a read only mapping of a whole file
+struct MappedFile {
+  const char* data{nullptr};
+  size_t size{0};
+
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile() {
+    if (data != nullptr) {
+      munmap(const_cast<char*>(data), size);
+    }
+  }
+};
+
+katana::Result<void>
+MapFile(const std::string& filename, MappedFile* file) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "Unable to open {}: {}", filename,
+        katana::ResultErrno().message());
+  }
+  struct stat buf;
+  if (fstat(fd, &buf) != 0) {
+    std::error_code ec = katana::ResultErrno();
+    close(fd);
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "Unable to stat {}: {}", filename,
+        ec.message());
+  }
+  file->size = buf.st_size;
+  if (file->size > 0) {
+    void* data = mmap(nullptr, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      std::error_code ec = katana::ResultErrno();
+      close(fd);
+      return KATANA_ERROR(
+          katana::ErrorCode::OutOfMemory, "Unable to map {}: {}", filename,
+          ec.message());
+    }
+    file->data = static_cast<const char*>(data);
+  }
+  close(fd);
+  return katana::ResultSuccess();
+}
+
+// whether text has a start tag of element name at pos
+bool
+IsStartTag(std::string_view text, size_t pos, std::string_view name) {
+  size_t end = pos + 1 + name.size();
+  if (end >= text.size() || text[pos] != '<' ||
+      text.compare(pos + 1, name.size(), name) != 0) {
+    return false;
+  }
+  char next = text[end];
+  return std::isspace(static_cast<unsigned char>(next)) || next == '>' ||
+         next == '/';
+}
+
+// the position of the first node or edge start tag at or after from in
+// text, or the size of text if there is none
+size_t
+NextElement(std::string_view text, size_t from) {
+  for (size_t pos = text.find('<', from); pos != std::string_view::npos;
+       pos = text.find('<', pos + 1)) {
+    if (IsStartTag(text, pos, "node") || IsStartTag(text, pos, "edge")) {
+      return pos;
+    }
+  }
+  return text.size();
+}
+
+// A GraphML document split into the text before the elements of its graph,
+// pieces of those elements that each start at a node or edge element, and
+// the text after them. Each piece between the header and the footer is a
+// document with part of the graph.
+struct SplitDocument {
+  std::string_view header;
+  std::vector<std::string_view> pieces;
+  std::string_view footer;
+};
+
+// Split text into about num_pieces pieces; \returns nothing if the graph
+// cannot be split safely
+std::optional<SplitDocument>
+Split(std::string_view text, size_t num_pieces) {
+  size_t graph = text.find("<graph");
+  // skip the graphml element
+  while (graph != std::string_view::npos && !IsStartTag(text, graph, "graph")) {
+    graph = text.find("<graph", graph + 1);
+  }
+  size_t open_end = text.find('>', graph);
+  size_t close = text.rfind("</graph>");
+  if (graph == std::string_view::npos || open_end == std::string_view::npos ||
+      text[open_end - 1] == '/' || close == std::string_view::npos ||
+      close < open_end) {
+    return std::nullopt;
+  }
+
+  SplitDocument doc;
+  doc.header = text.substr(0, open_end + 1);
+  doc.footer = text.substr(close);
+  std::string_view body =
+      text.substr(open_end + 1, close - open_end - 1);
+  size_t begin = NextElement(body, 0);
+  for (size_t i = 1; i <= num_pieces; ++i) {
+    size_t end = i == num_pieces
+                     ? body.size()
+                     : NextElement(
+                           body, std::max(
+                                     begin + 1, body.size() * i / num_pieces));
+    if (end > begin) {
+      doc.pieces.emplace_back(body.substr(begin, end - begin));
+      begin = end;
+    }
+  }
+  if (doc.pieces.empty()) {
+    return std::nullopt;
+  }
+  return doc;
+}
+
+// the parts of a document that ReadParts passes, in order, to libxml2
+struct DocumentParts {
+  std::vector<std::string_view> parts;
+  size_t part{0};
+  size_t offset{0};
+};
+
+int
+ReadParts(void* context, char* buffer, int len) {
+  auto* doc = static_cast<DocumentParts*>(context);
+  int read = 0;
+  while (read < len && doc->part < doc->parts.size()) {
+    std::string_view part = doc->parts[doc->part];
+    size_t n = std::min<size_t>(len - read, part.size() - doc->offset);
+    std::memcpy(buffer + read, part.data() + doc->offset, n);
+    read += n;
+    doc->offset += n;
+    if (doc->offset == part.size()) {
+      doc->part++;
+      doc->offset = 0;
+    }
+  }
+  return read;
+}
+
+int
+CloseParts(void*) {
+  return 0;
+}
+
+// What a scan of a piece found: how many nodes and edges it has, and the
+// property columns and labels that parsing it adds beyond the declared
+// keys, in the order that parsing adds them
+struct PieceScan {
+  size_t num_nodes{0};
+  size_t num_edges{0};
+  std::vector<PropertyKey> keys;
+  std::vector<LabelRule> labels;
+  // whether the piece has comments or CDATA sections, which the scan
+  // does not read
+  bool escaped{false};
+};
+
+// text with its entity and character references replaced, and its
+// whitespace normalized as libxml2 normalizes attribute values when
+// is_attribute
+std::string
+DecodeText(std::string_view text, bool is_attribute) {
+  std::string decoded;
+  decoded.reserve(text.size());
+  for (size_t i = 0; i < text.size(); ++i) {
+    char c = text[i];
+    size_t end = c == '&' ? text.find(';', i) : std::string_view::npos;
+    if (end == std::string_view::npos) {
+      bool space = is_attribute && (c == '\t' || c == '\n' || c == '\r');
+      decoded += space ? ' ' : c;
+      continue;
+    }
+    std::string_view ref = text.substr(i + 1, end - i - 1);
+    i = end;
+    if (ref == "amp") {
+      decoded += '&';
+    } else if (ref == "lt") {
+      decoded += '<';
+    } else if (ref == "gt") {
+      decoded += '>';
+    } else if (ref == "quot") {
+      decoded += '"';
+    } else if (ref == "apos") {
+      decoded += '\'';
+    } else if (!ref.empty() && ref[0] == '#') {
+      bool hex = ref.size() > 1 && (ref[1] == 'x' || ref[1] == 'X');
+      uint32_t code = std::strtoul(
+          std::string(ref.substr(hex ? 2 : 1)).c_str(), nullptr, hex ? 16 : 10);
+      // UTF-8
+      if (code < 0x80) {
+        decoded += static_cast<char>(code);
+      } else if (code < 0x800) {
+        decoded += static_cast<char>(0xc0 | (code >> 6));
+        decoded += static_cast<char>(0x80 | (code & 0x3f));
+      } else if (code < 0x10000) {
+        decoded += static_cast<char>(0xe0 | (code >> 12));
+        decoded += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        decoded += static_cast<char>(0x80 | (code & 0x3f));
+      } else {
+        decoded += static_cast<char>(0xf0 | (code >> 18));
+        decoded += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+        decoded += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        decoded += static_cast<char>(0x80 | (code & 0x3f));
+      }
+    } else {
+      decoded += text.substr(i - ref.size() - 1, ref.size() + 2);
+    }
+  }
+  return decoded;
+}
+
+// A start or end tag of a piece
+struct Tag {
+  std::string_view name;
+  std::vector<std::pair<std::string_view, std::string>> attributes;
+  bool is_end{false};
+  bool is_empty{false};
+  // the position just past the tag
+  size_t end{0};
+};
+
+// the tag at pos, which is a '<', of text; \returns nothing if the tag is
+// not closed
+std::optional<Tag>
+ParseTag(std::string_view text, size_t pos) {
+  auto is_space = [](char c) {
+    return std::isspace(static_cast<unsigned char>(c));
+  };
+  auto is_name_end = [&](char c) {
+    return is_space(c) || c == '>' || c == '/' || c == '=';
+  };
+  Tag tag;
+  size_t i = pos + 1;
+  if (i < text.size() && (text[i] == '/' || text[i] == '?')) {
+    tag.is_end = text[i] == '/';
+    ++i;
+  }
+  size_t name = i;
+  while (i < text.size() && !is_name_end(text[i])) {
+    ++i;
+  }
+  tag.name = text.substr(name, i - name);
+  while (i < text.size() && text[i] != '>') {
+    if (is_space(text[i]) || text[i] == '/' || text[i] == '?') {
+      tag.is_empty = text[i] == '/';
+      ++i;
+      continue;
+    }
+    size_t attr = i;
+    while (i < text.size() && !is_name_end(text[i])) {
+      ++i;
+    }
+    std::string_view attr_name = text.substr(attr, i - attr);
+    while (i < text.size() && is_space(text[i])) {
+      ++i;
+    }
+    if (i == text.size() || text[i] != '=') {
+      continue;
+    }
+    ++i;
+    while (i < text.size() && is_space(text[i])) {
+      ++i;
+    }
+    if (i == text.size() || (text[i] != '"' && text[i] != '\'')) {
+      continue;
+    }
+    size_t close = text.find(text[i], i + 1);
+    if (close == std::string_view::npos) {
+      return std::nullopt;
+    }
+    tag.attributes.emplace_back(
+        attr_name, DecodeText(text.substr(i + 1, close - i - 1), true));
+    i = close + 1;
+  }
+  if (i == text.size()) {
+    return std::nullopt;
+  }
+  tag.end = i + 1;
+  return tag;
+}
+
+// the labels of a labels value, split as ProcessNode splits them
+std::vector<std::string>
+SplitLabels(std::string data) {
+  if (!data.empty() && data.front() == ':') {
+    data.erase(0, 1);
+  }
+  std::vector<std::string> labels;
+  boost::split(labels, data, boost::is_any_of(":"));
+  return labels;
+}
+
+// Scan a piece of nodes and edges for the columns that ProcessNode and
+// ProcessEdge add, without building anything; the rules match theirs
+PieceScan
+ScanPiece(std::string_view piece) {
+  PieceScan scan;
+  if (piece.find("<!") != std::string_view::npos) {
+    scan.escaped = true;
+    return scan;
+  }
+  std::unordered_set<std::string> node_keys;
+  std::unordered_set<std::string> edge_keys;
+  std::unordered_set<std::string> node_labels;
+  std::unordered_set<std::string> edge_labels;
+
+  // the element being scanned
+  bool in_node = false;
+  bool in_edge = false;
+  bool valid = false;
+  bool extracted_labels = false;
+  std::vector<std::string> labels;
+
+  auto finish = [&]() {
+    if (valid) {
+      auto& seen = in_node ? node_labels : edge_labels;
+      for (const std::string& label : labels) {
+        // edges only take a non-empty type
+        if ((in_node || !label.empty()) && seen.emplace(label).second) {
+          scan.labels.emplace_back(label, in_node, in_edge, label);
+        }
+      }
+    }
+    in_node = in_edge = valid = extracted_labels = false;
+    labels.clear();
+  };
+
+  for (size_t pos = piece.find('<'); pos != std::string_view::npos;
+       pos = piece.find('<', pos)) {
+    std::optional<Tag> tag = ParseTag(piece, pos);
+    if (!tag) {
+      break;
+    }
+    pos = tag->end;
+    if (tag->is_end) {
+      if ((in_node && tag->name == "node") ||
+          (in_edge && tag->name == "edge")) {
+        finish();
+      }
+      continue;
+    }
+    auto attribute = [&](std::string_view name) -> const std::string* {
+      for (const auto& [attr_name, value] : tag->attributes) {
+        if (attr_name == name) {
+          return &value;
+        }
+      }
+      return nullptr;
+    };
+    if (tag->name == "node" || tag->name == "edge") {
+      finish();
+      in_node = tag->name == "node";
+      in_edge = !in_node;
+      if (in_node) {
+        scan.num_nodes++;
+        const std::string* id = attribute("id");
+        valid = id != nullptr && !id->empty();
+      } else {
+        scan.num_edges++;
+        const std::string* source = attribute("source");
+        const std::string* target = attribute("target");
+        valid = source != nullptr && !source->empty() && target != nullptr &&
+                !target->empty();
+      }
+      for (const auto& [name, value] : tag->attributes) {
+        if (name == "labels" || name == "label") {
+          labels = in_node ? SplitLabels(value)
+                           : std::vector<std::string>{value};
+          extracted_labels = true;
+        }
+      }
+      if (tag->is_empty) {
+        finish();
+      }
+    } else if (tag->name == "data" && (in_node || in_edge)) {
+      const std::string* key = attribute("key");
+      if (key == nullptr || key->empty()) {
+        continue;
+      }
+      if (*key == "label" || *key == "labels") {
+        if (!extracted_labels) {
+          std::string value;
+          if (!tag->is_empty) {
+            size_t text_end = piece.find('<', pos);
+            value = DecodeText(piece.substr(pos, text_end - pos), false);
+          }
+          labels = in_node ? SplitLabels(value)
+                           : std::vector<std::string>{value};
+          extracted_labels = true;
+        }
+      } else if (*key != "IGNORE" && valid) {
+        auto& seen = in_node ? node_keys : edge_keys;
+        if (seen.emplace(*key).second) {
+          scan.keys.emplace_back(
+              *key, in_node, in_edge, *key, ImportDataType::kString, false);
+        }
+      }
+    }
+  }
+  finish();
+  return scan;
+}
+
+// the schema of the pieces with the given scans, with their columns in the
+// order that parsing the pieces one after another would add them
+katana::ImportSchema
+MergeScans(const std::vector<PieceScan>& scans) {
+  katana::ImportSchema schema;
+  std::unordered_set<std::string> keys;
+  std::unordered_set<std::string> labels;
+  for (const PieceScan& scan : scans) {
+    for (const PropertyKey& key : scan.keys) {
+      if (keys.emplace((key.for_node ? "n" : "e") + key.id).second) {
+        schema.keys.emplace_back(key);
+      }
+    }
+    for (const LabelRule& rule : scan.labels) {
+      if (labels.emplace((rule.for_node ? "n" : "e") + rule.id).second) {
+        schema.labels.emplace_back(rule);
+      }
+    }
+  }
+  return schema;
+}
+
+// parse the pieces of doc in parallel, each into a shard of a sharded
+// builder, given the scans of the pieces
+katana::Result<katana::GraphComponents>
+ProcessPieces(
+    const std::string& infilename, const SplitDocument& doc,
+    const std::vector<PieceScan>& scans, size_t chunk_size, bool verbose) {
+  size_t num_pieces = doc.pieces.size();
+  katana::ShardedPropertyGraphBuilder builder(num_pieces, chunk_size);
+  katana::ImportSchema schema = MergeScans(scans);
+  std::vector<std::optional<katana::CopyableErrorInfo>> errors(num_pieces);
+
+  // libxml2 must be initialized before readers are made in parallel
+  xmlInitParser();
+  katana::do_all(
+      katana::iterate(size_t{0}, num_pieces),
+      [&](size_t i) {
+        DocumentParts parts{{doc.header, doc.pieces[i], doc.footer}};
+        xmlTextReaderPtr reader = xmlReaderForIO(
+            ReadParts, CloseParts, &parts, infilename.c_str(), nullptr, 0);
+        if (reader == nullptr) {
+          errors[i] = KATANA_ERROR(
+              katana::ErrorCode::OutOfMemory, "Unable to make an xml reader");
+          return;
+        }
+        builder.shard(i).Reserve(scans[i].num_nodes, scans[i].num_edges);
+        if (auto res =
+                ProcessDocument(reader, &builder.shard(i), &schema, false);
+            !res) {
+          errors[i] = res.error();
+        }
+        xmlFreeTextReader(reader);
+      },
+      katana::steal(), katana::no_stats());
+  for (size_t i = 0; i < num_pieces; ++i) {
+    if (errors[i]) {
+      return errors[i]->WithContext("piece {} of {}", i, num_pieces);
+    }
+  }
+  if (verbose) {
+    std::cout << "Finished parsing " << num_pieces << " pieces of "
+              << infilename << "\n";
+  }
+  return builder.Finish(verbose);
+}
+
+}  // end of unnamed namespace
+
+katana::Result<katana::GraphComponents>
+katana::ConvertGraphML(
+    const std::string& infilename, size_t chunk_size, bool verbose,
+    size_t num_pieces) {
+  MappedFile file;
+  if (num_pieces != 1) {
+    KATANA_CHECKED(MapFile(infilename, &file));
+  }
+  if (num_pieces == 0 && file.size >= kMinParallelBytes) {
+    num_pieces = std::min(
+        kPiecesPerThread * katana::getActiveThreads(),
+        file.size / kMinPieceBytes);
+  }
+  if (num_pieces > 1) {
+    std::string_view text(file.data, file.size);
+    // comments and CDATA sections may hide tags from the split
+    katana::GReduceLogicalOr escaped;
+    std::optional<SplitDocument> doc = Split(text, num_pieces);
+    std::vector<PieceScan> scans;
+    if (doc) {
+      scans.resize(doc->pieces.size());
+      katana::do_all(
+          katana::iterate(size_t{0}, doc->pieces.size()),
+          [&](size_t i) {
+            scans[i] = ScanPiece(doc->pieces[i]);
+            escaped.update(scans[i].escaped);
+          },
+          katana::steal(), katana::no_stats());
+    }
+    if (doc && !escaped.reduce()) {
+      return ProcessPieces(infilename, *doc, scans, chunk_size, verbose);
+    }
+  }
+
+  xmlTextReaderPtr reader;
+
+  reader = xmlNewTextReaderFilename(infilename.c_str());
+  if (reader == NULL) {
+    return KATANA_ERROR(ErrorCode::NotFound, "Unable to open {}", infilename);
+  }
+  auto res = ConvertGraphML(reader, chunk_size, verbose);
+  xmlFreeTextReader(reader);
+  return res;
+}
+
+katana::Result<katana::GraphComponents>
+katana::ConvertGraphML(
+    xmlTextReaderPtr reader, size_t chunk_size, bool verbose) {
+  katana::PropertyGraphBuilder builder{chunk_size};
+  KATANA_CHECKED(ProcessDocument(reader, &builder, nullptr, verbose));
   return builder.Finish(verbose);
 }
@@ -0,0 +1,43 @@
+#include "katana/GraphMemoryUsage.h"
+
+namespace {
+
+uint64_t
+SumBytes(const std::vector<katana::MemoryUsageItem>& items) {
+  uint64_t total = 0;
+  for (const auto& item : items) {
+    total += item.bytes;
+  }
+  return total;
+}
+
+void
+PrintItems(
+    std::ostream& os, const std::string& title,
+    const std::vector<katana::MemoryUsageItem>& items) {
+  os << title << " = " << SumBytes(items) << " bytes" << std::endl;
+  for (const auto& item : items) {
+    os << "  " << item.name << " = " << item.bytes << " bytes" << std::endl;
+  }
+}
+
+}  // namespace
+
+uint64_t
+katana::GraphMemoryUsage::TotalBytes() const {
+  return topology + SumBytes(views) + SumBytes(node_properties) +
+         SumBytes(edge_properties) + entity_type_ids + SumBytes(indexes) +
+         SumBytes(other);
+}
+
+void
+katana::GraphMemoryUsage::Print(std::ostream& os) const {
+  os << "Total = " << TotalBytes() << " bytes" << std::endl;
+  os << "Topology = " << topology << " bytes" << std::endl;
+  PrintItems(os, "Views", views);
+  PrintItems(os, "Node properties", node_properties);
+  PrintItems(os, "Edge properties", edge_properties);
+  os << "Entity type ids = " << entity_type_ids << " bytes" << std::endl;
+  PrintItems(os, "Indexes", indexes);
+  PrintItems(os, "Other", other);
+}
@@ -0,0 +1,76 @@
+#include "katana/GraphSnapshot.h"
+
+#include <iomanip>
+
+#include "katana/ErrorCode.h"
+#include "katana/PropertyGraph.h"
+
+namespace {
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+GetColumn(const arrow::Table& table, const std::string& name) {
+  std::shared_ptr<arrow::ChunkedArray> column = table.GetColumnByName(name);
+  if (!column) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no property named {}",
+        std::quoted(name));
+  }
+  return column;
+}
+
+}  // namespace
+
+katana::Result<std::shared_ptr<const katana::GraphSnapshot>>
+katana::GraphSnapshot::Make(const PropertyGraph& pg, uint64_t version) {
+  if (pg.IsTransformed()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "snapshots of projected graphs are not supported");
+  }
+  std::shared_ptr<GraphSnapshot> snapshot(new GraphSnapshot());
+  snapshot->version_ = version;
+  snapshot->topology_ = pg.pg_view_cache_.ShareDefaultTopology();
+  snapshot->node_properties_ = pg.rdg_->node_properties();
+  snapshot->edge_properties_ = pg.rdg_->edge_properties();
+  snapshot->node_entity_type_ids_ = pg.node_entity_type_ids_;
+  snapshot->edge_entity_type_ids_ = pg.edge_entity_type_ids_;
+  snapshot->node_type_manager_ = pg.GetNodeTypeManager();
+  snapshot->edge_type_manager_ = pg.GetEdgeTypeManager();
+  return std::shared_ptr<const GraphSnapshot>(std::move(snapshot));
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::GraphSnapshot::GetNodeProperty(const std::string& name) const {
+  return GetColumn(*node_properties_, name);
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::GraphSnapshot::GetEdgeProperty(const std::string& name) const {
+  return GetColumn(*edge_properties_, name);
+}
+
+katana::Result<std::unique_ptr<katana::SnapshotPublisher>>
+katana::SnapshotPublisher::Make(const PropertyGraph& pg) {
+  std::unique_ptr<SnapshotPublisher> publisher(new SnapshotPublisher());
+  publisher->latest_ = KATANA_CHECKED(GraphSnapshot::Make(pg, 0));
+  return std::unique_ptr<SnapshotPublisher>(std::move(publisher));
+}
+
+std::shared_ptr<const katana::GraphSnapshot>
+katana::SnapshotPublisher::Pin() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return latest_;
+}
+
+katana::Result<uint64_t>
+katana::SnapshotPublisher::Publish(const PropertyGraph& pg) {
+  // Taken outside the lock so that readers only wait for the swap
+  uint64_t version = Pin()->version() + 1;
+  std::shared_ptr<const GraphSnapshot> snapshot =
+      KATANA_CHECKED(GraphSnapshot::Make(pg, version));
+  std::lock_guard<std::mutex> lock(mutex_);
+  latest_.swap(snapshot);
+  // the old snapshot is released after the lock, once snapshot goes out of
+  // scope, if no reader pins it
+  return version;
+}
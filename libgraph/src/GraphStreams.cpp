@@ -0,0 +1,284 @@
+#include "katana/GraphStreams.h"
+
+#include <algorithm>
+#include <charconv>
+#include <iomanip>
+#include <sstream>
+
+#include "katana/ErrorCode.h"
+
+namespace {
+
+constexpr const char* kKindNames[] = {"nodes", "edges", "topology"};
+
+/// A buffer over memory of a snapshot, e.g., its topology, that keeps the
+/// snapshot alive
+class SnapshotBuffer : public arrow::Buffer {
+public:
+  SnapshotBuffer(
+      const void* data, int64_t size,
+      std::shared_ptr<const katana::GraphSnapshot> snapshot)
+      : arrow::Buffer(static_cast<const uint8_t*>(data), size),
+        snapshot_(std::move(snapshot)) {}
+
+private:
+  std::shared_ptr<const katana::GraphSnapshot> snapshot_;
+};
+
+std::shared_ptr<arrow::Schema>
+TopologySchema() {
+  return arrow::schema({
+      arrow::field("src", arrow::uint32(), false),
+      arrow::field("dst", arrow::uint32(), false),
+      arrow::field("property_index", arrow::uint64(), false),
+  });
+}
+
+const std::shared_ptr<arrow::Table>&
+PropertyTable(
+    const katana::GraphSnapshot& snapshot, katana::GraphStreamKind kind) {
+  return kind == katana::GraphStreamKind::kNodeProperties
+             ? snapshot.node_properties()
+             : snapshot.edge_properties();
+}
+
+/// The columns of ticket from the property table of its kind
+katana::Result<std::shared_ptr<arrow::Table>>
+SelectColumns(
+    const katana::GraphSnapshot& snapshot,
+    const katana::GraphStreamTicket& ticket) {
+  const std::shared_ptr<arrow::Table>& table =
+      PropertyTable(snapshot, ticket.kind);
+  if (ticket.columns.empty()) {
+    return table;
+  }
+  std::vector<int> indices;
+  for (const auto& name : ticket.columns) {
+    int index = table->schema()->GetFieldIndex(name);
+    if (index < 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no property named {}",
+          std::quoted(name));
+    }
+    indices.emplace_back(index);
+  }
+  return KATANA_CHECKED(table->SelectColumns(indices));
+}
+
+class PropertyStreamReader : public arrow::RecordBatchReader {
+public:
+  PropertyStreamReader(std::shared_ptr<arrow::Table> table, int64_t max_rows)
+      : table_(std::move(table)), reader_(*table_) {
+    reader_.set_chunksize(max_rows);
+  }
+
+  std::shared_ptr<arrow::Schema> schema() const override {
+    return table_->schema();
+  }
+
+  arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) override {
+    return reader_.ReadNext(batch);
+  }
+
+private:
+  // reader_ refers to the table, which in turn shares the buffers of the
+  // snapshot
+  std::shared_ptr<arrow::Table> table_;
+  arrow::TableBatchReader reader_;
+};
+
+class TopologyStreamReader : public arrow::RecordBatchReader {
+public:
+  TopologyStreamReader(
+      std::shared_ptr<const katana::GraphSnapshot> snapshot, uint64_t begin,
+      uint64_t end, int64_t max_rows)
+      : snapshot_(std::move(snapshot)),
+        schema_(TopologySchema()),
+        next_(begin),
+        end_(end),
+        max_rows_(max_rows) {
+    if (begin >= end) {
+      return;
+    }
+    // The node of the first edge
+    const katana::GraphTopology& topo = snapshot_->topology();
+    auto nodes = topo.Nodes();
+    node_ = *std::upper_bound(
+        nodes.begin(), nodes.end(), begin,
+        [&](uint64_t edge, katana::GraphTopology::Node n) {
+          return edge < *topo.OutEdges(n).end();
+        });
+  }
+
+  std::shared_ptr<arrow::Schema> schema() const override { return schema_; }
+
+  arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) override {
+    if (next_ >= end_) {
+      *batch = nullptr;
+      return arrow::Status::OK();
+    }
+    const katana::GraphTopology& topo = snapshot_->topology();
+    int64_t num_rows =
+        std::min<int64_t>(max_rows_, static_cast<int64_t>(end_ - next_));
+
+    ARROW_ASSIGN_OR_RAISE(
+        std::shared_ptr<arrow::Buffer> src,
+        arrow::AllocateBuffer(num_rows * sizeof(uint32_t)));
+    ARROW_ASSIGN_OR_RAISE(
+        std::shared_ptr<arrow::Buffer> prop,
+        arrow::AllocateBuffer(num_rows * sizeof(uint64_t)));
+    auto* src_data = reinterpret_cast<uint32_t*>(src->mutable_data());
+    auto* prop_data = reinterpret_cast<uint64_t*>(prop->mutable_data());
+    for (int64_t i = 0; i < num_rows; ++i) {
+      uint64_t edge = next_ + i;
+      while (*topo.OutEdges(node_).end() <= edge) {
+        ++node_;
+      }
+      src_data[i] = node_;
+      prop_data[i] = topo.GetEdgePropertyIndexFromOutEdge(edge);
+    }
+    auto dst = std::make_shared<SnapshotBuffer>(
+        topo.DestData() + next_, num_rows * sizeof(uint32_t), snapshot_);
+
+    *batch = arrow::RecordBatch::Make(
+        schema_, num_rows,
+        {
+            arrow::MakeArray(arrow::ArrayData::Make(
+                arrow::uint32(), num_rows, {nullptr, std::move(src)}, 0)),
+            arrow::MakeArray(arrow::ArrayData::Make(
+                arrow::uint32(), num_rows, {nullptr, std::move(dst)}, 0)),
+            arrow::MakeArray(arrow::ArrayData::Make(
+                arrow::uint64(), num_rows, {nullptr, std::move(prop)}, 0)),
+        });
+    next_ += num_rows;
+    return arrow::Status::OK();
+  }
+
+private:
+  std::shared_ptr<const katana::GraphSnapshot> snapshot_;
+  std::shared_ptr<arrow::Schema> schema_;
+  uint64_t next_;
+  uint64_t end_;
+  int64_t max_rows_;
+  katana::GraphTopology::Node node_{0};
+};
+
+}  // namespace
+
+std::string
+katana::GraphStreamTicket::ToString() const {
+  std::ostringstream out;
+  out << kKindNames[static_cast<int>(kind)] << '\n'
+      << partition << '\n'
+      << num_partitions;
+  for (const auto& column : columns) {
+    out << '\n' << column;
+  }
+  return out.str();
+}
+
+katana::Result<katana::GraphStreamTicket>
+katana::GraphStreamTicket::Parse(const std::string& str) {
+  std::vector<std::string> fields;
+  std::istringstream in(str);
+  for (std::string field; std::getline(in, field, '\n');) {
+    fields.emplace_back(std::move(field));
+  }
+  if (fields.size() < 3) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "malformed graph stream ticket {}",
+        std::quoted(str));
+  }
+
+  GraphStreamTicket ticket;
+  auto kind_it =
+      std::find(std::begin(kKindNames), std::end(kKindNames), fields[0]);
+  if (kind_it == std::end(kKindNames)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "unknown graph stream {}",
+        std::quoted(fields[0]));
+  }
+  ticket.kind =
+      static_cast<GraphStreamKind>(kind_it - std::begin(kKindNames));
+  for (auto [field, value] :
+       {std::make_pair(&fields[1], &ticket.partition),
+        std::make_pair(&fields[2], &ticket.num_partitions)}) {
+    const char* last = field->data() + field->size();
+    auto [ptr, ec] = std::from_chars(field->data(), last, *value);
+    if (ec != std::errc() || ptr != last) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "malformed graph stream ticket {}",
+          std::quoted(str));
+    }
+  }
+  if (ticket.partition >= ticket.num_partitions) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no partition {} of {}", ticket.partition,
+        ticket.num_partitions);
+  }
+  ticket.columns.assign(fields.begin() + 3, fields.end());
+  return ticket;
+}
+
+std::pair<uint64_t, uint64_t>
+katana::GraphStreamRows(
+    uint64_t num_rows, uint32_t partition, uint32_t num_partitions) {
+  uint64_t base = num_rows / num_partitions;
+  uint64_t extra = num_rows % num_partitions;
+  auto start = [&](uint64_t p) { return p * base + std::min(p, extra); };
+  return std::make_pair(start(partition), start(partition + 1));
+}
+
+uint64_t
+katana::GraphStreamNumRows(
+    const GraphSnapshot& snapshot, GraphStreamKind kind) {
+  switch (kind) {
+  case GraphStreamKind::kNodeProperties:
+    return snapshot.node_properties()->num_rows();
+  case GraphStreamKind::kEdgeProperties:
+    return snapshot.edge_properties()->num_rows();
+  case GraphStreamKind::kTopology:
+    return snapshot.NumEdges();
+  }
+  return 0;
+}
+
+katana::Result<std::shared_ptr<arrow::Schema>>
+katana::GraphStreamSchema(
+    const GraphSnapshot& snapshot, const GraphStreamTicket& ticket) {
+  if (ticket.kind == GraphStreamKind::kTopology) {
+    return TopologySchema();
+  }
+  std::shared_ptr<arrow::Table> table =
+      KATANA_CHECKED(SelectColumns(snapshot, ticket));
+  return table->schema();
+}
+
+katana::Result<std::shared_ptr<arrow::RecordBatchReader>>
+katana::MakeGraphStreamReader(
+    std::shared_ptr<const GraphSnapshot> snapshot,
+    const GraphStreamTicket& ticket, int64_t max_batch_rows) {
+  if (ticket.partition >= ticket.num_partitions) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no partition {} of {}", ticket.partition,
+        ticket.num_partitions);
+  }
+  if (max_batch_rows <= 0) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "batches must have rows");
+  }
+
+  auto [begin, end] = GraphStreamRows(
+      GraphStreamNumRows(*snapshot, ticket.kind), ticket.partition,
+      ticket.num_partitions);
+  if (ticket.kind == GraphStreamKind::kTopology) {
+    return std::shared_ptr<arrow::RecordBatchReader>(
+        std::make_shared<TopologyStreamReader>(
+            std::move(snapshot), begin, end, max_batch_rows));
+  }
+
+  std::shared_ptr<arrow::Table> table =
+      KATANA_CHECKED(SelectColumns(*snapshot, ticket));
+  return std::shared_ptr<arrow::RecordBatchReader>(
+      std::make_shared<PropertyStreamReader>(
+          table->Slice(begin, end - begin), max_batch_rows));
+}
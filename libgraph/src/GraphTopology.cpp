@@ -2,16 +2,46 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iomanip>
 #include <iostream>
-
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/ErrorCode.h"
 #include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/PropertyGraph.h"
 #include "katana/RDGTopology.h"
 #include "katana/Random.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
+#include "katana/TakeRows.h"
 
 katana::GraphTopology::~GraphTopology() = default;
 
+uint64_t
+katana::GraphTopology::SizeBytes() const noexcept {
+  return adj_indices_.size() * sizeof(Edge) + dests_.size() * sizeof(Node) +
+         (edge_prop_indices_.size() + node_prop_indices_.size()) *
+             sizeof(PropertyIndex);
+}
+
+katana::ReplicatedTopology
+katana::ReplicatedTopology::Make(const GraphTopology& topo) noexcept {
+  ReplicatedTopology ret;
+  ret.adj_indices_ =
+      ReplicatedArray<Edge>::Make(topo.AdjData(), topo.NumNodes());
+  ret.dests_ = ReplicatedArray<Node>::Make(topo.DestData(), topo.NumEdges());
+  return ret;
+}
+
 void
 katana::GraphTopology::Print() const noexcept {
   auto print_array = [](const auto& arr, const auto& name) {
@@ -28,9 +58,28 @@ katana::GraphTopology::Print() const noexcept {
 
 katana::GraphTopology::GraphTopology(
     const Edge* adj_indices, size_t num_nodes, const Node* dests,
-    size_t num_edges) noexcept {
-  adj_indices_.allocateInterleaved(num_nodes);
-  dests_.allocateInterleaved(num_edges);
+    size_t num_edges) noexcept
+    : GraphTopology(
+          adj_indices, num_nodes, dests, num_edges,
+          MemoryPlacement::kDefault) {}
+
+katana::GraphTopology::GraphTopology(
+    const Edge* adj_indices, size_t num_nodes, const Node* dests,
+    size_t num_edges, MemoryPlacement placement) noexcept {
+  if (placement == MemoryPlacement::kBlocked) {
+    // thread t iterates over nodes [t * n / T, (t + 1) * n / T), so it gets
+    // the edges from the first of those nodes on
+    std::vector<uint64_t> edge_ranges(activeThreads + 1, num_edges);
+    for (unsigned t = 0; t < activeThreads; ++t) {
+      uint64_t first_node = t * num_nodes / activeThreads;
+      edge_ranges[t] = first_node == 0 ? 0 : adj_indices[first_node - 1];
+    }
+    adj_indices_.allocateBlocked(num_nodes);
+    dests_.allocateSpecified(num_edges, edge_ranges);
+  } else {
+    adj_indices_.allocateInterleaved(num_nodes);
+    dests_.allocateInterleaved(num_edges);
+  }
 
   katana::ParallelSTL::copy(
       &adj_indices[0], &adj_indices[num_nodes], adj_indices_.begin());
@@ -75,6 +124,16 @@ katana::GraphTopology::GraphTopology(
       edge_prop_indices_(std::move(edge_prop_indices)),
       node_prop_indices_(std::move(node_prop_indices)) {}
 
+katana::GraphTopology::GraphTopology(
+    AdjIndexVec&& adj_indices, EdgeDestVec&& dests,
+    PropIndexVec&& edge_prop_indices, PropIndexVec&& node_prop_indices,
+    std::shared_ptr<const void> mapping) noexcept
+    : mapping_(std::move(mapping)),
+      adj_indices_(std::move(adj_indices)),
+      dests_(std::move(dests)),
+      edge_prop_indices_(std::move(edge_prop_indices)),
+      node_prop_indices_(std::move(node_prop_indices)) {}
+
 katana::GraphTopology
 katana::GraphTopology::Copy(const GraphTopology& that) noexcept {
   return katana::GraphTopology(
@@ -91,6 +150,146 @@ katana::GraphTopology::CopyWithoutPropertyIndexes(
       that.dests_.size(), nullptr, nullptr);
 }
 
+namespace {
+
+using Node = katana::GraphTopologyTypes::Node;
+using Edge = katana::GraphTopologyTypes::Edge;
+
+struct PatchedEdges {
+  katana::GraphTopologyTypes::AdjIndexVec adj_indices;
+  katana::GraphTopologyTypes::EdgeDestVec dests;
+  katana::GraphTopologyTypes::PropIndexVec edge_prop_indices;
+};
+
+template <typename Delta>
+bool
+BySrcThenDst(const Delta& a, const Delta& b) {
+  return std::tie(a.src, a.dst) < std::tie(b.src, b.dst);
+}
+
+template <typename Delta>
+katana::StandardRange<typename std::vector<Delta>::const_iterator>
+DeltasOfNode(const std::vector<Delta>& deltas, Node src) {
+  auto begin = std::lower_bound(
+      deltas.begin(), deltas.end(), src,
+      [](const Delta& d, Node n) { return d.src < n; });
+  auto end = std::upper_bound(
+      begin, deltas.end(), src,
+      [](Node n, const Delta& d) { return n < d.src; });
+  return katana::MakeStandardRange(begin, end);
+}
+
+/// Apply deltas, with src and dst swapped if topo is transposed, to topo. If
+/// keep_sorted, the out-edges of each node are sorted by destination and
+/// the inserted edges are merged in, otherwise they are appended.
+PatchedEdges
+PatchEdges(
+    const katana::GraphTopology& topo, const katana::EdgeDeltas& deltas,
+    bool transposed, bool keep_sorted) {
+  uint64_t num_nodes = topo.NumNodes();
+
+  katana::EdgeDeltas oriented = deltas;
+  if (transposed) {
+    for (auto& ins : oriented.insertions) {
+      std::swap(ins.src, ins.dst);
+    }
+    for (auto& del : oriented.deletions) {
+      std::swap(del.src, del.dst);
+    }
+  }
+  std::sort(
+      oriented.insertions.begin(), oriented.insertions.end(),
+      BySrcThenDst<katana::EdgeDeltas::Insertion>);
+  std::sort(
+      oriented.deletions.begin(), oriented.deletions.end(),
+      BySrcThenDst<katana::EdgeDeltas::Deletion>);
+
+  auto is_deleted = [](const auto& dels, Node dst) {
+    return std::binary_search(
+        dels.begin(), dels.end(), katana::EdgeDeltas::Deletion{0, dst},
+        [](const auto& a, const auto& b) { return a.dst < b.dst; });
+  };
+
+  PatchedEdges patched;
+  patched.adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node n) {
+        auto dels = DeltasOfNode(oriented.deletions, n);
+        uint64_t degree = topo.OutDegree(n);
+        if (!dels.empty()) {
+          degree = 0;
+          for (Edge e : topo.OutEdges(n)) {
+            degree += is_deleted(dels, topo.OutEdgeDst(e)) ? 0 : 1;
+          }
+        }
+        patched.adj_indices[n] =
+            degree + DeltasOfNode(oriented.insertions, n).size();
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      patched.adj_indices.begin(), patched.adj_indices.end(),
+      patched.adj_indices.begin());
+
+  uint64_t num_edges = num_nodes == 0 ? 0 : patched.adj_indices[num_nodes - 1];
+  patched.dests.allocateInterleaved(num_edges);
+  patched.edge_prop_indices.allocateInterleaved(num_edges);
+
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node n) {
+        auto dels = DeltasOfNode(oriented.deletions, n);
+        auto ins = DeltasOfNode(oriented.insertions, n);
+        auto next_ins = ins.begin();
+        Edge pos = n == 0 ? 0 : patched.adj_indices[n - 1];
+        auto put = [&](Node dst, katana::GraphTopologyTypes::PropertyIndex p) {
+          patched.dests[pos] = dst;
+          patched.edge_prop_indices[pos] = p;
+          ++pos;
+        };
+        for (Edge e : topo.OutEdges(n)) {
+          Node dst = topo.OutEdgeDst(e);
+          if (!dels.empty() && is_deleted(dels, dst)) {
+            continue;
+          }
+          for (; keep_sorted && next_ins != ins.end() && next_ins->dst < dst;
+               ++next_ins) {
+            put(next_ins->dst, next_ins->prop_index);
+          }
+          put(dst, topo.GetEdgePropertyIndexFromOutEdge(e));
+        }
+        for (; next_ins != ins.end(); ++next_ins) {
+          put(next_ins->dst, next_ins->prop_index);
+        }
+        KATANA_LOG_DEBUG_ASSERT(pos == patched.adj_indices[n]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return patched;
+}
+
+katana::GraphTopologyTypes::PropIndexVec
+CopyNodePropIndices(const katana::GraphTopology& topo) {
+  katana::GraphTopologyTypes::PropIndexVec node_prop_indices;
+  node_prop_indices.allocateInterleaved(topo.NumNodes());
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node n) { node_prop_indices[n] = topo.GetNodePropertyIndex(n); },
+      katana::no_stats());
+  return node_prop_indices;
+}
+
+}  // namespace
+
+katana::GraphTopology
+katana::GraphTopology::MakePatched(
+    const GraphTopology& that, const EdgeDeltas& deltas) noexcept {
+  PatchedEdges patched = PatchEdges(that, deltas, false, false);
+  return GraphTopology(
+      std::move(patched.adj_indices), std::move(patched.dests),
+      std::move(patched.edge_prop_indices), CopyNodePropIndices(that));
+}
+
 katana::GraphTopology::PropertyIndex
 katana::GraphTopology::GetEdgePropertyIndexFromOutEdge(
     const Edge& eid) const noexcept {
@@ -106,6 +305,7 @@ katana::GraphTopology::GetNodePropertyIndex(const Node& nid) const noexcept {
 
 katana::ShuffleTopology::~ShuffleTopology() = default;
 
+
 std::shared_ptr<katana::ShuffleTopology>
 katana::ShuffleTopology::MakeFrom(
     const PropertyGraph*, const katana::EdgeShuffleTopology&) noexcept {
@@ -114,6 +314,35 @@ katana::ShuffleTopology::MakeFrom(
   return ret;
 }
 
+namespace {
+
+/// MakeTransposeCopy partitions edges into at most this many blocks of
+/// destinations, few enough that the partition cursors of a thread stay in
+/// cache
+constexpr uint64_t kTransposeBlocks = 4096;
+
+/// SortEdgesByDestID sorts the edges of a node with more than this many
+/// edges with all threads
+constexpr uint64_t kParallelSortDegree = 1 << 20;
+
+/// and insertion sorts those with at most this many
+constexpr uint64_t kInsertionSortDegree = 16;
+
+template <typename Iterator, typename Compare>
+void
+InsertionSort(Iterator begin, Iterator end, Compare comp) {
+  for (Iterator i = begin; i != end; ++i) {
+    auto value = std::move(*i);
+    Iterator j = i;
+    for (; j != begin && comp(value, *(j - 1)); --j) {
+      *j = std::move(*(j - 1));
+    }
+    *j = std::move(value);
+  }
+}
+
+}  // namespace
+
 katana::EdgeShuffleTopology::~EdgeShuffleTopology() = default;
 
 std::shared_ptr<katana::EdgeShuffleTopology>
@@ -128,62 +357,121 @@ katana::EdgeShuffleTopology::MakeTransposeCopy(
     return std::make_shared<EdgeShuffleTopology>(std::move(et));
   }
 
+  // Radix partition the edges by blocks of destinations, then place the
+  // edges of each block. Each thread partitions the out-edges of a range of
+  // sources into its own slice of every block, so scanning a block visits
+  // sources in order and the transposed edges of a node come out sorted. No
+  // edge is written with an atomic, which serializes hubs.
+  uint64_t num_nodes = topology.NumNodes();
+  uint64_t num_edges = topology.NumEdges();
+  uint64_t num_blocks = std::min<uint64_t>(kTransposeBlocks, num_nodes);
+  uint64_t block_width = (num_nodes + num_blocks - 1) / num_blocks;
+  num_blocks = (num_nodes + block_width - 1) / block_width;
+  unsigned num_chunks = katana::getActiveThreads();
+
+  // chunk c partitions the out-edges of [chunk_begin[c], chunk_begin[c + 1])
+  std::vector<Node> chunk_begin(num_chunks + 1);
+  for (unsigned c = 0; c < num_chunks; ++c) {
+    Edge first_edge = num_edges * c / num_chunks;
+    chunk_begin[c] = std::upper_bound(
+                         topology.AdjData(), topology.AdjData() + num_nodes,
+                         first_edge) -
+                     topology.AdjData();
+  }
+  chunk_begin[0] = 0;
+  chunk_begin[num_chunks] = num_nodes;
+
+  // where each chunk writes into each block
+  std::vector<Edge> cursors(num_chunks * num_blocks, 0);
+  katana::on_each([&](unsigned c, unsigned) {
+    if (c >= num_chunks) {
+      return;
+    }
+    Edge* counts = cursors.data() + c * num_blocks;
+    for (Node src = chunk_begin[c]; src < chunk_begin[c + 1]; ++src) {
+      for (Edge e : topology.OutEdges(src)) {
+        ++counts[topology.OutEdgeDst(e) / block_width];
+      }
+    }
+  });
+
+  std::vector<Edge> block_begin(num_blocks + 1, 0);
+  Edge total = 0;
+  for (uint64_t b = 0; b < num_blocks; ++b) {
+    block_begin[b] = total;
+    for (unsigned c = 0; c < num_chunks; ++c) {
+      Edge count = cursors[c * num_blocks + b];
+      cursors[c * num_blocks + b] = total;
+      total += count;
+    }
+  }
+  block_begin[num_blocks] = total;
+  KATANA_LOG_DEBUG_ASSERT(total == num_edges);
+
   AdjIndexVec out_indices;
   EdgeDestVec out_dests;
-  AdjIndexVec out_dests_offset;
   PropIndexVec edge_prop_indices;
   PropIndexVec node_prop_indices;
 
-  out_indices.allocateInterleaved(topology.NumNodes());
-  out_dests.allocateInterleaved(topology.NumEdges());
-  edge_prop_indices.allocateInterleaved(topology.NumEdges());
-
-  out_dests_offset.allocateInterleaved(topology.NumNodes());
+  out_indices.allocateInterleaved(num_nodes);
+  out_dests.allocateInterleaved(num_edges);
+  edge_prop_indices.allocateInterleaved(num_edges);
 
-  katana::ParallelSTL::fill(out_indices.begin(), out_indices.end(), Edge{0});
-
-  // Keep a copy of old destinaton ids and compute number of
-  // in-coming edges for the new prefix sum of out_indices.
-  katana::do_all(
-      katana::iterate(topology.OutEdges()),
-      [&](Edge e) {
-        // Counting outgoing edges in the tranpose graph by
-        // counting incoming edges in the original graph
-        auto dest = topology.OutEdgeDst(e);
-        __sync_add_and_fetch(&(out_indices[dest]), 1);
-      },
-      katana::no_stats());
-
-  // Prefix sum calculation of the edge index array
-  katana::ParallelSTL::partial_sum(
-      out_indices.begin(), out_indices.end(), out_indices.begin());
+  // Partition: out_dests holds the source and edge_prop_indices the
+  // original edge until the block is placed
+  katana::on_each([&](unsigned c, unsigned) {
+    if (c >= num_chunks) {
+      return;
+    }
+    Edge* chunk_cursors = cursors.data() + c * num_blocks;
+    for (Node src = chunk_begin[c]; src < chunk_begin[c + 1]; ++src) {
+      for (Edge e : topology.OutEdges(src)) {
+        Edge& pos = chunk_cursors[topology.OutEdgeDst(e) / block_width];
+        out_dests[pos] = src;
+        edge_prop_indices[pos] = e;
+        ++pos;
+      }
+    }
+  });
 
-  // temporary buffer for storing the starting point of each node's transpose
-  // adjacency
-  out_dests_offset[0] = 0;
-  katana::do_all(
-      katana::iterate(Edge{1}, Edge{topology.NumNodes()}),
-      [&](Edge n) { out_dests_offset[n] = out_indices[n - 1]; },
-      katana::no_stats());
+  struct SrcAndEdge {
+    Node src;
+    Edge edge;
+  };
+  katana::PerThreadStorage<std::vector<SrcAndEdge>> edges_scratch;
+  katana::PerThreadStorage<std::vector<Edge>> offsets_scratch;
 
-  // Update out_dests with the new destination ids
-  // of the transposed graphs
+  // Place: a counting sort of the edges of each block by destination
   katana::do_all(
-      katana::iterate(topology.Nodes()),
-      [&](auto src) {
-        // get all outgoing edges of a particular
-        // node and reverse the edges.
-        for (GraphTopology::Edge e : topology.OutEdges(src)) {
-          // e = start index into edge array for a particular node
-          // Destination node
-          auto dest = topology.OutEdgeDst(e);
-          // Location to save edge
-          auto e_new = __sync_fetch_and_add(&(out_dests_offset[dest]), 1);
-          // Save src as destination
-          out_dests[e_new] = src;
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t b) {
+        Node first_node = b * block_width;
+        Node last_node =
+            std::min<uint64_t>(first_node + block_width, num_nodes);
+        Edge begin = block_begin[b];
+        Edge end = block_begin[b + 1];
+
+        std::vector<SrcAndEdge>& edges = *edges_scratch.getLocal();
+        std::vector<Edge>& offsets = *offsets_scratch.getLocal();
+        edges.resize(end - begin);
+        offsets.assign(last_node - first_node + 1, 0);
+        for (Edge i = begin; i < end; ++i) {
+          SrcAndEdge& entry = edges[i - begin];
+          entry.src = out_dests[i];
+          entry.edge = edge_prop_indices[i];
+          ++offsets[topology.OutEdgeDst(entry.edge) - first_node + 1];
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        for (Node n = first_node; n < last_node; ++n) {
+          out_indices[n] = begin + offsets[n - first_node + 1];
+        }
+        for (const SrcAndEdge& entry : edges) {
+          Edge pos = begin + offsets[topology.OutEdgeDst(entry.edge) -
+                                     first_node]++;
+          out_dests[pos] = entry.src;
           // remember the original edge ID to look up properties
-          edge_prop_indices[e_new] =
-              topology.GetEdgePropertyIndexFromOutEdge(e);
+          edge_prop_indices[pos] =
+              topology.GetEdgePropertyIndexFromOutEdge(entry.edge);
         }
       },
       katana::steal(), katana::no_stats());
@@ -203,6 +491,75 @@ katana::EdgeShuffleTopology::MakeTransposeCopy(
       std::move(node_prop_indices)});
 }
 
+std::shared_ptr<katana::EdgeShuffleTopology>
+katana::EdgeShuffleTopology::MakePatched(
+    const EdgeShuffleTopology& that, const EdgeDeltas& deltas) noexcept {
+  bool sorted = that.has_edges_sorted_by(
+      katana::RDGTopology::EdgeSortKind::kSortedByDestID);
+  PatchedEdges patched =
+      PatchEdges(that, deltas, that.is_transposed(), sorted);
+  return std::make_shared<EdgeShuffleTopology>(EdgeShuffleTopology{
+      that.transpose_state(),
+      sorted ? katana::RDGTopology::EdgeSortKind::kSortedByDestID
+             : katana::RDGTopology::EdgeSortKind::kAny,
+      std::move(patched.adj_indices), std::move(patched.dests),
+      std::move(patched.edge_prop_indices), CopyNodePropIndices(that)});
+}
+
+std::shared_ptr<katana::EdgeShuffleTopology>
+katana::EdgeShuffleTopology::MakeOfEdgeType(
+    const EdgeTypeAwareTopology& topo, const EntityTypeID& edge_type) {
+  uint64_t num_nodes = topo.NumNodes();
+  bool has_type = topo.DoesEdgeTypeExist(edge_type);
+
+  AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(Node{0}, static_cast<Node>(num_nodes)),
+      [&](Node n) {
+        adj_indices[n] = has_type ? topo.OutDegree(n, edge_type) : 0;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  uint64_t num_edges = num_nodes == 0 ? 0 : adj_indices[num_nodes - 1];
+  EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  PropIndexVec edge_prop_indices;
+  edge_prop_indices.allocateInterleaved(num_edges);
+  if (num_edges > 0) {
+    const Node* old_dests = topo.DestData();
+    const PropertyIndex* old_prop_indices = topo.EdgePropertyIndexData();
+    katana::do_all(
+        katana::iterate(Node{0}, static_cast<Node>(num_nodes)),
+        [&](Node n) {
+          auto edges = topo.OutEdges(n, edge_type);
+          Edge begin = *edges.begin();
+          Edge end = *edges.end();
+          Edge pos = n == 0 ? 0 : adj_indices[n - 1];
+          std::copy(old_dests + begin, old_dests + end, &dests[pos]);
+          if (old_prop_indices) {
+            std::copy(
+                old_prop_indices + begin, old_prop_indices + end,
+                &edge_prop_indices[pos]);
+          } else {
+            std::iota(
+                &edge_prop_indices[pos], &edge_prop_indices[pos] + end - begin,
+                PropertyIndex{begin});
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  // Edges of one type are sorted by destination in an EdgeTypeAwareTopology
+  return std::make_shared<EdgeShuffleTopology>(EdgeShuffleTopology{
+      topo.transpose_state(),
+      katana::RDGTopology::EdgeSortKind::kSortedByDestID,
+      std::move(adj_indices), std::move(dests), std::move(edge_prop_indices),
+      CopyNodePropIndices(topo)});
+}
+
 std::shared_ptr<katana::EdgeShuffleTopology>
 katana::EdgeShuffleTopology::MakeOriginalCopy(const katana::PropertyGraph* pg) {
   GraphTopology copy_topo = GraphTopology::Copy(pg->topology());
@@ -264,16 +621,75 @@ katana::EdgeShuffleTopology::Make(katana::RDGTopology* rdg_topo) {
           std::move(dests_copy),
           std::move(edge_prop_indices),
           {}});
+  shuffle->edge_sort_property_ = rdg_topo->edge_sort_property();
 
   return shuffle;
 }
 
+katana::Result<std::shared_ptr<katana::EdgeShuffleTopology>>
+katana::EdgeShuffleTopology::MakeSortedByEdgeProperty(
+    const katana::PropertyGraph* pg,
+    const katana::RDGTopology::TransposeKind& tpose_todo,
+    const std::string& property_name) {
+  KATANA_LOG_DEBUG_ASSERT(pg);
+
+  auto property = KATANA_CHECKED_CONTEXT(
+      pg->GetEdgeProperty(property_name), "sorting edges by {}",
+      std::quoted(property_name));
+  std::shared_ptr<arrow::Array> values =
+      KATANA_CHECKED(katana::UnchunkedArray(property));
+  // null values have no order
+  if (values->null_count() > 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "cannot sort edges by property {}, which has null values",
+        std::quoted(property_name));
+  }
+
+  std::shared_ptr<EdgeShuffleTopology> ret =
+      tpose_todo == katana::RDGTopology::TransposeKind::kYes
+          ? MakeTransposeCopy(pg)
+          : MakeOriginalCopy(pg);
+
+  auto sort_by = [&](const auto* typed) {
+    ret->SortEdgesByKey(typed->raw_values());
+  };
+  switch (values->type_id()) {
+  case arrow::Type::UINT32:
+    sort_by(static_cast<const arrow::UInt32Array*>(values.get()));
+    break;
+  case arrow::Type::INT32:
+    sort_by(static_cast<const arrow::Int32Array*>(values.get()));
+    break;
+  case arrow::Type::UINT64:
+    sort_by(static_cast<const arrow::UInt64Array*>(values.get()));
+    break;
+  case arrow::Type::INT64:
+    sort_by(static_cast<const arrow::Int64Array*>(values.get()));
+    break;
+  case arrow::Type::FLOAT:
+    sort_by(static_cast<const arrow::FloatArray*>(values.get()));
+    break;
+  case arrow::Type::DOUBLE:
+    sort_by(static_cast<const arrow::DoubleArray*>(values.get()));
+    break;
+  default:
+    return KATANA_ERROR(
+        ErrorCode::TypeError, "cannot sort edges by property {} of type {}",
+        std::quoted(property_name), values->type()->ToString());
+  }
+  ret->edge_sort_property_ = property_name;
+
+  return ret;
+}
+
 katana::Result<katana::RDGTopology>
 katana::EdgeShuffleTopology::ToRDGTopology() const {
   katana::RDGTopology topo = KATANA_CHECKED(katana::RDGTopology::Make(
       AdjData(), NumNodes(), DestData(), NumEdges(),
       katana::RDGTopology::TopologyKind::kEdgeShuffleTopology, tpose_state_,
       edge_sort_state_, edge_prop_indices_.data()));
+  topo.set_edge_sort_property(edge_sort_property_);
   return katana::RDGTopology(std::move(topo));
 }
 
@@ -339,39 +755,64 @@ katana::EdgeShuffleTopology::FindAllEdges(
 
 void
 katana::EdgeShuffleTopology::SortEdgesByDestID() noexcept {
+  using DstAndProp = std::pair<Node, PropertyIndex>;
+  auto sort_node = [&](Node node, std::vector<DstAndProp>* scratch,
+                       bool in_parallel) {
+    auto e_beg = *OutEdges(node).begin();
+    auto e_end = *OutEdges(node).end();
+    Node* dests = GetDests().data();
+    // transposes and loaded topologies often need no sorting
+    if (std::is_sorted(dests + e_beg, dests + e_end)) {
+      return;
+    }
+
+    // sorting pairs is much cheaper than sorting through a zip iterator
+    scratch->resize(e_end - e_beg);
+    for (Edge e = e_beg; e < e_end; ++e) {
+      (*scratch)[e - e_beg] = DstAndProp{dests[e], edge_prop_indices_[e]};
+    }
+    auto by_dest = [](const DstAndProp& a, const DstAndProp& b) {
+      return a.first < b.first;
+    };
+    if (in_parallel) {
+      katana::ParallelSTL::radix_sort(
+          scratch->begin(), scratch->end(),
+          [](const DstAndProp& a) { return a.first; });
+    } else if (scratch->size() <= kInsertionSortDegree) {
+      InsertionSort(scratch->begin(), scratch->end(), by_dest);
+    } else {
+      std::sort(scratch->begin(), scratch->end(), by_dest);
+    }
+    for (Edge e = e_beg; e < e_end; ++e) {
+      std::tie(dests[e], edge_prop_indices_[e]) = (*scratch)[e - e_beg];
+    }
+    KATANA_LOG_DEBUG_ASSERT(std::is_sorted(dests + e_beg, dests + e_end));
+  };
+
+  // Nodes with very many edges are sorted one at a time by all threads so
+  // that a hub does not leave a single thread sorting after everyone else
+  std::vector<Node> hubs;
+  katana::PerThreadStorage<std::vector<DstAndProp>> scratch;
+  katana::PerThreadStorage<std::vector<Node>> local_hubs;
   katana::do_all(
       katana::iterate(Nodes()),
       [&](Node node) {
-        // get this node's first and last edge
-        auto e_beg = *OutEdges(node).begin();
-        auto e_end = *OutEdges(node).end();
-
-        // get iterators to locations to sort in the vector
-        auto begin_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_beg, GetDests().begin() + e_beg);
-
-        auto end_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_end, GetDests().begin() + e_end);
-
-        // rearrange vector indices based on how the destinations of this
-        // graph will eventually be sorted sort function not based on vector
-        // being passed, but rather the type and destination of the graph
-        std::sort(
-            begin_sort_iter, end_sort_iter,
-            [&](const auto& tup1, const auto& tup2) {
-              auto dst1 = std::get<1>(tup1);
-              auto dst2 = std::get<1>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(dst1), GraphTopology::Node>);
-              static_assert(
-                  std::is_same_v<decltype(dst2), GraphTopology::Node>);
-              return dst1 < dst2;
-            });
-
-        KATANA_LOG_DEBUG_ASSERT(std::is_sorted(
-            GetDests().begin() + e_beg, GetDests().begin() + e_end));
+        if (OutDegree(node) > kParallelSortDegree) {
+          local_hubs.getLocal()->emplace_back(node);
+          return;
+        }
+        sort_node(node, scratch.getLocal(), false);
       },
       katana::steal(), katana::no_stats());
+  for (unsigned i = 0; i < katana::getActiveThreads(); ++i) {
+    const auto& thread_hubs = *local_hubs.getRemote(i);
+    hubs.insert(hubs.end(), thread_hubs.begin(), thread_hubs.end());
+  }
+  std::vector<DstAndProp> hub_scratch;
+  for (Node hub : hubs) {
+    sort_node(hub, &hub_scratch, true);
+  }
+
   // remember to update sort state
   edge_sort_state_ = katana::RDGTopology::EdgeSortKind::kSortedByDestID;
 }
@@ -430,6 +871,40 @@ katana::EdgeShuffleTopology::SortEdgesByTypeThenDest(
   edge_sort_state_ = katana::RDGTopology::EdgeSortKind::kSortedByEdgeType;
 }
 
+template <typename T>
+void
+katana::EdgeShuffleTopology::SortEdgesByKey(const T* keys) noexcept {
+  // like SortEdgesByDestID, sort copies rather than through a zip iterator;
+  // tuples compare by key, then by destination
+  using KeyAndEdge = std::tuple<T, Node, PropertyIndex>;
+  katana::PerThreadStorage<std::vector<KeyAndEdge>> scratch;
+  katana::do_all(
+      katana::iterate(Nodes()),
+      [&](Node node) {
+        auto e_beg = *OutEdges(node).begin();
+        auto e_end = *OutEdges(node).end();
+        Node* dests = GetDests().data();
+        std::vector<KeyAndEdge>& local = *scratch.getLocal();
+        local.resize(e_end - e_beg);
+        for (Edge e = e_beg; e < e_end; ++e) {
+          PropertyIndex prop = edge_prop_indices_[e];
+          local[e - e_beg] = KeyAndEdge{keys[prop], dests[e], prop};
+        }
+        if (local.size() <= kInsertionSortDegree) {
+          InsertionSort(local.begin(), local.end(), std::less<KeyAndEdge>{});
+        } else {
+          std::sort(local.begin(), local.end());
+        }
+        for (Edge e = e_beg; e < e_end; ++e) {
+          std::tie(std::ignore, dests[e], edge_prop_indices_[e]) =
+              local[e - e_beg];
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  edge_sort_state_ = katana::RDGTopology::EdgeSortKind::kSortedByEdgeProperty;
+}
+
 void
 katana::EdgeShuffleTopology::SortEdgesByDestType(
     const PropertyGraph*,
@@ -474,6 +949,365 @@ katana::ShuffleTopology::MakeSortedByNodeType(
       seed_topo, cmp, katana::RDGTopology::NodeSortKind::kSortedByNodeType);
 }
 
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::ShuffleTopology::PermutedNodeProperties(
+    const PropertyGraph* pg) const {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i = 0; i < pg->GetNumNodeProperties(); ++i) {
+    fields.emplace_back(pg->loaded_node_schema()->field(i));
+    columns.emplace_back(pg->GetNodeProperty(i));
+  }
+  auto table = arrow::Table::Make(arrow::schema(fields), columns, NumNodes());
+  if (columns.empty()) {
+    return table;
+  }
+
+  PropIndexVec rows;
+  rows.allocateInterleaved(NumNodes());
+  katana::do_all(
+      katana::iterate(Nodes()),
+      [&](Node n) { rows[n] = GetNodePropertyIndex(n); }, katana::no_stats());
+
+  return katana::TakeRows(table, rows);
+}
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeNodePermutedTopo(
+    const katana::EdgeShuffleTopology& seed_topo,
+    const katana::GraphTopology::PropIndexVec& new_to_old,
+    const katana::RDGTopology::NodeSortKind& node_sort_todo) {
+  KATANA_LOG_DEBUG_ASSERT(new_to_old.size() == seed_topo.NumNodes());
+
+  GraphTopology::AdjIndexVec degrees;
+  degrees.allocateInterleaved(seed_topo.NumNodes());
+
+  NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
+  old_to_new_map.allocateInterleaved(seed_topo.NumNodes());
+
+  PropIndexVec node_prop_indices;
+  node_prop_indices.allocateInterleaved(seed_topo.NumNodes());
+
+  // TODO(amber): given 32-bit node ids, put a check here that
+  // new_to_old.size() < 2^32
+  katana::do_all(
+      katana::iterate(size_t{0}, new_to_old.size()),
+      [&](auto i) {
+        // new_to_old[i] gives old node id
+        old_to_new_map[new_to_old[i]] = i;
+        degrees[i] = seed_topo.OutDegree(new_to_old[i]);
+        node_prop_indices[i] = seed_topo.GetNodePropertyIndex(new_to_old[i]);
+      },
+      katana::no_stats());
+
+  KATANA_LOG_DEBUG_ASSERT(
+      node_sort_todo != RDGTopology::NodeSortKind::kSortedByDegree ||
+      std::is_sorted(degrees.begin(), degrees.end(), std::greater<>()));
+
+  katana::ParallelSTL::partial_sum(
+      degrees.begin(), degrees.end(), degrees.begin());
+
+  GraphTopologyTypes::EdgeDestVec new_dest_vec;
+  new_dest_vec.allocateInterleaved(seed_topo.NumEdges());
+
+  GraphTopologyTypes::PropIndexVec edge_prop_indices;
+  edge_prop_indices.allocateInterleaved(seed_topo.NumEdges());
+
+  katana::do_all(
+      katana::iterate(seed_topo.Nodes()),
+      [&](auto old_src_id) {
+        auto new_srd_id = old_to_new_map[old_src_id];
+        auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
+
+        for (auto e : seed_topo.OutEdges(old_src_id)) {
+          auto new_edge_dest = old_to_new_map[seed_topo.OutEdgeDst(e)];
+          KATANA_LOG_DEBUG_ASSERT(new_edge_dest < seed_topo.NumNodes());
+
+          auto new_edge_id = new_out_index;
+          ++new_out_index;
+          KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
+
+          new_dest_vec[new_edge_id] = new_edge_dest;
+
+          // copy over edge_property_index mapping from old edge to new edge
+          edge_prop_indices[new_edge_id] =
+              seed_topo.GetEdgePropertyIndexFromOutEdge(e);
+        }
+        KATANA_LOG_DEBUG_ASSERT(new_out_index == degrees[new_srd_id]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return std::make_shared<ShuffleTopology>(ShuffleTopology{
+      seed_topo.transpose_state(), node_sort_todo, seed_topo.edge_sort_state(),
+      std::move(degrees), std::move(node_prop_indices), std::move(new_dest_vec),
+      std::move(edge_prop_indices)});
+}
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeInReverseCuthillMcKeeOrder(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  using Node = GraphTopologyTypes::Node;
+  constexpr uint64_t kUnclaimed = std::numeric_limits<uint64_t>::max();
+  // Levels smaller than this are numbered serially: graphs of large
+  // diameter, such as road networks, have thousands of small levels, each
+  // of which would otherwise pay for several parallel loops
+  constexpr uint64_t kParallelLevelSize = 1024;
+  const size_t num_nodes = seed_topo.NumNodes();
+
+  // component roots are taken in ascending degree
+  PropIndexVec by_degree;
+  by_degree.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::iota(
+      by_degree.begin(), by_degree.end(), GraphTopologyTypes::PropertyIndex{0});
+  katana::ParallelSTL::sample_sort(
+      by_degree.begin(), by_degree.end(), [&](const auto& a, const auto& b) {
+        auto da = seed_topo.OutDegree(a);
+        auto db = seed_topo.OutDegree(b);
+        return da == db ? a < b : da < db;
+      });
+
+  // the position in the order of the earliest node of the current level
+  // that reaches an unnumbered node; ties between parents resolve the same
+  // way on any number of threads
+  NUMAArray<std::atomic<uint64_t>> claim;
+  claim.allocateInterleaved(num_nodes);
+  NUMAArray<uint8_t> numbered;
+  numbered.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        claim[n].store(kUnclaimed, std::memory_order_relaxed);
+        numbered[n] = 0;
+      },
+      katana::no_stats());
+
+  PropIndexVec order;
+  order.allocateInterleaved(num_nodes);
+  NUMAArray<uint64_t> num_children;
+  num_children.allocateInterleaved(num_nodes + 1);
+  katana::PerThreadStorage<std::vector<Node>> children;
+
+  auto children_of = [&](uint64_t pos, std::vector<Node>* kids) {
+    kids->clear();
+    for (auto e : seed_topo.OutEdges(order[pos])) {
+      Node dst = seed_topo.OutEdgeDst(e);
+      if (!numbered[dst] && claim[dst].load(std::memory_order_relaxed) == pos) {
+        kids->emplace_back(dst);
+      }
+    }
+    std::sort(kids->begin(), kids->end(), [&](Node a, Node b) {
+      auto da = seed_topo.OutDegree(a);
+      auto db = seed_topo.OutDegree(b);
+      return da == db ? a < b : da < db;
+    });
+    kids->erase(std::unique(kids->begin(), kids->end()), kids->end());
+  };
+
+  uint64_t num_ordered = 0;
+  size_t next_root = 0;
+  while (num_ordered < num_nodes) {
+    while (numbered[by_degree[next_root]]) {
+      ++next_root;
+    }
+    Node root = by_degree[next_root];
+    numbered[root] = 1;
+    order[num_ordered] = root;
+    uint64_t level_begin = num_ordered;
+    uint64_t level_end = num_ordered + 1;
+
+    while (level_begin < level_end) {
+      if (level_end - level_begin < kParallelLevelSize) {
+        // Parents claim in order, so the first claim of a child is the
+        // minimum and the order is the same as with the parallel passes
+        uint64_t out = level_end;
+        std::vector<Node>& kids = *children.getLocal();
+        for (uint64_t pos = level_begin; pos < level_end; ++pos) {
+          for (auto e : seed_topo.OutEdges(order[pos])) {
+            Node dst = seed_topo.OutEdgeDst(e);
+            if (!numbered[dst] &&
+                claim[dst].load(std::memory_order_relaxed) == kUnclaimed) {
+              claim[dst].store(pos, std::memory_order_relaxed);
+            }
+          }
+          children_of(pos, &kids);
+          for (Node kid : kids) {
+            order[out++] = kid;
+          }
+        }
+        for (uint64_t pos = level_end; pos < out; ++pos) {
+          numbered[order[pos]] = 1;
+        }
+        level_begin = level_end;
+        level_end = out;
+        continue;
+      }
+
+      katana::do_all(
+          katana::iterate(level_begin, level_end),
+          [&](uint64_t pos) {
+            for (auto e : seed_topo.OutEdges(order[pos])) {
+              Node dst = seed_topo.OutEdgeDst(e);
+              if (!numbered[dst]) {
+                katana::atomicMin(claim[dst], pos);
+              }
+            }
+          },
+          katana::steal(), katana::no_stats());
+
+      katana::do_all(
+          katana::iterate(level_begin, level_end),
+          [&](uint64_t pos) {
+            std::vector<Node>& kids = *children.getLocal();
+            children_of(pos, &kids);
+            num_children[pos - level_begin + 1] = kids.size();
+          },
+          katana::steal(), katana::no_stats());
+
+      num_children[0] = 0;
+      uint64_t level_size = level_end - level_begin;
+      katana::ParallelSTL::partial_sum(
+          num_children.begin(), num_children.begin() + level_size + 1,
+          num_children.begin());
+
+      katana::do_all(
+          katana::iterate(level_begin, level_end),
+          [&](uint64_t pos) {
+            std::vector<Node>& kids = *children.getLocal();
+            children_of(pos, &kids);
+            uint64_t out = level_end + num_children[pos - level_begin];
+            for (Node kid : kids) {
+              order[out++] = kid;
+            }
+          },
+          katana::steal(), katana::no_stats());
+
+      uint64_t next_end = level_end + num_children[level_size];
+      katana::do_all(
+          katana::iterate(level_end, next_end),
+          [&](uint64_t pos) { numbered[order[pos]] = 1; }, katana::no_stats());
+      level_begin = level_end;
+      level_end = next_end;
+    }
+    num_ordered = level_end;
+  }
+
+  std::reverse(order.begin(), order.end());
+  return MakeNodePermutedTopo(
+      seed_topo, order,
+      katana::RDGTopology::NodeSortKind::kReverseCuthillMcKee);
+}
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeHubClustered(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  const size_t num_nodes = seed_topo.NumNodes();
+  // a hub has more than the average degree
+  double average_degree = 0;
+  if (num_nodes > 0) {
+    average_degree = static_cast<double>(seed_topo.NumEdges()) / num_nodes;
+  }
+  auto is_hub = [&](size_t n) {
+    return static_cast<double>(seed_topo.OutDegree(n)) > average_degree;
+  };
+
+  NUMAArray<uint64_t> num_hubs;
+  num_hubs.allocateInterleaved(num_nodes + 1);
+  num_hubs[0] = 0;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) { num_hubs[n + 1] = is_hub(n) ? 1 : 0; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      num_hubs.begin(), num_hubs.end(), num_hubs.begin());
+
+  // a stable partition: a node's place follows from the hubs before it
+  uint64_t total_hubs = num_hubs[num_nodes];
+  PropIndexVec order;
+  order.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        uint64_t pos = is_hub(n) ? num_hubs[n] : total_hubs + n - num_hubs[n];
+        order[pos] = n;
+      },
+      katana::no_stats());
+
+  return MakeNodePermutedTopo(
+      seed_topo, order, katana::RDGTopology::NodeSortKind::kHubClustered);
+}
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeClusteredByCommunity(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  using Node = GraphTopologyTypes::Node;
+  constexpr int kMaxRounds = 10;
+  const size_t num_nodes = seed_topo.NumNodes();
+
+  NUMAArray<Node> labels;
+  labels.allocateInterleaved(num_nodes);
+  NUMAArray<Node> next_labels;
+  next_labels.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::iota(labels.begin(), labels.end(), Node{0});
+
+  // synchronous rounds give the same communities on any number of threads:
+  // each node takes the most common label among itself and its neighbors,
+  // the smallest on ties
+  katana::PerThreadStorage<std::vector<Node>> scratch;
+  for (int round = 0; round < kMaxRounds; ++round) {
+    std::atomic<uint64_t> num_changed{0};
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          std::vector<Node>& seen = *scratch.getLocal();
+          seen.clear();
+          seen.emplace_back(labels[n]);
+          for (auto e : seed_topo.OutEdges(n)) {
+            seen.emplace_back(labels[seed_topo.OutEdgeDst(e)]);
+          }
+          std::sort(seen.begin(), seen.end());
+          Node best = seen[0];
+          size_t best_count = 0;
+          for (size_t i = 0; i < seen.size();) {
+            size_t j = i;
+            while (j < seen.size() && seen[j] == seen[i]) {
+              ++j;
+            }
+            if (j - i > best_count) {
+              best = seen[i];
+              best_count = j - i;
+            }
+            i = j;
+          }
+          next_labels[n] = best;
+          if (best != labels[n]) {
+            num_changed.fetch_add(1, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::no_stats());
+    std::swap(labels, next_labels);
+    // stop once nearly every node has settled
+    if (num_changed.load() * 1000 <= num_nodes) {
+      break;
+    }
+  }
+
+  PropIndexVec order;
+  order.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::iota(
+      order.begin(), order.end(), GraphTopologyTypes::PropertyIndex{0});
+  katana::ParallelSTL::sample_sort(
+      order.begin(), order.end(), [&](const auto& a, const auto& b) {
+        return labels[a] == labels[b] ? a < b : labels[a] < labels[b];
+      });
+
+  return MakeNodePermutedTopo(
+      seed_topo, order,
+      katana::RDGTopology::NodeSortKind::kClusteredByCommunity);
+}
+
 std::shared_ptr<katana::ShuffleTopology>
 katana::ShuffleTopology::Make(katana::RDGTopology* rdg_topo) {
   KATANA_LOG_DEBUG_ASSERT(rdg_topo);
@@ -529,6 +1363,16 @@ katana::ShuffleTopology::ToRDGTopology() const {
   return katana::RDGTopology(std::move(topo));
 }
 
+uint64_t
+katana::CondensedTypeIDMap::SizeBytes() const noexcept {
+  // A node of the hash map per type and its bucket
+  constexpr uint64_t kMapEntryBytes =
+      sizeof(TypeIDToIndexMap::value_type) + 2 * sizeof(void*);
+  return type_to_index_map_.size() * kMapEntryBytes +
+         type_to_index_map_.bucket_count() * sizeof(void*) +
+         index_to_type_map_.size() * sizeof(EntityTypeID);
+}
+
 std::shared_ptr<katana::CondensedTypeIDMap>
 katana::CondensedTypeIDMap::MakeFromEdgeTypes(
     const katana::PropertyGraph* pg) noexcept {
@@ -549,7 +1393,7 @@ katana::CondensedTypeIDMap::MakeFromEdgeTypes(
 
   // ordered map
   std::set<katana::EntityTypeID> mergedSet;
-  for (uint32_t i = 0; i < katana::activeThreads; ++i) {
+  for (uint32_t i = 0; i < katana::getActiveThreads(); ++i) {
     auto& edgeTypesSet = *edgeTypes.getRemote(i);
     for (auto edgeType : edgeTypesSet) {
       mergedSet.insert(edgeType);
@@ -574,6 +1418,89 @@ katana::CondensedTypeIDMap::MakeFromEdgeTypes(
       std::move(edge_type_to_index), std::move(edge_index_to_type)});
 }
 
+std::shared_ptr<katana::EdgeLookupIndex>
+katana::EdgeLookupIndex::Make(const EdgeShuffleTopology& topo) noexcept {
+  auto index = std::make_shared<EdgeLookupIndex>();
+  uint64_t num_nodes = topo.NumNodes();
+  uint64_t bitmap_words = (num_nodes + 63) / 64;
+
+  index->kinds_.allocateInterleaved(num_nodes);
+  index->offsets_.allocateInterleaved(num_nodes + 1);
+  index->offsets_[0] = 0;
+
+  katana::GAccumulator<uint64_t> num_filtered;
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node n) {
+        uint64_t degree = topo.OutDegree(n);
+        uint64_t num_words = 0;
+        Kind kind = Kind::kNone;
+        if (degree >= kMinDegree && degree * kBitmapDensity >= num_nodes) {
+          kind = Kind::kBitmap;
+          num_words = bitmap_words;
+        } else if (degree >= kMinDegree) {
+          // less than half full, two slots per word
+          uint64_t num_slots = uint64_t{1} << (65 - __builtin_clzll(degree));
+          kind = Kind::kHash;
+          num_words = num_slots / 2;
+        } else if (degree >= kMinFilteredDegree) {
+          kind = Kind::kFiltered;
+          num_filtered += degree;
+        }
+        index->kinds_[n] = kind;
+        index->offsets_[n + 1] = num_words;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      index->offsets_.begin(), index->offsets_.end(), index->offsets_.begin());
+  if (num_filtered.reduce() > 0) {
+    index->filter_ = BloomFilter(num_filtered.reduce());
+  }
+
+  index->words_.allocateInterleaved(index->offsets_[num_nodes]);
+
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node n) {
+        uint64_t* words = index->words_.data() + index->offsets_[n];
+        uint64_t num_words = index->offsets_[n + 1] - index->offsets_[n];
+        switch (index->kinds_[n]) {
+        case Kind::kNone:
+          return;
+        case Kind::kFiltered:
+          for (auto e : topo.OutEdges(n)) {
+            index->filter_.Insert(EdgeHash(n, topo.OutEdgeDst(e)));
+          }
+          return;
+        case Kind::kBitmap:
+          std::fill(words, words + num_words, uint64_t{0});
+          for (auto e : topo.OutEdges(n)) {
+            Node dst = topo.OutEdgeDst(e);
+            words[dst / 64] |= uint64_t{1} << (dst % 64);
+          }
+          return;
+        case Kind::kHash: {
+          auto* slots = reinterpret_cast<Node*>(words);
+          uint64_t mask = num_words * 2 - 1;
+          std::fill(slots, slots + num_words * 2, kEmptySlot);
+          for (auto e : topo.OutEdges(n)) {
+            Node dst = topo.OutEdgeDst(e);
+            uint64_t i = HashSlot(dst, mask);
+            // multi-edges repeat a destination
+            while (slots[i] != kEmptySlot && slots[i] != dst) {
+              i = (i + 1) & mask;
+            }
+            slots[i] = dst;
+          }
+          return;
+        }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return index;
+}
+
 katana::EdgeTypeAwareTopology::~EdgeTypeAwareTopology() = default;
 
 katana::EdgeTypeAwareTopology::AdjIndexVec
@@ -727,6 +1654,148 @@ katana::PGViewCache::DropAllTopologies() noexcept {
   fully_shuff_topos_.clear();
   edge_type_aware_topos_.clear();
   edge_type_id_map_.reset();
+  edge_lookup_indices_.clear();
+  stored_topos_.clear();
+}
+
+namespace {
+
+std::string
+TransposeKindName(katana::RDGTopology::TransposeKind kind) {
+  switch (kind) {
+  case katana::RDGTopology::TransposeKind::kNo:
+    return "original";
+  case katana::RDGTopology::TransposeKind::kYes:
+    return "transposed";
+  default:
+    return "any direction";
+  }
+}
+
+std::string
+EdgeSortKindName(katana::RDGTopology::EdgeSortKind kind) {
+  switch (kind) {
+  case katana::RDGTopology::EdgeSortKind::kSortedByDestID:
+    return "edges sorted by dest id";
+  case katana::RDGTopology::EdgeSortKind::kSortedByEdgeType:
+    return "edges sorted by edge type";
+  case katana::RDGTopology::EdgeSortKind::kSortedByNodeType:
+    return "edges sorted by node type";
+  case katana::RDGTopology::EdgeSortKind::kSortedByEdgeProperty:
+    return "edges sorted by edge property";
+  default:
+    return "edges in any order";
+  }
+}
+
+std::string
+NodeSortKindName(katana::RDGTopology::NodeSortKind kind) {
+  switch (kind) {
+  case katana::RDGTopology::NodeSortKind::kSortedByDegree:
+    return "nodes sorted by degree";
+  case katana::RDGTopology::NodeSortKind::kSortedByNodeType:
+    return "nodes sorted by node type";
+  case katana::RDGTopology::NodeSortKind::kReverseCuthillMcKee:
+    return "nodes in reverse Cuthill-McKee order";
+  case katana::RDGTopology::NodeSortKind::kHubClustered:
+    return "nodes hub clustered";
+  case katana::RDGTopology::NodeSortKind::kClusteredByCommunity:
+    return "nodes clustered by community";
+  default:
+    return "nodes in any order";
+  }
+}
+
+std::string
+EdgeShuffleTopologyName(const katana::EdgeShuffleTopology& topo) {
+  return fmt::format(
+      "edge shuffle topology: {}, {}",
+      TransposeKindName(topo.transpose_state()),
+      EdgeSortKindName(topo.edge_sort_state()));
+}
+
+}  // namespace
+
+std::vector<katana::MemoryUsageItem>
+katana::PGViewCache::GetMemoryUsage() const {
+  std::vector<MemoryUsageItem> usage;
+  auto add = [&](const GraphTopology* topo, std::string name) {
+    if (topo != original_topo_.get()) {
+      usage.emplace_back(MemoryUsageItem{std::move(name), topo->SizeBytes()});
+    }
+  };
+  for (const auto& topo : edge_shuff_topos_) {
+    add(topo.get(), EdgeShuffleTopologyName(*topo));
+  }
+  for (const auto& topo : fully_shuff_topos_) {
+    add(topo.get(),
+        fmt::format(
+            "shuffle topology: {}, {}, {}",
+            TransposeKindName(topo->transpose_state()),
+            NodeSortKindName(topo->node_sort_state()),
+            EdgeSortKindName(topo->edge_sort_state())));
+  }
+  for (const auto& topo : edge_type_aware_topos_) {
+    add(topo.get(),
+        fmt::format(
+            "edge type aware topology: {}",
+            TransposeKindName(topo->transpose_state())));
+  }
+  if (edge_type_id_map_) {
+    usage.emplace_back(
+        MemoryUsageItem{"edge type index", edge_type_id_map_->SizeBytes()});
+  }
+  for (const auto& [topo, index] : edge_lookup_indices_) {
+    auto locked = topo.lock();
+    usage.emplace_back(MemoryUsageItem{
+        locked ? "edge lookup index of " + EdgeShuffleTopologyName(*locked)
+               : "edge lookup index of a dropped topology",
+        index->SizeBytes()});
+  }
+  return usage;
+}
+
+void
+katana::PGViewCache::ApplyEdgeDeltas(const EdgeDeltas& deltas) noexcept {
+  if (deltas.empty()) {
+    return;
+  }
+
+  // Only the default topology is patched. Derived topologies are dropped and
+  // rebuilt from it when a view next asks for them, so a run of edits does
+  // not copy every cached topology once per edit.
+  std::shared_ptr<EdgeShuffleTopology> patched_shuffle;
+  for (const auto& topo : edge_shuff_topos_) {
+    stored_topos_.erase(topo.get());
+    topo->invalidate();
+    if (original_topo_ == topo) {
+      patched_shuffle = EdgeShuffleTopology::MakePatched(*topo, deltas);
+    }
+  }
+  edge_shuff_topos_.clear();
+  for (const auto& topo : fully_shuff_topos_) {
+    stored_topos_.erase(topo.get());
+    topo->invalidate();
+  }
+  fully_shuff_topos_.clear();
+  for (const auto& topo : edge_type_aware_topos_) {
+    stored_topos_.erase(topo.get());
+    topo->invalidate();
+  }
+  edge_type_aware_topos_.clear();
+  if (edge_type_id_map_) {
+    edge_type_id_map_->invalidate();
+  }
+
+  if (patched_shuffle) {
+    // the default topology was reseated to a sorted topology; it stays
+    // cached as one
+    edge_shuff_topos_.emplace_back(patched_shuffle);
+    original_topo_ = std::move(patched_shuffle);
+  } else {
+    original_topo_ = std::make_shared<GraphTopology>(
+        GraphTopology::MakePatched(*original_topo_, deltas));
+  }
 }
 
 std::shared_ptr<katana::CondensedTypeIDMap>
@@ -781,6 +1850,7 @@ katana::PGViewCache::BuildOrGetEdgeShuffTopoImpl(
     if (pop) {
       auto topo = *it;
       edge_shuff_topos_.erase(it);
+      stored_topos_.erase(topo.get());
       return topo;
     } else {
       return *it;
@@ -810,11 +1880,73 @@ katana::PGViewCache::BuildOrGetEdgeShuffTopoImpl(
   if (pop) {
     return new_topo;
   } else {
+    if (res) {
+      stored_topos_.emplace(new_topo.get());
+    }
     edge_shuff_topos_.emplace_back(std::move(new_topo));
     return edge_shuff_topos_.back();
   }
 }
 
+katana::Result<std::shared_ptr<katana::EdgeShuffleTopology>>
+katana::PGViewCache::BuildOrGetEdgesSortedByProperty(
+    katana::PropertyGraph* pg,
+    const katana::RDGTopology::TransposeKind& tpose_kind,
+    const std::string& name) {
+  auto it = std::find_if(
+      edge_shuff_topos_.begin(), edge_shuff_topos_.end(),
+      [&](const auto& topo_ptr) {
+        return topo_ptr->is_valid() &&
+               topo_ptr->has_transpose_state(tpose_kind) &&
+               topo_ptr->edge_sort_state() ==
+                   katana::RDGTopology::EdgeSortKind::kSortedByEdgeProperty &&
+               topo_ptr->edge_sort_property() == name;
+      });
+  if (it != edge_shuff_topos_.end()) {
+    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
+    return *it;
+  }
+
+  // No matching topology in cache, see if we have it in storage
+  katana::RDGTopology shadow = katana::RDGTopology::MakeShadow(
+      katana::RDGTopology::TopologyKind::kEdgeShuffleTopology, tpose_kind,
+      katana::RDGTopology::EdgeSortKind::kSortedByEdgeProperty,
+      katana::RDGTopology::NodeSortKind::kAny, name);
+
+  auto res = pg->LoadTopology(std::move(shadow));
+  std::shared_ptr<EdgeShuffleTopology> new_topo;
+  if (res) {
+    new_topo = EdgeShuffleTopology::Make(res.value());
+    stored_topos_.emplace(new_topo.get());
+  } else {
+    new_topo = KATANA_CHECKED(
+        EdgeShuffleTopology::MakeSortedByEdgeProperty(pg, tpose_kind, name));
+  }
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, new_topo.get()));
+
+  edge_shuff_topos_.emplace_back(std::move(new_topo));
+  return edge_shuff_topos_.back();
+}
+
+void
+katana::PGViewCache::DropTopologiesSortedBy(const std::string& name) noexcept {
+  auto sorted_by_name = [&](const auto& topo) {
+    return topo->edge_sort_state() ==
+               katana::RDGTopology::EdgeSortKind::kSortedByEdgeProperty &&
+           topo->edge_sort_property() == name;
+  };
+  for (const auto& topo : edge_shuff_topos_) {
+    if (sorted_by_name(topo)) {
+      stored_topos_.erase(topo.get());
+      topo->invalidate();
+    }
+  }
+  edge_shuff_topos_.erase(
+      std::remove_if(
+          edge_shuff_topos_.begin(), edge_shuff_topos_.end(), sorted_by_name),
+      edge_shuff_topos_.end());
+}
+
 std::shared_ptr<katana::ShuffleTopology>
 katana::PGViewCache::BuildOrGetShuffTopo(
     katana::PropertyGraph* pg,
@@ -860,6 +1992,7 @@ katana::PGViewCache::BuildOrGetShuffTopo(
       // found matching topology in storage
       katana::RDGTopology* topo = res.value();
       fully_shuff_topos_.emplace_back(katana::ShuffleTopology::Make(topo));
+      stored_topos_.emplace(fully_shuff_topos_.back().get());
     }
 
     KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, fully_shuff_topos_.back().get()));
@@ -867,6 +2000,15 @@ katana::PGViewCache::BuildOrGetShuffTopo(
   }
 }
 
+std::shared_ptr<katana::EdgeShuffleTopology>
+katana::PGViewCache::BuildEdgeTypeTopo(
+    katana::PropertyGraph* pg,
+    const katana::RDGTopology::TransposeKind& tpose_kind,
+    const katana::EntityTypeID& edge_type) noexcept {
+  auto topo = BuildOrGetEdgeTypeAwareTopo(pg, tpose_kind);
+  return katana::EdgeShuffleTopology::MakeOfEdgeType(*topo, edge_type);
+}
+
 std::shared_ptr<katana::EdgeTypeAwareTopology>
 katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
     katana::PropertyGraph* pg,
@@ -907,6 +2049,7 @@ katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
 
       edge_type_aware_topos_.emplace_back(katana::EdgeTypeAwareTopology::Make(
           rdg_topo, std::move(edge_type_index), std::move(*sorted_topo)));
+      stored_topos_.emplace(edge_type_aware_topos_.back().get());
     } else {
       // no matching topology in cache or storage, generate it
       edge_type_aware_topos_.emplace_back(EdgeTypeAwareTopology::MakeFrom(
@@ -920,23 +2063,61 @@ katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
   }
 }
 
+std::shared_ptr<katana::EdgeLookupIndex>
+katana::PGViewCache::BuildOrGetEdgeLookupIndex(
+    const std::shared_ptr<EdgeShuffleTopology>& topo) noexcept {
+  for (const auto& [built_from, index] : edge_lookup_indices_) {
+    if (built_from.lock() == topo && topo->is_valid()) {
+      return index;
+    }
+  }
+
+  auto gone = [](const auto& entry) {
+    auto built_from = entry.first.lock();
+    return !built_from || !built_from->is_valid();
+  };
+  edge_lookup_indices_.erase(
+      std::remove_if(
+          edge_lookup_indices_.begin(), edge_lookup_indices_.end(), gone),
+      edge_lookup_indices_.end());
+
+  edge_lookup_indices_.emplace_back(topo, EdgeLookupIndex::Make(*topo));
+  return edge_lookup_indices_.back().second;
+}
+
 katana::Result<std::vector<katana::RDGTopology>>
 katana::PGViewCache::ToRDGTopology() {
   std::vector<katana::RDGTopology> rdg_topos;
+  if (persist_policy_ == PersistPolicy::kNone) {
+    return rdg_topos;
+  }
+
+  auto is_new = [this](const auto& topo) {
+    return stored_topos_.count(topo.get()) == 0;
+  };
 
   for (size_t i = 0; i < edge_shuff_topos_.size(); i++) {
+    if (!is_new(edge_shuff_topos_[i])) {
+      continue;
+    }
     katana::RDGTopology topo =
         KATANA_CHECKED(edge_shuff_topos_[i]->ToRDGTopology());
     rdg_topos.emplace_back(std::move(topo));
   }
 
   for (size_t i = 0; i < fully_shuff_topos_.size(); i++) {
+    if (!is_new(fully_shuff_topos_[i])) {
+      continue;
+    }
     katana::RDGTopology topo =
         KATANA_CHECKED(fully_shuff_topos_[i]->ToRDGTopology());
     rdg_topos.emplace_back(std::move(topo));
   }
 
   for (size_t i = 0; i < edge_type_aware_topos_.size(); i++) {
+    if (!is_new(edge_type_aware_topos_[i])) {
+      continue;
+    }
     katana::RDGTopology topo =
         KATANA_CHECKED(edge_type_aware_topos_[i]->ToRDGTopology());
     rdg_topos.emplace_back(std::move(topo));
@@ -945,6 +2126,94 @@ katana::PGViewCache::ToRDGTopology() {
   return std::vector<katana::RDGTopology>(std::move(rdg_topos));
 }
 
+void
+katana::PGViewCache::MarkTopologiesStored() noexcept {
+  if (persist_policy_ == PersistPolicy::kNone) {
+    return;
+  }
+  for (const auto& topo : edge_shuff_topos_) {
+    stored_topos_.emplace(topo.get());
+  }
+  for (const auto& topo : fully_shuff_topos_) {
+    stored_topos_.emplace(topo.get());
+  }
+  for (const auto& topo : edge_type_aware_topos_) {
+    stored_topos_.emplace(topo.get());
+  }
+}
+
+katana::Result<std::vector<katana::RDGTopology>>
+katana::PGViewCache::CachedRDGTopologies() const {
+  std::vector<katana::RDGTopology> rdg_topos;
+  for (const auto& topo : edge_shuff_topos_) {
+    rdg_topos.emplace_back(KATANA_CHECKED(topo->ToRDGTopology()));
+  }
+  for (const auto& topo : fully_shuff_topos_) {
+    rdg_topos.emplace_back(KATANA_CHECKED(topo->ToRDGTopology()));
+  }
+  for (const auto& topo : edge_type_aware_topos_) {
+    rdg_topos.emplace_back(
+        KATANA_CHECKED(topo->EdgeShuffleTopology::ToRDGTopology()));
+    rdg_topos.emplace_back(KATANA_CHECKED(topo->ToRDGTopology()));
+  }
+  return std::vector<katana::RDGTopology>(std::move(rdg_topos));
+}
+
+katana::Result<void>
+katana::PGViewCache::AddRDGTopologies(
+    const katana::PropertyGraph* pg,
+    std::vector<katana::RDGTopology>* rdg_topos) {
+  using TopologyKind = katana::RDGTopology::TopologyKind;
+  for (size_t i = 0; i < rdg_topos->size(); ++i) {
+    katana::RDGTopology* rdg_topo = &(*rdg_topos)[i];
+    if (rdg_topo->num_nodes() != pg->NumNodes() ||
+        rdg_topo->num_edges() != pg->NumEdges()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "topology of {} nodes and {} edges does not match a graph of {} "
+          "nodes and {} edges",
+          rdg_topo->num_nodes(), rdg_topo->num_edges(), pg->NumNodes(),
+          pg->NumEdges());
+    }
+
+    switch (rdg_topo->topology_state()) {
+    case TopologyKind::kEdgeShuffleTopology: {
+      auto shuffled = katana::EdgeShuffleTopology::Make(rdg_topo);
+      bool extended = i + 1 < rdg_topos->size() &&
+                      (*rdg_topos)[i + 1].topology_state() ==
+                          TopologyKind::kEdgeTypeAwareTopology;
+      if (!extended) {
+        edge_shuff_topos_.emplace_back(std::move(shuffled));
+        break;
+      }
+
+      katana::RDGTopology* type_aware = &(*rdg_topos)[++i];
+      auto edge_type_index = BuildOrGetEdgeTypeIndex(pg);
+      if (!edge_type_index->index_to_type_map_matches(
+              type_aware->edge_condensed_type_id_map_size(),
+              type_aware->edge_condensed_type_id_map())) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "edge type aware topology does not match the edge types of the "
+            "graph");
+      }
+      edge_type_aware_topos_.emplace_back(katana::EdgeTypeAwareTopology::Make(
+          type_aware, std::move(edge_type_index), std::move(*shuffled)));
+      break;
+    }
+    case TopologyKind::kShuffleTopology:
+      fully_shuff_topos_.emplace_back(katana::ShuffleTopology::Make(rdg_topo));
+      break;
+    default:
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "cannot cache a topology of kind {}",
+          static_cast<int>(rdg_topo->topology_state()));
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 katana::GraphTopology
 katana::CreateUniformRandomTopology(
     const size_t num_nodes, const size_t edges_per_node) noexcept {
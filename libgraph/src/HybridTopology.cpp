@@ -0,0 +1,80 @@
+#include "katana/HybridTopology.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Threads.h"
+
+katana::HybridTopology
+katana::HybridTopology::Make(const GraphTopology& seed) noexcept {
+  HybridTopology topo;
+  uint64_t num_nodes = seed.NumNodes();
+  uint64_t num_edges = seed.NumEdges();
+
+  topo.records_.allocateInterleaved(num_nodes);
+  topo.edge_prop_indices_.allocateInterleaved(num_edges);
+  topo.node_prop_indices_.allocateInterleaved(num_nodes);
+
+  // inclusive prefix sum of the number of destinations each node keeps
+  // outside of its record
+  NUMAArray<uint64_t> hub_ends;
+  hub_ends.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(seed.Nodes()),
+      [&](Node n) {
+        uint64_t degree = seed.OutDegree(n);
+        hub_ends[n] = degree > kInlineDegree ? degree : 0;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      hub_ends.begin(), hub_ends.end(), hub_ends.begin());
+
+  uint64_t num_hub_dests = num_nodes == 0 ? 0 : hub_ends[num_nodes - 1];
+  topo.hub_dests_.allocateInterleaved(num_hub_dests);
+
+  using DstAndProp = std::pair<Node, PropertyIndex>;
+  katana::PerThreadStorage<std::vector<DstAndProp>> edges_scratch;
+  katana::PerThreadStorage<uint64_t> hubs_scratch;
+
+  katana::do_all(
+      katana::iterate(seed.Nodes()),
+      [&](Node n) {
+        auto edges = seed.OutEdges(n);
+        std::vector<DstAndProp>& sorted = *edges_scratch.getLocal();
+        sorted.clear();
+        for (auto e : edges) {
+          sorted.emplace_back(
+              seed.OutEdgeDst(e), seed.GetEdgePropertyIndexFromOutEdge(e));
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        NodeRecord& record = topo.records_[n];
+        record.first_edge = *edges.begin();
+        record.degree = sorted.size();
+        record.segment_begin = hub_ends[n];
+        Node* dsts = record.inline_dests;
+        if (record.degree > kInlineDegree) {
+          record.segment_begin -= record.degree;
+          dsts = topo.hub_dests_.data() + record.segment_begin;
+          ++*hubs_scratch.getLocal();
+        }
+        for (uint32_t i = 0; i < record.degree; ++i) {
+          dsts[i] = sorted[i].first;
+          topo.edge_prop_indices_[record.first_edge + i] = sorted[i].second;
+        }
+        for (uint32_t i = record.degree; i < kInlineDegree; ++i) {
+          record.inline_dests[i] = 0;
+        }
+        topo.node_prop_indices_[n] = seed.GetNodePropertyIndex(n);
+      },
+      katana::steal(), katana::no_stats());
+
+  for (unsigned i = 0; i < katana::getActiveThreads(); ++i) {
+    topo.num_hubs_ += *hubs_scratch.getRemote(i);
+  }
+  return topo;
+}
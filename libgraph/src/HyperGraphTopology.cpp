@@ -0,0 +1,182 @@
+#include "katana/HyperGraphTopology.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PropertyGraph.h"
+
+namespace {
+
+/// Lay out the values emitted for each of num_sources sources as one sorted
+/// run per bucket of num_buckets, with ends[b] the end of the run of bucket
+/// b in values. emit(source, push) calls push(bucket, value) for each value
+/// of source, and is called twice per source, once to count and once to
+/// place. Repeated values in a run are dropped if dedupe is true.
+template <typename Emit>
+void
+BuildRuns(
+    uint64_t num_sources, uint64_t num_buckets, const Emit& emit, bool dedupe,
+    katana::NUMAArray<uint64_t>* ends, katana::NUMAArray<uint32_t>* values) {
+  katana::NUMAArray<std::atomic<uint64_t>> cursors;
+  cursors.allocateInterleaved(num_buckets);
+  katana::ParallelSTL::fill(cursors.begin(), cursors.end(), uint64_t{0});
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_sources),
+      [&](uint64_t source) {
+        emit(source, [&](uint64_t bucket, uint32_t) {
+          cursors[bucket].fetch_add(1, std::memory_order_relaxed);
+        });
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::NUMAArray<uint64_t> run_ends;
+  run_ends.allocateInterleaved(num_buckets);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_buckets),
+      [&](uint64_t b) {
+        run_ends[b] = cursors[b].load(std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      run_ends.begin(), run_ends.end(), run_ends.begin());
+  uint64_t num_values = num_buckets == 0 ? 0 : run_ends[num_buckets - 1];
+
+  // Each run is filled from its start by atomically taking slots
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_buckets),
+      [&](uint64_t b) {
+        cursors[b].store(
+            b == 0 ? 0 : run_ends[b - 1], std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  katana::NUMAArray<uint32_t> runs;
+  runs.allocateInterleaved(num_values);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_sources),
+      [&](uint64_t source) {
+        emit(source, [&](uint64_t bucket, uint32_t value) {
+          runs[cursors[bucket].fetch_add(1, std::memory_order_relaxed)] =
+              value;
+        });
+      },
+      katana::steal(), katana::no_stats());
+
+  // Sort each run and count what it keeps
+  ends->allocateInterleaved(num_buckets);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_buckets),
+      [&](uint64_t b) {
+        uint32_t* begin = runs.data() + (b == 0 ? 0 : run_ends[b - 1]);
+        uint32_t* end = runs.data() + run_ends[b];
+        std::sort(begin, end);
+        if (dedupe) {
+          end = std::unique(begin, end);
+        }
+        (*ends)[b] = end - begin;
+      },
+      katana::steal(), katana::no_stats());
+  if (!dedupe) {
+    std::swap(*ends, run_ends);
+    std::swap(*values, runs);
+    return;
+  }
+
+  katana::ParallelSTL::partial_sum(ends->begin(), ends->end(), ends->begin());
+  values->allocateInterleaved(num_buckets == 0 ? 0 : (*ends)[num_buckets - 1]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_buckets),
+      [&](uint64_t b) {
+        uint64_t begin = b == 0 ? 0 : (*ends)[b - 1];
+        const uint32_t* run = runs.data() + (b == 0 ? 0 : run_ends[b - 1]);
+        std::copy(run, run + ((*ends)[b] - begin), values->data() + begin);
+      },
+      katana::steal(), katana::no_stats());
+}
+
+}  // namespace
+
+katana::Result<katana::HyperGraphTopology>
+katana::HyperGraphTopology::Make(
+    const PropertyGraph* pg, const std::string& net_node_type) {
+  if (!pg->GetNodeTypeManager().HasAtomicType(net_node_type)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "Node type: {} Not found",
+        net_node_type);
+  }
+  NUMAArray<uint8_t> is_net;
+  is_net.allocateInterleaved(pg->NumNodes());
+  pg->DoNodesHaveType(
+      0, pg->NumNodes(), pg->GetNodeEntityTypeID(net_node_type),
+      is_net.data());
+  return Make(pg->topology(), is_net.data());
+}
+
+katana::HyperGraphTopology
+katana::HyperGraphTopology::Make(
+    const GraphTopology& topology, const uint8_t* is_net) noexcept {
+  HyperGraphTopology hg;
+  uint64_t num_nodes = topology.NumNodes();
+  hg.is_net_.allocateInterleaved(num_nodes);
+  hg.node_ids_.allocateInterleaved(num_nodes);
+
+  // Number the nets and the pins in node order from the number of nets up
+  // to each node
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        hg.is_net_[n] = is_net[n] != 0;
+        hg.node_ids_[n] = hg.is_net_[n];
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      hg.node_ids_.begin(), hg.node_ids_.end(), hg.node_ids_.begin());
+  uint64_t num_nets = num_nodes == 0 ? 0 : hg.node_ids_[num_nodes - 1];
+  hg.net_nodes_.allocateInterleaved(num_nets);
+  hg.pin_nodes_.allocateInterleaved(num_nodes - num_nets);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint32_t nets_up_to = hg.node_ids_[n];
+        if (hg.is_net_[n]) {
+          hg.node_ids_[n] = nets_up_to - 1;
+          hg.net_nodes_[nets_up_to - 1] = n;
+        } else {
+          hg.node_ids_[n] = n - nets_up_to;
+          hg.pin_nodes_[n - nets_up_to] = n;
+        }
+      },
+      katana::no_stats());
+
+  // The pins of each net, from the edges of both nets and pins, so that
+  // edges stored in either direction count
+  BuildRuns(
+      num_nodes, num_nets,
+      [&](uint64_t n, const auto& push) {
+        for (auto e : topology.OutEdges(n)) {
+          Node dst = topology.OutEdgeDst(e);
+          if (hg.is_net_[n] == hg.is_net_[dst]) {
+            continue;
+          }
+          if (hg.is_net_[n]) {
+            push(hg.node_ids_[n], hg.node_ids_[dst]);
+          } else {
+            push(hg.node_ids_[dst], hg.node_ids_[n]);
+          }
+        }
+      },
+      true, &hg.net_ends_, &hg.net_pins_);
+
+  BuildRuns(
+      num_nets, hg.pin_nodes_.size(),
+      [&](uint64_t net, const auto& push) {
+        for (Pin pin : hg.Pins(net)) {
+          push(pin, net);
+        }
+      },
+      false, &hg.pin_ends_, &hg.pin_nets_);
+  return hg;
+}
@@ -0,0 +1,67 @@
+#include "katana/ProjectedGraphView.h"
+
+#include "katana/ErrorCode.h"
+#include "katana/PropertyFilter.h"
+
+katana::Result<std::unique_ptr<katana::ProjectedGraphView>>
+katana::ProjectedGraphView::Make(
+    PropertyGraph* pg, DynamicBitset&& node_selection,
+    std::optional<DynamicBitset>&& edge_selection) {
+  if (node_selection.size() != pg->NumOriginalNodes()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "node selection has {} nodes but the graph has {}",
+        node_selection.size(), pg->NumOriginalNodes());
+  }
+  if (edge_selection && edge_selection->size() != pg->NumOriginalEdges()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edge selection has {} edges but the graph has {}",
+        edge_selection->size(), pg->NumOriginalEdges());
+  }
+  // Using `new` to access a non-public constructor.
+  return std::unique_ptr<ProjectedGraphView>(new ProjectedGraphView(
+      pg, std::move(node_selection), std::move(edge_selection)));
+}
+
+katana::Result<std::unique_ptr<katana::ProjectedGraphView>>
+katana::ProjectedGraphView::Make(
+    PropertyGraph* pg, const std::optional<SetOfEntityTypeIDs>& node_types,
+    const std::optional<SetOfEntityTypeIDs>& edge_types) {
+  DynamicBitset node_selection;
+  if (node_types) {
+    node_selection = KATANA_CHECKED(
+        PropertyFilter::HasType(node_types.value()).SelectNodes(*pg));
+  } else {
+    node_selection.resize(pg->NumOriginalNodes());
+    node_selection.bitwise_not();
+  }
+  std::optional<DynamicBitset> edge_selection;
+  if (edge_types) {
+    edge_selection = KATANA_CHECKED(
+        PropertyFilter::HasType(edge_types.value()).SelectEdges(*pg));
+  }
+  return Make(pg, std::move(node_selection), std::move(edge_selection));
+}
+
+katana::Result<katana::PropertyGraph*>
+katana::ProjectedGraphView::Materialize() {
+  std::lock_guard<std::mutex> lock(materialized_mutex_);
+  if (!materialized_) {
+    materialized_ = KATANA_CHECKED(PropertyGraph::MakeProjectedGraph(
+        *pg_, node_selection_, edge_selection()));
+  }
+  return materialized_.get();
+}
+
+bool
+katana::ProjectedGraphView::IsMaterialized() const {
+  std::lock_guard<std::mutex> lock(materialized_mutex_);
+  return materialized_ != nullptr;
+}
+
+void
+katana::ProjectedGraphView::ReleaseMaterialized() {
+  std::lock_guard<std::mutex> lock(materialized_mutex_);
+  materialized_.reset();
+}
@@ -0,0 +1,412 @@
+#include "katana/PropertyFilter.h"
+
+#include <algorithm>
+#include <optional>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/PropertyGraph.h"
+
+namespace {
+
+/// Properties are evaluated in blocks of this many rows; a multiple of 64, so
+/// that blocks within a chunk write whole words of the selection
+constexpr size_t kBlockSize = 1 << 16;
+
+static_assert(kBlockSize % 64 == 0);
+
+/// Rows [offset, offset + length) of a chunk, the first of which is row
+/// start of the column
+struct Block {
+  int chunk;
+  int64_t offset;
+  int64_t length;
+  size_t start;
+};
+
+/// Split column into blocks that do not straddle a chunk or a multiple of
+/// kBlockSize
+std::vector<Block>
+MakeBlocks(const arrow::ChunkedArray& column) {
+  std::vector<Block> blocks;
+  size_t start = 0;
+  for (int c = 0; c < column.num_chunks(); ++c) {
+    int64_t length = column.chunk(c)->length();
+    int64_t offset = 0;
+    while (offset < length) {
+      size_t end = std::min(
+          (start / kBlockSize + 1) * kBlockSize,
+          start + static_cast<size_t>(length - offset));
+      int64_t block_length = end - start;
+      blocks.emplace_back(Block{c, offset, block_length, start});
+      offset += block_length;
+      start = end;
+    }
+  }
+  return blocks;
+}
+
+/// The length <= 64 bits of bitmap starting at bit offset, as a word whose
+/// bits past length are 0
+uint64_t
+ReadBits(const uint8_t* bitmap, int64_t offset, int64_t length) {
+  const uint8_t* bytes = bitmap + offset / 8;
+  int64_t shift = offset % 8;
+  int64_t num_bytes = (shift + length + 7) / 8;
+  uint64_t word = 0;
+  for (int64_t b = 0; b < num_bytes; ++b) {
+    int64_t pos = b * 8 - shift;
+    uint64_t byte = bytes[b];
+    word |= pos >= 0 ? byte << pos : byte >> -pos;
+  }
+  if (length < 64) {
+    word &= (uint64_t{1} << length) - 1;
+  }
+  return word;
+}
+
+/// The bits of array that are valid, as words
+std::vector<uint64_t>
+ValidBits(const arrow::Array& array) {
+  int64_t length = array.length();
+  std::vector<uint64_t> bits((length + 63) / 64);
+  const uint8_t* validity = array.null_bitmap_data();
+  for (size_t w = 0; w < bits.size(); ++w) {
+    int64_t n = std::min<int64_t>(64, length - 64 * w);
+    if (validity != nullptr) {
+      bits[w] = ReadBits(validity, array.offset() + 64 * w, n);
+    } else if (array.null_count() == length) {
+      bits[w] = 0;
+    } else {
+      bits[w] = n < 64 ? (uint64_t{1} << n) - 1 : ~uint64_t{0};
+    }
+  }
+  return bits;
+}
+
+/// The bits of a boolean array that are valid and true, as words
+std::vector<uint64_t>
+TrueBits(const arrow::BooleanArray& array) {
+  std::vector<uint64_t> bits = ValidBits(array);
+  const uint8_t* values = array.values()->data();
+  for (size_t w = 0; w < bits.size(); ++w) {
+    int64_t n = std::min<int64_t>(64, array.length() - 64 * w);
+    bits[w] &= ReadBits(values, array.offset() + 64 * w, n);
+  }
+  return bits;
+}
+
+/// Or the bits of a block starting at start into selection; the first and
+/// last word of a block may be shared with the neighboring blocks
+void
+OrBits(
+    const std::vector<uint64_t>& bits, size_t start,
+    katana::DynamicBitset* selection) {
+  auto& words = selection->get_vec();
+  size_t first = start / 64;
+  size_t shift = start % 64;
+  for (size_t w = 0; w < bits.size(); ++w) {
+    if (bits[w] == 0) {
+      continue;
+    }
+    words[first + w].fetch_or(bits[w] << shift, std::memory_order_relaxed);
+    if (shift != 0 && (bits[w] >> (64 - shift)) != 0) {
+      words[first + w + 1].fetch_or(
+          bits[w] >> (64 - shift), std::memory_order_relaxed);
+    }
+  }
+}
+
+const char*
+FunctionName(katana::PropertyFilter::CompareOp op) {
+  switch (op) {
+  case katana::PropertyFilter::CompareOp::kEqual:
+    return "equal";
+  case katana::PropertyFilter::CompareOp::kNotEqual:
+    return "not_equal";
+  case katana::PropertyFilter::CompareOp::kLess:
+    return "less";
+  case katana::PropertyFilter::CompareOp::kLessEqual:
+    return "less_equal";
+  case katana::PropertyFilter::CompareOp::kGreater:
+    return "greater";
+  case katana::PropertyFilter::CompareOp::kGreaterEqual:
+    return "greater_equal";
+  }
+  return "equal";
+}
+
+/// Select the rows of column for which bits_of_block, called on each block
+/// of it in parallel, sets a bit
+template <typename BitsFn>
+katana::Result<katana::DynamicBitset>
+SelectBlocks(
+    const arrow::ChunkedArray& column, size_t num_entities,
+    BitsFn bits_of_block) {
+  if (static_cast<size_t>(column.length()) != num_entities) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "property has {} rows but there are {} entities", column.length(),
+        num_entities);
+  }
+  katana::DynamicBitset selection;
+  selection.resize(num_entities);
+
+  std::vector<Block> blocks = MakeBlocks(column);
+  std::vector<std::optional<katana::CopyableErrorInfo>> errors(blocks.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, blocks.size()),
+      [&](size_t b) {
+        const Block& block = blocks[b];
+        auto res = bits_of_block(block);
+        if (!res) {
+          errors[b] = res.error();
+          return;
+        }
+        OrBits(res.value(), block.start, &selection);
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("PropertyFilter"));
+  for (auto& error : errors) {
+    if (error) {
+      return error->WithContext("evaluating property filter");
+    }
+  }
+  return selection;
+}
+
+}  // namespace
+
+struct katana::PropertyFilter::Entities {
+  const PropertyGraph& pg;
+  bool nodes;
+
+  size_t size() const {
+    return nodes ? pg.NumOriginalNodes() : pg.NumOriginalEdges();
+  }
+
+  Result<std::shared_ptr<arrow::ChunkedArray>> Property(
+      const std::string& name) const {
+    return nodes ? pg.GetNodeProperty(name) : pg.GetEdgeProperty(name);
+  }
+
+  const EntityTypeManager& TypeManager() const {
+    return nodes ? pg.GetNodeTypeManager() : pg.GetEdgeTypeManager();
+  }
+
+  EntityTypeID TypeOf(size_t i) const {
+    return nodes ? pg.GetTypeOfNodeFromPropertyIndex(i)
+                 : pg.GetTypeOfEdgeFromPropertyIndex(i);
+  }
+};
+
+katana::PropertyFilter
+katana::PropertyFilter::Compare(
+    std::string property, CompareOp op, std::shared_ptr<arrow::Scalar> value) {
+  PropertyFilter filter(Kind::kCompare);
+  filter.property_ = std::move(property);
+  filter.op_ = op;
+  filter.value_ = std::move(value);
+  return filter;
+}
+
+katana::PropertyFilter
+katana::PropertyFilter::In(
+    std::string property, std::shared_ptr<arrow::Array> values) {
+  PropertyFilter filter(Kind::kIn);
+  filter.property_ = std::move(property);
+  filter.values_ = std::move(values);
+  return filter;
+}
+
+katana::PropertyFilter
+katana::PropertyFilter::IsNull(std::string property) {
+  PropertyFilter filter(Kind::kIsNull);
+  filter.property_ = std::move(property);
+  return filter;
+}
+
+katana::PropertyFilter
+katana::PropertyFilter::IsValid(std::string property) {
+  PropertyFilter filter(Kind::kIsValid);
+  filter.property_ = std::move(property);
+  return filter;
+}
+
+katana::PropertyFilter
+katana::PropertyFilter::HasType(SetOfEntityTypeIDs types) {
+  PropertyFilter filter(Kind::kHasType);
+  filter.types_ = std::move(types);
+  return filter;
+}
+
+katana::PropertyFilter
+katana::PropertyFilter::And(std::vector<PropertyFilter> operands) {
+  PropertyFilter filter(Kind::kAnd);
+  filter.operands_ = std::move(operands);
+  return filter;
+}
+
+katana::PropertyFilter
+katana::PropertyFilter::Or(std::vector<PropertyFilter> operands) {
+  PropertyFilter filter(Kind::kOr);
+  filter.operands_ = std::move(operands);
+  return filter;
+}
+
+katana::PropertyFilter
+katana::PropertyFilter::Not(PropertyFilter operand) {
+  PropertyFilter filter(Kind::kNot);
+  filter.operands_.emplace_back(std::move(operand));
+  return filter;
+}
+
+katana::Result<katana::DynamicBitset>
+katana::PropertyFilter::SelectNodes(const PropertyGraph& pg) const {
+  return Select(Entities{pg, true});
+}
+
+katana::Result<katana::DynamicBitset>
+katana::PropertyFilter::SelectEdges(const PropertyGraph& pg) const {
+  return Select(Entities{pg, false});
+}
+
+katana::Result<katana::DynamicBitset>
+katana::PropertyFilter::Select(const Entities& entities) const {
+  size_t num_entities = entities.size();
+
+  switch (kind_) {
+  case Kind::kAnd:
+  case Kind::kOr: {
+    DynamicBitset selection;
+    selection.resize(num_entities);
+    if (kind_ == Kind::kAnd) {
+      selection.bitwise_not();
+    }
+    for (const auto& operand : operands_) {
+      DynamicBitset operand_selection =
+          KATANA_CHECKED(operand.Select(entities));
+      if (kind_ == Kind::kAnd) {
+        selection.bitwise_and(operand_selection);
+      } else {
+        selection.bitwise_or(operand_selection);
+      }
+    }
+    return selection;
+  }
+  case Kind::kNot: {
+    DynamicBitset selection = KATANA_CHECKED(operands_[0].Select(entities));
+    selection.bitwise_not();
+    return selection;
+  }
+  case Kind::kHasType: {
+    // whether each entity type is, or is a subtype of, one of types_
+    const EntityTypeManager& manager = entities.TypeManager();
+    std::vector<uint8_t> matches(manager.GetNumEntityTypes(), 0);
+    for (size_t id = 0; id < types_.size(); ++id) {
+      if (!types_.test(id) || !manager.HasEntityType(id)) {
+        continue;
+      }
+      std::vector<uint8_t> table = manager.MakeHasTypeTable(id);
+      for (size_t t = 0; t < matches.size(); ++t) {
+        matches[t] |= table[t];
+      }
+    }
+    DynamicBitset selection;
+    selection.resize(num_entities);
+    auto& words = selection.get_vec();
+    katana::do_all(
+        katana::iterate(size_t{0}, words.size()),
+        [&](size_t w) {
+          uint64_t word = 0;
+          size_t end = std::min(64 * w + 64, num_entities);
+          for (size_t i = 64 * w; i < end; ++i) {
+            if (matches[entities.TypeOf(i)]) {
+              word |= uint64_t{1} << (i % 64);
+            }
+          }
+          words[w] = word;
+        },
+        katana::no_stats());
+    return selection;
+  }
+  default:
+    break;
+  }
+
+  std::shared_ptr<arrow::ChunkedArray> column =
+      KATANA_CHECKED(entities.Property(property_));
+  if (!column) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no property {}", property_);
+  }
+
+  if (kind_ == Kind::kIsNull || kind_ == Kind::kIsValid) {
+    bool is_null = kind_ == Kind::kIsNull;
+    return SelectBlocks(
+        *column, num_entities,
+        [&](const Block& block) -> Result<std::vector<uint64_t>> {
+          std::vector<uint64_t> bits =
+              ValidBits(*column->chunk(block.chunk)->Slice(
+                  block.offset, block.length));
+          if (is_null) {
+            for (size_t w = 0; w < bits.size(); ++w) {
+              int64_t n = std::min<int64_t>(64, block.length - 64 * w);
+              uint64_t mask = n < 64 ? (uint64_t{1} << n) - 1 : ~uint64_t{0};
+              bits[w] = ~bits[w] & mask;
+            }
+          }
+          return bits;
+        });
+  }
+
+  auto apply = [&](const std::shared_ptr<arrow::Array>& values)
+      -> Result<std::shared_ptr<arrow::Array>> {
+    arrow::Datum result;
+    if (kind_ == Kind::kCompare) {
+      result = KATANA_CHECKED_CONTEXT(
+          arrow::compute::CallFunction(
+              FunctionName(op_), {arrow::Datum(values), arrow::Datum(value_)}),
+          "comparing property {}", property_);
+    } else {
+      result = KATANA_CHECKED_CONTEXT(
+          arrow::compute::IsIn(
+              values, arrow::compute::SetLookupOptions(values_)),
+          "looking up property {}", property_);
+    }
+    return result.make_array();
+  };
+
+  // A dictionary encoded chunk is evaluated on its dictionary, once for all
+  // of its blocks, and the result taken by code for each block
+  std::vector<std::shared_ptr<arrow::Array>> selected_codes(
+      column->num_chunks());
+  if (column->type()->id() == arrow::Type::DICTIONARY) {
+    for (int c = 0; c < column->num_chunks(); ++c) {
+      const auto& chunk =
+          static_cast<const arrow::DictionaryArray&>(*column->chunk(c));
+      selected_codes[c] = KATANA_CHECKED(apply(chunk.dictionary()));
+    }
+  }
+
+  return SelectBlocks(
+      *column, num_entities,
+      [&](const Block& block) -> Result<std::vector<uint64_t>> {
+        std::shared_ptr<arrow::Array> chunk = column->chunk(block.chunk);
+        std::shared_ptr<arrow::Array> selected;
+        if (selected_codes[block.chunk]) {
+          const auto& dict = static_cast<const arrow::DictionaryArray&>(*chunk);
+          arrow::Datum taken = KATANA_CHECKED(arrow::compute::Take(
+              selected_codes[block.chunk],
+              dict.indices()->Slice(block.offset, block.length)));
+          selected = taken.make_array();
+        } else {
+          selected =
+              KATANA_CHECKED(apply(chunk->Slice(block.offset, block.length)));
+        }
+        return TrueBits(static_cast<const arrow::BooleanArray&>(*selected));
+      });
+}
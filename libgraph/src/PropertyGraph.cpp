@@ -3,13 +3,20 @@
 #include <stdio.h>
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <future>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include <arrow/array.h>
+#include <arrow/util/byte_size.h>
 
 #include "katana/ArrowInterchange.h"
+#include "katana/EntityIndexPrimitive.h"
 #include "katana/ErrorCode.h"
 #include "katana/FileFrame.h"
 #include "katana/GraphTopology.h"
@@ -26,6 +33,7 @@
 #include "katana/RDGStorageFormatVersion.h"
 #include "katana/RDGTopology.h"
 #include "katana/Result.h"
+#include "katana/TakeRows.h"
 #include "katana/tsuba.h"
 
 namespace {
@@ -149,10 +157,437 @@ FillBitMask(
   });
 }
 
+/// Map each of the num_original property indices to the element of a
+/// projection that has it, or to num_original if none does, and mark the
+/// ones that have one in bitmask
+template <typename T, typename PropertyIndexFn>
+void
+FillOriginalToProjected(
+    size_t num_projected, size_t num_original, PropertyIndexFn property_index,
+    katana::NUMAArray<T>* original_to_projected,
+    katana::NUMAArray<uint8_t>* bitmask) {
+  original_to_projected->allocateInterleaved(num_original);
+  katana::ParallelSTL::fill(
+      original_to_projected->begin(), original_to_projected->end(),
+      static_cast<T>(num_original));
+  katana::do_all(
+      katana::iterate(size_t{0}, num_projected),
+      [&](size_t i) { (*original_to_projected)[property_index(i)] = i; },
+      katana::no_stats());
+
+  size_t num_bytes = (num_original + 7) / 8;
+  bitmask->allocateInterleaved(num_bytes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_bytes),
+      [&](size_t byte) {
+        size_t end = std::min(byte * 8 + 8, num_original);
+        uint8_t val{0};
+        for (size_t i = byte * 8; i < end; ++i) {
+          if ((*original_to_projected)[i] != static_cast<T>(num_original)) {
+            val |= uint8_t{1} << (i % 8);
+          }
+        }
+        (*bitmask)[byte] = val;
+      },
+      katana::no_stats());
+}
+
+/// A projection in its own node and edge IDs, with the property index of
+/// every node and edge it kept
+struct ProjectedTopology {
+  katana::GraphTopology::AdjIndexVec out_indices;
+  katana::GraphTopology::EdgeDestVec out_dests;
+  katana::GraphTopology::PropIndexVec node_prop_indices;
+  katana::GraphTopology::PropIndexVec edge_prop_indices;
+};
+
+/// \returns for every EntityTypeID of manager whether it has one of the
+/// atomic types in types; all of them if there are no types to match
+std::vector<bool>
+WantedTypes(
+    const katana::EntityTypeManager& manager,
+    const std::optional<katana::SetOfEntityTypeIDs>& types) {
+  std::vector<bool> wanted(manager.GetNumEntityTypes(), !types);
+  if (!types) {
+    return wanted;
+  }
+  for (size_t type = 0; type < wanted.size(); ++type) {
+    for (auto atomic : types.value()) {
+      if (manager.IsSubtypeOf(atomic, type)) {
+        wanted[type] = true;
+        break;
+      }
+    }
+  }
+  return wanted;
+}
+
+/// \returns a stored topology with nodes sorted by type that can be read by
+/// section, or nullptr if rdg has none
+katana::RDGTopology*
+FindTopologySortedByNodeType(katana::RDG* rdg) {
+  for (auto edge_sort :
+       {katana::RDGTopology::EdgeSortKind::kSortedByEdgeType,
+        katana::RDGTopology::EdgeSortKind::kSortedByDestID,
+        katana::RDGTopology::EdgeSortKind::kAny}) {
+    auto res = rdg->GetTopologySections(katana::RDGTopology::MakeShadow(
+        katana::RDGTopology::TopologyKind::kShuffleTopology,
+        katana::RDGTopology::TransposeKind::kNo, edge_sort,
+        katana::RDGTopology::NodeSortKind::kSortedByNodeType));
+    if (res) {
+      return res.value();
+    }
+    KATANA_LOG_DEBUG("no node type sorted topology to read: {}", res.error());
+  }
+  return nullptr;
+}
+
+/// Project a topology with nodes sorted by type, reading only the parts of it
+/// that hold the wanted nodes and their edges. The nodes of each type are
+/// contiguous, so their range is found by binary search over the few nodes
+/// it touches.
+katana::Result<ProjectedTopology>
+ProjectTopologySortedByNodeType(
+    katana::RDGTopology* topo, const std::vector<bool>& wanted_nodes,
+    const std::vector<bool>& wanted_edges,
+    const katana::PropertyGraph::EntityTypeIDArray& node_type_ids,
+    const katana::PropertyGraph::EntityTypeIDArray& edge_type_ids) {
+  const uint64_t num_nodes = topo->num_nodes();
+  const uint64_t* node_map = topo->node_index_to_property_index_map();
+  const uint64_t* edge_map = topo->edge_index_to_property_index_map();
+  const uint64_t* adj = topo->adj_indices();
+  const uint32_t* dests = topo->dests();
+
+  // the first node whose type is not less than type
+  auto lower_bound = [&](uint64_t type) -> katana::Result<uint64_t> {
+    uint64_t lo = 0;
+    uint64_t hi = num_nodes;
+    while (lo < hi) {
+      uint64_t mid = lo + (hi - lo) / 2;
+      KATANA_CHECKED(topo->FillNodes(mid, mid + 1));
+      if (node_type_ids[node_map[mid]] < type) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  };
+
+  std::vector<std::pair<uint64_t, uint64_t>> ranges;
+  for (uint64_t type = 0; type < wanted_nodes.size(); ++type) {
+    if (!wanted_nodes[type]) {
+      continue;
+    }
+    uint64_t begin = KATANA_CHECKED(lower_bound(type));
+    uint64_t end = KATANA_CHECKED(lower_bound(type + 1));
+    if (begin == end) {
+      continue;
+    }
+    if (!ranges.empty() && ranges.back().second == begin) {
+      ranges.back().second = end;
+    } else {
+      ranges.emplace_back(begin, end);
+    }
+  }
+
+  // read the wanted nodes and all of their out edges; the projected ID of
+  // the first node of a range follows the nodes of the ranges before it
+  std::vector<uint64_t> range_offsets;
+  uint64_t num_projected_nodes = 0;
+  for (const auto& [begin, end] : ranges) {
+    KATANA_CHECKED(topo->FillNodes(begin, end));
+    KATANA_CHECKED(
+        topo->FillEdges(begin > 0 ? adj[begin - 1] : 0, adj[end - 1]));
+    range_offsets.emplace_back(num_projected_nodes);
+    num_projected_nodes += end - begin;
+  }
+
+  katana::NUMAArray<uint64_t> stored_ids;
+  stored_ids.allocateInterleaved(num_projected_nodes);
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    katana::ParallelSTL::iota(
+        &stored_ids[range_offsets[i]],
+        &stored_ids[range_offsets[i]] + (ranges[i].second - ranges[i].first),
+        ranges[i].first);
+  }
+
+  // the projected ID of a stored node, or num_projected_nodes if it is not
+  // in the projection
+  auto to_projected = [&](uint64_t node) {
+    auto it = std::upper_bound(
+        ranges.begin(), ranges.end(), node,
+        [](uint64_t n, const auto& range) { return n < range.first; });
+    if (it == ranges.begin() || node >= std::prev(it)->second) {
+      return num_projected_nodes;
+    }
+    --it;
+    return range_offsets[it - ranges.begin()] + (node - it->first);
+  };
+  auto keep_edge = [&](uint64_t e) {
+    if (to_projected(dests[e]) == num_projected_nodes) {
+      return false;
+    }
+    katana::EntityTypeID type = edge_type_ids[edge_map[e]];
+    return type < wanted_edges.size() && wanted_edges[type];
+  };
+
+  ProjectedTopology projected;
+  projected.out_indices.allocateInterleaved(num_projected_nodes);
+  projected.node_prop_indices.allocateInterleaved(num_projected_nodes);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_projected_nodes),
+      [&](uint64_t p) {
+        uint64_t n = stored_ids[p];
+        uint64_t degree = 0;
+        for (uint64_t e = n > 0 ? adj[n - 1] : 0; e < adj[n]; ++e) {
+          if (keep_edge(e)) {
+            ++degree;
+          }
+        }
+        projected.out_indices[p] = degree;
+        projected.node_prop_indices[p] = node_map[n];
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::ParallelSTL::partial_sum(
+      projected.out_indices.begin(), projected.out_indices.end(),
+      projected.out_indices.begin());
+
+  uint64_t num_projected_edges =
+      num_projected_nodes > 0 ? projected.out_indices[num_projected_nodes - 1]
+                              : 0;
+  projected.out_dests.allocateInterleaved(num_projected_edges);
+  projected.edge_prop_indices.allocateInterleaved(num_projected_edges);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_projected_nodes),
+      [&](uint64_t p) {
+        uint64_t n = stored_ids[p];
+        uint64_t e_new = p > 0 ? projected.out_indices[p - 1] : 0;
+        for (uint64_t e = n > 0 ? adj[n - 1] : 0; e < adj[n]; ++e) {
+          if (keep_edge(e)) {
+            projected.out_dests[e_new] =
+                static_cast<katana::GraphTopology::Node>(
+                    to_projected(dests[e]));
+            projected.edge_prop_indices[e_new] = edge_map[e];
+            ++e_new;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  KATANA_CHECKED(topo->unbind_file_storage());
+
+  return katana::MakeResult(std::move(projected));
+}
+
+/// Copy the topology of a projected view of a graph loaded from storage
+ProjectedTopology
+CopyProjectedTopology(const katana::PropertyGraph& view) {
+  const katana::GraphTopology& topo = view.topology();
+
+  ProjectedTopology projected;
+  projected.out_indices.allocateInterleaved(topo.NumNodes());
+  projected.node_prop_indices.allocateInterleaved(topo.NumNodes());
+  projected.out_dests.allocateInterleaved(topo.NumEdges());
+  projected.edge_prop_indices.allocateInterleaved(topo.NumEdges());
+
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](auto n) {
+        projected.out_indices[n] = *topo.OutEdges(n).end();
+        projected.node_prop_indices[n] = topo.GetNodePropertyIndex(n);
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(topo.OutEdges()),
+      [&](auto e) {
+        projected.out_dests[e] = topo.OutEdgeDst(e);
+        projected.edge_prop_indices[e] =
+            topo.GetEdgePropertyIndexFromOutEdge(e);
+      },
+      katana::no_stats());
+
+  return projected;
+}
+
+/// Build a graph of its own from a projection: the types and properties of
+/// every kept node and edge are copied out of the arrays they were loaded
+/// into, which are indexed by property index
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+MakeCompactedGraph(
+    ProjectedTopology&& projected,
+    const katana::PropertyGraph::EntityTypeIDArray& node_type_ids,
+    const katana::PropertyGraph::EntityTypeIDArray& edge_type_ids,
+    katana::EntityTypeManager&& node_type_manager,
+    katana::EntityTypeManager&& edge_type_manager,
+    const std::shared_ptr<arrow::Table>& node_props,
+    const std::shared_ptr<arrow::Table>& edge_props,
+    katana::TxnContext* txn_ctx) {
+  size_t num_nodes = projected.node_prop_indices.size();
+  size_t num_edges = projected.edge_prop_indices.size();
+
+  katana::PropertyGraph::EntityTypeIDArray node_types;
+  node_types.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        node_types[n] = node_type_ids[projected.node_prop_indices[n]];
+      },
+      katana::no_stats());
+
+  katana::PropertyGraph::EntityTypeIDArray edge_types;
+  edge_types.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t e) {
+        edge_types[e] = edge_type_ids[projected.edge_prop_indices[e]];
+      },
+      katana::no_stats());
+
+  std::shared_ptr<arrow::Table> new_node_props =
+      KATANA_CHECKED(katana::TakeRows(node_props, projected.node_prop_indices));
+  std::shared_ptr<arrow::Table> new_edge_props =
+      KATANA_CHECKED(katana::TakeRows(edge_props, projected.edge_prop_indices));
+
+  std::unique_ptr<katana::PropertyGraph> pg =
+      KATANA_CHECKED(katana::PropertyGraph::Make(
+          katana::GraphTopology(
+              std::move(projected.out_indices), std::move(projected.out_dests)),
+          std::move(node_types), std::move(edge_types),
+          std::move(node_type_manager), std::move(edge_type_manager)));
+
+  if (new_node_props->num_columns() > 0) {
+    KATANA_CHECKED(pg->AddNodeProperties(new_node_props, txn_ctx));
+  }
+  if (new_edge_props->num_columns() > 0) {
+    KATANA_CHECKED(pg->AddEdgeProperties(new_edge_props, txn_ctx));
+  }
+  return katana::MakeResult(std::move(pg));
+}
+
+/// Add the indexes that are still current to stored. An index is stale once
+/// its property has been replaced or removed, since indexes are not updated
+/// with their properties.
+template <typename node_or_edge, typename GetPropertyFn>
+katana::Result<void>
+AddStoredIndexes(
+    const katana::URI& rdg_dir,
+    const std::vector<std::shared_ptr<katana::EntityIndex<node_or_edge>>>&
+        indexes,
+    bool is_node, uint64_t num_entities, GetPropertyFn get_property,
+    katana::EntityIndexPrimitive* stored) {
+  for (const auto& index : indexes) {
+    if (index->kind() == katana::EntityIndexKind::kComposite) {
+      // Composite indexes are cheap to rebuild on demand and not stored.
+      continue;
+    }
+    auto property_res = get_property(index->property_name());
+    if (!property_res || property_res.value()->num_chunks() != 1 ||
+        property_res.value()->chunk(0).get() != &index->property()) {
+      KATANA_LOG_WARN(
+          "not storing stale index over {}", index->property_name());
+      continue;
+    }
+    katana::EntityIndexPrimitive::IndexFiles files;
+    files.property_name = index->property_name();
+    files.is_node = is_node;
+    files.hash = index->kind() == katana::EntityIndexKind::kHash;
+    files.num_entities = num_entities;
+    files.num_entries = index->size();
+    auto [keys, keys_size] = index->key_data();
+    KATANA_CHECKED(stored->AddIndex(
+        rdg_dir, std::move(files), index->ids().data(),
+        index->size() * sizeof(node_or_edge), keys, keys_size));
+  }
+  return katana::ResultSuccess();
+}
+
+/// Restore an index stored by AddStoredIndexes, checking that it still fits
+/// the graph
+template <typename node_or_edge, typename GetPropertyFn>
+katana::Result<std::unique_ptr<katana::EntityIndex<node_or_edge>>>
+LoadStoredIndex(
+    const katana::URI& rdg_dir,
+    const katana::EntityIndexPrimitive::IndexFiles& files,
+    uint64_t num_entities, GetPropertyFn get_property) {
+  if (files.num_entities != num_entities) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "index was stored for {} entities, graph has {}", files.num_entities,
+        num_entities);
+  }
+  std::shared_ptr<arrow::ChunkedArray> chunked_property =
+      KATANA_CHECKED(get_property(files.property_name));
+  std::unique_ptr<katana::EntityIndex<node_or_edge>> index =
+      KATANA_CHECKED(katana::MakeTypedEntityIndex<node_or_edge>(
+          files.property_name, num_entities,
+          KATANA_CHECKED(katana::UnchunkedArray(chunked_property)),
+          files.hash ? katana::EntityIndexKind::kHash
+                     : katana::EntityIndexKind::kSorted));
+
+  katana::FileView ids = KATANA_CHECKED(
+      katana::EntityIndexPrimitive::MapFile(rdg_dir, files.ids_path));
+  katana::FileView keys;
+  if (!files.keys_path.empty()) {
+    keys = KATANA_CHECKED(
+        katana::EntityIndexPrimitive::MapFile(rdg_dir, files.keys_path));
+  }
+  KATANA_CHECKED(index->BuildFromFile(
+      ids.ptr<void>(), ids.size(), keys.Valid() ? keys.ptr<void>() : nullptr,
+      keys.size()));
+  if (index->size() != files.num_entries) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "index was stored with {} entries, file has {}", files.num_entries,
+        index->size());
+  }
+  return katana::MakeResult(std::move(index));
+}
+
 }  // namespace
 
+/// Serializes on-demand property loads against each other and against the
+/// background prefetch, which loads one property at a time under the same
+/// mutex so foreground accesses are never stuck behind the whole list.
+/// prefetch is shared so that any number of threads may wait for it; it has
+/// a mutex of its own since the prefetch holds mutex while loading.
+struct katana::PropertyGraph::LazyPropertyLoader {
+  std::mutex mutex;
+  std::mutex prefetch_mutex;
+  std::shared_future<void> prefetch;
+
+  std::shared_future<void> GetPrefetch() {
+    std::lock_guard<std::mutex> lock(prefetch_mutex);
+    return prefetch;
+  }
+
+  ~LazyPropertyLoader() {
+    if (prefetch.valid()) {
+      prefetch.wait();
+    }
+  }
+};
+
 katana::PropertyGraph::~PropertyGraph() = default;
 
+namespace {
+
+uint64_t
+ColumnMemUse(const std::shared_ptr<arrow::ChunkedArray>& column) {
+  uint64_t bytes = 0;
+  if (column) {
+    for (const auto& chunk : column->chunks()) {
+      bytes += katana::ApproxArrayMemUse(chunk);
+    }
+  }
+  return bytes;
+}
+
+}  // namespace
+
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Make(
     std::unique_ptr<katana::RDGFile> rdg_file, katana::RDG&& rdg,
@@ -167,7 +602,8 @@ katana::PropertyGraph::Make(
   KATANA_LOG_DEBUG_ASSERT(CheckTopology(
       csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges()));
   katana::GraphTopology topo = katana::GraphTopology(
-      csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges());
+      csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges(),
+      rdg.topology_placement());
 
   // The GraphTopology constructor copies all of the required topology data.
   // Clean up the RDGTopologies memory
@@ -224,13 +660,117 @@ katana::PropertyGraph::Make(
   return Make(std::move(new_file), txn_ctx, opts);
 }
 
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::Make(
+    const katana::RDGManifest& rdg_manifest, const katana::RDGLoadOptions& opts,
+    katana::TxnContext* txn_ctx) {
+  auto rdg_handle =
+      KATANA_CHECKED(katana::Open(rdg_manifest, katana::kReadOnly));
+  auto new_file = std::make_unique<katana::RDGFile>(rdg_handle);
+
+  return Make(std::move(new_file), txn_ctx, opts);
+}
+
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Make(
     std::unique_ptr<RDGFile> rdg_file, katana::TxnContext* txn_ctx,
     const katana::RDGLoadOptions& opts) {
   auto rdg = KATANA_CHECKED(RDG::Make(*rdg_file, opts));
-  return katana::PropertyGraph::Make(
-      std::move(rdg_file), std::move(rdg), txn_ctx);
+  if (opts.progress) {
+    KATANA_CHECKED(opts.progress->CheckCancelled());
+  }
+  std::unique_ptr<PropertyGraph> pg =
+      KATANA_CHECKED(katana::PropertyGraph::Make(
+          std::move(rdg_file), std::move(rdg), txn_ctx));
+  if (opts.lazy_load_properties) {
+    pg->StartLazyPropertyLoading(
+        opts.node_properties, opts.edge_properties, opts.progress);
+  }
+  if (opts.progress) {
+    KATANA_CHECKED(opts.progress->CheckCancelled());
+  }
+  pg->indexes_pending_ = true;
+  KATANA_CHECKED(pg->LoadVectorIndexes());
+  return MakeResult(std::move(pg));
+}
+
+void
+katana::PropertyGraph::StartLazyPropertyLoading(
+    const std::optional<std::vector<std::string>>& node_prefetch,
+    const std::optional<std::vector<std::string>>& edge_prefetch,
+    const std::shared_ptr<RDGLoadProgress>& progress) {
+  lazy_loader_ = std::make_shared<LazyPropertyLoader>();
+  PrefetchProperties(
+      node_prefetch.value_or(std::vector<std::string>{}),
+      edge_prefetch.value_or(std::vector<std::string>{}), progress);
+}
+
+void
+katana::PropertyGraph::PrefetchProperties(
+    std::vector<std::string> node_names, std::vector<std::string> edge_names,
+    const std::shared_ptr<RDGLoadProgress>& progress) {
+  WaitForPropertyPrefetch();
+  if (!lazy_loader_) {
+    lazy_loader_ = std::make_shared<LazyPropertyLoader>();
+  }
+  if (node_names.empty() && edge_names.empty()) {
+    return;
+  }
+  if (progress) {
+    progress->properties_total += node_names.size() + edge_names.size();
+  }
+
+  // The task holds its own reference to the RDG; the loader waits for the
+  // task in its destructor, so the raw loader pointer outlives the task.
+  std::shared_future<void> task = std::async(
+      std::launch::async, [rdg = rdg_, loader = lazy_loader_.get(),
+                           node_names = std::move(node_names),
+                           edge_names = std::move(edge_names), progress]() {
+        auto prefetch = [&](const std::string& name, bool is_node) {
+          if (progress && progress->cancelled) {
+            return;
+          }
+          std::lock_guard<std::mutex> lock(loader->mutex);
+          const auto& props =
+              is_node ? rdg->node_properties() : rdg->edge_properties();
+          if (!props->GetColumnByName(name)) {
+            auto res = is_node ? rdg->LoadNodeProperty(name)
+                               : rdg->LoadEdgeProperty(name);
+            if (!res) {
+              KATANA_LOG_WARN(
+                  "prefetching {} property {}: {}", is_node ? "node" : "edge",
+                  name, res.error());
+            }
+          }
+          if (progress) {
+            progress->properties_loaded += 1;
+            progress->bytes_loaded += ColumnMemUse(
+                (is_node ? rdg->node_properties() : rdg->edge_properties())
+                    ->GetColumnByName(name));
+          }
+        };
+        for (const auto& name : node_names) {
+          prefetch(name, true);
+        }
+        for (const auto& name : edge_names) {
+          prefetch(name, false);
+        }
+      });
+  std::lock_guard<std::mutex> lock(lazy_loader_->prefetch_mutex);
+  lazy_loader_->prefetch = std::move(task);
+}
+
+void
+katana::PropertyGraph::WaitForPropertyPrefetch() {
+  if (!lazy_loader_) {
+    return;
+  }
+  // Wait on a copy, so that other threads may wait or start a prefetch
+  // meanwhile
+  std::shared_future<void> prefetch = lazy_loader_->GetPrefetch();
+  if (prefetch.valid()) {
+    prefetch.wait();
+  }
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -278,6 +818,7 @@ katana::PropertyGraph::MakeEmptyEdgeProjectedGraph(
 
   NUMAArray<Edge> out_indices;
   out_indices.allocateInterleaved(num_new_nodes);
+  katana::ParallelSTL::fill(out_indices.begin(), out_indices.end(), Edge{0});
 
   NUMAArray<Node> out_dests;
   NUMAArray<Edge> original_to_projected_edges_mapping;
@@ -295,6 +836,8 @@ katana::PropertyGraph::MakeEmptyEdgeProjectedGraph(
 
   NUMAArray<uint8_t> edge_bitmask;
   edge_bitmask.allocateInterleaved((topology.NumEdges() + 7) / 8);
+  katana::ParallelSTL::fill(
+      edge_bitmask.begin(), edge_bitmask.end(), uint8_t{0});
 
   GraphTopology topo{
       std::move(out_indices), std::move(out_dests),
@@ -377,12 +920,11 @@ katana::PropertyGraph::MakeProjectedGraph(
   return MakeProjectedGraph(pg, node_type_ids, edge_type_ids);
 }
 
-/// Make a projected graph from a property graph. Shares state with
-/// the original graph.
+template <typename NodeSelected, typename EdgeSelected>
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
-katana::PropertyGraph::MakeProjectedGraph(
-    PropertyGraph& pg, std::optional<SetOfEntityTypeIDs> node_types,
-    std::optional<SetOfEntityTypeIDs> edge_types) {
+katana::PropertyGraph::ProjectGraph(
+    PropertyGraph& pg, NodeSelected node_selected,
+    EdgeSelected edge_selected) {
   const auto& topology = pg.topology();
   if (topology.empty()) {
     return MakeEmptyProjectedGraph(pg, katana::DynamicBitset{});
@@ -398,39 +940,27 @@ katana::PropertyGraph::MakeProjectedGraph(
   NUMAArray<Node> original_to_projected_nodes_mapping;
   original_to_projected_nodes_mapping.allocateInterleaved(topology.NumNodes());
 
-  if (!node_types) {
-    num_new_nodes = topology.NumNodes();
-    // set all nodes
-    katana::do_all(katana::iterate(topology.Nodes()), [&](auto src) {
+  katana::ParallelSTL::fill(
+      original_to_projected_nodes_mapping.begin(),
+      original_to_projected_nodes_mapping.end(), Node{0});
+
+  katana::GAccumulator<uint32_t> accum_num_new_nodes;
+
+  katana::do_all(katana::iterate(topology.Nodes()), [&](auto src) {
+    if (node_selected(src)) {
+      accum_num_new_nodes += 1;
       bitset_nodes.set(src);
+      // this sets the corresponding entry in the array to 1
+      // will perform a prefix sum on this array later on
       original_to_projected_nodes_mapping[src] = 1;
-    });
-  } else {
-    katana::ParallelSTL::fill(
-        original_to_projected_nodes_mapping.begin(),
-        original_to_projected_nodes_mapping.end(), Node{0});
-
-    katana::GAccumulator<uint32_t> accum_num_new_nodes;
-
-    katana::do_all(katana::iterate(topology.Nodes()), [&](auto src) {
-      for (auto type : node_types.value()) {
-        if (pg.DoesNodeHaveType(src, type)) {
-          accum_num_new_nodes += 1;
-          bitset_nodes.set(src);
-          // this sets the corresponding entry in the array to 1
-          // will perform a prefix sum on this array later on
-          original_to_projected_nodes_mapping[src] = 1;
-          return;
-        }
-      }
-    });
-    num_new_nodes = accum_num_new_nodes.reduce();
-
-    if (num_new_nodes == 0) {
-      // no nodes selected;
-      // return empty graph
-      return MakeEmptyProjectedGraph(pg, bitset_nodes);
     }
+  });
+  num_new_nodes = accum_num_new_nodes.reduce();
+
+  if (num_new_nodes == 0) {
+    // no nodes selected;
+    // return empty graph
+    return MakeEmptyProjectedGraph(pg, bitset_nodes);
   }
 
   // fill old to new nodes mapping
@@ -469,59 +999,33 @@ katana::PropertyGraph::MakeProjectedGraph(
   // initializes the edge-index array to all zeros
   katana::ParallelSTL::fill(out_indices.begin(), out_indices.end(), Edge{0});
 
-  if (!edge_types) {
-    katana::GAccumulator<uint32_t> accum_num_new_edges;
-    // set all edges incident to projected nodes
-    katana::do_all(
-        katana::iterate(Node{0}, Node{num_new_nodes}),
-        [&](auto src) {
-          auto old_src = projected_to_original_nodes_mapping[src];
-          for (Edge e : topology.OutEdges(old_src)) {
-            auto dest = topology.OutEdgeDst(e);
-            if (bitset_nodes.test(dest)) {
-              bitset_edges.set(e);
-              out_indices[src] += 1;
-              accum_num_new_edges += 1;
-            }
-          }
-        },
-        katana::steal());
+  katana::GAccumulator<uint32_t> accum_num_new_edges;
 
-    num_new_edges = accum_num_new_edges.reduce();
-  } else {
-    katana::GAccumulator<uint32_t> accum_num_new_edges;
-
-    katana::do_all(
-        katana::iterate(Node{0}, Node{num_new_nodes}),
-        [&](auto src) {
-          auto old_src = projected_to_original_nodes_mapping[src];
+  katana::do_all(
+      katana::iterate(Node{0}, Node{num_new_nodes}),
+      [&](auto src) {
+        auto old_src = projected_to_original_nodes_mapping[src];
 
-          for (Edge e : topology.OutEdges(old_src)) {
-            auto dest = topology.OutEdgeDst(e);
-            if (bitset_nodes.test(dest)) {
-              for (auto type : edge_types.value()) {
-                if (pg.DoesEdgeHaveTypeFromTopoIndex(e, type)) {
-                  accum_num_new_edges += 1;
-                  bitset_edges.set(e);
-                  out_indices[src] += 1;
-                  break;
-                }
-              }
-            }
+        for (Edge e : topology.OutEdges(old_src)) {
+          auto dest = topology.OutEdgeDst(e);
+          if (bitset_nodes.test(dest) && edge_selected(e)) {
+            accum_num_new_edges += 1;
+            bitset_edges.set(e);
+            out_indices[src] += 1;
           }
-        },
-        katana::steal());
-
-    num_new_edges = accum_num_new_edges.reduce();
-
-    if (num_new_edges == 0) {
-      // no edge selected
-      // return empty graph with only selected nodes
-      return MakeEmptyEdgeProjectedGraph(
-          pg, num_new_nodes, bitset_nodes,
-          std::move(original_to_projected_nodes_mapping),
-          std::move(projected_to_original_nodes_mapping));
-    }
+        }
+      },
+      katana::steal());
+
+  num_new_edges = accum_num_new_edges.reduce();
+
+  if (num_new_edges == 0) {
+    // no edge selected
+    // return empty graph with only selected nodes
+    return MakeEmptyEdgeProjectedGraph(
+        pg, num_new_nodes, bitset_nodes,
+        std::move(original_to_projected_nodes_mapping),
+        std::move(projected_to_original_nodes_mapping));
   }
 
   // Prefix sum calculation of the edge index array
@@ -575,34 +1079,428 @@ katana::PropertyGraph::MakeProjectedGraph(
     if (!bitset_edges.test(edge)) {
       original_to_projected_edges_mapping[edge] = topology.NumEdges();
     }
-  });
+  });
+
+  FillBitMask(topology.NumEdges(), bitset_edges, &edge_bitmask);
+
+  GraphTopology topo{
+      std::move(out_indices), std::move(out_dests),
+      std::move(projected_to_original_edges_mapping),
+      std::move(projected_to_original_nodes_mapping)};
+
+  // Using `new` to access a non-public constructor.
+  return std::unique_ptr<PropertyGraph>(new PropertyGraph(
+      pg, std::move(topo), std::move(original_to_projected_nodes_mapping),
+      std::move(original_to_projected_edges_mapping), std::move(node_bitmask),
+      std::move(edge_bitmask)));
+}
+
+/// Make a projected graph from a property graph. Shares state with
+/// the original graph.
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::MakeProjectedGraph(
+    PropertyGraph& pg, std::optional<SetOfEntityTypeIDs> node_types,
+    std::optional<SetOfEntityTypeIDs> edge_types) {
+  return ProjectGraph(
+      pg,
+      [&](Node src) {
+        if (!node_types) {
+          return true;
+        }
+        for (auto type : node_types.value()) {
+          if (pg.DoesNodeHaveType(src, type)) {
+            return true;
+          }
+        }
+        return false;
+      },
+      [&](Edge e) {
+        if (!edge_types) {
+          return true;
+        }
+        for (auto type : edge_types.value()) {
+          if (pg.DoesEdgeHaveTypeFromTopoIndex(e, type)) {
+            return true;
+          }
+        }
+        return false;
+      });
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::MakeProjectedGraph(
+    PropertyGraph& pg, const DynamicBitset& node_selection,
+    const DynamicBitset* edge_selection) {
+  if (node_selection.size() != pg.NumOriginalNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "node selection has {} nodes but the graph has {}",
+        node_selection.size(), pg.NumOriginalNodes());
+  }
+  if (edge_selection && edge_selection->size() != pg.NumOriginalEdges()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge selection has {} edges but the graph has {}",
+        edge_selection->size(), pg.NumOriginalEdges());
+  }
+  const auto& topology = pg.topology();
+  return ProjectGraph(
+      pg,
+      [&](Node src) {
+        return node_selection.test(topology.GetNodePropertyIndex(src));
+      },
+      [&](Edge e) {
+        return edge_selection == nullptr ||
+               edge_selection->test(
+                   topology.GetEdgePropertyIndexFromOutEdge(e));
+      });
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::MakeProjectedGraph(
+    PropertyGraph& pg, GraphTopology&& projected_topo) {
+  size_t num_original_nodes = pg.node_entity_type_ids_->size();
+  size_t num_original_edges = pg.edge_entity_type_ids_->size();
+  for (auto n : projected_topo.Nodes()) {
+    if (projected_topo.GetNodePropertyIndex(n) >= num_original_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "node {} of the projection has no node of the graph", n);
+    }
+  }
+  for (auto e : projected_topo.OutEdges()) {
+    if (projected_topo.GetEdgePropertyIndexFromOutEdge(e) >=
+        num_original_edges) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge {} of the projection has no edge of the graph", e);
+    }
+  }
+
+  NUMAArray<Node> original_to_projected_nodes_mapping;
+  NUMAArray<uint8_t> node_bitmask;
+  FillOriginalToProjected(
+      projected_topo.NumNodes(), num_original_nodes,
+      [&](size_t n) { return projected_topo.GetNodePropertyIndex(n); },
+      &original_to_projected_nodes_mapping, &node_bitmask);
+
+  NUMAArray<Edge> original_to_projected_edges_mapping;
+  NUMAArray<uint8_t> edge_bitmask;
+  FillOriginalToProjected(
+      projected_topo.NumEdges(), num_original_edges,
+      [&](size_t e) {
+        return projected_topo.GetEdgePropertyIndexFromOutEdge(e);
+      },
+      &original_to_projected_edges_mapping, &edge_bitmask);
+
+  // Using `new` to access a non-public constructor.
+  return std::unique_ptr<PropertyGraph>(new PropertyGraph(
+      pg, std::move(projected_topo),
+      std::move(original_to_projected_nodes_mapping),
+      std::move(original_to_projected_edges_mapping), std::move(node_bitmask),
+      std::move(edge_bitmask)));
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::MakeProjectedGraph(
+    const katana::URI& rdg_dir,
+    std::optional<std::vector<std::string>> node_types,
+    std::optional<std::vector<std::string>> edge_types,
+    katana::TxnContext* txn_ctx, const katana::RDGLoadOptions& opts) {
+  if (opts.lazy_load_properties) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "properties of a projection are compacted as it is loaded and cannot "
+        "be loaded lazily");
+  }
+
+  katana::RDGManifest manifest =
+      KATANA_CHECKED(katana::FindManifest(rdg_dir, txn_ctx));
+  auto rdg_handle =
+      KATANA_CHECKED(katana::Open(std::move(manifest), katana::kReadOnly));
+  auto rdg_file = std::make_unique<katana::RDGFile>(rdg_handle);
+  katana::RDG rdg = KATANA_CHECKED(katana::RDG::Make(*rdg_file, opts));
+
+  katana::RDGTopology* sorted_topo = nullptr;
+  if (node_types && rdg.IsEntityTypeIDsOutsideProperties()) {
+    sorted_topo = FindTopologySortedByNodeType(&rdg);
+  }
+
+  if (sorted_topo != nullptr) {
+    EntityTypeManager node_type_manager =
+        KATANA_CHECKED(rdg.node_entity_type_manager());
+    EntityTypeManager edge_type_manager =
+        KATANA_CHECKED(rdg.edge_entity_type_manager());
+
+    std::optional<SetOfEntityTypeIDs> node_type_ids =
+        KATANA_CHECKED(node_type_manager.GetEntityTypeIDs(node_types.value()));
+    std::optional<SetOfEntityTypeIDs> edge_type_ids;
+    if (edge_types) {
+      edge_type_ids = KATANA_CHECKED(
+          edge_type_manager.GetEntityTypeIDs(edge_types.value()));
+    }
+
+    EntityTypeIDArray node_entity_type_ids =
+        KATANA_CHECKED(MapEntityTypeIDsArray(
+            rdg.node_entity_type_id_array_file_storage(),
+            sorted_topo->num_nodes(), rdg.IsHeaderlessEntityTypeIDArray()));
+    EntityTypeIDArray edge_entity_type_ids =
+        KATANA_CHECKED(MapEntityTypeIDsArray(
+            rdg.edge_entity_type_id_array_file_storage(),
+            sorted_topo->num_edges(), rdg.IsHeaderlessEntityTypeIDArray()));
+
+    ProjectedTopology projected =
+        KATANA_CHECKED(ProjectTopologySortedByNodeType(
+            sorted_topo, WantedTypes(node_type_manager, node_type_ids),
+            WantedTypes(edge_type_manager, edge_type_ids),
+            node_entity_type_ids, edge_entity_type_ids));
+
+    return MakeCompactedGraph(
+        std::move(projected), node_entity_type_ids, edge_entity_type_ids,
+        std::move(node_type_manager), std::move(edge_type_manager),
+        rdg.node_properties(), rdg.edge_properties(), txn_ctx);
+  }
+
+  // nothing on storage lets us skip parts of the topology, so load all of it
+  // and project in memory
+  std::unique_ptr<PropertyGraph> pg =
+      KATANA_CHECKED(Make(std::move(rdg_file), std::move(rdg), txn_ctx));
+  std::unique_ptr<PropertyGraph> view =
+      KATANA_CHECKED(MakeProjectedGraph(*pg, node_types, edge_types));
+
+  return MakeCompactedGraph(
+      CopyProjectedTopology(*view), pg->mutable_node_entity_type_ids(),
+      pg->mutable_edge_entity_type_ids(),
+      EntityTypeManager(pg->GetNodeTypeManager()),
+      EntityTypeManager(pg->GetEdgeTypeManager()), pg->rdg().node_properties(),
+      pg->rdg().edge_properties(), txn_ctx);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::Copy(
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties,
+    katana::TxnContext* txn_ctx) const {
+  // TODO(gill): This should copy the RDG in memory without reloading from storage.
+  katana::RDGLoadOptions opts;
+  opts.partition_id_to_load = partition_id();
+  opts.node_properties = node_properties;
+  opts.edge_properties = edge_properties;
+
+  return Make(rdg_dir(), txn_ctx, opts);
+}
+
+katana::Result<void>
+katana::PropertyGraph::ApplyEdgeDeltas(const EdgeDeltas& deltas) {
+  if (IsTransformed()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edges of a projected graph cannot be edited");
+  }
+  if (dynamic_topo_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edges inserted or deleted since the last CompactTopology would be "
+        "lost; compact the topology first");
+  }
+  uint64_t num_nodes = NumNodes();
+  for (const auto& del : deltas.deletions) {
+    if (del.src >= num_nodes || del.dst >= num_nodes) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "deleted edge ({}, {}) out of range",
+          del.src, del.dst);
+    }
+  }
+  for (const auto& ins : deltas.insertions) {
+    if (ins.src >= num_nodes || ins.dst >= num_nodes) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "inserted edge ({}, {}) out of range",
+          ins.src, ins.dst);
+    }
+    if (ins.prop_index >= edge_entity_type_ids_->size()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "inserted edge ({}, {}) names property row {} of {}", ins.src,
+          ins.dst, ins.prop_index, edge_entity_type_ids_->size());
+    }
+  }
+  if (deltas.empty()) {
+    return katana::ResultSuccess();
+  }
+  pg_view_cache_.ApplyEdgeDeltas(deltas);
+  rdg_->InvalidateDerivedTopologies();
+  edges_patched_ = true;
+  uncommitted_changes_ = true;
+  graph_statistics_.reset();
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::InsertEdges(
+    const std::vector<std::pair<Node, Node>>& edges,
+    const std::vector<EntityTypeID>& types,
+    const std::shared_ptr<arrow::Table>& properties,
+    katana::TxnContext* txn_ctx) {
+  if (IsTransformed()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edges of a projected graph cannot be edited");
+  }
+  if (types.size() != edges.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} edges but {} edge types",
+        edges.size(), types.size());
+  }
+  if (properties &&
+      static_cast<uint64_t>(properties->num_rows()) != edges.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} edges but {} rows of properties",
+        edges.size(), properties->num_rows());
+  }
+  uint64_t num_nodes = NumNodes();
+  for (size_t i = 0; i < edges.size(); ++i) {
+    const auto& [src, dst] = edges[i];
+    if (src >= num_nodes || dst >= num_nodes) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "inserted edge ({}, {}) out of range",
+          src, dst);
+    }
+    if (!HasEdgeEntityType(types[i])) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "inserted edge ({}, {}) has unknown type {}", src, dst, types[i]);
+    }
+  }
+  if (edges.empty()) {
+    return katana::ResultSuccess();
+  }
 
-  FillBitMask(topology.NumEdges(), bitset_edges, &edge_bitmask);
+  if (rdg_->edge_properties()->num_columns() > 0) {
+    std::shared_ptr<arrow::Table> rows = properties;
+    if (!rows) {
+      // nothing but the number of rows, so every property is null
+      rows = arrow::Table::Make(
+          arrow::schema({}), arrow::ChunkedArrayVector{}, edges.size());
+    }
+    KATANA_CHECKED(rdg_->AppendEdgePropertyRows(rows, txn_ctx));
+  } else if (properties && properties->num_columns() > 0) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound,
+        "inserted edges have property values but the graph has no edge "
+        "properties");
+  }
+
+  if (!dynamic_topo_) {
+    dynamic_topo_ =
+        std::make_unique<DynamicTopology>(DynamicTopology::Make(topology()));
+  }
+  PropertyIndex first_row =
+      edge_entity_type_ids_->size() + inserted_edge_types_.size();
+  std::vector<EdgeDeltas::Insertion> insertions;
+  insertions.reserve(edges.size());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    insertions.emplace_back(EdgeDeltas::Insertion{
+        .src = edges[i].first,
+        .dst = edges[i].second,
+        .prop_index = first_row + i,
+    });
+  }
+  dynamic_topo_->InsertEdges(insertions);
+  inserted_edge_types_.insert(
+      inserted_edge_types_.end(), types.begin(), types.end());
+  uncommitted_changes_ = true;
+  return katana::ResultSuccess();
+}
 
-  GraphTopology topo{
-      std::move(out_indices), std::move(out_dests),
-      std::move(projected_to_original_edges_mapping),
-      std::move(projected_to_original_nodes_mapping)};
+katana::Result<void>
+katana::PropertyGraph::DeleteEdges(
+    const std::vector<std::pair<Node, Node>>& edges) {
+  if (IsTransformed()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edges of a projected graph cannot be edited");
+  }
+  uint64_t num_nodes = NumNodes();
+  std::vector<EdgeDeltas::Deletion> deletions;
+  deletions.reserve(edges.size());
+  for (const auto& [src, dst] : edges) {
+    if (src >= num_nodes || dst >= num_nodes) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "deleted edge ({}, {}) out of range",
+          src, dst);
+    }
+    deletions.emplace_back(EdgeDeltas::Deletion{.src = src, .dst = dst});
+  }
+  if (deletions.empty()) {
+    return katana::ResultSuccess();
+  }
 
-  // Using `new` to access a non-public constructor.
-  return std::unique_ptr<PropertyGraph>(new PropertyGraph(
-      pg, std::move(topo), std::move(original_to_projected_nodes_mapping),
-      std::move(original_to_projected_edges_mapping), std::move(node_bitmask),
-      std::move(edge_bitmask)));
+  if (!dynamic_topo_) {
+    dynamic_topo_ =
+        std::make_unique<DynamicTopology>(DynamicTopology::Make(topology()));
+  }
+  dynamic_topo_->DeleteEdges(deletions);
+  uncommitted_changes_ = true;
+  return katana::ResultSuccess();
 }
 
-katana::Result<std::unique_ptr<katana::PropertyGraph>>
-katana::PropertyGraph::Copy(
-    const std::vector<std::string>& node_properties,
-    const std::vector<std::string>& edge_properties,
-    katana::TxnContext* txn_ctx) const {
-  // TODO(gill): This should copy the RDG in memory without reloading from storage.
-  katana::RDGLoadOptions opts;
-  opts.partition_id_to_load = partition_id();
-  opts.node_properties = node_properties;
-  opts.edge_properties = edge_properties;
+katana::Result<void>
+katana::PropertyGraph::CompactTopology(katana::TxnContext* txn_ctx) {
+  if (!dynamic_topo_ && !edges_patched_) {
+    return katana::ResultSuccess();
+  }
+  // a patched default topology is already a CSR but names the property rows
+  // of its edges out of order
+  std::optional<GraphTopology> built;
+  std::shared_ptr<const GraphTopology> patched;
+  if (dynamic_topo_) {
+    built = dynamic_topo_->ToCSR();
+  } else {
+    patched = pg_view_cache_.ShareDefaultTopology();
+  }
+  const GraphTopology& csr = built ? *built : *patched;
+  uint64_t num_edges = csr.NumEdges();
+  uint64_t num_old_edges = edge_entity_type_ids_->size();
 
-  return Make(rdg_dir(), txn_ctx, opts);
+  // the property row of each edge in CSR order becomes its edge id
+  GraphTopology::PropIndexVec rows;
+  rows.allocateInterleaved(num_edges);
+  auto edge_type_ids = std::make_shared<EntityTypeIDArray>();
+  edge_type_ids->allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        PropertyIndex row = csr.GetEdgePropertyIndexFromOutEdge(e);
+        rows[e] = row;
+        (*edge_type_ids)[e] = row < num_old_edges
+                                  ? edge_entity_data_[row]
+                                  : inserted_edge_types_[row - num_old_edges];
+      },
+      katana::no_stats());
+
+  if (rdg_->edge_properties()->num_columns() > 0) {
+    arrow::UInt64Builder builder;
+    KATANA_CHECKED(builder.AppendValues(rows.data(), rows.size()));
+    std::shared_ptr<arrow::Array> row_ids = KATANA_CHECKED(builder.Finish());
+    KATANA_CHECKED(rdg_->TakeEdgePropertyRows(row_ids, txn_ctx));
+  }
+
+  // the graph is not a projection, so its nodes are their own property rows
+  PGViewCache::PersistPolicy policy = pg_view_cache_.persist_policy();
+  pg_view_cache_ = PGViewCache(GraphTopology(
+      csr.AdjData(), csr.NumNodes(), csr.DestData(), csr.NumEdges()));
+  pg_view_cache_.set_persist_policy(policy);
+
+  edge_entity_type_ids_ = std::move(edge_type_ids);
+  edge_entity_data_ = edge_entity_type_ids_->data();
+  RestoreIndexes();
+  edge_indexes_.clear();
+  rdg_->InvalidateDerivedTopologies();
+  dynamic_topo_.reset();
+  inserted_edge_types_.clear();
+  edges_patched_ = false;
+  graph_statistics_.reset();
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
@@ -763,17 +1661,157 @@ katana::PropertyGraph::DoWriteTopologies() {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::PropertyGraph::DoWriteIndexes() {
+  // The index files are written next to the current RDG and move with it
+  // when it is stored elsewhere; a graph that has never been stored has no
+  // directory to write them to yet.
+  RestoreIndexes();
+  const katana::URI& rdg_dir = rdg_->rdg_dir();
+  if (rdg_dir.empty()) {
+    if (!node_indexes_.empty() || !edge_indexes_.empty()) {
+      KATANA_LOG_WARN(
+          "not storing the {} node and {} edge indexes of a graph stored for "
+          "the first time; they are stored when it is next written",
+          node_indexes_.size(), edge_indexes_.size());
+    }
+    return katana::ResultSuccess();
+  }
+  bool has_stored = KATANA_CHECKED(rdg_->LoadEntityIndexPrimitive()) !=
+                    std::nullopt;
+  if (node_indexes_.empty() && edge_indexes_.empty() && !has_stored) {
+    return katana::ResultSuccess();
+  }
+
+  // Like the entity type id arrays, the indexes are always rewritten since
+  // nothing tracks whether they changed since the last write.
+  katana::EntityIndexPrimitive stored;
+  KATANA_CHECKED(AddStoredIndexes(
+      rdg_dir, node_indexes_, true, NumNodes(),
+      [this](const std::string& name) { return GetNodeProperty(name); },
+      &stored));
+  KATANA_CHECKED(AddStoredIndexes(
+      rdg_dir, edge_indexes_, false, NumEdges(),
+      [this](const std::string& name) { return GetEdgeProperty(name); },
+      &stored));
+  return rdg_->WriteEntityIndexPrimitive(stored);
+}
+
+katana::Result<void>
+katana::PropertyGraph::LoadIndexes() const {
+  std::optional<katana::EntityIndexPrimitive> stored =
+      KATANA_CHECKED(rdg_->LoadEntityIndexPrimitive());
+  if (!stored) {
+    return katana::ResultSuccess();
+  }
+
+  for (const auto& files : stored->indexes()) {
+    if (files.is_node) {
+      auto res = LoadStoredIndex<GraphTopology::Node>(
+          rdg_->rdg_dir(), files, NumNodes(),
+          [this](const std::string& name) { return GetNodeProperty(name); });
+      if (!res) {
+        KATANA_LOG_WARN(
+            "not loading node index over {}: {}", files.property_name,
+            res.error());
+        continue;
+      }
+      node_indexes_.emplace_back(std::move(res.value()));
+    } else {
+      auto res = LoadStoredIndex<GraphTopology::Edge>(
+          rdg_->rdg_dir(), files, NumEdges(),
+          [this](const std::string& name) { return GetEdgeProperty(name); });
+      if (!res) {
+        KATANA_LOG_WARN(
+            "not loading edge index over {}: {}", files.property_name,
+            res.error());
+        continue;
+      }
+      edge_indexes_.emplace_back(std::move(res.value()));
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::PropertyGraph::RestoreIndexes() const {
+  if (!indexes_pending_) {
+    return;
+  }
+  indexes_pending_ = false;
+  if (auto res = LoadIndexes(); !res) {
+    KATANA_LOG_WARN("not loading the stored indexes: {}", res.error());
+  }
+}
+
+katana::Result<void>
+katana::PropertyGraph::DoWriteVectorIndexes() {
+  // As with the entity indexes, the files are written next to the current
+  // RDG, and every write rewrites them.
+  const katana::URI& rdg_dir = rdg_->rdg_dir();
+  if (rdg_dir.empty()) {
+    return katana::ResultSuccess();
+  }
+  bool has_stored = KATANA_CHECKED(rdg_->LoadVectorIndexPrimitive()) !=
+                    std::nullopt;
+  if (node_vector_indexes_.empty() && !has_stored) {
+    return katana::ResultSuccess();
+  }
+
+  katana::VectorIndexPrimitive stored;
+  for (const auto& index : node_vector_indexes_) {
+    KATANA_CHECKED(index->Store(rdg_dir, &stored));
+  }
+  return rdg_->WriteVectorIndexPrimitive(stored);
+}
+
+katana::Result<void>
+katana::PropertyGraph::LoadVectorIndexes() {
+  std::optional<katana::VectorIndexPrimitive> stored =
+      KATANA_CHECKED(rdg_->LoadVectorIndexPrimitive());
+  if (!stored) {
+    return katana::ResultSuccess();
+  }
+
+  for (const auto& files : stored->indexes()) {
+    if (files.num_entities != NumNodes() ||
+        !HasNodeProperty(files.property_name)) {
+      KATANA_LOG_WARN(
+          "not loading vector index over {}: the graph has changed",
+          files.property_name);
+      continue;
+    }
+    auto res = katana::VectorIndex::Load(rdg_->rdg_dir(), files);
+    if (!res) {
+      KATANA_LOG_WARN(
+          "not loading vector index over {}: {}", files.property_name,
+          res.error());
+      continue;
+    }
+    node_vector_indexes_.emplace_back(std::move(res.value()));
+  }
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::PropertyGraph::DoWrite(
     katana::RDGHandle handle, const std::string& command_line,
     katana::RDG::RDGVersioningPolicy versioning_action,
     katana::TxnContext* txn_ctx) {
+  WaitForPropertyPrefetch();
+
+  // the stored topology is a CSR whose edges are their own property rows,
+  // so edits are folded into the topology and edge properties first
+  KATANA_CHECKED(CompactTopology(txn_ctx));
+
   KATANA_LOG_DEBUG(
       " node array valid: {}, edge array valid: {}",
       rdg_->node_entity_type_id_array_file_storage().Valid(),
       rdg_->edge_entity_type_id_array_file_storage().Valid());
 
   KATANA_CHECKED(DoWriteTopologies());
+  KATANA_CHECKED(DoWriteIndexes());
+  KATANA_CHECKED(DoWriteVectorIndexes());
 
   //TODO(emcginnis): we don't actually have any lifetime tracking for the in memory
   // entity_type_id arrays, which means we don't actually know when the array
@@ -785,11 +1823,16 @@ katana::PropertyGraph::DoWrite(
   std::unique_ptr<katana::FileFrame> edge_entity_type_id_array_res =
       KATANA_CHECKED(WriteEntityTypeIDsArray(*edge_entity_type_ids_));
 
-  return rdg_->Store(
+  KATANA_CHECKED(rdg_->Store(
       handle, command_line, versioning_action,
       std::move(node_entity_type_id_array_res),
       std::move(edge_entity_type_id_array_res), GetNodeTypeManager(),
-      GetEdgeTypeManager(), txn_ctx);
+      GetEdgeTypeManager(), txn_ctx));
+
+  // the derived topologies just stored are reused by later writes
+  pg_view_cache_.MarkTopologiesStored();
+  uncommitted_changes_ = false;
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
@@ -1092,8 +2135,81 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
   return std::string(buf.begin(), buf.end());
 }
 
+katana::GraphMemoryUsage
+katana::PropertyGraph::GetMemoryUsage() const {
+  GraphMemoryUsage usage;
+  usage.topology = topology().SizeBytes();
+  usage.views = pg_view_cache_.GetMemoryUsage();
+
+  auto add_properties = [](const arrow::Table& table, auto* items) {
+    for (int i = 0; i < table.num_columns(); ++i) {
+      items->emplace_back(MemoryUsageItem{
+          table.field(i)->name(),
+          static_cast<uint64_t>(
+              arrow::util::TotalBufferSize(*table.column(i)))});
+    }
+  };
+  add_properties(*rdg_->node_properties(), &usage.node_properties);
+  add_properties(*rdg_->edge_properties(), &usage.edge_properties);
+
+  for (const auto& ids : {node_entity_type_ids_, edge_entity_type_ids_}) {
+    if (ids) {
+      usage.entity_type_ids += ids->size() * sizeof(EntityTypeID);
+    }
+  }
+
+  for (const auto& index : node_indexes_) {
+    usage.indexes.emplace_back(MemoryUsageItem{
+        "node index of " + index->property_name(), index->SizeBytes()});
+  }
+  for (const auto& index : edge_indexes_) {
+    usage.indexes.emplace_back(MemoryUsageItem{
+        "edge index of " + index->property_name(), index->SizeBytes()});
+  }
+  for (const auto& index : node_vector_indexes_) {
+    usage.indexes.emplace_back(MemoryUsageItem{
+        "node vector index of " + index->property_name(), index->SizeBytes()});
+  }
+
+  if (dynamic_topo_) {
+    usage.other.emplace_back(
+        MemoryUsageItem{"dynamic topology", dynamic_topo_->SizeBytes()});
+  }
+  if (!inserted_edge_types_.empty()) {
+    usage.other.emplace_back(MemoryUsageItem{
+        "inserted edge types",
+        inserted_edge_types_.size() * sizeof(EntityTypeID)});
+  }
+  if (IsTransformed()) {
+    usage.other.emplace_back(MemoryUsageItem{
+        "original to transformed nodes",
+        original_to_transformed_nodes_.size() * sizeof(Node)});
+    usage.other.emplace_back(MemoryUsageItem{
+        "original to transformed edges",
+        original_to_transformed_edges_.size() * sizeof(Edge)});
+  }
+  if (!node_bitmask_data_.empty()) {
+    usage.other.emplace_back(
+        MemoryUsageItem{"node bitmask", node_bitmask_data_.size()});
+  }
+  if (!edge_bitmask_data_.empty()) {
+    usage.other.emplace_back(
+        MemoryUsageItem{"edge bitmask", edge_bitmask_data_.size()});
+  }
+  return usage;
+}
+
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 katana::PropertyGraph::GetNodeProperty(const std::string& name) const {
+  std::unique_lock<std::mutex> lock;
+  if (lazy_loader_) {
+    lock = std::unique_lock<std::mutex>(lazy_loader_->mutex);
+    if (!HasNodeProperty(name) &&
+        full_node_schema()->GetFieldIndex(name) != -1) {
+      KATANA_CHECKED_CONTEXT(
+          rdg_->LoadNodeProperty(name), "loading node property {}", name);
+    }
+  }
   auto ret = rdg_->node_properties()->GetColumnByName(name);
   if (ret) {
     return MakeResult(std::move(ret));
@@ -1108,8 +2224,33 @@ katana::PropertyGraph::GetNodePropertyStorageLocation(
   return rdg_->GetNodePropertyStorageLocation(name);
 }
 
+katana::Result<katana::PropertyStats>
+katana::PropertyGraph::GetNodePropertyStats(const std::string& name) const {
+  return rdg_->GetNodePropertyStats(name);
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::PropertyGraph::ReadNodePropertyRows(
+    const std::string& name, uint64_t begin, uint64_t end) const {
+  // lazy loading may be adding properties to the table concurrently
+  std::unique_lock<std::mutex> lock;
+  if (lazy_loader_) {
+    lock = std::unique_lock<std::mutex>(lazy_loader_->mutex);
+  }
+  return rdg_->ReadNodePropertyRows(name, begin, end);
+}
+
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 katana::PropertyGraph::GetEdgeProperty(const std::string& name) const {
+  std::unique_lock<std::mutex> lock;
+  if (lazy_loader_) {
+    lock = std::unique_lock<std::mutex>(lazy_loader_->mutex);
+    if (!HasEdgeProperty(name) &&
+        full_edge_schema()->GetFieldIndex(name) != -1) {
+      KATANA_CHECKED_CONTEXT(
+          rdg_->LoadEdgeProperty(name), "loading edge property {}", name);
+    }
+  }
   auto ret = rdg_->edge_properties()->GetColumnByName(name);
   if (ret) {
     return MakeResult(std::move(ret));
@@ -1124,6 +2265,22 @@ katana::PropertyGraph::GetEdgePropertyStorageLocation(
   return rdg_->GetEdgePropertyStorageLocation(name);
 }
 
+katana::Result<katana::PropertyStats>
+katana::PropertyGraph::GetEdgePropertyStats(const std::string& name) const {
+  return rdg_->GetEdgePropertyStats(name);
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::PropertyGraph::ReadEdgePropertyRows(
+    const std::string& name, uint64_t begin, uint64_t end) const {
+  // lazy loading may be adding properties to the table concurrently
+  std::unique_lock<std::mutex> lock;
+  if (lazy_loader_) {
+    lock = std::unique_lock<std::mutex>(lazy_loader_->mutex);
+  }
+  return rdg_->ReadEdgePropertyRows(name, begin, end);
+}
+
 katana::Result<void>
 katana::PropertyGraph::Write(
     const katana::URI& rdg_dir, const std::string& command_line,
@@ -1151,9 +2308,36 @@ katana::PropertyGraph::GetNodePropertyIndex(const Node& nid) const noexcept {
   return topology().GetNodePropertyIndex(nid);
 }
 
+void
+katana::PropertyGraph::DoNodesHaveType(
+    Node begin, Node end, EntityTypeID node_entity_type_id,
+    uint8_t* has_type) const {
+  std::vector<uint8_t> table =
+      GetNodeTypeManager().MakeHasTypeTable(node_entity_type_id);
+  const GraphTopology& topo = topology();
+  for (Node n = begin; n < end; ++n) {
+    has_type[n - begin] =
+        table[node_entity_data_[topo.GetNodePropertyIndex(n)]];
+  }
+}
+
+void
+katana::PropertyGraph::DoEdgesHaveTypeFromTopoIndex(
+    Edge begin, Edge end, EntityTypeID edge_entity_type_id,
+    uint8_t* has_type) const {
+  std::vector<uint8_t> table =
+      GetEdgeTypeManager().MakeHasTypeTable(edge_entity_type_id);
+  const GraphTopology& topo = topology();
+  for (Edge e = begin; e < end; ++e) {
+    has_type[e - begin] =
+        table[edge_entity_data_[topo.GetEdgePropertyIndexFromOutEdge(e)]];
+  }
+}
+
 katana::Result<void>
 katana::PropertyGraph::AddNodeProperties(
     const std::shared_ptr<arrow::Table>& props, katana::TxnContext* txn_ctx) {
+  WaitForPropertyPrefetch();
   if (props->num_columns() == 0) {
     KATANA_LOG_DEBUG("adding empty node prop table");
     return ResultSuccess();
@@ -1163,12 +2347,15 @@ katana::PropertyGraph::AddNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         NumOriginalNodes(), props->num_rows());
   }
-  return rdg_->AddNodeProperties(props, txn_ctx);
+  KATANA_CHECKED(rdg_->AddNodeProperties(props, txn_ctx));
+  uncommitted_changes_ = true;
+  return ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::UpsertNodeProperties(
     const std::shared_ptr<arrow::Table>& props, katana::TxnContext* txn_ctx) {
+  WaitForPropertyPrefetch();
   if (props->num_columns() == 0) {
     KATANA_LOG_DEBUG("upsert empty node prop table");
     return ResultSuccess();
@@ -1178,48 +2365,129 @@ katana::PropertyGraph::UpsertNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         NumOriginalNodes(), props->num_rows());
   }
-  return rdg_->UpsertNodeProperties(props, txn_ctx);
+  KATANA_CHECKED(rdg_->UpsertNodeProperties(props, txn_ctx));
+  uncommitted_changes_ = true;
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::UpdateNodePropertyRows(
+    const std::string& name, const std::vector<uint64_t>& row_ids,
+    const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx) {
+  WaitForPropertyPrefetch();
+  KATANA_CHECKED(
+      rdg_->UpdateNodePropertyRows(name, row_ids, values, txn_ctx));
+  uncommitted_changes_ = true;
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::UpdateEdgePropertyRows(
+    const std::string& name, const std::vector<uint64_t>& row_ids,
+    const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx) {
+  WaitForPropertyPrefetch();
+  KATANA_CHECKED(
+      rdg_->UpdateEdgePropertyRows(name, row_ids, values, txn_ctx));
+  uncommitted_changes_ = true;
+  return ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveNodeProperty(int i, katana::TxnContext* txn_ctx) {
-  return rdg_->RemoveNodeProperty(i, txn_ctx);
+  WaitForPropertyPrefetch();
+  KATANA_CHECKED(rdg_->RemoveNodeProperty(i, txn_ctx));
+  uncommitted_changes_ = true;
+  return ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveNodeProperty(
     const std::string& prop_name, katana::TxnContext* txn_ctx) {
+  WaitForPropertyPrefetch();
   auto col_names = rdg_->node_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_->RemoveNodeProperty(
-        std::distance(col_names.cbegin(), pos), txn_ctx);
+    KATANA_CHECKED(rdg_->RemoveNodeProperty(
+        std::distance(col_names.cbegin(), pos), txn_ctx));
+    uncommitted_changes_ = true;
+    return ResultSuccess();
   }
   return katana::ErrorCode::PropertyNotFound;
 }
 
 katana::Result<void>
 katana::PropertyGraph::LoadNodeProperty(const std::string& name, int i) {
+  WaitForPropertyPrefetch();
   return rdg_->LoadNodeProperty(name, i);
 }
 /// Load a node property by name if it is absent and append its column to
 /// the table do nothing otherwise
 katana::Result<void>
 katana::PropertyGraph::EnsureNodePropertyLoaded(const std::string& name) {
+  std::unique_lock<std::mutex> lock;
+  if (lazy_loader_) {
+    lock = std::unique_lock<std::mutex>(lazy_loader_->mutex);
+  }
   if (HasNodeProperty(name)) {
     return katana::ResultSuccess();
   }
-  return LoadNodeProperty(name);
+  return rdg_->LoadNodeProperty(name);
+}
+
+katana::Result<void>
+katana::PropertyGraph::EnsureNodePropertyMutable(
+    const std::string& name, katana::TxnContext* txn_ctx) {
+  std::shared_ptr<arrow::ChunkedArray> property =
+      KATANA_CHECKED(GetNodeProperty(name));
+  std::shared_ptr<arrow::ChunkedArray> mutable_property =
+      KATANA_CHECKED(katana::MutableValuesArray(property));
+  if (mutable_property == property) {
+    return katana::ResultSuccess();
+  }
+  // the copy holds the same values, so the graph is no more modified than
+  // it was
+  bool had_changes = uncommitted_changes_;
+  KATANA_CHECKED(UpsertNodeProperties(
+      arrow::Table::Make(
+          arrow::schema({arrow::field(name, property->type())}),
+          {mutable_property}),
+      txn_ctx));
+  uncommitted_changes_ = had_changes;
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::EnsureEdgePropertyMutable(
+    const std::string& name, katana::TxnContext* txn_ctx) {
+  std::shared_ptr<arrow::ChunkedArray> property =
+      KATANA_CHECKED(GetEdgeProperty(name));
+  std::shared_ptr<arrow::ChunkedArray> mutable_property =
+      KATANA_CHECKED(katana::MutableValuesArray(property));
+  if (mutable_property == property) {
+    return katana::ResultSuccess();
+  }
+  // the copy holds the same values, so the graph is no more modified than
+  // it was
+  bool had_changes = uncommitted_changes_;
+  KATANA_CHECKED(UpsertEdgeProperties(
+      arrow::Table::Make(
+          arrow::schema({arrow::field(name, property->type())}),
+          {mutable_property}),
+      txn_ctx));
+  uncommitted_changes_ = had_changes;
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::UnloadNodeProperty(const std::string& prop_name) {
+  WaitForPropertyPrefetch();
   return rdg_->UnloadNodeProperty(prop_name);
 }
 
 katana::Result<void>
 katana::PropertyGraph::AddEdgeProperties(
     const std::shared_ptr<arrow::Table>& props, katana::TxnContext* txn_ctx) {
+  WaitForPropertyPrefetch();
   if (props->num_columns() == 0) {
     KATANA_LOG_DEBUG("adding empty edge prop table");
     return ResultSuccess();
@@ -1229,12 +2497,15 @@ katana::PropertyGraph::AddEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         NumOriginalEdges(), props->num_rows());
   }
-  return rdg_->AddEdgeProperties(props, txn_ctx);
+  KATANA_CHECKED(rdg_->AddEdgeProperties(props, txn_ctx));
+  uncommitted_changes_ = true;
+  return ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::UpsertEdgeProperties(
     const std::shared_ptr<arrow::Table>& props, katana::TxnContext* txn_ctx) {
+  WaitForPropertyPrefetch();
   if (props->num_columns() == 0) {
     KATANA_LOG_DEBUG("upsert empty edge prop table");
     return ResultSuccess();
@@ -1244,33 +2515,62 @@ katana::PropertyGraph::UpsertEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         NumOriginalEdges(), props->num_rows());
   }
-  return rdg_->UpsertEdgeProperties(props, txn_ctx);
+  KATANA_CHECKED(rdg_->UpsertEdgeProperties(props, txn_ctx));
+  for (const auto& name : props->ColumnNames()) {
+    InvalidateTopologiesSortedBy(name);
+  }
+  uncommitted_changes_ = true;
+  return ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(int i, katana::TxnContext* txn_ctx) {
-  return rdg_->RemoveEdgeProperty(i, txn_ctx);
+  WaitForPropertyPrefetch();
+  std::string name = rdg_->edge_properties()->field(i)->name();
+  KATANA_CHECKED(rdg_->RemoveEdgeProperty(i, txn_ctx));
+  InvalidateTopologiesSortedBy(name);
+  uncommitted_changes_ = true;
+  return ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<const katana::EdgeShuffleTopology>>
+katana::PropertyGraph::BuildEdgesSortedByProperty(
+    const std::string& name, const RDGTopology::TransposeKind& tpose_kind) {
+  return KATANA_CHECKED(
+      pg_view_cache_.BuildOrGetEdgesSortedByProperty(this, tpose_kind, name));
+}
+
+void
+katana::PropertyGraph::InvalidateTopologiesSortedBy(const std::string& name) {
+  pg_view_cache_.DropTopologiesSortedBy(name);
+  rdg_->InvalidateTopologiesSortedByEdgeProperty(name);
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(
     const std::string& prop_name, katana::TxnContext* txn_ctx) {
+  WaitForPropertyPrefetch();
   auto col_names = rdg_->edge_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_->RemoveEdgeProperty(
-        std::distance(col_names.cbegin(), pos), txn_ctx);
+    KATANA_CHECKED(rdg_->RemoveEdgeProperty(
+        std::distance(col_names.cbegin(), pos), txn_ctx));
+    InvalidateTopologiesSortedBy(prop_name);
+    uncommitted_changes_ = true;
+    return ResultSuccess();
   }
   return katana::ErrorCode::PropertyNotFound;
 }
 
 katana::Result<void>
 katana::PropertyGraph::UnloadEdgeProperty(const std::string& prop_name) {
+  WaitForPropertyPrefetch();
   return rdg_->UnloadEdgeProperty(prop_name);
 }
 
 katana::Result<void>
 katana::PropertyGraph::LoadEdgeProperty(const std::string& name, int i) {
+  WaitForPropertyPrefetch();
   return rdg_->LoadEdgeProperty(name, i);
 }
 
@@ -1278,15 +2578,35 @@ katana::PropertyGraph::LoadEdgeProperty(const std::string& name, int i) {
 /// the table do nothing otherwise
 katana::Result<void>
 katana::PropertyGraph::EnsureEdgePropertyLoaded(const std::string& name) {
+  std::unique_lock<std::mutex> lock;
+  if (lazy_loader_) {
+    lock = std::unique_lock<std::mutex>(lazy_loader_->mutex);
+  }
   if (HasEdgeProperty(name)) {
     return katana::ResultSuccess();
   }
-  return LoadEdgeProperty(name);
+  return rdg_->LoadEdgeProperty(name);
+}
+
+katana::Result<void>
+katana::PropertyGraph::SetNodePropertyStorageFormat(
+    const std::string& name, katana::PropertyStorageFormat format) {
+  WaitForPropertyPrefetch();
+  return rdg_->SetNodePropertyStorageFormat(name, format);
+}
+
+katana::Result<void>
+katana::PropertyGraph::SetEdgePropertyStorageFormat(
+    const std::string& name, katana::PropertyStorageFormat format) {
+  WaitForPropertyPrefetch();
+  return rdg_->SetEdgePropertyStorageFormat(name, format);
 }
 
 // Build an index over nodes.
 katana::Result<void>
-katana::PropertyGraph::MakeNodeIndex(const std::string& property_name) {
+katana::PropertyGraph::MakeNodeIndex(
+    const std::string& property_name, katana::EntityIndexKind kind) {
+  RestoreIndexes();
   for (const auto& existing_index : node_indexes_) {
     if (existing_index->property_name() == property_name) {
       return KATANA_ERROR(
@@ -1298,13 +2618,13 @@ katana::PropertyGraph::MakeNodeIndex(const std::string& property_name) {
   // Get a view of the property.
   std::shared_ptr<arrow::ChunkedArray> chunked_property =
       KATANA_CHECKED(GetNodeProperty(property_name));
-  KATANA_LOG_ASSERT(chunked_property->num_chunks() == 1);
-  std::shared_ptr<arrow::Array> property = chunked_property->chunk(0);
+  std::shared_ptr<arrow::Array> property =
+      KATANA_CHECKED(katana::UnchunkedArray(chunked_property));
 
   // Create an index based on the type of the field.
   std::shared_ptr<katana::EntityIndex<GraphTopology::Node>> index =
       KATANA_CHECKED(katana::MakeTypedEntityIndex<katana::GraphTopology::Node>(
-          property_name, NumNodes(), property));
+          property_name, NumNodes(), property, kind));
 
   KATANA_CHECKED(index->BuildFromProperty());
 
@@ -1315,6 +2635,7 @@ katana::PropertyGraph::MakeNodeIndex(const std::string& property_name) {
 
 katana::Result<void>
 katana::PropertyGraph::DeleteNodeIndex(const std::string& property_name) {
+  RestoreIndexes();
   for (auto it = node_indexes_.begin(); it != node_indexes_.end(); it++) {
     if ((*it)->property_name() == property_name) {
       node_indexes_.erase(it);
@@ -1331,7 +2652,9 @@ katana::PropertyGraph::DeleteNodeIndex(const std::string& property_name) {
 
 // Build an index over edges.
 katana::Result<void>
-katana::PropertyGraph::MakeEdgeIndex(const std::string& property_name) {
+katana::PropertyGraph::MakeEdgeIndex(
+    const std::string& property_name, katana::EntityIndexKind kind) {
+  RestoreIndexes();
   for (const auto& existing_index : edge_indexes_) {
     if (existing_index->property_name() == property_name) {
       return KATANA_ERROR(
@@ -1343,13 +2666,13 @@ katana::PropertyGraph::MakeEdgeIndex(const std::string& property_name) {
   // Get a view of the property.
   std::shared_ptr<arrow::ChunkedArray> chunked_property =
       KATANA_CHECKED(GetEdgeProperty(property_name));
-  KATANA_LOG_ASSERT(chunked_property->num_chunks() == 1);
-  std::shared_ptr<arrow::Array> property = chunked_property->chunk(0);
+  std::shared_ptr<arrow::Array> property =
+      KATANA_CHECKED(katana::UnchunkedArray(chunked_property));
 
   // Create an index based on the type of the field.
   std::unique_ptr<katana::EntityIndex<katana::GraphTopology::Edge>> index =
       KATANA_CHECKED(katana::MakeTypedEntityIndex<katana::GraphTopology::Edge>(
-          property_name, NumEdges(), property));
+          property_name, NumEdges(), property, kind));
 
   KATANA_CHECKED(index->BuildFromProperty());
 
@@ -1360,6 +2683,7 @@ katana::PropertyGraph::MakeEdgeIndex(const std::string& property_name) {
 
 katana::Result<void>
 katana::PropertyGraph::DeleteEdgeIndex(const std::string& property_name) {
+  RestoreIndexes();
   for (auto it = edge_indexes_.begin(); it != edge_indexes_.end(); it++) {
     if ((*it)->property_name() == property_name) {
       edge_indexes_.erase(it);
@@ -1369,6 +2693,70 @@ katana::PropertyGraph::DeleteEdgeIndex(const std::string& property_name) {
   return KATANA_ERROR(katana::ErrorCode::NotFound, "edge index not found");
 }
 
+katana::Result<void>
+katana::PropertyGraph::MakeNodeCompositeIndex(
+    const std::vector<std::string>& property_names, bool by_type) {
+  RestoreIndexes();
+  std::string name = katana::CompositeEntityIndexName(property_names, by_type);
+  for (const auto& existing_index : node_indexes_) {
+    if (existing_index->property_name() == name) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AlreadyExists, "Index already exists: {}", name);
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::Array>> properties;
+  for (const auto& property_name : property_names) {
+    std::shared_ptr<arrow::ChunkedArray> chunked_property =
+        KATANA_CHECKED(GetNodeProperty(property_name));
+    properties.emplace_back(
+        KATANA_CHECKED(katana::UnchunkedArray(chunked_property)));
+  }
+
+  std::unique_ptr<katana::EntityIndex<GraphTopology::Node>> index =
+      std::make_unique<katana::CompositeEntityIndex<GraphTopology::Node>>(
+          property_names, NumNodes(), std::move(properties),
+          by_type ? node_entity_type_ids_ : nullptr);
+
+  KATANA_CHECKED(index->BuildFromProperty());
+
+  node_indexes_.push_back(std::move(index));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::MakeEdgeCompositeIndex(
+    const std::vector<std::string>& property_names, bool by_type) {
+  RestoreIndexes();
+  std::string name = katana::CompositeEntityIndexName(property_names, by_type);
+  for (const auto& existing_index : edge_indexes_) {
+    if (existing_index->property_name() == name) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AlreadyExists, "Index already exists: {}", name);
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::Array>> properties;
+  for (const auto& property_name : property_names) {
+    std::shared_ptr<arrow::ChunkedArray> chunked_property =
+        KATANA_CHECKED(GetEdgeProperty(property_name));
+    properties.emplace_back(
+        KATANA_CHECKED(katana::UnchunkedArray(chunked_property)));
+  }
+
+  std::unique_ptr<katana::EntityIndex<GraphTopology::Edge>> index =
+      std::make_unique<katana::CompositeEntityIndex<GraphTopology::Edge>>(
+          property_names, NumEdges(), std::move(properties),
+          by_type ? edge_entity_type_ids_ : nullptr);
+
+  KATANA_CHECKED(index->BuildFromProperty());
+
+  edge_indexes_.push_back(std::move(index));
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<std::unique_ptr<katana::NUMAArray<uint64_t>>>
 katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
   // TODO(amber): This function will soon change so that it produces a new sorted
@@ -1454,9 +2842,17 @@ katana::SortNodesByDegree(katana::PropertyGraph* pg) {
     dn_pairs[node] = DegreeNodePair(node_degree, node);
   });
 
-  // sort by degree (first item)
-  katana::ParallelSTL::sort(
-      dn_pairs.begin(), dn_pairs.end(), std::greater<DegreeNodePair>());
+  // sort by degree (first item), greatest first and ties by greatest node
+  if (num_edges <= std::numeric_limits<uint32_t>::max()) {
+    // degree and node fit in one integer key
+    katana::ParallelSTL::radix_sort(
+        dn_pairs.begin(), dn_pairs.end(), [](const DegreeNodePair& p) {
+          return ~((p.first << 32) | p.second);
+        });
+  } else {
+    katana::ParallelSTL::sample_sort(
+        dn_pairs.begin(), dn_pairs.end(), std::greater<DegreeNodePair>());
+  }
 
   // create mapping, get degrees out to another vector to get prefix sum
   katana::NUMAArray<uint32_t> old_to_new_mapping;
@@ -1704,3 +3100,61 @@ katana::PropertyGraph::GetEdgeIndex(const std::string& property_name) const {
   }
   return KATANA_ERROR(katana::ErrorCode::NotFound, "edge index not found");
 }
+
+katana::Result<void>
+katana::PropertyGraph::MakeNodeVectorIndex(
+    const std::string& property_name, const VectorIndex::Options& options) {
+  if (HasNodeVectorIndex(property_name)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AlreadyExists,
+        "Vector index already exists for column {}", property_name);
+  }
+
+  std::shared_ptr<arrow::ChunkedArray> chunked_property =
+      KATANA_CHECKED(GetNodeProperty(property_name));
+  std::shared_ptr<arrow::Array> property =
+      KATANA_CHECKED(katana::UnchunkedArray(chunked_property));
+
+  std::shared_ptr<katana::VectorIndex> index =
+      KATANA_CHECKED(katana::VectorIndex::Make(
+          property_name, NumNodes(), *property, options));
+  node_vector_indexes_.push_back(std::move(index));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::DeleteNodeVectorIndex(const std::string& property_name) {
+  for (auto it = node_vector_indexes_.begin(); it != node_vector_indexes_.end();
+       it++) {
+    if ((*it)->property_name() == property_name) {
+      node_vector_indexes_.erase(it);
+      return katana::ResultSuccess();
+    }
+  }
+  return KATANA_ERROR(
+      katana::ErrorCode::NotFound, "node vector index not found");
+}
+
+bool
+katana::PropertyGraph::HasNodeVectorIndex(
+    const std::string& property_name) const {
+  for (const auto& index : node_vector_indexes_) {
+    if (index->property_name() == property_name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+katana::Result<std::shared_ptr<katana::VectorIndex>>
+katana::PropertyGraph::GetNodeVectorIndex(
+    const std::string& property_name) const {
+  for (const auto& index : node_vector_indexes_) {
+    if (index->property_name() == property_name) {
+      return index;
+    }
+  }
+  return KATANA_ERROR(
+      katana::ErrorCode::NotFound, "node vector index not found");
+}
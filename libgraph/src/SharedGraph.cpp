@@ -0,0 +1,241 @@
+#include "katana/SharedGraph.h"
+
+#include <unistd.h>
+
+#include <cstring>
+#include <iomanip>
+
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/table.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+// The topology file is a header followed by the arrays of the topology, each
+// at an offset aligned to kAlignment
+constexpr uint64_t kTopologyMagic = 0x6b61746e53484752;  // "katnSHGR"
+constexpr uint64_t kTopologyVersion = 1;
+constexpr uint64_t kAlignment = 64;
+
+constexpr char kTopologyFile[] = "topology";
+constexpr char kNodePropertiesFile[] = "node_properties.arrow";
+constexpr char kEdgePropertiesFile[] = "edge_properties.arrow";
+
+struct TopologyHeader {
+  uint64_t magic{kTopologyMagic};
+  uint64_t version{kTopologyVersion};
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  uint64_t has_edge_prop_indices{0};
+  uint64_t has_node_prop_indices{0};
+};
+
+uint64_t
+AlignUp(uint64_t offset) {
+  return (offset + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+katana::Result<void>
+WriteAligned(
+    arrow::io::FileOutputStream* out, uint64_t* offset, const void* data,
+    uint64_t size) {
+  static const uint8_t kZeros[kAlignment] = {};
+  uint64_t aligned = AlignUp(*offset);
+  KATANA_CHECKED(out->Write(kZeros, aligned - *offset));
+  KATANA_CHECKED(out->Write(data, size));
+  *offset = aligned + size;
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+WriteTopology(const katana::GraphTopology& topo, const fs::path& path) {
+  auto out = KATANA_CHECKED(arrow::io::FileOutputStream::Open(path.string()));
+
+  TopologyHeader header;
+  header.num_nodes = topo.NumNodes();
+  header.num_edges = topo.NumEdges();
+  header.has_edge_prop_indices = topo.EdgePropertyIndexData() != nullptr;
+  header.has_node_prop_indices = topo.NodePropertyIndexData() != nullptr;
+  KATANA_CHECKED(out->Write(&header, sizeof(header)));
+
+  using Edge = katana::GraphTopology::Edge;
+  using Node = katana::GraphTopology::Node;
+  using PropertyIndex = katana::GraphTopology::PropertyIndex;
+  uint64_t offset = sizeof(header);
+  KATANA_CHECKED(WriteAligned(
+      out.get(), &offset, topo.AdjData(), header.num_nodes * sizeof(Edge)));
+  KATANA_CHECKED(WriteAligned(
+      out.get(), &offset, topo.DestData(), header.num_edges * sizeof(Node)));
+  if (header.has_edge_prop_indices) {
+    KATANA_CHECKED(WriteAligned(
+        out.get(), &offset, topo.EdgePropertyIndexData(),
+        header.num_edges * sizeof(PropertyIndex)));
+  }
+  if (header.has_node_prop_indices) {
+    KATANA_CHECKED(WriteAligned(
+        out.get(), &offset, topo.NodePropertyIndexData(),
+        header.num_nodes * sizeof(PropertyIndex)));
+  }
+  KATANA_CHECKED(out->Close());
+  return katana::ResultSuccess();
+}
+
+template <typename GetColumn>
+katana::Result<void>
+WriteProperties(
+    const std::shared_ptr<arrow::Schema>& schema, GetColumn get_column,
+    const fs::path& path) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i = 0; i < schema->num_fields(); ++i) {
+    columns.emplace_back(get_column(i));
+  }
+  std::shared_ptr<arrow::Table> table = arrow::Table::Make(schema, columns);
+
+  auto out = KATANA_CHECKED(arrow::io::FileOutputStream::Open(path.string()));
+  auto writer = KATANA_CHECKED(arrow::ipc::MakeFileWriter(out, schema));
+  KATANA_CHECKED(writer->WriteTable(*table));
+  KATANA_CHECKED(writer->Close());
+  KATANA_CHECKED(out->Close());
+  return katana::ResultSuccess();
+}
+
+/// \returns a read-only view of count values of type T at offset in file;
+/// the view does not own its memory, so whatever holds it must hold file too
+template <typename T>
+katana::Result<katana::NUMAArray<T>>
+MapArray(
+    const std::shared_ptr<arrow::io::MemoryMappedFile>& file, uint64_t* offset,
+    uint64_t count) {
+  uint64_t aligned = AlignUp(*offset);
+  uint64_t size = count * sizeof(T);
+  auto buffer = KATANA_CHECKED(file->ReadAt(aligned, size));
+  if (static_cast<uint64_t>(buffer->size()) != size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "shared graph topology is truncated: expected {} bytes at {}", size,
+        aligned);
+  }
+  *offset = aligned + size;
+  return katana::NUMAArray<T>(const_cast<uint8_t*>(buffer->data()), count);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+MapProperties(const fs::path& path) {
+  auto file = KATANA_CHECKED(arrow::io::MemoryMappedFile::Open(
+      path.string(), arrow::io::FileMode::READ));
+  auto reader = KATANA_CHECKED(arrow::ipc::RecordBatchFileReader::Open(file));
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (int i = 0, n = reader->num_record_batches(); i < n; ++i) {
+    batches.emplace_back(KATANA_CHECKED(reader->ReadRecordBatch(i)));
+  }
+  return KATANA_CHECKED(
+      arrow::Table::FromRecordBatches(reader->schema(), batches));
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::ExportSharedGraph(const PropertyGraph& pg, const std::string& dir) {
+  fs::path final_dir(dir);
+  if (fs::exists(final_dir)) {
+    return KATANA_ERROR(
+        ErrorCode::AlreadyExists, "shared graph {} already exists",
+        std::quoted(dir));
+  }
+  // Write next to the final directory and rename it into place, so that
+  // attachers never see a partial graph
+  fs::path tmp_dir = final_dir;
+  tmp_dir += fmt::format(".tmp-{}", getpid());
+  boost::system::error_code ec;
+  fs::create_directories(tmp_dir, ec);
+  if (ec) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "creating {}: {}", tmp_dir.string(),
+        ec.message());
+  }
+
+  auto write = [&]() -> katana::Result<void> {
+    KATANA_CHECKED(WriteTopology(pg.topology(), tmp_dir / kTopologyFile));
+    KATANA_CHECKED(WriteProperties(
+        pg.loaded_node_schema(), [&](int i) { return pg.GetNodeProperty(i); },
+        tmp_dir / kNodePropertiesFile));
+    KATANA_CHECKED(WriteProperties(
+        pg.loaded_edge_schema(), [&](int i) { return pg.GetEdgeProperty(i); },
+        tmp_dir / kEdgePropertiesFile));
+    fs::rename(tmp_dir, final_dir, ec);
+    if (ec) {
+      return KATANA_ERROR(
+          ErrorCode::LocalStorageError, "renaming {} to {}: {}",
+          tmp_dir.string(), dir, ec.message());
+    }
+    return katana::ResultSuccess();
+  };
+  if (auto res = write(); !res) {
+    fs::remove_all(tmp_dir, ec);
+    return res.error();
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<katana::PropertyGraph>>
+katana::AttachSharedGraph(const std::string& dir) {
+  fs::path path(dir);
+  std::shared_ptr<arrow::io::MemoryMappedFile> file = KATANA_CHECKED_CONTEXT(
+      arrow::io::MemoryMappedFile::Open(
+          (path / kTopologyFile).string(), arrow::io::FileMode::READ),
+      "attaching shared graph {}", std::quoted(dir));
+
+  TopologyHeader header;
+  auto header_buffer = KATANA_CHECKED(file->ReadAt(0, sizeof(header)));
+  if (static_cast<size_t>(header_buffer->size()) != sizeof(header)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "shared graph {} has no topology header",
+        std::quoted(dir));
+  }
+  std::memcpy(&header, header_buffer->data(), sizeof(header));
+  if (header.magic != kTopologyMagic || header.version != kTopologyVersion) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "{} is not a shared graph of version {}: magic {:#x} version {}",
+        std::quoted(dir), kTopologyVersion, header.magic, header.version);
+  }
+
+  using PropertyIndex = GraphTopology::PropertyIndex;
+  uint64_t offset = sizeof(header);
+  auto adj_indices = KATANA_CHECKED(
+      MapArray<GraphTopology::Edge>(file, &offset, header.num_nodes));
+  auto dests = KATANA_CHECKED(
+      MapArray<GraphTopology::Node>(file, &offset, header.num_edges));
+  GraphTopology::PropIndexVec edge_prop_indices;
+  if (header.has_edge_prop_indices) {
+    edge_prop_indices = KATANA_CHECKED(
+        MapArray<PropertyIndex>(file, &offset, header.num_edges));
+  }
+  GraphTopology::PropIndexVec node_prop_indices;
+  if (header.has_node_prop_indices) {
+    node_prop_indices = KATANA_CHECKED(
+        MapArray<PropertyIndex>(file, &offset, header.num_nodes));
+  }
+  // The topology owns the mapping, so that views of the topology, e.g., its
+  // arrays in Python, may outlive the graph
+  GraphTopology topo(
+      std::move(adj_indices), std::move(dests), std::move(edge_prop_indices),
+      std::move(node_prop_indices), std::move(file));
+  std::shared_ptr<PropertyGraph> graph =
+      KATANA_CHECKED(PropertyGraph::Make(std::move(topo)));
+
+  // The property arrays keep their own references to their mappings
+  katana::TxnContext txn_ctx;
+  KATANA_CHECKED(graph->AddNodeProperties(
+      KATANA_CHECKED(MapProperties(path / kNodePropertiesFile)), &txn_ctx));
+  KATANA_CHECKED(graph->AddEdgeProperties(
+      KATANA_CHECKED(MapProperties(path / kEdgePropertiesFile)), &txn_ctx));
+  return graph;
+}
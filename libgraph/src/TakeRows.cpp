@@ -0,0 +1,398 @@
+#include "katana/TakeRows.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/compute/api_vector.h>
+#include <arrow/util/bit_util.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+
+namespace {
+
+/// Rows are gathered in blocks of this many; a multiple of 8, so that blocks
+/// write whole bytes of bitmaps and can be gathered concurrently
+constexpr uint64_t kBlockSize = 1 << 14;
+
+static_assert(kBlockSize % 8 == 0);
+
+/// A chunk of a column, as raw pointers to what a gather reads
+struct SourceChunk {
+  /// null if every value of the chunk is valid
+  const uint8_t* validity;
+  /// the values, or offsets for binary types
+  const uint8_t* values;
+  /// the bytes of binary types
+  const uint8_t* data;
+  int64_t offset;
+  /// the row of the column the chunk starts at
+  uint64_t begin;
+};
+
+/// The chunks of a column, found by row
+class Source {
+public:
+  explicit Source(const arrow::ChunkedArray& column) {
+    uint64_t begin = 0;
+    for (const auto& chunk : column.chunks()) {
+      if (chunk->length() == 0) {
+        continue;
+      }
+      const auto& buffers = chunk->data()->buffers;
+      auto raw = [&buffers](size_t i) -> const uint8_t* {
+        return buffers.size() > i && buffers[i] ? buffers[i]->data() : nullptr;
+      };
+      chunks_.emplace_back(SourceChunk{
+          chunk->null_count() > 0 ? raw(0) : nullptr, raw(1), raw(2),
+          chunk->offset(), begin});
+      begin += chunk->length();
+    }
+  }
+
+  /// \returns the chunk holding row and the position of row in its buffers
+  std::pair<const SourceChunk*, int64_t> Find(uint64_t row) const {
+    const SourceChunk* chunk = chunks_.data();
+    if (chunks_.size() > 1) {
+      auto next = std::upper_bound(
+          chunks_.begin() + 1, chunks_.end(), row,
+          [](uint64_t r, const SourceChunk& c) { return r < c.begin; });
+      chunk = &*(next - 1);
+    }
+    return {chunk, static_cast<int64_t>(row - chunk->begin) + chunk->offset};
+  }
+
+private:
+  std::vector<SourceChunk> chunks_;
+};
+
+/// Gathers the rows of one column into new buffers. Gather is called once
+/// for each block of rows, possibly concurrently; columns with a variable
+/// number of bytes per row copy their bytes in a second pass over the
+/// blocks, after Prepare.
+class ColumnGather {
+public:
+  ColumnGather(const arrow::ChunkedArray& column, uint64_t num_rows)
+      : source_(column), type_(column.type()), num_rows_(num_rows) {}
+
+  virtual ~ColumnGather() = default;
+
+  virtual void Gather(const uint64_t* rows, uint64_t begin, uint64_t end) = 0;
+
+  /// \returns true if the column needs the second pass
+  virtual katana::Result<bool> Prepare() { return false; }
+
+  virtual void GatherData(
+      [[maybe_unused]] const uint64_t* rows, [[maybe_unused]] uint64_t begin,
+      [[maybe_unused]] uint64_t end) {}
+
+  katana::Result<std::shared_ptr<arrow::Array>> Finish() {
+    std::vector<std::shared_ptr<arrow::Buffer>> buffers{validity_};
+    buffers.insert(buffers.end(), values_.begin(), values_.end());
+    return arrow::MakeArray(arrow::ArrayData::Make(
+        type_, num_rows_, std::move(buffers),
+        validity_ ? arrow::kUnknownNullCount : 0));
+  }
+
+protected:
+  katana::Result<void> Init(const std::shared_ptr<arrow::ChunkedArray>& column) {
+    if (column->null_count() > 0) {
+      validity_ = KATANA_CHECKED(AllocateBitmap(num_rows_));
+    }
+    return katana::ResultSuccess();
+  }
+
+  static katana::Result<std::shared_ptr<arrow::Buffer>> AllocateBitmap(
+      uint64_t num_bits) {
+    int64_t num_bytes = arrow::BitUtil::BytesForBits(num_bits);
+    std::shared_ptr<arrow::Buffer> bitmap =
+        KATANA_CHECKED(arrow::AllocateBuffer(num_bytes));
+    if (num_bytes > 0) {
+      // the bits past the last row belong to no block
+      bitmap->mutable_data()[num_bytes - 1] = 0;
+    }
+    return bitmap;
+  }
+
+  void SetValid(uint64_t r, const SourceChunk* chunk, int64_t i) {
+    if (validity_) {
+      arrow::BitUtil::SetBitTo(
+          validity_->mutable_data(), r,
+          chunk->validity == nullptr ||
+              arrow::BitUtil::GetBit(chunk->validity, i));
+    }
+  }
+
+  Source source_;
+  std::shared_ptr<arrow::DataType> type_;
+  uint64_t num_rows_;
+  std::shared_ptr<arrow::Buffer> validity_;
+  /// the buffers after the validity bitmap
+  std::vector<std::shared_ptr<arrow::Buffer>> values_;
+};
+
+class FixedWidthGather : public ColumnGather {
+public:
+  static katana::Result<std::unique_ptr<ColumnGather>> Make(
+      const std::shared_ptr<arrow::ChunkedArray>& column, uint64_t num_rows,
+      int byte_width) {
+    std::unique_ptr<FixedWidthGather> gather(
+        new FixedWidthGather(*column, num_rows, byte_width));
+    KATANA_CHECKED(gather->Init(column));
+    gather->values_.emplace_back(
+        KATANA_CHECKED(arrow::AllocateBuffer(num_rows * byte_width)));
+    return std::unique_ptr<ColumnGather>(std::move(gather));
+  }
+
+  void Gather(const uint64_t* rows, uint64_t begin, uint64_t end) override {
+    switch (byte_width_) {
+    case 1:
+      return GatherWidth<1>(rows, begin, end);
+    case 2:
+      return GatherWidth<2>(rows, begin, end);
+    case 4:
+      return GatherWidth<4>(rows, begin, end);
+    case 8:
+      return GatherWidth<8>(rows, begin, end);
+    case 16:
+      return GatherWidth<16>(rows, begin, end);
+    default:
+      return GatherWidth<0>(rows, begin, end);
+    }
+  }
+
+private:
+  FixedWidthGather(
+      const arrow::ChunkedArray& column, uint64_t num_rows, int byte_width)
+      : ColumnGather(column, num_rows), byte_width_(byte_width) {}
+
+  /// kWidth is the byte width, or 0 when it is not a constant
+  template <size_t kWidth>
+  void GatherWidth(const uint64_t* rows, uint64_t begin, uint64_t end) {
+    size_t width = kWidth == 0 ? byte_width_ : kWidth;
+    uint8_t* out = values_[0]->mutable_data();
+    for (uint64_t r = begin; r < end; ++r) {
+      auto [chunk, i] = source_.Find(rows[r]);
+      std::memcpy(out + r * width, chunk->values + i * width, width);
+      SetValid(r, chunk, i);
+    }
+  }
+
+  size_t byte_width_;
+};
+
+class BooleanGather : public ColumnGather {
+public:
+  using ColumnGather::ColumnGather;
+
+  static katana::Result<std::unique_ptr<ColumnGather>> Make(
+      const std::shared_ptr<arrow::ChunkedArray>& column, uint64_t num_rows) {
+    std::unique_ptr<BooleanGather> gather(new BooleanGather(*column, num_rows));
+    KATANA_CHECKED(gather->Init(column));
+    gather->values_.emplace_back(KATANA_CHECKED(AllocateBitmap(num_rows)));
+    return std::unique_ptr<ColumnGather>(std::move(gather));
+  }
+
+  void Gather(const uint64_t* rows, uint64_t begin, uint64_t end) override {
+    uint8_t* out = values_[0]->mutable_data();
+    for (uint64_t r = begin; r < end; ++r) {
+      auto [chunk, i] = source_.Find(rows[r]);
+      arrow::BitUtil::SetBitTo(
+          out, r, arrow::BitUtil::GetBit(chunk->values, i));
+      SetValid(r, chunk, i);
+    }
+  }
+};
+
+/// Gathers string and binary columns: the first pass stores the length of
+/// each row in place of its end offset and sums the lengths of each block,
+/// and the second turns lengths into offsets and copies the bytes
+template <typename OffsetType>
+class BinaryGather : public ColumnGather {
+public:
+  using ColumnGather::ColumnGather;
+
+  static katana::Result<std::unique_ptr<ColumnGather>> Make(
+      const std::shared_ptr<arrow::ChunkedArray>& column, uint64_t num_rows) {
+    std::unique_ptr<BinaryGather> gather(new BinaryGather(*column, num_rows));
+    KATANA_CHECKED(gather->Init(column));
+    gather->values_.emplace_back(KATANA_CHECKED(
+        arrow::AllocateBuffer((num_rows + 1) * sizeof(OffsetType))));
+    gather->offsets()[0] = 0;
+    gather->block_bytes_.resize((num_rows + kBlockSize - 1) / kBlockSize);
+    return std::unique_ptr<ColumnGather>(std::move(gather));
+  }
+
+  void Gather(const uint64_t* rows, uint64_t begin, uint64_t end) override {
+    OffsetType* out = offsets();
+    uint64_t bytes = 0;
+    for (uint64_t r = begin; r < end; ++r) {
+      auto [chunk, i] = source_.Find(rows[r]);
+      const auto* in = reinterpret_cast<const OffsetType*>(chunk->values);
+      out[r + 1] = in[i + 1] - in[i];
+      bytes += out[r + 1];
+      SetValid(r, chunk, i);
+    }
+    block_bytes_[begin / kBlockSize] = bytes;
+  }
+
+  katana::Result<bool> Prepare() override {
+    uint64_t total = 0;
+    for (uint64_t& bytes : block_bytes_) {
+      uint64_t start = total;
+      total += bytes;
+      bytes = start;
+    }
+    if (total > static_cast<uint64_t>(std::numeric_limits<OffsetType>::max())) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError,
+          "taken rows of {} have too many bytes for its offsets: {}",
+          type_->ToString(), total);
+    }
+    values_.emplace_back(KATANA_CHECKED(arrow::AllocateBuffer(total)));
+    return true;
+  }
+
+  void GatherData(const uint64_t* rows, uint64_t begin, uint64_t end)
+      override {
+    OffsetType* out = offsets();
+    uint8_t* data = values_[1]->mutable_data();
+    OffsetType position = block_bytes_[begin / kBlockSize];
+    for (uint64_t r = begin; r < end; ++r) {
+      auto [chunk, i] = source_.Find(rows[r]);
+      const auto* in = reinterpret_cast<const OffsetType*>(chunk->values);
+      OffsetType length = out[r + 1];
+      std::memcpy(data + position, chunk->data + in[i], length);
+      position += length;
+      out[r + 1] = position;
+    }
+  }
+
+private:
+  OffsetType* offsets() {
+    return reinterpret_cast<OffsetType*>(values_[0]->mutable_data());
+  }
+
+  /// the bytes of each block, then where each block starts in the data
+  std::vector<uint64_t> block_bytes_;
+};
+
+/// \returns a gather for column, or null if it should use arrow's Take
+katana::Result<std::unique_ptr<ColumnGather>>
+MakeGather(
+    const std::shared_ptr<arrow::ChunkedArray>& column, uint64_t num_rows) {
+  const auto& type = column->type();
+  switch (type->id()) {
+  case arrow::Type::BOOL:
+    return BooleanGather::Make(column, num_rows);
+  case arrow::Type::STRING:
+  case arrow::Type::BINARY:
+    return BinaryGather<int32_t>::Make(column, num_rows);
+  case arrow::Type::LARGE_STRING:
+  case arrow::Type::LARGE_BINARY:
+    return BinaryGather<int64_t>::Make(column, num_rows);
+  case arrow::Type::DICTIONARY:
+  case arrow::Type::EXTENSION:
+    return std::unique_ptr<ColumnGather>();
+  default:
+    break;
+  }
+  const auto* fixed_width = dynamic_cast<const arrow::FixedWidthType*>(type.get());
+  if (fixed_width == nullptr || fixed_width->bit_width() % 8 != 0) {
+    return std::unique_ptr<ColumnGather>();
+  }
+  return FixedWidthGather::Make(column, num_rows, fixed_width->bit_width() / 8);
+}
+
+katana::Result<std::vector<std::shared_ptr<arrow::ChunkedArray>>>
+TakeColumns(
+    const std::vector<std::shared_ptr<arrow::ChunkedArray>>& columns,
+    const uint64_t* rows, uint64_t num_rows) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> taken(columns.size());
+  std::vector<std::unique_ptr<ColumnGather>> gathers;
+  std::vector<size_t> gathered;
+  std::shared_ptr<arrow::Array> indices;
+  for (size_t c = 0; c < columns.size(); ++c) {
+    std::unique_ptr<ColumnGather> gather =
+        KATANA_CHECKED(MakeGather(columns[c], num_rows));
+    if (gather) {
+      gathers.emplace_back(std::move(gather));
+      gathered.emplace_back(c);
+      continue;
+    }
+    if (!indices) {
+      // a view of rows, which outlive it
+      indices = std::make_shared<arrow::UInt64Array>(
+          num_rows, std::make_shared<arrow::Buffer>(
+                        reinterpret_cast<const uint8_t*>(rows),
+                        num_rows * sizeof(uint64_t)));
+    }
+    arrow::Datum datum =
+        KATANA_CHECKED(arrow::compute::Take(columns[c], indices));
+    taken[c] = datum.chunked_array();
+  }
+  if (gathers.empty()) {
+    return taken;
+  }
+
+  uint64_t num_blocks = (num_rows + kBlockSize - 1) / kBlockSize;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        uint64_t begin = block * kBlockSize;
+        uint64_t end = std::min(begin + kBlockSize, num_rows);
+        for (auto& gather : gathers) {
+          gather->Gather(rows, begin, end);
+        }
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("TakeRows"));
+
+  std::vector<ColumnGather*> second_pass;
+  for (auto& gather : gathers) {
+    if (KATANA_CHECKED(gather->Prepare())) {
+      second_pass.emplace_back(gather.get());
+    }
+  }
+  if (!second_pass.empty()) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_blocks),
+        [&](uint64_t block) {
+          uint64_t begin = block * kBlockSize;
+          uint64_t end = std::min(begin + kBlockSize, num_rows);
+          for (ColumnGather* gather : second_pass) {
+            gather->GatherData(rows, begin, end);
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("TakeRowsData"));
+  }
+
+  for (size_t g = 0; g < gathers.size(); ++g) {
+    std::shared_ptr<arrow::Array> array = KATANA_CHECKED(gathers[g]->Finish());
+    taken[gathered[g]] = std::make_shared<arrow::ChunkedArray>(array);
+  }
+  return taken;
+}
+
+}  // namespace
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::TakeRows(
+    const std::shared_ptr<arrow::Table>& table, const uint64_t* rows,
+    uint64_t num_rows) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns =
+      KATANA_CHECKED(TakeColumns(table->columns(), rows, num_rows));
+  return arrow::Table::Make(table->schema(), std::move(columns), num_rows);
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::TakeRows(
+    const std::shared_ptr<arrow::ChunkedArray>& column, const uint64_t* rows,
+    uint64_t num_rows) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns =
+      KATANA_CHECKED(TakeColumns({column}, rows, num_rows));
+  return columns[0];
+}
@@ -0,0 +1,233 @@
+#include "katana/TemporalEdgeIndex.h"
+
+#include <algorithm>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PropertyGraph.h"
+
+namespace {
+
+/// The number of edges per global bucket when the number of buckets is not
+/// given
+constexpr uint64_t kEdgesPerBucket = 1 << 12;
+
+using Timestamp = katana::TemporalEdgeIndex::Timestamp;
+using Edge = katana::TemporalEdgeIndex::Edge;
+using TimedEdge = std::pair<Timestamp, Edge>;
+
+/// Call fn with a function from property rows to their times
+template <typename Fn>
+katana::Result<void>
+VisitTimes(const arrow::Array& property, const Fn& fn) {
+  auto visit = [&](auto type) {
+    using ArrowType = decltype(type);
+    const auto& typed =
+        static_cast<const arrow::NumericArray<ArrowType>&>(property);
+    fn([&typed](uint64_t row) -> Timestamp { return typed.Value(row); });
+  };
+  switch (property.type_id()) {
+  case arrow::Type::TIMESTAMP:
+    visit(arrow::TimestampType());
+    break;
+  case arrow::Type::DATE32:
+    visit(arrow::Date32Type());
+    break;
+  case arrow::Type::DATE64:
+    visit(arrow::Date64Type());
+    break;
+  case arrow::Type::INT32:
+    visit(arrow::Int32Type());
+    break;
+  case arrow::Type::INT64:
+    visit(arrow::Int64Type());
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge property is not time valued: {}", property.type()->ToString());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Copy timed edges into separate arrays of edges and times
+void
+Split(
+    const katana::NUMAArray<TimedEdge>& timed, katana::NUMAArray<Edge>* edges,
+    katana::NUMAArray<Timestamp>* times) {
+  edges->allocateBlocked(timed.size());
+  times->allocateBlocked(timed.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, timed.size()),
+      [&](size_t i) {
+        (*times)[i] = timed[i].first;
+        (*edges)[i] = timed[i].second;
+      },
+      katana::no_stats());
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::TemporalEdgeIndex>>
+katana::TemporalEdgeIndex::Make(
+    const PropertyGraph& pg, const std::string& property_name,
+    uint64_t num_buckets) {
+  std::shared_ptr<arrow::ChunkedArray> chunked_property =
+      KATANA_CHECKED(pg.GetEdgeProperty(property_name));
+  std::shared_ptr<arrow::Array> unchunked_property =
+      KATANA_CHECKED(UnchunkedArray(chunked_property));
+  const arrow::Array& property = *unchunked_property;
+
+  std::unique_ptr<TemporalEdgeIndex> index(
+      new TemporalEdgeIndex(property_name));
+  const GraphTopology& topology = pg.topology();
+  uint64_t num_nodes = topology.NumNodes();
+
+  // Group the timed out-edges of each node, sorted by time, then sort all of
+  // them for the global order.
+  NUMAArray<uint64_t> counts;
+  counts.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(topology.Nodes()),
+      [&](Node node) {
+        uint64_t count = 0;
+        for (Edge e : topology.OutEdges(node)) {
+          count += property.IsValid(pg.GetEdgePropertyIndexFromOutEdge(e));
+        }
+        counts[node] = count;
+      },
+      katana::no_stats());
+  index->node_offsets_.allocateBlocked(num_nodes + 1);
+  index->node_offsets_[0] = 0;
+  katana::ParallelSTL::partial_sum(
+      counts.begin(), counts.end(), index->node_offsets_.begin() + 1);
+  const auto& offsets = index->node_offsets_;
+
+  NUMAArray<TimedEdge> timed;
+  timed.allocateBlocked(offsets[num_nodes]);
+  KATANA_CHECKED_CONTEXT(
+      VisitTimes(
+          property,
+          [&](const auto& time_of) {
+            katana::do_all(
+                katana::iterate(topology.Nodes()),
+                [&](Node node) {
+                  uint64_t next = offsets[node];
+                  for (Edge e : topology.OutEdges(node)) {
+                    auto row = pg.GetEdgePropertyIndexFromOutEdge(e);
+                    if (property.IsValid(row)) {
+                      timed[next++] = TimedEdge(time_of(row), e);
+                    }
+                  }
+                  std::sort(
+                      timed.begin() + offsets[node],
+                      timed.begin() + offsets[node + 1]);
+                },
+                katana::steal(), katana::no_stats());
+          }),
+      "indexing edge property {}", property_name);
+  Split(timed, &index->node_edges_, &index->node_times_);
+
+  katana::ParallelSTL::sort(timed.begin(), timed.end());
+  Split(timed, &index->edges_, &index->times_);
+  if (timed.size() == 0) {
+    return MakeResult(std::move(index));
+  }
+
+  // Buckets of equal width span the times; the last one may be narrower.
+  index->min_time_ = index->times_[0];
+  index->max_time_ = index->times_[timed.size() - 1];
+  if (num_buckets == 0) {
+    num_buckets = std::max<uint64_t>(1, timed.size() / kEdgesPerBucket);
+  }
+  uint64_t span = static_cast<uint64_t>(index->max_time_) -
+                  static_cast<uint64_t>(index->min_time_);
+  // Widths are rounded up so that the buckets cover the span, except that
+  // only two buckets can cover the widest span.
+  index->bucket_width_ = span / num_buckets == UINT64_MAX
+                             ? UINT64_MAX
+                             : span / num_buckets + 1;
+  num_buckets = index->BucketOf(index->max_time_) + 1;
+
+  const auto& times = index->times_;
+  index->bucket_offsets_.resize(num_buckets + 1);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_buckets),
+      [&](uint64_t bucket) {
+        Timestamp start = index->BucketWindow(bucket).first;
+        index->bucket_offsets_[bucket] =
+            std::lower_bound(times.begin(), times.end(), start) -
+            times.begin();
+      },
+      katana::no_stats());
+  index->bucket_offsets_[num_buckets] = times.size();
+  return MakeResult(std::move(index));
+}
+
+katana::TemporalEdgeIndex::EdgeRange
+katana::TemporalEdgeIndex::OutEdgesInWindow(
+    Node node, Timestamp first, Timestamp last) const {
+  const Timestamp* begin = node_times_.data() + node_offsets_[node];
+  const Timestamp* end = node_times_.data() + node_offsets_[node + 1];
+  if (first > last) {
+    end = begin;
+  }
+  const Timestamp* lo = std::lower_bound(begin, end, first);
+  const Timestamp* hi = std::upper_bound(lo, end, last);
+  return EdgeRange(
+      node_edges_.data() + (lo - node_times_.data()),
+      node_edges_.data() + (hi - node_times_.data()));
+}
+
+katana::TemporalEdgeIndex::EdgeRange
+katana::TemporalEdgeIndex::EdgesInWindow(
+    Timestamp first, Timestamp last) const {
+  if (size() == 0 || first > last || last < min_time_ || first > max_time_) {
+    return EdgeRange(edges_.data(), edges_.data());
+  }
+  first = std::max(first, min_time_);
+  last = std::min(last, max_time_);
+
+  // Only the buckets at the ends of the window need searching.
+  uint64_t first_bucket = BucketOf(first);
+  uint64_t last_bucket = BucketOf(last);
+  const Timestamp* lo = std::lower_bound(
+      times_.data() + bucket_offsets_[first_bucket],
+      times_.data() + bucket_offsets_[first_bucket + 1], first);
+  const Timestamp* hi = std::upper_bound(
+      times_.data() + bucket_offsets_[last_bucket],
+      times_.data() + bucket_offsets_[last_bucket + 1], last);
+  return EdgeRange(
+      edges_.data() + (lo - times_.data()),
+      edges_.data() + (hi - times_.data()));
+}
+
+katana::TemporalEdgeIndex::Timestamp
+katana::TemporalEdgeIndex::TimeOf(const Edge* it) const {
+  if (it >= node_edges_.data() &&
+      it < node_edges_.data() + node_edges_.size()) {
+    return node_times_[it - node_edges_.data()];
+  }
+  return times_[it - edges_.data()];
+}
+
+katana::TemporalEdgeIndex::EdgeRange
+katana::TemporalEdgeIndex::BucketEdges(uint64_t bucket) const {
+  return EdgeRange(
+      edges_.data() + bucket_offsets_[bucket],
+      edges_.data() + bucket_offsets_[bucket + 1]);
+}
+
+std::pair<
+    katana::TemporalEdgeIndex::Timestamp, katana::TemporalEdgeIndex::Timestamp>
+katana::TemporalEdgeIndex::BucketWindow(uint64_t bucket) const {
+  uint64_t start = static_cast<uint64_t>(min_time_) + bucket * bucket_width_;
+  if (bucket + 1 >= num_buckets()) {
+    return {static_cast<Timestamp>(start), max_time_};
+  }
+  return {
+      static_cast<Timestamp>(start),
+      static_cast<Timestamp>(start + bucket_width_ - 1)};
+}
@@ -1,6 +1,248 @@
 #include "katana/TopologyGeneration.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+
 namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// Random topologies are generated in blocks of edges or of nodes, the unit
+/// of parallel work, and each block draws from its own generator
+constexpr uint64_t kEdgesPerBlock = uint64_t{1} << 16;
+constexpr uint64_t kNodesPerBlock = uint64_t{1} << 12;
+
+/// Random streams, so that different uses of a seed draw unrelated numbers
+enum Stream : uint64_t {
+  kScrambleStream = 1,
+  kKroneckerStream,
+  kDegreeStream,
+  kCommunityStream,
+  kLfrEdgeStream,
+};
+
+/// The finalizer of SplitMix64
+uint64_t
+Mix(uint64_t x) {
+  x += UINT64_C(0x9e3779b97f4a7c15);
+  x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+
+/// SplitMix64, a generator much faster than a Mersenne Twister and cheap to
+/// seed, which matters as generating an edge takes a number per level and
+/// every block seeds a generator
+class SplitMix64 {
+public:
+  using result_type = uint64_t;
+
+  explicit SplitMix64(uint64_t seed) : state_(seed) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() {
+    state_ += UINT64_C(0x9e3779b97f4a7c15);
+    return Mix(state_);
+  }
+
+private:
+  uint64_t state_;
+};
+
+/// \returns the generator of a block, which is the same whichever thread
+/// generates the block
+SplitMix64
+BlockGenerator(uint64_t seed, Stream stream, uint64_t block) {
+  return SplitMix64(Mix(Mix(seed ^ Mix(stream)) + block));
+}
+
+/// A pseudo-random permutation of [0, num_nodes). It cycle walks a bijection
+/// of the smallest power of two range that holds the nodes: applying the
+/// bijection until the result is in range.
+class IdScrambler {
+public:
+  IdScrambler(uint64_t num_nodes, const katana::RandomTopologyOptions& options)
+      : num_nodes_(num_nodes), enabled_(options.scramble_ids) {
+    while (bits_ < 64 && (uint64_t{1} << bits_) < num_nodes) {
+      ++bits_;
+    }
+    mask_ = bits_ == 64 ? ~uint64_t{0} : (uint64_t{1} << bits_) - 1;
+    shift_ = std::max<uint32_t>(1, bits_ / 2);
+    uint64_t key = Mix(options.seed ^ Mix(kScrambleStream));
+    // odd multipliers are invertible modulo powers of two
+    multiplier_ = key | 1;
+    addend_ = Mix(key) & mask_;
+  }
+
+  Node operator()(Node id) const {
+    if (!enabled_) {
+      return id;
+    }
+    uint64_t x = id;
+    do {
+      x = Permute(x);
+    } while (x >= num_nodes_);
+    return x;
+  }
+
+private:
+  uint64_t Permute(uint64_t x) const {
+    x = (x * multiplier_ + addend_) & mask_;
+    x ^= x >> shift_;
+    x = (x * multiplier_) & mask_;
+    return x ^ (x >> shift_);
+  }
+
+  uint64_t num_nodes_;
+  bool enabled_;
+  uint32_t bits_{1};
+  uint32_t shift_;
+  uint64_t mask_;
+  uint64_t multiplier_;
+  uint64_t addend_;
+};
+
+/// Builds the topology of the edges that for_each_edge(block, emit) emits by
+/// calling emit(src, dst), for every block in [0, num_blocks). It is called
+/// twice for each block, to count the edges and then to place them, and must
+/// emit the same edges both times; this saves holding a list of all edges
+/// besides the topology. The edges of each node are sorted, so the topology
+/// does not depend on the order in which blocks are generated.
+template <typename ForEachEdge>
+katana::GraphTopology
+BuildTopology(
+    uint64_t num_nodes, uint64_t num_blocks,
+    const katana::RandomTopologyOptions& options,
+    const ForEachEdge& for_each_edge) {
+  if (num_nodes == 0) {
+    return katana::GraphTopology{};
+  }
+  IdScrambler scramble(num_nodes, options);
+  auto for_each_kept_edge = [&](uint64_t block, const auto& fn) {
+    for_each_edge(block, [&](Node src, Node dst) {
+      if (options.remove_self_loops && src == dst) {
+        return;
+      }
+      src = scramble(src);
+      dst = scramble(dst);
+      fn(src, dst);
+      if (options.symmetric && src != dst) {
+        fn(dst, src);
+      }
+    });
+  };
+
+  // first the degree, then the next free position of each node
+  katana::NUMAArray<Edge> cursors;
+  cursors.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(cursors.begin(), cursors.end(), Edge{0});
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        for_each_kept_edge(block, [&](Node src, Node) {
+          __atomic_fetch_add(&cursors[src], 1, __ATOMIC_RELAXED);
+        });
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::partial_sum(
+      cursors.begin(), cursors.end(), adj_indices.begin());
+  auto edge_begin = [&adj_indices](Node n) -> Edge {
+    return n == 0 ? 0 : adj_indices[n - 1];
+  };
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) { cursors[n] = edge_begin(n); }, katana::no_stats());
+
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(adj_indices[num_nodes - 1]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        for_each_kept_edge(block, [&](Node src, Node dst) {
+          dests[__atomic_fetch_add(&cursors[src], 1, __ATOMIC_RELAXED)] = dst;
+        });
+      },
+      katana::steal(), katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) {
+        std::sort(
+            dests.begin() + edge_begin(n), dests.begin() + adj_indices[n]);
+      },
+      katana::steal(), katana::no_stats());
+  if (!options.remove_multi_edges) {
+    return katana::GraphTopology{std::move(adj_indices), std::move(dests)};
+  }
+
+  // cursors are the degrees without multi-edges
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) {
+        auto first = dests.begin() + edge_begin(n);
+        cursors[n] =
+            std::unique(first, dests.begin() + adj_indices[n]) - first;
+      },
+      katana::steal(), katana::no_stats());
+  katana::GraphTopology::AdjIndexVec unique_indices;
+  unique_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::partial_sum(
+      cursors.begin(), cursors.end(), unique_indices.begin());
+  katana::GraphTopology::EdgeDestVec unique_dests;
+  unique_dests.allocateInterleaved(unique_indices[num_nodes - 1]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) {
+        std::copy_n(
+            dests.begin() + edge_begin(n), cursors[n],
+            unique_dests.begin() + unique_indices[n] - cursors[n]);
+      },
+      katana::steal(), katana::no_stats());
+  return katana::GraphTopology{
+      std::move(unique_indices), std::move(unique_dests)};
+}
+
+/// \returns an integer in [min, max] from a power law with the exponent
+uint32_t
+SamplePowerLaw(SplitMix64* gen, double exponent, uint32_t min, uint32_t max) {
+  double u = std::uniform_real_distribution<double>()(*gen);
+  // the continuous law on [min, max + 1), rounded down
+  double lo = min;
+  double hi = max + 1.0;
+  double x = 0;
+  if (std::abs(exponent - 1) < 1e-9) {
+    x = lo * std::pow(hi / lo, u);
+  } else {
+    double a = 1 - exponent;
+    double lo_a = std::pow(lo, a);
+    x = std::pow(lo_a + u * (std::pow(hi, a) - lo_a), 1 / a);
+  }
+  return std::clamp(static_cast<uint32_t>(x), min, max);
+}
+
+/// \returns half of value, rounding at random
+uint32_t
+RandomHalf(uint32_t value, SplitMix64* gen) {
+  return value / 2 + ((value & 1) & (*gen)());
+}
+
+/// The number of times an external edge draws another endpoint when it
+/// falls in its own community
+constexpr uint32_t kExternalRetries = 8;
+
 template <typename F>
 std::unique_ptr<katana::PropertyGraph>
 MakeTopologyImpl(F builder_fun) {
@@ -177,3 +419,236 @@ MakeTriangle(size_t num_rows) noexcept {
 }
 
 }  // namespace katana
+
+katana::Result<katana::GraphTopology>
+katana::CreateKroneckerTopology(
+    const std::vector<double>& initiator, uint32_t levels, uint64_t num_edges,
+    const RandomTopologyOptions& options) {
+  uint64_t k = std::llround(std::sqrt(initiator.size()));
+  if (k < 2 || k * k != initiator.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "initiator of {} weights is not a square matrix of at least 2 x 2",
+        initiator.size());
+  }
+  double total = 0;
+  for (double weight : initiator) {
+    if (!(weight >= 0)) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "initiator weight {} is negative",
+          weight);
+    }
+    total += weight;
+  }
+  if (!(total > 0)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "initiator weights sum to zero");
+  }
+  uint64_t num_nodes = 1;
+  for (uint32_t i = 0; i < levels; ++i) {
+    num_nodes *= k;
+    if (num_nodes > uint64_t{std::numeric_limits<Node>::max()} + 1) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "{} levels of a {} x {} initiator have more than 2^32 nodes",
+          levels, k, k);
+    }
+  }
+
+  // Cell i is picked by random numbers in [bounds[i - 1], bounds[i]). It is
+  // found by counting bounds rather than by a binary search, whose branches
+  // random numbers mispredict.
+  std::vector<uint64_t> bounds;
+  double cumulative = 0;
+  for (size_t i = 0; i + 1 < initiator.size(); ++i) {
+    cumulative += initiator[i] / total;
+    bounds.emplace_back(
+        cumulative >= 1 ? std::numeric_limits<uint64_t>::max()
+                        : static_cast<uint64_t>(std::ldexp(cumulative, 64)));
+  }
+
+  uint64_t num_blocks = (num_edges + kEdgesPerBlock - 1) / kEdgesPerBlock;
+  return BuildTopology(
+      num_nodes, num_blocks, options, [&](uint64_t block, const auto& emit) {
+        SplitMix64 gen = BlockGenerator(options.seed, kKroneckerStream, block);
+        uint64_t end = std::min(num_edges, (block + 1) * kEdgesPerBlock);
+        for (uint64_t e = block * kEdgesPerBlock; e < end; ++e) {
+          uint64_t src = 0;
+          uint64_t dst = 0;
+          for (uint32_t level = 0; level < levels; ++level) {
+            uint64_t random = gen();
+            uint64_t cell = 0;
+            for (uint64_t bound : bounds) {
+              cell += random >= bound;
+            }
+            src = src * k + cell / k;
+            dst = dst * k + cell % k;
+          }
+          emit(src, dst);
+        }
+      });
+}
+
+katana::Result<katana::GraphTopology>
+katana::CreateRmatTopology(
+    uint32_t scale, uint64_t edge_factor, const RandomTopologyOptions& options,
+    double a, double b, double c) {
+  if (scale > 32) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "scale {} has more than 2^32 nodes",
+        scale);
+  }
+  double d = 1 - a - b - c;
+  if (d < -1e-9) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "probabilities {}, {} and {} sum to more than 1", a, b, c);
+  }
+  return CreateKroneckerTopology(
+      {a, b, c, std::max(d, 0.0)}, scale, edge_factor << scale, options);
+}
+
+katana::Result<katana::GraphTopology>
+katana::CreateLfrTopology(
+    const LfrParameters& params, const RandomTopologyOptions& options,
+    NUMAArray<uint32_t>* communities) {
+  if (params.min_degree == 0 || params.min_degree > params.max_degree) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "degrees [{}, {}] are not positive bounds",
+        params.min_degree, params.max_degree);
+  }
+  if (params.min_community == 0 ||
+      params.min_community > params.max_community) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "community sizes [{}, {}] are not positive bounds",
+        params.min_community, params.max_community);
+  }
+  if (!(params.mixing >= 0 && params.mixing <= 1)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "mixing {} is not in [0, 1]",
+        params.mixing);
+  }
+  uint64_t num_nodes = params.num_nodes;
+  uint64_t num_node_blocks = (num_nodes + kNodesPerBlock - 1) / kNodesPerBlock;
+  auto for_each_node = [&](uint64_t block, const auto& fn) {
+    uint64_t end = std::min(num_nodes, (block + 1) * kNodesPerBlock);
+    for (uint64_t n = block * kNodesPerBlock; n < end; ++n) {
+      fn(n);
+    }
+  };
+
+  // Communities are contiguous ranges of nodes before scrambling; the last
+  // one joins the one before it if it is too small
+  std::vector<uint64_t> community_starts{0};
+  SplitMix64 community_gen = BlockGenerator(options.seed, kCommunityStream, 0);
+  while (community_starts.back() < num_nodes) {
+    uint64_t size = SamplePowerLaw(
+        &community_gen, params.community_exponent, params.min_community,
+        params.max_community);
+    community_starts.emplace_back(
+        std::min(num_nodes, community_starts.back() + size));
+  }
+  uint64_t num_communities = community_starts.size() - 1;
+  auto community_size = [&](uint64_t c) {
+    return community_starts[c + 1] - community_starts[c];
+  };
+  if (num_communities > 1 &&
+      community_size(num_communities - 1) < params.min_community) {
+    community_starts.erase(community_starts.end() - 2);
+    --num_communities;
+  }
+  NUMAArray<uint32_t> community_of;
+  community_of.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_communities),
+      [&](uint64_t c) {
+        std::fill(
+            community_of.begin() + community_starts[c],
+            community_of.begin() + community_starts[c + 1], c);
+      },
+      katana::no_stats());
+
+  // Every node splits its degree into edges inside and outside of its
+  // community, and the prefix sums of each pick endpoints by degree
+  NUMAArray<uint64_t> internal_sums;
+  internal_sums.allocateInterleaved(num_nodes);
+  NUMAArray<uint64_t> external_sums;
+  external_sums.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_node_blocks),
+      [&](uint64_t block) {
+        SplitMix64 gen = BlockGenerator(options.seed, kDegreeStream, block);
+        for_each_node(block, [&](uint64_t n) {
+          uint32_t degree = SamplePowerLaw(
+              &gen, params.degree_exponent, params.min_degree,
+              params.max_degree);
+          uint32_t c = community_of[n];
+          internal_sums[n] = std::min<uint64_t>(
+              std::lround((1 - params.mixing) * degree), community_size(c) - 1);
+          external_sums[n] = degree - internal_sums[n];
+        });
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      internal_sums.begin(), internal_sums.end(), internal_sums.begin());
+  katana::ParallelSTL::partial_sum(
+      external_sums.begin(), external_sums.end(), external_sums.begin());
+  auto degree_of = [](const NUMAArray<uint64_t>& sums, uint64_t n) {
+    return sums[n] - (n == 0 ? 0 : sums[n - 1]);
+  };
+  uint64_t total_external = num_nodes ? external_sums[num_nodes - 1] : 0;
+
+  // Each edge is drawn by one of its endpoints, so nodes draw half of their
+  // degrees and are drawn for the other half
+  RandomTopologyOptions symmetric_options = options;
+  symmetric_options.symmetric = true;
+  GraphTopology topology = BuildTopology(
+      num_nodes, num_node_blocks, symmetric_options,
+      [&](uint64_t block, const auto& emit) {
+        SplitMix64 gen = BlockGenerator(options.seed, kLfrEdgeStream, block);
+        for_each_node(block, [&](uint64_t n) {
+          uint32_t c = community_of[n];
+          uint64_t begin = community_starts[c];
+          uint64_t end = community_starts[c + 1];
+          uint64_t lo = begin == 0 ? 0 : internal_sums[begin - 1];
+          uint64_t hi = internal_sums[end - 1];
+          std::uniform_int_distribution<uint64_t> pick_internal(
+              lo, hi > lo ? hi - 1 : lo);
+          uint32_t internal_draws =
+              RandomHalf(degree_of(internal_sums, n), &gen);
+          for (uint32_t i = 0; i < internal_draws; ++i) {
+            uint64_t other = std::upper_bound(
+                                 internal_sums.begin() + begin,
+                                 internal_sums.begin() + end,
+                                 pick_internal(gen)) -
+                             internal_sums.begin();
+            emit(n, other);
+          }
+          std::uniform_int_distribution<uint64_t> pick_external(
+              0, std::max<uint64_t>(total_external, 1) - 1);
+          uint32_t external_draws =
+              RandomHalf(degree_of(external_sums, n), &gen);
+          for (uint32_t i = 0; i < external_draws; ++i) {
+            for (uint32_t retry = 0; retry < kExternalRetries; ++retry) {
+              uint64_t other = std::upper_bound(
+                                   external_sums.begin(), external_sums.end(),
+                                   pick_external(gen)) -
+                               external_sums.begin();
+              if (community_of[other] != c) {
+                emit(n, other);
+                break;
+              }
+            }
+          }
+        });
+      });
+
+  IdScrambler scramble(num_nodes, options);
+  communities->allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { (*communities)[scramble(n)] = community_of[n]; },
+      katana::no_stats());
+  return topology;
+}
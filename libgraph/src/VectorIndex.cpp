@@ -0,0 +1,615 @@
+#include "katana/VectorIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <utility>
+
+#include "katana/Galois.h"
+#include "katana/Reduction.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define KATANA_VECTOR_INDEX_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/// The number of vectors per cluster that k-means trains on at most; the
+/// rest are only assigned to the clusters it finds
+constexpr size_t kTrainingVectorsPerList = 256;
+
+using KernelFn = float (*)(const float* a, const float* b, size_t n);
+
+float
+DotScalar(const float* a, const float* b, size_t n) {
+  float sum = 0;
+  for (size_t i = 0; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+float
+L2Scalar(const float* a, const float* b, size_t n) {
+  float sum = 0;
+  for (size_t i = 0; i < n; ++i) {
+    float d = a[i] - b[i];
+    sum += d * d;
+  }
+  return sum;
+}
+
+#ifdef KATANA_VECTOR_INDEX_X86
+
+__attribute__((target("avx2"))) float
+SumAvx2(__m256 v) {
+  float lanes[8];
+  _mm256_storeu_ps(lanes, v);
+  return std::accumulate(lanes, lanes + 8, 0.0f);
+}
+
+__attribute__((target("avx2,fma"))) float
+DotAvx2(const float* a, const float* b, size_t n) {
+  __m256 sum = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    sum = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum);
+  }
+  return SumAvx2(sum) + DotScalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2,fma"))) float
+L2Avx2(const float* a, const float* b, size_t n) {
+  __m256 sum = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+    sum = _mm256_fmadd_ps(d, d, sum);
+  }
+  return SumAvx2(sum) + L2Scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f"))) float
+SumAvx512(__m512 v) {
+  float lanes[16];
+  _mm512_storeu_ps(lanes, v);
+  return std::accumulate(lanes, lanes + 16, 0.0f);
+}
+
+__attribute__((target("avx512f"))) float
+DotAvx512(const float* a, const float* b, size_t n) {
+  __m512 sum = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    sum = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum);
+  }
+  // The tail is loaded under a mask rather than compared one by one.
+  __mmask16 tail = (1u << (n - i)) - 1;
+  sum = _mm512_fmadd_ps(
+      _mm512_maskz_loadu_ps(tail, a + i), _mm512_maskz_loadu_ps(tail, b + i),
+      sum);
+  return SumAvx512(sum);
+}
+
+__attribute__((target("avx512f"))) float
+L2Avx512(const float* a, const float* b, size_t n) {
+  __m512 sum = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512 d = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+    sum = _mm512_fmadd_ps(d, d, sum);
+  }
+  __mmask16 tail = (1u << (n - i)) - 1;
+  __m512 d = _mm512_sub_ps(
+      _mm512_maskz_loadu_ps(tail, a + i), _mm512_maskz_loadu_ps(tail, b + i));
+  sum = _mm512_fmadd_ps(d, d, sum);
+  return SumAvx512(sum);
+}
+
+#endif
+
+/// The implementations of the distances for the instruction sets of this
+/// machine
+struct Kernels {
+  KernelFn dot{DotScalar};
+  KernelFn l2{L2Scalar};
+
+  Kernels() {
+#ifdef KATANA_VECTOR_INDEX_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+      dot = DotAvx2;
+      l2 = L2Avx2;
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+      dot = DotAvx512;
+      l2 = L2Avx512;
+    }
+#endif
+  }
+};
+
+const Kernels&
+GetKernels() {
+  static const Kernels kernels;
+  return kernels;
+}
+
+/// The distance of metric between vectors of dimension floats; vectors are
+/// normalized beforehand for kCosine
+class Distance {
+public:
+  Distance(katana::VectorMetric metric, size_t dimension)
+      : metric_(metric), dimension_(dimension) {}
+
+  float operator()(const float* a, const float* b) const {
+    switch (metric_) {
+    case katana::VectorMetric::kL2:
+      return GetKernels().l2(a, b, dimension_);
+    case katana::VectorMetric::kInnerProduct:
+      return -GetKernels().dot(a, b, dimension_);
+    case katana::VectorMetric::kCosine:
+      return 1 - GetKernels().dot(a, b, dimension_);
+    }
+    return 0;
+  }
+
+  /// \returns the nearest of the num_centroids centroids to v
+  uint32_t Nearest(
+      const float* centroids, size_t num_centroids, const float* v) const {
+    uint32_t nearest = 0;
+    float nearest_distance = std::numeric_limits<float>::infinity();
+    for (size_t c = 0; c < num_centroids; ++c) {
+      float d = (*this)(centroids + c * dimension_, v);
+      if (d < nearest_distance) {
+        nearest = c;
+        nearest_distance = d;
+      }
+    }
+    return nearest;
+  }
+
+private:
+  katana::VectorMetric metric_;
+  size_t dimension_;
+};
+
+void
+Normalize(float* v, size_t dimension) {
+  float norm = std::sqrt(GetKernels().dot(v, v, dimension));
+  if (norm > 0) {
+    for (size_t i = 0; i < dimension; ++i) {
+      v[i] /= norm;
+    }
+  }
+}
+
+/// The vectors of a fixed size list array, as floats row by row
+struct Vectors {
+  size_t dimension{};
+  /// The rows of the array that hold the vectors, in increasing order
+  std::vector<uint32_t> rows;
+  std::vector<float> values;
+};
+
+template <typename ArrowType>
+void
+CopyVectors(
+    const arrow::FixedSizeListArray& lists, Vectors* vectors) {
+  const auto* values =
+      static_cast<const arrow::NumericArray<ArrowType>&>(*lists.values())
+          .raw_values();
+  size_t dimension = vectors->dimension;
+  vectors->values.resize(vectors->rows.size() * dimension);
+  katana::do_all(
+      katana::iterate(size_t{0}, vectors->rows.size()),
+      [&](size_t i) {
+        const auto* value = values + lists.value_offset(vectors->rows[i]);
+        std::copy(
+            value, value + dimension, vectors->values.begin() + i * dimension);
+      },
+      katana::no_stats());
+}
+
+/// Read the vectors of array, leaving out null ones if skip_nulls and
+/// failing on them otherwise
+katana::Result<Vectors>
+ReadVectors(const arrow::Array& array, bool skip_nulls) {
+  if (array.type_id() != arrow::Type::FIXED_SIZE_LIST) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "vectors must be fixed size lists, not {}", array.type()->ToString());
+  }
+  const auto& lists = static_cast<const arrow::FixedSizeListArray&>(array);
+  if (lists.values()->null_count() != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "vectors have null elements");
+  }
+  if (!skip_nulls && lists.null_count() != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "vectors may not be null");
+  }
+
+  Vectors vectors;
+  vectors.dimension = lists.list_type()->list_size();
+  vectors.rows.reserve(lists.length() - lists.null_count());
+  for (int64_t i = 0; i < lists.length(); ++i) {
+    if (lists.IsValid(i)) {
+      vectors.rows.emplace_back(i);
+    }
+  }
+
+  switch (lists.value_type()->id()) {
+  case arrow::Type::FLOAT:
+    CopyVectors<arrow::FloatType>(lists, &vectors);
+    break;
+  case arrow::Type::DOUBLE:
+    CopyVectors<arrow::DoubleType>(lists, &vectors);
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "vectors must be of floats or doubles, not {}",
+        lists.value_type()->ToString());
+  }
+  return vectors;
+}
+
+/// The clusters of vectors: the cluster of each and the members of each
+/// cluster in increasing order
+struct Clusters {
+  std::vector<uint32_t> assignment;
+  std::vector<uint64_t> sizes;
+  std::vector<uint64_t> offsets;
+  std::vector<uint32_t> members;
+};
+
+/// Assign each of the vectors named by ids to its nearest centroid
+Clusters
+Assign(
+    const Distance& distance, const std::vector<float>& centroids,
+    size_t num_centroids, const float* values, size_t dimension,
+    const std::vector<uint32_t>& ids) {
+  Clusters clusters;
+  clusters.assignment.resize(ids.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, ids.size()),
+      [&](size_t i) {
+        clusters.assignment[i] = distance.Nearest(
+            centroids.data(), num_centroids, values + ids[i] * dimension);
+      },
+      katana::steal(), katana::no_stats());
+
+  // A counting sort keeps the members of each cluster in order.
+  clusters.sizes.assign(num_centroids, 0);
+  for (uint32_t c : clusters.assignment) {
+    ++clusters.sizes[c];
+  }
+  clusters.offsets.assign(num_centroids + 1, 0);
+  std::partial_sum(
+      clusters.sizes.begin(), clusters.sizes.end(),
+      clusters.offsets.begin() + 1);
+  std::vector<uint64_t> next(
+      clusters.offsets.begin(), clusters.offsets.end() - 1);
+  clusters.members.resize(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    clusters.members[next[clusters.assignment[i]]++] = i;
+  }
+  return clusters;
+}
+
+/// Cluster the vectors with k-means, in parallel, and \returns the
+/// centroids of the num_centroids clusters
+std::vector<float>
+KMeans(
+    const Distance& distance, katana::VectorMetric metric,
+    const Vectors& vectors, size_t num_centroids,
+    const katana::VectorIndex::Options& options) {
+  size_t dimension = vectors.dimension;
+  size_t num_vectors = vectors.rows.size();
+
+  // Train on a random sample, whose first vectors are the initial centroids
+  std::mt19937_64 gen(options.seed);
+  std::vector<uint32_t> sample(num_vectors);
+  std::iota(sample.begin(), sample.end(), 0);
+  size_t num_samples =
+      std::min(num_vectors, num_centroids * kTrainingVectorsPerList);
+  for (size_t i = 0; i < num_samples; ++i) {
+    std::swap(sample[i], sample[i + gen() % (num_vectors - i)]);
+  }
+  sample.resize(num_samples);
+  std::sort(sample.begin() + num_centroids, sample.end());
+
+  std::vector<float> centroids(num_centroids * dimension);
+  for (size_t c = 0; c < num_centroids; ++c) {
+    std::copy_n(
+        vectors.values.begin() + sample[c] * dimension, dimension,
+        centroids.begin() + c * dimension);
+  }
+
+  for (uint32_t iteration = 0; iteration < options.num_iterations;
+       ++iteration) {
+    Clusters clusters = Assign(
+        distance, centroids, num_centroids, vectors.values.data(), dimension,
+        sample);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_centroids),
+        [&](size_t c) {
+          if (clusters.sizes[c] == 0) {
+            return;
+          }
+          std::vector<double> sum(dimension, 0);
+          for (uint64_t m = clusters.offsets[c]; m < clusters.offsets[c + 1];
+               ++m) {
+            const float* v =
+                vectors.values.data() +
+                sample[clusters.members[m]] * dimension;
+            for (size_t i = 0; i < dimension; ++i) {
+              sum[i] += v[i];
+            }
+          }
+          float* centroid = centroids.data() + c * dimension;
+          for (size_t i = 0; i < dimension; ++i) {
+            centroid[i] = sum[i] / clusters.sizes[c];
+          }
+          if (metric == katana::VectorMetric::kCosine) {
+            Normalize(centroid, dimension);
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    // Restart empty clusters from random training vectors
+    for (size_t c = 0; c < num_centroids; ++c) {
+      if (clusters.sizes[c] == 0) {
+        std::copy_n(
+            vectors.values.begin() +
+                sample[gen() % num_samples] * dimension,
+            dimension, centroids.begin() + c * dimension);
+      }
+    }
+  }
+  return centroids;
+}
+
+}  // namespace
+
+std::string
+katana::VectorMetricName(katana::VectorMetric metric) {
+  switch (metric) {
+  case VectorMetric::kL2:
+    return "l2";
+  case VectorMetric::kInnerProduct:
+    return "inner_product";
+  case VectorMetric::kCosine:
+    return "cosine";
+  }
+  return "unknown";
+}
+
+katana::Result<katana::VectorMetric>
+katana::ParseVectorMetric(const std::string& name) {
+  for (auto metric :
+       {VectorMetric::kL2, VectorMetric::kInnerProduct,
+        VectorMetric::kCosine}) {
+    if (name == VectorMetricName(metric)) {
+      return metric;
+    }
+  }
+  return KATANA_ERROR(
+      ErrorCode::InvalidArgument, "unknown vector metric: {}", name);
+}
+
+katana::Result<std::shared_ptr<katana::VectorIndex>>
+katana::VectorIndex::Make(
+    const std::string& property_name, uint64_t num_entities,
+    const arrow::Array& property, const Options& options) {
+  if (static_cast<uint64_t>(property.length()) != num_entities) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "property {} has {} rows for {} entities", property_name,
+        property.length(), num_entities);
+  }
+  Vectors vectors = KATANA_CHECKED_CONTEXT(
+      ReadVectors(property, true), "indexing property {}", property_name);
+  size_t dimension = vectors.dimension;
+  size_t num_vectors = vectors.rows.size();
+  if (options.metric == VectorMetric::kCosine) {
+    katana::do_all(
+        katana::iterate(size_t{0}, num_vectors),
+        [&](size_t i) {
+          Normalize(vectors.values.data() + i * dimension, dimension);
+        },
+        katana::no_stats());
+  }
+
+  size_t num_centroids = options.num_lists;
+  if (num_centroids == 0) {
+    num_centroids = std::llround(std::sqrt(num_vectors));
+  }
+  num_centroids = std::max<size_t>(std::min(num_centroids, num_vectors), 1);
+  if (num_vectors == 0) {
+    num_centroids = 0;
+  }
+
+  Distance distance(options.metric, dimension);
+  std::vector<float> centroids =
+      KMeans(distance, options.metric, vectors, num_centroids, options);
+  std::vector<uint32_t> all(num_vectors);
+  std::iota(all.begin(), all.end(), 0);
+  Clusters clusters = Assign(
+      distance, centroids, num_centroids, vectors.values.data(), dimension,
+      all);
+
+  std::shared_ptr<VectorIndex> index(
+      new VectorIndex(property_name, options.metric, dimension, num_entities));
+  index->size_ = num_vectors;
+  index->centroids_ = PackedLists<float>::Build(
+      std::vector<uint64_t>(num_centroids, dimension),
+      [&](float* values, const PackedLists<float>&) {
+        std::copy(centroids.begin(), centroids.end(), values);
+      });
+  index->lists_ = PackedLists<uint32_t>::Build(
+      clusters.sizes, [&](uint32_t* values, const PackedLists<uint32_t>&) {
+        for (size_t m = 0; m < num_vectors; ++m) {
+          values[m] = vectors.rows[clusters.members[m]];
+        }
+      });
+  std::vector<uint64_t> vector_sizes(clusters.sizes);
+  for (auto& size : vector_sizes) {
+    size *= dimension;
+  }
+  index->vectors_ = PackedLists<float>::Build(
+      vector_sizes, [&](float* values, const PackedLists<float>&) {
+        katana::do_all(
+            katana::iterate(size_t{0}, num_vectors),
+            [&](size_t m) {
+              std::copy_n(
+                  vectors.values.begin() + clusters.members[m] * dimension,
+                  dimension, values + m * dimension);
+            },
+            katana::no_stats());
+      });
+  return index;
+}
+
+katana::Result<std::shared_ptr<katana::VectorIndex>>
+katana::VectorIndex::Load(
+    const katana::URI& rdg_dir, const VectorIndexPrimitive::IndexFiles& files) {
+  VectorMetric metric = KATANA_CHECKED(ParseVectorMetric(files.metric));
+  std::shared_ptr<VectorIndex> index(new VectorIndex(
+      files.property_name, metric, files.dimension, files.num_entities));
+  index->size_ = files.num_entries;
+  index->centroids_ = KATANA_CHECKED(
+      VectorIndexPrimitive::MapLists<float>(rdg_dir, files.centroids_path));
+  index->lists_ = KATANA_CHECKED(
+      VectorIndexPrimitive::MapLists<uint32_t>(rdg_dir, files.lists_path));
+  index->vectors_ = KATANA_CHECKED(
+      VectorIndexPrimitive::MapLists<float>(rdg_dir, files.vectors_path));
+
+  const auto& centroids = index->centroids_;
+  const auto& lists = index->lists_;
+  const auto& vectors = index->vectors_;
+  bool valid = centroids.size() == lists.size() &&
+               vectors.size() == lists.size() &&
+               lists.offset(lists.size()) == files.num_entries;
+  for (size_t c = 0; valid && c < lists.size(); ++c) {
+    valid = centroids[c].size() == files.dimension &&
+            vectors[c].size() == lists[c].size() * files.dimension;
+  }
+  if (!valid) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "stored vector index over {} is malformed", files.property_name);
+  }
+  katana::GReduceLogicalOr invalid;
+  const uint32_t* ids = lists.empty() ? nullptr : lists[0].begin();
+  katana::do_all(
+      katana::iterate(size_t{0}, files.num_entries),
+      [&](size_t i) { invalid.update(ids[i] >= files.num_entities); },
+      katana::no_stats());
+  if (invalid.reduce()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "stored vector index over {} names missing nodes",
+        files.property_name);
+  }
+  return index;
+}
+
+katana::Result<void>
+katana::VectorIndex::Store(
+    const katana::URI& rdg_dir, VectorIndexPrimitive* stored) const {
+  VectorIndexPrimitive::IndexFiles files{
+      .property_name = property_name_,
+      .metric = VectorMetricName(metric_),
+      .dimension = dimension_,
+      .num_entities = num_entities_,
+      .num_entries = size_,
+  };
+  return stored->AddIndex(
+      rdg_dir, std::move(files), centroids_, lists_, vectors_);
+}
+
+katana::Result<katana::VectorIndex::Neighbors>
+katana::VectorIndex::Search(
+    const float* queries, size_t num_queries, size_t k,
+    size_t num_probes) const {
+  if (num_probes == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "searches must probe at least one list");
+  }
+  num_probes = std::min(num_probes, num_lists());
+
+  Neighbors neighbors{
+      .num_queries = num_queries,
+      .k = k,
+      .ids = std::vector<Node>(num_queries * k, kNoNeighbor),
+      .distances = std::vector<float>(
+          num_queries * k, std::numeric_limits<float>::infinity()),
+  };
+  if (k == 0) {
+    return neighbors;
+  }
+
+  Distance distance(metric_, dimension_);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_queries),
+      [&](size_t q) {
+        std::vector<float> query(
+            queries + q * dimension_, queries + (q + 1) * dimension_);
+        if (metric_ == VectorMetric::kCosine) {
+          Normalize(query.data(), dimension_);
+        }
+
+        std::vector<std::pair<float, uint32_t>> probes(num_lists());
+        for (size_t c = 0; c < num_lists(); ++c) {
+          probes[c] = {distance(centroids_[c].begin(), query.data()), c};
+        }
+        std::nth_element(
+            probes.begin(), probes.begin() + num_probes, probes.end());
+
+        // A max-heap of the k nearest so far, with ties broken by id so that
+        // results do not depend on the order lists are probed in
+        std::vector<std::pair<float, Node>> heap;
+        heap.reserve(k);
+        for (size_t p = 0; p < num_probes; ++p) {
+          uint32_t c = probes[p].second;
+          auto ids = lists_[c];
+          const float* v = vectors_[c].begin();
+          for (size_t i = 0; i < ids.size(); ++i, v += dimension_) {
+            std::pair<float, Node> candidate{
+                distance(v, query.data()), ids[i]};
+            if (heap.size() < k) {
+              heap.emplace_back(candidate);
+              std::push_heap(heap.begin(), heap.end());
+            } else if (candidate < heap.front()) {
+              std::pop_heap(heap.begin(), heap.end());
+              heap.back() = candidate;
+              std::push_heap(heap.begin(), heap.end());
+            }
+          }
+        }
+        std::sort_heap(heap.begin(), heap.end());
+        for (size_t i = 0; i < heap.size(); ++i) {
+          neighbors.distances[q * k + i] = heap[i].first;
+          neighbors.ids[q * k + i] = heap[i].second;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return neighbors;
+}
+
+katana::Result<katana::VectorIndex::Neighbors>
+katana::VectorIndex::Search(
+    const arrow::Array& queries, size_t k, size_t num_probes) const {
+  Vectors vectors = KATANA_CHECKED(ReadVectors(queries, false));
+  if (vectors.dimension != dimension_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "queries have {} dimensions but the index over {} has {}",
+        vectors.dimension, property_name_, dimension_);
+  }
+  return Search(vectors.values.data(), vectors.rows.size(), k, num_probes);
+}
@@ -0,0 +1,167 @@
+#include "katana/analytics/GraphStatistics.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/analytics/Utils.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+
+/// BFS from source along out-edges. \returns the eccentricity of source
+/// and the least node at that distance from it.
+std::pair<uint32_t, Node>
+Eccentricity(
+    const katana::GraphTopology& topo, Node source,
+    katana::NUMAArray<uint32_t>* levels) {
+  katana::ParallelSTL::fill(levels->begin(), levels->end(), kUnvisited);
+  (*levels)[source] = 0;
+  std::vector<Node> frontier{source};
+  katana::InsertBag<Node> next;
+  uint32_t depth = 0;
+  while (true) {
+    next.clear();
+    katana::do_all(
+        katana::iterate(frontier),
+        [&](Node node) {
+          for (auto e : topo.OutEdges(node)) {
+            Node dst = topo.OutEdgeDst(e);
+            uint32_t expected = kUnvisited;
+            if (__atomic_load_n(&(*levels)[dst], __ATOMIC_RELAXED) ==
+                    kUnvisited &&
+                __atomic_compare_exchange_n(
+                    &(*levels)[dst], &expected, depth + 1, false,
+                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+              next.push(dst);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    if (next.empty()) {
+      break;
+    }
+    frontier.assign(next.begin(), next.end());
+    ++depth;
+  }
+  return {depth, *std::min_element(frontier.begin(), frontier.end())};
+}
+
+/// The ratio of the average to the median out-degree of a sample of the
+/// nodes with out-edges, as sampled by
+/// IsApproximateDegreeDistributionPowerLaw
+double
+SampleDegreeSkew(const katana::PropertyGraph& pg) {
+  katana::analytics::SourcePicker picker(pg);
+  uint32_t num_samples = std::min<uint64_t>(1000, pg.NumNodes());
+  std::vector<uint64_t> samples(num_samples);
+  double total = 0;
+  for (uint32_t i = 0; i < num_samples; ++i) {
+    samples[i] = pg.topology().OutDegree(picker.PickNext());
+    total += samples[i];
+  }
+  std::nth_element(
+      samples.begin(), samples.begin() + num_samples / 2, samples.end());
+  return total / num_samples / samples[num_samples / 2];
+}
+
+/// A lower bound on the diameter of topo by a double sweep: the farthest
+/// node from a hub is likely near the periphery, and its eccentricity is a
+/// tighter bound than that of the hub
+uint32_t
+EstimateDiameter(const katana::GraphTopology& topo, uint64_t max_degree) {
+  katana::StatTimer timer("EstimateDiameter");
+  katana::TimerGuard guard(timer);
+  if (topo.NumEdges() == 0) {
+    return 0;
+  }
+  Node hub = *katana::ParallelSTL::find_if(
+      topo.begin(), topo.end(),
+      [&](Node node) { return topo.OutDegree(node) == max_degree; });
+  katana::NUMAArray<uint32_t> levels;
+  levels.allocateBlocked(topo.NumNodes());
+  auto [hub_eccentricity, far] = Eccentricity(topo, hub, &levels);
+  return std::max(hub_eccentricity, Eccentricity(topo, far, &levels).first);
+}
+
+}  // namespace
+
+katana::analytics::GraphStatistics
+katana::analytics::GraphStatistics::Compute(const PropertyGraph& pg) {
+  katana::StatTimer timer("GraphStatistics");
+  katana::TimerGuard guard(timer);
+  const katana::GraphTopology& topo = pg.topology();
+
+  GraphStatistics stats;
+  stats.num_nodes = topo.NumNodes();
+  stats.num_edges = topo.NumEdges();
+  if (stats.num_nodes == 0) {
+    return stats;
+  }
+  stats.average_degree =
+      static_cast<double>(stats.num_edges) / stats.num_nodes;
+  if (stats.num_nodes > 1) {
+    stats.density = static_cast<double>(stats.num_edges) /
+                    (static_cast<double>(stats.num_nodes) *
+                     static_cast<double>(stats.num_nodes - 1));
+  }
+
+  katana::GReduceMax<uint64_t> max_degree;
+  katana::do_all(
+      katana::iterate(topo),
+      [&](Node node) { max_degree.update(topo.OutDegree(node)); },
+      katana::no_stats());
+  stats.max_degree = max_degree.reduce();
+
+  if (stats.num_edges == 0) {
+    return stats;
+  }
+  stats.degree_skew = SampleDegreeSkew(pg);
+  stats.power_law = stats.num_nodes >= 10 && stats.average_degree >= 10 &&
+                    stats.degree_skew > 1.3;
+  return stats;
+}
+
+void
+katana::analytics::GraphStatistics::Print(std::ostream& os) const {
+  os << "Number of nodes = " << num_nodes << std::endl;
+  os << "Number of edges = " << num_edges << std::endl;
+  os << "Average degree = " << average_degree << std::endl;
+  os << "Max degree = " << max_degree << std::endl;
+  os << "Density = " << density << std::endl;
+  os << "Degree skew = " << degree_skew << std::endl;
+  os << "Power law = " << power_law << std::endl;
+  if (diameter_estimate) {
+    os << "Diameter estimate = " << *diameter_estimate << std::endl;
+  }
+}
+
+katana::analytics::GraphStatistics
+katana::analytics::GetGraphStatistics(const PropertyGraph& pg) {
+  if (!pg.cached_graph_statistics()) {
+    pg.set_cached_graph_statistics(
+        std::make_shared<GraphStatistics>(GraphStatistics::Compute(pg)));
+  }
+  return *pg.cached_graph_statistics();
+}
+
+uint32_t
+katana::analytics::GetDiameterEstimate(const PropertyGraph& pg) {
+  GraphStatistics stats = GetGraphStatistics(pg);
+  if (!stats.diameter_estimate) {
+    stats.diameter_estimate =
+        EstimateDiameter(pg.topology(), stats.max_degree);
+    pg.set_cached_graph_statistics(std::make_shared<GraphStatistics>(stats));
+  }
+  return *stats.diameter_estimate;
+}
@@ -0,0 +1,169 @@
+#include "katana/analytics/Memoize.h"
+
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+/// The finalizer of SplitMix64
+uint64_t
+Mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// FNV-1a, which unlike std::hash is the same in every process, as the
+/// names of stored results must be
+uint64_t
+HashString(const std::string& s) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : s) {
+    hash = (hash ^ c) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+std::shared_ptr<arrow::Table>
+MakeTable(
+    const std::string& name,
+    const std::shared_ptr<arrow::ChunkedArray>& column) {
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, column->type())}), {column});
+}
+
+std::vector<std::string>
+MemoizedNames(const arrow::Schema& schema) {
+  std::vector<std::string> names;
+  for (const auto& name : schema.field_names()) {
+    if (name.rfind(katana::analytics::kMemoizedPropertyPrefix, 0) == 0) {
+      names.emplace_back(name);
+    }
+  }
+  return names;
+}
+
+/// The parts of a plan every analytic keys on
+template <typename PlanType>
+std::string
+PlanKey(const PlanType& plan) {
+  return fmt::format(
+      "algorithm={} edge_type={}", static_cast<int>(plan.algorithm()),
+      plan.edge_type() ? static_cast<int64_t>(plan.edge_type().value()) : -1);
+}
+
+}  // namespace
+
+uint64_t
+katana::analytics::TopologyFingerprint(const PropertyGraph& pg) {
+  const GraphTopology& topology = pg.topology();
+  // A sum of edge hashes does not depend on the order of the edges
+  katana::GAccumulator<uint64_t> sum;
+  katana::do_all(
+      katana::iterate(topology.Nodes()),
+      [&](GraphTopology::Node src) {
+        uint64_t node_sum = 0;
+        for (auto e : topology.OutEdges(src)) {
+          uint64_t edge = (uint64_t{src} << 32) | topology.OutEdgeDst(e);
+          node_sum += Mix(Mix(edge) + pg.GetTypeOfEdgeFromTopoIndex(e));
+        }
+        sum += node_sum;
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("TopologyFingerprint"));
+  return Mix(
+      sum.reduce() ^ Mix(topology.NumNodes()) ^
+      Mix(Mix(topology.NumEdges())));
+}
+
+katana::Result<bool>
+katana::analytics::MemoizeNodeProperty(
+    PropertyGraph* pg, const std::string& algorithm_key,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const std::function<Result<void>(
+        PropertyGraph*, const std::string&, katana::TxnContext*)>& compute) {
+  if (pg->IsTransformed()) {
+    KATANA_CHECKED(compute(pg, output_property_name, txn_ctx));
+    return false;
+  }
+
+  std::string memo_name = fmt::format(
+      "{}{:016x}", kMemoizedPropertyPrefix,
+      Mix(HashString(algorithm_key) ^ TopologyFingerprint(*pg)));
+  if (pg->full_node_schema()->GetFieldIndex(memo_name) != -1) {
+    KATANA_CHECKED(pg->EnsureNodePropertyLoaded(memo_name));
+    std::shared_ptr<arrow::ChunkedArray> column =
+        KATANA_CHECKED(pg->GetNodeProperty(memo_name));
+    KATANA_CHECKED(pg->AddNodeProperties(
+        MakeTable(output_property_name, column), txn_ctx));
+    return true;
+  }
+
+  KATANA_CHECKED(compute(pg, output_property_name, txn_ctx));
+  std::shared_ptr<arrow::ChunkedArray> column =
+      KATANA_CHECKED(pg->GetNodeProperty(output_property_name));
+  KATANA_CHECKED(pg->AddNodeProperties(MakeTable(memo_name, column), txn_ctx));
+  return false;
+}
+
+katana::Result<void>
+katana::analytics::UnloadMemoizedResults(PropertyGraph* pg) {
+  for (const auto& name : MemoizedNames(*pg->loaded_node_schema())) {
+    KATANA_CHECKED(pg->UnloadNodeProperty(name));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::RemoveMemoizedResults(
+    PropertyGraph* pg, katana::TxnContext* txn_ctx) {
+  for (const auto& name : MemoizedNames(*pg->full_node_schema())) {
+    KATANA_CHECKED(pg->RemoveNodeProperty(name, txn_ctx));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<bool>
+katana::analytics::MemoizedPagerank(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, PagerankPlan plan) {
+  std::string key = fmt::format(
+      "Pagerank {} tolerance={} max_iterations={} alpha={}", PlanKey(plan),
+      plan.tolerance(), plan.max_iterations(), plan.alpha());
+  return MemoizeNodeProperty(
+      pg, key, output_property_name, txn_ctx,
+      [&](PropertyGraph* g, const std::string& name, katana::TxnContext* txn) {
+        return Pagerank(g, name, txn, plan);
+      });
+}
+
+katana::Result<bool>
+katana::analytics::MemoizedConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric,
+    ConnectedComponentsPlan plan) {
+  std::string key = fmt::format(
+      "ConnectedComponents {} is_symmetric={}", PlanKey(plan), is_symmetric);
+  return MemoizeNodeProperty(
+      pg, key, output_property_name, txn_ctx,
+      [&](PropertyGraph* g, const std::string& name, katana::TxnContext* txn) {
+        return ConnectedComponents(g, name, txn, is_symmetric, plan);
+      });
+}
+
+katana::Result<bool>
+katana::analytics::MemoizedKCore(
+    PropertyGraph* pg, uint32_t k_core_number,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const bool& is_symmetric, KCorePlan plan) {
+  std::string key = fmt::format(
+      "KCore {} k={} is_symmetric={}", PlanKey(plan), k_core_number,
+      is_symmetric);
+  return MemoizeNodeProperty(
+      pg, key, output_property_name, txn_ctx,
+      [&](PropertyGraph* g, const std::string& name, katana::TxnContext* txn) {
+        return KCore(g, k_core_number, name, txn, is_symmetric, plan);
+      });
+}
@@ -0,0 +1,128 @@
+#include "katana/analytics/RunStatistics.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+thread_local katana::analytics::RunStatisticsCollector* current_collector =
+    nullptr;
+
+}  // namespace
+
+double
+katana::analytics::RunStatistics::seconds() const {
+  double total = 0;
+  for (const auto& phase : phases) {
+    total += phase.seconds;
+  }
+  return total;
+}
+
+const katana::analytics::PhaseStatistics*
+katana::analytics::RunStatistics::GetPhase(const std::string& name) const {
+  auto it = std::find_if(phases.begin(), phases.end(), [&](const auto& p) {
+    return p.name == name;
+  });
+  return it == phases.end() ? nullptr : &*it;
+}
+
+void
+katana::analytics::RunStatistics::Print(std::ostream& os) const {
+  os << algorithm << ": " << seconds() << " s" << std::endl;
+  for (const auto& phase : phases) {
+    os << "  " << phase.name << " = " << phase.seconds << " s, "
+       << phase.rss_delta_bytes << " bytes" << std::endl;
+  }
+  os << "Iterations = " << iterations << std::endl;
+  os << "Work items = " << work_items << std::endl;
+  os << "Peak memory = " << peak_memory_bytes << " bytes" << std::endl;
+}
+
+katana::analytics::RunStatisticsCollector::RunStatisticsCollector()
+    : previous_(current_collector) {
+  current_collector = this;
+}
+
+katana::analytics::RunStatisticsCollector::~RunStatisticsCollector() {
+  current_collector = previous_;
+}
+
+katana::analytics::RunStatisticsCollector*
+katana::analytics::RunStatisticsCollector::Current() {
+  return current_collector;
+}
+
+katana::analytics::RunRecorder::RunRecorder(const std::string& algorithm)
+    : start_rss_bytes_(ProgressTracer::ParseProcSelfRssBytes()),
+      start_max_rss_kb_(ProgressTracer::GetMaxMem()),
+      max_rss_bytes_(start_rss_bytes_) {
+  stats_.algorithm = algorithm;
+  // Programs that start only the GaloisRuntime have no tracer
+  if (ProgressTracer::IsSet()) {
+    run_scope_.reset(new ProgressScope(GetTracer().StartActiveSpan(algorithm)));
+  }
+}
+
+katana::analytics::RunRecorder::~RunRecorder() { Finish(); }
+
+void
+katana::analytics::RunRecorder::StartPhase(const std::string& name) {
+  EndPhase();
+  stats_.phases.emplace_back(PhaseStatistics{name, 0, 0});
+  in_phase_ = true;
+  if (run_scope_) {
+    phase_scope_.reset(new ProgressScope(GetTracer().StartActiveSpan(name)));
+  }
+  phase_start_ = std::chrono::steady_clock::now();
+}
+
+void
+katana::analytics::RunRecorder::EndPhase() {
+  if (!in_phase_) {
+    return;
+  }
+  in_phase_ = false;
+  auto& phase = stats_.phases.back();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - phase_start_;
+  phase.seconds = elapsed.count();
+  uint64_t rss_bytes = ProgressTracer::ParseProcSelfRssBytes();
+  max_rss_bytes_ = std::max(max_rss_bytes_, rss_bytes);
+  phase.rss_delta_bytes = static_cast<int64_t>(rss_bytes) -
+                          static_cast<int64_t>(start_rss_bytes_);
+  if (phase_scope_) {
+    phase_scope_->span().SetTags({
+        {"rss_delta_bytes", phase.rss_delta_bytes},
+    });
+    phase_scope_.reset();
+  }
+}
+
+void
+katana::analytics::RunRecorder::Finish() {
+  if (finished_) {
+    return;
+  }
+  finished_ = true;
+  EndPhase();
+
+  long max_rss_kb = ProgressTracer::GetMaxMem();
+  uint64_t peak_bytes = max_rss_bytes_;
+  if (max_rss_kb > start_max_rss_kb_) {
+    peak_bytes = std::max(peak_bytes, static_cast<uint64_t>(max_rss_kb) << 10);
+  }
+  stats_.peak_memory_bytes = peak_bytes - start_rss_bytes_;
+
+  if (run_scope_) {
+    run_scope_->span().SetTags({
+        {"iterations", stats_.iterations},
+        {"work_items", stats_.work_items},
+        {"peak_memory_bytes", stats_.peak_memory_bytes},
+    });
+    run_scope_.reset();
+  }
+  if (auto* collector = RunStatisticsCollector::Current(); collector) {
+    collector->runs_.emplace_back(std::move(stats_));
+  }
+}
@@ -20,6 +20,7 @@
 #include "katana/analytics/Utils.h"
 
 #include "katana/Random.h"
+#include "katana/analytics/GraphStatistics.h"
 
 uint32_t
 katana::analytics::SourcePicker::PickNext() {
@@ -36,32 +37,7 @@ katana::analytics::SourcePicker::PickNext() {
 bool
 katana::analytics::IsApproximateDegreeDistributionPowerLaw(
     const PropertyGraph& graph) {
-  if (graph.NumNodes() < 10) {
-    return false;
-  }
-  uint32_t averageDegree = graph.NumEdges() / graph.NumNodes();
-  if (averageDegree < 10) {
-    return false;
-  }
-  katana::StatTimer autoAlgoTimer("IsApproximateDegreeDistributionPowerLaw");
-  autoAlgoTimer.start();
-  SourcePicker sp(graph);
-  uint32_t num_samples = 1000;
-  if (num_samples > graph.NumNodes()) {
-    num_samples = graph.NumNodes();
-  }
-  uint32_t sample_total = 0;
-  std::vector<uint32_t> samples(num_samples);
-  for (uint32_t trial = 0; trial < num_samples; trial++) {
-    auto node = sp.PickNext();
-    samples[trial] = graph.OutEdges(node).size();
-    sample_total += samples[trial];
-  }
-  std::sort(samples.begin(), samples.end());
-  double sample_average = static_cast<double>(sample_total) / num_samples;
-  double sample_median = samples[num_samples / 2];
-  autoAlgoTimer.stop();
-  return sample_average / 1.3 > sample_median;
+  return GetGraphStatistics(graph).power_law;
 }
 
 void
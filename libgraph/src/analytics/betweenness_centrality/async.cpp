@@ -1,538 +1,291 @@
-#include <iomanip>
-#include <iostream>
+#include <atomic>
 
-#include "BCEdge.h"
-#include "BCNode.h"
+#include "betweenness_centrality_impl.h"
+#include "katana/AtomicHelpers.h"
 #include "katana/Bag.h"
-#include "katana/BufferedGraph.h"
-#include "katana/LC_CSR_CSC_Graph.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Properties.h"
+#include "katana/TypedPropertyGraph.h"
 
-// WARNING: optimal chunk size may differ depending on input graph
-constexpr static const unsigned ASYNC_CHUNK_SIZE = 64U;
-using NodeType = BCNode<BC_USE_MARKING, BC_CONCURRENT>;
-using AsynchronousGraph =
-    katana::LC_CSR_CSC_Graph<NodeType, BCEdge, false, true>;
-
-// Work items for the forward phase
-struct ForwardPhaseWorkItem {
-  uint32_t nodeID;
-  uint32_t distance;
-  ForwardPhaseWorkItem() : nodeID(kInfinity), distance(kInfinity){};
-  ForwardPhaseWorkItem(uint32_t _n, uint32_t _d) : nodeID(_n), distance(_d){};
-};
+using namespace katana::analytics;
 
-// grabs distance from a forward phase work item
-struct FPWorkItemIndexer {
-  uint32_t operator()(const ForwardPhaseWorkItem& it) const {
-    return it.distance;
-  }
-};
+namespace {
 
-// obim worklist type declaration
-using PSchunk = katana::PerSocketChunkFIFO<ASYNC_CHUNK_SIZE>;
-using OBIM = katana::OrderedByIntegerMetric<FPWorkItemIndexer, PSchunk>;
+using AsyncGraph = katana::PropertyGraphViews::BiDirectional;
+using AsyncGNode = AsyncGraph::Node;
 
-template <typename T, bool enable>
-struct Counter : public T {
-  std::string name;
+constexpr static uint32_t kAsyncInfinity =
+    std::numeric_limits<uint32_t>::max();
 
-  Counter(std::string s) : name(std::move(s)) {}
-
-  ~Counter() { katana::ReportStatSingle("(NULL)", name, this->reduce()); }
+// WARNING: optimal chunk size may differ depending on input graph
+constexpr static const unsigned kAsyncChunkSize = 64u;
+
+/// The state of a node for the current source. Only the nodes the source
+/// reaches are touched, and they are reset after the source, so the state
+/// of a source costs the size of its shortest path DAG rather than the size
+/// of the graph.
+struct BCAsyncNodeDataTy {
+  std::atomic<uint32_t> dist;
+  /// The DAG edges into the node whose shortest path counts are not added
+  /// to num_shortest_paths yet
+  std::atomic<uint32_t> waiting_preds;
+  /// The DAG edges out of the node whose dependencies are not added to
+  /// dependency yet
+  std::atomic<uint32_t> waiting_succs;
+  std::atomic<double> num_shortest_paths;
+  std::atomic<double> dependency;
+  float bc;
 };
 
-template <typename T>
-struct Counter<T, false> {
-  Counter(std::string) {}
+using BCAsyncNodeDataArray = katana::NUMAArray<BCAsyncNodeDataTy>;
 
-  template <typename... Args>
-  void update(Args...) {}
+struct ForwardPhaseWorkItem {
+  AsyncGNode node;
+  uint32_t dist;
 };
 
-struct BetweenessCentralityAsynchronous {
-  AsynchronousGraph& graph;
-
-  BetweenessCentralityAsynchronous(AsynchronousGraph& _graph) : graph(_graph) {}
-
-  using SumCounter =
-      Counter<katana::GAccumulator<unsigned long>, BC_COUNT_ACTIONS>;
-  SumCounter spfuCount{"SP&FU"};
-  SumCounter updateSigmaP1Count{"UpdateSigmaBefore"};
-  SumCounter updateSigmaP2Count{"RealUS"};
-  SumCounter firstUpdateCount{"First Update"};
-  SumCounter correctNodeP1Count{"CorrectNodeBefore"};
-  SumCounter correctNodeP2Count{"Real CN"};
-  SumCounter noActionCount{"NoAction"};
-
-  using MaxCounter =
-      Counter<katana::GReduceMax<unsigned long>, BC_COUNT_ACTIONS>;
-  MaxCounter largestNodeDist{"Largest node distance"};
-
-  using LeafCounter =
-      Counter<katana::GAccumulator<unsigned long>, BC_COUNT_LEAVES>;
-
-  void CorrectNode(uint32_t dstID, BCEdge&) {
-    NodeType& dstData = graph.getData(dstID);
-
-    // loop through in edges
-    for (auto e : graph.in_edges(dstID)) {
-      BCEdge& inEdgeData = graph.getInEdgeData(e);
-
-      uint32_t srcID = graph.getInEdgeDst(e);
-      if (srcID == dstID)
-        continue;
-
-      NodeType& srcData = graph.getData(srcID);
-
-      // lock in right order
-      if (srcID < dstID) {
-        srcData.lock();
-        dstData.lock();
-      } else {
-        dstData.lock();
-        srcData.lock();
-      }
-
-      const unsigned edgeLevel = inEdgeData.level;
-
-      // Correct Node
-      if (srcData.distance >= dstData.distance) {
-        correctNodeP1Count.update(1);
-        dstData.unlock();
-
-        if (edgeLevel != kInfinity) {
-          inEdgeData.level = kInfinity;
-          if (edgeLevel == srcData.distance) {
-            correctNodeP2Count.update(1);
-            srcData.nsuccs--;
-          }
-        }
-        srcData.unlock();
-      } else {
-        srcData.unlock();
-        dstData.unlock();
-      }
-    }
+struct ForwardPhaseWorkItemIndexer {
+  uint32_t operator()(const ForwardPhaseWorkItem& item) const {
+    return item.dist;
   }
+};
 
-  template <typename CTXType>
-  void SpAndFU(uint32_t srcID, uint32_t dstID, BCEdge& ed, CTXType& ctx) {
-    spfuCount.update(1);
-
-    NodeType& srcData = graph.getData(srcID);
-    NodeType& dstData = graph.getData(dstID);
-
-    // make dst a successor of src, src predecessor of dst
-    srcData.nsuccs++;
-    const ShortPathType srcSigma = srcData.sigma;
-    KATANA_LOG_DEBUG_ASSERT(srcSigma > 0);
-    NodeType::predTY& dstPreds = dstData.preds;
-    bool dstPredsNotEmpty = !dstPreds.empty();
-    dstPreds.clear();
-    dstPreds.push_back(srcID);
-    dstData.distance = srcData.distance + 1;
-
-    largestNodeDist.update(dstData.distance);
-
-    dstData.nsuccs = 0;        // SP
-    dstData.sigma = srcSigma;  // FU
-    ed.val = srcSigma;
-    ed.level = srcData.distance;
-    srcData.unlock();
-    if (!dstData.isAlreadyIn())
-      ctx.push(ForwardPhaseWorkItem(dstID, dstData.distance));
-    dstData.unlock();
-    if (dstPredsNotEmpty) {
-      correctNode(dstID, ed);
-    }
+using PSchunk = katana::PerSocketChunkFIFO<kAsyncChunkSize>;
+using OBIM =
+    katana::OrderedByIntegerMetric<ForwardPhaseWorkItemIndexer, PSchunk>;
+
+struct NodeBC : public katana::PODProperty<float> {};
+
+class AsyncExecutor {
+  const AsyncGraph& graph_;
+  BCAsyncNodeDataArray graph_data_;
+  /// The nodes the current source reaches
+  katana::InsertBag<AsyncGNode> reached_;
+  /// The reached nodes with no DAG edges out
+  katana::InsertBag<AsyncGNode> leaves_;
+
+  bool IsDagEdge(AsyncGNode src, AsyncGNode dst) const {
+    uint32_t src_dist = graph_data_[src].dist.load(std::memory_order_relaxed);
+    return src_dist != kAsyncInfinity &&
+           graph_data_[dst].dist.load(std::memory_order_relaxed) ==
+               src_dist + 1;
   }
 
-  template <typename CTXType>
-  void UpdateSigma(uint32_t srcID, uint32_t dstID, BCEdge& ed, CTXType& ctx) {
-    updateSigmaP1Count.update(1);
-
-    NodeType& srcData = graph.getData(srcID);
-    NodeType& dstData = graph.getData(dstID);
-
-    const ShortPathType srcSigma = srcData.sigma;
-    const ShortPathType eval = ed.val;
-    const ShortPathType diff = srcSigma - eval;
-
-    srcData.unlock();
-    // greater than 0.0001 instead of 0 due to floating point imprecision
-    if (diff > 0.0001) {
-      updateSigmaP2Count.update(1);
-      ed.val = srcSigma;
-
-      // ShortPathType old = dstData.sigma;
-      dstData.sigma += diff;
-
-      // if (old >= dstData.sigma) {
-      //  katana::gDebug("Overflow detected; capping at max uint64_t");
-      //  dstData.sigma = std::numeric_limits<uint64_t>::max();
-      //}
-
-      int nbsuccs = dstData.nsuccs;
-
-      if (nbsuccs > 0) {
-        if (!dstData.isAlreadyIn())
-          ctx.push(ForwardPhaseWorkItem(dstID, dstData.distance));
-      }
-      dstData.unlock();
-    } else {
-      dstData.unlock();
-    }
+  /// Distances from the source by a label correcting search in order of
+  /// distance, without a barrier between levels
+  void Distances(AsyncGNode source) {
+    graph_data_[source].dist.store(0, std::memory_order_relaxed);
+    reached_.push(source);
+    katana::for_each(
+        katana::iterate({ForwardPhaseWorkItem{source, 0}}),
+        [&](const ForwardPhaseWorkItem& item, auto& ctx) {
+          if (item.dist >
+              graph_data_[item.node].dist.load(std::memory_order_relaxed)) {
+            return;
+          }
+          uint32_t dist = item.dist + 1;
+          for (auto e : graph_.OutEdges(item.node)) {
+            AsyncGNode dst = graph_.OutEdgeDst(e);
+            uint32_t old = katana::atomicMin(graph_data_[dst].dist, dist);
+            if (old > dist) {
+              if (old == kAsyncInfinity) {
+                reached_.push(dst);
+              }
+              ctx.push(ForwardPhaseWorkItem{dst, dist});
+            }
+          }
+        },
+        katana::wl<OBIM>(ForwardPhaseWorkItemIndexer()),
+        katana::disable_conflict_detection(), katana::no_stats(),
+        katana::loopname("AsyncDistances"));
   }
 
-  template <typename CTXType>
-  void FirstUpdate(uint32_t srcID, uint32_t dstID, BCEdge& ed, CTXType& ctx) {
-    firstUpdateCount.update(1);
-
-    NodeType& srcData = graph.getData(srcID);
-    srcData.nsuccs++;
-    const ShortPathType srcSigma = srcData.sigma;
-
-    NodeType& dstData = graph.getData(dstID);
-    dstData.preds.push_back(srcID);
-
-    const ShortPathType dstSigma = dstData.sigma;
-
-    // ShortPathType old = dstData.sigma;
-    dstData.sigma = dstSigma + srcSigma;
-    // if (old >= dstData.sigma) {
-    //  katana::gDebug("Overflow detected; capping at max uint64_t");
-    //  dstData.sigma = std::numeric_limits<uint64_t>::max();
-    //}
-
-    ed.val = srcSigma;
-    ed.level = srcData.distance;
-    srcData.unlock();
-    int nbsuccs = dstData.nsuccs;
-    if (nbsuccs > 0) {
-      if (!dstData.isAlreadyIn())
-        ctx.push(ForwardPhaseWorkItem(dstID, dstData.distance));
-    }
-    dstData.unlock();
+  /// Count the DAG edges into and out of each reached node
+  void CountDagEdges() {
+    katana::do_all(
+        katana::iterate(reached_),
+        [&](AsyncGNode n) {
+          uint32_t succs = 0;
+          for (auto e : graph_.OutEdges(n)) {
+            AsyncGNode dst = graph_.OutEdgeDst(e);
+            if (IsDagEdge(n, dst)) {
+              ++succs;
+              graph_data_[dst].waiting_preds.fetch_add(
+                  1, std::memory_order_relaxed);
+            }
+          }
+          graph_data_[n].waiting_succs.store(
+              succs, std::memory_order_relaxed);
+          if (succs == 0) {
+            leaves_.push(n);
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("AsyncCountDagEdges"));
   }
 
-  void DagConstruction(katana::InsertBag<ForwardPhaseWorkItem>& wl) {
+  /// Push the shortest path counts down the DAG: a node goes once the last
+  /// of its DAG predecessors has added its count
+  void ShortestPathCounts(AsyncGNode source) {
+    graph_data_[source].num_shortest_paths.store(
+        1, std::memory_order_relaxed);
     katana::for_each(
-        katana::iterate(wl),
-        [&](ForwardPhaseWorkItem& wi, auto& ctx) {
-          uint32_t srcID = wi.nodeID;
-          NodeType& srcData = graph.getData(srcID);
-          srcData.markOut();
-
-          // loop through all edges
-          for (auto e : graph.edges(srcID)) {
-            BCEdge& edgeData = graph.getEdgeData(e);
-            uint32_t dstID = graph.getEdgeDst(e);
-            NodeType& dstData = graph.getData(dstID);
-
-            if (srcID == dstID)
-              continue;  // ignore self loops
-
-            // lock in set order to prevent deadlock (lower id
-            // first)
-            // TODO run even in serial version; find way to not
-            // need to run
-            if (srcID < dstID) {
-              srcData.lock();
-              dstData.lock();
-            } else {
-              dstData.lock();
-              srcData.lock();
+        katana::iterate({source}),
+        [&](AsyncGNode n, auto& ctx) {
+          double paths = graph_data_[n].num_shortest_paths.load(
+              std::memory_order_relaxed);
+          for (auto e : graph_.OutEdges(n)) {
+            AsyncGNode dst = graph_.OutEdgeDst(e);
+            if (!IsDagEdge(n, dst)) {
+              continue;
             }
-
-            const int elevel = edgeData.level;
-            const int ADist = srcData.distance;
-            const int BDist = dstData.distance;
-
-            if (BDist - ADist > 1) {
-              // Shortest Path + First Update (and Correct Node)
-              this->spAndFU(srcID, dstID, edgeData, ctx);
-            } else if (elevel == ADist && BDist == ADist + 1) {
-              // Update Sigma
-              this->updateSigma(srcID, dstID, edgeData, ctx);
-            } else if (BDist == ADist + 1 && elevel != ADist) {
-              // First Update not combined with Shortest Path
-              this->firstUpdate(srcID, dstID, edgeData, ctx);
-            } else {  // No Action
-              noActionCount.update(1);
-              srcData.unlock();
-              dstData.unlock();
+            auto& dst_data = graph_data_[dst];
+            katana::atomicAdd(dst_data.num_shortest_paths, paths);
+            if (dst_data.waiting_preds.fetch_sub(
+                    1, std::memory_order_acq_rel) == 1) {
+              ctx.push(dst);
             }
           }
         },
-        katana::wl<OBIM>(FPWorkItemIndexer()),
-        katana::disable_conflict_detection(), katana::loopname("ForwardPhase"));
+        katana::disable_conflict_detection(), katana::no_stats(),
+        katana::loopname("AsyncShortestPathCounts"));
   }
 
-  void DependencyBackProp(katana::InsertBag<uint32_t>& wl) {
+  /// Push the dependencies up the DAG from its leaves: a node goes once the
+  /// last of its DAG successors has added its share
+  void Dependencies(AsyncGNode source) {
     katana::for_each(
-        katana::iterate(wl),
-        [&](uint32_t srcID, auto& ctx) {
-          NodeType& srcData = graph.getData(srcID);
-          srcData.lock();
-
-          if (srcData.nsuccs == 0) {
-            const double srcDelta = srcData.delta;
-            srcData.bc += srcDelta;
-
-            srcData.unlock();
-
-            NodeType::predTY& srcPreds = srcData.preds;
-
-            // loop through src's predecessors
-            for (unsigned i = 0; i < srcPreds.size(); i++) {
-              uint32_t predID = srcPreds[i];
-              NodeType& predData = graph.getData(predID);
-
-              KATANA_LOG_DEBUG_ASSERT(srcData.sigma >= 1);
-              const double term =
-                  (double)predData.sigma * (1.0 + srcDelta) / srcData.sigma;
-              // if (std::isnan(term)) {
-              //  katana::gPrint(predData.sigma, " ", srcDelta, "
-              //  ", srcData.sigma, "\n");
-              //}
-              predData.lock();
-              predData.delta += term;
-              const unsigned prevPdNsuccs = predData.nsuccs;
-              predData.nsuccs--;
-
-              if (prevPdNsuccs == 1) {
-                predData.unlock();
-                ctx.push(predID);
-              } else {
-                predData.unlock();
-              }
+        katana::iterate(leaves_),
+        [&](AsyncGNode n, auto& ctx) {
+          auto& data = graph_data_[n];
+          double dependency =
+              data.dependency.load(std::memory_order_relaxed);
+          if (n != source) {
+            data.bc += dependency;
+          }
+          double share =
+              (1 + dependency) /
+              data.num_shortest_paths.load(std::memory_order_relaxed);
+          for (auto e : graph_.InEdges(n)) {
+            AsyncGNode src = graph_.InEdgeSrc(e);
+            if (!IsDagEdge(src, n)) {
+              continue;
             }
-
-            // reset data in preparation for next source
-            srcData.reset();
-            for (auto e : graph.edges(srcID)) {
-              graph.getEdgeData(e).reset();
+            auto& src_data = graph_data_[src];
+            katana::atomicAdd(
+                src_data.dependency,
+                src_data.num_shortest_paths.load(std::memory_order_relaxed) *
+                    share);
+            if (src_data.waiting_succs.fetch_sub(
+                    1, std::memory_order_acq_rel) == 1) {
+              ctx.push(src);
             }
-          } else {
-            srcData.unlock();
           }
         },
-        katana::disable_conflict_detection(),
-        katana::loopname("BackwardPhase"));
+        katana::disable_conflict_detection(), katana::no_stats(),
+        katana::loopname("AsyncDependencies"));
   }
 
-  void FindLeaves(katana::InsertBag<uint32_t>& fringeWL, unsigned nnodes) {
-    LeafCounter leafCount{"leaf nodes in DAG"};
+  void ResetReached() {
     katana::do_all(
-        katana::iterate(0u, nnodes),
-        [&](auto i) {
-          NodeType& n = graph.getData(i);
-
-          if (n.nsuccs == 0 && n.distance < kInfinity) {
-            leafCount.update(1);
-            fringeWL.push(i);
-          }
+        katana::iterate(reached_),
+        [&](AsyncGNode n) {
+          auto& data = graph_data_[n];
+          data.dist.store(kAsyncInfinity, std::memory_order_relaxed);
+          data.num_shortest_paths.store(0, std::memory_order_relaxed);
+          data.dependency.store(0, std::memory_order_relaxed);
         },
-        katana::loopname("LeafFind"));
+        katana::no_stats(), katana::loopname("AsyncReset"));
+    reached_.clear();
+    leaves_.clear();
   }
-};
-
-void
-AsynchronousSanity(AsynchronousGraph& graph) {
-  katana::GReduceMax<float> accum_max;
-  katana::GReduceMin<float> accum_min;
-  katana::GAccumulator<float> accum_sum;
-  accum_max.reset();
-  accum_min.reset();
-  accum_sum.reset();
-
-  // get max, min, sum of BC values using accumulators and reducers
-  katana::do_all(
-      katana::iterate(graph),
-      [&](unsigned n) {
-        auto& nodeData = graph.getData(n);
-        accum_max.update(nodeData.bc);
-        accum_min.update(nodeData.bc);
-        accum_sum += nodeData.bc;
-      },
-      katana::no_stats(), katana::loopname("AsynchronousSanity"));
-
-  katana::gPrint("Max BC is ", accum_max.reduce(), "\n");
-  katana::gPrint("Min BC is ", accum_min.reduce(), "\n");
-  katana::gPrint("BC sum is ", accum_sum.reduce(), "\n");
-}
-////////////////////////////////////////////////////////////////////////////////
 
-//! runs asynchronous BC
-void
-BetweennessCentralityAsynchronous() {
-  if (BC_CONCURRENT) {
-    katana::gInfo("Running in concurrent mode with ", numThreads, " threads");
-  } else {
-    katana::gInfo("Running in serial mode");
+public:
+  explicit AsyncExecutor(const AsyncGraph& graph) : graph_(graph) {
+    graph_data_.allocateBlocked(graph.NumNodes());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, graph.NumNodes()),
+        [&](uint64_t n) {
+          auto& data = graph_data_[n];
+          data.dist.store(kAsyncInfinity, std::memory_order_relaxed);
+          data.waiting_preds.store(0, std::memory_order_relaxed);
+          data.waiting_succs.store(0, std::memory_order_relaxed);
+          data.num_shortest_paths.store(0, std::memory_order_relaxed);
+          data.dependency.store(0, std::memory_order_relaxed);
+          data.bc = 0;
+        },
+        katana::no_stats(), katana::loopname("AsyncInitializeGraph"));
   }
 
-  katana::gInfo("Constructing async BC graph");
-  // create bidirectional graph
-  AsynchronousGraph bcGraph;
-
-  katana::StatTimer graph_construct_timer("GRAPH_CONSTRUCT");
-  graph_construct_timer.start();
-
-  katana::FileGraph fileReader;
-  fileReader.fromFile(inputFile);
-  bcGraph.allocateFrom(fileReader.size(), fileReader.sizeEdges());
-  bcGraph.constructNodes();
-
-  katana::do_all(katana::iterate(fileReader), [&](uint32_t i) {
-    auto b = fileReader.edge_begin(i);
-    auto e = fileReader.edge_end(i);
-
-    bcGraph.fixEndEdge(i, *e);
-
-    while (b < e) {
-      bcGraph.constructEdge(*b, fileReader.getEdgeDst(*b));
-      b++;
-    }
-  });
-  bcGraph.constructIncomingEdges();
+  /// Add the dependencies of source to the centralities. The counts of
+  /// waiting edges are back to 0 when the source is done.
+  void AddSource(AsyncGNode source) {
+    Distances(source);
+    CountDagEdges();
+    ShortestPathCounts(source);
+    Dependencies(source);
+    ResetReached();
+  }
 
-  graph_construct_timer.stop();
+  float bc(AsyncGNode n) const { return graph_data_[n].bc; }
+};
 
-  BetweenessCentralityAsynchronous bcExecutor(bcGraph);
+}  // namespace
 
-  unsigned nnodes = bcGraph.size();
-  uint64_t nedges = bcGraph.sizeEdges();
-  katana::gInfo("Num nodes is ", nnodes, ", num edges is ", nedges);
-  katana::gInfo("Using OBIM chunk size: ", ASYNC_CHUNK_SIZE);
-  katana::gInfo(
-      "Note that optimal chunk size may differ depending on input "
-      "graph");
+katana::Result<void>
+BetweennessCentralityAsynchronous(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan [[maybe_unused]],
+    katana::TxnContext* txn_ctx) {
   katana::ReportStatSingle(
-      "BetweennessCentralityAsynchronous", "ChunkSize", ASYNC_CHUNK_SIZE);
-
-  katana::EnsurePreallocated(
-      std::min(
-          static_cast<uint64_t>(
-              std::min(katana::getActiveThreads(), 100U) *
-              std::max((nnodes / 4500000), unsigned{5}) *
-              std::max((nedges / 30000000), uint64_t{5}) * 2.5),
-          uint64_t{1500}) +
-      5);
-  katana::ReportPageAllocGuard page_alloc;
-
-  // reset everything in preparation for run
-  katana::do_all(
-      katana::iterate(0u, nnodes), [&](auto i) { bcGraph.getData(i).reset(); });
-  katana::do_all(katana::iterate(UINT64_C(0), nedges), [&](auto i) {
-    bcGraph.getEdgeData(i).reset();
-  });
-
-  // reading in list of sources to operate on if provided
-  std::ifstream sourceFile;
-  std::vector<uint64_t> sourceVector;
-  if (sourcesToUse != "") {
-    sourceFile.open(sourcesToUse);
-    std::vector<uint64_t> t(
-        std::istream_iterator<uint64_t>{sourceFile},
-        std::istream_iterator<uint64_t>{});
-    sourceVector = t;
-    sourceFile.close();
-  }
-
-  if (numOfSources == 0) {
-    numOfSources = nnodes;
-  }
-
-  // if user does specifes a certain number of out sources (i.e. only sources
-  // with outgoing edges), we need to loop over the entire node set to look for
-  // good sources to use
-  uint32_t goodSource = 0;
-  if (iterLimit != 0) {
-    numOfSources = nnodes;
-  }
+      "BetweennessCentrality", "ChunkSize", kAsyncChunkSize);
+  katana::StatTimer graph_construct_timer(
+      "TimerConstructGraph", "BetweennessCentrality");
+  graph_construct_timer.start();
+  AsyncGraph graph = pg->BuildView<AsyncGraph>();
+  AsyncExecutor executor(graph);
+  graph_construct_timer.stop();
 
-  // only use at most the number of sources in the passed in source file (if
-  // such a file was actually pass in)
-  if (sourceVector.size() != 0) {
-    if (numOfSources > sourceVector.size()) {
-      numOfSources = sourceVector.size();
-    }
+  std::vector<uint32_t> source_vector;
+  uint64_t loop_end;
+  if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
+    source_vector = std::get<std::vector<uint32_t>>(sources);
+    loop_end = source_vector.size();
+  } else if (sources == kBetweennessCentralityAllNodes) {
+    loop_end = pg->NumNodes();
+  } else {
+    loop_end = std::min<uint64_t>(std::get<uint32_t>(sources), pg->NumNodes());
   }
 
-  katana::InsertBag<ForwardPhaseWorkItem> forwardPhaseWL;
-  katana::InsertBag<uint32_t> backwardPhaseWL;
-
-  katana::gInfo("Beginning execution");
-
-  katana::StatTimer exec_time("BetweennessCentralityAsynchronous");
+  katana::StatTimer exec_time("Asynchronous", "BetweennessCentrality");
   exec_time.start();
-  for (uint32_t i = 0; i < numOfSources; ++i) {
-    uint32_t sourceToUse = i;
-    if (sourceVector.size() != 0) {
-      sourceToUse = sourceVector[i];
-    }
-
-    // ignore nodes with no neighbors
-    if (!std::distance(
-            bcGraph.edge_begin(sourceToUse), bcGraph.edge_end(sourceToUse))) {
-      katana::gDebug(sourceToUse, " has no outgoing edges");
-      continue;
+  for (uint64_t i = 0; i < loop_end; ++i) {
+    AsyncGNode src_node = source_vector.empty() ? i : source_vector[i];
+    if (src_node >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          src_node);
     }
-
-    forwardPhaseWL.push_back(ForwardPhaseWorkItem(sourceToUse, 0));
-    NodeType& active = bcGraph.getData(sourceToUse);
-    active.initAsSource();
-    katana::gDebug("Source is ", sourceToUse);
-
-    bcExecutor.dagConstruction(forwardPhaseWL);
-    forwardPhaseWL.clear();
-
-    bcExecutor.findLeaves(backwardPhaseWL, nnodes);
-
-    double backupSrcBC = active.bc;
-    bcExecutor.dependencyBackProp(backwardPhaseWL);
-
-    active.bc = backupSrcBC;  // current source BC should not get updated
-
-    backwardPhaseWL.clear();
-
-    // break out once number of sources user specified to do (if any) has been
-    // reached
-    goodSource++;
-    if (iterLimit != 0 && goodSource >= iterLimit)
-      break;
+    executor.AddSource(src_node);
   }
   exec_time.stop();
 
-  katana::gInfo("Number of sources with outgoing edges was ", goodSource);
-
-  page_alloc.Report();
-
-  // sanity
-  AsynchronousSanity(bcGraph);
-
-  // prints out first 10 node BC values
-  if (!skipVerify) {
-    int count = 0;
-    for (unsigned i = 0; i < nnodes && count < 10; ++i, ++count) {
-      katana::gPrint(
-          count, ": ", std::setiosflags(std::ios::fixed), std::setprecision(6),
-          bcGraph.getData(i).bc, "\n");
-    }
-  }
-
-  if (output) {
-    std::cerr << "Writting out bc values...\n";
-    std::stringstream outfname;
-    outfname << "certificate"
-             << "_" << numThreads << ".txt";
-    std::string fname = outfname.str();
-    std::ofstream outfile(fname.c_str());
-    for (unsigned i = 0; i < nnodes; ++i) {
-      outfile << i << " " << std::setiosflags(std::ios::fixed)
-              << std::setprecision(9) << bcGraph.getData(i).bc << "\n";
-    }
-    outfile.close();
+  if (auto result = pg->ConstructNodeProperties<std::tuple<NodeBC>>(
+          txn_ctx, {output_property_name});
+      !result) {
+    return result.error();
   }
+  using NewGraph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Default, std::tuple<NodeBC>, std::tuple<>>;
+  auto new_graph =
+      KATANA_CHECKED(NewGraph::Make(pg, {output_property_name}, {}));
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->NumNodes()),
+      [&](uint64_t n) { new_graph.GetData<NodeBC>(n) = executor.bc(n); },
+      katana::no_stats(), katana::loopname("ExtractBC"));
+  return katana::ResultSuccess();
 }
@@ -31,18 +31,18 @@ katana::analytics::BetweennessCentrality(
     katana::TxnContext* txn_ctx, const BetweennessCentralitySources& sources,
     BetweennessCentralityPlan plan) {
   switch (plan.algorithm()) {
-    //TODO (gill) Needs bidirectional graph (CSR_CSC)
-    //   case Asynchronous:
-    //     // see AsyncStructs.h
-    //     katana::gInfo("Running async BC");
-    //     doAsyncBC();
-    //     break;
   case BetweennessCentralityPlan::kLevel:
     return BetweennessCentralityLevel(
         pg, sources, output_property_name, plan, txn_ctx);
   case BetweennessCentralityPlan::kOuter:
     return BetweennessCentralityOuter(
         pg, sources, output_property_name, plan, txn_ctx);
+  case BetweennessCentralityPlan::kApproximate:
+    return BetweennessCentralityApproximate(
+        pg, sources, output_property_name, plan, txn_ctx);
+  case BetweennessCentralityPlan::kAsynchronous:
+    return BetweennessCentralityAsynchronous(
+        pg, sources, output_property_name, plan, txn_ctx);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
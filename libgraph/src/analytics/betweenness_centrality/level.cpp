@@ -1,8 +1,13 @@
+#include <cmath>
+#include <random>
+
 #include "betweenness_centrality_impl.h"
 #include "katana/AtomicHelpers.h"
 #include "katana/DynamicBitset.h"
 #include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
 #include "katana/Properties.h"
+#include "katana/Reduction.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -322,3 +327,157 @@ BetweennessCentralityLevel(
   // Get the BC proporty into the property graph by extracting from AoS
   return ExtractBC(pg, graph, graph_data, output_property_name, txn_ctx);
 }
+
+namespace {
+
+/// Bound on the error of the mean of k samples in [0, 1] with sample variance
+/// variance that holds with probability 1 - delta (Maurer and Pontil's
+/// empirical Bernstein bound, two sided)
+double
+EmpiricalBernsteinBound(double variance, uint64_t k, double delta) {
+  double log_term = std::log(4 / delta);
+  return std::sqrt(2 * variance * log_term / k) +
+         7 * log_term / (3 * (k - 1));
+}
+
+/**
+ * Estimate the centrality of each node into its bc from the dependencies of
+ * uniformly sampled sources, at most max_samples of them.
+ *
+ * The sample of a source s at node v is its dependency scaled into [0, 1];
+ * its mean over all sources is the centrality of v divided by n * (n - 1).
+ * Half of delta goes to the Hoeffding bound after the last sample, half to
+ * the empirical Bernstein bounds of all nodes at geometric checkpoints.
+ *
+ * @returns the number of samples and sets bound to the error bound they meet
+ */
+uint64_t
+LevelApproximate(
+    LevelGraph* graph, BCLevelNodeDataArray* graph_data,
+    katana::DynamicBitset* active_edges, uint64_t max_samples,
+    const katana::analytics::BetweennessCentralityPlan& plan, double* bound) {
+  const uint64_t num_nodes = graph->size();
+  KATANA_LOG_DEBUG_ASSERT(num_nodes >= 3);
+  const double scale = 1.0 / (num_nodes - 1);
+  const double epsilon = plan.epsilon();
+  const double hoeffding_log = std::log(4 * num_nodes / plan.delta());
+  max_samples = std::min<uint64_t>(
+      max_samples, std::ceil(hoeffding_log / (2 * epsilon * epsilon)));
+  max_samples = std::max<uint64_t>(max_samples, 1);
+
+  const uint64_t first_check = std::max<uint64_t>(2, std::ceil(1 / epsilon));
+  uint64_t num_checks = 1;
+  for (uint64_t k = first_check; k < max_samples; k *= 2) {
+    ++num_checks;
+  }
+  const double check_delta = plan.delta() / (2 * num_nodes * num_checks);
+
+  katana::NUMAArray<double> sums;
+  katana::NUMAArray<double> squares;
+  sums.allocateBlocked(num_nodes);
+  squares.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(sums.begin(), sums.end(), 0.0);
+  katana::ParallelSTL::fill(squares.begin(), squares.end(), 0.0);
+
+  std::mt19937_64 gen(plan.seed());
+  std::uniform_int_distribution<uint64_t> pick(0, num_nodes - 1);
+
+  uint64_t samples = 0;
+  uint64_t next_check = first_check;
+  *bound = 1;
+  while (samples < max_samples) {
+    LevelGNode src_node = pick(gen);
+    LevelInitializeIteration(graph, src_node, graph_data, active_edges);
+    katana::gstl::Vector<LevelWorklistType> worklists =
+        LevelSSSP(graph, src_node, graph_data, active_edges);
+    LevelBackwardBrandes(graph, &worklists, graph_data, active_edges);
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](LevelGNode n) {
+          double x = (*graph_data)[n].dependency * scale;
+          sums[n] += x;
+          squares[n] += x * x;
+        },
+        katana::no_stats(), katana::loopname("ApproximateAccumulate"));
+    ++samples;
+
+    if (samples == next_check && samples < max_samples) {
+      next_check *= 2;
+      katana::GReduceMax<double> max_variance;
+      katana::do_all(
+          katana::iterate(*graph),
+          [&](LevelGNode n) {
+            double mean = sums[n] / samples;
+            double variance =
+                (squares[n] - samples * mean * mean) / (samples - 1);
+            max_variance.update(std::max(variance, 0.0));
+          },
+          katana::no_stats(), katana::loopname("ApproximateCheck"));
+      *bound =
+          EmpiricalBernsteinBound(max_variance.reduce(), samples, check_delta);
+      if (*bound <= epsilon) {
+        break;
+      }
+    }
+  }
+  if (samples == max_samples) {
+    *bound = std::sqrt(hoeffding_log / (2 * samples));
+  }
+
+  // Estimate the centrality in the units of the exact algorithms
+  const double estimate_scale =
+      static_cast<double>(num_nodes) * (num_nodes - 1) / samples;
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](LevelGNode n) { (*graph_data)[n].bc = sums[n] * estimate_scale; },
+      katana::no_stats(), katana::loopname("ApproximateEstimate"));
+  return samples;
+}
+
+}  // namespace
+
+katana::Result<void>
+BetweennessCentralityApproximate(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan,
+    katana::TxnContext* txn_ctx) {
+  if (!(plan.epsilon() > 0 && plan.epsilon() < 1) ||
+      !(plan.delta() > 0 && plan.delta() < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "epsilon {} and delta {} must be in (0, 1)", plan.epsilon(),
+        plan.delta());
+  }
+  if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "approximate betweenness centrality samples its own sources");
+  }
+  uint64_t max_samples = std::numeric_limits<uint64_t>::max();
+  if (sources != kBetweennessCentralityAllNodes) {
+    max_samples = std::get<uint32_t>(sources);
+  }
+
+  LevelGraph graph = KATANA_CHECKED(LevelGraph::Make(pg, {}, {}));
+  katana::ReportPageAllocGuard page_alloc;
+
+  BCLevelNodeDataArray graph_data;
+  katana::DynamicBitset active_edges;
+  LevelInitializeGraph(&graph, &graph_data, &active_edges);
+
+  // With fewer than 3 nodes, no node lies between two others
+  if (graph.size() >= 3) {
+    katana::StatTimer exec_time("Approximate", "BetweennessCentrality");
+    exec_time.start();
+    double bound = 0;
+    uint64_t samples = LevelApproximate(
+        &graph, &graph_data, &active_edges, max_samples, plan, &bound);
+    exec_time.stop();
+    katana::ReportStatSingle("BetweennessCentrality", "Samples", samples);
+    katana::ReportStatSingle("BetweennessCentrality", "ErrorBound", bound);
+  }
+
+  return ExtractBC(pg, graph, graph_data, output_property_name, txn_ctx);
+}
@@ -1,6 +1,7 @@
 #include <boost/iterator/filter_iterator.hpp>
 
 #include "betweenness_centrality_impl.h"
+#include "katana/ArrowRandomAccessBuilder.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -157,26 +158,24 @@ public:
 
   katana::Result<std::shared_ptr<arrow::FloatArray>> ExtractBCValues(
       size_t begin, size_t end) {
-    arrow::FloatBuilder builder;
-    if (auto r = builder.Resize(end - begin); !r.ok()) {
-      return katana::ErrorCode::ArrowError;
-    }
-    for (; begin != end; ++begin) {
-      float bc = (*centrality_measure_.getRemote(0))[begin];
-
-      for (unsigned j = 1; j < katana::getActiveThreads(); ++j) {
-        bc += (*centrality_measure_.getRemote(j))[begin];
-      }
-
-      if (auto r = builder.Append(bc); !r.ok()) {
-        return katana::ErrorCode::ArrowError;
-      }
-    }
-    std::shared_ptr<arrow::FloatArray> ret;
-    if (auto r = builder.Finish(&ret); !r.ok()) {
-      return katana::ErrorCode::ArrowError;
-    }
-    return ret;
+    // summed straight into the buffer of the result
+    katana::ArrowRandomAccessBuilder<arrow::FloatType, false> builder(
+        end - begin);
+    float* values = builder.data();
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](size_t i) {
+          float bc = (*centrality_measure_.getRemote(0))[i];
+
+          for (unsigned j = 1; j < katana::getActiveThreads(); ++j) {
+            bc += (*centrality_measure_.getRemote(j))[i];
+          }
+
+          values[i - begin] = bc;
+        },
+        katana::no_stats());
+    std::shared_ptr<arrow::Array> array = KATANA_CHECKED(builder.Finalize());
+    return std::static_pointer_cast<arrow::FloatArray>(array);
   }
 
 private:
@@ -22,12 +22,13 @@
 #include <deque>
 #include <type_traits>
 
-#include "katana/DynamicBitset.h"
 #include "katana/ErrorCode.h"
+#include "katana/Frontier.h"
 #include "katana/Result.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/RunStatistics.h"
 
 using namespace katana::analytics;
 
@@ -74,18 +75,6 @@ struct EdgeTileMaker {
   }
 };
 
-struct NodePushWrap {
-  template <typename C>
-  void operator()(C& cont, const GNode& n, const char* const /*tag*/) const {
-    (*this)(cont, n);
-  }
-
-  template <typename C>
-  void operator()(C& cont, const GNode& n) const {
-    cont.push(n);
-  }
-};
-
 struct EdgeTilePushWrap {
   Graph* graph;
   BfsImplementation& impl;
@@ -116,28 +105,6 @@ struct OneTilePushWrap {
   }
 };
 
-template <typename WL>
-void
-WlToBitset(const WL& wl, katana::DynamicBitset* bitset) {
-  katana::do_all(
-      katana::iterate(wl), [&](const GNode& src) { bitset->set(src); },
-      katana::chunk_size<kChunkSize>(), katana::loopname("WlToBitset"));
-}
-
-template <typename G, typename WL>
-void
-BitsetToWl(const G& graph, const katana::DynamicBitset& bitset, WL* wl) {
-  wl->clear();
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) {
-        if (bitset.test(src)) {
-          wl->push(src);
-        }
-      },
-      katana::chunk_size<kChunkSize>(), katana::loopname("BitsetToWl"));
-}
-
 template <typename T, typename P, typename R>
 void
 AsynchronousAlgo(
@@ -216,107 +183,71 @@ AsynchronousAlgo(
   }
 }
 
-template <typename P>
+/// Assigns BFS parents for EdgeMapPush and EdgeMapPull
+struct ParentOp {
+  katana::NUMAArray<GNode>* node_data;
+
+  bool Cond(GNode dst) const {
+    return (*node_data)[dst] == BfsImplementation::kDistanceInfinity;
+  }
+
+  bool Update(GNode src, GNode dst) {
+    (*node_data)[dst] = src;
+    return true;
+  }
+
+  bool UpdateAtomic(GNode src, GNode dst) {
+    return __sync_bool_compare_and_swap(
+        &(*node_data)[dst], BfsImplementation::kDistanceInfinity, src);
+  }
+};
+
 void
 SynchronousDirectOpt(
     const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_data,
-    const GNode source, const P& pushWrap, const uint32_t alpha,
-    const uint32_t beta) {
-  using Cont = katana::InsertBag<GNode>;
-  using Loop = katana::DoAll;
-
-  katana::GAccumulator<uint32_t> work_items;
+    const GNode source, const uint32_t alpha, const uint32_t beta) {
   katana::StatTimer bitset_to_wl_timer("Bitset_To_WL_Timer");
   katana::StatTimer wl_to_bitset_timer("WL_To_Bitset_Timer");
 
-  Loop loop;
-
-  katana::DynamicBitset front_bitset;
-  katana::DynamicBitset next_bitset;
-
   uint32_t num_nodes = bidir_view.NumNodes();
   uint64_t num_edges = bidir_view.NumEdges();
 
-  front_bitset.resize(num_nodes);
-  next_bitset.resize(num_nodes);
-
-  auto frontier = std::make_unique<Cont>();
-  auto next_frontier = std::make_unique<Cont>();
+  ParentOp op{node_data};
+  katana::Frontier frontier(num_nodes);
 
   (*node_data)[source] = source;
-
-  pushWrap(*next_frontier, source, "parallel");
-
-  work_items += 1;
+  frontier.Push(source);
 
   int64_t edges_to_check = num_edges;
   int64_t scout_count = bidir_view.OutDegree(source);
-  uint64_t old_num_work_items{0};
-
-  katana::GAccumulator<uint64_t> writes_pull;
-  katana::GAccumulator<uint64_t> writes_push;
 
-  while (!next_frontier->empty()) {
-    std::swap(frontier, next_frontier);
-    next_frontier->clear();
+  // Switch between push and pull with the heuristics of the GAP benchmark
+  // suite rather than those of katana::EdgeMap
+  while (!frontier.empty()) {
     if (scout_count > edges_to_check / alpha) {
       wl_to_bitset_timer.start();
-      WlToBitset(*frontier, &front_bitset);
+      frontier.ToDense();
       wl_to_bitset_timer.stop();
+      size_t num_work_items = frontier.size();
+      size_t old_num_work_items{0};
       do {
-        old_num_work_items = work_items.reduce();
-        work_items.reset();
-
-        loop(
-            katana::iterate(bidir_view),
-            [&](const GNode& dst) {
-              GNode& ddata = (*node_data)[dst];
-              if (ddata == BfsImplementation::kDistanceInfinity) {
-                for (auto e : bidir_view.InEdges(dst)) {
-                  auto src = bidir_view.InEdgeSrc(e);
-
-                  if (front_bitset.test(src)) {
-                    // assign parents on the bfs path.
-                    ddata = src;
-                    next_bitset.set(dst);
-                    work_items += 1;
-                    break;
-                  }
-                }
-              }
-            },
-            katana::steal(), katana::chunk_size<kChunkSize>(),
-            katana::loopname(std::string("SyncDO-pull").c_str()));
-        std::swap(front_bitset, next_bitset);
-        next_bitset.reset();
-      } while (work_items.reduce() >= old_num_work_items ||
-               (work_items.reduce() > num_nodes / beta));
+        old_num_work_items = num_work_items;
+        frontier = katana::EdgeMapPull(
+            bidir_view, &frontier, op, katana::chunk_size<kChunkSize>(),
+            katana::loopname("SyncDO-pull"));
+        num_work_items = frontier.size();
+      } while (num_work_items >= old_num_work_items ||
+               num_work_items > num_nodes / beta);
       bitset_to_wl_timer.start();
-      BitsetToWl(bidir_view, front_bitset, next_frontier.get());
+      frontier.ToSparse();
       bitset_to_wl_timer.stop();
       scout_count = 1;
     } else {
       edges_to_check -= scout_count;
-      work_items.reset();
-
-      loop(
-          katana::iterate(*frontier),
-          [&](const GNode& src) {
-            for (auto e : bidir_view.OutEdges(src)) {
-              auto dst = bidir_view.OutEdgeDst(e);
-              GNode& ddata = (*node_data)[dst];
-              if (ddata == BfsImplementation::kDistanceInfinity) {
-                GNode old_parent = ddata;
-                if (__sync_bool_compare_and_swap(&ddata, old_parent, src)) {
-                  next_frontier->push(dst);
-                  work_items += bidir_view.OutDegree(dst);
-                }
-              }
-            }
-          },
-          katana::steal(), katana::chunk_size<kChunkSize>(),
-          katana::loopname(std::string("SyncDO-push").c_str()));
-      scout_count = work_items.reduce();
+      frontier = katana::EdgeMapPush(
+          bidir_view, frontier, op, katana::chunk_size<kChunkSize>(),
+          katana::loopname("SyncDO-push"));
+      scout_count = frontier.OutDegreeSum(bidir_view);
     }
   }
 }
@@ -370,27 +301,30 @@ ComputeParentFromDistance(
 katana::Result<void>
 RunAlgo(
     BfsPlan algo, Graph* graph, const BiDirGraphView& bidir_view,
-    const GNode& source) {
+    const GNode& source, katana::analytics::RunRecorder* recorder) {
   BfsImplementation impl{algo.edge_tile_size()};
   katana::StatTimer exec_time("BFS");
 
   switch (algo.algorithm()) {
   case BfsPlan::kSynchronousDirectOpt: {
     // Set up node data
+    recorder->StartPhase(katana::analytics::kPhaseInit);
     katana::NUMAArray<GNode> node_data;
     node_data.allocateInterleaved(graph->NumNodes());
     InitNodeDataVec(BfsImplementation::kDistanceInfinity, &node_data);
 
+    recorder->StartPhase(katana::analytics::kPhaseMainLoop);
     exec_time.start();
     SynchronousDirectOpt(
-        bidir_view, &node_data, source, NodePushWrap(), algo.alpha(),
-        algo.beta());
+        bidir_view, &node_data, source, algo.alpha(), algo.beta());
     exec_time.stop();
 
+    recorder->StartPhase(katana::analytics::kPhaseOutput);
     UpdateGraphNodeData(graph, node_data);
     break;
   }
   case BfsPlan::kAsynchronous: {
+    recorder->StartPhase(katana::analytics::kPhaseInit);
     katana::NUMAArray<GNode> node_parent;
     katana::NUMAArray<Dist> node_dist;
     node_parent.allocateInterleaved(graph->NumNodes());
@@ -399,12 +333,14 @@ RunAlgo(
     InitNodeDataVec(BfsImplementation::kDistanceInfinity, &node_parent);
     InitNodeDataVec(BfsImplementation::kDistanceInfinity, &node_dist);
 
+    recorder->StartPhase(katana::analytics::kPhaseMainLoop);
     exec_time.start();
     AsynchronousAlgo<UpdateRequest>(
         *graph, source, &node_dist, ReqPushWrap(), OutEdgeRangeFn{graph});
     ComputeParentFromDistance(bidir_view, &node_parent, node_dist, source);
     exec_time.stop();
 
+    recorder->StartPhase(katana::analytics::kPhaseOutput);
     UpdateGraphNodeData(graph, node_parent);
     break;
   }
@@ -420,7 +356,7 @@ RunAlgo(
 katana::Result<void>
 BfsImpl(
     Graph* graph, const BiDirGraphView& bidir_view, size_t start_node,
-    BfsPlan algo) {
+    BfsPlan algo, katana::analytics::RunRecorder* recorder) {
   if (start_node >= graph->NumNodes()) {
     return katana::ErrorCode::InvalidArgument;
   }
@@ -440,7 +376,7 @@ BfsImpl(
   katana::EnsurePreallocated(8, approxNodeData);
   katana::ReportPageAllocGuard page_alloc;
 
-  if (auto res = RunAlgo(algo, graph, bidir_view, source); !res) {
+  if (auto res = RunAlgo(algo, graph, bidir_view, source, recorder); !res) {
     return res.error();
   }
 
@@ -454,15 +390,18 @@ katana::analytics::Bfs(
     PropertyGraph* pg, GNode start_node,
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     BfsPlan algo) {
+  katana::analytics::RunRecorder recorder("Bfs");
+  recorder.StartPhase(katana::analytics::kPhaseViewBuild);
   if (auto result = pg->ConstructNodeProperties<std::tuple<BfsNodeParent>>(
           txn_ctx, {output_property_name});
       !result) {
     return result.error();
   }
 
-  auto graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
-  auto bidir_view =
-      KATANA_CHECKED(BiDirGraphView::Make(pg, {output_property_name}, {}));
+  auto graph = KATANA_CHECKED(MakeGraphOfEdgeType<Graph>(
+      pg, algo.edge_type(), {output_property_name}, {}));
+  auto bidir_view = KATANA_CHECKED(MakeGraphOfEdgeType<BiDirGraphView>(
+      pg, algo.edge_type(), {output_property_name}, {}));
 
   /*
   auto pg_result = Graph::Make(pg, {output_property_name}, {});
@@ -471,7 +410,7 @@ katana::analytics::Bfs(
   }
   */
 
-  return BfsImpl(&graph, bidir_view, start_node, algo);
+  return BfsImpl(&graph, bidir_view, start_node, algo, &recorder);
 }
 
 template <typename LevelVec>
@@ -498,8 +437,10 @@ ComputeLevels(
     next->clear();
     ++next_level;
 
+    // split the frontier evenly; a few threads may have found most of it
+    auto frontier = curr->Blocks();
     loop(
-        katana::iterate(*curr),
+        katana::iterate(frontier),
         [&](const GNode& src) {
           for (auto e : graph.OutEdges(src)) {
             auto dest = graph.OutEdgeDst(e);
@@ -0,0 +1,325 @@
+#include "katana/analytics/bfs/bfs.h"
+
+#include <array>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// The number of searches that reach each node
+using MultiSourceBfsReach = katana::PODProperty<uint32_t>;
+
+using Graph = katana::TypedPropertyGraph<
+    std::tuple<MultiSourceBfsReach>, std::tuple<>>;
+using GNode = Graph::Node;
+
+/// MS-BFS: the searches of a batch are bit lanes of the per node sets seen,
+/// visit (the current frontier) and next (the next frontier). Each level
+/// scans the edges of every node in some frontier once for all lanes.
+template <size_t kWords>
+class BitParallelBfs {
+  static constexpr size_t kLanes = 64 * kWords;
+  using Lanes = std::array<uint64_t, kWords>;
+
+  const Graph& graph_;
+  katana::NUMAArray<Lanes> seen_;
+  katana::NUMAArray<Lanes> visit_;
+  katana::NUMAArray<Lanes> next_;
+  /// nodes each lane found in the current level
+  katana::PerThreadStorage<std::array<uint64_t, kLanes>> found_;
+
+  void Expand() {
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](const GNode& u) {
+          const Lanes& visit = visit_[u];
+          bool any = false;
+          for (uint64_t word : visit) {
+            any |= word != 0;
+          }
+          if (!any) {
+            return;
+          }
+          for (auto e : graph_.OutEdges(u)) {
+            auto v = graph_.OutEdgeDst(e);
+            const Lanes& seen = seen_[v];
+            Lanes& next = next_[v];
+            for (size_t w = 0; w < kWords; ++w) {
+              uint64_t bits = visit[w] & ~seen[w];
+              if ((bits & ~__atomic_load_n(&next[w], __ATOMIC_RELAXED)) != 0) {
+                __atomic_fetch_or(&next[w], bits, __ATOMIC_RELAXED);
+              }
+            }
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("MultiSourceBfs-Expand"));
+  }
+
+  void Advance() {
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](const GNode& v) {
+          Lanes& seen = seen_[v];
+          Lanes& visit = visit_[v];
+          Lanes& next = next_[v];
+          auto& found = *found_.getLocal();
+          for (size_t w = 0; w < kWords; ++w) {
+            uint64_t fresh = next[w] & ~seen[w];
+            next[w] = 0;
+            visit[w] = fresh;
+            seen[w] |= fresh;
+            for (; fresh; fresh &= fresh - 1) {
+              found[w * 64 + __builtin_ctzll(fresh)] += 1;
+            }
+          }
+        },
+        katana::no_stats(), katana::loopname("MultiSourceBfs-Advance"));
+  }
+
+public:
+  explicit BitParallelBfs(const Graph& graph) : graph_(graph) {
+    seen_.allocateBlocked(graph.NumNodes());
+    visit_.allocateBlocked(graph.NumNodes());
+    next_.allocateBlocked(graph.NumNodes());
+  }
+
+  /// Run the searches from sources [0, num) and record their statistics at
+  /// offset onwards; add the searches reaching each node to its property
+  void Run(
+      Graph* graph, const uint32_t* sources, size_t num, size_t offset,
+      MultiSourceBfsStatistics* stats) {
+    KATANA_LOG_DEBUG_ASSERT(num <= kLanes);
+    katana::ParallelSTL::fill(seen_.begin(), seen_.end(), Lanes{});
+    katana::ParallelSTL::fill(visit_.begin(), visit_.end(), Lanes{});
+    katana::ParallelSTL::fill(next_.begin(), next_.end(), Lanes{});
+    for (unsigned t = 0; t < found_.size(); ++t) {
+      found_.getRemote(t)->fill(0);
+    }
+
+    for (size_t l = 0; l < num; ++l) {
+      uint64_t bit = uint64_t{1} << (l % 64);
+      seen_[sources[l]][l / 64] |= bit;
+      visit_[sources[l]][l / 64] |= bit;
+      stats->n_reached_nodes[offset + l] = 1;
+    }
+
+    for (uint32_t level = 1;; ++level) {
+      Expand();
+      Advance();
+
+      bool any = false;
+      for (unsigned t = 0; t < found_.size(); ++t) {
+        auto& found = *found_.getRemote(t);
+        for (size_t l = 0; l < num; ++l) {
+          if (found[l] == 0) {
+            continue;
+          }
+          stats->n_reached_nodes[offset + l] += found[l];
+          stats->level_sums[offset + l] += found[l] * level;
+          stats->max_levels[offset + l] = level;
+          found[l] = 0;
+          any = true;
+        }
+      }
+      if (!any) {
+        break;
+      }
+    }
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& v) {
+          uint32_t reached = 0;
+          for (uint64_t word : seen_[v]) {
+            reached += __builtin_popcountll(word);
+          }
+          graph->GetData<MultiSourceBfsReach>(v) += reached;
+        },
+        katana::no_stats(), katana::loopname("MultiSourceBfs-Reach"));
+  }
+};
+
+template <size_t kWords>
+void
+RunBatches(
+    Graph* graph, const std::vector<uint32_t>& sources,
+    MultiSourceBfsStatistics* stats) {
+  constexpr size_t kLanes = 64 * kWords;
+  BitParallelBfs<kWords> bfs(*graph);
+  for (size_t offset = 0; offset < sources.size(); offset += kLanes) {
+    size_t num = std::min(kLanes, sources.size() - offset);
+    bfs.Run(graph, &sources[offset], num, offset, stats);
+  }
+}
+
+void
+RunAlgo(
+    Graph* graph, const std::vector<uint32_t>& sources,
+    MultiSourceBfsPlan plan, MultiSourceBfsStatistics* stats) {
+  switch (plan.batch_size() / 64) {
+  case 1:
+    RunBatches<1>(graph, sources, stats);
+    break;
+  case 2:
+    RunBatches<2>(graph, sources, stats);
+    break;
+  case 3:
+    RunBatches<3>(graph, sources, stats);
+    break;
+  case 4:
+    RunBatches<4>(graph, sources, stats);
+    break;
+  case 5:
+    RunBatches<5>(graph, sources, stats);
+    break;
+  case 6:
+    RunBatches<6>(graph, sources, stats);
+    break;
+  case 7:
+    RunBatches<7>(graph, sources, stats);
+    break;
+  case 8:
+    RunBatches<8>(graph, sources, stats);
+    break;
+  default:
+    KATANA_LOG_FATAL("unexpected batch size {}", plan.batch_size());
+  }
+}
+
+}  // namespace
+
+katana::Result<MultiSourceBfsStatistics>
+katana::analytics::MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MultiSourceBfsPlan plan) {
+  if (plan.algorithm() != MultiSourceBfsPlan::kBitParallel) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm {}",
+        plan.algorithm());
+  }
+  if (plan.batch_size() == 0 || plan.batch_size() % 64 != 0 ||
+      plan.batch_size() > MultiSourceBfsPlan::kMaxBatchSize) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "batch size {} must be a multiple of 64 up to {}", plan.batch_size(),
+        MultiSourceBfsPlan::kMaxBatchSize);
+  }
+  for (uint32_t source : sources) {
+    if (source >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          source);
+    }
+  }
+
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<std::tuple<MultiSourceBfsReach>>(
+          txn_ctx, {output_property_name}));
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& v) { graph.GetData<MultiSourceBfsReach>(v) = 0; },
+      katana::no_stats());
+
+  MultiSourceBfsStatistics stats;
+  stats.n_reached_nodes.resize(sources.size());
+  stats.level_sums.resize(sources.size());
+  stats.max_levels.resize(sources.size());
+
+  katana::StatTimer exec_time("MultiSourceBfs");
+  exec_time.start();
+  RunAlgo(&graph, sources, plan, &stats);
+  exec_time.stop();
+
+  return stats;
+}
+
+katana::Result<void>
+katana::analytics::MultiSourceBfsAssertValid(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& property_name) {
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+
+  std::vector<uint32_t> reach(graph.NumNodes());
+  katana::DynamicBitset seen;
+  seen.resize(graph.NumNodes());
+  katana::InsertBag<GNode> current;
+  katana::InsertBag<GNode> next;
+  for (uint32_t source : sources) {
+    if (source >= graph.NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          source);
+    }
+    seen.reset();
+    seen.set(source);
+    next.push(source);
+    while (!next.empty()) {
+      current.swap(next);
+      next.clear();
+      katana::do_all(
+          katana::iterate(current),
+          [&](const GNode& u) {
+            for (auto e : graph.OutEdges(u)) {
+              auto v = graph.OutEdgeDst(e);
+              if (!seen.set(v)) {
+                next.push(v);
+              }
+            }
+          },
+          katana::steal(), katana::no_stats());
+    }
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& v) {
+          if (seen.test(v)) {
+            reach[v] += 1;
+          }
+        },
+        katana::no_stats());
+  }
+
+  for (GNode v : graph) {
+    uint32_t found = graph.GetData<MultiSourceBfsReach>(v);
+    if (found != reach[v]) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "node {} is reached by {} searches, expected {}", v, found,
+          reach[v]);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+double
+katana::analytics::MultiSourceBfsStatistics::Closeness(size_t i) const {
+  if (level_sums[i] == 0) {
+    return 0;
+  }
+  return static_cast<double>(n_reached_nodes[i] - 1) / level_sums[i];
+}
+
+void
+katana::analytics::MultiSourceBfsStatistics::Print(std::ostream& os) const {
+  os << "Number of sources = " << n_reached_nodes.size() << std::endl;
+  for (size_t i = 0; i < n_reached_nodes.size(); ++i) {
+    os << "Source " << i << ": reached nodes = " << n_reached_nodes[i]
+       << ", max level = " << max_levels[i]
+       << ", closeness = " << Closeness(i) << std::endl;
+  }
+}
@@ -0,0 +1,431 @@
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
+
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/ErrorCode.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/RunStatistics.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+struct BipartiteMatchingPartner : public katana::PODProperty<uint32_t> {};
+
+using Graph = katana::TypedPropertyGraph<
+    std::tuple<BipartiteMatchingPartner>, std::tuple<>>;
+
+constexpr uint32_t kUnmatched = std::numeric_limits<uint32_t>::max();
+
+/// The right neighbors of each left node, from its out-edges and in-edges.
+/// Right nodes have none.
+struct BipartiteAdjacency {
+  std::vector<uint8_t> is_left;
+  std::vector<uint64_t> begin;
+  std::vector<uint32_t> dst;
+
+  uint32_t NumNodes() const { return is_left.size(); }
+};
+
+/// Pothen-Fan with lookahead and fairness on a bipartite adjacency
+class PothenFan {
+public:
+  explicit PothenFan(const BipartiteAdjacency& adjacency)
+      : adj_(adjacency),
+        mate_(adjacency.NumNodes(), kUnmatched),
+        lookahead_(adjacency.begin.begin(), adjacency.begin.end() - 1),
+        visited_(adjacency.NumNodes(), 0),
+        cursor_(adjacency.NumNodes(), 0) {}
+
+  const std::vector<uint32_t>& Run(katana::analytics::RunRecorder* recorder) {
+    GreedyMatch();
+
+    katana::InsertBag<uint32_t> unmatched;
+    CollectUnmatched(&unmatched);
+    uint32_t phase = 0;
+    bool forward = true;
+    while (!unmatched.empty()) {
+      ++phase;
+      katana::GAccumulator<uint64_t> augmented;
+      katana::do_all(
+          katana::iterate(unmatched),
+          [&](uint32_t node) {
+            if (Augment(node, phase, forward)) {
+              augmented += 1;
+            }
+          },
+          katana::steal(), katana::loopname("BipartiteMatching Augment"));
+      recorder->AddWorkItems(unmatched.size());
+      if (augmented.reduce() == 0) {
+        break;
+      }
+      CollectUnmatched(&unmatched);
+      forward = !forward;
+    }
+    recorder->AddIterations(phase);
+    katana::ReportStatSingle("BipartiteMatching", "Phases", phase);
+    return mate_;
+  }
+
+private:
+  /// The left nodes of the current search path and the right nodes
+  /// between them
+  struct SearchStack {
+    std::vector<uint32_t> left;
+    std::vector<uint32_t> right;
+  };
+
+  /// Match each left node to its first unmatched right neighbor, if any
+  void GreedyMatch() {
+    katana::do_all(
+        katana::iterate(uint32_t{0}, adj_.NumNodes()),
+        [&](uint32_t node) {
+          for (uint64_t arc = adj_.begin[node]; arc < adj_.begin[node + 1];
+               ++arc) {
+            uint32_t dst = adj_.dst[arc];
+            uint32_t expected = kUnmatched;
+            if (__atomic_load_n(&mate_[dst], __ATOMIC_RELAXED) == kUnmatched &&
+                __atomic_compare_exchange_n(
+                    &mate_[dst], &expected, node, false, __ATOMIC_RELAXED,
+                    __ATOMIC_RELAXED)) {
+              mate_[node] = dst;
+              lookahead_[node] = arc + 1;
+              return;
+            }
+          }
+        },
+        katana::steal(), katana::loopname("BipartiteMatching Greedy"));
+  }
+
+  void CollectUnmatched(katana::InsertBag<uint32_t>* unmatched) {
+    unmatched->clear();
+    katana::do_all(
+        katana::iterate(uint32_t{0}, adj_.NumNodes()),
+        [&](uint32_t node) {
+          if (adj_.is_left[node] && mate_[node] == kUnmatched &&
+              adj_.begin[node] < adj_.begin[node + 1]) {
+            unmatched->emplace(node);
+          }
+        },
+        katana::loopname("BipartiteMatching Unmatched"), katana::no_stats());
+  }
+
+  /// Claim right node for a search of this phase
+  bool Claim(uint32_t right, uint32_t phase) {
+    return __atomic_exchange_n(&visited_[right], phase, __ATOMIC_RELAXED) !=
+           phase;
+  }
+
+  /// Search for an augmenting path from the unmatched left node root and
+  /// augment the matching along it. Returns whether a path was found.
+  bool Augment(uint32_t root, uint32_t phase, bool forward) {
+    SearchStack& search = *stacks_.getLocal();
+    search.left.clear();
+    search.right.clear();
+    search.left.emplace_back(root);
+    cursor_[root] = 0;
+
+    while (!search.left.empty()) {
+      uint32_t node = search.left.back();
+      uint64_t begin = adj_.begin[node];
+      uint64_t end = adj_.begin[node + 1];
+
+      // Lookahead: right nodes only ever become matched, so each left node
+      // looks at each of its right neighbors once over all phases
+      for (; lookahead_[node] < end; ++lookahead_[node]) {
+        uint32_t dst = adj_.dst[lookahead_[node]];
+        if (__atomic_load_n(&mate_[dst], __ATOMIC_RELAXED) == kUnmatched &&
+            Claim(dst, phase)) {
+          ++lookahead_[node];
+          search.right.emplace_back(dst);
+          Flip(search);
+          return true;
+        }
+      }
+
+      bool descended = false;
+      while (cursor_[node] < end - begin) {
+        uint64_t offset = cursor_[node]++;
+        uint32_t dst = adj_.dst[forward ? begin + offset : end - 1 - offset];
+        if (!Claim(dst, phase)) {
+          continue;
+        }
+        uint32_t mate = __atomic_load_n(&mate_[dst], __ATOMIC_RELAXED);
+        search.right.emplace_back(dst);
+        if (mate == kUnmatched) {
+          Flip(search);
+          return true;
+        }
+        // mate is reached only through dst, which this search claimed
+        cursor_[mate] = 0;
+        search.left.emplace_back(mate);
+        descended = true;
+        break;
+      }
+      if (!descended) {
+        search.left.pop_back();
+        if (!search.right.empty()) {
+          search.right.pop_back();
+        }
+      }
+    }
+    return false;
+  }
+
+  /// Match the i-th left node of an augmenting path to its i-th right node
+  void Flip(const SearchStack& search) {
+    for (size_t i = 0; i < search.left.size(); ++i) {
+      uint32_t left = search.left[i];
+      uint32_t right = search.right[i];
+      __atomic_store_n(&mate_[left], right, __ATOMIC_RELAXED);
+      __atomic_store_n(&mate_[right], left, __ATOMIC_RELAXED);
+    }
+  }
+
+  const BipartiteAdjacency& adj_;
+  std::vector<uint32_t> mate_;
+  /// The next arc each left node looks ahead at
+  std::vector<uint64_t> lookahead_;
+  /// The last phase that claimed each right node
+  std::vector<uint32_t> visited_;
+  /// The arcs each left node on a search path has searched in this phase
+  std::vector<uint64_t> cursor_;
+  katana::PerThreadStorage<SearchStack> stacks_;
+};
+
+katana::Result<BipartiteAdjacency>
+BuildAdjacency(katana::PropertyGraph* pg, const std::string& left_node_type) {
+  if (!pg->GetNodeTypeManager().HasAtomicType(left_node_type)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "Node type: {} Not found",
+        left_node_type);
+  }
+  uint32_t num_nodes = pg->NumNodes();
+  BipartiteAdjacency adj;
+  adj.is_left.resize(num_nodes);
+  pg->DoNodesHaveType(
+      0, num_nodes, pg->GetNodeEntityTypeID(left_node_type),
+      adj.is_left.data());
+
+  auto transposed = pg->BuildView<katana::PropertyGraphViews::Transposed>();
+  const auto& topology = pg->topology();
+  adj.begin.resize(num_nodes + 1, 0);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t node) {
+        if (!adj.is_left[node]) {
+          return;
+        }
+        uint64_t degree = 0;
+        for (auto e : topology.OutEdges(node)) {
+          degree += !adj.is_left[topology.OutEdgeDst(e)];
+        }
+        for (auto e : transposed.OutEdges(node)) {
+          degree += !adj.is_left[transposed.OutEdgeDst(e)];
+        }
+        adj.begin[node + 1] = degree;
+      },
+      katana::steal(), katana::loopname("BipartiteMatching Degrees"));
+  katana::ParallelSTL::partial_sum(
+      adj.begin.begin(), adj.begin.end(), adj.begin.begin());
+
+  adj.dst.resize(adj.begin[num_nodes]);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t node) {
+        uint64_t arc = adj.begin[node];
+        if (arc == adj.begin[node + 1]) {
+          return;
+        }
+        for (auto e : topology.OutEdges(node)) {
+          uint32_t dst = topology.OutEdgeDst(e);
+          if (!adj.is_left[dst]) {
+            adj.dst[arc++] = dst;
+          }
+        }
+        for (auto e : transposed.OutEdges(node)) {
+          uint32_t dst = transposed.OutEdgeDst(e);
+          if (!adj.is_left[dst]) {
+            adj.dst[arc++] = dst;
+          }
+        }
+      },
+      katana::steal(), katana::loopname("BipartiteMatching Adjacency"));
+  return adj;
+}
+
+katana::Result<void>
+BipartiteMatchingWithWrap(
+    katana::PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx) {
+  katana::analytics::RunRecorder recorder("BipartiteMatching");
+  recorder.StartPhase(katana::analytics::kPhaseViewBuild);
+  // Check the type before creating the output
+  BipartiteAdjacency adj = KATANA_CHECKED(BuildAdjacency(pg, left_node_type));
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<std::tuple<BipartiteMatchingPartner>>(
+          txn_ctx, {output_property_name}));
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  recorder.StartPhase(katana::analytics::kPhaseMainLoop);
+  katana::StatTimer exec_time("BipartiteMatching");
+  exec_time.start();
+  PothenFan pothen_fan(adj);
+  const std::vector<uint32_t>& mate = pothen_fan.Run(&recorder);
+  exec_time.stop();
+
+  recorder.StartPhase(katana::analytics::kPhaseOutput);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Graph::Node& node) {
+        graph.GetData<BipartiteMatchingPartner>(node) = mate[node];
+      },
+      katana::loopname("BipartiteMatching Output"), katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+/// What AssertValid and Statistics need to know about a matching
+struct MatchingSummary {
+  uint64_t num_left_nodes{0};
+  uint64_t num_matched{0};
+  /// The number of nodes whose partner is not theirs, is on the same side
+  /// or is not a neighbor
+  uint64_t invalid_partners{0};
+  /// Whether an alternating path joins an unmatched left node to an
+  /// unmatched right node
+  bool has_augmenting_path{false};
+};
+
+katana::Result<MatchingSummary>
+Summarize(
+    katana::PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& output_property_name, bool with_augmenting_path) {
+  BipartiteAdjacency adj = KATANA_CHECKED(BuildAdjacency(pg, left_node_type));
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+  MatchingSummary summary;
+  std::vector<uint32_t> mate(adj.NumNodes());
+  for (uint32_t node = 0; node < adj.NumNodes(); ++node) {
+    mate[node] = graph.GetData<BipartiteMatchingPartner>(node);
+  }
+
+  for (uint32_t node = 0; node < adj.NumNodes(); ++node) {
+    if (adj.is_left[node]) {
+      ++summary.num_left_nodes;
+    }
+    uint32_t partner = mate[node];
+    if (partner == kUnmatched) {
+      continue;
+    }
+    if (partner >= adj.NumNodes() || mate[partner] != node ||
+        adj.is_left[partner] == adj.is_left[node]) {
+      ++summary.invalid_partners;
+      continue;
+    }
+    if (!adj.is_left[node]) {
+      continue;
+    }
+    ++summary.num_matched;
+    bool adjacent = false;
+    for (uint64_t arc = adj.begin[node]; arc < adj.begin[node + 1]; ++arc) {
+      adjacent |= adj.dst[arc] == partner;
+    }
+    if (!adjacent) {
+      ++summary.invalid_partners;
+    }
+  }
+  if (!with_augmenting_path || summary.invalid_partners != 0) {
+    return summary;
+  }
+
+  // Alternating breadth first search from all unmatched left nodes
+  std::vector<bool> reached(adj.NumNodes(), false);
+  std::deque<uint32_t> queue;
+  for (uint32_t node = 0; node < adj.NumNodes(); ++node) {
+    if (adj.is_left[node] && mate[node] == kUnmatched) {
+      reached[node] = true;
+      queue.emplace_back(node);
+    }
+  }
+  while (!queue.empty() && !summary.has_augmenting_path) {
+    uint32_t node = queue.front();
+    queue.pop_front();
+    for (uint64_t arc = adj.begin[node]; arc < adj.begin[node + 1]; ++arc) {
+      uint32_t dst = adj.dst[arc];
+      if (reached[dst]) {
+        continue;
+      }
+      reached[dst] = true;
+      if (mate[dst] == kUnmatched) {
+        summary.has_augmenting_path = true;
+        break;
+      }
+      if (!reached[mate[dst]]) {
+        reached[mate[dst]] = true;
+        queue.emplace_back(mate[dst]);
+      }
+    }
+  }
+  return summary;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::BipartiteMatching(
+    katana::PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    BipartiteMatchingPlan plan) {
+  switch (plan.algorithm()) {
+  case BipartiteMatchingPlan::kPothenFan:
+    return BipartiteMatchingWithWrap(
+        pg, left_node_type, output_property_name, txn_ctx);
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+}
+
+/// \cond DO_NOT_DOCUMENT
+katana::Result<void>
+katana::analytics::BipartiteMatchingAssertValid(
+    katana::PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& output_property_name) {
+  MatchingSummary summary = KATANA_CHECKED(
+      Summarize(pg, left_node_type, output_property_name, true));
+  if (summary.invalid_partners != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "{} nodes have invalid partners",
+        summary.invalid_partners);
+  }
+  if (summary.has_augmenting_path) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the matching leaves an augmenting path");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<BipartiteMatchingStatistics>
+katana::analytics::BipartiteMatchingStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& output_property_name) {
+  MatchingSummary summary = KATANA_CHECKED(
+      Summarize(pg, left_node_type, output_property_name, false));
+  return BipartiteMatchingStatistics{
+      summary.num_left_nodes, pg->NumNodes() - summary.num_left_nodes,
+      summary.num_matched};
+}
+
+void
+katana::analytics::BipartiteMatchingStatistics::Print(std::ostream& os) const {
+  os << "Number of left nodes = " << num_left_nodes << std::endl;
+  os << "Number of right nodes = " << num_right_nodes << std::endl;
+  os << "Number of matched pairs = " << num_matched << std::endl;
+}
+/// \endcond DO_NOT_DOCUMENT
@@ -22,7 +22,10 @@
 #include <boost/unordered_map.hpp>
 
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/BatchedGather.h"
+#include "katana/Frontier.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/RunStatistics.h"
 
 using namespace katana::analytics;
 
@@ -40,73 +43,100 @@ struct CdlpAlgo {
   using Graph = katana::TypedPropertyGraphView<GraphViewTy, NodeData, EdgeData>;
   using GNode = typename Graph::Node;
 
+  struct NodeDataPair {
+    GNode node;
+    CommunityType data;
+    NodeDataPair(GNode node, CommunityType data) : node(node), data(data) {}
+  };
+
   void Initialize(Graph* graph) {
     katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
       graph->template GetData<NodeCommunity>(node) = node;
     });
   }
-  virtual void operator()(Graph* graph, size_t max_iterations) = 0;
+
+  /// Gather phase for node: pushes the most frequent community among its
+  /// neighbors to apply_bag if it is not the community of node already
+  ///
+  /// @returns true if it pushed a new community
+  static bool Gather(
+      Graph* graph, const GNode& node,
+      katana::InsertBag<NodeDataPair>* apply_bag) {
+    const auto ndata_current_comm =
+        graph->template GetData<NodeCommunity>(node);
+    using Histogram_type = boost::unordered_map<CommunityType, size_t>;
+    Histogram_type histogram;
+    // Iterate over all neighbors (this is undirected view); their
+    // communities are read at random, so they are prefetched in batches
+    katana::GatherBatched(
+        Edges(*graph, node), [&](auto e) { return EdgeDst(*graph, e); },
+        [&](auto neighbor) {
+          return &graph->template GetData<NodeCommunity>(neighbor);
+        },
+        [&](auto, auto neighbor) {
+          histogram[graph->template GetData<NodeCommunity>(neighbor)]++;
+        });
+
+    // Pick the most frequent community as the new community for node
+    // pick the smallest one if more than one max frequent exist.
+    auto ndata_new_comm = ndata_current_comm;
+    size_t best_freq = 0;
+    for (const auto& [comm, freq] : histogram) {
+      if (freq > best_freq || (freq == best_freq && comm < ndata_new_comm)) {
+        ndata_new_comm = comm;
+        best_freq = freq;
+      }
+    }
+
+    if (ndata_new_comm == ndata_current_comm)
+      return false;
+    apply_bag->push(NodeDataPair(node, (CommunityType)ndata_new_comm));
+    return true;
+  }
+
+  virtual void operator()(
+      Graph* graph, size_t max_iterations,
+      std::vector<uint64_t>* changed_per_iteration) = 0;
 };
 
 template <typename GraphViewTy>
 struct CdlpSynchronousAlgo : CdlpAlgo<GraphViewTy> {
-  using Graph = typename CdlpAlgo<GraphViewTy>::Graph;
-  using GNode = typename CdlpAlgo<GraphViewTy>::GNode;
-  using CommunityType = typename CdlpAlgo<GraphViewTy>::CommunityType;
-  using NodeCommunity = typename CdlpAlgo<GraphViewTy>::NodeCommunity;
-
-  void operator()(Graph* graph, size_t max_iterations = kMaxIterations) {
+  using Base = CdlpAlgo<GraphViewTy>;
+  using Graph = typename Base::Graph;
+  using GNode = typename Base::GNode;
+  using NodeCommunity = typename Base::NodeCommunity;
+  using NodeDataPair = typename Base::NodeDataPair;
+
+  static constexpr char kName[] = "CdlpSynchronous";
+
+  void operator()(
+      Graph* graph, size_t max_iterations,
+      std::vector<uint64_t>* changed_per_iteration,
+      katana::analytics::RunRecorder* recorder) {
     if (max_iterations == 0)
       return;
 
-    struct NodeDataPair {
-      GNode node;
-      CommunityType data;
-      NodeDataPair(GNode node, CommunityType data) : node(node), data(data) {}
-    };
-
     size_t iterations = 0;
     katana::InsertBag<NodeDataPair> apply_bag;
 
-    /// TODO (Yasin): in this implementation, in each iteration, all the nodes are active
-    /// for gather phase. If InsertBag does not accept duplicate items then this
-    /// can be improved to have only the affected nodes to be active in next iteration
+    /// In each iteration all the nodes are active for the gather phase;
+    /// CdlpFrontierAlgo only visits the affected ones
     while (iterations < max_iterations) {
       // Gather Phase
+      katana::GAccumulator<uint64_t> changed;
       katana::do_all(
           katana::iterate(*graph),
           [&](const GNode& node) {
-            const auto ndata_current_comm =
-                graph->template GetData<NodeCommunity>(node);
-            using Histogram_type = boost::unordered_map<CommunityType, size_t>;
-            Histogram_type histogram;
-            // Iterate over all neighbors (this is undirected view)
-            for (auto e : Edges(*graph, node)) {
-              auto neighbor = EdgeDst(*graph, e);
-              const auto neighbor_data =
-                  graph->template GetData<NodeCommunity>(neighbor);
-              histogram[neighbor_data]++;
-            }
-
-            // Pick the most frequent community as the new community for node
-            // pick the smallest one if more than one max frequent exist.
-            auto ndata_new_comm = ndata_current_comm;
-            size_t best_freq = 0;
-            for (const auto& [comm, freq] : histogram) {
-              if (freq > best_freq ||
-                  (freq == best_freq && comm < ndata_new_comm)) {
-                ndata_new_comm = comm;
-                best_freq = freq;
-              }
+            if (Base::Gather(graph, node, &apply_bag)) {
+              changed += 1;
             }
-
-            if (ndata_new_comm != ndata_current_comm)
-              apply_bag.push(NodeDataPair(node, (CommunityType)ndata_new_comm));
           },
           katana::loopname("CDLP_Gather"));
 
+      uint64_t num_changed = changed.reduce();
+      changed_per_iteration->push_back(num_changed);
       // No change! break!
-      if (apply_bag.empty())
+      if (num_changed == 0)
         break;
 
       // Apply Phase
@@ -122,13 +152,98 @@ struct CdlpSynchronousAlgo : CdlpAlgo<GraphViewTy> {
       iterations += 1;
     }
     katana::ReportStatSingle("CDLP_Synchronous", "iterations", iterations);
+    recorder->AddIterations(iterations);
+    recorder->AddWorkItems(changed_per_iteration->size() * graph->NumNodes());
   }
 };
 
 template <typename GraphViewTy>
 struct CdlpAsynchronousAlgo : CdlpAlgo<GraphViewTy> {
   using Graph = typename CdlpAlgo<GraphViewTy>::Graph;
-  void operator()(Graph*, size_t) {}
+
+  static constexpr char kName[] = "CdlpAsynchronous";
+
+  void operator()(
+      Graph*, size_t, std::vector<uint64_t>*, katana::analytics::RunRecorder*) {
+  }
+};
+
+/// Synchronous label propagation over a frontier: the gather phase of an
+/// iteration only visits the neighbors of the nodes whose label changed in
+/// the one before, as the labels around every other node are the same as
+/// when it last picked its own. The views are undirected, so the neighbors
+/// of a node are also the nodes that have it as a neighbor.
+template <typename GraphViewTy>
+struct CdlpFrontierAlgo : CdlpAlgo<GraphViewTy> {
+  using Base = CdlpAlgo<GraphViewTy>;
+  using Graph = typename Base::Graph;
+  using GNode = typename Base::GNode;
+  using NodeCommunity = typename Base::NodeCommunity;
+  using NodeDataPair = typename Base::NodeDataPair;
+
+  static constexpr char kName[] = "CdlpFrontier";
+
+  void operator()(
+      Graph* graph, size_t max_iterations,
+      std::vector<uint64_t>* changed_per_iteration,
+      katana::analytics::RunRecorder* recorder) {
+    if (max_iterations == 0)
+      return;
+
+    size_t iterations = 0;
+    uint64_t visited = 0;
+    katana::InsertBag<NodeDataPair> apply_bag;
+    // The next frontier is filled as a bitset, which drops the neighbors
+    // pushed by several changed nodes, and shrinks to a bag when small
+    katana::Frontier frontier(graph->NumNodes());
+    katana::Frontier next_frontier(graph->NumNodes(), true);
+
+    while (iterations < max_iterations) {
+      // Gather Phase
+      katana::GAccumulator<uint64_t> changed;
+      auto gather = [&](const GNode& node) {
+        if (Base::Gather(graph, node, &apply_bag)) {
+          changed += 1;
+        }
+      };
+      if (iterations == 0) {
+        katana::do_all(
+            katana::iterate(*graph), gather, katana::loopname("CDLP_Gather"));
+        visited += graph->NumNodes();
+      } else {
+        visited += frontier.size();
+        frontier.ForEach(gather, katana::loopname("CDLP_Gather"));
+      }
+
+      uint64_t num_changed = changed.reduce();
+      changed_per_iteration->push_back(num_changed);
+      if (num_changed == 0)
+        break;
+
+      // Apply Phase, which also activates the neighbors of changed nodes
+      katana::do_all(
+          katana::iterate(apply_bag),
+          [&](const NodeDataPair node_data) {
+            GNode node = node_data.node;
+            graph->template GetData<NodeCommunity>(node) = node_data.data;
+            for (auto e : Edges(*graph, node)) {
+              next_frontier.Push(EdgeDst(*graph, e));
+            }
+          },
+          katana::steal(), katana::loopname("CDLP_Apply"));
+
+      apply_bag.clear();
+      next_frontier.Adapt();
+      frontier.swap(next_frontier);
+      next_frontier.Clear();
+      next_frontier.ToDense();
+      iterations += 1;
+    }
+    katana::ReportStatSingle("CDLP_Frontier", "iterations", iterations);
+    katana::ReportStatSingle("CDLP_Frontier", "visited_nodes", visited);
+    recorder->AddIterations(iterations);
+    recorder->AddWorkItems(visited);
+  }
 };
 
 }  //namespace
@@ -137,7 +252,10 @@ template <typename Algorithm>
 static katana::Result<void>
 CdlpWithWrap(
     katana::PropertyGraph* pg, std::string output_property_name,
-    size_t max_iterations, katana::TxnContext* txn_ctx) {
+    size_t max_iterations, katana::TxnContext* txn_ctx,
+    std::vector<uint64_t>* changed_per_iteration) {
+  katana::analytics::RunRecorder recorder(Algorithm::kName);
+  recorder.StartPhase(katana::analytics::kPhaseViewBuild);
   katana::EnsurePreallocated(
       2, pg->topology().NumNodes() * sizeof(typename Algorithm::NodeCommunity));
   katana::ReportPageAllocGuard page_alloc;
@@ -154,16 +272,23 @@ CdlpWithWrap(
   }
   auto graph = pg_result.value();
 
+  recorder.StartPhase(katana::analytics::kPhaseInit);
   Algorithm algo;
 
   algo.Initialize(&graph);
 
   katana::StatTimer execTime("CDLP");
 
+  recorder.StartPhase(katana::analytics::kPhaseMainLoop);
+  std::vector<uint64_t> changed;
   execTime.start();
-  algo(&graph, max_iterations);
+  algo(&graph, max_iterations, &changed, &recorder);
   execTime.stop();
 
+  if (changed_per_iteration) {
+    *changed_per_iteration = std::move(changed);
+  }
+
   return katana::ResultSuccess();
 }
 
@@ -171,17 +296,31 @@ katana::Result<void>
 katana::analytics::Cdlp(
     PropertyGraph* pg, const std::string& output_property_name,
     size_t max_iterations, katana::TxnContext* txn_ctx,
-    const bool& is_symmetric, CdlpPlan plan) {
+    const bool& is_symmetric, CdlpPlan plan,
+    std::vector<uint64_t>* changed_per_iteration) {
   switch (plan.algorithm()) {
   case CdlpPlan::kSynchronous:
     if (is_symmetric)
       return CdlpWithWrap<
           CdlpSynchronousAlgo<katana::PropertyGraphViews::Default>>(
-          pg, output_property_name, max_iterations, txn_ctx);
+          pg, output_property_name, max_iterations, txn_ctx,
+          changed_per_iteration);
     else
       return CdlpWithWrap<
           CdlpSynchronousAlgo<katana::PropertyGraphViews::Undirected>>(
-          pg, output_property_name, max_iterations, txn_ctx);
+          pg, output_property_name, max_iterations, txn_ctx,
+          changed_per_iteration);
+  case CdlpPlan::kFrontier:
+    if (is_symmetric)
+      return CdlpWithWrap<
+          CdlpFrontierAlgo<katana::PropertyGraphViews::Default>>(
+          pg, output_property_name, max_iterations, txn_ctx,
+          changed_per_iteration);
+    else
+      return CdlpWithWrap<
+          CdlpFrontierAlgo<katana::PropertyGraphViews::Undirected>>(
+          pg, output_property_name, max_iterations, txn_ctx,
+          changed_per_iteration);
   /// TODO (Yasin): Asynchronous Algorithm will be implemented later after Synchronous
   /// is done for both shared and distributed versions.
   /*
@@ -200,7 +339,8 @@ katana::analytics::Cdlp(
 /// to avoid code duplication.
 katana::Result<CdlpStatistics>
 katana::analytics::CdlpStatistics::Compute(
-    katana::PropertyGraph* pg, const std::string& property_name) {
+    katana::PropertyGraph* pg, const std::string& property_name,
+    std::vector<uint64_t> changed_per_iteration) {
   using CommunityType = uint64_t;
   struct NodeCommunity : public katana::PODProperty<CommunityType> {};
 
@@ -277,7 +417,7 @@ katana::analytics::CdlpStatistics::Compute(
 
   return CdlpStatistics{
       reps, non_trivial_communities.reduce(), largest_community_size,
-      largest_community_ratio};
+      largest_community_ratio, std::move(changed_per_iteration)};
 }
 
 void
@@ -289,4 +429,13 @@ katana::analytics::CdlpStatistics::Print(std::ostream& os) const {
      << std::endl;
   os << "Ratio of nodes in the largest community = " << largest_community_ratio
      << std::endl;
+  if (!changed_per_iteration.empty()) {
+    os << "Number of iterations = " << changed_per_iteration.size()
+       << std::endl;
+    os << "Nodes changed per iteration =";
+    for (uint64_t changed : changed_per_iteration) {
+      os << " " << changed;
+    }
+    os << std::endl;
+  }
 }
@@ -0,0 +1,259 @@
+#include "katana/analytics/clique_count/clique_count.h"
+
+#include <atomic>
+#include <vector>
+
+#include "../triangle_count/degree_ordering.h"
+#include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Bag.h"
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/SortedIntersection.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using SortedGraphView = katana::analytics::internal::DegreeSortedGraphView;
+using Node = SortedGraphView::Node;
+
+static_assert(
+    sizeof(Node) == sizeof(uint32_t),
+    "the intersection kernels need 32-bit node IDs");
+
+/// The cliques of the orientation of a graph by degree, listed by extending
+/// a clique with the nodes in the intersection of the smaller neighbors of
+/// its nodes
+class CliqueLister {
+public:
+  /// A node whose cliques are listed by one task or, for hubs, the cliques
+  /// through the neighbor at index neighbor of its smaller neighbors
+  struct Task {
+    Node node;
+    uint32_t neighbor;
+  };
+
+  static constexpr uint32_t kAllNeighbors = UINT32_MAX;
+
+  CliqueLister(
+      const katana::GraphTopology* topology, uint32_t clique_size,
+      katana::NUMAArray<std::atomic<uint64_t>>* local_counts)
+      : topology_(topology),
+        clique_size_(clique_size),
+        local_counts_(local_counts) {}
+
+  /// \returns the number of cliques of the task
+  uint64_t Run(const Task& task) {
+    Scratch* scratch = scratch_.getLocal();
+    scratch->candidates.resize(clique_size_);
+
+    const Node* dsts = Dsts(task.node);
+    uint32_t degree = topology_->OutDegree(task.node);
+    scratch->clique[0] = task.node;
+    if (task.neighbor == kAllNeighbors) {
+      return Extend(dsts, degree, 1, scratch);
+    }
+    // The smaller neighbors of task.node before this one that are also
+    // neighbors of it are the candidates of the clique of both
+    return ExtendWith(dsts, task.neighbor, 1, scratch);
+  }
+
+private:
+  struct Scratch {
+    Node clique[CliqueCountPlan::kMaxCliqueSize];
+    /// The candidates of each depth
+    std::vector<std::vector<Node>> candidates;
+  };
+
+  const Node* Dsts(Node n) const {
+    return topology_->DestData() + *topology_->OutEdges(n).begin();
+  }
+
+  /// Count the cliques extending the depth nodes of scratch->clique with
+  /// clique_size_ - depth of the size nodes of candidates, each of which is
+  /// a smaller neighbor of all of them
+  uint64_t Extend(
+      const Node* candidates, uint32_t size, uint32_t depth, Scratch* scratch) {
+    if (depth + 1 == clique_size_) {
+      Record(candidates, size, depth, scratch);
+      return size;
+    }
+    uint64_t count = 0;
+    // Each candidate needs clique_size_ - depth - 1 smaller candidates
+    for (uint32_t i = clique_size_ - depth - 1; i < size; ++i) {
+      count += ExtendWith(candidates, i, depth, scratch);
+    }
+    return count;
+  }
+
+  /// Extend with candidates[i], whose smaller neighbors among the
+  /// candidates are among the first i, as the candidates are sorted and
+  /// its neighbors are smaller than it
+  uint64_t ExtendWith(
+      const Node* candidates, uint32_t i, uint32_t depth, Scratch* scratch) {
+    Node v = candidates[i];
+    const Node* v_dsts = Dsts(v);
+    uint32_t v_degree = topology_->OutDegree(v);
+    scratch->clique[depth] = v;
+
+    if (depth + 2 == clique_size_ && local_counts_ == nullptr) {
+      return katana::SortedIntersectionSize(candidates, i, v_dsts, v_degree);
+    }
+    std::vector<Node>& next = scratch->candidates[depth];
+    next.resize(std::min(i, v_degree));
+    uint32_t next_size =
+        katana::SortedIntersection(
+            candidates, i, v_dsts, v_degree, next.data()) -
+        next.data();
+    if (next_size + depth + 1 < clique_size_) {
+      return 0;
+    }
+    return Extend(next.data(), next_size, depth + 1, scratch);
+  }
+
+  /// Add the cliques of the depth nodes of scratch->clique and each of the
+  /// size candidates to the counts of their nodes
+  void Record(
+      const Node* candidates, uint32_t size, uint32_t depth, Scratch* scratch) {
+    if (local_counts_ == nullptr || size == 0) {
+      return;
+    }
+    for (uint32_t j = 0; j < depth; ++j) {
+      (*local_counts_)[scratch->clique[j]].fetch_add(
+          size, std::memory_order_relaxed);
+    }
+    for (uint32_t j = 0; j < size; ++j) {
+      (*local_counts_)[candidates[j]].fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  const katana::GraphTopology* topology_;
+  uint32_t clique_size_;
+  katana::NUMAArray<std::atomic<uint64_t>>* local_counts_;
+  katana::PerThreadStorage<Scratch> scratch_;
+};
+
+/// \returns the number of cliques of clique_size nodes of graph, which are
+/// also added to local_counts, if given, for each of their nodes
+uint64_t
+OrderedListingAlgo(
+    const SortedGraphView* graph, uint32_t clique_size,
+    const CliqueCountPlan& plan,
+    katana::NUMAArray<std::atomic<uint64_t>>* local_counts) {
+  katana::GraphTopology oriented =
+      katana::analytics::internal::OrientedTopology(graph);
+  CliqueLister lister(&oriented, clique_size, local_counts);
+
+  // The nodes that have a single task are listed as they are found; the
+  // neighbors of hubs are listed after them, so threads can steal the
+  // neighborhoods of a hub from each other
+  katana::InsertBag<CliqueLister::Task> hub_tasks;
+  katana::GAccumulator<uint64_t> count;
+  katana::do_all(
+      katana::iterate(oriented),
+      [&](Node n) {
+        uint32_t degree = oriented.OutDegree(n);
+        if (degree + 1 < clique_size) {
+          return;
+        }
+        // A 2-clique is an edge, so only larger cliques split hubs
+        if (degree < plan.hub_degree() || clique_size == 2) {
+          count += lister.Run({n, CliqueLister::kAllNeighbors});
+          return;
+        }
+        for (uint32_t i = clique_size - 2; i < degree; ++i) {
+          hub_tasks.push({n, i});
+        }
+      },
+      katana::steal(), katana::loopname("CliqueCount_Nodes"));
+  katana::do_all(
+      katana::iterate(hub_tasks),
+      [&](const CliqueLister::Task& task) { count += lister.Run(task); },
+      katana::steal(), katana::loopname("CliqueCount_Hubs"));
+  return count.reduce();
+}
+
+katana::Result<uint64_t>
+CliqueCountImpl(
+    katana::PropertyGraph* pg, uint32_t clique_size,
+    const CliqueCountPlan& plan,
+    katana::NUMAArray<uint64_t>* property_local_counts) {
+  if (clique_size < 2 || clique_size > CliqueCountPlan::kMaxCliqueSize) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "clique size must be between 2 and {}; got {}",
+        CliqueCountPlan::kMaxCliqueSize, clique_size);
+  }
+
+  katana::StatTimer timer_relabel("GraphRelabelTimer", "CliqueCount");
+  timer_relabel.start();
+  SortedGraphView sorted_view = pg->BuildView<SortedGraphView>();
+  timer_relabel.stop();
+
+  katana::NUMAArray<std::atomic<uint64_t>> local_counts;
+  if (property_local_counts != nullptr) {
+    local_counts.allocateInterleaved(sorted_view.NumNodes());
+    katana::ParallelSTL::fill(
+        local_counts.begin(), local_counts.end(), uint64_t{0});
+  }
+
+  katana::StatTimer exec_time("CliqueCount", "CliqueCount");
+  exec_time.start();
+  uint64_t count = 0;
+  switch (plan.algorithm()) {
+  case CliqueCountPlan::kOrderedListing:
+    count = OrderedListingAlgo(
+        &sorted_view, clique_size, plan,
+        property_local_counts != nullptr ? &local_counts : nullptr);
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  if (property_local_counts != nullptr) {
+    property_local_counts->allocateInterleaved(sorted_view.NumNodes());
+    katana::do_all(
+        katana::iterate(sorted_view),
+        [&](Node n) {
+          (*property_local_counts)[sorted_view.GetNodePropertyIndex(n)] =
+              local_counts[n].load(std::memory_order_relaxed);
+        },
+        katana::no_stats());
+  }
+  return count;
+}
+
+}  // namespace
+
+katana::Result<uint64_t>
+katana::analytics::CliqueCount(
+    katana::PropertyGraph* pg, uint32_t clique_size, CliqueCountPlan plan) {
+  return CliqueCountImpl(pg, clique_size, plan, nullptr);
+}
+
+katana::Result<uint64_t>
+katana::analytics::CliqueCount(
+    katana::PropertyGraph* pg, uint32_t clique_size,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    CliqueCountPlan plan) {
+  katana::NUMAArray<uint64_t> local_counts;
+  uint64_t count =
+      KATANA_CHECKED(CliqueCountImpl(pg, clique_size, plan, &local_counts));
+
+  katana::ArrowRandomAccessBuilder<arrow::UInt64Type, false> builder(
+      pg->NumNodes());
+  katana::ParallelSTL::copy(
+      local_counts.begin(), local_counts.end(), builder.data());
+  std::shared_ptr<arrow::Array> column = KATANA_CHECKED(builder.Finalize());
+  KATANA_CHECKED(pg->AddNodeProperties(
+      arrow::Table::Make(
+          arrow::schema({arrow::field(output_property_name, arrow::uint64())}),
+          {column}),
+      txn_ctx));
+  return count;
+}
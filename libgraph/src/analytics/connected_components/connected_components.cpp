@@ -19,8 +19,14 @@
 
 #include "katana/analytics/connected_components/connected_components.h"
 
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/UnionFind.h"
 
 using namespace katana::analytics;
 
@@ -98,7 +104,9 @@ struct ConnectedComponentsSerialAlgo {
   }
 };
 
-template <typename GraphViewTy>
+/// With kOutEdgesOnly, the graph need not be symmetric: labels are pushed
+/// along out-edges and, through the transpose of the graph, along in-edges.
+template <typename GraphViewTy, bool kOutEdgesOnly = false>
 struct ConnectedComponentsLabelPropAlgo {
   using ComponentType = uint64_t;
   struct NodeComponent : public katana::AtomicPODProperty<ComponentType> {};
@@ -108,10 +116,18 @@ struct ConnectedComponentsLabelPropAlgo {
   typedef katana::TypedPropertyGraphView<GraphViewTy, NodeData, EdgeData> Graph;
   typedef typename Graph::Node GNode;
 
+  using InEdgesView = katana::PropertyGraphViews::Transposed;
+
   katana::NUMAArray<ComponentType> old_component_;
   ConnectedComponentsPlan& plan_;
+  std::optional<InEdgesView> in_edges_;
   ConnectedComponentsLabelPropAlgo(ConnectedComponentsPlan& plan)
-      : plan_(plan) {}
+      : plan_(plan) {
+    static_assert(!kOutEdgesOnly, "in-edges are needed");
+  }
+  ConnectedComponentsLabelPropAlgo(
+      ConnectedComponentsPlan& plan, const InEdgesView& in_edges)
+      : plan_(plan), in_edges_(in_edges) {}
 
   void Initialize(Graph* graph) {
     old_component_.allocateBlocked(graph->size());
@@ -145,6 +161,15 @@ struct ConnectedComponentsLabelPropAlgo {
                 ComponentType label_new = sdata_current_comp;
                 katana::atomicMin(ddata_current_comp, label_new);
               }
+              if constexpr (kOutEdgesOnly) {
+                for (auto e : Edges(*in_edges_, src)) {
+                  auto dest = EdgeDst(*in_edges_, e);
+                  auto& ddata_current_comp =
+                      graph->template GetData<NodeComponent>(dest);
+                  ComponentType label_new = sdata_current_comp;
+                  katana::atomicMin(ddata_current_comp, label_new);
+                }
+              }
             }
           },
           katana::disable_conflict_detection(), katana::steal(),
@@ -642,74 +667,14 @@ approxLargestComponent(Graph* graph, uint32_t component_sample_frequency) {
   return most_frequent->first;
 }
 
-template <
-    typename ComponentType, typename Graph, typename NodeIndex,
-    typename ParentArray>
-ComponentType
-approxLargestComponent(
-    Graph* graph, ParentArray& parent_array_,
-    uint32_t component_sample_frequency) {
-  using map_type = katana::gstl::UnorderedMap<ComponentType, int>;
-  using pair_type = std::pair<ComponentType, int>;
-
-  map_type comp_freq(component_sample_frequency);
-  std::random_device rd;
-  std::mt19937 rng(rd());
-  std::uniform_int_distribution<uint32_t> dist(0, graph->size() - 1);
-  for (uint32_t i = 0; i < component_sample_frequency; i++) {
-    const auto& ndata = parent_array_[dist(rng)];
-    comp_freq[ndata.component()]++;
-  }
-
-  KATANA_LOG_DEBUG_ASSERT(!comp_freq.empty());
-  auto most_frequent = std::max_element(
-      comp_freq.cbegin(), comp_freq.cend(),
-      [](const pair_type& a, const pair_type& b) {
-        return a.second < b.second;
-      });
-
-  //katana::gDebug(
-  //    "Approximate largest intermediate component: ", most_frequent->first,
-  //    " (hit rate ",
-  //    100.0 * (most_frequent->second) / component_sample_frequency, "%)");
-
-  return most_frequent->first;
-}
-
-template <typename GraphViewTy>
+/// With kOutEdgesOnly, the graph need not be symmetric: each edge is only
+/// seen from its source, so a node in the largest sampled component still
+/// links its out-neighbors that are not, rather than leaving that edge to
+/// the other endpoint. No transpose is needed for weak components.
+template <typename GraphViewTy, bool kOutEdgesOnly = false>
 struct ConnectedComponentsAfforestAlgo {
-  struct NodeAfforest : public katana::UnionFindNode<NodeAfforest> {
-    using ComponentType = NodeAfforest*;
-
-    NodeAfforest() : katana::UnionFindNode<NodeAfforest>(this) {}
-    NodeAfforest(const NodeAfforest& o)
-        : katana::UnionFindNode<NodeAfforest>(o.m_component) {}
-
-    ComponentType component() { return this->get(); }
-    ComponentType component() const { return this->get(); }
-    bool isRepComp(unsigned int) { return false; }  // verify
-
-  public:
-    void link(NodeAfforest* b) {
-      NodeAfforest* a = this->m_component.load(std::memory_order_relaxed);
-      b = b->m_component.load(std::memory_order_relaxed);
-      while (a != b) {
-        if (a < b)
-          std::swap(a, b);
-        // Now a > b
-        NodeAfforest* ac = a->m_component.load(std::memory_order_relaxed);
-        if ((ac == a && a->m_component.compare_exchange_strong(a, b)) ||
-            (b == ac))
-          break;
-        a = (a->m_component.load(std::memory_order_relaxed))
-                ->m_component.load(std::memory_order_relaxed);
-        b = b->m_component.load(std::memory_order_relaxed);
-      }
-    }
-  };
-
-  struct NodeComponent : public katana::PODProperty<
-                             uint64_t, typename NodeAfforest::ComponentType> {};
+  using ComponentType = uint64_t;
+  struct NodeComponent : public katana::PODProperty<ComponentType> {};
 
   using NodeData = std::tuple<NodeComponent>;
   using EdgeData = std::tuple<>;
@@ -717,33 +682,19 @@ struct ConnectedComponentsAfforestAlgo {
   typedef typename Graph::Node GNode;
 
   ConnectedComponentsPlan& plan_;
-  katana::NUMAArray<NodeAfforest> parent_array_;
+  // the root of each component is its smallest node, which becomes its id
+  katana::UnionFind<GNode> components_;
 
   ConnectedComponentsAfforestAlgo(ConnectedComponentsPlan& plan)
-      : plan_(plan), parent_array_() {}
-
-  void Initialize(Graph* graph) {
-    parent_array_.allocateBlocked(graph->size());
-    // parent_array_.allocateInterleaved(graph->size());
+      : plan_(plan) {}
 
-    katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
-      auto& snode = graph->template GetData<NodeComponent>(node);
-      new (&snode) NodeAfforest();
-      new (&parent_array_[node]) NodeAfforest();
-      //snode = reinterpret_cast<ComponentType>(&snode);
-    });
-  }
+  void Initialize(Graph* graph) { components_.Reset(graph->size()); }
 
   void Deallocate(Graph* graph) {
     katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
-      auto& sdata = graph->template GetData<NodeComponent>(node);
-      auto& dataFromArr = parent_array_[node];
-      // auto component_ptr = sdata->component();
-      auto component_ptr = dataFromArr.component();
-      sdata = component_ptr;
+      graph->template GetData<NodeComponent>(node) = components_.Find(node);
     });
   }
-  using ComponentType = typename NodeAfforest::ComponentType;
 
   void operator()(Graph* graph) {
     // (bozhi) should NOT go through single direction in sampling step: nodes
@@ -757,13 +708,7 @@ struct ConnectedComponentsAfforestAlgo {
             auto ei = edges.end();
 
             for (std::advance(ii, r); ii < ei; ii++) {
-              auto dest = EdgeDst(*graph, *ii);
-              // auto& sdata = graph->GetData<NodeComponent>(src);
-              // ComponentType ddata = graph->GetData<NodeComponent>(dest);
-              // sdata->link(ddata);
-              auto& sdata = parent_array_[src];
-              auto& ddata = parent_array_[dest];
-              sdata.link(&ddata);
+              components_.Union(src, EdgeDst(*graph, *ii));
               break;
             }
           },
@@ -771,27 +716,21 @@ struct ConnectedComponentsAfforestAlgo {
 
       katana::do_all(
           katana::iterate(*graph),
-          [&](const GNode& src) {
-            // auto& sdata = graph->GetData<NodeComponent>(src);
-            auto& sdata = parent_array_[src];
-            sdata.compress();
-          },
+          [&](const GNode& src) { components_.Compress(src); },
           katana::steal(), katana::loopname("Afforest-VNS-Compress"));
     }
 
     katana::StatTimer StatTimer_Sampling("Afforest-LCS-Sampling");
     StatTimer_Sampling.start();
-    const ComponentType c =
-        approxLargestComponent<ComponentType, Graph, NodeComponent>(
-            graph, parent_array_, plan_.component_sample_frequency());
+    const GNode c = components_.SampleLargestSet(
+        plan_.component_sample_frequency(), std::random_device{}());
     StatTimer_Sampling.stop();
 
     katana::do_all(
         katana::iterate(*graph),
         [&](const GNode& src) {
-          // auto& sdata = graph->GetData<NodeComponent>(src);
-          auto& sdata = parent_array_[src];
-          if (sdata.component() == c) {
+          const bool in_largest = components_.Parent(src) == c;
+          if (!kOutEdgesOnly && in_largest) {
             return;
           }
           auto edges = Edges(*graph, src);
@@ -799,22 +738,16 @@ struct ConnectedComponentsAfforestAlgo {
           auto ei = edges.end();
           for (std::advance(ii, plan_.neighbor_sample_size()); ii < ei; ++ii) {
             auto dest = EdgeDst(*graph, *ii);
-            // auto& ddata = graph->GetData<NodeComponent>(dest);
-            auto& ddata = parent_array_[dest];
-            // sdata->link(ddata);
-            sdata.link(&ddata);
+            if (!in_largest || components_.Parent(dest) != c) {
+              components_.Union(src, dest);
+            }
           }
         },
         katana::steal(), katana::loopname("Afforest-LCS-Link"));
 
     katana::do_all(
         katana::iterate(*graph),
-        [&](const GNode& src) {
-          // auto& sdata = graph->GetData<NodeComponent>(src);
-          // sdata->compress();
-          auto& sdata = parent_array_[src];
-          sdata.compress();
-        },
+        [&](const GNode& src) { components_.Compress(src); },
         katana::steal(), katana::loopname("Afforest-LCS-Compress"));
   }
 };
@@ -1134,11 +1067,12 @@ struct ConnectedComponentsEdgeTiledAfforestAlgo {
 
 }  //namespace
 
-template <typename Algorithm>
+template <typename Algorithm, typename... Args>
 static katana::Result<void>
 ConnectedComponentsWithWrap(
     katana::PropertyGraph* pg, std::string output_property_name,
-    katana::TxnContext* txn_ctx, ConnectedComponentsPlan plan) {
+    katana::TxnContext* txn_ctx, ConnectedComponentsPlan plan,
+    Args&&... args) {
   katana::EnsurePreallocated(
       2, pg->topology().NumNodes() * sizeof(typename Algorithm::NodeComponent));
   katana::ReportPageAllocGuard page_alloc;
@@ -1149,14 +1083,16 @@ ConnectedComponentsWithWrap(
       !r) {
     return r.error();
   }
-  auto pg_result = Algorithm::Graph::Make(pg, {output_property_name}, {});
+  auto pg_result = katana::analytics::MakeGraphOfEdgeType<
+      typename Algorithm::Graph>(
+      pg, plan.edge_type(), {output_property_name}, {});
   if (!pg_result) {
     return pg_result.error();
   }
 
   auto graph = pg_result.value();
 
-  Algorithm algo(plan);
+  Algorithm algo(plan, std::forward<Args>(args)...);
 
   algo.Initialize(&graph);
 
@@ -1227,17 +1163,136 @@ katana::analytics::ConnectedComponents(
     PropertyGraph* pg, const std::string& output_property_name,
     katana::TxnContext* txn_ctx, const bool& is_symmetric,
     ConnectedComponentsPlan plan) {
+  using DefaultView = katana::PropertyGraphViews::Default;
   if (is_symmetric) {
-    using GraphView = katana::PropertyGraphViews::Default;
-    return ConnectedComponentsSelectAlgorithm<GraphView>(
+    return ConnectedComponentsSelectAlgorithm<DefaultView>(
         pg, output_property_name, txn_ctx, plan);
-  } else {
-    using GraphView = katana::PropertyGraphViews::Undirected;
-    return ConnectedComponentsSelectAlgorithm<GraphView>(
+  }
+
+  // Weak components: Afforest links the out-edges alone and label
+  // propagation adds only the transpose, which the view cache keeps for
+  // later runs; the other algorithms use each edge in one direction and need
+  // the undirected view.
+  switch (plan.algorithm()) {
+  case ConnectedComponentsPlan::kAfforest:
+    return ConnectedComponentsWithWrap<
+        ConnectedComponentsAfforestAlgo<DefaultView, true>>(
+        pg, output_property_name, txn_ctx, plan);
+  case ConnectedComponentsPlan::kLabelProp:
+    return ConnectedComponentsWithWrap<
+        ConnectedComponentsLabelPropAlgo<DefaultView, true>>(
+        pg, output_property_name, txn_ctx, plan,
+        plan.edge_type()
+            ? MakeViewOfEdgeType<katana::PropertyGraphViews::Transposed>(
+                  pg, *plan.edge_type())
+            : pg->BuildView<katana::PropertyGraphViews::Transposed>());
+  default:
+    return ConnectedComponentsSelectAlgorithm<
+        katana::PropertyGraphViews::Undirected>(
         pg, output_property_name, txn_ctx, plan);
   }
 }
 
+template <typename GraphViewTy>
+katana::Result<void>
+ConnectedComponentsIncrementalImpl(
+    katana::PropertyGraph* pg, const std::string& previous_property_name,
+    const EdgeUpdates& updates, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx) {
+  using ComponentType = uint64_t;
+  struct PreviousComponent : public katana::PODProperty<ComponentType> {};
+  struct NodeComponent : public katana::PODProperty<ComponentType> {};
+
+  using NodeData = std::tuple<PreviousComponent, NodeComponent>;
+  using EdgeData = std::tuple<>;
+  typedef katana::TypedPropertyGraphView<GraphViewTy, NodeData, EdgeData> Graph;
+  typedef typename Graph::Node GNode;
+
+  katana::ReportPageAllocGuard page_alloc;
+
+  KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<NodeComponent>>(
+      txn_ctx, {output_property_name}));
+  auto graph = KATANA_CHECKED(
+      Graph::Make(pg, {previous_property_name, output_property_name}, {}));
+
+  for (const auto* edges : {&updates.inserted, &updates.deleted}) {
+    for (const auto& [src, dst] : *edges) {
+      if (src >= graph.size() || dst >= graph.size()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "edge ({}, {}) is not in graph",
+            src, dst);
+      }
+    }
+  }
+
+  // A component that lost an edge may have split
+  std::unordered_set<ComponentType> affected;
+  for (const auto& [src, dst] : updates.deleted) {
+    affected.emplace(graph.template GetData<PreviousComponent>(src));
+    affected.emplace(graph.template GetData<PreviousComponent>(dst));
+  }
+
+  katana::StatTimer execTime("ConnectedComponentIncremental");
+  execTime.start();
+
+  katana::UnionFind<GNode> components(graph.size());
+  // Unaffected components stay connected: join each node to the first node
+  // of its previous component that its thread saw, then join those
+  katana::PerThreadStorage<std::unordered_map<ComponentType, GNode>> firsts;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        ComponentType previous =
+            graph.template GetData<PreviousComponent>(node);
+        if (affected.count(previous) == 0) {
+          auto [it, inserted] = firsts.getLocal()->emplace(previous, node);
+          if (!inserted) {
+            components.Union(node, it->second);
+          }
+        } else {
+          for (const auto& e : Edges(graph, node)) {
+            components.Union(node, EdgeDst(graph, e));
+          }
+        }
+      },
+      katana::steal(), katana::loopname("Incremental-Link"));
+
+  std::unordered_map<ComponentType, GNode> first_of;
+  for (unsigned t = 0; t < firsts.size(); ++t) {
+    for (const auto& [previous, node] : *firsts.getRemote(t)) {
+      auto [it, inserted] = first_of.emplace(previous, node);
+      if (!inserted) {
+        components.Union(node, it->second);
+      }
+    }
+  }
+  components.UnionAll(updates.inserted, katana::steal());
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        graph.template GetData<NodeComponent>(node) = components.Find(node);
+      },
+      katana::loopname("Incremental-Label"));
+  execTime.stop();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::ConnectedComponentsIncremental(
+    PropertyGraph* pg, const std::string& previous_property_name,
+    const EdgeUpdates& updates, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric) {
+  // Both endpoints of an edge are in the same previous component, so the
+  // affected components see every edge of theirs from its source and the
+  // out-edges suffice whether or not pg is symmetric
+  (void)is_symmetric;
+  using GraphView = katana::PropertyGraphViews::Default;
+  return ConnectedComponentsIncrementalImpl<GraphView>(
+      pg, previous_property_name, updates, output_property_name, txn_ctx);
+}
+
 katana::Result<void>
 katana::analytics::ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name) {
@@ -0,0 +1,576 @@
+#include "katana/analytics/distributed/distributed.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/RDG.h"
+#include "katana/RDGTopology.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/tsuba.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// Nodes of adj_indices read at a time to find the node ranges
+constexpr uint64_t kScanNodes = UINT64_C(1) << 20;
+
+constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+
+/// \returns true if val was lowered to desired
+bool
+AtomicMin(uint32_t* val, uint32_t desired) {
+  uint32_t old = __atomic_load_n(val, __ATOMIC_RELAXED);
+  while (desired < old) {
+    if (__atomic_compare_exchange_n(
+            val, &old, desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+AtomicAdd(float* val, float delta) {
+  float old;
+  __atomic_load(val, &old, __ATOMIC_RELAXED);
+  float desired = old + delta;
+  while (!__atomic_compare_exchange(
+      val, &old, &desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    desired = old + delta;
+  }
+}
+
+/// Split num_nodes nodes into num_hosts ranges with roughly equal numbers of
+/// nodes plus edges, given the number of edges before each node
+template <typename EdgesBefore>
+std::vector<uint64_t>
+BalancedBounds(
+    uint32_t num_hosts, uint64_t num_nodes, uint64_t num_edges,
+    const EdgesBefore& edges_before) {
+  uint64_t total = num_nodes + num_edges;
+  std::vector<uint64_t> bounds{0};
+  for (uint32_t h = 1; h < num_hosts; ++h) {
+    uint64_t target = total * h / num_hosts;
+    uint64_t lo = bounds.back();
+    uint64_t hi = num_nodes;
+    while (lo < hi) {
+      uint64_t mid = lo + (hi - lo) / 2;
+      if (mid + edges_before(mid) < target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    bounds.emplace_back(lo);
+  }
+  bounds.emplace_back(num_nodes);
+  return bounds;
+}
+
+/// Relax the out edges of the masters in frontier with
+/// value[dst] = min(value[dst], value[src] + weight(edge)) and synchronize,
+/// round after round, until no host changes a value. Frontier holds the
+/// masters to start from and is left empty.
+template <typename WeightFn>
+katana::Result<uint32_t>
+MinPush(
+    DistributedGraph* graph, katana::NUMAArray<uint32_t>* value,
+    katana::DynamicBitset* frontier, const WeightFn& weight,
+    const char* loopname) {
+  const katana::GraphTopology& topo = graph->topology();
+  katana::DynamicBitset updated;
+  updated.resize(graph->NumLocalNodes());
+  uint32_t rounds = 0;
+
+  while (true) {
+    uint64_t work = 0;
+    for (uint64_t n = 0; n < graph->NumMasters(); ++n) {
+      work += frontier->test(n) ? 1 : 0;
+    }
+    KATANA_CHECKED(
+        graph->comm()->Allreduce(&work, 1, katana::ReduceOp::kSum));
+    if (work == 0) {
+      break;
+    }
+    ++rounds;
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, graph->NumMasters()),
+        [&](uint64_t u) {
+          if (!frontier->test(u)) {
+            return;
+          }
+          uint32_t dist = (*value)[u];
+          for (auto e : topo.OutEdges(u)) {
+            auto v = topo.OutEdgeDst(e);
+            if (AtomicMin(&(*value)[v], dist + weight(e))) {
+              updated.set(v);
+            }
+          }
+        },
+        katana::steal(), katana::loopname(loopname));
+
+    // The masters changed here or by reduction are the next frontier
+    KATANA_CHECKED(
+        graph->Reduce(value->data(), &updated, katana::ReduceOp::kMin));
+    KATANA_CHECKED(graph->Broadcast(value->data(), &updated));
+    frontier->reset();
+    for (uint64_t n = 0; n < graph->NumMasters(); ++n) {
+      if (updated.test(n)) {
+        frontier->set(n);
+      }
+    }
+    updated.reset();
+  }
+  return rounds;
+}
+
+katana::Result<katana::NUMAArray<uint32_t>>
+ShortestPaths(
+    DistributedGraph* graph, uint32_t source,
+    const std::function<uint32_t(uint64_t)>& weight, const char* name) {
+  if (source >= graph->NumGlobalNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source {} is not one of the {} nodes", source,
+        graph->NumGlobalNodes());
+  }
+
+  katana::StatTimer exec_time(name);
+  exec_time.start();
+
+  katana::NUMAArray<uint32_t> dist;
+  dist.allocateInterleaved(graph->NumLocalNodes());
+  katana::ParallelSTL::fill(dist.begin(), dist.end(), kInfinity);
+  katana::DynamicBitset frontier;
+  frontier.resize(graph->NumLocalNodes());
+  if (graph->HostOf(source) == graph->comm()->rank()) {
+    auto local = graph->LocalId(source).value();
+    dist[local] = 0;
+    frontier.set(local);
+  }
+
+  uint32_t rounds =
+      KATANA_CHECKED(MinPush(graph, &dist, &frontier, weight, name));
+
+  exec_time.stop();
+  katana::ReportStatSingle(name, "Rounds", rounds);
+  return katana::NUMAArray<uint32_t>(std::move(dist));
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<DistributedGraph>>
+DistributedGraph::Make(
+    CommBackend* comm, const URI& rdg_dir, TxnContext* txn_ctx) {
+  RDGManifest manifest = KATANA_CHECKED(FindManifest(rdg_dir, txn_ctx));
+  auto rdg_handle = KATANA_CHECKED(Open(std::move(manifest), kReadOnly));
+  RDGFile rdg_file(rdg_handle);
+
+  RDGLoadOptions opts;
+  opts.node_properties = std::vector<std::string>();
+  opts.edge_properties = std::vector<std::string>();
+  RDG rdg = KATANA_CHECKED(RDG::Make(rdg_file, opts));
+  KATANA_CHECKED(rdg.UnbindNodeEntityTypeIDArrayFileStorage());
+  KATANA_CHECKED(rdg.UnbindEdgeEntityTypeIDArrayFileStorage());
+  RDGTopology* topo = KATANA_CHECKED_CONTEXT(
+      rdg.GetTopologySections(RDGTopology::MakeShadow(
+          RDGTopology::TopologyKind::kCSR, RDGTopology::TransposeKind::kNo,
+          RDGTopology::EdgeSortKind::kAny, RDGTopology::NodeSortKind::kAny)),
+      "distributed analytics need an uncompressed CSR topology");
+  uint64_t num_nodes = topo->num_nodes();
+  uint64_t num_edges = topo->num_edges();
+  if (num_nodes > std::numeric_limits<Node>::max()) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "graphs of {} nodes are too large",
+        num_nodes);
+  }
+
+  // Every host finds the same ranges, the ones BalancedBounds finds, in a
+  // scan of adj_indices a chunk at a time
+  const uint64_t* adj_indices = topo->adj_indices();
+  uint32_t num_hosts = comm->num();
+  uint64_t total = num_nodes + num_edges;
+  std::vector<uint64_t> node_bounds{0};
+  uint64_t edges_before = 0;
+  for (uint64_t chunk = 0; chunk < num_nodes; chunk += kScanNodes) {
+    uint64_t chunk_end = std::min(chunk + kScanNodes, num_nodes);
+    KATANA_CHECKED(topo->FillNodes(chunk, chunk_end, false));
+    for (uint64_t n = chunk; n < chunk_end; ++n) {
+      while (node_bounds.size() < num_hosts &&
+             n + edges_before >= total * node_bounds.size() / num_hosts) {
+        node_bounds.emplace_back(n);
+      }
+      edges_before = adj_indices[n];
+    }
+    KATANA_CHECKED(topo->ReleaseNodes(chunk, chunk_end));
+  }
+  node_bounds.resize(num_hosts + 1, num_nodes);
+
+  uint64_t begin = node_bounds[comm->rank()];
+  uint64_t end = node_bounds[comm->rank() + 1];
+  std::vector<uint64_t> out_indices;
+  std::vector<Node> global_dests;
+  uint64_t first_edge = 0;
+  if (begin < end) {
+    KATANA_CHECKED(topo->FillNodes(begin, end, false));
+    first_edge = begin > 0 ? adj_indices[begin - 1] : 0;
+    uint64_t last_edge = adj_indices[end - 1];
+    KATANA_CHECKED(topo->FillEdges(first_edge, last_edge, false));
+    out_indices.resize(end - begin);
+    global_dests.resize(last_edge - first_edge);
+    for (uint64_t n = begin; n < end; ++n) {
+      out_indices[n - begin] = adj_indices[n] - first_edge;
+    }
+    std::copy(
+        topo->dests() + first_edge, topo->dests() + last_edge,
+        global_dests.begin());
+    KATANA_CHECKED(topo->ReleaseEdges(first_edge, last_edge));
+    KATANA_CHECKED(topo->ReleaseNodes(begin, end));
+  }
+
+  auto graph = KATANA_CHECKED(
+      Make(comm, std::move(node_bounds), out_indices, global_dests));
+  graph->first_global_edge_ = first_edge;
+  return std::unique_ptr<DistributedGraph>(std::move(graph));
+}
+
+katana::Result<std::unique_ptr<DistributedGraph>>
+DistributedGraph::Make(CommBackend* comm, const GraphTopology& topology) {
+  auto edges_before = [&](uint64_t node) -> uint64_t {
+    return node > 0 ? *topology.OutEdges(node - 1).end() : 0;
+  };
+  std::vector<uint64_t> node_bounds = BalancedBounds(
+      comm->num(), topology.NumNodes(), topology.NumEdges(), edges_before);
+
+  uint64_t begin = node_bounds[comm->rank()];
+  uint64_t end = node_bounds[comm->rank() + 1];
+  uint64_t first_edge = edges_before(begin);
+  std::vector<uint64_t> out_indices(end - begin);
+  for (uint64_t n = begin; n < end; ++n) {
+    out_indices[n - begin] = edges_before(n + 1) - first_edge;
+  }
+  std::vector<Node> global_dests;
+  global_dests.reserve(edges_before(end) - first_edge);
+  for (uint64_t e = first_edge; e < edges_before(end); ++e) {
+    global_dests.emplace_back(topology.OutEdgeDst(e));
+  }
+
+  auto graph = KATANA_CHECKED(
+      Make(comm, std::move(node_bounds), out_indices, global_dests));
+  graph->first_global_edge_ = first_edge;
+  return std::unique_ptr<DistributedGraph>(std::move(graph));
+}
+
+katana::Result<std::unique_ptr<DistributedGraph>>
+DistributedGraph::Make(
+    CommBackend* comm, std::vector<uint64_t> node_bounds,
+    const std::vector<uint64_t>& out_indices,
+    const std::vector<Node>& global_dests) {
+  uint32_t num_hosts = comm->num();
+  uint32_t rank = comm->rank();
+  if (node_bounds.size() != num_hosts + 1 || node_bounds.front() != 0 ||
+      !std::is_sorted(node_bounds.begin(), node_bounds.end())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "node bounds must be {} non-decreasing entries starting at 0",
+        num_hosts + 1);
+  }
+  uint64_t begin = node_bounds[rank];
+  uint64_t end = node_bounds[rank + 1];
+  uint64_t num_edges = global_dests.size();
+  if (out_indices.size() != end - begin ||
+      (!out_indices.empty() && out_indices.back() != num_edges)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "{} out indices ending at {} do not fit {} masters of {} edges",
+        out_indices.size(), out_indices.empty() ? 0 : out_indices.back(),
+        end - begin, num_edges);
+  }
+
+  // Using `new` to access a non-public constructor.
+  std::unique_ptr<DistributedGraph> graph(new DistributedGraph());
+  graph->comm_ = comm;
+  graph->node_bounds_ = std::move(node_bounds);
+  graph->num_masters_ = end - begin;
+
+  // The mirrors are the distinct destinations mastered elsewhere
+  std::vector<Node> mirrors;
+  for (Node dst : global_dests) {
+    if (dst < begin || dst >= end) {
+      mirrors.emplace_back(dst);
+    }
+  }
+  katana::ParallelSTL::sort(mirrors.begin(), mirrors.end());
+  mirrors.erase(std::unique(mirrors.begin(), mirrors.end()), mirrors.end());
+
+  uint64_t num_local = graph->num_masters_ + mirrors.size();
+  graph->local_to_global_.resize(num_local);
+  for (uint64_t n = 0; n < graph->num_masters_; ++n) {
+    graph->local_to_global_[n] = begin + n;
+  }
+  std::copy(
+      mirrors.begin(), mirrors.end(),
+      graph->local_to_global_.begin() + graph->num_masters_);
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    auto first = std::lower_bound(
+        mirrors.begin(), mirrors.end(), graph->node_bounds_[h]);
+    graph->mirror_bounds_.emplace_back(
+        graph->num_masters_ + (first - mirrors.begin()));
+  }
+  graph->mirror_bounds_.emplace_back(num_local);
+
+  // Mirrors have no out edges
+  std::vector<Edge> adj_indices(num_local, num_edges);
+  std::copy(out_indices.begin(), out_indices.end(), adj_indices.begin());
+  std::vector<Node> dests(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        Node dst = global_dests[e];
+        if (dst >= begin && dst < end) {
+          dests[e] = dst - begin;
+        } else {
+          auto it = std::lower_bound(mirrors.begin(), mirrors.end(), dst);
+          dests[e] = graph->num_masters_ + (it - mirrors.begin());
+        }
+      },
+      katana::no_stats());
+  graph->topology_ = GraphTopology(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size());
+
+  // Tell each host which of its nodes are mirrored here, in mirror order
+  std::vector<std::vector<uint8_t>> send(num_hosts);
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    uint64_t first = graph->mirror_bounds_[h];
+    uint64_t count = graph->mirror_bounds_[h + 1] - first;
+    send[h].resize(count * sizeof(Node));
+    std::memcpy(
+        send[h].data(), graph->local_to_global_.data() + first,
+        count * sizeof(Node));
+  }
+  auto recv = KATANA_CHECKED(graph->Exchange(send));
+  graph->masters_for_.resize(num_hosts);
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    auto& masters = graph->masters_for_[h];
+    masters.resize(recv[h].size() / sizeof(Node));
+    std::memcpy(masters.data(), recv[h].data(), recv[h].size());
+    for (Node& n : masters) {
+      n -= begin;
+    }
+  }
+
+  return std::unique_ptr<DistributedGraph>(std::move(graph));
+}
+
+uint32_t
+DistributedGraph::HostOf(Node global_node) const {
+  auto it =
+      std::upper_bound(node_bounds_.begin(), node_bounds_.end(), global_node);
+  return it - node_bounds_.begin() - 1;
+}
+
+std::optional<DistributedGraph::Node>
+DistributedGraph::LocalId(Node global_node) const {
+  uint64_t begin = node_bounds_[comm_->rank()];
+  if (global_node >= begin && global_node < begin + num_masters_) {
+    return static_cast<Node>(global_node - begin);
+  }
+  auto mirrors_begin = local_to_global_.begin() + num_masters_;
+  auto it =
+      std::lower_bound(mirrors_begin, local_to_global_.end(), global_node);
+  if (it == local_to_global_.end() || *it != global_node) {
+    return std::nullopt;
+  }
+  return static_cast<Node>(it - local_to_global_.begin());
+}
+
+katana::Result<std::vector<std::vector<uint8_t>>>
+DistributedGraph::Exchange(const std::vector<std::vector<uint8_t>>& send) {
+  uint32_t num_hosts = comm_->num();
+  std::vector<uint64_t> send_sizes(num_hosts);
+  std::vector<uint64_t> recv_sizes(num_hosts);
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    send_sizes[h] = send[h].size();
+  }
+  std::vector<uint64_t> size_bytes(num_hosts, sizeof(uint64_t));
+  KATANA_CHECKED(comm_->AlltoAllv(
+      send_sizes.data(), size_bytes, recv_sizes.data(), size_bytes));
+
+  std::vector<uint8_t> send_buf;
+  for (const auto& part : send) {
+    send_buf.insert(send_buf.end(), part.begin(), part.end());
+  }
+  uint64_t recv_total = 0;
+  for (uint64_t size : recv_sizes) {
+    recv_total += size;
+  }
+  std::vector<uint8_t> recv_buf(recv_total);
+  KATANA_CHECKED(comm_->AlltoAllv(
+      send_buf.data(), send_sizes, recv_buf.data(), recv_sizes));
+
+  std::vector<std::vector<uint8_t>> recv(num_hosts);
+  uint64_t off = 0;
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    recv[h].assign(
+        recv_buf.begin() + off, recv_buf.begin() + off + recv_sizes[h]);
+    off += recv_sizes[h];
+  }
+  return recv;
+}
+
+katana::Result<katana::NUMAArray<uint32_t>>
+katana::analytics::DistributedBfs(DistributedGraph* graph, uint32_t source) {
+  return ShortestPaths(
+      graph, source, [](uint64_t) -> uint32_t { return 1; },
+      "DistributedBfs");
+}
+
+katana::Result<katana::NUMAArray<uint32_t>>
+katana::analytics::DistributedSssp(
+    DistributedGraph* graph, uint32_t source,
+    const std::vector<uint32_t>& weights) {
+  if (weights.size() != graph->NumLocalEdges()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} weights for {} edges", weights.size(),
+        graph->NumLocalEdges());
+  }
+  return ShortestPaths(
+      graph, source, [&](uint64_t e) { return weights[e]; },
+      "DistributedSssp");
+}
+
+katana::Result<katana::NUMAArray<float>>
+katana::analytics::DistributedPagerank(
+    DistributedGraph* graph, const PagerankPlan& plan) {
+  const GraphTopology& topo = graph->topology();
+  uint64_t num_local = graph->NumLocalNodes();
+  katana::NUMAArray<float> rank;
+  katana::NUMAArray<float> sum;
+  rank.allocateInterleaved(num_local);
+  sum.allocateInterleaved(num_local);
+  if (graph->NumGlobalNodes() == 0) {
+    return katana::NUMAArray<float>(std::move(rank));
+  }
+
+  katana::StatTimer exec_time("DistributedPagerank");
+  exec_time.start();
+
+  katana::ParallelSTL::fill(
+      rank.begin(), rank.end(), 1.0f / graph->NumGlobalNodes());
+  katana::ParallelSTL::fill(sum.begin(), sum.end(), 0.0f);
+  katana::DynamicBitset touched;
+  touched.resize(num_local);
+  float base_score = 1.0f - plan.alpha();
+  katana::GAccumulator<float> accum;
+  unsigned int iteration = 0;
+  while (true) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, graph->NumMasters()),
+        [&](uint64_t u) {
+          uint64_t degree = topo.OutDegree(u);
+          if (degree == 0) {
+            return;
+          }
+          float share = rank[u] / degree;
+          for (auto e : topo.OutEdges(u)) {
+            auto v = topo.OutEdgeDst(e);
+            AtomicAdd(&sum[v], share);
+            if (!graph->IsMaster(v)) {
+              touched.set(v);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<PagerankPlan::kChunkSize>(),
+        katana::loopname("DistributedPagerank"));
+
+    KATANA_CHECKED(graph->Reduce(sum.data(), &touched, ReduceOp::kSum));
+    touched.reset();
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, graph->NumMasters()),
+        [&](uint64_t n) {
+          float value = sum[n] * plan.alpha() + base_score;
+          accum += std::fabs(value - rank[n]);
+          rank[n] = value;
+          sum[n] = 0;
+        },
+        katana::loopname("DistributedPagerank Update"));
+
+    iteration += 1;
+    float delta = accum.reduce();
+    accum.reset();
+    KATANA_CHECKED(graph->comm()->Allreduce(&delta, 1, ReduceOp::kSum));
+    if (delta <= plan.tolerance() || iteration >= plan.max_iterations()) {
+      break;
+    }
+  }
+  KATANA_CHECKED(graph->Broadcast(rank.data(), nullptr));
+
+  exec_time.stop();
+  katana::ReportStatSingle("DistributedPagerank", "Iterations", iteration);
+  return katana::NUMAArray<float>(std::move(rank));
+}
+
+katana::Result<katana::NUMAArray<uint32_t>>
+katana::analytics::DistributedConnectedComponents(DistributedGraph* graph) {
+  const GraphTopology& topo = graph->topology();
+  uint64_t num_local = graph->NumLocalNodes();
+
+  katana::StatTimer exec_time("DistributedConnectedComponents");
+  exec_time.start();
+
+  katana::NUMAArray<uint32_t> label;
+  label.allocateInterleaved(num_local);
+  katana::do_all(katana::iterate(uint64_t{0}, num_local), [&](uint64_t n) {
+    label[n] = graph->GlobalId(n);
+  });
+  katana::DynamicBitset updated;
+  updated.resize(num_local);
+
+  // Edges pull labels into their sources as well as push them to their
+  // destinations, since mirrors have no edges of their own
+  uint32_t rounds = 0;
+  while (true) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, graph->NumMasters()),
+        [&](uint64_t u) {
+          for (auto e : topo.OutEdges(u)) {
+            auto v = topo.OutEdgeDst(e);
+            uint32_t src_label = __atomic_load_n(&label[u], __ATOMIC_RELAXED);
+            uint32_t dst_label = __atomic_load_n(&label[v], __ATOMIC_RELAXED);
+            if (AtomicMin(&label[v], src_label)) {
+              updated.set(v);
+            }
+            if (AtomicMin(&label[u], dst_label)) {
+              updated.set(u);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("DistributedConnectedComponents"));
+
+    KATANA_CHECKED(graph->Reduce(label.data(), &updated, ReduceOp::kMin));
+    uint64_t work = 0;
+    for (uint64_t n = 0; n < graph->NumMasters(); ++n) {
+      work += updated.test(n) ? 1 : 0;
+    }
+    KATANA_CHECKED(graph->Broadcast(label.data(), &updated));
+    updated.reset();
+    ++rounds;
+
+    KATANA_CHECKED(graph->comm()->Allreduce(&work, 1, ReduceOp::kSum));
+    if (work == 0) {
+      break;
+    }
+  }
+
+  exec_time.stop();
+  katana::ReportStatSingle("DistributedConnectedComponents", "Rounds", rounds);
+  return katana::NUMAArray<uint32_t>(std::move(label));
+}
@@ -0,0 +1,272 @@
+#include "katana/analytics/graph_coloring/graph_coloring.h"
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "../independent_set/priority.h"
+#include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using katana::analytics::internal::HasPriority;
+
+constexpr uint32_t kNoColor = std::numeric_limits<uint32_t>::max();
+
+/// \returns true if src has priority over dst, one of its neighbors
+bool
+Precedes(const katana::GraphTopology& topology, Node src, Node dst) {
+  return HasPriority(
+      src, topology.OutDegree(src), dst, topology.OutDegree(dst));
+}
+
+/// The colors of the neighbors of the node being colored by a thread, as
+/// the stamp of the last node that saw each color, so they need not be
+/// cleared between nodes
+struct ColorMarks {
+  std::vector<uint64_t> marks;
+  uint64_t stamp{0};
+};
+
+/// \returns the smallest color that no neighbor dst of n for which
+/// consider(dst) holds has, by color(dst)
+template <typename Consider, typename Color>
+uint32_t
+SmallestFreeColor(
+    const katana::GraphTopology& topology, Node n, ColorMarks* scratch,
+    const Consider& consider, const Color& color) {
+  // A node with degree neighbors has one of the first degree + 1 colors free
+  size_t degree = topology.OutDegree(n);
+  if (scratch->marks.size() < degree + 1) {
+    scratch->marks.resize(degree + 1, 0);
+  }
+  uint64_t stamp = ++scratch->stamp;
+  for (auto e : topology.OutEdges(n)) {
+    Node dst = topology.OutEdgeDst(e);
+    if (dst == n || !consider(dst)) {
+      continue;
+    }
+    uint32_t c = color(dst);
+    if (c <= degree) {
+      scratch->marks[c] = stamp;
+    }
+  }
+  uint32_t c = 0;
+  while (scratch->marks[c] == stamp) {
+    ++c;
+  }
+  return c;
+}
+
+void
+JonesPlassmannAlgo(const katana::GraphTopology& topology, uint32_t* colors) {
+  katana::NUMAArray<std::atomic<uint32_t>> waiting;
+  waiting.allocateInterleaved(topology.NumNodes());
+  katana::InsertBag<Node> roots;
+
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) {
+        uint32_t num_waiting = 0;
+        for (auto e : topology.OutEdges(n)) {
+          Node dst = topology.OutEdgeDst(e);
+          num_waiting += dst != n && Precedes(topology, dst, n);
+        }
+        waiting[n].store(num_waiting, std::memory_order_relaxed);
+        colors[n] = kNoColor;
+        if (num_waiting == 0) {
+          roots.push(n);
+        }
+      },
+      katana::steal(), katana::loopname("GraphColoring-init"));
+
+  // A node is colored by the thread that colors the last of its neighbors
+  // of higher priority, so their colors are visible to it
+  katana::PerThreadStorage<ColorMarks> scratch;
+  katana::for_each(
+      katana::iterate(roots),
+      [&](Node n, auto& ctx) {
+        colors[n] = SmallestFreeColor(
+            topology, n, scratch.getLocal(),
+            [&](Node dst) { return Precedes(topology, dst, n); },
+            [&](Node dst) { return colors[dst]; });
+        for (auto e : topology.OutEdges(n)) {
+          Node dst = topology.OutEdgeDst(e);
+          if (dst != n && Precedes(topology, n, dst) &&
+              waiting[dst].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ctx.push(dst);
+          }
+        }
+      },
+      katana::disable_conflict_detection(),
+      katana::loopname("GraphColoring-JonesPlassmann"));
+}
+
+void
+SpeculativeAlgo(const katana::GraphTopology& topology, uint32_t* out_colors) {
+  katana::NUMAArray<std::atomic<uint32_t>> colors;
+  colors.allocateInterleaved(topology.NumNodes());
+  katana::ParallelSTL::fill(colors.begin(), colors.end(), kNoColor);
+
+  auto cur = std::make_unique<katana::InsertBag<Node>>();
+  auto next = std::make_unique<katana::InsertBag<Node>>();
+  katana::do_all(
+      katana::iterate(topology), [&](Node n) { cur->push(n); },
+      katana::no_stats());
+
+  auto color = [&](Node dst) {
+    return colors[dst].load(std::memory_order_relaxed);
+  };
+  katana::PerThreadStorage<ColorMarks> scratch;
+  size_t rounds = 0;
+  while (!cur->empty()) {
+    katana::do_all(
+        katana::iterate(*cur),
+        [&](Node n) {
+          colors[n].store(
+              SmallestFreeColor(
+                  topology, n, scratch.getLocal(), [](Node) { return true; },
+                  color),
+              std::memory_order_relaxed);
+        },
+        katana::steal(), katana::loopname("GraphColoring-speculate"));
+
+    // Of the nodes of an edge that got the same color, the one of higher
+    // priority keeps it, so each round fixes at least one node
+    katana::do_all(
+        katana::iterate(*cur),
+        [&](Node n) {
+          uint32_t c = color(n);
+          for (auto e : topology.OutEdges(n)) {
+            Node dst = topology.OutEdgeDst(e);
+            if (dst != n && color(dst) == c && Precedes(topology, dst, n)) {
+              next->push(n);
+              return;
+            }
+          }
+        },
+        katana::steal(), katana::loopname("GraphColoring-fix"));
+
+    cur->clear();
+    std::swap(cur, next);
+    rounds += 1;
+  }
+  katana::ReportStatSingle("GraphColoring-Speculative", "rounds", rounds);
+
+  katana::do_all(
+      katana::iterate(topology),
+      [&](Node n) { out_colors[n] = color(n); }, katana::no_stats());
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::GraphColoring(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, GraphColoringPlan plan) {
+  const katana::GraphTopology& topology = pg->topology();
+  katana::ArrowRandomAccessBuilder<arrow::UInt32Type, false> builder(
+      topology.NumNodes());
+
+  katana::StatTimer exec_time("GraphColoring");
+  exec_time.start();
+  switch (plan.algorithm()) {
+  case GraphColoringPlan::kJonesPlassmann:
+    JonesPlassmannAlgo(topology, builder.data());
+    break;
+  case GraphColoringPlan::kSpeculative:
+    SpeculativeAlgo(topology, builder.data());
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  std::shared_ptr<arrow::Array> column = KATANA_CHECKED(builder.Finalize());
+  KATANA_CHECKED(pg->AddNodeProperties(
+      arrow::Table::Make(
+          arrow::schema({arrow::field(output_property_name, arrow::uint32())}),
+          {column}),
+      txn_ctx));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::GraphColoringAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto colors =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<uint32_t>(property_name));
+  const katana::GraphTopology& topology = pg->topology();
+
+  auto is_bad = [&](Node n) {
+    if (colors->IsNull(n)) {
+      return true;
+    }
+    for (auto e : topology.OutEdges(n)) {
+      Node dst = topology.OutEdgeDst(e);
+      if (dst != n && colors->Value(dst) == colors->Value(n)) {
+        // Fail if an edge joins two nodes of the same color.
+        return true;
+      }
+    }
+    return false;
+  };
+  if (katana::ParallelSTL::find_if(
+          topology.begin(), topology.end(), is_bad) != topology.end()) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::GraphColoringStatistics::Print(std::ostream& os) const {
+  os << "Number of colors = " << num_colors << std::endl;
+  os << "Largest color size = " << largest_color_size << std::endl;
+}
+
+katana::Result<GraphColoringStatistics>
+katana::analytics::GraphColoringStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto colors =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<uint32_t>(property_name));
+
+  katana::GReduceMax<uint32_t> max_color;
+  katana::do_all(
+      katana::iterate(int64_t{0}, colors->length()),
+      [&](int64_t i) { max_color.update(colors->Value(i)); },
+      katana::no_stats());
+  if (colors->length() == 0) {
+    return GraphColoringStatistics{0, 0};
+  }
+
+  katana::NUMAArray<std::atomic<uint32_t>> sizes;
+  sizes.allocateInterleaved(uint64_t{max_color.reduce()} + 1);
+  katana::ParallelSTL::fill(sizes.begin(), sizes.end(), uint32_t{0});
+  katana::do_all(
+      katana::iterate(int64_t{0}, colors->length()),
+      [&](int64_t i) {
+        sizes[colors->Value(i)].fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  uint32_t num_colors = 0;
+  uint32_t largest_color_size = 0;
+  for (const auto& size : sizes) {
+    uint32_t s = size.load(std::memory_order_relaxed);
+    num_colors += s > 0;
+    largest_color_size = std::max(largest_color_size, s);
+  }
+  return GraphColoringStatistics{num_colors, largest_color_size};
+}
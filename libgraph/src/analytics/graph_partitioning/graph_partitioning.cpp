@@ -0,0 +1,673 @@
+#include "katana/analytics/graph_partitioning/graph_partitioning.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/ErrorCode.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+const double GraphPartitioningPlan::kDefaultImbalance = 1.03;
+const uint32_t GraphPartitioningPlan::kDefaultRefineIterations = 10;
+const uint64_t GraphPartitioningPlan::kDefaultSeed = 0;
+
+namespace {
+
+struct PartId : public katana::PODProperty<uint32_t> {};
+
+constexpr uint32_t kNoNode = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t kNoPart = std::numeric_limits<uint32_t>::max();
+constexpr uint64_t kNoPosition = std::numeric_limits<uint64_t>::max();
+
+/// Coarsening stops at this many nodes per part, at kMaxLevels levels or
+/// when a level merges fewer than kMinCoarsening of the nodes
+constexpr uint64_t kCoarsestNodesPerPart = 20;
+constexpr size_t kMaxLevels = 64;
+constexpr double kMinCoarsening = 0.05;
+/// Coarse nodes weigh at most this many times the average node of the
+/// coarsest graph, so that the coarsest graph can still be balanced
+constexpr double kMaxCoarseNodeWeight = 1.5;
+/// The coarsest graph is partitioned from this many random seeds and the
+/// smallest cut is kept
+constexpr uint32_t kInitialTries = 4;
+
+/// One level of the multilevel scheme: an undirected graph in CSR form, with
+/// both directions of each edge, weights and no self loops
+struct Level {
+  /// NumNodes() + 1 entries; the edges of u are [offsets[u], offsets[u + 1])
+  std::vector<uint64_t> offsets;
+  std::vector<uint32_t> dests;
+  std::vector<uint64_t> edge_weights;
+  std::vector<uint64_t> node_weights;
+  /// The node of the next coarser level that each node is merged into
+  std::vector<uint32_t> coarse_node;
+
+  uint32_t NumNodes() const { return node_weights.size(); }
+};
+
+/// The undirected graph of topo. Parallel edges, in either direction, are
+/// merged into one edge weighted by their number.
+Level
+MakeFinestLevel(const katana::GraphTopology& topo, bool balance_edges) {
+  uint32_t num_nodes = topo.NumNodes();
+  Level level;
+  level.node_weights.resize(num_nodes);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t u) {
+        level.node_weights[u] = balance_edges ? 1 + topo.OutDegree(u) : 1;
+      },
+      katana::loopname("GraphPartitioning Node Weights"), katana::no_stats());
+
+  std::vector<uint64_t> offsets(num_nodes + 1, 0);
+  for (auto u : topo.Nodes()) {
+    for (auto e : topo.OutEdges(u)) {
+      uint32_t v = topo.OutEdgeDst(e);
+      if (u != v) {
+        ++offsets[u + 1];
+        ++offsets[v + 1];
+      }
+    }
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<uint64_t> cursor(offsets.begin(), offsets.end() - 1);
+  std::vector<uint32_t> dests(offsets.back());
+  for (auto u : topo.Nodes()) {
+    for (auto e : topo.OutEdges(u)) {
+      uint32_t v = topo.OutEdgeDst(e);
+      if (u != v) {
+        dests[cursor[u]++] = v;
+        dests[cursor[v]++] = u;
+      }
+    }
+  }
+
+  // Merge the copies of each edge in place, then compact
+  std::vector<uint64_t> weights(dests.size());
+  std::vector<uint64_t> merged(num_nodes + 1, 0);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t u) {
+        uint64_t begin = offsets[u];
+        uint64_t out = begin;
+        std::sort(dests.begin() + begin, dests.begin() + offsets[u + 1]);
+        for (uint64_t e = begin; e < offsets[u + 1]; ++e) {
+          if (out > begin && dests[out - 1] == dests[e]) {
+            ++weights[out - 1];
+          } else {
+            dests[out] = dests[e];
+            weights[out] = 1;
+            ++out;
+          }
+        }
+        merged[u + 1] = out - begin;
+      },
+      katana::steal(), katana::loopname("GraphPartitioning Merge Edges"),
+      katana::no_stats());
+  std::partial_sum(merged.begin(), merged.end(), merged.begin());
+
+  level.dests.resize(merged.back());
+  level.edge_weights.resize(merged.back());
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t u) {
+        std::copy(
+            dests.begin() + offsets[u],
+            dests.begin() + offsets[u] + merged[u + 1] - merged[u],
+            level.dests.begin() + merged[u]);
+        std::copy(
+            weights.begin() + offsets[u],
+            weights.begin() + offsets[u] + merged[u + 1] - merged[u],
+            level.edge_weights.begin() + merged[u]);
+      },
+      katana::loopname("GraphPartitioning Compact Edges"), katana::no_stats());
+  level.offsets = std::move(merged);
+  return level;
+}
+
+/// Match each node of fine, visited in random order, with the unmatched
+/// neighbor it shares the heaviest edge with, and merge the pairs. Sets the
+/// coarse nodes of fine and returns the coarser level.
+Level
+Coarsen(Level* fine, uint64_t max_node_weight, std::mt19937_64* rng) {
+  uint32_t num_nodes = fine->NumNodes();
+  std::vector<uint32_t> order(num_nodes);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), *rng);
+
+  std::vector<uint32_t> match(num_nodes, kNoNode);
+  for (uint32_t u : order) {
+    if (match[u] != kNoNode) {
+      continue;
+    }
+    uint32_t best = u;
+    uint64_t best_weight = 0;
+    for (uint64_t e = fine->offsets[u]; e < fine->offsets[u + 1]; ++e) {
+      uint32_t v = fine->dests[e];
+      if (match[v] == kNoNode && fine->edge_weights[e] > best_weight &&
+          fine->node_weights[u] + fine->node_weights[v] <= max_node_weight) {
+        best = v;
+        best_weight = fine->edge_weights[e];
+      }
+    }
+    match[u] = best;
+    match[best] = u;
+  }
+
+  // Coarse nodes are numbered in the order of their smaller fine node
+  fine->coarse_node.resize(num_nodes);
+  std::vector<uint32_t> firsts;
+  for (uint32_t u = 0; u < num_nodes; ++u) {
+    if (u <= match[u]) {
+      fine->coarse_node[u] = firsts.size();
+      fine->coarse_node[match[u]] = firsts.size();
+      firsts.emplace_back(u);
+    }
+  }
+
+  uint32_t num_coarse = firsts.size();
+  Level coarse;
+  coarse.node_weights.resize(num_coarse, 0);
+  coarse.offsets.reserve(num_coarse + 1);
+  coarse.offsets.emplace_back(0);
+  // Where the edge from the current coarse node to each coarse node is, if
+  // it is at or after the first edge of the current node
+  std::vector<uint64_t> position(num_coarse, kNoPosition);
+  for (uint32_t c = 0; c < num_coarse; ++c) {
+    uint64_t begin = coarse.dests.size();
+    uint32_t members[2] = {firsts[c], match[firsts[c]]};
+    for (uint32_t i = 0; i < (members[0] == members[1] ? 1 : 2); ++i) {
+      uint32_t u = members[i];
+      coarse.node_weights[c] += fine->node_weights[u];
+      for (uint64_t e = fine->offsets[u]; e < fine->offsets[u + 1]; ++e) {
+        uint32_t dest = fine->coarse_node[fine->dests[e]];
+        if (dest == c) {
+          continue;
+        }
+        if (position[dest] != kNoPosition && position[dest] >= begin) {
+          coarse.edge_weights[position[dest]] += fine->edge_weights[e];
+        } else {
+          position[dest] = coarse.dests.size();
+          coarse.dests.emplace_back(dest);
+          coarse.edge_weights.emplace_back(fine->edge_weights[e]);
+        }
+      }
+    }
+    coarse.offsets.emplace_back(coarse.dests.size());
+  }
+  return coarse;
+}
+
+/// The total weight of the edges between parts
+uint64_t
+CutWeight(const Level& graph, const std::vector<uint32_t>& parts) {
+  katana::GAccumulator<uint64_t> cut;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, graph.NumNodes()),
+      [&](uint32_t u) {
+        for (uint64_t e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+          if (parts[graph.dests[e]] != parts[u]) {
+            cut += graph.edge_weights[e];
+          }
+        }
+      },
+      katana::loopname("GraphPartitioning Cut"), katana::no_stats());
+  // Each cut edge is seen from both ends
+  return cut.reduce() / 2;
+}
+
+std::vector<uint64_t>
+PartWeights(
+    const Level& graph, const std::vector<uint32_t>& parts,
+    uint32_t num_parts) {
+  std::vector<uint64_t> weights(num_parts, 0);
+  for (uint32_t u = 0; u < graph.NumNodes(); ++u) {
+    weights[parts[u]] += graph.node_weights[u];
+  }
+  return weights;
+}
+
+/// Grow parts one at a time from random seeds, each taking the unassigned
+/// node most connected to it until it has its share of the weight left. The
+/// last part takes the nodes left.
+std::vector<uint32_t>
+GrowParts(
+    const Level& graph, uint32_t num_parts, uint64_t total_weight,
+    std::mt19937_64* rng) {
+  uint32_t num_nodes = graph.NumNodes();
+  std::vector<uint32_t> parts(num_nodes, kNoPart);
+  std::vector<uint64_t> connection(num_nodes, 0);
+  std::vector<uint32_t> seeds(num_nodes);
+  std::iota(seeds.begin(), seeds.end(), 0);
+  std::shuffle(seeds.begin(), seeds.end(), *rng);
+  size_t next_seed = 0;
+
+  uint64_t assigned = 0;
+  for (uint32_t p = 0; p + 1 < num_parts; ++p) {
+    uint64_t target = (total_weight - assigned) / (num_parts - p);
+    uint64_t weight = 0;
+    // Entries are stale once the connection of their node has grown
+    std::priority_queue<std::pair<uint64_t, uint32_t>> frontier;
+    std::vector<uint32_t> touched;
+    while (weight < target) {
+      uint32_t u = kNoNode;
+      while (u == kNoNode && !frontier.empty()) {
+        auto [conn, v] = frontier.top();
+        frontier.pop();
+        if (parts[v] == kNoPart && conn == connection[v]) {
+          u = v;
+        }
+      }
+      if (u == kNoNode) {
+        // Start another region of the part from a random node
+        while (next_seed < num_nodes && parts[seeds[next_seed]] != kNoPart) {
+          ++next_seed;
+        }
+        if (next_seed == num_nodes) {
+          break;
+        }
+        u = seeds[next_seed];
+      }
+
+      parts[u] = p;
+      weight += graph.node_weights[u];
+      for (uint64_t e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+        uint32_t v = graph.dests[e];
+        if (parts[v] != kNoPart) {
+          continue;
+        }
+        if (connection[v] == 0) {
+          touched.emplace_back(v);
+        }
+        connection[v] += graph.edge_weights[e];
+        frontier.emplace(connection[v], v);
+      }
+    }
+    for (uint32_t v : touched) {
+      connection[v] = 0;
+    }
+    assigned += weight;
+  }
+
+  for (uint32_t& part : parts) {
+    if (part == kNoPart) {
+      part = num_parts - 1;
+    }
+  }
+  return parts;
+}
+
+/// Greedy k-way refinement: move boundary nodes to the neighboring part they
+/// are most connected to when that cuts less weight, or the same weight with
+/// a better balance, without taking the part over max_part_weight. Nodes of
+/// parts over max_part_weight move out even when that cuts more.
+///
+/// The nodes that may move are found in parallel; moves are then made one
+/// at a time with their gains computed against the current parts.
+uint64_t
+Refine(
+    const Level& graph, uint32_t num_parts, uint64_t max_part_weight,
+    uint32_t iterations, std::vector<uint32_t>* parts) {
+  std::vector<uint64_t> part_weights = PartWeights(graph, *parts, num_parts);
+  std::vector<uint64_t> connection(num_parts, 0);
+  std::vector<uint32_t> neighbor_parts;
+  uint64_t total_moves = 0;
+
+  for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+    katana::InsertBag<uint32_t> boundary;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, graph.NumNodes()),
+        [&](uint32_t u) {
+          uint32_t part = (*parts)[u];
+          bool movable = part_weights[part] > max_part_weight;
+          for (uint64_t e = graph.offsets[u];
+               !movable && e < graph.offsets[u + 1]; ++e) {
+            movable = (*parts)[graph.dests[e]] != part;
+          }
+          if (movable) {
+            boundary.emplace(u);
+          }
+        },
+        katana::steal(), katana::loopname("GraphPartitioning Boundary"),
+        katana::no_stats());
+    // Visit in node order so that results do not depend on threads
+    std::vector<uint32_t> candidates(boundary.begin(), boundary.end());
+    std::sort(candidates.begin(), candidates.end());
+
+    uint64_t moves = 0;
+    for (uint32_t u : candidates) {
+      uint32_t from = (*parts)[u];
+      uint64_t weight = graph.node_weights[u];
+      for (uint64_t e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+        uint32_t part = (*parts)[graph.dests[e]];
+        if (connection[part] == 0) {
+          neighbor_parts.emplace_back(part);
+        }
+        connection[part] += graph.edge_weights[e];
+      }
+
+      uint32_t to = kNoPart;
+      for (uint32_t part : neighbor_parts) {
+        if (part == from || part_weights[part] + weight > max_part_weight) {
+          continue;
+        }
+        if (to == kNoPart || connection[part] > connection[to] ||
+            (connection[part] == connection[to] &&
+             part_weights[part] < part_weights[to])) {
+          to = part;
+        }
+      }
+      bool overweight = part_weights[from] > max_part_weight;
+      if (to == kNoPart && overweight) {
+        auto lightest = static_cast<uint32_t>(
+            std::min_element(part_weights.begin(), part_weights.end()) -
+            part_weights.begin());
+        if (lightest != from &&
+            part_weights[lightest] + weight <= max_part_weight) {
+          to = lightest;
+        }
+      }
+
+      bool move = false;
+      if (to != kNoPart) {
+        uint64_t internal = connection[from];
+        move = overweight || connection[to] > internal ||
+               (connection[to] == internal &&
+                part_weights[to] + weight < part_weights[from]);
+      }
+      for (uint32_t part : neighbor_parts) {
+        connection[part] = 0;
+      }
+      neighbor_parts.clear();
+
+      if (move) {
+        (*parts)[u] = to;
+        part_weights[from] -= weight;
+        part_weights[to] += weight;
+        ++moves;
+      }
+    }
+
+    total_moves += moves;
+    if (moves == 0) {
+      break;
+    }
+  }
+  return total_moves;
+}
+
+/// How far the heaviest part is over max_part_weight
+uint64_t
+Overweight(
+    const Level& graph, const std::vector<uint32_t>& parts, uint32_t num_parts,
+    uint64_t max_part_weight) {
+  std::vector<uint64_t> weights = PartWeights(graph, parts, num_parts);
+  uint64_t heaviest = *std::max_element(weights.begin(), weights.end());
+  return heaviest > max_part_weight ? heaviest - max_part_weight : 0;
+}
+
+/// The part of each node of topo
+std::vector<uint32_t>
+MultilevelPartition(
+    const katana::GraphTopology& topo, uint32_t num_parts,
+    const GraphPartitioningPlan& plan) {
+  if (topo.NumNodes() == 0 || num_parts == 1) {
+    return std::vector<uint32_t>(topo.NumNodes(), 0);
+  }
+
+  std::mt19937_64 rng(plan.seed());
+  std::vector<Level> levels;
+  levels.emplace_back(MakeFinestLevel(topo, plan.balance_edges()));
+  uint64_t total_weight = std::accumulate(
+      levels.front().node_weights.begin(), levels.front().node_weights.end(),
+      uint64_t{0});
+  auto max_part_weight = static_cast<uint64_t>(
+      std::ceil(plan.imbalance() * total_weight / num_parts));
+
+  uint64_t coarsest_nodes = kCoarsestNodesPerPart * num_parts;
+  auto max_node_weight = std::max<uint64_t>(
+      1, static_cast<uint64_t>(
+             kMaxCoarseNodeWeight * total_weight / coarsest_nodes));
+  while (levels.back().NumNodes() > coarsest_nodes &&
+         levels.size() < kMaxLevels) {
+    Level coarse = Coarsen(&levels.back(), max_node_weight, &rng);
+    if (coarse.NumNodes() >
+        (1 - kMinCoarsening) * levels.back().NumNodes()) {
+      levels.back().coarse_node.clear();
+      break;
+    }
+    levels.emplace_back(std::move(coarse));
+  }
+  katana::ReportStatSingle("GraphPartitioning", "Levels", levels.size());
+
+  const Level& coarsest = levels.back();
+  std::vector<uint32_t> parts;
+  std::pair<uint64_t, uint64_t> best_score;
+  for (uint32_t i = 0; i < kInitialTries; ++i) {
+    std::vector<uint32_t> candidate =
+        GrowParts(coarsest, num_parts, total_weight, &rng);
+    Refine(
+        coarsest, num_parts, max_part_weight, plan.refine_iterations(),
+        &candidate);
+    std::pair<uint64_t, uint64_t> score{
+        Overweight(coarsest, candidate, num_parts, max_part_weight),
+        CutWeight(coarsest, candidate)};
+    if (parts.empty() || score < best_score) {
+      parts = std::move(candidate);
+      best_score = score;
+    }
+  }
+
+  uint64_t moves = 0;
+  while (levels.size() > 1) {
+    levels.pop_back();
+    const Level& fine = levels.back();
+    std::vector<uint32_t> fine_parts(fine.NumNodes());
+    katana::do_all(
+        katana::iterate(uint32_t{0}, fine.NumNodes()),
+        [&](uint32_t u) { fine_parts[u] = parts[fine.coarse_node[u]]; },
+        katana::loopname("GraphPartitioning Project"), katana::no_stats());
+    parts = std::move(fine_parts);
+    moves += Refine(
+        fine, num_parts, max_part_weight, plan.refine_iterations(), &parts);
+  }
+  katana::ReportStatSingle("GraphPartitioning", "Moves", moves);
+  katana::ReportStatSingle(
+      "GraphPartitioning", "CutWeight", CutWeight(levels.front(), parts));
+
+  return parts;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::GraphPartitioning(
+    katana::PropertyGraph* pg, uint32_t num_parts,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    GraphPartitioningPlan plan) {
+  if (num_parts == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "num_parts must be positive");
+  }
+  if (!(plan.imbalance() >= 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "imbalance must be at least 1, not {}", plan.imbalance());
+  }
+
+  katana::StatTimer exec_time("GraphPartitioning");
+  exec_time.start();
+  std::vector<uint32_t> parts;
+  switch (plan.algorithm()) {
+  case GraphPartitioningPlan::kMultilevel:
+    parts = MultilevelPartition(pg->topology(), num_parts, plan);
+    break;
+  default:
+    return katana::ErrorCode::AssertionFailed;
+  }
+  exec_time.stop();
+
+  if (plan.cut_kind() == GraphPartitioningPlan::kEdgeCut) {
+    KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<PartId>>(
+        txn_ctx, {output_property_name}));
+    using Graph = katana::TypedPropertyGraph<std::tuple<PartId>, std::tuple<>>;
+    auto graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const Graph::Node& node) {
+          graph.GetData<PartId>(node) = parts[node];
+        },
+        katana::loopname("GraphPartitioning Node Parts"), katana::no_stats());
+    return katana::ResultSuccess();
+  }
+
+  KATANA_CHECKED(pg->ConstructEdgeProperties<std::tuple<PartId>>(
+      txn_ctx, {output_property_name}));
+  using Graph = katana::TypedPropertyGraph<std::tuple<>, std::tuple<PartId>>;
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {}, {output_property_name}));
+  // Edges whose endpoints disagree go to the part with fewer edges so far
+  std::vector<uint64_t> part_edges(num_parts, 0);
+  for (auto node : graph) {
+    for (auto e : graph.OutEdges(node)) {
+      uint32_t src_part = parts[node];
+      uint32_t dst_part = parts[graph.OutEdgeDst(e)];
+      uint32_t part = part_edges[dst_part] < part_edges[src_part]
+                          ? dst_part
+                          : src_part;
+      graph.GetEdgeData<PartId>(e) = part;
+      ++part_edges[part];
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+// Doxygen doesn't correctly handle implementation annotations that do not
+// appear in the declaration.
+/// \cond DO_NOT_DOCUMENT
+katana::Result<void>
+katana::analytics::GraphPartitioningAssertValid(
+    katana::PropertyGraph* pg, uint32_t num_parts,
+    const std::string& property_name, GraphPartitioningPlan plan) {
+  auto stats = KATANA_CHECKED(GraphPartitioningStatistics::Compute(
+      pg, num_parts, property_name, plan));
+  if (plan.cut_kind() == GraphPartitioningPlan::kEdgeCut &&
+      pg->NumNodes() >= num_parts) {
+    for (uint32_t p = 0; p < num_parts; ++p) {
+      if (stats.part_nodes[p] == 0) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed, "part {} is empty", p);
+      }
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<GraphPartitioningStatistics>
+katana::analytics::GraphPartitioningStatistics::Compute(
+    katana::PropertyGraph* pg, uint32_t num_parts,
+    const std::string& property_name, GraphPartitioningPlan plan) {
+  const katana::GraphTopology& topo = pg->topology();
+  GraphPartitioningStatistics stats;
+  stats.part_nodes.resize(num_parts, 0);
+  stats.part_edges.resize(num_parts, 0);
+  stats.cut_edges = 0;
+
+  auto check_part = [num_parts](uint32_t part) -> katana::Result<void> {
+    if (part >= num_parts) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "part {} is not below the {} parts", part, num_parts);
+    }
+    return katana::ResultSuccess();
+  };
+
+  // The distinct parts that hold each node
+  std::vector<std::vector<uint32_t>> holders(topo.NumNodes());
+  if (plan.cut_kind() == GraphPartitioningPlan::kEdgeCut) {
+    using Graph = katana::TypedPropertyGraph<std::tuple<PartId>, std::tuple<>>;
+    auto graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+    for (auto node : graph) {
+      uint32_t part = graph.GetData<PartId>(node);
+      KATANA_CHECKED(check_part(part));
+      ++stats.part_nodes[part];
+      stats.part_edges[part] += topo.OutDegree(node);
+      holders[node].emplace_back(part);
+      for (auto e : graph.OutEdges(node)) {
+        auto dst = graph.OutEdgeDst(e);
+        if (graph.GetData<PartId>(dst) != part) {
+          ++stats.cut_edges;
+          holders[dst].emplace_back(part);
+        }
+      }
+    }
+  } else {
+    using Graph = katana::TypedPropertyGraph<std::tuple<>, std::tuple<PartId>>;
+    auto graph = KATANA_CHECKED(Graph::Make(pg, {}, {property_name}));
+    for (auto node : graph) {
+      for (auto e : graph.OutEdges(node)) {
+        uint32_t part = graph.GetEdgeData<PartId>(e);
+        KATANA_CHECKED(check_part(part));
+        ++stats.part_edges[part];
+        holders[node].emplace_back(part);
+        holders[graph.OutEdgeDst(e)].emplace_back(part);
+      }
+    }
+  }
+
+  uint64_t replicas = 0;
+  for (auto& parts : holders) {
+    std::sort(parts.begin(), parts.end());
+    parts.erase(std::unique(parts.begin(), parts.end()), parts.end());
+    if (plan.cut_kind() == GraphPartitioningPlan::kVertexCut) {
+      for (uint32_t part : parts) {
+        ++stats.part_nodes[part];
+      }
+    }
+    // A node without edges is still held by one part
+    replicas += std::max<size_t>(1, parts.size());
+  }
+
+  auto imbalance = [num_parts](const std::vector<uint64_t>& counts) {
+    uint64_t total = std::accumulate(counts.begin(), counts.end(), uint64_t{0});
+    if (total == 0) {
+      return 1.0;
+    }
+    uint64_t largest = *std::max_element(counts.begin(), counts.end());
+    return static_cast<double>(largest) * num_parts / total;
+  };
+  stats.node_imbalance = imbalance(stats.part_nodes);
+  stats.edge_imbalance = imbalance(stats.part_edges);
+  stats.replication_factor =
+      topo.NumNodes() == 0
+          ? 1.0
+          : static_cast<double>(replicas) / topo.NumNodes();
+  return stats;
+}
+/// \endcond DO_NOT_DOCUMENT
+
+std::vector<uint64_t>
+katana::analytics::GraphPartitioningStatistics::NodeBoundaries() const {
+  std::vector<uint64_t> boundaries{0};
+  for (uint64_t nodes : part_nodes) {
+    boundaries.emplace_back(boundaries.back() + nodes);
+  }
+  return boundaries;
+}
+
+void
+katana::analytics::GraphPartitioningStatistics::Print(std::ostream& os) const {
+  os << "Number of parts = " << part_nodes.size() << std::endl;
+  os << "Cut edges = " << cut_edges << std::endl;
+  os << "Node imbalance = " << node_imbalance << std::endl;
+  os << "Edge imbalance = " << edge_imbalance << std::endl;
+  os << "Replication factor = " << replication_factor << std::endl;
+}
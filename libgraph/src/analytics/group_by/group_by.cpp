@@ -0,0 +1,303 @@
+#include "katana/analytics/group_by/group_by.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+#include <arrow/compute/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// The aggregate of the values of a property over a group
+struct ValueAggregate {
+  uint64_t count{};
+  double sum{};
+  double min{std::numeric_limits<double>::infinity()};
+  double max{-std::numeric_limits<double>::infinity()};
+
+  void Add(double value) {
+    ++count;
+    sum += value;
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+
+  void Merge(const ValueAggregate& other) {
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+  }
+};
+
+struct GroupAggregate {
+  uint64_t num_nodes{};
+  uint64_t internal_edges{};
+  uint64_t cut_edges{};
+  /// Indexed like the aggregates requested
+  std::vector<ValueAggregate> values;
+
+  void Merge(const GroupAggregate& other) {
+    num_nodes += other.num_nodes;
+    internal_edges += other.internal_edges;
+    cut_edges += other.cut_edges;
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i].Merge(other.values[i]);
+    }
+  }
+};
+
+/// The groups a thread has seen, by key
+using GroupTable = std::unordered_map<int64_t, GroupAggregate>;
+
+const char*
+FunctionName(GroupByAggregate::Function function) {
+  switch (function) {
+  case GroupByAggregate::kCount:
+    return "count";
+  case GroupByAggregate::kSum:
+    return "sum";
+  case GroupByAggregate::kMin:
+    return "min";
+  case GroupByAggregate::kMax:
+    return "max";
+  case GroupByAggregate::kMean:
+    return "mean";
+  }
+  return "unknown";
+}
+
+/// \returns the values of property as one array of type. The cast is
+/// unsafe, so unsigned keys keep their bits as int64 and can be cast back.
+katana::Result<std::shared_ptr<arrow::Array>>
+CastProperty(
+    const std::shared_ptr<arrow::ChunkedArray>& property,
+    const std::shared_ptr<arrow::DataType>& type) {
+  arrow::Datum cast = KATANA_CHECKED(arrow::compute::Cast(
+      property, type, arrow::compute::CastOptions::Unsafe()));
+  return KATANA_CHECKED(katana::UnchunkedArray(cast.chunked_array()));
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+GroupByHash(
+    katana::PropertyGraph* pg, const std::string& key_property_name,
+    const std::vector<GroupByAggregate>& aggregates, bool cut_metrics) {
+  std::shared_ptr<arrow::ChunkedArray> key_property =
+      KATANA_CHECKED(pg->GetNodeProperty(key_property_name));
+  std::shared_ptr<arrow::DataType> key_type = key_property->type();
+  if (!arrow::is_integer(key_type->id())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "key property {} is of type {}, not an integer", key_property_name,
+        key_type->ToString());
+  }
+  auto keys = std::static_pointer_cast<arrow::Int64Array>(
+      KATANA_CHECKED(CastProperty(key_property, arrow::int64())));
+
+  // cast each property once, however many aggregates read it
+  std::unordered_map<std::string, std::shared_ptr<arrow::DoubleArray>> cast;
+  std::vector<const arrow::DoubleArray*> values;
+  for (const GroupByAggregate& aggregate : aggregates) {
+    auto it = cast.find(aggregate.property_name);
+    if (it == cast.end()) {
+      std::shared_ptr<arrow::ChunkedArray> property =
+          KATANA_CHECKED(pg->GetNodeProperty(aggregate.property_name));
+      auto type_id = property->type()->id();
+      if (!arrow::is_integer(type_id) && !arrow::is_floating(type_id)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "property {} is of type {}, not a number", aggregate.property_name,
+            property->type()->ToString());
+      }
+      auto array = std::static_pointer_cast<arrow::DoubleArray>(
+          KATANA_CHECKED(CastProperty(property, arrow::float64())));
+      it = cast.emplace(aggregate.property_name, std::move(array)).first;
+    }
+    values.emplace_back(it->second.get());
+  }
+
+  const katana::GraphTopology& topology = pg->topology();
+  katana::PerThreadStorage<GroupTable> tables;
+  katana::do_all(
+      katana::iterate(topology.Nodes()),
+      [&](Node n) {
+        uint64_t index = pg->GetNodePropertyIndex(n);
+        if (keys->IsNull(index)) {
+          return;
+        }
+        int64_t key = keys->Value(index);
+        GroupAggregate& group = (*tables.getLocal())[key];
+        if (group.num_nodes++ == 0) {
+          group.values.resize(values.size());
+        }
+        for (size_t i = 0; i < values.size(); ++i) {
+          if (values[i]->IsValid(index)) {
+            group.values[i].Add(values[i]->Value(index));
+          }
+        }
+        if (!cut_metrics) {
+          return;
+        }
+        for (auto e : topology.OutEdges(n)) {
+          uint64_t dst_index =
+              pg->GetNodePropertyIndex(topology.OutEdgeDst(e));
+          if (keys->IsValid(dst_index) && keys->Value(dst_index) == key) {
+            ++group.internal_edges;
+          } else {
+            ++group.cut_edges;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("GroupBy"));
+
+  GroupTable merged;
+  for (unsigned t = 0; t < tables.size(); ++t) {
+    for (auto& [key, group] : *tables.getRemote(t)) {
+      auto [it, inserted] = merged.try_emplace(key, std::move(group));
+      if (!inserted) {
+        it->second.Merge(group);
+      }
+    }
+  }
+
+  std::vector<int64_t> group_keys;
+  group_keys.reserve(merged.size());
+  uint64_t total_volume = 0;
+  for (const auto& [key, group] : merged) {
+    group_keys.emplace_back(key);
+    total_volume += group.internal_edges + group.cut_edges;
+  }
+  if (arrow::is_unsigned_integer(key_type->id())) {
+    std::sort(group_keys.begin(), group_keys.end(), [](int64_t a, int64_t b) {
+      return static_cast<uint64_t>(a) < static_cast<uint64_t>(b);
+    });
+  } else {
+    std::sort(group_keys.begin(), group_keys.end());
+  }
+
+  arrow::Int64Builder key_builder;
+  arrow::UInt64Builder count_builder;
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> aggregate_builders;
+  for (const GroupByAggregate& aggregate : aggregates) {
+    if (aggregate.function == GroupByAggregate::kCount) {
+      aggregate_builders.emplace_back(std::make_unique<arrow::UInt64Builder>());
+    } else {
+      aggregate_builders.emplace_back(std::make_unique<arrow::DoubleBuilder>());
+    }
+  }
+  arrow::UInt64Builder internal_builder;
+  arrow::UInt64Builder cut_builder;
+  arrow::UInt64Builder volume_builder;
+  arrow::DoubleBuilder conductance_builder;
+
+  for (int64_t key : group_keys) {
+    const GroupAggregate& group = merged.at(key);
+    KATANA_CHECKED(key_builder.Append(key));
+    KATANA_CHECKED(count_builder.Append(group.num_nodes));
+    for (size_t i = 0; i < aggregates.size(); ++i) {
+      const ValueAggregate& value = group.values[i];
+      if (aggregates[i].function == GroupByAggregate::kCount) {
+        auto* builder =
+            static_cast<arrow::UInt64Builder*>(aggregate_builders[i].get());
+        KATANA_CHECKED(builder->Append(value.count));
+        continue;
+      }
+      auto* builder =
+          static_cast<arrow::DoubleBuilder*>(aggregate_builders[i].get());
+      if (value.count == 0) {
+        KATANA_CHECKED(builder->AppendNull());
+        continue;
+      }
+      switch (aggregates[i].function) {
+      case GroupByAggregate::kSum:
+        KATANA_CHECKED(builder->Append(value.sum));
+        break;
+      case GroupByAggregate::kMin:
+        KATANA_CHECKED(builder->Append(value.min));
+        break;
+      case GroupByAggregate::kMax:
+        KATANA_CHECKED(builder->Append(value.max));
+        break;
+      case GroupByAggregate::kMean:
+        KATANA_CHECKED(builder->Append(value.sum / value.count));
+        break;
+      default:
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "unknown aggregate function");
+      }
+    }
+    if (cut_metrics) {
+      uint64_t volume = group.internal_edges + group.cut_edges;
+      KATANA_CHECKED(internal_builder.Append(group.internal_edges));
+      KATANA_CHECKED(cut_builder.Append(group.cut_edges));
+      KATANA_CHECKED(volume_builder.Append(volume));
+      uint64_t smaller = std::min(volume, total_volume - volume);
+      if (smaller == 0) {
+        KATANA_CHECKED(conductance_builder.AppendNull());
+      } else {
+        KATANA_CHECKED(conductance_builder.Append(
+            static_cast<double>(group.cut_edges) / smaller));
+      }
+    }
+  }
+
+  std::shared_ptr<arrow::Array> key_array =
+      KATANA_CHECKED(key_builder.Finish());
+  arrow::Datum key_column = KATANA_CHECKED(arrow::compute::Cast(
+      key_array, key_type, arrow::compute::CastOptions::Unsafe()));
+
+  std::vector<std::shared_ptr<arrow::Field>> fields{
+      arrow::field(key_property_name, key_type),
+      arrow::field("count", arrow::uint64()),
+  };
+  std::vector<std::shared_ptr<arrow::Array>> columns{
+      key_column.make_array(),
+      KATANA_CHECKED(count_builder.Finish()),
+  };
+  for (size_t i = 0; i < aggregates.size(); ++i) {
+    std::shared_ptr<arrow::Array> column =
+        KATANA_CHECKED(aggregate_builders[i]->Finish());
+    fields.emplace_back(arrow::field(
+        fmt::format(
+            "{}_{}", FunctionName(aggregates[i].function),
+            aggregates[i].property_name),
+        column->type()));
+    columns.emplace_back(std::move(column));
+  }
+  if (cut_metrics) {
+    fields.emplace_back(arrow::field("internal_edges", arrow::uint64()));
+    columns.emplace_back(KATANA_CHECKED(internal_builder.Finish()));
+    fields.emplace_back(arrow::field("cut_edges", arrow::uint64()));
+    columns.emplace_back(KATANA_CHECKED(cut_builder.Finish()));
+    fields.emplace_back(arrow::field("volume", arrow::uint64()));
+    columns.emplace_back(KATANA_CHECKED(volume_builder.Finish()));
+    fields.emplace_back(arrow::field("conductance", arrow::float64()));
+    columns.emplace_back(KATANA_CHECKED(conductance_builder.Finish()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+}  // namespace
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::analytics::GroupBy(
+    katana::PropertyGraph* pg, const std::string& key_property_name,
+    const std::vector<GroupByAggregate>& aggregates, bool cut_metrics,
+    GroupByPlan plan) {
+  switch (plan.algorithm()) {
+  case GroupByPlan::kHash:
+    return GroupByHash(pg, key_property_name, aggregates, cut_metrics);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown group by algorithm");
+  }
+}
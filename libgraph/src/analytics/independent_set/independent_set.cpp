@@ -32,20 +32,16 @@
 #include "katana/Timer.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
+#include "priority.h"
 
 namespace {
 
 using namespace katana::analytics;
 
-constexpr int kChunkSize = 64;
-constexpr float kHashScale = 1.0 / std::numeric_limits<unsigned int>::max();
+using katana::analytics::internal::HashNode;
+using katana::analytics::internal::kHashScale;
 
-unsigned int
-hash(unsigned int val) {
-  val = ((val >> 16) ^ val) * 0x45d9f3b;
-  val = ((val >> 16) ^ val) * 0x45d9f3b;
-  return (val >> 16) ^ val;
-}
+constexpr int kChunkSize = 64;
 
 enum MatchFlag : char {
   KOtherMatched = false,
@@ -351,7 +347,7 @@ struct PrioAlgo {
         [&](const GNode& src) {
           auto& src_flag = graph->GetData<NodeFlag>(src);
           float degree = graph->OutEdges(src).size();
-          float x = degree - hash(src) * kHashScale;
+          float x = degree - HashNode(src) * kHashScale;
           int res = round(scale_avg / (avg_degree + x));
           uint8_t val = (res + res) | 1;
           src_flag = val;
@@ -452,7 +448,7 @@ struct EdgeTiledPrioAlgo {
           const auto end = rng.end();
 
           float degree = float(graph->OutDegree(src));
-          float x = degree - hash(src) * kHashScale;
+          float x = degree - HashNode(src) * kHashScale;
           int res = round(scale_avg / (avg_degree + x));
           uint8_t val = (res + res) | 0x03;
 
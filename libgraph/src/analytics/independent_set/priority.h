@@ -0,0 +1,40 @@
+#ifndef KATANA_LIBGRAPH_ANALYTICS_INDEPENDENTSET_PRIORITY_H_
+#define KATANA_LIBGRAPH_ANALYTICS_INDEPENDENTSET_PRIORITY_H_
+
+#include <cstdint>
+#include <limits>
+
+/// The pseudo-random priorities of nodes that the priority algorithms of
+/// IndependentSet and GraphColoring use to decide between neighbors without
+/// coordination
+namespace katana::analytics::internal {
+
+constexpr float kHashScale = 1.0 / std::numeric_limits<unsigned int>::max();
+
+/// \returns a well-mixed hash of node, which is the same across runs
+inline unsigned int
+HashNode(unsigned int val) {
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  return (val >> 16) ^ val;
+}
+
+/// \returns true if node a, of degree a_degree, comes before node b, of
+/// degree b_degree, in the order of larger degree first with ties broken by
+/// hash and then by ID; the order is strict and total
+inline bool
+HasPriority(uint32_t a, uint64_t a_degree, uint32_t b, uint64_t b_degree) {
+  if (a_degree != b_degree) {
+    return a_degree > b_degree;
+  }
+  unsigned int a_hash = HashNode(a);
+  unsigned int b_hash = HashNode(b);
+  if (a_hash != b_hash) {
+    return a_hash > b_hash;
+  }
+  return a > b;
+}
+
+}  // namespace katana::analytics::internal
+
+#endif
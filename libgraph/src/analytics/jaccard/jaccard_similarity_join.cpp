@@ -0,0 +1,478 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/jaccard/jaccard.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using SortedGraph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::EdgesSortedByDestID, std::tuple<>,
+    std::tuple<>>;
+using GNode = SortedGraph::Node;
+
+struct Match {
+  GNode source;
+  GNode destination;
+  double similarity;
+};
+
+/// All pairs similarity join with prefix filtering: if the similarity of x
+/// and y is at least t, they share at least ceil(t * max(|x|, |y|))
+/// neighbors, so the |x| - ceil(t * |x|) + 1 rarest neighbors of x (its
+/// prefix) and those of y have one in common. Each node probes an inverted
+/// index of the prefixes for the smaller candidates, i.e., those before it
+/// in (degree, id) order, that are large enough to reach t, and verifies them
+/// with a merge of their sorted edge lists.
+class PrefixFilterJoin {
+  /// Rounding must not make the minimum overlap larger than it is
+  static constexpr double kEpsilon = 1e-9;
+
+  const SortedGraph& graph_;
+  double threshold_;
+  /// the number of distinct neighbors of each node
+  katana::NUMAArray<uint32_t> sizes_;
+  /// the order of each node as a neighbor; rarer neighbors come first
+  katana::NUMAArray<uint32_t> ranks_;
+  /// the nodes whose prefix contains each node, in (size, id) order
+  katana::NUMAArray<uint64_t> index_offsets_;
+  katana::NUMAArray<GNode> index_;
+  katana::PerThreadStorage<std::vector<GNode>> scratch_;
+
+  uint32_t MinOverlap(uint32_t size) const {
+    auto overlap =
+        static_cast<uint32_t>(std::ceil(threshold_ * size - kEpsilon));
+    return std::max<uint32_t>(overlap, 1);
+  }
+
+  bool Precedes(GNode a, GNode b) const {
+    return sizes_[a] < sizes_[b] || (sizes_[a] == sizes_[b] && a < b);
+  }
+
+  /// Fill prefix with the prefix of node
+  void Prefix(GNode node, std::vector<GNode>* prefix) const {
+    prefix->clear();
+    uint32_t size = sizes_[node];
+    if (size == 0 || MinOverlap(size) > size) {
+      return;
+    }
+    for (auto e : graph_.OutEdges(node)) {
+      auto dst = graph_.OutEdgeDst(e);
+      if (prefix->empty() || prefix->back() != dst) {
+        prefix->emplace_back(dst);
+      }
+    }
+    size_t length = size - MinOverlap(size) + 1;
+    auto rarer = [&](GNode a, GNode b) { return ranks_[a] < ranks_[b]; };
+    std::nth_element(
+        prefix->begin(), prefix->begin() + length - 1, prefix->end(), rarer);
+    prefix->resize(length);
+  }
+
+  /// \returns the number of distinct common neighbors of a and b
+  uint32_t Overlap(GNode a, GNode b) const {
+    auto a_edges = graph_.OutEdges(a);
+    auto b_edges = graph_.OutEdges(b);
+    auto a_it = a_edges.begin();
+    auto b_it = b_edges.begin();
+    uint32_t overlap = 0;
+    while (a_it != a_edges.end() && b_it != b_edges.end()) {
+      auto a_dst = graph_.OutEdgeDst(*a_it);
+      auto b_dst = graph_.OutEdgeDst(*b_it);
+      if (a_dst < b_dst) {
+        ++a_it;
+      } else if (b_dst < a_dst) {
+        ++b_it;
+      } else {
+        ++overlap;
+        // skip duplicate edges
+        for (; a_it != a_edges.end() && graph_.OutEdgeDst(*a_it) == a_dst;
+             ++a_it) {
+        }
+        for (; b_it != b_edges.end() && graph_.OutEdgeDst(*b_it) == b_dst;
+             ++b_it) {
+        }
+      }
+    }
+    return overlap;
+  }
+
+  void CountNeighbors() {
+    katana::NUMAArray<std::atomic<uint32_t>> frequencies;
+    frequencies.allocateBlocked(graph_.NumNodes());
+    katana::ParallelSTL::fill(frequencies.begin(), frequencies.end(), 0);
+
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](const GNode& node) {
+          uint32_t size = 0;
+          GNode last = 0;
+          for (auto e : graph_.OutEdges(node)) {
+            auto dst = graph_.OutEdgeDst(e);
+            if (size == 0 || dst != last) {
+              frequencies[dst].fetch_add(1, std::memory_order_relaxed);
+              ++size;
+              last = dst;
+            }
+          }
+          sizes_[node] = size;
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("JaccardSimilarityJoin-Count"));
+
+    katana::NUMAArray<GNode> order;
+    order.allocateBlocked(graph_.NumNodes());
+    std::iota(order.begin(), order.end(), GNode{0});
+    auto rarer = [&](GNode a, GNode b) {
+      uint32_t fa = frequencies[a].load(std::memory_order_relaxed);
+      uint32_t fb = frequencies[b].load(std::memory_order_relaxed);
+      return fa < fb || (fa == fb && a < b);
+    };
+    katana::ParallelSTL::sort(order.begin(), order.end(), rarer);
+    katana::do_all(
+        katana::iterate(size_t{0}, order.size()),
+        [&](size_t i) { ranks_[order[i]] = i; }, katana::no_stats());
+  }
+
+  void BuildIndex() {
+    size_t num_nodes = graph_.NumNodes();
+    katana::NUMAArray<std::atomic<uint64_t>> cursors;
+    cursors.allocateBlocked(num_nodes + 1);
+    katana::ParallelSTL::fill(cursors.begin(), cursors.end(), 0);
+
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](const GNode& node) {
+          auto& prefix = *scratch_.getLocal();
+          Prefix(node, &prefix);
+          for (GNode token : prefix) {
+            cursors[token + 1].fetch_add(1, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("JaccardSimilarityJoin-IndexCount"));
+
+    index_offsets_[0] = 0;
+    for (size_t i = 0; i < num_nodes; ++i) {
+      index_offsets_[i + 1] = index_offsets_[i] + cursors[i + 1].load();
+      cursors[i].store(index_offsets_[i]);
+    }
+    index_.allocateBlocked(index_offsets_[num_nodes]);
+
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](const GNode& node) {
+          auto& prefix = *scratch_.getLocal();
+          Prefix(node, &prefix);
+          for (GNode token : prefix) {
+            index_[cursors[token].fetch_add(1, std::memory_order_relaxed)] =
+                node;
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("JaccardSimilarityJoin-IndexFill"));
+
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](const GNode& token) {
+          std::sort(
+              &index_[index_offsets_[token]],
+              &index_[index_offsets_[token + 1]],
+              [&](GNode a, GNode b) { return Precedes(a, b); });
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("JaccardSimilarityJoin-IndexSort"));
+  }
+
+public:
+  PrefixFilterJoin(const SortedGraph& graph, double threshold)
+      : graph_(graph), threshold_(threshold) {
+    sizes_.allocateBlocked(graph.NumNodes());
+    ranks_.allocateBlocked(graph.NumNodes());
+    index_offsets_.allocateBlocked(graph.NumNodes() + 1);
+  }
+
+  void Run(katana::InsertBag<Match>* matches) {
+    CountNeighbors();
+    BuildIndex();
+
+    katana::PerThreadStorage<std::vector<GNode>> candidates;
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](const GNode& node) {
+          auto& prefix = *scratch_.getLocal();
+          auto& found = *candidates.getLocal();
+          Prefix(node, &prefix);
+          found.clear();
+
+          uint32_t size = sizes_[node];
+          uint32_t min_size = MinOverlap(size);
+          for (GNode token : prefix) {
+            GNode* begin = &index_[index_offsets_[token]];
+            GNode* end = &index_[index_offsets_[token + 1]];
+            // Skip the candidates too small to reach the threshold
+            begin = std::partition_point(
+                begin, end, [&](GNode c) { return sizes_[c] < min_size; });
+            for (; begin != end && Precedes(*begin, node); ++begin) {
+              found.emplace_back(*begin);
+            }
+          }
+          std::sort(found.begin(), found.end());
+          found.erase(std::unique(found.begin(), found.end()), found.end());
+
+          for (GNode other : found) {
+            uint32_t overlap = Overlap(node, other);
+            if (overlap == 0) {
+              continue;
+            }
+            double similarity =
+                static_cast<double>(overlap) / (size + sizes_[other] - overlap);
+            if (similarity >= threshold_) {
+              matches->push(Match{
+                  std::min(node, other), std::max(node, other), similarity});
+            }
+          }
+        },
+        katana::steal(), katana::loopname("JaccardSimilarityJoin-Probe"));
+  }
+};
+
+/// Keep the top_k most similar other nodes of each node
+std::vector<Match>
+SelectTopK(const std::vector<Match>& pairs, uint32_t top_k) {
+  std::vector<Match> both;
+  both.reserve(2 * pairs.size());
+  for (const Match& m : pairs) {
+    both.emplace_back(m);
+    both.emplace_back(Match{m.destination, m.source, m.similarity});
+  }
+  katana::ParallelSTL::sort(
+      both.begin(), both.end(), [](const Match& a, const Match& b) {
+        if (a.source != b.source) {
+          return a.source < b.source;
+        }
+        if (a.similarity != b.similarity) {
+          return a.similarity > b.similarity;
+        }
+        return a.destination < b.destination;
+      });
+
+  std::vector<Match> top;
+  uint32_t rank = 0;
+  for (size_t i = 0; i < both.size(); ++i) {
+    rank = (i > 0 && both[i].source == both[i - 1].source) ? rank + 1 : 0;
+    if (rank < top_k) {
+      top.emplace_back(both[i]);
+    }
+  }
+  return top;
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+MakeEdgeListTable(const std::vector<Match>& matches) {
+  arrow::UInt32Builder sources;
+  arrow::UInt32Builder destinations;
+  arrow::DoubleBuilder similarities;
+  KATANA_CHECKED(sources.Reserve(matches.size()));
+  KATANA_CHECKED(destinations.Reserve(matches.size()));
+  KATANA_CHECKED(similarities.Reserve(matches.size()));
+  for (const Match& m : matches) {
+    sources.UnsafeAppend(m.source);
+    destinations.UnsafeAppend(m.destination);
+    similarities.UnsafeAppend(m.similarity);
+  }
+
+  std::shared_ptr<arrow::Array> source_array =
+      KATANA_CHECKED(sources.Finish());
+  std::shared_ptr<arrow::Array> destination_array =
+      KATANA_CHECKED(destinations.Finish());
+  std::shared_ptr<arrow::Array> similarity_array =
+      KATANA_CHECKED(similarities.Finish());
+  return arrow::Table::Make(
+      arrow::schema({
+          arrow::field("source", arrow::uint32()),
+          arrow::field("destination", arrow::uint32()),
+          arrow::field("similarity", arrow::float64()),
+      }),
+      {source_array, destination_array, similarity_array});
+}
+
+/// The values of the column name of table
+template <typename ArrayType>
+katana::Result<std::vector<typename ArrayType::value_type>>
+ReadColumn(const arrow::Table& table, const std::string& name) {
+  auto column = table.GetColumnByName(name);
+  if (!column) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "no column {}", name);
+  }
+  std::vector<typename ArrayType::value_type> values;
+  values.reserve(column->length());
+  for (const auto& chunk : column->chunks()) {
+    auto array = std::dynamic_pointer_cast<ArrayType>(chunk);
+    if (!array) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed, "column {} has type {}", name,
+          chunk->type()->ToString());
+    }
+    for (int64_t i = 0; i < array->length(); ++i) {
+      values.emplace_back(array->Value(i));
+    }
+  }
+  return values;
+}
+
+}  // namespace
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::analytics::JaccardSimilarityJoin(
+    PropertyGraph* pg, JaccardSimilarityJoinPlan plan) {
+  if (plan.algorithm() != JaccardSimilarityJoinPlan::kPrefixFilter) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm {}",
+        plan.algorithm());
+  }
+  if (!(plan.threshold() >= 0 && plan.threshold() <= 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "threshold {} must be in [0, 1]",
+        plan.threshold());
+  }
+
+  katana::ReportPageAllocGuard page_alloc;
+
+  auto graph = KATANA_CHECKED(SortedGraph::Make(pg, {}, {}));
+
+  katana::StatTimer exec_time("JaccardSimilarityJoin");
+  exec_time.start();
+  katana::InsertBag<Match> bag;
+  PrefixFilterJoin join(graph, plan.threshold());
+  join.Run(&bag);
+
+  std::vector<Match> matches(bag.begin(), bag.end());
+  if (plan.top_k() > 0) {
+    matches = SelectTopK(matches, plan.top_k());
+  } else {
+    katana::ParallelSTL::sort(
+        matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+          return a.source < b.source ||
+                 (a.source == b.source && a.destination < b.destination);
+        });
+  }
+  exec_time.stop();
+
+  return MakeEdgeListTable(matches);
+}
+
+katana::Result<void>
+katana::analytics::JaccardSimilarityJoinAssertValid(
+    PropertyGraph* pg, const std::shared_ptr<arrow::Table>& result,
+    JaccardSimilarityJoinPlan plan) {
+  auto graph = KATANA_CHECKED(SortedGraph::Make(pg, {}, {}));
+
+  // The distinct neighbors of each node and the nodes that have each node as
+  // a neighbor
+  std::vector<std::vector<GNode>> neighbors(graph.NumNodes());
+  std::vector<std::vector<GNode>> having(graph.NumNodes());
+  for (GNode node : graph) {
+    for (auto e : graph.OutEdges(node)) {
+      auto dst = graph.OutEdgeDst(e);
+      if (neighbors[node].empty() || neighbors[node].back() != dst) {
+        neighbors[node].emplace_back(dst);
+        having[dst].emplace_back(node);
+      }
+    }
+  }
+
+  // The similar nodes of each node, in the order of the rows of its top_k
+  std::vector<std::vector<Match>> similar(graph.NumNodes());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        std::unordered_map<GNode, uint32_t> overlaps;
+        for (GNode neighbor : neighbors[node]) {
+          for (GNode other : having[neighbor]) {
+            if (other != node) {
+              overlaps[other] += 1;
+            }
+          }
+        }
+        uint32_t size = neighbors[node].size();
+        for (const auto& [other, overlap] : overlaps) {
+          uint32_t other_size = neighbors[other].size();
+          double similarity =
+              static_cast<double>(overlap) / (size + other_size - overlap);
+          if (similarity >= plan.threshold()) {
+            similar[node].emplace_back(Match{node, other, similarity});
+          }
+        }
+        std::sort(
+            similar[node].begin(), similar[node].end(),
+            [](const Match& a, const Match& b) {
+              if (a.similarity != b.similarity) {
+                return a.similarity > b.similarity;
+              }
+              return a.destination < b.destination;
+            });
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<Match> expected;
+  for (GNode node : graph) {
+    if (plan.top_k() > 0) {
+      size_t k = std::min<size_t>(plan.top_k(), similar[node].size());
+      expected.insert(
+          expected.end(), similar[node].begin(), similar[node].begin() + k);
+      continue;
+    }
+    std::vector<Match> pairs;
+    for (const Match& m : similar[node]) {
+      if (m.source < m.destination) {
+        pairs.emplace_back(m);
+      }
+    }
+    std::sort(pairs.begin(), pairs.end(), [](const Match& a, const Match& b) {
+      return a.destination < b.destination;
+    });
+    expected.insert(expected.end(), pairs.begin(), pairs.end());
+  }
+
+  auto sources =
+      KATANA_CHECKED(ReadColumn<arrow::UInt32Array>(*result, "source"));
+  auto destinations =
+      KATANA_CHECKED(ReadColumn<arrow::UInt32Array>(*result, "destination"));
+  auto similarities =
+      KATANA_CHECKED(ReadColumn<arrow::DoubleArray>(*result, "similarity"));
+  if (sources.size() != expected.size() ||
+      destinations.size() != expected.size() ||
+      similarities.size() != expected.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "expected {} rows, found {}",
+        expected.size(), sources.size());
+  }
+  for (size_t i = 0; i < expected.size(); ++i) {
+    const Match& m = expected[i];
+    if (sources[i] != m.source || destinations[i] != m.destination ||
+        similarities[i] != m.similarity) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "row {} is ({}, {}, {}), expected ({}, {}, {})", i, sources[i],
+          destinations[i], similarities[i], m.source, m.destination,
+          m.similarity);
+    }
+  }
+  return katana::ResultSuccess();
+}
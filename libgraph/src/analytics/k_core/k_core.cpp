@@ -19,7 +19,14 @@
 
 #include "katana/analytics/k_core/k_core.h"
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/ErrorCode.h"
+#include "katana/Frontier.h"
+#include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 
@@ -63,15 +70,13 @@ DegreeCounting(GraphTy* graph) {
  * Setup initial worklist of dead nodes.
  *
  * @param graph Graph to operate on
- * @param initial_worklist Empty worklist to be filled with dead nodes.
+ * @param push Called concurrently with each dead node.
  * @param k_core_number Each node in the core is expected to have degree <= k_core_number.
  */
-template <typename GraphTy>
+template <typename GraphTy, typename PushFn>
 void
 SetupInitialWorklist(
-    const GraphTy& graph,
-    katana::InsertBag<typename GraphTy::Node>& initial_worklist,
-    uint32_t k_core_number) {
+    const GraphTy& graph, const PushFn& push, uint32_t k_core_number) {
   using GNode = typename GraphTy::Node;
   katana::do_all(
       katana::iterate(graph),
@@ -80,7 +85,7 @@ SetupInitialWorklist(
             graph.template GetData<KCoreNodeCurrentDegree>(node);
         if (node_current_degree < k_core_number) {
           //! Dead node, add to initial_worklist for processing later.
-          initial_worklist.emplace(node);
+          push(node);
         }
       },
       katana::loopname("InitialWorklistSetup"), katana::no_stats());
@@ -97,21 +102,21 @@ SetupInitialWorklist(
 template <typename GraphTy>
 void
 SyncCascadeKCore(GraphTy* graph, uint32_t k_core_number) {
-  using GNode = typename GraphTy::Node;
-  auto current = std::make_unique<katana::InsertBag<GNode>>();
-  auto next = std::make_unique<katana::InsertBag<GNode>>();
+  katana::Frontier current(graph->NumNodes());
+  katana::Frontier next(graph->NumNodes());
 
   //! Setup worklist.
-  SetupInitialWorklist(*graph, *next, k_core_number);
+  SetupInitialWorklist(
+      *graph, [&](auto node) { next.Push(node); }, k_core_number);
 
-  while (!next->empty()) {
-    //! Make "next" into current.
-    std::swap(current, next);
-    next->clear();
+  while (!next.empty()) {
+    //! Make "next" into current; a large cascade is scanned as a bitset.
+    current.swap(next);
+    current.Adapt();
+    next.Clear();
 
-    katana::do_all(
-        katana::iterate(*current),
-        [&](const GNode& dead_node) {
+    current.ForEach(
+        [&](katana::Frontier::Node dead_node) {
           //! Decrement degree of all neighbors.
           for (auto e : Edges(*graph, dead_node)) {
             auto dest = EdgeDst(*graph, e);
@@ -122,7 +127,7 @@ SyncCascadeKCore(GraphTy* graph, uint32_t k_core_number) {
             if (old_degree == k_core_number) {
               //! This thread was responsible for putting degree of destination
               //! below threshold; add to worklist.
-              next->emplace(dest);
+              next.Push(dest);
             }
           }
         },
@@ -145,7 +150,9 @@ AsyncCascadeKCore(GraphTy* graph, uint32_t k_core_number) {
   using GNode = typename GraphTy::Node;
   katana::InsertBag<GNode> initial_worklist;
   //! Setup worklist.
-  SetupInitialWorklist(*graph, initial_worklist, k_core_number);
+  SetupInitialWorklist(
+      *graph, [&](auto node) { initial_worklist.emplace(node); },
+      k_core_number);
 
   katana::for_each(
       katana::iterate(initial_worklist),
@@ -169,6 +176,111 @@ AsyncCascadeKCore(GraphTy* graph, uint32_t k_core_number) {
       katana::loopname("KCore Asynchronous"));
 }
 
+//! The number of consecutive levels with an open bucket in
+//! BucketCoreDecomposition. Nodes of larger degree are not in any bucket until
+//! the buckets are reopened at the next levels.
+constexpr uint64_t kOpenBuckets = 128;
+
+/**
+ * Compute the core number of every node into its degree field by peeling all
+ * nodes of core number k, for increasing k, in parallel rounds. Nodes are
+ * found through buckets of nodes by degree for kOpenBuckets levels at a
+ * time, as in Julienne.
+ *
+ * Removing a node at level k decrements the degree of its neighbors of
+ * degree more than k and moves each into the bucket of its new degree, if
+ * that is open. Degrees never drop below k, so a removed node keeps its core
+ * number in its degree field and the nodes left have degree at least k. A
+ * bucket can hold nodes whose degree has dropped since they were added;
+ * these are skipped.
+ *
+ * @param graph Graph to operate on, with degree fields from DegreeCounting
+ */
+template <typename GraphTy>
+void
+BucketCoreDecomposition(GraphTy* graph) {
+  using GNode = typename GraphTy::Node;
+  using Bucket = katana::InsertBag<GNode>;
+  std::vector<std::unique_ptr<Bucket>> buckets(kOpenBuckets);
+  for (auto& bucket : buckets) {
+    bucket = std::make_unique<Bucket>();
+  }
+  auto frontier = std::make_unique<Bucket>();
+
+  katana::GReduceMin<uint64_t> min_degree;
+  katana::GAccumulator<uint64_t> removed;
+  uint64_t num_removed = 0;
+  uint64_t rounds = 0;
+  //! Every node of core number below base is removed.
+  uint64_t base = 0;
+
+  while (num_removed < graph->NumNodes()) {
+    //! Open the buckets from the smallest degree of the nodes left.
+    min_degree.reset();
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& node) {
+          uint64_t degree =
+              graph->template GetData<KCoreNodeCurrentDegree>(node);
+          if (degree >= base) {
+            min_degree.update(degree);
+          }
+        },
+        katana::loopname("KCore Bucket Minimum"), katana::no_stats());
+    base = min_degree.reduce();
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& node) {
+          uint64_t degree =
+              graph->template GetData<KCoreNodeCurrentDegree>(node);
+          if (degree >= base && degree - base < kOpenBuckets) {
+            buckets[degree - base]->emplace(node);
+          }
+        },
+        katana::loopname("KCore Bucket Fill"), katana::no_stats());
+
+    for (uint64_t i = 0; i < kOpenBuckets; ++i) {
+      uint64_t k = base + i;
+      //! Nodes that drop to degree k while removing the frontier go back
+      //! into bucket i, the frontier of the next round.
+      while (!buckets[i]->empty()) {
+        std::swap(frontier, buckets[i]);
+        removed.reset();
+        katana::do_all(
+            katana::iterate(*frontier),
+            [&](const GNode& node) {
+              if (graph->template GetData<KCoreNodeCurrentDegree>(node) != k) {
+                return;
+              }
+              removed += 1;
+              for (auto e : Edges(*graph, node)) {
+                auto dest = EdgeDst(*graph, e);
+                auto& dest_current_degree =
+                    graph->template GetData<KCoreNodeCurrentDegree>(dest);
+                uint32_t old_degree =
+                    dest_current_degree.load(std::memory_order_relaxed);
+                while (old_degree > k &&
+                       !dest_current_degree.compare_exchange_weak(
+                           old_degree, old_degree - 1,
+                           std::memory_order_relaxed)) {
+                }
+                if (old_degree > k && old_degree - 1 - base < kOpenBuckets) {
+                  buckets[old_degree - 1 - base]->emplace(dest);
+                }
+              }
+            },
+            katana::steal(), katana::chunk_size<KCorePlan::kChunkSize>(),
+            katana::loopname("KCore Bucket Peel"), katana::no_stats());
+        frontier->clear();
+        num_removed += removed.reduce();
+        ++rounds;
+      }
+    }
+    base += kOpenBuckets;
+  }
+  katana::ReportStatSingle("KCore", "Rounds", rounds);
+}
+
 /**
  * After computation is finished, the nodes left in the core
  * are marked as alive.
@@ -217,6 +329,10 @@ KCoreImpl(GraphTy* graph, KCorePlan algo, uint32_t k_core_number) {
   case KCorePlan::kAsynchronous:
     AsyncCascadeKCore(graph, k_core_number);
     break;
+  case KCorePlan::kBucketDecomposition:
+    //! A node is in the k-core iff its core number is at least k.
+    BucketCoreDecomposition(graph);
+    break;
   default:
     return katana::ErrorCode::AssertionFailed;
   }
@@ -225,6 +341,27 @@ KCoreImpl(GraphTy* graph, KCorePlan algo, uint32_t k_core_number) {
   return katana::ResultSuccess();
 }
 
+/// Run plan on pg with the degree fields in the property named
+/// degree_property_name
+static katana::Result<void>
+KCoreWithView(
+    katana::PropertyGraph* pg, const std::string& degree_property_name,
+    bool is_symmetric, KCorePlan plan, uint32_t k_core_number) {
+  if (is_symmetric) {
+    using Graph = katana::TypedPropertyGraphView<
+        katana::PropertyGraphViews::Default, NodeData, EdgeData>;
+    Graph graph = KATANA_CHECKED(Graph::Make(pg, {degree_property_name}, {}));
+
+    return KCoreImpl(&graph, plan, k_core_number);
+  }
+  using Graph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Undirected, NodeData, EdgeData>;
+
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {degree_property_name}, {}));
+
+  return KCoreImpl(&graph, plan, k_core_number);
+}
+
 katana::Result<void>
 katana::analytics::KCore(
     katana::PropertyGraph* pg, uint32_t k_core_number,
@@ -237,22 +374,8 @@ katana::analytics::KCore(
       pg->ConstructNodeProperties<std::tuple<KCoreNodeCurrentDegree>>(
           txn_ctx, {temporary_property.name()}));
 
-  if (is_symmetric) {
-    using Graph = katana::TypedPropertyGraphView<
-        katana::PropertyGraphViews::Default, NodeData, EdgeData>;
-    Graph graph =
-        KATANA_CHECKED(Graph::Make(pg, {temporary_property.name()}, {}));
-
-    KATANA_CHECKED(KCoreImpl(&graph, plan, k_core_number));
-  } else {
-    using Graph = katana::TypedPropertyGraphView<
-        katana::PropertyGraphViews::Undirected, NodeData, EdgeData>;
-
-    Graph graph =
-        KATANA_CHECKED(Graph::Make(pg, {temporary_property.name()}, {}));
-
-    KATANA_CHECKED(KCoreImpl(&graph, plan, k_core_number));
-  }
+  KATANA_CHECKED(KCoreWithView(
+      pg, temporary_property.name(), is_symmetric, plan, k_core_number));
   // Post processing. Mark alive nodes.
   KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<KCoreNodeAlive>>(
       txn_ctx, {output_property_name}));
@@ -265,6 +388,23 @@ katana::analytics::KCore(
   return KCoreMarkAliveNodes(&graph_final, k_core_number);
 }
 
+katana::Result<void>
+katana::analytics::KCoreDecomposition(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric, KCorePlan plan) {
+  if (plan.algorithm() != KCorePlan::kBucketDecomposition) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "core numbers are only computed by the bucket decomposition");
+  }
+
+  //! The degree fields end up holding the core numbers.
+  KATANA_CHECKED(pg->ConstructNodeProperties<NodeData>(
+      txn_ctx, {output_property_name}));
+
+  return KCoreWithView(pg, output_property_name, is_symmetric, plan, 0);
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
@@ -0,0 +1,216 @@
+#include "katana/analytics/k_shortest_simple_paths/k_shortest_simple_paths.h"
+
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <vector>
+
+#include "../point_to_point_shortest_path/bidirectional_search.h"
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+using namespace katana::analytics::internal;
+
+namespace {
+
+struct SimplePath {
+  std::vector<Node> nodes;
+  /// dists[i]: the length of the path up to nodes[i]
+  std::vector<double> dists;
+  /// The index of the node where the path leaves the path it was found from
+  size_t deviation{};
+
+  double length() const { return dists.back(); }
+
+  bool operator>(const SimplePath& other) const {
+    if (length() != other.length()) {
+      return length() > other.length();
+    }
+    return nodes > other.nodes;
+  }
+};
+
+/// The per-thread memory of the spur searches
+struct SpurScratch {
+  QueryScratch query;
+  katana::DynamicBitset blocked;
+  SearchExclusions exclusions;
+  std::vector<Node> nodes;
+  std::vector<double> dists;
+};
+
+class YenSearch {
+  const BiDirGraphView& graph_;
+  const EdgeWeights& weights_;
+  Node target_;
+  /// The paths found so far, in order
+  std::vector<SimplePath> paths_;
+  /// The candidates not taken yet, as a min-heap
+  std::vector<SimplePath> candidates_;
+  /// The node sequences of the paths and candidates
+  std::set<std::vector<Node>> seen_;
+  katana::PerThreadStorage<SpurScratch> scratch_;
+  katana::GAccumulator<uint64_t> settled_;
+
+  /// Search from last.nodes[spur] for the candidate that leaves last there
+  void Spur(
+      const SimplePath& last, size_t spur,
+      katana::InsertBag<SimplePath>* found) {
+    SpurScratch& scratch = *scratch_.getLocal();
+    if (scratch.blocked.size() != graph_.NumNodes()) {
+      scratch.blocked.resize(graph_.NumNodes());
+      scratch.blocked.reset();
+    }
+
+    // The root is last up to the spur; the spur path may not return to it
+    // or take an edge a path with the same root took from the spur
+    for (size_t i = 0; i < spur; ++i) {
+      scratch.blocked.set(last.nodes[i]);
+    }
+    SearchExclusions& exclusions = scratch.exclusions;
+    exclusions.nodes = &scratch.blocked;
+    exclusions.src = last.nodes[spur];
+    exclusions.dsts.clear();
+    for (const SimplePath& path : paths_) {
+      if (path.nodes.size() > spur + 1 &&
+          std::equal(
+              last.nodes.begin(), last.nodes.begin() + spur + 1,
+              path.nodes.begin())) {
+        exclusions.dsts.emplace_back(path.nodes[spur + 1]);
+      }
+    }
+
+    BidirectionalSearch search(
+        graph_, &weights_, nullptr, scratch.query, last.nodes[spur], target_);
+    search.Exclude(&exclusions);
+    if (search.Dijkstra() != kInfinity) {
+      search.Path(&scratch.nodes, &scratch.dists);
+      SimplePath candidate;
+      candidate.nodes.assign(last.nodes.begin(), last.nodes.begin() + spur);
+      candidate.dists.assign(last.dists.begin(), last.dists.begin() + spur);
+      for (size_t i = 0; i < scratch.nodes.size(); ++i) {
+        candidate.nodes.emplace_back(scratch.nodes[i]);
+        candidate.dists.emplace_back(last.dists[spur] + scratch.dists[i]);
+      }
+      candidate.deviation = spur;
+      found->push(std::move(candidate));
+    }
+    settled_ += search.settled();
+
+    for (size_t i = 0; i < spur; ++i) {
+      scratch.blocked.reset(last.nodes[i]);
+    }
+  }
+
+public:
+  YenSearch(
+      const BiDirGraphView& graph, const EdgeWeights& weights, Node target)
+      : graph_(graph), weights_(weights), target_(target) {}
+
+  /// Find the shortest path from source, false if there is none
+  bool First(Node source) {
+    SpurScratch& scratch = *scratch_.getLocal();
+    BidirectionalSearch search(
+        graph_, &weights_, nullptr, scratch.query, source, target_);
+    double length = search.Dijkstra();
+    settled_ += search.settled();
+    if (length == kInfinity) {
+      return false;
+    }
+    SimplePath path;
+    search.Path(&path.nodes, &path.dists);
+    seen_.insert(path.nodes);
+    paths_.emplace_back(std::move(path));
+    return true;
+  }
+
+  /// Find the next path, false if there is none
+  bool Next() {
+    const SimplePath& last = paths_.back();
+    katana::InsertBag<SimplePath> found;
+    katana::do_all(
+        katana::iterate(last.deviation, last.nodes.size() - 1),
+        [&](size_t spur) { Spur(last, spur, &found); }, katana::steal(),
+        katana::loopname("KShortestSimplePaths-spur"));
+
+    for (SimplePath& candidate : found) {
+      if (seen_.insert(candidate.nodes).second) {
+        candidates_.emplace_back(std::move(candidate));
+        std::push_heap(
+            candidates_.begin(), candidates_.end(),
+            std::greater<SimplePath>{});
+      }
+    }
+    if (candidates_.empty()) {
+      return false;
+    }
+    std::pop_heap(
+        candidates_.begin(), candidates_.end(), std::greater<SimplePath>{});
+    paths_.emplace_back(std::move(candidates_.back()));
+    candidates_.pop_back();
+    return true;
+  }
+
+  const std::vector<SimplePath>& paths() const { return paths_; }
+  uint64_t settled() { return settled_.reduce(); }
+};
+
+katana::Result<std::shared_ptr<arrow::Table>>
+MakePathTable(const std::vector<SimplePath>& paths) {
+  arrow::DoubleBuilder length_builder;
+  auto node_builder = std::make_shared<arrow::UInt32Builder>();
+  arrow::ListBuilder nodes_builder(arrow::default_memory_pool(), node_builder);
+  for (const SimplePath& path : paths) {
+    KATANA_CHECKED(length_builder.Append(path.length()));
+    KATANA_CHECKED(nodes_builder.Append());
+    KATANA_CHECKED(node_builder->AppendValues(path.nodes));
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields{
+      arrow::field("length", arrow::float64()),
+      arrow::field("nodes", arrow::list(arrow::uint32())),
+  };
+  std::vector<std::shared_ptr<arrow::Array>> columns{
+      KATANA_CHECKED(length_builder.Finish()),
+      KATANA_CHECKED(nodes_builder.Finish()),
+  };
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+}  // namespace
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::analytics::KShortestSimplePaths(
+    PropertyGraph* pg, uint32_t source, uint32_t target, uint32_t num_paths,
+    const std::string& edge_weight_property_name,
+    KShortestSimplePathsPlan plan) {
+  if (source >= pg->NumNodes() || target >= pg->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "({}, {}) is not a pair of nodes",
+        source, target);
+  }
+  if (plan.algorithm() != KShortestSimplePathsPlan::kYen) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+  katana::StatTimer exec_time("KShortestSimplePaths");
+  katana::TimerGuard guard(exec_time);
+
+  BiDirGraphView graph = pg->BuildView<BiDirGraphView>();
+  EdgeWeights weights =
+      KATANA_CHECKED(ReadEdgeWeights(pg, graph, edge_weight_property_name));
+
+  YenSearch search(graph, weights, target);
+  if (num_paths > 0 && search.First(source)) {
+    while (search.paths().size() < num_paths && search.Next()) {
+    }
+  }
+  katana::ReportStatSingle(
+      "KShortestSimplePaths", "SettledNodes", search.settled());
+  return MakePathTable(search.paths());
+}
@@ -19,8 +19,16 @@
 
 #include "katana/analytics/k_truss/k_truss.h"
 
+#include <algorithm>
+#include <atomic>
+
+#include <boost/iterator/counting_iterator.hpp>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Range.h"
+#include "katana/SortedIntersection.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/k_core/k_core.h"
 
 using namespace katana::analytics;
 
@@ -37,7 +45,6 @@ using SortedGraphView = katana::TypedPropertyGraphView<
 
 using Edge = std::pair<GNode, GNode>;
 using EdgeVec = katana::InsertBag<Edge>;
-using NodeVec = katana::InsertBag<GNode>;
 
 static const uint32_t valid = 0x0;
 static const uint32_t removed = 0x1;
@@ -56,32 +63,6 @@ KTrussInitialization(SortedGraphView* g) {
       katana::steal());
 }
 
-/**
- * Check if the number of valid edges is more than or equal to j.
- * If it is, then the node n still could be processed.
- * Otherwise, the node n will be ignored in the following steps.
- *
- * @param g
- * @param n the target node n to be tested
- * @param j the target number of triangels
- *
- * @return true if the target node n has the number of degrees
- *         more than or equal to j
- */
-bool
-IsValidDegreeNoLessThanJ(const SortedGraphView& g, GNode n, unsigned int j) {
-  size_t numValid = 0;
-  for (auto e : g.OutEdges(n)) {
-    if (!(g.GetEdgeData<EdgeFlag>(e) & removed)) {
-      numValid += 1;
-      if (numValid >= j) {
-        return true;
-      }
-    }
-  }
-  return numValid >= j;
-}
-
 /**
  * Measure the number of intersected edges between the src and the dest nodes.
  *
@@ -236,12 +217,13 @@ BSPTrussAlgo(SortedGraphView* g, unsigned int k) {
 
   //! Symmetry breaking:
   //! Consider only edges (i, j) where i < j.
+  //! Edges already removed, e.g. outside the (k-1)-core, stay removed.
   katana::do_all(
       katana::iterate(*g),
       [&g, &cur](GNode n) {
         for (auto e : g->OutEdges(n)) {
           auto dest = g->OutEdgeDst(e);
-          if (dest > n) {
+          if (dest > n && !(g->GetEdgeData<EdgeFlag>(e) & removed)) {
             cur->push_back(std::make_pair(n, dest));
           }
         }
@@ -268,50 +250,31 @@ BSPTrussAlgo(SortedGraphView* g, unsigned int k) {
   return katana::ResultSuccess();
 }
 
-struct KeepValidNodes {
-  SortedGraphView* g;
-  unsigned int j;
-  NodeVec& s;
-
-  void operator()(GNode n) {
-    if (IsValidDegreeNoLessThanJ(*g, n, j)) {
-      s.push_back(n);
-    } else {
-      for (auto e : g->OutEdges(n)) {
-        auto dest = g->OutEdgeDst(e);
-        KATANA_LOG_DEBUG_ASSERT(g->HasEdge(n, dest));
-        KATANA_LOG_DEBUG_ASSERT(g->HasEdge(dest, n));
-
-        g->template GetEdgeData<EdgeFlag>(*g->FindEdge(n, dest)) = removed;
-        g->template GetEdgeData<EdgeFlag>(*g->FindEdge(dest, n)) = removed;
-      }
-    }
-  }
-};
-
-/// BSPCoreAlgo:
-/// 1. Keep nodes w/ degree >= k and remove all edges for nodes whose degree < k.
-/// 2. If all nodes are kept, done.
-/// 3. Go back to 1.
+/// Remove the edges of nodes outside the k-core, found from the core numbers
+/// of a single bucketed core decomposition instead of rounds of rescanning
+/// the degrees of all nodes left.
 katana::Result<void>
-BSPCoreAlgo(SortedGraphView* g, uint32_t k) {
-  auto cur = std::make_unique<NodeVec>();
-  auto next = std::make_unique<NodeVec>();
-  size_t curSize = g->NumNodes(), nextSize;
+RemoveEdgesOutsideCore(
+    katana::TxnContext* txn_ctx, katana::PropertyGraph* pg, SortedGraphView* g,
+    uint32_t k) {
+  katana::analytics::TemporaryPropertyGuard core_number{
+      pg->NodeMutablePropertyView()};
+  KATANA_CHECKED(katana::analytics::KCoreDecomposition(
+      pg, core_number.name(), txn_ctx, true));
+  auto core_numbers =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<uint32_t>(core_number.name()));
+  const uint32_t* cores = core_numbers->raw_values();
 
   katana::do_all(
-      katana::iterate(*g), KeepValidNodes{g, k, *next}, katana::steal());
-  nextSize = std::distance(next->begin(), next->end());
-
-  while (curSize != nextSize) {
-    cur->clear();
-    curSize = nextSize;
-    std::swap(cur, next);
-
-    katana::do_all(
-        katana::iterate(*cur), KeepValidNodes{g, k, *next}, katana::steal());
-    nextSize = std::distance(next->begin(), next->end());
-  }
+      katana::iterate(*g),
+      [&](GNode n) {
+        for (auto e : g->OutEdges(n)) {
+          if (cores[n] < k || cores[g->OutEdgeDst(e)] < k) {
+            g->template GetEdgeData<EdgeFlag>(e) = removed;
+          }
+        }
+      },
+      katana::steal());
   return katana::ResultSuccess();
 }
 
@@ -319,7 +282,9 @@ BSPCoreAlgo(SortedGraphView* g, uint32_t k) {
 /// 1. Reduce the graph to k-1 core
 /// 2. Compute k-truss from k-1 core
 katana::Result<void>
-BSPCoreThenTrussAlgo(SortedGraphView* g, uint32_t k) {
+BSPCoreThenTrussAlgo(
+    katana::TxnContext* txn_ctx, katana::PropertyGraph* pg, SortedGraphView* g,
+    uint32_t k) {
   if (k <= 2) {
     return katana::ErrorCode::InvalidArgument;
   }
@@ -327,7 +292,7 @@ BSPCoreThenTrussAlgo(SortedGraphView* g, uint32_t k) {
   katana::StatTimer TCore("Reduce_to_(k-1)-core");
   TCore.start();
 
-  if (auto r = BSPCoreAlgo(g, k - 1); !r) {
+  if (auto r = RemoveEdgesOutsideCore(txn_ctx, pg, g, k - 1); !r) {
     return r.error();
   }
 
@@ -344,6 +309,355 @@ BSPCoreThenTrussAlgo(SortedGraphView* g, uint32_t k) {
   return katana::ResultSuccess();
 }
 
+struct EdgeTrussness : public katana::PODProperty<uint32_t> {};
+
+using TrussnessGraphView = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::EdgesSortedByDestID, NodeData,
+    std::tuple<EdgeTrussness>>;
+
+using EdgeID = katana::GraphTopology::Edge;
+
+//! The number of consecutive support levels with an open bucket in
+//! BucketTrussDecomposition, as for the degrees of the k-core decomposition.
+constexpr uint32_t kOpenSupportBuckets = 128;
+
+//! The states of an edge in BucketTrussDecomposition
+enum PeelState : uint8_t { kAlive, kPeeling, kPeeled };
+
+/**
+ * Compute the trussness of every edge of g, the largest k such that the edge
+ * is in the k-truss, by peeling all edges of support s, for increasing s, in
+ * parallel rounds. Edges are found through buckets of edges by support for
+ * kOpenSupportBuckets levels at a time, as nodes by degree in the k-core
+ * decomposition. Each edge {u, v}, u < v, is represented by the edge of u to
+ * v, and its support, the number of triangles it is in, is counted once with
+ * the SIMD intersection of the edge lists of u and v.
+ *
+ * Peeling an edge at level s breaks its triangles with the edges not peeled
+ * yet. The other two edges of such a triangle lose one support, down to at
+ * least s, unless one is peeled in the same round: then only the other
+ * loses one, for the triangle's peeled edge of smaller ID, so that no
+ * triangle counts twice. An edge peeled at level s has trussness s + 2.
+ *
+ * @param g Graph without self loops or parallel edges
+ * @param[out] trussness The trussness of each edge of g
+ */
+template <typename AdjacencyTy>
+void
+BucketTrussDecomposition(
+    const AdjacencyTy& g, katana::NUMAArray<uint32_t>* trussness) {
+  const uint64_t num_edges = g.NumEdges();
+  auto edge_to = [&g](GNode u, GNode v) -> EdgeID {
+    const GNode* dsts = g.OutEdgeDsts(u);
+    return *g.OutEdges(u).begin() +
+           (std::lower_bound(dsts, dsts + g.OutDegree(u), v) - dsts);
+  };
+
+  //! The edge that represents each edge, and the support and state of the
+  //! representatives.
+  katana::NUMAArray<EdgeID> canonical;
+  canonical.allocateBlocked(num_edges);
+  katana::NUMAArray<std::atomic<uint32_t>> support;
+  support.allocateBlocked(num_edges);
+  katana::NUMAArray<std::atomic<uint8_t>> state;
+  state.allocateBlocked(num_edges);
+
+  katana::GAccumulator<uint64_t> num_undirected;
+  katana::do_all(
+      katana::iterate(g),
+      [&](GNode u) {
+        for (auto e : g.OutEdges(u)) {
+          GNode v = g.OutEdgeDst(e);
+          if (u > v) {
+            canonical[e] = edge_to(v, u);
+            continue;
+          }
+          canonical[e] = e;
+          support[e].store(
+              katana::SortedIntersectionSize(
+                  g.OutEdgeDsts(u), g.OutDegree(u), g.OutEdgeDsts(v),
+                  g.OutDegree(v)),
+              std::memory_order_relaxed);
+          state[e].store(kAlive, std::memory_order_relaxed);
+          num_undirected += 1;
+        }
+      },
+      katana::steal(), katana::loopname("KTruss Support"));
+
+  using PeelEdge = std::pair<GNode, EdgeID>;
+  using Bucket = katana::InsertBag<PeelEdge>;
+  std::vector<std::unique_ptr<Bucket>> buckets(kOpenSupportBuckets);
+  for (auto& bucket : buckets) {
+    bucket = std::make_unique<Bucket>();
+  }
+  auto frontier = std::make_unique<Bucket>();
+  Bucket round;
+  katana::PerThreadStorage<std::vector<GNode>> common;
+
+  katana::GReduceMin<uint32_t> min_support;
+  katana::GAccumulator<uint64_t> peeled;
+  uint64_t num_peeled = 0;
+  uint64_t rounds = 0;
+  //! Every edge of trussness below base + 2 is peeled.
+  uint32_t base = 0;
+
+  auto for_each_alive = [&](auto fn) {
+    katana::do_all(
+        katana::iterate(g),
+        [&](GNode u) {
+          for (auto e : g.OutEdges(u)) {
+            if (canonical[e] == e &&
+                state[e].load(std::memory_order_relaxed) == kAlive) {
+              fn(u, e, support[e].load(std::memory_order_relaxed));
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+  };
+
+  while (num_peeled < num_undirected.reduce()) {
+    //! Open the buckets from the smallest support of the edges left.
+    min_support.reset();
+    for_each_alive([&](GNode, EdgeID, uint32_t sup) {
+      min_support.update(sup);
+    });
+    base = min_support.reduce();
+    for_each_alive([&](GNode u, EdgeID e, uint32_t sup) {
+      if (sup - base < kOpenSupportBuckets) {
+        buckets[sup - base]->emplace(u, e);
+      }
+    });
+
+    for (uint32_t i = 0; i < kOpenSupportBuckets; ++i) {
+      uint32_t s = base + i;
+      auto lose_support = [&](EdgeID edge, GNode a, GNode b) {
+        auto& edge_support = support[edge];
+        uint32_t old_support = edge_support.load(std::memory_order_relaxed);
+        while (old_support > s &&
+               !edge_support.compare_exchange_weak(
+                   old_support, old_support - 1, std::memory_order_relaxed)) {
+        }
+        if (old_support > s && old_support - 1 - base < kOpenSupportBuckets) {
+          buckets[old_support - 1 - base]->emplace(std::min(a, b), edge);
+        }
+      };
+
+      //! Edges that drop to support s while peeling a round go back into
+      //! bucket i, the frontier of the next round.
+      while (!buckets[i]->empty()) {
+        std::swap(frontier, buckets[i]);
+        //! Claim each edge still of support s once.
+        peeled.reset();
+        katana::do_all(
+            katana::iterate(*frontier),
+            [&](const PeelEdge& edge) {
+              EdgeID e = edge.second;
+              uint8_t alive = kAlive;
+              if (support[e].load(std::memory_order_relaxed) == s &&
+                  state[e].compare_exchange_strong(
+                      alive, kPeeling, std::memory_order_relaxed)) {
+                round.push(edge);
+                peeled += 1;
+              }
+            },
+            katana::no_stats());
+        frontier->clear();
+
+        katana::do_all(
+            katana::iterate(round),
+            [&](const PeelEdge& edge) {
+              auto [u, e] = edge;
+              GNode v = g.OutEdgeDst(e);
+              auto& triangles = *common.getLocal();
+              triangles.resize(std::min(g.OutDegree(u), g.OutDegree(v)));
+              GNode* end = katana::SortedIntersection(
+                  g.OutEdgeDsts(u), g.OutDegree(u), g.OutEdgeDsts(v),
+                  g.OutDegree(v), triangles.data());
+              for (GNode* w = triangles.data(); w != end; ++w) {
+                EdgeID uw = canonical[edge_to(u, *w)];
+                EdgeID vw = canonical[edge_to(v, *w)];
+                uint8_t uw_state = state[uw].load(std::memory_order_relaxed);
+                uint8_t vw_state = state[vw].load(std::memory_order_relaxed);
+                if (uw_state == kPeeled || vw_state == kPeeled ||
+                    (uw_state == kPeeling && vw_state == kPeeling)) {
+                  continue;
+                }
+                if (uw_state == kPeeling) {
+                  if (e < uw) {
+                    lose_support(vw, v, *w);
+                  }
+                } else if (vw_state == kPeeling) {
+                  if (e < vw) {
+                    lose_support(uw, u, *w);
+                  }
+                } else {
+                  lose_support(uw, u, *w);
+                  lose_support(vw, v, *w);
+                }
+              }
+            },
+            katana::steal(), katana::loopname("KTruss Bucket Peel"),
+            katana::no_stats());
+
+        katana::do_all(
+            katana::iterate(round),
+            [&](const PeelEdge& edge) {
+              state[edge.second].store(kPeeled, std::memory_order_relaxed);
+            },
+            katana::no_stats());
+        round.clear();
+        num_peeled += peeled.reduce();
+        ++rounds;
+      }
+    }
+    base += kOpenSupportBuckets;
+  }
+  katana::ReportStatSingle("KTruss", "Rounds", rounds);
+
+  trussness->allocateBlocked(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](EdgeID e) {
+        (*trussness)[e] =
+            support[canonical[e]].load(std::memory_order_relaxed) + 2;
+      },
+      katana::no_stats());
+}
+
+/// The edge lists of a graph without its self loops and parallel edges, with
+/// the accessors of a graph view that BucketTrussDecomposition uses
+class SimpleAdjacency {
+public:
+  using Node = GNode;
+
+  template <typename GraphTy>
+  explicit SimpleAdjacency(const GraphTy& g) {
+    indices_.allocateBlocked(g.NumNodes() + 1);
+    auto for_each_dest = [&g](GNode u, auto fn) {
+      const GNode* dsts = g.OutEdgeDsts(u);
+      for (size_t i = 0; i < g.OutDegree(u); ++i) {
+        if (dsts[i] != u && (i == 0 || dsts[i] != dsts[i - 1])) {
+          fn(dsts[i]);
+        }
+      }
+    };
+    katana::do_all(
+        katana::iterate(g),
+        [&](GNode u) {
+          uint64_t degree = 0;
+          for_each_dest(u, [&degree](GNode) { ++degree; });
+          indices_[u + 1] = degree;
+        },
+        katana::no_stats());
+    indices_[0] = 0;
+    katana::ParallelSTL::partial_sum(
+        indices_.begin(), indices_.end(), indices_.begin());
+    dests_.allocateBlocked(indices_[g.NumNodes()]);
+    katana::do_all(
+        katana::iterate(g),
+        [&](GNode u) {
+          uint64_t next = indices_[u];
+          for_each_dest(u, [&](GNode v) { dests_[next++] = v; });
+        },
+        katana::no_stats());
+  }
+
+  size_t NumNodes() const { return indices_.size() - 1; }
+  uint64_t NumEdges() const { return dests_.size(); }
+  boost::counting_iterator<Node> begin() const {
+    return boost::counting_iterator<Node>(0);
+  }
+  boost::counting_iterator<Node> end() const {
+    return boost::counting_iterator<Node>(NumNodes());
+  }
+  auto OutEdges(Node u) const {
+    return katana::MakeStandardRange<boost::counting_iterator<EdgeID>>(
+        indices_[u], indices_[u + 1]);
+  }
+  size_t OutDegree(Node u) const { return indices_[u + 1] - indices_[u]; }
+  const Node* OutEdgeDsts(Node u) const { return &dests_[indices_[u]]; }
+  Node OutEdgeDst(EdgeID e) const { return dests_[e]; }
+
+  /// \returns the edge of u to v, which must exist
+  EdgeID FindEdge(Node u, Node v) const {
+    const Node* dsts = OutEdgeDsts(u);
+    return indices_[u] +
+           (std::lower_bound(dsts, dsts + OutDegree(u), v) - dsts);
+  }
+
+private:
+  katana::NUMAArray<EdgeID> indices_;
+  katana::NUMAArray<Node> dests_;
+};
+
+/// Write the trussness of each edge of pg to the uint32 property named
+/// output_property_name, which must exist. The self loops of a graph that
+/// has any are in no triangle, and parallel edges share the trussness of the
+/// edge of the graph without them; its edge lists are copied without these
+/// first.
+katana::Result<void>
+KTrussDecompositionWithView(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto graph =
+      KATANA_CHECKED(TrussnessGraphView::Make(pg, {}, {output_property_name}));
+
+  katana::NUMAArray<uint32_t> trussness;
+  if (!katana::analytics::HasSelfLoopsOrParallelEdges(graph)) {
+    BucketTrussDecomposition(graph, &trussness);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{graph.NumEdges()}),
+        [&](EdgeID e) {
+          graph.template GetEdgeData<EdgeTrussness>(e) = trussness[e];
+        },
+        katana::no_stats());
+    return katana::ResultSuccess();
+  }
+
+  SimpleAdjacency simple(graph);
+  BucketTrussDecomposition(simple, &trussness);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode u) {
+        for (auto e : graph.OutEdges(u)) {
+          GNode v = graph.OutEdgeDst(e);
+          graph.template GetEdgeData<EdgeTrussness>(e) =
+              u == v ? 2 : trussness[simple.FindEdge(u, v)];
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+/// BucketDecompositionTrussAlgo:
+/// 1. Compute the trussness of every edge
+/// 2. Remove the edges of trussness below k
+katana::Result<void>
+BucketDecompositionTrussAlgo(
+    katana::TxnContext* txn_ctx, katana::PropertyGraph* pg, SortedGraphView* g,
+    uint32_t k) {
+  if (k <= 2) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  katana::analytics::TemporaryPropertyGuard trussness{
+      pg->EdgeMutablePropertyView()};
+  KATANA_CHECKED(pg->ConstructEdgeProperties<std::tuple<EdgeTrussness>>(
+      txn_ctx, {trussness.name()}));
+  KATANA_CHECKED(KTrussDecompositionWithView(pg, trussness.name()));
+
+  auto trussness_view =
+      KATANA_CHECKED(TrussnessGraphView::Make(pg, {}, {trussness.name()}));
+  katana::do_all(
+      katana::iterate(uint64_t{0}, uint64_t{g->NumEdges()}),
+      [&](EdgeID e) {
+        if (trussness_view.template GetEdgeData<EdgeTrussness>(e) < k) {
+          g->template GetEdgeData<EdgeFlag>(e) = removed;
+        }
+      },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::analytics::KTruss(
     katana::TxnContext* txn_ctx, katana::PropertyGraph* pg,
@@ -368,12 +682,35 @@ katana::analytics::KTruss(
   case KTrussPlan::kBspJacobi:
     return BSPTrussJacobiAlgo(&graph, k_truss_number);
   case KTrussPlan::kBspCoreThenTruss:
-    return BSPCoreThenTrussAlgo(&graph, k_truss_number);
+    return BSPCoreThenTrussAlgo(txn_ctx, pg, &graph, k_truss_number);
+  case KTrussPlan::kBucketDecomposition:
+    return BucketDecompositionTrussAlgo(txn_ctx, pg, &graph, k_truss_number);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
 
+katana::Result<void>
+katana::analytics::KTrussDecomposition(
+    katana::TxnContext* txn_ctx, katana::PropertyGraph* pg,
+    const std::string& output_property_name, KTrussPlan plan) {
+  if (plan.algorithm() != KTrussPlan::kBucketDecomposition) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "trussness is only computed by the bucket decomposition");
+  }
+  katana::ReportPageAllocGuard page_alloc;
+
+  KATANA_CHECKED(pg->ConstructEdgeProperties<std::tuple<EdgeTrussness>>(
+      txn_ctx, {output_property_name}));
+
+  katana::StatTimer exec_time("KTrussDecomposition");
+  exec_time.start();
+  KATANA_CHECKED(KTrussDecompositionWithView(pg, output_property_name));
+  exec_time.stop();
+  return katana::ResultSuccess();
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
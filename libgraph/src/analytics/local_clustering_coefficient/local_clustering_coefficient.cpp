@@ -19,7 +19,14 @@
 
 #include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
 #include "katana/AtomicHelpers.h"
+#include "katana/ErrorCode.h"
+#include "katana/SortedIntersection.h"
+#include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
 
@@ -36,6 +43,60 @@ using SortedGraphView =
     katana::TypedPropertyGraphView<SortedPropertyGraphView, NodeData, EdgeData>;
 using Node = SortedGraphView::Node;
 
+/// Nodes with at least this many smaller neighbors intersect their edges
+/// with those of their neighbors through a bitmap
+constexpr static const size_t kHubDegree = 1024;
+
+static_assert(
+    sizeof(Node) == sizeof(uint32_t),
+    "the intersection kernels need 32-bit node IDs");
+
+/// Scratch space of a thread for ForEachSmallerTriangle
+struct IntersectionScratch {
+  std::vector<Node> common;
+  katana::SortedSetBitmap hub;
+};
+
+/**
+ * Calls found(v, w) for each triangle of n, v and w with w < v < n of a graph
+ * without self loops and parallel edges, which intersects the smaller
+ * neighbors of n before v with those of v, through a bitmap of the
+ * neighbors of n if n is a hub.
+ */
+template <typename Found>
+void
+ForEachSmallerTriangle(
+    const SortedGraphView& graph, Node n, IntersectionScratch* scratch,
+    Found found) {
+  auto count_smaller = [&graph](Node node) {
+    const Node* dsts = graph.OutEdgeDsts(node);
+    return std::lower_bound(dsts, dsts + graph.OutDegree(node), node) - dsts;
+  };
+  const Node* n_dsts = graph.OutEdgeDsts(n);
+  size_t n_smaller = count_smaller(n);
+  bool is_hub = n_smaller >= kHubDegree;
+  if (is_hub) {
+    scratch->hub.Assign(n_dsts, n_smaller);
+  }
+
+  for (size_t i = 0; i < n_smaller; ++i) {
+    Node v = n_dsts[i];
+    const Node* v_dsts = graph.OutEdgeDsts(v);
+    size_t v_smaller = count_smaller(v);
+    if (scratch->common.size() < v_smaller) {
+      scratch->common.resize(v_smaller);
+    }
+    // The neighbors of n smaller than v are the first i
+    Node* common = scratch->common.data();
+    Node* end = is_hub ? scratch->hub.Intersection(v_dsts, v_smaller, common)
+                       : katana::SortedIntersection(
+                             n_dsts, i, v_dsts, v_smaller, common);
+    for (; common != end; ++common) {
+      found(v, *common);
+    }
+  }
+}
+
 struct LocalClusteringCoefficientAtomics {
   /**
    * Counts the number of triangles for each node
@@ -81,10 +142,21 @@ struct LocalClusteringCoefficientAtomics {
         per_node_triangles.begin(), per_node_triangles.end(), uint32_t{0});
 
     // Count triangles
+    bool simple = !HasSelfLoopsOrParallelEdges(*graph);
+    katana::PerThreadStorage<IntersectionScratch> scratch;
     katana::do_all(
         katana::iterate(*graph),
         [&](const Node& n) {
-          OrderedCountFunc(*graph, n, &per_node_triangles);
+          if (!simple) {
+            OrderedCountFunc(*graph, n, &per_node_triangles);
+            return;
+          }
+          ForEachSmallerTriangle(
+              *graph, n, scratch.getLocal(), [&](Node v, Node w) {
+                __sync_fetch_and_add(&per_node_triangles[n], uint32_t{1});
+                __sync_fetch_and_add(&per_node_triangles[v], uint32_t{1});
+                __sync_fetch_and_add(&per_node_triangles[w], uint32_t{1});
+              });
         },
         katana::chunk_size<kChunkSize>(), katana::steal(),
         katana::loopname("TriangleCount_OrderedCountAlgo"));
@@ -180,11 +252,23 @@ struct LocalClusteringCoefficientPerThread {
           all_thread_count_vec.begin(), all_thread_count_vec.end(), tid, numT);
     });
 
+    bool simple = !HasSelfLoopsOrParallelEdges(graph);
+    katana::PerThreadStorage<IntersectionScratch> scratch;
     katana::do_all(
         katana::iterate(graph),
         [&](const Node& n) {
-          OrderedCountFunc(
-              graph, n, *per_thread_node_triangle_count.getLocal());
+          auto counts = per_thread_node_triangle_count.getLocal()->first;
+          if (!simple) {
+            OrderedCountFunc(
+                graph, n, *per_thread_node_triangle_count.getLocal());
+            return;
+          }
+          ForEachSmallerTriangle(
+              graph, n, scratch.getLocal(), [&](Node v, Node w) {
+                *(counts + n) += 1;
+                *(counts + v) += 1;
+                *(counts + w) += 1;
+              });
         },
         katana::chunk_size<kChunkSize>(), katana::steal(),
         katana::loopname("TriangleCount_OrderedCountAlgo"));
@@ -237,13 +321,75 @@ struct LocalClusteringCoefficientPerThread {
     return katana::ResultSuccess();
   }
 };
+
+struct LocalClusteringCoefficientWedgeSampling {
+  LocalClusteringCoefficientPlan plan_;
+
+  /// Whether the wedge of n, a and b is closed by an edge between a and b
+  static bool IsClosed(const SortedGraphView& graph, Node a, Node b) {
+    const Node* a_dsts = graph.OutEdgeDsts(a);
+    return std::binary_search(a_dsts, a_dsts + graph.OutDegree(a), b);
+  }
+
+  double Coefficient(const SortedGraphView& graph, Node n) const {
+    const Node* dsts = graph.OutEdgeDsts(n);
+    uint64_t degree = graph.OutDegree(n);
+    if (degree < 2) {
+      return 0.0;
+    }
+    uint64_t num_wedges = degree * (degree - 1) / 2;
+    uint64_t closed = 0;
+    if (num_wedges <= plan_.num_samples()) {
+      for (uint64_t i = 0; i < degree; ++i) {
+        for (uint64_t j = i + 1; j < degree; ++j) {
+          closed += IsClosed(graph, dsts[i], dsts[j]);
+        }
+      }
+      return static_cast<double>(closed) / num_wedges;
+    }
+
+    // The samples of a node do not depend on the thread that draws them
+    std::mt19937_64 gen(plan_.seed() ^ (n * 0x9e3779b97f4a7c15ULL));
+    std::uniform_int_distribution<uint64_t> first(0, degree - 1);
+    std::uniform_int_distribution<uint64_t> second(0, degree - 2);
+    for (uint32_t s = 0; s < plan_.num_samples(); ++s) {
+      uint64_t i = first(gen);
+      uint64_t j = second(gen);
+      j += j >= i;
+      closed += IsClosed(graph, dsts[i], dsts[j]);
+    }
+    return static_cast<double>(closed) / plan_.num_samples();
+  }
+
+  katana::Result<void> operator()(SortedGraphView* graph) {
+    if (plan_.num_samples() == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "num_samples must be positive");
+    }
+    katana::StatTimer execTime(
+        "LocalClusteringCoefficient", "LocalClusteringCoefficient");
+    execTime.start();
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](Node n) {
+          graph->template GetData<NodeClusteringCoefficient>(n) =
+              Coefficient(*graph, n);
+        },
+        katana::chunk_size<kChunkSize>(), katana::steal(),
+        katana::loopname("LocalClusteringCoefficient_WedgeSampling"));
+
+    execTime.stop();
+    return katana::ResultSuccess();
+  }
+};
 }  // namespace
 
 template <typename Algorithm>
 katana::Result<void>
 LocalClusteringCoefficientWithWrap(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::TxnContext* txn_ctx) {
+    katana::TxnContext* txn_ctx, Algorithm algo = {}) {
   if (auto result = pg->ConstructNodeProperties<NodeData>(
           txn_ctx, {output_property_name});
       !result) {
@@ -252,7 +398,6 @@ LocalClusteringCoefficientWithWrap(
   auto sorted_view =
       KATANA_CHECKED(SortedGraphView::Make(pg, {output_property_name}, {}));
 
-  Algorithm algo;
   return algo(&sorted_view);
 }
 
@@ -321,6 +466,11 @@ katana::analytics::LocalClusteringCoefficient(
     return LocalClusteringCoefficientWithWrap<
         LocalClusteringCoefficientPerThread>(pg, output_property_name, txn_ctx);
   }
+  case LocalClusteringCoefficientPlan::kWedgeSampling: {
+    return LocalClusteringCoefficientWithWrap(
+        pg, output_property_name, txn_ctx,
+        LocalClusteringCoefficientWedgeSampling{plan});
+  }
   default:
     return katana::ErrorCode::InvalidArgument;
   }
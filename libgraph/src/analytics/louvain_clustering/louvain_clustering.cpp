@@ -54,6 +54,7 @@ struct LouvainClusteringImplementation
 
   using Base = katana::analytics::ClusteringImplementationBase<
       Graph, EdgeWeightType, CommTy>;
+  using PerThreadNeighborClusters = typename Base::PerThreadNeighborClusters;
 
   katana::Result<double> LouvainWithoutLockingDoAll(
       Graph* graph, double lower, double modularity_threshold_per_round,
@@ -90,6 +91,8 @@ struct LouvainClusteringImplementation
       KATANA_LOG_FATAL("constant_for_second_term is INFINITY\n");
     }
 
+    PerThreadNeighborClusters neighbor_clusters;
+
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
     while (true) {
@@ -110,22 +113,17 @@ struct LouvainClusteringImplementation
 
             uint64_t degree = Degree(*graph, n);
             uint64_t local_target = Base::UNASSIGNED;
-            // TODO(amber): use scalable allocator with these containers
-            std::map<uint64_t, uint64_t>
-                cluster_local_map;  // Map each neighbor's cluster to local number:
-                                    // Community --> Index
-            std::vector<EdgeWeightType>
-                counter;  // Number of edges to each unique cluster
+            // Edges to each unique cluster around n
+            auto* clusters = neighbor_clusters.getLocal();
             EdgeWeightType self_loop_wt = 0;
 
             if (degree > 0) {
               Base::template FindNeighboringClusters<EdgeWeightType>(
-                  *graph, n, cluster_local_map, counter, self_loop_wt);
+                  *graph, n, clusters, self_loop_wt);
               // Find the max gain in modularity
               local_target = Base::MaxModularityWithoutSwaps(
-                  cluster_local_map, counter, self_loop_wt, c_info,
-                  n_data_degree_wt, n_data_curr_comm_id,
-                  constant_for_second_term);
+                  *clusters, self_loop_wt, c_info, n_data_degree_wt,
+                  n_data_curr_comm_id, constant_for_second_term);
 
             } else {
               local_target = Base::UNASSIGNED;
@@ -189,9 +187,7 @@ struct LouvainClusteringImplementation
     katana::StatTimer TimerClusteringTotal("Timer_Clustering_Total");
     katana::TimerGuard TimerClusteringGuard(TimerClusteringTotal);
 
-    CommunityArray c_info;        // Community info
-    CommunityArray c_update_add;  // Used for updating community
-    CommunityArray c_update_subtract;
+    CommunityArray c_info;  // Community info
 
     /* Variables needed for Modularity calculation */
     double constant_for_second_term;
@@ -201,8 +197,6 @@ struct LouvainClusteringImplementation
 
     /*** Initialization ***/
     c_info.allocateBlocked(graph->NumNodes());
-    c_update_add.allocateBlocked(graph->NumNodes());
-    c_update_subtract.allocateBlocked(graph->NumNodes());
 
     /* Initialization each node to its own cluster */
     katana::do_all(katana::iterate(*graph), [&](GNode n) {
@@ -220,39 +214,22 @@ struct LouvainClusteringImplementation
     katana::NUMAArray<uint64_t> local_target;
     local_target.allocateBlocked(graph->NumNodes());
 
-    // partition nodes
-    std::vector<katana::InsertBag<GNode>> bag(16);
-
-    katana::InsertBag<GNode> to_process;
-    katana::NUMAArray<bool> in_bag;
-
-    in_bag.allocateBlocked(graph->NumNodes());
-
-    katana::do_all(katana::iterate(*graph), [&](GNode n) {
-      uint64_t idx = n % 16;
-      bag[idx].push(n);
-      in_bag[n] = false;
-      local_target[n] = Base::UNASSIGNED;
-    });
+    // Nodes of a batch pick their targets from the same community totals
+    // and move together, so the result does not depend on the schedule
+    auto batches = Base::ColorIntoBatches(*graph);
 
-    katana::do_all(katana::iterate(*graph), [&](GNode n) {
-      c_update_add[n].degree_wt = 0;
-      c_update_add[n].size = 0;
-      c_update_subtract[n].degree_wt = 0;
-      c_update_subtract[n].size = 0;
-    });
+    PerThreadNeighborClusters neighbor_clusters;
 
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
 
     while (true) {
       num_iter++;
+      uint64_t num_moves = 0;
 
-      for (uint64_t idx = 0; idx <= 15; idx++) {
-        katana::GAccumulator<uint32_t> sync_round;
-
+      for (size_t b = 0; b < batches.num_batches(); b++) {
         katana::do_all(
-            katana::iterate(bag[idx]),
+            katana::iterate(batches.begin(b), batches.end(b)),
             [&](GNode n) {
               auto& n_data_curr_comm_id =
                   graph->template GetData<CurrentCommunityID>(n);
@@ -261,74 +238,26 @@ struct LouvainClusteringImplementation
 
               uint64_t degree = Degree(*graph, n);
 
-              // TODO(amber): use scalable allocators
-              std::map<uint64_t, uint64_t>
-                  cluster_local_map;  // Map each neighbor's cluster to local number:
-                                      // Community --> Index
-              std::vector<EdgeWeightType>
-                  counter;  // Number of edges to each unique cluster
+              // Edges to each unique cluster around n
+              auto* clusters = neighbor_clusters.getLocal();
               EdgeWeightType self_loop_wt = 0;
 
               if (degree > 0) {
                 Base::template FindNeighboringClusters<EdgeWeightType>(
-                    *graph, n, cluster_local_map, counter, self_loop_wt);
+                    *graph, n, clusters, self_loop_wt);
                 // Find the max gain in modularity
                 local_target[n] = Base::MaxModularityWithoutSwaps(
-                    cluster_local_map, counter, self_loop_wt, c_info,
-                    n_data_degree_wt, n_data_curr_comm_id,
-                    constant_for_second_term);
+                    *clusters, self_loop_wt, c_info, n_data_degree_wt,
+                    n_data_curr_comm_id, constant_for_second_term);
 
               } else {
                 local_target[n] = Base::UNASSIGNED;
               }
-
-              /* Update cluster info */
-              if (local_target[n] != n_data_curr_comm_id &&
-                  local_target[n] != Base::UNASSIGNED) {
-                katana::atomicAdd(
-                    c_update_add[local_target[n]].degree_wt, n_data_degree_wt);
-                katana::atomicAdd(
-                    c_update_add[local_target[n]].size, (uint64_t)1);
-                katana::atomicAdd(
-                    c_update_subtract[n_data_curr_comm_id].degree_wt,
-                    n_data_degree_wt);
-                katana::atomicAdd(
-                    c_update_subtract[n_data_curr_comm_id].size, (uint64_t)1);
-
-                if (!in_bag[local_target[n]]) {
-                  to_process.push(local_target[n]);
-                  in_bag[local_target[n]] = true;
-                }
-
-                if (!in_bag[n_data_curr_comm_id]) {
-                  to_process.push(n_data_curr_comm_id);
-                  in_bag[n_data_curr_comm_id] = true;
-                }
-              }
             },
-            katana::loopname("louvain algo: Phase 1"));
-
-        katana::do_all(katana::iterate(bag[idx]), [&](GNode n) {
-          graph->template GetData<CurrentCommunityID>(n) = local_target[n];
-        });
-
-        for (auto n : to_process) {
-          if (in_bag[n]) {
-            katana::atomicAdd(c_info[n].size, c_update_add[n].size.load());
-            katana::atomicAdd(
-                c_info[n].degree_wt, c_update_add[n].degree_wt.load());
-
-            katana::atomicSub(c_info[n].size, c_update_subtract[n].size.load());
-            katana::atomicSub(
-                c_info[n].degree_wt, c_update_subtract[n].degree_wt.load());
-            c_update_add[n].size = 0;
-            c_update_add[n].degree_wt = 0;
-            c_update_subtract[n].size = 0;
-            c_update_subtract[n].degree_wt = 0;
-            in_bag[n] = false;
-          }
-        }
+            katana::steal(), katana::loopname("louvain algo: Phase 1"));
 
+        num_moves += Base::template CommitBatch<EdgeWeightType>(
+            graph, batches.begin(b), batches.end(b), local_target, c_info);
       }  // end for
 
       /* Calculate the overall modularity */
@@ -338,6 +267,10 @@ struct LouvainClusteringImplementation
       curr_mod = Base::template CalModularity<EdgeWeightType>(
           *graph, c_info, e_xx, a2_x, constant_for_second_term);
 
+      Base::ReportDeterministicRound(
+          "Louvain-Deterministic", num_iter, batches.num_batches(), num_moves,
+          curr_mod);
+
       if ((curr_mod - prev_mod) < modularity_threshold_per_round) {
         prev_mod = curr_mod;
         break;
@@ -19,6 +19,7 @@
 
 #include "katana/analytics/matrix_completion/matrix_completion.h"
 
+#include <algorithm>
 #include <cmath>
 #include <type_traits>
 #include <utility>
@@ -28,6 +29,7 @@
 #include "katana/AtomicWrapper.h"
 #include "katana/Bag.h"
 #include "katana/Galois.h"
+#include "katana/NUMAArray.h"
 #include "katana/ParallelSTL.h"
 #include "katana/Properties.h"
 #include "katana/Reduction.h"
@@ -254,11 +256,13 @@ struct MatrixCompletionImplementation
   }
 };
 
-// Common function to execute different algorithms till convergence
-template <typename Fn>
+// Common function to execute different algorithms till convergence;
+// sum_squared_error() is the error of the latent vectors after each round
+template <typename Fn, typename ErrorFn>
 void
 ExecuteUntilConverged(
-    const MatrixCompletionImplementation::StepFunction& sf, Graph& graph, Fn fn,
+    const MatrixCompletionImplementation::StepFunction& sf, Fn fn,
+    ErrorFn sum_squared_error, uint64_t num_ratings, const std::string& name,
     MatrixCompletionPlan plan, MatrixCompletionImplementation impl) {
   katana::GAccumulator<double> error_accum;
   std::vector<LatentValue> steps(plan.updatesPerEdge());
@@ -288,11 +292,18 @@ ExecuteUntilConverged(
     fn(&steps[0], round + delta_round,
        plan.useExactError() ? &error_accum : NULL, plan, impl);
     executeAlgoTimer.stop();
-    double error = plan.useExactError() ? error_accum.reduce()
-                                        : impl.SumSquaredError(graph);
+    double error =
+        plan.useExactError() ? error_accum.reduce() : sum_squared_error();
 
     elapsed.stop();
-
+    katana::ReportStatSingle(
+        name, fmt::format("Round{}ElapsedMs", round + delta_round),
+        elapsed.get());
+    if (!plan.useExactError()) {
+      katana::ReportStatSingle(
+          name, fmt::format("Round{}RMSE", round + delta_round),
+          std::sqrt(error / num_ratings));
+    }
     elapsed.start();
 
     if (!impl.IsFinite(error))
@@ -350,7 +361,7 @@ private:
   };
 
 public:
-  void operator()(
+  katana::Result<void> operator()(
       Graph& graph, const MatrixCompletionImplementation::StepFunction& sf,
       MatrixCompletionPlan plan, MatrixCompletionImplementation impl) {
     katana::GAccumulator<unsigned> edges_visited;
@@ -359,12 +370,338 @@ public:
     executeTimer.start();
 
     Execute fn{graph, edges_visited};
-    ExecuteUntilConverged(sf, graph, fn, plan, impl);
+    ExecuteUntilConverged(
+        sf, fn, [&]() { return impl.SumSquaredError(graph); },
+        graph.NumEdges(), Name(), plan, impl);
 
     executeTimer.stop();
 
     katana::ReportStatSingle(
         "sgdItemsAlgo", "EdgesVisited", edges_visited.reduce());
+    return katana::ResultSuccess();
+  }
+};
+
+/// Latent vectors are stored padded to a multiple of 64 bytes
+constexpr size_t kLatentStride = (LATENT_VECTOR_SIZE + 7) / 8 * 8;
+
+/// The latent vectors of all nodes as rows of kLatentStride doubles, so
+/// that each row starts on a cache line and the kernels below vectorize
+/// over whole rows. The padding stays zero through every update.
+class LatentMatrix {
+public:
+  explicit LatentMatrix(size_t num_nodes) {
+    values_.allocateInterleaved(num_nodes * kLatentStride);
+    katana::ParallelSTL::fill(values_.begin(), values_.end(), 0.0);
+  }
+
+  double* Row(GNode n) { return &values_[n * kLatentStride]; }
+  const double* Row(GNode n) const { return &values_[n * kLatentStride]; }
+
+  void Load(Graph& graph) {
+    katana::do_all(katana::iterate(graph), [&](GNode n) {
+      auto latent_vector = graph.GetData<NodeLatentVector>(n);
+      for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
+        Row(n)[i] = latent_vector[i];
+      }
+    });
+  }
+
+  void Store(Graph& graph) const {
+    katana::do_all(katana::iterate(graph), [&](GNode n) {
+      auto latent_vector = graph.GetData<NodeLatentVector>(n);
+      for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
+        latent_vector[i] = Row(n)[i];
+      }
+    });
+  }
+
+private:
+  katana::NUMAArray<double> values_;
+};
+
+double
+Dot(const double* __restrict__ first, const double* __restrict__ second) {
+  double res = 0;
+  for (size_t i = 0; i < kLatentStride; i++) {
+    res += first[i] * second[i];
+  }
+  return res;
+}
+
+/// The update of DoGradientUpdate on rows of a LatentMatrix; no other
+/// thread may update either row meanwhile
+double
+GradientStep(
+    double* __restrict__ item, double* __restrict__ user, double lambda,
+    double rating, double step_size) {
+  double error = rating - Dot(item, user);
+  for (size_t i = 0; i < kLatentStride; i++) {
+    double prev_item = item[i];
+    double prev_user = user[i];
+    item[i] += step_size * (error * prev_user - lambda * prev_item);
+    user[i] += step_size * (error * prev_item - lambda * prev_user);
+  }
+  return error;
+}
+
+struct Rating {
+  GNode item;
+  GNode user;
+  double value;
+};
+
+/// The ratings of the items in edge order, so the ratings of item n are the
+/// out-edges of n. The tiled and ALS algorithms need every user to come
+/// after all items; users may have no out-edges, or they would be taken
+/// for items.
+katana::Result<katana::NUMAArray<Rating>>
+CollectRatings(Graph& graph) {
+  uint64_t num_ratings =
+      kNumItemNodes == 0 ? 0 : *graph.OutEdges(kNumItemNodes - 1).end();
+  if (num_ratings != graph.NumEdges()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} of {} edges are not out-edges of items",
+        graph.NumEdges() - num_ratings, graph.NumEdges());
+  }
+  katana::NUMAArray<Rating> ratings;
+  ratings.allocateBlocked(num_ratings);
+  katana::GReduceLogicalOr not_bipartite;
+  katana::do_all(
+      katana::iterate(graph.begin(), graph.begin() + kNumItemNodes),
+      [&](GNode n) {
+        for (auto ii : graph.OutEdges(n)) {
+          GNode dst = graph.OutEdgeDst(ii);
+          if (dst < kNumItemNodes) {
+            not_bipartite.update(true);
+          }
+          ratings[ii] = Rating{n, dst, graph.GetEdgeData<EdgeWeight>(ii)};
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (not_bipartite.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "users must have higher node IDs than all items");
+  }
+  return ratings;
+}
+
+double
+SumSquaredError(
+    const LatentMatrix& latent, const katana::NUMAArray<Rating>& ratings) {
+  katana::GAccumulator<double> error;
+  katana::do_all(
+      katana::iterate(ratings.begin(), ratings.end()),
+      [&](const Rating& r) {
+        double e = r.value - Dot(latent.Row(r.item), latent.Row(r.user));
+        error += e * e;
+      },
+      katana::no_stats());
+  return error.reduce();
+}
+
+/// The offsets of the runs of equal keys in ratings sorted by key:
+/// ratings with key k are [offsets[k], offsets[k + 1])
+template <typename KeyFn>
+katana::NUMAArray<uint64_t>
+GroupOffsets(
+    const katana::NUMAArray<Rating>& ratings, uint64_t num_keys,
+    KeyFn key_fn) {
+  katana::NUMAArray<uint64_t> offsets;
+  offsets.allocateBlocked(num_keys + 1);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_keys + 1),
+      [&](uint64_t k) {
+        offsets[k] = std::lower_bound(
+                         ratings.begin(), ratings.end(), k,
+                         [&](const Rating& r, uint64_t key) {
+                           return key_fn(r) < key;
+                         }) -
+                     ratings.begin();
+      },
+      katana::no_stats());
+  return offsets;
+}
+
+/// Stratified SGD (Gemulla et al., 2011): items and users are cut into as
+/// many blocks as there are threads, and the ratings into the tiles of the
+/// grid of item blocks by user blocks. A round takes one stratum of tiles
+/// that share no item or user block after another and updates the tiles of
+/// a stratum in parallel, so updates need no atomics and each thread works
+/// on a cache-sized set of latent vectors at a time.
+class SGDTiledAlgo {
+public:
+  std::string Name() const { return "sgdTiledAlgo"; }
+
+  katana::Result<void> operator()(
+      Graph& graph, const MatrixCompletionImplementation::StepFunction& sf,
+      MatrixCompletionPlan plan, MatrixCompletionImplementation impl) {
+    katana::StatTimer executeTimer("Time");
+    executeTimer.start();
+
+    LatentMatrix latent(graph.NumNodes());
+    latent.Load(graph);
+    katana::NUMAArray<Rating> ratings = KATANA_CHECKED(CollectRatings(graph));
+
+    uint64_t num_users = graph.NumNodes() - kNumItemNodes;
+    uint64_t blocks = katana::getActiveThreads();
+    auto tile = [&](const Rating& r) -> uint64_t {
+      uint64_t item_block = uint64_t{r.item} * blocks / kNumItemNodes;
+      uint64_t user_block = (r.user - kNumItemNodes) * blocks / num_users;
+      return item_block * blocks + user_block;
+    };
+    // Within a tile, the ratings of an item stay together.
+    katana::ParallelSTL::radix_sort(
+        ratings.begin(), ratings.end(), [&](const Rating& r) {
+          return (tile(r) << 32) | r.item;
+        });
+    katana::NUMAArray<uint64_t> tile_offsets =
+        GroupOffsets(ratings, blocks * blocks, tile);
+
+    auto execute = [&](LatentValue* steps, int,
+                       katana::GAccumulator<double>*, MatrixCompletionPlan,
+                       MatrixCompletionImplementation) {
+      const LatentValue step_size = steps[0];
+      for (uint64_t stratum = 0; stratum < blocks; ++stratum) {
+        katana::do_all(
+            katana::iterate(uint64_t{0}, blocks),
+            [&](uint64_t item_block) {
+              uint64_t t =
+                  item_block * blocks + (item_block + stratum) % blocks;
+              for (uint64_t k = tile_offsets[t]; k < tile_offsets[t + 1];
+                   ++k) {
+                const Rating& r = ratings[k];
+                GradientStep(
+                    latent.Row(r.item), latent.Row(r.user), plan.lambda(),
+                    r.value, step_size);
+              }
+            },
+            katana::loopname("sgdTiledAlgo"));
+      }
+    };
+    ExecuteUntilConverged(
+        sf, execute, [&]() { return SumSquaredError(latent, ratings); },
+        ratings.size(), Name(), plan, impl);
+
+    latent.Store(graph);
+    executeTimer.stop();
+    return katana::ResultSuccess();
+  }
+};
+
+/// Alternating least squares with weighted-lambda regularization (Zhou et
+/// al., 2008): a round solves for the latent vectors of all items with the
+/// users fixed, then for those of all users with the items fixed. Each
+/// vector is the solution of a small regularized least-squares problem,
+/// solved by Cholesky decomposition.
+class ALSAlgo {
+public:
+  std::string Name() const { return "alsAlgo"; }
+
+  katana::Result<void> operator()(
+      Graph& graph, const MatrixCompletionImplementation::StepFunction& sf,
+      MatrixCompletionPlan plan, MatrixCompletionImplementation impl) {
+    katana::StatTimer executeTimer("Time");
+    executeTimer.start();
+
+    LatentMatrix latent(graph.NumNodes());
+    latent.Load(graph);
+    katana::NUMAArray<Rating> by_item = KATANA_CHECKED(CollectRatings(graph));
+    katana::NUMAArray<Rating> by_user;
+    by_user.allocateBlocked(by_item.size());
+    katana::ParallelSTL::copy(by_item.begin(), by_item.end(), by_user.begin());
+    katana::ParallelSTL::radix_sort(
+        by_user.begin(), by_user.end(),
+        [](const Rating& r) { return r.user; });
+    katana::NUMAArray<uint64_t> user_offsets = GroupOffsets(
+        by_user, graph.NumNodes() - kNumItemNodes,
+        [](const Rating& r) -> uint64_t { return r.user - kNumItemNodes; });
+
+    auto execute = [&](LatentValue*, int, katana::GAccumulator<double>*,
+                       MatrixCompletionPlan, MatrixCompletionImplementation) {
+      katana::do_all(
+          katana::iterate(graph.begin(), graph.begin() + kNumItemNodes),
+          [&](GNode n) {
+            auto edges = graph.OutEdges(n);
+            Solve(
+                by_item.data() + *edges.begin(), by_item.data() + *edges.end(),
+                &Rating::user, latent, plan.lambda(), latent.Row(n));
+          },
+          katana::steal(), katana::loopname("alsAlgoItems"));
+      katana::do_all(
+          katana::iterate(graph.begin() + kNumItemNodes, graph.end()),
+          [&](GNode n) {
+            uint64_t u = n - kNumItemNodes;
+            Solve(
+                by_user.data() + user_offsets[u],
+                by_user.data() + user_offsets[u + 1],
+                &Rating::item, latent, plan.lambda(), latent.Row(n));
+          },
+          katana::steal(), katana::loopname("alsAlgoUsers"));
+    };
+    ExecuteUntilConverged(
+        sf, execute, [&]() { return SumSquaredError(latent, by_item); },
+        by_item.size(), Name(), plan, impl);
+
+    latent.Store(graph);
+    executeTimer.stop();
+    return katana::ResultSuccess();
+  }
+
+private:
+  /// Sets x to the minimizer of the squared error of its ratings plus
+  /// lambda * |ratings| * |x|^2, where the other node of rating r is
+  /// r.*other; leaves x as it is if there are no ratings
+  static void Solve(
+      const Rating* begin, const Rating* end, GNode Rating::*other,
+      const LatentMatrix& latent, double lambda, double* x) {
+    constexpr size_t k = LATENT_VECTOR_SIZE;
+    if (begin == end) {
+      return;
+    }
+    double a[k][k] = {};
+    double b[k] = {};
+    for (const Rating* r = begin; r != end; ++r) {
+      const double* v = latent.Row(r->*other);
+      for (size_t i = 0; i < k; i++) {
+        for (size_t j = 0; j <= i; j++) {
+          a[i][j] += v[i] * v[j];
+        }
+        b[i] += r->value * v[i];
+      }
+    }
+    double regularization = lambda * (end - begin);
+
+    // The lower triangle of a becomes its Cholesky factor.
+    for (size_t j = 0; j < k; j++) {
+      double d = a[j][j] + regularization;
+      for (size_t p = 0; p < j; p++) {
+        d -= a[j][p] * a[j][p];
+      }
+      a[j][j] = std::sqrt(d);
+      for (size_t i = j + 1; i < k; i++) {
+        double s = a[i][j];
+        for (size_t p = 0; p < j; p++) {
+          s -= a[i][p] * a[j][p];
+        }
+        a[i][j] = s / a[j][j];
+      }
+    }
+    for (size_t i = 0; i < k; i++) {
+      for (size_t p = 0; p < i; p++) {
+        b[i] -= a[i][p] * b[p];
+      }
+      b[i] /= a[i][i];
+    }
+    for (size_t i = k; i-- > 0;) {
+      for (size_t p = i + 1; p < k; p++) {
+        b[i] -= a[p][i] * b[p];
+      }
+      b[i] /= a[i][i];
+    }
+    std::copy(b, b + k, x);
   }
 };
 
@@ -388,7 +725,7 @@ Run(katana::PropertyGraph* pg, MatrixCompletionPlan plan,
   katana::StatTimer execTime("MatrixCompletion");
 
   execTime.start();
-  algo(graph, *sf, plan, impl);
+  KATANA_CHECKED(algo(graph, *sf, plan, impl));
   execTime.stop();
 
   return katana::ResultSuccess();
@@ -403,6 +740,10 @@ katana::analytics::MatrixCompletion(
   switch (plan.algorithm()) {
   case MatrixCompletionPlan::kSGDByItems:
     return Run<SGDItemsAlgo>(pg, plan, txn_ctx);
+  case MatrixCompletionPlan::kSGDTiled:
+    return Run<SGDTiledAlgo>(pg, plan, txn_ctx);
+  case MatrixCompletionPlan::kALS:
+    return Run<ALSAlgo>(pg, plan, txn_ctx);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
@@ -0,0 +1,739 @@
+#include "katana/analytics/max_flow/max_flow.h"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/ErrorCode.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/RunStatistics.h"
+
+using namespace katana::analytics;
+
+const uint32_t MaxFlowPlan::kDefaultGlobalRelabelInterval = 0;
+const bool MaxFlowPlan::kDefaultGapHeuristic = true;
+
+namespace {
+
+template <typename Capacity>
+struct MaxFlowCapacity : public katana::PODProperty<Capacity> {};
+
+struct MaxFlowEdgeFlow : public katana::PODProperty<uint64_t> {};
+
+template <typename Capacity>
+using Graph = katana::TypedPropertyGraph<
+    std::tuple<>, std::tuple<MaxFlowCapacity<Capacity>, MaxFlowEdgeFlow>>;
+
+using Flow = int64_t;
+
+/// The work of a discharge and the extra work of a relabel towards the
+/// global relabel interval, and the interval per node, after Goldberg's
+/// parameters as used by lonestar preflowpush
+constexpr uint64_t kDischargeWork = 1;
+constexpr uint64_t kRelabelWork = 12;
+constexpr uint64_t kIntervalPerNode = 6;
+/// The height of nodes that a global relabel has not reached yet
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max();
+
+/// The residual network of a graph. The arcs of a node are those of its
+/// out-edges, with the capacity of the edge, followed by those of its
+/// in-edges, with none; reverse pairs the two arcs of each edge.
+struct ResidualNetwork {
+  std::vector<uint64_t> arc_begin;
+  std::vector<uint32_t> head;
+  std::vector<uint64_t> reverse;
+  std::vector<Flow> residual;
+
+  uint32_t NumNodes() const { return arc_begin.size() - 1; }
+};
+
+/// Two phase preflow-push on a residual network. Phase one discharges
+/// nodes towards the sink with the source as the other terminal; phase two
+/// returns the excess of the nodes cut off from the sink to the source,
+/// with the sink as the other terminal. Nodes are never raised to the
+/// height of the other terminal, the node count, or above.
+///
+/// A node is discharged by one thread at a time, which alone lowers its
+/// excess and the residual of its arcs and alone changes its height, so
+/// pushes and relabels need no locks. Heights of neighbors may be stale;
+/// a phase only ends when no node is active after a global relabel, which
+/// sets exact heights, so stale heights cost work but never the result.
+class PreflowPush {
+public:
+  PreflowPush(
+      ResidualNetwork* net, uint32_t source, uint32_t sink,
+      const MaxFlowPlan& plan)
+      : net_(*net),
+        source_(source),
+        sink_(sink),
+        max_height_(net->NumNodes()),
+        gap_heuristic_(plan.gap_heuristic()),
+        relabel_interval_(plan.global_relabel_interval()),
+        height_(net->NumNodes()),
+        excess_(net->NumNodes(), 0),
+        queued_(net->NumNodes(), 0),
+        height_count_(max_height_, 0) {
+    if (relabel_interval_ == 0) {
+      relabel_interval_ = kIntervalPerNode * net->NumNodes() +
+                          net->head.size() / 3 + kRelabelWork;
+    }
+  }
+
+  /// Leave a maximum flow in the residual network. Fails if some excess
+  /// cannot be returned to the source, which would be a bug.
+  katana::Result<void> Run(katana::analytics::RunRecorder* recorder) {
+    SaturateSource();
+    RunPhase(sink_, source_);
+    RunPhase(source_, sink_);
+
+    katana::GAccumulator<uint64_t> stranded;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, net_.NumNodes()),
+        [&](uint32_t node) {
+          if (node != source_ && node != sink_ && excess_[node] != 0) {
+            stranded += 1;
+          }
+        },
+        katana::loopname("MaxFlow Check"), katana::no_stats());
+    if (stranded.reduce() != 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "{} nodes keep excess flow after preflow-push", stranded.reduce());
+    }
+
+    katana::ReportStatSingle(
+        "MaxFlow", "GlobalRelabels", num_global_relabels_);
+    katana::ReportStatSingle("MaxFlow", "GapLifts", num_gap_lifts_);
+    recorder->AddIterations(num_global_relabels_);
+    recorder->AddWorkItems(num_discharges_);
+    return katana::ResultSuccess();
+  }
+
+private:
+  void SaturateSource() {
+    for (uint64_t arc = net_.arc_begin[source_];
+         arc < net_.arc_begin[source_ + 1]; ++arc) {
+      uint32_t dst = net_.head[arc];
+      if (dst == source_) {
+        continue;
+      }
+      Flow amount = net_.residual[arc];
+      net_.residual[arc] = 0;
+      net_.residual[net_.reverse[arc]] += amount;
+      excess_[dst] += amount;
+    }
+  }
+
+  void RunPhase(uint32_t target, uint32_t other) {
+    target_ = target;
+    other_ = other;
+    katana::InsertBag<uint32_t> active;
+    while (true) {
+      GlobalRelabel();
+      CollectActive(&active);
+      if (active.empty()) {
+        return;
+      }
+      while (!active.empty()) {
+        Discharge(&active);
+        if (should_global_relabel_ || gap_ == kUnreached) {
+          break;
+        }
+        LiftGap();
+        CollectActive(&active);
+      }
+    }
+  }
+
+  /// Set every height to the residual distance to the target by a breadth
+  /// first search over the arcs into each level. Nodes that cannot reach
+  /// the target get the maximum height.
+  void GlobalRelabel() {
+    ++num_global_relabels_;
+    work_.reset();
+    katana::ParallelSTL::fill(height_.begin(), height_.end(), kUnreached);
+    katana::ParallelSTL::fill(height_count_.begin(), height_count_.end(), 0);
+    height_[other_] = max_height_;
+    height_[target_] = 0;
+
+    katana::InsertBag<uint32_t> frontiers[2];
+    katana::InsertBag<uint32_t>* current = &frontiers[0];
+    katana::InsertBag<uint32_t>* next = &frontiers[1];
+    current->emplace(target_);
+    uint32_t level = 0;
+    while (!current->empty()) {
+      height_count_[level] = current->size();
+      katana::do_all(
+          katana::iterate(*current),
+          [&](uint32_t node) {
+            for (uint64_t arc = net_.arc_begin[node];
+                 arc < net_.arc_begin[node + 1]; ++arc) {
+              if (net_.residual[net_.reverse[arc]] <= 0) {
+                continue;
+              }
+              uint32_t src = net_.head[arc];
+              uint32_t expected = kUnreached;
+              if (__atomic_compare_exchange_n(
+                      &height_[src], &expected, level + 1, false,
+                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                next->emplace(src);
+              }
+            }
+          },
+          katana::steal(), katana::loopname("MaxFlow GlobalRelabel"));
+      current->clear();
+      std::swap(current, next);
+      ++level;
+    }
+    top_height_ = level;
+
+    katana::do_all(
+        katana::iterate(uint32_t{0}, net_.NumNodes()),
+        [&](uint32_t node) {
+          if (height_[node] == kUnreached) {
+            height_[node] = max_height_;
+          }
+        },
+        katana::loopname("MaxFlow GlobalRelabel Unreached"),
+        katana::no_stats());
+  }
+
+  /// Lift every node above the lowest height that emptied out to the
+  /// maximum height; their residual paths to the target all crossed it.
+  void LiftGap() {
+    ++num_gap_lifts_;
+    uint32_t gap = gap_;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, net_.NumNodes()),
+        [&](uint32_t node) {
+          uint32_t height = height_[node];
+          if (height > gap && height < max_height_) {
+            height_[node] = max_height_;
+            __atomic_fetch_sub(&height_count_[height], 1, __ATOMIC_RELAXED);
+          }
+        },
+        katana::loopname("MaxFlow LiftGap"), katana::no_stats());
+    top_height_ = gap;
+  }
+
+  void CollectActive(katana::InsertBag<uint32_t>* active) {
+    active->clear();
+    katana::do_all(
+        katana::iterate(uint32_t{0}, net_.NumNodes()),
+        [&](uint32_t node) {
+          bool is_active = node != target_ && node != other_ &&
+                           excess_[node] > 0 && height_[node] < max_height_;
+          queued_[node] = is_active;
+          if (is_active) {
+            active->emplace(node);
+          }
+        },
+        katana::loopname("MaxFlow CollectActive"), katana::no_stats());
+    should_global_relabel_ = false;
+    gap_ = kUnreached;
+  }
+
+  /// Discharge the active nodes and the nodes they activate until none are
+  /// left, the global relabel interval has passed or a height empties out
+  void Discharge(katana::InsertBag<uint32_t>* active) {
+    katana::GAccumulator<uint64_t> discharges;
+    const uint64_t thread_interval = std::max<uint64_t>(
+        relabel_interval_ / katana::getActiveThreads(), 1);
+    katana::for_each(
+        katana::iterate(*active),
+        [&](uint32_t node, auto& ctx) {
+          uint64_t increment = kDischargeWork;
+          if (DischargeNode(node, ctx)) {
+            increment += kRelabelWork;
+          }
+          work_ += increment;
+          discharges += 1;
+          if (work_.getLocal() >= thread_interval) {
+            __atomic_store_n(&should_global_relabel_, true, __ATOMIC_RELAXED);
+            ctx.breakLoop();
+          } else if (__atomic_load_n(&gap_, __ATOMIC_RELAXED) != kUnreached) {
+            ctx.breakLoop();
+          }
+        },
+        katana::disable_conflict_detection(), katana::parallel_break(),
+        katana::loopname("MaxFlow Discharge"));
+    num_discharges_ += discharges.reduce();
+  }
+
+  /// Push the excess of node to lower neighbors and relabel it when none
+  /// are left, until it has no excess or reaches the maximum height.
+  /// Returns whether node was relabeled.
+  template <typename Context>
+  bool DischargeNode(uint32_t node, Context& ctx) {
+    uint32_t height = height_[node];
+    Flow excess = __atomic_load_n(&excess_[node], __ATOMIC_SEQ_CST);
+    bool relabeled = false;
+    while (excess > 0 && height < max_height_) {
+      uint32_t min_height = kUnreached;
+      uint64_t arc = net_.arc_begin[node];
+      for (; arc < net_.arc_begin[node + 1] && excess > 0; ++arc) {
+        Flow residual = __atomic_load_n(&net_.residual[arc], __ATOMIC_RELAXED);
+        if (residual <= 0) {
+          continue;
+        }
+        uint32_t dst = net_.head[arc];
+        uint32_t dst_height = __atomic_load_n(&height_[dst], __ATOMIC_RELAXED);
+        if (dst_height >= height) {
+          min_height = std::min(min_height, dst_height);
+          continue;
+        }
+        Flow amount = std::min(excess, residual);
+        __atomic_fetch_sub(&net_.residual[arc], amount, __ATOMIC_RELAXED);
+        __atomic_fetch_add(
+            &net_.residual[net_.reverse[arc]], amount, __ATOMIC_RELAXED);
+        __atomic_fetch_sub(&excess_[node], amount, __ATOMIC_SEQ_CST);
+        __atomic_fetch_add(&excess_[dst], amount, __ATOMIC_SEQ_CST);
+        excess -= amount;
+        if (dst != target_) {
+          Enqueue(dst, ctx);
+        }
+      }
+      bool scanned_all = arc == net_.arc_begin[node + 1] && excess > 0;
+      // Other threads may have pushed more excess meanwhile
+      excess = __atomic_load_n(&excess_[node], __ATOMIC_SEQ_CST);
+      if (excess == 0 || !scanned_all) {
+        continue;
+      }
+
+      uint32_t new_height = min_height == kUnreached
+                                ? max_height_
+                                : std::min(min_height + 1, max_height_);
+      relabeled = true;
+      uint32_t left =
+          __atomic_sub_fetch(&height_count_[height], 1, __ATOMIC_RELAXED);
+      if (gap_heuristic_ && left == 0 &&
+          height + 1 < __atomic_load_n(&top_height_, __ATOMIC_RELAXED)) {
+        uint32_t gap = __atomic_load_n(&gap_, __ATOMIC_RELAXED);
+        while (height < gap && !__atomic_compare_exchange_n(
+                                   &gap_, &gap, height, true, __ATOMIC_RELAXED,
+                                   __ATOMIC_RELAXED)) {
+        }
+      }
+      if (new_height < max_height_) {
+        __atomic_fetch_add(&height_count_[new_height], 1, __ATOMIC_RELAXED);
+        uint32_t top = __atomic_load_n(&top_height_, __ATOMIC_RELAXED);
+        while (new_height >= top && !__atomic_compare_exchange_n(
+                                        &top_height_, &top, new_height + 1,
+                                        true, __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED)) {
+        }
+      }
+      __atomic_store_n(&height_[node], new_height, __ATOMIC_RELAXED);
+      height = new_height;
+    }
+
+    // Whoever pushes to node after this sees it unqueued and queues it
+    __atomic_store_n(&queued_[node], 0, __ATOMIC_SEQ_CST);
+    if (height < max_height_ &&
+        __atomic_load_n(&excess_[node], __ATOMIC_SEQ_CST) > 0) {
+      Enqueue(node, ctx);
+    }
+    return relabeled;
+  }
+
+  template <typename Context>
+  void Enqueue(uint32_t node, Context& ctx) {
+    if (node == other_ ||
+        __atomic_load_n(&height_[node], __ATOMIC_RELAXED) >= max_height_) {
+      return;
+    }
+    uint8_t expected = 0;
+    if (__atomic_compare_exchange_n(
+            &queued_[node], &expected, 1, false, __ATOMIC_SEQ_CST,
+            __ATOMIC_SEQ_CST)) {
+      ctx.push(node);
+    }
+  }
+
+  ResidualNetwork& net_;
+  uint32_t source_;
+  uint32_t sink_;
+  uint32_t target_{0};
+  uint32_t other_{0};
+  /// The height of the other terminal, which no other node reaches
+  uint32_t max_height_;
+  bool gap_heuristic_;
+  uint64_t relabel_interval_;
+
+  std::vector<uint32_t> height_;
+  std::vector<Flow> excess_;
+  std::vector<uint8_t> queued_;
+  /// The number of nodes at each height below the maximum
+  std::vector<uint32_t> height_count_;
+  /// One more than the largest height below the maximum given out since
+  /// the last global relabel
+  uint32_t top_height_{0};
+  /// The lowest height that emptied out since active nodes were collected
+  uint32_t gap_{kUnreached};
+  bool should_global_relabel_{false};
+  /// The work since the last global relabel
+  katana::GAccumulator<uint64_t> work_;
+
+  uint64_t num_global_relabels_{0};
+  uint64_t num_gap_lifts_{0};
+  uint64_t num_discharges_{0};
+};
+
+/// Whether capacity is a valid capacity, which is not negative and fits a
+/// Flow
+template <typename Capacity>
+bool
+IsValidCapacity(Capacity capacity) {
+  if constexpr (std::is_signed_v<Capacity>) {
+    return capacity >= 0;
+  } else {
+    return static_cast<uint64_t>(capacity) <=
+           static_cast<uint64_t>(std::numeric_limits<Flow>::max());
+  }
+}
+
+template <typename Capacity>
+katana::Result<ResidualNetwork>
+BuildResidualNetwork(katana::PropertyGraph* pg, const Graph<Capacity>& graph) {
+  using Node = typename Graph<Capacity>::Node;
+  auto transposed = pg->BuildView<katana::PropertyGraphViews::Transposed>();
+  uint32_t num_nodes = graph.NumNodes();
+
+  ResidualNetwork net;
+  net.arc_begin.resize(num_nodes + 1, 0);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& node) {
+        net.arc_begin[node + 1] =
+            graph.OutDegree(node) + transposed.OutDegree(node);
+      },
+      katana::loopname("MaxFlow Degrees"), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      net.arc_begin.begin(), net.arc_begin.end(), net.arc_begin.begin());
+
+  uint64_t num_arcs = net.arc_begin[num_nodes];
+  net.head.resize(num_arcs);
+  net.reverse.resize(num_arcs);
+  net.residual.resize(num_arcs);
+  // The forward arc of each edge by edge property index
+  std::vector<uint64_t> forward_arc(graph.NumEdges());
+  katana::GAccumulator<uint64_t> invalid_capacities;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& node) {
+        uint64_t arc = net.arc_begin[node];
+        for (auto e : graph.OutEdges(node)) {
+          Capacity capacity =
+              graph.template GetEdgeData<MaxFlowCapacity<Capacity>>(e);
+          if (!IsValidCapacity(capacity)) {
+            invalid_capacities += 1;
+          }
+          net.head[arc] = graph.OutEdgeDst(e);
+          net.residual[arc] = static_cast<Flow>(capacity);
+          forward_arc[pg->GetEdgePropertyIndexFromOutEdge(e)] = arc;
+          ++arc;
+        }
+      },
+      katana::steal(), katana::loopname("MaxFlow OutArcs"));
+  if (invalid_capacities.reduce() != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} capacities are negative or do not fit 63 bits",
+        invalid_capacities.reduce());
+  }
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& node) {
+        uint64_t arc = net.arc_begin[node] + graph.OutDegree(node);
+        for (auto e : transposed.OutEdges(node)) {
+          uint64_t forward =
+              forward_arc[transposed.GetEdgePropertyIndexFromOutEdge(e)];
+          net.head[arc] = transposed.OutEdgeDst(e);
+          net.residual[arc] = 0;
+          net.reverse[arc] = forward;
+          net.reverse[forward] = arc;
+          ++arc;
+        }
+      },
+      katana::steal(), katana::loopname("MaxFlow InArcs"));
+  return net;
+}
+
+template <typename Capacity>
+katana::Result<void>
+MaxFlowWithWrap(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MaxFlowPlan plan) {
+  katana::analytics::RunRecorder recorder("MaxFlow");
+  recorder.StartPhase(katana::analytics::kPhaseViewBuild);
+  KATANA_CHECKED(pg->ConstructEdgeProperties<std::tuple<MaxFlowEdgeFlow>>(
+      txn_ctx, {output_property_name}));
+  auto graph = KATANA_CHECKED(Graph<Capacity>::Make(
+      pg, {}, {capacity_property_name, output_property_name}));
+
+  recorder.StartPhase(katana::analytics::kPhaseInit);
+  ResidualNetwork net = KATANA_CHECKED(BuildResidualNetwork(pg, graph));
+  Flow source_capacity = 0;
+  for (uint64_t arc = net.arc_begin[source]; arc < net.arc_begin[source + 1];
+       ++arc) {
+    if (__builtin_add_overflow(
+            source_capacity, net.residual[arc], &source_capacity)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "the capacities out of the source do not fit 63 bits");
+    }
+  }
+
+  recorder.StartPhase(katana::analytics::kPhaseMainLoop);
+  katana::StatTimer exec_time("MaxFlow");
+  exec_time.start();
+  switch (plan.algorithm()) {
+  case MaxFlowPlan::kPreflowPush:
+    KATANA_CHECKED(PreflowPush(&net, source, sink, plan).Run(&recorder));
+    break;
+  default:
+    return katana::ErrorCode::AssertionFailed;
+  }
+  exec_time.stop();
+
+  recorder.StartPhase(katana::analytics::kPhaseOutput);
+  using Node = typename Graph<Capacity>::Node;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& node) {
+        uint64_t arc = net.arc_begin[node];
+        for (auto e : graph.OutEdges(node)) {
+          graph.template GetEdgeData<MaxFlowEdgeFlow>(e) =
+              static_cast<uint64_t>(net.residual[net.reverse[arc]]);
+          ++arc;
+        }
+      },
+      katana::steal(), katana::loopname("MaxFlow Output"));
+  return katana::ResultSuccess();
+}
+
+template <typename T>
+struct CapacityTag {
+  using type = T;
+};
+
+/// Call func with the name of the capacity property and a CapacityTag of
+/// its type. Without a property name every edge has capacity 1.
+template <typename R, typename Func>
+katana::Result<R>
+WithCapacities(
+    katana::PropertyGraph* pg, const std::string& capacity_property_name,
+    katana::TxnContext* txn_ctx, Func&& func) {
+  if (capacity_property_name.empty()) {
+    TemporaryPropertyGuard temporary_edge_property{
+        pg->EdgeMutablePropertyView()};
+    KATANA_CHECKED(katana::analytics::AddDefaultEdgeWeight<int64_t>(
+        pg, temporary_edge_property.name(), 1, txn_ctx));
+    return func(temporary_edge_property.name(), CapacityTag<int64_t>{});
+  }
+  if (!pg->HasEdgeProperty(capacity_property_name)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "Edge Property: {} Not found",
+        capacity_property_name);
+  }
+
+  auto property = KATANA_CHECKED(pg->GetEdgeProperty(capacity_property_name));
+  switch (property->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return func(capacity_property_name, CapacityTag<uint32_t>{});
+  case arrow::Int32Type::type_id:
+    return func(capacity_property_name, CapacityTag<int32_t>{});
+  case arrow::UInt64Type::type_id:
+    return func(capacity_property_name, CapacityTag<uint64_t>{});
+  case arrow::Int64Type::type_id:
+    return func(capacity_property_name, CapacityTag<int64_t>{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        property->type()->ToString());
+  }
+}
+
+katana::Result<void>
+CheckTerminals(katana::PropertyGraph* pg, uint32_t source, uint32_t sink) {
+  if (source >= pg->NumNodes() || sink >= pg->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source {} or sink {} is not a node of a graph of {} nodes", source,
+        sink, pg->NumNodes());
+  }
+  if (source == sink) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "the source is the sink");
+  }
+  return katana::ResultSuccess();
+}
+
+/// What AssertValid and Statistics need to know about a flow
+struct FlowSummary {
+  /// The number of edges with more flow than capacity
+  uint64_t over_capacity{0};
+  /// The number of nodes other than the terminals where flow is not
+  /// conserved
+  uint64_t unbalanced_nodes{0};
+  /// The net flow out of the source and into the sink
+  Flow source_flow{0};
+  Flow sink_flow{0};
+  uint64_t saturated_edges{0};
+  /// Whether the residual network has a path from source to sink
+  bool has_augmenting_path{false};
+};
+
+template <typename Capacity>
+katana::Result<FlowSummary>
+Summarize(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_property_name) {
+  auto graph = KATANA_CHECKED(Graph<Capacity>::Make(
+      pg, {}, {capacity_property_name, output_property_name}));
+  FlowSummary summary;
+  std::vector<Flow> net_out(graph.NumNodes(), 0);
+  std::vector<std::vector<uint32_t>> residual_adjacency(graph.NumNodes());
+  for (auto node : graph) {
+    for (auto e : graph.OutEdges(node)) {
+      uint32_t dst = graph.OutEdgeDst(e);
+      auto capacity = static_cast<Flow>(
+          graph.template GetEdgeData<MaxFlowCapacity<Capacity>>(e));
+      auto flow =
+          static_cast<Flow>(graph.template GetEdgeData<MaxFlowEdgeFlow>(e));
+      if (flow < 0 || flow > capacity) {
+        ++summary.over_capacity;
+      }
+      if (capacity > 0 && flow == capacity) {
+        ++summary.saturated_edges;
+      }
+      net_out[node] += flow;
+      net_out[dst] -= flow;
+      if (flow < capacity) {
+        residual_adjacency[node].emplace_back(dst);
+      }
+      if (flow > 0) {
+        residual_adjacency[dst].emplace_back(node);
+      }
+    }
+  }
+
+  for (uint32_t node = 0; node < graph.NumNodes(); ++node) {
+    if (node != source && node != sink && net_out[node] != 0) {
+      ++summary.unbalanced_nodes;
+    }
+  }
+  summary.source_flow = net_out[source];
+  summary.sink_flow = -net_out[sink];
+
+  std::vector<bool> reached(graph.NumNodes(), false);
+  std::deque<uint32_t> queue{source};
+  reached[source] = true;
+  while (!queue.empty() && !reached[sink]) {
+    uint32_t node = queue.front();
+    queue.pop_front();
+    for (uint32_t dst : residual_adjacency[node]) {
+      if (!reached[dst]) {
+        reached[dst] = true;
+        queue.emplace_back(dst);
+      }
+    }
+  }
+  summary.has_augmenting_path = reached[sink];
+  return summary;
+}
+
+katana::Result<FlowSummary>
+SummarizeAnyCapacity(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_property_name) {
+  KATANA_CHECKED(CheckTerminals(pg, source, sink));
+  katana::TxnContext txn_ctx;
+  return WithCapacities<FlowSummary>(
+      pg, capacity_property_name, &txn_ctx,
+      [&](const std::string& capacity_name, auto tag) {
+        using Capacity = typename decltype(tag)::type;
+        return Summarize<Capacity>(
+            pg, source, sink, capacity_name, output_property_name);
+      });
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MaxFlow(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MaxFlowPlan plan) {
+  KATANA_CHECKED(CheckTerminals(pg, source, sink));
+  return WithCapacities<void>(
+      pg, capacity_property_name, txn_ctx,
+      [&](const std::string& capacity_name, auto tag) {
+        using Capacity = typename decltype(tag)::type;
+        return MaxFlowWithWrap<Capacity>(
+            pg, source, sink, capacity_name, output_property_name, txn_ctx,
+            plan);
+      });
+}
+
+/// \cond DO_NOT_DOCUMENT
+katana::Result<void>
+katana::analytics::MaxFlowAssertValid(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_property_name) {
+  FlowSummary summary = KATANA_CHECKED(SummarizeAnyCapacity(
+      pg, source, sink, capacity_property_name, output_property_name));
+  if (summary.over_capacity != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} edges carry more flow than their capacity", summary.over_capacity);
+  }
+  if (summary.unbalanced_nodes != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "flow is not conserved at {} nodes", summary.unbalanced_nodes);
+  }
+  if (summary.source_flow != summary.sink_flow) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} flows out of the source but {} into the sink", summary.source_flow,
+        summary.sink_flow);
+  }
+  if (summary.has_augmenting_path) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the flow leaves an augmenting path");
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<MaxFlowStatistics>
+katana::analytics::MaxFlowStatistics::Compute(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_property_name) {
+  FlowSummary summary = KATANA_CHECKED(SummarizeAnyCapacity(
+      pg, source, sink, capacity_property_name, output_property_name));
+  return MaxFlowStatistics{
+      static_cast<uint64_t>(summary.sink_flow), summary.saturated_edges};
+}
+
+void
+katana::analytics::MaxFlowStatistics::Print(std::ostream& os) const {
+  os << "Flow value = " << flow_value << std::endl;
+  os << "Saturated edges = " << saturated_edges << std::endl;
+}
+/// \endcond DO_NOT_DOCUMENT
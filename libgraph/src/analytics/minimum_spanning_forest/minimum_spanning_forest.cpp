@@ -0,0 +1,512 @@
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/ErrorCode.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/RunStatistics.h"
+
+using namespace katana::analytics;
+
+const uint64_t MinimumSpanningForestPlan::kDefaultBaseCaseEdges = 1 << 16;
+
+namespace {
+
+template <typename Weight>
+struct MsfEdgeWeight : public katana::PODProperty<Weight> {};
+
+struct MsfInForest : public katana::PODProperty<uint8_t> {};
+
+template <typename Weight>
+using Graph = katana::TypedPropertyGraph<
+    std::tuple<>, std::tuple<MsfEdgeWeight<Weight>, MsfInForest>>;
+
+constexpr uint64_t kNoEdge = std::numeric_limits<uint64_t>::max();
+/// Filter-Kruskal pivots are the median weight of this many random edges
+constexpr uint32_t kPivotSamples = 63;
+
+template <typename Weight>
+struct WeightedEdge {
+  Weight weight;
+  uint64_t id;
+  uint32_t src;
+  uint32_t dst;
+};
+
+/// The total order of edges: by weight, then by id
+template <typename Weight>
+bool
+Lighter(const WeightedEdge<Weight>& a, const WeightedEdge<Weight>& b) {
+  return a.weight < b.weight || (a.weight == b.weight && a.id < b.id);
+}
+
+/// The edges of graph other than self loops
+template <typename Weight>
+std::vector<WeightedEdge<Weight>>
+CollectEdges(const Graph<Weight>& graph) {
+  using Node = typename Graph<Weight>::Node;
+  std::vector<uint64_t> offsets(graph.NumNodes() + 1, 0);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& node) {
+        uint64_t count = 0;
+        for (auto e : graph.OutEdges(node)) {
+          count += graph.OutEdgeDst(e) != node;
+        }
+        offsets[node + 1] = count;
+      },
+      katana::loopname("MinimumSpanningForest Count Edges"),
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      offsets.begin(), offsets.end(), offsets.begin());
+
+  std::vector<WeightedEdge<Weight>> edges(offsets.back());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& node) {
+        uint64_t out = offsets[node];
+        for (auto e : graph.OutEdges(node)) {
+          Node dst = graph.OutEdgeDst(e);
+          if (dst != node) {
+            edges[out++] = WeightedEdge<Weight>{
+                graph.template GetEdgeData<MsfEdgeWeight<Weight>>(e), e,
+                node, dst};
+          }
+        }
+      },
+      katana::loopname("MinimumSpanningForest Collect Edges"),
+      katana::no_stats());
+  return edges;
+}
+
+/// The root of node, for use while no other thread changes parent
+uint32_t
+FindRoot(const std::vector<uint32_t>& parent, uint32_t node) {
+  uint32_t next;
+  while ((next = __atomic_load_n(&parent[node], __ATOMIC_RELAXED)) != node) {
+    node = next;
+  }
+  return node;
+}
+
+template <typename Weight>
+void
+UpdateLightest(
+    uint64_t* slot, uint64_t candidate,
+    const std::vector<WeightedEdge<Weight>>& edges) {
+  uint64_t current = __atomic_load_n(slot, __ATOMIC_RELAXED);
+  while (current == kNoEdge || Lighter(edges[candidate], edges[current])) {
+    if (__atomic_compare_exchange_n(
+            slot, &current, candidate, true, __ATOMIC_RELAXED,
+            __ATOMIC_RELAXED)) {
+      return;
+    }
+  }
+}
+
+/// Parallel Boruvka. Components are trees of parent pointers; each round
+/// finds the lightest edge out of every root, hooks each root to the root at
+/// the other end of its edge, flattens the trees and drops the edges inside
+/// components. Since the order of edges is total, the hooks form no cycles
+/// except between two roots that picked the same edge, and of those only the
+/// larger root hooks.
+template <typename Weight>
+std::vector<uint64_t>
+Boruvka(
+    const std::vector<WeightedEdge<Weight>>& edges, uint32_t num_nodes,
+    katana::analytics::RunRecorder* recorder) {
+  std::vector<uint32_t> parent(num_nodes);
+  katana::ParallelSTL::iota(parent.begin(), parent.end(), uint32_t{0});
+  std::vector<uint64_t> lightest(num_nodes, kNoEdge);
+  std::vector<uint32_t> other_root(num_nodes);
+  std::vector<uint64_t> alive(edges.size());
+  katana::ParallelSTL::iota(alive.begin(), alive.end(), uint64_t{0});
+  katana::InsertBag<uint64_t> forest;
+
+  uint64_t rounds = 0;
+  while (!alive.empty()) {
+    ++rounds;
+    katana::do_all(
+        katana::iterate(alive),
+        [&](uint64_t i) {
+          uint32_t a = FindRoot(parent, edges[i].src);
+          uint32_t b = FindRoot(parent, edges[i].dst);
+          UpdateLightest(&lightest[a], i, edges);
+          UpdateLightest(&lightest[b], i, edges);
+        },
+        katana::steal(), katana::loopname("MinimumSpanningForest Lightest"),
+        katana::no_stats());
+
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t root) {
+          uint64_t i = lightest[root];
+          if (i != kNoEdge) {
+            uint32_t a = FindRoot(parent, edges[i].src);
+            other_root[root] = a == root ? FindRoot(parent, edges[i].dst) : a;
+          }
+        },
+        katana::loopname("MinimumSpanningForest Other Roots"),
+        katana::no_stats());
+
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t root) {
+          uint64_t i = lightest[root];
+          if (i == kNoEdge) {
+            return;
+          }
+          uint32_t other = other_root[root];
+          if (lightest[other] == i && root < other) {
+            return;
+          }
+          __atomic_store_n(&parent[root], other, __ATOMIC_RELAXED);
+          forest.emplace(edges[i].id);
+        },
+        katana::loopname("MinimumSpanningForest Hook"), katana::no_stats());
+
+    // Only roots are hooked in a round, so flattening sees no stale roots
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t node) {
+          __atomic_store_n(
+              &parent[node], FindRoot(parent, node), __ATOMIC_RELAXED);
+        },
+        katana::loopname("MinimumSpanningForest Flatten"), katana::no_stats());
+    katana::ParallelSTL::fill(lightest.begin(), lightest.end(), kNoEdge);
+
+    auto end = katana::ParallelSTL::partition(
+        alive.begin(), alive.end(), [&](uint64_t i) {
+          return parent[edges[i].src] != parent[edges[i].dst];
+        });
+    alive.erase(end, alive.end());
+  }
+  recorder->AddIterations(rounds);
+  katana::ReportStatSingle("MinimumSpanningForest", "Rounds", rounds);
+
+  return std::vector<uint64_t>(forest.begin(), forest.end());
+}
+
+/// Filter-Kruskal over a sequential union-find by size with path halving
+template <typename Weight>
+class FilterKruskal {
+public:
+  FilterKruskal(uint32_t num_nodes, uint64_t base_case_edges)
+      : parent_(num_nodes), size_(num_nodes, 1), base_case_(base_case_edges) {
+    katana::ParallelSTL::iota(parent_.begin(), parent_.end(), uint32_t{0});
+  }
+
+  std::vector<uint64_t> Run(std::vector<WeightedEdge<Weight>>* edges) {
+    Solve(edges->begin(), edges->end());
+    return std::move(forest_);
+  }
+
+private:
+  using Iterator = typename std::vector<WeightedEdge<Weight>>::iterator;
+
+  uint32_t Find(uint32_t node) {
+    while (parent_[node] != node) {
+      node = parent_[node] = parent_[parent_[node]];
+    }
+    return node;
+  }
+
+  void Kruskal(Iterator begin, Iterator end) {
+    katana::ParallelSTL::sort(begin, end, Lighter<Weight>);
+    for (auto it = begin; it != end; ++it) {
+      uint32_t a = Find(it->src);
+      uint32_t b = Find(it->dst);
+      if (a == b) {
+        continue;
+      }
+      if (size_[a] < size_[b]) {
+        std::swap(a, b);
+      }
+      parent_[b] = a;
+      size_[a] += size_[b];
+      forest_.emplace_back(it->id);
+    }
+  }
+
+  void Solve(Iterator begin, Iterator end) {
+    if (static_cast<uint64_t>(end - begin) <= base_case_) {
+      Kruskal(begin, end);
+      return;
+    }
+
+    std::vector<WeightedEdge<Weight>> samples;
+    std::uniform_int_distribution<int64_t> pick(0, end - begin - 1);
+    for (uint32_t i = 0; i < kPivotSamples; ++i) {
+      samples.emplace_back(begin[pick(rng_)]);
+    }
+    auto median = samples.begin() + samples.size() / 2;
+    std::nth_element(samples.begin(), median, samples.end(), Lighter<Weight>);
+    WeightedEdge<Weight> pivot = *median;
+
+    // The pivot is in the light part, so it is never empty
+    Iterator mid = katana::ParallelSTL::partition(
+        begin, end,
+        [&pivot](const auto& edge) { return !Lighter(pivot, edge); });
+    if (mid == end) {
+      Kruskal(begin, end);
+      return;
+    }
+    Solve(begin, mid);
+
+    // No unions happen while filtering, so finding roots only reads
+    Iterator heavy_end = katana::ParallelSTL::partition(
+        mid, end, [this](const auto& edge) {
+          return FindRoot(parent_, edge.src) != FindRoot(parent_, edge.dst);
+        });
+    Solve(mid, heavy_end);
+  }
+
+  std::vector<uint32_t> parent_;
+  std::vector<uint32_t> size_;
+  uint64_t base_case_;
+  std::mt19937_64 rng_;
+  std::vector<uint64_t> forest_;
+};
+
+template <typename Weight>
+katana::Result<void>
+MinimumSpanningForestWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MinimumSpanningForestPlan plan) {
+  katana::analytics::RunRecorder recorder("MinimumSpanningForest");
+  recorder.StartPhase(katana::analytics::kPhaseViewBuild);
+  KATANA_CHECKED(pg->ConstructEdgeProperties<std::tuple<MsfInForest>>(
+      txn_ctx, {output_property_name}));
+  auto graph = KATANA_CHECKED(Graph<Weight>::Make(
+      pg, {}, {edge_weight_property_name, output_property_name}));
+
+  recorder.StartPhase(katana::analytics::kPhaseInit);
+  std::vector<WeightedEdge<Weight>> edges = CollectEdges(graph);
+
+  recorder.StartPhase(katana::analytics::kPhaseMainLoop);
+  katana::StatTimer exec_time("MinimumSpanningForest");
+  exec_time.start();
+  std::vector<uint64_t> forest;
+  switch (plan.algorithm()) {
+  case MinimumSpanningForestPlan::kBoruvka:
+    forest = Boruvka(edges, graph.NumNodes(), &recorder);
+    break;
+  case MinimumSpanningForestPlan::kFilterKruskal:
+    forest = FilterKruskal<Weight>(graph.NumNodes(), plan.base_case_edges())
+                 .Run(&edges);
+    break;
+  default:
+    return katana::ErrorCode::AssertionFailed;
+  }
+  exec_time.stop();
+
+  recorder.StartPhase(katana::analytics::kPhaseOutput);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.NumEdges()),
+      [&](uint64_t e) { graph.template GetEdgeData<MsfInForest>(e) = 0; },
+      katana::loopname("MinimumSpanningForest Clear"), katana::no_stats());
+  katana::do_all(
+      katana::iterate(forest),
+      [&](uint64_t e) { graph.template GetEdgeData<MsfInForest>(e) = 1; },
+      katana::loopname("MinimumSpanningForest Mark"), katana::no_stats());
+  recorder.AddWorkItems(forest.size());
+  return katana::ResultSuccess();
+}
+
+template <typename T>
+struct WeightTag {
+  using type = T;
+};
+
+/// Call func with the name of the weight property and a WeightTag of its
+/// type. Without a property name every edge weighs 1.
+template <typename R, typename Func>
+katana::Result<R>
+WithEdgeWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    katana::TxnContext* txn_ctx, Func&& func) {
+  if (edge_weight_property_name.empty()) {
+    TemporaryPropertyGuard temporary_edge_property{
+        pg->EdgeMutablePropertyView()};
+    KATANA_CHECKED(katana::analytics::AddDefaultEdgeWeight<int64_t>(
+        pg, temporary_edge_property.name(), 1, txn_ctx));
+    return func(temporary_edge_property.name(), WeightTag<int64_t>{});
+  }
+  if (!pg->HasEdgeProperty(edge_weight_property_name)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "Edge Property: {} Not found",
+        edge_weight_property_name);
+  }
+
+  auto property =
+      KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name));
+  switch (property->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return func(edge_weight_property_name, WeightTag<uint32_t>{});
+  case arrow::Int32Type::type_id:
+    return func(edge_weight_property_name, WeightTag<int32_t>{});
+  case arrow::UInt64Type::type_id:
+    return func(edge_weight_property_name, WeightTag<uint64_t>{});
+  case arrow::Int64Type::type_id:
+    return func(edge_weight_property_name, WeightTag<int64_t>{});
+  case arrow::FloatType::type_id:
+    return func(edge_weight_property_name, WeightTag<float>{});
+  case arrow::DoubleType::type_id:
+    return func(edge_weight_property_name, WeightTag<double>{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        property->type()->ToString());
+  }
+}
+
+/// What AssertValid and Statistics need to know about a forest
+struct ForestSummary {
+  uint64_t num_edges{0};
+  double weight{0};
+  /// Whether an edge of the forest closes a cycle
+  bool has_cycle{false};
+  /// The edges and weight of a forest by sequential Kruskal
+  uint64_t kruskal_edges{0};
+  double kruskal_weight{0};
+};
+
+template <typename Weight>
+katana::Result<ForestSummary>
+Summarize(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, bool with_kruskal) {
+  auto graph = KATANA_CHECKED(Graph<Weight>::Make(
+      pg, {}, {edge_weight_property_name, output_property_name}));
+  ForestSummary summary;
+  std::vector<uint32_t> parent(graph.NumNodes());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&parent](uint32_t node) {
+    while (parent[node] != node) {
+      node = parent[node] = parent[parent[node]];
+    }
+    return node;
+  };
+
+  std::vector<WeightedEdge<Weight>> edges;
+  for (auto node : graph) {
+    for (auto e : graph.OutEdges(node)) {
+      Weight weight = graph.template GetEdgeData<MsfEdgeWeight<Weight>>(e);
+      if (with_kruskal) {
+        edges.emplace_back(
+            WeightedEdge<Weight>{weight, e, node, graph.OutEdgeDst(e)});
+      }
+      if (!graph.template GetEdgeData<MsfInForest>(e)) {
+        continue;
+      }
+      ++summary.num_edges;
+      summary.weight += weight;
+      uint32_t a = find(node);
+      uint32_t b = find(graph.OutEdgeDst(e));
+      if (a == b) {
+        summary.has_cycle = true;
+      }
+      parent[std::max(a, b)] = std::min(a, b);
+    }
+  }
+
+  if (with_kruskal) {
+    std::sort(edges.begin(), edges.end(), Lighter<Weight>);
+    std::iota(parent.begin(), parent.end(), 0);
+    for (const auto& edge : edges) {
+      uint32_t a = find(edge.src);
+      uint32_t b = find(edge.dst);
+      if (a != b) {
+        parent[std::max(a, b)] = std::min(a, b);
+        ++summary.kruskal_edges;
+        summary.kruskal_weight += edge.weight;
+      }
+    }
+  }
+  return summary;
+}
+
+katana::Result<ForestSummary>
+SummarizeAnyWeight(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, bool with_kruskal) {
+  katana::TxnContext txn_ctx;
+  return WithEdgeWeights<ForestSummary>(
+      pg, edge_weight_property_name, &txn_ctx,
+      [&](const std::string& weight_name, auto tag) {
+        using Weight = typename decltype(tag)::type;
+        return Summarize<Weight>(
+            pg, weight_name, output_property_name, with_kruskal);
+      });
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForest(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MinimumSpanningForestPlan plan) {
+  return WithEdgeWeights<void>(
+      pg, edge_weight_property_name, txn_ctx,
+      [&](const std::string& weight_name, auto tag) {
+        using Weight = typename decltype(tag)::type;
+        return MinimumSpanningForestWithWrap<Weight>(
+            pg, weight_name, output_property_name, txn_ctx, plan);
+      });
+}
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForestAssertValid(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  ForestSummary summary = KATANA_CHECKED(SummarizeAnyWeight(
+      pg, edge_weight_property_name, output_property_name, true));
+  if (summary.has_cycle) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "the forest has a cycle");
+  }
+  // An acyclic forest with as many edges as a spanning one spans too
+  if (summary.num_edges != summary.kruskal_edges) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the forest has {} edges, a spanning forest has {}", summary.num_edges,
+        summary.kruskal_edges);
+  }
+  double tolerance = 1e-6 * std::max(1.0, std::fabs(summary.kruskal_weight));
+  if (std::fabs(summary.weight - summary.kruskal_weight) > tolerance) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the forest weighs {}, a minimum spanning forest weighs {}",
+        summary.weight, summary.kruskal_weight);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<MinimumSpanningForestStatistics>
+katana::analytics::MinimumSpanningForestStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  ForestSummary summary = KATANA_CHECKED(SummarizeAnyWeight(
+      pg, edge_weight_property_name, output_property_name, false));
+  return MinimumSpanningForestStatistics{
+      pg->NumNodes() - summary.num_edges, summary.num_edges, summary.weight};
+}
+
+void
+katana::analytics::MinimumSpanningForestStatistics::Print(
+    std::ostream& os) const {
+  os << "Number of trees = " << num_trees << std::endl;
+  os << "Number of edges = " << num_edges << std::endl;
+  os << "Total weight = " << total_weight << std::endl;
+}
@@ -0,0 +1,207 @@
+#include "katana/analytics/motif_count/motif_count.h"
+
+#include <vector>
+
+#include "../triangle_count/degree_ordering.h"
+#include "katana/ErrorCode.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/SortedIntersection.h"
+#include "katana/Timer.h"
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/clique_count/clique_count.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using SortedGraphView = katana::analytics::internal::DegreeSortedGraphView;
+using Node = SortedGraphView::Node;
+
+static_assert(
+    sizeof(Node) == sizeof(uint32_t),
+    "the intersection kernels need 32-bit node IDs");
+
+using katana::analytics::internal::CountSmaller;
+
+uint64_t
+Choose2(uint64_t n) {
+  return n < 2 ? 0 : n * (n - 1) / 2;
+}
+
+uint64_t
+Choose3(uint64_t n) {
+  return n < 3 ? 0 : n * (n - 1) * (n - 2) / 6;
+}
+
+/// The numbers of subgraphs, not necessarily induced, of each shape
+struct SubgraphCounts {
+  uint64_t wedges{};
+  uint64_t triangles{};
+  uint64_t paths{};
+  uint64_t three_stars{};
+  uint64_t four_cycles{};
+  uint64_t tailed_triangles{};
+  uint64_t diamonds{};
+};
+
+/// Count the subgraphs that follow from the degrees of the nodes of each
+/// edge and the number of triangles through it
+SubgraphCounts
+EdgeCentricAlgo(const SortedGraphView* graph) {
+  katana::GAccumulator<uint64_t> wedges;
+  katana::GAccumulator<uint64_t> three_stars;
+  katana::GAccumulator<uint64_t> edge_triangles;
+  katana::GAccumulator<uint64_t> raw_paths;
+  katana::GAccumulator<uint64_t> twice_tailed_triangles;
+  katana::GAccumulator<uint64_t> diamonds;
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](Node n) {
+        const Node* n_dsts = graph->OutEdgeDsts(n);
+        uint64_t n_degree = graph->OutDegree(n);
+        wedges += Choose2(n_degree);
+        three_stars += Choose3(n_degree);
+
+        uint64_t local_triangles = 0;
+        uint64_t local_paths = 0;
+        uint64_t local_tailed = 0;
+        uint64_t local_diamonds = 0;
+        size_t smaller = CountSmaller(graph, n, n);
+        for (size_t i = 0; i < smaller; ++i) {
+          Node v = n_dsts[i];
+          uint64_t v_degree = graph->OutDegree(v);
+          uint64_t t = katana::SortedIntersectionSize(
+              n_dsts, n_degree, graph->OutEdgeDsts(v), v_degree);
+          local_triangles += t;
+          local_paths += (n_degree - 1) * (v_degree - 1);
+          local_tailed += t * (n_degree + v_degree - 4);
+          local_diamonds += Choose2(t);
+        }
+        edge_triangles += local_triangles;
+        raw_paths += local_paths;
+        twice_tailed_triangles += local_tailed;
+        diamonds += local_diamonds;
+      },
+      katana::steal(), katana::loopname("MotifCount_Edges"));
+
+  SubgraphCounts counts;
+  counts.wedges = wedges.reduce();
+  counts.three_stars = three_stars.reduce();
+  // Each triangle is counted from its 3 edges; the pairs of edges at the
+  // ends of an edge are the paths of 3 edges through it and, once from each
+  // of its edges, the triangles; each tailed triangle is counted from the 2
+  // edges of the triangle at the node of its tail
+  counts.triangles = edge_triangles.reduce() / 3;
+  counts.paths = raw_paths.reduce() - 3 * counts.triangles;
+  counts.tailed_triangles = twice_tailed_triangles.reduce() / 2;
+  counts.diamonds = diamonds.reduce();
+  return counts;
+}
+
+/// \returns the number of 4-cycles of graph, each counted from its largest
+/// node u as a pair of wedges from u to the opposite node through smaller
+/// nodes
+uint64_t
+FourCycleAlgo(const SortedGraphView* graph) {
+  struct Scratch {
+    std::vector<uint32_t> wedges;
+    std::vector<Node> ends;
+  };
+  katana::PerThreadStorage<Scratch> scratch;
+  katana::GAccumulator<uint64_t> four_cycles;
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](Node u) {
+        Scratch* s = scratch.getLocal();
+        if (s->wedges.empty()) {
+          s->wedges.resize(graph->NumNodes());
+        }
+        const Node* u_dsts = graph->OutEdgeDsts(u);
+        size_t u_smaller = CountSmaller(graph, u, u);
+        for (size_t i = 0; i < u_smaller; ++i) {
+          Node v = u_dsts[i];
+          const Node* v_dsts = graph->OutEdgeDsts(v);
+          size_t v_smaller = CountSmaller(graph, v, u);
+          for (size_t j = 0; j < v_smaller; ++j) {
+            Node w = v_dsts[j];
+            if (s->wedges[w]++ == 0) {
+              s->ends.emplace_back(w);
+            }
+          }
+        }
+        uint64_t local_cycles = 0;
+        for (Node w : s->ends) {
+          local_cycles += Choose2(s->wedges[w]);
+          s->wedges[w] = 0;
+        }
+        s->ends.clear();
+        four_cycles += local_cycles;
+      },
+      katana::steal(), katana::loopname("MotifCount_FourCycles"));
+
+  return four_cycles.reduce();
+}
+
+}  // namespace
+
+void
+katana::analytics::MotifCounts::Print(std::ostream& os) const {
+  os << "Triangles = " << triangles << std::endl;
+  os << "Open wedges = " << open_wedges << std::endl;
+  os << "Paths = " << paths << std::endl;
+  os << "Three stars = " << three_stars << std::endl;
+  os << "Four cycles = " << four_cycles << std::endl;
+  os << "Tailed triangles = " << tailed_triangles << std::endl;
+  os << "Diamonds = " << diamonds << std::endl;
+  os << "Four cliques = " << four_cliques << std::endl;
+}
+
+katana::Result<MotifCounts>
+katana::analytics::MotifCount(katana::PropertyGraph* pg, MotifCountPlan plan) {
+  katana::StatTimer timer_relabel("GraphRelabelTimer", "MotifCount");
+  timer_relabel.start();
+  SortedGraphView sorted_view = pg->BuildView<SortedGraphView>();
+  timer_relabel.stop();
+
+  if (HasSelfLoopsOrParallelEdges(sorted_view)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "motif counts need a graph without self loops or parallel edges");
+  }
+
+  katana::StatTimer exec_time("MotifCount", "MotifCount");
+  exec_time.start();
+  SubgraphCounts subgraphs;
+  switch (plan.algorithm()) {
+  case MotifCountPlan::kEdgeCentric:
+    subgraphs = EdgeCentricAlgo(&sorted_view);
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  subgraphs.four_cycles = FourCycleAlgo(&sorted_view);
+  exec_time.stop();
+
+  uint64_t four_cliques = KATANA_CHECKED(CliqueCount(pg, 4));
+
+  // Each induced subgraph contains the given number of subgraphs of each
+  // smaller shape on the same nodes
+  MotifCounts counts;
+  counts.triangles = subgraphs.triangles;
+  counts.open_wedges = subgraphs.wedges - 3 * subgraphs.triangles;
+  counts.four_cliques = four_cliques;
+  counts.diamonds = subgraphs.diamonds - 6 * four_cliques;
+  counts.four_cycles =
+      subgraphs.four_cycles - counts.diamonds - 3 * four_cliques;
+  counts.tailed_triangles =
+      subgraphs.tailed_triangles - 4 * counts.diamonds - 12 * four_cliques;
+  counts.paths = subgraphs.paths - 2 * counts.tailed_triangles -
+                 4 * counts.four_cycles - 6 * counts.diamonds -
+                 12 * four_cliques;
+  counts.three_stars = subgraphs.three_stars - counts.tailed_triangles -
+                       2 * counts.diamonds - 4 * four_cliques;
+  return counts;
+}
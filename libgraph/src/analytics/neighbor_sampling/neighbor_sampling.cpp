@@ -0,0 +1,407 @@
+#include "katana/analytics/neighbor_sampling/neighbor_sampling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <optional>
+
+#include <arrow/compute/api.h>
+
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirGraphView = katana::PropertyGraphViews::EdgeTypeAwareBiDir;
+using Node = BiDirGraphView::Node;
+using Edge = BiDirGraphView::Edge;
+using EdgesRange = katana::GraphTopologyTypes::edges_range;
+
+/// A stream of random numbers (SplitMix64) chosen by a seed and a stream
+/// number, so each node can draw its own without sharing a generator
+class SampleRandom {
+public:
+  SampleRandom(uint64_t seed, uint64_t stream)
+      : state_(Mix(seed ^ Mix(stream))) {}
+
+  uint64_t Next() { return Mix(state_ += kGamma); }
+
+  /// \returns a uniform integer in [0, bound)
+  uint64_t Below(uint64_t bound) {
+    return (static_cast<unsigned __int128>(Next()) * bound) >> 64;
+  }
+
+  /// \returns a uniform double in (0, 1]
+  double Uniform() { return ((Next() >> 11) + 1) * 0x1.0p-53; }
+
+private:
+  constexpr static const uint64_t kGamma = 0x9e3779b97f4a7c15ULL;
+
+  static uint64_t Mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t state_;
+};
+
+/// Up to fanout edges of a node are sampled among its edges of type, or
+/// among all of them if type is empty
+struct EdgeGroup {
+  std::optional<katana::EntityTypeID> type;
+  uint32_t fanout;
+};
+
+/// The edges of a node in the sampled direction and what they lead to
+template <typename GraphView>
+class SampledEdges {
+public:
+  SampledEdges(const GraphView& graph, bool in_edges)
+      : graph_(graph), in_edges_(in_edges) {}
+
+  EdgesRange Of(Node node, const EdgeGroup& group) const {
+    if (group.type) {
+      return in_edges_ ? graph_.InEdges(node, *group.type)
+                       : graph_.OutEdges(node, *group.type);
+    }
+    return in_edges_ ? graph_.InEdges(node) : graph_.OutEdges(node);
+  }
+
+  Node Neighbor(Edge edge) const {
+    return in_edges_ ? graph_.InEdgeSrc(edge) : graph_.OutEdgeDst(edge);
+  }
+
+  uint64_t PropertyIndex(Edge edge) const {
+    return in_edges_ ? graph_.GetEdgePropertyIndexFromInEdge(edge)
+                     : graph_.GetEdgePropertyIndexFromOutEdge(edge);
+  }
+
+private:
+  const GraphView& graph_;
+  bool in_edges_;
+};
+
+/// The nodes a sample has reached so far; local_ids[n] is the index of node
+/// n into nodes if in_sample tests true for n.
+///
+/// in_sample and local_ids have a row per node of the graph, so each thread
+/// that samples keeps them for its next sample, which resets only the bits
+/// of the nodes of the previous one instead of allocating them anew.
+struct SampledNodes {
+  std::vector<Node> nodes;
+  katana::DynamicBitset in_sample;
+  katana::NUMAArray<uint32_t> local_ids;
+
+  /// \returns the empty sample of the calling thread for a graph of
+  /// num_nodes nodes
+  static SampledNodes& ForThisThread(size_t num_nodes) {
+    thread_local SampledNodes sample;
+    sample.Reset(num_nodes);
+    return sample;
+  }
+
+  void Append(Node node) {
+    in_sample.set(node);
+    local_ids[node] = nodes.size();
+    nodes.emplace_back(node);
+  }
+
+private:
+  void Reset(size_t num_nodes) {
+    if (in_sample.size() != num_nodes) {
+      in_sample.clear();
+      in_sample.resize(num_nodes);
+      local_ids.deallocate();
+      local_ids.allocateBlocked(num_nodes);
+    } else {
+      for (Node node : nodes) {
+        in_sample.reset(node);
+      }
+    }
+    nodes.clear();
+  }
+};
+
+template <typename T>
+katana::Result<std::shared_ptr<arrow::Buffer>>
+AllocateArrayBuffer(uint64_t size) {
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(size * sizeof(T)));
+  return buffer;
+}
+
+template <typename T>
+T*
+MutableData(const std::shared_ptr<arrow::Buffer>& buffer) {
+  return reinterpret_cast<T*>(buffer->mutable_data());
+}
+
+/// Samples the neighbors of the first num_dst nodes of the sample, appends
+/// the ones it reaches first to it and returns the sampled edges. weights,
+/// if not null, are indexed by edge property index.
+template <typename GraphView>
+katana::Result<NeighborSampleBlock>
+SampleHop(
+    const SampledEdges<GraphView>& edges, const std::vector<EdgeGroup>& groups,
+    const katana::NUMAArray<double>* weights, uint64_t seed, uint32_t hop,
+    SampledNodes* sample) {
+  uint64_t num_dst = sample->nodes.size();
+  const std::vector<Node>& nodes = sample->nodes;
+
+  auto weight = [&](Edge e) { return (*weights)[edges.PropertyIndex(e)]; };
+  auto num_candidates = [&](EdgesRange range) -> uint64_t {
+    if (!weights) {
+      return range.size();
+    }
+    return std::count_if(
+        range.begin(), range.end(), [&](Edge e) { return weight(e) > 0; });
+  };
+
+  std::shared_ptr<arrow::Buffer> indptr_buffer =
+      KATANA_CHECKED(AllocateArrayBuffer<uint64_t>(num_dst + 1));
+  uint64_t* indptr = MutableData<uint64_t>(indptr_buffer);
+  indptr[0] = 0;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_dst),
+      [&](uint64_t i) {
+        uint64_t count = 0;
+        for (const EdgeGroup& group : groups) {
+          uint64_t candidates = num_candidates(edges.Of(nodes[i], group));
+          count += std::min<uint64_t>(candidates, group.fanout);
+        }
+        indptr[i + 1] = count;
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(indptr, indptr + num_dst + 1, indptr);
+  uint64_t num_edges = indptr[num_dst];
+
+  // Uniform sampling draws fanout distinct edges with Floyd's algorithm;
+  // weighted sampling takes the fanout edges of largest log(u) / weight
+  // for u uniform in (0, 1].
+  katana::NUMAArray<Edge> sampled;
+  sampled.allocateBlocked(num_edges);
+  katana::PerThreadStorage<std::vector<std::pair<double, Edge>>> keys;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_dst),
+      [&](uint64_t i) {
+        SampleRandom random(seed, (uint64_t{hop} << 32) | nodes[i]);
+        Edge* out = &sampled[indptr[i]];
+        for (const EdgeGroup& group : groups) {
+          EdgesRange range = edges.Of(nodes[i], group);
+          Edge* begin = out;
+          if (weights) {
+            std::vector<std::pair<double, Edge>>& local = *keys.getLocal();
+            local.clear();
+            for (Edge e : range) {
+              if (double w = weight(e); w > 0) {
+                local.emplace_back(std::log(random.Uniform()) / w, e);
+              }
+            }
+            size_t k = std::min<size_t>(local.size(), group.fanout);
+            std::nth_element(
+                local.begin(), local.begin() + k, local.end(),
+                std::greater<>());
+            for (size_t j = 0; j < k; ++j) {
+              *out++ = local[j].second;
+            }
+          } else if (range.size() <= group.fanout) {
+            out = std::copy(range.begin(), range.end(), out);
+          } else {
+            uint64_t degree = range.size();
+            for (uint64_t j = degree - group.fanout; j < degree; ++j) {
+              Edge e = *range.begin() + random.Below(j + 1);
+              if (std::find(begin, out, e) != out) {
+                e = *range.begin() + j;
+              }
+              *out++ = e;
+            }
+          }
+          std::sort(begin, out);
+        }
+      },
+      katana::steal(), katana::loopname("NeighborSamplingSample"));
+
+  std::shared_ptr<arrow::Buffer> edge_ids_buffer =
+      KATANA_CHECKED(AllocateArrayBuffer<uint64_t>(num_edges));
+  std::shared_ptr<arrow::Buffer> indices_buffer =
+      KATANA_CHECKED(AllocateArrayBuffer<uint32_t>(num_edges));
+  uint64_t* edge_ids = MutableData<uint64_t>(edge_ids_buffer);
+  uint32_t* indices = MutableData<uint32_t>(indices_buffer);
+
+  // The neighbors are stored in indices until they all have local IDs.
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t k) {
+        edge_ids[k] = edges.PropertyIndex(sampled[k]);
+        indices[k] = edges.Neighbor(sampled[k]);
+      },
+      katana::no_stats());
+
+  std::vector<Node> reached(indices, indices + num_edges);
+  katana::ParallelSTL::sort(reached.begin(), reached.end());
+  reached.erase(std::unique(reached.begin(), reached.end()), reached.end());
+  for (Node node : reached) {
+    if (!sample->in_sample.test(node)) {
+      sample->Append(node);
+    }
+  }
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t k) { indices[k] = sample->local_ids[indices[k]]; },
+      katana::no_stats());
+
+  NeighborSampleBlock block;
+  block.num_dst = num_dst;
+  block.num_src = sample->nodes.size();
+  block.indptr =
+      std::make_shared<arrow::UInt64Array>(num_dst + 1, indptr_buffer);
+  block.indices =
+      std::make_shared<arrow::UInt32Array>(num_edges, indices_buffer);
+  block.edge_ids =
+      std::make_shared<arrow::UInt64Array>(num_edges, edge_ids_buffer);
+  return block;
+}
+
+/// The edge groups of fanout in graph; types named by fanout that no edge
+/// has are dropped, as they have no edges to sample
+katana::Result<std::vector<EdgeGroup>>
+MakeEdgeGroups(
+    const katana::PropertyGraph& pg, const BiDirGraphView& graph,
+    const NeighborSamplingFanout& fanout) {
+  if (fanout.edge_type_fanouts.empty()) {
+    return std::vector<EdgeGroup>{{std::nullopt, fanout.fanout}};
+  }
+
+  std::vector<EdgeGroup> groups;
+  for (const auto& [name, count] : fanout.edge_type_fanouts) {
+    if (!pg.HasAtomicEdgeType(name)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotFound, "no edge type named {}", name);
+    }
+    katana::EntityTypeID type = pg.GetEdgeEntityTypeID(name);
+    if (graph.DoesEdgeTypeExist(type)) {
+      groups.emplace_back(EdgeGroup{type, count});
+    }
+  }
+  return groups;
+}
+
+/// The weights of the edges of pg by edge property index, with 0 for null
+katana::Result<katana::NUMAArray<double>>
+ReadEdgeWeights(katana::PropertyGraph* pg, const std::string& name) {
+  if (name.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "weighted sampling needs an edge weight property");
+  }
+  std::shared_ptr<arrow::ChunkedArray> property =
+      KATANA_CHECKED(pg->GetEdgeProperty(name));
+  if (!arrow::is_integer(property->type()->id()) &&
+      !arrow::is_floating(property->type()->id())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "unsupported edge weight type: {}",
+        property->type()->ToString());
+  }
+  arrow::Datum cast =
+      KATANA_CHECKED(arrow::compute::Cast(property, arrow::float64()));
+
+  katana::NUMAArray<double> weights;
+  weights.allocateBlocked(property->length());
+  int64_t offset = 0;
+  for (const auto& chunk : cast.chunked_array()->chunks()) {
+    auto values = std::static_pointer_cast<arrow::DoubleArray>(chunk);
+    katana::do_all(
+        katana::iterate(int64_t{0}, values->length()),
+        [&](int64_t i) {
+          weights[offset + i] = values->IsNull(i) ? 0 : values->Value(i);
+        },
+        katana::no_stats());
+    offset += values->length();
+  }
+  return weights;
+}
+
+/// The rows of the named node properties of nodes
+katana::Result<std::shared_ptr<arrow::Table>>
+GatherNodeFeatures(
+    const katana::PropertyGraph& pg, const BiDirGraphView& graph,
+    const std::vector<Node>& nodes,
+    const std::vector<std::string>& properties) {
+  arrow::UInt64Builder builder;
+  KATANA_CHECKED(builder.Reserve(nodes.size()));
+  for (Node node : nodes) {
+    builder.UnsafeAppend(graph.GetNodePropertyIndex(node));
+  }
+  std::shared_ptr<arrow::Array> rows = KATANA_CHECKED(builder.Finish());
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const std::string& name : properties) {
+    std::shared_ptr<arrow::ChunkedArray> column =
+        KATANA_CHECKED(pg.GetNodeProperty(name));
+    arrow::Datum taken = KATANA_CHECKED(arrow::compute::Take(column, rows));
+    fields.emplace_back(arrow::field(name, column->type()));
+    columns.emplace_back(taken.chunked_array());
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, nodes.size());
+}
+
+}  // namespace
+
+katana::Result<NeighborSample>
+katana::analytics::NeighborSampling(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& seeds,
+    const std::vector<NeighborSamplingFanout>& fanouts,
+    const std::vector<std::string>& node_feature_properties,
+    NeighborSamplingPlan plan) {
+  katana::StatTimer timer("NeighborSampling");
+  katana::TimerGuard timer_guard(timer);
+
+  BiDirGraphView graph = pg->BuildView<BiDirGraphView>();
+  SampledNodes& sample = SampledNodes::ForThisThread(graph.NumNodes());
+  for (Node seed : seeds) {
+    if (seed >= graph.NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "seed {} is not a node", seed);
+    }
+    if (sample.in_sample.test(seed)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "seed {} is repeated", seed);
+    }
+    sample.Append(seed);
+  }
+
+  std::optional<katana::NUMAArray<double>> weights;
+  if (plan.algorithm() == NeighborSamplingPlan::kWeighted) {
+    weights = KATANA_CHECKED(
+        ReadEdgeWeights(pg, plan.edge_weight_property_name()));
+  }
+
+  SampledEdges<BiDirGraphView> edges(
+      graph, plan.edge_direction() == NeighborSamplingPlan::kInEdges);
+  NeighborSample result;
+  for (uint32_t hop = 0; hop < fanouts.size(); ++hop) {
+    std::vector<EdgeGroup> groups =
+        KATANA_CHECKED(MakeEdgeGroups(*pg, graph, fanouts[hop]));
+    result.blocks.emplace_back(KATANA_CHECKED(SampleHop(
+        edges, groups, weights ? &*weights : nullptr, plan.seed(), hop,
+        &sample)));
+  }
+
+  arrow::UInt32Builder builder;
+  KATANA_CHECKED(builder.AppendValues(sample.nodes));
+  std::shared_ptr<arrow::Array> nodes = KATANA_CHECKED(builder.Finish());
+  result.nodes = std::static_pointer_cast<arrow::UInt32Array>(nodes);
+  result.node_features = KATANA_CHECKED(GatherNodeFeatures(
+      *pg, graph, sample.nodes, node_feature_properties));
+  return result;
+}
@@ -0,0 +1,426 @@
+#include "katana/analytics/node_embedding/node_embedding.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "../random_walks/walk_random.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/analytics/Utils.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using katana::analytics::internal::WalkRandom;
+
+/// Scores beyond this are taken as certain, as in word2vec
+constexpr float kMaxScore = 6.0f;
+
+/// The learning rate decays to no less than this fraction of the starting
+/// rate
+constexpr double kMinLearningRateFraction = 1e-4;
+
+/// The power of the number of times a node is expected in the walks that
+/// it is drawn as noise in proportion to (Mikolov et al., 2013)
+constexpr double kNoisePower = 0.75;
+
+float
+Sigmoid(float score) {
+  if (score > kMaxScore) {
+    return 1.0f;
+  }
+  if (score < -kMaxScore) {
+    return 0.0f;
+  }
+  return 1.0f / (1.0f + std::exp(-score));
+}
+
+/// An alias table (Vose, 1991) of the noise nodes: for a node n drawn
+/// uniformly, n is taken with probability prob[n] and otherwise alias[n]
+class NoiseDistribution {
+public:
+  /// Draw each node n of num_nodes in proportion to count(n) raised to
+  /// kNoisePower, or uniformly if every count is 0
+  template <typename Count>
+  static NoiseDistribution Make(uint32_t num_nodes, const Count& count) {
+    NoiseDistribution noise;
+    noise.prob_.allocateInterleaved(num_nodes);
+    noise.alias_.allocateInterleaved(num_nodes);
+
+    katana::NUMAArray<double> scaled;
+    scaled.allocateInterleaved(num_nodes);
+    katana::GAccumulator<double> total;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          scaled[n] = std::pow(static_cast<double>(count(n)), kNoisePower);
+          total += scaled[n];
+        },
+        katana::no_stats());
+    double mean = total.reduce() / num_nodes;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) { scaled[n] = mean > 0 ? scaled[n] / mean : 1.0; },
+        katana::no_stats());
+
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      (scaled[n] < 1.0 ? small : large).emplace_back(n);
+    }
+    while (!small.empty() && !large.empty()) {
+      uint32_t less = small.back();
+      small.pop_back();
+      uint32_t more = large.back();
+      noise.prob_[less] = scaled[less];
+      noise.alias_[less] = more;
+      scaled[more] -= 1.0 - scaled[less];
+      if (scaled[more] < 1.0) {
+        large.pop_back();
+        small.emplace_back(more);
+      }
+    }
+    // What is left is 1 up to rounding
+    for (const auto* rest : {&small, &large}) {
+      for (uint32_t n : *rest) {
+        noise.prob_[n] = 1.0f;
+        noise.alias_[n] = n;
+      }
+    }
+    return noise;
+  }
+
+  uint32_t Draw(WalkRandom* rng) const {
+    uint32_t n = rng->Below(prob_.size());
+    return rng->Uniform() < prob_[n] ? n : alias_[n];
+  }
+
+private:
+  katana::NUMAArray<float> prob_;
+  katana::NUMAArray<uint32_t> alias_;
+};
+
+/// Skip-gram with negative sampling over walks, updating the embeddings
+/// and the context vectors of the nodes without locks
+class SkipGramTrainer {
+public:
+  /// Start embeddings, the num_nodes * plan.dimensions() floats of each
+  /// node in turn, at small random values. total_steps is the number of
+  /// nodes expected in the walks over all epochs, which the learning rate
+  /// decays over.
+  SkipGramTrainer(
+      const NodeEmbeddingPlan& plan, uint32_t num_nodes,
+      NoiseDistribution noise, uint64_t total_steps, float* embeddings)
+      : plan_(plan),
+        dimensions_(plan.dimensions()),
+        noise_(std::move(noise)),
+        total_steps_(std::max(total_steps, uint64_t{1})),
+        embeddings_(embeddings) {
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          WalkRandom rng(~plan_.seed(), n);
+          float* embedding = Embedding(n);
+          for (uint32_t d = 0; d < dimensions_; ++d) {
+            embedding[d] = (rng.Uniform() - 0.5) / dimensions_;
+          }
+        },
+        katana::no_stats());
+    context_.allocateInterleaved(uint64_t{num_nodes} * dimensions_);
+    katana::ParallelSTL::fill(context_.begin(), context_.end(), 0.0f);
+  }
+
+  /// Train on walks, which are the walks from first_walk on of epoch. The
+  /// random numbers of a walk depend only on the seed, epoch and first_walk.
+  template <typename ListArray>
+  void Train(const ListArray& walks, uint32_t epoch, uint64_t first_walk) {
+    const uint32_t* nodes =
+        static_cast<const arrow::UInt32Array&>(*walks.values()).raw_values();
+    katana::do_all(
+        katana::iterate(int64_t{0}, walks.length()),
+        [&](int64_t i) {
+          if (walks.IsNull(i)) {
+            return;
+          }
+          uint64_t length = walks.value_length(i);
+          uint64_t trained =
+              trained_steps_.fetch_add(length, std::memory_order_relaxed);
+          double alpha =
+              plan_.learning_rate() *
+              std::max(
+                  1.0 - static_cast<double>(trained) / total_steps_,
+                  kMinLearningRateFraction);
+          WalkRandom rng(plan_.seed() + epoch, first_walk + i);
+          std::vector<float>& gradient = *gradients_.getLocal();
+          gradient.resize(dimensions_);
+          TrainWalk(
+              nodes + walks.value_offset(i), length, alpha, &rng,
+              gradient.data());
+        },
+        katana::steal(), katana::no_stats(), katana::loopname("SkipGram"));
+  }
+
+private:
+  float* Embedding(uint32_t n) {
+    return embeddings_ + uint64_t{n} * dimensions_;
+  }
+
+  float* Context(uint32_t n) { return &context_[uint64_t{n} * dimensions_]; }
+
+  /// Move the embedding of each node of walk within a window of another
+  /// towards the context vector of that node and away from the context
+  /// vectors of noise nodes
+  void TrainWalk(
+      const uint32_t* walk, uint64_t length, float alpha, WalkRandom* rng,
+      float* gradient) {
+    for (uint64_t pos = 0; pos < length; ++pos) {
+      uint32_t node = walk[pos];
+      uint64_t window = plan_.window_size() - rng->Below(plan_.window_size());
+      uint64_t begin = pos > window ? pos - window : 0;
+      uint64_t end = std::min(length, pos + window + 1);
+      for (uint64_t c = begin; c < end; ++c) {
+        if (c == pos) {
+          continue;
+        }
+        float* embedding = Embedding(walk[c]);
+        std::fill(gradient, gradient + dimensions_, 0.0f);
+        for (uint32_t k = 0; k <= plan_.negative_samples(); ++k) {
+          uint32_t target = node;
+          float label = 1.0f;
+          if (k > 0) {
+            target = noise_.Draw(rng);
+            if (target == node) {
+              continue;
+            }
+            label = 0.0f;
+          }
+          float* context = Context(target);
+          float score = 0;
+          for (uint32_t d = 0; d < dimensions_; ++d) {
+            score += embedding[d] * context[d];
+          }
+          float step = (label - Sigmoid(score)) * alpha;
+          for (uint32_t d = 0; d < dimensions_; ++d) {
+            gradient[d] += step * context[d];
+            context[d] += step * embedding[d];
+          }
+        }
+        for (uint32_t d = 0; d < dimensions_; ++d) {
+          embedding[d] += gradient[d];
+        }
+      }
+    }
+  }
+
+  NodeEmbeddingPlan plan_;
+  uint32_t dimensions_;
+  NoiseDistribution noise_;
+  uint64_t total_steps_;
+  /// The nodes of the walks trained on so far, over all epochs
+  std::atomic<uint64_t> trained_steps_{0};
+  float* embeddings_;
+  katana::NUMAArray<float> context_;
+  katana::PerThreadStorage<std::vector<float>> gradients_;
+};
+
+/// Calls fn(chunk) with each chunk of the walk column of walks, as an
+/// arrow::ListArray or arrow::LargeListArray of uint32
+template <typename Fn>
+katana::Result<void>
+ForEachWalkChunk(const arrow::Table& walks, const Fn& fn) {
+  std::shared_ptr<arrow::ChunkedArray> column = walks.GetColumnByName("walk");
+  if (!column) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "walks have no column \"walk\"");
+  }
+  if (!column->type()->Equals(arrow::list(arrow::uint32())) &&
+      !column->type()->Equals(arrow::large_list(arrow::uint32()))) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "walks are not lists of uint32: {}",
+        column->type()->ToString());
+  }
+  for (const auto& chunk : column->chunks()) {
+    if (chunk->type_id() == arrow::Type::LIST) {
+      const auto& lists = static_cast<const arrow::ListArray&>(*chunk);
+      if (lists.values()->null_count() != 0) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "walks have null nodes");
+      }
+      fn(lists);
+    } else {
+      const auto& lists = static_cast<const arrow::LargeListArray&>(*chunk);
+      if (lists.values()->null_count() != 0) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "walks have null nodes");
+      }
+      fn(lists);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+CheckPlan(const NodeEmbeddingPlan& plan) {
+  if (plan.dimensions() == 0 || plan.window_size() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "dimensions and window_size must be positive");
+  }
+  return katana::ResultSuccess();
+}
+
+/// Add the embeddings, num_nodes vectors of dimensions floats, to pg as the
+/// fixed_size_list<float> node property output_property_name
+katana::Result<void>
+AddEmbeddings(
+    katana::PropertyGraph* pg, const std::shared_ptr<arrow::Buffer>& buffer,
+    uint32_t dimensions, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx) {
+  uint64_t num_nodes = pg->NumNodes();
+  auto values =
+      std::make_shared<arrow::FloatArray>(num_nodes * dimensions, buffer);
+  auto embeddings = std::make_shared<arrow::FixedSizeListArray>(
+      arrow::fixed_size_list(arrow::float32(), dimensions), num_nodes, values);
+  return pg->AddNodeProperties(
+      arrow::Table::Make(
+          arrow::schema(
+              {arrow::field(output_property_name, embeddings->type())}),
+          {embeddings}),
+      txn_ctx);
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+AllocateEmbeddings(const katana::PropertyGraph* pg, uint32_t dimensions) {
+  std::shared_ptr<arrow::Buffer> buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer(pg->NumNodes() * dimensions * sizeof(float)));
+  return buffer;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::NodeEmbedding(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const std::string& edge_weight_property_name,
+    RandomWalksPlan walks_plan, NodeEmbeddingPlan plan) {
+  KATANA_CHECKED(CheckPlan(plan));
+  if (walks_plan.algorithm() != RandomWalksPlan::kNode2Vec) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "walks_plan must be a kNode2Vec plan");
+  }
+  katana::ReportPageAllocGuard page_alloc;
+
+  // The walks are along the edges of the edge type of the walks, if any
+  auto view = walks_plan.edge_type()
+                  ? MakeViewOfEdgeType<PropertyGraphViews::Default>(
+                        pg, *walks_plan.edge_type())
+                  : pg->BuildView<PropertyGraphViews::Default>();
+  NoiseDistribution noise = NoiseDistribution::Make(
+      pg->NumNodes(), [&](uint32_t n) { return view.OutDegree(n); });
+  // Walks end early at nodes without edges, so this is an upper bound
+  uint64_t steps_per_epoch = pg->NumNodes() * walks_plan.number_of_walks() *
+                             (std::max(walks_plan.walk_length(), 1u) + 1);
+
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(AllocateEmbeddings(pg, plan.dimensions()));
+  SkipGramTrainer trainer(
+      plan, pg->NumNodes(), std::move(noise), steps_per_epoch * plan.epochs(),
+      reinterpret_cast<float*>(buffer->mutable_data()));
+
+  katana::StatTimer exec_time("NodeEmbedding");
+  exec_time.start();
+  for (uint32_t epoch = 0; epoch < plan.epochs(); ++epoch) {
+    // The walks are the same in every epoch, as when training on a table
+    uint64_t first_walk = 0;
+    KATANA_CHECKED(RandomWalksStream(
+        pg, plan.walks_per_batch(),
+        [&](const std::shared_ptr<arrow::Table>& batch) -> Result<void> {
+          return ForEachWalkChunk(*batch, [&](const auto& chunk) {
+            trainer.Train(chunk, epoch, first_walk);
+            first_walk += chunk.length();
+          });
+        },
+        edge_weight_property_name, walks_plan));
+  }
+  exec_time.stop();
+
+  return AddEmbeddings(
+      pg, buffer, plan.dimensions(), output_property_name, txn_ctx);
+}
+
+katana::Result<void>
+katana::analytics::NodeEmbeddingFromWalks(
+    PropertyGraph* pg, const std::shared_ptr<arrow::Table>& walks,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    NodeEmbeddingPlan plan) {
+  KATANA_CHECKED(CheckPlan(plan));
+  katana::ReportPageAllocGuard page_alloc;
+
+  // Count the nodes of the walks for the noise and the learning rate
+  uint32_t num_nodes = pg->NumNodes();
+  katana::NUMAArray<std::atomic<uint64_t>> counts;
+  counts.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(counts.begin(), counts.end(), uint64_t{0});
+  katana::GAccumulator<uint64_t> steps_per_epoch;
+  katana::GReduceLogicalOr out_of_range;
+  KATANA_CHECKED(ForEachWalkChunk(*walks, [&](const auto& chunk) {
+    const uint32_t* nodes =
+        static_cast<const arrow::UInt32Array&>(*chunk.values()).raw_values();
+    katana::do_all(
+        katana::iterate(int64_t{0}, chunk.length()),
+        [&](int64_t i) {
+          if (chunk.IsNull(i)) {
+            return;
+          }
+          const uint32_t* walk = nodes + chunk.value_offset(i);
+          for (int64_t s = 0; s < chunk.value_length(i); ++s) {
+            if (walk[s] >= num_nodes) {
+              out_of_range.update(true);
+              return;
+            }
+            counts[walk[s]].fetch_add(1, std::memory_order_relaxed);
+          }
+          steps_per_epoch += chunk.value_length(i);
+        },
+        katana::steal(), katana::no_stats());
+  }));
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "walks have nodes not in the graph");
+  }
+
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(AllocateEmbeddings(pg, plan.dimensions()));
+  SkipGramTrainer trainer(
+      plan, num_nodes,
+      NoiseDistribution::Make(
+          num_nodes,
+          [&](uint32_t n) {
+            return counts[n].load(std::memory_order_relaxed);
+          }),
+      steps_per_epoch.reduce() * plan.epochs(),
+      reinterpret_cast<float*>(buffer->mutable_data()));
+
+  katana::StatTimer exec_time("NodeEmbedding");
+  exec_time.start();
+  for (uint32_t epoch = 0; epoch < plan.epochs(); ++epoch) {
+    uint64_t first_walk = 0;
+    KATANA_CHECKED(ForEachWalkChunk(*walks, [&](const auto& chunk) {
+      trainer.Train(chunk, epoch, first_walk);
+      first_walk += chunk.length();
+    }));
+  }
+  exec_time.stop();
+
+  return AddEmbeddings(
+      pg, buffer, plan.dimensions(), output_property_name, txn_ctx);
+}
@@ -0,0 +1,358 @@
+#include "katana/analytics/out_of_core/out_of_core.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// Nodes of adj_indices read at a time to find the partitions
+constexpr uint64_t kScanNodes = UINT64_C(1) << 20;
+
+constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+
+uint32_t
+LoadRelaxed(const uint32_t* val) {
+  return __atomic_load_n(val, __ATOMIC_RELAXED);
+}
+
+bool
+CasRelaxed(uint32_t* val, uint32_t expected, uint32_t desired) {
+  return __atomic_compare_exchange_n(
+      val, &expected, desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+/// The root of node in a union-find forest where every node points to a
+/// smaller or equal one, halving the path to it on the way
+uint32_t
+Find(katana::NUMAArray<uint32_t>* parent, uint32_t node) {
+  while (true) {
+    uint32_t p = LoadRelaxed(&(*parent)[node]);
+    if (p == node) {
+      return node;
+    }
+    uint32_t gp = LoadRelaxed(&(*parent)[p]);
+    if (p != gp) {
+      CasRelaxed(&(*parent)[node], p, gp);
+    }
+    node = gp;
+  }
+}
+
+void
+Union(katana::NUMAArray<uint32_t>* parent, uint32_t a, uint32_t b) {
+  while (true) {
+    a = Find(parent, a);
+    b = Find(parent, b);
+    if (a == b) {
+      return;
+    }
+    // Link the larger root under the smaller one, so that the smallest node
+    // of a component is its root
+    if (a < b) {
+      std::swap(a, b);
+    }
+    if (CasRelaxed(&(*parent)[a], a, b)) {
+      return;
+    }
+  }
+}
+
+}  // namespace
+
+katana::analytics::OutOfCoreTopology::OutOfCoreTopology(
+    std::unique_ptr<RDGFile> rdg_file, RDG&& rdg)
+    : rdg_file_(std::move(rdg_file)), rdg_(std::move(rdg)) {}
+
+katana::Result<std::unique_ptr<katana::analytics::OutOfCoreTopology>>
+katana::analytics::OutOfCoreTopology::Make(
+    const URI& rdg_dir, TxnContext* txn_ctx, const OutOfCoreOptions& options) {
+  RDGManifest manifest = KATANA_CHECKED(FindManifest(rdg_dir, txn_ctx));
+  auto rdg_handle = KATANA_CHECKED(Open(std::move(manifest), kReadOnly));
+  auto rdg_file = std::make_unique<RDGFile>(rdg_handle);
+
+  RDGLoadOptions opts;
+  opts.node_properties = std::vector<std::string>();
+  opts.edge_properties = std::vector<std::string>();
+  RDG rdg = KATANA_CHECKED(RDG::Make(*rdg_file, opts));
+  // Types are not used; give back their memory
+  KATANA_CHECKED(rdg.UnbindNodeEntityTypeIDArrayFileStorage());
+  KATANA_CHECKED(rdg.UnbindEdgeEntityTypeIDArrayFileStorage());
+
+  // Using `new` to access a non-public constructor.
+  std::unique_ptr<OutOfCoreTopology> topo(
+      new OutOfCoreTopology(std::move(rdg_file), std::move(rdg)));
+  topo->topology_ = KATANA_CHECKED_CONTEXT(
+      topo->rdg_.GetTopologySections(RDGTopology::MakeShadow(
+          RDGTopology::TopologyKind::kCSR, RDGTopology::TransposeKind::kNo,
+          RDGTopology::EdgeSortKind::kAny, RDGTopology::NodeSortKind::kAny)),
+      "out-of-core analytics need an uncompressed CSR topology");
+  topo->num_nodes_ = topo->topology_->num_nodes();
+  topo->num_edges_ = topo->topology_->num_edges();
+  KATANA_CHECKED(topo->Partition(std::max<uint64_t>(
+      options.memory_budget_bytes / 2, sizeof(uint64_t))));
+  return topo;
+}
+
+katana::Result<void>
+katana::analytics::OutOfCoreTopology::Partition(uint64_t partition_bytes) {
+  const uint64_t* adj_indices = topology_->adj_indices();
+  partition_bounds_ = {0};
+  uint64_t part_begin = 0;
+  uint64_t part_first_edge = 0;
+
+  for (uint64_t chunk = 0; chunk < num_nodes_; chunk += kScanNodes) {
+    uint64_t chunk_end = std::min(chunk + kScanNodes, num_nodes_);
+    KATANA_CHECKED(topology_->FillNodes(chunk, chunk_end, false));
+    for (uint64_t n = chunk; n < chunk_end; ++n) {
+      uint64_t bytes = (n + 1 - part_begin) * sizeof(uint64_t) +
+                       (adj_indices[n] - part_first_edge) * sizeof(uint32_t);
+      if (bytes > partition_bytes && n > part_begin) {
+        partition_bounds_.emplace_back(n);
+        part_begin = n;
+        part_first_edge = adj_indices[n - 1];
+      }
+    }
+    KATANA_CHECKED(topology_->ReleaseNodes(chunk, chunk_end));
+  }
+
+  if (num_nodes_ > 0) {
+    partition_bounds_.emplace_back(num_nodes_);
+  }
+  return katana::ResultSuccess();
+}
+
+uint32_t
+katana::analytics::OutOfCoreTopology::PartitionOf(uint64_t node) const {
+  auto it = std::upper_bound(
+      partition_bounds_.begin(), partition_bounds_.end(), node);
+  return it - partition_bounds_.begin() - 1;
+}
+
+katana::Result<OutOfCorePartition>
+katana::analytics::OutOfCoreTopology::Fill(uint32_t partition) {
+  uint64_t begin = partition_bounds_[partition];
+  uint64_t end = partition_bounds_[partition + 1];
+  KATANA_CHECKED(topology_->FillNodes(begin, end, false));
+
+  const uint64_t* adj_indices = topology_->adj_indices();
+  uint64_t first_edge = begin > 0 ? adj_indices[begin - 1] : 0;
+  KATANA_CHECKED(
+      topology_->FillEdges(first_edge, adj_indices[end - 1], false));
+  return OutOfCorePartition(
+      begin, end, first_edge, adj_indices, topology_->dests());
+}
+
+katana::Result<void>
+katana::analytics::OutOfCoreTopology::Release(
+    const OutOfCorePartition& partition) {
+  KATANA_CHECKED(topology_->ReleaseEdges(
+      partition.EdgesBegin(partition.begin()),
+      partition.EdgesEnd(partition.end() - 1)));
+  KATANA_CHECKED(topology_->ReleaseNodes(partition.begin(), partition.end()));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::OutOfCoreTopology::ForEachPartition(
+    const std::function<bool(uint32_t)>& wanted,
+    const std::function<void(const OutOfCorePartition&)>& fn) {
+  std::vector<uint32_t> partitions;
+  for (uint32_t p = 0; p < NumPartitions(); ++p) {
+    if (!wanted || wanted(p)) {
+      partitions.emplace_back(p);
+    }
+  }
+  if (partitions.empty()) {
+    return katana::ResultSuccess();
+  }
+
+  OutOfCorePartition current = KATANA_CHECKED(Fill(partitions[0]));
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    // The topology is only touched by one thread at a time: the next
+    // partition is read while fn runs, and the current one is released
+    // after that read is done
+    std::future<katana::Result<OutOfCorePartition>> next;
+    if (i + 1 < partitions.size()) {
+      next = std::async(std::launch::async, [this, p = partitions[i + 1]] {
+        return Fill(p);
+      });
+    }
+
+    fn(current);
+
+    if (!next.valid()) {
+      KATANA_CHECKED(Release(current));
+      break;
+    }
+    auto next_res = next.get();
+    KATANA_CHECKED(Release(current));
+    current = KATANA_CHECKED(std::move(next_res));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<katana::NUMAArray<uint32_t>>
+katana::analytics::OutOfCoreBfs(OutOfCoreTopology* topology, uint32_t source) {
+  uint64_t num_nodes = topology->NumNodes();
+  if (source >= num_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "source {} is not one of the {} nodes",
+        source, num_nodes);
+  }
+
+  katana::StatTimer exec_time("OutOfCoreBfs");
+  exec_time.start();
+
+  katana::NUMAArray<uint32_t> level;
+  level.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(level.begin(), level.end(), kInfinity);
+  level[source] = 0;
+
+  // Partitions with nodes in the current and the next frontier
+  std::vector<uint8_t> frontier(topology->NumPartitions(), 0);
+  std::vector<uint8_t> next(topology->NumPartitions(), 0);
+  frontier[topology->PartitionOf(source)] = 1;
+
+  uint32_t cur = 0;
+  while (std::find(frontier.begin(), frontier.end(), 1) != frontier.end()) {
+    KATANA_CHECKED(topology->ForEachPartition(
+        [&](uint32_t p) { return frontier[p] != 0; },
+        [&](const OutOfCorePartition& part) {
+          katana::do_all(
+              katana::iterate(part.begin(), part.end()),
+              [&](uint64_t u) {
+                if (LoadRelaxed(&level[u]) != cur) {
+                  return;
+                }
+                for (auto e = part.EdgesBegin(u); e < part.EdgesEnd(u); ++e) {
+                  uint32_t v = part.OutEdgeDst(e);
+                  if (LoadRelaxed(&level[v]) == kInfinity &&
+                      CasRelaxed(&level[v], kInfinity, cur + 1)) {
+                    __atomic_store_n(
+                        &next[topology->PartitionOf(v)], 1, __ATOMIC_RELAXED);
+                  }
+                }
+              },
+              katana::steal(), katana::loopname("OutOfCoreBfs"));
+        }));
+    frontier.swap(next);
+    std::fill(next.begin(), next.end(), 0);
+    ++cur;
+  }
+
+  exec_time.stop();
+  katana::ReportStatSingle("OutOfCoreBfs", "Levels", cur);
+  return katana::NUMAArray<uint32_t>(std::move(level));
+}
+
+katana::Result<katana::NUMAArray<float>>
+katana::analytics::OutOfCorePagerank(
+    OutOfCoreTopology* topology, const PagerankPlan& plan) {
+  uint64_t num_nodes = topology->NumNodes();
+  katana::NUMAArray<float> rank;
+  katana::NUMAArray<std::atomic<float>> sum;
+  rank.allocateInterleaved(num_nodes);
+  sum.allocateInterleaved(num_nodes);
+  if (num_nodes == 0) {
+    return katana::NUMAArray<float>(std::move(rank));
+  }
+
+  katana::StatTimer exec_time("OutOfCorePagerank");
+  exec_time.start();
+
+  katana::ParallelSTL::fill(rank.begin(), rank.end(), 1.0f / num_nodes);
+  float base_score = 1.0f - plan.alpha();
+  katana::GAccumulator<float> accum;
+  unsigned int iteration = 0;
+  while (true) {
+    katana::do_all(katana::iterate(uint64_t{0}, num_nodes), [&](uint64_t n) {
+      sum[n].store(0, std::memory_order_relaxed);
+    });
+
+    KATANA_CHECKED(topology->ForEachPartition(
+        {}, [&](const OutOfCorePartition& part) {
+          katana::do_all(
+              katana::iterate(part.begin(), part.end()),
+              [&](uint64_t u) {
+                uint64_t degree = part.OutDegree(u);
+                if (degree == 0) {
+                  return;
+                }
+                float share = rank[u] / degree;
+                for (auto e = part.EdgesBegin(u); e < part.EdgesEnd(u); ++e) {
+                  katana::atomicAdd(sum[part.OutEdgeDst(e)], share);
+                }
+              },
+              katana::steal(),
+              katana::chunk_size<PagerankPlan::kChunkSize>(),
+              katana::loopname("OutOfCorePagerank"));
+        }));
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          float value =
+              sum[n].load(std::memory_order_relaxed) * plan.alpha() +
+              base_score;
+          accum += std::fabs(value - rank[n]);
+          rank[n] = value;
+        },
+        katana::loopname("OutOfCorePagerank Update"));
+
+    iteration += 1;
+    if (accum.reduce() <= plan.tolerance() ||
+        iteration >= plan.max_iterations()) {
+      break;
+    }
+    accum.reset();
+  }
+
+  exec_time.stop();
+  katana::ReportStatSingle("OutOfCorePagerank", "Iterations", iteration);
+  return katana::NUMAArray<float>(std::move(rank));
+}
+
+katana::Result<katana::NUMAArray<uint32_t>>
+katana::analytics::OutOfCoreConnectedComponents(OutOfCoreTopology* topology) {
+  uint64_t num_nodes = topology->NumNodes();
+
+  katana::StatTimer exec_time("OutOfCoreConnectedComponents");
+  exec_time.start();
+
+  katana::NUMAArray<uint32_t> parent;
+  parent.allocateInterleaved(num_nodes);
+  katana::do_all(katana::iterate(uint64_t{0}, num_nodes), [&](uint64_t n) {
+    parent[n] = n;
+  });
+
+  KATANA_CHECKED(topology->ForEachPartition(
+      {}, [&](const OutOfCorePartition& part) {
+        katana::do_all(
+            katana::iterate(part.begin(), part.end()),
+            [&](uint64_t u) {
+              for (auto e = part.EdgesBegin(u); e < part.EdgesEnd(u); ++e) {
+                Union(&parent, static_cast<uint32_t>(u), part.OutEdgeDst(e));
+              }
+            },
+            katana::steal(), katana::loopname("OutOfCoreConnectedComponents"));
+      }));
+
+  katana::do_all(katana::iterate(uint64_t{0}, num_nodes), [&](uint64_t n) {
+    __atomic_store_n(
+        &parent[n], Find(&parent, static_cast<uint32_t>(n)), __ATOMIC_RELAXED);
+  });
+
+  exec_time.stop();
+  return katana::NUMAArray<uint32_t>(std::move(parent));
+}
@@ -27,6 +27,7 @@
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
+#include "katana/analytics/RunStatistics.h"
 #include "katana/analytics/Utils.h"
 #include "katana/analytics/pagerank/pagerank.h"
 
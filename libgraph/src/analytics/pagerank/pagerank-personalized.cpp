@@ -0,0 +1,393 @@
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "pagerank-impl.h"
+
+using katana::analytics::PersonalizedPagerankPlan;
+
+namespace {
+
+using Graph = katana::TypedPropertyGraph<std::tuple<>, std::tuple<>>;
+using GNode = Graph::Node;
+
+/// The top ranked nodes of a seed in decreasing rank
+using TopRanks = std::vector<std::pair<GNode, PRTy>>;
+
+template <typename Map>
+TopRanks
+SelectTop(const Map& ranks, uint32_t top_k) {
+  TopRanks top;
+  top.reserve(ranks.size());
+  for (const auto& [node, rank] : ranks) {
+    if (rank > 0) {
+      top.emplace_back(node, static_cast<PRTy>(rank));
+    }
+  }
+  auto higher = [](const auto& a, const auto& b) {
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+  };
+  size_t k = std::min<size_t>(top_k, top.size());
+  std::partial_sort(top.begin(), top.begin() + k, top.end(), higher);
+  top.resize(k);
+  return top;
+}
+
+/// Forward push from seed. Residual that would leave a node without
+/// out-edges returns to the seed instead.
+TopRanks
+ForwardPush(const Graph& graph, GNode seed, PersonalizedPagerankPlan plan) {
+  struct State {
+    double rank{};
+    double residual{};
+    bool queued{};
+  };
+  std::unordered_map<GNode, State> states;
+  std::deque<GNode> queue;
+
+  auto must_push = [&](GNode node, const State& state) {
+    size_t degree = std::max<size_t>(graph.OutDegree(node), 1);
+    return state.residual > plan.epsilon() * degree;
+  };
+  auto add_residual = [&](GNode node, double residual) {
+    State& state = states[node];
+    state.residual += residual;
+    if (!state.queued && must_push(node, state)) {
+      state.queued = true;
+      queue.push_back(node);
+    }
+  };
+
+  add_residual(seed, 1);
+  while (!queue.empty()) {
+    GNode node = queue.front();
+    queue.pop_front();
+    State& state = states[node];
+    state.queued = false;
+    double residual = state.residual;
+    state.residual = 0;
+    state.rank += (1 - plan.alpha()) * residual;
+
+    size_t degree = graph.OutDegree(node);
+    if (degree == 0) {
+      add_residual(seed, plan.alpha() * residual);
+      continue;
+    }
+    double share = plan.alpha() * residual / degree;
+    for (auto e : graph.OutEdges(node)) {
+      add_residual(graph.OutEdgeDst(e), share);
+    }
+  }
+
+  std::unordered_map<GNode, double> ranks;
+  for (const auto& [node, state] : states) {
+    ranks.emplace(node, state.rank);
+  }
+  return SelectTop(ranks, plan.top_k());
+}
+
+/// Random walks from seed, which continue at each step with probability
+/// alpha and return to the seed from a node without out-edges
+TopRanks
+MonteCarlo(
+    const Graph& graph, GNode seed, uint64_t rng_seed,
+    PersonalizedPagerankPlan plan) {
+  std::mt19937_64 gen(rng_seed);
+  std::bernoulli_distribution follow(plan.alpha());
+  std::unordered_map<GNode, uint32_t> ends;
+
+  for (uint32_t walk = 0; walk < plan.num_walks(); ++walk) {
+    GNode node = seed;
+    while (follow(gen)) {
+      size_t degree = graph.OutDegree(node);
+      if (degree == 0) {
+        node = seed;
+        continue;
+      }
+      auto edges = graph.OutEdges(node);
+      std::uniform_int_distribution<size_t> pick(0, degree - 1);
+      node = graph.OutEdgeDst(*std::next(edges.begin(), pick(gen)));
+    }
+    ends[node] += 1;
+  }
+
+  std::unordered_map<GNode, double> ranks;
+  for (const auto& [node, count] : ends) {
+    ranks.emplace(node, static_cast<double>(count) / plan.num_walks());
+  }
+  return SelectTop(ranks, plan.top_k());
+}
+
+katana::Result<void>
+AddTopRanks(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& row_of,
+    const std::vector<TopRanks>& tops, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx) {
+  arrow::LargeListBuilder nodes_builder(
+      arrow::default_memory_pool(), std::make_shared<arrow::UInt32Builder>());
+  arrow::LargeListBuilder ranks_builder(
+      arrow::default_memory_pool(), std::make_shared<arrow::FloatBuilder>());
+  auto* node_values =
+      static_cast<arrow::UInt32Builder*>(nodes_builder.value_builder());
+  auto* rank_values =
+      static_cast<arrow::FloatBuilder*>(ranks_builder.value_builder());
+
+  for (size_t node = 0; node < row_of.size(); ++node) {
+    KATANA_CHECKED(nodes_builder.Append());
+    KATANA_CHECKED(ranks_builder.Append());
+    if (row_of[node] == std::numeric_limits<uint32_t>::max()) {
+      continue;
+    }
+    for (const auto& [top_node, rank] : tops[row_of[node]]) {
+      KATANA_CHECKED(node_values->Append(top_node));
+      KATANA_CHECKED(rank_values->Append(rank));
+    }
+  }
+
+  std::shared_ptr<arrow::Array> nodes = KATANA_CHECKED(nodes_builder.Finish());
+  std::shared_ptr<arrow::Array> ranks = KATANA_CHECKED(ranks_builder.Finish());
+  auto table = arrow::Table::Make(
+      arrow::schema({
+          arrow::field(output_property_name + "_nodes", nodes->type()),
+          arrow::field(output_property_name + "_ranks", ranks->type()),
+      }),
+      {nodes, ranks});
+  return pg->AddNodeProperties(table, txn_ctx);
+}
+
+/// The lists of the list property name of pg, one per node
+template <typename ValueArray>
+katana::Result<std::vector<std::vector<typename ValueArray::value_type>>>
+ReadLists(katana::PropertyGraph* pg, const std::string& name) {
+  auto column = KATANA_CHECKED(pg->GetNodeProperty(name));
+  std::vector<std::vector<typename ValueArray::value_type>> lists;
+  lists.reserve(column->length());
+  for (const auto& chunk : column->chunks()) {
+    auto list_array = std::dynamic_pointer_cast<arrow::LargeListArray>(chunk);
+    std::shared_ptr<ValueArray> values;
+    if (list_array) {
+      values = std::dynamic_pointer_cast<ValueArray>(list_array->values());
+    }
+    if (!values) {
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError, "property {} has type {}", name,
+          chunk->type()->ToString());
+    }
+    for (int64_t i = 0; i < list_array->length(); ++i) {
+      auto& list = lists.emplace_back();
+      for (int64_t j = list_array->value_offset(i);
+           j < list_array->value_offset(i + 1); ++j) {
+        list.emplace_back(values->Value(j));
+      }
+    }
+  }
+  return lists;
+}
+
+/// The Personalized Page Rank of every node for seed by power iteration,
+/// with the walks from nodes without out-edges returning to the seed
+std::vector<double>
+ExactPersonalizedPagerank(const Graph& graph, GNode seed, double alpha) {
+  constexpr int kMaxIterations = 1000;
+  constexpr double kConvergence = 1e-9;
+
+  std::vector<double> rank(graph.NumNodes());
+  std::vector<double> next(graph.NumNodes());
+  rank[seed] = 1;
+  for (int iteration = 0; iteration < kMaxIterations; ++iteration) {
+    std::fill(next.begin(), next.end(), 0.0);
+    double returned = 1 - alpha;
+    for (GNode node : graph) {
+      if (rank[node] == 0) {
+        continue;
+      }
+      size_t degree = graph.OutDegree(node);
+      if (degree == 0) {
+        returned += alpha * rank[node];
+        continue;
+      }
+      double share = alpha * rank[node] / degree;
+      for (auto e : graph.OutEdges(node)) {
+        next[graph.OutEdgeDst(e)] += share;
+      }
+    }
+    next[seed] += returned;
+
+    double change = 0;
+    for (size_t i = 0; i < rank.size(); ++i) {
+      change += std::abs(next[i] - rank[i]);
+    }
+    rank.swap(next);
+    if (change < kConvergence) {
+      break;
+    }
+  }
+  return rank;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::PersonalizedPagerank(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    PersonalizedPagerankPlan plan) {
+  if (!(plan.alpha() > 0 && plan.alpha() < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "alpha {} must be in (0, 1)",
+        plan.alpha());
+  }
+  switch (plan.algorithm()) {
+  case PersonalizedPagerankPlan::kForwardPush:
+    if (!(plan.epsilon() > 0)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "epsilon {} must be positive",
+          plan.epsilon());
+    }
+    break;
+  case PersonalizedPagerankPlan::kMonteCarlo:
+    if (plan.num_walks() == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "num_walks must be positive");
+    }
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm {}",
+        plan.algorithm());
+  }
+
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {}, {}));
+
+  // Compute each distinct seed once
+  std::vector<uint32_t> unique_seeds(seeds);
+  std::sort(unique_seeds.begin(), unique_seeds.end());
+  unique_seeds.erase(
+      std::unique(unique_seeds.begin(), unique_seeds.end()),
+      unique_seeds.end());
+  std::vector<uint32_t> row_of(
+      graph.NumNodes(), std::numeric_limits<uint32_t>::max());
+  for (size_t i = 0; i < unique_seeds.size(); ++i) {
+    if (unique_seeds[i] >= graph.NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "seed {} is not a node",
+          unique_seeds[i]);
+    }
+    row_of[unique_seeds[i]] = i;
+  }
+
+  std::vector<TopRanks> tops(unique_seeds.size());
+  katana::StatTimer exec_time("PersonalizedPagerank");
+  exec_time.start();
+  katana::do_all(
+      katana::iterate(size_t{0}, unique_seeds.size()),
+      [&](size_t i) {
+        if (plan.algorithm() == PersonalizedPagerankPlan::kForwardPush) {
+          tops[i] = ForwardPush(graph, unique_seeds[i], plan);
+        } else {
+          // Walks depend only on the plan seed and the seed node, not on
+          // the thread that runs them
+          tops[i] = MonteCarlo(
+              graph, unique_seeds[i],
+              plan.seed() ^ (unique_seeds[i] * 0x9e3779b97f4a7c15ULL), plan);
+        }
+      },
+      katana::steal(), katana::loopname("PersonalizedPagerank"));
+  exec_time.stop();
+
+  return AddTopRanks(pg, row_of, tops, output_property_name, txn_ctx);
+}
+
+katana::Result<void>
+katana::analytics::PersonalizedPagerankAssertValid(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    const std::string& output_property_name, PersonalizedPagerankPlan plan,
+    double tolerance) {
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {}, {}));
+  auto nodes = KATANA_CHECKED(
+      ReadLists<arrow::UInt32Array>(pg, output_property_name + "_nodes"));
+  auto ranks = KATANA_CHECKED(
+      ReadLists<arrow::FloatArray>(pg, output_property_name + "_ranks"));
+  if (nodes.size() != graph.NumNodes() || ranks.size() != graph.NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "expected {} rows, found {} and {}",
+        graph.NumNodes(), nodes.size(), ranks.size());
+  }
+
+  std::vector<bool> is_seed(graph.NumNodes());
+  for (uint32_t seed : seeds) {
+    if (seed >= graph.NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "seed {} is not a node", seed);
+    }
+    is_seed[seed] = true;
+  }
+
+  for (GNode seed : graph) {
+    const auto& top_nodes = nodes[seed];
+    const auto& top_ranks = ranks[seed];
+    if (!is_seed[seed]) {
+      if (!top_nodes.empty() || !top_ranks.empty()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed, "node {} is not a seed", seed);
+      }
+      continue;
+    }
+    if (top_nodes.size() != top_ranks.size() ||
+        top_nodes.size() > plan.top_k()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "seed {} has {} nodes and {} ranks for a top {}", seed,
+          top_nodes.size(), top_ranks.size(), plan.top_k());
+    }
+
+    std::vector<double> exact =
+        ExactPersonalizedPagerank(graph, seed, plan.alpha());
+    std::vector<bool> listed(graph.NumNodes());
+    for (size_t i = 0; i < top_nodes.size(); ++i) {
+      GNode node = top_nodes[i];
+      if (node >= graph.NumNodes() || listed[node]) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "seed {} lists node {} twice or out of range", seed, node);
+      }
+      listed[node] = true;
+      if (i > 0 && top_ranks[i] > top_ranks[i - 1]) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "ranks of seed {} are not in decreasing order", seed);
+      }
+      if (std::abs(top_ranks[i] - exact[node]) > tolerance) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "rank of node {} for seed {} is {}, expected {}", node, seed,
+            top_ranks[i], exact[node]);
+      }
+    }
+
+    // Nodes are left out because they are past the top_k or, with fewer
+    // reported, because their estimated rank is 0
+    double lowest = top_nodes.size() == plan.top_k() && !top_ranks.empty()
+                        ? top_ranks.back()
+                        : 0;
+    for (GNode node : graph) {
+      if (!listed[node] && exact[node] > lowest + tolerance) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "node {} of rank {} is missing from the top {} of seed {}", node,
+            exact[node], plan.top_k(), seed);
+      }
+    }
+  }
+  return katana::ResultSuccess();
+}
@@ -17,8 +17,14 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <optional>
+
 #include <arrow/type.h>
 
+#include "katana/ArrayReduction.h"
+#include "katana/BatchedGather.h"
+#include "katana/EdgeBalancedRange.h"
+#include "katana/SizedCSRTopology.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
 #include "pagerank-impl.h"
@@ -82,31 +88,28 @@ InitNodeDataResidual(
 
 //! Computing outdegrees in the tranpose graph is equivalent to computing the
 //! indegrees in the original graph.
+template <typename Topo>
 katana::Result<void>
-ComputeOutDeg(const Graph& graph, PagerankValueAndOutDegreeArray* node_data) {
-  using GNode = typename Graph::Node;
+ComputeOutDeg(const Topo& graph, PagerankValueAndOutDegreeArray* node_data) {
+  using GNode = typename Topo::Node;
   katana::StatTimer out_degree_timer("computeOutDegFunc");
   out_degree_timer.start();
 
-  katana::NUMAArray<std::atomic<size_t>> vec;
-  vec.allocateInterleaved(graph.size());
+  // counts of hot destinations are combined per thread before they reach
+  // the shared array
+  katana::GArrayAccumulator<size_t> vec(graph.size());
 
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) { vec.constructAt(src, 0ul); },
-      katana::loopname("InitDegVec"));
-
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) {
-        for (auto nbr : graph.OutEdges(src)) {
+  // hubs are split across threads; the counts are reduced anyway
+  katana::DoAllEdgeBalanced(
+      katana::EdgeBalancedRange<Topo>(graph),
+      [&](const GNode&, const auto& edges) {
+        for (auto nbr : edges) {
           auto dest = graph.OutEdgeDst(nbr);
-          vec[dest].fetch_add(1ul);
+          vec.update(dest, 1ul);
         }
       },
-      katana::steal(),
-      katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
-      katana::loopname("ComputeOutDeg"));
+      katana::steal(), katana::loopname("ComputeOutDeg"));
+  vec.reduce();
 
   katana::do_all(
       katana::iterate(graph),
@@ -117,31 +120,28 @@ ComputeOutDeg(const Graph& graph, PagerankValueAndOutDegreeArray* node_data) {
   return katana::ResultSuccess();
 }
 
+template <typename Topo>
 katana::Result<void>
-ComputeOutDeg(const Graph& graph, NodeOutDegreeArray* node_data) {
-  using GNode = typename Graph::Node;
+ComputeOutDeg(const Topo& graph, NodeOutDegreeArray* node_data) {
+  using GNode = typename Topo::Node;
   katana::StatTimer out_degree_timer("computeOutDegFunc");
   out_degree_timer.start();
 
-  katana::NUMAArray<std::atomic<size_t>> vec;
-  vec.allocateInterleaved(graph.size());
-
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) { vec.constructAt(src, 0ul); },
-      katana::loopname("InitDegVec"));
+  // counts of hot destinations are combined per thread before they reach
+  // the shared array
+  katana::GArrayAccumulator<size_t> vec(graph.size());
 
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) {
-        for (auto nbr : graph.OutEdges(src)) {
+  // hubs are split across threads; the counts are reduced anyway
+  katana::DoAllEdgeBalanced(
+      katana::EdgeBalancedRange<Topo>(graph),
+      [&](const GNode&, const auto& edges) {
+        for (auto nbr : edges) {
           auto dest = graph.OutEdgeDst(nbr);
-          vec[dest].fetch_add(1ul);
+          vec.update(dest, 1ul);
         }
       },
-      katana::steal(),
-      katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
-      katana::loopname("ComputeOutDeg"));
+      katana::steal(), katana::loopname("ComputeOutDeg"));
+  vec.reduce();
 
   katana::do_all(
       katana::iterate(graph),
@@ -160,11 +160,13 @@ ComputeOutDeg(const Graph& graph, NodeOutDegreeArray* node_data) {
  * the next pagerank.
  */
 //! [scalarreduction]
+template <typename Topo>
 katana::Result<void>
 ComputePRResidual(
-    Graph* graph, DeltaArray* delta, ResidualArray* residual,
+    const Topo& topo, Graph* graph, DeltaArray* delta, ResidualArray* residual,
     const NodeOutDegreeArray& node_out_degree,
-    katana::analytics::PagerankPlan plan) {
+    katana::analytics::PagerankPlan plan,
+    katana::analytics::RunRecorder* recorder) {
   katana::StatTimer exec_time("PagerankPullResidual");
   exec_time.start();
   using GNode = typename Graph::Node;
@@ -197,12 +199,15 @@ ComputePRResidual(
         katana::iterate(*graph),
         [&](const GNode& src) {
           float sum = 0;
-          for (auto nbr : graph->OutEdges(src)) {
-            auto dest = graph->OutEdgeDst(nbr);
-            if ((*delta)[dest] > 0) {
-              sum += (*delta)[dest];
-            }
-          }
+          katana::GatherBatched(
+              topo.OutEdges(src),
+              [&](auto nbr) { return topo.OutEdgeDst(nbr); },
+              [&](auto dest) { return &(*delta)[dest]; },
+              [&](auto, auto dest) {
+                if ((*delta)[dest] > 0) {
+                  sum += (*delta)[dest];
+                }
+              });
           if (sum > 0) {
             (*residual)[src] = sum;
           }
@@ -222,6 +227,8 @@ ComputePRResidual(
   }  ///< End while(true).
   //! [scalarreduction]
   exec_time.start();
+  recorder->AddIterations(iterations);
+  recorder->AddWorkItems(iterations * topo.NumEdges());
   return katana::ResultSuccess();
 }
 
@@ -229,10 +236,12 @@ ComputePRResidual(
  * PageRank pull topological.
  * Always calculate the new pagerank for each iteration.
  */
+template <typename Topo>
 katana::Result<void>
 ComputePRTopological(
-    Graph* graph, katana::analytics::PagerankPlan plan,
-    PagerankValueAndOutDegreeArray* node_data) {
+    const Topo& topo, Graph* graph, katana::analytics::PagerankPlan plan,
+    PagerankValueAndOutDegreeArray* node_data,
+    katana::analytics::RunRecorder* recorder) {
   katana::StatTimer exec_time("PagerankPullTopological");
   exec_time.start();
 
@@ -247,11 +256,16 @@ ComputePRTopological(
         [&](const GNode& src) {
           float sum = 0.0;
 
-          for (auto jj : graph->OutEdges(src)) {
-            auto dest = graph->OutEdgeDst(jj);
-            auto& ddata = (*node_data)[dest];
-            sum += ddata.value / ddata.out;
-          }
+          // the data of in-neighbors is read at random, so it is
+          // prefetched a batch of edges ahead
+          katana::GatherBatched(
+              topo.OutEdges(src),
+              [&](auto jj) { return topo.OutEdgeDst(jj); },
+              [&](auto dest) { return &(*node_data)[dest]; },
+              [&](auto, auto dest) {
+                auto& ddata = (*node_data)[dest];
+                sum += ddata.value / ddata.out;
+              });
 
           //! New value of pagerank after computing contributions from
           //! incoming edges in the original graph.
@@ -283,8 +297,11 @@ ComputePRTopological(
   }  ///< End while(true).
 
   katana::ReportStatSingle("PageRank", "Iterations", iteration);
+  recorder->AddIterations(iteration);
+  recorder->AddWorkItems(iteration * topo.NumEdges());
 
   /// Assign values back to the property graph.
+  recorder->StartPhase(katana::analytics::kPhaseOutput);
   katana::do_all(
       katana::iterate(*graph),
       [&](uint32_t i) {
@@ -296,16 +313,43 @@ ComputePRTopological(
   return katana::ResultSuccess();
 }
 
+/// \returns the copy of topo with 32-bit edge indices that plan asks to walk
+/// instead of topo, or nullopt to walk topo. With kAutoEdgeIndexWidth, a
+/// topology that does not fit, e.g., because a projection has property
+/// indexes beyond 32 bits, falls back to 64 bits.
+template <typename Topo>
+katana::Result<std::optional<katana::CSRTopology32>>
+Make32BitTopology(
+    const Topo& topo, const katana::analytics::PagerankPlan& plan) {
+  if (!katana::analytics::Use32BitEdgeIndex(
+          plan.edge_index_width(), topo.NumEdges())) {
+    return std::optional<katana::CSRTopology32>();
+  }
+  auto res = katana::CSRTopology32::Make(topo);
+  if (!res) {
+    if (plan.edge_index_width() == katana::analytics::kAutoEdgeIndexWidth) {
+      return std::optional<katana::CSRTopology32>();
+    }
+    return res.error();
+  }
+  return std::make_optional(std::move(res.value()));
+}
+
 }  // namespace
 
 katana::Result<void>
 PagerankPullTopological(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  katana::analytics::RunRecorder recorder("PagerankPullTopological");
+  recorder.StartPhase(katana::analytics::kPhaseViewBuild);
   KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<NodeValue>>(
       txn_ctx, {output_property_name}));
 
-  Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+  Graph graph = KATANA_CHECKED(katana::analytics::MakeGraphOfEdgeType<Graph>(
+      pg, plan.edge_type(), {output_property_name}, {}));
+
+  recorder.StartPhase(katana::analytics::kPhaseInit);
 
   katana::EnsurePreallocated(2, 3 * graph.size() * sizeof(NodeData));
   katana::ReportPageAllocGuard page_alloc;
@@ -315,19 +359,32 @@ PagerankPullTopological(
   node_data.allocateInterleaved(graph.size());
 
   KATANA_CHECKED(InitNodeDataTopological(graph, &node_data));
-  KATANA_CHECKED(ComputeOutDeg(graph, &node_data));
 
-  return ComputePRTopological(&graph, plan, &node_data);
+  std::optional<katana::CSRTopology32> topo =
+      KATANA_CHECKED(Make32BitTopology(graph, plan));
+  if (topo) {
+    KATANA_CHECKED(ComputeOutDeg(*topo, &node_data));
+    recorder.StartPhase(katana::analytics::kPhaseMainLoop);
+    return ComputePRTopological(*topo, &graph, plan, &node_data, &recorder);
+  }
+  KATANA_CHECKED(ComputeOutDeg(graph, &node_data));
+  recorder.StartPhase(katana::analytics::kPhaseMainLoop);
+  return ComputePRTopological(graph, &graph, plan, &node_data, &recorder);
 }
 
 katana::Result<void>
 PagerankPullResidual(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  katana::analytics::RunRecorder recorder("PagerankPullResidual");
+  recorder.StartPhase(katana::analytics::kPhaseViewBuild);
   KATANA_CHECKED(
       pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
 
-  Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+  Graph graph = KATANA_CHECKED(katana::analytics::MakeGraphOfEdgeType<Graph>(
+      pg, plan.edge_type(), {output_property_name}, {}));
+
+  recorder.StartPhase(katana::analytics::kPhaseInit);
 
   katana::EnsurePreallocated(2, 3 * graph.size() * sizeof(NodeData));
   katana::ReportPageAllocGuard page_alloc;
@@ -343,7 +400,17 @@ PagerankPullResidual(
 
   KATANA_CHECKED(
       InitNodeDataResidual(&graph, &delta, &residual, &node_out_degree, plan));
-  KATANA_CHECKED(ComputeOutDeg(graph, &node_out_degree));
 
-  return ComputePRResidual(&graph, &delta, &residual, node_out_degree, plan);
+  std::optional<katana::CSRTopology32> topo =
+      KATANA_CHECKED(Make32BitTopology(graph, plan));
+  if (topo) {
+    KATANA_CHECKED(ComputeOutDeg(*topo, &node_out_degree));
+    recorder.StartPhase(katana::analytics::kPhaseMainLoop);
+    return ComputePRResidual(
+        *topo, &graph, &delta, &residual, node_out_degree, plan, &recorder);
+  }
+  KATANA_CHECKED(ComputeOutDeg(graph, &node_out_degree));
+  recorder.StartPhase(katana::analytics::kPhaseMainLoop);
+  return ComputePRResidual(
+      graph, &graph, &delta, &residual, node_out_degree, plan, &recorder);
 }
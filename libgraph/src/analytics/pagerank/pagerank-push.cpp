@@ -17,8 +17,12 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include "katana/AtomicHelpers.h"
 #include "katana/Properties.h"
+#include "katana/Reduction.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
 #include "pagerank-impl.h"
@@ -28,6 +32,7 @@ using katana::atomicAdd;
 namespace {
 
 struct NodeResidual : katana::AtomicPODProperty<PRTy> {};
+struct PreviousValue : katana::PODProperty<PRTy> {};
 
 using NodeData = std::tuple<NodeValue, NodeResidual>;
 using EdgeData = std::tuple<>;
@@ -56,6 +61,8 @@ katana::Result<void>
 PagerankPushAsynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  katana::analytics::RunRecorder recorder("PagerankPushAsynchronous");
+  recorder.StartPhase(katana::analytics::kPhaseViewBuild);
   katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
   katana::ReportPageAllocGuard page_alloc;
 
@@ -68,11 +75,15 @@ PagerankPushAsynchronous(
     return result.error();
   }
 
-  Graph graph = KATANA_CHECKED(
-      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
+  Graph graph = KATANA_CHECKED(katana::analytics::MakeGraphOfEdgeType<Graph>(
+      pg, plan.edge_type(), {output_property_name, temporary_property.name()},
+      {}));
 
+  recorder.StartPhase(katana::analytics::kPhaseInit);
   InitializeNodeResidual(&graph, plan);
 
+  recorder.StartPhase(katana::analytics::kPhaseMainLoop);
+  katana::GAccumulator<uint64_t> pushes;
   typedef katana::PerSocketChunkFIFO<
       katana::analytics::PagerankPlan::kChunkSize>
       WL;
@@ -85,6 +96,7 @@ PagerankPushAsynchronous(
           auto& src_value = graph.GetData<NodeValue>(src);
           src_value += old_residual;
           int src_nout = graph.OutDegree(src);
+          pushes += src_nout;
           if (src_nout > 0) {
             PRTy delta = old_residual * plan.alpha() / src_nout;
             //! For each out-going neighbors.
@@ -104,6 +116,7 @@ PagerankPushAsynchronous(
       },
       katana::loopname("PushResidualAsynchronous"),
       katana::disable_conflict_detection(), katana::wl<WL>());
+  recorder.AddWorkItems(pushes.reduce());
 
   return katana::ResultSuccess();
 }
@@ -112,6 +125,8 @@ katana::Result<void>
 PagerankPushSynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  katana::analytics::RunRecorder recorder("PagerankPushSynchronous");
+  recorder.StartPhase(katana::analytics::kPhaseViewBuild);
   katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
   katana::ReportPageAllocGuard page_alloc;
 
@@ -124,9 +139,11 @@ PagerankPushSynchronous(
     return result.error();
   }
 
-  Graph graph = KATANA_CHECKED(
-      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
+  Graph graph = KATANA_CHECKED(katana::analytics::MakeGraphOfEdgeType<Graph>(
+      pg, plan.edge_type(), {output_property_name, temporary_property.name()},
+      {}));
 
+  recorder.StartPhase(katana::analytics::kPhaseInit);
   InitializeNodeResidual(&graph, plan);
 
   struct Update {
@@ -144,6 +161,8 @@ PagerankPushSynchronous(
       katana::iterate(graph), [&](const auto& src) { active_nodes.push(src); },
       katana::no_stats());
 
+  recorder.StartPhase(katana::analytics::kPhaseMainLoop);
+  katana::GAccumulator<uint64_t> pushes;
   size_t iter = 0;
   for (; !active_nodes.empty() && iter < plan.max_iterations(); ++iter) {
     katana::do_all(
@@ -188,6 +207,7 @@ PagerankPushSynchronous(
         katana::iterate(updates),
         [&](const Update& up) {
           //! For each out-going neighbors.
+          pushes += up.end - up.beg;
           for (auto jj = up.beg; jj != up.end; ++jj) {
             auto dest = graph.OutEdgeDst(*jj);
             auto& ddata_residual = graph.GetData<NodeResidual>(dest);
@@ -207,5 +227,145 @@ PagerankPushSynchronous(
 
     updates.clear();
   }
+  recorder.AddIterations(iter);
+  recorder.AddWorkItems(pushes.reduce());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::PagerankIncremental(
+    katana::PropertyGraph* pg, const std::string& previous_property_name,
+    const EdgeUpdates& updates, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, PagerankPlan plan) {
+  katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+
+  KATANA_CHECKED(pg->ConstructNodeProperties<NodeData>(
+      txn_ctx, {output_property_name, temporary_property.name()}));
+
+  Graph graph = KATANA_CHECKED(
+      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
+  using PreviousGraph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Default, std::tuple<PreviousValue>,
+      std::tuple<>>;
+  PreviousGraph previous =
+      KATANA_CHECKED(PreviousGraph::Make(pg, {previous_property_name}, {}));
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        graph.GetData<NodeValue>(n) = previous.GetData<PreviousValue>(n);
+        graph.GetData<NodeResidual>(n) = 0;
+      },
+      katana::no_stats(), katana::loopname("InitializeIncremental"));
+
+  // The residual an update creates at a destination of src is the change in
+  // what src contributes to it: alpha times the previous rank of src, split
+  // over the new instead of the old out-edges of src
+  auto by_source = [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  };
+  auto inserted = updates.inserted;
+  auto deleted = updates.deleted;
+  std::sort(inserted.begin(), inserted.end(), by_source);
+  std::sort(deleted.begin(), deleted.end(), by_source);
+  std::vector<uint32_t> sources;
+  for (const auto* edges : {&inserted, &deleted}) {
+    for (const auto& [src, dst] : *edges) {
+      if (src >= graph.size() || dst >= graph.size()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "edge ({}, {}) is not in graph",
+            src, dst);
+      }
+      sources.emplace_back(src);
+    }
+  }
+  std::sort(sources.begin(), sources.end());
+  sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+
+  katana::GReduceLogicalOr inconsistent;
+  katana::do_all(
+      katana::iterate(sources),
+      [&](uint32_t src) {
+        auto [ins_begin, ins_end] = std::equal_range(
+            inserted.begin(), inserted.end(), std::make_pair(src, 0u),
+            by_source);
+        auto [del_begin, del_end] = std::equal_range(
+            deleted.begin(), deleted.end(), std::make_pair(src, 0u),
+            by_source);
+        int64_t new_degree = graph.OutDegree(src);
+        int64_t old_degree =
+            new_degree - (ins_end - ins_begin) + (del_end - del_begin);
+        if (old_degree < 0) {
+          inconsistent.update(true);
+          return;
+        }
+        PRTy contribution =
+            plan.alpha() * previous.GetData<PreviousValue>(src);
+        PRTy new_share = new_degree ? contribution / new_degree : 0;
+        PRTy old_share = old_degree ? contribution / old_degree : 0;
+
+        if (new_share != old_share) {
+          for (const auto& e : graph.OutEdges(src)) {
+            atomicAdd(
+                graph.GetData<NodeResidual>(graph.OutEdgeDst(e)),
+                new_share - old_share);
+          }
+        }
+        // Inserted edges had no old share; deleted edges lose theirs
+        for (auto it = ins_begin; it != ins_end; ++it) {
+          atomicAdd(graph.GetData<NodeResidual>(it->second), old_share);
+        }
+        for (auto it = del_begin; it != del_end; ++it) {
+          atomicAdd(graph.GetData<NodeResidual>(it->second), -old_share);
+        }
+      },
+      katana::steal(), katana::loopname("IncrementalResidual"));
+  if (inconsistent.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "deleted edges exceed the old out-degree of their source");
+  }
+
+  katana::InsertBag<GNode> active;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        if (std::abs(graph.GetData<NodeResidual>(n)) > plan.tolerance()) {
+          active.push(n);
+        }
+      },
+      katana::no_stats(), katana::loopname("IncrementalActive"));
+
+  typedef katana::PerSocketChunkFIFO<
+      katana::analytics::PagerankPlan::kChunkSize>
+      WL;
+  katana::for_each(
+      katana::iterate(active),
+      [&](const GNode& src, auto& ctx) {
+        auto& src_residual = graph.GetData<NodeResidual>(src);
+        if (std::abs(src_residual) > plan.tolerance()) {
+          PRTy old_residual = src_residual.exchange(0.0);
+          graph.GetData<NodeValue>(src) += old_residual;
+          int src_nout = graph.OutDegree(src);
+          if (src_nout > 0) {
+            PRTy delta = old_residual * plan.alpha() / src_nout;
+            for (const auto& jj : graph.OutEdges(src)) {
+              auto dest = graph.OutEdgeDst(jj);
+              auto old = atomicAdd(graph.GetData<NodeResidual>(dest), delta);
+              if (std::abs(old) <= plan.tolerance() &&
+                  std::abs(old + delta) > plan.tolerance()) {
+                ctx.push(dest);
+              }
+            }
+          }
+        }
+      },
+      katana::loopname("PushResidualIncremental"),
+      katana::disable_conflict_detection(), katana::wl<WL>());
+
   return katana::ResultSuccess();
 }
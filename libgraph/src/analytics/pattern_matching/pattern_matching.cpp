@@ -0,0 +1,482 @@
+#include "katana/analytics/pattern_matching/pattern_matching.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using BiDirGraphView = katana::PropertyGraphViews::EdgeTypeAwareBiDir;
+using Node = BiDirGraphView::Node;
+using Edge = BiDirGraphView::Edge;
+using EdgesRange = katana::GraphTopologyTypes::edges_range;
+
+/// A pattern edge between the node at a position of the matching order and
+/// the node at an earlier position, or at the same one for a loop
+struct Constraint {
+  /// The position of the other endpoint of the edge
+  uint32_t other;
+  /// Whether the edge goes from the other endpoint to this node
+  bool from_other;
+  std::optional<katana::EntityTypeID> type;
+  /// The edges that satisfy the filter of the edge, by property index, or
+  /// null if there is no filter
+  const katana::DynamicBitset* selection;
+};
+
+/// A pattern prepared for matching in a graph
+struct CompiledPattern {
+  /// order[i] is the pattern node matched at position i
+  std::vector<uint32_t> order;
+  /// constraints[i] are the edges between the node at position i and the
+  /// ones before it
+  std::vector<std::vector<Constraint>> constraints;
+  /// The nodes that can be matched at each position, by property index, or
+  /// nullopt for any node
+  std::vector<std::optional<katana::DynamicBitset>> node_selections;
+  /// By pattern edge; constraints point into it, so it is never resized
+  std::vector<std::optional<katana::DynamicBitset>> edge_selections;
+  /// Whether an edge of the pattern has a type no edge of the graph has
+  bool unmatchable{false};
+};
+
+/// The nodes matched at the first size positions of the matching order
+struct PartialMatch {
+  std::array<Node, Pattern::kMaxNodes> nodes;
+  uint32_t size;
+};
+
+using Scratch = std::array<std::vector<Node>, Pattern::kMaxNodes>;
+
+katana::Result<std::optional<katana::DynamicBitset>>
+SelectPatternNodes(const katana::PropertyGraph& pg, const PatternNode& node) {
+  std::vector<katana::PropertyFilter> filters;
+  if (!node.type_name.empty()) {
+    katana::SetOfEntityTypeIDs types = KATANA_CHECKED(
+        pg.GetNodeTypeManager().GetEntityTypeIDs(
+            std::vector<std::string>{node.type_name}));
+    filters.emplace_back(katana::PropertyFilter::HasType(std::move(types)));
+  }
+  if (node.filter) {
+    filters.emplace_back(node.filter.value());
+  }
+  if (filters.empty()) {
+    return std::nullopt;
+  }
+  return KATANA_CHECKED(
+      katana::PropertyFilter::And(std::move(filters)).SelectNodes(pg));
+}
+
+/// Order the pattern nodes so that each has an edge to one before it, first
+/// the one with the most edges, then, greedily, the one with the most edges
+/// to the nodes already ordered, which constrain its candidates the most
+katana::Result<std::vector<uint32_t>>
+MatchingOrder(const Pattern& pattern) {
+  uint32_t num_nodes = pattern.nodes.size();
+  std::vector<uint32_t> degree(num_nodes);
+  for (const PatternEdge& edge : pattern.edges) {
+    ++degree[edge.src];
+    ++degree[edge.dst];
+  }
+
+  std::vector<uint32_t> order;
+  std::vector<bool> ordered(num_nodes);
+  std::vector<uint32_t> edges_to_ordered(num_nodes);
+  while (order.size() < num_nodes) {
+    std::optional<uint32_t> next;
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      if (ordered[n] || (!order.empty() && edges_to_ordered[n] == 0)) {
+        continue;
+      }
+      if (!next ||
+          std::make_pair(edges_to_ordered[n], degree[n]) >
+              std::make_pair(edges_to_ordered[*next], degree[*next])) {
+        next = n;
+      }
+    }
+    if (!next) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "pattern is not connected");
+    }
+    order.emplace_back(*next);
+    ordered[*next] = true;
+    for (const PatternEdge& edge : pattern.edges) {
+      if (edge.src == *next && edge.dst != *next) {
+        ++edges_to_ordered[edge.dst];
+      } else if (edge.dst == *next && edge.src != *next) {
+        ++edges_to_ordered[edge.src];
+      }
+    }
+  }
+  return order;
+}
+
+katana::Result<CompiledPattern>
+Compile(
+    const katana::PropertyGraph& pg, const BiDirGraphView& graph,
+    const Pattern& pattern) {
+  uint32_t num_nodes = pattern.nodes.size();
+  if (num_nodes == 0 || num_nodes > Pattern::kMaxNodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "pattern has {} nodes but must have 1 to {}", num_nodes,
+        Pattern::kMaxNodes);
+  }
+  for (const PatternEdge& edge : pattern.edges) {
+    if (edge.src >= num_nodes || edge.dst >= num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "pattern edge ({}, {}) is not between nodes of the pattern",
+          edge.src, edge.dst);
+    }
+  }
+
+  CompiledPattern compiled;
+  compiled.order = KATANA_CHECKED(MatchingOrder(pattern));
+  std::vector<uint32_t> position(num_nodes);
+  for (uint32_t i = 0; i < num_nodes; ++i) {
+    position[compiled.order[i]] = i;
+    compiled.node_selections.emplace_back(KATANA_CHECKED(
+        SelectPatternNodes(pg, pattern.nodes[compiled.order[i]])));
+  }
+
+  compiled.constraints.resize(num_nodes);
+  compiled.edge_selections.resize(pattern.edges.size());
+  for (size_t i = 0; i < pattern.edges.size(); ++i) {
+    const PatternEdge& edge = pattern.edges[i];
+    std::optional<katana::EntityTypeID> type;
+    if (!edge.type_name.empty()) {
+      if (!pg.HasAtomicEdgeType(edge.type_name)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::NotFound, "no edge type named {}",
+            edge.type_name);
+      }
+      type = pg.GetEdgeEntityTypeID(edge.type_name);
+      if (!graph.DoesEdgeTypeExist(*type)) {
+        compiled.unmatchable = true;
+      }
+    }
+    if (edge.filter) {
+      compiled.edge_selections[i] =
+          KATANA_CHECKED(edge.filter->SelectEdges(pg));
+    }
+    const katana::DynamicBitset* selection =
+        compiled.edge_selections[i] ? &compiled.edge_selections[i].value()
+                                    : nullptr;
+
+    uint32_t src = position[edge.src];
+    uint32_t dst = position[edge.dst];
+    compiled.constraints[std::max(src, dst)].emplace_back(
+        Constraint{std::min(src, dst), src < dst, type, selection});
+  }
+  return compiled;
+}
+
+/// Extends partial matches one node at a time, depth first, and hands the
+/// extensions of a node with many candidates to the worklist instead so
+/// other threads can steal them
+class Matcher {
+public:
+  Matcher(
+      const BiDirGraphView& graph, const CompiledPattern& pattern,
+      uint32_t spawn_degree)
+      : graph_(graph), pattern_(pattern), spawn_degree_(spawn_degree) {}
+
+  uint32_t size() const { return pattern_.order.size(); }
+
+  bool IsCandidate(uint32_t pos, Node n) const {
+    const auto& selection = pattern_.node_selections[pos];
+    return !selection || selection->test(graph_.GetNodePropertyIndex(n));
+  }
+
+  /// Extend m in every way, calling visit(match) with each full match and
+  /// push(match) with partial matches left to the worklist. Stops when
+  /// visit returns false.
+  template <typename Visit, typename Push>
+  void Expand(const PartialMatch& m, Scratch* scratch, Visit& visit, Push& push)
+      const {
+    if (stop_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    if (m.size == size()) {
+      if (!visit(m)) {
+        stop_.store(true, std::memory_order_relaxed);
+      }
+      return;
+    }
+
+    size_t degree = 0;
+    const Constraint* driver = Driver(m, &degree);
+    bool spawn = degree > spawn_degree_ && m.size + 1 < size();
+    ForEachExtension(m, driver, &(*scratch)[m.size], [&](Node n) {
+      PartialMatch child = m;
+      child.nodes[child.size++] = n;
+      if (spawn) {
+        push(child);
+      } else {
+        Expand(child, scratch, visit, push);
+      }
+    });
+  }
+
+private:
+  /// The neighbors of n along c: its out-edges if c goes from n, else its
+  /// in-edges
+  EdgesRange Range(const Constraint& c, Node n) const {
+    if (c.type) {
+      return c.from_other ? graph_.OutEdges(n, *c.type)
+                          : graph_.InEdges(n, *c.type);
+    }
+    return c.from_other ? graph_.OutEdges(n) : graph_.InEdges(n);
+  }
+
+  Node Neighbor(const Constraint& c, Edge e) const {
+    return c.from_other ? graph_.OutEdgeDst(e) : graph_.InEdgeSrc(e);
+  }
+
+  bool IsSelected(const Constraint& c, uint64_t edge_property_index) const {
+    return !c.selection || c.selection->test(edge_property_index);
+  }
+
+  bool IsSelectedAlong(const Constraint& c, Edge e) const {
+    return IsSelected(
+        c, c.from_other ? graph_.GetEdgePropertyIndexFromOutEdge(e)
+                        : graph_.GetEdgePropertyIndexFromInEdge(e));
+  }
+
+  /// \returns whether an edge from src to dst satisfies c
+  bool HasEdge(const Constraint& c, Node src, Node dst) const {
+    auto selected = [&](Edge e) -> bool {
+      return IsSelected(c, graph_.GetEdgePropertyIndexFromOutEdge(e));
+    };
+    if (!c.type) {
+      return graph_.HasEdgeSatisfyingPredicate(src, dst, selected);
+    }
+    for (Edge e : graph_.FindAllEdges(src, dst, *c.type)) {
+      if (selected(e)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// \returns the constraint on the next node with the fewest neighbors of
+  /// its matched endpoint, whose neighbors are the candidates for the node
+  const Constraint* Driver(const PartialMatch& m, size_t* degree) const {
+    const Constraint* driver = nullptr;
+    for (const Constraint& c : pattern_.constraints[m.size]) {
+      if (c.other == m.size) {
+        continue;
+      }
+      size_t d = Range(c, m.nodes[c.other]).size();
+      if (!driver || d < *degree) {
+        driver = &c;
+        *degree = d;
+      }
+    }
+    return driver;
+  }
+
+  /// Call fn with every node that extends m: the distinct neighbors along
+  /// driver that are candidates, differ from the nodes of m and satisfy the
+  /// other constraints
+  template <typename Fn>
+  void ForEachExtension(
+      const PartialMatch& m, const Constraint* driver, std::vector<Node>* buf,
+      Fn fn) const {
+    uint32_t pos = m.size;
+    auto extend = [&](Node n) {
+      if (!IsCandidate(pos, n)) {
+        return;
+      }
+      for (uint32_t i = 0; i < pos; ++i) {
+        if (m.nodes[i] == n) {
+          return;
+        }
+      }
+      for (const Constraint& c : pattern_.constraints[pos]) {
+        if (&c == driver) {
+          continue;
+        }
+        Node other = c.other == pos ? n : m.nodes[c.other];
+        if (!HasEdge(c, c.from_other ? other : n, c.from_other ? n : other)) {
+          return;
+        }
+      }
+      fn(n);
+    };
+
+    Node from = m.nodes[driver->other];
+    if (driver->type) {
+      // a typed range is sorted by neighbor, so repeats are adjacent
+      std::optional<Node> last;
+      for (Edge e : Range(*driver, from)) {
+        Node n = Neighbor(*driver, e);
+        if (n != last && IsSelectedAlong(*driver, e)) {
+          last = n;
+          extend(n);
+        }
+      }
+      return;
+    }
+    // the full range is sorted by type and then by neighbor
+    buf->clear();
+    for (Edge e : Range(*driver, from)) {
+      if (IsSelectedAlong(*driver, e)) {
+        buf->emplace_back(Neighbor(*driver, e));
+      }
+    }
+    std::sort(buf->begin(), buf->end());
+    buf->erase(std::unique(buf->begin(), buf->end()), buf->end());
+    // extend may recurse into deeper positions, which use their own buffers
+    for (Node n : *buf) {
+      extend(n);
+    }
+  }
+
+  const BiDirGraphView& graph_;
+  const CompiledPattern& pattern_;
+  uint32_t spawn_degree_;
+  mutable std::atomic<bool> stop_{false};
+};
+
+/// Match pattern in pg, calling visit(match, order) with every match, where
+/// match.nodes holds the nodes matched to the pattern nodes in order, until
+/// it returns false
+template <typename Visit>
+katana::Result<void>
+Match(
+    katana::PropertyGraph* pg, const Pattern& pattern,
+    const PatternMatchingPlan& plan, Visit visit) {
+  BiDirGraphView graph = pg->BuildView<BiDirGraphView>();
+  CompiledPattern compiled = KATANA_CHECKED(Compile(*pg, graph, pattern));
+  if (compiled.unmatchable) {
+    return katana::ResultSuccess();
+  }
+  Matcher matcher(graph, compiled, plan.spawn_degree());
+  auto visit_match = [&](const PartialMatch& m) {
+    return visit(m, compiled.order);
+  };
+
+  katana::InsertBag<PartialMatch> roots;
+  katana::do_all(
+      katana::iterate(graph.Nodes()),
+      [&](Node n) {
+        if (matcher.IsCandidate(0, n)) {
+          PartialMatch root;
+          root.nodes[0] = n;
+          root.size = 1;
+          roots.push(root);
+        }
+      },
+      katana::no_stats(), katana::loopname("PatternMatching Roots"));
+
+  katana::PerThreadStorage<Scratch> scratch;
+  katana::for_each(
+      katana::iterate(roots),
+      [&](const PartialMatch& m, auto& ctx) {
+        auto push = [&](const PartialMatch& child) { ctx.push(child); };
+        matcher.Expand(m, scratch.getLocal(), visit_match, push);
+      },
+      katana::disable_conflict_detection(),
+      katana::loopname("PatternMatching"));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+CheckAlgorithm(const PatternMatchingPlan& plan) {
+  if (plan.algorithm() != PatternMatchingPlan::kGenericJoin) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown pattern matching plan");
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<uint64_t>
+katana::analytics::CountPatternMatches(
+    katana::PropertyGraph* pg, const Pattern& pattern,
+    PatternMatchingPlan plan) {
+  KATANA_CHECKED(CheckAlgorithm(plan));
+  katana::GAccumulator<uint64_t> num_matches;
+  auto visit = [&](const PartialMatch&, const std::vector<uint32_t>&) {
+    num_matches += 1;
+    return true;
+  };
+  KATANA_CHECKED(Match(pg, pattern, plan, visit));
+  return num_matches.reduce();
+}
+
+katana::Result<void>
+katana::analytics::ForEachPatternMatch(
+    katana::PropertyGraph* pg, const Pattern& pattern,
+    const std::function<void(const std::vector<katana::PropertyGraph::Node>&)>&
+        callback,
+    PatternMatchingPlan plan) {
+  KATANA_CHECKED(CheckAlgorithm(plan));
+  // the match in pattern order, for each thread
+  katana::PerThreadStorage<std::vector<katana::PropertyGraph::Node>> matches;
+  auto visit = [&](const PartialMatch& m, const std::vector<uint32_t>& order) {
+    std::vector<katana::PropertyGraph::Node>& match = *matches.getLocal();
+    match.resize(m.size);
+    for (uint32_t i = 0; i < m.size; ++i) {
+      match[order[i]] = m.nodes[i];
+    }
+    callback(match);
+    return true;
+  };
+  return Match(pg, pattern, plan, visit);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::analytics::FindPatternMatches(
+    katana::PropertyGraph* pg, const Pattern& pattern, uint64_t max_matches,
+    PatternMatchingPlan plan) {
+  KATANA_CHECKED(CheckAlgorithm(plan));
+  // matches in pattern order, one after the other, for each thread
+  katana::PerThreadStorage<std::vector<Node>> found;
+  std::atomic<uint64_t> num_found{0};
+  auto visit = [&](const PartialMatch& m, const std::vector<uint32_t>& order) {
+    if (num_found.fetch_add(1, std::memory_order_relaxed) >= max_matches) {
+      return false;
+    }
+    std::vector<Node>& mine = *found.getLocal();
+    size_t begin = mine.size();
+    mine.resize(begin + m.size);
+    for (uint32_t i = 0; i < m.size; ++i) {
+      mine[begin + order[i]] = m.nodes[i];
+    }
+    return true;
+  };
+  KATANA_CHECKED(Match(pg, pattern, plan, visit));
+
+  uint32_t num_nodes = pattern.nodes.size();
+  std::vector<arrow::UInt32Builder> builders(num_nodes);
+  for (unsigned t = 0; t < found.size(); ++t) {
+    const std::vector<Node>& mine = *found.getRemote(t);
+    for (size_t i = 0; i < mine.size(); ++i) {
+      KATANA_CHECKED(builders[i % num_nodes].Append(mine[i]));
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    std::string name = pattern.nodes[n].name.empty()
+                           ? fmt::format("node_{}", n)
+                           : pattern.nodes[n].name;
+    fields.emplace_back(arrow::field(name, arrow::uint32()));
+    columns.emplace_back(KATANA_CHECKED(builders[n].Finish()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
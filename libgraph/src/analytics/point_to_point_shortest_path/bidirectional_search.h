@@ -0,0 +1,382 @@
+#ifndef KATANA_LIBGRAPH_ANALYTICS_POINTTOPOINTSHORTESTPATH_BIDIRECTIONALSEARCH_H_
+#define KATANA_LIBGRAPH_ANALYTICS_POINTTOPOINTSHORTESTPATH_BIDIRECTIONALSEARCH_H_
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+
+/// The search from both ends of a path that answers point-to-point shortest
+/// path queries, shared by the analytics that find shortest paths between
+/// pairs of nodes
+namespace katana::analytics::internal {
+
+using BiDirGraphView = katana::PropertyGraphViews::BiDirectional;
+using Node = BiDirGraphView::Node;
+using Edge = BiDirGraphView::Edge;
+
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+/// Searches run forward from the source along out-edges and backward from
+/// the target along in-edges
+enum Side { kForward = 0, kBackward = 1 };
+
+/// The weight of each edge, once in the order of the out-edges and once in
+/// the order of the in-edges, so that the searches in both directions read
+/// the weights in the order they scan the edges
+struct EdgeWeights {
+  katana::NUMAArray<double> out;
+  katana::NUMAArray<double> in;
+};
+
+/// The distances between each node and each landmark, laid out by node so
+/// that the bounds of a node are computed from one row
+struct Landmarks {
+  uint32_t num{};
+  /// from[v * num + i]: the distance from landmark i to v
+  katana::NUMAArray<double> from;
+  /// to[v * num + i]: the distance from v to landmark i
+  katana::NUMAArray<double> to;
+
+  /// A lower bound on the distance from u to v by the triangle inequality,
+  /// infinity if some landmark shows there is no path. A landmark that does
+  /// not reach u, or that v does not reach, bounds nothing.
+  double LowerBound(Node u, Node v) const {
+    const double* from_u = from.data() + static_cast<size_t>(u) * num;
+    const double* from_v = from.data() + static_cast<size_t>(v) * num;
+    const double* to_u = to.data() + static_cast<size_t>(u) * num;
+    const double* to_v = to.data() + static_cast<size_t>(v) * num;
+    double bound = 0;
+    for (uint32_t i = 0; i < num; ++i) {
+      if (from_u[i] != kInfinity) {
+        bound = std::max(bound, from_v[i] - from_u[i]);
+      }
+      if (to_v[i] != kInfinity) {
+        bound = std::max(bound, to_u[i] - to_v[i]);
+      }
+    }
+    return bound;
+  }
+};
+
+struct HeapItem {
+  double key;
+  double dist;
+  Node node;
+
+  bool operator>(const HeapItem& other) const { return key > other.key; }
+};
+
+/// The state of a node in the query a thread is answering. A node belongs
+/// to the current query only if its epoch is that of the query, so nothing
+/// has to be cleared between queries.
+struct NodeState {
+  uint32_t epoch{};
+  /// The distance from the source and the distance to the target found so
+  /// far
+  double dist[2];
+  /// The potential of the node, NaN if not computed yet
+  double potential;
+  /// The neighbor through which each search reached the node at dist, the
+  /// node itself at the ends
+  Node parent[2];
+};
+
+/// The per-thread scratch memory of the queries
+struct QueryScratch {
+  std::vector<NodeState> nodes;
+  uint32_t epoch{};
+  std::vector<HeapItem> heaps[2];
+  std::vector<Node> frontiers[2];
+  std::vector<Node> next;
+};
+
+/// The parts of the graph a search must not use
+struct SearchExclusions {
+  /// The nodes no path may pass through
+  const katana::DynamicBitset* nodes{};
+  /// The edges from src to each of dsts
+  Node src{};
+  std::vector<Node> dsts;
+
+  bool ExcludesEdge(Node from, Node to) const {
+    return from == src &&
+           std::find(dsts.begin(), dsts.end(), to) != dsts.end();
+  }
+};
+
+/// A search from both ends of one query
+class BidirectionalSearch {
+  const BiDirGraphView& graph_;
+  const EdgeWeights* weights_;
+  const Landmarks* landmarks_;
+  QueryScratch& scratch_;
+  Node source_;
+  Node target_;
+  const SearchExclusions* exclusions_{};
+  uint64_t settled_{};
+  /// The node where the best path found by Dijkstra meets
+  Node meet_{};
+
+  NodeState& State(Node node) {
+    NodeState& state = scratch_.nodes[node];
+    if (state.epoch != scratch_.epoch) {
+      state.epoch = scratch_.epoch;
+      state.dist[kForward] = kInfinity;
+      state.dist[kBackward] = kInfinity;
+      state.potential = std::numeric_limits<double>::quiet_NaN();
+    }
+    return state;
+  }
+
+  /// \returns true if the search from side may not go from node to
+  /// neighbor
+  bool Excludes(Side side, Node node, Node neighbor) const {
+    if (!exclusions_) {
+      return false;
+    }
+    if (exclusions_->nodes && exclusions_->nodes->test(neighbor)) {
+      return true;
+    }
+    return side == kForward ? exclusions_->ExcludesEdge(node, neighbor)
+                            : exclusions_->ExcludesEdge(neighbor, node);
+  }
+
+  /// The average of the forward potential, a lower bound on the distance to
+  /// the target, and the negated backward one, a lower bound on the
+  /// distance from the source: it keeps the reduced edge lengths
+  /// non-negative in both searches, so each search is Dijkstra on the
+  /// reduced lengths. Infinity when a bound shows no path through the node.
+  double Potential(NodeState& state, Node node) {
+    if (std::isnan(state.potential)) {
+      double to_target = landmarks_->LowerBound(node, target_);
+      double from_source = landmarks_->LowerBound(source_, node);
+      state.potential = (to_target == kInfinity || from_source == kInfinity)
+                            ? kInfinity
+                            : (to_target - from_source) / 2;
+    }
+    return state.potential;
+  }
+
+  /// The key of a node reached at dist by a search, infinity if the node
+  /// cannot lie on a path from the source to the target
+  double Key(Side side, NodeState& state, Node node, double dist) {
+    if (!landmarks_) {
+      return dist;
+    }
+    double potential = Potential(state, node);
+    if (potential == kInfinity) {
+      return kInfinity;
+    }
+    return side == kForward ? dist + potential : dist - potential;
+  }
+
+  void Push(Side side, double key, double dist, Node node) {
+    auto& heap = scratch_.heaps[side];
+    heap.push_back(HeapItem{key, dist, node});
+    std::push_heap(heap.begin(), heap.end(), std::greater<HeapItem>{});
+  }
+
+  template <typename Fn>
+  void ForEachNeighbor(Side side, Node node, const Fn& fn) {
+    if (side == kForward) {
+      for (Edge e : graph_.OutEdges(node)) {
+        Node neighbor = graph_.OutEdgeDst(e);
+        if (!Excludes(side, node, neighbor)) {
+          fn(neighbor, weights_ ? weights_->out[e] : 1.0);
+        }
+      }
+    } else {
+      for (Edge e : graph_.InEdges(node)) {
+        Node neighbor = graph_.InEdgeSrc(e);
+        if (!Excludes(side, node, neighbor)) {
+          fn(neighbor, weights_ ? weights_->in[e] : 1.0);
+        }
+      }
+    }
+  }
+
+public:
+  BidirectionalSearch(
+      const BiDirGraphView& graph, const EdgeWeights* weights,
+      const Landmarks* landmarks, QueryScratch& scratch, Node source,
+      Node target)
+      : graph_(graph),
+        weights_(weights),
+        landmarks_(landmarks),
+        scratch_(scratch),
+        source_(source),
+        target_(target) {
+    if (scratch_.nodes.size() != graph.NumNodes()) {
+      scratch_.nodes.assign(graph.NumNodes(), NodeState{});
+      scratch_.epoch = 0;
+    }
+    if (++scratch_.epoch == 0) {
+      std::fill(scratch_.nodes.begin(), scratch_.nodes.end(), NodeState{});
+      scratch_.epoch = 1;
+    }
+  }
+
+  uint64_t settled() const { return settled_; }
+
+  /// Keep later searches off the parts of the graph in exclusions, which
+  /// must outlive them. Only Dijkstra records paths.
+  void Exclude(const SearchExclusions* exclusions) {
+    exclusions_ = exclusions;
+  }
+
+  /// Dijkstra from both ends, choosing the side with the smaller heap at
+  /// each step. The best path found through an edge scanned by either
+  /// search is a shortest path once the least keys of the two heaps add up
+  /// to its length; with potentials the keys are shifted by the same amount
+  /// in both searches, so the same test holds.
+  double Dijkstra() {
+    if (source_ == target_) {
+      NodeState& state = State(source_);
+      state.dist[kForward] = 0;
+      state.dist[kBackward] = 0;
+      state.parent[kForward] = source_;
+      state.parent[kBackward] = source_;
+      meet_ = source_;
+      return 0;
+    }
+    auto& heaps = scratch_.heaps;
+    heaps[kForward].clear();
+    heaps[kBackward].clear();
+
+    NodeState& source_state = State(source_);
+    double source_key = Key(kForward, source_state, source_, 0);
+    if (source_key == kInfinity) {
+      return kInfinity;
+    }
+    source_state.dist[kForward] = 0;
+    source_state.parent[kForward] = source_;
+    Push(kForward, source_key, 0, source_);
+    NodeState& target_state = State(target_);
+    target_state.dist[kBackward] = 0;
+    target_state.parent[kBackward] = target_;
+    Push(kBackward, Key(kBackward, target_state, target_, 0), 0, target_);
+
+    double best = kInfinity;
+    while (!heaps[kForward].empty() && !heaps[kBackward].empty()) {
+      if (heaps[kForward].front().key + heaps[kBackward].front().key >= best) {
+        break;
+      }
+      Side side = heaps[kForward].size() <= heaps[kBackward].size()
+                      ? kForward
+                      : kBackward;
+      Side other = side == kForward ? kBackward : kForward;
+      auto& heap = heaps[side];
+      std::pop_heap(heap.begin(), heap.end(), std::greater<HeapItem>{});
+      HeapItem item = heap.back();
+      heap.pop_back();
+      if (item.dist > State(item.node).dist[side]) {
+        continue;
+      }
+      ++settled_;
+      ForEachNeighbor(side, item.node, [&](Node neighbor, double weight) {
+        double dist = item.dist + weight;
+        NodeState& state = State(neighbor);
+        if (!(dist < state.dist[side])) {
+          return;
+        }
+        double key = Key(side, state, neighbor, dist);
+        if (key == kInfinity) {
+          return;
+        }
+        state.dist[side] = dist;
+        state.parent[side] = item.node;
+        Push(side, key, dist, neighbor);
+        if (dist + state.dist[other] < best) {
+          best = dist + state.dist[other];
+          meet_ = neighbor;
+        }
+      });
+    }
+    return best;
+  }
+
+  /// The nodes of the shortest path the last call to Dijkstra found, from
+  /// the source to the target, and the distance of each from the source.
+  /// The path must exist.
+  void Path(std::vector<Node>* nodes, std::vector<double>* dists) {
+    nodes->clear();
+    dists->clear();
+    for (Node n = meet_;; n = State(n).parent[kForward]) {
+      nodes->push_back(n);
+      dists->push_back(State(n).dist[kForward]);
+      if (n == source_) {
+        break;
+      }
+    }
+    std::reverse(nodes->begin(), nodes->end());
+    std::reverse(dists->begin(), dists->end());
+    double length = State(meet_).dist[kForward] + State(meet_).dist[kBackward];
+    for (Node n = meet_; n != target_;) {
+      n = State(n).parent[kBackward];
+      nodes->push_back(n);
+      dists->push_back(length - State(n).dist[kBackward]);
+    }
+  }
+
+  /// Breadth-first search from both ends, expanding a level of the smaller
+  /// frontier at a time. Until the searches meet, every path is longer than
+  /// the sum of their depths, so the first meeting closes a shortest path.
+  double Bfs() {
+    if (source_ == target_) {
+      return 0;
+    }
+    auto& frontiers = scratch_.frontiers;
+    auto& next = scratch_.next;
+    frontiers[kForward].assign(1, source_);
+    frontiers[kBackward].assign(1, target_);
+    State(source_).dist[kForward] = 0;
+    State(target_).dist[kBackward] = 0;
+
+    double depths[2] = {0, 0};
+    while (!frontiers[kForward].empty() && !frontiers[kBackward].empty()) {
+      Side side = frontiers[kForward].size() <= frontiers[kBackward].size()
+                      ? kForward
+                      : kBackward;
+      Side other = side == kForward ? kBackward : kForward;
+      double depth = depths[side] + 1;
+      double met = kInfinity;
+      next.clear();
+      for (Node node : frontiers[side]) {
+        ++settled_;
+        ForEachNeighbor(side, node, [&](Node neighbor, double) {
+          NodeState& state = State(neighbor);
+          if (state.dist[side] != kInfinity) {
+            return;
+          }
+          state.dist[side] = depth;
+          met = std::min(met, depth + state.dist[other]);
+          next.push_back(neighbor);
+        });
+        if (met != kInfinity) {
+          return met;
+        }
+      }
+      std::swap(frontiers[side], next);
+      depths[side] = depth;
+    }
+    return kInfinity;
+  }
+};
+
+/// \returns the weights of the edges of graph from the property name of pg,
+/// or all 1 if name is empty
+katana::Result<EdgeWeights> ReadEdgeWeights(
+    katana::PropertyGraph* pg, const BiDirGraphView& graph,
+    const std::string& name);
+
+}  // namespace katana::analytics::internal
+
+#endif
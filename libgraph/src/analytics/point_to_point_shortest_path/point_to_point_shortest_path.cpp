@@ -0,0 +1,340 @@
+#include "katana/analytics/point_to_point_shortest_path/point_to_point_shortest_path.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+
+#include <arrow/compute/api.h>
+
+#include "bidirectional_search.h"
+#include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+using namespace katana::analytics::internal;
+
+katana::Result<EdgeWeights>
+katana::analytics::internal::ReadEdgeWeights(
+    katana::PropertyGraph* pg, const BiDirGraphView& graph,
+    const std::string& name) {
+  EdgeWeights weights;
+  weights.out.allocateBlocked(graph.NumEdges());
+  weights.in.allocateBlocked(graph.NumEdges());
+  if (name.empty()) {
+    katana::ParallelSTL::fill(weights.out.begin(), weights.out.end(), 1.0);
+    katana::ParallelSTL::fill(weights.in.begin(), weights.in.end(), 1.0);
+    return weights;
+  }
+
+  std::shared_ptr<arrow::ChunkedArray> property =
+      KATANA_CHECKED(pg->GetEdgeProperty(name));
+  if (!arrow::is_integer(property->type()->id()) &&
+      !arrow::is_floating(property->type()->id())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "unsupported edge weight type: {}",
+        property->type()->ToString());
+  }
+  arrow::Datum cast =
+      KATANA_CHECKED(arrow::compute::Cast(property, arrow::float64()));
+
+  // A null weight leaves its edge out of every path
+  katana::NUMAArray<double> by_property;
+  by_property.allocateBlocked(property->length());
+  katana::GReduceLogicalOr negative;
+  int64_t offset = 0;
+  for (const auto& chunk : cast.chunked_array()->chunks()) {
+    auto values = std::static_pointer_cast<arrow::DoubleArray>(chunk);
+    katana::do_all(
+        katana::iterate(int64_t{0}, values->length()),
+        [&](int64_t i) {
+          double w = values->IsNull(i) ? kInfinity : values->Value(i);
+          if (!(w >= 0)) {
+            negative.update(true);
+          }
+          by_property[offset + i] = w;
+        },
+        katana::no_stats());
+    offset += values->length();
+  }
+  if (negative.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge weights in {} must not be negative or NaN", name);
+  }
+
+  katana::do_all(
+      katana::iterate(Edge{0}, Edge{graph.NumEdges()}),
+      [&](Edge e) {
+        weights.out[e] = by_property[graph.GetEdgePropertyIndexFromOutEdge(e)];
+        weights.in[e] = by_property[graph.GetEdgePropertyIndexFromInEdge(e)];
+      },
+      katana::no_stats());
+  return weights;
+}
+
+namespace {
+
+std::string
+LandmarkPropertyName(
+    const std::string& prefix, const char* direction, uint32_t landmark) {
+  return prefix + direction + std::to_string(landmark);
+}
+
+katana::Result<void>
+ReadLandmarkDistances(
+    katana::PropertyGraph* pg, const std::string& name, uint32_t landmark,
+    uint32_t num, katana::NUMAArray<double>* distances) {
+  std::shared_ptr<arrow::ChunkedArray> property =
+      KATANA_CHECKED(pg->GetNodeProperty(name));
+  if (property->type()->id() != arrow::Type::DOUBLE) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "landmark distances {} must be double, not {}", name,
+        property->type()->ToString());
+  }
+  int64_t offset = 0;
+  for (const auto& chunk : property->chunks()) {
+    auto values = std::static_pointer_cast<arrow::DoubleArray>(chunk);
+    katana::do_all(
+        katana::iterate(int64_t{0}, values->length()),
+        [&](int64_t i) {
+          (*distances)[(offset + i) * num + landmark] =
+              values->IsNull(i) ? kInfinity : values->Value(i);
+        },
+        katana::no_stats());
+    offset += values->length();
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<Landmarks>
+ReadLandmarks(
+    katana::PropertyGraph* pg, const std::string& prefix, uint32_t num) {
+  Landmarks landmarks;
+  landmarks.num = num;
+  landmarks.from.allocateBlocked(static_cast<size_t>(pg->NumNodes()) * num);
+  landmarks.to.allocateBlocked(static_cast<size_t>(pg->NumNodes()) * num);
+  for (uint32_t i = 0; i < num; ++i) {
+    KATANA_CHECKED(ReadLandmarkDistances(
+        pg, LandmarkPropertyName(prefix, "_from_", i), i, num,
+        &landmarks.from));
+    KATANA_CHECKED(ReadLandmarkDistances(
+        pg, LandmarkPropertyName(prefix, "_to_", i), i, num, &landmarks.to));
+  }
+  return landmarks;
+}
+
+/// Dijkstra from source over the whole graph, along out-edges if side is
+/// kForward and along in-edges otherwise
+void
+SingleSourceDijkstra(
+    const BiDirGraphView& graph, const EdgeWeights& weights, Node source,
+    Side side, double* dist) {
+  std::fill(dist, dist + graph.NumNodes(), kInfinity);
+  std::vector<HeapItem> heap;
+  dist[source] = 0;
+  heap.push_back(HeapItem{0, 0, source});
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), std::greater<HeapItem>{});
+    HeapItem item = heap.back();
+    heap.pop_back();
+    if (item.dist > dist[item.node]) {
+      continue;
+    }
+    auto relax = [&](Node neighbor, double weight) {
+      double d = item.dist + weight;
+      if (d < dist[neighbor]) {
+        dist[neighbor] = d;
+        heap.push_back(HeapItem{d, d, neighbor});
+        std::push_heap(heap.begin(), heap.end(), std::greater<HeapItem>{});
+      }
+    };
+    if (side == kForward) {
+      for (Edge e : graph.OutEdges(item.node)) {
+        relax(graph.OutEdgeDst(e), weights.out[e]);
+      }
+    } else {
+      for (Edge e : graph.InEdges(item.node)) {
+        relax(graph.InEdgeSrc(e), weights.in[e]);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+katana::Result<std::vector<uint32_t>>
+katana::analytics::ShortestPathLandmarks(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    uint32_t num_landmarks, const std::string& output_property_prefix,
+    katana::TxnContext* txn_ctx) {
+  if (num_landmarks == 0 || num_landmarks > pg->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the number of landmarks {} must be between 1 and the number of "
+        "nodes {}",
+        num_landmarks, pg->NumNodes());
+  }
+  katana::StatTimer exec_time("ShortestPathLandmarks");
+  katana::TimerGuard guard(exec_time);
+
+  BiDirGraphView graph = pg->BuildView<BiDirGraphView>();
+  EdgeWeights weights =
+      KATANA_CHECKED(ReadEdgeWeights(pg, graph, edge_weight_property_name));
+
+  size_t num_nodes = graph.NumNodes();
+  // the distances are computed in place in the arrays of the properties
+  using DistanceBuilder =
+      katana::ArrowRandomAccessBuilder<arrow::DoubleType, false>;
+  std::vector<DistanceBuilder> distances;
+  distances.reserve(2 * num_landmarks);
+  // Of the nodes some landmark reaches or is reached from, the least sum of
+  // the finite distances to and from a landmark
+  std::vector<double> closeness(num_nodes, kInfinity);
+  katana::DynamicBitset covered;
+  covered.resize(num_nodes);
+  katana::DynamicBitset is_landmark;
+  is_landmark.resize(num_nodes);
+  std::vector<uint32_t> landmarks;
+
+  auto degree = [&](Node node) {
+    return graph.OutDegree(node) + graph.InDegree(node);
+  };
+
+  while (landmarks.size() < num_landmarks) {
+    // Prefer a node no landmark covers, among those with edges, so that
+    // each component of the graph gets a landmark
+    size_t landmark = num_nodes;
+    for (Node node = 0; node < num_nodes; ++node) {
+      if (!covered.test(node) && degree(node) > 0 &&
+          (landmark == num_nodes || degree(node) > degree(landmark))) {
+        landmark = node;
+      }
+    }
+    if (landmark == num_nodes) {
+      for (Node node = 0; node < num_nodes; ++node) {
+        if (is_landmark.test(node)) {
+          continue;
+        }
+        if (landmark == num_nodes || closeness[node] > closeness[landmark]) {
+          landmark = node;
+        }
+      }
+    }
+
+    landmarks.push_back(landmark);
+    is_landmark.set(landmark);
+    DistanceBuilder& from = distances.emplace_back(num_nodes);
+    DistanceBuilder& to = distances.emplace_back(num_nodes);
+    katana::do_all(
+        katana::iterate(0, 2),
+        [&](int side) {
+          SingleSourceDijkstra(
+              graph, weights, landmark, side == 0 ? kForward : kBackward,
+              side == 0 ? from.data() : to.data());
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("ShortestPathLandmarks-Dijkstra"));
+
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t node) {
+          if (from[node] == kInfinity && to[node] == kInfinity) {
+            return;
+          }
+          double sum = (from[node] == kInfinity ? 0 : from[node]) +
+                       (to[node] == kInfinity ? 0 : to[node]);
+          closeness[node] = std::min(closeness[node], sum);
+        },
+        katana::no_stats());
+    for (size_t node = 0; node < num_nodes; ++node) {
+      if (closeness[node] != kInfinity) {
+        covered.set(node);
+      }
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (uint32_t i = 0; i < num_landmarks; ++i) {
+    for (int side = 0; side < 2; ++side) {
+      std::shared_ptr<arrow::Array> column =
+          KATANA_CHECKED(distances[2 * i + side].Finalize());
+      fields.emplace_back(arrow::field(
+          LandmarkPropertyName(
+              output_property_prefix, side == 0 ? "_from_" : "_to_", i),
+          arrow::float64()));
+      columns.emplace_back(std::move(column));
+    }
+  }
+  KATANA_CHECKED(pg->AddNodeProperties(
+      arrow::Table::Make(arrow::schema(fields), columns), txn_ctx));
+  return landmarks;
+}
+
+katana::Result<std::vector<double>>
+katana::analytics::PointToPointShortestPaths(
+    PropertyGraph* pg,
+    const std::vector<std::pair<uint32_t, uint32_t>>& queries,
+    const std::string& edge_weight_property_name,
+    PointToPointShortestPathPlan plan) {
+  for (const auto& [source, target] : queries) {
+    if (source >= pg->NumNodes() || target >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "query ({}, {}) is not a pair of nodes", source, target);
+    }
+  }
+  if (plan.algorithm() == PointToPointShortestPathPlan::kAlt &&
+      plan.num_landmarks() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the ALT algorithm needs at least one landmark");
+  }
+  katana::StatTimer exec_time("PointToPointShortestPaths");
+  katana::TimerGuard guard(exec_time);
+
+  BiDirGraphView graph = pg->BuildView<BiDirGraphView>();
+  std::optional<EdgeWeights> weights;
+  if (plan.algorithm() != PointToPointShortestPathPlan::kBidirectionalBfs) {
+    weights =
+        KATANA_CHECKED(ReadEdgeWeights(pg, graph, edge_weight_property_name));
+  }
+  std::optional<Landmarks> landmarks;
+  if (plan.algorithm() == PointToPointShortestPathPlan::kAlt) {
+    landmarks = KATANA_CHECKED(ReadLandmarks(
+        pg, plan.landmark_property_prefix(), plan.num_landmarks()));
+  }
+
+  std::vector<double> distances(queries.size());
+  katana::PerThreadStorage<QueryScratch> scratch;
+  katana::GAccumulator<uint64_t> settled;
+  katana::do_all(
+      katana::iterate(size_t{0}, queries.size()),
+      [&](size_t q) {
+        BidirectionalSearch search(
+            graph, weights ? &*weights : nullptr,
+            landmarks ? &*landmarks : nullptr, *scratch.getLocal(),
+            queries[q].first, queries[q].second);
+        distances[q] =
+            plan.algorithm() == PointToPointShortestPathPlan::kBidirectionalBfs
+                ? search.Bfs()
+                : search.Dijkstra();
+        settled += search.settled();
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("PointToPointShortestPaths"));
+  katana::ReportStatSingle(
+      "PointToPointShortestPaths", "SettledNodes", settled.reduce());
+  return distances;
+}
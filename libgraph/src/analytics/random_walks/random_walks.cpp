@@ -19,7 +19,21 @@
 
 #include "katana/analytics/random_walks/random_walks.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+#include <arrow/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/JSON.h"
+#include "katana/ParquetWriter.h"
+#include "katana/Reduction.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/WriteGroup.h"
+#include "katana/file.h"
+#include "walk_random.h"
 
 using namespace katana::analytics;
 
@@ -29,499 +43,748 @@ namespace {
 
 using SortedPropertyGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 
-struct Node2VecAlgo {
-  using NodeData = std::tuple<>;
-  using EdgeData = std::tuple<>;
+/// Walks of each node are in chunks of this many
+constexpr static const unsigned kWalkChunkSize = 64;
 
-  using SortedGraphView = katana::TypedPropertyGraphView<
-      SortedPropertyGraphView, NodeData, EdgeData>;
-  using GNode = typename SortedGraphView::Node;
+using katana::analytics::internal::WalkRandom;
 
-  const RandomWalksPlan& plan_;
-  Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
+/// Alias tables (Vose, 1991) of the weighted edges of each node: the edge
+/// at index i of a node is taken with probability prob[e] and otherwise the
+/// edge at index alias[e] of the node, where e is the edge at index i, for
+/// an index i drawn uniformly
+struct AliasTables {
+  katana::NUMAArray<float> prob;
+  katana::NUMAArray<uint32_t> alias;
+};
 
-  GNode FindSampleNeighbor(
-      const SortedGraphView& graph, const GNode& n,
-      const katana::NUMAArray<uint64_t>& degree, const double prob) {
-    if (degree[n] == 0) {
-      return graph.NumNodes();
-    }
-    double total_wt = degree[n];
+/// num_walks walks of at most stride nodes; walk i is the first lengths[i]
+/// nodes of steps[i * stride, (i + 1) * stride)
+struct FlatWalks {
+  uint64_t stride{};
+  uint64_t num_walks{};
+  katana::NUMAArray<uint32_t> steps;
+  katana::NUMAArray<uint32_t> lengths;
+};
 
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto ei = graph.OutEdges(n).begin() + edge_index;
-    return graph.OutEdgeDst(*ei);
+template <typename Weight>
+struct EdgeWeight : public katana::PODProperty<Weight> {};
+
+using UnweightedGraphView = katana::TypedPropertyGraphView<
+    SortedPropertyGraphView, std::tuple<>, std::tuple<>>;
+
+template <typename Weight>
+using WeightedGraphView = katana::TypedPropertyGraphView<
+    SortedPropertyGraphView, std::tuple<>, std::tuple<EdgeWeight<Weight>>>;
+
+template <typename Weight>
+katana::Result<AliasTables>
+BuildAliasTables(const WeightedGraphView<Weight>& graph) {
+  using Node = typename WeightedGraphView<Weight>::Node;
+  struct Scratch {
+    std::vector<double> scaled;
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+  };
+
+  AliasTables tables;
+  tables.prob.allocateBlocked(graph.NumEdges());
+  tables.alias.allocateBlocked(graph.NumEdges());
+  katana::PerThreadStorage<Scratch> scratch;
+  katana::GReduceLogicalOr negative;
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) {
+        auto edges = graph.OutEdges(n);
+        uint64_t begin = *edges.begin();
+        uint32_t degree = edges.size();
+        Scratch& local = *scratch.getLocal();
+        local.scaled.clear();
+        double total = 0;
+        for (auto e : edges) {
+          double weight = graph.template GetEdgeData<EdgeWeight<Weight>>(e);
+          negative.update(!(weight >= 0));
+          local.scaled.emplace_back(weight);
+          total += weight;
+        }
+
+        float* prob = &tables.prob[begin];
+        uint32_t* alias = &tables.alias[begin];
+        local.small.clear();
+        local.large.clear();
+        for (uint32_t i = 0; i < degree; ++i) {
+          // Nodes whose edges all weigh 0 take them uniformly
+          local.scaled[i] = total > 0 ? local.scaled[i] * degree / total : 1;
+          (local.scaled[i] < 1 ? local.small : local.large).emplace_back(i);
+        }
+        while (!local.small.empty() && !local.large.empty()) {
+          uint32_t less = local.small.back();
+          uint32_t more = local.large.back();
+          local.small.pop_back();
+          local.large.pop_back();
+          prob[less] = local.scaled[less];
+          alias[less] = more;
+          local.scaled[more] += local.scaled[less] - 1;
+          (local.scaled[more] < 1 ? local.small : local.large)
+              .emplace_back(more);
+        }
+        // What remains is 1 up to rounding
+        for (const auto* rest : {&local.small, &local.large}) {
+          for (uint32_t i : *rest) {
+            prob[i] = 1;
+            alias[i] = i;
+          }
+        }
+      },
+      katana::steal(), katana::loopname("RandomWalks_AliasTables"));
+
+  if (negative.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge weights must be non-negative numbers");
   }
+  return tables;
+}
 
-  void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
-
-    double prob_forward = 1.0 / plan_.forward_probability();
-    double prob_backward = 1.0 / plan_.backward_probability();
-
-    double upper_bound = 1.0;
-
-    upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
-    upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
-
-    double lower_bound = 1.0;
-
-    lower_bound = (lower_bound < prob_forward) ? lower_bound : prob_forward;
-    lower_bound = (lower_bound < prob_backward) ? lower_bound : prob_backward;
-
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
+katana::Result<void>
+ValidateProbabilities(const RandomWalksPlan& plan) {
+  if (!(plan.backward_probability() > 0 && plan.forward_probability() > 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "backward probability {} and forward probability {} must be positive",
+        plan.backward_probability(), plan.forward_probability());
+  }
+  return katana::ResultSuccess();
+}
 
-    katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
-        [&](uint64_t idx) {
-          GNode n = idx % graph.size();
+katana::Result<void>
+ValidateNode2Vec(const RandomWalksPlan& plan) {
+  if (plan.algorithm() != RandomWalksPlan::kNode2Vec) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "only node2vec walks can be flat or streamed");
+  }
+  return ValidateProbabilities(plan);
+}
 
-          //check if n has no neighbor
-          if (degree[n] == 0) {
-            return;
+/// Node2vec walks first_walk to first_walk + walks->num_walks of plan,
+/// following Grover and Leskovec, 2016, where walk i starts at node
+/// i % NumNodes(). The return (backward) and in-out (forward) biases are
+/// applied by rejection of neighbors drawn uniformly or, with aliases, by
+/// edge weight.
+template <typename Graph>
+void
+Node2VecWalks(
+    const Graph& graph, const AliasTables* aliases,
+    const RandomWalksPlan& plan, uint64_t first_walk, FlatWalks* walks) {
+  using Node = typename Graph::Node;
+  double prob_forward = 1.0 / plan.forward_probability();
+  double prob_backward = 1.0 / plan.backward_probability();
+  double upper_bound = std::max({1.0, prob_forward, prob_backward});
+  double lower_bound = std::min({1.0, prob_forward, prob_backward});
+
+  auto sample = [&](Node n, WalkRandom* random) -> Node {
+    uint64_t i = random->Below(graph.OutDegree(n));
+    if (aliases) {
+      uint64_t e = *graph.OutEdges(n).begin() + i;
+      if (random->Uniform() >= aliases->prob[e]) {
+        i = aliases->alias[e];
+      }
+    }
+    return graph.OutEdgeDsts(n)[i];
+  };
+  auto has_edge = [&](Node src, Node dst) {
+    const Node* dsts = graph.OutEdgeDsts(src);
+    return std::binary_search(dsts, dsts + graph.OutDegree(src), dst);
+  };
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, walks->num_walks),
+      [&](uint64_t i) {
+        uint64_t idx = first_walk + i;
+        Node n = idx % graph.NumNodes();
+        uint32_t* walk = &walks->steps[i * walks->stride];
+        if (graph.OutDegree(n) == 0) {
+          walks->lengths[i] = 0;
+          return;
+        }
+
+        WalkRandom random(plan.seed(), idx);
+        walk[0] = n;
+        walk[1] = sample(n, &random);
+        uint32_t length = 2;
+        for (; length < walks->stride; ++length) {
+          Node curr = walk[length - 1];
+          Node prev = walk[length - 2];
+          if (graph.OutDegree(curr) == 0) {
+            break;
           }
-
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
-
-          std::vector<uint32_t> walk;
-          walk.push_back(n);
-
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
-
-          //Assumption: All edges have weight 1
-          auto nbr = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr < graph.NumNodes());
-
-          walk.push_back(std::move(nbr));
-
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[current_walk - 1];
-            uint32_t prev = walk[current_walk - 2];
-
-            //check if n has no neighbor
-            if (degree[curr] == 0) {
+          Node next;
+          while (true) {
+            next = sample(curr, &random);
+            double y = random.Uniform() * upper_bound;
+            if (y <= lower_bound) {
               break;
             }
-            //acceptance-rejection sampling
-            while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
-
-              auto nbr = FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr < graph.NumNodes());
-
-              //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
-
-              if (y <= lower_bound) {
-                //accept this sample
-                walk.push_back(std::move(nbr));
-                break;
-              } else {
-                //compute transition probability
-                double alpha;
-
-                //check if nbr is same as the previous node on this walk
-                if (nbr == prev) {
-                  alpha = prob_backward;
-                }  //check if nbr is also a neighbor of the previous node on this walk
-                else if (graph.HasEdge(prev, nbr)) {
-                  alpha = 1.0;
-                } else {
-                  alpha = prob_forward;
-                }
-
-                if (y <= alpha) {
-                  //accept y
-                  walk.push_back(std::move(nbr));
-                  break;
-                }
-              }
+            double alpha = next == prev           ? prob_backward
+                           : has_edge(prev, next) ? 1.0
+                                                  : prob_forward;
+            if (y <= alpha) {
+              break;
             }
           }
+          walk[length] = next;
+        }
+        walks->lengths[i] = length;
+      },
+      katana::steal(), katana::chunk_size<kWalkChunkSize>(),
+      katana::loopname("Node2vec walks"), katana::no_stats());
+}
 
-          walks->push(std::move(walk));
-        },
-        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
-        katana::loopname("Node2vec walks"), katana::no_stats());
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      delete (*distribution.getRemote(i));
-    }
+/// Calls emit(walks) with the walks of plan in order, in batches of at most
+/// walks_per_batch walks that reuse the same memory
+template <typename Graph, typename Emit>
+katana::Result<void>
+ForEachWalkBatch(
+    const Graph& graph, const AliasTables* aliases,
+    const RandomWalksPlan& plan, uint64_t walks_per_batch, Emit emit) {
+  KATANA_CHECKED(ValidateNode2Vec(plan));
+  if (walks_per_batch == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "walks_per_batch must be positive");
   }
 
-  void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    GraphRandomWalk(graph, walks, degree);
+  uint64_t total_walks = graph.NumNodes() * plan.number_of_walks();
+  uint64_t capacity = std::min(total_walks, walks_per_batch);
+  FlatWalks walks;
+  // A walk always takes its first edge, even if walk_length is 0
+  walks.stride = std::max(plan.walk_length(), uint32_t{1}) + 1;
+  walks.steps.allocateBlocked(capacity * walks.stride);
+  walks.lengths.allocateBlocked(capacity);
+
+  katana::StatTimer exec_time("RandomWalks");
+  for (uint64_t first = 0; first < total_walks; first += capacity) {
+    walks.num_walks = std::min(capacity, total_walks - first);
+    exec_time.start();
+    Node2VecWalks(graph, aliases, plan, first, &walks);
+    exec_time.stop();
+    KATANA_CHECKED(emit(walks));
   }
-};
-
-struct Edge2VecAlgo {
-  using EdgeType = katana::UInt32Property;
-
-  using NodeData = std::tuple<>;
-  using EdgeData = std::tuple<EdgeType>;
-
-  using SortedGraphView = katana::TypedPropertyGraphView<
-      SortedPropertyGraphView, NodeData, EdgeData>;
-  using GNode = typename SortedGraphView::Node;
+  return katana::ResultSuccess();
+}
 
-  const RandomWalksPlan& plan_;
-  Edge2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
+/// The edge2vec transition matrix (Gao et al., 2019) between the edge types
+/// 0 to num_types - 1: bias[i * num_types + j] weighs taking an edge of type
+/// j right after an edge of type i
+struct TransitionMatrix {
+  uint32_t num_types{};
+  std::vector<double> bias;
+  double min_bias{1};
+  double max_bias{1};
 
-  //transition matrix
-  std::vector<std::vector<double>> transition_matrix_;
+  explicit TransitionMatrix(uint32_t types)
+      : num_types(types), bias(uint64_t{types} * types, 1.0) {}
 
-  void Initialize() {
-    transition_matrix_.resize(plan_.number_of_edge_types() + 1);
-    //initialize transition matrix
-    for (uint32_t i = 0; i <= plan_.number_of_edge_types(); i++) {
-      for (uint32_t j = 0; j <= plan_.number_of_edge_types(); j++) {
-        transition_matrix_[i].push_back(1.0);
-      }
-    }
+  double operator()(uint32_t prev, uint32_t next) const {
+    return bias[uint64_t{prev} * num_types + next];
   }
+};
 
-  std::pair<GNode, EdgeType::ViewType::value_type> FindSampleNeighbor(
-      const SortedGraphView& graph, const GNode& n,
-      const katana::NUMAArray<uint64_t>& degree, const double prob) {
-    if (degree[n] == 0) {
-      return std::make_pair(graph.NumNodes(), 1);
-    }
-    double total_wt = degree[n];
-
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto ei = graph.OutEdges(n).begin() + edge_index;
-    return std::make_pair(
-        graph.OutEdgeDst(*ei), graph.GetEdgeData<EdgeType>(*ei));
-  }
-
-  void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      katana::InsertBag<std::vector<uint32_t>>* types_walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
-
-    double prob_forward = 1.0 / plan_.forward_probability();
-    double prob_backward = 1.0 / plan_.backward_probability();
-
-    double upper_bound = 1.0;
-
-    upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
-    upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
-
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
-
-    katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
-        [&](uint64_t idx) {
-          GNode n = idx % graph.size();
+/// The edge2vec type of each edge of graph: its entity type in pg if that is
+/// one of 1 to max_type, and 0 otherwise
+katana::NUMAArray<uint32_t>
+Edge2VecEdgeTypes(
+    const katana::PropertyGraph& pg, const UnweightedGraphView& graph,
+    uint32_t max_type) {
+  using Node = UnweightedGraphView::Node;
+  katana::NUMAArray<uint32_t> types;
+  types.allocateBlocked(graph.NumEdges());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) {
+        for (auto e : graph.OutEdges(n)) {
+          uint32_t type = pg.GetTypeOfEdgeFromPropertyIndex(
+              graph.GetEdgePropertyIndexFromOutEdge(e));
+          types[e] = type <= max_type ? type : 0;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return types;
+}
 
-          //check if n has no neighbor
-          if (degree[n] == 0) {
-            return;
+/// Edge2vec walks of round round: node2vec walks, see Node2VecWalks, whose
+/// steps are also biased by matrix between the types of the last and the
+/// next edge. The type of the k-th edge of walk i goes to
+/// walk_types[i * (walks->stride - 1) + k].
+void
+Edge2VecWalks(
+    const UnweightedGraphView& graph,
+    const katana::NUMAArray<uint32_t>& edge_types,
+    const TransitionMatrix& matrix, const RandomWalksPlan& plan,
+    uint32_t round, FlatWalks* walks,
+    katana::NUMAArray<uint32_t>* walk_types) {
+  using Node = UnweightedGraphView::Node;
+  double prob_forward = 1.0 / plan.forward_probability();
+  double prob_backward = 1.0 / plan.backward_probability();
+  double upper_bound =
+      std::max({1.0, prob_forward, prob_backward}) * matrix.max_bias;
+  double lower_bound =
+      std::min({1.0, prob_forward, prob_backward}) * matrix.min_bias;
+
+  auto sample = [&](Node n, WalkRandom* random, uint32_t* type) -> Node {
+    uint64_t i = random->Below(graph.OutDegree(n));
+    *type = edge_types[*graph.OutEdges(n).begin() + i];
+    return graph.OutEdgeDsts(n)[i];
+  };
+  auto has_edge = [&](Node src, Node dst) {
+    const Node* dsts = graph.OutEdgeDsts(src);
+    return std::binary_search(dsts, dsts + graph.OutDegree(src), dst);
+  };
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, walks->num_walks),
+      [&](uint64_t i) {
+        Node n = i % graph.NumNodes();
+        uint32_t* walk = &walks->steps[i * walks->stride];
+        uint32_t* types = &(*walk_types)[i * (walks->stride - 1)];
+        if (graph.OutDegree(n) == 0) {
+          walks->lengths[i] = 0;
+          return;
+        }
+
+        WalkRandom random(plan.seed() + round, i);
+        walk[0] = n;
+        walk[1] = sample(n, &random, &types[0]);
+        uint32_t length = 2;
+        for (; length < walks->stride; ++length) {
+          Node curr = walk[length - 1];
+          Node prev = walk[length - 2];
+          if (graph.OutDegree(curr) == 0) {
+            break;
           }
-
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
-
-          std::vector<uint32_t> walk;
-          std::vector<uint32_t> types_vec;
-
-          walk.push_back(n);
-
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
-
-          //Assumption: All edges have weight 1
-          auto nbr_pair = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr_pair.first < graph.NumNodes());
-
-          walk.push_back(std::move(nbr_pair.first));
-          types_vec.push_back(nbr_pair.second);
-
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[walk.size() - 1];
-            //check if n has no neighbor
-            if (degree[curr] == 0) {
-              return;
+          Node next;
+          uint32_t type;
+          while (true) {
+            next = sample(curr, &random, &type);
+            double y = random.Uniform() * upper_bound;
+            if (y <= lower_bound) {
+              break;
+            }
+            double alpha = next == prev           ? prob_backward
+                           : has_edge(prev, next) ? 1.0
+                                                  : prob_forward;
+            if (y <= alpha * matrix(types[length - 2], type)) {
+              break;
             }
-            uint32_t prev = walk[walk.size() - 2];
-
-            uint32_t p1 = types_vec.back();  //last element of types_vec
-
-            //acceptance-rejection sampling
-            while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
-
-              auto nbr_type_pair =
-                  FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr_pair.first < graph.NumNodes());
-
-              GNode nbr = nbr_type_pair.first;
-              EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
-
-              //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
-
-              //compute transition probability
-              double alpha;
-
-              //check if nbr is same as the previous node on this walk
-              if (nbr == prev) {
-                alpha = prob_backward;
-              }  //check if nbr is also a neighbor of the previous node on this walk
-              else if (graph.HasEdge(prev, nbr)) {
-                alpha = 1.0;
-              } else {
-                alpha = prob_forward;
-              }
-
-              alpha = alpha * transition_matrix_[p1][p2];
-              if (alpha >= y) {
-                //accept y
-                walk.push_back(std::move(nbr));
-                types_vec.push_back(p2);
-                break;
-              }
-            }  //end while
-
-          }  //end for
-
-          (*walks).push(std::move(walk));
-          (*types_walks).push(std::move(types_vec));
-        },
-        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
-        katana::loopname("Edge2vec walks"), katana::no_stats());
-  }
-
-  //compute the histogram of edge types for each walk
-  std::vector<std::vector<uint32_t>> ComputeNumEdgeTypeVectors(
-      const katana::InsertBag<std::vector<uint32_t>>& types_walks) {
-    std::vector<std::vector<uint32_t>> num_edge_types_walks;
-
-    katana::PerThreadStorage<std::vector<std::vector<uint32_t>>>
-        per_thread_num_edge_types_walks;
-    katana::do_all(
-        katana::iterate(types_walks),
-        [&](const std::vector<uint32_t>& types_walk) {
-          std::vector<uint32_t> num_edge_types(
-              plan_.number_of_edge_types() + 1, 0);
-
-          for (auto type : types_walk) {
-            num_edge_types[type]++;
           }
+          walk[length] = next;
+          types[length - 1] = type;
+        }
+        walks->lengths[i] = length;
+      },
+      katana::steal(), katana::chunk_size<kWalkChunkSize>(),
+      katana::loopname("Edge2vec walks"), katana::no_stats());
+}
 
-          per_thread_num_edge_types_walks.getLocal()->emplace_back(
-              std::move(num_edge_types));
-        });
+/// Sets the bias between each two edge types in matrix to the sigmoid of the
+/// Pearson correlation, over walks, of the numbers of edges of either type
+/// in a walk: the update of the transition matrix by edge2vec
+void
+EstimateTransitionMatrix(
+    const FlatWalks& walks, const katana::NUMAArray<uint32_t>& walk_types,
+    TransitionMatrix* matrix) {
+  struct Sums {
+    uint64_t walks{};
+    std::vector<uint64_t> counts;
+    std::vector<uint64_t> products;
+    std::vector<uint32_t> sorted;
+    std::vector<std::pair<uint32_t, uint64_t>> runs;
+  };
+  uint32_t num_types = matrix->num_types;
+  uint64_t num_cells = uint64_t{num_types} * num_types;
+  katana::PerThreadStorage<Sums> sums;
+  // Each thread allocates its own sums, so that they are local to it
+  katana::on_each([&](unsigned, unsigned) {
+    Sums& local = *sums.getLocal();
+    local.counts.assign(num_types, 0);
+    local.products.assign(num_cells, 0);
+  });
 
-    for (unsigned j = 0; j < katana::getActiveThreads(); ++j) {
-      for (auto num_edge_types :
-           *per_thread_num_edge_types_walks.getRemote(j)) {
-        num_edge_types_walks.push_back(std::move(num_edge_types));
-      }
+  // A walk has few of the types, so it only adds to the products of the
+  // pairs of types it has rather than to all num_cells of them
+  katana::do_all(
+      katana::iterate(uint64_t{0}, walks.num_walks),
+      [&](uint64_t i) {
+        uint32_t num_edges = walks.lengths[i] > 0 ? walks.lengths[i] - 1 : 0;
+        if (num_edges == 0) {
+          return;
+        }
+        Sums& local = *sums.getLocal();
+        const uint32_t* types = &walk_types[i * (walks.stride - 1)];
+        local.sorted.assign(types, types + num_edges);
+        std::sort(local.sorted.begin(), local.sorted.end());
+        local.runs.clear();
+        for (uint32_t type : local.sorted) {
+          if (local.runs.empty() || local.runs.back().first != type) {
+            local.runs.emplace_back(type, 0);
+          }
+          ++local.runs.back().second;
+        }
+
+        ++local.walks;
+        for (const auto& [a, count_a] : local.runs) {
+          local.counts[a] += count_a;
+          uint64_t* row = &local.products[uint64_t{a} * num_types];
+          for (const auto& [b, count_b] : local.runs) {
+            row[b] += count_a * count_b;
+          }
+        }
+      },
+      katana::steal(), katana::chunk_size<kWalkChunkSize>(),
+      katana::loopname("Edge2vec type counts"), katana::no_stats());
+
+  unsigned num_threads = katana::getActiveThreads();
+  uint64_t num_walks = 0;
+  std::vector<double> means(num_types);
+  for (unsigned t = 0; t < num_threads; ++t) {
+    const Sums& remote = *sums.getRemote(t);
+    num_walks += remote.walks;
+    for (uint32_t a = 0; a < num_types; ++a) {
+      means[a] += remote.counts[a];
     }
-
-    return num_edge_types_walks;
   }
-
-  std::vector<std::vector<uint32_t>> TransformVectors(
-      const std::vector<std::vector<uint32_t>>& num_edge_types_walks) {
-    uint32_t rows = num_edge_types_walks.size();
-    std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks;
-    transformed_num_edge_types_walks.resize(plan_.number_of_edge_types() + 1);
-
-    katana::do_all(
-        katana::iterate(uint32_t(0), plan_.number_of_edge_types() + 1),
-        [&](uint32_t j) {
-          for (uint32_t i = 0; i < rows; i++) {
-            transformed_num_edge_types_walks[j].push_back(
-                num_edge_types_walks[i][j]);
-          }
-        });
-
-    return transformed_num_edge_types_walks;
+  if (num_walks == 0) {
+    return;
   }
-
-  std::vector<double> ComputeMeans(const std::vector<std::vector<uint32_t>>&
-                                       transformed_num_edge_types_walks) {
-    std::vector<double> means(plan_.number_of_edge_types() + 1);
-
-    for (uint32_t i = 1; i <= plan_.number_of_edge_types(); i++) {
-      uint32_t sum = 0;
-      for (auto n : transformed_num_edge_types_walks[i]) {
-        sum += n;
-      }
-
-      means[i] = ((double)sum) / (transformed_num_edge_types_walks[i].size());
-    }
-
-    return means;
+  for (double& mean : means) {
+    mean /= num_walks;
   }
 
-  double sigmoidCal(const double pears) {
-    return 1 / (1 + exp(-pears));  //exact sig
-  }
+  katana::NUMAArray<double> covariance;
+  covariance.allocateBlocked(num_cells);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_cells),
+      [&](uint64_t c) {
+        uint64_t sum = 0;
+        for (unsigned t = 0; t < num_threads; ++t) {
+          sum += sums.getRemote(t)->products[c];
+        }
+        covariance[c] = static_cast<double>(sum) / num_walks -
+                        means[c / num_types] * means[c % num_types];
+      },
+      katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_cells),
+      [&](uint64_t c) {
+        uint64_t a = c / num_types;
+        uint64_t b = c % num_types;
+        double norm = std::sqrt(
+            std::max(covariance[a * num_types + a], 0.0) *
+            std::max(covariance[b * num_types + b], 0.0));
+        // Types that never vary between walks are uncorrelated to the rest
+        double correlation = norm > 0 ? covariance[c] / norm : 0;
+        matrix->bias[c] = 1 / (1 + std::exp(-correlation));
+      },
+      katana::no_stats());
+  auto [lowest, highest] =
+      std::minmax_element(matrix->bias.begin(), matrix->bias.end());
+  matrix->min_bias = *lowest;
+  matrix->max_bias = *highest;
+}
 
-  double pearsonCorr(
-      const uint32_t i, const uint32_t j,
-      const std::vector<std::vector<uint32_t>>&
-          transformed_num_edge_types_walks,
-      const std::vector<double>& means) {
-    const std::vector<uint32_t>& x = transformed_num_edge_types_walks[i];
-    const std::vector<uint32_t>& y = transformed_num_edge_types_walks[j];
-
-    double sum = 0.0;
-    double sig1 = 0.0;
-    double sig2 = 0.0;
-
-    for (uint32_t m = 0; m < x.size(); m++) {
-      sum += ((double)x[m] - means[i]) * ((double)y[m] - means[j]);
-      sig1 += ((double)x[m] - means[i]) * ((double)x[m] - means[i]);
-      sig2 += ((double)y[m] - means[j]) * ((double)y[m] - means[j]);
+/// Edge2vec walks of plan (Gao et al., 2019) over the edges of graph typed by
+/// their entity types in pg. The transition matrix is estimated by
+/// max_iterations rounds of walks and updates of the matrix by
+/// EstimateTransitionMatrix; the walks taken with the final matrix are
+/// returned, and the matrix goes to matrix.
+katana::Result<FlatWalks>
+Edge2VecWalks(
+    const katana::PropertyGraph& pg, const UnweightedGraphView& graph,
+    const RandomWalksPlan& plan, TransitionMatrix* matrix) {
+  KATANA_CHECKED(ValidateProbabilities(plan));
+  katana::NUMAArray<uint32_t> edge_types =
+      Edge2VecEdgeTypes(pg, graph, plan.number_of_edge_types());
+  *matrix = TransitionMatrix(plan.number_of_edge_types() + 1);
+
+  FlatWalks walks;
+  walks.num_walks = graph.NumNodes() * plan.number_of_walks();
+  // A walk always takes its first edge, even if walk_length is 0
+  walks.stride = std::max(plan.walk_length(), uint32_t{1}) + 1;
+  walks.steps.allocateBlocked(walks.num_walks * walks.stride);
+  walks.lengths.allocateBlocked(walks.num_walks);
+  katana::NUMAArray<uint32_t> walk_types;
+  walk_types.allocateBlocked(walks.num_walks * (walks.stride - 1));
+
+  katana::StatTimer exec_time("RandomWalks");
+  katana::StatTimer matrix_time("RandomWalks_TransitionMatrix");
+  for (uint32_t round = 0;; ++round) {
+    exec_time.start();
+    Edge2VecWalks(
+        graph, edge_types, *matrix, plan, round, &walks, &walk_types);
+    exec_time.stop();
+    if (round == plan.max_iterations()) {
+      break;
     }
-
-    sum = sum / x.size();
-
-    sig1 = sig1 / x.size();
-    sig1 = sqrt(sig1);
-
-    sig2 = sig2 / x.size();
-    sig2 = sqrt(sig2);
-
-    double corr = sum / (sig1 * sig2);
-    return corr;
+    matrix_time.start();
+    EstimateTransitionMatrix(walks, walk_types, matrix);
+    matrix_time.stop();
   }
+  return walks;
+}
 
-  void ComputeTransitionMatrix(
-      const std::vector<std::vector<uint32_t>>&
-          transformed_num_edge_types_walks,
-      const std::vector<double>& means) {
+/// For each walk, the number of non-empty walks and of nodes up to it
+struct WalkOffsets {
+  katana::NUMAArray<uint64_t> row_ends;
+  katana::NUMAArray<uint64_t> step_ends;
+
+  explicit WalkOffsets(const FlatWalks& walks) {
+    uint64_t num_walks = walks.num_walks;
+    row_ends.allocateBlocked(num_walks);
+    step_ends.allocateBlocked(num_walks);
     katana::do_all(
-        katana::iterate(uint32_t(1), plan_.number_of_edge_types() + 1),
-        [&](uint32_t i) {
-          for (uint32_t j = 1; j <= plan_.number_of_edge_types(); j++) {
-            double pearson_corr =
-                pearsonCorr(i, j, transformed_num_edge_types_walks, means);
-            double sigmoid = sigmoidCal(pearson_corr);
-
-            transition_matrix_[i][j] = sigmoid;
-          }
-        });
+        katana::iterate(uint64_t{0}, num_walks),
+        [&](uint64_t i) {
+          row_ends[i] = walks.lengths[i] > 0;
+          step_ends[i] = walks.lengths[i];
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        row_ends.begin(), row_ends.end(), row_ends.begin());
+    katana::ParallelSTL::partial_sum(
+        step_ends.begin(), step_ends.end(), step_ends.begin());
   }
 
-  void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    uint32_t iterations = plan_.max_iterations();
-
-    Initialize();
-
-    for (uint32_t iter = 0; iter < iterations; iter++) {
-      //E step; generate walks
-      katana::InsertBag<std::vector<uint32_t>> types_walks;
-
-      GraphRandomWalk(graph, walks, &types_walks, degree);
-
-      //Update transition matrix
-      std::vector<std::vector<uint32_t>> num_edge_types_walks =
-          ComputeNumEdgeTypeVectors(types_walks);
-
-      std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks =
-          TransformVectors(num_edge_types_walks);
-
-      std::vector<double> means =
-          ComputeMeans(transformed_num_edge_types_walks);
-
-      ComputeTransitionMatrix(transformed_num_edge_types_walks, means);
-    }
+  uint64_t num_rows() const {
+    return row_ends.empty() ? 0 : row_ends[row_ends.size() - 1];
+  }
+  uint64_t num_steps() const {
+    return step_ends.empty() ? 0 : step_ends[step_ends.size() - 1];
   }
 };
 
-template <typename Graph>
-void
-InitializeDegrees(const Graph& graph, katana::NUMAArray<uint64_t>* degree) {
-  katana::do_all(katana::iterate(graph), [&](typename Graph::Node n) {
-    // Treat this as O(1) time because subtracting iterators is just pointer
-    // or number subtraction. So don't use steal().
-    (*degree)[n] = graph.OutDegree(n);
-  });
+std::vector<std::vector<uint32_t>>
+WalksToVectors(const FlatWalks& walks) {
+  WalkOffsets offsets(walks);
+  std::vector<std::vector<uint32_t>> vectors(offsets.num_rows());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, walks.num_walks),
+      [&](uint64_t i) {
+        if (walks.lengths[i] > 0) {
+          const uint32_t* walk = &walks.steps[i * walks.stride];
+          vectors[offsets.row_ends[i] - 1].assign(
+              walk, walk + walks.lengths[i]);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return vectors;
 }
 
-}  //namespace
-
-template <typename Algorithm>
-static katana::Result<std::vector<std::vector<uint32_t>>>
-RandomWalksWithWrap(
-    const typename Algorithm::SortedGraphView& graph, RandomWalksPlan plan) {
-  katana::ReportPageAllocGuard page_alloc;
-
-  Algorithm algo(plan);
-
-  katana::NUMAArray<uint64_t> degree;
-  degree.allocateBlocked(graph.size());
-  InitializeDegrees(graph, &degree);
+katana::Result<std::shared_ptr<arrow::Table>>
+WalksToTable(const FlatWalks& walks) {
+  WalkOffsets offsets(walks);
+  uint64_t num_rows = offsets.num_rows();
+  std::shared_ptr<arrow::Buffer> offsets_buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer((num_rows + 1) * sizeof(int64_t)));
+  std::shared_ptr<arrow::Buffer> steps_buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer(offsets.num_steps() * sizeof(uint32_t)));
+  auto* row_offsets =
+      reinterpret_cast<int64_t*>(offsets_buffer->mutable_data());
+  auto* steps = reinterpret_cast<uint32_t*>(steps_buffer->mutable_data());
+
+  row_offsets[0] = 0;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, walks.num_walks),
+      [&](uint64_t i) {
+        uint32_t length = walks.lengths[i];
+        if (length == 0) {
+          return;
+        }
+        const uint32_t* walk = &walks.steps[i * walks.stride];
+        uint64_t end = offsets.step_ends[i];
+        row_offsets[offsets.row_ends[i]] = end;
+        std::copy(walk, walk + length, steps + end - length);
+      },
+      katana::steal(), katana::no_stats());
+
+  auto nodes =
+      std::make_shared<arrow::UInt32Array>(offsets.num_steps(), steps_buffer);
+  auto walk_array = std::make_shared<arrow::LargeListArray>(
+      arrow::large_list(arrow::uint32()), num_rows, offsets_buffer, nodes);
+  return arrow::Table::Make(
+      arrow::schema({arrow::field("walk", walk_array->type())}), {walk_array});
+}
 
-  katana::StatTimer execTime("RandomWalks");
-  execTime.start();
-  katana::InsertBag<std::vector<uint32_t>> walks;
-  algo(graph, &walks, degree);
-  execTime.stop();
+/// Calls fn(graph, aliases) with a view of pg, of the edges of edge_type if
+/// given, and, if edge_weight_property_name is not empty, the alias tables of
+/// its weights
+template <typename Fn>
+katana::Result<void>
+WithWalkGraph(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::optional<katana::EntityTypeID>& edge_type, Fn fn) {
+  if (edge_weight_property_name.empty()) {
+    auto graph = KATANA_CHECKED(
+        katana::analytics::MakeGraphOfEdgeType<UnweightedGraphView>(
+            pg, edge_type, {}, {}));
+    return fn(graph, nullptr);
+  }
 
-  std::vector<std::vector<uint32_t>> walks_in_vector;
-  walks_in_vector.reserve(plan.number_of_walks());
-  std::move(walks.begin(), walks.end(), std::back_inserter(walks_in_vector));
-  return walks_in_vector;
+  auto weighted = [&](auto weight) -> katana::Result<void> {
+    using Weight = decltype(weight);
+    auto graph = KATANA_CHECKED(
+        katana::analytics::MakeGraphOfEdgeType<WeightedGraphView<Weight>>(
+            pg, edge_type, {}, {edge_weight_property_name}));
+    AliasTables aliases = KATANA_CHECKED(BuildAliasTables(graph));
+    return fn(graph, &aliases);
+  };
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return weighted(uint32_t{});
+  case arrow::Int32Type::type_id:
+    return weighted(int32_t{});
+  case arrow::UInt64Type::type_id:
+    return weighted(uint64_t{});
+  case arrow::Int64Type::type_id:
+    return weighted(int64_t{});
+  case arrow::FloatType::type_id:
+    return weighted(float{});
+  case arrow::DoubleType::type_id:
+    return weighted(double{});
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "unsupported edge weight type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
 }
 
+}  //namespace
+
 katana::Result<std::vector<std::vector<uint32_t>>>
 katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
   switch (plan.algorithm()) {
   case RandomWalksPlan::kNode2Vec: {
-    auto graph =
-        KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
-    return RandomWalksWithWrap<Node2VecAlgo>(graph, plan);
+    katana::ReportPageAllocGuard page_alloc;
+    auto graph = KATANA_CHECKED(MakeGraphOfEdgeType<UnweightedGraphView>(
+        pg, plan.edge_type(), {}, {}));
+    std::vector<std::vector<uint32_t>> walks;
+    KATANA_CHECKED(ForEachWalkBatch(
+        graph, nullptr, plan, std::numeric_limits<uint64_t>::max(),
+        [&](const FlatWalks& batch) -> katana::Result<void> {
+          walks = WalksToVectors(batch);
+          return katana::ResultSuccess();
+        }));
+    return walks;
   }
   case RandomWalksPlan::kEdge2Vec: {
-    TemporaryPropertyGuard tmp_edge_prop{pg->NodeMutablePropertyView()};
-    auto graph = KATANA_CHECKED(
-        Edge2VecAlgo::SortedGraphView::Make(pg, {}, {tmp_edge_prop.name()}));
-    return RandomWalksWithWrap<Edge2VecAlgo>(graph, plan);
+    katana::ReportPageAllocGuard page_alloc;
+    auto graph = KATANA_CHECKED(UnweightedGraphView::Make(pg, {}, {}));
+    TransitionMatrix matrix(0);
+    return WalksToVectors(
+        KATANA_CHECKED(Edge2VecWalks(*pg, graph, plan, &matrix)));
   }
   default:
     return ErrorCode::InvalidArgument;
   }
 }
 
+katana::Result<std::vector<double>>
+katana::analytics::Edge2VecTransitionMatrix(
+    PropertyGraph* pg, RandomWalksPlan plan) {
+  if (plan.algorithm() != RandomWalksPlan::kEdge2Vec) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "the plan is not an edge2vec plan");
+  }
+  katana::ReportPageAllocGuard page_alloc;
+  auto graph = KATANA_CHECKED(UnweightedGraphView::Make(pg, {}, {}));
+  TransitionMatrix matrix(0);
+  KATANA_CHECKED(Edge2VecWalks(*pg, graph, plan, &matrix));
+  return std::move(matrix.bias);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::analytics::RandomWalksTable(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    RandomWalksPlan plan) {
+  std::shared_ptr<arrow::Table> table;
+  KATANA_CHECKED(RandomWalksStream(
+      pg, std::numeric_limits<uint64_t>::max(),
+      [&](const std::shared_ptr<arrow::Table>& batch) -> Result<void> {
+        table = batch;
+        return ResultSuccess();
+      },
+      edge_weight_property_name, plan));
+  if (!table) {
+    // A graph without nodes has no batches
+    return WalksToTable(FlatWalks{});
+  }
+  return table;
+}
+
+katana::Result<void>
+katana::analytics::RandomWalksStream(
+    PropertyGraph* pg, uint64_t walks_per_batch,
+    const RandomWalksBatchCallback& callback,
+    const std::string& edge_weight_property_name, RandomWalksPlan plan) {
+  katana::ReportPageAllocGuard page_alloc;
+  return WithWalkGraph(
+      pg, edge_weight_property_name, plan.edge_type(),
+      [&](const auto& graph, const AliasTables* aliases) -> Result<void> {
+        return ForEachWalkBatch(
+            graph, aliases, plan, walks_per_batch,
+            [&](const FlatWalks& walks) -> Result<void> {
+              return callback(KATANA_CHECKED(WalksToTable(walks)));
+            });
+      });
+}
+
+katana::Result<void>
+katana::analytics::RandomWalksToParquet(
+    PropertyGraph* pg, const katana::URI& uri, uint64_t walks_per_batch,
+    const std::string& edge_weight_property_name, RandomWalksPlan plan) {
+  if (walks_per_batch > kMaxWalksPerParquetPart) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "walks_per_batch {} is more than the {} walks of a Parquet part",
+        walks_per_batch, kMaxWalksPerParquetPart);
+  }
+
+  std::unique_ptr<katana::WriteGroup> group =
+      KATANA_CHECKED(katana::WriteGroup::Make());
+  auto opts = katana::ParquetWriter::WriteOpts::Defaults();
+  // Each batch is already one part
+  opts.write_streaming = false;
+  std::vector<int64_t> part_offsets;
+  int64_t num_rows = 0;
+
+  auto written = RandomWalksStream(
+      pg, walks_per_batch,
+      [&](const std::shared_ptr<arrow::Table>& batch) -> Result<void> {
+        // Write waits for room in the group, so batches are not generated
+        // faster than they are uploaded
+        auto writer = KATANA_CHECKED(katana::ParquetWriter::Make(batch, opts));
+        KATANA_CHECKED(writer->WriteToUri(
+            uri + fmt::format(".part_{:09}", part_offsets.size()),
+            group.get()));
+        part_offsets.emplace_back(num_rows);
+        num_rows += batch->num_rows();
+        return ResultSuccess();
+      },
+      edge_weight_property_name, plan);
+
+  // Let the writes already started finish before reporting
+  auto finished = group->Finish();
+  KATANA_CHECKED(written);
+  KATANA_CHECKED(finished);
+  return katana::FileStore(
+      uri.string(), KATANA_CHECKED(katana::JsonDump(part_offsets)));
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::RandomWalksAssertValid(
@@ -0,0 +1,40 @@
+#ifndef KATANA_LIBGRAPH_ANALYTICS_RANDOMWALKS_WALKRANDOM_H_
+#define KATANA_LIBGRAPH_ANALYTICS_RANDOMWALKS_WALKRANDOM_H_
+
+#include <cstdint>
+
+namespace katana::analytics::internal {
+
+/// A counter-based random number generator (SplitMix64, from Steele et al.,
+/// "Fast Splittable Pseudorandom Number Generators", 2014), which is cheap
+/// enough to give each walk a stream of its own: the numbers of a walk
+/// depend only on the seed and the walk, not on the thread that takes it
+class WalkRandom {
+public:
+  WalkRandom(uint64_t seed, uint64_t walk) : state_(Mix(seed ^ Mix(walk))) {}
+
+  uint64_t Next() { return Mix(state_ += kGamma); }
+
+  /// \returns a uniform integer in [0, bound)
+  uint64_t Below(uint64_t bound) {
+    return (static_cast<unsigned __int128>(Next()) * bound) >> 64;
+  }
+
+  /// \returns a uniform double in [0, 1)
+  double Uniform() { return (Next() >> 11) * 0x1.0p-53; }
+
+private:
+  constexpr static const uint64_t kGamma = 0x9e3779b97f4a7c15ULL;
+
+  static uint64_t Mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t state_;
+};
+
+}  // namespace katana::analytics::internal
+
+#endif
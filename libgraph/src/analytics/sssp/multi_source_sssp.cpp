@@ -0,0 +1,394 @@
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/sssp/sssp.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// The number of searches that reach each node
+using MultiSourceSsspReach = katana::PODProperty<uint32_t>;
+
+template <typename Weight>
+using MultiSourceSsspEdgeWeight = katana::PODProperty<Weight>;
+
+template <typename Weight>
+using Graph = katana::TypedPropertyGraph<
+    std::tuple<MultiSourceSsspReach>,
+    std::tuple<MultiSourceSsspEdgeWeight<Weight>>>;
+
+/// Delta stepping of a batch of searches over shared work items. Each node
+/// keeps a distance per search and a bit per search whose distance improved
+/// since the node was last processed (pending). A work item is a node and
+/// the bucket of an improved distance; processing it takes the pending
+/// searches whose distance falls in that bucket or an earlier one and scans
+/// the edges of the node once for all of them. A search left pending has
+/// its own item at the bucket of its distance, because one is pushed
+/// whenever a search becomes pending or its bucket decreases.
+template <typename Weight, size_t kWords>
+class BatchedDeltaStep {
+  static constexpr size_t kLanes = 64 * kWords;
+  static constexpr Weight kInfinity = std::numeric_limits<Weight>::max() / 4;
+  static constexpr uint32_t kNoBucket = std::numeric_limits<uint32_t>::max();
+  using Lanes = std::array<uint64_t, kWords>;
+  using EdgeWeight = MultiSourceSsspEdgeWeight<Weight>;
+  using GNode = typename Graph<Weight>::Node;
+
+  struct Item {
+    GNode node;
+    uint32_t bucket;
+  };
+
+  struct Indexer {
+    unsigned int operator()(const Item& item) const { return item.bucket; }
+  };
+
+  using OBIM =
+      katana::OrderedByIntegerMetric<Indexer, katana::PerSocketChunkFIFO<64>>;
+
+  struct Summary {
+    std::array<uint64_t, kLanes> reached;
+    std::array<double, kLanes> sums;
+    std::array<double, kLanes> maxes;
+  };
+
+  const Graph<Weight>& graph_;
+  unsigned long divisor_;
+  katana::NUMAArray<std::atomic<Weight>> dist_;
+  katana::NUMAArray<Lanes> pending_;
+  katana::PerThreadStorage<Summary> summaries_;
+
+  uint32_t Bucket(Weight dist) const {
+    return static_cast<uint32_t>(dist / divisor_);
+  }
+
+  std::atomic<Weight>& Dist(GNode node, size_t lane) {
+    return dist_[static_cast<size_t>(node) * kLanes + lane];
+  }
+
+  template <typename Context>
+  void Process(const Item& item, Context& ctx) {
+    // The pending searches of item.node due by item.bucket and their
+    // distances
+    std::array<uint16_t, kLanes> lanes;
+    std::array<Weight, kLanes> dists;
+    size_t num = 0;
+
+    Lanes& pending = pending_[item.node];
+    for (size_t w = 0; w < kWords; ++w) {
+      uint64_t due = 0;
+      uint64_t bits = __atomic_load_n(&pending[w], __ATOMIC_RELAXED);
+      for (; bits; bits &= bits - 1) {
+        size_t lane = w * 64 + __builtin_ctzll(bits);
+        if (Bucket(Dist(item.node, lane).load(std::memory_order_relaxed)) <=
+            item.bucket) {
+          due |= uint64_t{1} << (lane % 64);
+        }
+      }
+      if (!due) {
+        continue;
+      }
+      // Another item of this node may have taken some of them first
+      uint64_t taken = __atomic_fetch_and(&pending[w], ~due, __ATOMIC_ACQ_REL);
+      taken &= due;
+      for (; taken; taken &= taken - 1) {
+        size_t lane = w * 64 + __builtin_ctzll(taken);
+        lanes[num] = lane;
+        dists[num] = Dist(item.node, lane).load(std::memory_order_relaxed);
+        ++num;
+      }
+    }
+    if (num == 0) {
+      return;
+    }
+
+    for (auto e : graph_.OutEdges(item.node)) {
+      auto dst = graph_.OutEdgeDst(e);
+      Weight weight = graph_.template GetEdgeData<EdgeWeight>(e);
+      Lanes& dst_pending = pending_[dst];
+      uint32_t last_pushed = kNoBucket;
+      for (size_t i = 0; i < num; ++i) {
+        size_t lane = lanes[i];
+        Weight new_dist = dists[i] + weight;
+        Weight old_dist = katana::atomicMin(Dist(dst, lane), new_dist);
+        if (!(new_dist < old_dist)) {
+          continue;
+        }
+        uint64_t bit = uint64_t{1} << (lane % 64);
+        uint64_t was = __atomic_fetch_or(
+            &dst_pending[lane / 64], bit, __ATOMIC_ACQ_REL);
+        uint32_t bucket = Bucket(new_dist);
+        if ((!(was & bit) || bucket < Bucket(old_dist)) &&
+            bucket != last_pushed) {
+          ctx.push(Item{dst, bucket});
+          last_pushed = bucket;
+        }
+      }
+    }
+  }
+
+public:
+  BatchedDeltaStep(const Graph<Weight>& graph, unsigned shift)
+      : graph_(graph), divisor_(std::pow(2, shift)) {
+    dist_.allocateBlocked(graph.NumNodes() * kLanes);
+    pending_.allocateBlocked(graph.NumNodes());
+  }
+
+  /// Run the searches from sources [0, num) and record their statistics at
+  /// offset onwards; add the searches reaching each node to its property
+  void Run(
+      Graph<Weight>* graph, const uint32_t* sources, size_t num, size_t offset,
+      MultiSourceSsspStatistics* stats) {
+    KATANA_LOG_DEBUG_ASSERT(num <= kLanes);
+    katana::do_all(
+        katana::iterate(size_t{0}, dist_.size()),
+        [&](size_t i) { dist_[i].store(kInfinity, std::memory_order_relaxed); },
+        katana::no_stats());
+    katana::ParallelSTL::fill(pending_.begin(), pending_.end(), Lanes{});
+
+    katana::InsertBag<Item> initial;
+    for (size_t l = 0; l < num; ++l) {
+      Dist(sources[l], l).store(0, std::memory_order_relaxed);
+      pending_[sources[l]][l / 64] |= uint64_t{1} << (l % 64);
+      initial.push(Item{sources[l], 0});
+    }
+
+    katana::for_each(
+        katana::iterate(initial),
+        [&](const Item& item, auto& ctx) { Process(item, ctx); },
+        katana::wl<OBIM>(Indexer{}), katana::disable_conflict_detection(),
+        katana::loopname("MultiSourceSssp"));
+
+    for (unsigned t = 0; t < summaries_.size(); ++t) {
+      Summary& s = *summaries_.getRemote(t);
+      s.reached.fill(0);
+      s.sums.fill(0);
+      s.maxes.fill(0);
+    }
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& v) {
+          Summary& s = *summaries_.getLocal();
+          uint32_t reached = 0;
+          for (size_t l = 0; l < num; ++l) {
+            Weight d = Dist(v, l).load(std::memory_order_relaxed);
+            if (d == kInfinity) {
+              continue;
+            }
+            ++reached;
+            s.reached[l] += 1;
+            s.sums[l] += static_cast<double>(d);
+            s.maxes[l] = std::max(s.maxes[l], static_cast<double>(d));
+          }
+          graph->template GetData<MultiSourceSsspReach>(v) += reached;
+        },
+        katana::no_stats(), katana::loopname("MultiSourceSssp-Reach"));
+
+    for (unsigned t = 0; t < summaries_.size(); ++t) {
+      const Summary& s = *summaries_.getRemote(t);
+      for (size_t l = 0; l < num; ++l) {
+        stats->n_reached_nodes[offset + l] += s.reached[l];
+        stats->distance_sums[offset + l] += s.sums[l];
+        stats->max_distances[offset + l] =
+            std::max(stats->max_distances[offset + l], s.maxes[l]);
+      }
+    }
+  }
+};
+
+template <typename Weight, size_t kWords>
+void
+RunBatches(
+    Graph<Weight>* graph, const std::vector<uint32_t>& sources,
+    unsigned shift, MultiSourceSsspStatistics* stats) {
+  constexpr size_t kLanes = 64 * kWords;
+  BatchedDeltaStep<Weight, kWords> sssp(*graph, shift);
+  for (size_t offset = 0; offset < sources.size(); offset += kLanes) {
+    size_t num = std::min(kLanes, sources.size() - offset);
+    sssp.Run(graph, &sources[offset], num, offset, stats);
+  }
+}
+
+template <typename Weight>
+void
+RunAlgo(
+    Graph<Weight>* graph, const std::vector<uint32_t>& sources,
+    MultiSourceSsspPlan plan, MultiSourceSsspStatistics* stats) {
+  switch (plan.batch_size() / 64) {
+  case 1:
+    RunBatches<Weight, 1>(graph, sources, plan.delta(), stats);
+    break;
+  case 2:
+    RunBatches<Weight, 2>(graph, sources, plan.delta(), stats);
+    break;
+  case 3:
+    RunBatches<Weight, 3>(graph, sources, plan.delta(), stats);
+    break;
+  case 4:
+    RunBatches<Weight, 4>(graph, sources, plan.delta(), stats);
+    break;
+  case 5:
+    RunBatches<Weight, 5>(graph, sources, plan.delta(), stats);
+    break;
+  case 6:
+    RunBatches<Weight, 6>(graph, sources, plan.delta(), stats);
+    break;
+  case 7:
+    RunBatches<Weight, 7>(graph, sources, plan.delta(), stats);
+    break;
+  case 8:
+    RunBatches<Weight, 8>(graph, sources, plan.delta(), stats);
+    break;
+  default:
+    KATANA_LOG_FATAL("unexpected batch size {}", plan.batch_size());
+  }
+}
+
+template <typename Weight>
+katana::Result<MultiSourceSsspStatistics>
+MultiSourceSsspWithWrap(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MultiSourceSsspPlan plan,
+    katana::TxnContext* txn_ctx) {
+  static_assert(std::is_integral_v<Weight> || std::is_floating_point_v<Weight>);
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<std::tuple<MultiSourceSsspReach>>(
+          txn_ctx, {output_property_name}));
+  auto graph = KATANA_CHECKED(Graph<Weight>::Make(
+      pg, {output_property_name}, {edge_weight_property_name}));
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const typename Graph<Weight>::Node& v) {
+        graph.template GetData<MultiSourceSsspReach>(v) = 0;
+      },
+      katana::no_stats());
+
+  MultiSourceSsspStatistics stats;
+  stats.n_reached_nodes.resize(sources.size());
+  stats.distance_sums.resize(sources.size());
+  stats.max_distances.resize(sources.size());
+
+  katana::StatTimer exec_time("MultiSourceSssp");
+  exec_time.start();
+  RunAlgo(&graph, sources, plan, &stats);
+  exec_time.stop();
+
+  return stats;
+}
+
+}  // namespace
+
+katana::Result<MultiSourceSsspStatistics>
+katana::analytics::MultiSourceSssp(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MultiSourceSsspPlan plan) {
+  if (plan.algorithm() != MultiSourceSsspPlan::kBatchedDeltaStep) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm {}",
+        plan.algorithm());
+  }
+  if (plan.batch_size() == 0 || plan.batch_size() % 64 != 0 ||
+      plan.batch_size() > MultiSourceSsspPlan::kMaxBatchSize) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "batch size {} must be a multiple of 64 up to {}", plan.batch_size(),
+        MultiSourceSsspPlan::kMaxBatchSize);
+  }
+  for (uint32_t source : sources) {
+    if (source >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          source);
+    }
+  }
+  if (!edge_weight_property_name.empty() &&
+      !pg->HasEdgeProperty(edge_weight_property_name)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "Edge Property: {} Not found",
+        edge_weight_property_name);
+  }
+
+  if (edge_weight_property_name.empty()) {
+    TemporaryPropertyGuard temporary_edge_property{
+        pg->EdgeMutablePropertyView()};
+    using EdgeWeightType = int64_t;
+    KATANA_CHECKED(katana::analytics::AddDefaultEdgeWeight<EdgeWeightType>(
+        pg, temporary_edge_property.name(), 1, txn_ctx));
+
+    return MultiSourceSsspWithWrap<EdgeWeightType>(
+        pg, sources, temporary_edge_property.name(), output_property_name,
+        plan, txn_ctx);
+  }
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return MultiSourceSsspWithWrap<uint32_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan,
+        txn_ctx);
+  case arrow::Int32Type::type_id:
+    return MultiSourceSsspWithWrap<int32_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan,
+        txn_ctx);
+  case arrow::UInt64Type::type_id:
+    return MultiSourceSsspWithWrap<uint64_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan,
+        txn_ctx);
+  case arrow::Int64Type::type_id:
+    return MultiSourceSsspWithWrap<int64_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan,
+        txn_ctx);
+  case arrow::FloatType::type_id:
+    return MultiSourceSsspWithWrap<float>(
+        pg, sources, edge_weight_property_name, output_property_name, plan,
+        txn_ctx);
+  case arrow::DoubleType::type_id:
+    return MultiSourceSsspWithWrap<double>(
+        pg, sources, edge_weight_property_name, output_property_name, plan,
+        txn_ctx);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+katana::Result<void>
+katana::analytics::MultiSourceSsspAssertValid(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& property_name) {
+  return MultiSourceBfsAssertValid(pg, sources, property_name);
+}
+
+void
+katana::analytics::MultiSourceSsspStatistics::Print(std::ostream& os) const {
+  os << "Number of sources = " << n_reached_nodes.size() << std::endl;
+  for (size_t i = 0; i < n_reached_nodes.size(); ++i) {
+    double average =
+        n_reached_nodes[i] ? distance_sums[i] / n_reached_nodes[i] : 0;
+    os << "Source " << i << ": reached nodes = " << n_reached_nodes[i]
+       << ", max distance = " << max_distances[i]
+       << ", average distance = " << average << std::endl;
+  }
+}
@@ -19,10 +19,14 @@
 
 #include "katana/analytics/sssp/sssp.h"
 
+#include <algorithm>
+#include <type_traits>
+
 #include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/RunStatistics.h"
 #include "katana/gstl.h"
 
 using namespace katana::analytics;
@@ -69,6 +73,21 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   using OBIM = katana::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
   using OBIMBarrier = typename katana::OrderedByIntegerMetric<
       UpdateRequestIndexer, PSchunk>::template with_barrier<true>::type;
+  using AdaptiveOBIM =
+      katana::AdaptiveOrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
+  using MultiQueue = katana::MultiQueue<UpdateRequestIndexer>;
+
+  template <typename WL>
+  static auto DeltaStepWorklist(unsigned stepShift) {
+    if constexpr (std::is_same_v<WL, AdaptiveOBIM>) {
+      // the worklist buckets unscaled distances itself, from 2^stepShift on
+      return katana::wl<WL>(UpdateRequestIndexer{0}, stepShift);
+    } else if constexpr (std::is_same_v<WL, MultiQueue>) {
+      return katana::wl<WL>(UpdateRequestIndexer{0});
+    } else {
+      return katana::wl<WL>(UpdateRequestIndexer{stepShift});
+    }
+  }
 
   template <typename T, typename OBIMTy = OBIM, typename P, typename R>
   static void DeltaStepAlgo(
@@ -114,7 +133,7 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
             }
           }
         },
-        katana::wl<OBIMTy>(UpdateRequestIndexer{stepShift}),
+        DeltaStepWorklist<OBIMTy>(stepShift),
         katana::disable_conflict_detection(), katana::loopname("SSSP"));
 
     if (kTrackWork) {
@@ -125,6 +144,96 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     }
   }
 
+  /// A request of DeltaStepSortedAlgo to relax the light edges of src or,
+  /// if heavy, its heavy edges. dist is the priority of the request, see
+  /// UpdateRequestIndexer; src_dist is the distance of src it was made for.
+  struct SplitRequest {
+    typename Graph::Node src;
+    Dist dist;
+    Dist src_dist;
+    bool heavy;
+  };
+
+  /// DeltaStepAlgo over edges sorted by weight. The light edges of a node,
+  /// those lighter than the delta, come first and are relaxed in a loop that
+  /// does not look at weights. Its heavy edges are relaxed by a second
+  /// request in the bucket of the lightest of them, which is dropped if the
+  /// distance of the node improves in the meantime.
+  template <typename OBIMTy = OBIM>
+  static void DeltaStepSortedAlgo(
+      katana::NUMAArray<std::atomic<Weight>>* node_data,
+      const katana::NUMAArray<Weight>& edge_data,
+      const katana::EdgeShuffleTopology& topo,
+      const typename Graph::Node& source, unsigned stepShift) {
+    using Node = typename Graph::Node;
+    using Edge = katana::GraphTopology::Edge;
+
+    katana::GAccumulator<size_t> BadWork;
+    katana::GAccumulator<size_t> WLEmptyWork;
+
+    // the first heavy edge of each node
+    const Dist delta = Dist(1 << stepShift);
+    katana::NUMAArray<Edge> light_end;
+    light_end.allocateInterleaved(topo.NumNodes());
+    katana::do_all(
+        katana::iterate(topo.Nodes()),
+        [&](Node n) {
+          auto edges = topo.OutEdges(n);
+          light_end[n] = *std::lower_bound(
+              edges.begin(), edges.end(), delta,
+              [&](Edge e, Dist d) { return edge_data[e] < d; });
+        },
+        katana::steal(), katana::no_stats());
+
+    auto relax = [&](Dist sdist, Edge beg, Edge end, auto& ctx) {
+      for (Edge e = beg; e < end; ++e) {
+        auto dest = topo.OutEdgeDst(e);
+        Dist new_dist = sdist + edge_data[e];
+        Dist old_dist = katana::atomicMin((*node_data)[dest], new_dist);
+        if (new_dist < old_dist) {
+          if (kTrackWork && old_dist != kDistanceInfinity) {
+            BadWork += 1;
+          }
+          ctx.push(SplitRequest{dest, new_dist, new_dist, false});
+        }
+      }
+    };
+
+    katana::InsertBag<SplitRequest> init_bag;
+    init_bag.push(SplitRequest{source, 0, 0, false});
+
+    katana::for_each(
+        katana::iterate(init_bag),
+        [&](const SplitRequest& item, auto& ctx) {
+          Dist sdist = (*node_data)[item.src];
+          if (sdist < item.src_dist) {
+            if (kTrackWork) {
+              WLEmptyWork += 1;
+            }
+            return;
+          }
+
+          Edge light = light_end[item.src];
+          Edge end = *topo.OutEdges(item.src).end();
+          if (item.heavy) {
+            relax(sdist, light, end, ctx);
+            return;
+          }
+          relax(sdist, *topo.OutEdges(item.src).begin(), light, ctx);
+          if (light != end) {
+            ctx.push(
+                SplitRequest{item.src, sdist + edge_data[light], sdist, true});
+          }
+        },
+        DeltaStepWorklist<OBIMTy>(stepShift),
+        katana::disable_conflict_detection(), katana::loopname("SSSP"));
+
+    if (kTrackWork) {
+      katana::ReportStatSingle("SSSP", "BadWork", BadWork.reduce());
+      katana::ReportStatSingle("SSSP", "WLEmptyWork", WLEmptyWork.reduce());
+    }
+  }
+
   static void DeltaStepFusionAlgo(
       katana::NUMAArray<std::atomic<Weight>>* node_data,
       katana::NUMAArray<Weight>* edge_data, Graph* graph,
@@ -401,7 +510,13 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   }
 
 public:
-  katana::Result<void> SSSP(Graph& graph, size_t start_node, SsspPlan plan) {
+  /// If sorted_topo is given, the delta stepping plans run over its edges,
+  /// those of graph sorted by weight, see DeltaStepSortedAlgo, and
+  /// sorted_weights holds the weights of the edges by property index.
+  katana::Result<void> SSSP(
+      Graph& graph, size_t start_node, SsspPlan plan,
+      const katana::EdgeShuffleTopology* sorted_topo = nullptr,
+      const Weight* sorted_weights = nullptr) {
     if (start_node >= graph.size()) {
       return katana::ErrorCode::InvalidArgument;
     }
@@ -428,6 +543,13 @@ public:
     katana::do_all(katana::iterate(graph), [&](const typename Graph::Node& n) {
       graph.template GetData<NodeDistance>(n) = kDistanceInfinity;
       node_data[n] = kDistanceInfinity;
+      if (sorted_topo) {
+        for (auto e : sorted_topo->OutEdges(n)) {
+          edge_data[e] =
+              sorted_weights[sorted_topo->GetEdgePropertyIndexFromOutEdge(e)];
+        }
+        return;
+      }
       for (auto e : graph.OutEdges(n)) {
         edge_data[e] = graph.template GetEdgeData<EdgeWeight>(e);
       }
@@ -450,15 +572,40 @@ public:
           SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(), plan.delta());
       break;
     case SsspPlan::kDeltaStep:
+      if (sorted_topo) {
+        DeltaStepSortedAlgo(
+            &node_data, edge_data, *sorted_topo, source, plan.delta());
+        break;
+      }
       DeltaStepAlgo<UpdateRequest>(
           &node_data, &edge_data, &graph, source, ReqPushWrap(),
           OutEdgeRangeFn{&graph}, plan.delta());
       break;
     case SsspPlan::kDeltaStepBarrier:
+      if (sorted_topo) {
+        DeltaStepSortedAlgo<OBIMBarrier>(
+            &node_data, edge_data, *sorted_topo, source, plan.delta());
+        break;
+      }
       DeltaStepAlgo<UpdateRequest, OBIMBarrier>(
           &node_data, &edge_data, &graph, source, ReqPushWrap(),
           OutEdgeRangeFn{&graph}, plan.delta());
       break;
+    case SsspPlan::kDeltaStepAdaptive:
+      if (sorted_topo) {
+        DeltaStepSortedAlgo<AdaptiveOBIM>(
+            &node_data, edge_data, *sorted_topo, source, plan.delta());
+        break;
+      }
+      DeltaStepAlgo<UpdateRequest, AdaptiveOBIM>(
+          &node_data, &edge_data, &graph, source, ReqPushWrap(),
+          OutEdgeRangeFn{&graph}, plan.delta());
+      break;
+    case SsspPlan::kMultiQueue:
+      DeltaStepAlgo<UpdateRequest, MultiQueue>(
+          &node_data, &edge_data, &graph, source, ReqPushWrap(),
+          OutEdgeRangeFn{&graph}, plan.delta());
+      break;
     case SsspPlan::kDeltaStepFusion:
       DeltaStepFusionAlgo(&node_data, &edge_data, &graph, source, plan.delta());
       break;
@@ -505,10 +652,25 @@ Sssp(
     katana::TypedPropertyGraph<
         std::tuple<SsspNodeDistance<Weight>>,
         std::tuple<SsspEdgeWeight<Weight>>>& pg,
-    size_t start_node, SsspPlan plan) {
+    size_t start_node, SsspPlan plan,
+    const katana::EdgeShuffleTopology* sorted_topo = nullptr,
+    const Weight* sorted_weights = nullptr) {
   static_assert(std::is_integral_v<Weight> || std::is_floating_point_v<Weight>);
   SsspImplementation<Weight> impl{{plan.edge_tile_size()}};
-  return impl.SSSP(pg, start_node, plan);
+  return impl.SSSP(pg, start_node, plan, sorted_topo, sorted_weights);
+}
+
+/// Whether plan runs faster over edges sorted by weight
+bool
+UsesSortedEdges(const SsspPlan& plan) {
+  switch (plan.algorithm()) {
+  case SsspPlan::kDeltaStep:
+  case SsspPlan::kDeltaStepBarrier:
+  case SsspPlan::kDeltaStepAdaptive:
+    return true;
+  default:
+    return false;
+  }
 }
 
 template <typename Weight>
@@ -517,17 +679,20 @@ SSSPWithWrap(
     katana::PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
     const std::string& output_property_name, SsspPlan plan,
-    katana::TxnContext* txn_ctx) {
+    katana::TxnContext* txn_ctx, bool sort_edges = true) {
+  katana::analytics::RunRecorder recorder("Sssp");
+  recorder.StartPhase(katana::analytics::kPhaseViewBuild);
   if (auto r =
           pg->ConstructNodeProperties<std::tuple<SsspNodeDistance<Weight>>>(
               txn_ctx, {output_property_name});
       !r) {
     return r.error();
   }
-  auto graph = katana::TypedPropertyGraph<
+  auto graph = MakeGraphOfEdgeType<katana::TypedPropertyGraph<
       std::tuple<SsspNodeDistance<Weight>>,
-      std::tuple<SsspEdgeWeight<Weight>>>::
-      Make(pg, {output_property_name}, {edge_weight_property_name});
+      std::tuple<SsspEdgeWeight<Weight>>>>(
+      pg, plan.edge_type(), {output_property_name},
+      {edge_weight_property_name});
   if (!graph && graph.error() == katana::ErrorCode::TypeError) {
     KATANA_LOG_DEBUG(
         "Incorrect edge property type: {}",
@@ -538,7 +703,37 @@ SSSPWithWrap(
   if (!graph) {
     return graph.error();
   }
-  return Sssp(graph.value(), start_node, plan);
+
+  // The delta stepping plans over the whole graph relax the edges of a node
+  // sorted by weight, light ones first; the sorted topology is cached, and
+  // stored, with the graph
+  std::shared_ptr<const katana::EdgeShuffleTopology> sorted_topo;
+  std::shared_ptr<typename arrow::CTypeTraits<Weight>::ArrayType> weights;
+  if (sort_edges && !plan.edge_type()) {
+    if (plan.algorithm() == SsspPlan::kAutomatic) {
+      plan = SsspPlan(pg);
+    }
+    if (UsesSortedEdges(plan)) {
+      auto sorted_res =
+          pg->BuildEdgesSortedByProperty(edge_weight_property_name);
+      auto weights_res =
+          pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name);
+      if (sorted_res && weights_res) {
+        sorted_topo = std::move(sorted_res.value());
+        weights = std::move(weights_res.value());
+      } else {
+        KATANA_LOG_DEBUG(
+            "not sorting edges by {}: {}", edge_weight_property_name,
+            sorted_res ? weights_res.error() : sorted_res.error());
+      }
+    }
+  }
+
+  // The implementation initializes the distances as it starts
+  recorder.StartPhase(katana::analytics::kPhaseMainLoop);
+  return Sssp(
+      graph.value(), start_node, plan, sorted_topo.get(),
+      weights ? weights->raw_values() : nullptr);
 }
 
 }  // namespace
@@ -564,9 +759,10 @@ katana::analytics::Sssp(
     KATANA_CHECKED(katana::analytics::AddDefaultEdgeWeight<EdgeWeightType>(
         pg, temporary_edge_property.name(), 1, txn_ctx));
 
+    // unit weights sort edges by destination, which is not worth a topology
     return SSSPWithWrap<EdgeWeightType>(
         pg, start_node, temporary_edge_property.name(), output_property_name,
-        plan, txn_ctx);
+        plan, txn_ctx, false);
   }
   switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
               ->type()
@@ -19,84 +19,213 @@
 
 #include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
 
-#include <iostream>
+#include <functional>
+#include <unordered_set>
 
+#include <arrow/api.h>
+
+#include "katana/PerThreadStorage.h"
 #include "katana/PropertyGraph.h"
+#include "katana/TakeRows.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
 
 namespace {
 
 using namespace katana::analytics;
-using edge_iterator = boost::counting_iterator<uint64_t>;
 
 using SortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 using Node = SortedGraphView::Node;
 using Edge = SortedGraphView::Edge;
 
-katana::Result<std::unique_ptr<katana::PropertyGraph>>
+/// The sub-graph in its own node IDs, with the property index in the
+/// original graph of each of its nodes and edges
+struct SubGraphTopology {
+  katana::GraphTopology::AdjIndexVec out_indices;
+  katana::GraphTopology::EdgeDestVec out_dests;
+  katana::GraphTopology::PropIndexVec node_prop_indices;
+  katana::GraphTopology::PropIndexVec edge_prop_indices;
+};
+
+/// An edge of the sub-graph, found by the thread that owns its source
+struct SubGraphEdge {
+  Node dest;
+  Edge edge;
+};
+
+SubGraphTopology
 SubGraphNodeSet(
     const SortedGraphView& graph, const std::vector<Node>& node_set) {
   uint64_t num_nodes = node_set.size();
-  // Subgraph topology : out indices
-  katana::NUMAArray<Edge> out_indices;
-  out_indices.allocateInterleaved(num_nodes);
 
-  katana::gstl::Vector<katana::gstl::Vector<Node>> subgraph_edges;
-  subgraph_edges.resize(num_nodes);
+  // Node set sorted by original ID, so that the nodes of the sub-graph among
+  // the neighbors of a node are found by merging two sorted lists
+  std::vector<std::pair<Node, Node>> sorted_nodes(num_nodes);
+  katana::do_all(
+      katana::iterate(Node(0), Node(num_nodes)),
+      [&](const Node& n) { sorted_nodes[n] = {node_set[n], n}; },
+      katana::no_stats());
+  katana::ParallelSTL::sort(sorted_nodes.begin(), sorted_nodes.end());
+
+  SubGraphTopology sub;
+  sub.out_indices.allocateInterleaved(num_nodes);
+  sub.node_prop_indices.allocateInterleaved(num_nodes);
+
+  // Each thread appends the edges of the nodes it handles to its own scratch
+  // vector and remembers where they start, instead of allocating a vector
+  // per node
+  katana::PerThreadStorage<std::vector<SubGraphEdge>> scratch;
+  katana::NUMAArray<uint32_t> owner;
+  owner.allocateInterleaved(num_nodes);
+  katana::NUMAArray<uint64_t> scratch_begin;
+  scratch_begin.allocateInterleaved(num_nodes);
 
   katana::do_all(
       katana::iterate(Node(0), Node(num_nodes)),
       [&](const Node& n) {
         Node src = node_set[n];
+        std::vector<SubGraphEdge>& edges = *scratch.getLocal();
+        owner[n] = katana::ThreadPool::getTID();
+        scratch_begin[n] = edges.size();
 
-        auto last = graph.OutEdges(src).end();
-        for (Node m = 0; m < num_nodes; ++m) {
-          auto dest = node_set[m];
-          // Binary search on the edges sorted by destination id
-          for (auto edge_it = graph.FindEdge(src, dest);
-               edge_it != last && graph.OutEdgeDst(*edge_it) == dest;
-               ++edge_it) {
-            subgraph_edges[n].push_back(m);
+        auto out_edges = graph.OutEdges(src);
+        if (out_edges.size() <= num_nodes) {
+          // Few neighbors: look each of them up in the node set
+          for (Edge e : out_edges) {
+            Node dest = graph.OutEdgeDst(e);
+            auto it = std::lower_bound(
+                sorted_nodes.begin(), sorted_nodes.end(),
+                std::make_pair(dest, Node(0)));
+            if (it != sorted_nodes.end() && it->first == dest) {
+              edges.push_back({it->second, e});
+            }
+          }
+        } else {
+          // Many neighbors: binary search on the edges sorted by destination
+          // id for each node of the set
+          auto last = out_edges.end();
+          for (const auto& [dest, m] : sorted_nodes) {
+            for (auto edge_it = graph.FindEdge(src, dest);
+                 edge_it != last && graph.OutEdgeDst(*edge_it) == dest;
+                 ++edge_it) {
+              edges.push_back({m, *edge_it});
+            }
           }
         }
-        out_indices[n] = subgraph_edges[n].size();
+        sub.out_indices[n] = edges.size() - scratch_begin[n];
+        sub.node_prop_indices[n] = graph.GetNodePropertyIndex(src);
       },
       katana::steal(), katana::loopname("SubgraphExtraction"));
 
   // Prefix sum
   katana::ParallelSTL::partial_sum(
-      out_indices.begin(), out_indices.end(), out_indices.begin());
-  uint64_t num_edges = out_indices[num_nodes - 1];
+      sub.out_indices.begin(), sub.out_indices.end(), sub.out_indices.begin());
+  uint64_t num_edges = sub.out_indices[num_nodes - 1];
 
   // Subgraph topology : out dests
-  katana::NUMAArray<Node> out_dests;
-  out_dests.allocateInterleaved(num_edges);
+  sub.out_dests.allocateInterleaved(num_edges);
+  sub.edge_prop_indices.allocateInterleaved(num_edges);
 
   katana::do_all(
       katana::iterate(Node(0), Node(num_nodes)),
       [&](const Node& n) {
-        uint64_t offset = n == 0 ? 0 : out_indices[n - 1];
-        for (Node dest : subgraph_edges[n]) {
-          out_dests[offset] = dest;
-          offset++;
+        uint64_t offset = n == 0 ? 0 : sub.out_indices[n - 1];
+        const SubGraphEdge* edges =
+            scratch.getRemote(owner[n])->data() + scratch_begin[n];
+        for (; offset != sub.out_indices[n]; ++offset, ++edges) {
+          sub.out_dests[offset] = edges->dest;
+          sub.edge_prop_indices[offset] =
+              graph.GetEdgePropertyIndexFromOutEdge(edges->edge);
         }
       },
       katana::steal(), katana::loopname("ConstructTopology"));
 
-  katana::GraphTopology sub_g_topo{
-      std::move(out_indices), std::move(out_dests)};
-  auto sub_g_res = katana::PropertyGraph::Make(std::move(sub_g_topo));
+  katana::on_each([&](unsigned tid, unsigned) {
+    std::vector<SubGraphEdge>().swap(*scratch.getRemote(tid));
+  });
 
-  return sub_g_res;
+  return sub;
 }
-}  // namespace
 
+/// A table of the named properties with the rows at indices
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeProperties(
+    const std::vector<std::string>& names,
+    const katana::GraphTopology::PropIndexVec& indices,
+    const std::function<katana::Result<std::shared_ptr<arrow::ChunkedArray>>(
+        const std::string&)>& get_property) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : names) {
+    std::shared_ptr<arrow::ChunkedArray> column =
+        KATANA_CHECKED(get_property(name));
+    fields.emplace_back(arrow::field(name, column->type()));
+    columns.emplace_back(std::move(column));
+  }
+  // all the properties are taken in one pass over indices
+  return katana::TakeRows(
+      arrow::Table::Make(arrow::schema(fields), columns), indices);
+}
+
+/// A graph of its own with the topology, types and requested properties of
+/// the sub-graph
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
-katana::analytics::SubGraphExtraction(
-    katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
-    SubGraphExtractionPlan plan) {
-  // Remove duplicates from the node vector
+MakeSubGraphCopy(
+    katana::PropertyGraph* pg, SubGraphTopology&& sub,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties,
+    katana::TxnContext* txn_ctx) {
+  size_t num_nodes = sub.node_prop_indices.size();
+  size_t num_edges = sub.edge_prop_indices.size();
+
+  katana::PropertyGraph::EntityTypeIDArray node_types;
+  node_types.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        node_types[n] =
+            pg->GetTypeOfNodeFromPropertyIndex(sub.node_prop_indices[n]);
+      },
+      katana::no_stats());
+
+  katana::PropertyGraph::EntityTypeIDArray edge_types;
+  edge_types.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t e) {
+        edge_types[e] =
+            pg->GetTypeOfEdgeFromPropertyIndex(sub.edge_prop_indices[e]);
+      },
+      katana::no_stats());
+
+  std::shared_ptr<arrow::Table> new_node_props = KATANA_CHECKED(TakeProperties(
+      node_properties, sub.node_prop_indices,
+      [pg](const std::string& name) { return pg->GetNodeProperty(name); }));
+  std::shared_ptr<arrow::Table> new_edge_props = KATANA_CHECKED(TakeProperties(
+      edge_properties, sub.edge_prop_indices,
+      [pg](const std::string& name) { return pg->GetEdgeProperty(name); }));
+
+  std::unique_ptr<katana::PropertyGraph> sub_pg =
+      KATANA_CHECKED(katana::PropertyGraph::Make(
+          katana::GraphTopology(
+              std::move(sub.out_indices), std::move(sub.out_dests)),
+          std::move(node_types), std::move(edge_types),
+          katana::EntityTypeManager(pg->GetNodeTypeManager()),
+          katana::EntityTypeManager(pg->GetEdgeTypeManager())));
+
+  if (new_node_props->num_columns() > 0) {
+    KATANA_CHECKED(sub_pg->AddNodeProperties(new_node_props, txn_ctx));
+  }
+  if (new_edge_props->num_columns() > 0) {
+    KATANA_CHECKED(sub_pg->AddEdgeProperties(new_edge_props, txn_ctx));
+  }
+  return katana::MakeResult(std::move(sub_pg));
+}
+
+/// \returns the nodes of node_vec without duplicates, in the order of their
+/// first appearance
+std::vector<Node>
+Deduplicate(const std::vector<Node>& node_vec) {
   std::unordered_set<uint32_t> set;
   std::vector<uint32_t> dedup_node_vec;
   for (auto n : node_vec) {
@@ -104,9 +233,18 @@ katana::analytics::SubGraphExtraction(
       dedup_node_vec.push_back(n);
     }
   }
+  return dedup_node_vec;
+}
 
-  if (dedup_node_vec.empty()) {
-    return std::make_unique<katana::PropertyGraph>();
+katana::Result<SubGraphTopology>
+ExtractSubGraphTopology(
+    katana::PropertyGraph* pg, const std::vector<Node>& node_set,
+    SubGraphExtractionPlan plan) {
+  for (auto n : node_set) {
+    if (n >= pg->topology().NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "node {} is not in graph", n);
+    }
   }
 
   SortedGraphView sg = pg->BuildView<SortedGraphView>();
@@ -115,12 +253,54 @@ katana::analytics::SubGraphExtraction(
   switch (plan.algorithm()) {
   case SubGraphExtractionPlan::kNodeSet: {
     execTime.start();
-    auto subgraph = SubGraphNodeSet(sg, dedup_node_vec);
+    SubGraphTopology sub = SubGraphNodeSet(sg, node_set);
     execTime.stop();
-    KATANA_LOG_DEBUG_ASSERT(subgraph);
-    return std::move(subgraph.value());
+    return katana::MakeResult(std::move(sub));
   }
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtraction(
+    katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
+    SubGraphExtractionPlan plan) {
+  return SubGraphExtraction(pg, node_vec, {}, {}, nullptr, plan);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtraction(
+    katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
+    katana::TxnContext* txn_ctx, SubGraphExtractionPlan plan) {
+  std::vector<Node> dedup_node_vec = Deduplicate(node_vec);
+  if (dedup_node_vec.empty()) {
+    return std::make_unique<katana::PropertyGraph>();
+  }
+
+  SubGraphTopology sub =
+      KATANA_CHECKED(ExtractSubGraphTopology(pg, dedup_node_vec, plan));
+  return MakeSubGraphCopy(
+      pg, std::move(sub), node_properties_to_copy, edge_properties_to_copy,
+      txn_ctx);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtractionView(
+    katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
+    SubGraphExtractionPlan plan) {
+  std::vector<Node> dedup_node_vec = Deduplicate(node_vec);
+  SubGraphTopology sub;
+  if (!dedup_node_vec.empty()) {
+    sub = KATANA_CHECKED(ExtractSubGraphTopology(pg, dedup_node_vec, plan));
+  }
+  return katana::PropertyGraph::MakeProjectedGraph(
+      *pg, katana::GraphTopology{
+               std::move(sub.out_indices), std::move(sub.out_dests),
+               std::move(sub.edge_prop_indices),
+               std::move(sub.node_prop_indices)});
+}
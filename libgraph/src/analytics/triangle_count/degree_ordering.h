@@ -0,0 +1,30 @@
+#ifndef KATANA_LIBGRAPH_ANALYTICS_TRIANGLECOUNT_DEGREEORDERING_H_
+#define KATANA_LIBGRAPH_ANALYTICS_TRIANGLECOUNT_DEGREEORDERING_H_
+
+#include "katana/GraphTopology.h"
+
+/// The orientation of a symmetric graph by degree that the ordered counts of
+/// triangles and larger cliques share: in a view where the nodes are sorted
+/// by degree, each undirected edge is kept only from its larger node, so
+/// every node has at most O(sqrt(|E|)) edges and each clique is found once,
+/// from its largest node.
+namespace katana::analytics::internal {
+
+using DegreeSortedGraphView =
+    katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+
+/// \returns the number of destinations of the edges of n smaller than bound,
+/// which are the first ones in a view sorted by destination
+size_t CountSmaller(
+    const DegreeSortedGraphView* graph, DegreeSortedGraphView::Node n,
+    DegreeSortedGraphView::Node bound);
+
+/// \returns the topology of the edges of graph to smaller nodes, without
+/// self loops or parallel edges, in which each triangle is found once from
+/// its largest node. Its nodes are those of graph and its edges are sorted
+/// by destination.
+katana::GraphTopology OrientedTopology(const DegreeSortedGraphView* graph);
+
+}  // namespace katana::analytics::internal
+
+#endif
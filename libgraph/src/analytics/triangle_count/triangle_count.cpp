@@ -19,16 +19,41 @@
 
 #include "katana/analytics/triangle_count/triangle_count.h"
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "degree_ordering.h"
+#include "katana/ErrorCode.h"
+#include "katana/ParallelSTL.h"
+#include "katana/SortedIntersection.h"
 #include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
 
-using SortedGraphView =
-    katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+using SortedGraphView = katana::analytics::internal::DegreeSortedGraphView;
 using Node = SortedGraphView::Node;
 using edge_iterator = SortedGraphView::edge_iterator;
 
 constexpr static const unsigned kChunkSize = 16U;
+/// Nodes with at least this many smaller neighbors intersect their edges
+/// with those of their neighbors through a bitmap
+constexpr static const size_t kHubDegree = 1024;
+
+static_assert(
+    sizeof(Node) == sizeof(uint32_t),
+    "the intersection kernels need 32-bit node IDs");
+
+using katana::analytics::internal::CountSmaller;
+using katana::analytics::internal::OrientedTopology;
+
+size_t
+katana::analytics::internal::CountSmaller(
+    const SortedGraphView* graph, Node n, Node bound) {
+  const Node* dsts = graph->OutEdgeDsts(n);
+  return std::lower_bound(dsts, dsts + graph->OutDegree(n), bound) - dsts;
+}
 
 /**
  * Like std::lower_bound but doesn't dereference iterators. Returns the first
@@ -188,15 +213,51 @@ OrderedCountFunc(
   numTriangles += numTriangles_local;
 }
 
+/**
+ * OrderedCountFunc for graphs without self loops and parallel edges, which
+ * intersects the smaller neighbors of n before v with those of v, through a
+ * bitmap of the neighbors of n if n is a hub.
+ */
+void
+OrderedCountIntersectFunc(
+    const SortedGraphView* graph, Node n, katana::SortedSetBitmap* hub,
+    katana::GAccumulator<size_t>& numTriangles) {
+  const Node* n_dsts = graph->OutEdgeDsts(n);
+  size_t n_smaller = CountSmaller(graph, n, n);
+  bool is_hub = n_smaller >= kHubDegree;
+  if (is_hub) {
+    hub->Assign(n_dsts, n_smaller);
+  }
+
+  size_t numTriangles_local = 0;
+  for (size_t i = 0; i < n_smaller; ++i) {
+    Node v = n_dsts[i];
+    const Node* v_dsts = graph->OutEdgeDsts(v);
+    size_t v_smaller = CountSmaller(graph, v, v);
+    // The neighbors of n smaller than v are the first i
+    numTriangles_local +=
+        is_hub ? hub->IntersectionSize(v_dsts, v_smaller)
+               : katana::SortedIntersectionSize(n_dsts, i, v_dsts, v_smaller);
+  }
+  numTriangles += numTriangles_local;
+}
+
 /*
  * Simple counting loop, instead of binary searching.
  */
 size_t
-OrderedCountAlgo(const SortedGraphView* graph) {
+OrderedCountAlgo(const SortedGraphView* graph, bool simple) {
   katana::GAccumulator<size_t> numTriangles;
+  katana::PerThreadStorage<katana::SortedSetBitmap> hubs;
   katana::do_all(
       katana::iterate(*graph),
-      [&](const Node& n) { OrderedCountFunc(graph, n, numTriangles); },
+      [&](const Node& n) {
+        if (simple) {
+          OrderedCountIntersectFunc(graph, n, hubs.getLocal(), numTriangles);
+        } else {
+          OrderedCountFunc(graph, n, numTriangles);
+        }
+      },
       katana::chunk_size<kChunkSize>(), katana::steal(),
       katana::loopname("TriangleCount_OrderedCountAlgo"));
 
@@ -217,7 +278,7 @@ OrderedCountAlgo(const SortedGraphView* graph) {
  * Thesis. Universitat Karlsruhe. 2007.
  */
 size_t
-EdgeIteratingAlgo(const SortedGraphView* graph) {
+EdgeIteratingAlgo(const SortedGraphView* graph, bool simple) {
   struct WorkItem {
     Node src;
     Node dst;
@@ -244,6 +305,16 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
       [&](const WorkItem& w) {
         // Compute intersection of range (w.src, w.dst) in neighbors of
         // w.src and w.dst
+        if (simple) {
+          const Node* a = graph->OutEdgeDsts(w.src);
+          const Node* b = graph->OutEdgeDsts(w.dst);
+          size_t a_begin = CountSmaller(graph, w.src, w.src + 1);
+          size_t b_begin = CountSmaller(graph, w.dst, w.src + 1);
+          numTriangles += katana::SortedIntersectionSize(
+              a + a_begin, CountSmaller(graph, w.src, w.dst) - a_begin,
+              b + b_begin, CountSmaller(graph, w.dst, w.dst) - b_begin);
+          return;
+        }
         edge_iterator abegin = graph->OutEdges(w.src).begin();
         edge_iterator aend = graph->OutEdges(w.src).end();
         edge_iterator bbegin = graph->OutEdges(w.dst).begin();
@@ -266,6 +337,190 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
   return numTriangles.reduce();
 }
 
+/// Samples are drawn in blocks of this many, each from its own generator,
+/// so the samples do not depend on the number of threads
+constexpr static const uint64_t kSampleBlockSize = 4096;
+
+/// The z such that a standard normal variable is in [-z, z] with
+/// probability confidence
+double
+NormalQuantile(double confidence) {
+  double lo = 0;
+  double hi = 40;
+  for (int i = 0; i < 100; ++i) {
+    double mid = (lo + hi) / 2;
+    (std::erf(mid / std::sqrt(2.0)) < confidence ? lo : hi) = mid;
+  }
+  return hi;
+}
+
+/**
+ * Estimate scale times the mean of num_samples values sample(&gen) with a
+ * confidence interval from the normal approximation of the mean.
+ */
+template <typename Sample>
+TriangleCountEstimate
+EstimateMean(double scale, const TriangleCountPlan& plan, Sample sample) {
+  struct Sums {
+    double sum{};
+    double sum_squares{};
+  };
+  uint64_t num_samples = plan.num_samples();
+  uint64_t num_blocks = (num_samples + kSampleBlockSize - 1) / kSampleBlockSize;
+  std::vector<Sums> block_sums(num_blocks);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        std::mt19937_64 gen(plan.seed() ^ (block * 0x9e3779b97f4a7c15ULL));
+        uint64_t end = std::min(num_samples, (block + 1) * kSampleBlockSize);
+        Sums& sums = block_sums[block];
+        for (uint64_t i = block * kSampleBlockSize; i < end; ++i) {
+          double x = sample(&gen);
+          sums.sum += x;
+          sums.sum_squares += x * x;
+        }
+      },
+      katana::steal(), katana::loopname("TriangleCount_Sample"));
+
+  Sums total;
+  for (const Sums& sums : block_sums) {
+    total.sum += sums.sum;
+    total.sum_squares += sums.sum_squares;
+  }
+  double n = num_samples;
+  double mean = total.sum / n;
+  double variance =
+      n > 1 ? std::max(0.0, (total.sum_squares - n * mean * mean) / (n - 1))
+            : 0.0;
+  double half_width = NormalQuantile(plan.confidence()) *
+                      std::sqrt(variance / n) * scale;
+  double estimate = mean * scale;
+  return TriangleCountEstimate{
+      estimate, std::max(0.0, estimate - half_width), estimate + half_width,
+      num_samples};
+}
+
+/// Three times the mean of whether a uniformly sampled wedge is closed,
+/// times the number of wedges
+TriangleCountEstimate
+WedgeSamplingAlgo(const SortedGraphView* graph, const TriangleCountPlan& plan) {
+  // wedges[n] is the number of wedges centered at nodes up to n
+  std::vector<uint64_t> wedges(graph->NumNodes());
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](Node n) {
+        uint64_t degree = graph->OutDegree(n);
+        wedges[n] = degree < 2 ? 0 : degree * (degree - 1) / 2;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      wedges.begin(), wedges.end(), wedges.begin());
+  uint64_t num_wedges = wedges.empty() ? 0 : wedges.back();
+  if (num_wedges == 0) {
+    return TriangleCountEstimate{0, 0, 0, plan.num_samples()};
+  }
+
+  return EstimateMean(
+      num_wedges / 3.0, plan, [&](std::mt19937_64* gen) -> double {
+        uint64_t wedge =
+            std::uniform_int_distribution<uint64_t>(0, num_wedges - 1)(*gen);
+        Node center =
+            std::upper_bound(wedges.begin(), wedges.end(), wedge) -
+            wedges.begin();
+        const Node* dsts = graph->OutEdgeDsts(center);
+        size_t degree = graph->OutDegree(center);
+        size_t i = std::uniform_int_distribution<size_t>(0, degree - 1)(*gen);
+        size_t j = std::uniform_int_distribution<size_t>(0, degree - 2)(*gen);
+        j += j >= i;
+        Node a = dsts[i];
+        const Node* a_dsts = graph->OutEdgeDsts(a);
+        return std::binary_search(
+            a_dsts, a_dsts + graph->OutDegree(a), dsts[j]);
+      });
+}
+
+/// The mean of the common neighbors of the endpoints of a uniformly sampled
+/// edge, times the number of edges over six
+TriangleCountEstimate
+EdgeSamplingAlgo(const SortedGraphView* graph, const TriangleCountPlan& plan) {
+  uint64_t num_edges = graph->NumEdges();
+  if (num_edges == 0) {
+    return TriangleCountEstimate{0, 0, 0, plan.num_samples()};
+  }
+
+  return EstimateMean(
+      num_edges / 6.0, plan, [&](std::mt19937_64* gen) -> double {
+        uint64_t e =
+            std::uniform_int_distribution<uint64_t>(0, num_edges - 1)(*gen);
+        Node u = graph->GetEdgeSrc(e);
+        Node v = graph->OutEdgeDst(e);
+        if (u == v) {
+          return 0;
+        }
+        return katana::SortedIntersectionSize(
+            graph->OutEdgeDsts(u), graph->OutDegree(u), graph->OutEdgeDsts(v),
+            graph->OutDegree(v));
+      });
+}
+
+katana::Result<TriangleCountEstimate>
+SamplingAlgo(const SortedGraphView* graph, const TriangleCountPlan& plan) {
+  if (plan.num_samples() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "num_samples must be positive");
+  }
+  if (!(plan.confidence() > 0 && plan.confidence() < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "confidence {} must be in (0, 1)",
+        plan.confidence());
+  }
+
+  TriangleCountEstimate estimate =
+      plan.algorithm() == TriangleCountPlan::kEdgeSampling
+          ? EdgeSamplingAlgo(graph, plan)
+          : WedgeSamplingAlgo(graph, plan);
+  katana::ReportStatSingle("TriangleCount", "Samples", estimate.num_samples);
+  katana::ReportStatSingle(
+      "TriangleCount", "ConfidenceIntervalLower", estimate.lower);
+  katana::ReportStatSingle(
+      "TriangleCount", "ConfidenceIntervalUpper", estimate.upper);
+  return estimate;
+}
+
+katana::GraphTopology
+katana::analytics::internal::OrientedTopology(const SortedGraphView* graph) {
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(graph->NumNodes());
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const Node& n) {
+        const Node* dsts = graph->OutEdgeDsts(n);
+        size_t smaller = CountSmaller(graph, n, n);
+        uint64_t distinct = 0;
+        for (size_t i = 0; i < smaller; ++i) {
+          distinct += i == 0 || dsts[i] != dsts[i - 1];
+        }
+        adj_indices[n] = distinct;
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(
+      graph->NumNodes() > 0 ? adj_indices[graph->NumNodes() - 1] : 0);
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const Node& n) {
+        const Node* dsts = graph->OutEdgeDsts(n);
+        std::unique_copy(
+            dsts, dsts + CountSmaller(graph, n, n),
+            dests.begin() + (n > 0 ? adj_indices[n - 1] : 0));
+      },
+      katana::steal(), katana::no_stats());
+  return katana::GraphTopology(std::move(adj_indices), std::move(dests));
+}
+
 katana::Result<uint64_t>
 katana::analytics::TriangleCount(
     katana::PropertyGraph* pg, TriangleCountPlan plan) {
@@ -343,10 +598,17 @@ katana::analytics::TriangleCount(
     total_count = NodeIteratingAlgo(&sorted_view);
     break;
   case TriangleCountPlan::kEdgeIteration:
-    total_count = EdgeIteratingAlgo(&sorted_view);
+    total_count = EdgeIteratingAlgo(
+        &sorted_view, !HasSelfLoopsOrParallelEdges(sorted_view));
     break;
   case TriangleCountPlan::kOrderedCount:
-    total_count = OrderedCountAlgo(&sorted_view);
+    total_count = OrderedCountAlgo(
+        &sorted_view, !HasSelfLoopsOrParallelEdges(sorted_view));
+    break;
+  case TriangleCountPlan::kEdgeSampling:
+  case TriangleCountPlan::kWedgeSampling:
+    total_count = std::llround(
+        KATANA_CHECKED(SamplingAlgo(&sorted_view, plan)).estimate);
     break;
   default:
     return katana::ErrorCode::InvalidArgument;
@@ -355,3 +617,20 @@ katana::analytics::TriangleCount(
 
   return total_count;
 }
+
+katana::Result<TriangleCountEstimate>
+katana::analytics::EstimateTriangleCount(
+    katana::PropertyGraph* pg, TriangleCountPlan plan) {
+  if (plan.algorithm() != TriangleCountPlan::kEdgeSampling &&
+      plan.algorithm() != TriangleCountPlan::kWedgeSampling) {
+    auto count = static_cast<double>(KATANA_CHECKED(TriangleCount(pg, plan)));
+    return TriangleCountEstimate{count, count, count, 0};
+  }
+
+  SortedGraphView sorted_view = pg->BuildView<SortedGraphView>();
+  katana::StatTimer exec_time("TriangleCount", "TriangleCount");
+  exec_time.start();
+  auto estimate = KATANA_CHECKED(SamplingAlgo(&sorted_view, plan));
+  exec_time.stop();
+  return estimate;
+}
@@ -0,0 +1,122 @@
+#include <fstream>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/BulkLoader.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+katana::URI
+WriteFile(const katana::URI& dir, const std::string& name, const char* text) {
+  katana::URI uri = dir.Join(name);
+  std::ofstream out(uri.path());
+  out << text;
+  KATANA_LOG_ASSERT(out);
+  return uri;
+}
+
+std::vector<int64_t>
+Int64Values(const arrow::ChunkedArray& column) {
+  std::vector<int64_t> values;
+  for (const auto& chunk : column.chunks()) {
+    const auto& typed = static_cast<const arrow::Int64Array&>(*chunk);
+    for (int64_t i = 0; i < typed.length(); ++i) {
+      values.emplace_back(typed.Value(i));
+    }
+  }
+  return values;
+}
+
+/// Two node tables and two edge tables of a graph with string ids; edges
+/// come in no particular order of source
+void
+TestStringIds(const katana::URI& dir) {
+  std::vector<katana::URI> nodes{
+      WriteFile(dir, "nodes0.csv", "id,age\na,10\nb,20\n"),
+      WriteFile(dir, "nodes1.csv", "id,age\nc,30\n"),
+  };
+  std::vector<katana::URI> edges{
+      WriteFile(dir, "edges0.csv", "source,destination,weight\nc,a,1\na,b,2\n"),
+      WriteFile(dir, "edges1.csv", "source,destination,weight\na,c,3\nb,c,4\n"),
+  };
+
+  katana::TxnContext txn_ctx;
+  auto res = katana::LoadGraphFromTables(
+      nodes, edges, katana::BulkLoadOptions(), &txn_ctx);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(res.value());
+
+  const katana::GraphTopology& topology = pg->topology();
+  KATANA_LOG_ASSERT(topology.NumNodes() == 3);
+  KATANA_LOG_ASSERT(topology.NumEdges() == 4);
+  // out-edges of each node keep their table order
+  std::vector<std::pair<uint32_t, uint32_t>> expected{
+      {0, 1}, {0, 2}, {1, 2}, {2, 0}};
+  std::vector<std::pair<uint32_t, uint32_t>> found;
+  for (auto node : topology.Nodes()) {
+    for (auto e : topology.OutEdges(node)) {
+      found.emplace_back(node, topology.OutEdgeDst(e));
+    }
+  }
+  KATANA_LOG_ASSERT(found == expected);
+
+  auto ages = pg->GetNodeProperty("age");
+  KATANA_LOG_ASSERT(ages);
+  KATANA_LOG_ASSERT(
+      Int64Values(*ages.value()) == (std::vector<int64_t>{10, 20, 30}));
+  auto weights = pg->GetEdgeProperty("weight");
+  KATANA_LOG_ASSERT(weights);
+  KATANA_LOG_ASSERT(
+      Int64Values(*weights.value()) == (std::vector<int64_t>{2, 3, 4, 1}));
+  KATANA_LOG_ASSERT(!pg->GetEdgeProperty("source"));
+}
+
+/// Integer ids, and edges to nodes that do not exist
+void
+TestDanglingEdges(const katana::URI& dir) {
+  std::vector<katana::URI> nodes{
+      WriteFile(dir, "int-nodes.csv", "id\n7\n3\n"),
+  };
+  std::vector<katana::URI> edges{
+      WriteFile(dir, "int-edges.csv", "source,destination\n3,7\n3,5\n9,7\n"),
+  };
+
+  katana::TxnContext txn_ctx;
+  katana::BulkLoadOptions options;
+  KATANA_LOG_ASSERT(
+      !katana::LoadGraphFromTables(nodes, edges, options, &txn_ctx));
+
+  options.drop_dangling_edges = true;
+  auto res = katana::LoadGraphFromTables(nodes, edges, options, &txn_ctx);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  const katana::GraphTopology& topology = res.value()->topology();
+  KATANA_LOG_ASSERT(topology.NumNodes() == 2);
+  KATANA_LOG_ASSERT(topology.NumEdges() == 1);
+  KATANA_LOG_ASSERT(topology.OutDegree(1) == 1);
+  KATANA_LOG_ASSERT(topology.OutEdgeDst(*topology.OutEdges(1).begin()) == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::URI::MakeRand("/tmp/bulkloader");
+  KATANA_LOG_ASSERT(uri_res);
+  katana::URI dir = uri_res.value();
+  fs::create_directories(dir.path());
+
+  TestStringIds(dir);
+  TestDanglingEdges(dir);
+
+  fs::remove_all(dir.path());
+  return 0;
+}
@@ -0,0 +1,290 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TcpCommBackend.h"
+#include "katana/URI.h"
+#include "katana/analytics/distributed/distributed.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+namespace {
+
+using katana::analytics::DistributedGraph;
+
+constexpr uint32_t kNumHosts = 3;
+constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+constexpr unsigned int kIterations = 10;
+
+uint32_t
+Weight(uint32_t src, uint32_t dst) {
+  return (src * 7 + dst) % 5 + 1;
+}
+
+std::vector<uint32_t>
+ExpectedBfs(const katana::GraphTopology& topo, uint32_t source) {
+  std::vector<uint32_t> level(topo.NumNodes(), kInfinity);
+  std::deque<uint32_t> queue{source};
+  level[source] = 0;
+  while (!queue.empty()) {
+    uint32_t u = queue.front();
+    queue.pop_front();
+    for (auto e : topo.OutEdges(u)) {
+      uint32_t v = topo.OutEdgeDst(e);
+      if (level[v] == kInfinity) {
+        level[v] = level[u] + 1;
+        queue.push_back(v);
+      }
+    }
+  }
+  return level;
+}
+
+std::vector<uint32_t>
+ExpectedSssp(const katana::GraphTopology& topo, uint32_t source) {
+  using Item = std::pair<uint32_t, uint32_t>;
+  std::vector<uint32_t> dist(topo.NumNodes(), kInfinity);
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+  dist[source] = 0;
+  heap.emplace(0, source);
+  while (!heap.empty()) {
+    auto [d, u] = heap.top();
+    heap.pop();
+    if (d != dist[u]) {
+      continue;
+    }
+    for (auto e : topo.OutEdges(u)) {
+      uint32_t v = topo.OutEdgeDst(e);
+      uint32_t nd = d + Weight(u, v);
+      if (nd < dist[v]) {
+        dist[v] = nd;
+        heap.emplace(nd, v);
+      }
+    }
+  }
+  return dist;
+}
+
+uint32_t
+FindRoot(std::vector<uint32_t>* parent, uint32_t node) {
+  while ((*parent)[node] != node) {
+    node = (*parent)[node] = (*parent)[(*parent)[node]];
+  }
+  return node;
+}
+
+std::vector<uint32_t>
+ExpectedComponents(const katana::GraphTopology& topo) {
+  std::vector<uint32_t> parent(topo.NumNodes());
+  std::iota(parent.begin(), parent.end(), 0);
+  for (auto u : topo.Nodes()) {
+    for (auto e : topo.OutEdges(u)) {
+      uint32_t a = FindRoot(&parent, u);
+      uint32_t b = FindRoot(&parent, topo.OutEdgeDst(e));
+      parent[std::max(a, b)] = std::min(a, b);
+    }
+  }
+  for (auto u : topo.Nodes()) {
+    parent[u] = FindRoot(&parent, u);
+  }
+  return parent;
+}
+
+std::vector<float>
+ExpectedPagerank(
+    const katana::GraphTopology& topo,
+    const katana::analytics::PagerankPlan& plan) {
+  std::vector<float> rank(topo.NumNodes(), 1.0f / topo.NumNodes());
+  for (unsigned int i = 0; i < plan.max_iterations(); ++i) {
+    std::vector<float> sum(topo.NumNodes(), 0);
+    for (auto u : topo.Nodes()) {
+      uint64_t degree = topo.OutDegree(u);
+      for (auto e : topo.OutEdges(u)) {
+        sum[topo.OutEdgeDst(e)] += rank[u] / degree;
+      }
+    }
+    for (auto u : topo.Nodes()) {
+      rank[u] = sum[u] * plan.alpha() + (1.0f - plan.alpha());
+    }
+  }
+  return rank;
+}
+
+/// Check the value of every local node, mirrors included, against the
+/// expected value of its global node
+template <typename T, typename Equal>
+void
+CheckLocal(
+    const DistributedGraph& graph, const katana::NUMAArray<T>& values,
+    const std::vector<T>& expected, const char* name, const Equal& equal) {
+  for (uint64_t n = 0; n < graph.NumLocalNodes(); ++n) {
+    uint32_t global = graph.GlobalId(n);
+    KATANA_LOG_VASSERT(
+        equal(values[n], expected[global]), "{} of node {}: {} != {}", name,
+        global, values[n], expected[global]);
+  }
+}
+
+void
+CheckPartition(
+    const DistributedGraph& graph, const katana::GraphTopology& topo) {
+  uint32_t rank = graph.comm()->rank();
+  const auto& bounds = graph.node_bounds();
+  KATANA_LOG_ASSERT(bounds.size() == kNumHosts + 1);
+  KATANA_LOG_ASSERT(bounds.back() == topo.NumNodes());
+  KATANA_LOG_ASSERT(graph.NumMasters() == bounds[rank + 1] - bounds[rank]);
+
+  uint64_t num_edges = graph.NumLocalEdges();
+  KATANA_LOG_ASSERT(
+      graph.comm()->Allreduce(&num_edges, 1, katana::ReduceOp::kSum));
+  KATANA_LOG_ASSERT(num_edges == topo.NumEdges());
+
+  for (uint64_t n = 0; n < graph.NumLocalNodes(); ++n) {
+    uint32_t global = graph.GlobalId(n);
+    KATANA_LOG_ASSERT(graph.LocalId(global) == n);
+    KATANA_LOG_ASSERT(graph.IsMaster(n) == (graph.HostOf(global) == rank));
+    if (graph.IsMaster(n)) {
+      KATANA_LOG_ASSERT(
+          graph.topology().OutDegree(n) == topo.OutDegree(global));
+    } else {
+      KATANA_LOG_ASSERT(graph.topology().OutDegree(n) == 0);
+    }
+  }
+}
+
+void
+RunHost(uint32_t rank, const std::string& root, const katana::URI& input) {
+  katana::SharedMemSys sys;
+  auto comm_res = katana::TcpCommBackend::Make(kNumHosts, rank, root);
+  KATANA_LOG_VASSERT(comm_res, "{}", comm_res.error());
+  katana::CommBackend* comm = comm_res.value().get();
+
+  katana::TxnContext txn_ctx;
+  auto pg_res =
+      katana::PropertyGraph::Make(input, &txn_ctx, katana::RDGLoadOptions());
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  const katana::GraphTopology& topo = pg_res.value()->topology();
+
+  // Each host reads its part of the graph from storage
+  auto graph_res = DistributedGraph::Make(comm, input, &txn_ctx);
+  KATANA_LOG_VASSERT(graph_res, "{}", graph_res.error());
+  auto graph = std::move(graph_res.value());
+  CheckPartition(*graph, topo);
+
+  auto exact = [](uint32_t a, uint32_t b) { return a == b; };
+  auto bfs_res = katana::analytics::DistributedBfs(graph.get(), 0);
+  KATANA_LOG_VASSERT(bfs_res, "{}", bfs_res.error());
+  CheckLocal(*graph, bfs_res.value(), ExpectedBfs(topo, 0), "level", exact);
+  KATANA_LOG_ASSERT(
+      !katana::analytics::DistributedBfs(graph.get(), kInfinity));
+
+  auto cc_res =
+      katana::analytics::DistributedConnectedComponents(graph.get());
+  KATANA_LOG_VASSERT(cc_res, "{}", cc_res.error());
+  CheckLocal(
+      *graph, cc_res.value(), ExpectedComponents(topo), "component", exact);
+
+  // No tolerance, so both run the same number of iterations
+  auto plan = katana::analytics::PagerankPlan::PullTopological(
+      0, kIterations, katana::analytics::PagerankPlan::kDefaultAlpha);
+  auto pr_res = katana::analytics::DistributedPagerank(graph.get(), plan);
+  KATANA_LOG_VASSERT(pr_res, "{}", pr_res.error());
+  CheckLocal(
+      *graph, pr_res.value(), ExpectedPagerank(topo, plan), "rank",
+      [](float a, float b) {
+        return std::fabs(a - b) <= 1e-4 * std::max(1.0f, b);
+      });
+
+  // The same ranges from a topology in memory
+  auto mem_res = DistributedGraph::Make(comm, topo);
+  KATANA_LOG_VASSERT(mem_res, "{}", mem_res.error());
+  auto mem_graph = std::move(mem_res.value());
+  KATANA_LOG_ASSERT(mem_graph->node_bounds() == graph->node_bounds());
+  CheckPartition(*mem_graph, topo);
+
+  const katana::GraphTopology& local = mem_graph->topology();
+  std::vector<uint32_t> weights(local.NumEdges());
+  for (uint64_t u = 0; u < mem_graph->NumMasters(); ++u) {
+    for (auto e : local.OutEdges(u)) {
+      weights[e] = Weight(
+          mem_graph->GlobalId(u), mem_graph->GlobalId(local.OutEdgeDst(e)));
+    }
+  }
+  auto sssp_res =
+      katana::analytics::DistributedSssp(mem_graph.get(), 0, weights);
+  KATANA_LOG_VASSERT(sssp_res, "{}", sssp_res.error());
+  CheckLocal(
+      *mem_graph, sssp_res.value(), ExpectedSssp(topo, 0), "distance", exact);
+}
+
+uint16_t
+FreePort() {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  KATANA_LOG_ASSERT(fd >= 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  KATANA_LOG_ASSERT(
+      bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+  socklen_t len = sizeof(addr);
+  KATANA_LOG_ASSERT(
+      getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+  close(fd);
+  return ntohs(addr.sin_port);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  cll::ParseCommandLineOptions(argc, argv);
+
+  auto uri_res = katana::URI::Make(inputFile);
+  KATANA_LOG_VASSERT(uri_res, "{}", uri_res.error());
+  auto input = uri_res.value();
+
+  // Hosts are processes, forked before any threads start, since each runs
+  // its own thread pool
+  std::string root = fmt::format("127.0.0.1:{}", FreePort());
+  std::vector<pid_t> hosts;
+  for (uint32_t rank = 0; rank < kNumHosts; ++rank) {
+    pid_t pid = fork();
+    KATANA_LOG_ASSERT(pid >= 0);
+    if (pid == 0) {
+      RunHost(rank, root, input);
+      std::exit(0);
+    }
+    hosts.emplace_back(pid);
+  }
+
+  for (pid_t pid : hosts) {
+    int status = 0;
+    KATANA_LOG_ASSERT(waitpid(pid, &status, 0) == pid);
+    KATANA_LOG_VASSERT(
+        WIFEXITED(status) && WEXITSTATUS(status) == 0,
+        "host process {} failed with status {}", pid, status);
+  }
+
+  return 0;
+}
@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/Memoize.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/node_embedding/node_embedding.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/random_walks/random_walks.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr uint32_t kWidth = 17;
+constexpr uint32_t kHeight = 11;
+
+struct TypedGrid {
+  std::unique_ptr<katana::PropertyGraph> pg;
+  katana::EntityTypeID row;
+  katana::EntityTypeID column;
+};
+
+/// A grid without diagonals whose edges within a row have the type "row"
+/// and whose edges between rows have the type "column"
+TypedGrid
+MakeTypedGrid() {
+  auto grid = katana::MakeGrid(kWidth, kHeight, false);
+  auto topo = katana::GraphTopology::Copy(grid->topology());
+
+  katana::EntityTypeManager edge_type_manager;
+  auto row_res = edge_type_manager.AddAtomicEntityType("row");
+  auto column_res = edge_type_manager.AddAtomicEntityType("column");
+  KATANA_LOG_ASSERT(row_res && column_res);
+  katana::PropertyGraph::EntityTypeIDArray edge_types;
+  edge_types.allocateInterleaved(topo.NumEdges());
+  for (auto src : topo.Nodes()) {
+    for (auto e : topo.OutEdges(src)) {
+      bool same_row = topo.OutEdgeDst(e) / kWidth == src / kWidth;
+      edge_types[e] = same_row ? row_res.value() : column_res.value();
+    }
+  }
+  katana::PropertyGraph::EntityTypeIDArray node_types;
+  node_types.allocateInterleaved(topo.NumNodes());
+  std::fill(node_types.begin(), node_types.end(), katana::kUnknownEntityType);
+
+  auto pg_res = katana::PropertyGraph::Make(
+      std::move(topo), std::move(node_types), std::move(edge_types),
+      katana::EntityTypeManager{}, std::move(edge_type_manager));
+  KATANA_LOG_VASSERT(pg_res, "making the graph failed: {}", pg_res.error());
+  return {std::move(pg_res.value()), row_res.value(), column_res.value()};
+}
+
+void
+TestBfs(const TypedGrid& grid) {
+  katana::TxnContext txn_ctx;
+  // Along the rows only the first row is reachable from its first node
+  KATANA_LOG_ASSERT(Bfs(
+      grid.pg.get(), 0, "row_bfs", &txn_ctx,
+      BfsPlan::Asynchronous().WithEdgeType(grid.row)));
+  auto stats_res = BfsStatistics::Compute(grid.pg.get(), "row_bfs");
+  KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+  KATANA_LOG_VASSERT(
+      stats_res.value().n_reached_nodes == kWidth, "reached {} nodes",
+      stats_res.value().n_reached_nodes);
+
+  KATANA_LOG_ASSERT(Bfs(
+      grid.pg.get(), 0, "column_bfs", &txn_ctx,
+      BfsPlan::SynchronousDirectOpt().WithEdgeType(grid.column)));
+  stats_res = BfsStatistics::Compute(grid.pg.get(), "column_bfs");
+  KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+  KATANA_LOG_VASSERT(
+      stats_res.value().n_reached_nodes == kHeight, "reached {} nodes",
+      stats_res.value().n_reached_nodes);
+}
+
+void
+TestConnectedComponents(const TypedGrid& grid) {
+  katana::TxnContext txn_ctx;
+  for (const auto& [name, plan] :
+       {std::make_pair("row_afforest", ConnectedComponentsPlan::Afforest()),
+        std::make_pair("row_label_prop", ConnectedComponentsPlan::LabelProp()),
+        std::make_pair(
+            "row_synchronous", ConnectedComponentsPlan::Synchronous())}) {
+    KATANA_LOG_ASSERT(ConnectedComponents(
+        grid.pg.get(), name, &txn_ctx, false, plan.WithEdgeType(grid.row)));
+    auto stats_res =
+        ConnectedComponentsStatistics::Compute(grid.pg.get(), name);
+    KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+    KATANA_LOG_VASSERT(
+        stats_res.value().total_components == kHeight,
+        "{} found {} components", name, stats_res.value().total_components);
+  }
+}
+
+void
+TestPagerank(const TypedGrid& grid) {
+  katana::TxnContext txn_ctx;
+  // The rows are identical paths, so the rank of a node depends only on its
+  // column
+  for (const auto& [name, plan] :
+       {std::make_pair("row_pull", PagerankPlan::PullTopological()),
+        std::make_pair("row_push", PagerankPlan::PushSynchronous())}) {
+    KATANA_LOG_ASSERT(Pagerank(
+        grid.pg.get(), name, &txn_ctx, plan.WithEdgeType(grid.row)));
+    auto ranks_res = grid.pg->GetNodePropertyTyped<float>(name);
+    KATANA_LOG_VASSERT(ranks_res, "{}", ranks_res.error());
+    auto ranks = ranks_res.value();
+    for (uint32_t node = kWidth; node < kWidth * kHeight; ++node) {
+      float expected = ranks->Value(node % kWidth);
+      KATANA_LOG_VASSERT(
+          std::fabs(ranks->Value(node) - expected) <= 1e-4 * expected,
+          "{}: node {} has rank {}, expected {}", name, node,
+          ranks->Value(node), expected);
+    }
+  }
+}
+
+void
+TestRandomWalks(const TypedGrid& grid) {
+  auto walks_res = RandomWalks(
+      grid.pg.get(), RandomWalksPlan::Node2Vec(5, 2).WithEdgeType(grid.row));
+  KATANA_LOG_VASSERT(walks_res, "{}", walks_res.error());
+  KATANA_LOG_ASSERT(!walks_res.value().empty());
+  for (const auto& walk : walks_res.value()) {
+    for (auto node : walk) {
+      KATANA_LOG_VASSERT(
+          node / kWidth == walk.front() / kWidth,
+          "a walk from {} left its row at {}", walk.front(), node);
+    }
+  }
+}
+
+void
+TestEdge2Vec(const TypedGrid& grid) {
+  constexpr uint32_t kWalkLength = 6;
+  constexpr uint32_t kNumWalks = 2;
+  uint32_t num_types = std::max(grid.row, grid.column);
+  auto plan = RandomWalksPlan::Edge2Vec(
+      kWalkLength, kNumWalks, 0.5, 2, 2, num_types);
+  auto walks_res = RandomWalks(grid.pg.get(), plan);
+  KATANA_LOG_VASSERT(walks_res, "{}", walks_res.error());
+  KATANA_LOG_ASSERT(walks_res.value().size() == kWidth * kHeight * kNumWalks);
+  // Every node of the grid has edges, so every walk is complete
+  for (const auto& walk : walks_res.value()) {
+    KATANA_LOG_ASSERT(walk.size() == kWalkLength + 1);
+    for (size_t i = 1; i < walk.size(); ++i) {
+      auto distance = [](uint32_t x, uint32_t y) {
+        return std::max(x, y) - std::min(x, y);
+      };
+      uint32_t dx = distance(walk[i] % kWidth, walk[i - 1] % kWidth);
+      uint32_t dy = distance(walk[i] / kWidth, walk[i - 1] / kWidth);
+      KATANA_LOG_VASSERT(
+          dx + dy == 1, "{} to {} is not an edge of the grid", walk[i - 1],
+          walk[i]);
+    }
+  }
+  auto valid_res = RandomWalksAssertValid(grid.pg.get());
+  KATANA_LOG_VASSERT(valid_res, "{}", valid_res.error());
+
+  auto matrix_res = Edge2VecTransitionMatrix(grid.pg.get(), plan);
+  KATANA_LOG_VASSERT(matrix_res, "{}", matrix_res.error());
+  const std::vector<double>& matrix = matrix_res.value();
+  KATANA_LOG_ASSERT(matrix.size() == (num_types + 1) * (num_types + 1));
+  for (double bias : matrix) {
+    KATANA_LOG_VASSERT(bias > 0 && bias < 1, "bias {} is not a sigmoid", bias);
+  }
+}
+
+/// \returns the mean cosine similarity of the embeddings of pairs of nodes
+/// in the same row and of pairs of nodes in different rows
+std::pair<double, double>
+RowSimilarities(const TypedGrid& grid, const std::string& name) {
+  auto prop_res = grid.pg->GetNodeProperty(name);
+  KATANA_LOG_VASSERT(prop_res, "{}", prop_res.error());
+  auto chunked = prop_res.value();
+  KATANA_LOG_ASSERT(chunked->num_chunks() == 1);
+  const auto& lists =
+      static_cast<const arrow::FixedSizeListArray&>(*chunked->chunk(0));
+  int32_t dimensions = lists.value_length();
+  const float* values =
+      static_cast<const arrow::FloatArray&>(*lists.values()).raw_values();
+
+  double same[2] = {0, 0};
+  double other[2] = {0, 0};
+  for (uint32_t a = 0; a < kWidth * kHeight; ++a) {
+    for (uint32_t b = a + 1; b < kWidth * kHeight; ++b) {
+      double dot = 0;
+      double norm_a = 0;
+      double norm_b = 0;
+      for (int32_t d = 0; d < dimensions; ++d) {
+        float x = values[a * dimensions + d];
+        float y = values[b * dimensions + d];
+        dot += x * y;
+        norm_a += x * x;
+        norm_b += y * y;
+      }
+      double* sum = a / kWidth == b / kWidth ? same : other;
+      sum[0] += dot / std::sqrt(norm_a * norm_b);
+      sum[1] += 1;
+    }
+  }
+  return {same[0] / same[1], other[0] / other[1]};
+}
+
+void
+TestNodeEmbedding(const TypedGrid& grid) {
+  katana::TxnContext txn_ctx;
+  // Walks along the rows never leave their row, so nodes of a row should be
+  // closer to each other than to nodes of other rows
+  auto walks_plan = RandomWalksPlan::Node2Vec(20, 4).WithEdgeType(grid.row);
+  auto plan = NodeEmbeddingPlan::SkipGram(16, 5, 5, 3);
+  KATANA_LOG_ASSERT(NodeEmbedding(
+      grid.pg.get(), "row_streamed_embedding", &txn_ctx, "", walks_plan,
+      plan));
+
+  auto walks_res = RandomWalksTable(grid.pg.get(), "", walks_plan);
+  KATANA_LOG_VASSERT(walks_res, "{}", walks_res.error());
+  KATANA_LOG_ASSERT(NodeEmbeddingFromWalks(
+      grid.pg.get(), walks_res.value(), "row_table_embedding", &txn_ctx,
+      plan));
+
+  for (const auto& name : {"row_streamed_embedding", "row_table_embedding"}) {
+    auto [same_row, other_rows] = RowSimilarities(grid, name);
+    KATANA_LOG_VASSERT(
+        same_row > other_rows,
+        "{}: similarity within rows {} is not above similarity across {}",
+        name, same_row, other_rows);
+  }
+}
+
+void
+TestMemoize(const TypedGrid& grid) {
+  katana::TxnContext txn_ctx;
+  auto plan = ConnectedComponentsPlan::Afforest().WithEdgeType(grid.row);
+  auto memo_res = MemoizedConnectedComponents(
+      grid.pg.get(), "memo_first", &txn_ctx, false, plan);
+  KATANA_LOG_VASSERT(memo_res, "{}", memo_res.error());
+  KATANA_LOG_ASSERT(!memo_res.value());
+
+  // the same plan on the same topology reuses the result
+  memo_res = MemoizedConnectedComponents(
+      grid.pg.get(), "memo_again", &txn_ctx, false, plan);
+  KATANA_LOG_VASSERT(memo_res, "{}", memo_res.error());
+  KATANA_LOG_ASSERT(memo_res.value());
+  auto first = grid.pg->GetNodeProperty("memo_first");
+  auto again = grid.pg->GetNodeProperty("memo_again");
+  KATANA_LOG_ASSERT(first && again);
+  KATANA_LOG_ASSERT(first.value()->Equals(*again.value()));
+
+  // another edge type is another result
+  memo_res = MemoizedConnectedComponents(
+      grid.pg.get(), "memo_column", &txn_ctx, false,
+      ConnectedComponentsPlan::Afforest().WithEdgeType(grid.column));
+  KATANA_LOG_VASSERT(memo_res, "{}", memo_res.error());
+  KATANA_LOG_ASSERT(!memo_res.value());
+  auto stats_res =
+      ConnectedComponentsStatistics::Compute(grid.pg.get(), "memo_column");
+  KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+  KATANA_LOG_ASSERT(stats_res.value().total_components == kWidth);
+
+  KATANA_LOG_ASSERT(RemoveMemoizedResults(grid.pg.get(), &txn_ctx));
+  memo_res = MemoizedConnectedComponents(
+      grid.pg.get(), "memo_removed", &txn_ctx, false, plan);
+  KATANA_LOG_VASSERT(memo_res, "{}", memo_res.error());
+  KATANA_LOG_ASSERT(!memo_res.value());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto grid = MakeTypedGrid();
+  TestBfs(grid);
+  TestConnectedComponents(grid);
+  TestPagerank(grid);
+  TestRandomWalks(grid);
+  TestEdge2Vec(grid);
+  TestNodeEmbedding(grid);
+  TestMemoize(grid);
+
+  return 0;
+}
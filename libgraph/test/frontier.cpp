@@ -0,0 +1,128 @@
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "katana/Frontier.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+namespace {
+
+constexpr size_t kWidth = 16;
+constexpr size_t kHeight = 12;
+constexpr uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+
+using Node = katana::Frontier::Node;
+
+/// Assigns BFS levels
+struct LevelOp {
+  std::vector<uint32_t>* level;
+  uint32_t next;
+
+  bool Cond(Node dst) const { return (*level)[dst] == kUnvisited; }
+
+  bool Update(Node, Node dst) {
+    (*level)[dst] = next;
+    return true;
+  }
+
+  bool UpdateAtomic(Node, Node dst) {
+    return __sync_bool_compare_and_swap(&(*level)[dst], kUnvisited, next);
+  }
+};
+
+enum class Direction { kPush, kPull, kAuto };
+
+/// The edges of the grid go right and down, so BFS from the top left corner
+/// reaches node (x, y) at level x + y
+template <typename Graph>
+void
+TestBfs(const Graph& graph, Direction direction) {
+  std::vector<uint32_t> level(graph.NumNodes(), kUnvisited);
+  level[0] = 0;
+
+  katana::Frontier frontier(graph.NumNodes());
+  frontier.Push(0);
+
+  LevelOp op{&level, 0};
+  size_t num_visited = 0;
+  while (!frontier.empty()) {
+    num_visited += frontier.size();
+    ++op.next;
+    switch (direction) {
+    case Direction::kPush:
+      frontier = katana::EdgeMapPush(graph, frontier, op, katana::no_stats());
+      break;
+    case Direction::kPull:
+      frontier = katana::EdgeMapPull(graph, &frontier, op, katana::no_stats());
+      break;
+    case Direction::kAuto:
+      frontier = katana::EdgeMap(graph, &frontier, op, katana::no_stats());
+      break;
+    }
+  }
+
+  KATANA_LOG_ASSERT(num_visited == graph.NumNodes());
+  for (size_t n = 0; n < graph.NumNodes(); ++n) {
+    KATANA_LOG_VASSERT(
+        level[n] == n % kWidth + n / kWidth, "node {} has level {}", n,
+        level[n]);
+  }
+}
+
+void
+TestConversion(size_t num_nodes) {
+  katana::Frontier frontier(num_nodes);
+  uint64_t expected_sum = 0;
+  size_t expected_size = 0;
+  for (Node n = 0; n < num_nodes; n += 3) {
+    frontier.Push(n);
+    expected_sum += n;
+    ++expected_size;
+  }
+
+  auto check = [&]() {
+    katana::GAccumulator<uint64_t> sum;
+    frontier.ForEach([&](Node n) { sum += n; }, katana::no_stats());
+    KATANA_LOG_ASSERT(sum.reduce() == expected_sum);
+    KATANA_LOG_ASSERT(frontier.size() == expected_size);
+  };
+
+  check();
+  frontier.ToDense();
+  KATANA_LOG_ASSERT(frontier.is_dense());
+  check();
+  for (Node n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_ASSERT(frontier.Contains(n) == (n % 3 == 0));
+  }
+  frontier.ToSparse();
+  KATANA_LOG_ASSERT(!frontier.is_dense());
+  check();
+
+  frontier.Adapt();
+  KATANA_LOG_ASSERT(frontier.is_dense());
+
+  frontier.Clear();
+  KATANA_LOG_ASSERT(frontier.empty());
+  frontier.Adapt();
+  KATANA_LOG_ASSERT(!frontier.is_dense());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  auto pg = katana::MakeGrid(kWidth, kHeight, false);
+  auto graph = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+
+  TestBfs(graph, Direction::kPush);
+  TestBfs(graph, Direction::kPull);
+  TestBfs(graph, Direction::kAuto);
+
+  TestConversion(1000);
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include <map>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/BatchedGather.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+// Benchmarks of the pull-style gather of PageRank, CDLP and Louvain: every
+// node reads the data of its neighbors, which are scattered over memory.
+// The plain loop (batch size 0) is compared with GatherBatched at a few batch
+// sizes.
+//
+// Graphs are Graph500 R-MAT graphs with 16 edges per node, at a scale whose
+// node data fits in the last level cache and at one where it does not.
+
+namespace {
+
+constexpr uint64_t kEdgeFactor = 16;
+
+/// What pagerank-pull reads of each in-neighbor
+struct NodeValue {
+  float value;
+  uint32_t out;
+};
+
+struct Input {
+  katana::GraphTopology topology;
+  katana::NUMAArray<NodeValue> node_data;
+};
+
+/// \returns the graph of the given scale and its node data, generated on
+/// first use
+const Input&
+GetInput(uint32_t scale) {
+  static std::map<uint32_t, Input> inputs;
+  if (auto it = inputs.find(scale); it != inputs.end()) {
+    return it->second;
+  }
+
+  katana::RandomTopologyOptions options;
+  options.seed = scale;
+  auto topo_res = katana::CreateRmatTopology(scale, kEdgeFactor, options);
+  KATANA_LOG_VASSERT(topo_res, "{}", topo_res.error());
+
+  Input input{std::move(topo_res.value()), {}};
+  input.node_data.allocateInterleaved(input.topology.NumNodes());
+  for (auto node : input.topology.Nodes()) {
+    input.node_data[node] = NodeValue{1.0f / (node + 1), node % 7 + 1};
+  }
+  return inputs.emplace(scale, std::move(input)).first->second;
+}
+
+template <size_t kBatchSize>
+void
+Gather(benchmark::State& state) {
+  const Input& input = GetInput(state.range(0));
+  const katana::GraphTopology& topo = input.topology;
+  const auto& node_data = input.node_data;
+
+  katana::NUMAArray<float> sums;
+  sums.allocateInterleaved(topo.NumNodes());
+
+  for (auto _ : state) {
+    katana::do_all(
+        katana::iterate(topo),
+        [&](auto src) {
+          float sum = 0;
+          if constexpr (kBatchSize == 0) {
+            for (auto e : topo.OutEdges(src)) {
+              const NodeValue& data = node_data[topo.OutEdgeDst(e)];
+              sum += data.value / data.out;
+            }
+          } else {
+            katana::GatherBatched<kBatchSize>(
+                topo.OutEdges(src), [&](auto e) { return topo.OutEdgeDst(e); },
+                [&](auto dst) { return &node_data[dst]; },
+                [&](auto, auto dst) {
+                  const NodeValue& data = node_data[dst];
+                  sum += data.value / data.out;
+                });
+          }
+          sums[src] = sum;
+        },
+        katana::steal(), katana::chunk_size<64>(), katana::no_stats());
+    benchmark::DoNotOptimize(sums.data());
+  }
+  state.SetItemsProcessed(state.iterations() * topo.NumEdges());
+}
+
+void
+ScaleArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"scale"});
+  for (long scale : {16, 22}) {
+    b->Args({scale});
+  }
+}
+
+BENCHMARK_TEMPLATE(Gather, 0)->Apply(ScaleArguments)->UseRealTime();
+BENCHMARK_TEMPLATE(Gather, 8)->Apply(ScaleArguments)->UseRealTime();
+BENCHMARK_TEMPLATE(Gather, 16)->Apply(ScaleArguments)->UseRealTime();
+BENCHMARK_TEMPLATE(Gather, 32)->Apply(ScaleArguments)->UseRealTime();
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
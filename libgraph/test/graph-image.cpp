@@ -0,0 +1,169 @@
+#include <algorithm>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/GraphImage.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+constexpr size_t kNumNodes = 100;
+const std::string command_line = "graph-image";
+
+std::shared_ptr<arrow::Table>
+MakeProps(const std::string& name, size_t size) {
+  arrow::Int64Builder builder;
+  KATANA_LOG_ASSERT(builder.Reserve(size).ok());
+  for (size_t i = 0; i < size; ++i) {
+    builder.UnsafeAppend(i * 7 % size);
+  }
+  std::shared_ptr<arrow::Array> array = builder.Finish().ValueOrDie();
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, arrow::int64())}), {array});
+}
+
+bool
+SameTopology(const katana::RDGTopology& a, const katana::RDGTopology& b) {
+  if (!a.Equals(b) || a.num_nodes() != b.num_nodes() ||
+      a.num_edges() != b.num_edges()) {
+    return false;
+  }
+  return a.num_edges() == 0 ||
+         std::equal(a.dests(), a.dests() + a.num_edges(), b.dests());
+}
+
+void
+AssertSameGraph(katana::PropertyGraph* g, katana::PropertyGraph* g2) {
+  KATANA_LOG_ASSERT(g2->topology().Equals(g->topology()));
+  for (size_t n = 0; n < g->NumNodes(); ++n) {
+    KATANA_LOG_ASSERT(g2->GetTypeOfNode(n) == g->GetTypeOfNode(n));
+  }
+  KATANA_LOG_ASSERT(g2->GetNumNodeProperties() == g->GetNumNodeProperties());
+  for (int i = 0, n = g->GetNumNodeProperties(); i < n; ++i) {
+    KATANA_LOG_ASSERT(g2->loaded_node_schema()->field(i)->Equals(
+        g->loaded_node_schema()->field(i)));
+    KATANA_LOG_ASSERT(g2->GetNodeProperty(i)->Equals(g->GetNodeProperty(i)));
+  }
+  KATANA_LOG_ASSERT(g2->GetNumEdgeProperties() == g->GetNumEdgeProperties());
+  for (int i = 0, n = g->GetNumEdgeProperties(); i < n; ++i) {
+    KATANA_LOG_ASSERT(g2->GetEdgeProperty(i)->Equals(g->GetEdgeProperty(i)));
+  }
+
+  // the derived topologies are cached as they were
+  auto topos = g->GetCachedTopologies();
+  auto topos2 = g2->GetCachedTopologies();
+  KATANA_LOG_ASSERT(topos && topos2);
+  KATANA_LOG_ASSERT(topos.value().size() == topos2.value().size());
+  for (size_t i = 0; i < topos.value().size(); ++i) {
+    KATANA_LOG_ASSERT(SameTopology(topos.value()[i], topos2.value()[i]));
+  }
+
+  KATANA_LOG_ASSERT(g2->HasNodeIndex("id"));
+}
+
+void
+TestWriteLoad() {
+  katana::TxnContext txn_ctx;
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 1, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps("id", kNumNodes), &txn_ctx));
+
+  auto uri_res = katana::URI::MakeRand("/tmp/graphimage");
+  KATANA_LOG_ASSERT(uri_res);
+  katana::URI rdg_dir = uri_res.value();
+  std::string image = rdg_dir.path() + ".image";
+
+  auto write_res = g->Write(rdg_dir, command_line, &txn_ctx);
+  if (!write_res) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("writing graph: {}", write_res.error());
+  }
+  auto make_res = katana::PropertyGraph::Make(rdg_dir, &txn_ctx);
+  if (!make_res) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("loading graph: {}", make_res.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(make_res.value());
+
+  // warm the graph up: views of each kind of derived topology and an index
+  pg->BuildView<katana::PropertyGraphViews::EdgeTypeAwareBiDir>();
+  pg->BuildView<katana::PropertyGraphViews::EdgesSortedByDestID>();
+  pg->BuildView<
+      katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID>();
+  KATANA_LOG_ASSERT(pg->MakeNodeIndex("id"));
+
+  auto image_res = katana::WriteGraphImage(pg.get(), image);
+  if (!image_res) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("writing image: {}", image_res.error());
+  }
+
+  auto load_res = katana::LoadGraphImage(image, rdg_dir);
+  if (!load_res) {
+    fs::remove_all(rdg_dir.path());
+    fs::remove(image);
+    KATANA_LOG_FATAL("loading image: {}", load_res.error());
+  }
+  std::shared_ptr<katana::PropertyGraph> g2 = std::move(load_res.value());
+  AssertSameGraph(pg.get(), g2.get());
+
+  // views of the restored graph use the restored topologies
+  auto view = g2->BuildView<katana::PropertyGraphViews::EdgeTypeAwareBiDir>();
+  KATANA_LOG_ASSERT(view.NumEdges() == pg->NumEdges());
+
+  // the topology of the restored graph keeps the image mapped, so it may
+  // outlive the graph
+  std::shared_ptr<const katana::GraphTopology> topo =
+      g2->BuildView<katana::PropertyGraphViews::Default>().topo_ptr();
+  g2.reset();
+  KATANA_LOG_ASSERT(topo->Equals(pg->topology()));
+
+  // images of other graphs and of older versions are refused
+  auto other_res = katana::URI::MakeRand("/tmp/graphimage");
+  KATANA_LOG_ASSERT(other_res);
+  KATANA_LOG_ASSERT(!katana::LoadGraphImage(image, other_res.value()));
+
+  KATANA_LOG_ASSERT(
+      pg->UpsertNodeProperties(MakeProps("id", kNumNodes), &txn_ctx));
+  // the change is not in the RDG yet, so no image can stand for it
+  KATANA_LOG_ASSERT(!katana::WriteGraphImage(pg.get(), image));
+  auto commit_res = pg->Commit(command_line, &txn_ctx);
+  if (!commit_res) {
+    fs::remove_all(rdg_dir.path());
+    fs::remove(image);
+    KATANA_LOG_FATAL("committing: {}", commit_res.error());
+  }
+  auto stale_res = katana::LoadGraphImage(image, rdg_dir);
+  fs::remove_all(rdg_dir.path());
+  fs::remove(image);
+  KATANA_LOG_ASSERT(!stale_res);
+  KATANA_LOG_ASSERT(stale_res.error() == katana::ErrorCode::InvalidArgument);
+}
+
+void
+TestNotAnImage() {
+  auto uri_res = katana::URI::MakeRand("/tmp/graphimage");
+  KATANA_LOG_ASSERT(uri_res);
+  KATANA_LOG_ASSERT(!katana::LoadGraphImage(
+      "/tmp/graphimage-does-not-exist", uri_res.value()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestWriteLoad();
+  TestNotAnImage();
+
+  return 0;
+}
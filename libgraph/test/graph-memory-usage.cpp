@@ -0,0 +1,94 @@
+#include <numeric>
+
+#include <arrow/api.h>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+namespace {
+
+const katana::MemoryUsageItem*
+Find(
+    const std::vector<katana::MemoryUsageItem>& items,
+    const std::string& name) {
+  for (const auto& item : items) {
+    if (item.name == name) {
+      return &item;
+    }
+  }
+  return nullptr;
+}
+
+void
+TestTopology() {
+  auto pg = katana::MakeGrid(4, 4, true);
+  auto usage = pg->GetMemoryUsage();
+  uint64_t csr_bytes = pg->NumNodes() * sizeof(katana::GraphTopology::Edge) +
+                       pg->NumEdges() * sizeof(katana::GraphTopology::Node);
+  KATANA_LOG_ASSERT(usage.topology >= csr_bytes);
+  KATANA_LOG_ASSERT(usage.views.empty());
+  KATANA_LOG_ASSERT(usage.node_properties.empty());
+  KATANA_LOG_ASSERT(usage.indexes.empty());
+  KATANA_LOG_ASSERT(usage.TotalBytes() >= usage.topology);
+}
+
+void
+TestViews() {
+  auto pg = katana::MakeGrid(4, 4, true);
+  uint64_t before = pg->GetMemoryUsage().TotalBytes();
+
+  auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+  auto usage = pg->GetMemoryUsage();
+  KATANA_LOG_VASSERT(!usage.views.empty(), "no views after building one");
+  uint64_t views_bytes = 0;
+  for (const auto& item : usage.views) {
+    KATANA_LOG_VASSERT(item.bytes > 0, "view {} is empty", item.name);
+    views_bytes += item.bytes;
+  }
+  KATANA_LOG_ASSERT(usage.TotalBytes() == before + views_bytes);
+
+  pg->DropAllTopologies();
+  KATANA_LOG_ASSERT(pg->GetMemoryUsage().views.empty());
+}
+
+void
+TestPropertiesAndIndexes() {
+  auto pg = katana::MakeGrid(4, 4, true);
+  katana::TxnContext txn_ctx;
+
+  std::vector<uint64_t> values(pg->NumNodes());
+  std::iota(values.begin(), values.end(), 0);
+  arrow::UInt64Builder builder;
+  KATANA_LOG_ASSERT(builder.AppendValues(values).ok());
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("value", arrow::uint64())}), {array});
+  KATANA_LOG_ASSERT(pg->AddNodeProperties(table, &txn_ctx));
+
+  auto usage = pg->GetMemoryUsage();
+  const auto* property = Find(usage.node_properties, "value");
+  KATANA_LOG_ASSERT(property != nullptr);
+  KATANA_LOG_ASSERT(property->bytes >= pg->NumNodes() * sizeof(uint64_t));
+
+  KATANA_LOG_ASSERT(pg->MakeNodeIndex("value"));
+  usage = pg->GetMemoryUsage();
+  const auto* index = Find(usage.indexes, "node index of value");
+  KATANA_LOG_ASSERT(index != nullptr);
+  KATANA_LOG_ASSERT(index->bytes >= pg->NumNodes() * sizeof(uint64_t));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestTopology();
+  TestViews();
+  TestPropertiesAndIndexes();
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/graph_partitioning/graph_partitioning.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+GraphPartitioningStatistics
+RunPartitioning(
+    katana::PropertyGraph* pg, uint32_t num_parts,
+    const std::string& property_name, GraphPartitioningPlan plan) {
+  katana::TxnContext txn_ctx;
+  auto res = GraphPartitioning(pg, num_parts, property_name, &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "partitioning failed: {}", res.error());
+
+  auto valid_res =
+      GraphPartitioningAssertValid(pg, num_parts, property_name, plan);
+  KATANA_LOG_VASSERT(valid_res, "invalid partition: {}", valid_res.error());
+
+  auto stats_res =
+      GraphPartitioningStatistics::Compute(pg, num_parts, property_name, plan);
+  KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+  return stats_res.value();
+}
+
+void
+TestEdgeCut() {
+  auto pg = katana::MakeGrid(32, 32, false);
+  constexpr uint32_t kNumParts = 4;
+  auto plan = GraphPartitioningPlan::Multilevel();
+  auto stats = RunPartitioning(pg.get(), kNumParts, "part", plan);
+
+  KATANA_LOG_ASSERT(stats.part_nodes.size() == kNumParts);
+  KATANA_LOG_VASSERT(
+      stats.node_imbalance <= plan.imbalance(), "node imbalance {}",
+      stats.node_imbalance);
+  // Random parts would cut three quarters of the edges
+  KATANA_LOG_VASSERT(
+      stats.cut_edges < pg->NumEdges() / 8, "cut {} of {} edges",
+      stats.cut_edges, pg->NumEdges());
+  KATANA_LOG_ASSERT(stats.replication_factor < 2);
+
+  auto boundaries = stats.NodeBoundaries();
+  KATANA_LOG_ASSERT(boundaries.size() == kNumParts + 1);
+  KATANA_LOG_ASSERT(boundaries.front() == 0);
+  KATANA_LOG_ASSERT(boundaries.back() == pg->NumNodes());
+
+  // The same seed gives the same parts
+  auto again = RunPartitioning(pg.get(), kNumParts, "again", plan);
+  KATANA_LOG_ASSERT(again.part_nodes == stats.part_nodes);
+  KATANA_LOG_ASSERT(again.cut_edges == stats.cut_edges);
+}
+
+void
+TestVertexCut() {
+  auto pg = katana::MakeGrid(32, 32, true);
+  constexpr uint32_t kNumParts = 8;
+  auto plan =
+      GraphPartitioningPlan::Multilevel(GraphPartitioningPlan::kVertexCut);
+  auto stats = RunPartitioning(pg.get(), kNumParts, "part", plan);
+
+  uint64_t edges = 0;
+  for (uint64_t part_edges : stats.part_edges) {
+    edges += part_edges;
+  }
+  KATANA_LOG_ASSERT(edges == pg->NumEdges());
+  KATANA_LOG_ASSERT(stats.cut_edges == 0);
+  KATANA_LOG_VASSERT(
+      stats.replication_factor > 1 && stats.replication_factor < 1.5,
+      "replication factor {}", stats.replication_factor);
+  KATANA_LOG_VASSERT(
+      stats.edge_imbalance < 1.5, "edge imbalance {}", stats.edge_imbalance);
+}
+
+void
+TestCornerCases() {
+  auto pg = katana::MakeFerrisWheel(50);
+  auto one = RunPartitioning(
+      pg.get(), 1, "one", GraphPartitioningPlan::Multilevel());
+  KATANA_LOG_ASSERT(one.cut_edges == 0);
+  KATANA_LOG_ASSERT(one.part_nodes[0] == pg->NumNodes());
+
+  // More parts than nodes leaves some parts empty
+  auto small = katana::MakeClique(3);
+  auto many = RunPartitioning(
+      small.get(), 5, "many", GraphPartitioningPlan::Multilevel());
+  KATANA_LOG_ASSERT(many.NodeBoundaries().back() == small->NumNodes());
+
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(!GraphPartitioning(pg.get(), 0, "none", &txn_ctx));
+  KATANA_LOG_ASSERT(!GraphPartitioning(
+      pg.get(), 2, "bad", &txn_ctx,
+      GraphPartitioningPlan::Multilevel(
+          GraphPartitioningPlan::kEdgeCut, 0.5)));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestEdgeCut();
+  TestVertexCut();
+  TestCornerCases();
+
+  return 0;
+}
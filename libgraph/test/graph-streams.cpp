@@ -0,0 +1,170 @@
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/GraphSnapshot.h"
+#include "katana/GraphStreams.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr size_t kNumNodes = 1000;
+constexpr uint32_t kNumPartitions = 3;
+constexpr int64_t kMaxBatchRows = 100;
+
+/// A node property named name whose row i is i * scale
+std::shared_ptr<arrow::Table>
+MakeProps(const std::string& name, size_t size, int64_t scale) {
+  arrow::Int64Builder builder;
+  KATANA_LOG_ASSERT(builder.Reserve(size).ok());
+  for (size_t i = 0; i < size; ++i) {
+    builder.UnsafeAppend(i * scale);
+  }
+  std::shared_ptr<arrow::Array> array = builder.Finish().ValueOrDie();
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, arrow::int64())}), {array});
+}
+
+/// All batches of all partitions of the stream of ticket, in order
+std::vector<std::shared_ptr<arrow::RecordBatch>>
+ReadAll(
+    const std::shared_ptr<const katana::GraphSnapshot>& snapshot,
+    katana::GraphStreamTicket ticket) {
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  ticket.num_partitions = kNumPartitions;
+  for (uint32_t p = 0; p < kNumPartitions; ++p) {
+    ticket.partition = p;
+    auto reader_res =
+        katana::MakeGraphStreamReader(snapshot, ticket, kMaxBatchRows);
+    KATANA_LOG_VASSERT(reader_res, "{}", reader_res.error());
+    auto reader = std::move(reader_res.value());
+
+    auto schema_res = katana::GraphStreamSchema(*snapshot, ticket);
+    KATANA_LOG_ASSERT(schema_res);
+    KATANA_LOG_ASSERT(reader->schema()->Equals(*schema_res.value()));
+
+    for (;;) {
+      std::shared_ptr<arrow::RecordBatch> batch;
+      KATANA_LOG_ASSERT(reader->ReadNext(&batch).ok());
+      if (!batch) {
+        break;
+      }
+      KATANA_LOG_ASSERT(batch->num_rows() > 0);
+      KATANA_LOG_ASSERT(batch->num_rows() <= kMaxBatchRows);
+      batches.emplace_back(std::move(batch));
+    }
+  }
+  return batches;
+}
+
+void
+TestTickets() {
+  katana::GraphStreamTicket ticket;
+  ticket.kind = katana::GraphStreamKind::kEdgeProperties;
+  ticket.partition = 2;
+  ticket.num_partitions = 5;
+  ticket.columns = {"a", "b c"};
+  auto parsed = katana::GraphStreamTicket::Parse(ticket.ToString());
+  KATANA_LOG_VASSERT(parsed, "{}", parsed.error());
+  KATANA_LOG_ASSERT(parsed.value().kind == ticket.kind);
+  KATANA_LOG_ASSERT(parsed.value().partition == 2);
+  KATANA_LOG_ASSERT(parsed.value().num_partitions == 5);
+  KATANA_LOG_ASSERT(parsed.value().columns == ticket.columns);
+
+  KATANA_LOG_ASSERT(!katana::GraphStreamTicket::Parse("nodes\n1"));
+  KATANA_LOG_ASSERT(!katana::GraphStreamTicket::Parse("vertices\n0\n1"));
+  KATANA_LOG_ASSERT(!katana::GraphStreamTicket::Parse("nodes\n1\n1"));
+  KATANA_LOG_ASSERT(!katana::GraphStreamTicket::Parse("nodes\nx\n1"));
+
+  // partitions cover the rows exactly
+  uint64_t next = 0;
+  for (uint32_t p = 0; p < 7; ++p) {
+    auto [begin, end] = katana::GraphStreamRows(100, p, 7);
+    KATANA_LOG_ASSERT(begin == next && end >= begin);
+    next = end;
+  }
+  KATANA_LOG_ASSERT(next == 100);
+}
+
+void
+TestStreams() {
+  katana::TxnContext txn_ctx;
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(kNumNodes, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps("id", kNumNodes, 1), &txn_ctx));
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps("twice", kNumNodes, 2), &txn_ctx));
+
+  auto snapshot_res = katana::GraphSnapshot::Make(*g);
+  KATANA_LOG_VASSERT(snapshot_res, "{}", snapshot_res.error());
+  std::shared_ptr<const katana::GraphSnapshot> snapshot =
+      std::move(snapshot_res.value());
+
+  // node properties, one column selected
+  katana::GraphStreamTicket ticket;
+  ticket.columns = {"twice"};
+  int64_t row = 0;
+  for (const auto& batch : ReadAll(snapshot, ticket)) {
+    KATANA_LOG_ASSERT(batch->num_columns() == 1);
+    KATANA_LOG_ASSERT(batch->schema()->field(0)->name() == "twice");
+    const auto& values =
+        static_cast<const arrow::Int64Array&>(*batch->column(0));
+    for (int64_t i = 0; i < values.length(); ++i, ++row) {
+      KATANA_LOG_ASSERT(values.Value(i) == row * 2);
+    }
+  }
+  KATANA_LOG_ASSERT(row == static_cast<int64_t>(kNumNodes));
+
+  ticket.columns = {"missing"};
+  KATANA_LOG_ASSERT(!katana::MakeGraphStreamReader(snapshot, ticket));
+
+  // the topology, edge by edge
+  const katana::GraphTopology& topo = snapshot->topology();
+  ticket.kind = katana::GraphStreamKind::kTopology;
+  ticket.columns.clear();
+  uint64_t edge = 0;
+  for (const auto& batch : ReadAll(snapshot, ticket)) {
+    const auto& src =
+        static_cast<const arrow::UInt32Array&>(*batch->column(0));
+    const auto& dst =
+        static_cast<const arrow::UInt32Array&>(*batch->column(1));
+    const auto& prop =
+        static_cast<const arrow::UInt64Array&>(*batch->column(2));
+    for (int64_t i = 0; i < batch->num_rows(); ++i, ++edge) {
+      auto edges = topo.OutEdges(src.Value(i));
+      KATANA_LOG_ASSERT(*edges.begin() <= edge && edge < *edges.end());
+      KATANA_LOG_ASSERT(dst.Value(i) == topo.OutEdgeDst(edge));
+      KATANA_LOG_ASSERT(
+          prop.Value(i) == topo.GetEdgePropertyIndexFromOutEdge(edge));
+    }
+  }
+  KATANA_LOG_ASSERT(edge == topo.NumEdges());
+
+  // batches outlive the graph they were read from
+  katana::GraphStreamTicket nodes;
+  auto reader_res = katana::MakeGraphStreamReader(snapshot, nodes);
+  KATANA_LOG_ASSERT(reader_res);
+  snapshot.reset();
+  g.reset();
+  std::shared_ptr<arrow::RecordBatch> batch;
+  KATANA_LOG_ASSERT(reader_res.value()->ReadNext(&batch).ok());
+  KATANA_LOG_ASSERT(batch && batch->num_columns() == 2);
+  const auto& ids = static_cast<const arrow::Int64Array&>(*batch->column(0));
+  KATANA_LOG_ASSERT(ids.length() > 0 && ids.Value(ids.length() - 1) > 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestTickets();
+  TestStreams();
+
+  return 0;
+}
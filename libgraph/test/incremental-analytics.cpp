@@ -0,0 +1,195 @@
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr uint32_t kNumNodes = 300;
+constexpr uint32_t kNumEdges = 450;
+constexpr uint32_t kNumUpdates = 40;
+
+using EdgeSet = std::set<std::pair<uint32_t, uint32_t>>;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const EdgeSet& edges) {
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(kNumNodes);
+  for (const auto& [src, dst] : edges) {
+    builder.AddEdge(src, dst);
+  }
+  auto pg_res = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  return std::move(pg_res.value());
+}
+
+/// A sparse random graph, the updates to it and the graph they make
+struct Delta {
+  EdgeSet before;
+  EdgeSet after;
+  EdgeUpdates updates;
+};
+
+Delta
+MakeDelta(uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  auto random_edge = [&]() {
+    uint32_t src = node(gen);
+    uint32_t dst = node(gen);
+    while (dst == src) {
+      dst = node(gen);
+    }
+    return std::make_pair(src, dst);
+  };
+
+  Delta delta;
+  while (delta.before.size() < kNumEdges) {
+    delta.before.emplace(random_edge());
+  }
+  delta.after = delta.before;
+  while (delta.updates.deleted.size() < kNumUpdates) {
+    auto it = delta.after.begin();
+    std::advance(it, node(gen) % delta.after.size());
+    delta.updates.deleted.emplace_back(*it);
+    delta.after.erase(it);
+  }
+  while (delta.updates.inserted.size() < kNumUpdates) {
+    auto edge = random_edge();
+    if (delta.before.count(edge) == 0 && delta.after.emplace(edge).second) {
+      delta.updates.inserted.emplace_back(edge);
+    }
+  }
+  return delta;
+}
+
+/// Add the node property name of from to to
+void
+CarryProperty(
+    const katana::PropertyGraph& from, katana::PropertyGraph* to,
+    const std::string& name) {
+  auto prop_res = from.GetNodeProperty(name);
+  KATANA_LOG_VASSERT(prop_res, "{}", prop_res.error());
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(name, prop_res.value()->type())}),
+      {prop_res.value()});
+  katana::TxnContext txn_ctx;
+  auto add_res = to->AddNodeProperties(table, &txn_ctx);
+  KATANA_LOG_VASSERT(add_res, "{}", add_res.error());
+}
+
+template <typename ArrayType>
+std::vector<typename ArrayType::value_type>
+ReadProperty(const katana::PropertyGraph& pg, const std::string& name) {
+  auto prop_res = pg.GetNodeProperty(name);
+  KATANA_LOG_VASSERT(prop_res, "{}", prop_res.error());
+  std::vector<typename ArrayType::value_type> values;
+  for (const auto& chunk : prop_res.value()->chunks()) {
+    const auto& array = static_cast<const ArrayType&>(*chunk);
+    for (int64_t i = 0; i < array.length(); ++i) {
+      values.emplace_back(array.Value(i));
+    }
+  }
+  KATANA_LOG_ASSERT(values.size() == pg.NumNodes());
+  return values;
+}
+
+void
+TestConnectedComponents(uint32_t seed) {
+  Delta delta = MakeDelta(seed);
+  auto before = MakeGraph(delta.before);
+  auto after = MakeGraph(delta.after);
+
+  katana::TxnContext txn_ctx;
+  auto prev_res = ConnectedComponents(before.get(), "previous", &txn_ctx);
+  KATANA_LOG_VASSERT(prev_res, "{}", prev_res.error());
+  CarryProperty(*before, after.get(), "previous");
+
+  auto inc_res = ConnectedComponentsIncremental(
+      after.get(), "previous", delta.updates, "incremental", &txn_ctx);
+  KATANA_LOG_VASSERT(inc_res, "{}", inc_res.error());
+  auto valid_res = ConnectedComponentsAssertValid(after.get(), "incremental");
+  KATANA_LOG_VASSERT(valid_res, "{}", valid_res.error());
+
+  auto full_res = ConnectedComponents(after.get(), "full", &txn_ctx);
+  KATANA_LOG_VASSERT(full_res, "{}", full_res.error());
+
+  // Component ids differ, so compare the partitions of the nodes
+  auto incremental = ReadProperty<arrow::UInt64Array>(*after, "incremental");
+  auto full = ReadProperty<arrow::UInt64Array>(*after, "full");
+  std::unordered_map<uint64_t, uint64_t> full_of;
+  std::unordered_map<uint64_t, uint64_t> incremental_of;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    auto f = full_of.emplace(incremental[n], full[n]).first;
+    auto i = incremental_of.emplace(full[n], incremental[n]).first;
+    KATANA_LOG_VASSERT(
+        f->second == full[n] && i->second == incremental[n],
+        "node {} is in incremental component {} and full component {}", n,
+        incremental[n], full[n]);
+  }
+}
+
+void
+TestPagerank(uint32_t seed) {
+  Delta delta = MakeDelta(seed);
+  auto before = MakeGraph(delta.before);
+  auto after = MakeGraph(delta.after);
+  auto plan = PagerankPlan::PushAsynchronous(1e-6);
+
+  katana::TxnContext txn_ctx;
+  auto prev_res = Pagerank(before.get(), "previous", &txn_ctx, plan);
+  KATANA_LOG_VASSERT(prev_res, "{}", prev_res.error());
+  CarryProperty(*before, after.get(), "previous");
+
+  auto inc_res = PagerankIncremental(
+      after.get(), "previous", delta.updates, "incremental", &txn_ctx, plan);
+  KATANA_LOG_VASSERT(inc_res, "{}", inc_res.error());
+
+  auto full_res = Pagerank(after.get(), "full", &txn_ctx, plan);
+  KATANA_LOG_VASSERT(full_res, "{}", full_res.error());
+
+  auto incremental = ReadProperty<arrow::FloatArray>(*after, "incremental");
+  auto full = ReadProperty<arrow::FloatArray>(*after, "full");
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(incremental[n] - full[n]) < 1e-3,
+        "node {} has incremental rank {} and full rank {}", n, incremental[n],
+        full[n]);
+  }
+
+  // Updates that name nodes outside of the graph are rejected
+  EdgeUpdates bad;
+  bad.inserted.emplace_back(0, kNumNodes);
+  auto bad_res = PagerankIncremental(
+      after.get(), "previous", bad, "bad", &txn_ctx, plan);
+  KATANA_LOG_ASSERT(!bad_res);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  for (uint32_t seed : {1, 2, 3}) {
+    TestConnectedComponents(seed);
+    TestPagerank(seed);
+  }
+
+  return 0;
+}
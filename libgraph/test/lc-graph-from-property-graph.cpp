@@ -0,0 +1,107 @@
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/LC_CSR_Graph.h"
+#include "katana/LC_InlineEdge_Graph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/ReadGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+namespace {
+
+std::unique_ptr<katana::PropertyGraph>
+MakeWeightedGrid() {
+  auto pg = katana::MakeGrid(37, 23, true);
+  katana::TxnContext txn_ctx;
+
+  std::vector<int32_t> weights(pg->NumEdges());
+  std::iota(weights.begin(), weights.end(), -100);
+  arrow::Int32Builder builder;
+  KATANA_LOG_ASSERT(builder.AppendValues(weights).ok());
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::int32())}), {array});
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(table, &txn_ctx));
+  return pg;
+}
+
+/// Checks that graph has the topology of pg and, if weighted, the weights of
+/// MakeWeightedGrid
+template <typename Graph>
+void
+CheckGraph(Graph& graph, const katana::PropertyGraph& pg, bool weighted) {
+  KATANA_LOG_ASSERT(graph.size() == pg.NumNodes());
+  KATANA_LOG_ASSERT(graph.sizeEdges() == pg.NumEdges());
+
+  auto first = *graph.begin();
+  for (auto src : pg.Nodes()) {
+    auto node = first + src;
+    auto edges = pg.OutEdges(src);
+    KATANA_LOG_ASSERT(
+        std::distance(graph.edge_begin(node), graph.edge_end(node)) ==
+        static_cast<std::ptrdiff_t>(edges.size()));
+
+    auto e = *edges.begin();
+    for (auto jj : graph.edges(node)) {
+      KATANA_LOG_VASSERT(
+          graph.getEdgeDst(jj) - first == pg.OutEdgeDst(e),
+          "edge {} of node {}", e, src);
+      if constexpr (!std::is_void_v<typename Graph::edge_data_type>) {
+        int32_t expected = 0;
+        if (weighted) {
+          expected =
+              static_cast<int32_t>(pg.GetEdgePropertyIndexFromOutEdge(e)) -
+              100;
+        }
+        KATANA_LOG_VASSERT(
+            graph.getEdgeData(jj) == expected, "edge {} has weight {}", e,
+            graph.getEdgeData(jj));
+      }
+      ++e;
+    }
+  }
+}
+
+template <typename Graph>
+void
+TestRead(const katana::PropertyGraph& pg) {
+  Graph weighted;
+  katana::readGraph(weighted, pg, "weight");
+  CheckGraph(weighted, pg, true);
+
+  Graph unweighted;
+  katana::readGraph(unweighted, pg);
+  CheckGraph(unweighted, pg, false);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  auto pg = MakeWeightedGrid();
+
+  TestRead<katana::LC_CSR_Graph<uint32_t, int32_t>>(*pg);
+  TestRead<katana::LC_CSR_Graph<uint32_t, int32_t>::with_numa_alloc<
+      true>::type>(*pg);
+  TestRead<katana::LC_InlineEdge_Graph<uint32_t, int32_t>>(*pg);
+  TestRead<katana::LC_InlineEdge_Graph<uint32_t, int32_t>::with_numa_alloc<
+      true>::type>(*pg);
+
+  katana::LC_CSR_Graph<uint32_t, void> topology_only;
+  katana::readGraph(topology_only, *pg);
+  CheckGraph(topology_only, *pg, false);
+
+  return 0;
+}
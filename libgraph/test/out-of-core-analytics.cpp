@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+#include "katana/analytics/out_of_core/out_of_core.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+namespace {
+
+constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+constexpr unsigned int kIterations = 10;
+
+std::vector<uint32_t>
+ExpectedBfs(const katana::GraphTopology& topo, uint32_t source) {
+  std::vector<uint32_t> level(topo.NumNodes(), kInfinity);
+  std::deque<uint32_t> queue{source};
+  level[source] = 0;
+  while (!queue.empty()) {
+    uint32_t u = queue.front();
+    queue.pop_front();
+    for (auto e : topo.OutEdges(u)) {
+      uint32_t v = topo.OutEdgeDst(e);
+      if (level[v] == kInfinity) {
+        level[v] = level[u] + 1;
+        queue.push_back(v);
+      }
+    }
+  }
+  return level;
+}
+
+uint32_t
+FindRoot(std::vector<uint32_t>* parent, uint32_t node) {
+  while ((*parent)[node] != node) {
+    node = (*parent)[node] = (*parent)[(*parent)[node]];
+  }
+  return node;
+}
+
+std::vector<uint32_t>
+ExpectedComponents(const katana::GraphTopology& topo) {
+  std::vector<uint32_t> parent(topo.NumNodes());
+  std::iota(parent.begin(), parent.end(), 0);
+  for (auto u : topo.Nodes()) {
+    for (auto e : topo.OutEdges(u)) {
+      uint32_t a = FindRoot(&parent, u);
+      uint32_t b = FindRoot(&parent, topo.OutEdgeDst(e));
+      parent[std::max(a, b)] = std::min(a, b);
+    }
+  }
+  for (auto u : topo.Nodes()) {
+    parent[u] = FindRoot(&parent, u);
+  }
+  return parent;
+}
+
+std::vector<float>
+ExpectedPagerank(
+    const katana::GraphTopology& topo,
+    const katana::analytics::PagerankPlan& plan) {
+  std::vector<float> rank(topo.NumNodes(), 1.0f / topo.NumNodes());
+  for (unsigned int i = 0; i < plan.max_iterations(); ++i) {
+    std::vector<float> sum(topo.NumNodes(), 0);
+    for (auto u : topo.Nodes()) {
+      uint64_t degree = topo.OutDegree(u);
+      for (auto e : topo.OutEdges(u)) {
+        sum[topo.OutEdgeDst(e)] += rank[u] / degree;
+      }
+    }
+    for (auto u : topo.Nodes()) {
+      rank[u] = sum[u] * plan.alpha() + (1.0f - plan.alpha());
+    }
+  }
+  return rank;
+}
+
+void
+TestBudget(
+    const katana::URI& input, const katana::PropertyGraph& pg,
+    uint64_t budget) {
+  const katana::GraphTopology& topo = pg.topology();
+  katana::TxnContext txn_ctx;
+  katana::analytics::OutOfCoreOptions options;
+  options.memory_budget_bytes = budget;
+  auto topo_res =
+      katana::analytics::OutOfCoreTopology::Make(input, &txn_ctx, options);
+  KATANA_LOG_VASSERT(topo_res, "{}", topo_res.error());
+  auto ooc = std::move(topo_res.value());
+
+  KATANA_LOG_ASSERT(ooc->NumNodes() == topo.NumNodes());
+  KATANA_LOG_ASSERT(ooc->NumEdges() == topo.NumEdges());
+  const auto& bounds = ooc->partition_bounds();
+  KATANA_LOG_ASSERT(bounds.front() == 0 && bounds.back() == topo.NumNodes());
+  for (uint32_t p = 0; p < ooc->NumPartitions(); ++p) {
+    KATANA_LOG_ASSERT(bounds[p] < bounds[p + 1]);
+    KATANA_LOG_ASSERT(ooc->PartitionOf(bounds[p]) == p);
+    KATANA_LOG_ASSERT(ooc->PartitionOf(bounds[p + 1] - 1) == p);
+  }
+
+  // Every edge is visited once. The topology read may sort the edges of a
+  // node differently from the one loaded, so compare them as sets.
+  uint64_t seen_edges = 0;
+  auto visit_res = ooc->ForEachPartition(
+      {}, [&](const katana::analytics::OutOfCorePartition& part) {
+        for (uint64_t u = part.begin(); u < part.end(); ++u) {
+          KATANA_LOG_ASSERT(part.OutDegree(u) == topo.OutDegree(u));
+          std::vector<uint32_t> dests;
+          std::vector<uint32_t> expected;
+          for (auto e = part.EdgesBegin(u); e < part.EdgesEnd(u); ++e) {
+            dests.emplace_back(part.OutEdgeDst(e));
+          }
+          for (auto e : topo.OutEdges(u)) {
+            expected.emplace_back(topo.OutEdgeDst(e));
+          }
+          std::sort(dests.begin(), dests.end());
+          std::sort(expected.begin(), expected.end());
+          KATANA_LOG_ASSERT(dests == expected);
+          seen_edges += dests.size();
+        }
+      });
+  KATANA_LOG_VASSERT(visit_res, "{}", visit_res.error());
+  KATANA_LOG_ASSERT(seen_edges == topo.NumEdges());
+
+  auto bfs_res = katana::analytics::OutOfCoreBfs(ooc.get(), 0);
+  KATANA_LOG_VASSERT(bfs_res, "{}", bfs_res.error());
+  auto expected_bfs = ExpectedBfs(topo, 0);
+  for (auto u : topo.Nodes()) {
+    KATANA_LOG_VASSERT(
+        bfs_res.value()[u] == expected_bfs[u], "node {}: {} != {}", u,
+        bfs_res.value()[u], expected_bfs[u]);
+  }
+  KATANA_LOG_ASSERT(!katana::analytics::OutOfCoreBfs(ooc.get(), kInfinity));
+
+  auto cc_res = katana::analytics::OutOfCoreConnectedComponents(ooc.get());
+  KATANA_LOG_VASSERT(cc_res, "{}", cc_res.error());
+  auto expected_cc = ExpectedComponents(topo);
+  for (auto u : topo.Nodes()) {
+    KATANA_LOG_VASSERT(
+        cc_res.value()[u] == expected_cc[u], "node {}: {} != {}", u,
+        cc_res.value()[u], expected_cc[u]);
+  }
+
+  // No tolerance, so both run the same number of iterations
+  auto plan = katana::analytics::PagerankPlan::PullTopological(
+      0, kIterations, katana::analytics::PagerankPlan::kDefaultAlpha);
+  auto pr_res = katana::analytics::OutOfCorePagerank(ooc.get(), plan);
+  KATANA_LOG_VASSERT(pr_res, "{}", pr_res.error());
+  auto expected_pr = ExpectedPagerank(topo, plan);
+  for (auto u : topo.Nodes()) {
+    float diff = std::fabs(pr_res.value()[u] - expected_pr[u]);
+    KATANA_LOG_VASSERT(
+        diff <= 1e-4 * std::max(1.0f, expected_pr[u]), "node {}: {} != {}",
+        u, pr_res.value()[u], expected_pr[u]);
+  }
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  cll::ParseCommandLineOptions(argc, argv);
+
+  auto uri_res = katana::URI::Make(inputFile);
+  KATANA_LOG_VASSERT(uri_res, "{}", uri_res.error());
+  auto input = uri_res.value();
+
+  katana::TxnContext txn_ctx;
+  auto pg_res =
+      katana::PropertyGraph::Make(input, &txn_ctx, katana::RDGLoadOptions());
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  const katana::PropertyGraph& pg = *pg_res.value();
+  uint64_t topology_bytes = pg.NumNodes() * sizeof(uint64_t) +
+                            pg.NumEdges() * sizeof(uint32_t);
+
+  // All in one partition, a few partitions and many partitions
+  for (uint64_t budget :
+       {UINT64_C(1) << 30, topology_bytes / 4, topology_bytes / 64}) {
+    TestBudget(input, pg, budget);
+  }
+
+  return 0;
+}
@@ -0,0 +1,138 @@
+#include <atomic>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/pattern_matching/pattern_matching.h"
+
+namespace {
+
+using katana::PropertyFilter;
+using katana::analytics::Pattern;
+
+constexpr size_t kNumNodes = 1000;
+constexpr size_t kWidth = 3;
+
+/// Node i has edges to i + 1, ..., i + kWidth, so edge e goes e % kWidth + 1
+/// nodes ahead; the edge property "hop" holds that and the node property
+/// "parity" holds i % 2
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(katana::TxnContext* txn_ctx) {
+  LinePolicy policy{kWidth};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 0, &policy, txn_ctx);
+
+  arrow::Int64Builder parity;
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    KATANA_LOG_ASSERT(parity.Append(i % 2).ok());
+  }
+  arrow::Int64Builder hop;
+  for (size_t e = 0; e < g->NumEdges(); ++e) {
+    KATANA_LOG_ASSERT(hop.Append(e % kWidth + 1).ok());
+  }
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      arrow::Table::Make(
+          arrow::schema({arrow::field("parity", arrow::int64())}),
+          {parity.Finish().ValueOrDie()}),
+      txn_ctx));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(
+      arrow::Table::Make(
+          arrow::schema({arrow::field("hop", arrow::int64())}),
+          {hop.Finish().ValueOrDie()}),
+      txn_ctx));
+  return g;
+}
+
+PropertyFilter
+Equals(const std::string& property, int64_t value) {
+  return PropertyFilter::Compare(
+      property, PropertyFilter::CompareOp::kEqual, arrow::MakeScalar(value));
+}
+
+Pattern
+Path() {
+  return Pattern{{{"a"}, {"b"}, {"c"}}, {{0, 1}, {1, 2}}};
+}
+
+Pattern
+Triangle() {
+  return Pattern{{{}, {}, {}}, {{0, 1}, {1, 2}, {0, 2}}};
+}
+
+uint64_t
+Count(katana::PropertyGraph* g, const Pattern& pattern) {
+  return katana::analytics::CountPatternMatches(g, pattern).value();
+}
+
+void
+TestPatternMatching() {
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g = MakeGraph(&txn_ctx);
+
+  // a path takes any two hops, a triangle two hops that add up to at most
+  // kWidth
+  KATANA_LOG_ASSERT(Count(g.get(), Path()) == kNumNodes * kWidth * kWidth);
+  KATANA_LOG_ASSERT(Count(g.get(), Triangle()) == kNumNodes * 3);
+
+  Pattern even_start = Triangle();
+  even_start.nodes[0].filter = Equals("parity", 0);
+  KATANA_LOG_ASSERT(Count(g.get(), even_start) == kNumNodes / 2 * 3);
+
+  Pattern short_hops = Path();
+  for (auto& edge : short_hops.edges) {
+    edge.filter = Equals("hop", 1);
+  }
+  KATANA_LOG_ASSERT(Count(g.get(), short_hops) == kNumNodes);
+
+  // hops along a cycle back to the start add up to kNumNodes
+  Pattern cycle{{{}, {}}, {{0, 1}, {1, 0}}};
+  KATANA_LOG_ASSERT(Count(g.get(), cycle) == 0);
+
+  // a small spawn degree makes every partial match a task of its own
+  KATANA_LOG_ASSERT(
+      katana::analytics::CountPatternMatches(
+          g.get(), Triangle(),
+          katana::analytics::PatternMatchingPlan::GenericJoin(0))
+          .value() == kNumNodes * 3);
+
+  std::atomic<uint64_t> num_visited{0};
+  auto check_triangle = [&](const auto& match) {
+    KATANA_LOG_ASSERT(match.size() == 3);
+    size_t ab = (match[1] + kNumNodes - match[0]) % kNumNodes;
+    size_t ac = (match[2] + kNumNodes - match[0]) % kNumNodes;
+    KATANA_LOG_VASSERT(
+        ab >= 1 && ab < ac && ac <= kWidth, "{} {} {}", match[0], match[1],
+        match[2]);
+    num_visited += 1;
+  };
+  KATANA_LOG_ASSERT(katana::analytics::ForEachPatternMatch(
+      g.get(), Triangle(), check_triangle));
+  KATANA_LOG_ASSERT(num_visited == kNumNodes * 3);
+
+  auto matches =
+      katana::analytics::FindPatternMatches(g.get(), Path(), 10).value();
+  KATANA_LOG_ASSERT(matches->num_rows() == 10);
+  std::vector<std::string> names{"a", "b", "c"};
+  KATANA_LOG_ASSERT(matches->schema()->field_names() == names);
+
+  Pattern disconnected{{{}, {}}, {}};
+  KATANA_LOG_ASSERT(
+      !katana::analytics::CountPatternMatches(g.get(), disconnected));
+  Pattern unknown_type = Path();
+  unknown_type.edges[0].type_name = "no such type";
+  KATANA_LOG_ASSERT(
+      !katana::analytics::CountPatternMatches(g.get(), unknown_type));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestPatternMatching();
+
+  return 0;
+}
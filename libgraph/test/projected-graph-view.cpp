@@ -0,0 +1,95 @@
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/ProjectedGraphView.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr size_t kNumNodes = 10007;
+
+bool
+IsSelectedNode(size_t n) {
+  return n % 3 != 0;
+}
+
+bool
+IsSelectedEdge(size_t e) {
+  return e % 5 != 1;
+}
+
+void
+TestView() {
+  LinePolicy policy{4};
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 0, &policy, &txn_ctx);
+
+  katana::DynamicBitset nodes;
+  nodes.resize(g->NumNodes());
+  katana::DynamicBitset edges;
+  edges.resize(g->NumEdges());
+  for (size_t n = 0; n < g->NumNodes(); ++n) {
+    if (IsSelectedNode(n)) {
+      nodes.set(n);
+    }
+  }
+  for (size_t e = 0; e < g->NumEdges(); ++e) {
+    if (IsSelectedEdge(e)) {
+      edges.set(e);
+    }
+  }
+
+  auto view = katana::ProjectedGraphView::Make(
+                  g.get(), std::move(nodes), std::move(edges))
+                  .value();
+  KATANA_LOG_ASSERT(!view->IsMaterialized());
+
+  size_t num_nodes = 0;
+  size_t num_edges = 0;
+  for (auto n : g->Nodes()) {
+    KATANA_LOG_ASSERT(view->ContainsNode(n) == IsSelectedNode(n));
+    num_nodes += view->ContainsNode(n);
+    view->ForEachOutEdge(n, [&](auto e, auto dst) {
+      KATANA_LOG_ASSERT(IsSelectedEdge(e) && IsSelectedNode(dst));
+      KATANA_LOG_ASSERT(view->ContainsEdge(n, e));
+      num_edges += 1;
+    });
+  }
+  KATANA_LOG_ASSERT(view->NumNodes() == num_nodes);
+
+  // the compacted projection has the same nodes and edges
+  katana::PropertyGraph* projected = view->Materialize().value();
+  KATANA_LOG_ASSERT(view->IsMaterialized());
+  KATANA_LOG_ASSERT(view->Materialize().value() == projected);
+  KATANA_LOG_ASSERT(projected->NumNodes() == num_nodes);
+  KATANA_LOG_ASSERT(projected->NumEdges() == num_edges);
+  for (auto n : projected->Nodes()) {
+    KATANA_LOG_ASSERT(IsSelectedNode(projected->GetNodePropertyIndex(n)));
+  }
+  view->ReleaseMaterialized();
+  KATANA_LOG_ASSERT(!view->IsMaterialized());
+
+  // no types is every node and edge
+  auto all =
+      katana::ProjectedGraphView::Make(g.get(), std::nullopt, std::nullopt)
+          .value();
+  KATANA_LOG_ASSERT(all->NumNodes() == g->NumNodes());
+  KATANA_LOG_ASSERT(all->edge_selection() == nullptr);
+  KATANA_LOG_ASSERT(all->Materialize().value()->NumEdges() == g->NumEdges());
+
+  katana::DynamicBitset too_small;
+  too_small.resize(g->NumNodes() - 1);
+  KATANA_LOG_ASSERT(
+      !katana::ProjectedGraphView::Make(g.get(), std::move(too_small)));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestView();
+
+  return 0;
+}
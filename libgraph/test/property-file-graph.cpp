@@ -1,11 +1,19 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+
 #include <arrow/api.h>
 #include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
+#include "katana/PropertyStatistics.h"
+#include "katana/RDGManifest.h"
 #include "katana/SharedMemSys.h"
 #include "katana/URI.h"
+#include "katana/tsuba.h"
 
 namespace {
 
@@ -24,6 +32,31 @@ MakeProps(const std::string& name, size_t size) {
   return builder.Finish();
 }
 
+/// Copy the current version of pg, stored at rdg_dir, to a new directory
+/// with CopyRDG, which copies the files that RDGManifest::FileNames lists
+katana::URI
+CopyRDGToNewDir(katana::PropertyGraph* pg, const katana::URI& rdg_dir) {
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  katana::URI new_rdg_dir = uri_res.value();
+
+  auto version_res = pg->CurrentVersion();
+  KATANA_LOG_VASSERT(version_res, "{}", version_res.error());
+  auto files_res = katana::CreateSrcDestFromViewsForCopy(
+      rdg_dir, new_rdg_dir.string(), version_res.value());
+  if (!files_res) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("listing files to copy: {}", files_res.error());
+  }
+  auto copy_res = katana::CopyRDG(std::move(files_res.value()));
+  if (!copy_res) {
+    fs::remove_all(rdg_dir.path());
+    fs::remove_all(new_rdg_dir.path());
+    KATANA_LOG_FATAL("copying RDG: {}", copy_res.error());
+  }
+  return new_rdg_dir;
+}
+
 void
 TestTypesFromPropertiesCompareTypesFromStorage() {
   /*
@@ -453,6 +486,647 @@ TestTopologyAccess() {
   }
   KATANA_LOG_ASSERT(n_nodes == 10);
 }
+
+void
+TestLazyLoad() {
+  constexpr size_t test_length = 10;
+  using ValueType = int32_t;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+
+  auto add_node_result = g->AddNodeProperties(
+      MakeProps<ValueType>("node-name", test_length), &txn_ctx);
+  KATANA_LOG_ASSERT(add_node_result);
+
+  auto add_edge_result = g->AddEdgeProperties(
+      MakeProps<ValueType>("edge-name", test_length), &txn_ctx);
+  KATANA_LOG_ASSERT(add_edge_result);
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  auto rdg_dir = uri_res.value();
+
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  if (!write_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::RDGLoadOptions opts;
+  opts.lazy_load_properties = true;
+  opts.edge_properties = std::vector<std::string>{"edge-name"};
+
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g2->IsLazyLoadingProperties());
+
+  // nothing is loaded up front but everything is registered
+  KATANA_LOG_ASSERT(g2->full_node_schema()->num_fields() == 1);
+  KATANA_LOG_ASSERT(!g2->HasNodeProperty("node-name"));
+
+  auto node_property = g2->GetNodeProperty("node-name");
+  KATANA_LOG_ASSERT(node_property);
+  KATANA_LOG_ASSERT(
+      static_cast<size_t>(node_property.value()->length()) == test_length);
+  KATANA_LOG_ASSERT(g2->HasNodeProperty("node-name"));
+
+  KATANA_LOG_ASSERT(!g2->GetNodeProperty("no-such-property"));
+
+  g2->WaitForPropertyPrefetch();
+  KATANA_LOG_ASSERT(g2->HasEdgeProperty("edge-name"));
+
+  fs::remove_all(rdg_dir.path());
+
+  KATANA_LOG_ASSERT(g->Equals(g2.get()));
+}
+
+void
+TestConcurrentLazyLoad() {
+  constexpr size_t test_length = 1000;
+  constexpr size_t num_properties = 8;
+  constexpr size_t num_readers = 8;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  std::vector<std::string> names;
+  for (size_t i = 0; i < num_properties; ++i) {
+    names.emplace_back(fmt::format("node-{}", i));
+    KATANA_LOG_ASSERT(g->AddNodeProperties(
+        MakeProps<int64_t>(names.back(), test_length), &txn_ctx));
+  }
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  auto rdg_dir = uri_res.value();
+
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  if (!write_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  // the readers race the prefetch of every property and wait for it while
+  // others are still reading
+  katana::RDGLoadOptions opts;
+  opts.lazy_load_properties = true;
+  opts.node_properties = names;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  std::atomic<size_t> failures{0};
+  std::vector<std::thread> readers;
+  for (size_t r = 0; r < num_readers; ++r) {
+    readers.emplace_back([&, r]() {
+      for (size_t i = 0; i < num_properties; ++i) {
+        const std::string& name = names[(r + i) % num_properties];
+        auto prop = g2->GetNodeProperty(name);
+        if (!prop ||
+            static_cast<size_t>(prop.value()->length()) != test_length) {
+          failures += 1;
+        }
+      }
+      g2->WaitForPropertyPrefetch();
+    });
+  }
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  fs::remove_all(rdg_dir.path());
+
+  KATANA_LOG_ASSERT(failures == 0);
+  for (const auto& name : names) {
+    KATANA_LOG_ASSERT(g2->HasNodeProperty(name));
+  }
+  KATANA_LOG_ASSERT(g->Equals(g2.get()));
+}
+
+void
+TestArrowIPCStorage() {
+  constexpr size_t test_length = 10;
+  using ValueType = int64_t;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+
+  auto add_node_result = g->AddNodeProperties(
+      MakeProps<ValueType>("node-name", test_length), &txn_ctx);
+  KATANA_LOG_ASSERT(add_node_result);
+
+  auto add_edge_result = g->AddEdgeProperties(
+      MakeProps<ValueType>("edge-name", test_length), &txn_ctx);
+  KATANA_LOG_ASSERT(add_edge_result);
+
+  KATANA_LOG_ASSERT(g->SetNodePropertyStorageFormat(
+      "node-name", katana::PropertyStorageFormat::kArrowIPC));
+  KATANA_LOG_ASSERT(!g->SetNodePropertyStorageFormat(
+      "no-such-property", katana::PropertyStorageFormat::kArrowIPC));
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  auto rdg_dir = uri_res.value();
+
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  if (!write_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g->Equals(g2.get()));
+
+  // the format is remembered across unload and load
+  KATANA_LOG_ASSERT(g2->UnloadNodeProperty("node-name"));
+  KATANA_LOG_ASSERT(g2->LoadNodeProperty("node-name"));
+
+  // a copy of the RDG has the Arrow IPC file too
+  katana::URI copy_dir = CopyRDGToNewDir(g2.get(), rdg_dir);
+  fs::remove_all(rdg_dir.path());
+  auto copy_result = katana::PropertyGraph::Make(
+      copy_dir, &txn_ctx, katana::RDGLoadOptions());
+  fs::remove_all(copy_dir.path());
+  if (!copy_result) {
+    KATANA_LOG_FATAL("making copy: {}", copy_result.error());
+  }
+  KATANA_LOG_ASSERT(g2->Equals(copy_result.value().get()));
+
+  KATANA_LOG_ASSERT(g->Equals(g2.get()));
+}
+
+void
+TestPropertyDeltas() {
+  constexpr size_t test_length = 100;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-name", test_length), &txn_ctx));
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  auto rdg_dir = uri_res.value();
+
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  if (!write_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto reload = [&]() {
+    auto make_result = katana::PropertyGraph::Make(
+        rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+    if (!make_result) {
+      fs::remove_all(rdg_dir.path());
+      KATANA_LOG_FATAL("making result: {}", make_result.error());
+    }
+    return std::move(make_result.value());
+  };
+  auto value_at = [](const katana::PropertyGraph& pg, uint64_t row) {
+    auto prop = pg.GetNodeProperty("node-name");
+    KATANA_LOG_ASSERT(prop);
+    auto scalar = prop.value()->GetScalar(row);
+    KATANA_LOG_ASSERT(scalar.ok());
+    return std::static_pointer_cast<arrow::Int64Scalar>(scalar.ValueOrDie())
+        ->value;
+  };
+
+  // two commits stack two deltas on the stored property
+  std::vector<std::pair<uint64_t, int64_t>> updates{{3, -1}, {50, -2}};
+  for (const auto& [row, value] : updates) {
+    std::unique_ptr<katana::PropertyGraph> pg = reload();
+    arrow::Int64Builder builder;
+    KATANA_LOG_ASSERT(builder.Append(value).ok());
+    std::shared_ptr<arrow::Array> values = builder.Finish().ValueOrDie();
+    KATANA_LOG_ASSERT(
+        pg->UpdateNodePropertyRows("node-name", {row}, values, &txn_ctx));
+    KATANA_LOG_ASSERT(value_at(*pg, row) == value);
+    auto commit_result = pg->Commit(command_line, &txn_ctx);
+    if (!commit_result) {
+      fs::remove_all(rdg_dir.path());
+      KATANA_LOG_FATAL("committing result: {}", commit_result.error());
+    }
+  }
+
+  std::unique_ptr<katana::PropertyGraph> g2 = reload();
+
+  // a copy of the RDG has the deltas too
+  katana::URI copy_dir = CopyRDGToNewDir(g2.get(), rdg_dir);
+  fs::remove_all(rdg_dir.path());
+  auto copy_result = katana::PropertyGraph::Make(
+      copy_dir, &txn_ctx, katana::RDGLoadOptions());
+  fs::remove_all(copy_dir.path());
+  if (!copy_result) {
+    KATANA_LOG_FATAL("making copy: {}", copy_result.error());
+  }
+  KATANA_LOG_ASSERT(g2->Equals(copy_result.value().get()));
+
+  KATANA_LOG_ASSERT(value_at(*g2, 3) == -1);
+  KATANA_LOG_ASSERT(value_at(*g2, 50) == -2);
+  KATANA_LOG_ASSERT(value_at(*g2, 51) == value_at(*g, 51));
+
+  // rows past the end of the property are rejected
+  auto nulls = arrow::MakeArrayOfNull(arrow::int64(), 1).ValueOrDie();
+  KATANA_LOG_ASSERT(
+      !g2->UpdateNodePropertyRows("node-name", {test_length}, nulls, &txn_ctx));
+}
+
+void
+TestPropertyStats() {
+  constexpr size_t test_length = 100;
+  constexpr uint64_t block_size = 16;
+  katana::TxnContext txn_ctx;
+
+  setenv("KATANA_PROPERTY_STATS_BLOCK_ROWS", "16", 1);
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int32_t>("node-name", test_length), &txn_ctx));
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  auto rdg_dir = uri_res.value();
+
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  unsetenv("KATANA_PROPERTY_STATS_BLOCK_ROWS");
+  if (!write_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  // leave the property unloaded so its statistics come from the part header
+  katana::RDGLoadOptions opts;
+  opts.node_properties = std::vector<std::string>{};
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  fs::remove_all(rdg_dir.path());
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  auto stored = g2->GetNodePropertyStats("node-name");
+  KATANA_LOG_ASSERT(stored);
+  auto prop = g->GetNodeProperty("node-name");
+  KATANA_LOG_ASSERT(prop);
+  auto expected = katana::ComputePropertyStats(prop.value(), block_size);
+  KATANA_LOG_ASSERT(expected);
+
+  KATANA_LOG_ASSERT(stored.value().block_size == block_size);
+  KATANA_LOG_ASSERT(
+      stored.value().blocks.size() == expected.value().blocks.size());
+  for (size_t i = 0; i < expected.value().blocks.size(); ++i) {
+    const katana::PropertyBlockStats& a = stored.value().blocks[i];
+    const katana::PropertyBlockStats& b = expected.value().blocks[i];
+    KATANA_LOG_ASSERT(a.begin == b.begin && a.end == b.end);
+    KATANA_LOG_ASSERT(a.null_count == b.null_count);
+    KATANA_LOG_ASSERT(a.min == b.min && a.max == b.max);
+  }
+  KATANA_LOG_ASSERT(stored.value().total.end == test_length);
+  KATANA_LOG_ASSERT(stored.value().total.min == expected.value().total.min);
+  KATANA_LOG_ASSERT(stored.value().total.max == expected.value().total.max);
+
+  // nothing lies above the maximum
+  double max = stored.value().total.max.value();
+  KATANA_LOG_ASSERT(stored.value().CandidateRanges(max + 1, max + 2).empty());
+  KATANA_LOG_ASSERT(!stored.value().CandidateRanges(max, max).empty());
+}
+
+void
+TestCompressedTopology() {
+  // more nodes than one compressed block holds
+  constexpr size_t test_length = 40000;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  auto rdg_dir = uri_res.value();
+
+  // an EdgeTypeAwareTopology, whose adj_indices are per node and edge type,
+  // is stored with the graph too
+  auto view = g->BuildView<katana::PropertyGraphViews::EdgeTypeAwareBiDir>();
+
+  setenv("KATANA_TOPOLOGY_COMPRESSION", "1", 1);
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  unsetenv("KATANA_TOPOLOGY_COMPRESSION");
+  if (!write_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  fs::remove_all(rdg_dir.path());
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  KATANA_LOG_ASSERT(g2->NumNodes() == g->NumNodes());
+  KATANA_LOG_ASSERT(g2->NumEdges() == g->NumEdges());
+  KATANA_LOG_ASSERT(g->Equals(g2.get()));
+
+  auto view2 = g2->BuildView<katana::PropertyGraphViews::EdgeTypeAwareBiDir>();
+  KATANA_LOG_ASSERT(view2.NumEdges() == view.NumEdges());
+  for (auto edge_type : view.GetDistinctEdgeTypes()) {
+    for (auto n : view.Nodes()) {
+      KATANA_LOG_ASSERT(
+          view2.OutDegree(n, edge_type) == view.OutDegree(n, edge_type));
+    }
+  }
+}
+
+void
+TestUnchangedPropertyReuse() {
+  constexpr size_t test_length = 10;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-same", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-changed", test_length), &txn_ctx));
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  auto rdg_dir = uri_res.value();
+  uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  auto new_rdg_dir = uri_res.value();
+
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  if (!write_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  auto same_path = g2->GetNodePropertyStorageLocation("node-same");
+  auto changed_path = g2->GetNodePropertyStorageLocation("node-changed");
+  KATANA_LOG_ASSERT(same_path && changed_path);
+
+  // rewrite one property with the values it already has and one with new
+  // values, then fork the graph into a new directory
+  KATANA_LOG_ASSERT(g2->UpsertNodeProperties(
+      MakeProps<int64_t>("node-same", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g2->UpsertNodeProperties(
+      MakeProps<int32_t>("node-changed", test_length), &txn_ctx));
+  write_result = g2->Write(new_rdg_dir, command_line, &txn_ctx);
+  fs::remove_all(rdg_dir.path());
+  if (!write_result) {
+    fs::remove_all(new_rdg_dir.path());
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto new_same_path = g2->GetNodePropertyStorageLocation("node-same");
+  auto new_changed_path = g2->GetNodePropertyStorageLocation("node-changed");
+  KATANA_LOG_ASSERT(new_same_path && new_changed_path);
+  KATANA_LOG_ASSERT(new_same_path.value() == same_path.value());
+  KATANA_LOG_ASSERT(new_changed_path.value() != changed_path.value());
+
+  make_result = katana::PropertyGraph::Make(
+      new_rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  fs::remove_all(new_rdg_dir.path());
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  KATANA_LOG_ASSERT(g2->Equals(make_result.value().get()));
+}
+
+void
+TestRelocatePropertyParts() {
+  // a property of more than a part is written as a file of offsets and parts
+  constexpr size_t test_length = 300000;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-name", test_length), &txn_ctx));
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  auto rdg_dir = uri_res.value();
+  uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  auto new_rdg_dir = uri_res.value();
+
+  setenv("KATANA_PARQUET_WRITE_PART_MB", "1", 1);
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  unsetenv("KATANA_PARQUET_WRITE_PART_MB");
+  if (!write_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+  size_t num_parts = 0;
+  for (const auto& entry : fs::directory_iterator(rdg_dir.path())) {
+    num_parts +=
+        entry.path().filename().string().find(".part_") != std::string::npos;
+  }
+  KATANA_LOG_VASSERT(num_parts > 1, "property written in {} parts", num_parts);
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  // the unchanged property is copied to the new directory, parts and all
+  write_result = g2->Write(new_rdg_dir, command_line, &txn_ctx);
+  fs::remove_all(rdg_dir.path());
+  if (!write_result) {
+    fs::remove_all(new_rdg_dir.path());
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  make_result = katana::PropertyGraph::Make(
+      new_rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  fs::remove_all(new_rdg_dir.path());
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  KATANA_LOG_ASSERT(g->Equals(make_result.value().get()));
+}
+
+void
+TestSharedVersions() {
+  constexpr size_t test_length = 10;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-same", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-changed", test_length), &txn_ctx));
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  auto rdg_dir = uri_res.value();
+
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  if (!write_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  // commit a new version that changes one of the properties
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(make_result.value());
+  auto old_version = pg->CurrentVersion();
+  KATANA_LOG_ASSERT(old_version);
+  KATANA_LOG_ASSERT(pg->UpsertNodeProperties(
+      MakeProps<int32_t>("node-changed", test_length), &txn_ctx));
+  auto commit_result = pg->Commit(command_line, &txn_ctx);
+  if (!commit_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("committing result: {}", commit_result.error());
+  }
+  pg.reset();
+
+  katana::RDGLoadOptions opts;
+  opts.share_loaded_properties = true;
+  auto manifest_res = katana::RDGManifest::Make(
+      rdg_dir, katana::kDefaultRDGViewType, old_version.value());
+  KATANA_LOG_ASSERT(manifest_res);
+  make_result =
+      katana::PropertyGraph::Make(manifest_res.value(), opts, &txn_ctx);
+  if (!make_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("making old version: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> old_pg =
+      std::move(make_result.value());
+  make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  fs::remove_all(rdg_dir.path());
+  if (!make_result) {
+    KATANA_LOG_FATAL("making new version: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> new_pg =
+      std::move(make_result.value());
+
+  // the unchanged property is loaded once and held by both versions
+  auto old_same = old_pg->GetNodeProperty("node-same");
+  auto new_same = new_pg->GetNodeProperty("node-same");
+  KATANA_LOG_ASSERT(old_same && new_same);
+  KATANA_LOG_ASSERT(old_same.value() == new_same.value());
+
+  auto old_changed = old_pg->GetNodeProperty("node-changed");
+  auto new_changed = new_pg->GetNodeProperty("node-changed");
+  KATANA_LOG_ASSERT(old_changed && new_changed);
+  KATANA_LOG_ASSERT(old_changed.value()->type()->Equals(arrow::int64()));
+  KATANA_LOG_ASSERT(new_changed.value()->type()->Equals(arrow::int32()));
+}
+
+void
+TestProjectionFromStorage() {
+  constexpr size_t test_length = 100;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  // ascending values leave node 0 alone without the type
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<uint8_t>("node-type", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("node-value", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g->ConstructEntityTypeIDs(&txn_ctx));
+
+  // cache the type sorted topology so that it is stored with the graph
+  g->BuildView<
+      katana::PropertyGraphViews::NodesSortedByNodeTypeEdgesSortedByEdgeType>();
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  auto rdg_dir = uri_res.value();
+
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  if (!write_result) {
+    fs::remove_all(rdg_dir.path());
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  std::optional<std::vector<std::string>> node_types =
+      std::vector<std::string>{"node-type"};
+  std::optional<std::vector<std::string>> edge_types;
+  auto stored_result = katana::PropertyGraph::MakeProjectedGraph(
+      rdg_dir, node_types, edge_types, &txn_ctx);
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  fs::remove_all(rdg_dir.path());
+  if (!stored_result) {
+    KATANA_LOG_FATAL("projecting result: {}", stored_result.error());
+  }
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> stored =
+      std::move(stored_result.value());
+  auto view_result = katana::PropertyGraph::MakeProjectedGraph(
+      *make_result.value(), node_types, edge_types);
+  KATANA_LOG_ASSERT(view_result);
+  std::unique_ptr<katana::PropertyGraph> view = std::move(view_result.value());
+
+  KATANA_LOG_ASSERT(stored->NumNodes() == test_length - 1);
+  KATANA_LOG_ASSERT(stored->NumNodes() == view->NumNodes());
+  KATANA_LOG_ASSERT(stored->NumEdges() == view->NumEdges());
+
+  auto values_of = [](const katana::PropertyGraph& pg) {
+    auto prop = pg.GetNodeProperty("node-value");
+    KATANA_LOG_ASSERT(prop);
+    auto values = prop.value();
+    auto value_at = [values, &pg](katana::PropertyGraph::Node n) {
+      auto scalar = values->GetScalar(pg.topology().GetNodePropertyIndex(n));
+      KATANA_LOG_ASSERT(scalar.ok());
+      return std::static_pointer_cast<arrow::Int64Scalar>(*scalar)->value;
+    };
+    // nodes of one type keep their order, but edges may not
+    std::vector<std::vector<int64_t>> neighbors(pg.NumNodes());
+    for (katana::PropertyGraph::Node n : pg.topology().Nodes()) {
+      neighbors[n].emplace_back(value_at(n));
+      for (auto e : pg.topology().OutEdges(n)) {
+        neighbors[n].emplace_back(value_at(pg.topology().OutEdgeDst(e)));
+      }
+      std::sort(neighbors[n].begin() + 1, neighbors[n].end());
+    }
+    return neighbors;
+  };
+  KATANA_LOG_ASSERT(values_of(*stored) == values_of(*view));
+}
 }  // namespace
 
 int
@@ -473,6 +1147,25 @@ main(int argc, char** argv) {
   TestTopologyAccess();
   TestTypesFromPropertiesCompareTypesFromStorage();
   TestCompositeTypesFromPropertiesCompareCompositeTypesFromStorage();
+  TestLazyLoad();
+
+  TestConcurrentLazyLoad();
+
+  TestArrowIPCStorage();
+
+  TestCompressedTopology();
+
+  TestPropertyDeltas();
+
+  TestPropertyStats();
+
+  TestProjectionFromStorage();
+
+  TestUnchangedPropertyReuse();
+
+  TestRelocatePropertyParts();
+
+  TestSharedVersions();
 
   return 0;
 }
@@ -0,0 +1,153 @@
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyFilter.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+// more than one block of the filter, in chunks that do not end on a word
+constexpr size_t kNumNodes = 150001;
+constexpr int64_t kFirstChunk = 70007;
+const std::vector<std::string> kNames{"a", "b", "c", "d"};
+
+int64_t
+Age(size_t i) {
+  return i % 100;
+}
+
+bool
+IsAgeNull(size_t i) {
+  return i % 11 == 0;
+}
+
+/// An int64 property "age" with nulls, and a dictionary encoded property
+/// "name"
+std::shared_ptr<arrow::Table>
+MakeProperties() {
+  arrow::Int64Builder age_builder;
+  arrow::Int32Builder code_builder;
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    if (IsAgeNull(i)) {
+      KATANA_LOG_ASSERT(age_builder.AppendNull().ok());
+    } else {
+      KATANA_LOG_ASSERT(age_builder.Append(Age(i)).ok());
+    }
+    KATANA_LOG_ASSERT(code_builder.Append(i % kNames.size()).ok());
+  }
+  std::shared_ptr<arrow::Array> ages = age_builder.Finish().ValueOrDie();
+  std::shared_ptr<arrow::Array> codes = code_builder.Finish().ValueOrDie();
+
+  arrow::StringBuilder dictionary_builder;
+  KATANA_LOG_ASSERT(dictionary_builder.AppendValues(kNames).ok());
+  std::shared_ptr<arrow::Array> dictionary =
+      dictionary_builder.Finish().ValueOrDie();
+  auto type = arrow::dictionary(arrow::int32(), arrow::utf8());
+  std::shared_ptr<arrow::Array> names =
+      arrow::DictionaryArray::FromArrays(type, codes, dictionary).ValueOrDie();
+
+  auto chunked = [](const std::shared_ptr<arrow::Array>& array) {
+    return std::make_shared<arrow::ChunkedArray>(arrow::ArrayVector{
+        array->Slice(0, kFirstChunk), array->Slice(kFirstChunk)});
+  };
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("age", arrow::int64()), arrow::field("name", type)}),
+      {chunked(ages), chunked(names)});
+}
+
+template <typename Expected>
+void
+CheckSelection(
+    const katana::DynamicBitset& selection, Expected expected,
+    const std::string& what) {
+  KATANA_LOG_VASSERT(selection.size() == kNumNodes, "{}", what);
+  size_t num_expected = 0;
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    KATANA_LOG_VASSERT(
+        selection.test(i) == expected(i), "{}: node {}", what, i);
+    num_expected += expected(i);
+  }
+  KATANA_LOG_VASSERT(selection.count() == num_expected, "{}", what);
+}
+
+void
+TestFilters() {
+  LinePolicy policy{3};
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(MakeProperties(), &txn_ctx));
+
+  using katana::PropertyFilter;
+  auto adult = PropertyFilter::Compare(
+      "age", PropertyFilter::CompareOp::kGreaterEqual,
+      arrow::MakeScalar(int64_t{18}));
+  auto is_adult = [](size_t i) { return !IsAgeNull(i) && Age(i) >= 18; };
+  CheckSelection(adult.SelectNodes(*g).value(), is_adult, "compare");
+
+  arrow::StringBuilder values_builder;
+  KATANA_LOG_ASSERT(
+      values_builder.AppendValues(std::vector<std::string>{"b", "d", "z"})
+          .ok());
+  auto b_or_d =
+      PropertyFilter::In("name", values_builder.Finish().ValueOrDie());
+  auto is_b_or_d = [](size_t i) { return i % 2 == 1; };
+  CheckSelection(b_or_d.SelectNodes(*g).value(), is_b_or_d, "in");
+
+  CheckSelection(
+      PropertyFilter::IsNull("age").SelectNodes(*g).value(), IsAgeNull,
+      "is null");
+
+  auto combined = PropertyFilter::Or({
+      PropertyFilter::And({adult, b_or_d}),
+      PropertyFilter::Not(PropertyFilter::IsValid("age")),
+  });
+  katana::DynamicBitset selection = combined.SelectNodes(*g).value();
+  auto is_selected = [&](size_t i) {
+    return (is_adult(i) && is_b_or_d(i)) || IsAgeNull(i);
+  };
+  CheckSelection(selection, is_selected, "combined");
+
+  CheckSelection(
+      PropertyFilter::HasType(katana::SetOfEntityTypeIDs{})
+          .SelectNodes(*g)
+          .value(),
+      [](size_t) { return false; }, "no types");
+
+  KATANA_LOG_ASSERT(
+      !PropertyFilter::IsNull("no such property").SelectNodes(*g));
+
+  // the projection keeps the selected nodes and the edges between them
+  auto projected =
+      katana::PropertyGraph::MakeProjectedGraph(*g, selection).value();
+  KATANA_LOG_ASSERT(projected->NumNodes() == selection.count());
+  size_t num_expected_edges = 0;
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    for (size_t j = 1; j <= 3; ++j) {
+      num_expected_edges +=
+          is_selected(i) && is_selected((i + j) % kNumNodes);
+    }
+  }
+  KATANA_LOG_ASSERT(projected->NumEdges() == num_expected_edges);
+  for (auto n : projected->Nodes()) {
+    KATANA_LOG_ASSERT(is_selected(projected->GetNodePropertyIndex(n)));
+  }
+
+  katana::DynamicBitset too_small;
+  too_small.resize(kNumNodes - 1);
+  KATANA_LOG_ASSERT(
+      !katana::PropertyGraph::MakeProjectedGraph(*g, too_small));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestFilters();
+
+  return 0;
+}
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <vector>
+
 #include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
@@ -62,6 +65,52 @@ TestOptionalTopologyGenerationEdgeTypeAwareTopology(
   pg.BuildView<SortedGraphView>();
 }
 
+/// Check that a locality view only renumbers the nodes of pg
+template <typename LocalityView>
+void
+CheckLocalityView(katana::PropertyGraph* pg) {
+  const auto& original = pg->topology();
+  LocalityView view = pg->BuildView<LocalityView>();
+  KATANA_LOG_ASSERT(view.NumNodes() == original.NumNodes());
+  KATANA_LOG_ASSERT(view.NumEdges() == original.NumEdges());
+
+  std::vector<bool> seen(original.NumNodes(), false);
+  for (auto n : view.Nodes()) {
+    // the loaded topology numbers nodes by their property index
+    auto old_n = view.GetNodePropertyIndex(n);
+    KATANA_LOG_ASSERT(original.GetNodePropertyIndex(old_n) == old_n);
+    KATANA_LOG_ASSERT(!seen[old_n]);
+    seen[old_n] = true;
+    KATANA_LOG_ASSERT(view.OutDegree(n) == original.OutDegree(old_n));
+
+    std::vector<uint64_t> dests;
+    for (auto e : view.OutEdges(n)) {
+      dests.emplace_back(view.GetNodePropertyIndex(view.OutEdgeDst(e)));
+    }
+    std::vector<uint64_t> old_dests;
+    for (auto e : original.OutEdges(old_n)) {
+      old_dests.emplace_back(
+          original.GetNodePropertyIndex(original.OutEdgeDst(e)));
+    }
+    std::sort(dests.begin(), dests.end());
+    std::sort(old_dests.begin(), old_dests.end());
+    KATANA_LOG_ASSERT(dests == old_dests);
+  }
+}
+
+void
+TestOptionalTopologyGenerationLocalityOrders(const katana::URI& rdg_dir) {
+  KATANA_LOG_DEBUG("##### Testing Locality Order Generation #####");
+
+  katana::PropertyGraph pg = LoadGraph(rdg_dir);
+
+  CheckLocalityView<
+      katana::PropertyGraphViews::NodesInReverseCuthillMcKeeOrder>(&pg);
+  CheckLocalityView<katana::PropertyGraphViews::NodesHubClustered>(&pg);
+  CheckLocalityView<katana::PropertyGraphViews::NodesClusteredByCommunity>(
+      &pg);
+}
+
 int
 main(int argc, char** argv) {
   katana::SharedMemSys sys;
@@ -75,5 +124,6 @@ main(int argc, char** argv) {
   TestOptionalTopologyGenerationEdgeShuffleTopology(uri);
   TestOptionalTopologyGenerationShuffleTopology(uri);
   TestOptionalTopologyGenerationEdgeTypeAwareTopology(uri);
+  TestOptionalTopologyGenerationLocalityOrders(uri);
   return 0;
 }
@@ -1,6 +1,21 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "katana/DynamicTopology.h"
+#include "katana/EdgeBalancedRange.h"
+#include "katana/HybridTopology.h"
+#include "katana/HyperGraphTopology.h"
 #include "katana/Logging.h"
+#include "katana/MemoryPlacement.h"
+#include "katana/NUMAArray.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
+#include "katana/SizedCSRTopology.h"
 
 void
 TestEdgeSource(const katana::GraphTopology& topo) noexcept {
@@ -12,6 +27,606 @@ TestEdgeSource(const katana::GraphTopology& topo) noexcept {
   }
 }
 
+void
+TestHybridTopology(const katana::GraphTopology& topo) noexcept {
+  katana::HybridTopology hybrid = katana::HybridTopology::Make(topo);
+  KATANA_LOG_ASSERT(hybrid.NumNodes() == topo.NumNodes());
+  KATANA_LOG_ASSERT(hybrid.NumEdges() == topo.NumEdges());
+
+  uint64_t num_hubs = 0;
+  for (auto node : topo.Nodes()) {
+    KATANA_LOG_ASSERT(hybrid.OutDegree(node) == topo.OutDegree(node));
+    if (topo.OutDegree(node) > katana::HybridTopology::kInlineDegree) {
+      ++num_hubs;
+    }
+    KATANA_LOG_ASSERT(
+        hybrid.GetNodePropertyIndex(node) == topo.GetNodePropertyIndex(node));
+
+    std::vector<std::pair<uint32_t, uint64_t>> expected;
+    for (auto e : topo.OutEdges(node)) {
+      expected.emplace_back(
+          topo.OutEdgeDst(e), topo.GetEdgePropertyIndexFromOutEdge(e));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    size_t i = 0;
+    for (const auto& e : hybrid.OutEdges(node)) {
+      KATANA_LOG_ASSERT(i < expected.size());
+      KATANA_LOG_ASSERT(hybrid.OutEdgeDst(e) == expected[i].first);
+      KATANA_LOG_ASSERT(
+          hybrid.GetEdgePropertyIndexFromOutEdge(e) == expected[i].second);
+      ++i;
+    }
+    KATANA_LOG_ASSERT(i == expected.size());
+  }
+  KATANA_LOG_ASSERT(hybrid.NumHubs() == num_hubs);
+}
+
+void
+TestHyperGraphTopology(const katana::GraphTopology& topo) noexcept {
+  std::vector<uint8_t> is_net(topo.NumNodes());
+  for (auto node : topo.Nodes()) {
+    is_net[node] = node % 3 == 0;
+  }
+  katana::HyperGraphTopology hg =
+      katana::HyperGraphTopology::Make(topo, is_net.data());
+  KATANA_LOG_ASSERT(hg.NumNets() + hg.NumPins() == topo.NumNodes());
+
+  // (net node, pin node) for each edge between a net and a pin
+  std::set<std::pair<uint32_t, uint32_t>> expected;
+  for (auto node : topo.Nodes()) {
+    for (auto e : topo.OutEdges(node)) {
+      auto dst = topo.OutEdgeDst(e);
+      if (is_net[node] && !is_net[dst]) {
+        expected.emplace(node, dst);
+      } else if (!is_net[node] && is_net[dst]) {
+        expected.emplace(dst, node);
+      }
+    }
+  }
+  KATANA_LOG_ASSERT(hg.NumIncidences() == expected.size());
+
+  std::set<std::pair<uint32_t, uint32_t>> from_nets;
+  for (uint32_t net = 0; net < hg.NumNets(); ++net) {
+    KATANA_LOG_ASSERT(hg.IsNetNode(hg.NetNode(net)));
+    KATANA_LOG_ASSERT(hg.IdOfNode(hg.NetNode(net)) == net);
+    KATANA_LOG_ASSERT(
+        std::is_sorted(hg.Pins(net).begin(), hg.Pins(net).end()));
+    for (auto pin : hg.Pins(net)) {
+      KATANA_LOG_ASSERT(
+          from_nets.emplace(hg.NetNode(net), hg.PinNode(pin)).second);
+    }
+  }
+  KATANA_LOG_ASSERT(from_nets == expected);
+
+  std::set<std::pair<uint32_t, uint32_t>> from_pins;
+  for (uint32_t pin = 0; pin < hg.NumPins(); ++pin) {
+    KATANA_LOG_ASSERT(!hg.IsNetNode(hg.PinNode(pin)));
+    KATANA_LOG_ASSERT(hg.IdOfNode(hg.PinNode(pin)) == pin);
+    KATANA_LOG_ASSERT(hg.PinDegree(pin) == hg.Nets(pin).size());
+    for (auto net : hg.Nets(pin)) {
+      from_pins.emplace(hg.NetNode(net), hg.PinNode(pin));
+    }
+  }
+  KATANA_LOG_ASSERT(from_pins == expected);
+}
+
+void
+TestEdgeLookupIndex(size_t num_nodes, size_t edges_per_node) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(num_nodes, edges_per_node));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  using IndexedView = katana::PropertyGraphViews::EdgesSortedByDestIDIndexed;
+  IndexedView view = pg->BuildView<IndexedView>();
+
+  std::vector<bool> is_dst(num_nodes);
+  for (auto src : view.Nodes()) {
+    std::fill(is_dst.begin(), is_dst.end(), false);
+    for (auto e : view.OutEdges(src)) {
+      is_dst[view.OutEdgeDst(e)] = true;
+    }
+    for (auto dst : view.Nodes()) {
+      KATANA_LOG_ASSERT(view.HasEdge(src, dst) == is_dst[dst]);
+    }
+  }
+}
+
+using EdgeTriple = std::tuple<uint32_t, uint32_t, uint64_t>;
+
+template <typename View>
+std::vector<EdgeTriple>
+SortedEdgeTriples(const View& view, bool transposed) noexcept {
+  std::vector<EdgeTriple> triples;
+  for (auto src : view.Nodes()) {
+    for (auto e : view.OutEdges(src)) {
+      auto dst = view.OutEdgeDst(e);
+      triples.emplace_back(
+          transposed ? dst : src, transposed ? src : dst,
+          view.GetEdgePropertyIndexFromOutEdge(e));
+    }
+  }
+  std::sort(triples.begin(), triples.end());
+  return triples;
+}
+
+void
+TestApplyEdgeDeltas(size_t num_nodes, size_t edges_per_node) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(num_nodes, edges_per_node));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  arrow::UInt64Builder builder;
+  for (uint64_t row = 0; row < pg->NumEdges(); ++row) {
+    KATANA_LOG_ASSERT(builder.Append(row).ok());
+  }
+  auto rows = builder.Finish();
+  KATANA_LOG_ASSERT(rows.ok());
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(
+      arrow::Table::Make(
+          arrow::schema({arrow::field("row", arrow::uint64())}),
+          {rows.ValueOrDie()}),
+      &txn_ctx));
+
+  using SortedView = katana::PropertyGraphViews::EdgesSortedByDestID;
+  using TransposedView = katana::PropertyGraphViews::Transposed;
+  pg->BuildView<SortedView>();
+  pg->BuildView<TransposedView>();
+
+  katana::EdgeDeltas deltas;
+  std::vector<EdgeTriple> expected;
+  for (auto src : pg->topology().Nodes()) {
+    for (auto e : pg->topology().OutEdges(src)) {
+      auto dst = pg->topology().OutEdgeDst(e);
+      if (src % 3 == 0 && e == *pg->topology().OutEdges(src).begin()) {
+        deltas.deletions.emplace_back(katana::EdgeDeltas::Deletion{src, dst});
+      }
+    }
+  }
+  for (auto src : pg->topology().Nodes()) {
+    for (auto e : pg->topology().OutEdges(src)) {
+      auto dst = pg->topology().OutEdgeDst(e);
+      bool deleted = std::any_of(
+          deltas.deletions.begin(), deltas.deletions.end(),
+          [&](const auto& del) { return del.src == src && del.dst == dst; });
+      if (!deleted) {
+        expected.emplace_back(
+            src, dst, pg->topology().GetEdgePropertyIndexFromOutEdge(e));
+      }
+    }
+  }
+  for (uint32_t src = 0; src < num_nodes; src += 2) {
+    uint32_t dst = (src * 7 + 1) % num_nodes;
+    deltas.insertions.emplace_back(
+        katana::EdgeDeltas::Insertion{src, dst, uint64_t{src}});
+    expected.emplace_back(src, dst, uint64_t{src});
+  }
+  std::sort(expected.begin(), expected.end());
+
+  KATANA_LOG_ASSERT(pg->ApplyEdgeDeltas(deltas));
+
+  KATANA_LOG_ASSERT(SortedEdgeTriples(pg->topology(), false) == expected);
+
+  SortedView sorted = pg->BuildView<SortedView>();
+  KATANA_LOG_ASSERT(SortedEdgeTriples(sorted, false) == expected);
+  for (auto src : sorted.Nodes()) {
+    auto edges = sorted.OutEdges(src);
+    KATANA_LOG_ASSERT(std::is_sorted(
+        edges.begin(), edges.end(), [&](auto a, auto b) {
+          return sorted.OutEdgeDst(a) < sorted.OutEdgeDst(b);
+        }));
+  }
+
+  TransposedView transposed = pg->BuildView<TransposedView>();
+  KATANA_LOG_ASSERT(SortedEdgeTriples(transposed, true) == expected);
+
+  katana::EdgeDeltas out_of_range;
+  out_of_range.insertions.emplace_back(katana::EdgeDeltas::Insertion{
+      0, static_cast<uint32_t>(num_nodes), 0});
+  KATANA_LOG_ASSERT(!pg->ApplyEdgeDeltas(out_of_range));
+
+  // compaction puts the property row of each edge at its edge id
+  KATANA_LOG_ASSERT(pg->CompactTopology(&txn_ctx));
+  KATANA_LOG_ASSERT(pg->topology().EdgePropertyIndexData() == nullptr);
+  auto row_prop = pg->GetEdgeProperty("row");
+  KATANA_LOG_ASSERT(row_prop);
+  std::vector<uint64_t> row_of_edge;
+  for (const auto& chunk : row_prop.value()->chunks()) {
+    auto values = std::static_pointer_cast<arrow::UInt64Array>(chunk);
+    for (int64_t i = 0; i < values->length(); ++i) {
+      row_of_edge.emplace_back(values->Value(i));
+    }
+  }
+  KATANA_LOG_ASSERT(row_of_edge.size() == pg->NumEdges());
+  std::vector<EdgeTriple> compacted;
+  for (auto src : pg->topology().Nodes()) {
+    for (auto e : pg->topology().OutEdges(src)) {
+      compacted.emplace_back(src, pg->topology().OutEdgeDst(e), row_of_edge[e]);
+    }
+  }
+  std::sort(compacted.begin(), compacted.end());
+  KATANA_LOG_ASSERT(compacted == expected);
+}
+
+void
+TestCSRTopology32(size_t num_nodes, size_t edges_per_node) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(num_nodes, edges_per_node));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  using TransposedView = katana::PropertyGraphViews::Transposed;
+  TransposedView transposed = pg->BuildView<TransposedView>();
+  auto narrow_res = katana::CSRTopology32::Make(transposed);
+  KATANA_LOG_ASSERT(narrow_res);
+  katana::CSRTopology32 narrow = std::move(narrow_res.value());
+
+  KATANA_LOG_ASSERT(narrow.NumNodes() == transposed.NumNodes());
+  KATANA_LOG_ASSERT(narrow.NumEdges() == transposed.NumEdges());
+  for (auto node : transposed.Nodes()) {
+    KATANA_LOG_ASSERT(narrow.OutDegree(node) == transposed.OutDegree(node));
+    KATANA_LOG_ASSERT(
+        narrow.GetNodePropertyIndex(node) ==
+        transposed.GetNodePropertyIndex(node));
+  }
+  KATANA_LOG_ASSERT(
+      SortedEdgeTriples(narrow, true) == SortedEdgeTriples(transposed, true));
+}
+
+void
+TestEdgeBalancedRange(size_t num_nodes) noexcept {
+  // node 0 points to every node, odd nodes point back to it and even nodes
+  // have no out-edges
+  std::vector<katana::GraphTopology::Edge> adj_indices(num_nodes);
+  std::vector<katana::GraphTopology::Node> dests;
+  for (size_t n = 0; n < num_nodes; ++n) {
+    if (n == 0) {
+      for (size_t dst = 0; dst < num_nodes; ++dst) {
+        dests.emplace_back(dst);
+      }
+    } else if (n % 2 == 1) {
+      dests.emplace_back(0);
+    }
+    adj_indices[n] = dests.size();
+  }
+  katana::GraphTopology topo(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size());
+
+  constexpr uint64_t kBlockSize = 16;
+  katana::EdgeBalancedRange<katana::GraphTopology> range(topo, kBlockSize);
+  KATANA_LOG_ASSERT(range.NumBlocks() > num_nodes / kBlockSize);
+
+  std::vector<uint32_t> edge_visits(topo.NumEdges(), 0);
+  std::vector<uint32_t> node_visits(topo.NumNodes(), 0);
+  for (uint64_t block = 0; block < range.NumBlocks(); ++block) {
+    range.ForEachInBlock(block, [&](auto node, const auto& edges) {
+      ++node_visits[node];
+      for (auto e : edges) {
+        KATANA_LOG_ASSERT(topo.GetEdgeSrc(e) == node);
+        ++edge_visits[e];
+      }
+    });
+  }
+  KATANA_LOG_ASSERT(std::all_of(
+      edge_visits.begin(), edge_visits.end(),
+      [](uint32_t visits) { return visits == 1; }));
+  for (auto node : topo.Nodes()) {
+    KATANA_LOG_ASSERT(node_visits[node] >= 1);
+    KATANA_LOG_ASSERT(topo.OutDegree(node) > 0 || node_visits[node] == 1);
+  }
+  // the hub is split
+  KATANA_LOG_ASSERT(node_visits[0] > 1);
+
+  katana::NUMAArray<std::atomic<uint64_t>> in_degrees;
+  in_degrees.allocateInterleaved(topo.NumNodes());
+  for (auto node : topo.Nodes()) {
+    in_degrees.constructAt(node, 0);
+  }
+  katana::DoAllEdgeBalanced(
+      range,
+      [&](auto, const auto& edges) {
+        for (auto e : edges) {
+          in_degrees[topo.OutEdgeDst(e)].fetch_add(1);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  KATANA_LOG_ASSERT(in_degrees[0] == num_nodes / 2 + 1);
+  KATANA_LOG_ASSERT(in_degrees[num_nodes - 1] == 1);
+
+  std::vector<uint32_t> thread_ranges = range.ThreadRanges(4);
+  KATANA_LOG_ASSERT(thread_ranges.size() == 5);
+  KATANA_LOG_ASSERT(thread_ranges.front() == 0);
+  KATANA_LOG_ASSERT(thread_ranges.back() == topo.NumNodes());
+  KATANA_LOG_ASSERT(
+      std::is_sorted(thread_ranges.begin(), thread_ranges.end()));
+  // the hub holds about half the work, so it gets a thread to itself
+  KATANA_LOG_ASSERT(thread_ranges[1] == 1);
+}
+
+void
+TestMemoryPlacement(const katana::GraphTopology& topo) noexcept {
+  katana::GraphTopology blocked(
+      topo.AdjData(), topo.NumNodes(), topo.DestData(), topo.NumEdges(),
+      katana::MemoryPlacement::kBlocked);
+  KATANA_LOG_ASSERT(blocked.Equals(topo));
+
+  arrow::Int64Builder builder;
+  for (int64_t i = 0; i < 1000; ++i) {
+    auto res = i % 7 == 0 ? builder.AppendNull() : builder.Append(i);
+    KATANA_LOG_ASSERT(res.ok());
+  }
+  std::shared_ptr<arrow::Array> first;
+  std::shared_ptr<arrow::Array> second;
+  KATANA_LOG_ASSERT(builder.Finish(&first).ok());
+  KATANA_LOG_ASSERT(builder.AppendValues({1, 2, 3}).ok());
+  KATANA_LOG_ASSERT(builder.Finish(&second).ok());
+  auto column = std::make_shared<arrow::ChunkedArray>(
+      arrow::ArrayVector{first->Slice(3), second});
+
+  auto placed_res = katana::PlaceInMemory(
+      column, katana::MemoryPlacement::kInterleaved, 0);
+  KATANA_LOG_ASSERT(placed_res);
+  std::shared_ptr<arrow::ChunkedArray> placed = placed_res.value();
+  KATANA_LOG_ASSERT(placed->num_chunks() == 1);
+  KATANA_LOG_ASSERT(placed->Equals(*column));
+
+  auto too_small_res = katana::PlaceInMemory(
+      column, katana::MemoryPlacement::kInterleaved, 1 << 20);
+  KATANA_LOG_ASSERT(too_small_res);
+  KATANA_LOG_ASSERT(too_small_res.value() == column);
+}
+
+void
+TestReplicatedTopology(const katana::GraphTopology& topo) noexcept {
+  auto replicated = katana::ReplicatedTopology::Make(topo);
+  KATANA_LOG_ASSERT(replicated.NumNodes() == topo.NumNodes());
+  KATANA_LOG_ASSERT(replicated.NumEdges() == topo.NumEdges());
+  KATANA_LOG_ASSERT(
+      replicated.SizeBytes() ==
+      katana::GetThreadPool().getMaxSockets() *
+          (topo.NumNodes() * sizeof(katana::GraphTopology::Edge) +
+           topo.NumEdges() * sizeof(katana::GraphTopology::Node)));
+
+  std::atomic<size_t> mismatches{0};
+  katana::do_all(
+      katana::iterate(replicated.Nodes()), [&](katana::GraphTopology::Node n) {
+        auto edges = replicated.OutEdges(n);
+        auto expected = topo.OutEdges(n);
+        if (*edges.begin() != *expected.begin() ||
+            *edges.end() != *expected.end()) {
+          ++mismatches;
+          return;
+        }
+        for (auto e : edges) {
+          if (replicated.OutEdgeDst(e) != topo.OutEdgeDst(e)) {
+            ++mismatches;
+          }
+        }
+      });
+  KATANA_LOG_ASSERT(mismatches == 0);
+
+  auto empty = katana::ReplicatedTopology::Make(katana::GraphTopology{});
+  KATANA_LOG_ASSERT(empty.empty());
+  KATANA_LOG_ASSERT(empty.SizeBytes() == 0);
+}
+
+void
+TestDynamicTopology(size_t num_nodes, size_t edges_per_node) noexcept {
+  katana::GraphTopology topo =
+      katana::CreateUniformRandomTopology(num_nodes, edges_per_node);
+  katana::DynamicTopology dynamic = katana::DynamicTopology::Make(topo);
+  std::vector<EdgeTriple> expected = SortedEdgeTriples(topo, false);
+  KATANA_LOG_ASSERT(SortedEdgeTriples(dynamic, false) == expected);
+
+  // enough batches into node 0 that it moves several times and the pool
+  // is repacked
+  uint64_t next_prop = topo.NumEdges();
+  for (size_t batch = 0; batch < 8; ++batch) {
+    std::vector<katana::EdgeDeltas::Insertion> insertions;
+    for (uint32_t src = 0; src < num_nodes; src += 3) {
+      insertions.emplace_back(katana::EdgeDeltas::Insertion{
+          src, static_cast<uint32_t>((src + batch + 1) % num_nodes),
+          next_prop++});
+    }
+    for (size_t i = 0; i < 4 * num_nodes; ++i) {
+      insertions.emplace_back(katana::EdgeDeltas::Insertion{
+          0, static_cast<uint32_t>(i % num_nodes), next_prop++});
+    }
+    for (const auto& ins : insertions) {
+      expected.emplace_back(ins.src, ins.dst, ins.prop_index);
+    }
+    dynamic.InsertEdges(insertions);
+  }
+  std::sort(expected.begin(), expected.end());
+  KATANA_LOG_ASSERT(dynamic.NumEdges() == expected.size());
+  KATANA_LOG_ASSERT(SortedEdgeTriples(dynamic, false) == expected);
+
+  std::vector<katana::EdgeDeltas::Deletion> deletions;
+  for (uint32_t src = 0; src < num_nodes; src += 5) {
+    deletions.emplace_back(katana::EdgeDeltas::Deletion{src, src % 7});
+  }
+  dynamic.DeleteEdges(deletions);
+  expected.erase(
+      std::remove_if(
+          expected.begin(), expected.end(),
+          [](const EdgeTriple& t) {
+            return std::get<0>(t) % 5 == 0 &&
+                   std::get<1>(t) == std::get<0>(t) % 7;
+          }),
+      expected.end());
+  KATANA_LOG_ASSERT(dynamic.NumEdges() == expected.size());
+  KATANA_LOG_ASSERT(SortedEdgeTriples(dynamic, false) == expected);
+
+  katana::GraphTopology csr = dynamic.ToCSR();
+  KATANA_LOG_ASSERT(csr.NumEdges() == expected.size());
+  KATANA_LOG_ASSERT(SortedEdgeTriples(csr, false) == expected);
+}
+
+void
+TestCompactTopology(size_t num_nodes, size_t edges_per_node) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(num_nodes, edges_per_node));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  uint64_t num_edges = pg->NumEdges();
+
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (uint32_t src = 0; src < num_nodes; ++src) {
+    edges.emplace_back(src, (src + 1) % num_nodes);
+  }
+  std::vector<katana::EntityTypeID> types(
+      edges.size(), katana::kUnknownEntityType);
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(pg->InsertEdges(edges, types, nullptr, &txn_ctx));
+  KATANA_LOG_ASSERT(pg->NumEdges() == num_edges);
+  // the inserted edges would be lost
+  katana::EdgeDeltas deltas;
+  deltas.insertions.emplace_back(katana::EdgeDeltas::Insertion{0, 0, 0});
+  KATANA_LOG_ASSERT(!pg->ApplyEdgeDeltas(deltas));
+  KATANA_LOG_ASSERT(
+      pg->dynamic_topology()->NumEdges() == num_edges + edges.size());
+
+  std::vector<katana::EntityTypeID> too_few_types;
+  KATANA_LOG_ASSERT(
+      !pg->InsertEdges(edges, too_few_types, nullptr, &txn_ctx));
+
+  KATANA_LOG_ASSERT(pg->CompactTopology(&txn_ctx));
+  KATANA_LOG_ASSERT(pg->dynamic_topology() == nullptr);
+  KATANA_LOG_ASSERT(pg->NumEdges() == num_edges + edges.size());
+  KATANA_LOG_ASSERT(pg->GetEdgeTypeManager().HasEntityType(
+      pg->GetTypeOfEdgeFromTopoIndex(pg->NumEdges() - 1)));
+  for (const auto& [src, dst] : edges) {
+    auto out_edges = pg->topology().OutEdges(src);
+    KATANA_LOG_ASSERT(std::any_of(
+        out_edges.begin(), out_edges.end(),
+        [&](auto e) { return pg->topology().OutEdgeDst(e) == dst; }));
+  }
+}
+
+void
+TestPermuteNodeProperties(size_t num_nodes, size_t edges_per_node) noexcept {
+  katana::EntityTypeManager node_type_manager;
+  auto even_res = node_type_manager.AddAtomicEntityType("even");
+  auto odd_res = node_type_manager.AddAtomicEntityType("odd");
+  KATANA_LOG_ASSERT(even_res && odd_res);
+  katana::GraphTopology topo =
+      katana::CreateUniformRandomTopology(num_nodes, edges_per_node);
+  katana::PropertyGraph::EntityTypeIDArray node_types;
+  node_types.allocateInterleaved(topo.NumNodes());
+  for (auto node : topo.Nodes()) {
+    node_types[node] = node % 2 == 0 ? even_res.value() : odd_res.value();
+  }
+  katana::PropertyGraph::EntityTypeIDArray edge_types;
+  edge_types.allocateInterleaved(topo.NumEdges());
+  std::fill(edge_types.begin(), edge_types.end(), katana::kUnknownEntityType);
+  auto pg_res = katana::PropertyGraph::Make(
+      std::move(topo), std::move(node_types), std::move(edge_types),
+      std::move(node_type_manager), katana::EntityTypeManager{});
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  arrow::UInt32Builder builder;
+  for (auto node : pg->topology().Nodes()) {
+    KATANA_LOG_ASSERT(builder.Append(node).ok());
+  }
+  auto ids = builder.Finish();
+  KATANA_LOG_ASSERT(ids.ok());
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(pg->AddNodeProperties(
+      arrow::Table::Make(
+          arrow::schema({arrow::field("id", arrow::uint32())}),
+          {ids.ValueOrDie()}),
+      &txn_ctx));
+
+  auto seed = katana::EdgeShuffleTopology::MakeOriginalCopy(pg.get());
+  auto sorted = katana::ShuffleTopology::MakeSortedByNodeType(pg.get(), *seed);
+  auto props_res = sorted->PermutedNodeProperties(pg.get());
+  KATANA_LOG_ASSERT(props_res);
+  std::shared_ptr<arrow::Table> props = std::move(props_res.value());
+  KATANA_LOG_ASSERT(props->num_rows() == static_cast<int64_t>(num_nodes));
+  auto column = std::static_pointer_cast<arrow::UInt32Array>(
+      props->GetColumnByName("id")->chunk(0));
+  KATANA_LOG_ASSERT(column->length() == static_cast<int64_t>(num_nodes));
+  for (auto node : sorted->Nodes()) {
+    KATANA_LOG_ASSERT(
+        column->Value(node) == sorted->GetNodePropertyIndex(node));
+  }
+  // the even nodes come first, in order
+  KATANA_LOG_ASSERT(column->Value(1) == 2);
+  KATANA_LOG_ASSERT(column->Value(num_nodes / 2) == 1);
+}
+
+std::shared_ptr<arrow::Table>
+MakeEdgeWeights(size_t num_edges, uint32_t multiplier) {
+  arrow::UInt32Builder builder;
+  for (size_t e = 0; e < num_edges; ++e) {
+    KATANA_LOG_ASSERT(builder.Append(e * multiplier % 17).ok());
+  }
+  auto weights = builder.Finish();
+  KATANA_LOG_ASSERT(weights.ok());
+  return arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {weights.ValueOrDie()});
+}
+
+void
+TestEdgesSortedByProperty(size_t num_nodes, size_t edges_per_node) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(num_nodes, edges_per_node));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(
+      pg->AddEdgeProperties(MakeEdgeWeights(pg->NumEdges(), 7), &txn_ctx));
+
+  auto check_sorted = [&](const katana::EdgeShuffleTopology& sorted) {
+    auto weights_res = pg->GetEdgePropertyTyped<uint32_t>("weight");
+    KATANA_LOG_ASSERT(weights_res);
+    auto weights = weights_res.value();
+    KATANA_LOG_ASSERT(sorted.NumEdges() == pg->NumEdges());
+    for (auto node : sorted.Nodes()) {
+      KATANA_LOG_ASSERT(
+          sorted.OutDegree(node) == pg->topology().OutDegree(node));
+      uint32_t last = 0;
+      for (auto e : sorted.OutEdges(node)) {
+        uint32_t w = weights->Value(sorted.GetEdgePropertyIndexFromOutEdge(e));
+        KATANA_LOG_ASSERT(w >= last);
+        last = w;
+      }
+    }
+  };
+
+  auto sorted_res = pg->BuildEdgesSortedByProperty("weight");
+  KATANA_LOG_ASSERT(sorted_res);
+  auto sorted = sorted_res.value();
+  KATANA_LOG_ASSERT(
+      sorted->edge_sort_state() ==
+      katana::RDGTopology::EdgeSortKind::kSortedByEdgeProperty);
+  KATANA_LOG_ASSERT(sorted->edge_sort_property() == "weight");
+  check_sorted(*sorted);
+
+  // the topology is cached...
+  auto again_res = pg->BuildEdgesSortedByProperty("weight");
+  KATANA_LOG_ASSERT(again_res && again_res.value() == sorted);
+  auto rdg_topo_res = sorted->ToRDGTopology();
+  KATANA_LOG_ASSERT(rdg_topo_res);
+  KATANA_LOG_ASSERT(rdg_topo_res.value().edge_sort_property() == "weight");
+
+  // ...until the property changes
+  KATANA_LOG_ASSERT(
+      pg->UpsertEdgeProperties(MakeEdgeWeights(pg->NumEdges(), 5), &txn_ctx));
+  KATANA_LOG_ASSERT(!sorted->is_valid());
+  auto rebuilt_res = pg->BuildEdgesSortedByProperty("weight");
+  KATANA_LOG_ASSERT(rebuilt_res && rebuilt_res.value() != sorted);
+  check_sorted(*rebuilt_res.value());
+
+  // edges are only sorted by properties the graph has
+  KATANA_LOG_ASSERT(!pg->BuildEdgesSortedByProperty("no such property"));
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -23,6 +638,29 @@ main() {
       katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode);
 
   TestEdgeSource(topo);
+  TestHybridTopology(topo);
+  TestHyperGraphTopology(topo);
+  TestMemoryPlacement(topo);
+  TestReplicatedTopology(topo);
+
+  constexpr size_t kHubEdgesPerNode = 40;
+  katana::GraphTopology hub_topo =
+      katana::CreateUniformRandomTopology(kNumNodes, kHubEdgesPerNode);
+  TestHybridTopology(hub_topo);
+
+  // no index, bitmaps and hash sets respectively
+  TestEdgeLookupIndex(kNumNodes, kEdgesPerNode);
+  TestEdgeLookupIndex(kNumNodes, kHubEdgesPerNode);
+  TestEdgeLookupIndex(2 * kNumNodes, kHubEdgesPerNode);
+
+  TestApplyEdgeDeltas(kNumNodes, kEdgesPerNode);
+
+  TestCSRTopology32(kNumNodes, kEdgesPerNode);
+  TestDynamicTopology(kNumNodes, kEdgesPerNode);
+  TestCompactTopology(kNumNodes, kEdgesPerNode);
+  TestEdgeBalancedRange(kNumNodes);
+  TestPermuteNodeProperties(kNumNodes, kEdgesPerNode);
+  TestEdgesSortedByProperty(kNumNodes, kEdgesPerNode);
 
   return 0;
 }
@@ -1,8 +1,11 @@
+#include <algorithm>
+
 #include <arrow/api.h>
 #include <arrow/type.h>
 #include <arrow/type_traits.h>
 
 #include "TestTypedPropertyGraph.h"
+#include "storage-format-version.h"
 #include "katana/EntityIndex.h"
 #include "katana/Logging.h"
 #include "katana/Properties.h"
@@ -11,11 +14,20 @@
 template <typename node_or_edge>
 struct NodeOrEdge {
   static katana::Result<katana::EntityIndex<node_or_edge>*> MakeIndex(
-      katana::PropertyGraph* pg, const std::string& property_name);
+      katana::PropertyGraph* pg, const std::string& property_name,
+      katana::EntityIndexKind kind = katana::EntityIndexKind::kSorted);
+  static katana::Result<katana::CompositeEntityIndex<node_or_edge>*>
+  MakeCompositeIndex(
+      katana::PropertyGraph* pg, const std::vector<std::string>& property_names,
+      bool by_type);
   static katana::Result<void> AddProperties(
       katana::PropertyGraph* pg, std::shared_ptr<arrow::Table> properties,
       katana::TxnContext* txn_ctx);
   static size_t num_entities(katana::PropertyGraph* pg);
+  static katana::EntityTypeID GetType(
+      katana::PropertyGraph* pg, node_or_edge id);
+  static const katana::EntityTypeManager& type_manager(
+      katana::PropertyGraph* pg);
 };
 
 using Node = NodeOrEdge<katana::GraphTopology::Node>;
@@ -23,8 +35,10 @@ using Edge = NodeOrEdge<katana::GraphTopology::Edge>;
 
 template <>
 katana::Result<katana::EntityIndex<katana::GraphTopology::Node>*>
-Node::MakeIndex(katana::PropertyGraph* pg, const std::string& property_name) {
-  auto result = pg->MakeNodeIndex(property_name);
+Node::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    katana::EntityIndexKind kind) {
+  auto result = pg->MakeNodeIndex(property_name, kind);
   if (!result) {
     return result.error();
   }
@@ -40,8 +54,10 @@ Node::MakeIndex(katana::PropertyGraph* pg, const std::string& property_name) {
 
 template <>
 katana::Result<katana::EntityIndex<katana::GraphTopology::Edge>*>
-Edge::MakeIndex(katana::PropertyGraph* pg, const std::string& property_name) {
-  auto result = pg->MakeEdgeIndex(property_name);
+Edge::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    katana::EntityIndexKind kind) {
+  auto result = pg->MakeEdgeIndex(property_name, kind);
   if (!result) {
     return result.error();
   }
@@ -55,6 +71,42 @@ Edge::MakeIndex(katana::PropertyGraph* pg, const std::string& property_name) {
   return KATANA_ERROR(katana::ErrorCode::NotFound, "Created index not found");
 }
 
+template <>
+katana::Result<katana::CompositeEntityIndex<katana::GraphTopology::Node>*>
+Node::MakeCompositeIndex(
+    katana::PropertyGraph* pg, const std::vector<std::string>& property_names,
+    bool by_type) {
+  KATANA_CHECKED(pg->MakeNodeCompositeIndex(property_names, by_type));
+  std::string name = katana::CompositeEntityIndexName(property_names, by_type);
+  for (const auto& index : pg->node_indexes()) {
+    if (index->property_name() == name) {
+      return static_cast<
+          katana::CompositeEntityIndex<katana::GraphTopology::Node>*>(
+          index.get());
+    }
+  }
+
+  return KATANA_ERROR(katana::ErrorCode::NotFound, "Created index not found");
+}
+
+template <>
+katana::Result<katana::CompositeEntityIndex<katana::GraphTopology::Edge>*>
+Edge::MakeCompositeIndex(
+    katana::PropertyGraph* pg, const std::vector<std::string>& property_names,
+    bool by_type) {
+  KATANA_CHECKED(pg->MakeEdgeCompositeIndex(property_names, by_type));
+  std::string name = katana::CompositeEntityIndexName(property_names, by_type);
+  for (const auto& index : pg->edge_indexes()) {
+    if (index->property_name() == name) {
+      return static_cast<
+          katana::CompositeEntityIndex<katana::GraphTopology::Edge>*>(
+          index.get());
+    }
+  }
+
+  return KATANA_ERROR(katana::ErrorCode::NotFound, "Created index not found");
+}
+
 template <>
 size_t
 Node::num_entities(katana::PropertyGraph* pg) {
@@ -67,6 +119,30 @@ Edge::num_entities(katana::PropertyGraph* pg) {
   return pg->NumEdges();
 }
 
+template <>
+katana::EntityTypeID
+Node::GetType(katana::PropertyGraph* pg, katana::GraphTopology::Node id) {
+  return pg->GetTypeOfNodeFromPropertyIndex(id);
+}
+
+template <>
+katana::EntityTypeID
+Edge::GetType(katana::PropertyGraph* pg, katana::GraphTopology::Edge id) {
+  return pg->GetTypeOfEdgeFromPropertyIndex(id);
+}
+
+template <>
+const katana::EntityTypeManager&
+Node::type_manager(katana::PropertyGraph* pg) {
+  return pg->GetNodeTypeManager();
+}
+
+template <>
+const katana::EntityTypeManager&
+Edge::type_manager(katana::PropertyGraph* pg) {
+  return pg->GetEdgeTypeManager();
+}
+
 template <>
 katana::Result<void>
 Node::AddProperties(
@@ -171,7 +247,6 @@ TestPrimitiveIndex(size_t num_nodes, size_t line_width) {
   auto* uniform_index = static_cast<IndexType*>(uniform_index_result.value());
   auto* nonuniform_index =
       static_cast<IndexType*>(nonuniform_index_result.value());
-  (void)nonuniform_index;
 
   // The uniform index has every value == (c_type)42.
   auto it = uniform_index->Find(0);
@@ -203,6 +278,25 @@ TestPrimitiveIndex(size_t num_nodes, size_t line_width) {
   it = nonuniform_index->UpperBound(44);
   KATANA_LOG_ASSERT(it != nonuniform_index->end());
   KATANA_LOG_ASSERT(typed_prop->Value(*it) == 46);
+
+  // Every value is found and none between them, also when large indexes
+  // screen lookups with a Bloom filter.
+  for (size_t i = 0; i < num_entities; ++i) {
+    KATANA_LOG_ASSERT(
+        nonuniform_index->Find(i * 2 + 42) != nonuniform_index->end());
+    KATANA_LOG_ASSERT(
+        nonuniform_index->Find(i * 2 + 43) == nonuniform_index->end());
+  }
+
+  // Iteration visits every entity in order of property value.
+  size_t num_visited = 0;
+  DataType prev = typed_prop->Value(*nonuniform_index->begin());
+  for (node_or_edge id : *nonuniform_index) {
+    KATANA_LOG_ASSERT(prev <= typed_prop->Value(id));
+    prev = typed_prop->Value(id);
+    ++num_visited;
+  }
+  KATANA_LOG_ASSERT(num_visited == num_entities);
 }
 
 template <typename node_or_edge>
@@ -271,6 +365,248 @@ TestStringIndex(size_t num_nodes, size_t line_width) {
   it = nonuniform_index->UpperBound("aaak");
   KATANA_LOG_ASSERT(it != nonuniform_index->end());
   KATANA_LOG_ASSERT(typed_prop->GetView(*it) == "aaam");
+
+  // Iteration visits every entity in order of property value.
+  size_t num_visited = 0;
+  auto prev = typed_prop->GetView(*nonuniform_index->begin());
+  for (node_or_edge id : *nonuniform_index) {
+    KATANA_LOG_ASSERT(prev <= typed_prop->GetView(id));
+    prev = typed_prop->GetView(id);
+    ++num_visited;
+  }
+  KATANA_LOG_ASSERT(num_visited == num_entities);
+}
+
+template <typename node_or_edge>
+void
+TestStringHashIndex(size_t num_nodes, size_t line_width) {
+  using IndexType = katana::StringHashEntityIndex<node_or_edge>;
+  using ArrayType = arrow::LargeStringArray;
+
+  LinePolicy policy{line_width};
+
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int>(num_nodes, 0, &policy, &txn_ctx);
+
+  std::shared_ptr<arrow::Table> uniform_prop = CreateStringProperty(
+      "uniform", true, NodeOrEdge<node_or_edge>::num_entities(g.get()));
+  std::shared_ptr<arrow::Table> nonuniform_prop = CreateStringProperty(
+      "nonuniform", false, NodeOrEdge<node_or_edge>::num_entities(g.get()));
+  KATANA_LOG_ASSERT(
+      NodeOrEdge<node_or_edge>::AddProperties(g.get(), uniform_prop, &txn_ctx));
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
+      g.get(), nonuniform_prop, &txn_ctx));
+
+  auto uniform_index_result = NodeOrEdge<node_or_edge>::MakeIndex(
+      g.get(), "uniform", katana::EntityIndexKind::kHash);
+  KATANA_LOG_VASSERT(
+      uniform_index_result, "Could not create index: {}",
+      uniform_index_result.error());
+  auto nonuniform_index_result = NodeOrEdge<node_or_edge>::MakeIndex(
+      g.get(), "nonuniform", katana::EntityIndexKind::kHash);
+  KATANA_LOG_VASSERT(
+      nonuniform_index_result, "Could not create index: {}",
+      nonuniform_index_result.error());
+
+  auto* uniform_index = static_cast<IndexType*>(uniform_index_result.value());
+  auto* nonuniform_index =
+      static_cast<IndexType*>(nonuniform_index_result.value());
+  KATANA_LOG_ASSERT(
+      uniform_index_result.value()->kind() == katana::EntityIndexKind::kHash);
+
+  // The uniform index has every value == "aaaa".
+  KATANA_LOG_ASSERT(uniform_index->Find("aaaq") == uniform_index->end());
+
+  // Searching for "aaaa" should get every item, in order.
+  size_t num_entities = NodeOrEdge<node_or_edge>::num_entities(g.get());
+  auto [first, last] = uniform_index->EqualRange("aaaa");
+  KATANA_LOG_ASSERT(static_cast<size_t>(last - first) == num_entities);
+  node_or_edge expected = 0;
+  for (auto it = first; it != last; ++it) {
+    KATANA_LOG_VASSERT(*it == expected, "Out of order: {}", *it);
+    ++expected;
+  }
+
+  // Every value of the non-uniform index is distinct.
+  auto typed_prop =
+      std::static_pointer_cast<ArrayType>(nonuniform_prop->column(0)->chunk(0));
+  KATANA_LOG_ASSERT(nonuniform_index->Find("aaaj") == nonuniform_index->end());
+  auto it = nonuniform_index->Find("aaak");
+  KATANA_LOG_ASSERT(it != nonuniform_index->end());
+  KATANA_LOG_ASSERT(typed_prop->GetView(*it) == "aaak");
+
+  // Batch lookups find each entity by its own value.
+  auto batch_result = nonuniform_index->FindBatch(*typed_prop);
+  KATANA_LOG_VASSERT(
+      batch_result, "Could not look up batch: {}", batch_result.error());
+  const katana::NUMAArray<node_or_edge>& ids = batch_result.value();
+  KATANA_LOG_ASSERT(ids.size() == num_entities);
+  for (node_or_edge id = 0; id < num_entities; ++id) {
+    KATANA_LOG_VASSERT(ids[id] == id, "Batch found {} for {}", ids[id], id);
+  }
+
+  arrow::LargeStringBuilder builder;
+  KATANA_LOG_ASSERT(builder.Append("aaaj").ok());
+  KATANA_LOG_ASSERT(builder.AppendNull().ok());
+  std::shared_ptr<arrow::Array> missing_keys;
+  KATANA_LOG_ASSERT(builder.Finish(&missing_keys).ok());
+  auto missing_result = nonuniform_index->FindBatch(*missing_keys);
+  KATANA_LOG_ASSERT(missing_result);
+  for (node_or_edge id : missing_result.value()) {
+    KATANA_LOG_ASSERT(id == IndexType::kNotFound);
+  }
+
+  // Only strings can have hash indexes.
+  std::shared_ptr<arrow::Table> int_prop = CreatePrimitiveProperty<int64_t>(
+      "int", false, NodeOrEdge<node_or_edge>::num_entities(g.get()));
+  KATANA_LOG_ASSERT(
+      NodeOrEdge<node_or_edge>::AddProperties(g.get(), int_prop, &txn_ctx));
+  KATANA_LOG_ASSERT(!NodeOrEdge<node_or_edge>::MakeIndex(
+      g.get(), "int", katana::EntityIndexKind::kHash));
+}
+
+template <typename node_or_edge>
+void
+TestCompositeIndex(size_t num_nodes, size_t line_width) {
+  LinePolicy policy{line_width};
+
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+  size_t num_entities = NodeOrEdge<node_or_edge>::num_entities(g.get());
+
+  std::shared_ptr<arrow::Table> uniform_prop =
+      CreatePrimitiveProperty<int64_t>("uniform", true, num_entities);
+  std::shared_ptr<arrow::Table> nonuniform_prop =
+      CreatePrimitiveProperty<int64_t>("nonuniform", false, num_entities);
+  std::shared_ptr<arrow::Table> string_prop =
+      CreateStringProperty("string", false, num_entities);
+  for (const auto& prop : {uniform_prop, nonuniform_prop, string_prop}) {
+    KATANA_LOG_ASSERT(
+        NodeOrEdge<node_or_edge>::AddProperties(g.get(), prop, &txn_ctx));
+  }
+
+  auto composite_result = NodeOrEdge<node_or_edge>::MakeCompositeIndex(
+      g.get(), {"uniform", "string"}, false);
+  KATANA_LOG_VASSERT(
+      composite_result, "Could not create index: {}",
+      composite_result.error());
+  auto* composite_index = composite_result.value();
+  KATANA_LOG_ASSERT(composite_index->property_name() == "uniform,string");
+  KATANA_LOG_ASSERT(
+      static_cast<katana::EntityIndex<node_or_edge>*>(composite_index)
+          ->kind() == katana::EntityIndexKind::kComposite);
+  KATANA_LOG_ASSERT(!NodeOrEdge<node_or_edge>::MakeCompositeIndex(
+      g.get(), {"uniform", "string"}, false));
+
+  // Every entity has uniform == 42, and the strings increase with the id.
+  auto [first, last] = composite_index->EqualRange({int64_t{42}});
+  KATANA_LOG_ASSERT(static_cast<size_t>(last - first) == num_entities);
+  node_or_edge expected = 0;
+  for (auto it = first; it != last; ++it) {
+    KATANA_LOG_VASSERT(*it == expected, "Out of order: {}", *it);
+    ++expected;
+  }
+  auto [match_first, match_last] =
+      composite_index->EqualRange({uint64_t{42}, std::string_view("aaac")});
+  KATANA_LOG_ASSERT(match_last - match_first == 1 && *match_first == 1);
+  auto [none_first, none_last] = composite_index->EqualRange({int64_t{43}});
+  KATANA_LOG_ASSERT(none_first == none_last);
+  auto [mistyped_first, mistyped_last] =
+      composite_index->EqualRange({std::string_view("aaaa")});
+  KATANA_LOG_ASSERT(mistyped_first == mistyped_last);
+
+  // A typed lookup finds the entity among those of its type.
+  auto typed_result = NodeOrEdge<node_or_edge>::MakeCompositeIndex(
+      g.get(), {"nonuniform"}, true);
+  KATANA_LOG_VASSERT(
+      typed_result, "Could not create index: {}", typed_result.error());
+  auto* typed_index = typed_result.value();
+  KATANA_LOG_ASSERT(typed_index->property_name() == "type:nonuniform");
+  node_or_edge id = 1;
+  auto ranges = typed_index->EqualRanges(
+      NodeOrEdge<node_or_edge>::type_manager(g.get()),
+      NodeOrEdge<node_or_edge>::GetType(g.get(), id), {int64_t{44}});
+  KATANA_LOG_ASSERT(ranges.size() == 1);
+  KATANA_LOG_ASSERT(
+      ranges[0].second - ranges[0].first == 1 && *ranges[0].first == id);
+}
+
+template <typename node_or_edge>
+const std::vector<std::shared_ptr<katana::EntityIndex<node_or_edge>>>&
+GetIndexes(const katana::PropertyGraph& g);
+
+template <>
+const std::vector<
+    std::shared_ptr<katana::EntityIndex<katana::GraphTopology::Node>>>&
+GetIndexes<katana::GraphTopology::Node>(const katana::PropertyGraph& g) {
+  return g.node_indexes();
+}
+
+template <>
+const std::vector<
+    std::shared_ptr<katana::EntityIndex<katana::GraphTopology::Edge>>>&
+GetIndexes<katana::GraphTopology::Edge>(const katana::PropertyGraph& g) {
+  return g.edge_indexes();
+}
+
+template <typename node_or_edge>
+void
+TestStoredIndex(size_t num_nodes, size_t line_width) {
+  using IndexType = katana::PrimitiveEntityIndex<node_or_edge, int64_t>;
+
+  LinePolicy policy{line_width};
+
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+
+  std::shared_ptr<arrow::Table> nonuniform_prop =
+      CreatePrimitiveProperty<int64_t>(
+          "nonuniform", false, NodeOrEdge<node_or_edge>::num_entities(g.get()));
+  std::shared_ptr<arrow::Table> string_prop = CreateStringProperty(
+      "string", false, NodeOrEdge<node_or_edge>::num_entities(g.get()));
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
+      g.get(), nonuniform_prop, &txn_ctx));
+  KATANA_LOG_ASSERT(
+      NodeOrEdge<node_or_edge>::AddProperties(g.get(), string_prop, &txn_ctx));
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "nonuniform"));
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "string"));
+
+  // The indexes are written next to the graph, so a graph that has never
+  // been stored only stores them from its second write on; the first warns
+  // that it leaves them out. The second write also moves them to a new
+  // location. The loaded graph restores them on first use.
+  StoreGraph(g.get());
+  katana::URI rdg_dir = StoreGraph(g.get());
+
+  katana::PropertyGraph loaded = LoadGraph(rdg_dir);
+  const auto& indexes = GetIndexes<node_or_edge>(loaded);
+  KATANA_LOG_ASSERT(indexes.size() == 2);
+  for (const auto& index : indexes) {
+    const auto& original = *std::find_if(
+        GetIndexes<node_or_edge>(*g).begin(),
+        GetIndexes<node_or_edge>(*g).end(), [&](const auto& other) {
+          return other->property_name() == index->property_name();
+        });
+    KATANA_LOG_ASSERT(std::equal(
+        index->begin(), index->end(), original->begin(), original->end()));
+  }
+
+  auto* nonuniform_index = static_cast<IndexType*>(
+      indexes[0]->property_name() == "nonuniform" ? indexes[0].get()
+                                                  : indexes[1].get());
+  auto it = nonuniform_index->LowerBound(43);
+  KATANA_LOG_ASSERT(it != nonuniform_index->end());
+  auto typed_prop = std::static_pointer_cast<arrow::Int64Array>(
+      nonuniform_prop->column(0)->chunk(0));
+  KATANA_LOG_ASSERT(typed_prop->Value(*it) == 44);
+  KATANA_LOG_ASSERT(nonuniform_index->Find(44) == it);
+  KATANA_LOG_ASSERT(nonuniform_index->Find(43) == nonuniform_index->end());
 }
 
 int
@@ -289,5 +625,20 @@ main() {
   TestStringIndex<katana::GraphTopology::Node>(10, 3);
   TestStringIndex<katana::GraphTopology::Edge>(10, 3);
 
+  TestStringHashIndex<katana::GraphTopology::Node>(10, 3);
+  TestStringHashIndex<katana::GraphTopology::Edge>(10, 3);
+
+  TestCompositeIndex<katana::GraphTopology::Node>(10, 3);
+  TestCompositeIndex<katana::GraphTopology::Edge>(10, 3);
+
+  TestStoredIndex<katana::GraphTopology::Node>(10, 3);
+  TestStoredIndex<katana::GraphTopology::Edge>(10, 3);
+
+  // Indexes this large keep Bloom filters
+  TestPrimitiveIndex<katana::GraphTopology::Node, int64_t>(5000, 3);
+  TestPrimitiveIndex<katana::GraphTopology::Edge, float_t>(5000, 3);
+  TestStringIndex<katana::GraphTopology::Node>(5000, 3);
+  TestStoredIndex<katana::GraphTopology::Node>(5000, 3);
+
   return 0;
 }
@@ -1,3 +1,4 @@
+#include "katana/ArrowInterchange.h"
 #include "katana/Properties.h"
 #include "katana/Result.h"
 
@@ -60,6 +61,26 @@ GenerateFixedBinaryTestArray() {
           array_of_fixed_size_binaries));
 }
 
+/// Generates a chunked array of the values 0, 1, ... in chunks of the given
+/// lengths, where every multiple of 3 is null.
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+GenerateChunkedTestArray(const std::vector<int>& chunk_lengths) {
+  arrow::ArrayVector chunks;
+  int32_t next = 0;
+  for (int chunk_length : chunk_lengths) {
+    arrow::Int32Builder builder;
+    for (int i = 0; i < chunk_length; ++i, ++next) {
+      if (next % 3 == 0) {
+        KATANA_CHECKED(builder.AppendNull());
+      } else {
+        KATANA_CHECKED(builder.Append(next));
+      }
+    }
+    chunks.emplace_back(KATANA_CHECKED(builder.Finish()));
+  }
+  return KATANA_CHECKED(arrow::ChunkedArray::Make(chunks, arrow::int32()));
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -111,10 +132,176 @@ TestFixedSizedBinaryArray() {
   return katana::ResultSuccess();
 }
 
+/// Check that a view reads and writes the chunks of a property in place,
+/// whether or not the chunks have the same length.
+katana::Result<void>
+TestChunkedArray() {
+  for (const std::vector<int>& chunk_lengths : std::vector<std::vector<int>>{
+           {4, 4, 4, 2}, {3, 0, 5, 1, 7}, {0, 6}}) {
+    std::shared_ptr<arrow::ChunkedArray> array =
+        KATANA_CHECKED(GenerateChunkedTestArray(chunk_lengths));
+    auto view = KATANA_CHECKED(
+        katana::ConstructPropertyView<katana::PODProperty<int32_t>>(
+            array.get()));
+    KATANA_LOG_ASSERT(view.size() == static_cast<size_t>(array->length()));
+
+    for (size_t i = 0; i < view.size(); ++i) {
+      KATANA_LOG_VASSERT(
+          view.IsValid(i) == (i % 3 != 0), "wrong validity of element {}", i);
+      if (view.IsValid(i)) {
+        KATANA_LOG_VASSERT(
+            static_cast<size_t>(view[i]) == i, "expected {} found {}", i,
+            view[i]);
+      }
+      view[i] = -static_cast<int32_t>(i);
+    }
+
+    // writes go to the chunks
+    size_t i = 0;
+    for (const auto& chunk : array->chunks()) {
+      const auto& values = static_cast<const arrow::Int32Array&>(*chunk);
+      for (int64_t j = 0; j < values.length(); ++j, ++i) {
+        KATANA_LOG_ASSERT(values.Value(j) == -static_cast<int32_t>(i));
+      }
+    }
+  }
+
+  return katana::ResultSuccess();
+}
+
+/// Check that read-only views use immutable buffers in place and that views
+/// that write get a copy.
+katana::Result<void>
+TestImmutableBuffers() {
+  std::vector<int32_t> values(kNumArrayEntries);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = i;
+  }
+  // wraps values without owning or allowing writes to them, as mapped
+  // buffers do
+  auto buffer = std::make_shared<arrow::Buffer>(
+      reinterpret_cast<const uint8_t*>(values.data()),
+      values.size() * sizeof(int32_t));
+  KATANA_LOG_ASSERT(!buffer->is_mutable());
+  auto array =
+      std::make_shared<arrow::Int32Array>(values.size(), std::move(buffer));
+
+  KATANA_LOG_ASSERT(!katana::PODPropertyView<int32_t>::Make(*array));
+
+  auto read_only_view =
+      KATANA_CHECKED(katana::PODPropertyView<const int32_t>::Make(*array));
+  KATANA_LOG_ASSERT(&read_only_view[0] == values.data());
+  for (size_t i = 0; i < read_only_view.size(); ++i) {
+    KATANA_LOG_ASSERT(read_only_view[i] == static_cast<int32_t>(i));
+  }
+
+  auto chunked_array = std::make_shared<arrow::ChunkedArray>(array);
+  std::shared_ptr<arrow::ChunkedArray> mutable_array =
+      KATANA_CHECKED(katana::MutableValuesArray(chunked_array));
+  KATANA_LOG_ASSERT(mutable_array != chunked_array);
+  KATANA_LOG_ASSERT(mutable_array->Equals(*chunked_array));
+  std::shared_ptr<arrow::ChunkedArray> unchanged_array =
+      KATANA_CHECKED(katana::MutableValuesArray(mutable_array));
+  KATANA_LOG_ASSERT(unchanged_array == mutable_array);
+
+  auto view = KATANA_CHECKED(
+      katana::ConstructPropertyView<katana::PODProperty<int32_t>>(
+          mutable_array.get()));
+  view[0] = -1;
+  KATANA_LOG_ASSERT(values[0] == 0);
+
+  return katana::ResultSuccess();
+}
+
+/// Check that a dictionary view gives the codes and strings of its elements.
+katana::Result<void>
+TestDictionaryStringArray() {
+  const std::vector<std::string> labels{"person", "company", "account"};
+  arrow::StringBuilder dictionary_builder;
+  KATANA_CHECKED(dictionary_builder.AppendValues(labels));
+  std::shared_ptr<arrow::Array> dictionary =
+      KATANA_CHECKED(dictionary_builder.Finish());
+
+  arrow::Int32Builder indices_builder;
+  for (int32_t i = 0; i < kNumArrayEntries; ++i) {
+    if (i == 1) {
+      KATANA_CHECKED(indices_builder.AppendNull());
+    } else {
+      KATANA_CHECKED(indices_builder.Append(i % labels.size()));
+    }
+  }
+  std::shared_ptr<arrow::Array> indices =
+      KATANA_CHECKED(indices_builder.Finish());
+  std::shared_ptr<arrow::Array> array =
+      KATANA_CHECKED(arrow::DictionaryArray::FromArrays(
+          arrow::dictionary(arrow::int32(), arrow::utf8()), indices,
+          dictionary));
+
+  auto view = KATANA_CHECKED(
+      katana::ConstructPropertyView<katana::DictionaryStringReadOnlyProperty>(
+          array.get()));
+  KATANA_LOG_ASSERT(view.size() == kNumArrayEntries);
+  KATANA_LOG_ASSERT(view.num_codes() == labels.size());
+  KATANA_LOG_ASSERT(view.FindCode("company") == 1);
+  KATANA_LOG_ASSERT(view.FindCode("product") == -1);
+  for (size_t i = 0; i < view.size(); ++i) {
+    if (i == 1) {
+      KATANA_LOG_ASSERT(!view.IsValid(i));
+      KATANA_LOG_ASSERT(view[i].empty());
+      continue;
+    }
+    KATANA_LOG_ASSERT(
+        view.GetCode(i) == static_cast<int32_t>(i % labels.size()));
+    KATANA_LOG_ASSERT(view[i] == labels[i % labels.size()]);
+  }
+
+  return katana::ResultSuccess();
+}
+
+/// Check that a bit view writes single bits of the array in place, including
+/// in a slice that starts within a byte.
+katana::Result<void>
+TestAtomicBitArray() {
+  auto table = KATANA_CHECKED(katana::AtomicBitProperty::Allocate(
+      3 * kNumArrayEntries, "flags"));
+  std::shared_ptr<arrow::Array> array = table->column(0)->chunk(0);
+  auto sliced = array->Slice(3, 2 * kNumArrayEntries);
+
+  auto view = KATANA_CHECKED(
+      katana::ConstructPropertyView<katana::AtomicBitProperty>(sliced.get()));
+  KATANA_LOG_ASSERT(view.size() == 2 * kNumArrayEntries);
+  for (size_t i = 0; i < view.size(); ++i) {
+    KATANA_LOG_ASSERT(view.IsValid(i));
+    KATANA_LOG_ASSERT(!view.Test(i));
+  }
+
+  for (size_t i = 0; i < view.size(); i += 3) {
+    KATANA_LOG_ASSERT(!view.Set(i));
+  }
+  KATANA_LOG_ASSERT(view.Set(0));
+  view[1] = true;
+  KATANA_LOG_ASSERT(view.Reset(1));
+  KATANA_LOG_ASSERT(!view.Reset(1));
+
+  const auto& bools = static_cast<const arrow::BooleanArray&>(*array);
+  for (int64_t i = 0; i < bools.length(); ++i) {
+    bool expected = i >= 3 &&
+                    i < static_cast<int64_t>(3 + view.size()) &&
+                    (i - 3) % 3 == 0;
+    KATANA_LOG_ASSERT(bools.Value(i) == expected);
+  }
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll() {
   KATANA_CHECKED(TestNoBitmapValidity());
   KATANA_CHECKED(TestFixedSizedBinaryArray());
+  KATANA_CHECKED(TestChunkedArray());
+  KATANA_CHECKED(TestImmutableBuffers());
+  KATANA_CHECKED(TestDictionaryStringArray());
+  KATANA_CHECKED(TestAtomicBitArray());
   return katana::ResultSuccess();
 }
 
@@ -0,0 +1,130 @@
+#include <set>
+#include <utility>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+std::set<std::pair<Node, Node>>
+EdgeSet(const katana::GraphTopology& topology) {
+  std::set<std::pair<Node, Node>> edges;
+  for (Node n : topology.Nodes()) {
+    for (auto e : topology.OutEdges(n)) {
+      edges.emplace(n, topology.OutEdgeDst(e));
+    }
+  }
+  return edges;
+}
+
+/// The same seed generates the same topology on any number of threads
+void
+TestDeterminism() {
+  katana::RandomTopologyOptions options;
+  options.seed = 42;
+  unsigned max_threads = katana::GetThreadPool().getMaxThreads();
+
+  katana::setActiveThreads(1);
+  auto one = katana::CreateRmatTopology(10, 8, options);
+  KATANA_LOG_ASSERT(one);
+  katana::setActiveThreads(max_threads);
+  auto all = katana::CreateRmatTopology(10, 8, options);
+  KATANA_LOG_ASSERT(all);
+
+  KATANA_LOG_ASSERT(one.value().NumNodes() == 1024);
+  KATANA_LOG_ASSERT(one.value().NumEdges() == 8192);
+  KATANA_LOG_ASSERT(one.value().Equals(all.value()));
+
+  options.seed = 43;
+  auto other = katana::CreateRmatTopology(10, 8, options);
+  KATANA_LOG_ASSERT(other);
+  KATANA_LOG_ASSERT(!one.value().Equals(other.value()));
+}
+
+void
+TestSimpleSymmetric() {
+  katana::RandomTopologyOptions options;
+  options.symmetric = true;
+  options.remove_self_loops = true;
+  options.remove_multi_edges = true;
+  auto res = katana::CreateKroneckerTopology(
+      {0.5, 0.2, 0.1, 0.2, 0.3, 0.1, 0.1, 0.1, 0.4}, 5, 5000, options);
+  KATANA_LOG_ASSERT(res);
+  const katana::GraphTopology& topology = res.value();
+  KATANA_LOG_ASSERT(topology.NumNodes() == 243);
+
+  auto edges = EdgeSet(topology);
+  // no multi-edges
+  KATANA_LOG_ASSERT(edges.size() == topology.NumEdges());
+  for (const auto& [src, dst] : edges) {
+    KATANA_LOG_ASSERT(src != dst);
+    KATANA_LOG_ASSERT(edges.count(std::make_pair(dst, src)));
+  }
+}
+
+void
+TestLfr() {
+  katana::LfrParameters params;
+  params.num_nodes = 10000;
+  params.mixing = 0.2;
+  katana::RandomTopologyOptions options;
+  options.remove_self_loops = true;
+  katana::NUMAArray<uint32_t> communities;
+  auto res = katana::CreateLfrTopology(params, options, &communities);
+  KATANA_LOG_ASSERT(res);
+  const katana::GraphTopology& topology = res.value();
+  KATANA_LOG_ASSERT(topology.NumNodes() == params.num_nodes);
+  KATANA_LOG_ASSERT(communities.size() == params.num_nodes);
+
+  uint64_t internal = 0;
+  for (Node n : topology.Nodes()) {
+    for (auto e : topology.OutEdges(n)) {
+      internal += communities[n] == communities[topology.OutEdgeDst(e)];
+    }
+  }
+  // about 1 - mixing of the edges stay inside of communities
+  double fraction = static_cast<double>(internal) / topology.NumEdges();
+  KATANA_LOG_VASSERT(
+      fraction > 0.7 && fraction < 0.9, "{} of edges are internal", fraction);
+  double average_degree =
+      static_cast<double>(topology.NumEdges()) / topology.NumNodes();
+  KATANA_LOG_VASSERT(
+      average_degree > 8 && average_degree < 14, "average degree {}",
+      average_degree);
+}
+
+void
+TestErrors() {
+  katana::RandomTopologyOptions options;
+  KATANA_LOG_ASSERT(
+      !katana::CreateKroneckerTopology({1, 2, 3}, 2, 10, options));
+  KATANA_LOG_ASSERT(
+      !katana::CreateKroneckerTopology({1, -1, 1, 1}, 2, 10, options));
+  KATANA_LOG_ASSERT(
+      !katana::CreateKroneckerTopology({1, 1, 1, 1}, 33, 10, options));
+  KATANA_LOG_ASSERT(!katana::CreateRmatTopology(4, 4, options, 0.5, 0.5, 0.5));
+
+  katana::LfrParameters params;
+  params.num_nodes = 100;
+  params.min_degree = 0;
+  katana::NUMAArray<uint32_t> communities;
+  KATANA_LOG_ASSERT(!katana::CreateLfrTopology(params, options, &communities));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestDeterminism();
+  TestSimpleSymmetric();
+  TestLfr();
+  TestErrors();
+
+  return 0;
+}
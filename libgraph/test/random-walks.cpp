@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/EntityTypeManager.h"
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/ParquetReader.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/URI.h"
+#include "katana/analytics/random_walks/random_walks.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+constexpr uint32_t kNumWalks = 20000;
+constexpr double kTolerance = 0.02;
+
+using Walks = std::vector<std::vector<uint32_t>>;
+using Batch = std::shared_ptr<arrow::Table>;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(
+    uint32_t num_nodes,
+    const std::vector<std::pair<uint32_t, uint32_t>>& edges) {
+  katana::SymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(num_nodes);
+  for (const auto& [src, dst] : edges) {
+    builder.AddEdge(src, dst);
+  }
+  auto pg_res = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  return std::move(pg_res.value());
+}
+
+/// A graph like MakeGraph of the edges of typed_edges, each of which has
+/// the entity type given with it in both directions
+std::unique_ptr<katana::PropertyGraph>
+MakeTypedGraph(
+    uint32_t num_nodes,
+    const std::vector<std::tuple<uint32_t, uint32_t, katana::EntityTypeID>>&
+        typed_edges,
+    katana::EntityTypeManager edge_type_manager) {
+  std::map<std::pair<uint32_t, uint32_t>, katana::EntityTypeID> types;
+  katana::SymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(num_nodes);
+  for (const auto& [src, dst, type] : typed_edges) {
+    builder.AddEdge(src, dst);
+    types.emplace(std::make_pair(src, dst), type);
+    types.emplace(std::make_pair(dst, src), type);
+  }
+  katana::GraphTopology topo = builder.ConvertToCSR();
+
+  katana::PropertyGraph::EntityTypeIDArray edge_types;
+  edge_types.allocateInterleaved(topo.NumEdges());
+  for (auto src : topo.Nodes()) {
+    for (auto e : topo.OutEdges(src)) {
+      edge_types[e] = types.at({src, topo.OutEdgeDst(e)});
+    }
+  }
+  katana::PropertyGraph::EntityTypeIDArray node_types;
+  node_types.allocateInterleaved(topo.NumNodes());
+  std::fill(node_types.begin(), node_types.end(), katana::kUnknownEntityType);
+
+  auto pg_res = katana::PropertyGraph::Make(
+      std::move(topo), std::move(node_types), std::move(edge_types),
+      katana::EntityTypeManager{}, std::move(edge_type_manager));
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  return std::move(pg_res.value());
+}
+
+Walks
+ReadWalks(const arrow::Table& table) {
+  KATANA_LOG_ASSERT(table.num_columns() == 1);
+  KATANA_LOG_ASSERT(table.column(0)->type()->id() == arrow::Type::LARGE_LIST);
+  Walks walks;
+  for (const auto& chunk : table.column(0)->chunks()) {
+    const auto& lists = static_cast<const arrow::LargeListArray&>(*chunk);
+    const auto& nodes = static_cast<const arrow::UInt32Array&>(*lists.values());
+    for (int64_t i = 0; i < lists.length(); ++i) {
+      auto& walk = walks.emplace_back();
+      for (int64_t j = lists.value_offset(i); j < lists.value_offset(i + 1);
+           ++j) {
+        walk.emplace_back(nodes.Value(j));
+      }
+    }
+  }
+  return walks;
+}
+
+Walks
+RunWalks(
+    katana::PropertyGraph* pg, const std::string& weight_name,
+    const RandomWalksPlan& plan) {
+  auto walks_res = RandomWalksTable(pg, weight_name, plan);
+  KATANA_LOG_VASSERT(walks_res, "{}", walks_res.error());
+  return ReadWalks(*walks_res.value());
+}
+
+/// Check that the fraction of the walks that go to each node of expected is
+/// its share of the total of expected
+void
+CheckFrequencies(
+    const std::vector<uint64_t>& counts, const std::vector<double>& expected) {
+  uint64_t total_count = 0;
+  double total_expected = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    total_count += counts[i];
+    total_expected += expected[i];
+  }
+  KATANA_LOG_ASSERT(total_count > 0);
+  for (size_t i = 0; i < counts.size(); ++i) {
+    double found = static_cast<double>(counts[i]) / total_count;
+    double wanted = expected[i] / total_expected;
+    KATANA_LOG_VASSERT(
+        std::abs(found - wanted) < kTolerance,
+        "{} of the steps went to node {}, expected {}", found, i, wanted);
+  }
+}
+
+/// The first step of a walk is drawn in proportion to the edge weights
+void
+TestEdgeWeights() {
+  // A star whose center 0 has edges to 1 to 4 that weigh 1 to 4, which are
+  // its first edges
+  auto pg = MakeGraph(5, {{0, 1}, {0, 2}, {0, 3}, {0, 4}});
+  katana::TxnContext txn_ctx;
+  auto add_res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("weight", [](auto edge) {
+        return edge < 4 ? static_cast<double>(edge + 1) : 1.0;
+      }));
+  KATANA_LOG_VASSERT(add_res, "{}", add_res.error());
+
+  auto walks =
+      RunWalks(pg.get(), "weight", RandomWalksPlan::Node2Vec(1, kNumWalks));
+  std::vector<uint64_t> counts(5);
+  for (const auto& walk : walks) {
+    KATANA_LOG_ASSERT(walk.size() == 2);
+    if (walk[0] == 0) {
+      counts[walk[1]] += 1;
+    }
+  }
+  CheckFrequencies(counts, {0, 1, 2, 3, 4});
+
+  // Without weights, the first step is uniform
+  walks = RunWalks(pg.get(), "", RandomWalksPlan::Node2Vec(1, kNumWalks));
+  std::fill(counts.begin(), counts.end(), 0);
+  for (const auto& walk : walks) {
+    if (walk[0] == 0) {
+      counts[walk[1]] += 1;
+    }
+  }
+  CheckFrequencies(counts, {0, 1, 1, 1, 1});
+}
+
+/// The second step of a walk is biased by the return and in-out parameters
+void
+TestTransitions() {
+  // From 0 through 1, a walk can return to 0, go to 2, which is a neighbor
+  // of 0, or go to 3, which is not
+  auto pg = MakeGraph(4, {{0, 1}, {0, 2}, {1, 2}, {1, 3}});
+  constexpr double p = 0.5;
+  constexpr double q = 2;
+  auto walks =
+      RunWalks(pg.get(), "", RandomWalksPlan::Node2Vec(2, kNumWalks, p, q));
+
+  std::vector<uint64_t> counts(4);
+  for (const auto& walk : walks) {
+    KATANA_LOG_ASSERT(walk.size() == 3);
+    if (walk[0] == 0 && walk[1] == 1) {
+      counts[walk[2]] += 1;
+    }
+  }
+  CheckFrequencies(counts, {1 / p, 0, 1, 1 / q});
+}
+
+/// The walks depend on the seed but not on the number of threads
+void
+TestDeterminism() {
+  auto pg = katana::MakeGrid(10, 10, true);
+  auto plan = RandomWalksPlan::Node2Vec(8, 4, 0.5, 2, 7);
+
+  katana::setActiveThreads(1);
+  auto one_thread = RunWalks(pg.get(), "", plan);
+  katana::setActiveThreads(2);
+  auto two_threads = RunWalks(pg.get(), "", plan);
+  KATANA_LOG_ASSERT(one_thread == two_threads);
+  KATANA_LOG_ASSERT(one_thread.size() == pg->NumNodes() * 4);
+
+  auto other_seed =
+      RunWalks(pg.get(), "", RandomWalksPlan::Node2Vec(8, 4, 0.5, 2, 8));
+  KATANA_LOG_ASSERT(one_thread != other_seed);
+}
+
+/// Streamed walks are those of a single batch, whatever the batch size
+void
+TestStreaming() {
+  // Node 6 has no edges, so its walks are dropped
+  auto pg = MakeGraph(7, {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {0, 4}, {4, 5}});
+  auto plan = RandomWalksPlan::Node2Vec(5, 3, 0.5, 2, 11);
+  auto expected = RunWalks(pg.get(), "", plan);
+  KATANA_LOG_ASSERT(expected.size() == 6 * 3);
+
+  for (uint64_t walks_per_batch : {1, 4, 7, 21, 100}) {
+    Walks streamed;
+    uint64_t num_batches = 0;
+    auto stream_res = RandomWalksStream(
+        pg.get(), walks_per_batch,
+        [&](const Batch& batch) -> katana::Result<void> {
+          Walks walks = ReadWalks(*batch);
+          KATANA_LOG_ASSERT(walks.size() <= walks_per_batch);
+          streamed.insert(streamed.end(), walks.begin(), walks.end());
+          num_batches += 1;
+          return katana::ResultSuccess();
+        },
+        "", plan);
+    KATANA_LOG_VASSERT(stream_res, "{}", stream_res.error());
+    KATANA_LOG_VASSERT(
+        streamed == expected, "batches of {} walks differ from one batch",
+        walks_per_batch);
+    uint64_t total_walks = pg->NumNodes() * plan.number_of_walks();
+    KATANA_LOG_ASSERT(
+        num_batches == (total_walks + walks_per_batch - 1) / walks_per_batch);
+  }
+
+  // An error from the callback stops the walks
+  uint64_t calls = 0;
+  auto error_res = RandomWalksStream(
+      pg.get(), 4,
+      [&](const Batch&) -> katana::Result<void> {
+        calls += 1;
+        return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "stop");
+      },
+      "", plan);
+  KATANA_LOG_ASSERT(!error_res);
+  KATANA_LOG_ASSERT(calls == 1);
+
+  auto empty_res = RandomWalksStream(
+      pg.get(), 0,
+      [](const Batch&) -> katana::Result<void> {
+        return katana::ResultSuccess();
+      },
+      "", plan);
+  KATANA_LOG_ASSERT(!empty_res);
+
+  auto dir_res = katana::URI::MakeRand("/tmp/randomwalks");
+  KATANA_LOG_VASSERT(dir_res, "{}", dir_res.error());
+  katana::URI uri = dir_res.value().Join("walks.parquet");
+  auto write_res = RandomWalksToParquet(pg.get(), uri, 5, "", plan);
+  if (!write_res) {
+    fs::remove_all(dir_res.value().path());
+    KATANA_LOG_FATAL("writing walks failed: {}", write_res.error());
+  }
+  auto reader_res = katana::ParquetReader::Make();
+  KATANA_LOG_VASSERT(reader_res, "{}", reader_res.error());
+  auto read_res = reader_res.value()->ReadTable(uri);
+  fs::remove_all(dir_res.value().path());
+  KATANA_LOG_VASSERT(read_res, "{}", read_res.error());
+  KATANA_LOG_ASSERT(ReadWalks(*read_res.value()) == expected);
+}
+
+/// Edge2vec biases each pair of edge types by the sigmoid of the
+/// correlation of their numbers of edges in a walk
+void
+TestEdge2VecTransitionMatrix() {
+  katana::EntityTypeManager edge_type_manager;
+  auto a_res = edge_type_manager.AddAtomicEntityType("a");
+  auto b_res = edge_type_manager.AddAtomicEntityType("b");
+  KATANA_LOG_ASSERT(a_res && b_res);
+  katana::EntityTypeID a = a_res.value();
+  katana::EntityTypeID b = b_res.value();
+  uint32_t num_types = std::max(a, b) + 1;
+
+  // Walks of one edge from 0 or 1 take an edge of type a and walks from 2 or
+  // 3 one of type b, so the numbers of either type in a walk are opposite,
+  // whatever the steps drawn
+  auto pg = MakeTypedGraph(4, {{0, 1, a}, {2, 3, b}}, edge_type_manager);
+  auto plan = RandomWalksPlan::Edge2Vec(1, 10, 1, 1, 3, num_types - 1);
+  auto matrix_res = Edge2VecTransitionMatrix(pg.get(), plan);
+  KATANA_LOG_VASSERT(matrix_res, "{}", matrix_res.error());
+  const std::vector<double>& matrix = matrix_res.value();
+  KATANA_LOG_ASSERT(matrix.size() == num_types * num_types);
+
+  auto sigmoid = [](double x) { return 1 / (1 + std::exp(-x)); };
+  for (uint32_t i = 0; i < num_types; ++i) {
+    for (uint32_t j = 0; j < num_types; ++j) {
+      // Types that no edge has never vary, so they are uncorrelated to the
+      // rest
+      double expected = 0.5;
+      if ((i == a || i == b) && (j == a || j == b)) {
+        expected = sigmoid(i == j ? 1 : -1);
+      }
+      double found = matrix[i * num_types + j];
+      KATANA_LOG_VASSERT(
+          std::abs(found - expected) < 1e-9,
+          "bias from type {} to type {} is {}, expected {}", i, j, found,
+          expected);
+    }
+  }
+
+  // Walks of three edges of type a all have three of them, so no type
+  // varies
+  auto path = MakeTypedGraph(2, {{0, 1, a}}, edge_type_manager);
+  matrix_res = Edge2VecTransitionMatrix(
+      path.get(), RandomWalksPlan::Edge2Vec(3, 10, 1, 1, 3, num_types - 1));
+  KATANA_LOG_VASSERT(matrix_res, "{}", matrix_res.error());
+  for (double bias : matrix_res.value()) {
+    KATANA_LOG_VASSERT(bias == 0.5, "bias {}, expected 0.5", bias);
+  }
+
+  // Without iterations the matrix is not estimated
+  matrix_res = Edge2VecTransitionMatrix(
+      pg.get(), RandomWalksPlan::Edge2Vec(1, 10, 1, 1, 0, num_types - 1));
+  KATANA_LOG_VASSERT(matrix_res, "{}", matrix_res.error());
+  for (double bias : matrix_res.value()) {
+    KATANA_LOG_ASSERT(bias == 1);
+  }
+
+  KATANA_LOG_ASSERT(
+      !Edge2VecTransitionMatrix(pg.get(), RandomWalksPlan::Node2Vec()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestEdgeWeights();
+  TestTransitions();
+  TestDeterminism();
+  TestStreaming();
+  TestEdge2VecTransitionMatrix();
+
+  return 0;
+}
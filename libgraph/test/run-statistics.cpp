@@ -0,0 +1,111 @@
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/RunStatistics.h"
+#include "katana/analytics/cdlp/cdlp.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+void
+CheckPhases(
+    const RunStatistics& stats, const std::vector<std::string>& expected) {
+  KATANA_LOG_VASSERT(
+      stats.phases.size() == expected.size(), "{}: {} phases, expected {}",
+      stats.algorithm, stats.phases.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        stats.phases[i].name == expected[i], "{}: phase {} is {}, expected {}",
+        stats.algorithm, i, stats.phases[i].name, expected[i]);
+    KATANA_LOG_ASSERT(stats.phases[i].seconds >= 0);
+  }
+  KATANA_LOG_ASSERT(stats.GetPhase(expected.front()) == &stats.phases[0]);
+  KATANA_LOG_ASSERT(stats.GetPhase("no such phase") == nullptr);
+}
+
+void
+TestCollect() {
+  auto pg = katana::MakeGrid(4, 4, true);
+  katana::TxnContext txn_ctx;
+
+  RunStatisticsCollector collector;
+  KATANA_LOG_ASSERT(RunStatisticsCollector::Current() == &collector);
+  KATANA_LOG_ASSERT(
+      Cdlp(pg.get(), "community", 10, &txn_ctx, true, CdlpPlan::Frontier()));
+  KATANA_LOG_ASSERT(
+      Pagerank(pg.get(), "rank", &txn_ctx, PagerankPlan::PullTopological()));
+  KATANA_LOG_ASSERT(collector.runs().size() == 2);
+
+  const RunStatistics& cdlp = collector.runs()[0];
+  KATANA_LOG_ASSERT(cdlp.algorithm == "CdlpFrontier");
+  CheckPhases(cdlp, {kPhaseViewBuild, kPhaseInit, kPhaseMainLoop});
+  KATANA_LOG_ASSERT(cdlp.iterations > 0);
+  // The first round visits every node
+  KATANA_LOG_ASSERT(cdlp.work_items >= pg->NumNodes());
+
+  const RunStatistics& pagerank = collector.runs()[1];
+  KATANA_LOG_ASSERT(pagerank.algorithm == "PagerankPullTopological");
+  CheckPhases(
+      pagerank, {kPhaseViewBuild, kPhaseInit, kPhaseMainLoop, kPhaseOutput});
+  KATANA_LOG_ASSERT(pagerank.iterations > 0);
+  KATANA_LOG_ASSERT(
+      pagerank.work_items == pagerank.iterations * pg->NumEdges());
+  KATANA_LOG_ASSERT(pagerank.seconds() > 0);
+}
+
+void
+TestNested() {
+  auto pg = katana::MakeGrid(2, 2, true);
+  katana::TxnContext txn_ctx;
+
+  RunStatisticsCollector outer;
+  {
+    RunStatisticsCollector inner;
+    KATANA_LOG_ASSERT(RunStatisticsCollector::Current() == &inner);
+    KATANA_LOG_ASSERT(Cdlp(pg.get(), "inner", 10, &txn_ctx, true));
+    KATANA_LOG_ASSERT(inner.runs().size() == 1);
+  }
+  KATANA_LOG_ASSERT(RunStatisticsCollector::Current() == &outer);
+  KATANA_LOG_ASSERT(outer.runs().empty());
+
+  KATANA_LOG_ASSERT(Cdlp(pg.get(), "outer", 10, &txn_ctx, true));
+  KATANA_LOG_ASSERT(outer.runs().size() == 1);
+  KATANA_LOG_ASSERT(outer.runs()[0].algorithm == "CdlpSynchronous");
+}
+
+void
+TestRecorder() {
+  RunStatisticsCollector collector;
+  {
+    RunRecorder recorder("Test");
+    recorder.StartPhase(kPhaseInit);
+    recorder.AddIterations(2);
+    recorder.StartPhase(kPhaseMainLoop);
+    recorder.AddIterations(3);
+    recorder.AddWorkItems(7);
+    recorder.Finish();
+    // Finishing again does not record the call twice
+  }
+  KATANA_LOG_ASSERT(collector.runs().size() == 1);
+  const RunStatistics& stats = collector.runs()[0];
+  CheckPhases(stats, {kPhaseInit, kPhaseMainLoop});
+  KATANA_LOG_ASSERT(stats.iterations == 5);
+  KATANA_LOG_ASSERT(stats.work_items == 7);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  KATANA_LOG_ASSERT(RunStatisticsCollector::Current() == nullptr);
+  TestCollect();
+  TestNested();
+  TestRecorder();
+  KATANA_LOG_ASSERT(RunStatisticsCollector::Current() == nullptr);
+
+  return 0;
+}
@@ -0,0 +1,221 @@
+#include <arrow/api.h>
+
+#include "katana/BuildGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr size_t kChunkSize = 7;
+constexpr size_t kNumShards = 3;
+constexpr uint32_t kNumNodes = 100;
+
+katana::ImportData
+Int64Data(int64_t value) {
+  katana::ImportData data(katana::ImportDataType::kInt64, false);
+  data.value = value;
+  return data;
+}
+
+void
+AddInt64(
+    katana::PropertyGraphBuilder* builder, const katana::PropertyKey& key,
+    int64_t value) {
+  builder->AddValue(
+      key.id, [&]() -> katana::PropertyKey { return key; },
+      [value](katana::ImportDataType, bool) { return Int64Data(value); });
+}
+
+/// Node i goes to shard i * kNumShards / kNumNodes so that the shards hold
+/// the nodes in order. The nodes of the last shard have no "rank", and node
+/// ids that are multiples of 5 are labeled.
+void
+AddNode(katana::PropertyGraphBuilder* builder, uint32_t i, size_t shard) {
+  katana::PropertyKey rank(
+      "rank", true, false, "rank", katana::ImportDataType::kInt64, false);
+  KATANA_LOG_ASSERT(builder->StartNode(std::to_string(i)));
+  if (shard + 1 < kNumShards) {
+    AddInt64(builder, rank, i);
+  }
+  if (i % 5 == 0) {
+    builder->AddLabel("Fives");
+  }
+  builder->FinishNode();
+}
+
+/// Edges are added by the shard of their source, some before their
+/// destination exists in any shard
+void
+AddEdges(katana::PropertyGraphBuilder* builder, uint32_t i) {
+  katana::PropertyKey weight(
+      "weight", false, true, "weight", katana::ImportDataType::kInt64, false);
+  for (uint32_t j = 0; j < i % 4; ++j) {
+    uint32_t dst = (i * 31 + j * 17) % kNumNodes;
+    KATANA_LOG_ASSERT(
+        builder->StartEdge(std::to_string(i), std::to_string(dst)));
+    AddInt64(builder, weight, i * kNumNodes + dst);
+    builder->AddLabel(j % 2 == 0 ? "Even" : "Odd");
+    builder->FinishEdge();
+  }
+}
+
+size_t
+ShardOf(uint32_t i) {
+  return i * kNumShards / kNumNodes;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+ToGraph(katana::Result<katana::GraphComponents> components) {
+  KATANA_LOG_ASSERT(components);
+  katana::TxnContext txn_ctx;
+  auto graph = katana::ConvertToPropertyGraph(
+      std::move(components.value()), &txn_ctx);
+  KATANA_LOG_ASSERT(graph);
+  return std::move(graph.value());
+}
+
+void
+TestMatchesSingleBuilder() {
+  katana::PropertyGraphBuilder single(kChunkSize);
+  for (uint32_t i = 0; i < kNumNodes; ++i) {
+    AddNode(&single, i, ShardOf(i));
+    if (i % 2 == 0) {
+      AddEdges(&single, i);
+    }
+  }
+  for (uint32_t i = 1; i < kNumNodes; i += 2) {
+    AddEdges(&single, i);
+  }
+
+  // Shards are filled concurrently and their edges refer to nodes of any
+  // shard, in any order
+  katana::ShardedPropertyGraphBuilder sharded(kNumShards, kChunkSize);
+  katana::do_all(
+      katana::iterate(size_t{0}, kNumShards),
+      [&](size_t s) {
+        katana::PropertyGraphBuilder& shard = sharded.shard(s);
+        for (uint32_t i = 0; i < kNumNodes; ++i) {
+          if (ShardOf(i) == s) {
+            AddNode(&shard, i, s);
+            if (i % 2 == 0) {
+              AddEdges(&shard, i);
+            }
+          }
+        }
+        for (uint32_t i = 1; i < kNumNodes; i += 2) {
+          if (ShardOf(i) == s) {
+            AddEdges(&shard, i);
+          }
+        }
+      },
+      katana::no_stats());
+
+  auto expected = ToGraph(single.Finish(false));
+  auto merged = ToGraph(sharded.Finish(false));
+  KATANA_LOG_VASSERT(
+      merged->Equals(expected.get()), "{}",
+      merged->ReportDiff(expected.get()));
+}
+
+void
+TestPlaceholders() {
+  katana::ShardedPropertyGraphBuilder sharded(2, kChunkSize);
+  KATANA_LOG_ASSERT(sharded.shard(0).StartNode("a"));
+  sharded.shard(0).FinishNode();
+  KATANA_LOG_ASSERT(sharded.shard(1).StartNode("a"));
+  sharded.shard(1).FinishNode();
+  // "b" and "c" are nodes of no shard
+  KATANA_LOG_ASSERT(sharded.shard(0).AddEdge("a", "c"));
+  KATANA_LOG_ASSERT(sharded.shard(1).AddEdge("b", "a"));
+
+  auto graph = ToGraph(sharded.Finish(false));
+  const katana::GraphTopology& topology = graph->topology();
+  KATANA_LOG_ASSERT(topology.NumNodes() == 4);
+  KATANA_LOG_ASSERT(topology.NumEdges() == 2);
+  // Each shard refers to its own "a"; placeholders follow in order of id
+  KATANA_LOG_ASSERT(topology.OutDegree(0) == 1);
+  KATANA_LOG_ASSERT(topology.OutEdgeDst(*topology.OutEdges(0).begin()) == 3);
+  KATANA_LOG_ASSERT(topology.OutDegree(2) == 1);
+  KATANA_LOG_ASSERT(topology.OutEdgeDst(*topology.OutEdges(2).begin()) == 1);
+}
+
+void
+TestSchema() {
+  katana::ImportSchema schema;
+  schema.keys.emplace_back(
+      "b", true, false, "b", katana::ImportDataType::kInt64, false);
+  schema.keys.emplace_back(
+      "a", true, false, "a", katana::ImportDataType::kInt64, false);
+  schema.labels.emplace_back("Second", true, false, "Second");
+  schema.labels.emplace_back("First", true, false, "First");
+
+  // A schema fixes the columns and their order, whichever shard adds
+  // values to them first
+  katana::ShardedPropertyGraphBuilder sharded(2, kChunkSize);
+  for (size_t s = 0; s < 2; ++s) {
+    sharded.shard(s).ApplySchema(schema);
+    sharded.shard(s).Reserve(1, 0);
+  }
+  katana::PropertyKey a = schema.keys[1];
+  KATANA_LOG_ASSERT(sharded.shard(0).StartNode("x"));
+  AddInt64(&sharded.shard(0), a, 1);
+  sharded.shard(0).AddLabel("First");
+  sharded.shard(0).FinishNode();
+  KATANA_LOG_ASSERT(sharded.shard(1).StartNode("y"));
+  sharded.shard(1).FinishNode();
+
+  auto components = sharded.Finish(false);
+  KATANA_LOG_ASSERT(components);
+  const auto& properties = components.value().nodes.properties;
+  const auto& labels = components.value().nodes.labels;
+  KATANA_LOG_ASSERT(properties->num_columns() == 2);
+  KATANA_LOG_ASSERT(properties->field(0)->name() == "b");
+  KATANA_LOG_ASSERT(properties->field(1)->name() == "a");
+  KATANA_LOG_ASSERT(properties->column(0)->null_count() == 2);
+  KATANA_LOG_ASSERT(properties->column(1)->null_count() == 1);
+  KATANA_LOG_ASSERT(labels->num_columns() == 2);
+  KATANA_LOG_ASSERT(labels->field(0)->name() == "Second");
+  KATANA_LOG_ASSERT(labels->field(1)->name() == "First");
+}
+
+void
+TestErrors() {
+  katana::ShardedPropertyGraphBuilder unfinished(2, kChunkSize);
+  KATANA_LOG_ASSERT(unfinished.shard(1).StartNode("a"));
+  KATANA_LOG_ASSERT(!unfinished.Finish(false));
+
+  katana::ShardedPropertyGraphBuilder mismatched(2, kChunkSize);
+  katana::PropertyKey int_key(
+      "x", true, false, "x", katana::ImportDataType::kInt64, false);
+  katana::PropertyKey string_key(
+      "x", true, false, "x", katana::ImportDataType::kString, false);
+  KATANA_LOG_ASSERT(mismatched.shard(0).StartNode("a"));
+  AddInt64(&mismatched.shard(0), int_key, 1);
+  mismatched.shard(0).FinishNode();
+  KATANA_LOG_ASSERT(mismatched.shard(1).StartNode("b"));
+  mismatched.shard(1).AddValue(
+      "x", [&]() -> katana::PropertyKey { return string_key; },
+      [](katana::ImportDataType, bool) {
+        katana::ImportData data(katana::ImportDataType::kString, false);
+        data.value = std::string("one");
+        return data;
+      });
+  mismatched.shard(1).FinishNode();
+  KATANA_LOG_ASSERT(!mismatched.Finish(false));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestMatchesSingleBuilder();
+  TestPlaceholders();
+  TestSchema();
+  TestErrors();
+
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+void
+TestExportAttach() {
+  constexpr size_t kNumNodes = 10;
+  constexpr size_t kNumProperties = 2;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{3};
+  auto g =
+      MakeFileGraph<uint32_t>(kNumNodes, kNumProperties, &policy, &txn_ctx);
+
+  auto uri_res = katana::URI::MakeRand("/tmp/sharedgraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir = uri_res.value().path();
+
+  auto export_res = katana::ExportSharedGraph(*g, dir);
+  if (!export_res) {
+    fs::remove_all(dir);
+    KATANA_LOG_FATAL("exporting: {}", export_res.error());
+  }
+
+  auto again_res = katana::ExportSharedGraph(*g, dir);
+  KATANA_LOG_ASSERT(!again_res);
+  KATANA_LOG_ASSERT(again_res.error() == katana::ErrorCode::AlreadyExists);
+
+  auto attach_res = katana::AttachSharedGraph(dir);
+  if (!attach_res) {
+    fs::remove_all(dir);
+    KATANA_LOG_FATAL("attaching: {}", attach_res.error());
+  }
+  std::shared_ptr<katana::PropertyGraph> g2 = std::move(attach_res.value());
+
+  // Attached graphs keep their mappings when the files are removed
+  fs::remove_all(dir);
+
+  KATANA_LOG_ASSERT(g2->topology().Equals(g->topology()));
+
+  KATANA_LOG_ASSERT(g2->GetNumNodeProperties() == g->GetNumNodeProperties());
+  for (int i = 0, n = g->GetNumNodeProperties(); i < n; ++i) {
+    KATANA_LOG_ASSERT(g2->loaded_node_schema()->field(i)->Equals(
+        g->loaded_node_schema()->field(i)));
+    KATANA_LOG_ASSERT(g2->GetNodeProperty(i)->Equals(g->GetNodeProperty(i)));
+  }
+  KATANA_LOG_ASSERT(g2->GetNumEdgeProperties() == g->GetNumEdgeProperties());
+  for (int i = 0, n = g->GetNumEdgeProperties(); i < n; ++i) {
+    KATANA_LOG_ASSERT(g2->loaded_edge_schema()->field(i)->Equals(
+        g->loaded_edge_schema()->field(i)));
+    KATANA_LOG_ASSERT(g2->GetEdgeProperty(i)->Equals(g->GetEdgeProperty(i)));
+  }
+
+  // Properties added after attaching are private to the attached graph
+  katana::TableBuilder builder{kNumNodes};
+  katana::ColumnOptions options;
+  options.name = "private";
+  builder.AddColumn<int64_t>(options);
+  KATANA_LOG_ASSERT(g2->AddNodeProperties(builder.Finish(), &txn_ctx));
+  KATANA_LOG_ASSERT(
+      g2->GetNumNodeProperties() == g->GetNumNodeProperties() + 1);
+}
+
+void
+TestAttachMissing() {
+  auto res = katana::AttachSharedGraph("/tmp/sharedgraph-does-not-exist");
+  KATANA_LOG_ASSERT(!res);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestExportAttach();
+  TestAttachMissing();
+
+  return 0;
+}
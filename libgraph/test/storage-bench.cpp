@@ -0,0 +1,325 @@
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <numeric>
+#include <thread>
+
+#include <arrow/api.h>
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/FileView.h"
+#include "katana/Logging.h"
+#include "katana/ParquetReader.h"
+#include "katana/ParquetWriter.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/URI.h"
+#include "katana/file.h"
+
+// Benchmarks of the storage paths: FileView, ParquetReader and RDG load and
+// store through PropertyGraph.
+//
+// Files are written under KATANA_STORAGE_BENCH_URI if it is set, e.g., to
+// s3://bucket/prefix to benchmark a remote store, and under a new local
+// temporary directory otherwise. The RDG benchmarks load the RDG given as the
+// first non-benchmark argument and are skipped if there is none.
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+katana::URI bench_dir;
+katana::URI input_rdg;
+
+template <typename T>
+bool
+Check(benchmark::State& state, const katana::Result<T>& res) {
+  if (!res) {
+    state.SkipWithError(fmt::format("{}", res.error()).c_str());
+    return false;
+  }
+  return true;
+}
+
+/// \returns a file of size bytes under bench_dir, written on first use
+katana::Result<katana::URI>
+DataFile(uint64_t size) {
+  static std::map<uint64_t, katana::URI> files;
+  if (auto it = files.find(size); it != files.end()) {
+    return it->second;
+  }
+  std::vector<uint64_t> data(size / sizeof(uint64_t));
+  std::iota(data.begin(), data.end(), 0);
+  katana::URI uri = bench_dir.Join(fmt::format("data-{}", size));
+  KATANA_CHECKED(katana::FileStore(uri.string(), data));
+  files.emplace(size, uri);
+  return uri;
+}
+
+/// \returns a parquet file of num_rows rows of an int64 and a double column
+/// under bench_dir, written on first use
+katana::Result<katana::URI>
+ParquetFile(int64_t num_rows) {
+  static std::map<int64_t, katana::URI> files;
+  if (auto it = files.find(num_rows); it != files.end()) {
+    return it->second;
+  }
+  arrow::Int64Builder ints;
+  arrow::DoubleBuilder doubles;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    KATANA_CHECKED(ints.Append(i * 31));
+    KATANA_CHECKED(doubles.Append(i * 0.5));
+  }
+  std::shared_ptr<arrow::Array> int_array;
+  std::shared_ptr<arrow::Array> double_array;
+  KATANA_CHECKED(ints.Finish(&int_array));
+  KATANA_CHECKED(doubles.Finish(&double_array));
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("int", arrow::int64()),
+           arrow::field("double", arrow::float64())}),
+      {int_array, double_array});
+
+  katana::URI uri = bench_dir.Join(fmt::format("table-{}.parquet", num_rows));
+  auto writer = KATANA_CHECKED(katana::ParquetWriter::Make(table));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+  files.emplace(num_rows, uri);
+  return uri;
+}
+
+/// Touch every page of a view so that mapped views are paged in
+uint64_t
+TouchPages(const katana::FileView& fv) {
+  uint64_t sum = 0;
+  for (const char* p = fv.begin(); p < fv.end(); p += 4096) {
+    sum += *p;
+  }
+  return sum;
+}
+
+void
+SizeArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"size", "map_mode"});
+  for (long size : {1L << 20, 64L << 20, 512L << 20}) {
+    for (auto mode :
+         {katana::FileView::MapMode::kCopy,
+          katana::FileView::MapMode::kMapPrivate,
+          katana::FileView::MapMode::kMapShared}) {
+      b->Args({size, static_cast<long>(mode)});
+    }
+  }
+}
+
+void
+FillArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"size", "fill_size"});
+  for (long size : {64L << 20, 512L << 20}) {
+    for (long fill_size : {4L << 10, 64L << 10, 1L << 20, 16L << 20}) {
+      b->Args({size, fill_size});
+    }
+  }
+}
+
+/// Benchmarks are registered before the thread pool exists, so thread
+/// counts are bounded by the hardware threads instead
+long
+MaxThreads() {
+  return std::max(1U, std::thread::hardware_concurrency());
+}
+
+void
+ThreadArguments(benchmark::internal::Benchmark* b) {
+  long max_threads = MaxThreads();
+  for (long threads = 1; threads < max_threads; threads *= 2) {
+    b->Args({threads});
+  }
+  b->Args({max_threads});
+}
+
+void
+ParquetArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"rows", "threads"});
+  long max_threads = MaxThreads();
+  for (long rows : {1L << 16, 1L << 22}) {
+    for (long threads = 1; threads < max_threads; threads *= 2) {
+      b->Args({rows, threads});
+    }
+    b->Args({rows, max_threads});
+  }
+}
+
+/// Bind and load a whole file, measuring throughput
+void
+FileViewBind(benchmark::State& state) {
+  uint64_t size = state.range(0);
+  auto mode = static_cast<katana::FileView::MapMode>(state.range(1));
+  auto uri = DataFile(size);
+  if (!Check(state, uri)) {
+    return;
+  }
+
+  for (auto _ : state) {
+    katana::FileView fv(mode);
+    if (!Check(state, fv.Bind(uri.value().string(), true))) {
+      return;
+    }
+    benchmark::DoNotOptimize(TouchPages(fv));
+  }
+
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+/// Bind a file without loading it and then fill it sequentially in
+/// fill_size requests, measuring throughput and the latency of each fill
+void
+FileViewFill(benchmark::State& state) {
+  uint64_t size = state.range(0);
+  uint64_t fill_size = state.range(1);
+  auto uri = DataFile(size);
+  if (!Check(state, uri)) {
+    return;
+  }
+
+  std::chrono::nanoseconds fill_time{0};
+  std::chrono::nanoseconds max_fill_time{0};
+  int64_t num_fills = 0;
+  for (auto _ : state) {
+    katana::FileView fv(katana::FileView::MapMode::kCopy);
+    if (!Check(state, fv.Bind(uri.value().string(), 0, 0, true))) {
+      return;
+    }
+    for (uint64_t begin = 0; begin < size; begin += fill_size) {
+      auto start = std::chrono::steady_clock::now();
+      if (!Check(state, fv.Fill(begin, begin + fill_size, true))) {
+        return;
+      }
+      std::chrono::nanoseconds elapsed =
+          std::chrono::steady_clock::now() - start;
+      fill_time += elapsed;
+      max_fill_time = std::max(max_fill_time, elapsed);
+      ++num_fills;
+    }
+  }
+
+  state.SetBytesProcessed(state.iterations() * size);
+  if (num_fills > 0) {
+    using Micros = std::chrono::duration<double, std::micro>;
+    state.counters["fill_us"] = Micros(fill_time).count() / num_fills;
+    state.counters["max_fill_us"] = Micros(max_fill_time).count();
+  }
+}
+
+/// Read and decode a whole parquet table
+void
+ParquetReadTable(benchmark::State& state) {
+  int64_t num_rows = state.range(0);
+  katana::setActiveThreads(state.range(1));
+  auto uri = ParquetFile(num_rows);
+  if (!Check(state, uri)) {
+    return;
+  }
+  auto reader = katana::ParquetReader::Make();
+  if (!Check(state, reader)) {
+    return;
+  }
+
+  for (auto _ : state) {
+    auto table = reader.value()->ReadTable(uri.value());
+    if (!Check(state, table)) {
+      return;
+    }
+    benchmark::DoNotOptimize(table.value()->num_rows());
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_rows);
+  state.SetBytesProcessed(
+      state.iterations() * num_rows * (sizeof(int64_t) + sizeof(double)));
+}
+
+/// Load the input RDG with all of its properties
+void
+RDGLoad(benchmark::State& state) {
+  if (input_rdg.empty()) {
+    state.SkipWithError("no input RDG");
+    return;
+  }
+  katana::setActiveThreads(state.range(0));
+
+  for (auto _ : state) {
+    katana::TxnContext txn_ctx;
+    auto pg = katana::PropertyGraph::Make(input_rdg, &txn_ctx);
+    if (!Check(state, pg)) {
+      return;
+    }
+    benchmark::DoNotOptimize(pg.value()->NumEdges());
+  }
+}
+
+/// Store the input RDG to a new location under bench_dir
+void
+RDGStore(benchmark::State& state) {
+  if (input_rdg.empty()) {
+    state.SkipWithError("no input RDG");
+    return;
+  }
+  katana::setActiveThreads(state.range(0));
+  katana::TxnContext txn_ctx;
+  auto pg = katana::PropertyGraph::Make(input_rdg, &txn_ctx);
+  if (!Check(state, pg)) {
+    return;
+  }
+
+  int64_t num_stores = 0;
+  for (auto _ : state) {
+    katana::URI out = bench_dir.Join(fmt::format("rdg-{}", num_stores++));
+    if (!Check(state, pg.value()->Write(out, "storage-bench", &txn_ctx))) {
+      return;
+    }
+  }
+}
+
+BENCHMARK(FileViewBind)->Apply(SizeArguments)->UseRealTime();
+BENCHMARK(FileViewFill)->Apply(FillArguments)->UseRealTime();
+BENCHMARK(ParquetReadTable)->Apply(ParquetArguments)->UseRealTime();
+BENCHMARK(RDGLoad)->ArgName("threads")->Apply(ThreadArguments)->UseRealTime();
+BENCHMARK(RDGStore)->ArgName("threads")->Apply(ThreadArguments)->UseRealTime();
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+
+  if (argc > 1) {
+    auto uri_res = katana::URI::Make(argv[1]);
+    if (!uri_res) {
+      KATANA_LOG_FATAL("input RDG {}: {}", argv[1], uri_res.error());
+    }
+    input_rdg = uri_res.value();
+  }
+
+  bool is_temp = false;
+  if (const char* dir = std::getenv("KATANA_STORAGE_BENCH_URI"); dir) {
+    auto uri_res = katana::URI::Make(dir);
+    if (!uri_res) {
+      KATANA_LOG_FATAL("KATANA_STORAGE_BENCH_URI: {}", uri_res.error());
+    }
+    bench_dir = uri_res.value();
+  } else {
+    auto uri_res = katana::URI::MakeRand("/tmp/storage-bench");
+    KATANA_LOG_ASSERT(uri_res);
+    bench_dir = uri_res.value();
+    fs::create_directories(bench_dir.path());
+    is_temp = true;
+  }
+
+  ::benchmark::RunSpecifiedBenchmarks();
+
+  // Files under KATANA_STORAGE_BENCH_URI are left for the caller to remove
+  if (is_temp) {
+    fs::remove_all(bench_dir.path());
+  }
+}
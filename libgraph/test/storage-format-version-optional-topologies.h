@@ -52,6 +52,12 @@ TestOptionalTopologyStorageEdgeShuffleTopology(const katana::URI& inputFile) {
   //TODO: emcginnis need some way to verify we loaded this view, vs just generating it again
 
   verify_view(generated_sorted_view, loaded_sorted_view);
+
+  // A topology loaded from storage is not rebuilt on the next write, but it
+  // must still be carried along to the new location
+  auto g3_rdg_file = StoreGraph(&pg2);
+  katana::PropertyGraph pg3 = LoadGraph(g3_rdg_file);
+  verify_view(generated_sorted_view, pg3.BuildView<SortedGraphView>());
 }
 
 void
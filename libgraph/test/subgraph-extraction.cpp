@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr uint32_t kNumNodes = 12;
+
+using Node = katana::PropertyGraph::Node;
+using EdgeSet = std::set<std::pair<uint32_t, uint32_t>>;
+
+/// Node n has the property "id" 10 * n and edge e the property "weight"
+/// 3 * e
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const EdgeSet& edges) {
+  // The set is ordered, so the edges of each node are sorted by destination
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(kNumNodes);
+  for (const auto& [src, dst] : edges) {
+    builder.AddEdge(src, dst);
+  }
+  auto pg_res = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  katana::TxnContext txn_ctx;
+  auto node_res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("id", [](auto node) {
+        return static_cast<int64_t>(10 * node);
+      }));
+  KATANA_LOG_VASSERT(node_res, "{}", node_res.error());
+  auto edge_res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("weight", [](auto edge) {
+        return static_cast<int64_t>(3 * edge);
+      }));
+  KATANA_LOG_VASSERT(edge_res, "{}", edge_res.error());
+  return pg;
+}
+
+int64_t
+ValueAt(const std::shared_ptr<arrow::ChunkedArray>& column, int64_t row) {
+  KATANA_LOG_ASSERT(row < column->length());
+  int chunk = 0;
+  for (; row >= column->chunk(chunk)->length(); ++chunk) {
+    row -= column->chunk(chunk)->length();
+  }
+  const auto& values =
+      static_cast<const arrow::Int64Array&>(*column->chunk(chunk));
+  return values.Value(row);
+}
+
+/// An edge of the sub-graph and the edge of the original graph it stands for
+struct ExpectedEdge {
+  Node src;
+  Node dst;
+  uint64_t original;
+};
+
+/// The edges of the sub-graph of nodes, whose node i is nodes[i], with the
+/// edges of each node in the order of the original IDs of their destinations
+std::vector<ExpectedEdge>
+ExpectedEdges(const EdgeSet& edges, const std::vector<Node>& nodes) {
+  std::vector<ExpectedEdge> expected;
+  for (Node i = 0; i < nodes.size(); ++i) {
+    uint64_t original = 0;
+    for (const auto& [src, dst] : edges) {
+      if (src == nodes[i]) {
+        auto it = std::find(nodes.begin(), nodes.end(), dst);
+        if (it != nodes.end()) {
+          expected.push_back(
+              {i, static_cast<Node>(it - nodes.begin()), original});
+        }
+      }
+      ++original;
+    }
+  }
+  return expected;
+}
+
+/// Check the topology of sub and, through get_id and get_weight, the
+/// properties it has for each node and edge
+template <typename GetId, typename GetWeight>
+void
+CheckSubGraph(
+    const katana::PropertyGraph& sub, const std::vector<Node>& nodes,
+    const std::vector<ExpectedEdge>& expected, GetId get_id,
+    GetWeight get_weight) {
+  KATANA_LOG_ASSERT(sub.NumNodes() == nodes.size());
+  KATANA_LOG_VASSERT(
+      sub.NumEdges() == expected.size(), "sub-graph has {} edges, expected {}",
+      sub.NumEdges(), expected.size());
+  for (Node n = 0; n < nodes.size(); ++n) {
+    KATANA_LOG_ASSERT(get_id(n) == 10 * nodes[n]);
+  }
+  size_t i = 0;
+  for (Node n = 0; n < nodes.size(); ++n) {
+    for (auto e : sub.topology().OutEdges(n)) {
+      KATANA_LOG_ASSERT(i < expected.size());
+      KATANA_LOG_ASSERT(expected[i].src == n);
+      KATANA_LOG_VASSERT(
+          sub.topology().OutEdgeDst(e) == expected[i].dst,
+          "edge {} goes to {}, expected {}", e, sub.topology().OutEdgeDst(e),
+          expected[i].dst);
+      KATANA_LOG_ASSERT(
+          get_weight(e) == static_cast<int64_t>(3 * expected[i].original));
+      ++i;
+    }
+  }
+}
+
+void
+TestExtraction() {
+  EdgeSet edges{{0, 1}, {0, 5}, {0, 7}, {1, 0}, {2, 0},  {2, 5},
+                {2, 7}, {3, 4}, {5, 2}, {5, 5}, {5, 11}, {7, 0},
+                {7, 2}, {7, 9}, {9, 7}, {11, 5}};
+  auto pg = MakeGraph(edges);
+
+  // Duplicates are dropped; node i of the sub-graph is the i-th distinct node
+  std::vector<Node> node_vec{7, 2, 5, 2, 0, 11};
+  std::vector<Node> nodes{7, 2, 5, 0, 11};
+  auto expected = ExpectedEdges(edges, nodes);
+
+  auto ids = pg->GetNodeProperty("id").value();
+  auto weights = pg->GetEdgeProperty("weight").value();
+
+  // The view reads the properties of the original graph by property index
+  auto view_res = SubGraphExtractionView(pg.get(), node_vec);
+  KATANA_LOG_VASSERT(view_res, "{}", view_res.error());
+  const katana::PropertyGraph& view = *view_res.value();
+  CheckSubGraph(
+      view, nodes, expected,
+      [&](Node n) { return ValueAt(ids, view.GetNodePropertyIndex(n)); },
+      [&](auto e) {
+        return ValueAt(weights, view.GetEdgePropertyIndexFromOutEdge(e));
+      });
+
+  // The copy has rows of its own
+  katana::TxnContext txn_ctx;
+  auto copy_res =
+      SubGraphExtraction(pg.get(), node_vec, {"id"}, {"weight"}, &txn_ctx);
+  KATANA_LOG_VASSERT(copy_res, "{}", copy_res.error());
+  const katana::PropertyGraph& copy = *copy_res.value();
+  auto copy_ids = copy.GetNodeProperty("id").value();
+  auto copy_weights = copy.GetEdgeProperty("weight").value();
+  KATANA_LOG_ASSERT(copy_ids->length() == static_cast<int64_t>(nodes.size()));
+  CheckSubGraph(
+      copy, nodes, expected, [&](Node n) { return ValueAt(copy_ids, n); },
+      [&](auto e) { return ValueAt(copy_weights, e); });
+
+  auto empty_res = SubGraphExtractionView(pg.get(), {});
+  KATANA_LOG_VASSERT(empty_res, "{}", empty_res.error());
+  KATANA_LOG_ASSERT(empty_res.value()->NumNodes() == 0);
+
+  KATANA_LOG_ASSERT(!SubGraphExtractionView(pg.get(), {0, kNumNodes}));
+}
+
+void
+TestProjectedTopology() {
+  EdgeSet edges{{0, 1}, {1, 2}, {2, 3}, {3, 0}};
+  auto pg = MakeGraph(edges);
+
+  // Nodes 3 and 1 of pg, with the edge 3 -> 0 standing for edge 1 -> 2 of pg
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(2);
+  adj_indices[0] = 1;
+  adj_indices[1] = 1;
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(1);
+  dests[0] = 1;
+  katana::GraphTopology::PropIndexVec edge_prop_indices;
+  edge_prop_indices.allocateInterleaved(1);
+  edge_prop_indices[0] = 1;
+  katana::GraphTopology::PropIndexVec node_prop_indices;
+  node_prop_indices.allocateInterleaved(2);
+  node_prop_indices[0] = 3;
+  node_prop_indices[1] = 1;
+
+  auto projected_res = katana::PropertyGraph::MakeProjectedGraph(
+      *pg, katana::GraphTopology{
+               std::move(adj_indices), std::move(dests),
+               std::move(edge_prop_indices), std::move(node_prop_indices)});
+  KATANA_LOG_VASSERT(projected_res, "{}", projected_res.error());
+  const katana::PropertyGraph& projected = *projected_res.value();
+  KATANA_LOG_ASSERT(projected.NumNodes() == 2);
+  KATANA_LOG_ASSERT(projected.NumEdges() == 1);
+  KATANA_LOG_ASSERT(projected.topology().OutEdgeDst(0) == 1);
+
+  auto ids = projected.GetNodeProperty("id").value();
+  auto weights = projected.GetEdgeProperty("weight").value();
+  KATANA_LOG_ASSERT(ValueAt(ids, projected.GetNodePropertyIndex(0)) == 30);
+  KATANA_LOG_ASSERT(ValueAt(ids, projected.GetNodePropertyIndex(1)) == 10);
+  KATANA_LOG_ASSERT(
+      ValueAt(weights, projected.GetEdgePropertyIndexFromOutEdge(0)) == 3);
+
+  // Property indices must be those of nodes of pg
+  katana::GraphTopology::AdjIndexVec bad_adj_indices;
+  bad_adj_indices.allocateInterleaved(1);
+  bad_adj_indices[0] = 0;
+  katana::GraphTopology::EdgeDestVec bad_dests;
+  katana::GraphTopology::PropIndexVec bad_edge_prop_indices;
+  katana::GraphTopology::PropIndexVec bad_node_prop_indices;
+  bad_node_prop_indices.allocateInterleaved(1);
+  bad_node_prop_indices[0] = kNumNodes;
+  KATANA_LOG_ASSERT(!katana::PropertyGraph::MakeProjectedGraph(
+      *pg, katana::GraphTopology{
+               std::move(bad_adj_indices), std::move(bad_dests),
+               std::move(bad_edge_prop_indices),
+               std::move(bad_node_prop_indices)}));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestExtraction();
+  TestProjectedTopology();
+
+  return 0;
+}
@@ -0,0 +1,127 @@
+#include <random>
+
+#include <arrow/api.h>
+#include <arrow/compute/api_vector.h>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TakeRows.h"
+
+namespace {
+
+constexpr int64_t kNumRows = 100000;
+
+/// A column of kNumRows in chunks of the given lengths, every seventh null
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+MakeColumn(
+    const std::shared_ptr<arrow::DataType>& type,
+    const std::vector<int64_t>& chunk_lengths) {
+  std::unique_ptr<arrow::ArrayBuilder> builder;
+  KATANA_CHECKED(
+      arrow::MakeBuilder(arrow::default_memory_pool(), type, &builder));
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    if (i % 7 == 3) {
+      KATANA_CHECKED(builder->AppendNull());
+      continue;
+    }
+    switch (type->id()) {
+    case arrow::Type::INT32:
+      KATANA_CHECKED(
+          static_cast<arrow::Int32Builder*>(builder.get())->Append(i));
+      break;
+    case arrow::Type::BOOL:
+      KATANA_CHECKED(static_cast<arrow::BooleanBuilder*>(builder.get())
+                         ->Append(i % 3 == 0));
+      break;
+    case arrow::Type::STRING:
+      KATANA_CHECKED(static_cast<arrow::StringBuilder*>(builder.get())
+                         ->Append(std::string(i % 13, 'a' + i % 26)));
+      break;
+    case arrow::Type::LARGE_STRING:
+      KATANA_CHECKED(static_cast<arrow::LargeStringBuilder*>(builder.get())
+                         ->Append(std::to_string(i)));
+      break;
+    default:
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "unexpected type {}",
+          type->ToString());
+    }
+  }
+  std::shared_ptr<arrow::Array> array = KATANA_CHECKED(builder->Finish());
+
+  arrow::ArrayVector chunks;
+  int64_t offset = 0;
+  for (int64_t length : chunk_lengths) {
+    chunks.emplace_back(array->Slice(offset, length));
+    offset += length;
+  }
+  chunks.emplace_back(array->Slice(offset));
+  return std::make_shared<arrow::ChunkedArray>(chunks);
+}
+
+/// Check TakeRows against arrow's Take for columns of each kind of gather,
+/// and a column of nulls that falls back to Take
+katana::Result<void>
+TestTakeRows() {
+  std::vector<std::shared_ptr<arrow::Field>> fields{
+      arrow::field("int", arrow::int32()),
+      arrow::field("bool", arrow::boolean()),
+      arrow::field("string", arrow::utf8()),
+      arrow::field("large_string", arrow::large_utf8()),
+  };
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns{
+      KATANA_CHECKED(MakeColumn(arrow::int32(), {})),
+      KATANA_CHECKED(MakeColumn(arrow::boolean(), {3, 0, 40000})),
+      KATANA_CHECKED(MakeColumn(arrow::utf8(), {1 << 14, 1 << 14})),
+      KATANA_CHECKED(MakeColumn(arrow::large_utf8(), {kNumRows - 1})),
+  };
+  fields.emplace_back(arrow::field("null", arrow::null()));
+  columns.emplace_back(std::make_shared<arrow::ChunkedArray>(
+      KATANA_CHECKED(arrow::MakeArrayOfNull(arrow::null(), kNumRows))));
+  auto table = arrow::Table::Make(arrow::schema(fields), columns);
+
+  // rows out of order and repeated, and fewer than in the table
+  std::mt19937_64 gen(kNumRows);
+  std::uniform_int_distribution<uint64_t> dist(0, kNumRows - 1);
+  std::vector<uint64_t> rows(kNumRows - 1001);
+  for (uint64_t& row : rows) {
+    row = dist(gen);
+  }
+
+  std::shared_ptr<arrow::Table> taken =
+      KATANA_CHECKED(katana::TakeRows(table, rows.data(), rows.size()));
+  KATANA_LOG_ASSERT(taken->num_rows() == static_cast<int64_t>(rows.size()));
+  KATANA_LOG_ASSERT(taken->schema()->Equals(*table->schema()));
+
+  arrow::UInt64Builder builder;
+  KATANA_CHECKED(builder.AppendValues(rows));
+  std::shared_ptr<arrow::Array> indices = KATANA_CHECKED(builder.Finish());
+  for (int c = 0; c < table->num_columns(); ++c) {
+    arrow::Datum expected =
+        KATANA_CHECKED(arrow::compute::Take(table->column(c), indices));
+    KATANA_LOG_ASSERT(taken->column(c)->Equals(expected.chunked_array()));
+    KATANA_LOG_ASSERT(
+        taken->column(c)->null_count() ==
+        expected.chunked_array()->null_count());
+  }
+
+  std::shared_ptr<arrow::Table> none =
+      KATANA_CHECKED(katana::TakeRows(table, rows.data(), 0));
+  KATANA_LOG_ASSERT(none->num_rows() == 0);
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  if (auto res = TestTakeRows(); !res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <random>
+
+#include <arrow/api.h>
+#include <arrow/type.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TemporalEdgeIndex.h"
+
+namespace {
+
+using Timestamp = katana::TemporalEdgeIndex::Timestamp;
+using TimedEdge = std::pair<Timestamp, katana::GraphTopology::Edge>;
+
+/// Random times in [-range / 2, range / 2), with every eleventh one null
+std::shared_ptr<arrow::Table>
+CreateTimeProperty(
+    const std::string& name, const std::shared_ptr<arrow::DataType>& type,
+    size_t num_edges, int64_t range, std::vector<Timestamp>* times) {
+  std::mt19937_64 gen(num_edges);
+  std::uniform_int_distribution<int64_t> dist(-range / 2, range / 2 - 1);
+  std::unique_ptr<arrow::ArrayBuilder> builder;
+  KATANA_LOG_ASSERT(
+      arrow::MakeBuilder(arrow::default_memory_pool(), type, &builder).ok());
+  for (size_t i = 0; i < num_edges; ++i) {
+    (*times)[i] = dist(gen);
+    arrow::Status status;
+    if (i % 11 == 5) {
+      status = builder->AppendNull();
+    } else if (type->id() == arrow::Type::TIMESTAMP) {
+      status = static_cast<arrow::TimestampBuilder*>(builder.get())
+                   ->Append((*times)[i]);
+    } else {
+      status =
+          static_cast<arrow::Int64Builder*>(builder.get())->Append((*times)[i]);
+    }
+    KATANA_LOG_ASSERT(status.ok());
+  }
+  std::vector<std::shared_ptr<arrow::Array>> chunks(1);
+  KATANA_LOG_ASSERT(builder->Finish(&chunks[0]).ok());
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, type)}),
+      {std::make_shared<arrow::ChunkedArray>(chunks)});
+}
+
+std::vector<TimedEdge>
+Collect(
+    const katana::TemporalEdgeIndex& index,
+    katana::TemporalEdgeIndex::EdgeRange range) {
+  std::vector<TimedEdge> edges;
+  for (const auto* it = range.begin(); it != range.end(); ++it) {
+    edges.emplace_back(index.TimeOf(it), *it);
+  }
+  return edges;
+}
+
+void
+TestWindows(
+    const std::shared_ptr<arrow::DataType>& type, size_t num_nodes,
+    int64_t range, uint64_t num_buckets) {
+  RandomPolicy policy{4};
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+  const katana::GraphTopology& topology = g->topology();
+
+  std::vector<Timestamp> times(topology.NumEdges());
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(
+      CreateTimeProperty("time", type, times.size(), range, &times),
+      &txn_ctx));
+  std::unique_ptr<katana::TemporalEdgeIndex> index =
+      katana::TemporalEdgeIndex::Make(*g, "time", num_buckets).value();
+  KATANA_LOG_ASSERT(index->size() == times.size() - (times.size() + 5) / 11);
+
+  // Every indexed edge is in exactly one bucket, within its window
+  uint64_t num_bucketed = 0;
+  for (uint64_t b = 0; b < index->num_buckets(); ++b) {
+    auto [first, last] = index->BucketWindow(b);
+    for (const auto& [time, edge] : Collect(*index, index->BucketEdges(b))) {
+      KATANA_LOG_ASSERT(first <= time && time <= last);
+      ++num_bucketed;
+    }
+  }
+  KATANA_LOG_ASSERT(num_bucketed == index->size());
+
+  std::mt19937_64 gen(num_nodes);
+  std::uniform_int_distribution<int64_t> dist(-range, range);
+  for (size_t q = 0; q < 100; ++q) {
+    Timestamp first = dist(gen);
+    Timestamp last = first + dist(gen) / 4;
+
+    std::vector<TimedEdge> expected;
+    for (auto edge : topology.OutEdges()) {
+      auto row = g->GetEdgePropertyIndexFromOutEdge(edge);
+      if (row % 11 != 5 && first <= times[row] && times[row] <= last) {
+        expected.emplace_back(times[row], edge);
+      }
+    }
+    std::sort(expected.begin(), expected.end());
+    KATANA_LOG_VASSERT(
+        Collect(*index, index->EdgesInWindow(first, last)) == expected,
+        "window [{}, {}]", first, last);
+
+    auto node = static_cast<katana::GraphTopology::Node>(gen() % num_nodes);
+    std::vector<TimedEdge> expected_out;
+    for (const auto& timed : expected) {
+      if (topology.GetEdgeSrc(timed.second) == node) {
+        expected_out.emplace_back(timed);
+      }
+    }
+    KATANA_LOG_ASSERT(
+        Collect(*index, index->OutEdgesInWindow(node, first, last)) ==
+        expected_out);
+  }
+}
+
+void
+TestErrors() {
+  LinePolicy policy{3};
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<double>(10, 1, &policy, &txn_ctx);
+  std::string name = g->loaded_edge_schema()->field(0)->name();
+  KATANA_LOG_ASSERT(!katana::TemporalEdgeIndex::Make(*g, name));
+  KATANA_LOG_ASSERT(!katana::TemporalEdgeIndex::Make(*g, "missing"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  auto timestamp = arrow::timestamp(arrow::TimeUnit::MICRO);
+  TestWindows(timestamp, 10, 1000, 0);
+  TestWindows(timestamp, 5000, 1000000, 0);
+  TestWindows(arrow::int64(), 5000, 100, 7);
+  TestWindows(arrow::int64(), 5000, 1000000, 1);
+  TestErrors();
+
+  return 0;
+}
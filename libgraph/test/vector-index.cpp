@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <random>
+
+#include <arrow/api.h>
+#include <arrow/type.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "storage-format-version.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/VectorIndex.h"
+
+namespace {
+
+constexpr size_t kDimension = 11;
+
+/// Vectors in clusters around a few centers, with every seventh one null
+std::vector<std::vector<float>>
+RandomVectors(size_t num_vectors, std::mt19937_64* gen) {
+  std::normal_distribution<float> noise;
+  std::vector<std::vector<float>> vectors(num_vectors);
+  for (size_t i = 0; i < num_vectors; ++i) {
+    for (size_t d = 0; d < kDimension; ++d) {
+      vectors[i].emplace_back(noise(*gen) + 4.0f * ((i + d) % 5));
+    }
+  }
+  return vectors;
+}
+
+std::shared_ptr<arrow::Table>
+CreateVectorProperty(
+    const std::string& name, const std::vector<std::vector<float>>& vectors) {
+  auto value_builder = std::make_shared<arrow::FloatBuilder>();
+  arrow::FixedSizeListBuilder builder(
+      arrow::default_memory_pool(), value_builder, kDimension);
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    if (i % 7 == 3) {
+      KATANA_LOG_ASSERT(builder.AppendNull().ok());
+      continue;
+    }
+    KATANA_LOG_ASSERT(builder.Append().ok());
+    KATANA_LOG_ASSERT(
+        value_builder->AppendValues(vectors[i].data(), kDimension).ok());
+  }
+  std::vector<std::shared_ptr<arrow::Array>> chunks(1);
+  KATANA_LOG_ASSERT(builder.Finish(&chunks[0]).ok());
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, chunks[0]->type())}),
+      {std::make_shared<arrow::ChunkedArray>(chunks)});
+}
+
+float
+Distance(
+    katana::VectorMetric metric, const std::vector<float>& a,
+    const std::vector<float>& b) {
+  double dot = 0;
+  double l2 = 0;
+  double norms = 1;
+  for (size_t d = 0; d < kDimension; ++d) {
+    dot += a[d] * b[d];
+    l2 += (a[d] - b[d]) * (a[d] - b[d]);
+  }
+  switch (metric) {
+  case katana::VectorMetric::kL2:
+    return l2;
+  case katana::VectorMetric::kInnerProduct:
+    return -dot;
+  case katana::VectorMetric::kCosine:
+    for (const auto* v : {&a, &b}) {
+      double norm = 0;
+      for (float x : *v) {
+        norm += x * x;
+      }
+      norms *= std::sqrt(norm);
+    }
+    return 1 - dot / norms;
+  }
+  return 0;
+}
+
+void
+TestSearch(katana::VectorMetric metric, size_t num_nodes) {
+  LinePolicy policy{3};
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+
+  std::mt19937_64 gen(num_nodes);
+  std::vector<std::vector<float>> vectors = RandomVectors(num_nodes, &gen);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      CreateVectorProperty("embedding", vectors), &txn_ctx));
+
+  katana::VectorIndex::Options options;
+  options.metric = metric;
+  KATANA_LOG_ASSERT(g->MakeNodeVectorIndex("embedding", options));
+  KATANA_LOG_ASSERT(!g->MakeNodeVectorIndex("embedding", options));
+  std::shared_ptr<katana::VectorIndex> index =
+      g->GetNodeVectorIndex("embedding").value();
+  KATANA_LOG_ASSERT(index->size() == num_nodes - (num_nodes + 3) / 7);
+
+  constexpr size_t kNumQueries = 16;
+  constexpr size_t kK = 10;
+  std::vector<std::vector<float>> queries = RandomVectors(kNumQueries, &gen);
+  std::vector<float> flat;
+  for (const auto& query : queries) {
+    flat.insert(flat.end(), query.begin(), query.end());
+  }
+
+  // Probing every list is an exact search
+  katana::VectorIndex::Neighbors exact =
+      index->Search(flat.data(), kNumQueries, kK, index->num_lists()).value();
+  katana::VectorIndex::Neighbors approximate =
+      index->Search(flat.data(), kNumQueries, kK, 2).value();
+  for (size_t q = 0; q < kNumQueries; ++q) {
+    std::vector<std::pair<float, uint32_t>> expected;
+    for (size_t i = 0; i < num_nodes; ++i) {
+      if (i % 7 != 3) {
+        expected.emplace_back(Distance(metric, queries[q], vectors[i]), i);
+      }
+    }
+    std::sort(expected.begin(), expected.end());
+    for (size_t i = 0; i < kK; ++i) {
+      if (i >= expected.size()) {
+        KATANA_LOG_ASSERT(
+            exact.ids[q * kK + i] == katana::VectorIndex::kNoNeighbor);
+        continue;
+      }
+      float distance = exact.distances[q * kK + i];
+      KATANA_LOG_VASSERT(
+          std::abs(distance - expected[i].first) <=
+              1e-4 * (1 + std::abs(expected[i].first)),
+          "neighbor {} of query {}: {} != {}", i, q, distance,
+          expected[i].first);
+      // Approximate neighbors are never nearer than the exact ones
+      KATANA_LOG_ASSERT(
+          approximate.ids[q * kK + i] == katana::VectorIndex::kNoNeighbor ||
+          approximate.distances[q * kK + i] >= distance - 1e-4);
+    }
+  }
+
+  // The index is stored with the graph and maps back identically
+  StoreGraph(g.get());
+  katana::URI rdg_dir = StoreGraph(g.get());
+  katana::PropertyGraph loaded = LoadGraph(rdg_dir);
+  KATANA_LOG_ASSERT(loaded.node_vector_indexes().size() == 1);
+  std::shared_ptr<katana::VectorIndex> loaded_index =
+      loaded.GetNodeVectorIndex("embedding").value();
+  KATANA_LOG_ASSERT(loaded_index->metric() == metric);
+  katana::VectorIndex::Neighbors reloaded =
+      loaded_index->Search(flat.data(), kNumQueries, kK, 2).value();
+  KATANA_LOG_ASSERT(reloaded.ids == approximate.ids);
+  KATANA_LOG_ASSERT(reloaded.distances == approximate.distances);
+
+  KATANA_LOG_ASSERT(g->DeleteNodeVectorIndex("embedding"));
+  KATANA_LOG_ASSERT(!g->HasNodeVectorIndex("embedding"));
+}
+
+void
+TestErrors() {
+  LinePolicy policy{3};
+  katana::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(10, 1, &policy, &txn_ctx);
+  std::string scalar = g->loaded_node_schema()->field(0)->name();
+  KATANA_LOG_ASSERT(!g->MakeNodeVectorIndex(scalar));
+
+  std::mt19937_64 gen(0);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      CreateVectorProperty("embedding", RandomVectors(10, &gen)), &txn_ctx));
+  KATANA_LOG_ASSERT(g->MakeNodeVectorIndex("embedding"));
+  std::shared_ptr<katana::VectorIndex> index =
+      g->GetNodeVectorIndex("embedding").value();
+
+  auto value_builder = std::make_shared<arrow::FloatBuilder>();
+  arrow::FixedSizeListBuilder builder(
+      arrow::default_memory_pool(), value_builder, 2);
+  KATANA_LOG_ASSERT(builder.Append().ok());
+  KATANA_LOG_ASSERT(value_builder->AppendValues({1.0f, 2.0f}).ok());
+  std::shared_ptr<arrow::Array> wrong_dimension;
+  KATANA_LOG_ASSERT(builder.Finish(&wrong_dimension).ok());
+  KATANA_LOG_ASSERT(!index->Search(*wrong_dimension, 1, 1));
+
+  float query[kDimension] = {};
+  KATANA_LOG_ASSERT(!index->Search(query, 1, 1, 0));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  for (auto metric :
+       {katana::VectorMetric::kL2, katana::VectorMetric::kInnerProduct,
+        katana::VectorMetric::kCosine}) {
+    TestSearch(metric, 5);
+    TestSearch(metric, 2000);
+  }
+  TestErrors();
+
+  return 0;
+}
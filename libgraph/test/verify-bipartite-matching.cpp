@@ -0,0 +1,91 @@
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// A graph on topo whose nodes have the type "left" when is_left says so
+/// and "right" otherwise
+template <typename IsLeft>
+std::unique_ptr<katana::PropertyGraph>
+MakeTyped(katana::GraphTopology&& topo, IsLeft is_left) {
+  katana::EntityTypeManager node_type_manager;
+  auto left_res = node_type_manager.AddAtomicEntityType("left");
+  auto right_res = node_type_manager.AddAtomicEntityType("right");
+  KATANA_LOG_ASSERT(left_res && right_res);
+  katana::PropertyGraph::EntityTypeIDArray node_types;
+  node_types.allocateInterleaved(topo.NumNodes());
+  for (auto node : topo.Nodes()) {
+    node_types[node] = is_left(node) ? left_res.value() : right_res.value();
+  }
+  katana::PropertyGraph::EntityTypeIDArray edge_types;
+  edge_types.allocateInterleaved(topo.NumEdges());
+  std::fill(edge_types.begin(), edge_types.end(), katana::kUnknownEntityType);
+  auto pg_res = katana::PropertyGraph::Make(
+      std::move(topo), std::move(node_types), std::move(edge_types),
+      std::move(node_type_manager), katana::EntityTypeManager{});
+  KATANA_LOG_VASSERT(pg_res, "making the graph failed: {}", pg_res.error());
+  return std::move(pg_res.value());
+}
+
+BipartiteMatchingStatistics
+RunMatching(katana::PropertyGraph* pg, const std::string& output_name) {
+  katana::TxnContext txn_ctx;
+  auto res = BipartiteMatching(pg, "left", output_name, &txn_ctx);
+  KATANA_LOG_VASSERT(res, "BipartiteMatching failed: {}", res.error());
+
+  auto valid_res = BipartiteMatchingAssertValid(pg, "left", output_name);
+  KATANA_LOG_VASSERT(valid_res, "invalid matching: {}", valid_res.error());
+
+  auto stats_res =
+      BipartiteMatchingStatistics::Compute(pg, "left", output_name);
+  KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+  return stats_res.value();
+}
+
+void
+TestGrid() {
+  // A checkerboard coloring of a grid without diagonals is a bipartition
+  // with a perfect matching
+  constexpr uint32_t kWidth = 30;
+  auto grid = katana::MakeGrid(kWidth, 20, false);
+  auto pg = MakeTyped(
+      katana::GraphTopology::Copy(grid->topology()), [](uint32_t node) {
+        return (node % kWidth + node / kWidth) % 2 == 0;
+      });
+  auto stats = RunMatching(pg.get(), "partner");
+  KATANA_LOG_ASSERT(stats.num_left_nodes == pg->NumNodes() / 2);
+  KATANA_LOG_VASSERT(
+      stats.num_matched == pg->NumNodes() / 2, "matched {} pairs",
+      stats.num_matched);
+}
+
+void
+TestRandom() {
+  // Edges between two left or two right nodes are ignored
+  auto pg = MakeTyped(
+      katana::CreateUniformRandomTopology(2000, 3),
+      [](uint32_t node) { return node % 3 == 0; });
+  auto stats = RunMatching(pg.get(), "partner");
+  KATANA_LOG_ASSERT(stats.num_matched <= stats.num_left_nodes);
+  KATANA_LOG_ASSERT(stats.num_matched > 0);
+
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(
+      !BipartiteMatching(pg.get(), "no_such_type", "none", &txn_ctx));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestGrid();
+  TestRandom();
+
+  return 0;
+}
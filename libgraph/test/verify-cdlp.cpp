@@ -7,16 +7,23 @@ using namespace katana::analytics;
 void
 RunCdlp(
     std::unique_ptr<katana::PropertyGraph>&& pg, const bool& is_symmetric,
-    const CdlpStatistics cdlp_expected_statistics) noexcept {
-  using Plan = CdlpPlan;
-  Plan plan = Plan::Synchronous();
+    const CdlpStatistics cdlp_expected_statistics,
+    CdlpPlan plan = CdlpPlan::Synchronous()) noexcept {
   const std::string property_name = "community";
 
   katana::TxnContext txn_ctx;
-  auto cdlp = Cdlp(pg.get(), property_name, 10, &txn_ctx, is_symmetric, plan);
+  std::vector<uint64_t> changed_per_iteration;
+  auto cdlp = Cdlp(
+      pg.get(), property_name, 10, &txn_ctx, is_symmetric, plan,
+      &changed_per_iteration);
   KATANA_LOG_VASSERT(cdlp, " CDLP failed and returned error {}", cdlp.error());
+  KATANA_LOG_VASSERT(
+      !changed_per_iteration.empty() && changed_per_iteration.size() <= 10,
+      "Wrong number of iterations. Found: {}, Expected: 1 to 10",
+      changed_per_iteration.size());
 
-  auto stats_result = CdlpStatistics::Compute(pg.get(), property_name);
+  auto stats_result = CdlpStatistics::Compute(
+      pg.get(), property_name, changed_per_iteration);
   KATANA_LOG_VASSERT(
       stats_result, "Failed to compute Cdlp statistics: {}",
       stats_result.error());
@@ -64,5 +71,16 @@ main() {
   // Triangular array tests
   RunCdlp(katana::MakeTriangle(1), true, CdlpStatistics{1, 1, 3, 1});
 
+  // The frontier variant finds the same labels
+  RunCdlp(
+      katana::MakeGrid(2, 2, true), true, CdlpStatistics{1, 1, 4, 1},
+      CdlpPlan::Frontier());
+  RunCdlp(
+      katana::MakeGrid(2, 2, false), true, CdlpStatistics{2, 2, 2, 0.5},
+      CdlpPlan::Frontier());
+  RunCdlp(
+      katana::MakeTriangle(1), true, CdlpStatistics{1, 1, 3, 1},
+      CdlpPlan::Frontier());
+
   return 0;
 }
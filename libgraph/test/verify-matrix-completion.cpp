@@ -0,0 +1,125 @@
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "katana/AtomicWrapper.h"
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/matrix_completion/matrix_completion.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr uint32_t kNumItems = 8;
+constexpr uint32_t kNumUsers = 12;
+constexpr size_t kLatentVectorSize = 20;
+
+struct LatentVector
+    : public katana::ArrayProperty<
+          katana::CopyableAtomic<double>, kLatentVectorSize> {};
+struct Rating : public katana::PODProperty<double> {};
+
+using Graph = katana::TypedPropertyGraph<
+    std::tuple<LatentVector>, std::tuple<Rating>>;
+
+/// Item i rates user u (i + 1) * (u % 3 + 1) / 4, a matrix of rank one.
+/// Items come first; item i skips user i + 1.
+template <typename Builder>
+std::unique_ptr<katana::PropertyGraph>
+MakeRatings() {
+  Builder builder;
+  builder.AddNodes(kNumItems + kNumUsers);
+  for (uint32_t i = 0; i < kNumItems; ++i) {
+    for (uint32_t u = 0; u < kNumUsers; ++u) {
+      if (u != i + 1) {
+        builder.AddEdge(i, kNumItems + u);
+      }
+    }
+  }
+  auto pg_res = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  katana::TxnContext txn_ctx;
+  const katana::GraphTopology& topology = pg->topology();
+  auto add_res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator("rating", [&](auto edge) {
+        uint32_t item = topology.GetEdgeSrc(edge);
+        uint32_t user = topology.OutEdgeDst(edge);
+        if (item >= kNumItems) {
+          std::swap(item, user);
+        }
+        return (item + 1) * ((user - kNumItems) % 3 + 1) / 4.0;
+      }));
+  KATANA_LOG_VASSERT(add_res, "{}", add_res.error());
+  return pg;
+}
+
+double
+Predict(Graph& graph, uint32_t item, uint32_t user) {
+  auto x = graph.GetData<LatentVector>(item);
+  auto y = graph.GetData<LatentVector>(kNumItems + user);
+  double dot = 0;
+  for (size_t i = 0; i < kLatentVectorSize; ++i) {
+    dot += x[i] * y[i];
+  }
+  return dot;
+}
+
+void
+TestFit(const MatrixCompletionPlan& plan, double tolerance) {
+  auto pg = MakeRatings<katana::AsymmetricGraphTopologyBuilder>();
+  katana::TxnContext txn_ctx;
+  auto res = MatrixCompletion(pg.get(), &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  auto graph_res = Graph::Make(pg.get(), {"Column_0"}, {"rating"});
+  KATANA_LOG_VASSERT(graph_res, "{}", graph_res.error());
+  Graph graph = std::move(graph_res.value());
+
+  double sum_squared_error = 0;
+  for (uint32_t item = 0; item < kNumItems; ++item) {
+    for (auto e : graph.OutEdges(item)) {
+      double error = graph.GetEdgeData<Rating>(e) -
+                     Predict(graph, item, graph.OutEdgeDst(e) - kNumItems);
+      sum_squared_error += error * error;
+    }
+  }
+  double rmse = std::sqrt(sum_squared_error / pg->NumEdges());
+  KATANA_LOG_VASSERT(
+      rmse < tolerance, "algorithm {} fits with an RMSE of {}",
+      static_cast<int>(plan.algorithm()), rmse);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(2);
+
+  TestFit(MatrixCompletionPlan::ALS(0.001, 0.01, false, 100, 20), 0.05);
+  TestFit(
+      MatrixCompletionPlan::SGDTiled(
+          0.05, 0.015, 0.001, 0.01, false, 1000, 400),
+      0.2);
+
+  // Out-edges of users would be taken for ratings of items
+  auto symmetric = MakeRatings<katana::SymmetricGraphTopologyBuilder>();
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(!MatrixCompletion(
+      symmetric.get(), &txn_ctx, MatrixCompletionPlan::ALS()));
+
+  return 0;
+}
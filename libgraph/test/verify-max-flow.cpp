@@ -0,0 +1,102 @@
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/max_flow/max_flow.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+MaxFlowStatistics
+RunMaxFlow(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_name, const std::string& output_name,
+    MaxFlowPlan plan) {
+  katana::TxnContext txn_ctx;
+  auto res =
+      MaxFlow(pg, source, sink, capacity_name, output_name, &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "MaxFlow failed: {}", res.error());
+
+  auto valid_res =
+      MaxFlowAssertValid(pg, source, sink, capacity_name, output_name);
+  KATANA_LOG_VASSERT(valid_res, "invalid flow: {}", valid_res.error());
+
+  auto stats_res = MaxFlowStatistics::Compute(
+      pg, source, sink, capacity_name, output_name);
+  KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+  return stats_res.value();
+}
+
+template <typename Capacity>
+void
+TestCapacities() {
+  auto pg = katana::MakeGrid(24, 24, true);
+  katana::TxnContext txn_ctx;
+  auto add_res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("capacity", [](auto edge) {
+        return static_cast<Capacity>((edge * 7919) % 13);
+      }));
+  KATANA_LOG_VASSERT(add_res, "adding capacities failed: {}", add_res.error());
+
+  uint32_t sink = pg->NumNodes() - 1;
+  auto flow = RunMaxFlow(
+      pg.get(), 0, sink, "capacity", "flow", MaxFlowPlan::PreflowPush());
+  // Frequent global relabels and no gap heuristic find the same value
+  auto other = RunMaxFlow(
+      pg.get(), 0, sink, "capacity", "other_flow",
+      MaxFlowPlan::PreflowPush(16, false));
+  KATANA_LOG_VASSERT(
+      flow.flow_value == other.flow_value, "flows of {} and {}",
+      flow.flow_value, other.flow_value);
+  KATANA_LOG_ASSERT(flow.flow_value > 0);
+}
+
+void
+TestUnitCapacities() {
+  // Without capacities the flow counts edge disjoint paths, which are as
+  // many as the edges of a grid corner
+  auto grid = katana::MakeGrid(12, 12, false);
+  auto stats = RunMaxFlow(
+      grid.get(), 0, grid->NumNodes() - 1, "", "flow",
+      MaxFlowPlan::PreflowPush());
+  KATANA_LOG_VASSERT(stats.flow_value == 2, "flow of {}", stats.flow_value);
+
+  auto wheel = katana::MakeFerrisWheel(30);
+  auto wheel_stats =
+      RunMaxFlow(wheel.get(), 1, 15, "", "flow", MaxFlowPlan::PreflowPush());
+  KATANA_LOG_VASSERT(
+      wheel_stats.flow_value == 3, "flow of {}", wheel_stats.flow_value);
+}
+
+void
+TestInvalid() {
+  auto pg = katana::MakeGrid(4, 4, false);
+  katana::TxnContext txn_ctx;
+  auto add_res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "negative",
+          [](auto edge) { return static_cast<int32_t>(edge % 5) - 1; }),
+      katana::PropertyGenerator(
+          "fractional", [](auto edge) { return 0.5 * edge; }));
+  KATANA_LOG_VASSERT(add_res, "adding capacities failed: {}", add_res.error());
+
+  KATANA_LOG_ASSERT(!MaxFlow(pg.get(), 0, 15, "negative", "a", &txn_ctx));
+  KATANA_LOG_ASSERT(!MaxFlow(pg.get(), 0, 15, "fractional", "b", &txn_ctx));
+  KATANA_LOG_ASSERT(!MaxFlow(pg.get(), 3, 3, "", "c", &txn_ctx));
+  KATANA_LOG_ASSERT(!MaxFlow(pg.get(), 0, 16, "", "d", &txn_ctx));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestCapacities<uint32_t>();
+  TestCapacities<int64_t>();
+  TestUnitCapacities();
+  TestInvalid();
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+MinimumSpanningForestStatistics
+RunMsf(
+    katana::PropertyGraph* pg, const std::string& weight_name,
+    const std::string& output_name, MinimumSpanningForestPlan plan) {
+  katana::TxnContext txn_ctx;
+  auto res =
+      MinimumSpanningForest(pg, weight_name, output_name, &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "MinimumSpanningForest failed: {}", res.error());
+
+  auto valid_res =
+      MinimumSpanningForestAssertValid(pg, weight_name, output_name);
+  KATANA_LOG_VASSERT(valid_res, "invalid forest: {}", valid_res.error());
+
+  auto stats_res =
+      MinimumSpanningForestStatistics::Compute(pg, weight_name, output_name);
+  KATANA_LOG_VASSERT(stats_res, "statistics failed: {}", stats_res.error());
+  return stats_res.value();
+}
+
+template <typename Weight>
+void
+TestWeights() {
+  auto pg = katana::MakeGrid(20, 20, true);
+  katana::TxnContext txn_ctx;
+  auto add_res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("weight", [](auto edge) {
+        return static_cast<Weight>((edge * 7919) % 13);
+      }));
+  KATANA_LOG_VASSERT(add_res, "adding weights failed: {}", add_res.error());
+
+  auto boruvka = RunMsf(
+      pg.get(), "weight", "boruvka", MinimumSpanningForestPlan::Boruvka());
+  // A small base case so that edges are partitioned and filtered
+  auto filter_kruskal = RunMsf(
+      pg.get(), "weight", "filter_kruskal",
+      MinimumSpanningForestPlan::FilterKruskal(16));
+
+  KATANA_LOG_ASSERT(boruvka.num_trees == 1);
+  KATANA_LOG_ASSERT(boruvka.num_edges == pg->NumNodes() - 1);
+  KATANA_LOG_ASSERT(filter_kruskal.num_edges == boruvka.num_edges);
+  KATANA_LOG_VASSERT(
+      filter_kruskal.total_weight == boruvka.total_weight,
+      "Filter-Kruskal weighs {}, Boruvka weighs {}",
+      filter_kruskal.total_weight, boruvka.total_weight);
+}
+
+void
+TestUnitWeights() {
+  // Without weights every spanning tree is minimal
+  auto pg = katana::MakeFerrisWheel(30);
+  for (auto plan :
+       {MinimumSpanningForestPlan::Boruvka(),
+        MinimumSpanningForestPlan::FilterKruskal(4)}) {
+    std::string output_name =
+        plan.algorithm() == MinimumSpanningForestPlan::kBoruvka ? "b" : "fk";
+    auto stats = RunMsf(pg.get(), "", output_name, plan);
+    KATANA_LOG_ASSERT(stats.num_trees == 1);
+    KATANA_LOG_ASSERT(
+        stats.total_weight == static_cast<double>(pg->NumNodes() - 1));
+  }
+
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(
+      !MinimumSpanningForest(pg.get(), "no_such_weight", "out", &txn_ctx));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestWeights<uint32_t>();
+  TestWeights<int64_t>();
+  TestWeights<double>();
+  TestUnitWeights();
+
+  return 0;
+}
@@ -0,0 +1,338 @@
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+// Benchmarks of view construction: every PGViewBuilder specialization end to
+// end, and the phases views are built from (transposing, sorting edges,
+// sorting nodes, building type and lookup indexes and converting to
+// RDGTopology) on their own.
+//
+// Graphs are R-MAT graphs with 16 edges per node at several scales and skews,
+// with a few node and edge types, so that type-aware views do real work.
+
+namespace {
+
+constexpr uint64_t kEdgeFactor = 16;
+constexpr uint32_t kNumTypes = 4;
+
+/// R-MAT probabilities (a, b, c) by skew: uniform, mild and Graph500
+constexpr double kSkews[][3] = {
+    {0.25, 0.25, 0.25},
+    {0.45, 0.22, 0.22},
+    {0.57, 0.19, 0.19},
+};
+
+struct BaseGraph {
+  katana::GraphTopology topology;
+  std::vector<katana::EntityTypeID> node_types;
+  std::vector<katana::EntityTypeID> edge_types;
+};
+
+uint32_t
+TypeOf(uint64_t id) {
+  return (id * 0x9E3779B97F4A7C15ULL >> 32) % kNumTypes;
+}
+
+/// \returns the topology and types of the graph of the given scale and skew,
+/// generated on first use
+const BaseGraph&
+GetBaseGraph(uint32_t scale, int skew) {
+  static std::map<std::pair<uint32_t, int>, BaseGraph> graphs;
+  auto key = std::make_pair(scale, skew);
+  if (auto it = graphs.find(key); it != graphs.end()) {
+    return it->second;
+  }
+
+  katana::RandomTopologyOptions options;
+  options.seed = scale;
+  const double* p = kSkews[skew];
+  auto topo_res =
+      katana::CreateRmatTopology(scale, kEdgeFactor, options, p[0], p[1], p[2]);
+  KATANA_LOG_VASSERT(topo_res, "{}", topo_res.error());
+
+  BaseGraph base{std::move(topo_res.value()), {}, {}};
+  // Type id 0 is kUnknownEntityType, so atomic types start at 1
+  for (auto node : base.topology.Nodes()) {
+    base.node_types.emplace_back(TypeOf(node) + 1);
+  }
+  for (auto edge : base.topology.OutEdges()) {
+    base.edge_types.emplace_back(TypeOf(edge) + 1);
+  }
+  return graphs.emplace(key, std::move(base)).first->second;
+}
+
+katana::EntityTypeManager
+MakeTypeManager() {
+  katana::EntityTypeManager manager;
+  for (uint32_t i = 0; i < kNumTypes; ++i) {
+    auto res = manager.AddAtomicEntityType(fmt::format("type{}", i));
+    KATANA_LOG_VASSERT(res, "{}", res.error());
+  }
+  return manager;
+}
+
+katana::PropertyGraph::EntityTypeIDArray
+MakeTypeArray(const std::vector<katana::EntityTypeID>& types) {
+  katana::PropertyGraph::EntityTypeIDArray array;
+  array.allocateInterleaved(types.size());
+  std::copy(types.begin(), types.end(), array.begin());
+  return array;
+}
+
+/// \returns a new graph, with no views yet, of the scale and skew of the
+/// benchmark arguments
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const benchmark::State& state) {
+  const BaseGraph& base = GetBaseGraph(state.range(0), state.range(1));
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::GraphTopology::Copy(base.topology),
+      MakeTypeArray(base.node_types), MakeTypeArray(base.edge_types),
+      MakeTypeManager(), MakeTypeManager());
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  return std::move(pg_res.value());
+}
+
+void
+GraphArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"scale", "skew"});
+  for (long scale : {14, 18}) {
+    for (long skew = 0; skew < static_cast<long>(std::size(kSkews)); ++skew) {
+      b->Args({scale, skew});
+    }
+  }
+}
+
+void
+SetEdgesProcessed(benchmark::State& state) {
+  const BaseGraph& base = GetBaseGraph(state.range(0), state.range(1));
+  state.SetItemsProcessed(state.iterations() * base.topology.NumEdges());
+}
+
+/// Build a view on a graph without any cached topologies
+template <typename View>
+void
+BuildView(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto pg = MakeGraph(state);
+    state.ResumeTiming();
+
+    View view = pg->BuildView<View>();
+    benchmark::DoNotOptimize(view.NumEdges());
+
+    state.PauseTiming();
+    pg.reset();
+    state.ResumeTiming();
+  }
+  SetEdgesProcessed(state);
+}
+
+using Views = katana::PropertyGraphViews;
+
+BENCHMARK_TEMPLATE(BuildView, Views::Default)->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BuildView, Views::Transposed)->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BuildView, Views::BiDirectional)->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BuildView, Views::Undirected)->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BuildView, Views::EdgesSortedByDestID)
+    ->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BuildView, Views::EdgesSortedByDestIDIndexed)
+    ->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BuildView, Views::EdgeTypeAwareBiDir)
+    ->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BuildView, Views::NodesSortedByDegreeEdgesSortedByDestID)
+    ->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(
+    BuildView, Views::NodesSortedByNodeTypeEdgesSortedByEdgeType)
+    ->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BuildView, Views::NodesInReverseCuthillMcKeeOrder)
+    ->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BuildView, Views::NodesHubClustered)->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BuildView, Views::NodesClusteredByCommunity)
+    ->Apply(GraphArguments);
+
+//
+// Phases. EdgeShuffleTopology does not expose its edge sorts on their own, so
+// CopyAndSortEdges includes the copy that CopyOriginal measures alone.
+//
+
+using Kind = katana::RDGTopology;
+
+void
+CopyOriginal(benchmark::State& state) {
+  auto pg = MakeGraph(state);
+  for (auto _ : state) {
+    auto topo = katana::EdgeShuffleTopology::MakeOriginalCopy(pg.get());
+    benchmark::DoNotOptimize(topo->NumEdges());
+  }
+  SetEdgesProcessed(state);
+}
+
+void
+Transpose(benchmark::State& state) {
+  auto pg = MakeGraph(state);
+  for (auto _ : state) {
+    auto topo = katana::EdgeShuffleTopology::MakeTransposeCopy(pg.get());
+    benchmark::DoNotOptimize(topo->NumEdges());
+  }
+  SetEdgesProcessed(state);
+}
+
+template <Kind::EdgeSortKind kSort>
+void
+CopyAndSortEdges(benchmark::State& state) {
+  auto pg = MakeGraph(state);
+  for (auto _ : state) {
+    auto topo = katana::EdgeShuffleTopology::Make(
+        pg.get(), Kind::TransposeKind::kNo, kSort);
+    benchmark::DoNotOptimize(topo->NumEdges());
+  }
+  SetEdgesProcessed(state);
+}
+
+/// Sort the nodes of an edge shuffle topology with make
+template <typename MakeFunc>
+void
+SortNodes(benchmark::State& state, MakeFunc make) {
+  auto pg = MakeGraph(state);
+  auto seed = katana::EdgeShuffleTopology::MakeOriginalCopy(pg.get());
+  for (auto _ : state) {
+    auto topo = make(pg.get(), *seed);
+    benchmark::DoNotOptimize(topo->NumEdges());
+  }
+  SetEdgesProcessed(state);
+}
+
+void
+EdgeTypeIndex(benchmark::State& state) {
+  auto pg = MakeGraph(state);
+  for (auto _ : state) {
+    auto index = katana::CondensedTypeIDMap::MakeFromEdgeTypes(pg.get());
+    benchmark::DoNotOptimize(index->num_unique_types());
+  }
+  SetEdgesProcessed(state);
+}
+
+/// Build the per-type adjacency indices of an EdgeTypeAwareTopology from
+/// edges already sorted by type
+void
+EdgeTypeAware(benchmark::State& state) {
+  auto pg = MakeGraph(state);
+  auto index = katana::CondensedTypeIDMap::MakeFromEdgeTypes(pg.get());
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto sorted = katana::EdgeShuffleTopology::Make(
+        pg.get(), Kind::TransposeKind::kNo,
+        Kind::EdgeSortKind::kSortedByEdgeType);
+    state.ResumeTiming();
+
+    auto topo = katana::EdgeTypeAwareTopology::MakeFrom(
+        pg.get(), index, std::move(*sorted));
+    benchmark::DoNotOptimize(topo->NumEdges());
+
+    state.PauseTiming();
+    topo.reset();
+    sorted.reset();
+    state.ResumeTiming();
+  }
+  SetEdgesProcessed(state);
+}
+
+void
+EdgeLookupIndex(benchmark::State& state) {
+  auto pg = MakeGraph(state);
+  auto sorted = katana::EdgeShuffleTopology::Make(
+      pg.get(), Kind::TransposeKind::kNo, Kind::EdgeSortKind::kSortedByDestID);
+  for (auto _ : state) {
+    auto index = katana::EdgeLookupIndex::Make(*sorted);
+    benchmark::DoNotOptimize(index.get());
+  }
+  SetEdgesProcessed(state);
+}
+
+/// Convert a topology made once by make to the RDGTopology it is stored as
+template <typename MakeFunc>
+void
+ToRDGTopology(benchmark::State& state, MakeFunc make) {
+  auto pg = MakeGraph(state);
+  auto topo = make(pg.get());
+  for (auto _ : state) {
+    auto rdg_topo = topo->ToRDGTopology();
+    KATANA_LOG_VASSERT(rdg_topo, "{}", rdg_topo.error());
+    benchmark::DoNotOptimize(rdg_topo.value().num_edges());
+  }
+  SetEdgesProcessed(state);
+}
+
+BENCHMARK(CopyOriginal)->Apply(GraphArguments);
+BENCHMARK(Transpose)->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(CopyAndSortEdges, Kind::EdgeSortKind::kSortedByDestID)
+    ->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(CopyAndSortEdges, Kind::EdgeSortKind::kSortedByEdgeType)
+    ->Apply(GraphArguments);
+
+BENCHMARK_CAPTURE(
+    SortNodes, degree, &katana::ShuffleTopology::MakeSortedByDegree)
+    ->Apply(GraphArguments);
+BENCHMARK_CAPTURE(
+    SortNodes, node_type,
+    [](const katana::PropertyGraph* pg, const katana::EdgeShuffleTopology& s) {
+      return katana::ShuffleTopology::MakeSortedByNodeType(pg, s);
+    })
+    ->Apply(GraphArguments);
+BENCHMARK_CAPTURE(
+    SortNodes, reverse_cuthill_mckee,
+    &katana::ShuffleTopology::MakeInReverseCuthillMcKeeOrder)
+    ->Apply(GraphArguments);
+BENCHMARK_CAPTURE(
+    SortNodes, hub_clustered, &katana::ShuffleTopology::MakeHubClustered)
+    ->Apply(GraphArguments);
+BENCHMARK_CAPTURE(
+    SortNodes, clustered_by_community,
+    &katana::ShuffleTopology::MakeClusteredByCommunity)
+    ->Apply(GraphArguments);
+
+BENCHMARK(EdgeTypeIndex)->Apply(GraphArguments);
+BENCHMARK(EdgeTypeAware)->Apply(GraphArguments);
+BENCHMARK(EdgeLookupIndex)->Apply(GraphArguments);
+
+BENCHMARK_CAPTURE(
+    ToRDGTopology, edge_shuffle,
+    [](katana::PropertyGraph* pg) {
+      return katana::EdgeShuffleTopology::MakeTransposeCopy(pg);
+    })
+    ->Apply(GraphArguments);
+BENCHMARK_CAPTURE(
+    ToRDGTopology, shuffle,
+    [](katana::PropertyGraph* pg) {
+      auto seed = katana::EdgeShuffleTopology::MakeOriginalCopy(pg);
+      return katana::ShuffleTopology::MakeSortedByDegree(pg, *seed);
+    })
+    ->Apply(GraphArguments);
+BENCHMARK_CAPTURE(
+    ToRDGTopology, edge_type_aware,
+    [](katana::PropertyGraph* pg) {
+      auto sorted = katana::EdgeShuffleTopology::Make(
+          pg, Kind::TransposeKind::kNo, Kind::EdgeSortKind::kSortedByEdgeType);
+      return katana::EdgeTypeAwareTopology::MakeFrom(
+          pg, katana::CondensedTypeIDMap::MakeFromEdgeTypes(pg),
+          std::move(*sorted));
+    })
+    ->Apply(GraphArguments);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -28,9 +28,21 @@ public:
   static constexpr katana::TxnContext* default_value = nullptr;
 };
 
+/// Convert the arguments of the Python property add and upsert methods, a
+/// table (an arrow table, a dict of columns or anything pyarrow.table takes)
+/// and named columns, to a table. Arrow columns are shared with the result,
+/// as are numpy arrays whose types arrow lays out the same way (fixed width
+/// types other than bool). Copies of anything else are counted by
+/// PropertyBytesCopied; if may_copy is false they are an error instead.
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>>
 PythonArgumentsToTable(
-    const pybind11::object& table, const pybind11::dict& kwargs);
+    const pybind11::object& table, const pybind11::dict& kwargs,
+    bool may_copy = true);
+
+/// \returns the number of bytes of Python arguments that
+/// PythonArgumentsToTable has copied, for checking that large columns are
+/// shared
+KATANA_EXPORT uint64_t PropertyBytesCopied();
 
 }  // namespace katana::python
 
@@ -24,6 +24,9 @@ GetPythonExceptionType(std::error_code code) {
       return builtins.attr("AssertionError");
     case katana::ErrorCode::OutOfMemory:
       return builtins.attr("MemoryError");
+    case katana::ErrorCode::Cancelled:
+      return pybind11::module::import("concurrent.futures")
+          .attr("CancelledError");
     case katana::ErrorCode::AlreadyExists:
     case katana::ErrorCode::ArrowError:
     case katana::ErrorCode::JSONParseFailed:
@@ -40,6 +43,7 @@ GetPythonExceptionType(std::error_code code) {
     case katana::ErrorCode::BadVersion:
     case katana::ErrorCode::MpiError:
     case katana::ErrorCode::GSError:
+    case katana::ErrorCode::GpuError:
       break;
     }
   }
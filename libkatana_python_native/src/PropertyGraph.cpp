@@ -2,8 +2,16 @@
 
 #include <numpy/ndarrayobject.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <numeric>
+#include <optional>
+
 // Must come after numpy/ndarrayobject.h since that is required, but
 // not included by arrow/python headers.
+#include <arrow/python/common.h>
 #include <arrow/python/numpy_convert.h>
 #include <arrow/python/numpy_to_arrow.h>
 #include <arrow/python/python_to_arrow.h>
@@ -11,6 +19,11 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/SharedGraph.h"
+#include "katana/ThreadGroup.h"
 #include "katana/python/Conventions.h"
 #include "katana/python/CythonIntegration.h"
 #include "katana/python/EntityTypeManagerPython.h"
@@ -24,46 +37,150 @@
 
 namespace py = pybind11;
 
+namespace {
+
+std::atomic<uint64_t> property_bytes_copied{0};
+
+/// \returns true if buffer, or the buffer it slices, is memory of a Python
+/// object (e.g., a numpy array) rather than a copy of it
+bool
+IsSharedWithPython(std::shared_ptr<arrow::Buffer> buffer) {
+  for (; buffer; buffer = buffer->parent()) {
+    if (dynamic_cast<arrow::py::NumPyBuffer*>(buffer.get()) ||
+        dynamic_cast<arrow::py::PyBuffer*>(buffer.get())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t
+CopiedBytes(const arrow::ArrayData& data) {
+  uint64_t bytes = 0;
+  for (const auto& buffer : data.buffers) {
+    if (buffer && !IsSharedWithPython(buffer)) {
+      bytes += buffer->size();
+    }
+  }
+  for (const auto& child : data.child_data) {
+    bytes += CopiedBytes(*child);
+  }
+  if (data.dictionary) {
+    bytes += CopiedBytes(*data.dictionary);
+  }
+  return bytes;
+}
+
+uint64_t
+CopiedBytes(const arrow::ChunkedArray& array) {
+  uint64_t bytes = 0;
+  for (const auto& chunk : array.chunks()) {
+    bytes += CopiedBytes(*chunk->data());
+  }
+  return bytes;
+}
+
+/// Account for a conversion of a Python argument that copied bytes of it
+katana::Result<void>
+CountCopy(uint64_t bytes, bool may_copy, const std::string& what) {
+  if (bytes == 0) {
+    return katana::ResultSuccess();
+  }
+  if (!may_copy) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "converting {} would copy {} bytes; pass arrow data or numpy arrays "
+        "of fixed width types, or allow copies",
+        what, bytes);
+  }
+  property_bytes_copied += bytes;
+  KATANA_LOG_DEBUG("converting {} copied {} bytes", what, bytes);
+  return katana::ResultSuccess();
+}
+
+/// Convert a column argument; converting arrow data never copies
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+ColumnToArrow(const py::handle& v, const std::string& name, bool may_copy) {
+  if (arrow::py::is_chunked_array(v.ptr())) {
+    return KATANA_CHECKED(arrow::py::unwrap_chunked_array(v.ptr()));
+  }
+  if (arrow::py::is_array(v.ptr())) {
+    return std::make_shared<arrow::ChunkedArray>(
+        KATANA_CHECKED(arrow::py::unwrap_array(v.ptr())));
+  }
+
+  std::shared_ptr<arrow::ChunkedArray> array;
+  if (py::isinstance<py::array>(v)) {
+    // Convert a numpy array; this shares its memory when arrow and numpy lay
+    // out the type the same way
+    py::array pyarray = py::cast<py::array>(v);
+    std::shared_ptr<arrow::DataType> dtype;
+    KATANA_CHECKED(arrow::py::NumPyDtypeToArrow(pyarray.dtype().ptr(), &dtype));
+    KATANA_CHECKED(arrow::py::NdarrayToArrow(
+        arrow::default_memory_pool(), v.ptr(), nullptr, true, dtype,
+        arrow::compute::CastOptions::Safe(dtype), &array));
+    KATANA_LOG_DEBUG_ASSERT(array);
+  } else {
+    // Convert any other python sequence.
+    arrow::py::PyConversionOptions options;
+    options.from_pandas = true;
+    array =
+        KATANA_CHECKED(arrow::py::ConvertPySequence(v.ptr(), nullptr, options));
+  }
+  KATANA_CHECKED(CountCopy(CopiedBytes(*array), may_copy, name));
+  return array;
+}
+
+}  // namespace
+
+uint64_t
+katana::python::PropertyBytesCopied() {
+  return property_bytes_copied.load();
+}
+
 /// Utility to convert Python argument to an Arrow Table for insertion into a
 /// graph as properties.
 katana::Result<std::shared_ptr<arrow::Table>>
 katana::python::PythonArgumentsToTable(
-    const pybind11::object& table, const pybind11::dict& kwargs) {
+    const pybind11::object& table, const pybind11::dict& kwargs,
+    bool may_copy) {
   std::shared_ptr<arrow::Table> arrow_table;
+  auto add_column = [&](const std::string& name,
+                        std::shared_ptr<arrow::ChunkedArray> array)
+      -> katana::Result<void> {
+    auto field = arrow::field(name, array->type());
+    if (arrow_table) {
+      arrow_table = KATANA_CHECKED(arrow_table->AddColumn(
+          arrow_table->num_columns(), field, std::move(array)));
+    } else {
+      arrow_table = arrow::Table::Make(arrow::schema({field}), {array});
+    }
+    return katana::ResultSuccess();
+  };
 
   if (arrow::py::is_table(table.ptr())) {
     arrow_table = KATANA_CHECKED(arrow::py::unwrap_table(table.ptr()));
+  } else if (py::isinstance<py::dict>(table)) {
+    // convert the columns one at a time so that arrow columns are shared
+    for (const auto& [k, v] : py::cast<py::dict>(table)) {
+      auto name = py::cast<std::string>(k);
+      auto array = KATANA_CHECKED(ColumnToArrow(v, name, may_copy));
+      KATANA_CHECKED(add_column(name, std::move(array)));
+    }
   } else if (!table.is_none()) {
     arrow_table = KATANA_CHECKED(arrow::py::unwrap_table(
         py::module::import("pyarrow").attr("table")(table).ptr()));
+    uint64_t copied = 0;
+    for (const auto& column : arrow_table->columns()) {
+      copied += CopiedBytes(*column);
+    }
+    KATANA_CHECKED(CountCopy(copied, may_copy, "table"));
   }
 
   for (const auto& [k, v] : kwargs) {
-    std::shared_ptr<arrow::ChunkedArray> array;
-    if (py::isinstance<py::array>(v)) {
-      // Convert a numpy array.
-      py::array pyarray = py::cast<py::array>(v);
-      std::shared_ptr<arrow::DataType> dtype;
-      KATANA_CHECKED(
-          arrow::py::NumPyDtypeToArrow(pyarray.dtype().ptr(), &dtype));
-      KATANA_CHECKED(arrow::py::NdarrayToArrow(
-          arrow::default_memory_pool(), v.ptr(), nullptr, true, dtype,
-          arrow::compute::CastOptions::Safe(dtype), &array));
-      KATANA_LOG_DEBUG_ASSERT(array);
-    } else {
-      // Convert any other python sequence.
-      arrow::py::PyConversionOptions options;
-      options.from_pandas = true;
-      array = KATANA_CHECKED(
-          arrow::py::ConvertPySequence(v.ptr(), nullptr, options));
-    }
-    auto field = arrow::field(py::cast<py::str>(k), array->type());
-    if (arrow_table) {
-      arrow_table = KATANA_CHECKED(
-          arrow_table->AddColumn(arrow_table->num_columns(), field, array));
-    } else {
-      arrow_table = arrow::Table::Make(arrow::schema({field}), {array});
-    }
+    auto name = py::cast<std::string>(k);
+    auto array = KATANA_CHECKED(ColumnToArrow(v, name, may_copy));
+    KATANA_CHECKED(add_column(name, std::move(array)));
   }
 
   if (!arrow_table) {
@@ -95,7 +212,7 @@ public:
     auto begin = py::cast<ssize_t>(slice.attr("start"));
     auto end = py::cast<ssize_t>(slice.attr("stop"));
     auto step = py::cast<ssize_t>(slice.attr("step"));
-    py::array_t<T> out{(end - begin) / step};
+    py::array_t<T> out{std::max<ssize_t>(end - begin + step - 1, 0) / step};
     for (ssize_t j = 0, i = begin; i < end; j += 1, i += step) {
       out.mutable_at(j) = at_typed(i);
     }
@@ -156,6 +273,235 @@ PropertyGraphTopologyOutEdgesForNode(
   return pg->topology().OutEdges(n);
 }
 
+/// A load of a graph or of its properties running on a background thread.
+/// Dropping the load cancels it.
+///
+/// The loops of the load run on a thread group of their own, so that they
+/// do not share the pool with the loops of the thread that started it. If
+/// no threads are free for a group, the load runs before the constructor
+/// returns.
+class GraphLoad {
+public:
+  using GraphResult =
+      katana::CopyableResult<std::shared_ptr<katana::PropertyGraph>>;
+
+  template <typename F>
+  GraphLoad(std::shared_ptr<katana::RDGLoadProgress> progress, F&& fn)
+      : progress_(std::move(progress)) {
+    if (!katana::ThreadGroup::Current()) {
+      group_ = katana::ThreadGroup::Make(
+          std::max(1U, katana::getActiveThreads() / kGroupFraction));
+    }
+    if (!group_) {
+      py::gil_scoped_release guard;
+      std::promise<GraphResult> promise;
+      promise.set_value(fn());
+      result_ = promise.get_future().share();
+      return;
+    }
+    result_ = std::async(
+        std::launch::async,
+        [group = group_.get(), fn = std::forward<F>(fn)]() mutable {
+          katana::ThreadGroup::Scope scope(group);
+          return fn();
+        });
+  }
+
+  ~GraphLoad() {
+    progress_->Cancel();
+    result_.wait();
+  }
+
+  GraphLoad(const GraphLoad&) = delete;
+  GraphLoad& operator=(const GraphLoad&) = delete;
+
+  /// \returns true once the load is done; waits at most timeout seconds,
+  /// or until done if timeout is nullopt
+  bool Wait(std::optional<double> timeout) const {
+    py::gil_scoped_release guard;
+    if (!timeout) {
+      result_.wait();
+      return true;
+    }
+    return result_.wait_for(std::chrono::duration<double>(*timeout)) ==
+           std::future_status::ready;
+  }
+
+  /// \returns the result of the load, waiting for it if needed
+  katana::Result<std::shared_ptr<katana::PropertyGraph>> Get() const {
+    Wait(std::nullopt);
+    const GraphResult& res = result_.get();
+    if (!res) {
+      return katana::ErrorInfo(res.error());
+    }
+    return res.value();
+  }
+
+  katana::RDGLoadProgress& progress() const { return *progress_; }
+
+private:
+  /// A load runs on this fraction of the active threads
+  static constexpr unsigned kGroupFraction = 4;
+
+  std::shared_ptr<katana::RDGLoadProgress> progress_;
+  std::unique_ptr<katana::ThreadGroup> group_;
+  std::shared_future<GraphResult> result_;
+};
+
+/// A read-only NumPy array of the size elements at data, which shares the
+/// memory of topology and keeps it alive, even past
+/// PropertyGraph::DropAllTopologies
+template <typename T>
+py::array
+TopologyArray(
+    const T* data, size_t size,
+    const std::shared_ptr<const katana::GraphTopology>& topology) {
+  using Owner = std::shared_ptr<const katana::GraphTopology>;
+  py::capsule base(new Owner(topology), [](void* owner) {
+    delete static_cast<Owner*>(owner);
+  });
+  py::array_t<T> array(size, data, base);
+  array.attr("flags").attr("writeable") = false;
+  return std::move(array);
+}
+
+/// The property indexes at data as TopologyArray makes them, or a new array
+/// of 0, ..., size - 1 if the topology has none
+py::array
+PropertyIndexArray(
+    const katana::GraphTopology::PropertyIndex* data, size_t size,
+    const std::shared_ptr<const katana::GraphTopology>& topology) {
+  if (data != nullptr) {
+    return TopologyArray(data, size, topology);
+  }
+  py::array_t<katana::GraphTopology::PropertyIndex> identity(size);
+  std::iota(identity.mutable_data(), identity.mutable_data() + size, 0);
+  return std::move(identity);
+}
+
+/// The arrays of topology, named as in GraphTopology
+py::dict
+TopologyArrays(const std::shared_ptr<const katana::GraphTopology>& topology) {
+  py::dict arrays;
+  arrays["adj_indices"] =
+      TopologyArray(topology->AdjData(), topology->NumNodes(), topology);
+  arrays["dests"] =
+      TopologyArray(topology->DestData(), topology->NumEdges(), topology);
+  arrays["edge_property_indices"] = PropertyIndexArray(
+      topology->EdgePropertyIndexData(), topology->NumEdges(), topology);
+  arrays["node_property_indices"] = PropertyIndexArray(
+      topology->NodePropertyIndexData(), topology->NumNodes(), topology);
+  return arrays;
+}
+
+// Batch variants of the edge lookups, which take NumPy arrays and run a
+// parallel loop without the GIL
+
+constexpr int kCArray = py::array::c_style | py::array::forcecast;
+using NodeArray = py::array_t<katana::GraphTopologyTypes::Node, kCArray>;
+using EdgeArray = py::array_t<katana::GraphTopologyTypes::Edge, kCArray>;
+
+/// Check that ids, named what, is one-dimensional and holds ids below bound
+template <typename T>
+katana::Result<void>
+CheckIDs(
+    const py::array_t<T, kCArray>& ids, uint64_t bound, const char* what) {
+  if (ids.ndim() != 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} must be one-dimensional",
+        what);
+  }
+  const T* data = ids.data();
+  katana::GReduceLogicalOr out_of_range;
+  {
+    py::gil_scoped_release guard;
+    katana::do_all(
+        katana::iterate(ssize_t{0}, ids.size()),
+        [&](ssize_t i) {
+          if (data[i] >= bound) {
+            out_of_range.update(true);
+          }
+        },
+        katana::no_stats());
+  }
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} must be below {}", what,
+        bound);
+  }
+  return katana::ResultSuccess();
+}
+
+/// Check that srcs and dsts are pairs of nodes of pg
+katana::Result<void>
+CheckNodePairs(
+    const katana::PropertyGraph& pg, const NodeArray& srcs,
+    const NodeArray& dsts) {
+  KATANA_CHECKED(CheckIDs(srcs, pg.NumNodes(), "sources"));
+  KATANA_CHECKED(CheckIDs(dsts, pg.NumNodes(), "destinations"));
+  if (srcs.size() != dsts.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "got {} sources but {} destinations", srcs.size(), dsts.size());
+  }
+  return katana::ResultSuccess();
+}
+
+/// A bool array of has_edge(i) for the num_pairs pairs, where has_edge is
+/// made by make_has_edge() without the GIL, since it may build a view
+template <typename MakeHasEdge>
+py::array
+HasEdgeBatch(size_t num_pairs, const MakeHasEdge& make_has_edge) {
+  py::array_t<bool> found(num_pairs);
+  bool* data = found.mutable_data();
+  {
+    py::gil_scoped_release guard;
+    auto has_edge = make_has_edge();
+    katana::do_all(
+        katana::iterate(size_t{0}, num_pairs),
+        [&](size_t i) { data[i] = has_edge(i); }, katana::steal(),
+        katana::no_stats());
+  }
+  return std::move(found);
+}
+
+/// The edges of find_all_edges(i) for the num_pairs pairs, as a pair of
+/// arrays: the edges of pair i are edge_ids[indptr[i]:indptr[i + 1]].
+/// find_all_edges is made by make_find_all_edges() as in HasEdgeBatch.
+template <typename MakeFindAllEdges>
+py::tuple
+FindAllEdgesBatch(
+    size_t num_pairs, const MakeFindAllEdges& make_find_all_edges) {
+  using Edge = katana::GraphTopologyTypes::Edge;
+  py::array_t<uint64_t> indptr(num_pairs + 1);
+  uint64_t* offsets = indptr.mutable_data();
+  std::optional<decltype(make_find_all_edges())> find_all_edges;
+  {
+    py::gil_scoped_release guard;
+    find_all_edges.emplace(make_find_all_edges());
+    offsets[0] = 0;
+    katana::do_all(
+        katana::iterate(size_t{0}, num_pairs),
+        [&](size_t i) { offsets[i + 1] = (*find_all_edges)(i).size(); },
+        katana::steal(), katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        offsets + 1, offsets + num_pairs + 1, offsets + 1);
+  }
+  py::array_t<Edge> edge_ids(offsets[num_pairs]);
+  Edge* edges = edge_ids.mutable_data();
+  {
+    py::gil_scoped_release guard;
+    katana::do_all(
+        katana::iterate(size_t{0}, num_pairs),
+        [&](size_t i) {
+          auto range = (*find_all_edges)(i);
+          std::copy(range.begin(), range.end(), edges + offsets[i]);
+        },
+        katana::steal(), katana::no_stats());
+  }
+  return py::make_tuple(indptr, edge_ids);
+}
+
 class PropertyGraphNumbaReplacement {
   using Edge = katana::GraphTopologyTypes::Edge;
   using Node = katana::GraphTopologyTypes::Node;
@@ -387,6 +733,124 @@ DefPropertyGraph(py::module& m) {
           memory. If this is None (default), then all properties are loaded.
       )""");
 
+  cls.def_static(
+      "load_async",
+      [](py::object path,
+         std::optional<std::vector<std::string>> node_properties,
+         std::optional<std::vector<std::string>> edge_properties) {
+        auto path_str = py::str(path).cast<std::string>();
+        auto path_uri = PythonChecked(URI::Make(path_str));
+        katana::RDGLoadOptions options = katana::RDGLoadOptions::Defaults();
+        options.node_properties = std::move(node_properties);
+        options.edge_properties = std::move(edge_properties);
+        options.progress = std::make_shared<katana::RDGLoadProgress>();
+        auto progress = options.progress;
+        return std::make_unique<GraphLoad>(
+            std::move(progress),
+            [path_uri, options]() -> GraphLoad::GraphResult {
+              TxnContext txn_ctx;
+              std::shared_ptr<PropertyGraph> pg = KATANA_CHECKED(
+                  PropertyGraph::Make(path_uri, &txn_ctx, options));
+              return pg;
+            });
+      },
+      py::arg("path"), py::kw_only(), py::arg("node_properties") = std::nullopt,
+      py::arg("edge_properties") = std::nullopt,
+      R"""(
+      Start loading a property graph on a background thread, e.g., to warm a
+      graph while serving requests. The arguments are those of
+      :py:class:`Graph`.
+
+      The load runs on a :py:class:`~katana.ThreadGroup` of a quarter of the
+      active threads, so loops may run on the rest of the pool meanwhile.
+      Like a thread group, it must be started while no loop runs. If too few
+      threads are free, or the calling thread is in a thread group, the load
+      finishes before this returns.
+
+      :returns: A :py:class:`GraphLoad` whose ``result()`` is the graph.
+      )""");
+
+  cls.def(
+      "load_properties_async",
+      [](std::shared_ptr<PropertyGraph> self,
+         std::optional<std::vector<std::string>> node_properties,
+         std::optional<std::vector<std::string>> edge_properties) {
+        std::vector<std::string> node_names =
+            node_properties.value_or(self->ListFullNodeProperties());
+        std::vector<std::string> edge_names =
+            edge_properties.value_or(self->ListFullEdgeProperties());
+        auto progress = std::make_shared<katana::RDGLoadProgress>();
+        return std::make_unique<GraphLoad>(
+            progress,
+            [self, node_names = std::move(node_names),
+             edge_names = std::move(edge_names),
+             progress]() mutable -> GraphLoad::GraphResult {
+              self->PrefetchProperties(
+                  std::move(node_names), std::move(edge_names), progress);
+              self->WaitForPropertyPrefetch();
+              KATANA_CHECKED(progress->CheckCancelled());
+              return self;
+            });
+      },
+      py::kw_only(), py::arg("node_properties") = std::nullopt,
+      py::arg("edge_properties") = std::nullopt,
+      R"""(
+      Start loading properties of this graph on a background thread. The
+      properties of the graph can be used by name while they load, each
+      waiting for its own load if needed. Properties that fail to load are
+      logged and left unloaded. The load runs on a thread group as in
+      :py:meth:`load_async`.
+
+      :param node_properties: The node properties to load, or None (default)
+          for all of them.
+      :param edge_properties: The edge properties to load, or None (default)
+          for all of them.
+      :returns: A :py:class:`GraphLoad` whose ``result()`` is this graph.
+      )""");
+
+  cls.def(
+      "export_shared",
+      [](PropertyGraph& self, py::object path) {
+        auto path_str = py::str(path).cast<std::string>();
+        py::gil_scoped_release guard;
+        return katana::ExportSharedGraph(self, path_str);
+      },
+      py::arg("path"),
+      R"""(
+      Export the topology and the loaded properties of this graph to the
+      directory ``path``, for worker processes on this host to attach with
+      :py:meth:`Graph.attach_shared` instead of each loading its own copy.
+      Use a directory on a memory file system, e.g., under ``/dev/shm``, to
+      host the graph in shared memory.
+
+      The directory appears complete or not at all and must not exist yet;
+      remove it when no process will attach the graph again. Entity types
+      are not exported.
+
+      :param path: The directory to export to.
+      :type path: Union[str, Path]
+      )""");
+
+  cls.def_static(
+      "attach_shared",
+      [](py::object path) -> Result<std::shared_ptr<PropertyGraph>> {
+        auto path_str = py::str(path).cast<std::string>();
+        py::gil_scoped_release guard;
+        return katana::AttachSharedGraph(path_str);
+      },
+      py::arg("path"),
+      R"""(
+      Attach to a graph exported with :py:meth:`Graph.export_shared`. The
+      topology and properties of the graph are read-only mappings shared by
+      every process that attaches it, so attaching is fast and does not copy
+      the graph. Properties added to the attached graph are private to this
+      process.
+
+      :param path: The directory the graph was exported to.
+      :type path: Union[str, Path]
+      :returns: The attached graph.
+      )""");
+
   // Below are the view API methods that we have in mind (not all of them may end up being exposed to Python). We differentiate between 3 classes of identifiers for nodes and edges:
   // Local ID: This is an ID produced by a specific partitioning of a distributed graph.
   // Topology handle: It is a handle used to relate to an entity in a topology data structure. It is a handle that various topology-related methods return.
@@ -844,6 +1308,126 @@ DefPropertyGraph(py::module& m) {
       },
       py::call_guard<py::gil_scoped_release>());
 
+  cls.def(
+      "has_edge_batch",
+      [](PropertyGraph& self, const NodeArray& srcs,
+         const NodeArray& dsts) -> Result<py::array> {
+        KATANA_CHECKED(CheckNodePairs(self, srcs, dsts));
+        const auto* s = srcs.data();
+        const auto* d = dsts.data();
+        return HasEdgeBatch(srcs.size(), [&]() {
+          auto view =
+              self.BuildView<PropertyGraphViews::EdgesSortedByDestID>();
+          return [s, d, view](size_t i) { return view.HasEdge(s[i], d[i]); };
+        });
+      },
+      py::arg("srcs"), py::arg("dsts"),
+      R"""(
+      Batch version of :py:func:`~Graph.has_edge`: for each pair of
+      ``srcs[i]`` and ``dsts[i]``, whether an edge goes from one to the other.
+      Lookups run in parallel without the GIL.
+
+      Returns:
+          numpy.ndarray: One bool per pair.
+
+      Args:
+          srcs (numpy.ndarray): Source node ids.
+          dsts (numpy.ndarray): Destination node ids, as many as ``srcs``.
+          edge_type (Optional[EntityType]): If provided, only edges of this type
+            count.
+      )""");
+  cls.def(
+      "has_edge_batch",
+      [](PropertyGraph& self, const NodeArray& srcs, const NodeArray& dsts,
+         const EntityType& ty) -> Result<py::array> {
+        KATANA_CHECKED(CheckNodePairs(self, srcs, dsts));
+        const auto* s = srcs.data();
+        const auto* d = dsts.data();
+        auto type = ty.type_id;
+        return HasEdgeBatch(srcs.size(), [&]() {
+          auto view = self.BuildView<PropertyGraphViews::EdgeTypeAwareBiDir>();
+          return [s, d, type, view](size_t i) {
+            return view.HasEdge(s[i], d[i], type);
+          };
+        });
+      },
+      py::arg("srcs"), py::arg("dsts"), py::arg("edge_type"));
+
+  cls.def(
+      "find_all_edge_ids_batch",
+      [](PropertyGraph& self, const NodeArray& srcs,
+         const NodeArray& dsts) -> Result<py::tuple> {
+        KATANA_CHECKED(CheckNodePairs(self, srcs, dsts));
+        const auto* s = srcs.data();
+        const auto* d = dsts.data();
+        return FindAllEdgesBatch(srcs.size(), [&]() {
+          auto view =
+              self.BuildView<PropertyGraphViews::EdgesSortedByDestID>();
+          return [s, d, view](size_t i) {
+            return view.FindAllEdges(s[i], d[i]);
+          };
+        });
+      },
+      py::arg("srcs"), py::arg("dsts"),
+      R"""(
+      Batch version of :py:func:`~Graph.find_all_edge_ids`: the ids of the edges
+      from ``srcs[i]`` to ``dsts[i]`` for each pair. Lookups run in parallel
+      without the GIL.
+
+      Returns:
+          Tuple[numpy.ndarray, numpy.ndarray]: ``indptr`` and ``edge_ids``,
+          where the edges of pair ``i`` are
+          ``edge_ids[indptr[i]:indptr[i + 1]]``.
+
+      Args:
+          srcs (numpy.ndarray): Source node ids.
+          dsts (numpy.ndarray): Destination node ids, as many as ``srcs``.
+          edge_type (Optional[EntityType]): If provided, only edges of this type
+            are returned.
+      )""");
+  cls.def(
+      "find_all_edge_ids_batch",
+      [](PropertyGraph& self, const NodeArray& srcs, const NodeArray& dsts,
+         const EntityType& ty) -> Result<py::tuple> {
+        KATANA_CHECKED(CheckNodePairs(self, srcs, dsts));
+        const auto* s = srcs.data();
+        const auto* d = dsts.data();
+        auto type = ty.type_id;
+        return FindAllEdgesBatch(srcs.size(), [&]() {
+          auto view = self.BuildView<PropertyGraphViews::EdgeTypeAwareBiDir>();
+          return [s, d, type, view](size_t i) {
+            return view.FindAllEdges(s[i], d[i], type);
+          };
+        });
+      },
+      py::arg("srcs"), py::arg("dsts"), py::arg("edge_type"));
+
+  cls.def(
+      "get_edge_src_batch",
+      [](PropertyGraph& self, const EdgeArray& edges) -> Result<py::array> {
+        KATANA_CHECKED(CheckIDs(edges, self.NumEdges(), "edges"));
+        const auto* e = edges.data();
+        py::array_t<GraphTopologyTypes::Node> srcs(edges.size());
+        auto* data = srcs.mutable_data();
+        {
+          py::gil_scoped_release guard;
+          auto view = self.BuildView<PropertyGraphViews::BiDirectional>();
+          katana::do_all(
+              katana::iterate(ssize_t{0}, edges.size()),
+              [&](ssize_t i) { data[i] = view.GetEdgeSrc(e[i]); },
+              katana::no_stats());
+        }
+        return std::move(srcs);
+      },
+      py::arg("edges"),
+      R"""(
+      Batch version of :py:func:`~Graph.get_edge_src`: the source of each of
+      ``edges``, looked up in parallel without the GIL.
+
+      Returns:
+          numpy.ndarray: One node id per edge.
+      )""");
+
   // These methods are needed in addition to the above (for querying/mining that stores matched edges):
 
   // GetEdgeSrc(LocalEdgeID)-> NodeHandle - source of an edge
@@ -864,6 +1448,48 @@ DefPropertyGraph(py::module& m) {
   katana::DefWithNumba<&PropertyGraphNumbaReplacement::OutEdgeDst>(
       cls_numba_replacement, "get_edge_dst");
 
+  cls.def(
+      "topology_arrays",
+      [](PropertyGraph& self, bool transposed) {
+        std::shared_ptr<const GraphTopology> topology;
+        {
+          py::gil_scoped_release release;
+          if (transposed) {
+            topology = self.BuildView<PropertyGraphViews::Transposed>()
+                           .topo_ptr();
+          } else {
+            topology =
+                self.BuildView<PropertyGraphViews::Default>().topo_ptr();
+          }
+        }
+        return TopologyArrays(topology);
+      },
+      py::arg("transposed") = false,
+      R"""(
+      Get the CSR arrays of the topology as read-only NumPy arrays, which share
+      memory with the graph rather than copying it, for vectorized code.
+
+      Returns:
+          Dict[str, numpy.ndarray]: ``adj_indices``, where the out-edges of node
+          ``n`` are ``adj_indices[n - 1]`` (or 0) up to ``adj_indices[n]``;
+          ``dests``, the destination of each edge; ``edge_property_indices``,
+          the row of each edge in the edge property tables; and
+          ``node_property_indices``, the row of each node in the node property
+          tables. Prepending a 0 to ``adj_indices`` gives the ``indptr`` of a
+          ``scipy.sparse.csr_matrix``. The property indexes are computed, not
+          shared, when the topology has none of its own.
+
+      Args:
+          transposed (bool): If true, return the arrays of the transposed
+            topology, whose edges are the in-edges: ``adj_indices`` are indexed
+            by destination and ``dests`` holds the sources. It is built if it is
+            not cached.
+
+      The arrays keep the topology they view alive, even after
+      :py:func:`~Graph.unload_topologies`; they do not see later changes to the
+      graph.
+      )""");
+
   // In addition, all access views will support property and type queries:
 
   // GetNodeProperty(string) -> PropertyArray - property array for all nodes
@@ -887,6 +1513,46 @@ DefPropertyGraph(py::module& m) {
       },
       py::call_guard<py::gil_scoped_release>());
 
+  cls.def(
+      "read_node_property_rows",
+      [](const PropertyGraph& self, const std::string& name, uint64_t start,
+         uint64_t stop) -> katana::Result<py::object> {
+        std::shared_ptr<arrow::ChunkedArray> rows;
+        {
+          py::gil_scoped_release guard;
+          rows = KATANA_CHECKED(self.ReadNodePropertyRows(name, start, stop));
+        }
+        return py::reinterpret_steal<py::object>(
+            arrow::py::wrap_chunked_array(rows));
+      },
+      py::arg("name"), py::arg("start"), py::arg("stop"),
+      R"""(
+      Read the rows [start, stop) of a node property without loading it.
+
+      A loaded property is sliced without a copy. An unloaded property is read
+      from storage, fetching only the row groups that hold the rows, and stays
+      unloaded, so properties too large to load can be read a slice at a time.
+
+      :returns: The rows as a ``pyarrow.ChunkedArray``.
+      )""");
+  cls.def(
+      "read_edge_property_rows",
+      [](const PropertyGraph& self, const std::string& name, uint64_t start,
+         uint64_t stop) -> katana::Result<py::object> {
+        std::shared_ptr<arrow::ChunkedArray> rows;
+        {
+          py::gil_scoped_release guard;
+          rows = KATANA_CHECKED(self.ReadEdgePropertyRows(name, start, stop));
+        }
+        return py::reinterpret_steal<py::object>(
+            arrow::py::wrap_chunked_array(rows));
+      },
+      py::arg("name"), py::arg("start"), py::arg("stop"),
+      R"""(
+      Read the rows [start, stop) of an edge property without loading it; see
+      :py:meth:`read_node_property_rows`.
+      )""");
+
   cls.def(
       "unload_node_property", &PropertyGraph::UnloadNodeProperty,
       py::call_guard<py::gil_scoped_release>());
@@ -902,6 +1568,14 @@ DefPropertyGraph(py::module& m) {
     return py::reinterpret_steal<py::object>(
         arrow::py::wrap_schema(self.loaded_edge_schema()));
   });
+  cls.def("full_node_schema", [](PropertyGraph& self) {
+    return py::reinterpret_steal<py::object>(
+        arrow::py::wrap_schema(self.full_node_schema()));
+  });
+  cls.def("full_edge_schema", [](PropertyGraph& self) {
+    return py::reinterpret_steal<py::object>(
+        arrow::py::wrap_schema(self.full_edge_schema()));
+  });
 
   // GetNodeEntityType(NodePropertyIndex)-> EntityTypeID - entity type for a node
   cls.def(
@@ -938,27 +1612,29 @@ DefPropertyGraph(py::module& m) {
   cls.def(
       "add_node_property",
       [](PropertyGraph& self, const py::object& table, TxnContext* txn_ctx,
-         const py::kwargs& kwargs) -> Result<void> {
+         bool may_copy, const py::kwargs& kwargs) -> Result<void> {
         std::shared_ptr<arrow::Table> arrow_table =
-            KATANA_CHECKED(PythonArgumentsToTable(table, kwargs));
+            KATANA_CHECKED(PythonArgumentsToTable(table, kwargs, may_copy));
         py::gil_scoped_release guard;
         TxnContextArgumentHandler txn_handler(txn_ctx);
         return self.AddNodeProperties(arrow_table, txn_handler.get());
       },
       py::arg("table") = py::none(),
-      py::arg("txn_ctx") = TxnContextArgumentHandler::default_value);
+      py::arg("txn_ctx") = TxnContextArgumentHandler::default_value,
+      py::arg("may_copy") = true);
   cls.def(
       "upsert_node_property",
       [](PropertyGraph& self, const py::object& table, TxnContext* txn_ctx,
-         const py::kwargs& kwargs) -> Result<void> {
+         bool may_copy, const py::kwargs& kwargs) -> Result<void> {
         std::shared_ptr<arrow::Table> arrow_table =
-            KATANA_CHECKED(PythonArgumentsToTable(table, kwargs));
+            KATANA_CHECKED(PythonArgumentsToTable(table, kwargs, may_copy));
         py::gil_scoped_release guard;
         TxnContextArgumentHandler txn_handler(txn_ctx);
         return self.UpsertNodeProperties(arrow_table, txn_handler.get());
       },
       py::arg("table") = py::none(),
-      py::arg("txn_ctx") = TxnContextArgumentHandler::default_value);
+      py::arg("txn_ctx") = TxnContextArgumentHandler::default_value,
+      py::arg("may_copy") = true);
   cls.def(
       "remove_node_property",
       [](PropertyGraph& self, const std::string& name, TxnContext* txn_ctx) {
@@ -972,27 +1648,29 @@ DefPropertyGraph(py::module& m) {
   cls.def(
       "add_edge_property",
       [](PropertyGraph& self, const py::object& table, TxnContext* txn_ctx,
-         const py::kwargs& kwargs) -> Result<void> {
+         bool may_copy, const py::kwargs& kwargs) -> Result<void> {
         std::shared_ptr<arrow::Table> arrow_table =
-            KATANA_CHECKED(PythonArgumentsToTable(table, kwargs));
+            KATANA_CHECKED(PythonArgumentsToTable(table, kwargs, may_copy));
         py::gil_scoped_release guard;
         TxnContextArgumentHandler txn_handler(txn_ctx);
         return self.AddEdgeProperties(arrow_table, txn_handler.get());
       },
       py::arg("table") = py::none(),
-      py::arg("txn_ctx") = TxnContextArgumentHandler::default_value);
+      py::arg("txn_ctx") = TxnContextArgumentHandler::default_value,
+      py::arg("may_copy") = true);
   cls.def(
       "upsert_edge_property",
       [](PropertyGraph& self, const py::object& table, TxnContext* txn_ctx,
-         const py::kwargs& kwargs) -> Result<void> {
+         bool may_copy, const py::kwargs& kwargs) -> Result<void> {
         std::shared_ptr<arrow::Table> arrow_table =
-            KATANA_CHECKED(PythonArgumentsToTable(table, kwargs));
+            KATANA_CHECKED(PythonArgumentsToTable(table, kwargs, may_copy));
         py::gil_scoped_release guard;
         TxnContextArgumentHandler txn_handler(txn_ctx);
         return self.UpsertEdgeProperties(arrow_table, txn_handler.get());
       },
       py::arg("table") = py::none(),
-      py::arg("txn_ctx") = TxnContextArgumentHandler::default_value);
+      py::arg("txn_ctx") = TxnContextArgumentHandler::default_value,
+      py::arg("may_copy") = true);
 
   cls.def(
       "remove_edge_property",
@@ -1007,28 +1685,109 @@ DefPropertyGraph(py::module& m) {
   cls.def("has_node_index", &PropertyGraph::HasNodeIndex, py::arg("name"));
   cls.def(
       "get_node_index",
-      [](PropertyGraph& self, const std::string& name)
+      [](PropertyGraph& self, const std::string& name, bool hash)
           -> std::shared_ptr<katana::EntityIndex<katana::GraphTopology::Node>> {
         if (!self.HasNodeIndex(name)) {
-          PythonChecked(self.MakeNodeIndex(name));
+          PythonChecked(self.MakeNodeIndex(
+              name, hash ? katana::EntityIndexKind::kHash
+                         : katana::EntityIndexKind::kSorted));
         }
         return PythonChecked(self.GetNodeIndex(name));
       },
-      py::arg("name"), py::return_value_policy::reference_internal);
+      py::arg("name"), py::arg("hash") = false,
+      py::return_value_policy::reference_internal,
+      R"""(
+      Return the index over the node property `name`, creating it if there is
+      none. A new index is a hash index if `hash` is true, which only supports
+      lookups of equal values, and only of strings.
+      )""");
   cls.def("has_edge_index", &PropertyGraph::HasEdgeIndex, py::arg("name"));
   cls.def(
       "get_edge_index",
-      [](PropertyGraph& self, const std::string& name)
+      [](PropertyGraph& self, const std::string& name, bool hash)
           -> std::shared_ptr<katana::EntityIndex<katana::GraphTopology::Edge>> {
         if (!self.HasEdgeIndex(name)) {
-          PythonChecked(self.MakeEdgeIndex(name));
+          PythonChecked(self.MakeEdgeIndex(
+              name, hash ? katana::EntityIndexKind::kHash
+                         : katana::EntityIndexKind::kSorted));
         }
         return PythonChecked(self.GetEdgeIndex(name));
       },
-      py::arg("name"), py::return_value_policy::reference_internal);
+      py::arg("name"), py::arg("hash") = false,
+      py::return_value_policy::reference_internal,
+      R"""(
+      Return the index over the edge property `name`, creating it if there is
+      none. A new index is a hash index if `hash` is true, which only supports
+      lookups of equal values, and only of strings.
+      )""");
+
+  cls.def(
+      "has_node_vector_index", &PropertyGraph::HasNodeVectorIndex,
+      py::arg("name"));
+  cls.def(
+      "get_node_vector_index",
+      [](PropertyGraph& self, const std::string& name,
+         const std::string& metric, uint32_t num_lists,
+         uint32_t num_iterations,
+         uint64_t seed) -> Result<std::shared_ptr<katana::VectorIndex>> {
+        if (!self.HasNodeVectorIndex(name)) {
+          katana::VectorIndex::Options options;
+          options.metric = KATANA_CHECKED(katana::ParseVectorMetric(metric));
+          options.num_lists = num_lists;
+          options.num_iterations = num_iterations;
+          options.seed = seed;
+          py::gil_scoped_release guard;
+          KATANA_CHECKED(self.MakeNodeVectorIndex(name, options));
+        }
+        return self.GetNodeVectorIndex(name);
+      },
+      py::arg("name"), py::arg("metric") = "l2", py::arg("num_lists") = 0,
+      py::arg("num_iterations") = 10, py::arg("seed") = 0,
+      py::return_value_policy::reference_internal,
+      R"""(
+      Return the vector index over the node property `name`, a property of
+      fixed size lists of floats such as embeddings, creating it if there is
+      none. A new index ranks neighbors by `metric`, one of "l2" (squared
+      Euclidean distance), "inner_product" or "cosine", and clusters the
+      vectors into `num_lists` lists, about the square root of their number
+      if 0, with `num_iterations` rounds of k-means seeded by `seed`. The
+      index is stored with the graph.
+      )""");
+  cls.def(
+      "delete_node_vector_index", &PropertyGraph::DeleteNodeVectorIndex,
+      py::arg("name"));
 
   cls.def("unload_topologies", &PropertyGraph::DropAllTopologies);
 
+  cls.def(
+      "memory_usage",
+      [](const PropertyGraph& self) {
+        auto usage = self.GetMemoryUsage();
+        auto items = [](const std::vector<katana::MemoryUsageItem>& items) {
+          py::dict dict;
+          for (const auto& item : items) {
+            dict[py::str(item.name)] = item.bytes;
+          }
+          return dict;
+        };
+        py::dict dict;
+        dict["topology"] = usage.topology;
+        dict["views"] = items(usage.views);
+        dict["node_properties"] = items(usage.node_properties);
+        dict["edge_properties"] = items(usage.edge_properties);
+        dict["entity_type_ids"] = usage.entity_type_ids;
+        dict["indexes"] = items(usage.indexes);
+        dict["other"] = items(usage.other);
+        dict["total"] = usage.TotalBytes();
+        return dict;
+      },
+      R"""(
+      :return: The bytes of memory held by each part of this graph, as a dict
+        of the topology, views, node and edge properties, entity type ids,
+        indexes, other optional datastructures and their total. The parts
+        with several members map the name of each member to its size.
+      )""");
+
   cls.def(
       "write",
       [](PropertyGraph& self, const std::string* path,
@@ -1106,6 +1865,51 @@ struct WrapStringEntityIndex {
   }
 };
 
+template <typename node_or_edge>
+struct WrapStringHashEntityIndex {
+  py::class_<
+      katana::EntityIndex<node_or_edge>,
+      std::shared_ptr<katana::EntityIndex<node_or_edge>>>
+      base_cls;
+
+  py::object instantiate(py::module& m, const char* name) {
+    using Cls = katana::StringHashEntityIndex<node_or_edge>;
+    py::class_<Cls, std::shared_ptr<Cls>> cls(m, name, base_cls);
+
+    cls.template def("__getitem__", [](Cls& self, const std::string& v) {
+      return *self.Find(v);
+    });
+    cls.template def("find_all", [](Cls& self, const std::string& v) {
+      auto [first, last] = self.EqualRange(v);
+      return py::make_iterator(first, last);
+    });
+    cls.template def(
+        "find_batch",
+        [](Cls& self,
+           const py::object& keys) -> Result<py::array_t<node_or_edge>> {
+          std::shared_ptr<arrow::Array> arrow_keys =
+              KATANA_CHECKED(arrow::py::unwrap_array(
+                  py::module::import("pyarrow").attr("array")(keys).ptr()));
+          katana::NUMAArray<node_or_edge> ids;
+          {
+            py::gil_scoped_release guard;
+            ids = KATANA_CHECKED(self.FindBatch(*arrow_keys));
+          }
+          return py::array_t<node_or_edge>(ids.size(), ids.data());
+        },
+        py::arg("keys"),
+        R"""(
+        Look up each of the strings `keys` in parallel. Return a numpy array
+        of the least id with each value, or of the largest value of its type
+        where a key is None or not in the index.
+        )""");
+
+    //    katana::DefConventions(cls);
+
+    return std::move(cls);
+  }
+};
+
 template <typename node_or_edge>
 void
 DefEntityIndex(py::module& m) {
@@ -1124,6 +1928,62 @@ DefEntityIndex(py::module& m) {
       WrapPrimitiveEntityIndex<node_or_edge>{cls});
   WrapStringEntityIndex<node_or_edge>{cls}.instantiate(
       m, ("String" + cls_name).c_str());
+  WrapStringHashEntityIndex<node_or_edge>{cls}.instantiate(
+      m, ("StringHash" + cls_name).c_str());
+}
+
+void
+DefVectorIndex(py::module& m) {
+  using katana::VectorIndex;
+  py::class_<VectorIndex, std::shared_ptr<VectorIndex>> cls(
+      m, "NodeVectorIndex");
+
+  cls.def_property_readonly("property_name", &VectorIndex::property_name);
+  cls.def_property_readonly("metric", [](const VectorIndex& self) {
+    return katana::VectorMetricName(self.metric());
+  });
+  cls.def_property_readonly("dimension", &VectorIndex::dimension);
+  cls.def_property_readonly("num_lists", &VectorIndex::num_lists);
+  cls.def("__len__", &VectorIndex::size);
+
+  cls.def(
+      "search",
+      [](const VectorIndex& self,
+         py::array_t<float, py::array::c_style | py::array::forcecast> queries,
+         size_t k, size_t num_probes) -> Result<py::tuple> {
+        size_t num_queries = queries.ndim() == 1 ? 1 : queries.shape(0);
+        size_t dimension = queries.shape(queries.ndim() - 1);
+        if (queries.ndim() > 2 || dimension != self.dimension()) {
+          return KATANA_ERROR(
+              katana::ErrorCode::InvalidArgument,
+              "queries must be rows of {} floats", self.dimension());
+        }
+        VectorIndex::Neighbors neighbors;
+        {
+          py::gil_scoped_release guard;
+          neighbors = KATANA_CHECKED(
+              self.Search(queries.data(), num_queries, k, num_probes));
+        }
+        std::vector<ssize_t> shape{
+            static_cast<ssize_t>(num_queries), static_cast<ssize_t>(k)};
+        py::array_t<VectorIndex::Node> ids(shape);
+        std::copy(
+            neighbors.ids.begin(), neighbors.ids.end(), ids.mutable_data());
+        py::array_t<float> distances(shape);
+        std::copy(
+            neighbors.distances.begin(), neighbors.distances.end(),
+            distances.mutable_data());
+        return py::make_tuple(ids, distances);
+      },
+      py::arg("queries"), py::arg("k"), py::arg("num_probes") = 8,
+      R"""(
+      Find the `k` nearest indexed nodes to each row of `queries` among the
+      vectors of the `num_probes` lists nearest to it; probing all lists is an
+      exact search. Queries run in parallel. Return a pair of numpy arrays of
+      one row per query: the ids of the nodes from the nearest, and their
+      distances. Rows of queries with fewer than `k` neighbors end with the
+      largest node id and infinite distances.
+      )""");
 }
 
 void
@@ -1134,6 +1994,69 @@ DefTxnContext(py::module& m) {
   katana::DefKatanaAddress(cls);
 }
 
+void
+DefGraphLoad(py::module& m) {
+  py::class_<GraphLoad> cls(
+      m, "GraphLoad",
+      R"""(
+      A load of a graph, or of properties of a graph, running on a background
+      thread; see :py:meth:`Graph.load_async` and
+      :py:meth:`Graph.load_properties_async`. Dropping the load cancels it.
+      )""");
+  cls.def(
+      "done", [](const GraphLoad& self) { return self.Wait(0.0); },
+      "Return True if the load has finished, successfully or not.");
+  cls.def(
+      "wait", &GraphLoad::Wait, py::arg("timeout") = std::nullopt,
+      R"""(
+      Wait for the load to finish, for at most timeout seconds if given.
+
+      :returns: True if the load has finished.
+      )""");
+  cls.def(
+      "result",
+      [](const GraphLoad& self, std::optional<double> timeout)
+          -> katana::Result<std::shared_ptr<katana::PropertyGraph>> {
+        if (!self.Wait(timeout)) {
+          PyErr_Format(
+              PyExc_TimeoutError, "load did not finish in %f seconds",
+              *timeout);
+          throw py::error_already_set();
+        }
+        return self.Get();
+      },
+      py::arg("timeout") = std::nullopt,
+      R"""(
+      Wait for the load to finish and return the loaded graph.
+
+      :raises TimeoutError: If timeout seconds pass first.
+      :raises concurrent.futures.CancelledError: If the load was cancelled.
+      )""");
+  cls.def(
+      "cancel", [](GraphLoad& self) { self.progress().Cancel(); },
+      R"""(
+      Ask the load to stop. It stops between properties and steps of the
+      load, after which ``result()`` raises
+      ``concurrent.futures.CancelledError``. A load that already finished is
+      not affected.
+      )""");
+  cls.def_property_readonly(
+      "progress",
+      [](const GraphLoad& self) {
+        const katana::RDGLoadProgress& progress = self.progress();
+        py::dict out;
+        out["properties_total"] = progress.properties_total.load();
+        out["properties_loaded"] = progress.properties_loaded.load();
+        out["bytes_loaded"] = progress.bytes_loaded.load();
+        return out;
+      },
+      R"""(
+      The progress of the load: a dict of the number of properties to load
+      (known once the load has read the graph metadata), the number loaded so
+      far and their bytes in memory.
+      )""");
+}
+
 void
 DefRanges(py::module& m) {
   py::class_<katana::GraphTopologyTypes::nodes_range> nodes_range_cls(
@@ -1163,7 +2086,16 @@ katana::python::InitPropertyGraph(py::module& m) {
   DefAccessors(m);
   DefEntityIndex<katana::GraphTopologyTypes::Node>(m);
   DefEntityIndex<katana::GraphTopologyTypes::Edge>(m);
+  DefVectorIndex(m);
   DefTxnContext(m);
   DefRanges(m);
+  DefGraphLoad(m);
   DefPropertyGraph(m);
+
+  m.def("property_bytes_copied", &PropertyBytesCopied, R"""(
+  The number of bytes of property data that adding or upserting properties
+  has copied from Python arguments so far. Arrow data and numpy arrays of
+  fixed width types are shared with the graph instead, and pass
+  ``may_copy=False`` to make any copy an error.
+  )""");
 }
@@ -282,6 +282,18 @@ KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> NullChunkedArray(
 
 KATANA_EXPORT std::shared_ptr<arrow::Table> MakeEmptyArrowTable();
 
+/// \returns the only chunk of array or, if it has none or several, an array
+/// of its values. Only the latter copies; code that can read the chunks in
+/// place should.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Array>> UnchunkedArray(
+    const std::shared_ptr<arrow::ChunkedArray>& array);
+
+/// \returns array if the values of all its chunks are in mutable buffers and
+/// otherwise a copy of it where they are. Only the immutable value buffers,
+/// e.g., ones mapped from a file, are copied.
+KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> MutableValuesArray(
+    const std::shared_ptr<arrow::ChunkedArray>& array);
+
 /// Print the differences between two ChunkedArrays only using
 /// about approx_total_characters
 KATANA_EXPORT void DiffFormatTo(
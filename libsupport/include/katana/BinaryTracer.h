@@ -0,0 +1,132 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_BINARYTRACER_H_
+#define KATANA_LIBSUPPORT_KATANA_BINARYTRACER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "katana/ProgressTracer.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class BinaryTraceState;
+
+struct KATANA_EXPORT BinaryTracerOptions {
+  /// The bytes of the ring buffer of each thread that records, rounded up to
+  /// a power of two
+  size_t buffer_bytes{1 << 20};
+  /// How often the buffers are drained to the output
+  std::chrono::milliseconds flush_interval{100};
+};
+
+/// BinaryTracer records spans, logs and tags as compact binary records
+/// rather than formatting them as they happen like JSONTracer and
+/// TextTracer. Each thread appends its records to its own ring buffer
+/// without locking, and a background thread drains the buffers to the output
+/// every flush_interval. A record that does not fit in its thread's buffer
+/// is dropped rather than waited for; see dropped_records(). Finish and the
+/// destructor drain the buffers before returning. Unlike those of the other
+/// tracers, logs do not carry the memory usage of the process, which is
+/// costly to read.
+///
+/// The output is converted to the Chrome trace format, which Perfetto and
+/// chrome://tracing load, by ToChromeTrace or the trace-convert tool.
+///
+/// Records are in the byte order of the host that wrote them.
+class KATANA_EXPORT BinaryTracer : public ProgressTracer {
+public:
+  using OutputCB = std::function<void(const std::string&)>;
+  using Options = BinaryTracerOptions;
+
+  /// Make a tracer that writes to the file at path, replacing it
+  static Result<std::unique_ptr<BinaryTracer>> Make(
+      const std::string& path, uint32_t host_id = 0, uint32_t num_hosts = 1,
+      const Options& options = Options());
+  /// Make a tracer that passes its output to out_callback in chunks of whole
+  /// records. out_callback is called by one thread at a time.
+  static std::unique_ptr<BinaryTracer> Make(
+      uint32_t host_id, uint32_t num_hosts, OutputCB out_callback,
+      const Options& options = Options());
+
+  ~BinaryTracer() override;
+
+  std::shared_ptr<ProgressSpan> StartSpan(
+      const std::string& span_name, const ProgressContext& child_of) override;
+
+  std::string Inject(const ProgressContext& ctx) override;
+  std::unique_ptr<ProgressContext> Extract(const std::string& carrier) override;
+
+  /// \returns the number of records dropped so far because a ring buffer was
+  /// full
+  uint64_t dropped_records() const;
+
+  /// Convert the output of a BinaryTracer to a Chrome trace: a JSON object
+  /// whose traceEvents are a complete event per span, with the tags of the
+  /// span as its args, and an instant event per log. Spans that were not
+  /// finished last until the last record.
+  static Result<std::string> ToChromeTrace(const std::string& trace);
+
+private:
+  BinaryTracer(
+      uint32_t host_id, uint32_t num_hosts, OutputCB out_callback,
+      const Options& options);
+
+  std::shared_ptr<ProgressSpan> StartSpan(
+      const std::string& span_name,
+      std::shared_ptr<ProgressSpan> child_of) override;
+
+  void Close() override;
+
+  std::shared_ptr<BinaryTraceState> state_;
+};
+
+class KATANA_EXPORT BinaryContext : public ProgressContext {
+public:
+  std::unique_ptr<ProgressContext> Clone() const noexcept override;
+  std::string GetTraceID() const noexcept override;
+  std::string GetSpanID() const noexcept override;
+
+private:
+  friend class BinaryTracer;
+  friend class BinarySpan;
+
+  BinaryContext(uint64_t trace_id, uint64_t span_id)
+      : trace_id_(trace_id), span_id_(span_id) {}
+
+  uint64_t trace_id_;
+  uint64_t span_id_;
+};
+
+class KATANA_EXPORT BinarySpan : public ProgressSpan {
+public:
+  ~BinarySpan() override { Finish(); }
+
+  void SetTags(const Tags& tags) override;
+
+  void Log(const std::string& message, const Tags& tags) override;
+
+  const ProgressContext& GetContext() const noexcept override {
+    return context_;
+  }
+
+private:
+  friend BinaryTracer;
+
+  BinarySpan(
+      std::shared_ptr<BinaryTraceState> state, const std::string& span_name,
+      std::shared_ptr<ProgressSpan> parent, uint64_t trace_id,
+      uint64_t parent_id);
+
+  void Close() override;
+
+  std::shared_ptr<BinaryTraceState> state_;
+  BinaryContext context_;
+};
+
+}  // namespace katana
+
+#endif
@@ -1,8 +1,9 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_CACHE_H_
 #define KATANA_LIBSUPPORT_KATANA_CACHE_H_
 
-// This is single threaded only, it is not intended to store large objects,
-// but rather metadata (e.g., a shared_ptr to a property column).
+// Cache is single threaded only, it is not intended to store large objects,
+// but rather metadata (e.g., a shared_ptr to a property column). ShardedCache,
+// below, is the thread-safe variant.
 
 // The problem witchel had implementing a multi-threaded version using
 // parallel-hashmap is a lock ordering problem.  parallel-hashmap 1.33 allows
@@ -11,13 +12,22 @@
 // lock ordering is parallel-hashmap write lock, then list lock.  But without a way to
 // execute insert code with the parallel-hashmap write lock held, it seemed like there
 // would be some form of race condition.
+//
+// ShardedCache sidesteps that by never holding more than one lock: each shard
+// is a Cache behind its own mutex, and the global byte budget is an atomic
+// counter that is enforced by evicting from shards one at a time.
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <arrow/table.h>
 
@@ -145,6 +155,9 @@ public:
   /// Returns true if the cache is empty
   bool empty() const { return key_to_value_.empty(); }
 
+  /// Returns the number of entries regardless of the replacement policy
+  size_t num_entries() const { return key_to_value_.size(); }
+
   /// Try to reclaim \p goal bytes (#entries), evicting least recently used entries to
   /// do it.  Returns the number of bytes actually evicted.
   int64_t Reclaim(int64_t goal) {
@@ -155,6 +168,49 @@ public:
     return reclaimed;
   }
 
+  /// Evict the entry with the lowest \p score among the \p sample least
+  /// recently used entries; ties go to the less recently used one. Returns
+  /// the number of bytes (#entries) evicted.
+  int64_t EvictLowestScore(
+      size_t sample,
+      const std::function<double(const Key& key, const Value& value)>& score) {
+    auto evicted = RemoveLowestScore(sample, score);
+    if (value_to_bytes_ != nullptr) {
+      return value_to_bytes_(evicted.second);
+    }
+    return 1;
+  }
+
+  /// Like EvictLowestScore but hand the evicted entry to the caller
+  std::pair<Key, Value> RemoveLowestScore(
+      size_t sample,
+      const std::function<double(const Key& key, const Value& value)>& score) {
+    KATANA_LOG_DEBUG_ASSERT(!empty());
+    auto victim = --lru_list_.end();
+    double victim_score = score(*victim, key_to_value_.at(*victim).value);
+    auto it = victim;
+    for (size_t i = 1; i < sample && it != lru_list_.begin(); ++i) {
+      --it;
+      double it_score = score(*it, key_to_value_.at(*it).value);
+      if (it_score < victim_score) {
+        victim = it;
+        victim_score = it_score;
+      }
+    }
+    Key evicted_key = *victim;
+    auto evicted_value = EvictMe(victim);
+    return {std::move(evicted_key), std::move(evicted_value)};
+  }
+
+  /// Evict the least recently used entry and hand it to the caller
+  std::pair<Key, Value> RemoveLeastRecent() {
+    KATANA_LOG_DEBUG_ASSERT(!empty());
+    auto tail = --lru_list_.end();
+    Key evicted_key = *tail;
+    auto evicted_value = EvictMe(tail);
+    return {std::move(evicted_key), std::move(evicted_value)};
+  }
+
   bool Contains(const Key& key) const {
     return key_to_value_.find(key) != key_to_value_.end();
   }
@@ -289,10 +345,235 @@ private:
   std::function<int64_t(const Value& value)> value_to_bytes_;
 };
 
+/// A thread-safe cache made of independently locked LRU shards. Keys are
+/// assigned to shards by hash, so concurrent users touching different keys
+/// rarely contend. Capacity is a byte budget shared by all shards; when an
+/// insert pushes the total over budget, a clock hand sweeps the shards and
+/// evicts the least recently used entry of each until the total fits. Recency
+/// is therefore exact within a shard and approximate across shards.
+///
+/// With an eviction score (SetEvictionScore) each shard instead evicts the
+/// lowest scoring of its few least recently used entries.
+template <typename Value>
+class KATANA_EXPORT ShardedCache {
+  using Key = katana::URI;
+  using Shard = Cache<Value>;
+
+public:
+  using ScoreFn = std::function<double(const Key& key, const Value& value)>;
+  using EvictFn = std::function<void(const Key& key, Value&& value)>;
+
+  static constexpr size_t kDefaultNumShards = 16;
+  static constexpr size_t kDefaultEvictionSample = 8;
+
+  /// Construct a cache that holds a fixed number of bytes.
+  ShardedCache(
+      int64_t capacity,  // bytes of entries
+      std::function<int64_t(const Value& value)> value_to_bytes,
+      size_t num_shards = kDefaultNumShards)
+      : capacity_(capacity), value_to_bytes_(std::move(value_to_bytes)) {
+    KATANA_LOG_VASSERT(capacity_ > 0, "cache requires positive capacity");
+    MakeShards(num_shards);
+  }
+
+  /// Construct a cache that holds whatever we put in it and only evicts when
+  /// we explicitly tell it to do so (see Cache).
+  ShardedCache(
+      std::function<int64_t(const Value& value)> value_to_bytes,
+      size_t num_shards = kDefaultNumShards)
+      : capacity_(std::numeric_limits<int64_t>::max()),
+        value_to_bytes_(std::move(value_to_bytes)) {
+    MakeShards(num_shards);
+  }
+
+  /// Returns the number of bytes held across all shards
+  int64_t size() const { return total_bytes_.load(std::memory_order_relaxed); }
+
+  int64_t capacity() const { return capacity_; }
+
+  size_t num_shards() const { return shards_.size(); }
+
+  /// Rank eviction candidates by \p score, lowest evicted first, considering
+  /// the \p sample least recently used entries of a shard. \p score is
+  /// called with the shard lock held, so it must not call back into this
+  /// cache. Not thread safe; set it before sharing the cache.
+  void SetEvictionScore(ScoreFn score, size_t sample = kDefaultEvictionSample) {
+    KATANA_LOG_VASSERT(sample > 0, "eviction sample must be positive");
+    score_ = std::move(score);
+    eviction_sample_ = sample;
+  }
+
+  /// Call \p on_evict with every entry evicted to stay within capacity or by
+  /// Reclaim (but not by GetAndEvict or clear). It runs without any cache lock
+  /// held. Not thread safe; set it before sharing the cache.
+  void SetEvictionCallback(EvictFn on_evict) {
+    on_evict_ = std::move(on_evict);
+  }
+
+  void clear() {
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      total_bytes_ -= shard->cache.size();
+      shard->cache.clear();
+    }
+  }
+
+  bool empty() const { return size() == 0; }
+
+  /// Try to reclaim \p goal bytes, evicting the least recently used entry of
+  /// each shard in turn. Returns the number of bytes actually evicted.
+  int64_t Reclaim(int64_t goal) { return Reclaim(goal, nullptr); }
+
+  bool Contains(const Key& key) const {
+    const auto& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.cache.Contains(key);
+  }
+
+  void Insert(const Key& key, const Value& value) {
+    if (value_to_bytes_(value) > capacity_) {
+      // Object too big, don't insert
+      return;
+    }
+    auto& shard = ShardFor(key);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      int64_t before = shard.cache.size();
+      shard.cache.Insert(key, value);
+      total_bytes_ += shard.cache.size() - before;
+    }
+    if (size() > capacity_) {
+      Reclaim(size() - capacity_, &key);
+    }
+  }
+
+  std::optional<Value> Get(const Key& key) {
+    auto& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.cache.Get(key);
+  }
+
+  std::optional<Value> GetAndEvict(const Key& key) {
+    auto& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    int64_t before = shard.cache.size();
+    std::optional<Value> ret = shard.cache.GetAndEvict(key);
+    total_bytes_ -= before - shard.cache.size();
+    return ret;
+  }
+
+  /// Returns the sum of the statistics of all shards
+  CacheStats GetStats() const {
+    CacheStats stats;
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      CacheStats shard_stats = shard->cache.GetStats();
+      stats.get_count += shard_stats.get_count;
+      stats.get_hit_count += shard_stats.get_hit_count;
+      stats.insert_count += shard_stats.insert_count;
+      stats.insert_hit_count += shard_stats.insert_hit_count;
+    }
+    return stats;
+  }
+
+private:
+  struct LockedShard {
+    explicit LockedShard(
+        const std::function<int64_t(const Value& value)>& value_to_bytes)
+        : cache(value_to_bytes) {}
+
+    mutable std::mutex mutex;
+    Shard cache;
+  };
+
+  void MakeShards(size_t num_shards) {
+    KATANA_LOG_VASSERT(
+        value_to_bytes_ != nullptr, "cache requires value to bytes function");
+    KATANA_LOG_VASSERT(num_shards > 0, "cache requires at least one shard");
+    shards_.reserve(num_shards);
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.emplace_back(std::make_unique<LockedShard>(value_to_bytes_));
+    }
+  }
+
+  LockedShard& ShardFor(const Key& key) {
+    return *shards_[Key::Hash{}(key) % shards_.size()];
+  }
+  const LockedShard& ShardFor(const Key& key) const {
+    return *shards_[Key::Hash{}(key) % shards_.size()];
+  }
+
+  /// Evict until \p goal bytes are reclaimed or every shard is empty. Never
+  /// evict \p keep, the entry whose insert triggered the eviction.
+  int64_t Reclaim(int64_t goal, const Key* keep) {
+    int64_t reclaimed{};
+    size_t empty_shards{};
+    while (reclaimed < goal && empty_shards < shards_.size()) {
+      int64_t evicted = EvictFromNextShard(keep);
+      if (evicted == 0) {
+        ++empty_shards;
+        continue;
+      }
+      empty_shards = 0;
+      reclaimed += evicted;
+    }
+    return reclaimed;
+  }
+
+  int64_t EvictFromNextShard(const Key* keep) {
+    size_t hand = clock_hand_.fetch_add(1, std::memory_order_relaxed);
+    auto& shard = *shards_[hand % shards_.size()];
+    std::optional<std::pair<Key, Value>> evicted;
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      // keep was just inserted so it is at the front of its shard's LRU list;
+      // it is the victim only if it is alone
+      size_t evictable = shard.cache.num_entries();
+      if (keep != nullptr && evictable == 1 && shard.cache.Contains(*keep)) {
+        evictable = 0;
+      }
+      if (evictable == 0) {
+        return 0;
+      }
+      if (score_ == nullptr) {
+        evicted = shard.cache.RemoveLeastRecent();
+      } else {
+        evicted = shard.cache.RemoveLowestScore(
+            eviction_sample_,
+            [this, keep](const Key& key, const Value& value) {
+              if (keep != nullptr && key == *keep) {
+                return std::numeric_limits<double>::infinity();
+              }
+              return score_(key, value);
+            });
+      }
+    }
+    int64_t evicted_bytes = value_to_bytes_(evicted->second);
+    total_bytes_ -= evicted_bytes;
+    if (on_evict_ != nullptr) {
+      on_evict_(evicted->first, std::move(evicted->second));
+    }
+    return evicted_bytes;
+  }
+
+  // Shards are never added or removed after construction
+  std::vector<std::unique_ptr<LockedShard>> shards_;
+
+  int64_t capacity_{0};
+  std::atomic<int64_t> total_bytes_{0};
+  std::atomic<size_t> clock_hand_{0};
+
+  std::function<int64_t(const Value& value)> value_to_bytes_;
+  ScoreFn score_;
+  size_t eviction_sample_{kDefaultEvictionSample};
+  EvictFn on_evict_;
+};
+
 // The property cache contains properties NOT in use by the graph and never contains a
 // property that IS in use by the graph.  When a graph unloads a property, it goes
 // into the cache, and when it loads a property it (hopefully) comes from the cache.
-using PropertyCache = Cache<std::shared_ptr<arrow::Table>>;
+// It is shared by every graph in the process, so it must be thread-safe.
+using PropertyCache = ShardedCache<std::shared_ptr<arrow::Table>>;
 
 }  // namespace katana
 
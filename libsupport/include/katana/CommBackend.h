@@ -3,6 +3,8 @@
 
 #include <cstdint>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -10,6 +12,62 @@
 
 namespace katana {
 
+/// The element types CommBackend::Allreduce can reduce
+enum class CommDataType {
+  kInt8,
+  kUInt8,
+  kInt32,
+  kUInt32,
+  kInt64,
+  kUInt64,
+  kFloat,
+  kDouble,
+};
+
+/// The reductions of CommBackend::Allreduce. The bitwise ones are only for
+/// integer types.
+enum class ReduceOp {
+  kSum,
+  kMin,
+  kMax,
+  kBitOr,
+  kBitAnd,
+};
+
+/// The size in bytes of an element of type
+KATANA_EXPORT uint64_t CommDataTypeSize(CommDataType type);
+
+template <typename T>
+constexpr CommDataType
+CommDataTypeOf() {
+  if constexpr (std::is_same_v<T, int8_t>) {
+    return CommDataType::kInt8;
+  } else if constexpr (std::is_same_v<T, uint8_t>) {
+    return CommDataType::kUInt8;
+  } else if constexpr (std::is_same_v<T, int32_t>) {
+    return CommDataType::kInt32;
+  } else if constexpr (std::is_same_v<T, uint32_t>) {
+    return CommDataType::kUInt32;
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    return CommDataType::kInt64;
+  } else if constexpr (std::is_same_v<T, uint64_t>) {
+    return CommDataType::kUInt64;
+  } else if constexpr (std::is_same_v<T, float>) {
+    return CommDataType::kFloat;
+  } else {
+    static_assert(std::is_same_v<T, double>, "type cannot be reduced");
+    return CommDataType::kDouble;
+  }
+}
+
+/// A CommBackend is how the tasks of a distributed job coordinate.
+///
+/// Every task must call the same collectives in the same order. The
+/// collectives on raw buffers have implementations in terms of the string
+/// Broadcast so that every backend has them, but they move every buffer
+/// through every task; backends should override them with real
+/// collectives, e.g., MPI_Bcast, MPI_Allreduce, MPI_Allgatherv and
+/// MPI_Alltoallv.
 class KATANA_EXPORT CommBackend {
 public:
   CommBackend() = default;
@@ -29,6 +87,44 @@ public:
   /// Notify other tasks that there was a failure; e.g., with MPI_Abort
   virtual void NotifyFailure() = 0;
 
+  /// Broadcast the size bytes at buf on root to buf on everyone
+  virtual katana::Result<void> Broadcast(
+      uint32_t root, void* buf, uint64_t size);
+  /// Reduce the count elements at buf of every task with op, leaving the
+  /// result in buf on everyone. Every task gets the same result, even for
+  /// floating point types.
+  virtual katana::Result<void> Allreduce(
+      void* buf, uint64_t count, CommDataType type, ReduceOp op);
+  /// Gather the send_bytes at send_buf of every task into recv_buf on
+  /// everyone, in rank order. recv_bytes has the number of bytes each task
+  /// sends.
+  virtual katana::Result<void> Allgatherv(
+      const void* send_buf, uint64_t send_bytes, void* recv_buf,
+      const std::vector<uint64_t>& recv_bytes);
+  /// Send send_bytes[i] bytes of send_buf to task i and receive
+  /// recv_bytes[i] bytes from task i into recv_buf. The parts of both
+  /// buffers are in rank order.
+  virtual katana::Result<void> AlltoAllv(
+      const void* send_buf, const std::vector<uint64_t>& send_bytes,
+      void* recv_buf, const std::vector<uint64_t>& recv_bytes);
+
+  template <typename T>
+  katana::Result<void> Allreduce(T* buf, uint64_t count, ReduceOp op) {
+    return Allreduce(buf, count, CommDataTypeOf<T>(), op);
+  }
+
+  /// Gather val from every task, in rank order
+  template <typename T>
+  katana::Result<std::vector<T>> Allgather(const T& val) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::vector<T> vals(num());
+    std::vector<uint64_t> sizes(num(), sizeof(T));
+    if (auto res = Allgatherv(&val, sizeof(T), vals.data(), sizes); !res) {
+      return res.error();
+    }
+    return vals;
+  }
+
   /// The number of tasks involved
   uint32_t num() const { return Num; }
 
@@ -61,10 +157,23 @@ protected:
     Rank = rank;
     LocalRank = local_rank;
   }
+
+  /// Check that tasks can reduce elements of type with op
+  static katana::Result<void> CheckReduce(CommDataType type, ReduceOp op);
+  /// Reduce the count elements at from into those at into
+  static void Reduce(
+      void* into, const void* from, uint64_t count, CommDataType type,
+      ReduceOp op);
+  /// Check that there is a size per task and return where the part of each
+  /// task starts in a buffer, followed by the size of the buffer
+  katana::Result<std::vector<uint64_t>> Displacements(
+      const std::vector<uint64_t>& sizes) const;
 };
 
 class KATANA_EXPORT NullCommBackend : public CommBackend {
 public:
+  using CommBackend::Allreduce;
+
   void Barrier() override {}
   void NotifyFailure() override;
   bool Broadcast([[maybe_unused]] uint32_t root, bool val) override {
@@ -75,6 +184,19 @@ public:
       uint64_t max_size) override {
     return val.substr(0, max_size);
   }
+  katana::Result<void> Broadcast(uint32_t, void*, uint64_t) override {
+    return katana::ResultSuccess();
+  }
+  katana::Result<void> Allreduce(
+      void*, uint64_t, CommDataType type, ReduceOp op) override {
+    return CheckReduce(type, op);
+  }
+  katana::Result<void> Allgatherv(
+      const void* send_buf, uint64_t send_bytes, void* recv_buf,
+      const std::vector<uint64_t>& recv_bytes) override;
+  katana::Result<void> AlltoAllv(
+      const void* send_buf, const std::vector<uint64_t>& send_bytes,
+      void* recv_buf, const std::vector<uint64_t>& recv_bytes) override;
 };
 
 }  // namespace katana
@@ -78,6 +78,8 @@ enum class ErrorCode {
   MpiError,
   BadVersion,
   GSError,
+  Cancelled,
+  GpuError,
 };
 
 KATANA_EXPORT ErrorCode ArrowToKatana(arrow::StatusCode);
@@ -137,6 +139,10 @@ public:
       return "some MPI process reported an error";
     case ErrorCode::GSError:
       return "Google storage error";
+    case ErrorCode::Cancelled:
+      return "operation cancelled";
+    case ErrorCode::GpuError:
+      return "GPU error";
     default:
       return "unknown error";
     }
@@ -171,7 +177,10 @@ public:
     case ErrorCode::AzureError:
     case ErrorCode::MpiError:
     case ErrorCode::GSError:
+    case ErrorCode::GpuError:
       return make_error_condition(std::errc::io_error);
+    case ErrorCode::Cancelled:
+      return make_error_condition(std::errc::operation_canceled);
     default:
       return std::error_condition(c, *this);
     }
@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_JSON_H_
 #define KATANA_LIBSUPPORT_KATANA_JSON_H_
 
+#include <algorithm>
+#include <string_view>
+
 #include <nlohmann/json.hpp>
 
 #include "katana/ErrorCode.h"
@@ -48,6 +51,63 @@ JsonDump(const T& obj) {
   return JsonDump(nlohmann::json(obj));
 }
 
+/// Prefix of the binary encoding written by JsonDumpBinary. JSON text never
+/// starts with a NUL byte, so readers can tell the two encodings apart.
+constexpr std::string_view kJsonBinaryMagic{"\0KMP", 4};
+
+/// Whether obj, a sequence of bytes, holds the binary encoding
+template <typename U>
+bool
+IsJsonBinary(const U& obj) {
+  return static_cast<size_t>(obj.end() - obj.begin()) >=
+             kJsonBinaryMagic.size() &&
+         std::equal(
+             kJsonBinaryMagic.begin(), kJsonBinaryMagic.end(), obj.begin());
+}
+
+/// Like JsonParse but for the binary (MessagePack) encoding written by
+/// JsonDumpBinary; values are decoded from obj in place with no text to
+/// tokenize, which is much faster for large documents
+template <typename T, typename U>
+katana::Result<void>
+JsonParseBinary(U& obj, T* val) {
+  if (!IsJsonBinary(obj)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::JSONParseFailed, "parsing binary json: bad magic");
+  }
+  try {
+    auto j = nlohmann::json::from_msgpack(
+        obj.begin() + kJsonBinaryMagic.size(), obj.end());
+    j.get_to(*val);
+    return katana::ResultSuccess();
+  } catch (const std::exception& exp) {
+    return KATANA_ERROR(
+        katana::ErrorCode::JSONParseFailed, "parsing binary json: {}",
+        exp.what());
+  }
+}
+
+/// Parse obj as whichever of JSON text or the binary encoding it holds
+template <typename T, typename U>
+katana::Result<void>
+JsonParseAny(U& obj, T* val) {
+  if (IsJsonBinary(obj)) {
+    return JsonParseBinary(obj, val);
+  }
+  return JsonParse(obj, val);
+}
+
+/// Dump to the binary encoding read by JsonParseBinary: kJsonBinaryMagic
+/// followed by the MessagePack encoding of obj
+KATANA_EXPORT katana::Result<std::string> JsonDumpBinary(
+    const nlohmann::json& obj);
+
+template <typename T>
+katana::Result<std::string>
+JsonDumpBinary(const T& obj) {
+  return JsonDumpBinary(nlohmann::json(obj));
+}
+
 }  // namespace katana
 
 #endif
@@ -0,0 +1,195 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_METRICS_H_
+#define KATANA_LIBSUPPORT_KATANA_METRICS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+/// Metrics are counters, gauges and histograms that a long running process
+/// updates as it goes and that a MetricsExporter (see MetricsExporter.h)
+/// reports continuously, e.g., to Prometheus or an OpenTelemetry collector.
+/// Unlike the statistics of StatManager and the logs of ProgressTracer, they
+/// are aggregated in place, so updating one is a relaxed atomic add.
+///
+/// Metric names follow the Prometheus conventions: snake case, a katana_
+/// prefix, a unit suffix, e.g., _bytes or _seconds, and _total for counters.
+///
+/// \file
+
+namespace katana {
+
+/// Label names and values that distinguish the series of a metric
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+enum class MetricType {
+  kCounter,
+  kGauge,
+  kHistogram,
+};
+
+/// A monotonically increasing count
+class KATANA_EXPORT Counter {
+public:
+  void Add(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+  uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint64_t> value_{0};
+};
+
+/// A value that goes up and down
+class KATANA_EXPORT Gauge {
+public:
+  void Set(double value) { value_.store(value, std::memory_order_relaxed); }
+  void Add(double delta) {
+    double old = value_.load(std::memory_order_relaxed);
+    while (!value_.compare_exchange_weak(
+        old, old + delta, std::memory_order_relaxed)) {
+    }
+  }
+  double value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<double> value_{0};
+};
+
+/// A distribution of observations, counted in buckets by their upper bounds
+class KATANA_EXPORT Histogram {
+public:
+  /// bounds must be increasing. Observations above the last bound go to an
+  /// extra bucket.
+  explicit Histogram(std::vector<double> bounds);
+
+  void Observe(double value);
+
+  const std::vector<double>& bounds() const { return bounds_; }
+  /// \returns the number of observations in each bucket, not cumulatively,
+  /// with the extra bucket last
+  std::vector<uint64_t> bucket_counts() const;
+  double sum() const { return sum_.load(std::memory_order_relaxed); }
+
+private:
+  std::vector<double> bounds_;
+  std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+  std::atomic<double> sum_{0};
+};
+
+/// The bounds, in seconds, of the buckets of latency histograms: from 100us
+/// to 10s in steps of about 2.5x
+KATANA_EXPORT const std::vector<double>& LatencyBuckets();
+
+/// The value of one series of a metric when collected
+struct KATANA_EXPORT MetricSample {
+  MetricLabels labels;
+  /// The value of a counter or gauge
+  double value{};
+  /// The bucket counts of a histogram, as returned by
+  /// Histogram::bucket_counts
+  std::vector<uint64_t> bucket_counts;
+  /// The sum of the observations of a histogram
+  double sum{};
+};
+
+/// All the series of one metric when collected
+struct KATANA_EXPORT MetricFamily {
+  std::string name;
+  std::string help;
+  MetricType type{MetricType::kGauge};
+  /// The bucket bounds of a histogram
+  std::vector<double> bounds;
+  std::vector<MetricSample> samples;
+
+  /// Add a sample of a counter or gauge
+  void AddSample(double value, MetricLabels labels = {}) {
+    MetricSample sample;
+    sample.labels = std::move(labels);
+    sample.value = value;
+    samples.emplace_back(std::move(sample));
+  }
+};
+
+/// The metrics of a process. Metrics are made on their first use and live as
+/// long as the registry, so code on hot paths looks a metric up once:
+///
+///     static Counter& reads = MetricsRegistry::Get().GetCounter(
+///         "katana_storage_reads_total", "Reads from storage");
+///     reads.Add();
+///
+/// Values tracked elsewhere, e.g., cache statistics, are reported by
+/// collectors, which are called whenever the metrics are collected.
+class KATANA_EXPORT MetricsRegistry {
+public:
+  using CollectorFn = std::function<void(std::vector<MetricFamily>*)>;
+
+  MetricsRegistry() = default;
+  MetricsRegistry(const MetricsRegistry&) = delete;
+  MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+  /// The registry that the metrics of katana are in
+  static MetricsRegistry& Get();
+
+  /// \returns the series of the named counter with the given labels, making
+  /// it if needed. A name must always be used for the same type of metric.
+  Counter& GetCounter(
+      const std::string& name, const std::string& help,
+      const MetricLabels& labels = {});
+  Gauge& GetGauge(
+      const std::string& name, const std::string& help,
+      const MetricLabels& labels = {});
+  /// The bounds of a histogram are those of its first use
+  Histogram& GetHistogram(
+      const std::string& name, const std::string& help,
+      const std::vector<double>& bounds, const MetricLabels& labels = {});
+
+  /// Add a collector, which appends metric families to its argument. It is
+  /// called from the thread that collects, so it must be thread safe, and
+  /// must not use the registry.
+  /// \returns an id for RemoveCollector
+  uint64_t AddCollector(CollectorFn collector);
+  void RemoveCollector(uint64_t id);
+
+  /// \returns the current values of all metrics
+  std::vector<MetricFamily> Collect() const;
+
+private:
+  struct Family {
+    std::string help;
+    MetricType type;
+    std::vector<double> bounds;
+    std::map<MetricLabels, std::unique_ptr<Counter>> counters;
+    std::map<MetricLabels, std::unique_ptr<Gauge>> gauges;
+    std::map<MetricLabels, std::unique_ptr<Histogram>> histograms;
+  };
+
+  Family& GetFamily(
+      const std::string& name, const std::string& help, MetricType type);
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Family> families_;
+  std::map<uint64_t, CollectorFn> collectors_;
+  uint64_t next_collector_id_{1};
+};
+
+/// \returns metrics in the Prometheus text exposition format
+KATANA_EXPORT std::string ToPrometheusText(
+    const std::vector<MetricFamily>& families);
+
+/// \returns metrics as the JSON encoding of an OpenTelemetry (OTLP)
+/// ExportMetricsServiceRequest from the service named service_name.
+/// Counters and histograms are cumulative since start_unix_ns.
+KATANA_EXPORT Result<std::string> ToOtlpJson(
+    const std::vector<MetricFamily>& families, const std::string& service_name,
+    uint64_t start_unix_ns);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_METRICSEXPORTER_H_
+#define KATANA_LIBSUPPORT_KATANA_METRICSEXPORTER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/Metrics.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A MetricsExporter sends collected metrics somewhere, e.g., to a file or a
+/// collector. Exporters are pushed to by a MetricsReporter; a
+/// PrometheusServer is scraped instead.
+class KATANA_EXPORT MetricsExporter {
+public:
+  virtual ~MetricsExporter();
+
+  virtual Result<void> Export(const std::vector<MetricFamily>& families) = 0;
+};
+
+/// Write metrics in the Prometheus text format to a file, replacing it
+/// atomically, as the textfile collector of the Prometheus node exporter
+/// expects
+class KATANA_EXPORT PrometheusFileExporter : public MetricsExporter {
+public:
+  explicit PrometheusFileExporter(std::string path) : path_(std::move(path)) {}
+
+  Result<void> Export(const std::vector<MetricFamily>& families) override;
+
+private:
+  std::string path_;
+};
+
+/// Post metrics to the OTLP/HTTP endpoint of an OpenTelemetry collector,
+/// e.g., http://localhost:4318/v1/metrics, in the JSON encoding
+class KATANA_EXPORT OtlpExporter : public MetricsExporter {
+public:
+  OtlpExporter(std::string endpoint, std::string service_name);
+
+  Result<void> Export(const std::vector<MetricFamily>& families) override;
+
+private:
+  std::string endpoint_;
+  std::string service_name_;
+  uint64_t start_unix_ns_;
+};
+
+/// Export the metrics of MetricsRegistry::Get() every interval from a
+/// background thread, and once more when destroyed. Export errors are
+/// logged rather than returned.
+class KATANA_EXPORT MetricsReporter {
+public:
+  MetricsReporter(
+      std::unique_ptr<MetricsExporter> exporter,
+      std::chrono::milliseconds interval);
+  ~MetricsReporter();
+
+  MetricsReporter(const MetricsReporter&) = delete;
+  MetricsReporter& operator=(const MetricsReporter&) = delete;
+
+  /// Export now
+  Result<void> Report();
+
+private:
+  void Run();
+
+  std::unique_ptr<MetricsExporter> exporter_;
+  std::chrono::milliseconds interval_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  std::thread thread_;
+};
+
+/// Serve the metrics of MetricsRegistry::Get() in the Prometheus text format
+/// to HTTP GET requests for /metrics, for Prometheus to scrape. Requests are
+/// served one at a time by a background thread.
+class KATANA_EXPORT PrometheusServer {
+public:
+  /// Listen on port of address. If port is 0, the system picks one; see
+  /// port().
+  static Result<std::unique_ptr<PrometheusServer>> Make(
+      uint16_t port = 0, const std::string& address = "0.0.0.0");
+  ~PrometheusServer();
+
+  PrometheusServer(const PrometheusServer&) = delete;
+  PrometheusServer& operator=(const PrometheusServer&) = delete;
+
+  uint16_t port() const { return port_; }
+
+private:
+  PrometheusServer(int socket_fd, uint16_t port);
+
+  void Run();
+
+  int socket_fd_;
+  uint16_t port_;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_PERFCOUNTERS_H_
+#define KATANA_LIBSUPPORT_KATANA_PERFCOUNTERS_H_
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Hardware counters of the threads of this process, read through the Linux
+/// perf_event interface without a PAPI build.
+///
+/// Counters are opened for each thread of the process the first time Read
+/// finds it and count user space events from then on. Events that the
+/// processor, the kernel or perf_event_paranoid do not allow are left out;
+/// on other systems, no event is available.
+class KATANA_EXPORT PerfCounters {
+public:
+  enum Event : size_t {
+    kCycles,
+    kLLCMisses,
+    kDTLBMisses,
+    /// loads served by another NUMA node
+    kRemoteNodeLoads,
+    kNumEvents,
+  };
+
+  /// the tag names of the events
+  static constexpr std::array<const char*, kNumEvents> kEventNames{
+      "cycles", "llc_misses", "dtlb_misses", "remote_node_loads"};
+
+  using Counts = std::array<uint64_t, kNumEvents>;
+
+  struct ThreadCounts {
+    int64_t tid;
+    Counts counts;
+  };
+
+  /// Counts by thread, ordered by tid
+  using Snapshot = std::vector<ThreadCounts>;
+
+  static PerfCounters& Get();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+  PerfCounters(PerfCounters&&) = delete;
+  PerfCounters& operator=(PerfCounters&&) = delete;
+  ~PerfCounters();
+
+  bool IsAvailable(Event event) const { return available_[event]; }
+  bool IsAnyAvailable() const;
+
+  /// Read the counters of all threads of the process; the values of
+  /// multiplexed counters are scaled to the time they were enabled
+  Snapshot Read();
+
+  /// \returns the counts of each thread in end minus those in begin;
+  /// threads absent from begin count from zero
+  static Snapshot Difference(const Snapshot& end, const Snapshot& begin);
+
+private:
+  PerfCounters();
+
+  std::mutex mutex_;
+  std::array<bool, kNumEvents> available_{};
+  /// perf_event file descriptors by thread; -1 if the event is unavailable
+  std::map<int64_t, std::array<int, kNumEvents>> fds_;
+};
+
+}  // namespace katana
+
+#endif
@@ -7,6 +7,7 @@
 #include <variant>
 #include <vector>
 
+#include "katana/PerfCounters.h"
 #include "katana/Result.h"
 #include "katana/config.h"
 
@@ -110,6 +111,9 @@ public:
   ProgressTracer& operator=(ProgressTracer&&) = delete;
 
   static ProgressTracer& Get() { return *tracer_; }
+  /// IsSet returns false before the first Set, e.g., in programs that
+  /// start only the GaloisRuntime rather than SharedMemSys or DistMemSys
+  static bool IsSet() { return tracer_ != nullptr; }
   static void Set(std::unique_ptr<ProgressTracer> tracer);
 
   static uint64_t ParseProcSelfRssBytes();
@@ -156,6 +160,17 @@ public:
   /// is created (in this case the program is probably not using tracing).
   virtual ProgressSpan& GetActiveSpan();
   bool HasActiveSpan() { return active_span_ != nullptr; }
+
+  /// SetCapturePerfCounters turns on or off attaching the hardware counters
+  /// of PerfCounters to the spans started from now on by StartActiveSpan.
+  /// On Finish, such a span is tagged with the counts of the process while
+  /// it was active, e.g., perf.cycles, and logs one "perf counters" message
+  /// with the counts of each thread. It is initially on if the environment
+  /// variable KATANA_TRACE_PERF_COUNTERS is true.
+  void SetCapturePerfCounters(bool capture) {
+    capture_perf_counters_ = capture;
+  }
+  bool capture_perf_counters() const { return capture_perf_counters_; }
   uint32_t GetHostID() const { return host_id_; }
   uint32_t GetNumHosts() const { return num_hosts_; }
 
@@ -167,12 +182,15 @@ public:
 
 protected:
   ProgressTracer(uint32_t host_id, uint32_t num_hosts)
-      : host_id_(host_id), num_hosts_(num_hosts) {}
+      : host_id_(host_id),
+        num_hosts_(num_hosts),
+        capture_perf_counters_(CapturePerfCountersFromEnv()) {}
 
 private:
   virtual std::shared_ptr<ProgressSpan> StartSpan(
       const std::string& span_name, std::shared_ptr<ProgressSpan> child_of) = 0;
   ProgressScope SetActiveSpan(std::shared_ptr<ProgressSpan> span);
+  static bool CapturePerfCountersFromEnv();
 
   /// Close flushes any buffered spans
   virtual void Close() = 0;
@@ -182,6 +200,7 @@ private:
   std::shared_ptr<ProgressSpan> active_span_ = nullptr;
   uint32_t host_id_;
   uint32_t num_hosts_;
+  bool capture_perf_counters_;
   std::shared_ptr<ProgressSpan> default_active_span_ = nullptr;
 };
 
@@ -262,6 +281,7 @@ public:
   virtual bool ScopeClosed();
   bool IsFinished() const { return finished_; }
   const std::shared_ptr<ProgressSpan>& GetParentSpan() { return parent_; }
+  void StartPerfCounters();
 
   /// Finish the ProgressSpan.
   ///
@@ -283,7 +303,11 @@ protected:
 private:
   virtual void Close() = 0;
 
+  void LogPerfCounters();
+
   std::shared_ptr<ProgressSpan> parent_ = nullptr;
+  /// counters when StartPerfCounters was called
+  std::unique_ptr<PerfCounters::Snapshot> perf_begin_;
   bool finished_ = false;
   bool scope_closed_ = false;
 };
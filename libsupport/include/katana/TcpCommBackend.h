@@ -0,0 +1,89 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_TCPCOMMBACKEND_H_
+#define KATANA_LIBSUPPORT_KATANA_TCPCOMMBACKEND_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A CommBackend over a TCP connection between every pair of tasks, for
+/// distributed jobs that do not run under MPI.
+///
+/// Small broadcasts and reductions go up and down a binomial tree. Large
+/// ones use the bandwidth optimal algorithms: a broadcast is a scatter
+/// followed by a ring allgather, and an allreduce is a ring reduce-scatter
+/// followed by a ring allgather, so no task sends much more than the buffer
+/// twice however many tasks there are. Allgatherv is a ring and AlltoAllv a
+/// sequence of pairwise exchanges.
+///
+/// The collectives that cannot return errors abort on connection failures,
+/// like the default error handler of MPI.
+class KATANA_EXPORT TcpCommBackend : public CommBackend {
+public:
+  using CommBackend::Allreduce;
+
+  /// Connect the num tasks of a job. Task 0 listens on root_address,
+  /// host:port, and the others connect to it to find each other.
+  static Result<std::unique_ptr<TcpCommBackend>> Make(
+      uint32_t num, uint32_t rank, const std::string& root_address);
+
+  /// Make from the environment: KATANA_COMM_NUM, KATANA_COMM_RANK and
+  /// KATANA_COMM_ROOT_ADDRESS
+  static Result<std::unique_ptr<TcpCommBackend>> MakeFromEnv();
+
+  ~TcpCommBackend() override;
+
+  void Barrier() override;
+  bool Broadcast(uint32_t root, bool val) override;
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override;
+  /// Close every connection, so the collectives of the other tasks fail
+  void NotifyFailure() override;
+
+  Result<void> Broadcast(uint32_t root, void* buf, uint64_t size) override;
+  Result<void> Allreduce(
+      void* buf, uint64_t count, CommDataType type, ReduceOp op) override;
+  Result<void> Allgatherv(
+      const void* send_buf, uint64_t send_bytes, void* recv_buf,
+      const std::vector<uint64_t>& recv_bytes) override;
+  Result<void> AlltoAllv(
+      const void* send_buf, const std::vector<uint64_t>& send_bytes,
+      void* recv_buf, const std::vector<uint64_t>& recv_bytes) override;
+
+private:
+  TcpCommBackend(
+      uint32_t num, uint32_t rank, uint32_t local_rank, std::vector<int> fds);
+
+  /// Send send_size bytes to task to while receiving recv_size bytes from
+  /// task from; either may be this task if its size is 0
+  Result<void> SendRecv(
+      uint32_t to, const void* send_buf, uint64_t send_size, uint32_t from,
+      void* recv_buf, uint64_t recv_size);
+  Result<void> Send(uint32_t to, const void* buf, uint64_t size) {
+    return SendRecv(to, buf, size, rank(), nullptr, 0);
+  }
+  Result<void> Recv(uint32_t from, void* buf, uint64_t size) {
+    return SendRecv(rank(), nullptr, 0, from, buf, size);
+  }
+
+  Result<void> BarrierImpl();
+  Result<void> TreeBroadcast(uint32_t root, void* buf, uint64_t size);
+  Result<void> RingBroadcast(uint32_t root, void* buf, uint64_t size);
+  Result<void> TreeAllreduce(
+      void* buf, uint64_t count, CommDataType type, ReduceOp op);
+  Result<void> RingAllreduce(
+      void* buf, uint64_t count, CommDataType type, ReduceOp op);
+
+  /// A connection to every task, -1 for this one
+  std::vector<int> fds_;
+};
+
+}  // namespace katana
+
+#endif
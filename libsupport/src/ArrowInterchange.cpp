@@ -1,5 +1,6 @@
 #include "katana/ArrowInterchange.h"
 
+#include <algorithm>
 #include <iostream>
 #include <iterator>
 #include <sstream>
@@ -73,6 +74,43 @@ katana::MakeEmptyArrowTable() {
       arrow::schema({}), std::vector<std::shared_ptr<arrow::ChunkedArray>>());
 }
 
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::UnchunkedArray(const std::shared_ptr<arrow::ChunkedArray>& array) {
+  if (array->num_chunks() == 1) {
+    return array->chunk(0);
+  }
+  if (array->num_chunks() == 0) {
+    return KATANA_CHECKED(arrow::MakeArrayOfNull(array->type(), 0));
+  }
+  return KATANA_CHECKED(arrow::Concatenate(array->chunks()));
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::MutableValuesArray(const std::shared_ptr<arrow::ChunkedArray>& array) {
+  arrow::ArrayVector chunks;
+  bool copied = false;
+  for (const auto& chunk : array->chunks()) {
+    const auto& buffers = chunk->data()->buffers;
+    if (buffers.size() <= 1 || !buffers[1] || buffers[1]->is_mutable()) {
+      chunks.emplace_back(chunk);
+      continue;
+    }
+    std::shared_ptr<arrow::Buffer> values =
+        KATANA_CHECKED(arrow::AllocateBuffer(buffers[1]->size()));
+    std::copy(
+        buffers[1]->data(), buffers[1]->data() + buffers[1]->size(),
+        values->mutable_data());
+    std::shared_ptr<arrow::ArrayData> data = chunk->data()->Copy();
+    data->buffers[1] = std::move(values);
+    chunks.emplace_back(arrow::MakeArray(data));
+    copied = true;
+  }
+  if (!copied) {
+    return array;
+  }
+  return KATANA_CHECKED(arrow::ChunkedArray::Make(chunks, array->type()));
+}
+
 void
 katana::DiffFormatTo(
     fmt::memory_buffer& buf, const std::shared_ptr<arrow::ChunkedArray>& a0,
@@ -0,0 +1,679 @@
+#include "katana/BinaryTracer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/Random.h"
+
+// A trace is a header followed by records. The header is kMagic, the host id
+// and number of hosts as uint32_t, and the wall clock time the tracer was
+// made at, in microseconds since the epoch, as uint64_t. Every record begins
+// with its size in bytes, including the size, as uint32_t, its RecordKind,
+// the index of the thread that wrote it as uint32_t, its time in nanoseconds
+// since the tracer was made as uint64_t and the id of its span as uint64_t.
+// The rest of a record depends on its kind:
+//
+//     kStart: trace id, parent span id or 0, span name
+//     kFinish: nothing
+//     kLog: message, tags
+//     kTags: tags
+//
+// Strings are their size as uint32_t followed by their bytes. Tags are their
+// number as uint32_t followed by, for each tag, its name, a ValueKind and
+// its value.
+
+namespace {
+
+constexpr char kMagic[8] = {'K', 'T', 'R', 'A', 'C', 'E', '0', '1'};
+constexpr size_t kHeaderSize = sizeof(kMagic) + 2 * sizeof(uint32_t) +
+                               sizeof(uint64_t);
+constexpr size_t kRecordHeaderSize = sizeof(uint32_t) + sizeof(uint8_t) +
+                                     sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+enum class RecordKind : uint8_t {
+  kStart = 1,
+  kFinish,
+  kLog,
+  kTags,
+};
+
+enum class ValueKind : uint8_t {
+  kBool = 1,
+  kInt64,
+  kUint64,
+  kDouble,
+  kString,
+};
+
+class Encoder {
+public:
+  explicit Encoder(std::string* buf) : buf_(buf) {}
+
+  template <typename T>
+  void Put(T value) {
+    buf_->append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  void PutString(const std::string& str) {
+    Put(static_cast<uint32_t>(str.size()));
+    buf_->append(str);
+  }
+
+  void PutTags(const katana::Tags& tags) {
+    Put(static_cast<uint32_t>(tags.size()));
+    for (const auto& [name, value] : tags) {
+      PutString(name);
+      if (std::holds_alternative<bool>(value)) {
+        Put(ValueKind::kBool);
+        Put(static_cast<uint8_t>(std::get<bool>(value)));
+      } else if (std::holds_alternative<int64_t>(value)) {
+        Put(ValueKind::kInt64);
+        Put(std::get<int64_t>(value));
+      } else if (std::holds_alternative<uint64_t>(value)) {
+        Put(ValueKind::kUint64);
+        Put(std::get<uint64_t>(value));
+      } else if (std::holds_alternative<double>(value)) {
+        Put(ValueKind::kDouble);
+        Put(std::get<double>(value));
+      } else if (std::holds_alternative<std::string>(value)) {
+        Put(ValueKind::kString);
+        PutString(std::get<std::string>(value));
+      } else {
+        Put(ValueKind::kString);
+        PutString(katana::ProgressTracer::GetValue(value));
+      }
+    }
+  }
+
+private:
+  std::string* buf_;
+};
+
+class Decoder {
+public:
+  Decoder(const std::string& buf, size_t begin, size_t end)
+      : buf_(buf), pos_(begin), end_(end) {}
+
+  template <typename T>
+  katana::Result<T> Get() {
+    if (end_ - pos_ < sizeof(T)) {
+      return Truncated();
+    }
+    T value;
+    std::memcpy(&value, buf_.data() + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return value;
+  }
+
+  katana::Result<std::string> GetString() {
+    auto size = KATANA_CHECKED(Get<uint32_t>());
+    if (end_ - pos_ < size) {
+      return Truncated();
+    }
+    std::string str = buf_.substr(pos_, size);
+    pos_ += size;
+    return str;
+  }
+
+  katana::Result<void> GetTags(nlohmann::json* args) {
+    auto num_tags = KATANA_CHECKED(Get<uint32_t>());
+    for (uint32_t i = 0; i < num_tags; ++i) {
+      auto name = KATANA_CHECKED(GetString());
+      auto kind = KATANA_CHECKED(Get<ValueKind>());
+      switch (kind) {
+      case ValueKind::kBool:
+        (*args)[name] = KATANA_CHECKED(Get<uint8_t>()) != 0;
+        break;
+      case ValueKind::kInt64:
+        (*args)[name] = KATANA_CHECKED(Get<int64_t>());
+        break;
+      case ValueKind::kUint64:
+        (*args)[name] = KATANA_CHECKED(Get<uint64_t>());
+        break;
+      case ValueKind::kDouble:
+        (*args)[name] = KATANA_CHECKED(Get<double>());
+        break;
+      case ValueKind::kString:
+        (*args)[name] = KATANA_CHECKED(GetString());
+        break;
+      default:
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "unknown tag value kind {} at byte {}", static_cast<int>(kind),
+            pos_);
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
+private:
+  katana::ErrorInfo Truncated() const {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "trace truncated at byte {}",
+        pos_);
+  }
+
+  const std::string& buf_;
+  size_t pos_;
+  size_t end_;
+};
+
+/// A ring buffer of bytes with one producer and one consumer
+class RingBuffer {
+public:
+  /// capacity must be a power of two
+  explicit RingBuffer(size_t capacity) : data_(capacity) {}
+
+  /// \returns false, without pushing anything, if size bytes do not fit
+  bool Push(const char* bytes, size_t size) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    if (size > data_.size() - (head - tail)) {
+      return false;
+    }
+    size_t begin = head & (data_.size() - 1);
+    size_t first = std::min(size, data_.size() - begin);
+    std::memcpy(&data_[begin], bytes, first);
+    std::memcpy(&data_[0], bytes + first, size - first);
+    head_.store(head + size, std::memory_order_release);
+    return true;
+  }
+
+  /// Move the pushed bytes to the end of out
+  void Drain(std::string* out) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    size_t size = head - tail;
+    size_t begin = tail & (data_.size() - 1);
+    size_t first = std::min(size, data_.size() - begin);
+    out->append(&data_[begin], first);
+    out->append(&data_[0], size - first);
+    tail_.store(head, std::memory_order_release);
+  }
+
+private:
+  std::vector<char> data_;
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+};
+
+struct ThreadBuffer {
+  ThreadBuffer(std::thread::id thread_, uint32_t tid_, size_t capacity)
+      : thread(thread_), tid(tid_), ring(capacity) {}
+
+  std::thread::id thread;
+  uint32_t tid;
+  RingBuffer ring;
+};
+
+/// The buffer of this thread and the BinaryTraceState it belongs to
+struct CachedBuffer {
+  uint64_t state_id{};
+  ThreadBuffer* buffer{};
+};
+
+thread_local CachedBuffer cached_buffer;
+
+std::atomic<uint64_t> next_state_id{1};
+
+size_t
+RoundUpToPowerOfTwo(size_t n) {
+  size_t power = 1;
+  while (power < n) {
+    power <<= 1;
+  }
+  return power;
+}
+
+std::string
+FormatID(uint64_t id) {
+  return fmt::format("0x{:x}", id);
+}
+
+}  // namespace
+
+/// The buffers and flusher thread of a BinaryTracer, shared with its spans,
+/// which may outlive it
+class katana::BinaryTraceState {
+public:
+  BinaryTraceState(
+      uint32_t host_id, uint32_t num_hosts, BinaryTracer::OutputCB out_callback,
+      const BinaryTracer::Options& options)
+      : out_callback_(std::move(out_callback)),
+        buffer_bytes_(RoundUpToPowerOfTwo(options.buffer_bytes)),
+        flush_interval_(options.flush_interval) {
+    std::uniform_int_distribution<uint64_t> dist(
+        1, std::numeric_limits<uint32_t>::max());
+    // Ids of different tracers, e.g., of different hosts, rarely collide
+    next_id_ = dist(katana::GetGenerator()) << 32;
+
+    auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+    auto start_unix_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(since_epoch)
+            .count();
+    std::string header(kMagic, sizeof(kMagic));
+    Encoder enc(&header);
+    enc.Put(host_id);
+    enc.Put(num_hosts);
+    enc.Put(static_cast<uint64_t>(start_unix_us));
+    out_callback_(header);
+
+    flusher_ = std::thread([this] { Run(); });
+  }
+
+  ~BinaryTraceState() {
+    {
+      std::lock_guard<std::mutex> lock(stop_mutex_);
+      stop_ = true;
+    }
+    stop_cv_.notify_one();
+    flusher_.join();
+    Flush();
+
+    if (uint64_t dropped = dropped_records(); dropped > 0) {
+      KATANA_LOG_WARN(
+          "binary tracer dropped {} records because a buffer was full; "
+          "consider increasing buffer_bytes",
+          dropped);
+    }
+  }
+
+  BinaryTraceState(const BinaryTraceState&) = delete;
+  BinaryTraceState& operator=(const BinaryTraceState&) = delete;
+
+  uint64_t NewID() { return next_id_.fetch_add(1, std::memory_order_relaxed); }
+
+  /// Append a record to the buffer of this thread. fill encodes the part of
+  /// the record that depends on its kind.
+  template <typename F>
+  void Record(RecordKind kind, uint64_t span_id, const F& fill) {
+    // Reused so that recording does not allocate once the scratch space has
+    // grown to the largest record
+    thread_local std::string scratch;
+
+    ThreadBuffer* buffer = GetThreadBuffer();
+    std::chrono::nanoseconds now = std::chrono::steady_clock::now() - start_;
+
+    scratch.clear();
+    Encoder enc(&scratch);
+    enc.Put(uint32_t{0});
+    enc.Put(kind);
+    enc.Put(buffer->tid);
+    enc.Put(static_cast<uint64_t>(now.count()));
+    enc.Put(span_id);
+    fill(&enc);
+    auto size = static_cast<uint32_t>(scratch.size());
+    std::memcpy(scratch.data(), &size, sizeof(size));
+
+    if (!buffer->ring.Push(scratch.data(), scratch.size())) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /// Drain the buffers to the output
+  void Flush() {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+    std::vector<ThreadBuffer*> buffers;
+    {
+      std::lock_guard<std::mutex> lock(buffers_mutex_);
+      for (const auto& buffer : buffers_) {
+        buffers.emplace_back(buffer.get());
+      }
+    }
+    std::string out;
+    for (ThreadBuffer* buffer : buffers) {
+      buffer->ring.Drain(&out);
+    }
+    if (!out.empty()) {
+      out_callback_(out);
+    }
+  }
+
+  uint64_t dropped_records() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  ThreadBuffer* GetThreadBuffer() {
+    if (cached_buffer.state_id == id_) {
+      return cached_buffer.buffer;
+    }
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    auto self = std::this_thread::get_id();
+    auto it = std::find_if(
+        buffers_.begin(), buffers_.end(),
+        [&](const auto& buffer) { return buffer->thread == self; });
+    if (it == buffers_.end()) {
+      buffers_.emplace_back(
+          std::make_unique<ThreadBuffer>(self, buffers_.size(), buffer_bytes_));
+      it = buffers_.end() - 1;
+    }
+    cached_buffer = CachedBuffer{id_, it->get()};
+    return it->get();
+  }
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    while (!stop_) {
+      stop_cv_.wait_for(lock, flush_interval_, [this] { return stop_; });
+      lock.unlock();
+      Flush();
+      lock.lock();
+    }
+  }
+
+  const uint64_t id_{next_state_id.fetch_add(1)};
+  const std::chrono::steady_clock::time_point start_{
+      std::chrono::steady_clock::now()};
+  BinaryTracer::OutputCB out_callback_;
+  size_t buffer_bytes_;
+  std::chrono::milliseconds flush_interval_;
+  std::atomic<uint64_t> next_id_;
+  std::atomic<uint64_t> dropped_{0};
+
+  /// Buffers are never removed, so pointers to them stay valid
+  std::mutex buffers_mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+
+  /// Serializes draining the buffers and calling out_callback_
+  std::mutex flush_mutex_;
+
+  std::mutex stop_mutex_;
+  std::condition_variable stop_cv_;
+  bool stop_{false};
+  std::thread flusher_;
+};
+
+katana::Result<std::unique_ptr<katana::BinaryTracer>>
+katana::BinaryTracer::Make(
+    const std::string& path, uint32_t host_id, uint32_t num_hosts,
+    const Options& options) {
+  auto out = std::make_shared<std::ofstream>(
+      path, std::ios_base::binary | std::ios_base::trunc);
+  if (!*out) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "opening {}: {}", path,
+        std::strerror(errno));
+  }
+  return Make(
+      host_id, num_hosts,
+      [out](const std::string& output) {
+        out->write(output.data(), output.size());
+        out->flush();
+      },
+      options);
+}
+
+std::unique_ptr<katana::BinaryTracer>
+katana::BinaryTracer::Make(
+    uint32_t host_id, uint32_t num_hosts, OutputCB out_callback,
+    const Options& options) {
+  return std::unique_ptr<BinaryTracer>(
+      new BinaryTracer(host_id, num_hosts, std::move(out_callback), options));
+}
+
+katana::BinaryTracer::BinaryTracer(
+    uint32_t host_id, uint32_t num_hosts, OutputCB out_callback,
+    const Options& options)
+    : ProgressTracer(host_id, num_hosts),
+      state_(std::make_shared<BinaryTraceState>(
+          host_id, num_hosts, std::move(out_callback), options)) {}
+
+katana::BinaryTracer::~BinaryTracer() = default;
+
+std::shared_ptr<katana::ProgressSpan>
+katana::BinaryTracer::StartSpan(
+    const std::string& span_name, const katana::ProgressContext& child_of) {
+  uint64_t trace_id = 0;
+  uint64_t parent_id = 0;
+  if (const auto* ctx = dynamic_cast<const BinaryContext*>(&child_of); ctx) {
+    trace_id = ctx->trace_id_;
+    parent_id = ctx->span_id_;
+  }
+  return std::shared_ptr<BinarySpan>(
+      new BinarySpan(state_, span_name, nullptr, trace_id, parent_id));
+}
+
+std::shared_ptr<katana::ProgressSpan>
+katana::BinaryTracer::StartSpan(
+    const std::string& span_name,
+    std::shared_ptr<katana::ProgressSpan> child_of) {
+  uint64_t trace_id = 0;
+  uint64_t parent_id = 0;
+  if (child_of != nullptr) {
+    const auto& ctx = static_cast<const BinaryContext&>(child_of->GetContext());
+    trace_id = ctx.trace_id_;
+    parent_id = ctx.span_id_;
+  }
+  return std::shared_ptr<BinarySpan>(new BinarySpan(
+      state_, span_name, std::move(child_of), trace_id, parent_id));
+}
+
+std::string
+katana::BinaryTracer::Inject(const katana::ProgressContext& ctx) {
+  return ctx.GetTraceID() + "," + ctx.GetSpanID();
+}
+
+std::unique_ptr<katana::ProgressContext>
+katana::BinaryTracer::Extract(const std::string& carrier) {
+  size_t split = carrier.find(',');
+  if (split == std::string::npos) {
+    return nullptr;
+  }
+  auto parse = [](const std::string& str, uint64_t* id) {
+    char* end = nullptr;
+    *id = std::strtoull(str.c_str(), &end, 16);
+    return !str.empty() && *end == '\0';
+  };
+  uint64_t trace_id = 0;
+  uint64_t span_id = 0;
+  if (!parse(carrier.substr(0, split), &trace_id) ||
+      !parse(carrier.substr(split + 1), &span_id)) {
+    return nullptr;
+  }
+  return std::unique_ptr<BinaryContext>(new BinaryContext(trace_id, span_id));
+}
+
+uint64_t
+katana::BinaryTracer::dropped_records() const {
+  return state_->dropped_records();
+}
+
+void
+katana::BinaryTracer::Close() {
+  state_->Flush();
+}
+
+katana::Result<std::string>
+katana::BinaryTracer::ToChromeTrace(const std::string& trace) {
+  if (trace.size() < kHeaderSize ||
+      std::memcmp(trace.data(), kMagic, sizeof(kMagic)) != 0) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "not a binary trace");
+  }
+  Decoder header(trace, sizeof(kMagic), kHeaderSize);
+  auto host_id = KATANA_CHECKED(header.Get<uint32_t>());
+  auto num_hosts = KATANA_CHECKED(header.Get<uint32_t>());
+  auto start_unix_us = KATANA_CHECKED(header.Get<uint64_t>());
+
+  struct Span {
+    std::string name{"unknown span"};
+    uint32_t tid{};
+    uint64_t begin_ns{};
+    uint64_t end_ns{};
+    bool finished{false};
+    nlohmann::json args = nlohmann::json::object();
+  };
+  // The start of a span may have been dropped or, if another thread tagged
+  // it, come after its other records
+  std::map<uint64_t, Span> spans;
+  auto get_span = [&](uint64_t span_id, uint32_t tid, uint64_t ts) -> Span& {
+    auto [it, inserted] = spans.try_emplace(span_id);
+    if (inserted) {
+      it->second.tid = tid;
+      it->second.begin_ns = ts;
+      it->second.args["span_id"] = FormatID(span_id);
+    }
+    return it->second;
+  };
+
+  nlohmann::json events = nlohmann::json::array();
+  uint64_t last_ns = 0;
+  for (size_t pos = kHeaderSize; pos < trace.size();) {
+    Decoder size_decoder(trace, pos, trace.size());
+    auto size = KATANA_CHECKED(size_decoder.Get<uint32_t>());
+    if (size < kRecordHeaderSize || size > trace.size() - pos) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "bad record size {} at byte {}", size,
+          pos);
+    }
+    Decoder record(trace, pos + sizeof(size), pos + size);
+    pos += size;
+
+    auto kind = KATANA_CHECKED(record.Get<RecordKind>());
+    auto tid = KATANA_CHECKED(record.Get<uint32_t>());
+    auto ts = KATANA_CHECKED(record.Get<uint64_t>());
+    auto span_id = KATANA_CHECKED(record.Get<uint64_t>());
+    last_ns = std::max(last_ns, ts);
+
+    switch (kind) {
+    case RecordKind::kStart: {
+      Span& span = get_span(span_id, tid, ts);
+      auto trace_id = KATANA_CHECKED(record.Get<uint64_t>());
+      auto parent_id = KATANA_CHECKED(record.Get<uint64_t>());
+      span.name = KATANA_CHECKED(record.GetString());
+      span.tid = tid;
+      span.begin_ns = ts;
+      span.args["trace_id"] = FormatID(trace_id);
+      if (parent_id != 0) {
+        span.args["parent_id"] = FormatID(parent_id);
+      }
+      break;
+    }
+    case RecordKind::kFinish: {
+      Span& span = get_span(span_id, tid, ts);
+      span.end_ns = ts;
+      span.finished = true;
+      break;
+    }
+    case RecordKind::kTags:
+      KATANA_CHECKED(record.GetTags(&get_span(span_id, tid, ts).args));
+      break;
+    case RecordKind::kLog: {
+      nlohmann::json args = nlohmann::json::object();
+      auto message = KATANA_CHECKED(record.GetString());
+      KATANA_CHECKED(record.GetTags(&args));
+      args["span_id"] = FormatID(span_id);
+      events.push_back({
+          {"name", message},
+          {"ph", "i"},
+          {"s", "t"},
+          {"ts", ts / 1000.0},
+          {"pid", host_id},
+          {"tid", tid},
+          {"args", args},
+      });
+      break;
+    }
+    default:
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "unknown record kind {} at byte {}",
+          static_cast<int>(kind), pos - size);
+    }
+  }
+
+  for (auto& [span_id, span] : spans) {
+    if (!span.finished) {
+      span.end_ns = last_ns;
+      span.args["unfinished"] = true;
+    }
+    uint64_t dur_ns = span.end_ns - span.begin_ns;
+    events.push_back({
+        {"name", span.name},
+        {"cat", "katana"},
+        {"ph", "X"},
+        {"ts", span.begin_ns / 1000.0},
+        {"dur", dur_ns / 1000.0},
+        {"pid", host_id},
+        {"tid", span.tid},
+        {"args", std::move(span.args)},
+    });
+  }
+
+  nlohmann::json chrome_trace = {
+      {"traceEvents", std::move(events)},
+      {"displayTimeUnit", "ns"},
+      {"otherData",
+       {
+           {"host", host_id},
+           {"num_hosts", num_hosts},
+           {"start_unix_us", start_unix_us},
+       }},
+  };
+  return KATANA_CHECKED(JsonDump(chrome_trace));
+}
+
+std::unique_ptr<katana::ProgressContext>
+katana::BinaryContext::Clone() const noexcept {
+  return std::unique_ptr<BinaryContext>(
+      new BinaryContext(trace_id_, span_id_));
+}
+
+std::string
+katana::BinaryContext::GetTraceID() const noexcept {
+  return FormatID(trace_id_);
+}
+
+std::string
+katana::BinaryContext::GetSpanID() const noexcept {
+  return FormatID(span_id_);
+}
+
+katana::BinarySpan::BinarySpan(
+    std::shared_ptr<BinaryTraceState> state, const std::string& span_name,
+    std::shared_ptr<ProgressSpan> parent, uint64_t trace_id,
+    uint64_t parent_id)
+    : ProgressSpan(std::move(parent)),
+      state_(std::move(state)),
+      context_(trace_id, state_->NewID()) {
+  if (context_.trace_id_ == 0) {
+    context_.trace_id_ = context_.span_id_;
+  }
+  state_->Record(RecordKind::kStart, context_.span_id_, [&](Encoder* enc) {
+    enc->Put(context_.trace_id_);
+    enc->Put(parent_id);
+    enc->PutString(span_name);
+  });
+}
+
+void
+katana::BinarySpan::SetTags(const katana::Tags& tags) {
+  state_->Record(RecordKind::kTags, context_.span_id_, [&](Encoder* enc) {
+    enc->PutTags(tags);
+  });
+}
+
+void
+katana::BinarySpan::Log(const std::string& message, const katana::Tags& tags) {
+  state_->Record(RecordKind::kLog, context_.span_id_, [&](Encoder* enc) {
+    enc->PutString(message);
+    enc->PutTags(tags);
+  });
+}
+
+void
+katana::BinarySpan::Close() {
+  state_->Record(RecordKind::kFinish, context_.span_id_, [](Encoder*) {});
+}
@@ -1,8 +1,274 @@
 #include "katana/CommBackend.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include "katana/ErrorCode.h"
+
+namespace {
+
+template <typename T>
+void
+ReduceTyped(T* into, const T* from, uint64_t count, katana::ReduceOp op) {
+  for (uint64_t i = 0; i < count; ++i) {
+    switch (op) {
+    case katana::ReduceOp::kSum:
+      into[i] += from[i];
+      break;
+    case katana::ReduceOp::kMin:
+      into[i] = std::min(into[i], from[i]);
+      break;
+    case katana::ReduceOp::kMax:
+      into[i] = std::max(into[i], from[i]);
+      break;
+    case katana::ReduceOp::kBitOr:
+      if constexpr (std::is_integral_v<T>) {
+        into[i] |= from[i];
+      }
+      break;
+    case katana::ReduceOp::kBitAnd:
+      if constexpr (std::is_integral_v<T>) {
+        into[i] &= from[i];
+      }
+      break;
+    }
+  }
+}
+
+}  // namespace
+
+uint64_t
+katana::CommDataTypeSize(CommDataType type) {
+  switch (type) {
+  case CommDataType::kInt8:
+  case CommDataType::kUInt8:
+    return 1;
+  case CommDataType::kInt32:
+  case CommDataType::kUInt32:
+  case CommDataType::kFloat:
+    return 4;
+  case CommDataType::kInt64:
+  case CommDataType::kUInt64:
+  case CommDataType::kDouble:
+    return 8;
+  }
+  KATANA_LOG_FATAL("unknown comm data type");
+}
+
 // Anchor vtables
 
 katana::CommBackend::~CommBackend() = default;
 
+katana::Result<void>
+katana::CommBackend::CheckReduce(CommDataType type, ReduceOp op) {
+  bool bitwise = op == ReduceOp::kBitOr || op == ReduceOp::kBitAnd;
+  bool floating = type == CommDataType::kFloat || type == CommDataType::kDouble;
+  if (bitwise && floating) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "bitwise reductions are only for integer types");
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::CommBackend::Reduce(
+    void* into, const void* from, uint64_t count, CommDataType type,
+    ReduceOp op) {
+  switch (type) {
+  case CommDataType::kInt8:
+    ReduceTyped(
+        static_cast<int8_t*>(into), static_cast<const int8_t*>(from), count,
+        op);
+    break;
+  case CommDataType::kUInt8:
+    ReduceTyped(
+        static_cast<uint8_t*>(into), static_cast<const uint8_t*>(from), count,
+        op);
+    break;
+  case CommDataType::kInt32:
+    ReduceTyped(
+        static_cast<int32_t*>(into), static_cast<const int32_t*>(from), count,
+        op);
+    break;
+  case CommDataType::kUInt32:
+    ReduceTyped(
+        static_cast<uint32_t*>(into), static_cast<const uint32_t*>(from),
+        count, op);
+    break;
+  case CommDataType::kInt64:
+    ReduceTyped(
+        static_cast<int64_t*>(into), static_cast<const int64_t*>(from), count,
+        op);
+    break;
+  case CommDataType::kUInt64:
+    ReduceTyped(
+        static_cast<uint64_t*>(into), static_cast<const uint64_t*>(from),
+        count, op);
+    break;
+  case CommDataType::kFloat:
+    ReduceTyped(
+        static_cast<float*>(into), static_cast<const float*>(from), count,
+        op);
+    break;
+  case CommDataType::kDouble:
+    ReduceTyped(
+        static_cast<double*>(into), static_cast<const double*>(from), count,
+        op);
+    break;
+  }
+}
+
+katana::Result<std::vector<uint64_t>>
+katana::CommBackend::Displacements(const std::vector<uint64_t>& sizes) const {
+  if (sizes.size() != num()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected {} sizes, one per task, got {}",
+        num(), sizes.size());
+  }
+  std::vector<uint64_t> displacements(num() + 1, 0);
+  for (uint32_t i = 0; i < num(); ++i) {
+    displacements[i + 1] = displacements[i] + sizes[i];
+  }
+  return displacements;
+}
+
+katana::Result<void>
+katana::CommBackend::Broadcast(uint32_t root, void* buf, uint64_t size) {
+  std::string val;
+  if (rank() == root) {
+    val.assign(static_cast<const char*>(buf), size);
+  }
+  val = Broadcast(root, val, size);
+  if (val.size() != size) {
+    return KATANA_ERROR(
+        ErrorCode::MpiError, "broadcast got {} bytes, expected {}", val.size(),
+        size);
+  }
+  if (size > 0) {
+    std::memcpy(buf, val.data(), size);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::CommBackend::Allreduce(
+    void* buf, uint64_t count, CommDataType type, ReduceOp op) {
+  KATANA_CHECKED(CheckReduce(type, op));
+  if (count == 0) {
+    return katana::ResultSuccess();
+  }
+  uint64_t bytes = count * CommDataTypeSize(type);
+  std::vector<uint8_t> all(bytes * num());
+  KATANA_CHECKED(Allgatherv(
+      buf, bytes, all.data(), std::vector<uint64_t>(num(), bytes)));
+  // Reduce in rank order so that every task gets the same result
+  std::memcpy(buf, all.data(), bytes);
+  for (uint32_t i = 1; i < num(); ++i) {
+    Reduce(buf, all.data() + i * bytes, count, type, op);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::CommBackend::Allgatherv(
+    const void* send_buf, uint64_t send_bytes, void* recv_buf,
+    const std::vector<uint64_t>& recv_bytes) {
+  std::vector<uint64_t> displacements =
+      KATANA_CHECKED(Displacements(recv_bytes));
+  if (recv_bytes[rank()] != send_bytes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "sending {} bytes but {} are expected",
+        send_bytes, recv_bytes[rank()]);
+  }
+  auto* recv = static_cast<uint8_t*>(recv_buf);
+  if (send_bytes > 0) {
+    std::memcpy(recv + displacements[rank()], send_buf, send_bytes);
+  }
+  for (uint32_t i = 0; i < num(); ++i) {
+    KATANA_CHECKED(Broadcast(i, recv + displacements[i], recv_bytes[i]));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::CommBackend::AlltoAllv(
+    const void* send_buf, const std::vector<uint64_t>& send_bytes,
+    void* recv_buf, const std::vector<uint64_t>& recv_bytes) {
+  std::vector<uint64_t> send_displacements =
+      KATANA_CHECKED(Displacements(send_bytes));
+  std::vector<uint64_t> recv_displacements =
+      KATANA_CHECKED(Displacements(recv_bytes));
+
+  // Everyone gets everything and keeps its parts
+  std::vector<uint64_t> all_send_bytes(num() * num());
+  KATANA_CHECKED(Allgatherv(
+      send_bytes.data(), num() * sizeof(uint64_t), all_send_bytes.data(),
+      std::vector<uint64_t>(num(), num() * sizeof(uint64_t))));
+  std::vector<uint64_t> totals(num());
+  for (uint32_t i = 0; i < num(); ++i) {
+    for (uint32_t j = 0; j < num(); ++j) {
+      totals[i] += all_send_bytes[i * num() + j];
+    }
+  }
+  std::vector<uint64_t> all_displacements =
+      KATANA_CHECKED(Displacements(totals));
+  std::vector<uint8_t> all(all_displacements.back());
+  KATANA_CHECKED(Allgatherv(
+      send_buf, send_displacements.back(), all.data(), totals));
+
+  auto* recv = static_cast<uint8_t*>(recv_buf);
+  for (uint32_t i = 0; i < num(); ++i) {
+    uint64_t offset = all_displacements[i];
+    for (uint32_t j = 0; j < rank(); ++j) {
+      offset += all_send_bytes[i * num() + j];
+    }
+    uint64_t size = all_send_bytes[i * num() + rank()];
+    if (size != recv_bytes[i]) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "task {} sends {} bytes but {} are expected", i, size,
+          recv_bytes[i]);
+    }
+    if (size > 0) {
+      std::memcpy(recv + recv_displacements[i], all.data() + offset, size);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 void
 katana::NullCommBackend::NotifyFailure() {}
+
+katana::Result<void>
+katana::NullCommBackend::Allgatherv(
+    const void* send_buf, uint64_t send_bytes, void* recv_buf,
+    const std::vector<uint64_t>& recv_bytes) {
+  KATANA_CHECKED(Displacements(recv_bytes));
+  if (recv_bytes[0] != send_bytes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "sending {} bytes but {} are expected",
+        send_bytes, recv_bytes[0]);
+  }
+  if (send_bytes > 0) {
+    std::memcpy(recv_buf, send_buf, send_bytes);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::NullCommBackend::AlltoAllv(
+    const void* send_buf, const std::vector<uint64_t>& send_bytes,
+    void* recv_buf, const std::vector<uint64_t>& recv_bytes) {
+  KATANA_CHECKED(Displacements(send_bytes));
+  KATANA_CHECKED(Displacements(recv_bytes));
+  if (recv_bytes[0] != send_bytes[0]) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "sending {} bytes but {} are expected",
+        send_bytes[0], recv_bytes[0]);
+  }
+  if (send_bytes[0] > 0) {
+    std::memcpy(recv_buf, send_buf, send_bytes[0]);
+  }
+  return katana::ResultSuccess();
+}
@@ -1,5 +1,8 @@
 #include "katana/JSON.h"
 
+#include <cstdint>
+#include <vector>
+
 katana::Result<std::string>
 katana::JsonDump(const nlohmann::json& obj) {
   try {
@@ -21,3 +24,17 @@ katana::JsonDump(const nlohmann::ordered_json& obj) {
         "nlohmann::ordered_json::dump exception: {}", exp.what());
   }
 }
+
+katana::Result<std::string>
+katana::JsonDumpBinary(const nlohmann::json& obj) {
+  try {
+    std::vector<uint8_t> packed = nlohmann::json::to_msgpack(obj);
+    std::string out(kJsonBinaryMagic);
+    out.append(packed.begin(), packed.end());
+    return out;
+  } catch (const std::exception& exp) {
+    return KATANA_ERROR(
+        katana::ErrorCode::JSONDumpFailed,
+        "nlohmann::json::to_msgpack exception: {}", exp.what());
+  }
+}
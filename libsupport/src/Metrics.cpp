@@ -0,0 +1,356 @@
+#include "katana/Metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+
+namespace {
+
+const char*
+TypeName(katana::MetricType type) {
+  switch (type) {
+  case katana::MetricType::kCounter:
+    return "counter";
+  case katana::MetricType::kGauge:
+    return "gauge";
+  case katana::MetricType::kHistogram:
+    return "histogram";
+  }
+  return "untyped";
+}
+
+/// Format a value the way Prometheus expects, e.g., +Inf and integers
+/// without a fraction
+std::string
+FormatValue(double value) {
+  if (std::isinf(value)) {
+    return value > 0 ? "+Inf" : "-Inf";
+  }
+  if (std::isnan(value)) {
+    return "NaN";
+  }
+  // The shortest representation that round trips
+  return fmt::format("{}", value);
+}
+
+void
+EscapeLabelValue(const std::string& value, std::ostringstream& out) {
+  for (char c : value) {
+    switch (c) {
+    case '\\':
+      out << "\\\\";
+      break;
+    case '"':
+      out << "\\\"";
+      break;
+    case '\n':
+      out << "\\n";
+      break;
+    default:
+      out << c;
+    }
+  }
+}
+
+void
+WriteLabels(
+    const katana::MetricLabels& labels, const std::string& extra_name,
+    const std::string& extra_value, std::ostringstream& out) {
+  if (labels.empty() && extra_name.empty()) {
+    return;
+  }
+  out << "{";
+  bool first = true;
+  for (const auto& [name, value] : labels) {
+    out << (first ? "" : ",") << name << "=\"";
+    EscapeLabelValue(value, out);
+    out << "\"";
+    first = false;
+  }
+  if (!extra_name.empty()) {
+    out << (first ? "" : ",") << extra_name << "=\"" << extra_value << "\"";
+  }
+  out << "}";
+}
+
+nlohmann::json
+OtlpAttributes(const katana::MetricLabels& labels) {
+  nlohmann::json attributes = nlohmann::json::array();
+  for (const auto& [name, value] : labels) {
+    attributes.push_back({{"key", name}, {"value", {{"stringValue", value}}}});
+  }
+  return attributes;
+}
+
+}  // namespace
+
+katana::Histogram::Histogram(std::vector<double> bounds)
+    : bounds_(std::move(bounds)),
+      counts_(new std::atomic<uint64_t>[bounds_.size() + 1]) {
+  KATANA_LOG_DEBUG_ASSERT(std::is_sorted(bounds_.begin(), bounds_.end()));
+  for (size_t i = 0; i <= bounds_.size(); ++i) {
+    counts_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void
+katana::Histogram::Observe(double value) {
+  size_t bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) -
+                  bounds_.begin();
+  counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+  double old = sum_.load(std::memory_order_relaxed);
+  while (!sum_.compare_exchange_weak(
+      old, old + value, std::memory_order_relaxed)) {
+  }
+}
+
+std::vector<uint64_t>
+katana::Histogram::bucket_counts() const {
+  std::vector<uint64_t> counts(bounds_.size() + 1);
+  for (size_t i = 0; i < counts.size(); ++i) {
+    counts[i] = counts_[i].load(std::memory_order_relaxed);
+  }
+  return counts;
+}
+
+const std::vector<double>&
+katana::LatencyBuckets() {
+  static const std::vector<double> buckets{
+      0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+      0.025,  0.05,    0.1,    0.25,  0.5,    1,     2.5,
+      5,      10,
+  };
+  return buckets;
+}
+
+katana::MetricsRegistry&
+katana::MetricsRegistry::Get() {
+  // Never destroyed so that metrics can be updated during static destruction
+  static auto* registry = new MetricsRegistry();
+  return *registry;
+}
+
+katana::MetricsRegistry::Family&
+katana::MetricsRegistry::GetFamily(
+    const std::string& name, const std::string& help, MetricType type) {
+  auto [it, inserted] = families_.try_emplace(name);
+  Family& family = it->second;
+  if (inserted) {
+    family.help = help;
+    family.type = type;
+  }
+  KATANA_LOG_VASSERT(
+      family.type == type, "metric {} is a {} not a {}", name,
+      TypeName(family.type), TypeName(type));
+  return family;
+}
+
+katana::Counter&
+katana::MetricsRegistry::GetCounter(
+    const std::string& name, const std::string& help,
+    const MetricLabels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& counter =
+      GetFamily(name, help, MetricType::kCounter).counters[labels];
+  if (!counter) {
+    counter = std::make_unique<Counter>();
+  }
+  return *counter;
+}
+
+katana::Gauge&
+katana::MetricsRegistry::GetGauge(
+    const std::string& name, const std::string& help,
+    const MetricLabels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& gauge = GetFamily(name, help, MetricType::kGauge).gauges[labels];
+  if (!gauge) {
+    gauge = std::make_unique<Gauge>();
+  }
+  return *gauge;
+}
+
+katana::Histogram&
+katana::MetricsRegistry::GetHistogram(
+    const std::string& name, const std::string& help,
+    const std::vector<double>& bounds, const MetricLabels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Family& family = GetFamily(name, help, MetricType::kHistogram);
+  if (family.histograms.empty()) {
+    family.bounds = bounds;
+  }
+  auto& histogram = family.histograms[labels];
+  if (!histogram) {
+    histogram = std::make_unique<Histogram>(family.bounds);
+  }
+  return *histogram;
+}
+
+uint64_t
+katana::MetricsRegistry::AddCollector(CollectorFn collector) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t id = next_collector_id_++;
+  collectors_.emplace(id, std::move(collector));
+  return id;
+}
+
+void
+katana::MetricsRegistry::RemoveCollector(uint64_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  collectors_.erase(id);
+}
+
+std::vector<katana::MetricFamily>
+katana::MetricsRegistry::Collect() const {
+  std::vector<MetricFamily> families;
+  // Collectors are called with the lock held so that one is not called after
+  // RemoveCollector returns
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& [name, family] : families_) {
+    MetricFamily collected{name, family.help, family.type, family.bounds, {}};
+    for (const auto& [labels, counter] : family.counters) {
+      MetricSample sample;
+      sample.labels = labels;
+      sample.value = static_cast<double>(counter->value());
+      collected.samples.emplace_back(std::move(sample));
+    }
+    for (const auto& [labels, gauge] : family.gauges) {
+      MetricSample sample;
+      sample.labels = labels;
+      sample.value = gauge->value();
+      collected.samples.emplace_back(std::move(sample));
+    }
+    for (const auto& [labels, histogram] : family.histograms) {
+      MetricSample sample;
+      sample.labels = labels;
+      sample.bucket_counts = histogram->bucket_counts();
+      sample.sum = histogram->sum();
+      collected.samples.emplace_back(std::move(sample));
+    }
+    families.emplace_back(std::move(collected));
+  }
+  for (const auto& [id, collector] : collectors_) {
+    collector(&families);
+  }
+  return families;
+}
+
+std::string
+katana::ToPrometheusText(const std::vector<MetricFamily>& families) {
+  std::ostringstream out;
+  for (const auto& family : families) {
+    out << "# HELP " << family.name << " " << family.help << "\n";
+    out << "# TYPE " << family.name << " " << TypeName(family.type) << "\n";
+    for (const auto& sample : family.samples) {
+      if (family.type != MetricType::kHistogram) {
+        out << family.name;
+        WriteLabels(sample.labels, "", "", out);
+        out << " " << FormatValue(sample.value) << "\n";
+        continue;
+      }
+      uint64_t cumulative = 0;
+      for (size_t i = 0; i < sample.bucket_counts.size(); ++i) {
+        cumulative += sample.bucket_counts[i];
+        double bound = i < family.bounds.size()
+                           ? family.bounds[i]
+                           : std::numeric_limits<double>::infinity();
+        out << family.name << "_bucket";
+        WriteLabels(sample.labels, "le", FormatValue(bound), out);
+        out << " " << cumulative << "\n";
+      }
+      out << family.name << "_sum";
+      WriteLabels(sample.labels, "", "", out);
+      out << " " << FormatValue(sample.sum) << "\n";
+      out << family.name << "_count";
+      WriteLabels(sample.labels, "", "", out);
+      out << " " << cumulative << "\n";
+    }
+  }
+  return out.str();
+}
+
+katana::Result<std::string>
+katana::ToOtlpJson(
+    const std::vector<MetricFamily>& families, const std::string& service_name,
+    uint64_t start_unix_ns) {
+  auto now_unix_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+  // OTLP JSON encodes 64-bit integers as strings
+  std::string start = std::to_string(start_unix_ns);
+  std::string now = std::to_string(now_unix_ns);
+  // AGGREGATION_TEMPORALITY_CUMULATIVE
+  constexpr int kCumulative = 2;
+
+  nlohmann::json metrics = nlohmann::json::array();
+  for (const auto& family : families) {
+    nlohmann::json points = nlohmann::json::array();
+    for (const auto& sample : family.samples) {
+      nlohmann::json point = {
+          {"attributes", OtlpAttributes(sample.labels)},
+          {"startTimeUnixNano", start},
+          {"timeUnixNano", now},
+      };
+      if (family.type == MetricType::kHistogram) {
+        uint64_t count = 0;
+        nlohmann::json bucket_counts = nlohmann::json::array();
+        for (uint64_t n : sample.bucket_counts) {
+          count += n;
+          bucket_counts.push_back(std::to_string(n));
+        }
+        point["count"] = std::to_string(count);
+        point["sum"] = sample.sum;
+        point["bucketCounts"] = std::move(bucket_counts);
+        point["explicitBounds"] = family.bounds;
+      } else {
+        point["asDouble"] = sample.value;
+      }
+      points.emplace_back(std::move(point));
+    }
+
+    nlohmann::json metric = {
+        {"name", family.name},
+        {"description", family.help},
+    };
+    switch (family.type) {
+    case MetricType::kCounter:
+      metric["sum"] = {
+          {"dataPoints", std::move(points)},
+          {"aggregationTemporality", kCumulative},
+          {"isMonotonic", true},
+      };
+      break;
+    case MetricType::kGauge:
+      metric["gauge"] = {{"dataPoints", std::move(points)}};
+      break;
+    case MetricType::kHistogram:
+      metric["histogram"] = {
+          {"dataPoints", std::move(points)},
+          {"aggregationTemporality", kCumulative},
+      };
+      break;
+    }
+    metrics.emplace_back(std::move(metric));
+  }
+
+  nlohmann::json request = {
+      {"resourceMetrics",
+       {{
+           {"resource",
+            {{"attributes",
+              OtlpAttributes({{"service.name", service_name}})}}},
+           {"scopeMetrics",
+            {{
+                {"scope", {{"name", "katana"}}},
+                {"metrics", std::move(metrics)},
+            }}},
+       }}},
+  };
+  return JsonDump(request);
+}
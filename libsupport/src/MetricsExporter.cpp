@@ -0,0 +1,238 @@
+#include "katana/MetricsExporter.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "katana/ErrorCode.h"
+#include "katana/HTTP.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// How often the server checks whether it should stop
+constexpr int kPollTimeoutMs = 100;
+/// How long the server waits for a client to send its request
+constexpr int kReadTimeoutMs = 1000;
+/// The largest request the server reads
+constexpr size_t kMaxRequestBytes = 8192;
+
+// A client that goes away should not raise SIGPIPE
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+void
+SendAll(int fd, const std::string& data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    ssize_t n = send(fd, data.data() + sent, data.size() - sent, kSendFlags);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return;
+    }
+    sent += n;
+  }
+}
+
+void
+Respond(int fd, const std::string& status, const std::string& body) {
+  SendAll(
+      fd, fmt::format(
+              "HTTP/1.1 {}\r\n"
+              "Content-Type: text/plain; version=0.0.4\r\n"
+              "Content-Length: {}\r\n"
+              "Connection: close\r\n\r\n{}",
+              status, body.size(), body));
+}
+
+/// Read the request line and headers of an HTTP request
+std::string
+ReadRequest(int fd) {
+  std::string request;
+  char buf[1024];
+  while (request.find("\r\n\r\n") == std::string::npos &&
+         request.size() < kMaxRequestBytes) {
+    pollfd pfd{fd, POLLIN, 0};
+    if (poll(&pfd, 1, kReadTimeoutMs) <= 0) {
+      break;
+    }
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    request.append(buf, n);
+  }
+  return request;
+}
+
+void
+Serve(int fd) {
+  std::string request = ReadRequest(fd);
+  std::string path;
+  if (request.compare(0, 4, "GET ") == 0) {
+    path = request.substr(4, request.find(' ', 4) - 4);
+  }
+  if (path == "/metrics" || path.compare(0, 9, "/metrics?") == 0) {
+    Respond(
+        fd, "200 OK",
+        katana::ToPrometheusText(katana::MetricsRegistry::Get().Collect()));
+  } else {
+    Respond(fd, "404 Not Found", "");
+  }
+}
+
+}  // namespace
+
+katana::MetricsExporter::~MetricsExporter() = default;
+
+katana::Result<void>
+katana::PrometheusFileExporter::Export(
+    const std::vector<MetricFamily>& families) {
+  // Write to a temporary file and rename it so that readers never see a
+  // partial file
+  std::string tmp_path = path_ + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios_base::trunc);
+    out << ToPrometheusText(families);
+    if (!out) {
+      return KATANA_ERROR(
+          ErrorCode::LocalStorageError, "writing {}: {}", tmp_path,
+          std::strerror(errno));
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "renaming {} to {}: {}", tmp_path,
+        path_, std::strerror(errno));
+  }
+  return ResultSuccess();
+}
+
+katana::OtlpExporter::OtlpExporter(
+    std::string endpoint, std::string service_name)
+    : endpoint_(std::move(endpoint)),
+      service_name_(std::move(service_name)),
+      start_unix_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count()) {}
+
+katana::Result<void>
+katana::OtlpExporter::Export(const std::vector<MetricFamily>& families) {
+  std::string body = KATANA_CHECKED(
+      ToOtlpJson(families, service_name_, start_unix_ns_));
+  std::vector<char> response;
+  KATANA_CHECKED_CONTEXT(
+      HttpPost(endpoint_, body, &response), "posting metrics to {}",
+      endpoint_);
+  return ResultSuccess();
+}
+
+katana::MetricsReporter::MetricsReporter(
+    std::unique_ptr<MetricsExporter> exporter,
+    std::chrono::milliseconds interval)
+    : exporter_(std::move(exporter)), interval_(interval) {
+  thread_ = std::thread([this] { Run(); });
+}
+
+katana::MetricsReporter::~MetricsReporter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+  if (auto res = Report(); !res) {
+    KATANA_LOG_WARN("exporting metrics: {}", res.error());
+  }
+}
+
+katana::Result<void>
+katana::MetricsReporter::Report() {
+  return exporter_->Export(MetricsRegistry::Get().Collect());
+}
+
+void
+katana::MetricsReporter::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!cv_.wait_for(lock, interval_, [this] { return stop_; })) {
+    lock.unlock();
+    if (auto res = Report(); !res) {
+      KATANA_LOG_WARN("exporting metrics: {}", res.error());
+    }
+    lock.lock();
+  }
+}
+
+katana::Result<std::unique_ptr<katana::PrometheusServer>>
+katana::PrometheusServer::Make(uint16_t port, const std::string& address) {
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "not an IPv4 address: {}", address);
+  }
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return KATANA_ERROR(ResultErrno(), "making socket");
+  }
+  int on = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      listen(fd, SOMAXCONN) != 0) {
+    std::error_code ec = ResultErrno();
+    close(fd);
+    return KATANA_ERROR(ec, "listening on {}:{}", address, port);
+  }
+  socklen_t len = sizeof(addr);
+  if (getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+    std::error_code ec = ResultErrno();
+    close(fd);
+    return KATANA_ERROR(ec, "getting port");
+  }
+  return std::unique_ptr<PrometheusServer>(
+      new PrometheusServer(fd, ntohs(addr.sin_port)));
+}
+
+katana::PrometheusServer::PrometheusServer(int socket_fd, uint16_t port)
+    : socket_fd_(socket_fd), port_(port) {
+  thread_ = std::thread([this] { Run(); });
+}
+
+katana::PrometheusServer::~PrometheusServer() {
+  stop_ = true;
+  thread_.join();
+  close(socket_fd_);
+}
+
+void
+katana::PrometheusServer::Run() {
+  while (!stop_) {
+    pollfd pfd{socket_fd_, POLLIN, 0};
+    if (poll(&pfd, 1, kPollTimeoutMs) <= 0) {
+      continue;
+    }
+    int fd = accept(socket_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      continue;
+    }
+    Serve(fd);
+    close(fd);
+  }
+}
@@ -0,0 +1,197 @@
+#include "katana/PerfCounters.h"
+
+#include <algorithm>
+
+#include "katana/Logging.h"
+
+#if __linux__
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#endif
+
+namespace {
+
+#if __linux__
+
+perf_event_attr
+MakeAttr(katana::PerfCounters::Event event) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  constexpr uint64_t kReadMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  switch (event) {
+  case katana::PerfCounters::kCycles:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    break;
+  case katana::PerfCounters::kLLCMisses:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_LL | kReadMiss;
+    break;
+  case katana::PerfCounters::kDTLBMisses:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | kReadMiss;
+    break;
+  case katana::PerfCounters::kRemoteNodeLoads:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_NODE | kReadMiss;
+    break;
+  default:
+    KATANA_LOG_FATAL("unknown event {}", event);
+  }
+  return attr;
+}
+
+int
+Open(katana::PerfCounters::Event event, int64_t tid) {
+  perf_event_attr attr = MakeAttr(event);
+  return syscall(__NR_perf_event_open, &attr, tid, -1, -1, 0);
+}
+
+uint64_t
+ReadScaled(int fd) {
+  struct {
+    uint64_t value;
+    uint64_t time_enabled;
+    uint64_t time_running;
+  } data{};
+  if (read(fd, &data, sizeof(data)) != sizeof(data) ||
+      data.time_running == 0) {
+    return 0;
+  }
+  if (data.time_running == data.time_enabled) {
+    return data.value;
+  }
+  return static_cast<uint64_t>(
+      static_cast<double>(data.value) * data.time_enabled / data.time_running);
+}
+
+std::vector<int64_t>
+ListThreads() {
+  std::vector<int64_t> tids;
+  DIR* dir = opendir("/proc/self/task");
+  if (!dir) {
+    return tids;
+  }
+  while (dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      tids.emplace_back(std::strtoll(entry->d_name, nullptr, 10));
+    }
+  }
+  closedir(dir);
+  std::sort(tids.begin(), tids.end());
+  return tids;
+}
+
+#endif
+
+}  // namespace
+
+katana::PerfCounters&
+katana::PerfCounters::Get() {
+  static PerfCounters counters;
+  return counters;
+}
+
+katana::PerfCounters::PerfCounters() {
+#if __linux__
+  for (size_t e = 0; e < kNumEvents; ++e) {
+    int fd = Open(static_cast<Event>(e), 0);
+    available_[e] = fd >= 0;
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+#endif
+}
+
+katana::PerfCounters::~PerfCounters() {
+#if __linux__
+  for (const auto& [tid, fds] : fds_) {
+    for (int fd : fds) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+#endif
+}
+
+bool
+katana::PerfCounters::IsAnyAvailable() const {
+  return std::any_of(
+      available_.begin(), available_.end(), [](bool a) { return a; });
+}
+
+katana::PerfCounters::Snapshot
+katana::PerfCounters::Read() {
+  Snapshot snapshot;
+#if __linux__
+  if (!IsAnyAvailable()) {
+    return snapshot;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<int64_t> tids = ListThreads();
+
+  // forget threads that exited
+  for (auto it = fds_.begin(); it != fds_.end();) {
+    if (std::binary_search(tids.begin(), tids.end(), it->first)) {
+      ++it;
+      continue;
+    }
+    for (int fd : it->second) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+    it = fds_.erase(it);
+  }
+
+  for (int64_t tid : tids) {
+    auto [it, inserted] = fds_.try_emplace(tid);
+    std::array<int, kNumEvents>& fds = it->second;
+    if (inserted) {
+      for (size_t e = 0; e < kNumEvents; ++e) {
+        fds[e] = available_[e] ? Open(static_cast<Event>(e), tid) : -1;
+      }
+    }
+    ThreadCounts thread{tid, {}};
+    for (size_t e = 0; e < kNumEvents; ++e) {
+      if (fds[e] >= 0) {
+        thread.counts[e] = ReadScaled(fds[e]);
+      }
+    }
+    snapshot.emplace_back(thread);
+  }
+#endif
+  return snapshot;
+}
+
+katana::PerfCounters::Snapshot
+katana::PerfCounters::Difference(const Snapshot& end, const Snapshot& begin) {
+  Snapshot diff;
+  auto b = begin.begin();
+  for (const ThreadCounts& thread : end) {
+    while (b != begin.end() && b->tid < thread.tid) {
+      ++b;
+    }
+    ThreadCounts d = thread;
+    if (b != begin.end() && b->tid == thread.tid) {
+      for (size_t e = 0; e < kNumEvents; ++e) {
+        d.counts[e] -= std::min(d.counts[e], b->counts[e]);
+      }
+    }
+    diff.emplace_back(d);
+  }
+  return diff;
+}
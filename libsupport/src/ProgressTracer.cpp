@@ -3,9 +3,11 @@
 #include <sys/resource.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <fstream>
 #include <regex>
 
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/config.h"
 
@@ -162,9 +164,19 @@ katana::ProgressScope
 katana::ProgressTracer::SetActiveSpan(
     std::shared_ptr<katana::ProgressSpan> span) {
   active_span_ = span;
+  if (capture_perf_counters_) {
+    span->StartPerfCounters();
+  }
   return ProgressScope(std::move(span));
 }
 
+bool
+katana::ProgressTracer::CapturePerfCountersFromEnv() {
+  bool capture = false;
+  GetEnv("KATANA_TRACE_PERF_COUNTERS", &capture);
+  return capture;
+}
+
 void
 katana::ProgressTracer::Finish() {
   while (HasActiveSpan()) {
@@ -241,10 +253,61 @@ katana::ProgressSpan::ScopeClosed() {
   return scope_closed_;
 }
 
+void
+katana::ProgressSpan::StartPerfCounters() {
+  if (!PerfCounters::Get().IsAnyAvailable()) {
+    return;
+  }
+  perf_begin_ =
+      std::make_unique<PerfCounters::Snapshot>(PerfCounters::Get().Read());
+}
+
+void
+katana::ProgressSpan::LogPerfCounters() {
+  PerfCounters& counters = PerfCounters::Get();
+  PerfCounters::Snapshot diff =
+      PerfCounters::Difference(counters.Read(), *perf_begin_);
+  perf_begin_.reset();
+
+  PerfCounters::Counts total{};
+  for (const auto& thread : diff) {
+    for (size_t e = 0; e < PerfCounters::kNumEvents; ++e) {
+      total[e] += thread.counts[e];
+    }
+  }
+
+  auto make_tags = [&](const std::string& prefix,
+                       const PerfCounters::Counts& counts, Tags* tags) {
+    for (size_t e = 0; e < PerfCounters::kNumEvents; ++e) {
+      if (counters.IsAvailable(static_cast<PerfCounters::Event>(e))) {
+        tags->emplace_back(prefix + PerfCounters::kEventNames[e], counts[e]);
+      }
+    }
+  };
+
+  Tags total_tags;
+  make_tags("perf.", total, &total_tags);
+  SetTags(total_tags);
+
+  for (const auto& thread : diff) {
+    const auto& c = thread.counts;
+    if (std::all_of(c.begin(), c.end(), [](uint64_t n) { return n == 0; })) {
+      // idle while the span was active
+      continue;
+    }
+    Tags thread_tags{{"tid", thread.tid}};
+    make_tags("", thread.counts, &thread_tags);
+    Log("perf counters", thread_tags);
+  }
+}
+
 void
 katana::ProgressSpan::Finish() {
   if (!finished_) {
     finished_ = true;
+    if (perf_begin_) {
+      LogPerfCounters();
+    }
     Close();
   }
   ProgressTracer& tracer = ProgressTracer::Get();
@@ -0,0 +1,726 @@
+#include "katana/TcpCommBackend.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// Broadcasts and reductions of at least this many bytes use the ring
+/// algorithms, which send less per task but take more steps
+constexpr uint64_t kLargeBytes = 256 << 10;
+/// How long tasks wait for each other to start
+constexpr auto kConnectTimeout = std::chrono::minutes(2);
+constexpr auto kConnectRetryInterval = std::chrono::milliseconds(100);
+/// The most bytes moved by one send or recv call
+constexpr uint64_t kMaxIoBytes = 1 << 30;
+
+// A task that goes away should not raise SIGPIPE
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+/// What a task sends first on each connection
+struct Hello {
+  uint32_t rank;
+  /// The port the task listens on, for connections to the root
+  uint32_t port;
+};
+
+katana::Result<std::pair<std::string, std::string>>
+SplitAddress(const std::string& address) {
+  auto colon = address.rfind(':');
+  if (colon == std::string::npos) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "address {} is not host:port",
+        address);
+  }
+  std::string host = address.substr(0, colon);
+  // Allow [::1]:port
+  if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+    host = host.substr(1, host.size() - 2);
+  }
+  return std::make_pair(host, address.substr(colon + 1));
+}
+
+katana::Result<std::string>
+ToString(const sockaddr_storage& addr) {
+  char buf[INET6_ADDRSTRLEN];
+  const void* src = nullptr;
+  if (addr.ss_family == AF_INET) {
+    src = &reinterpret_cast<const sockaddr_in*>(&addr)->sin_addr;
+  } else if (addr.ss_family == AF_INET6) {
+    src = &reinterpret_cast<const sockaddr_in6*>(&addr)->sin6_addr;
+  }
+  if (src == nullptr ||
+      inet_ntop(addr.ss_family, src, buf, sizeof(buf)) == nullptr) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unsupported address family");
+  }
+  return std::string(buf);
+}
+
+katana::Result<void>
+WriteAll(int fd, const void* buf, uint64_t size) {
+  const auto* data = static_cast<const uint8_t*>(buf);
+  while (size > 0) {
+    ssize_t n = send(fd, data, std::min(size, kMaxIoBytes), kSendFlags);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "sending");
+    }
+    data += n;
+    size -= n;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+ReadAll(int fd, void* buf, uint64_t size) {
+  auto* data = static_cast<uint8_t*>(buf);
+  while (size > 0) {
+    ssize_t n = recv(fd, data, std::min(size, kMaxIoBytes), 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n == 0) {
+      return KATANA_ERROR(katana::ErrorCode::MpiError, "connection closed");
+    }
+    if (n < 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "receiving");
+    }
+    data += n;
+    size -= n;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+SendHello(int fd, uint32_t rank, uint32_t port) {
+  Hello hello{htonl(rank), htonl(port)};
+  return WriteAll(fd, &hello, sizeof(hello));
+}
+
+katana::Result<Hello>
+RecvHello(int fd) {
+  Hello hello{};
+  KATANA_CHECKED(ReadAll(fd, &hello, sizeof(hello)));
+  return Hello{ntohl(hello.rank), ntohl(hello.port)};
+}
+
+/// Listen on host:port; an empty host is every interface and port "0" any
+/// free port
+katana::Result<int>
+Listen(const std::string& host, const std::string& port, uint32_t backlog) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+  addrinfo* info = nullptr;
+  if (int err = getaddrinfo(
+          host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &info);
+      err != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "resolving {}: {}", host,
+        gai_strerror(err));
+  }
+  int fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+  if (fd < 0) {
+    freeaddrinfo(info);
+    return KATANA_ERROR(katana::ResultErrno(), "creating socket");
+  }
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  if (bind(fd, info->ai_addr, info->ai_addrlen) != 0 ||
+      listen(fd, static_cast<int>(backlog)) != 0) {
+    std::error_code ec = katana::ResultErrno();
+    freeaddrinfo(info);
+    close(fd);
+    return KATANA_ERROR(ec, "listening on {}:{}", host, port);
+  }
+  freeaddrinfo(info);
+  return fd;
+}
+
+/// Connect to host:port, retrying until the deadline while nobody listens
+katana::Result<int>
+Connect(
+    const std::string& host, const std::string& port,
+    Clock::time_point deadline) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* info = nullptr;
+  if (int err = getaddrinfo(host.c_str(), port.c_str(), &hints, &info);
+      err != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "resolving {}: {}", host,
+        gai_strerror(err));
+  }
+  while (true) {
+    int fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (fd < 0) {
+      freeaddrinfo(info);
+      return KATANA_ERROR(katana::ResultErrno(), "creating socket");
+    }
+    if (connect(fd, info->ai_addr, info->ai_addrlen) == 0) {
+      freeaddrinfo(info);
+      return fd;
+    }
+    std::error_code ec = katana::ResultErrno();
+    close(fd);
+    if (Clock::now() >= deadline) {
+      freeaddrinfo(info);
+      return KATANA_ERROR(ec, "connecting to {}:{}", host, port);
+    }
+    std::this_thread::sleep_for(kConnectRetryInterval);
+  }
+}
+
+katana::Result<int>
+Accept(int listen_fd, Clock::time_point deadline) {
+  while (true) {
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - Clock::now());
+    if (left.count() <= 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::MpiError, "timed out waiting for tasks");
+    }
+    pollfd pfd{listen_fd, POLLIN, 0};
+    int ready = poll(&pfd, 1, static_cast<int>(left.count()));
+    if (ready < 0 && errno != EINTR) {
+      return KATANA_ERROR(katana::ResultErrno(), "waiting for tasks");
+    }
+    if (ready <= 0) {
+      continue;
+    }
+    int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd >= 0) {
+      return fd;
+    }
+    if (errno != EINTR && errno != ECONNABORTED) {
+      return KATANA_ERROR(katana::ResultErrno(), "accepting");
+    }
+  }
+}
+
+katana::Result<uint32_t>
+BoundPort(int fd) {
+  sockaddr_storage addr{};
+  socklen_t len = sizeof(addr);
+  if (getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "getting socket address");
+  }
+  if (addr.ss_family == AF_INET6) {
+    return ntohs(reinterpret_cast<sockaddr_in6*>(&addr)->sin6_port);
+  }
+  return ntohs(reinterpret_cast<sockaddr_in*>(&addr)->sin_port);
+}
+
+katana::Result<std::string>
+PeerHost(int fd, bool local) {
+  sockaddr_storage addr{};
+  socklen_t len = sizeof(addr);
+  auto* sa = reinterpret_cast<sockaddr*>(&addr);
+  if ((local ? getsockname(fd, sa, &len) : getpeername(fd, sa, &len)) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "getting socket address");
+  }
+  return ToString(addr);
+}
+
+/// Closes the sockets of a failed Make
+class FdsCloser {
+public:
+  explicit FdsCloser(std::vector<int>* fds) : fds_(fds) {}
+  ~FdsCloser() {
+    if (fds_ == nullptr) {
+      return;
+    }
+    for (int fd : *fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+  void Release() { fds_ = nullptr; }
+
+private:
+  std::vector<int>* fds_;
+};
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::TcpCommBackend>>
+katana::TcpCommBackend::Make(
+    uint32_t num, uint32_t rank, const std::string& root_address) {
+  if (num == 0 || rank >= num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "rank {} is not one of {} tasks", rank,
+        num);
+  }
+  auto [root_host, root_port] = KATANA_CHECKED(SplitAddress(root_address));
+  auto deadline = Clock::now() + kConnectTimeout;
+
+  // fds has a connection to every other task, and the listening socket last
+  std::vector<int> fds(num + 1, -1);
+  FdsCloser closer(&fds);
+  std::vector<std::string> hosts(num);
+  std::vector<uint32_t> ports(num, 0);
+
+  if (rank == 0) {
+    fds[num] = KATANA_CHECKED(Listen(root_host, root_port, num));
+    for (uint32_t i = 1; i < num; ++i) {
+      int fd = KATANA_CHECKED(Accept(fds[num], deadline));
+      auto hello_res = RecvHello(fd);
+      if (!hello_res || hello_res.value().rank == 0 ||
+          hello_res.value().rank >= num || fds[hello_res.value().rank] >= 0) {
+        close(fd);
+        return KATANA_ERROR(
+            ErrorCode::MpiError, "unexpected connection to the root task");
+      }
+      uint32_t peer = hello_res.value().rank;
+      fds[peer] = fd;
+      hosts[peer] = KATANA_CHECKED(PeerHost(fd, false));
+      ports[peer] = hello_res.value().port;
+      if (hosts[0].empty()) {
+        hosts[0] = KATANA_CHECKED(PeerHost(fd, true));
+      }
+    }
+    std::ostringstream table;
+    for (uint32_t i = 0; i < num; ++i) {
+      table << hosts[i] << " " << ports[i] << "\n";
+    }
+    std::string table_str = table.str();
+    uint32_t size = htonl(table_str.size());
+    for (uint32_t i = 1; i < num; ++i) {
+      KATANA_CHECKED(WriteAll(fds[i], &size, sizeof(size)));
+      KATANA_CHECKED(WriteAll(fds[i], table_str.data(), table_str.size()));
+    }
+  } else {
+    fds[0] = KATANA_CHECKED(Connect(root_host, root_port, deadline));
+    // Listen where the root reached us, which is where the others will too
+    std::string host = KATANA_CHECKED(PeerHost(fds[0], true));
+    fds[num] = KATANA_CHECKED(Listen(host, "0", num));
+    uint32_t port = KATANA_CHECKED(BoundPort(fds[num]));
+    KATANA_CHECKED(SendHello(fds[0], rank, port));
+
+    uint32_t size = 0;
+    KATANA_CHECKED(ReadAll(fds[0], &size, sizeof(size)));
+    std::string table_str(ntohl(size), '\0');
+    KATANA_CHECKED(ReadAll(fds[0], table_str.data(), table_str.size()));
+    std::istringstream table(table_str);
+    for (uint32_t i = 0; i < num; ++i) {
+      table >> hosts[i] >> ports[i];
+    }
+    if (!table) {
+      return KATANA_ERROR(ErrorCode::MpiError, "bad table of tasks");
+    }
+
+    // Connect to lower ranks and wait for higher ones to connect to us
+    for (uint32_t i = 1; i < rank; ++i) {
+      fds[i] = KATANA_CHECKED(
+          Connect(hosts[i], std::to_string(ports[i]), deadline));
+      KATANA_CHECKED(SendHello(fds[i], rank, 0));
+    }
+    for (uint32_t i = rank + 1; i < num; ++i) {
+      int fd = KATANA_CHECKED(Accept(fds[num], deadline));
+      auto hello_res = RecvHello(fd);
+      if (!hello_res || hello_res.value().rank <= rank ||
+          hello_res.value().rank >= num || fds[hello_res.value().rank] >= 0) {
+        close(fd);
+        return KATANA_ERROR(
+            ErrorCode::MpiError, "unexpected connection to task {}", rank);
+      }
+      fds[hello_res.value().rank] = fd;
+    }
+  }
+
+  close(fds[num]);
+  fds.pop_back();
+  for (int fd : fds) {
+    if (fd < 0) {
+      continue;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+      return KATANA_ERROR(ResultErrno(), "making socket non-blocking");
+    }
+  }
+
+  uint32_t local_rank = std::count(
+      hosts.begin(), hosts.begin() + rank, hosts[rank]);
+  closer.Release();
+  return std::unique_ptr<TcpCommBackend>(
+      new TcpCommBackend(num, rank, local_rank, std::move(fds)));
+}
+
+katana::Result<std::unique_ptr<katana::TcpCommBackend>>
+katana::TcpCommBackend::MakeFromEnv() {
+  int num = 0;
+  int rank = 0;
+  std::string root_address;
+  if (!GetEnv("KATANA_COMM_NUM", &num) || !GetEnv("KATANA_COMM_RANK", &rank) ||
+      !GetEnv("KATANA_COMM_ROOT_ADDRESS", &root_address) || num <= 0 ||
+      rank < 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "KATANA_COMM_NUM, KATANA_COMM_RANK and KATANA_COMM_ROOT_ADDRESS must "
+        "be set");
+  }
+  return Make(num, rank, root_address);
+}
+
+katana::TcpCommBackend::TcpCommBackend(
+    uint32_t num, uint32_t rank, uint32_t local_rank, std::vector<int> fds)
+    : fds_(std::move(fds)) {
+  Initialize(num, rank, local_rank);
+}
+
+katana::TcpCommBackend::~TcpCommBackend() {
+  for (int fd : fds_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+katana::Result<void>
+katana::TcpCommBackend::SendRecv(
+    uint32_t to, const void* send_buf, uint64_t send_size, uint32_t from,
+    void* recv_buf, uint64_t recv_size) {
+  KATANA_LOG_DEBUG_ASSERT(send_size == 0 || fds_[to] >= 0);
+  KATANA_LOG_DEBUG_ASSERT(recv_size == 0 || fds_[from] >= 0);
+  const auto* send_data = static_cast<const uint8_t*>(send_buf);
+  auto* recv_data = static_cast<uint8_t*>(recv_buf);
+  uint64_t sent = 0;
+  uint64_t received = 0;
+  // Send and receive at once, since the task we send to may be sending to
+  // us and neither socket buffer may hold everything
+  while (sent < send_size || received < recv_size) {
+    pollfd pfds[2];
+    nfds_t nfds = 0;
+    int send_idx = -1;
+    int recv_idx = -1;
+    if (sent < send_size) {
+      pfds[nfds] = pollfd{fds_[to], POLLOUT, 0};
+      send_idx = nfds++;
+    }
+    if (received < recv_size) {
+      if (send_idx >= 0 && to == from) {
+        pfds[send_idx].events |= POLLIN;
+        recv_idx = send_idx;
+      } else {
+        pfds[nfds] = pollfd{fds_[from], POLLIN, 0};
+        recv_idx = nfds++;
+      }
+    }
+    if (poll(pfds, nfds, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(ResultErrno(), "waiting for tasks");
+    }
+
+    constexpr short kDone = POLLHUP | POLLERR;
+    if (recv_idx >= 0 && (pfds[recv_idx].revents & (POLLIN | kDone)) != 0) {
+      ssize_t n = recv(
+          fds_[from], recv_data + received,
+          std::min(recv_size - received, kMaxIoBytes), 0);
+      if (n == 0) {
+        return KATANA_ERROR(
+            ErrorCode::MpiError, "task {} closed its connection", from);
+      }
+      if (n > 0) {
+        received += n;
+      } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        return KATANA_ERROR(ResultErrno(), "receiving from task {}", from);
+      }
+    }
+    if (send_idx >= 0 && (pfds[send_idx].revents & (POLLOUT | kDone)) != 0) {
+      ssize_t n = send(
+          fds_[to], send_data + sent, std::min(send_size - sent, kMaxIoBytes),
+          kSendFlags);
+      if (n > 0) {
+        sent += n;
+      } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        return KATANA_ERROR(ResultErrno(), "sending to task {}", to);
+      }
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::TcpCommBackend::BarrierImpl() {
+  // Dissemination barrier: after round k everyone has heard, indirectly,
+  // from 2^k others
+  uint8_t token = 0;
+  uint8_t received = 0;
+  for (uint32_t k = 1; k < num(); k <<= 1) {
+    KATANA_CHECKED(SendRecv(
+        (rank() + k) % num(), &token, 1, (rank() + num() - k) % num(),
+        &received, 1));
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::TcpCommBackend::Barrier() {
+  if (auto res = BarrierImpl(); !res) {
+    KATANA_LOG_FATAL("barrier failed: {}", res.error());
+  }
+}
+
+bool
+katana::TcpCommBackend::Broadcast(uint32_t root, bool val) {
+  uint8_t byte = val ? 1 : 0;
+  if (auto res = Broadcast(root, &byte, 1); !res) {
+    KATANA_LOG_FATAL("broadcast failed: {}", res.error());
+  }
+  return byte != 0;
+}
+
+std::string
+katana::TcpCommBackend::Broadcast(
+    uint32_t root, const std::string& val, uint64_t max_size) {
+  uint64_t size = rank() == root ? std::min<uint64_t>(val.size(), max_size) : 0;
+  std::string ret;
+  auto res = Broadcast(root, &size, sizeof(size));
+  if (res) {
+    ret = rank() == root ? val.substr(0, size) : std::string(size, '\0');
+    res = Broadcast(root, ret.data(), size);
+  }
+  if (!res) {
+    KATANA_LOG_FATAL("broadcast failed: {}", res.error());
+  }
+  return ret;
+}
+
+void
+katana::TcpCommBackend::NotifyFailure() {
+  for (int fd : fds_) {
+    if (fd >= 0) {
+      shutdown(fd, SHUT_RDWR);
+    }
+  }
+}
+
+katana::Result<void>
+katana::TcpCommBackend::Broadcast(uint32_t root, void* buf, uint64_t size) {
+  if (root >= num()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "root {} is not one of {} tasks", root,
+        num());
+  }
+  if (num() == 1 || size == 0) {
+    return katana::ResultSuccess();
+  }
+  if (size >= kLargeBytes && num() > 2) {
+    return RingBroadcast(root, buf, size);
+  }
+  return TreeBroadcast(root, buf, size);
+}
+
+katana::Result<void>
+katana::TcpCommBackend::TreeBroadcast(uint32_t root, void* buf, uint64_t size) {
+  // Ranks relative to the root
+  uint32_t me = (rank() + num() - root) % num();
+  auto actual = [&](uint32_t relative) { return (relative + root) % num(); };
+  uint32_t mask = 1;
+  for (; mask < num(); mask <<= 1) {
+    if ((me & mask) != 0) {
+      KATANA_CHECKED(Recv(actual(me - mask), buf, size));
+      break;
+    }
+  }
+  for (mask >>= 1; mask > 0; mask >>= 1) {
+    if (me + mask < num()) {
+      KATANA_CHECKED(Send(actual(me + mask), buf, size));
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::TcpCommBackend::RingBroadcast(uint32_t root, void* buf, uint64_t size) {
+  auto* data = static_cast<uint8_t*>(buf);
+  uint32_t me = (rank() + num() - root) % num();
+  auto actual = [&](uint32_t relative) { return (relative + root) % num(); };
+  // Relative rank i ends up with chunk i after the scatter
+  uint64_t chunk = (size + num() - 1) / num();
+  auto begin = [&](uint32_t i) { return std::min(size, i * chunk); };
+  auto length = [&](uint32_t i) {
+    return std::min(size, begin(i) + chunk) - begin(i);
+  };
+
+  if (me == 0) {
+    for (uint32_t i = 1; i < num(); ++i) {
+      KATANA_CHECKED(Send(actual(i), data + begin(i), length(i)));
+    }
+  } else {
+    KATANA_CHECKED(Recv(root, data + begin(me), length(me)));
+  }
+
+  uint32_t right = actual((me + 1) % num());
+  uint32_t left = actual((me + num() - 1) % num());
+  for (uint32_t step = 0; step + 1 < num(); ++step) {
+    uint32_t send_chunk = (me + num() - step) % num();
+    uint32_t recv_chunk = (me + 2 * num() - step - 1) % num();
+    KATANA_CHECKED(SendRecv(
+        right, data + begin(send_chunk), length(send_chunk), left,
+        data + begin(recv_chunk), length(recv_chunk)));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::TcpCommBackend::Allreduce(
+    void* buf, uint64_t count, CommDataType type, ReduceOp op) {
+  KATANA_CHECKED(CheckReduce(type, op));
+  if (num() == 1 || count == 0) {
+    return katana::ResultSuccess();
+  }
+  if (count * CommDataTypeSize(type) >= kLargeBytes && count >= num()) {
+    return RingAllreduce(buf, count, type, op);
+  }
+  return TreeAllreduce(buf, count, type, op);
+}
+
+katana::Result<void>
+katana::TcpCommBackend::TreeAllreduce(
+    void* buf, uint64_t count, CommDataType type, ReduceOp op) {
+  uint64_t bytes = count * CommDataTypeSize(type);
+  std::vector<uint8_t> received(bytes);
+  // Reduce up a binomial tree to task 0, which broadcasts the result
+  for (uint32_t mask = 1; mask < num(); mask <<= 1) {
+    if ((rank() & mask) != 0) {
+      KATANA_CHECKED(Send(rank() - mask, buf, bytes));
+      break;
+    }
+    if (rank() + mask < num()) {
+      KATANA_CHECKED(Recv(rank() + mask, received.data(), bytes));
+      Reduce(buf, received.data(), count, type, op);
+    }
+  }
+  return TreeBroadcast(0, buf, bytes);
+}
+
+katana::Result<void>
+katana::TcpCommBackend::RingAllreduce(
+    void* buf, uint64_t count, CommDataType type, ReduceOp op) {
+  auto* data = static_cast<uint8_t*>(buf);
+  uint64_t elem = CommDataTypeSize(type);
+  uint64_t chunk = (count + num() - 1) / num();
+  auto begin = [&](uint32_t i) { return std::min(count, i * chunk); };
+  auto length = [&](uint32_t i) {
+    return std::min(count, begin(i) + chunk) - begin(i);
+  };
+  uint32_t right = (rank() + 1) % num();
+  uint32_t left = (rank() + num() - 1) % num();
+  std::vector<uint8_t> received(chunk * elem);
+
+  // Reduce-scatter: after step s, the chunk received has the contributions
+  // of s + 2 tasks, so at the end task r has all of chunk r + 1
+  for (uint32_t step = 0; step + 1 < num(); ++step) {
+    uint32_t send_chunk = (rank() + num() - step) % num();
+    uint32_t recv_chunk = (rank() + 2 * num() - step - 1) % num();
+    KATANA_CHECKED(SendRecv(
+        right, data + begin(send_chunk) * elem, length(send_chunk) * elem,
+        left, received.data(), length(recv_chunk) * elem));
+    Reduce(
+        data + begin(recv_chunk) * elem, received.data(), length(recv_chunk),
+        type, op);
+  }
+  // Allgather the reduced chunks around the ring
+  for (uint32_t step = 0; step + 1 < num(); ++step) {
+    uint32_t send_chunk = (rank() + 1 + num() - step) % num();
+    uint32_t recv_chunk = (rank() + num() - step) % num();
+    KATANA_CHECKED(SendRecv(
+        right, data + begin(send_chunk) * elem, length(send_chunk) * elem,
+        left, data + begin(recv_chunk) * elem, length(recv_chunk) * elem));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::TcpCommBackend::Allgatherv(
+    const void* send_buf, uint64_t send_bytes, void* recv_buf,
+    const std::vector<uint64_t>& recv_bytes) {
+  std::vector<uint64_t> displacements =
+      KATANA_CHECKED(Displacements(recv_bytes));
+  if (recv_bytes[rank()] != send_bytes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "sending {} bytes but {} are expected",
+        send_bytes, recv_bytes[rank()]);
+  }
+  auto* recv = static_cast<uint8_t*>(recv_buf);
+  if (send_bytes > 0) {
+    std::memcpy(recv + displacements[rank()], send_buf, send_bytes);
+  }
+  uint32_t right = (rank() + 1) % num();
+  uint32_t left = (rank() + num() - 1) % num();
+  for (uint32_t step = 0; step + 1 < num(); ++step) {
+    uint32_t send_part = (rank() + num() - step) % num();
+    uint32_t recv_part = (rank() + 2 * num() - step - 1) % num();
+    KATANA_CHECKED(SendRecv(
+        right, recv + displacements[send_part], recv_bytes[send_part], left,
+        recv + displacements[recv_part], recv_bytes[recv_part]));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::TcpCommBackend::AlltoAllv(
+    const void* send_buf, const std::vector<uint64_t>& send_bytes,
+    void* recv_buf, const std::vector<uint64_t>& recv_bytes) {
+  std::vector<uint64_t> send_displacements =
+      KATANA_CHECKED(Displacements(send_bytes));
+  std::vector<uint64_t> recv_displacements =
+      KATANA_CHECKED(Displacements(recv_bytes));
+  if (send_bytes[rank()] != recv_bytes[rank()]) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "sending {} bytes to self but {} expected",
+        send_bytes[rank()], recv_bytes[rank()]);
+  }
+  const auto* send = static_cast<const uint8_t*>(send_buf);
+  auto* recv = static_cast<uint8_t*>(recv_buf);
+  if (send_bytes[rank()] > 0) {
+    std::memcpy(
+        recv + recv_displacements[rank()], send + send_displacements[rank()],
+        send_bytes[rank()]);
+  }
+  // In step s everyone sends to the task s after it and receives from the
+  // one s before it
+  for (uint32_t step = 1; step < num(); ++step) {
+    uint32_t to = (rank() + step) % num();
+    uint32_t from = (rank() + num() - step) % num();
+    KATANA_CHECKED(SendRecv(
+        to, send + send_displacements[to], send_bytes[to], from,
+        recv + recv_displacements[from], recv_bytes[from]));
+  }
+  return katana::ResultSuccess();
+}
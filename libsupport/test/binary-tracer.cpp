@@ -0,0 +1,212 @@
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/BinaryTracer.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/ProgressTracer.h"
+
+namespace {
+
+/// Collects the output of a BinaryTracer
+class Output {
+public:
+  katana::BinaryTracer::OutputCB Callback() {
+    return [this](const std::string& chunk) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      data_ += chunk;
+    };
+  }
+
+  nlohmann::json ToChromeTrace() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto chrome_trace_res = katana::BinaryTracer::ToChromeTrace(data_);
+    KATANA_LOG_VASSERT(chrome_trace_res, "{}", chrome_trace_res.error());
+    return nlohmann::json::parse(chrome_trace_res.value());
+  }
+
+  std::string data() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return data_;
+  }
+
+private:
+  std::mutex mutex_;
+  std::string data_;
+};
+
+std::vector<nlohmann::json>
+FindEvents(const nlohmann::json& chrome_trace, const std::string& name) {
+  std::vector<nlohmann::json> found;
+  for (const auto& event : chrome_trace["traceEvents"]) {
+    if (event["name"] == name) {
+      found.emplace_back(event);
+    }
+  }
+  return found;
+}
+
+void
+TestSpans() {
+  Output output;
+  katana::ProgressTracer::Set(
+      katana::BinaryTracer::Make(1, 2, output.Callback()));
+  auto& tracer = katana::GetTracer();
+  {
+    auto scope = tracer.StartActiveSpan("parent");
+    scope.span().SetTags(
+        {{"count", 42}, {"name", "test"}, {"ok", true}, {"ratio", 0.5}});
+    auto child_scope = tracer.StartActiveSpan("child");
+    child_scope.span().Log("working", {{"step", static_cast<uint64_t>(3)}});
+  }
+  {
+    auto scope = tracer.StartActiveSpan("root of second trace");
+    std::string carrier = tracer.Inject(scope.span().GetContext());
+    auto ctx = tracer.Extract(carrier);
+    KATANA_LOG_ASSERT(ctx != nullptr);
+    const auto& scope_ctx = scope.span().GetContext();
+    KATANA_LOG_ASSERT(ctx->GetTraceID() == scope_ctx.GetTraceID());
+    KATANA_LOG_ASSERT(ctx->GetSpanID() == scope_ctx.GetSpanID());
+    auto remote_scope = tracer.StartActiveSpan("remote child", *ctx);
+  }
+  KATANA_LOG_ASSERT(tracer.Extract("no comma") == nullptr);
+  KATANA_LOG_ASSERT(tracer.Extract("0x1,not hex") == nullptr);
+  auto unfinished = tracer.StartSpan(
+      "unfinished", tracer.GetActiveSpan().GetContext());
+  tracer.Finish();
+
+  auto chrome_trace = output.ToChromeTrace();
+  KATANA_LOG_ASSERT(chrome_trace["otherData"]["host"] == 1);
+  KATANA_LOG_ASSERT(chrome_trace["otherData"]["num_hosts"] == 2);
+
+  auto parents = FindEvents(chrome_trace, "parent");
+  auto children = FindEvents(chrome_trace, "child");
+  KATANA_LOG_ASSERT(parents.size() == 1 && children.size() == 1);
+  const auto& parent = parents[0];
+  const auto& child = children[0];
+  KATANA_LOG_ASSERT(parent["ph"] == "X" && parent["pid"] == 1);
+  KATANA_LOG_ASSERT(parent["args"]["count"] == 42);
+  KATANA_LOG_ASSERT(parent["args"]["name"] == "test");
+  KATANA_LOG_ASSERT(parent["args"]["ok"] == true);
+  KATANA_LOG_ASSERT(parent["args"]["ratio"] == 0.5);
+  KATANA_LOG_ASSERT(child["args"]["parent_id"] == parent["args"]["span_id"]);
+  KATANA_LOG_ASSERT(child["args"]["trace_id"] == parent["args"]["trace_id"]);
+  KATANA_LOG_ASSERT(child["ts"] >= parent["ts"]);
+  KATANA_LOG_ASSERT(
+      child["ts"].get<double>() + child["dur"].get<double>() <=
+      parent["ts"].get<double>() + parent["dur"].get<double>());
+
+  auto logs = FindEvents(chrome_trace, "working");
+  KATANA_LOG_ASSERT(logs.size() == 1);
+  KATANA_LOG_ASSERT(logs[0]["ph"] == "i");
+  KATANA_LOG_ASSERT(logs[0]["args"]["step"] == 3);
+  KATANA_LOG_ASSERT(logs[0]["args"]["span_id"] == child["args"]["span_id"]);
+
+  auto roots = FindEvents(chrome_trace, "root of second trace");
+  auto remotes = FindEvents(chrome_trace, "remote child");
+  KATANA_LOG_ASSERT(roots.size() == 1 && remotes.size() == 1);
+  KATANA_LOG_ASSERT(
+      remotes[0]["args"]["parent_id"] == roots[0]["args"]["span_id"]);
+  KATANA_LOG_ASSERT(
+      remotes[0]["args"]["trace_id"] == roots[0]["args"]["trace_id"]);
+  KATANA_LOG_ASSERT(roots[0]["args"]["trace_id"] != parent["args"]["trace_id"]);
+
+  auto unfinisheds = FindEvents(chrome_trace, "unfinished");
+  KATANA_LOG_ASSERT(unfinisheds.size() == 1);
+  KATANA_LOG_ASSERT(unfinisheds[0]["args"]["unfinished"] == true);
+  unfinished.reset();
+  // Reset the tracer before the output it writes to goes
+  katana::ProgressTracer::Set(nullptr);
+}
+
+void
+TestThreads() {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumLogs = 1000;
+
+  Output output;
+  katana::BinaryTracer::Options options;
+  options.flush_interval = std::chrono::milliseconds(1);
+  katana::ProgressTracer::Set(
+      katana::BinaryTracer::Make(0, 1, output.Callback(), options));
+  auto& tracer = katana::GetTracer();
+  {
+    auto scope = tracer.StartActiveSpan("threads");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < kNumLogs; ++i) {
+          scope.span().Log("tick", {{"thread", t}, {"i", i}});
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  tracer.Finish();
+
+  auto* binary_tracer = static_cast<katana::BinaryTracer*>(&tracer);
+  KATANA_LOG_ASSERT(binary_tracer->dropped_records() == 0);
+  auto ticks = FindEvents(output.ToChromeTrace(), "tick");
+  KATANA_LOG_ASSERT(ticks.size() == kNumThreads * kNumLogs);
+  katana::ProgressTracer::Set(nullptr);
+}
+
+void
+TestDropped() {
+  Output output;
+  katana::BinaryTracer::Options options;
+  options.buffer_bytes = 256;
+  // Long enough that the buffer is not drained while the span logs
+  options.flush_interval = std::chrono::hours(1);
+  katana::ProgressTracer::Set(
+      katana::BinaryTracer::Make(0, 1, output.Callback(), options));
+  auto& tracer = katana::GetTracer();
+  {
+    auto scope = tracer.StartActiveSpan("dropping");
+    for (int i = 0; i < 100; ++i) {
+      scope.span().Log("overflowing");
+    }
+  }
+  auto* binary_tracer = static_cast<katana::BinaryTracer*>(&tracer);
+  KATANA_LOG_ASSERT(binary_tracer->dropped_records() > 0);
+  tracer.Finish();
+
+  // The records that fit are still a trace
+  auto chrome_trace = output.ToChromeTrace();
+  KATANA_LOG_ASSERT(FindEvents(chrome_trace, "dropping").size() == 1);
+  katana::ProgressTracer::Set(nullptr);
+}
+
+void
+TestBadTraces() {
+  KATANA_LOG_ASSERT(!katana::BinaryTracer::ToChromeTrace(""));
+  KATANA_LOG_ASSERT(!katana::BinaryTracer::ToChromeTrace("not a trace"));
+
+  Output output;
+  katana::ProgressTracer::Set(
+      katana::BinaryTracer::Make(0, 1, output.Callback()));
+  {
+    auto scope = katana::GetTracer().StartActiveSpan("span");
+  }
+  katana::GetTracer().Finish();
+  std::string trace = output.data();
+  KATANA_LOG_ASSERT(katana::BinaryTracer::ToChromeTrace(trace));
+  KATANA_LOG_ASSERT(
+      !katana::BinaryTracer::ToChromeTrace(trace.substr(0, trace.size() - 1)));
+  katana::ProgressTracer::Set(nullptr);
+}
+
+}  // namespace
+
+int
+main() {
+  TestSpans();
+  TestThreads();
+  TestDropped();
+  TestBadTraces();
+  return 0;
+}
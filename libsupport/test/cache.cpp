@@ -2,6 +2,7 @@
 
 #include <map>
 #include <random>
+#include <thread>
 
 #include "katana/Cache.h"
 #include "katana/Logging.h"
@@ -212,6 +213,130 @@ TestLRUSize(int64_t lru_size, const std::vector<katana::URI>& keys) {
   KATANA_LOG_ASSERT(cache.size() == 0);
 }
 
+void
+TestSharded(const std::vector<katana::URI>& keys) {
+  constexpr size_t num_shards = 4;
+  int64_t byte_size = 8;
+  KATANA_LOG_ASSERT(static_cast<int64_t>(keys.size()) > byte_size * 2);
+  katana::ShardedCache<CacheValue> cache(
+      byte_size, [](const CacheValue& value) { return BytesInValue(value); },
+      num_shards);
+  KATANA_LOG_ASSERT(cache.num_shards() == num_shards);
+
+  for (const auto& key : keys) {
+    cache.Insert(key, SizeOneValue());
+    KATANA_LOG_ASSERT(cache.size() <= byte_size);
+  }
+  KATANA_LOG_VASSERT(
+      cache.size() == byte_size, "size {} allocated {}", cache.size(),
+      byte_size);
+  // The most recent insert is always present
+  KATANA_LOG_ASSERT(cache.Contains(keys.back()));
+
+  auto val = cache.GetAndEvict(keys.back());
+  KATANA_LOG_ASSERT(val.has_value());
+  KATANA_LOG_ASSERT(cache.size() == byte_size - 1);
+  KATANA_LOG_ASSERT(!cache.Get(keys.back()).has_value());
+
+  KATANA_LOG_ASSERT(cache.Reclaim(2) == 2);
+  KATANA_LOG_ASSERT(cache.size() == byte_size - 3);
+
+  cache.clear();
+  KATANA_LOG_ASSERT(cache.empty());
+
+  // Hammer the cache from several threads; the byte total must stay
+  // consistent with what is actually cached.
+  katana::ShardedCache<CacheValue> shared_cache(
+      [](const CacheValue& value) { return BytesInValue(value); }, num_shards);
+  constexpr size_t num_threads = 4;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&keys, &shared_cache, t]() {
+      for (size_t i = t; i < keys.size(); i += num_threads) {
+        shared_cache.Insert(keys[i], SizeFiveValue());
+        if (i % 2 == 0) {
+          KATANA_LOG_ASSERT(shared_cache.GetAndEvict(keys[i]).has_value());
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  int64_t expected = 5 * static_cast<int64_t>(keys.size() / 2);
+  KATANA_LOG_VASSERT(
+      shared_cache.size() == expected, "size {} expected {}",
+      shared_cache.size(), expected);
+  KATANA_LOG_ASSERT(shared_cache.Reclaim(expected) == expected);
+  KATANA_LOG_ASSERT(shared_cache.empty());
+  KATANA_LOG_ASSERT(
+      shared_cache.GetStats().insert_count ==
+      static_cast<int64_t>(keys.size()));
+}
+
+void
+TestEvictionScore(const std::vector<katana::URI>& keys) {
+  // One shard so that recency order is exact
+  katana::ShardedCache<CacheValue> cache(
+      [](const CacheValue& value) { return BytesInValue(value); }, 1);
+  KATANA_LOG_ASSERT(keys.size() > 4);
+  const katana::URI& precious = keys[0];
+  cache.SetEvictionScore(
+      [&precious](const katana::URI& key, const CacheValue&) {
+        return key == precious ? 1.0 : 0.0;
+      },
+      4);
+
+  // precious is least recently used but scores highest
+  for (size_t i = 0; i < 4; ++i) {
+    cache.Insert(keys[i], SizeOneValue());
+  }
+  KATANA_LOG_ASSERT(cache.Reclaim(3) == 3);
+  KATANA_LOG_ASSERT(cache.Contains(precious));
+  KATANA_LOG_ASSERT(cache.size() == 1);
+
+  // Outside the sample window recency wins
+  katana::Cache<CacheValue> lru(
+      [](const CacheValue& value) { return BytesInValue(value); });
+  for (size_t i = 0; i < 4; ++i) {
+    lru.Insert(keys[i], SizeOneValue());
+  }
+  auto score = [&keys](const katana::URI& key, const CacheValue&) {
+    return key == keys[0] ? 1.0 : 0.0;
+  };
+  KATANA_LOG_ASSERT(lru.EvictLowestScore(1, score) == 1);
+  KATANA_LOG_ASSERT(!lru.Contains(keys[0]));
+  KATANA_LOG_ASSERT(lru.EvictLowestScore(2, score) == 1);
+  KATANA_LOG_ASSERT(!lru.Contains(keys[1]));
+}
+
+void
+TestEvictionCallback(const std::vector<katana::URI>& keys) {
+  int64_t byte_size = 2;
+  katana::ShardedCache<CacheValue> cache(
+      byte_size, [](const CacheValue& value) { return BytesInValue(value); },
+      1);
+  std::vector<katana::URI> evicted;
+  cache.SetEvictionCallback(
+      [&evicted](const katana::URI& key, CacheValue&&) {
+        evicted.emplace_back(key);
+      });
+
+  KATANA_LOG_ASSERT(keys.size() > 3);
+  for (size_t i = 0; i < 3; ++i) {
+    cache.Insert(keys[i], SizeOneValue());
+  }
+  KATANA_LOG_ASSERT(evicted.size() == 1 && evicted[0] == keys[0]);
+
+  // Explicit removal is not an eviction
+  KATANA_LOG_ASSERT(cache.GetAndEvict(keys[1]).has_value());
+  KATANA_LOG_ASSERT(evicted.size() == 1);
+
+  KATANA_LOG_ASSERT(cache.Reclaim(1) == 1);
+  KATANA_LOG_ASSERT(evicted.size() == 2 && evicted[1] == keys[2]);
+  KATANA_LOG_ASSERT(cache.empty());
+}
+
 int
 main(int argc, char** argv) {
   constexpr int64_t lru_size = 10;
@@ -236,5 +361,11 @@ main(int argc, char** argv) {
 
   TestLRUExplicit(keys);
 
+  TestSharded(keys);
+
+  TestEvictionScore(keys);
+
+  TestEvictionCallback(keys);
+
   return 0;
 }
@@ -0,0 +1,250 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/TcpCommBackend.h"
+
+namespace {
+
+/// Big enough for the ring algorithms
+constexpr uint64_t kLargeBytes = (1 << 20) + 3;
+
+/// A backend with only the original collectives, to exercise the default
+/// implementations of the others
+class StringOnlyBackend : public katana::CommBackend {
+public:
+  explicit StringOnlyBackend(katana::CommBackend* inner) : inner_(inner) {
+    Initialize(inner->num(), inner->rank(), inner->local_rank());
+  }
+
+  void Barrier() override { inner_->Barrier(); }
+  bool Broadcast(uint32_t root, bool val) override {
+    return inner_->Broadcast(root, val);
+  }
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override {
+    return inner_->Broadcast(root, val, max_size);
+  }
+  void NotifyFailure() override { inner_->NotifyFailure(); }
+
+private:
+  katana::CommBackend* inner_;
+};
+
+uint16_t
+FreePort() {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  KATANA_LOG_ASSERT(fd >= 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  KATANA_LOG_ASSERT(
+      bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+  socklen_t len = sizeof(addr);
+  KATANA_LOG_ASSERT(
+      getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+  close(fd);
+  return ntohs(addr.sin_port);
+}
+
+/// Run fn for each of num tasks on threads connected by TcpCommBackends
+void
+RunTasks(uint32_t num, const std::function<void(katana::CommBackend*)>& fn) {
+  std::string root = fmt::format("127.0.0.1:{}", FreePort());
+  std::vector<std::thread> threads;
+  for (uint32_t rank = 0; rank < num; ++rank) {
+    threads.emplace_back([&, rank] {
+      auto comm_res = katana::TcpCommBackend::Make(num, rank, root);
+      KATANA_LOG_VASSERT(comm_res, "{}", comm_res.error());
+      auto& comm = comm_res.value();
+      KATANA_LOG_ASSERT(comm->num() == num && comm->rank() == rank);
+      // Everyone is on this host
+      KATANA_LOG_ASSERT(comm->local_rank() == rank);
+      fn(comm.get());
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+uint8_t
+Byte(uint32_t rank, uint64_t i) {
+  return static_cast<uint8_t>(rank * 31 + i * 7 + i / 253);
+}
+
+void
+TestBroadcast(katana::CommBackend* comm) {
+  uint32_t num = comm->num();
+  comm->Barrier();
+  KATANA_LOG_ASSERT(comm->Broadcast(num - 1, comm->rank() == num - 1));
+  std::string val = comm->rank() == 0 ? "hello world" : "";
+  KATANA_LOG_ASSERT(comm->Broadcast(0, val, 5) == "hello");
+
+  for (uint64_t size : {UINT64_C(0), UINT64_C(100), kLargeBytes}) {
+    uint32_t root = num / 2;
+    std::vector<uint8_t> buf(size);
+    if (comm->rank() == root) {
+      for (uint64_t i = 0; i < size; ++i) {
+        buf[i] = Byte(root, i);
+      }
+    }
+    KATANA_LOG_ASSERT(comm->Broadcast(root, buf.data(), buf.size()));
+    for (uint64_t i = 0; i < size; ++i) {
+      KATANA_LOG_ASSERT(buf[i] == Byte(root, i));
+    }
+  }
+}
+
+void
+TestAllreduce(katana::CommBackend* comm) {
+  uint32_t num = comm->num();
+  uint32_t rank = comm->rank();
+  for (uint64_t count : {UINT64_C(5), kLargeBytes / sizeof(int64_t)}) {
+    std::vector<int64_t> sums(count);
+    std::vector<double> maxes(count);
+    std::vector<uint32_t> mins(count);
+    for (uint64_t i = 0; i < count; ++i) {
+      sums[i] = static_cast<int64_t>(i) * rank - 3;
+      maxes[i] = (i % num == rank) ? 1.5 * i : -1.0;
+      mins[i] = rank + i;
+    }
+    KATANA_LOG_ASSERT(
+        comm->Allreduce(sums.data(), count, katana::ReduceOp::kSum));
+    KATANA_LOG_ASSERT(
+        comm->Allreduce(maxes.data(), count, katana::ReduceOp::kMax));
+    KATANA_LOG_ASSERT(
+        comm->Allreduce(mins.data(), count, katana::ReduceOp::kMin));
+    int64_t rank_sum = num * (num - 1) / 2;
+    for (uint64_t i = 0; i < count; ++i) {
+      KATANA_LOG_ASSERT(
+          sums[i] == static_cast<int64_t>(i) * rank_sum - 3 * num);
+      KATANA_LOG_ASSERT(maxes[i] == 1.5 * i);
+      KATANA_LOG_ASSERT(mins[i] == i);
+    }
+  }
+
+  uint32_t bits = 1U << rank;
+  KATANA_LOG_ASSERT(comm->Allreduce(&bits, 1, katana::ReduceOp::kBitOr));
+  KATANA_LOG_ASSERT(bits == (1U << num) - 1);
+  double not_bits = 1;
+  auto res = comm->Allreduce(&not_bits, 1, katana::ReduceOp::kBitAnd);
+  KATANA_LOG_ASSERT(!res && res.error() == katana::ErrorCode::InvalidArgument);
+}
+
+void
+TestAllgather(katana::CommBackend* comm) {
+  uint32_t num = comm->num();
+  uint32_t rank = comm->rank();
+  auto ranks_res = comm->Allgather(rank * 10);
+  KATANA_LOG_VASSERT(ranks_res, "{}", ranks_res.error());
+  for (uint32_t i = 0; i < num; ++i) {
+    KATANA_LOG_ASSERT(ranks_res.value()[i] == i * 10);
+  }
+
+  // Sizes differ and one is 0
+  std::vector<uint64_t> sizes(num);
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < num; ++i) {
+    sizes[i] = i == 1 ? 0 : i * 100000 + 17;
+    total += sizes[i];
+  }
+  std::vector<uint8_t> send(sizes[rank]);
+  for (uint64_t i = 0; i < send.size(); ++i) {
+    send[i] = Byte(rank, i);
+  }
+  std::vector<uint8_t> recv(total);
+  KATANA_LOG_ASSERT(
+      comm->Allgatherv(send.data(), send.size(), recv.data(), sizes));
+  uint64_t offset = 0;
+  for (uint32_t i = 0; i < num; ++i) {
+    for (uint64_t j = 0; j < sizes[i]; ++j) {
+      KATANA_LOG_ASSERT(recv[offset + j] == Byte(i, j));
+    }
+    offset += sizes[i];
+  }
+
+  auto bad_res = comm->Allgatherv(send.data(), send.size(), recv.data(), {});
+  KATANA_LOG_ASSERT(!bad_res);
+}
+
+void
+TestAlltoAll(katana::CommBackend* comm) {
+  uint32_t num = comm->num();
+  uint32_t rank = comm->rank();
+  auto size = [&](uint32_t from, uint32_t to) -> uint64_t {
+    return (from * 7 + to * 3) % 5 * 30000 + to;
+  };
+  std::vector<uint64_t> send_bytes(num);
+  std::vector<uint64_t> recv_bytes(num);
+  std::vector<uint8_t> send;
+  uint64_t recv_total = 0;
+  for (uint32_t i = 0; i < num; ++i) {
+    send_bytes[i] = size(rank, i);
+    recv_bytes[i] = size(i, rank);
+    recv_total += recv_bytes[i];
+    for (uint64_t j = 0; j < send_bytes[i]; ++j) {
+      send.emplace_back(Byte(rank * num + i, j));
+    }
+  }
+  std::vector<uint8_t> recv(recv_total);
+  KATANA_LOG_ASSERT(
+      comm->AlltoAllv(send.data(), send_bytes, recv.data(), recv_bytes));
+  uint64_t offset = 0;
+  for (uint32_t i = 0; i < num; ++i) {
+    for (uint64_t j = 0; j < recv_bytes[i]; ++j) {
+      KATANA_LOG_ASSERT(recv[offset + j] == Byte(i * num + rank, j));
+    }
+    offset += recv_bytes[i];
+  }
+}
+
+void
+TestAll(katana::CommBackend* comm) {
+  TestBroadcast(comm);
+  TestAllreduce(comm);
+  TestAllgather(comm);
+  TestAlltoAll(comm);
+  comm->Barrier();
+}
+
+}  // namespace
+
+int
+main() {
+  katana::NullCommBackend null_comm;
+  TestAll(&null_comm);
+
+  for (uint32_t num : {1, 2, 3, 4, 5}) {
+    RunTasks(num, TestAll);
+  }
+
+  RunTasks(3, [](katana::CommBackend* comm) {
+    StringOnlyBackend fallback(comm);
+    TestAll(&fallback);
+  });
+
+  // A task that fails makes the collectives of the others fail too
+  RunTasks(3, [](katana::CommBackend* comm) {
+    if (comm->rank() == 2) {
+      comm->NotifyFailure();
+      return;
+    }
+    uint64_t val = 1;
+    KATANA_LOG_ASSERT(!comm->Allreduce(&val, 1, katana::ReduceOp::kSum));
+  });
+
+  return 0;
+}
@@ -0,0 +1,234 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/Metrics.h"
+#include "katana/MetricsExporter.h"
+
+namespace {
+
+bool
+Contains(const std::string& haystack, const std::string& needle) {
+  return haystack.find(needle) != std::string::npos;
+}
+
+const katana::MetricFamily*
+FindFamily(
+    const std::vector<katana::MetricFamily>& families,
+    const std::string& name) {
+  for (const auto& family : families) {
+    if (family.name == name) {
+      return &family;
+    }
+  }
+  return nullptr;
+}
+
+void
+TestRegistry() {
+  katana::MetricsRegistry registry;
+  auto& counter = registry.GetCounter(
+      "test_requests_total", "Requests", {{"op", "get"}});
+  KATANA_LOG_ASSERT(
+      &counter ==
+      &registry.GetCounter("test_requests_total", "Requests", {{"op", "get"}}));
+  registry.GetCounter("test_requests_total", "Requests", {{"op", "put"}})
+      .Add(2);
+
+  constexpr int kNumThreads = 4;
+  constexpr int kNumAdds = 10000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < kNumAdds; ++i) {
+        counter.Add();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  KATANA_LOG_ASSERT(counter.value() == kNumThreads * kNumAdds);
+
+  auto& gauge = registry.GetGauge("test_bytes", "Bytes");
+  gauge.Set(10);
+  gauge.Add(-4);
+  KATANA_LOG_ASSERT(gauge.value() == 6);
+
+  auto& histogram = registry.GetHistogram(
+      "test_latency_seconds", "Latency", {0.1, 1});
+  histogram.Observe(0.05);
+  histogram.Observe(0.1);
+  histogram.Observe(0.5);
+  histogram.Observe(5);
+  KATANA_LOG_ASSERT(
+      histogram.bucket_counts() == std::vector<uint64_t>({2, 1, 1}));
+  KATANA_LOG_ASSERT(std::abs(histogram.sum() - 5.65) < 1e-9);
+
+  uint64_t id = registry.AddCollector([](auto* families) {
+    katana::MetricFamily family{
+        "test_collected", "Collected", katana::MetricType::kGauge, {}, {}};
+    family.AddSample(42);
+    families->emplace_back(std::move(family));
+  });
+
+  auto families = registry.Collect();
+  KATANA_LOG_ASSERT(families.size() == 4);
+  const auto* requests = FindFamily(families, "test_requests_total");
+  KATANA_LOG_ASSERT(requests && requests->samples.size() == 2);
+  KATANA_LOG_ASSERT(requests->type == katana::MetricType::kCounter);
+  const auto* latency = FindFamily(families, "test_latency_seconds");
+  KATANA_LOG_ASSERT(latency && latency->bounds.size() == 2);
+  const auto* collected = FindFamily(families, "test_collected");
+  KATANA_LOG_ASSERT(collected && collected->samples[0].value == 42);
+
+  registry.RemoveCollector(id);
+  KATANA_LOG_ASSERT(
+      FindFamily(registry.Collect(), "test_collected") == nullptr);
+}
+
+std::vector<katana::MetricFamily>
+MakeFamilies() {
+  katana::MetricsRegistry registry;
+  registry.GetCounter("test_reads_total", "Reads", {{"path", "a\"b"}}).Add(3);
+  registry.GetGauge("test_ratio", "Ratio").Set(0.25);
+  auto& histogram = registry.GetHistogram(
+      "test_latency_seconds", "Latency", {0.1, 1});
+  histogram.Observe(0.05);
+  histogram.Observe(0.5);
+  histogram.Observe(5);
+  return registry.Collect();
+}
+
+void
+TestPrometheusText() {
+  std::string text = katana::ToPrometheusText(MakeFamilies());
+  KATANA_LOG_ASSERT(Contains(text, "# HELP test_reads_total Reads\n"));
+  KATANA_LOG_ASSERT(Contains(text, "# TYPE test_reads_total counter\n"));
+  KATANA_LOG_ASSERT(Contains(text, "test_reads_total{path=\"a\\\"b\"} 3\n"));
+  KATANA_LOG_ASSERT(Contains(text, "# TYPE test_ratio gauge\n"));
+  KATANA_LOG_ASSERT(Contains(text, "test_ratio 0.25\n"));
+  KATANA_LOG_ASSERT(Contains(text, "# TYPE test_latency_seconds histogram\n"));
+  KATANA_LOG_ASSERT(
+      Contains(text, "test_latency_seconds_bucket{le=\"0.1\"} 1\n"));
+  KATANA_LOG_ASSERT(
+      Contains(text, "test_latency_seconds_bucket{le=\"1\"} 2\n"));
+  KATANA_LOG_ASSERT(
+      Contains(text, "test_latency_seconds_bucket{le=\"+Inf\"} 3\n"));
+  KATANA_LOG_ASSERT(Contains(text, "test_latency_seconds_sum 5.55\n"));
+  KATANA_LOG_ASSERT(Contains(text, "test_latency_seconds_count 3\n"));
+}
+
+void
+TestOtlpJson() {
+  auto json_res = katana::ToOtlpJson(MakeFamilies(), "test", 1000);
+  KATANA_LOG_VASSERT(json_res, "{}", json_res.error());
+  auto request = nlohmann::json::parse(json_res.value());
+  auto& resource_metrics = request["resourceMetrics"][0];
+  auto& attribute = resource_metrics["resource"]["attributes"][0];
+  KATANA_LOG_ASSERT(attribute["key"] == "service.name");
+  KATANA_LOG_ASSERT(attribute["value"]["stringValue"] == "test");
+
+  auto& metrics = resource_metrics["scopeMetrics"][0]["metrics"];
+  KATANA_LOG_ASSERT(metrics.size() == 3);
+  for (const auto& metric : metrics) {
+    if (metric["name"] == "test_reads_total") {
+      KATANA_LOG_ASSERT(metric["sum"]["isMonotonic"] == true);
+      const auto& point = metric["sum"]["dataPoints"][0];
+      KATANA_LOG_ASSERT(point["asDouble"] == 3);
+      KATANA_LOG_ASSERT(point["startTimeUnixNano"] == "1000");
+      KATANA_LOG_ASSERT(point["attributes"][0]["key"] == "path");
+    } else if (metric["name"] == "test_ratio") {
+      KATANA_LOG_ASSERT(metric["gauge"]["dataPoints"][0]["asDouble"] == 0.25);
+    } else {
+      KATANA_LOG_ASSERT(metric["name"] == "test_latency_seconds");
+      const auto& point = metric["histogram"]["dataPoints"][0];
+      KATANA_LOG_ASSERT(point["count"] == "3");
+      KATANA_LOG_ASSERT(
+          point["bucketCounts"] == nlohmann::json({"1", "1", "1"}));
+      KATANA_LOG_ASSERT(point["explicitBounds"].size() == 2);
+    }
+  }
+}
+
+void
+TestFileExporter() {
+  std::string path = "metrics-test.prom";
+  katana::PrometheusFileExporter exporter(path);
+  auto families = MakeFamilies();
+  auto res = exporter.Export(families);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  std::ifstream in(path);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  KATANA_LOG_ASSERT(contents.str() == katana::ToPrometheusText(families));
+  std::remove(path.c_str());
+}
+
+std::string
+Get(uint16_t port, const std::string& path) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  KATANA_LOG_ASSERT(fd >= 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  KATANA_LOG_ASSERT(
+      connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+  std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  KATANA_LOG_ASSERT(
+      send(fd, request.data(), request.size(), 0) ==
+      static_cast<ssize_t>(request.size()));
+  std::string response;
+  char buf[1024];
+  ssize_t n;
+  while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+    response.append(buf, n);
+  }
+  close(fd);
+  return response;
+}
+
+void
+TestServer() {
+  katana::MetricsRegistry::Get()
+      .GetCounter("test_server_total", "Served")
+      .Add(7);
+  auto server_res = katana::PrometheusServer::Make(0, "127.0.0.1");
+  KATANA_LOG_VASSERT(server_res, "{}", server_res.error());
+  auto server = std::move(server_res.value());
+  KATANA_LOG_ASSERT(server->port() != 0);
+
+  std::string response = Get(server->port(), "/metrics");
+  KATANA_LOG_ASSERT(Contains(response, "HTTP/1.1 200 OK\r\n"));
+  KATANA_LOG_ASSERT(Contains(response, "\r\n\r\n# HELP"));
+  KATANA_LOG_ASSERT(Contains(response, "test_server_total 7\n"));
+
+  KATANA_LOG_ASSERT(
+      Contains(Get(server->port(), "/other"), "HTTP/1.1 404 Not Found\r\n"));
+
+  KATANA_LOG_ASSERT(!katana::PrometheusServer::Make(0, "not an address"));
+}
+
+}  // namespace
+
+int
+main() {
+  TestRegistry();
+  TestPrometheusText();
+  TestOtlpJson();
+  TestFileExporter();
+  TestServer();
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "katana/JSONTracer.h"
+#include "katana/Logging.h"
+#include "katana/PerfCounters.h"
+#include "katana/ProgressTracer.h"
+
+namespace {
+
+using katana::PerfCounters;
+
+uint64_t
+Work() {
+  std::vector<uint64_t> values(1 << 20);
+  uint64_t sum = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[(i * 7919) % values.size()] = i;
+  }
+  for (uint64_t v : values) {
+    sum += v;
+  }
+  return sum;
+}
+
+void
+TestDifference() {
+  PerfCounters::Snapshot begin{
+      {1, {10, 10, 10, 10}},
+      {3, {5, 5, 5, 5}},
+  };
+  PerfCounters::Snapshot end{
+      {1, {15, 10, 12, 10}},
+      {2, {7, 0, 0, 0}},
+      {3, {6, 5, 5, 4}},
+  };
+  auto diff = PerfCounters::Difference(end, begin);
+  KATANA_LOG_ASSERT(diff.size() == 3);
+  KATANA_LOG_ASSERT(diff[0].tid == 1);
+  KATANA_LOG_ASSERT((diff[0].counts == PerfCounters::Counts{5, 0, 2, 0}));
+  KATANA_LOG_ASSERT((diff[1].counts == PerfCounters::Counts{7, 0, 0, 0}));
+  // counters that went backwards, e.g., due to scaling, count as zero
+  KATANA_LOG_ASSERT((diff[2].counts == PerfCounters::Counts{1, 0, 0, 0}));
+}
+
+void
+TestRead() {
+  PerfCounters& counters = PerfCounters::Get();
+  auto begin = counters.Read();
+  Work();
+  auto end = counters.Read();
+
+  if (!counters.IsAnyAvailable()) {
+    KATANA_LOG_WARN("no perf_event counters available; skipping");
+    KATANA_LOG_ASSERT(begin.empty() && end.empty());
+    return;
+  }
+  KATANA_LOG_ASSERT(!end.empty());
+  if (counters.IsAvailable(PerfCounters::kCycles)) {
+    uint64_t cycles = 0;
+    for (const auto& thread : PerfCounters::Difference(end, begin)) {
+      cycles += thread.counts[PerfCounters::kCycles];
+    }
+    KATANA_LOG_ASSERT(cycles > 0);
+  }
+}
+
+void
+TestSpans() {
+  std::string output;
+  katana::ProgressTracer::Set(katana::JSONTracer::Make(
+      0, 1, [&](const std::string& line) { output += line; }));
+  auto& tracer = katana::GetTracer();
+
+  tracer.SetCapturePerfCounters(true);
+  {
+    auto scope = tracer.StartActiveSpan("counted");
+    Work();
+  }
+  bool available = PerfCounters::Get().IsAnyAvailable();
+  KATANA_LOG_ASSERT(
+      (output.find("perf counters") != std::string::npos) == available);
+
+  output.clear();
+  tracer.SetCapturePerfCounters(false);
+  {
+    auto scope = tracer.StartActiveSpan("not counted");
+    Work();
+  }
+  KATANA_LOG_ASSERT(output.find("perf counters") == std::string::npos);
+
+  tracer.Finish();
+}
+
+}  // namespace
+
+int
+main() {
+  TestDifference();
+  TestRead();
+  TestSpans();
+  return 0;
+}
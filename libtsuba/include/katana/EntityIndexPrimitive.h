@@ -0,0 +1,122 @@
+#ifndef KATANA_LIBTSUBA_KATANA_ENTITYINDEXPRIMITIVE_H_
+#define KATANA_LIBTSUBA_KATANA_ENTITYINDEXPRIMITIVE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/FileFrame.h"
+#include "katana/FileView.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/RDGOptionalDatastructure.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/config.h"
+#include "katana/tsuba.h"
+
+namespace katana {
+
+const std::string kOptionalDatastructureEntityIndexPrimitive =
+    "kg.v1.entity_index";
+const std::string kOptionalDatastructureEntityIndexPrimitiveFilename =
+    "entity_index_manifest";
+const std::string kEntityIndexPrimitiveIdsFilename = "entity_index_ids";
+const std::string kEntityIndexPrimitiveKeysFilename = "entity_index_keys";
+
+/// The property indexes of a graph as stored in an RDG. Each index is a file
+/// of its sorted entity ids and, for primitive properties, a file of their
+/// keys in the same order, both raw arrays that can be mapped and copied
+/// without parsing. The manifest records which property each index covers.
+class KATANA_EXPORT EntityIndexPrimitive
+    : private katana::RDGOptionalDatastructure {
+public:
+  /// The files of a single index
+  struct IndexFiles {
+    std::string property_name;
+    bool is_node{};
+    /// Whether the index is a hash index rather than a sorted one
+    bool hash{};
+    /// The number of nodes or edges in the graph when the index was written
+    uint64_t num_entities{};
+    /// The number of ids, i.e., of entities whose property is not null
+    uint64_t num_entries{};
+    std::string ids_path;
+    /// Empty if the index does not store its keys
+    std::string keys_path;
+  };
+
+  static katana::Result<EntityIndexPrimitive> Load(
+      const katana::URI& rdg_dir_path, const std::string& path) {
+    EntityIndexPrimitive index =
+        KATANA_CHECKED(LoadJson(rdg_dir_path.Join(path).string()));
+    return index;
+  }
+
+  katana::Result<std::string> Write(katana::URI rdg_dir_path) {
+    // Write out our json manifest
+    katana::URI manifest_path = rdg_dir_path.RandFile(
+        kOptionalDatastructureEntityIndexPrimitiveFilename);
+    KATANA_CHECKED(WriteManifest(manifest_path.string()));
+    return manifest_path.BaseName();
+  }
+
+  /// Persist the arrays of an index in rdg_dir_path now and add it to the
+  /// manifest with the paths of files filled in. keys may be null if the
+  /// index does not store its keys.
+  katana::Result<void> AddIndex(
+      const katana::URI& rdg_dir_path, IndexFiles files, const void* ids,
+      uint64_t ids_size, const void* keys, uint64_t keys_size) {
+    files.ids_path = KATANA_CHECKED(WriteArray(
+        rdg_dir_path, kEntityIndexPrimitiveIdsFilename, ids, ids_size));
+    if (keys != nullptr) {
+      files.keys_path = KATANA_CHECKED(WriteArray(
+          rdg_dir_path, kEntityIndexPrimitiveKeysFilename, keys, keys_size));
+    }
+    indexes_.emplace_back(std::move(files));
+    return katana::ResultSuccess();
+  }
+
+  /// Map a file named by IndexFiles
+  static katana::Result<katana::FileView> MapFile(
+      const katana::URI& rdg_dir_path, const std::string& path) {
+    katana::FileView fv;
+    KATANA_CHECKED(fv.Bind(rdg_dir_path.Join(path).string(), true));
+    return katana::Result<katana::FileView>(std::move(fv));
+  }
+
+  const std::vector<IndexFiles>& indexes() const { return indexes_; }
+
+  friend void to_json(nlohmann::json& j, const EntityIndexPrimitive& index);
+  friend void from_json(const nlohmann::json& j, EntityIndexPrimitive& index);
+
+private:
+  std::vector<IndexFiles> indexes_;
+
+  static katana::Result<EntityIndexPrimitive> LoadJson(
+      const std::string& path) {
+    katana::FileView fv;
+    KATANA_CHECKED(fv.Bind(path, true));
+
+    if (fv.size() == 0) {
+      return EntityIndexPrimitive();
+    }
+
+    EntityIndexPrimitive index;
+    KATANA_CHECKED(katana::JsonParse<EntityIndexPrimitive>(fv, &index));
+
+    return index;
+  }
+
+  katana::Result<void> WriteManifest(const std::string& path) const {
+    std::string serialized = KATANA_CHECKED(katana::JsonDump(*this));
+    // POSIX files end with newlines
+    serialized = serialized + "\n";
+    return WriteFile(path, serialized.data(), serialized.size());
+  }
+};
+
+}  // namespace katana
+
+#endif
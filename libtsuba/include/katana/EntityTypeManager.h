@@ -268,9 +268,10 @@ public:
   /// This function can be used to convert "old style" graphs (storage format 1,
   /// where types are represented by uint8 properties) and "new style"
   /// graphs (version > 2, where types are represented in our native type
-  /// represenation). This function is serial but it likely iterates over
-  /// O(nodes) and O(edges) vectors, so it is very slow. It should only be used
-  /// for updating old graphs.
+  /// represenation). It makes two parallel passes over the rows, one to find
+  /// the combinations of types and one to assign IDs, so it is still costly
+  /// for large graphs. It should only be used for updating old graphs and
+  /// importing.
   ///
   /// The length of entity_type_ids should be equal to topo_size.
   /// properties->num_rows() should be equal to the length of entity_type_ids or
@@ -313,31 +314,13 @@ public:
     }
 
     // We cannot use KATANA_CHECKED here because nvcc cannot handle it.
-    auto res =
-        DoAssignEntityTypeIDsFromProperties(properties, entity_type_manager);
+    auto res = DoAssignEntityTypeIDsFromProperties(
+        properties, entity_type_manager, entity_type_ids->data());
     if (!res) {
       return katana::Result<std::vector<std::string>>(std::move(res.error()));
     }
     TypeProperties type_properties = std::move(res.value());
 
-    // assign the type ID for each row
-    for (int64_t row = 0; row < num_rows; ++row) {
-      TypeProperties::FieldEntity field_indices;
-      for (auto& uint8_property : type_properties.uint8_properties) {
-        if (uint8_property.array->IsValid(row) &&
-            uint8_property.array->Value(row)) {
-          field_indices.emplace_back(uint8_property.field_index);
-        }
-      }
-      if (field_indices.empty()) {
-        entity_type_ids->at(row) = katana::kUnknownEntityType;
-      } else {
-        katana::EntityTypeID entity_type_id =
-            type_properties.type_field_indices_to_id.at(field_indices);
-        entity_type_ids->at(row) = entity_type_id;
-      }
-    }
-
     std::vector<std::string> properties_used;
     for (const auto& prop_col : type_properties.uint8_properties) {
       properties_used.emplace_back(
@@ -575,11 +558,31 @@ public:
   bool IsSubtypeOf(EntityTypeID sub_type, EntityTypeID super_type) const {
     const auto& super_atomic_types = GetAtomicSubtypes(super_type);
     const auto& sub_atomic_types = GetAtomicSubtypes(sub_type);
-    // return true if sub_atomic_types is a subset of super_atomic_types
-    SetOfEntityTypeIDs res;
-    res.resize(SetOfEntityTypeIDsSize_);
-    res.bitwise_and(sub_atomic_types, super_atomic_types);
-    return (res == sub_atomic_types);
+    // return true if sub_atomic_types is a subset of super_atomic_types;
+    // compare words in place since this is called once per entity by filters
+    const auto& sub_words = sub_atomic_types.get_vec();
+    const auto& super_words = super_atomic_types.get_vec();
+    for (size_t i = 0, n = sub_words.size(); i < n; ++i) {
+      uint64_t super_word = i < super_words.size() ? super_words[i] : 0;
+      if ((sub_words[i] & ~super_word) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// \returns a table indexed by entity type ID that is 1 for the types that
+  /// have the type \p type, i.e., include all of its atomic types, and 0 for
+  /// the rest. Checking an entity type ID against the table is a single byte
+  /// load, so filters over many entities should build it once rather than
+  /// call IsSubtypeOf per entity.
+  /// (assumes that the type EntityTypeID exists)
+  std::vector<uint8_t> MakeHasTypeTable(EntityTypeID type) const {
+    std::vector<uint8_t> table(GetNumEntityTypes(), 0);
+    for (size_t id = 0, n = table.size(); id < n; ++id) {
+      table[id] = IsSubtypeOf(type, id);
+    }
+    return table;
   }
 
   const EntityTypeIDToSetOfEntityTypeIDsMap&
@@ -670,9 +673,12 @@ private:
   Result<EntityTypeID> AddNonAtomicEntityType(
       const SetOfEntityTypeIDs& type_id_set);
 
+  /// Add the types of \p properties to \p entity_type_manager and write the
+  /// type ID of each row to \p entity_type_ids. Rows are visited in parallel,
+  /// but IDs are assigned in the same order as by a serial pass.
   static Result<TypeProperties> DoAssignEntityTypeIDsFromProperties(
       const std::shared_ptr<arrow::Table>& properties,
-      EntityTypeManager* entity_type_manager);
+      EntityTypeManager* entity_type_manager, EntityTypeID* entity_type_ids);
 
   void Init() {
     // assume kUnknownEntityType is 0
@@ -3,16 +3,24 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <string>
 
 #include <arrow/status.h>
 #include <parquet/arrow/writer.h>
 
+#include "katana/FileStorage.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 
 namespace katana {
 
+/// An output stream to a buffer that is stored at path when persisted.
+///
+/// After StartUpload, the frame instead stores its bytes in parts of a
+/// fixed size as they are written: a full part is uploaded from the buffer
+/// while writing continues into a second one, so that serializing overlaps
+/// with storing and the frame holds at most two parts in memory.
 class KATANA_EXPORT FileFrame : public arrow::io::OutputStream {
   std::string path_;
   uint8_t* map_start_;
@@ -22,10 +30,27 @@ class KATANA_EXPORT FileFrame : public arrow::io::OutputStream {
   bool valid_ = false;
   bool synced_ = false;
 
+  /// Set by StartUpload; the buffer is then two parts, one being written at
+  /// cursor_ and the other, if pending_ is valid, being uploaded
+  std::unique_ptr<FileUpload> upload_;
+  uint64_t part_size_{0};
+  /// The offset in the file of the part being written
+  uint64_t part_offset_{0};
+  std::future<katana::CopyableResult<void>> pending_;
+
   katana::Result<void> GrowBuffer(int64_t accommodate);
 
   katana::Result<void> MapContguousExtension(uint64_t new_size);
 
+  /// The offset in the buffer of the part being written
+  uint64_t part_start() const {
+    return part_offset_ / part_size_ % 2 * part_size_;
+  }
+  katana::Result<void> WaitForPending();
+  /// Upload the full part being written and start writing the other one
+  katana::Result<void> UploadPart();
+  katana::Result<void> UploadWrite(const uint8_t* data, uint64_t nbytes);
+
 public:
   FileFrame() = default;
   FileFrame(const FileFrame&) = delete;
@@ -38,7 +63,11 @@ public:
         region_size_(other.region_size_),
         cursor_(other.cursor_),
         valid_(other.valid_),
-        synced_(other.synced_) {
+        synced_(other.synced_),
+        upload_(std::move(other.upload_)),
+        part_size_(other.part_size_),
+        part_offset_(other.part_offset_),
+        pending_(std::move(other.pending_)) {
     other.valid_ = false;
   }
 
@@ -54,6 +83,10 @@ public:
       cursor_ = other.cursor_;
       synced_ = other.synced_;
       valid_ = other.valid_;
+      upload_ = std::move(other.upload_);
+      part_size_ = other.part_size_;
+      part_offset_ = other.part_offset_;
+      pending_ = std::move(other.pending_);
       other.valid_ = false;
     }
     return *this;
@@ -67,6 +100,19 @@ public:
 
   katana::Result<void> Destroy();
 
+  /// Parts of uploads; object stores want parts of at least a few megabytes
+  static constexpr uint64_t kDefaultPartSize = UINT64_C(8) << 20;
+
+  /// Store the frame at its path in parts of part_size bytes, a multiple of
+  /// kBlockSize, as they are written rather than all at once when persisted;
+  /// see FileUpload. Call it on a bound frame before writing to it. Since
+  /// uploaded bytes are gone from the buffer, ptr and SetCursor cannot be
+  /// used with uploads. If the storage of path has no multipart uploads, the
+  /// frame is stored whole when persisted as usual.
+  katana::Result<void> StartUpload(uint64_t part_size = kDefaultPartSize);
+
+  /// Store what was written at path, or with StartUpload, upload what is
+  /// left and complete the upload
   katana::Result<void> Persist();
   std::future<katana::CopyableResult<void>> PersistAsync();
 
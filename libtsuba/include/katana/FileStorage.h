@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
@@ -14,6 +15,26 @@ namespace katana {
 
 struct StatBuf;
 
+/// An object stored in parts while it is still being written, so that
+/// writers need not hold all of it in memory. The object appears at its URI,
+/// whole, only once the upload is completed; an upload that is aborted, or
+/// destroyed before it completes, leaves nothing behind.
+class KATANA_EXPORT FileUpload {
+public:
+  FileUpload() = default;
+  FileUpload(const FileUpload& no_copy) = delete;
+  FileUpload& operator=(const FileUpload& no_copy) = delete;
+  virtual ~FileUpload();
+
+  /// Put size bytes of data at offset of the object. Parts are put one at a
+  /// time in order of offset, and all parts but the last are the same size,
+  /// which object stores may require to be at least a few megabytes.
+  virtual katana::Result<void> PutPart(
+      uint64_t offset, const uint8_t* data, uint64_t size) = 0;
+  virtual katana::Result<void> Complete() = 0;
+  virtual katana::Result<void> Abort() = 0;
+};
+
 class KATANA_EXPORT FileStorage {
   std::string uri_scheme_;
 
@@ -39,6 +60,12 @@ public:
   virtual katana::Result<void> PutMultiSync(
       const std::string& uri, const uint8_t* data, uint64_t size) = 0;
 
+  /// Start an upload of the object at uri in parts. Returns
+  /// ErrorCode::NotImplemented, the default, if the storage has no
+  /// multipart uploads.
+  virtual katana::Result<std::unique_ptr<FileUpload>> CreateUpload(
+      const std::string& uri);
+
   virtual katana::Result<void> RemoteCopy(
       const std::string& source_uri, const std::string& dest_uri,
       uint64_t begin, uint64_t size) = 0;
@@ -16,7 +16,26 @@ namespace katana {
 
 class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
 public:
-  FileView() = default;
+  /// MapMode controls how bound regions of a file are brought into memory.
+  ///
+  /// kCopy reserves anonymous memory and copies pages in from storage on
+  /// demand. kMapPrivate and kMapShared map local files directly (falling back
+  /// to kCopy for non-local URIs) so that loads skip the copy, the page cache
+  /// is shared with other processes and untouched pages are never read.
+  /// kMapPrivate mappings are copy-on-write; kMapShared mappings are read-only.
+  enum class MapMode {
+    kCopy,
+    kMapPrivate,
+    kMapShared,
+  };
+
+  /// The mode used by default constructed FileViews. It is read once from the
+  /// environment variable KATANA_FILE_VIEW_MAP_MODE (one of "copy",
+  /// "private" or "shared") and is kCopy if the variable is unset.
+  static MapMode DefaultMapMode();
+
+  FileView() : map_mode_(DefaultMapMode()) {}
+  explicit FileView(MapMode map_mode) : map_mode_(map_mode) {}
   FileView(const FileView&) = delete;
   FileView& operator=(const FileView&) = delete;
 
@@ -25,8 +44,12 @@ public:
         file_size_(other.file_size_),
         page_shift_(other.page_shift_),
         cursor_(other.cursor_),
+        last_read_end_(other.last_read_end_),
+        readahead_(other.readahead_),
         mem_start_(other.mem_start_),
         filename_(std::move(other.filename_)),
+        map_mode_(other.map_mode_),
+        file_mapped_(other.file_mapped_),
         bound_(other.bound_),
         filling_(std::move(other.filling_)),
         fetches_(std::move(other.fetches_)) {
@@ -42,8 +65,12 @@ public:
       file_size_ = other.file_size_;
       page_shift_ = other.page_shift_;
       cursor_ = other.cursor_;
+      last_read_end_ = other.last_read_end_;
+      readahead_ = other.readahead_;
       mem_start_ = other.mem_start_;
       filename_ = std::move(other.filename_);
+      map_mode_ = other.map_mode_;
+      file_mapped_ = other.file_mapped_;
       bound_ = other.bound_;
       filling_ = std::move(other.filling_);
       fetches_ =
@@ -77,8 +104,19 @@ public:
 
   katana::Result<void> Fill(uint64_t begin, uint64_t end, bool resolve);
 
+  /// Give back the memory of the pages entirely within [begin, end), so that
+  /// a file larger than memory can be scanned a region at a time. Released
+  /// pages must be filled again before they are read.
+  katana::Result<void> Release(uint64_t begin, uint64_t end);
+
   bool Valid() const { return bound_; }
 
+  MapMode map_mode() const { return map_mode_; }
+
+  /// True if the bound file is mapped directly rather than copied in. Only
+  /// meaningful when Valid().
+  bool file_mapped() const { return file_mapped_; }
+
   katana::Result<void> Unbind();
 
   /// Be very careful with this function. It is the caller's responsibility to
@@ -112,6 +150,10 @@ public:
   uint64_t size() const { return file_size_; }
   const std::string& filename() const { return filename_; }
 
+  /// The granularity at which the bound file is fetched from storage. Chosen
+  /// per file by Bind based on the size of the file and its backing store.
+  uint64_t page_size() const { return UINT64_C(1) << page_shift_; }
+
   // support iterating through characters
   const char* begin() const { return ptr<char>(); }
   const char* end() const { return ptr<char>() + size(); }
@@ -129,6 +171,19 @@ public:
   ///// End arrow::io::RandomAccessFile methods ///////
 
 private:
+  /// Page size for remote files (64K)
+  static constexpr uint8_t kRemotePageShift = 16;
+  /// Page size for local files (1M)
+  static constexpr uint8_t kLocalPageShift = 20;
+  static constexpr uint8_t kMaxPageShift = 30;
+  /// Pages are grown beyond the defaults above to keep at most this many
+  /// pages per file
+  static constexpr uint64_t kMaxPages = UINT64_C(1) << 22;
+  /// Upper bound on the sequential readahead window (16M)
+  static constexpr int64_t kMaxReadahead = INT64_C(16) << 20;
+
+  static uint8_t ChoosePageShift(uint64_t file_size, bool is_local);
+
   // Given the size of some region, how many pages does it take up?
   uint64_t page_number(uint64_t size);
 
@@ -148,12 +203,18 @@ private:
 
   katana::Result<void> MarkFilled(
       uint64_t* bitmap, uint64_t begin, uint64_t end);
+  // Inverse of MarkFilled; begin and end are inclusive like MarkFilled
+  void ClearFilled(uint64_t* bitmap, uint64_t begin, uint64_t end);
+
+  // Map a local file directly according to map_mode_
+  katana::Result<void*> MapFile(const std::string& path, uint64_t size);
 
   // Resolve all outstanding reads that overlap with the range [cursor_, nbytes]
   katana::Result<void> Resolve(int64_t start, int64_t size);
 
   // Start asynchronously fetching data that we think we might need from storage
-  // @start and @size give the location and range of the previous read
+  // @start and @size give the location and range of the previous read. Data is
+  // only fetched ahead of reads that continue where the previous one ended.
   katana::Result<void> PreFetch(int64_t start, int64_t size);
 
   struct FillingRange {
@@ -166,8 +227,14 @@ private:
   int64_t file_size_{0};
   uint8_t page_shift_{0};
   int64_t cursor_{0};
+  // end of the previous Read, used to detect sequential access
+  int64_t last_read_end_{0};
+  // current readahead window in bytes
+  int64_t readahead_{0};
   int64_t mem_start_{0};
   std::string filename_;
+  MapMode map_mode_{MapMode::kCopy};
+  bool file_mapped_{false};
   bool bound_{false};
   std::vector<uint64_t> filling_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
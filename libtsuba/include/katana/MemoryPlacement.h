@@ -0,0 +1,45 @@
+#ifndef KATANA_LIBTSUBA_KATANA_MEMORYPLACEMENT_H_
+#define KATANA_LIBTSUBA_KATANA_MEMORYPLACEMENT_H_
+
+#include <cstdint>
+#include <memory>
+
+#include <arrow/api.h>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Where the large arrays of a loaded graph live in memory. The placed
+/// policies copy arrays into huge pages faulted in by the worker threads,
+/// which cuts TLB misses on graphs much larger than the TLB reach of 4 KiB
+/// pages.
+enum class MemoryPlacement {
+  /// Leave arrays where loading put them: topology arrays are interleaved,
+  /// property columns are wherever Arrow allocated or mapped them
+  kDefault,
+  /// Spread pages round robin over the NUMA nodes of the threads; best for
+  /// arrays accessed at random, such as properties read through edges
+  kInterleaved,
+  /// Give each thread a contiguous block; best for loops over node ranges
+  /// where each thread mostly touches its own block
+  kBlocked,
+};
+
+/// \returns array as a single chunk in memory placed per placement if it is
+/// a fixed width column of at least min_bytes bytes, and array otherwise.
+/// Must be called from the main thread, which owns the thread pool that
+/// faults in the pages.
+KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> PlaceInMemory(
+    const std::shared_ptr<arrow::ChunkedArray>& array,
+    MemoryPlacement placement, uint64_t min_bytes);
+
+/// PlaceInMemory every column of table
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> PlaceInMemory(
+    const std::shared_ptr<arrow::Table>& table, MemoryPlacement placement,
+    uint64_t min_bytes);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,240 @@
+#ifndef KATANA_LIBTSUBA_KATANA_PACKEDLISTS_H_
+#define KATANA_LIBTSUBA_KATANA_PACKEDLISTS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/FileView.h"
+#include "katana/FingerprintScreen.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Lists of trivially copyable values packed the way a CSR graph packs its
+/// edges, for optional datastructures to store as a single flat file that
+/// maps without parsing. The layout, in native byte order, is
+///
+///   uint64_t num_lists;
+///   uint64_t offsets[num_lists + 1];  // offsets[0] == 0
+///   T values[offsets[num_lists]];     // padded to a multiple of 8 bytes
+///
+/// so that list i is values[offsets[i], offsets[i + 1]). PackedLists either
+/// own their buffer or view a mapped file, which copies share.
+template <typename T>
+class PackedLists {
+  static_assert(std::is_trivially_copyable_v<T>);
+  static_assert(alignof(T) <= alignof(uint64_t));
+
+public:
+  /// The values of one list
+  struct List {
+    const T* first;
+    const T* last;
+
+    const T* begin() const { return first; }
+    const T* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    const T& operator[](size_t i) const { return first[i]; }
+  };
+
+  /// No lists
+  PackedLists() : buffer_{0, 0} {}
+
+  /// Pack lists, a range of elements that project maps to ranges with a
+  /// size() and values convertible to T
+  template <typename Lists, typename Project>
+  static PackedLists Pack(const Lists& lists, Project project) {
+    std::vector<uint64_t> sizes;
+    sizes.reserve(std::size(lists));
+    for (const auto& list : lists) {
+      sizes.emplace_back(std::size(project(list)));
+    }
+    return Build(sizes, [&](T* values, const PackedLists&) {
+      for (const auto& list : lists) {
+        for (const auto& value : project(list)) {
+          *values++ = value;
+        }
+      }
+    });
+  }
+
+  /// Lists of the given sizes, zeroed and then filled by fill(values, lists)
+  /// where list i starts at values + lists.offset(i), so that callers may
+  /// fill them in parallel
+  template <typename Fill>
+  static PackedLists Build(const std::vector<uint64_t>& sizes, Fill fill) {
+    PackedLists packed;
+    packed.buffer_.assign(2 + sizes.size(), 0);
+    packed.buffer_[0] = sizes.size();
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      packed.buffer_[2 + i] = packed.buffer_[1 + i] + sizes[i];
+    }
+    packed.buffer_.resize(
+        packed.buffer_.size() + ValueWords(packed.buffer_.back()), 0);
+    fill(const_cast<T*>(packed.values()), std::as_const(packed));
+    return packed;
+  }
+
+  /// Pack lists, a range of ranges with a size() and values convertible to T
+  template <typename Lists>
+  static PackedLists Pack(const Lists& lists) {
+    return Pack(lists, [](const auto& list) -> const auto& { return list; });
+  }
+
+  /// View the lists packed in a file, which must stay as it is while the
+  /// lists are in use
+  static katana::Result<PackedLists> Map(std::shared_ptr<katana::FileView> fv) {
+    if (fv->size() < 2 * sizeof(uint64_t)) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "packed lists file is too small");
+    }
+    const uint64_t* words = fv->ptr<uint64_t>();
+    uint64_t num_words = fv->size() / sizeof(uint64_t);
+    uint64_t num_lists = words[0];
+    if (num_lists > num_words - 2) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "packed lists file is truncated: {} lists in {} bytes", num_lists,
+          fv->size());
+    }
+    const uint64_t* offsets = words + 1;
+    if (offsets[0] != 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "packed lists do not start at 0");
+    }
+    for (uint64_t i = 0; i < num_lists; ++i) {
+      if (offsets[i + 1] < offsets[i]) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "packed list {} ends before it starts",
+            i);
+      }
+    }
+    uint64_t max_values =
+        (num_words - 2 - num_lists) * sizeof(uint64_t) / sizeof(T);
+    if (offsets[num_lists] > max_values) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "packed lists file is truncated: {} values in {} bytes",
+          offsets[num_lists], fv->size());
+    }
+
+    PackedLists packed;
+    packed.file_ = std::move(fv);
+    return packed;
+  }
+
+  size_t size() const { return words()[0]; }
+
+  bool empty() const { return size() == 0; }
+
+  /// The position of the first value of list i among all values
+  uint64_t offset(size_t i) const { return words()[1 + i]; }
+
+  List operator[](size_t i) const {
+    return List{values() + offset(i), values() + offset(i + 1)};
+  }
+
+  /// The bytes to store, in the layout above
+  const void* data() const { return words(); }
+  uint64_t size_bytes() const {
+    if (file_) {
+      return file_->size();
+    }
+    return buffer_.size() * sizeof(uint64_t);
+  }
+
+private:
+  /// The number of words that hold num_values values
+  static uint64_t ValueWords(uint64_t num_values) {
+    return (num_values * sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+  }
+
+  const uint64_t* words() const {
+    if (file_) {
+      return file_->ptr<uint64_t>();
+    }
+    return buffer_.data();
+  }
+
+  const T* values() const {
+    return reinterpret_cast<const T*>(words() + 2 + words()[0]);
+  }
+
+  // Pointers are recomputed on every access so that copies of owned lists
+  // stay valid.
+  std::vector<uint64_t> buffer_;
+  std::shared_ptr<katana::FileView> file_;
+};
+
+/// Pack bitsets as a row-major matrix: each list is the number of bits of a
+/// bitset followed by its words, padded with zeros to the words of the
+/// longest one, so that consecutive rows are the same distance apart
+inline PackedLists<uint64_t>
+PackBitsets(const std::vector<katana::DynamicBitset>& bitsets) {
+  size_t num_words = 0;
+  for (const auto& bitset : bitsets) {
+    num_words = std::max(num_words, bitset.get_vec().size());
+  }
+  return PackedLists<uint64_t>::Pack(bitsets, [&](const auto& bitset) {
+    std::vector<uint64_t> words{bitset.size()};
+    words.insert(words.end(), bitset.get_vec().begin(), bitset.get_vec().end());
+    words.resize(1 + num_words, 0);
+    return words;
+  });
+}
+
+/// Check that mapped lists have the shape of bitsets packed by PackBitsets;
+/// their contents are not checked
+inline katana::Result<void>
+ValidateBitsets(const PackedLists<uint64_t>& packed) {
+  for (size_t i = 0; i < packed.size(); ++i) {
+    auto list = packed[i];
+    if (list.empty() || list.size() != packed[0].size() ||
+        list.size() - 1 < list[0] / 64 + (list[0] % 64 != 0)) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "packed bitset {} is malformed", i);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+inline std::vector<katana::DynamicBitset>
+UnpackBitsets(const PackedLists<uint64_t>& packed) {
+  std::vector<katana::DynamicBitset> bitsets(packed.size());
+  for (size_t i = 0; i < packed.size(); ++i) {
+    auto list = packed[i];
+    bitsets[i].resize(list[0]);
+    std::copy_n(
+        list.begin() + 1, bitsets[i].get_vec().size(),
+        bitsets[i].get_vec().begin());
+  }
+  return bitsets;
+}
+
+/// The rows of bitsets packed by PackBitsets, for screening them
+inline katana::FingerprintRows
+BitsetRows(const PackedLists<uint64_t>& packed) {
+  if (packed.empty()) {
+    return katana::FingerprintRows{};
+  }
+  auto first = packed[0];
+  return katana::FingerprintRows{
+      .words = first.begin() + 1,
+      .num_rows = packed.size(),
+      .num_words = first.size() - 1,
+      .stride = first.size(),
+  };
+}
+
+}  // namespace katana
+
+#endif
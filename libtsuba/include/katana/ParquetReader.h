@@ -25,9 +25,27 @@ public:
 
   struct ReadOpts {
     /// if true (default) make sure canonical types are used and table columns
-    /// are not chunked
+    /// are not chunked, but see combine_fixed_width_chunks
     bool make_canonical{true};
 
+    /// if true (default) row groups of a file are fetched concurrently and
+    /// decoded in parallel on the Arrow CPU thread pool (sized to
+    /// katana::getActiveThreads()), so decode of one row group overlaps with
+    /// fetching the next. Only applies to reads of whole tables.
+    bool parallel_decode{true};
+
+    /// if false, make_canonical leaves the columns of fixed width types in a
+    /// chunk per row group, which katana::PODPropertyView reads in place,
+    /// rather than copying them into one array; other columns are still
+    /// combined
+    bool combine_fixed_width_chunks{true};
+
+    /// if true, string and binary columns are read as arrow::DictionaryArrays
+    /// of the dictionaries Parquet stored them with instead of being decoded
+    /// into a value per row, which saves memory when values repeat; see
+    /// katana::DictionaryStringPropertyReadOnlyView
+    bool read_strings_as_dictionary{false};
+
     static ReadOpts Defaults() { return ReadOpts{}; }
   };
 
@@ -77,7 +95,13 @@ public:
   katana::Result<std::vector<std::string>> GetFiles(const katana::URI& uri);
 
 private:
-  ParquetReader(bool make_canonical) : make_canonical_{make_canonical} {}
+  ParquetReader(
+      bool make_canonical, bool parallel_decode,
+      bool combine_fixed_width_chunks, bool read_strings_as_dictionary)
+      : make_canonical_{make_canonical},
+        parallel_decode_{parallel_decode},
+        combine_fixed_width_chunks_{combine_fixed_width_chunks},
+        read_strings_as_dictionary_{read_strings_as_dictionary} {}
 
   katana::Result<std::shared_ptr<arrow::Table>> ReadFromUriSliced(
       const katana::URI& uri);
@@ -89,6 +113,9 @@ private:
       const std::shared_ptr<arrow::Schema>& schema);
 
   bool make_canonical_;
+  bool parallel_decode_;
+  bool combine_fixed_width_chunks_;
+  bool read_strings_as_dictionary_;
 };
 
 }  // namespace katana
@@ -31,6 +31,21 @@ public:
 
     /// control the approximate size of blocked files when writing blocked
     uint64_t mbs_per_block{256};
+
+    /// if true, tables larger than mbs_per_part are encoded and uploaded a
+    /// part at a time rather than buffered whole, so writing does not double
+    /// the memory held by the table. Parts are stored in the multi-file layout
+    /// that ParquetReader already understands
+    bool write_streaming{true};
+
+    /// control the approximate size of each part when writing streaming;
+    /// KATANA_PARQUET_WRITE_PART_MB overrides this
+    uint64_t mbs_per_part{128};
+
+    /// bound on encoded parts buffered waiting for their upload when writing
+    /// streaming; KATANA_PARQUET_WRITE_INFLIGHT_MB overrides this
+    uint64_t max_inflight_mbs{512};
+
     static WriteOpts Defaults() { return WriteOpts{}; }
   };
 
@@ -73,6 +88,10 @@ private:
       std::shared_ptr<arrow::Table> table, const katana::URI& uri,
       katana::WriteGroup* desc);
 
+  katana::Result<void> StoreParquetStreaming(
+      std::shared_ptr<arrow::Table> table, const katana::URI& uri,
+      katana::WriteGroup* desc);
+
   std::vector<std::shared_ptr<arrow::Table>> tables_;
   WriteOpts opts_;
 };
@@ -0,0 +1,72 @@
+#ifndef KATANA_LIBTSUBA_KATANA_PROPERTYSTATISTICS_H_
+#define KATANA_LIBTSUBA_KATANA_PROPERTYSTATISTICS_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <arrow/type_fwd.h>
+
+#include "katana/JSON.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Statistics of a range of rows [begin, end) of a property.
+///
+/// min and max are only kept for boolean and numeric properties. They are
+/// widened to doubles and rounded outward, so they bound the values in the
+/// range but need not be attained. Both are empty if every row is null.
+struct KATANA_EXPORT PropertyBlockStats {
+  uint64_t begin{0};
+  uint64_t end{0};
+  uint64_t null_count{0};
+  std::optional<double> min;
+  std::optional<double> max;
+
+  /// \returns false only if no value in this range can lie within [lo, hi]
+  bool MayContain(double lo, double hi) const;
+};
+
+/// A zone map of a property: statistics of the whole property and of each
+/// block of block_size consecutive rows, captured when the property is written
+struct KATANA_EXPORT PropertyStats {
+  uint64_t block_size{0};
+  PropertyBlockStats total;
+  std::vector<PropertyBlockStats> blocks;
+
+  /// \returns the row ranges of the blocks that may hold values in [lo, hi],
+  /// with adjacent ranges merged
+  std::vector<std::pair<uint64_t, uint64_t>> CandidateRanges(
+      double lo, double hi) const;
+};
+
+/// Compute the statistics of array in blocks of block_size rows
+KATANA_EXPORT katana::Result<PropertyStats> ComputePropertyStats(
+    const std::shared_ptr<arrow::ChunkedArray>& array, uint64_t block_size);
+
+/// A 64-bit hash of the type and the row values of array, independent of how
+/// it is chunked: FNV-1a of the FNV-1a hashes of blocks of rows, which are
+/// hashed in parallel. Writers record it so that a property whose contents
+/// did not change can keep referring to the files already on storage.
+///
+/// \returns nullopt for nested types, which are not hashed
+KATANA_EXPORT std::optional<uint64_t> ComputePropertyContentHash(
+    const std::shared_ptr<arrow::ChunkedArray>& array);
+
+/// The block size of statistics captured at write time, 1Mi rows unless
+/// KATANA_PROPERTY_STATS_BLOCK_ROWS says otherwise
+KATANA_EXPORT uint64_t PropertyStatsBlockSize();
+
+void to_json(nlohmann::json& j, const PropertyBlockStats& stats);
+void from_json(const nlohmann::json& j, PropertyBlockStats& stats);
+
+void to_json(nlohmann::json& j, const PropertyStats& stats);
+void from_json(const nlohmann::json& j, PropertyStats& stats);
+
+}  // namespace katana
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef KATANA_LIBTSUBA_KATANA_RDG_H_
 #define KATANA_LIBTSUBA_KATANA_RDG_H_
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -12,12 +13,15 @@
 #include <nlohmann/json.hpp>
 
 #include "katana/Cache.h"
+#include "katana/EntityIndexPrimitive.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
 #include "katana/FileFrame.h"
 #include "katana/FileView.h"
+#include "katana/MemoryPlacement.h"
 #include "katana/NUMAArray.h"
 #include "katana/PartitionMetadata.h"
+#include "katana/PropertyStatistics.h"
 #include "katana/RDGLineage.h"
 #include "katana/RDGStorageFormatVersion.h"
 #include "katana/RDGTopology.h"
@@ -27,6 +31,7 @@
 #include "katana/Result.h"
 #include "katana/TxnContext.h"
 #include "katana/URI.h"
+#include "katana/VectorIndexPrimitive.h"
 #include "katana/WriteGroup.h"
 #include "katana/config.h"
 #include "katana/tsuba.h"
@@ -37,6 +42,45 @@ class RDGManifest;
 class RDGCore;
 class PropStorageInfo;
 
+/// How a property column is laid out on storage
+enum class PropertyStorageFormat {
+  /// Compressed and encoded Parquet, the default
+  kParquet,
+  /// Uncompressed Arrow IPC, whose buffers are used in place on load without
+  /// decoding; best for large fixed-width columns
+  kArrowIPC,
+};
+
+/// The progress of a load, updated by the loading thread and readable from
+/// any other, which can also cancel the load
+struct KATANA_EXPORT RDGLoadProgress {
+  /// Properties the load reads; known once the load has read the metadata
+  std::atomic<uint64_t> properties_total{0};
+  std::atomic<uint64_t> properties_loaded{0};
+  /// In-memory size of the properties loaded so far
+  std::atomic<uint64_t> bytes_loaded{0};
+  std::atomic<bool> cancelled{false};
+
+  /// Ask the load to stop; it fails with ErrorCode::Cancelled at its next
+  /// check, between the properties and steps of the load
+  void Cancel() { cancelled = true; }
+
+  Result<void> CheckCancelled() const {
+    if (cancelled) {
+      return ErrorCode::Cancelled;
+    }
+    return ResultSuccess();
+  }
+
+  /// Record another property of the given in-memory size, then check for
+  /// cancellation
+  Result<void> PropertyLoaded(uint64_t bytes) {
+    properties_loaded += 1;
+    bytes_loaded += bytes;
+    return CheckCancelled();
+  }
+};
+
 struct KATANA_EXPORT RDGLoadOptions {
   /// Which partition of the RDG on storage should be loaded
   /// nullopt means the partition associated with the current host's ID will be
@@ -48,6 +92,38 @@ struct KATANA_EXPORT RDGLoadOptions {
   /// List of edge properties that should be loaded
   /// nullptr means all edge properties will be loaded
   std::optional<std::vector<std::string>> edge_properties{std::nullopt};
+  /// Register every property in the partition without loading any of them;
+  /// a PropertyGraph made with this option loads each property the first
+  /// time it is requested by name. In this mode node_properties and
+  /// edge_properties name the properties to prefetch in the background and
+  /// nullopt means prefetch nothing
+  bool lazy_load_properties{false};
+  /// Where to place the topology arrays a PropertyGraph copies out of the
+  /// RDG; kBlocked gives each thread the block of edges of its range of
+  /// nodes
+  MemoryPlacement topology_placement{MemoryPlacement::kDefault};
+  /// Where to place fixed width property columns loaded with the RDG.
+  /// Properties loaded lazily stay where they were loaded.
+  MemoryPlacement property_placement{MemoryPlacement::kDefault};
+  /// Columns smaller than this stay where they were loaded
+  uint64_t min_placed_property_bytes{uint64_t{1} << 26};
+  /// If false, fixed width properties keep a chunk per Parquet row group
+  /// instead of being copied into one array at load; PODPropertyView reads
+  /// them in place. Code that takes chunk(0) of a property needs the default.
+  bool combine_fixed_width_property_chunks{true};
+  /// If true, string properties stay dictionary encoded as Parquet stored
+  /// them; DictionaryStringPropertyReadOnlyView reads them. Properties with
+  /// stored deltas are decoded.
+  bool read_strings_as_dictionary{false};
+  /// If true, a property another RDG loaded with this option from the same
+  /// storage file, such as an unchanged property of another version of the
+  /// graph, is shared with it instead of loaded again. Shared properties
+  /// must not be modified in place. Copies made for property_placement are
+  /// not shared.
+  bool share_loaded_properties{false};
+  /// If set, the load reports its progress here and can be cancelled
+  /// through it
+  std::shared_ptr<RDGLoadProgress> progress;
 
   /// Build a default options struct the default behavior is:
   ///  * load the partition associated with this host
@@ -168,6 +244,30 @@ public:
   katana::Result<void> UpsertEdgeProperties(
       const std::shared_ptr<arrow::Table>& props, katana::TxnContext* txn_ctx);
 
+  /// Overwrite the rows of a loaded node property listed in row_ids with the
+  /// matching entries of values. Until the property is otherwise modified,
+  /// the next store writes only the changed rows as a delta file stacked on
+  /// the stored property.
+  katana::Result<void> UpdateNodePropertyRows(
+      const std::string& name, const std::vector<uint64_t>& row_ids,
+      const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx);
+
+  /// Overwrite rows of a loaded edge property; see UpdateNodePropertyRows
+  katana::Result<void> UpdateEdgePropertyRows(
+      const std::string& name, const std::vector<uint64_t>& row_ids,
+      const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx);
+
+  /// Append rows to every edge property; properties without a column in
+  /// rows get nulls. All edge properties must be loaded.
+  katana::Result<void> AppendEdgePropertyRows(
+      const std::shared_ptr<arrow::Table>& rows, katana::TxnContext* txn_ctx);
+
+  /// Replace every edge property with its rows at row_ids, a UInt64Array,
+  /// in that order. All edge properties must be loaded.
+  katana::Result<void> TakeEdgePropertyRows(
+      const std::shared_ptr<arrow::Array>& row_ids,
+      katana::TxnContext* txn_ctx);
+
   katana::Result<void> RemoveNodeProperty(int i, katana::TxnContext* txn_ctx);
   katana::Result<void> RemoveEdgeProperty(int i, katana::TxnContext* txn_ctx);
 
@@ -181,6 +281,18 @@ public:
   katana::Result<URI> GetNodePropertyStorageLocation(
       const std::string& name) const;
 
+  /// report the statistics of this property captured when it was last
+  /// written, or computed from memory if it has been modified since. Returns
+  /// NotFound for unloaded properties of RDGs written without statistics
+  katana::Result<PropertyStats> GetNodePropertyStats(
+      const std::string& name) const;
+
+  /// Read rows [begin, end) of a node property without loading it. A loaded
+  /// property is sliced without copying; an unloaded one is read from
+  /// storage, fetching only the row groups that hold the rows.
+  katana::Result<std::shared_ptr<arrow::ChunkedArray>> ReadNodePropertyRows(
+      const std::string& name, uint64_t begin, uint64_t end) const;
+
   /// Ensure the edge property at index `i` was written back to storage
   /// then free its memory
   katana::Result<void> UnloadEdgeProperty(int i);
@@ -191,6 +303,14 @@ public:
   katana::Result<URI> GetEdgePropertyStorageLocation(
       const std::string& name) const;
 
+  /// report the statistics of this property; see GetNodePropertyStats
+  katana::Result<PropertyStats> GetEdgePropertyStats(
+      const std::string& name) const;
+
+  /// Read rows of an edge property; see ReadNodePropertyRows
+  katana::Result<std::shared_ptr<arrow::ChunkedArray>> ReadEdgePropertyRows(
+      const std::string& name, uint64_t begin, uint64_t end) const;
+
   /// Load node property with a particular name and insert it into the
   /// property table at index. If index is invalid, the property is put
   /// in the last slot. A given property cannot be loaded more than once
@@ -202,6 +322,17 @@ public:
   /// cannot be loaded more than once
   katana::Result<void> LoadEdgeProperty(const std::string& name, int i = -1);
 
+  /// Choose how the named node property is stored from now on. A loaded
+  /// property whose format changes is rewritten on the next store; an unloaded
+  /// one must be loaded first.
+  katana::Result<void> SetNodePropertyStorageFormat(
+      const std::string& name, PropertyStorageFormat format);
+
+  /// Choose how the named edge property is stored from now on; see
+  /// SetNodePropertyStorageFormat
+  katana::Result<void> SetEdgePropertyStorageFormat(
+      const std::string& name, PropertyStorageFormat format);
+
   std::vector<std::string> ListFullNodeProperties() const;
   std::vector<std::string> ListLoadedNodeProperties() const;
   std::vector<std::string> ListFullEdgeProperties() const;
@@ -233,6 +364,11 @@ public:
   /// If it does, the RDG returns the topology
   katana::Result<katana::RDGTopology*> GetTopology(const RDGTopology& shadow);
 
+  /// Like GetTopology, but bind the topology with RDGTopology::BindSections
+  /// so that only the parts of it the caller fills are read from storage
+  katana::Result<katana::RDGTopology*> GetTopologySections(
+      const RDGTopology& shadow);
+
   katana::Result<void> UnbindNodeEntityTypeIDArrayFileStorage();
 
   /// Inform this RDG that its Node Entity Type ID Array is in storage at this
@@ -260,6 +396,10 @@ public:
 
   uint32_t partition_id() const;
 
+  /// Where a PropertyGraph made from this RDG places its topology, from the
+  /// options the RDG was loaded with
+  MemoryPlacement topology_placement() const;
+
   /// The node properties
   const std::shared_ptr<arrow::Table>& node_properties() const;
 
@@ -275,6 +415,14 @@ public:
   /// Remove topology data
   katana::Result<void> DropAllTopologies();
 
+  /// Forget the stored topologies derived from the CSR, whose edges no
+  /// longer match the graph's. They are not stored again.
+  void InvalidateDerivedTopologies();
+
+  /// Forget the stored topologies whose edges are sorted by the edge
+  /// property name, e.g., after its values changed
+  void InvalidateTopologiesSortedByEdgeProperty(const std::string& name);
+
   std::shared_ptr<arrow::Schema> full_node_schema() const;
 
   std::shared_ptr<arrow::Schema> full_edge_schema() const;
@@ -333,6 +481,22 @@ public:
   katana::Result<void> WriteRDKSubstructureIndexPrimitive(
       katana::RDKSubstructureIndexPrimitive& index);
 
+  // Returns std::nullopt if the RDG has no EntityIndexPrimitive
+  katana::Result<std::optional<katana::EntityIndexPrimitive>>
+  LoadEntityIndexPrimitive();
+
+  // Replaces any EntityIndexPrimitive written before
+  katana::Result<void> WriteEntityIndexPrimitive(
+      katana::EntityIndexPrimitive& index);
+
+  // Returns std::nullopt if the RDG has no VectorIndexPrimitive
+  katana::Result<std::optional<katana::VectorIndexPrimitive>>
+  LoadVectorIndexPrimitive();
+
+  // Replaces any VectorIndexPrimitive written before
+  katana::Result<void> WriteVectorIndexPrimitive(
+      katana::VectorIndexPrimitive& index);
+
 private:
   std::string view_type_;
   RDG(std::unique_ptr<RDGCore>&& core);
@@ -342,7 +506,7 @@ private:
   katana::Result<void> DoMake(
       const std::vector<PropStorageInfo*>& node_props_to_be_loaded,
       const std::vector<PropStorageInfo*>& edge_props_to_be_loaded,
-      const katana::URI& metadata_dir);
+      const katana::URI& metadata_dir, const RDGLoadOptions& opts);
 
   static katana::Result<RDG> Make(
       const RDGManifest& manifest, const RDGLoadOptions& opts);
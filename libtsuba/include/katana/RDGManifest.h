@@ -146,6 +146,10 @@ public:
   static bool IsManifestUri(const katana::URI& uri);
   std::string ToJsonString() const;
 
+  /// The manifest as it is stored: JSON text, or a binary encoding when the
+  /// BinaryRDGMetadata experimental feature is enabled. Make reads either.
+  katana::Result<std::string> Serialize() const;
+
   /// Return the set of file names that hold this RDG's data by reading partition files
   /// Useful to garbage collect unused files, and copy an RDG to a new location
   katana::Result<std::set<std::string>> FileNames();
@@ -8,6 +8,7 @@
 #include "katana/AtomicWrapper.h"
 #include "katana/DynamicBitset.h"
 #include "katana/ErrorCode.h"
+#include "katana/FileFrame.h"
 #include "katana/FileView.h"
 #include "katana/JSON.h"
 #include "katana/Logging.h"
@@ -71,6 +72,41 @@ public:
       const nlohmann::json& j, RDGOptionalDatastructure& data);
 
 protected:
+  /// Persist size bytes of data now as a new file in rdg_dir_path whose name
+  /// starts with prefix, and track it in paths_ so that it moves with the
+  /// RDG. \returns the path of the file relative to rdg_dir_path
+  katana::Result<std::string> WriteArray(
+      const katana::URI& rdg_dir_path, const std::string& prefix,
+      const void* data, uint64_t size) {
+    katana::URI path = rdg_dir_path.RandFile(prefix);
+    KATANA_CHECKED(WriteFile(path.string(), data, size));
+    paths_.emplace(path.BaseName(), path.BaseName());
+    return path.BaseName();
+  }
+
+  /// Map a file written by WriteArray without copying it
+  static katana::Result<std::shared_ptr<katana::FileView>> MapArray(
+      const katana::URI& rdg_dir_path, const std::string& path) {
+    auto fv = std::make_shared<katana::FileView>();
+    KATANA_CHECKED(fv->Bind(rdg_dir_path.Join(path).string(), true));
+    return fv;
+  }
+
+  static katana::Result<void> WriteFile(
+      const std::string& path, const void* data, uint64_t size) {
+    auto ff = std::make_unique<katana::FileFrame>();
+    KATANA_CHECKED(ff->Init(size));
+    if (auto res = ff->Write(data, size); !res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(res.code()), "arrow error: {}", res);
+    }
+    ff->Bind(path);
+    // persist now
+    KATANA_CHECKED(ff->Persist());
+
+    return katana::ResultSuccess();
+  }
+
   // map of exta files this optional datastructure will load
   // { "file_name" : "rdg-relative_path" }
   // track these so that when we move the RDG, we also move these extra files
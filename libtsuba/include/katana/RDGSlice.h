@@ -2,6 +2,7 @@
 #define KATANA_LIBTSUBA_KATANA_RDGSLICE_H_
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -65,6 +66,39 @@ public:
   static katana::Result<std::pair<std::vector<size_t>, std::vector<size_t>>>
   GetPerPartitionCounts(RDGHandle handle);
 
+  /// Make one slice per entry of slices, all from partition partition_id.
+  ///
+  /// The part header is read once and the topology, type id and property
+  /// ranges of all slices are read concurrently. Each property is read once
+  /// over the smallest range covering every slice and the property tables of
+  /// the returned slices are zero-copy slices of it, so they share buffers
+  /// instead of holding copies. Partition metadata arrays are shared the same
+  /// way.
+  static katana::Result<std::vector<RDGSlice>> MakeMany(
+      RDGHandle handle, const std::vector<SliceArg>& slices,
+      uint32_t partition_id = 0,
+      const std::optional<std::vector<std::string>>& node_props = std::nullopt,
+      const std::optional<std::vector<std::string>>& edge_props = std::nullopt);
+
+  /// Split the CSR topology of partition partition_id into num_slices
+  /// contiguous node ranges with roughly equal numbers of nodes plus edges,
+  /// e.g., one range per host for an edge-cut load.
+  ///
+  /// The topology range of each returned SliceArg starts at the out index of
+  /// its first node and ends after the destination of its last edge.
+  static katana::Result<std::vector<SliceArg>> ComputeSliceArgs(
+      RDGHandle handle, uint32_t num_slices, uint32_t partition_id = 0);
+
+  /// Split the CSR topology of partition partition_id into the node ranges
+  /// [node_boundaries[i], node_boundaries[i + 1]). node_boundaries must start
+  /// at 0, end at the number of nodes and not decrease.
+  ///
+  /// A graph whose nodes are sorted by a partition id property loads one part
+  /// per slice with the prefix sums of the sizes of the parts as boundaries.
+  static katana::Result<std::vector<SliceArg>> ComputeSliceArgs(
+      RDGHandle handle, const std::vector<uint64_t>& node_boundaries,
+      uint32_t partition_id = 0);
+
   // metadata sorts of things
   const katana::URI& rdg_dir() const;
   uint32_t partition_id() const;
@@ -145,6 +179,19 @@ private:
 
   RDGSlice(std::unique_ptr<RDGCore>&& core);
 
+  /// Called with the number of nodes, the number of edges and a function
+  /// from a node to the number of edges before it
+  using BoundariesFunc = std::function<katana::Result<std::vector<uint64_t>>(
+      uint64_t, uint64_t, const std::function<uint64_t(uint64_t)>&)>;
+
+  /// The slices between the node boundaries returned by compute_boundaries
+  static katana::Result<std::vector<SliceArg>> MakeSliceArgs(
+      RDGHandle handle, uint32_t partition_id,
+      const BoundariesFunc& compute_boundaries);
+
+  /// bind the topology and type id ranges of slice_arg_
+  katana::Result<void> BindSliceStorage(const katana::URI& metadata_dir);
+
   katana::Result<void> DoMake(
       const std::optional<std::vector<std::string>>& node_props,
       const std::optional<std::vector<std::string>>& edge_props,
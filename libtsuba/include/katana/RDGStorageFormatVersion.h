@@ -14,11 +14,15 @@ static const uint32_t kPartitionStorageFormatVersion3 = 3;
 static const uint32_t kPartitionStorageFormatVersion4 = 4;
 static const uint32_t kPartitionStorageFormatVersion5 = 5;
 static const uint32_t kPartitionStorageFormatVersion6 = 6;
+static const uint32_t kPartitionStorageFormatVersion7 = 7;
+static const uint32_t kPartitionStorageFormatVersion8 = 8;
+static const uint32_t kPartitionStorageFormatVersion9 = 9;
+static const uint32_t kPartitionStorageFormatVersion10 = 10;
 
 /// kLatestPartitionStorageFormatVersion to be bumped any time
 /// the on disk format of RDGPartHeader changes
 static const uint32_t kLatestPartitionStorageFormatVersion =
-    kPartitionStorageFormatVersion6;
+    kPartitionStorageFormatVersion10;
 
 };  // namespace katana
 
@@ -2,6 +2,8 @@
 #define KATANA_LIBTSUBA_KATANA_RDGTOPOLOGY_H_
 
 #include <array>
+#include <string>
+#include <vector>
 
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
@@ -37,14 +39,21 @@ public:
     kAny = 0,  // don't care. Sorted or Unsorted
     kSortedByDestID,
     kSortedByEdgeType,
-    kSortedByNodeType
+    kSortedByNodeType,
+    // by the value of an edge property, then by dest id; the name of the
+    // property is edge_sort_property()
+    kSortedByEdgeProperty
   };
 
   enum class NodeSortKind : int {
     kInvalid = -1,
     kAny = 0,
     kSortedByDegree,
-    kSortedByNodeType
+    kSortedByNodeType,
+    // locality improving orders, see ShuffleTopology
+    kReverseCuthillMcKee,
+    kHubClustered,
+    kClusteredByCommunity
   };
 
   enum class TopologyKind : int {
@@ -74,11 +83,14 @@ public:
   void unmap_file_storage() {
     adj_indices_ = nullptr;
     dests_ = nullptr;
+    decoded_adj_indices_ = std::vector<uint64_t>();
+    decoded_dests_ = std::vector<uint32_t>();
     edge_index_to_property_index_map_ = nullptr;
     node_index_to_property_index_map_ = nullptr;
     edge_condensed_type_id_map_ = nullptr;
     node_condensed_type_id_map_ = nullptr;
     file_store_mapped_ = false;
+    file_store_partial_ = false;
   }
 
   /// Invalidate the file store
@@ -179,6 +191,13 @@ public:
 
   EdgeSortKind edge_sort_state() const { return edge_sort_state_; }
 
+  /// The edge property the edges are sorted by if edge_sort_state() is
+  /// kSortedByEdgeProperty, empty otherwise
+  const std::string& edge_sort_property() const { return edge_sort_property_; }
+  void set_edge_sort_property(const std::string& name) {
+    edge_sort_property_ = name;
+  }
+
   NodeSortKind node_sort_state() const { return node_sort_state_; }
 
   std::string path() const;
@@ -237,8 +256,59 @@ public:
   /// ignore the size_of_edge_data (data[1]) and the
   /// void*[num_edges] edge_data
   /// defined by FileGraph.cpp
+  ///
+  /// Version 2 files, written when KATANA_TOPOLOGY_COMPRESSION is set, replace
+  /// out_indices and out_dests with delta encoded varints and are decoded
+  /// into memory owned by this RDGTopology when mapped:
+  ///
+  ///   uint64_t adj_indices_size: number of out_indices entries
+  ///   uint64_t adj_bytes: length of the encoded out_indices
+  ///   uint64_t[ceil(adj_indices_size / block)] adj_block_offsets
+  ///   uint64_t dests_bytes: length of the encoded out_dests
+  ///   uint64_t[ceil(num_edges / block)] dests_block_offsets
+  ///   uint8_t[adj_bytes] out_indices deltas, padded to 8 bytes
+  ///   uint8_t[dests_bytes] zigzag out_dests deltas, padded to 8 bytes
+  ///
+  /// Every block of kCompressedBlockSize entries starts its deltas from zero
+  /// at the recorded byte offset, so blocks decode independently.
+  /// The optional topology data structures follow unchanged.
   katana::Result<void> Map();
 
+  /// Bind only the header of an uncompressed topology file and point each
+  /// array at its place in the file without reading any of them. Callers read
+  /// the parts they need with FillNodes and FillEdges; touching an array
+  /// outside of what was filled is an error. Unlike Map, this does not
+  /// locate the condensed type ID maps.
+  ///
+  /// Compressed topology files and EdgeTypeAwareTopologies are not supported,
+  /// since their arrays cannot be indexed by node without reading them.
+  katana::Result<void> BindSections(const katana::URI& metadata_dir);
+
+  /// Read adj_indices and node_index_to_property_index_map for the nodes in
+  /// [begin, end), and the adj_indices entry before begin that locates the
+  /// first of their edges. Requires BindSections.
+  ///
+  /// \param property_maps whether to read the property index map too;
+  /// callers that never look up properties can skip it
+  katana::Result<void> FillNodes(
+      uint64_t begin, uint64_t end, bool property_maps = true);
+
+  /// Read dests and edge_index_to_property_index_map for the edges in
+  /// [begin, end). Requires BindSections.
+  katana::Result<void> FillEdges(
+      uint64_t begin, uint64_t end, bool property_maps = true);
+
+  /// Give back the memory holding the arrays of the nodes in [begin, end)
+  /// after a FillNodes, so that a topology larger than memory can be scanned
+  /// a range at a time. Memory shared with neighboring nodes is kept.
+  katana::Result<void> ReleaseNodes(uint64_t begin, uint64_t end);
+
+  /// Like ReleaseNodes, for the edges in [begin, end)
+  katana::Result<void> ReleaseEdges(uint64_t begin, uint64_t end);
+
+  /// True if this topology was bound with BindSections rather than mapped
+  bool partially_filled() const { return file_store_partial_; }
+
   /// Map a topology file and extract its metadata
   /// this only loads the topology metadata into the PartitionTopologyMetadataEntry
   /// *ONLY USE THIS FOR BACKWARDS COMPATIBILITY*
@@ -257,7 +327,8 @@ public:
   /// Create a shadow RDGTopology with parameters
   static katana::RDGTopology MakeShadow(
       TopologyKind topology_state, TransposeKind transpose_state,
-      EdgeSortKind edge_sort_state, NodeSortKind node_sort_state);
+      EdgeSortKind edge_sort_state, NodeSortKind node_sort_state,
+      const std::string& edge_sort_property = "");
 
   /// Create a shadow RDGTopology with default CSR state
   static katana::RDGTopology MakeShadowCSR();
@@ -320,6 +391,7 @@ private:
   TransposeKind transpose_state_{-1};
   EdgeSortKind edge_sort_state_{-1};
   NodeSortKind node_sort_state_{-1};
+  std::string edge_sort_property_;
   uint64_t edge_condensed_type_id_map_size_{0};
   uint64_t node_condensed_type_id_map_size_{0};
 
@@ -328,6 +400,9 @@ private:
   bool file_store_mapped_{false};
   /// Flag to show if we have bound the file at PartitionTopologyMetadataEntry.path_ to a file store
   bool file_store_bound_{false};
+  /// Flag to show if the file store was bound with BindSections, so only the
+  /// filled parts of it are in memory
+  bool file_store_partial_{false};
   /// Flag to show if the file on disk is up to date with our in memory represenation
   bool storage_valid_{false};
   /// Flag to show if this RDGTopology is invalid, and shouldn't be stored or used
@@ -347,6 +422,24 @@ private:
 
   FileView file_storage_;
 
+  /// Backing storage for adj_indices_ and dests_ when they were decoded from
+  /// a compressed topology file
+  std::vector<uint64_t> decoded_adj_indices_;
+  std::vector<uint32_t> decoded_dests_;
+
+  /// Decode the compressed sections of a version 2 file starting at cursor
+  /// \returns the position of the first optional data structure
+  katana::Result<const uint64_t*> MapCompressed(
+      const uint64_t* cursor, const uint64_t* end);
+
+  /// Read the size bytes of file_storage_ that start at start
+  katana::Result<void> FillBytes(const void* start, uint64_t size);
+  katana::Result<void> ReleaseBytes(const void* start, uint64_t size);
+
+  /// Write adj_indices and dests in the version 2 encoding
+  katana::Result<void> StoreCompressed(
+      FileFrame* ff, uint64_t adj_indices_size) const;
+
   static katana::Result<katana::RDGTopology> DoMake(
       katana::RDGTopology topo, const uint64_t* adj_indices, uint64_t num_nodes,
       const uint32_t* dests, uint64_t num_edges, TopologyKind topology_state,
@@ -355,6 +448,11 @@ private:
 
   size_t GetGraphSize() const;
 
+  // Topology File Versions
+  static constexpr uint64_t kUncompressedVersion = 1;
+  static constexpr uint64_t kCompressedVersion = 2;
+  static constexpr uint64_t kCompressedBlockSize = 1 << 14;
+
   // Topology File Offset Definitions
   static constexpr size_t version_num_offset = 0;
   static constexpr size_t num_nodes_offset_ = 2;
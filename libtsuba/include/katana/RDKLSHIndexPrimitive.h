@@ -1,7 +1,11 @@
 #ifndef KATANA_LIBTSUBA_KATANA_RDKLSHINDEXPRIMITIVE_H_
 #define KATANA_LIBTSUBA_KATANA_RDKLSHINDEXPRIMITIVE_H_
 
+#include <algorithm>
 #include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "katana/AtomicWrapper.h"
@@ -11,6 +15,7 @@
 #include "katana/JSON.h"
 #include "katana/Logging.h"
 #include "katana/NUMAArray.h"
+#include "katana/PackedLists.h"
 #include "katana/RDGOptionalDatastructure.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
@@ -24,7 +29,17 @@ const std::string kOptionalDatastructureRDKLSHIndexPrimitive =
     "kg.v1.rdk_lsh_index";
 const std::string kOptionalDatastructureRDKLSHIndexPrimitiveFilename =
     "rdk_lsh_index_manifest";
-
+const std::string kRDKLSHIndexPrimitiveHashKeysFilename = "rdk_lsh_hash_keys";
+const std::string kRDKLSHIndexPrimitiveHashValuesFilename =
+    "rdk_lsh_hash_values";
+const std::string kRDKLSHIndexPrimitiveFingerprintsFilename =
+    "rdk_lsh_fingerprints";
+const std::string kRDKLSHIndexPrimitiveSmilesFilename = "rdk_lsh_smiles";
+
+/// An LSH index over molecule fingerprints. The manifest is JSON, but the
+/// hash structure, fingerprints and smiles are each a file of PackedLists that
+/// Load maps without copying or parsing. Manifests written before that hold
+/// the arrays themselves, and still load.
 class KATANA_EXPORT RDKLSHIndexPrimitive
     : private katana::RDGOptionalDatastructure {
 public:
@@ -32,10 +47,26 @@ public:
       const katana::URI& rdg_dir_path, const std::string& path) {
     RDKLSHIndexPrimitive index =
         KATANA_CHECKED(LoadJson(rdg_dir_path.Join(path).string()));
+    KATANA_CHECKED(index.MapArrays(rdg_dir_path));
     return index;
   }
 
   katana::Result<std::string> Write(katana::URI rdg_dir_path) {
+    // Every array is written anew, so forget the files of earlier writes.
+    paths_.clear();
+    hash_keys_path_ = KATANA_CHECKED(WriteArray(
+        rdg_dir_path, kRDKLSHIndexPrimitiveHashKeysFilename, hash_keys_.data(),
+        hash_keys_.size_bytes()));
+    hash_values_path_ = KATANA_CHECKED(WriteArray(
+        rdg_dir_path, kRDKLSHIndexPrimitiveHashValuesFilename,
+        hash_values_.data(), hash_values_.size_bytes()));
+    fingerprints_path_ = KATANA_CHECKED(WriteArray(
+        rdg_dir_path, kRDKLSHIndexPrimitiveFingerprintsFilename,
+        fingerprints_.data(), fingerprints_.size_bytes()));
+    smiles_path_ = KATANA_CHECKED(WriteArray(
+        rdg_dir_path, kRDKLSHIndexPrimitiveSmilesFilename, smiles_.data(),
+        smiles_.size_bytes()));
+
     // Write out our json manifest
     katana::URI manifest_path = rdg_dir_path.RandFile(
         kOptionalDatastructureRDKLSHIndexPrimitiveFilename);
@@ -55,22 +86,90 @@ public:
   size_t num_fingerprints() const { return num_fingerprints_; }
   void set_num_fingerprints(const size_t num) { num_fingerprints_ = num; }
 
-  std::vector<std::map<uint64_t, std::vector<uint64_t>>>& hash_structure() {
-    return hash_structure_;
+  /// Copy the hash structure out of its packed form: for each bucket, the
+  /// ids of the fingerprints under each hash
+  std::vector<std::map<uint64_t, std::vector<uint64_t>>> hash_structure()
+      const {
+    std::vector<std::map<uint64_t, std::vector<uint64_t>>> hash_struct(
+        hash_keys_.size());
+    for (size_t bucket = 0; bucket < hash_keys_.size(); ++bucket) {
+      auto keys = hash_keys_[bucket];
+      for (size_t i = 0; i < keys.size(); ++i) {
+        auto values = hash_values_[hash_keys_.offset(bucket) + i];
+        hash_struct[bucket].emplace(
+            keys[i], std::vector<uint64_t>(values.begin(), values.end()));
+      }
+    }
+    return hash_struct;
   }
   void set_hash_structure(
-      std::vector<std::map<uint64_t, std::vector<uint64_t>>> hash_struct) {
-    hash_structure_ = std::move(hash_struct);
+      const std::vector<std::map<uint64_t, std::vector<uint64_t>>>&
+          hash_struct) {
+    std::vector<const std::vector<uint64_t>*> values;
+    for (const auto& hashes : hash_struct) {
+      for (const auto& [hash, ids] : hashes) {
+        values.emplace_back(&ids);
+      }
+    }
+    hash_keys_ = PackedLists<uint64_t>::Pack(hash_struct, [](const auto& m) {
+      std::vector<uint64_t> keys;
+      keys.reserve(m.size());
+      for (const auto& [hash, ids] : m) {
+        keys.emplace_back(hash);
+      }
+      return keys;
+    });
+    hash_values_ = PackedLists<uint64_t>::Pack(
+        values, [](const auto* ids) -> const auto& { return *ids; });
+  }
+
+  /// The ids of the fingerprints under hash in bucket, without copying
+  PackedLists<uint64_t>::List Find(size_t bucket, uint64_t hash) const {
+    auto keys = hash_keys_[bucket];
+    const uint64_t* it = std::lower_bound(keys.begin(), keys.end(), hash);
+    if (it == keys.end() || *it != hash) {
+      return PackedLists<uint64_t>::List{it, it};
+    }
+    return hash_values_[hash_keys_.offset(bucket) + (it - keys.begin())];
   }
 
-  std::vector<katana::DynamicBitset>& fingerprints() { return fingerprints_; }
-  void set_fingerprints(std::vector<katana::DynamicBitset> prints) {
-    fingerprints_ = std::move(prints);
+  /// Copy the fingerprints out of their packed form
+  std::vector<katana::DynamicBitset> fingerprints() const {
+    return UnpackBitsets(fingerprints_);
+  }
+  void set_fingerprints(const std::vector<katana::DynamicBitset>& prints) {
+    fingerprints_ = PackBitsets(prints);
+  }
+
+  /// The number of bits of fingerprint i
+  uint64_t fingerprint_size(size_t i) const { return fingerprints_[i][0]; }
+
+  /// The bits of fingerprint i as words of 64 bits, lowest first and with the
+  /// bits past fingerprint_size(i) clear, without copying
+  PackedLists<uint64_t>::List fingerprint_words(size_t i) const {
+    auto list = fingerprints_[i];
+    return PackedLists<uint64_t>::List{list.begin() + 1, list.end()};
+  }
+
+  /// The fingerprints as a row-major matrix, for FingerprintScreen
+  FingerprintRows fingerprint_rows() const { return BitsetRows(fingerprints_); }
+
+  std::vector<std::string> smiles() const {
+    std::vector<std::string> smiles;
+    smiles.reserve(smiles_.size());
+    for (size_t i = 0; i < smiles_.size(); ++i) {
+      smiles.emplace_back(smile(i));
+    }
+    return smiles;
+  }
+  void set_smiles(const std::vector<std::string>& smiles) {
+    smiles_ = PackedLists<char>::Pack(smiles);
   }
 
-  std::vector<std::string> smiles() { return smiles_; }
-  void set_smiles(std::vector<std::string> smiles) {
-    smiles_ = std::move(smiles);
+  /// The smiles string of fingerprint i, without copying
+  std::string_view smile(size_t i) const {
+    auto chars = smiles_[i];
+    return std::string_view(chars.begin(), chars.size());
   }
 
   friend void to_json(nlohmann::json& j, const RDKLSHIndexPrimitive& index);
@@ -82,14 +181,44 @@ private:
   uint64_t fingerprint_length_;
   size_t num_fingerprints_;
 
-  std::vector<std::string> smiles_;
-
   /// data structures dumped to their own files
 
-  std::vector<std::map<uint64_t, std::vector<uint64_t>>> hash_structure_;
-
-  // Array of fingerprint bitsets indexed on num_fingerprints_
-  std::vector<katana::DynamicBitset> fingerprints_;
+  // The sorted hashes of each bucket
+  PackedLists<uint64_t> hash_keys_;
+  // The ids of the fingerprints under each hash, in the order of hash_keys_
+  PackedLists<uint64_t> hash_values_;
+  // Fingerprint bitsets indexed on num_fingerprints_: see PackBitsets
+  PackedLists<uint64_t> fingerprints_;
+  // Smiles strings indexed on num_fingerprints_
+  PackedLists<char> smiles_;
+
+  // The files of the packed lists; empty for manifests that hold the arrays
+  std::string hash_keys_path_;
+  std::string hash_values_path_;
+  std::string fingerprints_path_;
+  std::string smiles_path_;
+
+  katana::Result<void> MapArrays(const katana::URI& rdg_dir_path) {
+    if (hash_keys_path_.empty()) {
+      return katana::ResultSuccess();
+    }
+    hash_keys_ = KATANA_CHECKED(PackedLists<uint64_t>::Map(
+        KATANA_CHECKED(MapArray(rdg_dir_path, hash_keys_path_))));
+    hash_values_ = KATANA_CHECKED(PackedLists<uint64_t>::Map(
+        KATANA_CHECKED(MapArray(rdg_dir_path, hash_values_path_))));
+    if (hash_values_.size() != hash_keys_.offset(hash_keys_.size())) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "LSH index has {} hashes but {} lists of ids",
+          hash_keys_.offset(hash_keys_.size()), hash_values_.size());
+    }
+    fingerprints_ = KATANA_CHECKED(PackedLists<uint64_t>::Map(
+        KATANA_CHECKED(MapArray(rdg_dir_path, fingerprints_path_))));
+    KATANA_CHECKED(ValidateBitsets(fingerprints_));
+    smiles_ = KATANA_CHECKED(PackedLists<char>::Map(
+        KATANA_CHECKED(MapArray(rdg_dir_path, smiles_path_))));
+    return katana::ResultSuccess();
+  }
 
   static katana::Result<RDKLSHIndexPrimitive> LoadJson(
       const std::string& path) {
@@ -110,18 +239,7 @@ private:
     std::string serialized = KATANA_CHECKED(katana::JsonDump(*this));
     // POSIX files end with newlines
     serialized = serialized + "\n";
-
-    auto ff = std::make_unique<katana::FileFrame>();
-    KATANA_CHECKED(ff->Init(serialized.size()));
-    if (auto res = ff->Write(serialized.data(), serialized.size()); !res.ok()) {
-      return KATANA_ERROR(
-          katana::ArrowToKatana(res.code()), "arrow error: {}", res);
-    }
-    ff->Bind(path);
-    // persist now
-    KATANA_CHECKED(ff->Persist());
-
-    return katana::ResultSuccess();
+    return WriteFile(path, serialized.data(), serialized.size());
   }
 };
 
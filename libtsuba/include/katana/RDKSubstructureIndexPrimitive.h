@@ -1,7 +1,10 @@
 #ifndef KATANA_LIBTSUBA_KATANA_RDKSUBSTRUCTUREINDEXPRIMITIVE_H_
 #define KATANA_LIBTSUBA_KATANA_RDKSUBSTRUCTUREINDEXPRIMITIVE_H_
 
+#include <algorithm>
 #include <cstdint>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "katana/AtomicWrapper.h"
@@ -11,6 +14,7 @@
 #include "katana/JSON.h"
 #include "katana/Logging.h"
 #include "katana/NUMAArray.h"
+#include "katana/PackedLists.h"
 #include "katana/RDGOptionalDatastructure.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
@@ -24,7 +28,17 @@ const std::string kOptionalDatastructureRDKSubstructureIndexPrimitive =
     "kg.v1.rdk_substructure_index";
 const std::string kOptionalDatastructureRDKSubstructureIndexPrimitiveFilename =
     "rdk_substructure_index_manifest";
-
+const std::string kRDKSubstructureIndexPrimitiveIndexFilename =
+    "rdk_substructure_index";
+const std::string kRDKSubstructureIndexPrimitiveFingerprintsFilename =
+    "rdk_substructure_fingerprints";
+const std::string kRDKSubstructureIndexPrimitiveSmilesFilename =
+    "rdk_substructure_smiles";
+
+/// A substructure index over molecule fingerprints. The manifest is JSON, but
+/// the index, fingerprints and smiles are each a file of PackedLists that
+/// Load maps without copying or parsing. Manifests written before that hold
+/// the arrays themselves, and still load.
 class KATANA_EXPORT RDKSubstructureIndexPrimitive
     : private katana::RDGOptionalDatastructure {
 public:
@@ -32,10 +46,23 @@ public:
       const katana::URI& rdg_dir_path, const std::string& path) {
     RDKSubstructureIndexPrimitive substructure_index =
         KATANA_CHECKED(LoadJson(rdg_dir_path.Join(path).string()));
+    KATANA_CHECKED(substructure_index.MapArrays(rdg_dir_path));
     return substructure_index;
   }
 
   katana::Result<std::string> Write(katana::URI rdg_dir_path) {
+    // Every array is written anew, so forget the files of earlier writes.
+    paths_.clear();
+    index_path_ = KATANA_CHECKED(WriteArray(
+        rdg_dir_path, kRDKSubstructureIndexPrimitiveIndexFilename,
+        index_.data(), index_.size_bytes()));
+    fingerprints_path_ = KATANA_CHECKED(WriteArray(
+        rdg_dir_path, kRDKSubstructureIndexPrimitiveFingerprintsFilename,
+        fingerprints_.data(), fingerprints_.size_bytes()));
+    smiles_path_ = KATANA_CHECKED(WriteArray(
+        rdg_dir_path, kRDKSubstructureIndexPrimitiveSmilesFilename,
+        smiles_.data(), smiles_.size_bytes()));
+
     // Write out our json manifest
     katana::URI manifest_path = rdg_dir_path.RandFile(
         kOptionalDatastructureRDKSubstructureIndexPrimitiveFilename);
@@ -49,19 +76,90 @@ public:
   size_t num_entries() const { return num_entries_; }
   void set_num_entries(size_t num) { num_entries_ = num; }
 
-  std::vector<std::vector<std::uint64_t>>& index() { return index_; }
-  void set_index(std::vector<std::vector<std::uint64_t>> index) {
-    index_ = std::move(index);
+  /// Copy the index out of its packed form
+  std::vector<std::vector<std::uint64_t>> index() const {
+    std::vector<std::vector<std::uint64_t>> index(index_.size());
+    for (size_t i = 0; i < index_.size(); ++i) {
+      index[i].assign(index_[i].begin(), index_[i].end());
+    }
+    return index;
+  }
+  void set_index(const std::vector<std::vector<std::uint64_t>>& index) {
+    index_ = PackedLists<uint64_t>::Pack(index);
   }
 
-  std::vector<katana::DynamicBitset>& fingerprints() { return fingerprints_; }
-  void set_fingerprints(std::vector<katana::DynamicBitset> prints) {
-    fingerprints_ = std::move(prints);
+  /// Entry i of the index, without copying
+  PackedLists<uint64_t>::List index_entry(size_t i) const { return index_[i]; }
+
+  /// Copy the fingerprints out of their packed form
+  std::vector<katana::DynamicBitset> fingerprints() const {
+    return UnpackBitsets(fingerprints_);
+  }
+  void set_fingerprints(const std::vector<katana::DynamicBitset>& prints) {
+    fingerprints_ = PackBitsets(prints);
   }
 
-  std::vector<std::string> smiles() { return smiles_; }
-  void set_smiles(std::vector<std::string> smiles) {
-    smiles_ = std::move(smiles);
+  /// The number of bits of fingerprint i
+  uint64_t fingerprint_size(size_t i) const { return fingerprints_[i][0]; }
+
+  /// The bits of fingerprint i as words of 64 bits, lowest first and with the
+  /// bits past fingerprint_size(i) clear, without copying
+  PackedLists<uint64_t>::List fingerprint_words(size_t i) const {
+    auto list = fingerprints_[i];
+    return PackedLists<uint64_t>::List{list.begin() + 1, list.end()};
+  }
+
+  /// The fingerprints as a row-major matrix, for FingerprintScreen
+  FingerprintRows fingerprint_rows() const { return BitsetRows(fingerprints_); }
+
+  /// \returns the entries whose fingerprints have every bit of query set, in
+  /// increasing order: the candidates for a substructure match
+  std::vector<uint64_t> ScreenSubstructures(
+      const katana::DynamicBitset& query) const {
+    FingerprintRows rows = fingerprint_rows();
+    std::vector<uint64_t> words = QueryWords(query, rows.num_words);
+    for (size_t i = rows.num_words; i < query.get_vec().size(); ++i) {
+      if (query.get_vec()[i] != 0) {
+        // no fingerprint has this bit
+        return {};
+      }
+    }
+    return katana::ScreenSubstructures(rows, words.data());
+  }
+
+  /// \returns the Tanimoto similarity of the fingerprint of each entry to
+  /// query, which must not have bits past the longest fingerprint
+  katana::Result<std::vector<double>> TanimotoSimilarities(
+      const katana::DynamicBitset& query) const {
+    FingerprintRows rows = fingerprint_rows();
+    for (size_t i = rows.num_words; i < query.get_vec().size(); ++i) {
+      if (query.get_vec()[i] != 0) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "query has {} bits but the fingerprints only {} words",
+            query.size(), rows.num_words);
+      }
+    }
+    std::vector<uint64_t> words = QueryWords(query, rows.num_words);
+    return katana::TanimotoSimilarities(rows, words.data());
+  }
+
+  std::vector<std::string> smiles() const {
+    std::vector<std::string> smiles;
+    smiles.reserve(smiles_.size());
+    for (size_t i = 0; i < smiles_.size(); ++i) {
+      smiles.emplace_back(smile(i));
+    }
+    return smiles;
+  }
+  void set_smiles(const std::vector<std::string>& smiles) {
+    smiles_ = PackedLists<char>::Pack(smiles);
+  }
+
+  /// The smiles string of entry i, without copying
+  std::string_view smile(size_t i) const {
+    auto chars = smiles_[i];
+    return std::string_view(chars.begin(), chars.size());
   }
 
   friend void to_json(
@@ -74,14 +172,45 @@ private:
 
   size_t num_entries_;
 
-  // Array of smiles strings indexed on num_entries
-  std::vector<std::string> smiles_;
+  /// data structures dumped to their own files
 
-  // Array of fingerprint bitsets indexed on num_entries
-  std::vector<katana::DynamicBitset> fingerprints_;
+  // Smiles strings indexed on num_entries
+  PackedLists<char> smiles_;
+
+  // Fingerprint bitsets indexed on num_entries: see PackBitsets
+  PackedLists<uint64_t> fingerprints_;
 
   // has size fp_size
-  std::vector<std::vector<std::uint64_t>> index_;
+  PackedLists<uint64_t> index_;
+
+  // The files of the packed lists; empty for manifests that hold the arrays
+  std::string index_path_;
+  std::string fingerprints_path_;
+  std::string smiles_path_;
+
+  /// The first num_words words of query, padded with zeros
+  static std::vector<uint64_t> QueryWords(
+      const katana::DynamicBitset& query, size_t num_words) {
+    std::vector<uint64_t> words(num_words, 0);
+    std::copy_n(
+        query.get_vec().begin(), std::min(num_words, query.get_vec().size()),
+        words.begin());
+    return words;
+  }
+
+  katana::Result<void> MapArrays(const katana::URI& rdg_dir_path) {
+    if (index_path_.empty()) {
+      return katana::ResultSuccess();
+    }
+    index_ = KATANA_CHECKED(PackedLists<uint64_t>::Map(
+        KATANA_CHECKED(MapArray(rdg_dir_path, index_path_))));
+    fingerprints_ = KATANA_CHECKED(PackedLists<uint64_t>::Map(
+        KATANA_CHECKED(MapArray(rdg_dir_path, fingerprints_path_))));
+    KATANA_CHECKED(ValidateBitsets(fingerprints_));
+    smiles_ = KATANA_CHECKED(PackedLists<char>::Map(
+        KATANA_CHECKED(MapArray(rdg_dir_path, smiles_path_))));
+    return katana::ResultSuccess();
+  }
 
   static katana::Result<RDKSubstructureIndexPrimitive> LoadJson(
       const std::string& path) {
@@ -103,18 +232,7 @@ private:
     std::string serialized = KATANA_CHECKED(katana::JsonDump(*this));
     // POSIX files end with newlines
     serialized = serialized + "\n";
-
-    auto ff = std::make_unique<katana::FileFrame>();
-    KATANA_CHECKED(ff->Init(serialized.size()));
-    if (auto res = ff->Write(serialized.data(), serialized.size()); !res.ok()) {
-      return KATANA_ERROR(
-          katana::ArrowToKatana(res.code()), "arrow error: {}", res);
-    }
-    ff->Bind(path);
-    // persist now
-    KATANA_CHECKED(ff->Persist());
-
-    return katana::ResultSuccess();
+    return WriteFile(path, serialized.data(), serialized.size());
   }
 };
 
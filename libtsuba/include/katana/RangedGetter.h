@@ -0,0 +1,153 @@
+#ifndef KATANA_LIBTSUBA_KATANA_RANGEDGETTER_H_
+#define KATANA_LIBTSUBA_KATANA_RANGEDGETTER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+struct KATANA_EXPORT RangedGetterOptions {
+  /// Size of the ranged requests that a get is split into
+  uint64_t part_size{UINT64_C(8) << 20};
+  /// Bounds and starting point of the number of requests in flight
+  uint32_t min_concurrency{2};
+  uint32_t max_concurrency{64};
+  uint32_t initial_concurrency{16};
+  /// Attempts of a request before its get fails, and the wait before the
+  /// first retry, which doubles with each retry
+  uint32_t max_attempts{4};
+  std::chrono::milliseconds retry_backoff{50};
+  /// Issue a second, hedged, request for a part when its first has been in
+  /// flight for hedge_multiple times the typical part latency, and use
+  /// whichever finishes first. Zero disables hedging.
+  double hedge_multiple{3.0};
+  /// Never hedge a request sooner than this
+  std::chrono::milliseconds min_hedge_delay{20};
+};
+
+/// A RangedGetter reads large ranges of remote objects at the throughput of
+/// the network rather than of a single request. It is for FileStorage
+/// backends of object stores, e.g., S3, GCS or Azure Blob, which implement
+/// GetMultiSync and GetAsync by calling Get and GetAsync of a RangedGetter
+/// made with a function that performs one ranged GET.
+///
+/// - A get is split into parts of part_size bytes that are requested in
+///   parallel. Parts of all gets share one limit on requests in flight.
+/// - Requests run on a fixed pool of max_concurrency threads, so a backend
+///   that keeps a connection per thread, e.g., a thread_local HTTP handle,
+///   reuses its connections across requests.
+/// - Failed requests are retried with exponential backoff.
+/// - A slow request is hedged: a second request for the same part is sent
+///   and the first to finish wins, which cuts the tail latency of a get to
+///   that of its parts' typical latency. Hedged parts are read into
+///   temporary buffers and copied, so that the loser never writes to the
+///   result.
+/// - The number of requests in flight adapts: it climbs while throughput
+///   improves, backs off when it drops and halves when requests fail, e.g.,
+///   because the store is throttling.
+class KATANA_EXPORT RangedGetter {
+public:
+  /// Read size bytes of the object at uri starting at start into result_buf.
+  /// Called concurrently from the threads of the getter.
+  using GetRangeFn = std::function<katana::Result<void>(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf)>;
+  using Options = RangedGetterOptions;
+
+  struct Stats {
+    uint64_t parts{0};
+    uint64_t retries{0};
+    uint64_t hedges{0};
+    /// Hedged requests that finished before the request they hedged
+    uint64_t hedge_wins{0};
+  };
+
+  explicit RangedGetter(GetRangeFn get_range, const Options& options = {});
+  ~RangedGetter();
+
+  RangedGetter(const RangedGetter& no_copy) = delete;
+  RangedGetter& operator=(const RangedGetter& no_copy) = delete;
+
+  katana::Result<void> Get(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf);
+
+  /// result_buf must remain valid until the returned future is ready
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf);
+
+  /// The current limit on requests in flight
+  uint32_t concurrency() const {
+    return concurrency_.load(std::memory_order_relaxed);
+  }
+
+  Stats GetStats() const;
+
+private:
+  struct Call;
+  struct Part;
+
+  struct Attempt {
+    std::shared_ptr<Call> call;
+    size_t part;
+    bool is_hedge;
+  };
+
+  void Work();
+  void Monitor();
+  void Run(const Attempt& attempt);
+  katana::Result<void> Request(const Attempt& attempt, uint8_t* buf);
+  void Finish(
+      const Attempt& attempt, katana::Result<void> res,
+      std::unique_ptr<uint8_t[]> buf,
+      std::chrono::steady_clock::duration latency);
+  void Adapt(uint64_t part_bytes, bool failed);
+
+  GetRangeFn get_range_;
+  Options options_;
+
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable monitor_cv_;
+  std::deque<Attempt> queue_;
+  /// Parts being requested, for the monitor to hedge
+  std::vector<Attempt> in_flight_;
+  uint32_t active_{0};
+  bool stopping_{false};
+
+  std::atomic<uint32_t> concurrency_;
+  /// Exponentially weighted average part latency, in seconds, 0 until known
+  double typical_latency_{0};
+  /// Throughput of the last adaptation window, for hill climbing
+  uint64_t window_bytes_{0};
+  uint64_t window_parts_{0};
+  std::chrono::steady_clock::time_point window_start_;
+  double last_throughput_{0};
+  int direction_{1};
+
+  std::atomic<uint64_t> parts_{0};
+  std::atomic<uint64_t> retries_{0};
+  std::atomic<uint64_t> hedges_{0};
+  std::atomic<uint64_t> hedge_wins_{0};
+
+  std::vector<std::thread> workers_;
+  std::thread monitor_;
+};
+
+}  // namespace katana
+
+#endif
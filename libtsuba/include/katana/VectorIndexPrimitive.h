@@ -0,0 +1,129 @@
+#ifndef KATANA_LIBTSUBA_KATANA_VECTORINDEXPRIMITIVE_H_
+#define KATANA_LIBTSUBA_KATANA_VECTORINDEXPRIMITIVE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/FileView.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/PackedLists.h"
+#include "katana/RDGOptionalDatastructure.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/config.h"
+#include "katana/tsuba.h"
+
+namespace katana {
+
+const std::string kOptionalDatastructureVectorIndexPrimitive =
+    "kg.v1.vector_index";
+const std::string kOptionalDatastructureVectorIndexPrimitiveFilename =
+    "vector_index_manifest";
+const std::string kVectorIndexPrimitiveCentroidsFilename =
+    "vector_index_centroids";
+const std::string kVectorIndexPrimitiveListsFilename = "vector_index_lists";
+const std::string kVectorIndexPrimitiveVectorsFilename =
+    "vector_index_vectors";
+
+/// The vector similarity indexes of a graph as stored in an RDG. Each index
+/// clusters the vectors of a node property and is three files of packed
+/// lists that map without parsing: the centroid of each cluster, the nodes of
+/// each cluster, and the vectors of those nodes in the same order. The
+/// manifest records which property each index covers.
+class KATANA_EXPORT VectorIndexPrimitive
+    : private katana::RDGOptionalDatastructure {
+public:
+  /// The files of a single index
+  struct IndexFiles {
+    std::string property_name;
+    /// The name of the distance the index ranks neighbors by
+    std::string metric;
+    uint64_t dimension{};
+    /// The number of nodes in the graph when the index was written
+    uint64_t num_entities{};
+    /// The number of vectors, i.e., of nodes whose property is not null
+    uint64_t num_entries{};
+    std::string centroids_path;
+    std::string lists_path;
+    std::string vectors_path;
+  };
+
+  static katana::Result<VectorIndexPrimitive> Load(
+      const katana::URI& rdg_dir_path, const std::string& path) {
+    VectorIndexPrimitive index =
+        KATANA_CHECKED(LoadJson(rdg_dir_path.Join(path).string()));
+    return index;
+  }
+
+  katana::Result<std::string> Write(katana::URI rdg_dir_path) {
+    // Write out our json manifest
+    katana::URI manifest_path = rdg_dir_path.RandFile(
+        kOptionalDatastructureVectorIndexPrimitiveFilename);
+    KATANA_CHECKED(WriteManifest(manifest_path.string()));
+    return manifest_path.BaseName();
+  }
+
+  /// Persist the lists of an index in rdg_dir_path now and add it to the
+  /// manifest with the paths of files filled in
+  katana::Result<void> AddIndex(
+      const katana::URI& rdg_dir_path, IndexFiles files,
+      const PackedLists<float>& centroids,
+      const PackedLists<uint32_t>& lists, const PackedLists<float>& vectors) {
+    files.centroids_path = KATANA_CHECKED(WriteArray(
+        rdg_dir_path, kVectorIndexPrimitiveCentroidsFilename, centroids.data(),
+        centroids.size_bytes()));
+    files.lists_path = KATANA_CHECKED(WriteArray(
+        rdg_dir_path, kVectorIndexPrimitiveListsFilename, lists.data(),
+        lists.size_bytes()));
+    files.vectors_path = KATANA_CHECKED(WriteArray(
+        rdg_dir_path, kVectorIndexPrimitiveVectorsFilename, vectors.data(),
+        vectors.size_bytes()));
+    indexes_.emplace_back(std::move(files));
+    return katana::ResultSuccess();
+  }
+
+  /// Map the packed lists of a file named by IndexFiles
+  template <typename T>
+  static katana::Result<PackedLists<T>> MapLists(
+      const katana::URI& rdg_dir_path, const std::string& path) {
+    return PackedLists<T>::Map(KATANA_CHECKED(MapArray(rdg_dir_path, path)));
+  }
+
+  const std::vector<IndexFiles>& indexes() const { return indexes_; }
+
+  friend void to_json(nlohmann::json& j, const VectorIndexPrimitive& index);
+  friend void from_json(const nlohmann::json& j, VectorIndexPrimitive& index);
+
+private:
+  std::vector<IndexFiles> indexes_;
+
+  static katana::Result<VectorIndexPrimitive> LoadJson(
+      const std::string& path) {
+    katana::FileView fv;
+    KATANA_CHECKED(fv.Bind(path, true));
+
+    if (fv.size() == 0) {
+      return VectorIndexPrimitive();
+    }
+
+    VectorIndexPrimitive index;
+    KATANA_CHECKED(katana::JsonParse<VectorIndexPrimitive>(fv, &index));
+
+    return index;
+  }
+
+  katana::Result<void> WriteManifest(const std::string& path) const {
+    std::string serialized = KATANA_CHECKED(katana::JsonDump(*this));
+    // POSIX files end with newlines
+    serialized = serialized + "\n";
+    return WriteFile(path, serialized.data(), serialized.size());
+  }
+};
+
+}  // namespace katana
+
+#endif
@@ -23,11 +23,14 @@ class KATANA_EXPORT WriteGroup {
 
   std::string tag_;
   std::atomic<uint64_t> outstanding_size_{0};
+  uint64_t max_outstanding_size_;
   AsyncOpGroup async_op_group_;
 
-  WriteGroup(std::string tag) : tag_(std::move(tag)){};
+  WriteGroup(std::string tag);
 
 public:
+  /// default for max_outstanding_size(); KATANA_WRITE_GROUP_MAX_INFLIGHT_MB
+  /// overrides it
   static constexpr uint64_t kMaxOutstandingSize = 10ULL << 30;  // 10 GB
 
   /// Build a descriptor with a tag. If running with multiple hosts, Make should
@@ -48,11 +51,21 @@ public:
     AddOp(FileStoreAsync(file, buf, size), file);
   }
 
-  void AddToOutstanding(uint64_t size) { outstanding_size_ += size; }
+  /// The most bytes that accounted ops may hold at once; ops beyond that wait
+  /// for older ones to finish
+  uint64_t max_outstanding_size() const { return max_outstanding_size_; }
+  void set_max_outstanding_size(uint64_t size) { max_outstanding_size_ = size; }
+
+  /// Block, finishing the oldest ops, until an op accounting for size bytes
+  /// fits under max_outstanding_size(). Call this before producing the data
+  /// for an op, e.g., serializing it, so that production is throttled along
+  /// with upload.
+  void WaitForRoom(uint64_t size);
 
   /// Add future to the list of futures this descriptor will wait for, note
-  /// the file name for debugging. If the operation is associated with a file
-  /// frame that we are responsible for, note the size
+  /// the file name for debugging. If the operation holds data
+  /// that we are responsible for, note its size (an estimate is fine); the
+  /// size counts against max_outstanding_size() until the op finishes
   void AddOp(
       std::future<katana::CopyableResult<void>> future, std::string file,
       uint64_t accounted_size = 0);
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -13,6 +14,8 @@
 
 namespace katana {
 
+class FileUpload;
+
 constexpr uint64_t kBlockSize = UINT64_C(4) << 10; /* 4K */
 constexpr uint64_t kBlockOffsetMask = kBlockSize - 1;
 constexpr uint64_t kBlockMask = ~kBlockOffsetMask;
@@ -30,6 +33,9 @@ RoundUpToBlock(T val) {
 
 struct StatBuf {
   uint64_t size{UINT64_C(0)};
+  /// Identifies the version of the object, if the storage has one, e.g., the
+  /// ETag of an object store; empty otherwise
+  std::string etag;
 };
 
 // Returns an error file uri does not exist
@@ -77,6 +83,10 @@ KATANA_EXPORT katana::Result<void> FileRemoteCopy(
 KATANA_EXPORT std::future<katana::CopyableResult<void>> FileStoreAsync(
     const std::string& uri, const void* data, uint64_t size);
 
+/// Start storing the file at uri in parts, see FileUpload
+KATANA_EXPORT katana::Result<std::unique_ptr<FileUpload>> FileCreateUpload(
+    const std::string& uri);
+
 // read a part of the file into a caller defined buffer
 KATANA_EXPORT katana::Result<void> FileGet(
     const std::string& uri, void* result_buffer, uint64_t begin, uint64_t size);
@@ -1,9 +1,15 @@
 #include "AddProperties.h"
 
 #include <memory>
+#include <numeric>
 #include <optional>
 
+#include <arrow/buffer.h>
 #include <arrow/chunked_array.h>
+#include <arrow/compute/api_vector.h>
+#include <arrow/compute/cast.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
 #include <arrow/type_fwd.h>
 
 #include "katana/ArrowInterchange.h"
@@ -19,15 +25,59 @@
 
 namespace {
 
+/// A buffer over a whole bound FileView that keeps the view alive for as long
+/// as arrays sliced out of it are
+class FileViewBuffer : public arrow::Buffer {
+public:
+  explicit FileViewBuffer(std::shared_ptr<katana::FileView> fv)
+      : arrow::Buffer(fv->ptr<uint8_t>(), fv->size()), fv_(std::move(fv)) {}
+
+private:
+  std::shared_ptr<katana::FileView> fv_;
+};
+
+/// Arrow IPC files are written uncompressed, so the arrays read here point
+/// straight into the FileView rather than into decoded copies
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadArrowIPC(
+    const katana::URI& file_path,
+    std::optional<katana::ParquetReader::Slice> slice) {
+  auto fv = std::make_shared<katana::FileView>();
+  KATANA_CHECKED(fv->Bind(file_path.string(), true));
+
+  auto input = std::make_shared<arrow::io::BufferReader>(
+      std::make_shared<FileViewBuffer>(std::move(fv)));
+  auto reader =
+      KATANA_CHECKED(arrow::ipc::RecordBatchFileReader::Open(std::move(input)));
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (int i = 0, n = reader->num_record_batches(); i < n; ++i) {
+    batches.emplace_back(KATANA_CHECKED(reader->ReadRecordBatch(i)));
+  }
+  std::shared_ptr<arrow::Table> out = KATANA_CHECKED(
+      arrow::Table::FromRecordBatches(reader->schema(), batches));
+
+  if (slice) {
+    out = out->Slice(slice->offset, slice->length);
+  }
+  return out;
+}
+
 katana::Result<std::shared_ptr<arrow::Table>>
 DoLoadProperties(
     const std::string& expected_name, const katana::URI& file_path,
-    std::optional<katana::ParquetReader::Slice> slice = std::nullopt) {
-  std::unique_ptr<katana::ParquetReader> reader =
-      KATANA_CHECKED(katana::ParquetReader::Make());
-
-  std::shared_ptr<arrow::Table> out =
-      KATANA_CHECKED(reader->ReadTable(file_path, slice));
+    katana::PropertyStorageFormat format,
+    std::optional<katana::ParquetReader::Slice> slice = std::nullopt,
+    const katana::ParquetReader::ReadOpts& read_opts =
+        katana::ParquetReader::ReadOpts::Defaults()) {
+  std::shared_ptr<arrow::Table> out;
+  if (format == katana::PropertyStorageFormat::kArrowIPC) {
+    out = KATANA_CHECKED(ReadArrowIPC(file_path, slice));
+  } else {
+    std::unique_ptr<katana::ParquetReader> reader =
+        KATANA_CHECKED(katana::ParquetReader::Make(read_opts));
+    out = KATANA_CHECKED(reader->ReadTable(file_path, slice));
+  }
 
   std::shared_ptr<arrow::Schema> schema = out->schema();
   if (schema->num_fields() != 1) {
@@ -44,13 +94,163 @@ DoLoadProperties(
   return out;
 }
 
+bool
+IsChunked(const arrow::Table& table) {
+  for (const auto& column : table.columns()) {
+    if (column->num_chunks() > 1) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Decode the dictionary encoded columns of table into the canonical types
+/// ParquetReader gives them when it does not read dictionaries
+katana::Result<std::shared_ptr<arrow::Table>>
+DecodeDictionaries(const std::shared_ptr<arrow::Table>& table) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns = table->columns();
+  std::vector<std::shared_ptr<arrow::Field>> fields = table->fields();
+  bool decoded = false;
+  for (size_t i = 0; i < columns.size(); ++i) {
+    if (columns[i]->type()->id() != arrow::Type::DICTIONARY) {
+      continue;
+    }
+    std::shared_ptr<arrow::DataType> value_type =
+        static_cast<const arrow::DictionaryType&>(*columns[i]->type())
+            .value_type();
+    arrow::Datum dense =
+        KATANA_CHECKED(arrow::compute::Cast(columns[i], value_type));
+    if (value_type->id() == arrow::Type::STRING) {
+      value_type = arrow::large_utf8();
+      dense = KATANA_CHECKED(arrow::compute::Cast(dense, value_type));
+    } else if (value_type->id() == arrow::Type::BINARY) {
+      value_type = arrow::large_binary();
+      dense = KATANA_CHECKED(arrow::compute::Cast(dense, value_type));
+    }
+    columns[i] = dense.chunked_array();
+    fields[i] = fields[i]->WithType(value_type);
+    decoded = true;
+  }
+  if (!decoded) {
+    return table;
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, table->num_rows());
+}
+
+/// Make a property cached by a load with other options look like one read
+/// with read_opts
+katana::Result<std::shared_ptr<arrow::Table>>
+MatchReadOpts(
+    std::shared_ptr<arrow::Table> table,
+    const katana::ParquetReader::ReadOpts& read_opts) {
+  if (!read_opts.read_strings_as_dictionary) {
+    table = KATANA_CHECKED(DecodeDictionaries(table));
+  }
+  if (read_opts.combine_fixed_width_chunks && IsChunked(*table)) {
+    table = KATANA_CHECKED(table->CombineChunks(arrow::default_memory_pool()));
+  }
+  return table;
+}
+
+/// Apply the delta files of prop, oldest first, to table, which holds the
+/// property starting at row_offset
+katana::Result<std::shared_ptr<arrow::Table>>
+ApplyStoredDeltas(
+    const katana::URI& dir, const katana::PropStorageInfo* prop,
+    std::shared_ptr<arrow::Table> table, uint64_t row_offset) {
+  if (!prop->delta_paths().empty()) {
+    // deltas hold decoded values
+    table = KATANA_CHECKED(DecodeDictionaries(table));
+  }
+  for (const std::string& delta_path : prop->delta_paths()) {
+    std::unique_ptr<katana::ParquetReader> reader =
+        KATANA_CHECKED(katana::ParquetReader::Make());
+    std::shared_ptr<arrow::Table> delta = KATANA_CHECKED_CONTEXT(
+        reader->ReadTable(dir.Join(delta_path)), "reading delta {}",
+        delta_path);
+    if (delta->num_columns() != 2 ||
+        delta->field(0)->name() != katana::kPropertyDeltaRowIDName) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "delta {} of {} is not a row id and value table", delta_path,
+          std::quoted(prop->name()));
+    }
+
+    std::shared_ptr<arrow::ChunkedArray> column =
+        KATANA_CHECKED(katana::ApplyPropertyDelta(
+            table->column(0), delta->column(0), delta->column(1), row_offset));
+    table = arrow::Table::Make(table->schema(), {column});
+  }
+  return table;
+}
+
 }  // namespace
 
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::ApplyPropertyDelta(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const std::shared_ptr<arrow::ChunkedArray>& row_ids,
+    const std::shared_ptr<arrow::ChunkedArray>& values, uint64_t row_offset) {
+  if (!row_ids->type()->Equals(arrow::uint64())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "row ids must be uint64, found {}",
+        row_ids->type()->ToString());
+  }
+  if (!values->type()->Equals(column->type())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected values of type {} found {}",
+        column->type()->ToString(), values->type()->ToString());
+  }
+  if (row_ids->length() != values->length()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} row ids but {} values",
+        row_ids->length(), values->length());
+  }
+
+  // Take from the column followed by the values: index r keeps row r and
+  // num_rows + j picks value j
+  uint64_t num_rows = column->length();
+  std::vector<uint64_t> indices(num_rows);
+  std::iota(indices.begin(), indices.end(), 0);
+  uint64_t value_index = 0;
+  bool changed = false;
+  for (const auto& chunk : row_ids->chunks()) {
+    const auto& ids = static_cast<const arrow::UInt64Array&>(*chunk);
+    for (int64_t i = 0, n = ids.length(); i < n; ++i, ++value_index) {
+      uint64_t row = ids.Value(i);
+      if (row < row_offset || row - row_offset >= num_rows) {
+        continue;
+      }
+      indices[row - row_offset] = num_rows + value_index;
+      changed = true;
+    }
+  }
+  if (!changed) {
+    return column;
+  }
+
+  arrow::ArrayVector chunks = column->chunks();
+  chunks.insert(chunks.end(), values->chunks().begin(), values->chunks().end());
+  std::shared_ptr<arrow::ChunkedArray> combined =
+      KATANA_CHECKED(arrow::ChunkedArray::Make(chunks, column->type()));
+
+  arrow::UInt64Builder builder;
+  KATANA_CHECKED(builder.AppendValues(indices));
+  std::shared_ptr<arrow::Array> take_indices = KATANA_CHECKED(builder.Finish());
+
+  arrow::Datum taken =
+      KATANA_CHECKED(arrow::compute::Take(combined, take_indices));
+  return taken.chunked_array();
+}
+
 katana::Result<std::shared_ptr<arrow::Table>>
 katana::LoadProperties(
-    const std::string& expected_name, const katana::URI& file_path) {
+    const std::string& expected_name, const katana::URI& file_path,
+    katana::PropertyStorageFormat format,
+    const katana::ParquetReader::ReadOpts& read_opts) {
   try {
-    return DoLoadProperties(expected_name, file_path);
+    return DoLoadProperties(
+        expected_name, file_path, format, std::nullopt, read_opts);
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
         katana::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
@@ -60,10 +260,10 @@ katana::LoadProperties(
 katana::Result<std::shared_ptr<arrow::Table>>
 katana::LoadPropertySlice(
     const std::string& expected_name, const katana::URI& file_path,
-    int64_t offset, int64_t length) {
+    int64_t offset, int64_t length, katana::PropertyStorageFormat format) {
   try {
     return DoLoadProperties(
-        expected_name, file_path,
+        expected_name, file_path, format,
         katana::ParquetReader::Slice{.offset = offset, .length = length});
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
@@ -76,7 +276,8 @@ katana::AddProperties(
     const katana::URI& uri, bool is_property,
     const std::vector<katana::PropStorageInfo*>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn) {
+        add_fn,
+    const katana::ParquetReader::ReadOpts& read_opts, bool share_loaded) {
   for (katana::PropStorageInfo* prop : properties) {
     if (!prop->IsAbsent()) {
       return KATANA_ERROR(
@@ -88,9 +289,20 @@ katana::AddProperties(
           katana::MemorySupervisor::Get().GetPropertyManager();
       KATANA_LOG_DEBUG_ASSERT(pm);
       KATANA_LOG_DEBUG_ASSERT(!uri.empty());
-      const katana::URI& cache_key = uri.Join(prop->path());
-      std::shared_ptr<arrow::Table> props = pm->GetProperty(cache_key);
+      // a property with deltas has different contents than its base file
+      const katana::URI& cache_key = uri.Join(prop->latest_path());
+      std::shared_ptr<arrow::Table> props;
+      if (share_loaded) {
+        props = pm->GetSharedProperty(cache_key);
+      }
+      if (!props) {
+        props = pm->GetProperty(cache_key);
+        if (props && share_loaded) {
+          pm->ShareProperty(props, cache_key);
+        }
+      }
       if (props) {
+        props = KATANA_CHECKED(MatchReadOpts(std::move(props), read_opts));
         KATANA_CHECKED_CONTEXT(
             add_fn(props), "adding {}", std::quoted(prop->name()));
         prop->WasLoaded(props->field(0)->type());
@@ -117,17 +329,29 @@ katana::AddProperties(
                                                  {"name", prop->name()},
                                              });
     const katana::URI& path = uri.Join(prop->path());
+    const katana::URI& cache_key = uri.Join(prop->latest_path());
 
+    // Measured inside the load itself because ReadGroup may run on_complete
+    // long after the load finishes; the PropertyManager weighs eviction by it
+    auto load_us = std::make_shared<uint64_t>(0);
     std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> future =
         std::async(
             std::launch::async,
-            [prop,
-             path]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
-              return KATANA_CHECKED_CONTEXT(
-                  LoadProperties(prop->name(), path), "error loading {}", path);
+            [uri, prop, path, load_us, read_opts]()
+                -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
+              katana::TimePoint start = katana::Now();
+              auto table = KATANA_CHECKED_CONTEXT(
+                  LoadProperties(
+                      prop->name(), path, prop->storage_format(),
+                      read_opts),
+                  "error loading {}", path);
+              table = KATANA_CHECKED(ApplyStoredDeltas(uri, prop, table, 0));
+              *load_us = katana::UsSince(start);
+              return table;
             });
-    auto on_complete = [add_fn, is_property,
-                        prop](const std::shared_ptr<arrow::Table>& props)
+    auto on_complete = [add_fn, is_property, prop, cache_key, load_us,
+                        share_loaded](
+                           const std::shared_ptr<arrow::Table>& props)
         -> katana::CopyableResult<void> {
       KATANA_CHECKED_CONTEXT(
           add_fn(props), "adding {}", std::quoted(prop->name()));
@@ -135,7 +359,10 @@ katana::AddProperties(
       PropertyManager* pm =
           katana::MemorySupervisor::Get().GetPropertyManager();
       if (is_property) {
-        pm->PropertyLoadedActive(props);
+        pm->PropertyLoadedActive(props, cache_key, *load_us);
+        if (share_loaded) {
+          pm->ShareProperty(props, cache_key);
+        }
       } else {
         katana::GetTracer().GetActiveSpan().Log(
             "addproperties property cache callback non-property",
@@ -159,6 +386,19 @@ katana::AddProperties(
   return katana::ResultSuccess();
 }
 
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::ReadPropertySlice(
+    const katana::URI& dir, const katana::PropStorageInfo& prop,
+    std::pair<uint64_t, uint64_t> range) {
+  uint64_t begin = range.first;
+  uint64_t size = range.second > range.first ? range.second - range.first : 0;
+  const katana::URI& path = dir.Join(prop.path());
+  std::shared_ptr<arrow::Table> table = KATANA_CHECKED_CONTEXT(
+      LoadPropertySlice(prop.name(), path, begin, size, prop.storage_format()),
+      "error loading {}", path);
+  return KATANA_CHECKED(ApplyStoredDeltas(dir, &prop, table, begin));
+}
+
 katana::Result<void>
 katana::AddPropertySlice(
     const katana::URI& dir,
@@ -166,8 +406,6 @@ katana::AddPropertySlice(
     std::pair<uint64_t, uint64_t> range, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
         add_fn) {
-  uint64_t begin = range.first;
-  uint64_t size = range.second > range.first ? range.second - range.first : 0;
   for (katana::PropStorageInfo* prop : properties) {
     if (!prop->IsAbsent()) {
       return KATANA_ERROR(
@@ -179,13 +417,9 @@ katana::AddPropertySlice(
     std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> future =
         std::async(
             std::launch::async,
-            [path, prop, begin,
-             size]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
-              std::shared_ptr<arrow::Table> load_result =
-                  KATANA_CHECKED_CONTEXT(
-                      LoadPropertySlice(prop->name(), path, begin, size),
-                      "error loading {}", path);
-              return load_result;
+            [dir, prop,
+             range]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
+              return KATANA_CHECKED(ReadPropertySlice(dir, *prop, range));
             });
     auto on_complete = [add_fn,
                         prop](const std::shared_ptr<arrow::Table>& props)
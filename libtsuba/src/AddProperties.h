@@ -4,25 +4,55 @@
 #include <arrow/api.h>
 
 #include "RDGPartHeader.h"
+#include "katana/ParquetReader.h"
 #include "katana/ReadGroup.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
 
 namespace katana {
 
+/// read_opts applies to Parquet properties; see ParquetReader::ReadOpts
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadProperties(
-    const std::string& expected_name, const katana::URI& file_path);
+    const std::string& expected_name, const katana::URI& file_path,
+    PropertyStorageFormat format = PropertyStorageFormat::kParquet,
+    const ParquetReader::ReadOpts& read_opts = ParquetReader::ReadOpts::Defaults());
 
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadPropertySlice(
     const std::string& expected_name, const katana::URI& file_path,
-    int64_t offset, int64_t length);
+    int64_t offset, int64_t length,
+    PropertyStorageFormat format = PropertyStorageFormat::kParquet);
+
+/// name of the row id column of a property delta file; the other column is
+/// the property itself
+inline const std::string kPropertyDeltaRowIDName = "row_id";
+
+/// Overwrite the rows of column listed in row_ids with the matching entries
+/// of values; when a row id repeats, the later entry wins. Row ids count from
+/// the start of the whole property, so when column is a slice of it starting
+/// at row_offset, rows outside the slice are ignored.
+KATANA_EXPORT katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+ApplyPropertyDelta(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const std::shared_ptr<arrow::ChunkedArray>& row_ids,
+    const std::shared_ptr<arrow::ChunkedArray>& values,
+    uint64_t row_offset = 0);
 
-// is_property is true for properties and false for RDG metadata
+// is_property is true for properties and false for RDG metadata.
+// share_loaded is RDGLoadOptions::share_loaded_properties
 KATANA_EXPORT katana::Result<void> AddProperties(
     const katana::URI& uri, bool is_property,
     const std::vector<katana::PropStorageInfo*>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn);
+        add_fn,
+    const ParquetReader::ReadOpts& read_opts = ParquetReader::ReadOpts::Defaults(),
+    bool share_loaded = false);
+
+/// Read rows [range.first, range.second) of a stored property with its deltas
+/// applied. Only the row groups holding those rows are fetched, and prop is
+/// left as it is, so an absent property stays absent.
+KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> ReadPropertySlice(
+    const katana::URI& dir, const katana::PropStorageInfo& prop,
+    std::pair<uint64_t, uint64_t> range);
 
 KATANA_EXPORT katana::Result<void> AddPropertySlice(
     const katana::URI& dir,
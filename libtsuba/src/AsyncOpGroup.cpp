@@ -18,6 +18,8 @@ katana::AsyncOpGroup::FinishOne() {
       KATANA_LOG_ERROR(
           "complete cb for async op for {} returned {}", op_it->location,
           res.error());
+      errors_++;
+      last_error_ = res.error();
     }
   }
   pending_ops_.erase(op_it);
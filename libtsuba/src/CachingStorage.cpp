@@ -0,0 +1,484 @@
+#include "CachingStorage.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Metrics.h"
+#include "katana/Random.h"
+#include "katana/file.h"
+
+namespace {
+
+/// The cache shrinks to this fraction of its capacity when it is full, so
+/// that it is not scanned on every insert
+constexpr double kEvictToFraction = 0.9;
+
+constexpr char kIdFile[] = "id";
+constexpr char kLockFile[] = ".lock";
+constexpr char kTmpInfix[] = ".tmp.";
+
+/// FNV-1a, which unlike std::hash is the same in every process
+uint64_t
+HashString(const std::string& str) {
+  uint64_t hash = UINT64_C(0xcbf29ce484222325);
+  for (char c : str) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= UINT64_C(0x100000001b3);
+  }
+  return hash;
+}
+
+katana::CopyableResult<void>
+ToCopyable(katana::Result<void> res) {
+  if (!res) {
+    return katana::CopyableErrorInfo{res.error()};
+  }
+  return katana::CopyableResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+MakeReadyFuture(katana::CopyableResult<void> res) {
+  std::promise<katana::CopyableResult<void>> promise;
+  promise.set_value(std::move(res));
+  return promise.get_future();
+}
+
+struct CacheMetrics {
+  katana::Counter& hits;
+  katana::Counter& misses;
+  katana::Counter& hit_bytes;
+  katana::Counter& evicted_bytes;
+};
+
+CacheMetrics&
+Metrics() {
+  auto& registry = katana::MetricsRegistry::Get();
+  static CacheMetrics metrics{
+      registry.GetCounter(
+          "katana_storage_cache_hits_total",
+          "Blocks read from the local storage cache"),
+      registry.GetCounter(
+          "katana_storage_cache_misses_total",
+          "Blocks requested from remote storage and cached"),
+      registry.GetCounter(
+          "katana_storage_cache_hit_bytes_total",
+          "Bytes read from the local storage cache"),
+      registry.GetCounter(
+          "katana_storage_cache_evicted_bytes_total",
+          "Bytes removed from the local storage cache"),
+  };
+  return metrics;
+}
+
+struct CachedFile {
+  std::string path;
+  uint64_t size;
+  struct timespec mtime;
+};
+
+/// List the block files of the cache in dir
+std::vector<CachedFile>
+ListCachedFiles(const std::string& dir) {
+  std::vector<CachedFile> files;
+  DIR* top = opendir(dir.c_str());
+  if (top == nullptr) {
+    return files;
+  }
+  while (struct dirent* object = readdir(top)) {
+    if (object->d_name[0] == '.') {
+      continue;
+    }
+    std::string object_dir = dir + "/" + object->d_name;
+    DIR* blocks = opendir(object_dir.c_str());
+    if (blocks == nullptr) {
+      continue;
+    }
+    while (struct dirent* block = readdir(blocks)) {
+      if (block->d_name[0] == '.' || std::strcmp(block->d_name, kIdFile) == 0) {
+        continue;
+      }
+      std::string path = object_dir + "/" + block->d_name;
+      struct stat buf;
+      if (stat(path.c_str(), &buf) == 0 && S_ISREG(buf.st_mode)) {
+        files.emplace_back(
+            CachedFile{path, static_cast<uint64_t>(buf.st_size), buf.st_mtim});
+      }
+    }
+    closedir(blocks);
+  }
+  closedir(top);
+  return files;
+}
+
+/// Write data to path by way of a temporary file, so that other processes
+/// see either all of it or nothing
+katana::Result<void>
+WriteAtomically(const std::string& path, const uint8_t* data, uint64_t size) {
+  std::string tmp_path =
+      path + kTmpInfix + katana::RandomAlphanumericString(8);
+  {
+    std::ofstream out(tmp_path, std::ios_base::binary | std::ios_base::trunc);
+    out.write(reinterpret_cast<const char*>(data), size); /* NOLINT */
+    if (!out) {
+      std::remove(tmp_path.c_str());
+      return KATANA_ERROR(
+          katana::ErrorCode::LocalStorageError, "writing {}: {}", tmp_path,
+          std::strerror(errno));
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::error_code ec = katana::ResultErrno();
+    std::remove(tmp_path.c_str());
+    return KATANA_ERROR(ec, "renaming {}", tmp_path);
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::CachingStorage::Options
+katana::CachingStorage::OptionsFromEnv(const std::string& dir) {
+  Options options;
+  options.dir = dir;
+  // GetEnv has no 64-bit integers; doubles hold them exactly up to 2^53
+  if (double bytes{}; katana::GetEnv("KATANA_STORAGE_CACHE_BYTES", &bytes)) {
+    options.capacity_bytes = static_cast<uint64_t>(std::max(bytes, 0.0));
+  }
+  if (double bytes{};
+      katana::GetEnv("KATANA_STORAGE_CACHE_BLOCK_BYTES", &bytes) && bytes > 0) {
+    options.block_size = static_cast<uint64_t>(bytes);
+  }
+  return options;
+}
+
+katana::CachingStorage::CachingStorage(FileStorage* cached, Options options)
+    : FileStorage(cached->uri_scheme()),
+      cached_(cached),
+      options_(std::move(options)) {
+  KATANA_LOG_VASSERT(options_.block_size > 0, "block size must be positive");
+}
+
+katana::Result<void>
+katana::CachingStorage::Init() {
+  KATANA_CHECKED(cached_->Init());
+  boost::system::error_code err;
+  boost::filesystem::create_directories(options_.dir, err);
+  if (err) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "creating storage cache {}: {}",
+        options_.dir, err.message());
+  }
+  uint64_t used = 0;
+  for (const auto& file : ListCachedFiles(options_.dir)) {
+    used += file.size;
+  }
+  used_bytes_ = used;
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::CachingStorage::Fini() {
+  return cached_->Fini();
+}
+
+katana::Result<void>
+katana::CachingStorage::Stat(const std::string& uri, StatBuf* s_buf) {
+  return cached_->Stat(uri, s_buf);
+}
+
+katana::Result<katana::CachingStorage::Object>
+katana::CachingStorage::Lookup(const std::string& uri) {
+  {
+    std::lock_guard<std::mutex> lock(objects_mutex_);
+    if (auto it = objects_.find(uri); it != objects_.end()) {
+      return it->second;
+    }
+  }
+
+  StatBuf stat_buf;
+  KATANA_CHECKED(cached_->Stat(uri, &stat_buf));
+  std::string id = uri + "\n";
+  if (stat_buf.etag.empty()) {
+    id += fmt::format("size {}", stat_buf.size);
+  } else {
+    id += fmt::format("etag {}", stat_buf.etag);
+  }
+  Object object{
+      fmt::format("{}/{:016x}", options_.dir, HashString(id)), stat_buf.size};
+
+  // The id file tells objects whose ids hash the same apart
+  std::string id_path = object.dir + "/" + kIdFile;
+  std::ifstream in(id_path);
+  if (in) {
+    std::stringstream existing;
+    existing << in.rdbuf();
+    if (existing.str() != id) {
+      object.dir.clear();
+    }
+  } else if (mkdir(object.dir.c_str(), 0777) != 0 && errno != EEXIST) {
+    object.dir.clear();
+  } else if (!WriteAtomically(
+                 id_path, reinterpret_cast<const uint8_t*>(id.data()),
+                 id.size())) {
+    object.dir.clear();
+  }
+
+  std::lock_guard<std::mutex> lock(objects_mutex_);
+  objects_.emplace(uri, object);
+  return object;
+}
+
+void
+katana::CachingStorage::Forget(const std::string& uri) {
+  std::lock_guard<std::mutex> lock(objects_mutex_);
+  objects_.erase(uri);
+}
+
+bool
+katana::CachingStorage::ReadBlock(const Block& block, uint8_t* result_buf) {
+  int fd = open(block.path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  uint8_t* out = result_buf + block.offset_in_result;
+  uint64_t done = 0;
+  while (done < block.size) {
+    ssize_t n = pread(
+        fd, out + done, block.size - done, block.offset_in_block + done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    done += n;
+  }
+  if (done == block.size) {
+    // Mark the block recently used
+    futimens(fd, nullptr);
+  }
+  close(fd);
+  return done == block.size;
+}
+
+void
+katana::CachingStorage::StoreBlock(const Block& block, const uint8_t* data) {
+  if (auto res = WriteAtomically(block.path, data, block.block_bytes); !res) {
+    if (!warned_.exchange(true)) {
+      KATANA_LOG_WARN("not caching remote storage: {}", res.error());
+    }
+    return;
+  }
+  auto used = used_bytes_.fetch_add(block.block_bytes) + block.block_bytes;
+  if (used > options_.capacity_bytes) {
+    Evict();
+  }
+}
+
+void
+katana::CachingStorage::Evict() {
+  if (evicting_.exchange(true)) {
+    return;
+  }
+  // Only one process scans the cache at a time; the others carry on
+  std::string lock_path = options_.dir + "/" + kLockFile;
+  int lock_fd = open(lock_path.c_str(), O_RDWR | O_CREAT, 0666);
+  if (lock_fd >= 0 && flock(lock_fd, LOCK_EX | LOCK_NB) == 0) {
+    std::vector<CachedFile> files = ListCachedFiles(options_.dir);
+    std::sort(
+        files.begin(), files.end(),
+        [](const CachedFile& a, const CachedFile& b) {
+          return std::tie(a.mtime.tv_sec, a.mtime.tv_nsec) <
+                 std::tie(b.mtime.tv_sec, b.mtime.tv_nsec);
+        });
+    uint64_t used = 0;
+    for (const auto& file : files) {
+      used += file.size;
+    }
+    auto target =
+        static_cast<uint64_t>(options_.capacity_bytes * kEvictToFraction);
+    uint64_t evicted = 0;
+    // Readers that have a block open keep reading it after it is removed
+    for (auto it = files.begin(); it != files.end() && used > target; ++it) {
+      if (unlink(it->path.c_str()) == 0) {
+        used -= it->size;
+        evicted += it->size;
+      }
+    }
+    used_bytes_ = used;
+    Metrics().evicted_bytes.Add(evicted);
+    flock(lock_fd, LOCK_UN);
+  }
+  if (lock_fd >= 0) {
+    close(lock_fd);
+  }
+  evicting_ = false;
+}
+
+katana::Result<std::vector<katana::CachingStorage::Block>>
+katana::CachingStorage::StartGet(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  Object object = KATANA_CHECKED(Lookup(uri));
+  std::vector<Block> missing;
+  // Reads past the end are left to the remote storage to fail
+  if (object.dir.empty() || start + size > object.size) {
+    Block block{};
+    block.size = size;
+    block.future = cached_->GetAsync(uri, start, size, result_buf);
+    missing.emplace_back(std::move(block));
+    return missing;
+  }
+
+  uint64_t block_size = options_.block_size;
+  for (uint64_t index = start / block_size; index * block_size < start + size;
+       ++index) {
+    uint64_t block_start = index * block_size;
+    Block block;
+    block.path = fmt::format("{}/{}", object.dir, index);
+    block.block_bytes = std::min(block_size, object.size - block_start);
+    block.offset_in_block = std::max(start, block_start) - block_start;
+    block.size = std::min(start + size, block_start + block.block_bytes) -
+                 block_start - block.offset_in_block;
+    block.offset_in_result = block_start + block.offset_in_block - start;
+    if (ReadBlock(block, result_buf)) {
+      Metrics().hits.Add();
+      Metrics().hit_bytes.Add(block.size);
+      continue;
+    }
+
+    Metrics().misses.Add();
+    // Fetch the whole block, straight into the result if it is all there
+    uint8_t* target = result_buf + block.offset_in_result;
+    if (block.size != block.block_bytes) {
+      block.scratch = std::make_unique<uint8_t[]>(block.block_bytes);
+      target = block.scratch.get();
+    }
+    block.future =
+        cached_->GetAsync(uri, block_start, block.block_bytes, target);
+    missing.emplace_back(std::move(block));
+  }
+  return missing;
+}
+
+katana::Result<void>
+katana::CachingStorage::FinishGet(
+    std::vector<Block>* missing, uint8_t* result_buf) {
+  // Wait for every request even if one fails so that none is left writing
+  // into result_buf after we return
+  katana::Result<void> ret = katana::ResultSuccess();
+  for (auto& block : *missing) {
+    if (auto res = block.future.get(); !res) {
+      if (ret) {
+        ret = katana::ErrorInfo{res.error()};
+      }
+      continue;
+    }
+    if (block.path.empty()) {
+      // The object is not cached
+      continue;
+    }
+    if (block.scratch) {
+      std::memcpy(
+          result_buf + block.offset_in_result,
+          block.scratch.get() + block.offset_in_block, block.size);
+      StoreBlock(block, block.scratch.get());
+    } else {
+      StoreBlock(block, result_buf + block.offset_in_result);
+    }
+  }
+  return ret;
+}
+
+katana::Result<void>
+katana::CachingStorage::GetMultiSync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  if (size == 0) {
+    return katana::ResultSuccess();
+  }
+  std::vector<Block> missing =
+      KATANA_CHECKED(StartGet(uri, start, size, result_buf));
+  return FinishGet(&missing, result_buf);
+}
+
+std::future<katana::CopyableResult<void>>
+katana::CachingStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  if (size == 0) {
+    return MakeReadyFuture(katana::CopyableResultSuccess());
+  }
+  auto missing_res = StartGet(uri, start, size, result_buf);
+  if (!missing_res) {
+    return MakeReadyFuture(katana::CopyableErrorInfo{missing_res.error()});
+  }
+  if (missing_res.value().empty()) {
+    return MakeReadyFuture(katana::CopyableResultSuccess());
+  }
+  auto missing =
+      std::make_shared<std::vector<Block>>(std::move(missing_res.value()));
+  return std::async(std::launch::deferred, [this, missing, result_buf]() {
+    return ToCopyable(FinishGet(missing.get(), result_buf));
+  });
+}
+
+katana::Result<void>
+katana::CachingStorage::PutMultiSync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  Forget(uri);
+  return cached_->PutMultiSync(uri, data, size);
+}
+
+katana::Result<std::unique_ptr<katana::FileUpload>>
+katana::CachingStorage::CreateUpload(const std::string& uri) {
+  Forget(uri);
+  return cached_->CreateUpload(uri);
+}
+
+katana::Result<void>
+katana::CachingStorage::RemoteCopy(
+    const std::string& source_uri, const std::string& dest_uri, uint64_t begin,
+    uint64_t size) {
+  Forget(dest_uri);
+  return cached_->RemoteCopy(source_uri, dest_uri, begin, size);
+}
+
+std::future<katana::CopyableResult<void>>
+katana::CachingStorage::PutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  Forget(uri);
+  return cached_->PutAsync(uri, data, size);
+}
+
+std::future<katana::CopyableResult<void>>
+katana::CachingStorage::ListAsync(
+    const std::string& directory, std::vector<std::string>* list,
+    std::vector<uint64_t>* size) {
+  return cached_->ListAsync(directory, list, size);
+}
+
+katana::Result<void>
+katana::CachingStorage::Delete(
+    const std::string& directory,
+    const std::unordered_set<std::string>& files) {
+  for (const auto& file : files) {
+    Forget(directory + "/" + file);
+  }
+  return cached_->Delete(directory, files);
+}
@@ -0,0 +1,139 @@
+#ifndef KATANA_LIBTSUBA_CACHINGSTORAGE_H_
+#define KATANA_LIBTSUBA_CACHINGSTORAGE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "katana/FileStorage.h"
+#include "katana/Result.h"
+
+namespace katana {
+
+/// A read-through cache of a remote FileStorage on a local file system,
+/// e.g., an NVMe drive, so that jobs that load the same RDG do not download
+/// it again.
+///
+/// Objects are cached in blocks of block_size bytes. A block is a file named
+/// by a hash of the URI and version of its object, the etag from Stat or its
+/// size if the backend has no etags, and its index, so a changed object is
+/// cached anew rather than read stale. Blocks are written to temporary files
+/// and renamed into place, so the cache can be shared by processes on the
+/// same host. Blocks are touched when read, and when the cache grows past
+/// capacity_bytes the least recently read blocks are removed.
+///
+/// Writes, copies, lists and deletes go straight to the remote storage.
+///
+/// GlobalState puts one in front of every backend other than local storage
+/// when KATANA_STORAGE_CACHE_DIR names a directory. The capacity and block
+/// size are set by KATANA_STORAGE_CACHE_BYTES and
+/// KATANA_STORAGE_CACHE_BLOCK_BYTES.
+class CachingStorage : public FileStorage {
+public:
+  struct Options {
+    std::string dir;
+    uint64_t capacity_bytes{UINT64_C(64) << 30};
+    uint64_t block_size{UINT64_C(8) << 20};
+  };
+
+  static Options OptionsFromEnv(const std::string& dir);
+
+  /// cached must outlive this
+  CachingStorage(FileStorage* cached, Options options);
+
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override;
+  katana::Result<void> Stat(const std::string& uri, StatBuf* s_buf) override;
+
+  uint32_t Priority() const override { return cached_->Priority(); }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
+
+  katana::Result<std::unique_ptr<FileUpload>> CreateUpload(
+      const std::string& uri) override;
+
+  katana::Result<void> RemoteCopy(
+      const std::string& source_uri, const std::string& dest_uri,
+      uint64_t begin, uint64_t size) override;
+
+  std::future<katana::CopyableResult<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
+  /// Cached blocks are read before returning; missing blocks are requested
+  /// from the remote storage before returning and cached when the future is
+  /// waited on
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+  std::future<katana::CopyableResult<void>> ListAsync(
+      const std::string& directory, std::vector<std::string>* list,
+      std::vector<uint64_t>* size) override;
+  katana::Result<void> Delete(
+      const std::string& directory,
+      const std::unordered_set<std::string>& files) override;
+
+  /// Bytes of cached blocks, as of the last time the cache was scanned plus
+  /// the blocks this process has added since
+  uint64_t used_bytes() const {
+    return used_bytes_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Object {
+    /// Directory of the blocks of the object, empty if it is not cached
+    std::string dir;
+    uint64_t size;
+  };
+
+  /// The part of a get that a block covers
+  struct Block {
+    std::string path;
+    uint64_t block_bytes;
+    uint64_t offset_in_block;
+    uint64_t size;
+    uint64_t offset_in_result;
+    /// Where a missing block is read to if it is not entirely in the result
+    std::unique_ptr<uint8_t[]> scratch;
+    std::future<katana::CopyableResult<void>> future;
+  };
+
+  katana::Result<Object> Lookup(const std::string& uri);
+  void Forget(const std::string& uri);
+
+  /// Read the blocks of a get that are cached and start requests for the
+  /// rest, which are returned
+  katana::Result<std::vector<Block>> StartGet(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf);
+  /// Wait for the requests of missing blocks and cache them
+  katana::Result<void> FinishGet(
+      std::vector<Block>* missing, uint8_t* result_buf);
+
+  bool ReadBlock(const Block& block, uint8_t* result_buf);
+  void StoreBlock(const Block& block, const uint8_t* data);
+  void Evict();
+
+  FileStorage* cached_;
+  Options options_;
+
+  std::mutex objects_mutex_;
+  std::unordered_map<std::string, Object> objects_;
+
+  std::atomic<uint64_t> used_bytes_{0};
+  std::atomic<bool> evicting_{false};
+  std::atomic<bool> warned_{false};
+};
+
+}  // namespace katana
+
+#endif
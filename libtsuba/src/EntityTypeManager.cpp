@@ -1,8 +1,56 @@
 #include "katana/EntityTypeManager.h"
 
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/Result.h"
 
+namespace {
+
+/// The types of a row as a bitset: bit i is set if the ith type property of
+/// the row is valid and true
+using TypeMask = std::vector<uint64_t>;
+
+struct TypeMaskHash {
+  size_t operator()(const TypeMask& mask) const {
+    size_t hash = 0;
+    for (uint64_t word : mask) {
+      hash ^= std::hash<uint64_t>{}(word) + 0x9e3779b97f4a7c15UL +
+              (hash << 6) + (hash >> 2);
+    }
+    return hash;
+  }
+};
+
+/// Per thread state of the passes over rows; the mask is scratch space so
+/// that rows can be looked at without allocating
+struct TypeMaskScratch {
+  TypeMask mask;
+  std::unordered_set<TypeMask, TypeMaskHash> combinations;
+};
+
+/// Fill \p mask with the types of \p row and return how many there are
+size_t
+RowTypeMask(
+    const std::vector<const arrow::UInt8Array*>& columns, int64_t row,
+    TypeMask* mask) {
+  std::fill(mask->begin(), mask->end(), 0);
+  size_t num_types = 0;
+  for (size_t i = 0, n = columns.size(); i < n; ++i) {
+    if (columns[i]->IsValid(row) && columns[i]->Value(row)) {
+      (*mask)[i / 64] |= uint64_t{1} << (i % 64);
+      ++num_types;
+    }
+  }
+  return num_types;
+}
+
+}  // namespace
+
 //TODO(emcginnis): while this logic works and technically saves cycles by avoiding
 // looping through all of the sets too frequently, its cumbersome and likely not worth it
 // simplify to just resizing as we need to, and let the reserve functionality in the backend
@@ -42,7 +90,8 @@ katana::EntityTypeManager::CalculateSetOfEntityTypeIDsSize(
 katana::Result<katana::EntityTypeManager::TypeProperties>
 katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
     const std::shared_ptr<arrow::Table>& properties,
-    EntityTypeManager* entity_type_manager) {
+    EntityTypeManager* entity_type_manager,
+    katana::EntityTypeID* entity_type_ids) {
   // throw an error if each column/property has more than 1 chunk
   for (int i = 0, n = properties->num_columns(); i < n; i++) {
     std::shared_ptr<arrow::ChunkedArray> property = properties->column(i);
@@ -88,21 +137,47 @@ katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
         field_indices, new_entity_type_id);
   }
 
+  std::vector<const arrow::UInt8Array*> columns;
+  for (const auto& uint8_property : type_properties.uint8_properties) {
+    columns.emplace_back(uint8_property.array.get());
+  }
+  size_t num_words = (columns.size() + 63) / 64;
+  auto to_field_indices = [&](const TypeMask& mask) {
+    TypeProperties::FieldEntity field_indices;
+    for (size_t i = 0, n = columns.size(); i < n; ++i) {
+      if (mask[i / 64] & (uint64_t{1} << (i % 64))) {
+        field_indices.emplace_back(
+            type_properties.uint8_properties[i].field_index);
+      }
+    }
+    return field_indices;
+  };
+
+  // find the combinations of more than one type, each thread on its own
+  katana::PerThreadStorage<TypeMaskScratch> scratch;
+  katana::on_each([&](unsigned, unsigned) {
+    scratch.getLocal()->mask.resize(num_words);
+  });
+  int64_t num_rows = properties->num_rows();
+  katana::do_all(
+      katana::iterate(int64_t{0}, num_rows),
+      [&](int64_t row) {
+        TypeMaskScratch& local = *scratch.getLocal();
+        if (RowTypeMask(columns, row, &local.mask) > 1) {
+          local.combinations.emplace(local.mask);
+        }
+      },
+      katana::no_stats());
+
+  // merge into an ordered set so that IDs are assigned in the same order as
+  // by a serial pass, independent of the number of threads
   // NB: cannot use unordered_set without defining a hash function for vectors;
   // performance is not affected here because the set is very small (<=256)
   using FieldEntityTypeSet = std::set<TypeProperties::FieldEntity>;
   FieldEntityTypeSet type_combinations;
-  for (int64_t row = 0, num_rows = properties->num_rows(); row < num_rows;
-       ++row) {
-    TypeProperties::FieldEntity field_indices;
-    for (auto uint8_property : type_properties.uint8_properties) {
-      if (uint8_property.array->IsValid(row) &&
-          uint8_property.array->Value(row)) {
-        field_indices.emplace_back(uint8_property.field_index);
-      }
-    }
-    if (field_indices.size() > 1) {
-      type_combinations.emplace(field_indices);
+  for (uint32_t i = 0; i < katana::getActiveThreads(); ++i) {
+    for (const TypeMask& mask : scratch.getRemote(i)->combinations) {
+      type_combinations.emplace(to_field_indices(mask));
     }
   }
 
@@ -136,6 +211,32 @@ katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
         std::numeric_limits<katana::EntityTypeID>::max() - 2);
   }
 
+  // assign the type ID for each row
+  std::unordered_map<TypeMask, katana::EntityTypeID, TypeMaskHash> mask_to_id;
+  for (const auto& [field_indices, id] :
+       type_properties.type_field_indices_to_id) {
+    TypeMask mask(num_words);
+    for (size_t i = 0, n = columns.size(); i < n; ++i) {
+      if (std::binary_search(
+              field_indices.begin(), field_indices.end(),
+              type_properties.uint8_properties[i].field_index)) {
+        mask[i / 64] |= uint64_t{1} << (i % 64);
+      }
+    }
+    mask_to_id.emplace(std::move(mask), id);
+  }
+  katana::do_all(
+      katana::iterate(int64_t{0}, num_rows),
+      [&](int64_t row) {
+        TypeMask& mask = scratch.getLocal()->mask;
+        if (RowTypeMask(columns, row, &mask) == 0) {
+          entity_type_ids[row] = katana::kUnknownEntityType;
+        } else {
+          entity_type_ids[row] = mask_to_id.at(mask);
+        }
+      },
+      katana::no_stats());
+
   return type_properties;
 }
 
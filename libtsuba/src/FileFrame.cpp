@@ -2,6 +2,8 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
+
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
 #include "katana/Platform.h"
@@ -16,6 +18,18 @@ katana::FileFrame::~FileFrame() {
 
 katana::Result<void>
 katana::FileFrame::Destroy() {
+  // the buffer must outlive the upload of its parts
+  if (pending_.valid()) {
+    if (auto res = pending_.get(); !res) {
+      KATANA_LOG_ERROR("uploading part of {}: {}", path_, res.error());
+    }
+  }
+  if (upload_) {
+    if (auto res = upload_->Abort(); !res) {
+      KATANA_LOG_ERROR("aborting upload of {}: {}", path_, res.error());
+    }
+    upload_.reset();
+  }
   if (valid_) {
     int err = munmap(map_start_, map_size_);
     valid_ = false;
@@ -44,6 +58,8 @@ katana::FileFrame::Init(uint64_t reserved_size) {
   synced_ = false;
   valid_ = true;
   cursor_ = 0;
+  part_size_ = 0;
+  part_offset_ = 0;
   return katana::ResultSuccess();
 }
 
@@ -103,6 +119,87 @@ katana::FileFrame::GrowBuffer(int64_t accommodate) {
   return res;
 }
 
+katana::Result<void>
+katana::FileFrame::StartUpload(uint64_t part_size) {
+  if (!valid_) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
+  }
+  if (path_.empty()) {
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "no path provided");
+  }
+  if (upload_ || cursor_ != 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "upload must start before writes");
+  }
+  if (part_size == 0 || part_size % kBlockSize != 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "part size {} is not a multiple of {}",
+        part_size, kBlockSize);
+  }
+
+  auto upload_res = katana::FileCreateUpload(path_);
+  if (!upload_res) {
+    if (upload_res.error() == ErrorCode::NotImplemented) {
+      return katana::ResultSuccess();
+    }
+    return upload_res.error().WithContext("uploading {}", path_);
+  }
+  upload_ = std::move(upload_res.value());
+  part_size_ = part_size;
+  part_offset_ = 0;
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::FileFrame::WaitForPending() {
+  if (pending_.valid()) {
+    KATANA_CHECKED_CONTEXT(pending_.get(), "uploading part of {}", path_);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::FileFrame::UploadPart() {
+  if (map_size_ < 2 * part_size_) {
+    // growing may move the buffer, so grow to both parts before any of it is
+    // uploaded
+    KATANA_CHECKED(MapContguousExtension(2 * part_size_));
+  }
+  // the other part is written next, so its upload must be done
+  KATANA_CHECKED(WaitForPending());
+  pending_ = std::async(
+      std::launch::async,
+      [upload = upload_.get(), offset = part_offset_,
+       data = map_start_ + part_start(),
+       size = part_size_]() -> katana::CopyableResult<void> {
+        KATANA_CHECKED(upload->PutPart(offset, data, size));
+        return katana::CopyableResultSuccess();
+      });
+  part_offset_ += part_size_;
+  cursor_ = part_start();
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::FileFrame::UploadWrite(const uint8_t* data, uint64_t nbytes) {
+  while (nbytes > 0) {
+    uint64_t part_end = part_start() + part_size_;
+    uint64_t n = std::min(nbytes, part_end - cursor_);
+    if (cursor_ + n > map_size_) {
+      // only while the first part is written, when nothing is being uploaded
+      KATANA_CHECKED(GrowBuffer(n));
+    }
+    memcpy(map_start_ + cursor_, data, n);
+    cursor_ += n;
+    data += n;
+    nbytes -= n;
+    if (cursor_ == part_end) {
+      KATANA_CHECKED(UploadPart());
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::FileFrame::Persist() {
   if (!valid_) {
@@ -111,6 +208,17 @@ katana::FileFrame::Persist() {
   if (path_.empty()) {
     return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "no path provided");
   }
+  if (upload_) {
+    KATANA_CHECKED(WaitForPending());
+    if (uint64_t size = cursor_ - part_start(); size > 0) {
+      KATANA_CHECKED_CONTEXT(
+          upload_->PutPart(part_offset_, map_start_ + part_start(), size),
+          "uploading part of {}", path_);
+    }
+    KATANA_CHECKED_CONTEXT(upload_->Complete(), "uploading {}", path_);
+    upload_.reset();
+    return katana::ResultSuccess();
+  }
   KATANA_CHECKED(katana::FileStore(path_, map_start_, cursor_));
 
   return katana::ResultSuccess();
@@ -130,11 +238,22 @@ katana::FileFrame::PersistAsync() {
           return KATANA_ERROR(ErrorCode::InvalidArgument, "no path provided");
         });
   }
+  if (upload_) {
+    return std::async(
+        std::launch::async, [this]() -> katana::CopyableResult<void> {
+          KATANA_CHECKED(Persist());
+          return katana::CopyableResultSuccess();
+        });
+  }
   return katana::FileStoreAsync(path_, map_start_, cursor_);
 }
 
 katana::Result<void>
 katana::FileFrame::SetCursor(uint64_t new_cursor) {
+  if (upload_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "cannot move the cursor of an upload");
+  }
   if (new_cursor > map_size_) {
     KATANA_CHECKED(GrowBuffer(new_cursor - map_size_));
   }
@@ -157,6 +276,9 @@ katana::FileFrame::Tell() const {
   if (!valid_) {
     return -1;
   }
+  if (upload_) {
+    return part_offset_ + cursor_ - part_start();
+  }
   return cursor_;
 }
 
@@ -174,6 +296,14 @@ katana::FileFrame::Write(const void* data, int64_t nbytes) {
     return arrow::Status(
         arrow::StatusCode::Invalid, "Cannot Write negative bytes");
   }
+  if (upload_) {
+    if (auto res = UploadWrite(static_cast<const uint8_t*>(data), nbytes);
+        !res) {
+      return arrow::Status::IOError(
+          "FileFrame could not upload: ", fmt::format("{}", res.error()));
+    }
+    return arrow::Status::OK();
+  }
   if (cursor_ + nbytes > map_size_) {
     if (auto res = GrowBuffer(nbytes); !res) {
       return arrow::Status(
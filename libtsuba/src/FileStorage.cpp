@@ -1,9 +1,18 @@
 #include "katana/FileStorage.h"
 
 #include "FileStorage_internal.h"
+#include "katana/ErrorCode.h"
+
+katana::FileUpload::~FileUpload() = default;
 
 katana::FileStorage::~FileStorage() = default;
 
+katana::Result<std::unique_ptr<katana::FileUpload>>
+katana::FileStorage::CreateUpload(const std::string& uri) {
+  return KATANA_ERROR(
+      ErrorCode::NotImplemented, "{} has no multipart uploads", uri_scheme());
+}
+
 std::vector<katana::FileStorage*>&
 katana::GetRegisteredFileStorages() {
   static std::vector<FileStorage*> fs;
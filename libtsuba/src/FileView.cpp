@@ -1,15 +1,20 @@
 #include "katana/FileView.h"
 
+#include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <iomanip>
 #include <string>
 
+#include "katana/Env.h"
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
+#include "katana/URI.h"
 #include "katana/file.h"
 
 /*
@@ -30,6 +35,34 @@
  * somehow and also tell users to not modify our files?
  */
 
+namespace {
+
+katana::FileView::MapMode
+MapModeFromEnv() {
+  std::string mode;
+  if (!katana::GetEnv("KATANA_FILE_VIEW_MAP_MODE", &mode) || mode == "copy") {
+    return katana::FileView::MapMode::kCopy;
+  }
+  if (mode == "private") {
+    return katana::FileView::MapMode::kMapPrivate;
+  }
+  if (mode == "shared") {
+    return katana::FileView::MapMode::kMapShared;
+  }
+  KATANA_LOG_WARN(
+      "unrecognized KATANA_FILE_VIEW_MAP_MODE {}, using copy",
+      std::quoted(mode));
+  return katana::FileView::MapMode::kCopy;
+}
+
+}  // namespace
+
+katana::FileView::MapMode
+katana::FileView::DefaultMapMode() {
+  static MapMode mode = MapModeFromEnv();
+  return mode;
+}
+
 katana::FileView::~FileView() {
   if (auto res = Unbind(); !res) {
     KATANA_LOG_ERROR("Unbind: {}", res.error());
@@ -49,9 +82,12 @@ katana::FileView::Unbind() {
       }
     }
     map_start_ = nullptr;
+    file_mapped_ = false;
     file_size_ = 0;
     page_shift_ = 0;
     cursor_ = 0;
+    last_read_end_ = 0;
+    readahead_ = 0;
     mem_start_ = 0;
     filename_ = "";
     filling_ = std::vector<uint64_t>();
@@ -78,16 +114,20 @@ katana::FileView::Bind(
         begin, end, buf.size);
   }
 
-  // SCB 2020-07-23: Given that page_shift_ is treated as a compile-time
-  // constant, it seems silly to have it be a member of this class. But I can
-  // imagine one day wanting to set it dynamically based on file type, file
-  // size, type of backing storage, etc. So make it a class member and set it
-  // here.
-  page_shift_ = 20; /* 1M */
+  auto uri = KATANA_CHECKED(katana::URI::Make(filename_));
+  bool is_local = uri.scheme() == katana::URI::kFileScheme;
+
+  uint8_t page_shift = ChoosePageShift(buf.size, is_local);
   void* tmp = nullptr;
+  bool file_mapped = false;
+
+  if (buf.size > 0 && is_local && map_mode_ != MapMode::kCopy) {
+    tmp = KATANA_CHECKED_CONTEXT(MapFile(uri.path(), buf.size), "{}", filename);
+    file_mapped = true;
+  }
 
   // Map enough virtual memory to hold entire file, but do not populate it
-  if (buf.size > 0) {
+  if (buf.size > 0 && !file_mapped) {
     tmp =
         mmap(nullptr, buf.size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
     if (tmp == MAP_FAILED) {
@@ -98,8 +138,13 @@ katana::FileView::Bind(
 
   KATANA_CHECKED(Unbind());
 
+  page_shift_ = page_shift;
+  readahead_ = 0;
+  last_read_end_ = 0;
+
   map_start_ = static_cast<uint8_t*>(tmp);
-  mem_start_ = -1;
+  file_mapped_ = file_mapped;
+  mem_start_ = file_mapped ? 0 : -1;
   filling_.clear();
   filling_.resize(page_number(buf.size) / 64 + 1, 0);
   file_size_ = buf.size;
@@ -127,6 +172,20 @@ katana::FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   if (!fetches_) {
     return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
   }
+  // A mapped file is always fully present; the kernel pages it in on access.
+  // Use the fill request as a readahead hint instead.
+  if (file_mapped_) {
+    if (in_end != in_begin) {
+      uint64_t page_off = RoundDownToBlock(in_begin);
+      if (int err = madvise(
+              map_start_ + page_off, in_end - page_off, MADV_WILLNEED);
+          err) {
+        KATANA_LOG_DEBUG("madvise failed: {}", katana::ResultErrno().message());
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
   // Gracefully handle the fill zero case here to simplify Bind
   if (in_end != in_begin) {
     if (auto opt =
@@ -154,18 +213,108 @@ katana::FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
       FillingRange fetch = {first_page, last_page, std::move(peek_fut)};
       fetches_->push_back(std::move(fetch));
       KATANA_CHECKED(MarkFilled(&filling_[0], first_page, last_page));
-      if (resolve) {
-        KATANA_CHECKED(Resolve(file_off, map_size));
-      }
       int64_t signed_begin = static_cast<int64_t>(in_begin);
       if (mem_start_ < 0 || signed_begin < mem_start_) {
         mem_start_ = signed_begin;
       }
     }
+    // Pages of the range may have been filled without resolving, e.g., by a
+    // prefetch, so wait for those too
+    if (resolve) {
+      KATANA_CHECKED(Resolve(in_begin, in_end - in_begin));
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::FileView::Release(uint64_t begin, uint64_t end) {
+  if (!fetches_) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
+  }
+  uint64_t in_end = std::min<uint64_t>(end, file_size_);
+  // Only pages entirely in the range are released; the last page of the file
+  // is entirely in any range that reaches the end of the file
+  uint64_t first_page = page_number(begin + page_size() - 1);
+  uint64_t end_page = in_end == static_cast<uint64_t>(file_size_)
+                          ? page_number(in_end + page_size() - 1)
+                          : page_number(in_end);
+  if (first_page >= end_page) {
+    return katana::ResultSuccess();
+  }
+  uint64_t file_off = first_page << page_shift_;
+  uint64_t map_size =
+      std::min<uint64_t>(end_page << page_shift_, file_size_) - file_off;
+
+  if (file_mapped_) {
+    // Clean pages of a mapping are dropped and read again if touched
+    if (int err = madvise(map_start_ + file_off, map_size, MADV_DONTNEED);
+        err) {
+      KATANA_LOG_DEBUG("madvise failed: {}", katana::ResultErrno().message());
+    }
+    return katana::ResultSuccess();
+  }
+
+  // Outstanding reads must not write to the pages after they are released
+  KATANA_CHECKED(Resolve(file_off, map_size));
+  if (int err = madvise(map_start_ + file_off, map_size, MADV_DONTNEED); err) {
+    return KATANA_ERROR(katana::ResultErrno(), "releasing buffer");
+  }
+  if (int err = mprotect(map_start_ + file_off, map_size, PROT_NONE); err) {
+    return KATANA_ERROR(katana::ResultErrno(), "mprotecting buffer");
+  }
+  ClearFilled(&filling_[0], first_page, end_page - 1);
+
+  int64_t signed_off = static_cast<int64_t>(file_off);
+  if (mem_start_ >= signed_off &&
+      mem_start_ < signed_off + static_cast<int64_t>(map_size)) {
+    mem_start_ = -1;
   }
   return katana::ResultSuccess();
 }
 
+uint8_t
+katana::FileView::ChoosePageShift(uint64_t file_size, bool is_local) {
+  // Remote requests are expensive, so fetching more than was asked for is
+  // expensive too. Use small pages and rely on readahead for sequential
+  // access. Local reads are cheap, so favor fewer, larger requests.
+  uint8_t shift = is_local ? kLocalPageShift : kRemotePageShift;
+  // Bound the number of pages, and with it the size of the fill bitmap and
+  // the cost of scanning it, for very large files
+  while ((file_size >> shift) > kMaxPages && shift < kMaxPageShift) {
+    ++shift;
+  }
+  return shift;
+}
+
+katana::Result<void*>
+katana::FileView::MapFile(const std::string& path, uint64_t size) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return KATANA_ERROR(
+        katana::ResultErrno(), "opening {} for mapping", std::quoted(path));
+  }
+
+  // Private mappings are copy-on-write, so writes through them are harmless
+  // to the underlying file. Shared mappings are read-only to guarantee the
+  // same.
+  int prot = PROT_READ;
+  int flags = MAP_SHARED;
+  if (map_mode_ == MapMode::kMapPrivate) {
+    prot |= PROT_WRITE;
+    flags = MAP_PRIVATE;
+  }
+  void* tmp = mmap(nullptr, size, prot, flags, fd, 0);
+  // The mapping holds its own reference to the file
+  close(fd);
+  if (tmp == MAP_FAILED) {
+    return KATANA_ERROR(
+        katana::ResultErrno(), "mapping file {} of size {}", std::quoted(path),
+        size);
+  }
+  return tmp;
+}
+
 bool
 katana::FileView::Equals(const FileView& other) const {
   if (!bound_ || !other.bound_) {
@@ -457,6 +606,13 @@ katana::FileView::MarkFilled(uint64_t* bitmap, uint64_t begin, uint64_t end) {
   return katana::ResultSuccess();
 }
 
+void
+katana::FileView::ClearFilled(uint64_t* bitmap, uint64_t begin, uint64_t end) {
+  for (uint64_t page = begin; page <= end; ++page) {
+    bitmap[page / 64] &= ~(UINT64_C(1) << (63 - page % 64));
+  }
+}
+
 katana::Result<void>
 katana::FileView::Resolve(int64_t start, int64_t size) {
   // This loop could do less work by sorting the vector or storing an
@@ -464,7 +620,7 @@ katana::FileView::Resolve(int64_t start, int64_t size) {
   // bottleneck
   for (auto it = fetches_->begin(); it != fetches_->end();) {
     auto fetch = it;
-    if (fetch->first_page <= page_number(start + size) ||
+    if (fetch->first_page <= page_number(start + size) &&
         fetch->last_page >= page_number(start)) {
       // Complete the remaining work if there is some
       if (fetch->work.valid()) {
@@ -482,15 +638,26 @@ katana::FileView::Resolve(int64_t start, int64_t size) {
 
 katana::Result<void>
 katana::FileView::PreFetch(int64_t start, int64_t size) {
-  // Our highly sophisticated prefetching algorithm is to crudely approximate
-  // the size of the last read plus 10%. This is largely motivated by parquet
-  // files, which consecutively read row groups that are (in theory)
-  // approximately the same size.
-  int64_t fetch_size = (size / 10) * 11;
+  // Only read ahead when the cursor is moving sequentially, e.g., a topology
+  // scan or parquet consecutively reading row groups. Random access, e.g.,
+  // selecting a few columns of a parquet file, gets exactly what it asked
+  // for. Like the kernel's readahead, the window starts at the size of the
+  // last read (plus 10%), doubles with each further sequential read, and is
+  // reset by a seek.
+  bool sequential = start == last_read_end_;
+  last_read_end_ = start + size;
+  if (!sequential) {
+    readahead_ = 0;
+    return katana::ResultSuccess();
+  }
+
+  int64_t min_window = std::max<int64_t>((size / 10) * 11, page_size());
+  readahead_ = std::min<int64_t>(
+      std::max<int64_t>(readahead_ * 2, min_window), kMaxReadahead);
   // Make sure we haven't overflown
-  KATANA_LOG_DEBUG_ASSERT(fetch_size >= 0);
+  KATANA_LOG_DEBUG_ASSERT(readahead_ >= 0);
   uint64_t begin = static_cast<uint64_t>(start + size);
-  uint64_t end = static_cast<uint64_t>(start + size + fetch_size);
+  uint64_t end = static_cast<uint64_t>(start + size + readahead_);
   KATANA_CHECKED(Fill(begin, end, false));
   return katana::ResultSuccess();
 }
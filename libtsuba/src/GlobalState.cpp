@@ -4,6 +4,7 @@
 #include <cassert>
 
 #include "FileStorage_internal.h"
+#include "katana/Env.h"
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -45,6 +46,19 @@ katana::GlobalState::Init(katana::CommBackend* comm) {
   }
   registered.clear();
 
+  if (std::string cache_dir;
+      katana::GetEnv("KATANA_STORAGE_CACHE_DIR", &cache_dir)) {
+    auto options = CachingStorage::OptionsFromEnv(cache_dir);
+    for (FileStorage*& fs : global_state->file_stores_) {
+      if (fs == &global_state->local_storage_) {
+        continue;
+      }
+      fs = global_state->caching_stores_
+               .emplace_back(std::make_unique<CachingStorage>(fs, options))
+               .get();
+    }
+  }
+
   std::sort(
       global_state->file_stores_.begin(), global_state->file_stores_.end(),
       [](const FileStorage* lhs, const FileStorage* rhs) {
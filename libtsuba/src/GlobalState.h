@@ -4,6 +4,7 @@
 #include <memory>
 #include <vector>
 
+#include "CachingStorage.h"
 #include "LocalStorage.h"
 #include "katana/CommBackend.h"
 #include "katana/FileStorage.h"
@@ -19,6 +20,8 @@ class GlobalState {
   katana::CommBackend* comm_;
 
   katana::LocalStorage local_storage_;
+  /// Local caches of remote file stores; see CachingStorage
+  std::vector<std::unique_ptr<CachingStorage>> caching_stores_;
 
   GlobalState(katana::CommBackend* comm) : comm_(comm) {
     file_stores_.emplace_back(&local_storage_);
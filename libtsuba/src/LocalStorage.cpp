@@ -7,7 +7,9 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <iomanip>
 #include <iterator>
 #include <system_error>
 
@@ -15,6 +17,7 @@
 #include <boost/system/error_code.hpp>
 
 #include "GlobalState.h"
+#include "katana/Env.h"
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -25,6 +28,40 @@ namespace fs = boost::filesystem;
 
 namespace {
 
+/// Default number of reads to have in flight at once
+constexpr uint32_t kDefaultQueueDepth = 16;
+
+/// GetMultiSync reads larger than this are split into chunks of this size
+/// that are read concurrently
+constexpr uint64_t kReadChunkSize = UINT64_C(16) << 20; /* 16M */
+
+uint32_t
+QueueDepthFromEnv() {
+  int depth = kDefaultQueueDepth;
+  katana::GetEnv("KATANA_LOCAL_STORAGE_QUEUE_DEPTH", &depth);
+  if (depth < 0) {
+    KATANA_LOG_WARN(
+        "ignoring negative KATANA_LOCAL_STORAGE_QUEUE_DEPTH {}", depth);
+    return kDefaultQueueDepth;
+  }
+  return depth;
+}
+
+katana::CopyableResult<void>
+ToCopyable(katana::Result<void> res) {
+  if (!res) {
+    return katana::CopyableErrorInfo{res.error()};
+  }
+  return katana::CopyableResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+MakeReadyFuture(katana::CopyableResult<void> res) {
+  std::promise<katana::CopyableResult<void>> promise;
+  promise.set_value(std::move(res));
+  return promise.get_future();
+}
+
 katana::Result<void>
 EnsureDirectories(const std::string& path) {
   fs::path m_path{path};
@@ -47,8 +84,86 @@ GetPath(const std::string& uri) {
   return u.path();
 }
 
+class LocalUpload : public katana::FileUpload {
+public:
+  LocalUpload(std::string path, std::string tmp_path, int fd)
+      : path_(std::move(path)), tmp_path_(std::move(tmp_path)), fd_(fd) {}
+
+  ~LocalUpload() override {
+    if (fd_ >= 0) {
+      if (auto res = Abort(); !res) {
+        KATANA_LOG_ERROR("aborting upload of {}: {}", path_, res.error());
+      }
+    }
+  }
+
+  katana::Result<void> PutPart(
+      uint64_t offset, const uint8_t* data, uint64_t size) override {
+    while (size > 0) {
+      ssize_t written = pwrite(fd_, data, size, offset);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return KATANA_ERROR(
+            katana::ResultErrno(), "writing {}", std::quoted(tmp_path_));
+      }
+      data += written;
+      offset += written;
+      size -= written;
+    }
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> Complete() override {
+    int err = close(fd_);
+    fd_ = -1;
+    if (err != 0 || rename(tmp_path_.c_str(), path_.c_str()) != 0) {
+      auto res = KATANA_ERROR(
+          katana::ResultErrno(), "storing {}", std::quoted(path_));
+      unlink(tmp_path_.c_str());
+      return res;
+    }
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> Abort() override {
+    close(fd_);
+    fd_ = -1;
+    if (unlink(tmp_path_.c_str()) != 0) {
+      return KATANA_ERROR(
+          katana::ResultErrno(), "removing {}", std::quoted(tmp_path_));
+    }
+    return katana::ResultSuccess();
+  }
+
+private:
+  std::string path_;
+  std::string tmp_path_;
+  int fd_;
+};
+
 }  // namespace
 
+katana::Result<std::unique_ptr<katana::FileUpload>>
+katana::LocalStorage::CreateUpload(const std::string& uri) {
+  std::string path = KATANA_CHECKED(GetPath(uri));
+  KATANA_CHECKED(EnsureDirectories(path));
+
+  // unique among the uploads of all processes; open applies the umask as
+  // for files stored whole
+  static std::atomic<uint64_t> next_upload{0};
+  std::string tmp_path = fmt::format(
+      "{}.upload-{}-{}", path, getpid(), next_upload.fetch_add(1));
+  int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+  if (fd < 0) {
+    return KATANA_ERROR(
+        katana::ResultErrno(), "creating {}", std::quoted(tmp_path));
+  }
+  return std::unique_ptr<FileUpload>(
+      std::make_unique<LocalUpload>(path, tmp_path, fd));
+}
+
 katana::Result<void>
 katana::LocalStorage::WriteFile(
     const std::string& uri, const uint8_t* data, uint64_t size) {
@@ -95,36 +210,172 @@ katana::LocalStorage::RemoteCopyFile(
   return katana::ResultSuccess();
 }
 
-katana::Result<void>
-katana::LocalStorage::ReadFile(
-    const std::string& uri, uint64_t start, uint64_t size, uint8_t* data) {
-  std::string path = KATANA_CHECKED(GetPath(uri));
-  std::ifstream ifile(path, std::ios_base::binary);
-  if (!ifile) {
-    return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "failed to open source file {}",
-        std::quoted(path));
+katana::LocalReadQueue::~LocalReadQueue() { Stop(); }
+
+void
+katana::LocalReadQueue::Start(uint32_t queue_depth) {
+  KATANA_LOG_DEBUG_ASSERT(workers_.empty());
+  stopping_ = false;
+  for (uint32_t i = 0; i < queue_depth; ++i) {
+    workers_.emplace_back([this]() { Work(); });
   }
+}
 
-  ifile.seekg(start);
-  if (!ifile) {
+void
+katana::LocalReadQueue::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+std::future<katana::CopyableResult<void>>
+katana::LocalReadQueue::Submit(
+    std::string path, uint64_t start, uint64_t size, uint8_t* data) {
+  if (workers_.empty()) {
+    return MakeReadyFuture(ToCopyable(Read(path, start, size, data)));
+  }
+
+  std::future<katana::CopyableResult<void>> future;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.emplace_back(Request{
+        .path = std::move(path),
+        .start = start,
+        .size = size,
+        .data = data,
+        .promise = {},
+    });
+    future = requests_.back().promise.get_future();
+  }
+  cv_.notify_one();
+  return future;
+}
+
+void
+katana::LocalReadQueue::Work() {
+  for (;;) {
+    Request req;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return stopping_ || !requests_.empty(); });
+      // Drain outstanding requests before stopping so that no future is left
+      // without a value
+      if (requests_.empty()) {
+        return;
+      }
+      req = std::move(requests_.front());
+      requests_.pop_front();
+    }
+    req.promise.set_value(
+        ToCopyable(Read(req.path, req.start, req.size, req.data)));
+  }
+}
+
+katana::Result<void>
+katana::LocalReadQueue::Read(
+    const std::string& path, uint64_t start, uint64_t size, uint8_t* data) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
     return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "failed to seek to offset {}", start);
+        ErrorCode::LocalStorageError, "failed to open source file {}: {}",
+        std::quoted(path), katana::ResultErrno().message());
   }
 
-  ifile.read(reinterpret_cast<char*>(data), size); /* NOLINT */
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to read");
+  uint64_t done = 0;
+  while (done < size) {
+    ssize_t ret = pread(fd, data + done, size - done, start + done);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      std::error_code ec = katana::ResultErrno();
+      close(fd);
+      return KATANA_ERROR(
+          ErrorCode::LocalStorageError, "failed to read {} at offset {}: {}",
+          std::quoted(path), start + done, ec.message());
+    }
+    if (ret == 0) {
+      break;
+    }
+    done += ret;
   }
+  close(fd);
 
   // if the difference in what was read from what we wanted is less  than a
   // block it's because the file size isn't well aligned so don't complain.
-  if (size - ifile.gcount() > kBlockSize) {
-    return ErrorCode::LocalStorageError;
+  if (size - done > kBlockSize) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError,
+        "short read of {}: wanted {} bytes at offset {} but read {}",
+        std::quoted(path), size, start, done);
   }
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::LocalStorage::Init() {
+  read_queue_.Start(QueueDepthFromEnv());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::LocalStorage::Fini() {
+  read_queue_.Stop();
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::LocalStorage::ReadFile(
+    const std::string& uri, uint64_t start, uint64_t size, uint8_t* data) {
+  std::string path = KATANA_CHECKED(GetPath(uri));
+  return LocalReadQueue::Read(path, start, size, data);
+}
+
+katana::Result<void>
+katana::LocalStorage::GetMultiSync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  if (size <= kReadChunkSize || read_queue_.queue_depth() <= 1) {
+    return ReadFile(uri, start, size, result_buf);
+  }
+
+  std::string path = KATANA_CHECKED(GetPath(uri));
+  std::vector<std::future<katana::CopyableResult<void>>> futures;
+  for (uint64_t off = 0; off < size; off += kReadChunkSize) {
+    uint64_t chunk_size = std::min(kReadChunkSize, size - off);
+    futures.emplace_back(
+        read_queue_.Submit(path, start + off, chunk_size, result_buf + off));
+  }
+
+  // Wait for every chunk even if one fails so that no read is left writing
+  // into result_buf after we return
+  katana::Result<void> ret = katana::ResultSuccess();
+  for (auto& future : futures) {
+    if (auto res = future.get(); !res && ret) {
+      ret = katana::ErrorInfo{res.error()};
+    }
+  }
+  return ret;
+}
+
+std::future<katana::CopyableResult<void>>
+katana::LocalStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  auto path_res = GetPath(uri);
+  if (!path_res) {
+    return MakeReadyFuture(katana::CopyableErrorInfo{path_res.error()});
+  }
+  return read_queue_.Submit(
+      std::move(path_res.value()), start, size, result_buf);
+}
+
 katana::Result<void>
 katana::LocalStorage::Stat(const std::string& uri, StatBuf* s_buf) {
   std::string path = KATANA_CHECKED(GetPath(uri));
@@ -3,18 +3,72 @@
 
 #include <sys/mman.h>
 
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <future>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "katana/FileStorage.h"
 #include "katana/Result.h"
 
 namespace katana {
 
-/// Store byte arrays to the local file system; Provided as a convenience for
-/// testing only (un-optimized)
+/// A fixed pool of threads that service positional reads of local files.
+///
+/// Reads submitted together, e.g., all the reads of a ReadGroup or the chunks
+/// of a large GetMultiSync, are outstanding at the same time, so load time
+/// scales with device parallelism rather than with the number of files. The
+/// number of worker threads bounds the number of reads in flight (the queue
+/// depth).
+class LocalReadQueue {
+public:
+  LocalReadQueue() = default;
+  LocalReadQueue(const LocalReadQueue& no_copy) = delete;
+  LocalReadQueue& operator=(const LocalReadQueue& no_copy) = delete;
+  ~LocalReadQueue();
+
+  /// Start queue_depth workers; a queue_depth of zero means reads are
+  /// performed synchronously by the submitting thread.
+  void Start(uint32_t queue_depth);
+  void Stop();
+
+  uint32_t queue_depth() const { return workers_.size(); }
+
+  /// Read size bytes starting at start from the file at path into data.
+  /// data must remain valid until the returned future is ready.
+  std::future<katana::CopyableResult<void>> Submit(
+      std::string path, uint64_t start, uint64_t size, uint8_t* data);
+
+  /// Read synchronously in the calling thread
+  static katana::Result<void> Read(
+      const std::string& path, uint64_t start, uint64_t size, uint8_t* data);
+
+private:
+  struct Request {
+    std::string path;
+    uint64_t start;
+    uint64_t size;
+    uint8_t* data;
+    std::promise<katana::CopyableResult<void>> promise;
+  };
+
+  void Work();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request> requests_;
+  std::vector<std::thread> workers_;
+  bool stopping_{false};
+};
+
+/// Store byte arrays to the local file system
+///
+/// Reads are serviced by a LocalReadQueue whose depth can be set with the
+/// environment variable KATANA_LOCAL_STORAGE_QUEUE_DEPTH.
 class LocalStorage : public FileStorage {
   katana::Result<void> WriteFile(
       const std::string&, const uint8_t* data, uint64_t size);
@@ -24,26 +78,32 @@ class LocalStorage : public FileStorage {
       const std::string& source_uri, const std::string& dest_uri,
       uint64_t begin, uint64_t size);
 
+  LocalReadQueue read_queue_;
+
 public:
   LocalStorage() : FileStorage("file://") {}
 
-  katana::Result<void> Init() override { return katana::ResultSuccess(); }
-  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override;
   katana::Result<void> Stat(const std::string& uri, StatBuf* s_buf) override;
 
   uint32_t Priority() const override { return 1; }
 
+  /// Large reads are split into chunks that are read concurrently
   katana::Result<void> GetMultiSync(
       const std::string& uri, uint64_t start, uint64_t size,
-      uint8_t* result_buf) override {
-    return ReadFile(uri, start, size, result_buf);
-  }
+      uint8_t* result_buf) override;
 
   katana::Result<void> PutMultiSync(
       const std::string& uri, const uint8_t* data, uint64_t size) override {
     return WriteFile(uri, data, size);
   }
 
+  /// Parts are written to a temporary file next to the destination, which
+  /// is renamed into place on Complete
+  katana::Result<std::unique_ptr<FileUpload>> CreateUpload(
+      const std::string& uri) override;
+
   katana::Result<void> RemoteCopy(
       const std::string& source_uri, const std::string& dest_uri,
       uint64_t begin, uint64_t size) override {
@@ -67,19 +127,7 @@ public:
   }
   std::future<katana::CopyableResult<void>> GetAsync(
       const std::string& uri, uint64_t start, uint64_t size,
-      uint8_t* result_buf) override {
-    // I suppose there is no need for AsyncGet to local storage either
-    if (auto read_res = ReadFile(uri, start, size, result_buf); !read_res) {
-      katana::CopyableErrorInfo cei{read_res.error()};
-      return std::async(
-          std::launch::deferred,
-          [=]() -> katana::CopyableResult<void> { return cei; });
-    }
-    return std::async(
-        std::launch::deferred, []() -> katana::CopyableResult<void> {
-          return katana::CopyableResultSuccess();
-        });
-  }
+      uint8_t* result_buf) override;
   std::future<katana::CopyableResult<void>> ListAsync(
       const std::string& uri, std::vector<std::string>* list,
       std::vector<uint64_t>* size) override;
@@ -0,0 +1,116 @@
+#include "katana/MemoryPlacement.h"
+
+#include <vector>
+
+#include <arrow/util/bit_util.h>
+#include <arrow/util/bitmap_ops.h>
+
+#include "katana/NumaMem.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+/// A buffer over a huge page allocation that frees it with the buffer
+class PlacedBuffer : public arrow::Buffer {
+public:
+  PlacedBuffer(katana::LAptr mem, int64_t size)
+      : arrow::Buffer(static_cast<const uint8_t*>(mem.get()), size),
+        mem_(std::move(mem)) {}
+
+private:
+  katana::LAptr mem_;
+};
+
+/// \returns the width in bytes of the values of type, or 0 if type is not a
+/// column of byte-aligned fixed width values
+int
+ValueBytes(const arrow::DataType& type) {
+  // dictionary indices mean nothing without the dictionary
+  if (!arrow::is_fixed_width(type.id()) || type.id() == arrow::Type::NA ||
+      type.id() == arrow::Type::DICTIONARY ||
+      type.id() == arrow::Type::EXTENSION) {
+    return 0;
+  }
+  int width = static_cast<const arrow::FixedWidthType&>(type).bit_width();
+  return width % 8 == 0 ? width / 8 : 0;
+}
+
+bool
+IsPlaced(const arrow::ChunkedArray& array) {
+  if (array.num_chunks() != 1) {
+    return false;
+  }
+  const auto& buffers = array.chunk(0)->data()->buffers;
+  return buffers.size() > 1 &&
+         std::dynamic_pointer_cast<PlacedBuffer>(buffers[1]) != nullptr;
+}
+
+}  // namespace
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::PlaceInMemory(
+    const std::shared_ptr<arrow::ChunkedArray>& array,
+    MemoryPlacement placement, uint64_t min_bytes) {
+  int value_bytes = ValueBytes(*array->type());
+  int64_t length = array->length();
+  uint64_t bytes = static_cast<uint64_t>(length) * value_bytes;
+  if (placement == MemoryPlacement::kDefault || value_bytes == 0 ||
+      bytes == 0 || bytes < min_bytes || IsPlaced(*array)) {
+    return array;
+  }
+
+  katana::LAptr mem =
+      placement == MemoryPlacement::kBlocked
+          ? katana::largeMallocBlocked(bytes, activeThreads)
+          : katana::largeMallocInterleaved(bytes, activeThreads);
+  auto* values = static_cast<uint8_t*>(mem.get());
+
+  std::shared_ptr<arrow::Buffer> validity;
+  if (array->null_count() > 0) {
+    validity = KATANA_CHECKED(arrow::AllocateEmptyBitmap(length));
+  }
+
+  int64_t row = 0;
+  for (const auto& chunk : array->chunks()) {
+    if (chunk->length() == 0) {
+      continue;
+    }
+    const uint8_t* chunk_values =
+        chunk->data()->buffers[1]->data() + chunk->offset() * value_bytes;
+    katana::ParallelSTL::copy(
+        chunk_values, chunk_values + chunk->length() * value_bytes,
+        values + row * value_bytes);
+    if (validity) {
+      if (chunk->null_count() > 0) {
+        arrow::internal::CopyBitmap(
+            chunk->null_bitmap_data(), chunk->offset(), chunk->length(),
+            validity->mutable_data(), row);
+      } else {
+        arrow::BitUtil::SetBitsTo(
+            validity->mutable_data(), row, chunk->length(), true);
+      }
+    }
+    row += chunk->length();
+  }
+
+  auto data = arrow::ArrayData::Make(
+      array->type(), length,
+      {validity, std::make_shared<PlacedBuffer>(std::move(mem), bytes)},
+      array->null_count());
+  return std::make_shared<arrow::ChunkedArray>(arrow::MakeArray(data));
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::PlaceInMemory(
+    const std::shared_ptr<arrow::Table>& table, MemoryPlacement placement,
+    uint64_t min_bytes) {
+  if (placement == MemoryPlacement::kDefault) {
+    return table;
+  }
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& column : table->columns()) {
+    columns.emplace_back(
+        KATANA_CHECKED(PlaceInMemory(column, placement, min_bytes)));
+  }
+  return arrow::Table::Make(table->schema(), columns, table->num_rows());
+}
@@ -9,11 +9,15 @@
 #include <arrow/compute/cast.h>
 #include <arrow/type.h>
 #include <arrow/type_fwd.h>
+#include <arrow/util/parallel.h>
+#include <arrow/util/thread_pool.h>
+#include <parquet/arrow/reader.h>
 #include <parquet/arrow/schema.h>
 
 #include "katana/ErrorCode.h"
 #include "katana/FileView.h"
 #include "katana/JSON.h"
+#include "katana/Threads.h"
 
 template <typename T>
 using Result = katana::Result<T>;
@@ -56,22 +60,78 @@ HandleBadParquetTypes(std::shared_ptr<arrow::Field> old_field) {
   }
 }
 
+/// Whether a view can read the chunks of a column of type in place; see
+/// katana::PODPropertyView
+bool
+IsReadInChunks(const arrow::DataType& type) {
+  if (type.id() == arrow::Type::DICTIONARY ||
+      type.id() == arrow::Type::EXTENSION) {
+    return false;
+  }
+  const auto* fixed_width = dynamic_cast<const arrow::FixedWidthType*>(&type);
+  return fixed_width && fixed_width->bit_width() % 8 == 0;
+}
+
+/// Combine the chunks of the columns of table that are not read in chunks
+Result<std::shared_ptr<arrow::Table>>
+CombineChunksNotReadInChunks(const std::shared_ptr<arrow::Table>& table) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns = table->columns();
+  for (int i = 0, size = table->num_columns(); i < size; ++i) {
+    if (columns[i]->num_chunks() <= 1 || IsReadInChunks(*columns[i]->type())) {
+      continue;
+    }
+    auto column_table = arrow::Table::Make(
+        arrow::schema({table->field(i)}), {columns[i]}, table->num_rows());
+    auto combined = KATANA_CHECKED(
+        column_table->CombineChunks(arrow::default_memory_pool()));
+    columns[i] = combined->column(0);
+  }
+  return arrow::Table::Make(table->schema(), columns, table->num_rows());
+}
+
+/// Open a reader of the Parquet file in fv. If metadata is given, the footer
+/// of the file is not read again. If read_dictionary, string and binary
+/// columns are read as arrow::DictionaryArrays of the dictionary pages
+/// Parquet wrote for them, rather than being decoded into one value per row
+Result<std::unique_ptr<parquet::arrow::FileReader>>
+OpenReader(
+    const std::shared_ptr<katana::FileView>& fv, bool read_dictionary,
+    const std::shared_ptr<parquet::FileMetaData>& metadata = nullptr) {
+  parquet::arrow::FileReaderBuilder builder;
+  KATANA_CHECKED(
+      builder.Open(fv, parquet::default_reader_properties(), metadata));
+
+  parquet::ArrowReaderProperties properties;
+  if (read_dictionary) {
+    const parquet::SchemaDescriptor* schema =
+        builder.raw_reader()->metadata()->schema();
+    for (int i = 0, n = schema->num_columns(); i < n; ++i) {
+      if (schema->Column(i)->physical_type() == parquet::Type::BYTE_ARRAY) {
+        properties.set_read_dictionary(i, true);
+      }
+    }
+  }
+
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  KATANA_CHECKED(builder.memory_pool(arrow::default_memory_pool())
+                     ->properties(properties)
+                     ->Build(&reader));
+
+  return std::unique_ptr<parquet::arrow::FileReader>(std::move(reader));
+}
+
+/// Open a reader of the Parquet file at uri; see OpenReader
 Result<std::unique_ptr<parquet::arrow::FileReader>>
 BuildReader(
     const std::string& uri, bool preload,
-    std::shared_ptr<katana::FileView>* fv) {
+    std::shared_ptr<katana::FileView>* fv, bool read_dictionary = false) {
   auto fv_tmp = std::make_shared<katana::FileView>();
   uint64_t end = preload ? std::numeric_limits<uint64_t>::max() : 0;
   KATANA_CHECKED_CONTEXT(
       fv_tmp->Bind(uri, 0, end, false), "opening {}; begin: {}, end: {}", uri,
       0, end);
   *fv = fv_tmp;
-
-  std::unique_ptr<parquet::arrow::FileReader> reader;
-  KATANA_CHECKED(
-      parquet::arrow::OpenFile(fv_tmp, arrow::default_memory_pool(), &reader));
-
-  return std::unique_ptr<parquet::arrow::FileReader>(std::move(reader));
+  return OpenReader(fv_tmp, read_dictionary);
 }
 
 Result<std::shared_ptr<arrow::Table>>
@@ -109,6 +169,74 @@ ReadTableSlice(
   return out->Slice(row_offset, last_row - first_row);
 }
 
+/// Return the range of bytes [first, second) in the file that holds row group
+/// rg
+std::pair<int64_t, int64_t>
+RowGroupByteRange(parquet::arrow::FileReader* reader, int rg) {
+  auto rg_md = reader->parquet_reader()->metadata()->RowGroup(rg);
+  int64_t begin = std::numeric_limits<int64_t>::max();
+  int64_t end = 0;
+  for (int c = 0, num_cols = rg_md->num_columns(); c < num_cols; ++c) {
+    auto cc_md = rg_md->ColumnChunk(c);
+    int64_t offset = cc_md->data_page_offset();
+    if (cc_md->has_dictionary_page()) {
+      offset = std::min(offset, cc_md->dictionary_page_offset());
+    }
+    begin = std::min(begin, offset);
+    end = std::max(end, offset + cc_md->total_compressed_size());
+  }
+  if (begin > end) {
+    return {0, 0};
+  }
+  return {begin, end};
+}
+
+/// Read all the row groups of a file. The byte ranges of all row groups are
+/// requested from storage up front and the row groups are decoded in parallel
+/// as their data arrives.
+Result<std::shared_ptr<arrow::Table>>
+ReadRowGroupsParallel(
+    parquet::arrow::FileReader* reader,
+    const std::shared_ptr<katana::FileView>& fv, bool read_dictionary) {
+  int rg_count = reader->num_row_groups();
+  if (rg_count <= 1) {
+    // Nothing to overlap; decode columns in parallel instead
+    reader->set_use_threads(true);
+    std::shared_ptr<arrow::Table> out;
+    KATANA_CHECKED(reader->ReadTable(&out));
+    return out;
+  }
+
+  // FileView is not thread safe, so start every fetch before decoding. Reads
+  // from decoding threads are serialized by arrow::io::RandomAccessFile and
+  // only wait for the fetch of the range they touch.
+  for (int i = 0; i < rg_count; ++i) {
+    auto [begin, end] = RowGroupByteRange(reader, i);
+    KATANA_CHECKED(fv->Fill(begin, end, false));
+  }
+
+  // A FileReader is not thread safe, so each row group gets its own. They
+  // share the metadata already read, so opening them reads nothing.
+  std::shared_ptr<parquet::FileMetaData> metadata =
+      reader->parquet_reader()->metadata();
+  std::vector<std::unique_ptr<parquet::arrow::FileReader>> rg_readers;
+  for (int i = 0; i < rg_count; ++i) {
+    rg_readers.emplace_back(
+        KATANA_CHECKED(OpenReader(fv, read_dictionary, metadata)));
+  }
+
+  int num_threads = std::max<int>(1, katana::getActiveThreads());
+  if (arrow::GetCpuThreadPoolCapacity() < num_threads) {
+    KATANA_CHECKED(arrow::SetCpuThreadPoolCapacity(num_threads));
+  }
+
+  std::vector<std::shared_ptr<arrow::Table>> tables(rg_count);
+  KATANA_CHECKED(arrow::internal::ParallelFor(rg_count, [&](int i) {
+    return rg_readers[i]->ReadRowGroup(i, &tables[i]);
+  }));
+  return KATANA_CHECKED(arrow::ConcatenateTables(tables));
+}
+
 class BlockedParquetReader {
 public:
   /// Read a potentially blocked Parquet file at the provide uri
@@ -129,10 +257,18 @@ public:
   /// "[0, 10]" corresponds to a single logical table who's rows 0-9 are in
   /// "s3://example_file/table.parquet.part_000000000" and rows 10-end are
   /// in "s3://example_file/table.parquet.part_000000001"
+  ///
+  /// If parallel_decode is true, reads of whole tables fetch and decode row
+  /// groups in parallel (see ReadRowGroupsParallel). If read_dictionary is
+  /// true, string columns are read dictionary encoded (see BuildReader).
   static Result<std::unique_ptr<BlockedParquetReader>> Make(
-      const katana::URI& uri, bool preload) {
+      const katana::URI& uri, bool preload, bool parallel_decode = false,
+      bool read_dictionary = false) {
+    // Parallel decoding fetches row groups individually
+    preload = preload && !parallel_decode;
     std::shared_ptr<katana::FileView> fv;
-    auto builder_res = BuildReader(uri.string(), preload, &fv);
+    auto builder_res =
+        BuildReader(uri.string(), preload, &fv, read_dictionary);
 
     if (builder_res) {
       std::vector<std::unique_ptr<parquet::arrow::FileReader>> readers;
@@ -141,7 +277,8 @@ public:
       fvs.emplace_back(std::move(fv));
 
       return std::unique_ptr<BlockedParquetReader>(new BlockedParquetReader(
-          uri.string(), std::move(fvs), std::move(readers), {0}));
+          uri.string(), std::move(fvs), std::move(readers), {0},
+          parallel_decode, read_dictionary));
     }
 
     if (builder_res.error() != katana::ErrorCode::InvalidArgument) {
@@ -169,7 +306,7 @@ public:
 
     std::unique_ptr<BlockedParquetReader> bpr(new BlockedParquetReader(
         uri.string(), std::move(fvs), std::move(readers),
-        std::move(row_offsets)));
+        std::move(row_offsets), parallel_decode, read_dictionary));
 
     if (preload) {
       for (size_t i = 0, num_files = bpr->row_offsets_.size(); i < num_files;
@@ -205,9 +342,15 @@ public:
     if (!slice) {
       std::vector<std::shared_ptr<arrow::Table>> tables;
       for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
-        KATANA_CHECKED(EnsureReader(i, true));
         std::shared_ptr<arrow::Table> table;
-        KATANA_CHECKED(readers_[i]->ReadTable(&table));
+        if (parallel_decode_) {
+          KATANA_CHECKED(EnsureReader(i, false));
+          table = KATANA_CHECKED(ReadRowGroupsParallel(
+              readers_[i].get(), fvs_[i], read_dictionary_));
+        } else {
+          KATANA_CHECKED(EnsureReader(i, true));
+          KATANA_CHECKED(readers_[i]->ReadTable(&table));
+        }
         tables.emplace_back(std::move(table));
       }
       return KATANA_CHECKED(arrow::ConcatenateTables(tables));
@@ -334,11 +477,14 @@ private:
   BlockedParquetReader(
       std::string prefix, std::vector<std::shared_ptr<katana::FileView>>&& fvs,
       std::vector<std::unique_ptr<parquet::arrow::FileReader>>&& readers,
-      std::vector<int64_t>&& row_offsets)
+      std::vector<int64_t>&& row_offsets, bool parallel_decode,
+      bool read_dictionary)
       : prefix_(std::move(prefix)),
         fvs_(std::move(fvs)),
         readers_(std::move(readers)),
-        row_offsets_(std::move(row_offsets)) {}
+        row_offsets_(std::move(row_offsets)),
+        parallel_decode_(parallel_decode),
+        read_dictionary_(read_dictionary) {}
 
   Result<void> EnsureReader(size_t idx, bool preload = false) {
     if (readers_[idx]) {
@@ -346,7 +492,8 @@ private:
       return katana::ResultSuccess();
     }
     readers_[idx] = KATANA_CHECKED(BuildReader(
-        fmt::format("{}.part_{:09}", prefix_, idx), preload, &fvs_[idx]));
+        fmt::format("{}.part_{:09}", prefix_, idx), preload, &fvs_[idx],
+        read_dictionary_));
 
     return katana::ResultSuccess();
   }
@@ -355,13 +502,17 @@ private:
   std::vector<std::shared_ptr<katana::FileView>> fvs_;
   std::vector<std::unique_ptr<parquet::arrow::FileReader>> readers_;
   std::vector<int64_t> row_offsets_;
+  bool parallel_decode_;
+  bool read_dictionary_;
 };
 
 }  // namespace
 
 Result<std::unique_ptr<katana::ParquetReader>>
 katana::ParquetReader::Make(ReadOpts opts) {
-  return std::unique_ptr<ParquetReader>(new ParquetReader(opts.make_canonical));
+  return std::unique_ptr<ParquetReader>(new ParquetReader(
+      opts.make_canonical, opts.parallel_decode,
+      opts.combine_fixed_width_chunks, opts.read_strings_as_dictionary));
 }
 
 Result<std::shared_ptr<arrow::Table>>
@@ -377,7 +528,8 @@ katana::ParquetReader::ReadTable(
     preload = false;
   }
 
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, preload));
+  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(
+      uri, preload, parallel_decode_ && !slice, read_strings_as_dictionary_));
   return FixTable(KATANA_CHECKED(bpr->ReadTable(slice)));
 }
 
@@ -389,7 +541,8 @@ katana::ParquetReader::GetSchema(const katana::URI& uri) {
 
 Result<std::shared_ptr<arrow::Table>>
 katana::ParquetReader::ReadColumn(const katana::URI& uri, int32_t column_idx) {
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
+  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(
+      uri, false, false, read_strings_as_dictionary_));
   return FixTable(KATANA_CHECKED(bpr->ReadTable({column_idx})));
 }
 
@@ -397,7 +550,8 @@ Result<std::shared_ptr<arrow::Table>>
 katana::ParquetReader::ReadTable(
     const katana::URI& uri, const std::vector<int32_t>& column_indexes,
     std::optional<katana::ParquetReader::Slice> slice) {
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
+  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(
+      uri, false, false, read_strings_as_dictionary_));
   return FixTable(KATANA_CHECKED(bpr->ReadTable(column_indexes, slice)));
 }
 
@@ -466,7 +620,11 @@ katana::ParquetReader::FixTable(std::shared_ptr<arrow::Table>&& _table) {
   // combined into a single chunk due to the fact the offset type for these
   // columns is int32_t and thus the maximum size of an arrow::Array for these
   // types is 2^31.
-  table = KATANA_CHECKED(table->CombineChunks(arrow::default_memory_pool()));
+  if (combine_fixed_width_chunks_) {
+    table = KATANA_CHECKED(table->CombineChunks(arrow::default_memory_pool()));
+  } else {
+    table = KATANA_CHECKED(CombineChunksNotReadInChunks(table));
+  }
 
   // lots of the code base assumes chunks will exist, but arrow allows zero length
   // chunked arrays to have zero chunks. Let's be helpful.
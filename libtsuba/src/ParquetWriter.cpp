@@ -1,6 +1,11 @@
 #include "katana/ParquetWriter.h"
 
+#include <algorithm>
+#include <deque>
+#include <future>
+
 #include "katana/ArrowInterchange.h"
+#include "katana/Env.h"
 #include "katana/ErrorCode.h"
 #include "katana/FaultTest.h"
 #include "katana/JSON.h"
@@ -67,10 +72,21 @@ DoStoreParquet(
   auto ff = std::make_shared<katana::FileFrame>();
   KATANA_CHECKED(ff->Init());
   ff->Bind(path);
+  KATANA_CHECKED(ff->StartUpload());
+
+  // Encoding runs in the op, so the caller can go on to the next table while
+  // this one is encoded and uploaded; the in-memory size stands in for the
+  // encoded size, which is not known until then
+  uint64_t accounted_size = table->num_rows() > 0
+                                ? EstimateRowSize(table) * table->num_rows()
+                                : 0;
+  if (desc) {
+    desc->WaitForRoom(accounted_size);
+  }
 
   auto future = std::async(
       std::launch::async,
-      [table = std::move(table), ff = std::move(ff), desc, writer_props,
+      [table = std::move(table), ff = std::move(ff), writer_props,
        arrow_props]() mutable -> katana::CopyableResult<void> {
         auto write_result = parquet::arrow::WriteTable(
             *table, arrow::default_memory_pool(), ff,
@@ -81,12 +97,10 @@ DoStoreParquet(
           return KATANA_ERROR(
               katana::ErrorCode::ArrowError, "arrow error: {}", write_result);
         }
-        if (desc) {
-          desc->AddToOutstanding(ff->map_size());
-        }
 
         TSUBA_PTP(katana::internal::FaultSensitivity::Normal);
         KATANA_CHECKED(ff->Persist());
+        ff.reset();
 
         return katana::CopyableResultSuccess();
       });
@@ -96,7 +110,7 @@ DoStoreParquet(
     return katana::ResultSuccess();
   }
 
-  desc->AddOp(std::move(future), path);
+  desc->AddOp(std::move(future), path, accounted_size);
   return katana::ResultSuccess();
 }
 
@@ -115,6 +129,11 @@ katana::ParquetWriter::Make(
 Result<std::unique_ptr<katana::ParquetWriter>>
 katana::ParquetWriter::Make(
     std::shared_ptr<arrow::Table> table, WriteOpts opts) {
+  if (int env_mbs = 0;
+      katana::GetEnv("KATANA_PARQUET_WRITE_PART_MB", &env_mbs) &&
+      env_mbs > 0) {
+    opts.mbs_per_part = env_mbs;
+  }
   if (!opts.write_blocked) {
     return std::unique_ptr<ParquetWriter>(
         new ParquetWriter({std::move(table)}, opts));
@@ -155,6 +174,11 @@ katana::ParquetWriter::StoreParquet(
   auto arrow_props = StandardArrowProperties();
   std::string prefix = uri.string();
 
+  if (opts_.write_streaming && table->num_rows() > 1 &&
+      EstimateRowSize(table) * table->num_rows() > opts_.mbs_per_part * kMB) {
+    return StoreParquetStreaming(std::move(table), uri, desc);
+  }
+
   if (table->num_rows() <= kMaxRowsPerFile) {
     return DoStoreParquet(prefix, table, writer_props, arrow_props, desc);
   }
@@ -185,6 +209,105 @@ katana::ParquetWriter::StoreParquet(
       uri.string(), KATANA_CHECKED(katana::JsonDump(table_offsets)));
 }
 
+/// Encode the table a part at a time, starting each part's upload as soon as
+/// it is encoded. At most max_inflight_mbs of encoded parts wait on storage at
+/// once; the rest of the table is not encoded until some of them finish
+katana::Result<void>
+katana::ParquetWriter::StoreParquetStreaming(
+    std::shared_ptr<arrow::Table> table, const katana::URI& uri,
+    katana::WriteGroup* desc) {
+  auto writer_props = StandardWriterProperties();
+  auto arrow_props = StandardArrowProperties();
+  std::string prefix = uri.string();
+
+  uint64_t max_inflight_mbs = opts_.max_inflight_mbs;
+  if (int env_mbs = 0;
+      katana::GetEnv("KATANA_PARQUET_WRITE_INFLIGHT_MB", &env_mbs) &&
+      env_mbs > 0) {
+    max_inflight_mbs = env_mbs;
+  }
+  uint64_t max_inflight = std::max<uint64_t>(max_inflight_mbs, 1) * kMB;
+
+  uint64_t row_size = std::max<uint64_t>(EstimateRowSize(table), 1);
+  int64_t rows_per_part = std::clamp<int64_t>(
+      opts_.mbs_per_part * kMB / row_size, 1, kMaxRowsPerFile);
+
+  struct Upload {
+    std::future<katana::CopyableResult<void>> result;
+    std::string path;
+    uint64_t size;
+  };
+  std::deque<Upload> inflight;
+  uint64_t inflight_size = 0;
+
+  auto finish_oldest = [&]() -> katana::Result<void> {
+    Upload upload = std::move(inflight.front());
+    inflight.pop_front();
+    inflight_size -= upload.size;
+    KATANA_CHECKED_CONTEXT(upload.result.get(), "writing {}", upload.path);
+    return katana::ResultSuccess();
+  };
+
+  auto store_parts = [&]() -> katana::Result<std::vector<int64_t>> {
+    std::vector<int64_t> part_offsets;
+    for (int64_t i = 0, num_rows = table->num_rows(); i < num_rows;
+         i += rows_per_part) {
+      part_offsets.emplace_back(i);
+      std::shared_ptr<arrow::Table> part = table->Slice(i, rows_per_part);
+
+      std::string path =
+          fmt::format("{}.part_{:09}", prefix, part_offsets.size() - 1);
+      auto ff = std::make_shared<katana::FileFrame>();
+      KATANA_CHECKED(ff->Init());
+      ff->Bind(path);
+      KATANA_CHECKED(parquet::arrow::WriteTable(
+          *part, arrow::default_memory_pool(), ff, rows_per_part, writer_props,
+          arrow_props));
+      part.reset();
+
+      uint64_t size = ff->map_size();
+      while (!inflight.empty() && inflight_size + size > max_inflight) {
+        KATANA_CHECKED(finish_oldest());
+      }
+
+      TSUBA_PTP(katana::internal::FaultSensitivity::Normal);
+      // the task holds the frame so its buffer is freed once uploaded
+      auto future = std::async(
+          std::launch::async,
+          [ff = std::move(ff)]() -> katana::CopyableResult<void> {
+            KATANA_CHECKED(ff->Persist());
+            return katana::CopyableResultSuccess();
+          });
+      inflight.emplace_back(Upload{std::move(future), std::move(path), size});
+      inflight_size += size;
+    }
+    return part_offsets;
+  };
+
+  auto part_offsets_res = store_parts();
+  table.reset();
+
+  if (!part_offsets_res) {
+    // let the uploads already started finish before reporting
+    while (!inflight.empty()) {
+      if (auto res = finish_oldest(); !res) {
+        KATANA_LOG_ERROR("multiple errors, masking: {}", res.error());
+      }
+    }
+    return part_offsets_res.error();
+  }
+
+  for (Upload& upload : inflight) {
+    if (desc) {
+      desc->AddOp(std::move(upload.result), upload.path, upload.size);
+      continue;
+    }
+    KATANA_CHECKED_CONTEXT(upload.result.get(), "writing {}", upload.path);
+  }
+  return FileStore(
+      uri.string(), KATANA_CHECKED(katana::JsonDump(part_offsets_res.value())));
+}
+
 katana::Result<void>
 katana::ParquetWriter::StoreParquet(
     const katana::URI& uri, katana::WriteGroup* desc) {
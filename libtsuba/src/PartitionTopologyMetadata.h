@@ -35,6 +35,9 @@ public:
   katana::RDGTopology::TransposeKind transpose_state_{-1};
   katana::RDGTopology::EdgeSortKind edge_sort_state_{-1};
   katana::RDGTopology::NodeSortKind node_sort_state_{-1};
+  /// the edge property the edges are sorted by, if edge_sort_state_ is
+  /// kSortedByEdgeProperty
+  std::string edge_sort_property_{""};
 
   // control variables
 
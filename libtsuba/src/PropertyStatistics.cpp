@@ -0,0 +1,351 @@
+#include "katana/PropertyStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
+
+namespace {
+
+constexpr uint64_t kDefaultStatsBlockSize = 1UL << 20;
+
+void
+Widen(katana::PropertyBlockStats* stats, double lo, double hi) {
+  stats->min = stats->min ? std::min(*stats->min, lo) : lo;
+  stats->max = stats->max ? std::max(*stats->max, hi) : hi;
+}
+
+template <typename T>
+void
+Widen(katana::PropertyBlockStats* stats, T value) {
+  double lo = static_cast<double>(value);
+  double hi = lo;
+  if constexpr (std::is_floating_point_v<T>) {
+    if (std::isnan(lo)) {
+      // NaN never satisfies a range predicate
+      return;
+    }
+  } else if constexpr (sizeof(T) > 4) {
+    // doubles cannot hold every 64-bit integer, so round outward
+    lo = std::nextafter(lo, -std::numeric_limits<double>::infinity());
+    hi = std::nextafter(hi, std::numeric_limits<double>::infinity());
+  }
+  Widen(stats, lo, hi);
+}
+
+template <typename ArrayType>
+void
+Accumulate(
+    const arrow::Array& chunk, uint64_t first_row, uint64_t block_size,
+    std::vector<katana::PropertyBlockStats>* blocks) {
+  const auto& typed = static_cast<const ArrayType&>(chunk);
+  for (int64_t i = 0, n = typed.length(); i < n; ++i) {
+    katana::PropertyBlockStats& block =
+        (*blocks)[(first_row + i) / block_size];
+    if (typed.IsNull(i)) {
+      ++block.null_count;
+      continue;
+    }
+    if constexpr (!std::is_same_v<ArrayType, arrow::Array>) {
+      Widen(&block, typed.Value(i));
+    }
+  }
+}
+
+void
+AccumulateChunk(
+    const arrow::Array& chunk, uint64_t first_row, uint64_t block_size,
+    std::vector<katana::PropertyBlockStats>* blocks) {
+  switch (chunk.type_id()) {
+  case arrow::Type::BOOL:
+    return Accumulate<arrow::BooleanArray>(
+        chunk, first_row, block_size, blocks);
+  case arrow::Type::INT8:
+    return Accumulate<arrow::Int8Array>(chunk, first_row, block_size, blocks);
+  case arrow::Type::UINT8:
+    return Accumulate<arrow::UInt8Array>(chunk, first_row, block_size, blocks);
+  case arrow::Type::INT16:
+    return Accumulate<arrow::Int16Array>(chunk, first_row, block_size, blocks);
+  case arrow::Type::UINT16:
+    return Accumulate<arrow::UInt16Array>(chunk, first_row, block_size, blocks);
+  case arrow::Type::INT32:
+    return Accumulate<arrow::Int32Array>(chunk, first_row, block_size, blocks);
+  case arrow::Type::UINT32:
+    return Accumulate<arrow::UInt32Array>(chunk, first_row, block_size, blocks);
+  case arrow::Type::INT64:
+    return Accumulate<arrow::Int64Array>(chunk, first_row, block_size, blocks);
+  case arrow::Type::UINT64:
+    return Accumulate<arrow::UInt64Array>(chunk, first_row, block_size, blocks);
+  case arrow::Type::FLOAT:
+    return Accumulate<arrow::FloatArray>(chunk, first_row, block_size, blocks);
+  case arrow::Type::DOUBLE:
+    return Accumulate<arrow::DoubleArray>(chunk, first_row, block_size, blocks);
+  default:
+    // only null counts for everything else
+    return Accumulate<arrow::Array>(chunk, first_row, block_size, blocks);
+  }
+}
+
+constexpr uint64_t kFNVOffsetBasis = 14695981039346656037UL;
+constexpr uint64_t kFNVPrime = 1099511628211UL;
+
+/// Rows hashed on their own by ComputePropertyContentHash, whose hash
+/// combines the hashes of its blocks so that they can be computed in
+/// parallel
+constexpr int64_t kHashBlockRows = 1 << 16;
+
+void
+HashBytes(const void* data, size_t size, uint64_t* hash) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    *hash = (*hash ^ bytes[i]) * kFNVPrime;
+  }
+}
+
+template <typename T>
+void
+HashValue(const T& value, uint64_t* hash) {
+  HashBytes(&value, sizeof(value), hash);
+}
+
+/// Hash rows [begin, end) of chunk; the null flag goes in first so that a
+/// null and a value of zero differ
+bool
+HashChunk(
+    const arrow::Array& chunk, int64_t begin, int64_t end, uint64_t* hash) {
+  const arrow::DataType& type = *chunk.type();
+  for (int64_t i = begin; i < end; ++i) {
+    bool valid = chunk.IsValid(i);
+    HashValue(valid, hash);
+    if (!valid) {
+      continue;
+    }
+    switch (type.id()) {
+    case arrow::Type::BOOL:
+      HashValue(static_cast<const arrow::BooleanArray&>(chunk).Value(i), hash);
+      break;
+    case arrow::Type::STRING:
+    case arrow::Type::BINARY: {
+      auto view = static_cast<const arrow::BinaryArray&>(chunk).GetView(i);
+      HashValue(view.size(), hash);
+      HashBytes(view.data(), view.size(), hash);
+      break;
+    }
+    case arrow::Type::LARGE_STRING:
+    case arrow::Type::LARGE_BINARY: {
+      auto view = static_cast<const arrow::LargeBinaryArray&>(chunk).GetView(i);
+      HashValue(view.size(), hash);
+      HashBytes(view.data(), view.size(), hash);
+      break;
+    }
+    default: {
+      // dictionary indices mean nothing without the dictionary
+      if (!arrow::is_fixed_width(type.id()) ||
+          type.id() == arrow::Type::NA ||
+          type.id() == arrow::Type::DICTIONARY ||
+          type.id() == arrow::Type::EXTENSION) {
+        return false;
+      }
+      int width = static_cast<const arrow::FixedWidthType&>(type).bit_width();
+      if (width % 8 != 0) {
+        return false;
+      }
+      size_t bytes = width / 8;
+      const uint8_t* values = chunk.data()->buffers[1]->data();
+      HashBytes(values + (chunk.offset() + i) * bytes, bytes, hash);
+    }
+    }
+  }
+  return true;
+}
+
+nlohmann::json
+OptionalToJson(const std::optional<double>& value) {
+  return value ? nlohmann::json(*value) : nlohmann::json(nullptr);
+}
+
+std::optional<double>
+OptionalFromJson(const nlohmann::json& j) {
+  if (j.is_null()) {
+    return std::nullopt;
+  }
+  return j.get<double>();
+}
+
+}  // namespace
+
+bool
+katana::PropertyBlockStats::MayContain(double lo, double hi) const {
+  if (null_count == end - begin) {
+    return false;
+  }
+  if (!min || !max) {
+    // not a numeric property, nothing to go on
+    return true;
+  }
+  return *min <= hi && lo <= *max;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>>
+katana::PropertyStats::CandidateRanges(double lo, double hi) const {
+  std::vector<std::pair<uint64_t, uint64_t>> ranges;
+  for (const PropertyBlockStats& block : blocks) {
+    if (!block.MayContain(lo, hi)) {
+      continue;
+    }
+    if (!ranges.empty() && ranges.back().second == block.begin) {
+      ranges.back().second = block.end;
+    } else {
+      ranges.emplace_back(block.begin, block.end);
+    }
+  }
+  return ranges;
+}
+
+katana::Result<katana::PropertyStats>
+katana::ComputePropertyStats(
+    const std::shared_ptr<arrow::ChunkedArray>& array, uint64_t block_size) {
+  if (block_size == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "statistics block size must be positive");
+  }
+
+  uint64_t num_rows = array->length();
+  PropertyStats stats;
+  stats.block_size = block_size;
+  stats.total.end = num_rows;
+  for (uint64_t begin = 0; begin < num_rows; begin += block_size) {
+    stats.blocks.emplace_back(PropertyBlockStats{
+        .begin = begin,
+        .end = std::min(begin + block_size, num_rows),
+    });
+  }
+
+  uint64_t first_row = 0;
+  for (const auto& chunk : array->chunks()) {
+    AccumulateChunk(*chunk, first_row, block_size, &stats.blocks);
+    first_row += chunk->length();
+  }
+
+  for (const PropertyBlockStats& block : stats.blocks) {
+    stats.total.null_count += block.null_count;
+    if (block.min && block.max) {
+      Widen(&stats.total, *block.min, *block.max);
+    }
+  }
+  return stats;
+}
+
+std::optional<uint64_t>
+katana::ComputePropertyContentHash(
+    const std::shared_ptr<arrow::ChunkedArray>& array) {
+  int64_t num_rows = array->length();
+  int64_t num_blocks = (num_rows + kHashBlockRows - 1) / kHashBlockRows;
+  std::vector<int64_t> chunk_begins;
+  int64_t chunk_begin = 0;
+  for (const auto& chunk : array->chunks()) {
+    chunk_begins.emplace_back(chunk_begin);
+    chunk_begin += chunk->length();
+  }
+
+  // Blocks are rows, not chunks, so the hash does not depend on chunking
+  std::vector<uint64_t> block_hashes(num_blocks);
+  auto hash_blocks = [&](int64_t first, int64_t last) {
+    for (int64_t b = first; b < last; ++b) {
+      uint64_t hash = kFNVOffsetBasis;
+      int64_t row = b * kHashBlockRows;
+      int64_t end = std::min(row + kHashBlockRows, num_rows);
+      auto it = std::upper_bound(chunk_begins.begin(), chunk_begins.end(), row);
+      size_t c = it - chunk_begins.begin() - 1;
+      for (; row < end; ++c) {
+        const arrow::Array& chunk = *array->chunk(c);
+        int64_t stop = std::min(end, chunk_begins[c] + chunk.length());
+        if (!HashChunk(
+                chunk, row - chunk_begins[c], stop - chunk_begins[c],
+                &hash)) {
+          return false;
+        }
+        row = stop;
+      }
+      block_hashes[b] = hash;
+    }
+    return true;
+  };
+
+  int64_t num_tasks = std::min<int64_t>(
+      std::max(std::thread::hardware_concurrency(), 1U), num_blocks);
+  std::vector<std::future<bool>> tasks;
+  for (int64_t t = 1; t < num_tasks; ++t) {
+    tasks.emplace_back(std::async(
+        std::launch::async, hash_blocks, num_blocks * t / num_tasks,
+        num_blocks * (t + 1) / num_tasks));
+  }
+  bool ok = hash_blocks(0, num_blocks / std::max<int64_t>(num_tasks, 1));
+  for (auto& task : tasks) {
+    ok = task.get() && ok;
+  }
+  if (!ok) {
+    return std::nullopt;
+  }
+
+  uint64_t hash = kFNVOffsetBasis;
+  std::string type_name = array->type()->ToString();
+  HashBytes(type_name.data(), type_name.size(), &hash);
+  HashValue(num_rows, &hash);
+  for (uint64_t block_hash : block_hashes) {
+    HashValue(block_hash, &hash);
+  }
+  return hash;
+}
+
+uint64_t
+katana::PropertyStatsBlockSize() {
+  int block_size = 0;
+  if (katana::GetEnv("KATANA_PROPERTY_STATS_BLOCK_ROWS", &block_size) &&
+      block_size > 0) {
+    return block_size;
+  }
+  return kDefaultStatsBlockSize;
+}
+
+void
+katana::to_json(nlohmann::json& j, const PropertyBlockStats& stats) {
+  // an array rather than an object keeps headers of long properties small
+  j = nlohmann::json{
+      stats.begin, stats.end, stats.null_count, OptionalToJson(stats.min),
+      OptionalToJson(stats.max)};
+}
+
+void
+katana::from_json(const nlohmann::json& j, PropertyBlockStats& stats) {
+  j.at(0).get_to(stats.begin);
+  j.at(1).get_to(stats.end);
+  j.at(2).get_to(stats.null_count);
+  stats.min = OptionalFromJson(j.at(3));
+  stats.max = OptionalFromJson(j.at(4));
+}
+
+void
+katana::to_json(nlohmann::json& j, const PropertyStats& stats) {
+  j = nlohmann::json{
+      {"block_size", stats.block_size},
+      {"total", stats.total},
+      {"blocks", stats.blocks},
+  };
+}
+
+void
+katana::from_json(const nlohmann::json& j, PropertyStats& stats) {
+  j.at("block_size").get_to(stats.block_size);
+  j.at("total").get_to(stats.total);
+  j.at("blocks").get_to(stats.blocks);
+}
@@ -1,8 +1,10 @@
 #include "katana/RDG.h"
 
+#include <algorithm>
 #include <cassert>
 #include <exception>
 #include <fstream>
+#include <future>
 #include <iterator>
 #include <memory>
 #include <optional>
@@ -12,7 +14,9 @@
 #include <vector>
 
 #include <arrow/chunked_array.h>
+#include <arrow/compute/api_vector.h>
 #include <arrow/filesystem/api.h>
+#include <arrow/ipc/writer.h>
 #include <arrow/memory_pool.h>
 #include <arrow/type_fwd.h>
 #include <arrow/util/string_view.h>
@@ -28,11 +32,14 @@
 #include "RDGCore.h"
 #include "RDGHandleImpl.h"
 #include "katana/ArrowInterchange.h"
+#include "katana/Env.h"
 #include "katana/ErrorCode.h"
 #include "katana/FaultTest.h"
+#include "katana/FileFrame.h"
 #include "katana/JSON.h"
 #include "katana/Logging.h"
 #include "katana/ParquetWriter.h"
+#include "katana/PropertyStatistics.h"
 #include "katana/RDGTopology.h"
 #include "katana/ReadGroup.h"
 #include "katana/Result.h"
@@ -45,10 +52,68 @@ using json = nlohmann::json;
 
 namespace {
 
+/// Write array as a single column, uncompressed Arrow IPC file so that it can
+/// be mapped and used without decoding when it is loaded
+katana::Result<void>
+StoreArrowIPC(
+    const std::shared_ptr<arrow::ChunkedArray>& array, const std::string& name,
+    const katana::URI& path, katana::WriteGroup* desc) {
+  std::shared_ptr<arrow::Table> table = arrow::Table::Make(
+      arrow::schema({arrow::field(name, array->type())}), {array});
+
+  auto ff = std::make_shared<katana::FileFrame>();
+  KATANA_CHECKED(ff->Init());
+  ff->Bind(path.string());
+
+  // uncompressed, so the file is about as large as the array
+  uint64_t accounted_size = 0;
+  for (const auto& chunk : array->chunks()) {
+    accounted_size += katana::ApproxArrayMemUse(chunk);
+  }
+  if (desc) {
+    desc->WaitForRoom(accounted_size);
+  }
+
+  auto future = std::async(
+      std::launch::async,
+      [table = std::move(table),
+       ff = std::move(ff)]() mutable -> katana::CopyableResult<void> {
+        auto writer =
+            KATANA_CHECKED(arrow::ipc::MakeFileWriter(ff, table->schema()));
+        KATANA_CHECKED(writer->WriteTable(*table));
+        KATANA_CHECKED(writer->Close());
+        table.reset();
+
+        TSUBA_PTP(katana::internal::FaultSensitivity::Normal);
+        KATANA_CHECKED(ff->Persist());
+        ff.reset();
+
+        return katana::CopyableResultSuccess();
+      });
+
+  if (!desc) {
+    KATANA_CHECKED(future.get());
+    return katana::ResultSuccess();
+  }
+
+  desc->AddOp(std::move(future), path.string(), accounted_size);
+  return katana::ResultSuccess();
+}
+
 katana::Result<std::string>
 StoreArrowArrayAtName(
     const std::shared_ptr<arrow::ChunkedArray>& array, const katana::URI& dir,
-    const std::string& name, katana::WriteGroup* desc) {
+    const std::string& name, katana::WriteGroup* desc,
+    katana::PropertyStorageFormat format =
+        katana::PropertyStorageFormat::kParquet) {
+  if (format == katana::PropertyStorageFormat::kArrowIPC) {
+    katana::URI new_path = dir.RandFile(name);
+    KATANA_CHECKED_CONTEXT(
+        StoreArrowIPC(array, name, new_path, desc), "writing to: {}",
+        new_path);
+    return new_path.BaseName();
+  }
+
   std::unique_ptr<katana::ParquetWriter> writer =
       KATANA_CHECKED(katana::ParquetWriter::Make(array, name));
 
@@ -58,6 +123,116 @@ StoreArrowArrayAtName(
   return new_path.BaseName();
 }
 
+/// Write the rows of array listed in rows as a delta file of row ids and
+/// values
+katana::Result<std::string>
+StorePropertyDelta(
+    const std::shared_ptr<arrow::ChunkedArray>& array,
+    std::vector<uint64_t> rows, const katana::URI& dir,
+    const std::string& name, katana::WriteGroup* desc) {
+  std::sort(rows.begin(), rows.end());
+  rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+  arrow::UInt64Builder builder;
+  KATANA_CHECKED(builder.AppendValues(rows));
+  std::shared_ptr<arrow::Array> row_ids = KATANA_CHECKED(builder.Finish());
+  arrow::Datum values = KATANA_CHECKED(arrow::compute::Take(array, row_ids));
+
+  std::shared_ptr<arrow::Table> delta = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field(katana::kPropertyDeltaRowIDName, arrow::uint64()),
+           arrow::field(name, array->type())}),
+      {std::make_shared<arrow::ChunkedArray>(row_ids), values.chunked_array()});
+
+  std::unique_ptr<katana::ParquetWriter> writer =
+      KATANA_CHECKED(katana::ParquetWriter::Make(delta));
+
+  katana::URI new_path = dir.RandFile(name + "_delta");
+  KATANA_CHECKED_CONTEXT(
+      writer->WriteToUri(new_path, desc), "writing to: {}", new_path);
+  return new_path.BaseName();
+}
+
+/// Deltas are folded back into a new base file once there are this many of
+/// them or once the pending delta covers a quarter of the rows, past which a
+/// full write is about as cheap
+bool
+ShouldCompactDeltas(
+    const katana::PropStorageInfo& prop_info, int64_t num_rows) {
+  int max_deltas = 8;
+  katana::GetEnv("KATANA_PROPERTY_MAX_DELTAS", &max_deltas);
+  return prop_info.delta_paths().size() >=
+             static_cast<size_t>(std::max(max_deltas, 0)) ||
+         static_cast<int64_t>(prop_info.pending_delta_rows().size()) * 4 >
+             num_rows;
+}
+
+/// Capture the statistics of a property as it is written, so that readers of
+/// the part header can skip blocks of it without loading it
+katana::Result<void>
+CaptureStats(
+    const std::shared_ptr<arrow::ChunkedArray>& array,
+    katana::PropStorageInfo* prop_info) {
+  prop_info->set_stats(KATANA_CHECKED(
+      katana::ComputePropertyStats(array, katana::PropertyStatsBlockSize())));
+  return katana::ResultSuccess();
+}
+
+/// Write array back to storage if prop_info is dirty, as a delta file if only
+/// some of its rows changed. A dirty property with the same contents as the
+/// files it replaced goes back to those files, copied into dir if they are
+/// elsewhere, so unchanged properties are never serialized again.
+katana::Result<void>
+StoreDirtyProperty(
+    const std::shared_ptr<arrow::ChunkedArray>& array, const std::string& name,
+    katana::PropStorageInfo* prop_info, const katana::URI& dir,
+    katana::WriteGroup* desc) {
+  if (prop_info->IsDeltaDirty()) {
+    if (!ShouldCompactDeltas(*prop_info, array->length())) {
+      std::string path = KATANA_CHECKED(StorePropertyDelta(
+          array, prop_info->pending_delta_rows(), dir, name, desc));
+      KATANA_CHECKED(CaptureStats(array, prop_info));
+      prop_info->WasDeltaWritten(path);
+      // Rehashing every row for a few changed ones would cost as much as a
+      // full write; without a hash these files are just never reused
+      prop_info->set_content_hash(std::nullopt);
+      return katana::ResultSuccess();
+    }
+    prop_info->WasModified(prop_info->type());
+  }
+  if (!prop_info->IsDirty()) {
+    return katana::ResultSuccess();
+  }
+
+  std::optional<uint64_t> content_hash =
+      katana::ComputePropertyContentHash(array);
+  // Files of another type, length or format cannot hold these contents
+  // whatever their hash
+  const auto& replaced = prop_info->replaced();
+  bool same_shape =
+      replaced && replaced->storage_format == prop_info->storage_format() &&
+      replaced->type && replaced->type->Equals(*array->type()) &&
+      replaced->num_rows &&
+      *replaced->num_rows == static_cast<uint64_t>(array->length());
+  if (same_shape && content_hash && replaced->content_hash == *content_hash) {
+    if (replaced->dir) {
+      KATANA_CHECKED(katana::CopyPropertyFiles(
+          replaced->path, replaced->delta_paths, replaced->storage_format,
+          *replaced->dir, dir));
+    }
+    prop_info->WasRestored();
+    KATANA_CHECKED(CaptureStats(array, prop_info));
+    return katana::ResultSuccess();
+  }
+
+  std::string path = KATANA_CHECKED(StoreArrowArrayAtName(
+      array, dir, name, desc, prop_info->storage_format()));
+  KATANA_CHECKED(CaptureStats(array, prop_info));
+  prop_info->WasWritten(path);
+  prop_info->set_content_hash(content_hash);
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 WriteProperties(
     const arrow::Table& props, std::vector<katana::PropStorageInfo*> prop_info,
@@ -66,15 +241,13 @@ WriteProperties(
 
   std::vector<std::string> next_paths;
   for (size_t i = 0, n = prop_info.size(); i < n; ++i) {
-    if (!prop_info[i]->IsDirty()) {
+    if (!prop_info[i]->IsDirty() && !prop_info[i]->IsDeltaDirty()) {
       continue;
     }
     std::string name = prop_info[i]->name().empty() ? schema->field(i)->name()
                                                     : prop_info[i]->name();
-    std::string path =
-        KATANA_CHECKED(StoreArrowArrayAtName(props.column(i), dir, name, desc));
-
-    prop_info[i]->WasWritten(path);
+    KATANA_CHECKED(
+        StoreDirtyProperty(props.column(i), name, prop_info[i], dir, desc));
   }
   TSUBA_PTP(katana::internal::FaultSensitivity::Normal);
 
@@ -114,6 +287,16 @@ SetTnxContextManifest(
   return katana::ResultSuccess();
 }
 
+/// The Parquet read options of the properties loaded with opts
+katana::ParquetReader::ReadOpts
+PropertyReadOpts(const katana::RDGLoadOptions& opts) {
+  auto read_opts = katana::ParquetReader::ReadOpts::Defaults();
+  read_opts.combine_fixed_width_chunks =
+      opts.combine_fixed_width_property_chunks;
+  read_opts.read_strings_as_dictionary = opts.read_strings_as_dictionary;
+  return read_opts;
+}
+
 }  // namespace
 
 void
@@ -364,14 +547,23 @@ katana::Result<void>
 katana::RDG::DoMake(
     const std::vector<PropStorageInfo*>& node_props_to_be_loaded,
     const std::vector<PropStorageInfo*>& edge_props_to_be_loaded,
-    const katana::URI& metadata_dir) {
+    const katana::URI& metadata_dir, const RDGLoadOptions& opts) {
   ReadGroup grp;
 
+  if (opts.progress) {
+    opts.progress->properties_total +=
+        node_props_to_be_loaded.size() + edge_props_to_be_loaded.size();
+    KATANA_CHECKED(opts.progress->CheckCancelled());
+  }
+
   // populating node properties
   KATANA_CHECKED(AddProperties(
       metadata_dir, true /*is_property*/, node_props_to_be_loaded, &grp,
-      [rdg = this](
-          const std::shared_ptr<arrow::Table>& props) -> katana::Result<void> {
+      [rdg = this, &opts](
+          const std::shared_ptr<arrow::Table>& loaded)
+          -> katana::Result<void> {
+        std::shared_ptr<arrow::Table> props = KATANA_CHECKED(PlaceInMemory(
+            loaded, opts.property_placement, opts.min_placed_property_bytes));
         std::shared_ptr<arrow::Table> prop_table =
             rdg->core_->node_properties();
 
@@ -384,14 +576,22 @@ katana::RDG::DoMake(
           prop_table = props;
         }
         rdg->core_->set_node_properties(std::move(prop_table));
+        if (opts.progress) {
+          return opts.progress->PropertyLoaded(
+              katana::ApproxTableMemUse(loaded));
+        }
         return katana::ResultSuccess();
-      }));
+      },
+      PropertyReadOpts(opts), opts.share_loaded_properties));
 
   // populating edge properties
   KATANA_CHECKED(AddProperties(
       metadata_dir, true /*is_property*/, edge_props_to_be_loaded, &grp,
-      [rdg = this](
-          const std::shared_ptr<arrow::Table>& props) -> katana::Result<void> {
+      [rdg = this, &opts](
+          const std::shared_ptr<arrow::Table>& loaded)
+          -> katana::Result<void> {
+        std::shared_ptr<arrow::Table> props = KATANA_CHECKED(PlaceInMemory(
+            loaded, opts.property_placement, opts.min_placed_property_bytes));
         std::shared_ptr<arrow::Table> prop_table =
             rdg->core_->edge_properties();
 
@@ -404,10 +604,18 @@ katana::RDG::DoMake(
           prop_table = props;
         }
         rdg->core_->set_edge_properties(std::move(prop_table));
+        if (opts.progress) {
+          return opts.progress->PropertyLoaded(
+              katana::ApproxTableMemUse(loaded));
+        }
         return katana::ResultSuccess();
-      }));
+      },
+      PropertyReadOpts(opts), opts.share_loaded_properties));
 
   // populating topologies
+  if (opts.progress) {
+    KATANA_CHECKED(opts.progress->CheckCancelled());
+  }
   KATANA_CHECKED(core_->MakeTopologyManager(metadata_dir));
 
   // ensure we can find the default csr topology
@@ -508,16 +716,24 @@ katana::RDG::Make(const RDGManifest& manifest, const RDGLoadOptions& opts) {
   // needs a valid rdg_dir
   rdg.set_rdg_dir(manifest.dir());
   KATANA_LOG_ASSERT(!manifest.dir().empty());
+  rdg.core_->set_share_loaded_properties(opts.share_loaded_properties);
 
-  std::vector<PropStorageInfo*> node_props = KATANA_CHECKED(
-      rdg.core_->part_header().SelectNodeProperties(opts.node_properties));
+  // Lazily loaded properties stay absent; they are registered by the part
+  // header and loaded by name on first access
+  std::optional<std::vector<std::string>> none_to_load =
+      std::vector<std::string>{};
+  std::vector<PropStorageInfo*> node_props =
+      KATANA_CHECKED(rdg.core_->part_header().SelectNodeProperties(
+          opts.lazy_load_properties ? none_to_load : opts.node_properties));
 
-  std::vector<PropStorageInfo*> edge_props = KATANA_CHECKED(
-      rdg.core_->part_header().SelectEdgeProperties(opts.edge_properties));
+  std::vector<PropStorageInfo*> edge_props =
+      KATANA_CHECKED(rdg.core_->part_header().SelectEdgeProperties(
+          opts.lazy_load_properties ? none_to_load : opts.edge_properties));
 
-  KATANA_CHECKED(rdg.DoMake(node_props, edge_props, manifest.dir()));
+  KATANA_CHECKED(rdg.DoMake(node_props, edge_props, manifest.dir(), opts));
 
   rdg.core_->set_partition_id(partition_id_to_load);
+  rdg.core_->set_topology_placement(opts.topology_placement);
 
   return RDG(std::move(rdg));
 }
@@ -637,6 +853,32 @@ katana::RDG::UpsertEdgeProperties(
   return core_->UpsertEdgeProperties(props, txn_ctx);
 }
 
+katana::Result<void>
+katana::RDG::UpdateNodePropertyRows(
+    const std::string& name, const std::vector<uint64_t>& row_ids,
+    const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx) {
+  return core_->UpdateNodePropertyRows(name, row_ids, values, txn_ctx);
+}
+
+katana::Result<void>
+katana::RDG::UpdateEdgePropertyRows(
+    const std::string& name, const std::vector<uint64_t>& row_ids,
+    const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx) {
+  return core_->UpdateEdgePropertyRows(name, row_ids, values, txn_ctx);
+}
+
+katana::Result<void>
+katana::RDG::AppendEdgePropertyRows(
+    const std::shared_ptr<arrow::Table>& rows, katana::TxnContext* txn_ctx) {
+  return core_->AppendEdgePropertyRows(rows, txn_ctx);
+}
+
+katana::Result<void>
+katana::RDG::TakeEdgePropertyRows(
+    const std::shared_ptr<arrow::Array>& row_ids, katana::TxnContext* txn_ctx) {
+  return core_->TakeEdgePropertyRows(row_ids, txn_ctx);
+}
+
 katana::Result<void>
 katana::RDG::RemoveNodeProperty(int i, katana::TxnContext* txn_ctx) {
   return core_->RemoveNodeProperty(i, txn_ctx);
@@ -680,11 +922,8 @@ UnloadProperty(
 
   KATANA_LOG_ASSERT(!prop_info.IsAbsent());
 
-  if (prop_info.IsDirty()) {
-    std::string path = KATANA_CHECKED(
-        StoreArrowArrayAtName(props->column(i), dir, name, nullptr));
-    prop_info.WasWritten(path);
-  }
+  KATANA_CHECKED(
+      StoreDirtyProperty(props->column(i), name, &prop_info, dir, nullptr));
 
   prop_info.WasUnloaded();
 
@@ -713,11 +952,79 @@ GetStorageLocationIfValid(
   return path;
 }
 
+katana::Result<katana::PropertyStats>
+GetStatsIfAvailable(
+    const std::string& name, const std::shared_ptr<arrow::Table>& props,
+    const std::vector<katana::PropStorageInfo>& prop_info_list) {
+  auto psi_it = std::find_if(
+      prop_info_list.begin(), prop_info_list.end(),
+      [&](const katana::PropStorageInfo& psi) { return psi.name() == name; });
+  if (psi_it == prop_info_list.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no property named {}",
+        std::quoted(name));
+  }
+
+  if (psi_it->stats()) {
+    return *psi_it->stats();
+  }
+  if (psi_it->IsAbsent()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound,
+        "no statistics were stored for property {}; load the property to "
+        "compute them",
+        std::quoted(name));
+  }
+
+  std::shared_ptr<arrow::ChunkedArray> column = props->GetColumnByName(name);
+  KATANA_LOG_ASSERT(column);
+  return KATANA_CHECKED(
+      katana::ComputePropertyStats(column, katana::PropertyStatsBlockSize()));
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+ReadPropertyRows(
+    const std::string& name, uint64_t begin, uint64_t end,
+    const std::shared_ptr<arrow::Table>& props,
+    const std::vector<katana::PropStorageInfo>& prop_info_list,
+    const katana::URI& dir) {
+  if (end < begin) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "row range [{}, {}) is reversed",
+        begin, end);
+  }
+
+  // a loaded property may have changed since it was stored
+  if (std::shared_ptr<arrow::ChunkedArray> column =
+          props->GetColumnByName(name)) {
+    if (end > static_cast<uint64_t>(column->length())) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "row range [{}, {}) is past the {} rows of {}", begin, end,
+          column->length(), std::quoted(name));
+    }
+    return column->Slice(begin, end - begin);
+  }
+
+  auto psi_it = std::find_if(
+      prop_info_list.begin(), prop_info_list.end(),
+      [&](const katana::PropStorageInfo& psi) { return psi.name() == name; });
+  if (psi_it == prop_info_list.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no property named {}",
+        std::quoted(name));
+  }
+
+  std::shared_ptr<arrow::Table> table =
+      KATANA_CHECKED(katana::ReadPropertySlice(dir, *psi_it, {begin, end}));
+  return table->column(0);
+}
+
 katana::Result<std::shared_ptr<arrow::Table>>
 LoadProperty(
     const std::shared_ptr<arrow::Table>& props, const std::string name, int i,
     std::vector<katana::PropStorageInfo>* prop_info_list,
-    const katana::URI& dir) {
+    const katana::URI& dir, bool share_loaded) {
   auto psi_it = std::find_if(
       prop_info_list->begin(), prop_info_list->end(),
       [&](const katana::PropStorageInfo& psi) { return psi.name() == name; });
@@ -753,15 +1060,64 @@ LoadProperty(
           new_table = col;
         }
         return katana::ResultSuccess();
-      }));
+      },
+      katana::ParquetReader::ReadOpts::Defaults(), share_loaded));
 
   KATANA_LOG_ASSERT(prop_info.IsClean());
 
   return new_table;
 }
 
+katana::Result<void>
+SetPropertyStorageFormat(
+    const std::string& name, katana::PropertyStorageFormat format,
+    std::vector<katana::PropStorageInfo>* prop_info_list) {
+  auto psi_it = std::find_if(
+      prop_info_list->begin(), prop_info_list->end(),
+      [&](const katana::PropStorageInfo& psi) { return psi.name() == name; });
+
+  if (psi_it == prop_info_list->end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no property named {}",
+        std::quoted(name));
+  }
+
+  katana::PropStorageInfo& prop_info = *psi_it;
+
+  if (prop_info.storage_format() == format) {
+    return katana::ResultSuccess();
+  }
+  if (prop_info.IsAbsent()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "property {} must be loaded to change its storage format",
+        std::quoted(name));
+  }
+
+  // The file on storage is in the old format, so force a rewrite
+  if (!prop_info.IsDirty()) {
+    prop_info.WasModified(prop_info.type());
+  }
+  prop_info.set_storage_format(format);
+  return katana::ResultSuccess();
+}
+
 }  // namespace
 
+katana::Result<void>
+katana::RDG::SetNodePropertyStorageFormat(
+    const std::string& name, PropertyStorageFormat format) {
+  return SetPropertyStorageFormat(
+      name, format, &core_->part_header().node_prop_info_list());
+}
+
+katana::Result<void>
+katana::RDG::SetEdgePropertyStorageFormat(
+    const std::string& name, PropertyStorageFormat format) {
+  return SetPropertyStorageFormat(
+      name, format, &core_->part_header().edge_prop_info_list());
+}
+
 katana::Result<void>
 katana::RDG::UnloadNodeProperty(int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(UnloadProperty(
@@ -789,6 +1145,20 @@ katana::RDG::GetNodePropertyStorageLocation(const std::string& name) const {
       name, core_->part_header().node_prop_info_list());
 }
 
+katana::Result<katana::PropertyStats>
+katana::RDG::GetNodePropertyStats(const std::string& name) const {
+  return GetStatsIfAvailable(
+      name, node_properties(), core_->part_header().node_prop_info_list());
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::RDG::ReadNodePropertyRows(
+    const std::string& name, uint64_t begin, uint64_t end) const {
+  return ReadPropertyRows(
+      name, begin, end, node_properties(),
+      core_->part_header().node_prop_info_list(), rdg_dir());
+}
+
 katana::Result<void>
 katana::RDG::UnloadEdgeProperty(int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(UnloadProperty(
@@ -804,6 +1174,20 @@ katana::RDG::GetEdgePropertyStorageLocation(const std::string& name) const {
       name, core_->part_header().edge_prop_info_list());
 }
 
+katana::Result<katana::PropertyStats>
+katana::RDG::GetEdgePropertyStats(const std::string& name) const {
+  return GetStatsIfAvailable(
+      name, edge_properties(), core_->part_header().edge_prop_info_list());
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::RDG::ReadEdgePropertyRows(
+    const std::string& name, uint64_t begin, uint64_t end) const {
+  return ReadPropertyRows(
+      name, begin, end, edge_properties(),
+      core_->part_header().edge_prop_info_list(), rdg_dir());
+}
+
 katana::Result<void>
 katana::RDG::UnloadEdgeProperty(const std::string& name) {
   auto col_names = edge_properties()->ColumnNames();
@@ -820,7 +1204,7 @@ katana::Result<void>
 katana::RDG::LoadNodeProperty(const std::string& name, int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(LoadProperty(
       node_properties(), name, i, &core_->part_header().node_prop_info_list(),
-      rdg_dir()));
+      rdg_dir(), core_->share_loaded_properties()));
   core_->set_node_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
@@ -829,7 +1213,7 @@ katana::Result<void>
 katana::RDG::LoadEdgeProperty(const std::string& name, int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(LoadProperty(
       edge_properties(), name, i, &core_->part_header().edge_prop_info_list(),
-      rdg_dir()));
+      rdg_dir(), core_->share_loaded_properties()));
   core_->set_edge_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
@@ -898,6 +1282,11 @@ katana::RDG::partition_id() const {
   return core_->partition_id();
 }
 
+katana::MemoryPlacement
+katana::RDG::topology_placement() const {
+  return core_->topology_placement();
+}
+
 const std::shared_ptr<arrow::Table>&
 katana::RDG::node_properties() const {
   return core_->node_properties();
@@ -923,6 +1312,17 @@ katana::RDG::DropAllTopologies() {
   return core_->UnbindAllTopologyFile();
 }
 
+void
+katana::RDG::InvalidateDerivedTopologies() {
+  core_->topology_manager().InvalidateDerivedTopologies();
+}
+
+void
+katana::RDG::InvalidateTopologiesSortedByEdgeProperty(
+    const std::string& name) {
+  core_->topology_manager().InvalidateTopologiesSortedBy(name);
+}
+
 std::shared_ptr<arrow::Schema>
 katana::RDG::full_node_schema() const {
   return core_->full_node_schema();
@@ -1008,11 +1408,22 @@ katana::Result<katana::RDGTopology*>
 katana::RDG::GetTopology(const katana::RDGTopology& shadow) {
   RDGTopology* topology =
       KATANA_CHECKED(core_->topology_manager().GetTopology(shadow));
+  if (topology->partially_filled()) {
+    KATANA_CHECKED(topology->unbind_file_storage());
+  }
   KATANA_CHECKED(topology->Bind(rdg_dir()));
   KATANA_CHECKED(topology->Map());
   return topology;
 }
 
+katana::Result<katana::RDGTopology*>
+katana::RDG::GetTopologySections(const katana::RDGTopology& shadow) {
+  RDGTopology* topology =
+      KATANA_CHECKED(core_->topology_manager().GetTopology(shadow));
+  KATANA_CHECKED(topology->BindSections(rdg_dir()));
+  return topology;
+}
+
 const katana::FileView&
 katana::RDG::node_entity_type_id_array_file_storage() const {
   return core_->node_entity_type_id_array_file_storage();
@@ -1129,6 +1540,64 @@ katana::RDG::WriteRDKSubstructureIndexPrimitive(
   return katana::ResultSuccess();
 }
 
+katana::Result<std::optional<katana::EntityIndexPrimitive>>
+katana::RDG::LoadEntityIndexPrimitive() {
+  // Most graphs have no indexes; do not warn about them on every load.
+  if (core_->part_header().optional_datastructure_manifests().count(
+          kOptionalDatastructureEntityIndexPrimitive) == 0) {
+    return std::nullopt;
+  }
+  std::optional<std::string> res =
+      KATANA_CHECKED(core_->part_header().OptionalDatastructureManifest(
+          kOptionalDatastructureEntityIndexPrimitive));
+  if (!res) {
+    return std::nullopt;
+  }
+
+  katana::EntityIndexPrimitive index = KATANA_CHECKED_CONTEXT(
+      katana::EntityIndexPrimitive::Load(rdg_dir(), res.value()),
+      "Failed to load EntityIndexPrimitive located at {}", res.value());
+  return index;
+}
+
+katana::Result<void>
+katana::RDG::WriteEntityIndexPrimitive(katana::EntityIndexPrimitive& index) {
+  std::string path = KATANA_CHECKED(index.Write(rdg_dir()));
+  core_->part_header().AppendOptionalDatastructureManifest(
+      kOptionalDatastructureEntityIndexPrimitive, path);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::optional<katana::VectorIndexPrimitive>>
+katana::RDG::LoadVectorIndexPrimitive() {
+  // Most graphs have no vector indexes; do not warn about them on every load.
+  if (core_->part_header().optional_datastructure_manifests().count(
+          kOptionalDatastructureVectorIndexPrimitive) == 0) {
+    return std::nullopt;
+  }
+  std::optional<std::string> res =
+      KATANA_CHECKED(core_->part_header().OptionalDatastructureManifest(
+          kOptionalDatastructureVectorIndexPrimitive));
+  if (!res) {
+    return std::nullopt;
+  }
+
+  katana::VectorIndexPrimitive index = KATANA_CHECKED_CONTEXT(
+      katana::VectorIndexPrimitive::Load(rdg_dir(), res.value()),
+      "Failed to load VectorIndexPrimitive located at {}", res.value());
+  return index;
+}
+
+katana::Result<void>
+katana::RDG::WriteVectorIndexPrimitive(katana::VectorIndexPrimitive& index) {
+  std::string path = KATANA_CHECKED(index.Write(rdg_dir()));
+  core_->part_header().AppendOptionalDatastructureManifest(
+      kOptionalDatastructureVectorIndexPrimitive, path);
+
+  return katana::ResultSuccess();
+}
+
 katana::RDG::RDG(std::unique_ptr<RDGCore>&& core) : core_(std::move(core)) {}
 
 katana::RDG::RDG() : core_(std::make_unique<RDGCore>()) {}
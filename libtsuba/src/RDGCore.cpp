@@ -1,5 +1,8 @@
 #include "RDGCore.h"
 
+#include <arrow/compute/api.h>
+
+#include "AddProperties.h"
 #include "RDGPartHeader.h"
 #include "RDGTopologyManager.h"
 #include "katana/ArrowInterchange.h"
@@ -86,6 +89,148 @@ UpsertProperties(
   return written_prop_names;
 }
 
+katana::Result<void>
+UpdatePropertyRows(
+    const std::string& name, const std::vector<uint64_t>& row_ids,
+    const std::shared_ptr<arrow::Array>& values,
+    std::shared_ptr<arrow::Table>* to_update,
+    std::vector<katana::PropStorageInfo>* prop_state) {
+  auto prop_info_it = std::find_if(
+      prop_state->begin(), prop_state->end(),
+      [&](const katana::PropStorageInfo& psi) { return psi.name() == name; });
+  if (prop_info_it == prop_state->end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no property named {}",
+        std::quoted(name));
+  }
+  if (prop_info_it->IsAbsent()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "property {} must be loaded to update its rows", std::quoted(name));
+  }
+
+  std::shared_ptr<arrow::Table> next = *to_update;
+  int current_col = next->schema()->GetFieldIndex(name);
+  KATANA_LOG_ASSERT(current_col >= 0);
+
+  uint64_t num_rows = next->num_rows();
+  for (uint64_t row : row_ids) {
+    if (row >= num_rows) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "row {} is out of range for {} rows", row, num_rows);
+    }
+  }
+
+  arrow::UInt64Builder builder;
+  KATANA_CHECKED(builder.AppendValues(row_ids));
+  std::shared_ptr<arrow::Array> row_id_array = KATANA_CHECKED(builder.Finish());
+
+  std::shared_ptr<arrow::ChunkedArray> column =
+      KATANA_CHECKED(katana::ApplyPropertyDelta(
+          next->column(current_col),
+          std::make_shared<arrow::ChunkedArray>(row_id_array),
+          std::make_shared<arrow::ChunkedArray>(values)));
+  *to_update = KATANA_CHECKED(
+      next->SetColumn(current_col, next->field(current_col), column));
+
+  prop_info_it->WasDeltaModified(row_ids);
+  return katana::ResultSuccess();
+}
+
+/// Rows can only be added to or dropped from every property at once, and
+/// properties that are not loaded cannot be changed
+katana::Result<void>
+CheckAllPropertiesLoaded(
+    const std::vector<katana::PropStorageInfo>& prop_state) {
+  for (const katana::PropStorageInfo& psi : prop_state) {
+    if (psi.IsAbsent()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "property {} must be loaded to change the number of rows",
+          std::quoted(psi.name()));
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::set<std::string>>
+AppendPropertyRows(
+    const std::shared_ptr<arrow::Table>& rows,
+    std::shared_ptr<arrow::Table>* to_update,
+    std::vector<katana::PropStorageInfo>* prop_state) {
+  KATANA_CHECKED(CheckAllPropertiesLoaded(*prop_state));
+  std::shared_ptr<arrow::Table> table = *to_update;
+  for (const auto& field : rows->fields()) {
+    if (table->schema()->GetFieldIndex(field->name()) < 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound,
+          "appended rows have a value for {}, which is not a property",
+          std::quoted(field->name()));
+    }
+  }
+
+  std::set<std::string> written_prop_names;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i = 0, n = table->num_columns(); i < n; i++) {
+    const std::shared_ptr<arrow::Field>& field = table->field(i);
+    arrow::ArrayVector chunks = table->column(i)->chunks();
+    std::shared_ptr<arrow::ChunkedArray> appended =
+        rows->GetColumnByName(field->name());
+    if (appended) {
+      if (!appended->type()->Equals(field->type())) {
+        return KATANA_ERROR(
+            katana::ErrorCode::TypeError,
+            "appended rows of {} are {}, the property is {}",
+            std::quoted(field->name()), appended->type()->ToString(),
+            field->type()->ToString());
+      }
+      chunks.insert(
+          chunks.end(), appended->chunks().begin(), appended->chunks().end());
+    } else if (rows->num_rows() > 0) {
+      // rows without a value for a property are null
+      chunks.emplace_back(KATANA_CHECKED(
+          arrow::MakeArrayOfNull(field->type(), rows->num_rows())));
+    }
+    columns.emplace_back(
+        KATANA_CHECKED(arrow::ChunkedArray::Make(chunks, field->type())));
+
+    auto prop_info_it = std::find_if(
+        prop_state->begin(), prop_state->end(),
+        [&](const katana::PropStorageInfo& psi) {
+          return psi.name() == field->name();
+        });
+    KATANA_LOG_ASSERT(prop_info_it != prop_state->end());
+    prop_info_it->WasModified(field->type());
+    written_prop_names.insert(field->name());
+  }
+  *to_update = arrow::Table::Make(
+      table->schema(), columns, table->num_rows() + rows->num_rows());
+  return written_prop_names;
+}
+
+katana::Result<std::set<std::string>>
+TakePropertyRows(
+    const std::shared_ptr<arrow::Array>& row_ids,
+    std::shared_ptr<arrow::Table>* to_update,
+    std::vector<katana::PropStorageInfo>* prop_state) {
+  KATANA_CHECKED(CheckAllPropertiesLoaded(*prop_state));
+  std::shared_ptr<arrow::Table> table = *to_update;
+  if (table->num_columns() == 0) {
+    return std::set<std::string>{};
+  }
+
+  arrow::Datum taken = KATANA_CHECKED(arrow::compute::Take(table, row_ids));
+  *to_update = taken.table();
+
+  std::set<std::string> written_prop_names;
+  for (katana::PropStorageInfo& psi : *prop_state) {
+    psi.WasModified(psi.type());
+    written_prop_names.insert(psi.name());
+  }
+  return written_prop_names;
+}
+
 katana::Result<std::set<std::string>>
 AddProperties(
     const std::shared_ptr<arrow::Table>& props,
@@ -264,6 +409,56 @@ katana::RDGCore::UpsertEdgeProperties(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::RDGCore::UpdateNodePropertyRows(
+    const std::string& name, const std::vector<uint64_t>& row_ids,
+    const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx) {
+  KATANA_LOG_DEBUG_ASSERT(txn_ctx != nullptr);
+  KATANA_CHECKED(UpdatePropertyRows(
+      name, row_ids, values, &node_properties_,
+      &part_header_.node_prop_info_list()));
+  txn_ctx->InsertNodePropertyWrite(rdg_dir_, name);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::RDGCore::UpdateEdgePropertyRows(
+    const std::string& name, const std::vector<uint64_t>& row_ids,
+    const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx) {
+  KATANA_LOG_DEBUG_ASSERT(txn_ctx != nullptr);
+  KATANA_CHECKED(UpdatePropertyRows(
+      name, row_ids, values, &edge_properties_,
+      &part_header_.edge_prop_info_list()));
+  txn_ctx->InsertEdgePropertyWrite(rdg_dir_, name);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::RDGCore::AppendEdgePropertyRows(
+    const std::shared_ptr<arrow::Table>& rows, katana::TxnContext* txn_ctx) {
+  KATANA_LOG_DEBUG_ASSERT(txn_ctx != nullptr);
+  auto written_prop_names = KATANA_CHECKED(AppendPropertyRows(
+      rows, &edge_properties_, &part_header_.edge_prop_info_list()));
+  txn_ctx->InsertEdgePropertyWrite<std::set<std::string>>(
+      rdg_dir_, written_prop_names);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::RDGCore::TakeEdgePropertyRows(
+    const std::shared_ptr<arrow::Array>& row_ids, katana::TxnContext* txn_ctx) {
+  KATANA_LOG_DEBUG_ASSERT(txn_ctx != nullptr);
+  auto written_prop_names = KATANA_CHECKED(TakePropertyRows(
+      row_ids, &edge_properties_, &part_header_.edge_prop_info_list()));
+  txn_ctx->InsertEdgePropertyWrite<std::set<std::string>>(
+      rdg_dir_, written_prop_names);
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::RDGCore::EnsureNodeTypesLoaded() {
   if (rdg_dir_.empty()) {
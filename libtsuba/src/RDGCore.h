@@ -10,6 +10,7 @@
 #include "RDGTopologyManager.h"
 #include "katana/FileView.h"
 #include "katana/Logging.h"
+#include "katana/MemoryPlacement.h"
 #include "katana/NUMAArray.h"
 #include "katana/RDGTopology.h"
 #include "katana/Result.h"
@@ -40,6 +41,21 @@ public:
   katana::Result<void> UpsertEdgeProperties(
       const std::shared_ptr<arrow::Table>& props, katana::TxnContext* txn_ctx);
 
+  katana::Result<void> UpdateNodePropertyRows(
+      const std::string& name, const std::vector<uint64_t>& row_ids,
+      const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx);
+
+  katana::Result<void> UpdateEdgePropertyRows(
+      const std::string& name, const std::vector<uint64_t>& row_ids,
+      const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx);
+
+  katana::Result<void> AppendEdgePropertyRows(
+      const std::shared_ptr<arrow::Table>& rows, katana::TxnContext* txn_ctx);
+
+  katana::Result<void> TakeEdgePropertyRows(
+      const std::shared_ptr<arrow::Array>& row_ids,
+      katana::TxnContext* txn_ctx);
+
   katana::Result<void> RemoveNodeProperty(int i, katana::TxnContext* txn_ctx);
 
   katana::Result<void> RemoveEdgeProperty(int i, katana::TxnContext* txn_ctx);
@@ -85,6 +101,16 @@ public:
   uint32_t partition_id() const { return partition_id_; }
   void set_partition_id(uint32_t partition_id) { partition_id_ = partition_id; }
 
+  MemoryPlacement topology_placement() const { return topology_placement_; }
+  void set_topology_placement(MemoryPlacement placement) {
+    topology_placement_ = placement;
+  }
+
+  bool share_loaded_properties() const { return share_loaded_properties_; }
+  void set_share_loaded_properties(bool share) {
+    share_loaded_properties_ = share;
+  }
+
   std::shared_ptr<arrow::Schema> full_node_schema() const;
 
   const std::shared_ptr<arrow::Table>& node_properties() const {
@@ -312,6 +338,10 @@ private:
   katana::URI rdg_dir_;
   /// which partition of the graph was loaded
   uint32_t partition_id_{std::numeric_limits<uint32_t>::max()};
+  /// where a PropertyGraph made from this RDG places its topology
+  MemoryPlacement topology_placement_{MemoryPlacement::kDefault};
+  /// whether properties loaded by name later are shared with other RDGs
+  bool share_loaded_properties_{false};
   // How this graph was derived from the previous version
   RDGLineage lineage_;
 };
@@ -7,16 +7,28 @@
 #include "RDGHandleImpl.h"
 #include "RDGPartHeader.h"
 #include "katana/ErrorCode.h"
+#include "katana/Experimental.h"
 #include "katana/FileView.h"
 #include "katana/JSON.h"
 #include "katana/Logging.h"
-#include "katana/ParquetReader.h"
 #include "katana/RDGOptionalDatastructure.h"
 #include "katana/Result.h"
 #include "katana/tsuba.h"
 
 using json = nlohmann::json;
 
+/// When "BinaryRDGMetadata" is found in the envar "KATANA_ENABLE_EXPERIMENTAL",
+/// manifests and part headers are stored in the binary encoding of
+/// katana::JsonDumpBinary rather than as JSON text, which makes opening graphs
+/// with many properties or partitions much faster. Either encoding is always
+/// read, so RDGs stored with the flag set can be loaded without it, but
+/// tooling that reads the metadata as JSON, e.g. scripts/migrate_rdgs.py, does
+/// not understand the binary encoding.
+///
+/// This feature flag can be set in the environment:
+/// KATANA_ENABLE_EXPERIMENTAL="BinaryRDGMetadata"
+KATANA_EXPERIMENTAL_FEATURE(BinaryRDGMetadata);
+
 namespace {
 
 katana::Result<uint64_t>
@@ -55,7 +67,7 @@ katana::RDGManifest::MakeFromStorage(const katana::URI& uri) {
   KATANA_CHECKED(fv.Bind(uri.string(), true));
 
   katana::RDGManifest manifest(uri.DirName());
-  auto manifest_res = katana::JsonParse<katana::RDGManifest>(fv, &manifest);
+  auto manifest_res = katana::JsonParseAny<katana::RDGManifest>(fv, &manifest);
 
   if (!manifest_res) {
     return manifest_res.error().WithContext("cannot parse {}", uri.string());
@@ -131,6 +143,14 @@ katana::RDGManifest::ToJsonString() const {
   return s;
 }
 
+katana::Result<std::string>
+katana::RDGManifest::Serialize() const {
+  if (KATANA_EXPERIMENTAL_ENABLED(BinaryRDGMetadata)) {
+    return katana::JsonDumpBinary(*this);
+  }
+  return ToJsonString();
+}
+
 // e.g., rdg_dir == s3://witchel-tests-east2/fault/simple/
 katana::URI
 katana::RDGManifest::FileName(
@@ -205,16 +225,14 @@ katana::RDGManifest::ParseViewArgsFromName(const std::string& file) {
 }
 
 namespace {
+/// Add the files of prop, see PropertyFileNames, to fnames
 katana::Result<void>
-AddPropertySubFiles(std::set<std::string>& fnames, std::string full_path) {
-  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
-  auto uri_path = KATANA_CHECKED(katana::URI::Make(full_path));
-  auto sub_files = KATANA_CHECKED(reader->GetFiles(uri_path));
-  for (const auto& sub_file : sub_files) {
-    auto sub_file_uri = KATANA_CHECKED(katana::URI::Make(sub_file));
-    fnames.emplace(
-        sub_file_uri.BaseName());  // Only want the file name without dir
-  }
+AddPropertyFiles(
+    std::set<std::string>& fnames, const katana::URI& dir,
+    const katana::PropStorageInfo& prop) {
+  std::vector<std::string> names = KATANA_CHECKED(katana::PropertyFileNames(
+      dir, prop.path(), prop.delta_paths(), prop.storage_format()));
+  fnames.insert(names.begin(), names.end());
   return katana::ResultSuccess();
 }
 
@@ -260,19 +278,13 @@ katana::RDGManifest::FileNames() {
       auto header = std::move(header_res.value());
 
       for (const auto& node_prop : header.node_prop_info_list()) {
-        fnames.emplace(node_prop.path());
-        KATANA_CHECKED(AddPropertySubFiles(
-            fnames, katana::URI::JoinPath(dir().string(), node_prop.path())));
+        KATANA_CHECKED(AddPropertyFiles(fnames, dir(), node_prop));
       }
       for (const auto& edge_prop : header.edge_prop_info_list()) {
-        fnames.emplace(edge_prop.path());
-        KATANA_CHECKED(AddPropertySubFiles(
-            fnames, katana::URI::JoinPath(dir().string(), edge_prop.path())));
+        KATANA_CHECKED(AddPropertyFiles(fnames, dir(), edge_prop));
       }
       for (const auto& part_prop : header.part_prop_info_list()) {
-        fnames.emplace(part_prop.path());
-        KATANA_CHECKED(AddPropertySubFiles(
-            fnames, katana::URI::JoinPath(dir().string(), part_prop.path())));
+        KATANA_CHECKED(AddPropertyFiles(fnames, dir(), part_prop));
       }
       // Duplicates eliminated by set
       if (const auto& n = header.node_entity_type_id_array_path(); !n.empty()) {
@@ -1,6 +1,7 @@
 #include "RDGPartHeader.h"
 
 #include <cstdint>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -14,10 +15,12 @@
 #include "katana/FaultTest.h"
 #include "katana/FileView.h"
 #include "katana/Logging.h"
+#include "katana/ParquetReader.h"
 #include "katana/RDGOptionalDatastructure.h"
 #include "katana/RDGStorageFormatVersion.h"
 #include "katana/RDGTopology.h"
 #include "katana/Result.h"
+#include "katana/file.h"
 
 using json = nlohmann::json;
 
@@ -52,6 +55,9 @@ const char* kPartitionTopologyMetadataEntriesKey =
 const char* kPartitionTopologyMetadataEntriesSizeKey =
     "kg.v1.partition_topology_metadata_entries_size";
 const char* kOptionalDatastructuresKey = "kg.v1.optional_datastructures";
+// Storage format tags recorded with property entries
+const char* kParquetStorageFormat = "parquet";
+const char* kArrowIPCStorageFormat = "arrow";
 
 //
 //constexpr std::string_view  mirror_nodes_prop_name = "mirror_nodes";
@@ -64,12 +70,9 @@ katana::Result<void>
 CopyProperty(
     katana::PropStorageInfo* prop, const katana::URI& old_location,
     const katana::URI& new_location) {
-  katana::URI old_path = old_location.Join(prop->path());
-  katana::URI new_path = new_location.Join(prop->path());
-  katana::FileView fv;
-
-  KATANA_CHECKED(fv.Bind(old_path.string(), true));
-  return katana::FileStore(new_path.string(), fv.ptr<uint8_t>(), fv.size());
+  return katana::CopyPropertyFiles(
+      prop->path(), prop->delta_paths(), prop->storage_format(), old_location,
+      new_location);
 }
 
 katana::PropStorageInfo*
@@ -103,8 +106,73 @@ const int kPartitionMatchHostIndex = 3;
 
 }  // namespace
 
+katana::Result<std::vector<std::string>>
+katana::PropertyFileNames(
+    const katana::URI& dir, const std::string& path,
+    const std::vector<std::string>& delta_paths, PropertyStorageFormat format) {
+  std::vector<std::string> names;
+  // a large Parquet table is written as a file of part offsets and the parts
+  auto add_parquet = [&](const std::string& name) -> katana::Result<void> {
+    names.emplace_back(name);
+    std::unique_ptr<katana::ParquetReader> reader =
+        KATANA_CHECKED(katana::ParquetReader::Make());
+    std::vector<std::string> files = KATANA_CHECKED_CONTEXT(
+        reader->GetFiles(dir.Join(name)), "listing the files of {}", name);
+    for (const std::string& file : files) {
+      katana::URI file_uri = KATANA_CHECKED(katana::URI::Make(file));
+      std::string base_name = file_uri.BaseName();
+      if (base_name != name) {
+        names.emplace_back(std::move(base_name));
+      }
+    }
+    return katana::ResultSuccess();
+  };
+
+  if (format == PropertyStorageFormat::kArrowIPC) {
+    names.emplace_back(path);
+  } else {
+    KATANA_CHECKED(add_parquet(path));
+  }
+  // deltas are always Parquet
+  for (const std::string& delta_path : delta_paths) {
+    KATANA_CHECKED(add_parquet(delta_path));
+  }
+  return names;
+}
+
+katana::Result<void>
+katana::CopyPropertyFiles(
+    const std::string& path, const std::vector<std::string>& delta_paths,
+    PropertyStorageFormat format, const katana::URI& old_location,
+    const katana::URI& new_location) {
+  std::vector<std::string> names = KATANA_CHECKED(
+      PropertyFileNames(old_location, path, delta_paths, format));
+  for (const std::string& name : names) {
+    katana::URI old_path = old_location.Join(name);
+    katana::URI new_path = new_location.Join(name);
+
+    katana::StatBuf stat;
+    KATANA_CHECKED(katana::FileStat(old_path.string(), &stat));
+    auto copied = katana::FileRemoteCopy(
+        old_path.string(), new_path.string(), 0, stat.size);
+    if (copied) {
+      continue;
+    }
+    if (copied.error() != katana::ErrorCode::NotImplemented) {
+      return copied.error().WithContext("copying {}", old_path.string());
+    }
+
+    // different backends, copy through memory
+    katana::FileView fv;
+    KATANA_CHECKED(fv.Bind(old_path.string(), true));
+    KATANA_CHECKED(
+        katana::FileStore(new_path.string(), fv.ptr<uint8_t>(), fv.size()));
+  }
+  return katana::ResultSuccess();
+}
+
 katana::Result<katana::RDGPartHeader>
-katana::RDGPartHeader::MakeJson(const katana::URI& partition_path) {
+katana::RDGPartHeader::Make(const katana::URI& partition_path) {
   katana::FileView fv;
   KATANA_CHECKED(fv.Bind(partition_path.string(), true));
 
@@ -112,24 +180,25 @@ katana::RDGPartHeader::MakeJson(const katana::URI& partition_path) {
     return katana::RDGPartHeader();
   }
 
+  // headers are JSON text unless written with BinaryRDGMetadata enabled
   katana::RDGPartHeader header;
-  KATANA_CHECKED(katana::JsonParse<katana::RDGPartHeader>(fv, &header));
+  KATANA_CHECKED(katana::JsonParseAny<katana::RDGPartHeader>(fv, &header));
 
   return header;
 }
 
-katana::Result<katana::RDGPartHeader>
-katana::RDGPartHeader::Make(const katana::URI& partition_path) {
-  return KATANA_CHECKED(MakeJson(partition_path));
-}
-
 katana::Result<std::unique_ptr<katana::FileFrame>>
 katana::RDGPartHeader::FillFileFrame(
     katana::RDGHandle handle,
     katana::RDG::RDGVersioningPolicy retain_version) const {
-  std::string serialized = KATANA_CHECKED(katana::JsonDump(*this));
-  // POSIX files end with newlines
-  serialized = serialized + "\n";
+  std::string serialized;
+  if (KATANA_EXPERIMENTAL_ENABLED(BinaryRDGMetadata)) {
+    serialized = KATANA_CHECKED(katana::JsonDumpBinary(*this));
+  } else {
+    serialized = KATANA_CHECKED(katana::JsonDump(*this));
+    // POSIX files end with newlines
+    serialized = serialized + "\n";
+  }
   TSUBA_PTP(internal::FaultSensitivity::Normal);
 
   auto ff = std::make_unique<katana::FileFrame>();
@@ -266,25 +335,27 @@ katana::RDGPartHeader::Validate() const {
 katana::Result<void>
 katana::RDGPartHeader::ChangeStorageLocation(
     const katana::URI& old_location, const katana::URI& new_location) {
+  // properties that match their files on storage, loaded or not, are copied
+  // rather than serialized again; only their changes are written
   for (PropStorageInfo& prop : node_prop_info_list_) {
-    if (prop.IsAbsent()) {
-      KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
+    if (prop.IsDirty()) {
+      prop.WasRelocated(old_location);
     } else {
-      prop.WasModified(prop.type());
+      KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
     }
   }
   for (PropStorageInfo& prop : edge_prop_info_list_) {
-    if (prop.IsAbsent()) {
-      KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
+    if (prop.IsDirty()) {
+      prop.WasRelocated(old_location);
     } else {
-      prop.WasModified(prop.type());
+      KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
     }
   }
   for (PropStorageInfo& prop : part_prop_info_list_) {
-    if (prop.IsAbsent()) {
-      KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
+    if (prop.IsDirty()) {
+      prop.WasRelocated(old_location);
     } else {
-      prop.WasModified(prop.type());
+      KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
     }
   }
   // clear out specific file paths so that we know to store them later
@@ -529,11 +600,64 @@ katana::from_json(const nlohmann::json& j, katana::PropStorageInfo& propmd) {
   j.at(0).get_to(propmd.name_);
   j.at(1).get_to(propmd.path_);
   propmd.state_ = PropStorageInfo::State::kAbsent;
+  propmd.delta_paths_.clear();
+
+  // Version 7 added an optional storage format, absent for parquet
+  propmd.storage_format_ = katana::PropertyStorageFormat::kParquet;
+  if (j.size() > 2) {
+    std::string storage_format;
+    j.at(2).get_to(storage_format);
+    if (storage_format == kArrowIPCStorageFormat) {
+      propmd.storage_format_ = katana::PropertyStorageFormat::kArrowIPC;
+    } else if (storage_format != kParquetStorageFormat) {
+      throw std::runtime_error(
+          "unknown property storage format: " + storage_format);
+    }
+  }
+
+  // Version 8 added an optional list of delta files
+  if (j.size() > 3) {
+    j.at(3).get_to(propmd.delta_paths_);
+  }
+
+  // Version 9 added optional statistics
+  propmd.stats_.reset();
+  if (j.size() > 4 && !j.at(4).is_null()) {
+    propmd.stats_ = j.at(4).get<katana::PropertyStats>();
+  }
+
+  // Version 10 added an optional content hash
+  propmd.content_hash_.reset();
+  propmd.replaced_.reset();
+  if (j.size() > 5) {
+    propmd.content_hash_ = j.at(5).get<uint64_t>();
+  }
 }
 
 void
 katana::to_json(json& j, const katana::PropStorageInfo& propmd) {
   j = json{propmd.name(), propmd.path()};
+  // Leave parquet entries without deltas, statistics or hashes in the
+  // pre-version 7 layout
+  if (!propmd.delta_paths().empty() || propmd.stats() ||
+      propmd.content_hash()) {
+    j.push_back(
+        propmd.storage_format() == katana::PropertyStorageFormat::kArrowIPC
+            ? kArrowIPCStorageFormat
+            : kParquetStorageFormat);
+    j.push_back(propmd.delta_paths());
+    if (propmd.stats() || propmd.content_hash()) {
+      j.push_back(
+          propmd.stats() ? nlohmann::json(*propmd.stats())
+                         : nlohmann::json(nullptr));
+    }
+    if (propmd.content_hash()) {
+      j.push_back(*propmd.content_hash());
+    }
+  } else if (
+      propmd.storage_format() == katana::PropertyStorageFormat::kArrowIPC) {
+    j.push_back(kArrowIPCStorageFormat);
+  }
 }
 
 void
@@ -562,6 +686,10 @@ katana::from_json(
   j.at("transpose_state").get_to(topo.transpose_state_);
   j.at("edge_sort_state").get_to(topo.edge_sort_state_);
   j.at("node_sort_state").get_to(topo.node_sort_state_);
+  // only present on topologies sorted by an edge property
+  if (auto it = j.find("edge_sort_property"); it != j.end()) {
+    it->get_to(topo.edge_sort_property_);
+  }
   KATANA_LOG_DEBUG(
       "read topology with: topology_state={}, transpose_state={}, "
       "edge_sort_state={}, node_sort_state={}",
@@ -608,6 +736,9 @@ katana::to_json(json& j, const katana::PartitionTopologyMetadataEntry& topo) {
       {"transpose_state", topo.transpose_state_},
       {"edge_sort_state", topo.edge_sort_state_},
       {"node_sort_state", topo.node_sort_state_}};
+  if (!topo.edge_sort_property_.empty()) {
+    j["edge_sort_property"] = topo.edge_sort_property_;
+  }
 
   KATANA_LOG_DEBUG(
       "stored topology with: topology_state={}, transpose_state={}, "
@@ -689,10 +820,21 @@ katana::from_json(
   j.at("num_buckets").get_to(index.num_buckets_);
   j.at("fingerprint_length").get_to(index.fingerprint_length_);
   j.at("num_fingerprints").get_to(index.num_fingerprints_);
-  j.at("smiles").get_to(index.smiles_);
-  j.at("hash_structure").get_to(index.hash_structure_);
-  j.at("fingerprints").get_to(index.fingerprints_);
   j.at("paths").get_to(index.paths_);
+  if (j.contains("hash_structure")) {
+    // manifests written before the packed format hold the arrays themselves
+    index.set_smiles(j.at("smiles").get<std::vector<std::string>>());
+    index.set_hash_structure(
+        j.at("hash_structure")
+            .get<std::vector<std::map<uint64_t, std::vector<uint64_t>>>>());
+    index.set_fingerprints(
+        j.at("fingerprints").get<std::vector<katana::DynamicBitset>>());
+    return;
+  }
+  j.at("hash_keys_path").get_to(index.hash_keys_path_);
+  j.at("hash_values_path").get_to(index.hash_values_path_);
+  j.at("fingerprints_path").get_to(index.fingerprints_path_);
+  j.at("smiles_path").get_to(index.smiles_path_);
 }
 
 void
@@ -702,9 +844,10 @@ katana::to_json(nlohmann::json& j, const katana::RDKLSHIndexPrimitive& index) {
       {"num_buckets", index.num_buckets_},
       {"fingerprint_length", index.fingerprint_length_},
       {"num_fingerprints", index.num_fingerprints_},
-      {"smiles", index.smiles_},
-      {"hash_structure", index.hash_structure_},
-      {"fingerprints", index.fingerprints_},
+      {"hash_keys_path", index.hash_keys_path_},
+      {"hash_values_path", index.hash_values_path_},
+      {"fingerprints_path", index.fingerprints_path_},
+      {"smiles_path", index.smiles_path_},
       {"paths", index.paths_}};
 }
 
@@ -713,10 +856,18 @@ katana::from_json(
     const nlohmann::json& j, katana::RDKSubstructureIndexPrimitive& index) {
   j.at("fp_size").get_to(index.fp_size_);
   j.at("num_entries").get_to(index.num_entries_);
-  j.at("smiles").get_to(index.smiles_);
-  j.at("index").get_to(index.index_);
-  j.at("fingerprints").get_to(index.fingerprints_);
   j.at("paths").get_to(index.paths_);
+  if (j.contains("index")) {
+    // manifests written before the packed format hold the arrays themselves
+    index.set_smiles(j.at("smiles").get<std::vector<std::string>>());
+    index.set_index(j.at("index").get<std::vector<std::vector<uint64_t>>>());
+    index.set_fingerprints(
+        j.at("fingerprints").get<std::vector<katana::DynamicBitset>>());
+    return;
+  }
+  j.at("index_path").get_to(index.index_path_);
+  j.at("fingerprints_path").get_to(index.fingerprints_path_);
+  j.at("smiles_path").get_to(index.smiles_path_);
 }
 
 void
@@ -725,12 +876,89 @@ katana::to_json(
   j = nlohmann::json{
       {"fp_size", index.fp_size_},
       {"num_entries", index.num_entries_},
-      {"smiles", index.smiles_},
-      {"index", index.index_},
-      {"fingerprints", index.fingerprints_},
+      {"index_path", index.index_path_},
+      {"fingerprints_path", index.fingerprints_path_},
+      {"smiles_path", index.smiles_path_},
       {"paths", index.paths_}};
 }
 
+void
+katana::from_json(
+    const nlohmann::json& j, katana::EntityIndexPrimitive::IndexFiles& files) {
+  j.at("property_name").get_to(files.property_name);
+  j.at("is_node").get_to(files.is_node);
+  // manifests written before hash indexes existed hold only sorted ones
+  files.hash = j.value("hash", false);
+  j.at("num_entities").get_to(files.num_entities);
+  j.at("num_entries").get_to(files.num_entries);
+  j.at("ids_path").get_to(files.ids_path);
+  j.at("keys_path").get_to(files.keys_path);
+}
+
+void
+katana::to_json(
+    nlohmann::json& j, const katana::EntityIndexPrimitive::IndexFiles& files) {
+  j = nlohmann::json{
+      {"property_name", files.property_name},
+      {"is_node", files.is_node},
+      {"hash", files.hash},
+      {"num_entities", files.num_entities},
+      {"num_entries", files.num_entries},
+      {"ids_path", files.ids_path},
+      {"keys_path", files.keys_path}};
+}
+
+void
+katana::from_json(
+    const nlohmann::json& j, katana::EntityIndexPrimitive& index) {
+  j.at("indexes").get_to(index.indexes_);
+  j.at("paths").get_to(index.paths_);
+}
+
+void
+katana::to_json(nlohmann::json& j, const katana::EntityIndexPrimitive& index) {
+  j = nlohmann::json{{"indexes", index.indexes_}, {"paths", index.paths_}};
+}
+
+void
+katana::from_json(
+    const nlohmann::json& j, katana::VectorIndexPrimitive::IndexFiles& files) {
+  j.at("property_name").get_to(files.property_name);
+  j.at("metric").get_to(files.metric);
+  j.at("dimension").get_to(files.dimension);
+  j.at("num_entities").get_to(files.num_entities);
+  j.at("num_entries").get_to(files.num_entries);
+  j.at("centroids_path").get_to(files.centroids_path);
+  j.at("lists_path").get_to(files.lists_path);
+  j.at("vectors_path").get_to(files.vectors_path);
+}
+
+void
+katana::to_json(
+    nlohmann::json& j, const katana::VectorIndexPrimitive::IndexFiles& files) {
+  j = nlohmann::json{
+      {"property_name", files.property_name},
+      {"metric", files.metric},
+      {"dimension", files.dimension},
+      {"num_entities", files.num_entities},
+      {"num_entries", files.num_entries},
+      {"centroids_path", files.centroids_path},
+      {"lists_path", files.lists_path},
+      {"vectors_path", files.vectors_path}};
+}
+
+void
+katana::from_json(
+    const nlohmann::json& j, katana::VectorIndexPrimitive& index) {
+  j.at("indexes").get_to(index.indexes_);
+  j.at("paths").get_to(index.paths_);
+}
+
+void
+katana::to_json(nlohmann::json& j, const katana::VectorIndexPrimitive& index) {
+  j = nlohmann::json{{"indexes", index.indexes_}, {"paths", index.paths_}};
+}
+
 void
 katana::from_json(
     const nlohmann::json& j, katana::RDGOptionalDatastructure& data) {
@@ -13,11 +13,13 @@
 #include <arrow/api.h>
 
 #include "PartitionTopologyMetadata.h"
+#include "katana/EntityIndexPrimitive.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
 #include "katana/JSON.h"
 #include "katana/Logging.h"
 #include "katana/PartitionMetadata.h"
+#include "katana/PropertyStatistics.h"
 #include "katana/RDG.h"
 #include "katana/RDGStorageFormatVersion.h"
 #include "katana/RDGTopology.h"
@@ -25,6 +27,7 @@
 #include "katana/RDKSubstructureIndexPrimitive.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
+#include "katana/VectorIndexPrimitive.h"
 #include "katana/WriteGroup.h"
 #include "katana/tsuba.h"
 
@@ -38,6 +41,8 @@ namespace katana {
 ///  * Absent - exists in storage but is not in memory
 ///  * Clean  - in memory and matches what is in storage
 ///  * Dirty  - in memory but does not match what is in storage
+///  * DeltaDirty - in memory and differs from storage only in the rows listed
+///    by pending_delta_rows(); storing it appends one delta file
 ///
 /// The state machine looks like this:
 ///
@@ -55,11 +60,22 @@ namespace katana {
 /// Properties either start out in storage as part of an RDG on disk
 /// (EXISTING PROPERTY) or start out in memory as part of an RDG in
 /// memory (NEW PROPERTY)
+///
+/// A Clean or DeltaDirty property becomes DeltaDirty when some of its rows are
+/// updated and goes back to Clean when the delta is written. A full modify
+/// drops any deltas. On storage, a property is its base file at path() with
+/// the files in delta_paths() applied in order; each delta file holds a row
+/// id column and a value column.
+///
+/// A full modify remembers the files it replaced and their content hash. If
+/// the property is written back with the same contents, it returns to those
+/// files instead of writing new ones.
 class PropStorageInfo {
   enum class State {
     kAbsent,
     kClean,
     kDirty,
+    kDeltaDirty,
   };
 
 public:
@@ -81,17 +97,74 @@ public:
   }
 
   void WasModified(const std::shared_ptr<arrow::DataType>& type) {
+    if (state_ != State::kDirty && !path_.empty() && content_hash_) {
+      replaced_ = StoredFiles{
+          .dir = std::nullopt,
+          .path = std::move(path_),
+          .delta_paths = std::move(delta_paths_),
+          .content_hash = *content_hash_,
+          .storage_format = storage_format_,
+          .type = type_,
+          .num_rows = stats_ ? std::optional<uint64_t>(stats_->total.end)
+                             : std::nullopt,
+      };
+    }
     path_.clear();
+    delta_paths_.clear();
+    pending_delta_rows_.clear();
+    stats_.reset();
+    content_hash_.reset();
     state_ = State::kDirty;
     type_ = type;
   }
 
+  /// Record that rows of a loaded property were overwritten. A property that
+  /// is already fully dirty stays that way.
+  void WasDeltaModified(const std::vector<uint64_t>& rows) {
+    KATANA_LOG_ASSERT(state_ != State::kAbsent);
+    if (state_ == State::kDirty) {
+      return;
+    }
+    pending_delta_rows_.insert(
+        pending_delta_rows_.end(), rows.begin(), rows.end());
+    stats_.reset();
+    content_hash_.reset();
+    state_ = State::kDeltaDirty;
+  }
+
+  void WasDeltaWritten(std::string_view new_delta_path) {
+    KATANA_LOG_ASSERT(state_ == State::kDeltaDirty);
+    delta_paths_.emplace_back(new_delta_path);
+    pending_delta_rows_.clear();
+    state_ = State::kClean;
+  }
+
   void WasWritten(std::string_view new_path) {
     KATANA_LOG_ASSERT(state_ == State::kDirty);
     path_ = new_path;
+    replaced_.reset();
+    state_ = State::kClean;
+  }
+
+  /// Record that a dirty property turned out to hold the same contents as
+  /// the files it replaced, which now live in the directory being written
+  void WasRestored() {
+    KATANA_LOG_ASSERT(state_ == State::kDirty && replaced_);
+    path_ = std::move(replaced_->path);
+    delta_paths_ = std::move(replaced_->delta_paths);
+    content_hash_ = replaced_->content_hash;
+    replaced_.reset();
     state_ = State::kClean;
   }
 
+  /// Record that the RDG is being written to a new directory; the files a
+  /// dirty property replaced stay behind in old_location
+  void WasRelocated(const URI& old_location) {
+    if (replaced_ && !replaced_->dir) {
+      replaced_->dir = old_location;
+    }
+  }
+
   void WasUnloaded() {
     KATANA_LOG_ASSERT(state_ == State::kClean);
     state_ = State::kAbsent;
@@ -103,10 +176,54 @@ public:
 
   bool IsDirty() const { return state_ == State::kDirty; }
 
+  bool IsDeltaDirty() const { return state_ == State::kDeltaDirty; }
+
   const std::string& name() const { return name_; }
   const std::string& path() const { return path_; }
+  const std::vector<std::string>& delta_paths() const { return delta_paths_; }
+  /// the newest file of this property on storage; it names the current
+  /// contents of the property, e.g., as a cache key
+  const std::string& latest_path() const {
+    return delta_paths_.empty() ? path_ : delta_paths_.back();
+  }
+  /// rows changed since the last store, unsorted and possibly repeated
+  const std::vector<uint64_t>& pending_delta_rows() const {
+    return pending_delta_rows_;
+  }
   const std::shared_ptr<arrow::DataType>& type() const { return type_; }
 
+  /// statistics captured when the property was last written; empty for
+  /// properties modified since then and for older RDGs
+  const std::optional<PropertyStats>& stats() const { return stats_; }
+  void set_stats(PropertyStats stats) { stats_ = std::move(stats); }
+
+  /// ComputePropertyContentHash of the property as it is on storage; empty
+  /// for properties modified since they were last written, for types that
+  /// are not hashed and for older RDGs
+  const std::optional<uint64_t>& content_hash() const { return content_hash_; }
+  void set_content_hash(std::optional<uint64_t> content_hash) {
+    content_hash_ = content_hash;
+  }
+
+  /// The files a dirty property replaced. dir is empty if they are in the
+  /// directory the property will be written to.
+  struct StoredFiles {
+    std::optional<URI> dir;
+    std::string path;
+    std::vector<std::string> delta_paths;
+    uint64_t content_hash;
+    PropertyStorageFormat storage_format;
+    std::shared_ptr<arrow::DataType> type;
+    /// empty if the files were written without statistics
+    std::optional<uint64_t> num_rows;
+  };
+  const std::optional<StoredFiles>& replaced() const { return replaced_; }
+
+  PropertyStorageFormat storage_format() const { return storage_format_; }
+  void set_storage_format(PropertyStorageFormat storage_format) {
+    storage_format_ = storage_format;
+  }
+
   // since we don't have type info in the header don't know the
   // type when this would have been constructed. Allow others to
   // fix up the type in this case, required until we can get the type
@@ -125,10 +242,32 @@ public:
 private:
   std::string name_;
   std::string path_;
+  std::vector<std::string> delta_paths_;
+  std::vector<uint64_t> pending_delta_rows_;
+  std::optional<PropertyStats> stats_;
+  std::optional<uint64_t> content_hash_;
+  std::optional<StoredFiles> replaced_;
   std::shared_ptr<arrow::DataType> type_;
   State state_;
+  PropertyStorageFormat storage_format_{PropertyStorageFormat::kParquet};
 };
 
+/// \returns the names, relative to dir, of the files that hold a property
+/// stored at path in format with the deltas at delta_paths: path and, for a
+/// Parquet table written in parts, its part files, then the same for each
+/// delta
+KATANA_EXPORT katana::Result<std::vector<std::string>> PropertyFileNames(
+    const katana::URI& dir, const std::string& path,
+    const std::vector<std::string>& delta_paths, PropertyStorageFormat format);
+
+/// Copy the files of a property, see PropertyFileNames, from old_location to
+/// new_location, with a copy on the storage backend where it supports one so
+/// that the data does not pass through this host
+KATANA_EXPORT katana::Result<void> CopyPropertyFiles(
+    const std::string& path, const std::vector<std::string>& delta_paths,
+    PropertyStorageFormat format, const katana::URI& old_location,
+    const katana::URI& new_location);
+
 class KATANA_EXPORT RDGPartHeader {
 public:
   RDGPartHeader() = default;
@@ -437,7 +576,8 @@ public:
   void AppendOptionalDatastructureManifest(
       const std::string& optional_datastructure_name,
       const std::string& optional_datastructure_path) {
-    optional_datastructure_manifests_.emplace(
+    // a later write of the same datastructure replaces the earlier one
+    optional_datastructure_manifests_.insert_or_assign(
         optional_datastructure_name, optional_datastructure_path);
     KATANA_LOG_DEBUG(
         "Appended optional datastructure manifest {}, at path {}, total count "
@@ -506,9 +646,6 @@ private:
     return DoSelectProperties(storage_info);
   }
 
-  static katana::Result<RDGPartHeader> MakeJson(
-      const katana::URI& partition_path);
-
   katana::Result<std::unique_ptr<katana::FileFrame>> FillFileFrame(
       katana::RDGHandle handle,
       katana::RDG::RDGVersioningPolicy retain_version) const;
@@ -605,6 +742,22 @@ void from_json(const nlohmann::json& j, RDKLSHIndexPrimitive& index);
 void to_json(nlohmann::json& j, const RDKSubstructureIndexPrimitive& index);
 void from_json(const nlohmann::json& j, RDKSubstructureIndexPrimitive& index);
 
+void to_json(
+    nlohmann::json& j, const EntityIndexPrimitive::IndexFiles& files);
+void from_json(
+    const nlohmann::json& j, EntityIndexPrimitive::IndexFiles& files);
+
+void to_json(nlohmann::json& j, const EntityIndexPrimitive& index);
+void from_json(const nlohmann::json& j, EntityIndexPrimitive& index);
+
+void to_json(
+    nlohmann::json& j, const VectorIndexPrimitive::IndexFiles& files);
+void from_json(
+    const nlohmann::json& j, VectorIndexPrimitive::IndexFiles& files);
+
+void to_json(nlohmann::json& j, const VectorIndexPrimitive& index);
+void from_json(const nlohmann::json& j, VectorIndexPrimitive& index);
+
 void to_json(nlohmann::json& j, const RDGOptionalDatastructure& data);
 void from_json(const nlohmann::json& j, RDGOptionalDatastructure& data);
 
@@ -624,14 +777,20 @@ NLOHMANN_JSON_SERIALIZE_ENUM(
      {RDGTopology::EdgeSortKind::kAny, "kAny"},
      {RDGTopology::EdgeSortKind::kSortedByDestID, "kSortedByDestID"},
      {RDGTopology::EdgeSortKind::kSortedByEdgeType, "kSortedByEdgeType"},
-     {RDGTopology::EdgeSortKind::kSortedByNodeType, "kSortedByNodeType"}})
+     {RDGTopology::EdgeSortKind::kSortedByNodeType, "kSortedByNodeType"},
+     {RDGTopology::EdgeSortKind::kSortedByEdgeProperty,
+      "kSortedByEdgeProperty"}})
 
 NLOHMANN_JSON_SERIALIZE_ENUM(
     RDGTopology::NodeSortKind,
     {{RDGTopology::NodeSortKind::kInvalid, "kInvalid"},
      {RDGTopology::NodeSortKind::kAny, "kAny"},
      {RDGTopology::NodeSortKind::kSortedByDegree, "kSortedByDegree"},
-     {RDGTopology::NodeSortKind::kSortedByNodeType, "kSortedByNodeType"}})
+     {RDGTopology::NodeSortKind::kSortedByNodeType, "kSortedByNodeType"},
+     {RDGTopology::NodeSortKind::kReverseCuthillMcKee, "kReverseCuthillMcKee"},
+     {RDGTopology::NodeSortKind::kHubClustered, "kHubClustered"},
+     {RDGTopology::NodeSortKind::kClusteredByCommunity,
+      "kClusteredByCommunity"}})
 
 NLOHMANN_JSON_SERIALIZE_ENUM(
     RDGTopology::TopologyKind,
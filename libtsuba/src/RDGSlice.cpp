@@ -1,5 +1,9 @@
 #include "katana/RDGSlice.h"
 
+#include <algorithm>
+#include <functional>
+#include <future>
+
 #include "AddProperties.h"
 #include "RDGCore.h"
 #include "RDGHandleImpl.h"
@@ -153,29 +157,176 @@ unload_property(
   return katana::ResultSuccess();
 }
 
-}  // namespace
+constexpr uint64_t kTopologyHeaderSize = 4 * sizeof(uint64_t);
+
+// returns the number of nodes and edges of the topology file at topo_path
+katana::Result<std::pair<uint64_t, uint64_t>>
+read_sliceable_topology_header(const katana::URI& topo_path) {
+  katana::FileView topo_header;
+  KATANA_CHECKED(
+      topo_header.Bind(topo_path.string(), 0, kTopologyHeaderSize, true));
+  const auto* data = topo_header.ptr<uint64_t>();
+
+  // slices are byte ranges of the uncompressed layout, so a compressed
+  // topology file has to be loaded whole
+  if (data[0] != 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "cannot slice a compressed topology file; rewrite the graph without "
+        "KATANA_TOPOLOGY_COMPRESSION");
+  }
+  return std::make_pair(data[2], data[3]);
+}
+
+std::pair<uint64_t, uint64_t>
+slice_range(const katana::RDGSlice::SliceArg& slice, NodeEdge node_edge) {
+  return node_edge == NodeEdge::kNode ? slice.node_range : slice.edge_range;
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+append_columns(
+    std::shared_ptr<arrow::Table> table,
+    const std::shared_ptr<arrow::Table>& props) {
+  if (!table || table->num_columns() == 0) {
+    return props;
+  }
+  for (int i = 0; i < props->num_columns(); ++i) {
+    table = KATANA_CHECKED(table->AddColumn(
+        table->num_columns(), props->field(i), props->column(i)));
+  }
+  return table;
+}
 
+// Load the selected node or edge properties once, over the smallest range that
+// covers every slice, and give each core a zero-copy slice of the result. The
+// property infos of cores[0] drive the load, the rest are marked loaded as
+// their slice of a property is attached.
 katana::Result<void>
-katana::RDGSlice::DoMake(
-    const std::optional<std::vector<std::string>>& node_props,
-    const std::optional<std::vector<std::string>>& edge_props,
-    const katana::URI& metadata_dir, const SliceArg& slice) {
-  slice_arg_ = slice;
+add_shared_property_slices(
+    const katana::URI& metadata_dir, const std::vector<katana::RDGCore*>& cores,
+    const std::vector<katana::RDGSlice::SliceArg>& slices, NodeEdge node_edge,
+    const std::optional<std::vector<std::string>>& names,
+    katana::ReadGroup* grp) {
+  std::pair<uint64_t, uint64_t> covering = slice_range(slices[0], node_edge);
+  for (const auto& slice : slices) {
+    std::pair<uint64_t, uint64_t> range = slice_range(slice, node_edge);
+    covering.first = std::min(covering.first, range.first);
+    covering.second = std::max(covering.second, range.second);
+  }
 
-  ReadGroup grp;
+  katana::RDGPartHeader& header = cores[0]->part_header();
+  std::vector<katana::PropStorageInfo*> properties;
+  if (node_edge == NodeEdge::kNode) {
+    properties = KATANA_CHECKED(header.SelectNodeProperties(names));
+  } else {
+    properties = KATANA_CHECKED(header.SelectEdgeProperties(names));
+  }
+
+  KATANA_CHECKED(AddPropertySlice(
+      metadata_dir, properties, covering, grp,
+      [cores, slices, covering, node_edge](
+          const std::shared_ptr<arrow::Table>& props) -> katana::Result<void> {
+        const std::string& name = props->field(0)->name();
+        for (size_t i = 0, size = cores.size(); i < size; ++i) {
+          katana::RDGCore* core = cores[i];
+          std::pair<uint64_t, uint64_t> range =
+              slice_range(slices[i], node_edge);
+          int64_t length = range.second > range.first
+                               ? range.second - range.first
+                               : 0;
+          std::shared_ptr<arrow::Table> prop_slice =
+              props->Slice(range.first - covering.first, length);
+
+          if (node_edge == NodeEdge::kNode) {
+            core->set_node_properties(KATANA_CHECKED(
+                append_columns(core->node_properties(), prop_slice)));
+          } else {
+            core->set_edge_properties(KATANA_CHECKED(
+                append_columns(core->edge_properties(), prop_slice)));
+          }
+
+          // AddPropertySlice marks the property of cores[0]
+          if (i > 0) {
+            katana::PropStorageInfo* prop_info =
+                node_edge == NodeEdge::kNode
+                    ? core->part_header().find_node_prop_info(name)
+                    : core->part_header().find_edge_prop_info(name);
+            KATANA_LOG_ASSERT(prop_info);
+            prop_info->WasLoaded(props->field(0)->type());
+          }
+        }
+        return katana::ResultSuccess();
+      }));
+
+  return katana::ResultSuccess();
+}
+
+// Load the partition metadata arrays that slices need up front (as opposed to
+// on-demand) once and share them between cores.
+katana::Result<void>
+add_partition_metadata(
+    const katana::URI& metadata_dir, const std::vector<katana::RDGCore*>& cores,
+    katana::ReadGroup* grp) {
+  // any properties left at this point will really be partition metadata arrays
+  // (which we load via the property interface)
+  std::vector<katana::PropStorageInfo*> part_info =
+      KATANA_CHECKED(cores[0]->part_header().SelectPartitionProperties());
+
+  std::vector<katana::PropStorageInfo*> load_now;
+  for (katana::PropStorageInfo* prop : part_info) {
+    const std::string& name = prop->name();
+    if (name == katana::RDGCore::kMasterNodesPropName ||
+        name == katana::RDGCore::kMirrorNodesPropName ||
+        name == katana::RDGCore::kHostToOwnedGlobalNodeIDsPropName ||
+        name == katana::RDGCore::kHostToOwnedGlobalEdgeIDsPropName) {
+      load_now.push_back(prop);
+    }
+  }
+  if (load_now.empty()) {
+    return katana::ResultSuccess();
+  }
+
+  KATANA_CHECKED_CONTEXT(
+      AddProperties(
+          metadata_dir, false, load_now, grp,
+          [cores](
+              const std::shared_ptr<arrow::Table>& props)
+              -> katana::Result<void> {
+            for (size_t i = 0, size = cores.size(); i < size; ++i) {
+              KATANA_CHECKED(cores[i]->AddPartitionMetadataArray(props));
+              if (i > 0) {
+                katana::PropStorageInfo* prop_info =
+                    cores[i]->part_header().find_part_prop_info(
+                        props->field(0)->name());
+                KATANA_LOG_ASSERT(prop_info);
+                prop_info->WasLoaded(props->field(0)->type());
+              }
+            }
+            return katana::ResultSuccess();
+          }),
+      "populating partition metadata");
 
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::RDGSlice::BindSliceStorage(const katana::URI& metadata_dir) {
   KATANA_CHECKED(core_->MakeTopologyManager(metadata_dir));
 
   // must have csr topology to Make an RDGSlice
   katana::RDGTopology shadow = katana::RDGTopology::MakeShadowCSR();
   katana::RDGTopology* topo =
       KATANA_CHECKED(core_->topology_manager().GetTopology(shadow));
+  KATANA_CHECKED(
+      read_sliceable_topology_header(metadata_dir.Join(topo->path())));
 
+  uint64_t topo_end = slice_arg_.topo_off + slice_arg_.topo_size;
   KATANA_CHECKED_CONTEXT(
-      topo->Bind(
-          metadata_dir, slice.topo_off, slice.topo_off + slice.topo_size, true),
-      "loading topology array; begin: {}, end: {}", slice.topo_off,
-      slice.topo_off + slice.topo_size);
+      topo->Bind(metadata_dir, slice_arg_.topo_off, topo_end, true),
+      "loading topology array; begin: {}, end: {}", slice_arg_.topo_off,
+      topo_end);
 
   if (core_->part_header().IsEntityTypeIDsOutsideProperties()) {
     katana::URI node_types_path = metadata_dir.Join(
@@ -199,107 +350,53 @@ katana::RDGSlice::DoMake(
         core_->node_entity_type_id_array_file_storage().Bind(
             node_types_path.string(),
             entity_type_id_array_header_offset +
-                slice.node_range.first * sizeof(katana::EntityTypeID),
+                slice_arg_.node_range.first * sizeof(katana::EntityTypeID),
             entity_type_id_array_header_offset +
-                slice.node_range.second * sizeof(katana::EntityTypeID),
+                slice_arg_.node_range.second * sizeof(katana::EntityTypeID),
             true),
         "loading node type id array; begin: {}, end: {}",
-        slice.node_range.first * sizeof(katana::EntityTypeID),
-        slice.node_range.second * sizeof(katana::EntityTypeID));
+        slice_arg_.node_range.first * sizeof(katana::EntityTypeID),
+        slice_arg_.node_range.second * sizeof(katana::EntityTypeID));
     KATANA_CHECKED_CONTEXT(
         core_->edge_entity_type_id_array_file_storage().Bind(
             edge_types_path.string(),
             entity_type_id_array_header_offset +
-                slice.edge_range.first * sizeof(katana::EntityTypeID),
+                slice_arg_.edge_range.first * sizeof(katana::EntityTypeID),
             entity_type_id_array_header_offset +
-                slice.edge_range.second * sizeof(katana::EntityTypeID),
+                slice_arg_.edge_range.second * sizeof(katana::EntityTypeID),
             true),
         "loading edge type id array; begin: {}, end: {}",
-        slice.edge_range.first * sizeof(katana::EntityTypeID),
-        slice.edge_range.second * sizeof(katana::EntityTypeID));
+        slice_arg_.edge_range.first * sizeof(katana::EntityTypeID),
+        slice_arg_.edge_range.second * sizeof(katana::EntityTypeID));
   }
-  core_->set_rdg_dir(metadata_dir);
-  // all of the properties
-  std::vector<PropStorageInfo*> node_properties =
-      KATANA_CHECKED(core_->part_header().SelectNodeProperties(node_props));
 
-  KATANA_CHECKED(AddPropertySlice(
-      metadata_dir, node_properties, slice.node_range, &grp,
-      [rdg = this](
-          const std::shared_ptr<arrow::Table>& props) -> katana::Result<void> {
-        std::shared_ptr<arrow::Table> prop_table =
-            rdg->core_->node_properties();
-
-        if (prop_table && prop_table->num_columns() > 0) {
-          for (int i = 0; i < props->num_columns(); ++i) {
-            prop_table = KATANA_CHECKED(prop_table->AddColumn(
-                prop_table->num_columns(), props->field(i), props->column(i)));
-          }
-        } else {
-          prop_table = props;
-        }
-        rdg->core_->set_node_properties(std::move(prop_table));
-        return katana::ResultSuccess();
-      }));
+  return katana::ResultSuccess();
+}
 
-  // all of the properties
-  std::vector<PropStorageInfo*> edge_properties =
-      KATANA_CHECKED(core_->part_header().SelectEdgeProperties(edge_props));
+katana::Result<void>
+katana::RDGSlice::DoMake(
+    const std::optional<std::vector<std::string>>& node_props,
+    const std::optional<std::vector<std::string>>& edge_props,
+    const katana::URI& metadata_dir, const SliceArg& slice) {
+  slice_arg_ = slice;
+  core_->set_rdg_dir(metadata_dir);
 
-  KATANA_CHECKED(AddPropertySlice(
-      metadata_dir, edge_properties, slice.edge_range, &grp,
-      [rdg = this](
-          const std::shared_ptr<arrow::Table>& props) -> katana::Result<void> {
-        std::shared_ptr<arrow::Table> prop_table =
-            rdg->core_->edge_properties();
+  KATANA_CHECKED(BindSliceStorage(metadata_dir));
 
-        if (prop_table && prop_table->num_columns() > 0) {
-          for (int i = 0; i < props->num_columns(); ++i) {
-            prop_table = KATANA_CHECKED(prop_table->AddColumn(
-                prop_table->num_columns(), props->field(i), props->column(i)));
-          }
-        } else {
-          prop_table = props;
-        }
-        rdg->core_->set_edge_properties(std::move(prop_table));
-        return katana::ResultSuccess();
-      }));
-  core_->set_rdg_dir(metadata_dir);
+  ReadGroup grp;
+  std::vector<RDGCore*> cores{core_.get()};
+  std::vector<SliceArg> slices{slice};
 
-  // check if there are any properties left to load
-  // any properties left at this point will really be partition metadata arrays
-  // (which we load via the property interface)
-  std::vector<PropStorageInfo*> part_info =
-      KATANA_CHECKED(core_->part_header().SelectPartitionProperties());
+  KATANA_CHECKED(add_shared_property_slices(
+      metadata_dir, cores, slices, NodeEdge::kNode, node_props, &grp));
+  KATANA_CHECKED(add_shared_property_slices(
+      metadata_dir, cores, slices, NodeEdge::kEdge, edge_props, &grp));
 
   // these are not Node/Edge types but rather property types we are checking
   KATANA_CHECKED(core_->EnsureNodeTypesLoaded());
   KATANA_CHECKED(core_->EnsureEdgeTypesLoaded());
 
-  if (part_info.empty()) {
-    return grp.Finish();
-  }
-
-  // metadata arrays that should be loaded now (as oppposed to on-demand)
-  std::vector<PropStorageInfo*> load_now;
-
-  for (PropStorageInfo* prop : part_info) {
-    std::string name = prop->name();
-    if (name == RDGCore::kMasterNodesPropName ||
-        name == RDGCore::kMirrorNodesPropName ||
-        name == RDGCore::kHostToOwnedGlobalNodeIDsPropName ||
-        name == RDGCore::kHostToOwnedGlobalEdgeIDsPropName) {
-      load_now.push_back(prop);
-    }
-  }
-
-  KATANA_CHECKED_CONTEXT(
-      AddProperties(
-          metadata_dir, false, load_now, &grp,
-          [rdg = this](const std::shared_ptr<arrow::Table>& props) {
-            return rdg->core_->AddPartitionMetadataArray(props);
-          }),
-      "populating partition metadata");
+  KATANA_CHECKED(add_partition_metadata(metadata_dir, cores, &grp));
   KATANA_CHECKED(grp.Finish());
 
   return katana::ResultSuccess();
@@ -323,6 +420,177 @@ katana::RDGSlice::Make(
   return RDGSlice(std::move(rdg_slice));
 }
 
+katana::Result<std::vector<katana::RDGSlice>>
+katana::RDGSlice::MakeMany(
+    RDGHandle handle, const std::vector<SliceArg>& slices,
+    const uint32_t partition_id,
+    const std::optional<std::vector<std::string>>& node_props,
+    const std::optional<std::vector<std::string>>& edge_props) {
+  std::vector<RDGSlice> rdg_slices;
+  if (slices.empty()) {
+    return std::vector<RDGSlice>(std::move(rdg_slices));
+  }
+
+  const RDGManifest& manifest = handle.impl_->rdg_manifest();
+  const katana::URI& metadata_dir = manifest.dir();
+  katana::URI partition_path(manifest.PartitionFileName(partition_id));
+
+  auto part_header = KATANA_CHECKED(RDGPartHeader::Make(partition_path));
+
+  std::vector<RDGCore*> cores;
+  rdg_slices.reserve(slices.size());
+  for (const SliceArg& slice : slices) {
+    RDGSlice rdg_slice(std::make_unique<RDGCore>(RDGPartHeader(part_header)));
+    rdg_slice.slice_arg_ = slice;
+    rdg_slice.core_->set_rdg_dir(metadata_dir);
+    cores.emplace_back(rdg_slice.core_.get());
+    rdg_slices.emplace_back(std::move(rdg_slice));
+  }
+
+  // FileView binds block, so bind the topology and type id ranges of each
+  // slice in its own task while the property reads are in flight
+  std::vector<std::future<katana::CopyableResult<void>>> binds;
+  binds.reserve(rdg_slices.size());
+  for (RDGSlice& rdg_slice : rdg_slices) {
+    binds.emplace_back(std::async(
+        std::launch::async,
+        [&metadata_dir, rdg = &rdg_slice]() -> katana::CopyableResult<void> {
+          KATANA_CHECKED(rdg->BindSliceStorage(metadata_dir));
+          return katana::CopyableResultSuccess();
+        }));
+  }
+
+  ReadGroup grp;
+  KATANA_CHECKED(add_shared_property_slices(
+      metadata_dir, cores, slices, NodeEdge::kNode, node_props, &grp));
+  KATANA_CHECKED(add_shared_property_slices(
+      metadata_dir, cores, slices, NodeEdge::kEdge, edge_props, &grp));
+
+  for (auto& bind : binds) {
+    KATANA_CHECKED_CONTEXT(bind.get(), "binding slice storage");
+  }
+
+  // these are not Node/Edge types but rather property types we are checking
+  for (RDGCore* core : cores) {
+    KATANA_CHECKED(core->EnsureNodeTypesLoaded());
+    KATANA_CHECKED(core->EnsureEdgeTypesLoaded());
+  }
+
+  KATANA_CHECKED(add_partition_metadata(metadata_dir, cores, &grp));
+  KATANA_CHECKED(grp.Finish());
+
+  return std::vector<RDGSlice>(std::move(rdg_slices));
+}
+
+katana::Result<std::vector<katana::RDGSlice::SliceArg>>
+katana::RDGSlice::ComputeSliceArgs(
+    RDGHandle handle, uint32_t num_slices, uint32_t partition_id) {
+  if (num_slices == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "num_slices must be positive");
+  }
+
+  // balance nodes plus edges; boundaries are found by binary search since
+  // that cost is monotone in the node index
+  auto balanced = [num_slices](
+                      uint64_t num_nodes, uint64_t num_edges,
+                      const std::function<uint64_t(uint64_t)>& edges_before)
+      -> katana::Result<std::vector<uint64_t>> {
+    uint64_t total = num_nodes + num_edges;
+    std::vector<uint64_t> boundaries{0};
+    for (uint32_t i = 1; i < num_slices; ++i) {
+      uint64_t target = total * i / num_slices;
+      uint64_t lo = boundaries.back();
+      uint64_t hi = num_nodes;
+      while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (mid + edges_before(mid) < target) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      boundaries.emplace_back(lo);
+    }
+    boundaries.emplace_back(num_nodes);
+    return boundaries;
+  };
+
+  return MakeSliceArgs(handle, partition_id, balanced);
+}
+
+katana::Result<std::vector<katana::RDGSlice::SliceArg>>
+katana::RDGSlice::ComputeSliceArgs(
+    RDGHandle handle, const std::vector<uint64_t>& node_boundaries,
+    uint32_t partition_id) {
+  auto given = [&node_boundaries](
+                   uint64_t num_nodes, uint64_t,
+                   const std::function<uint64_t(uint64_t)>&)
+      -> katana::Result<std::vector<uint64_t>> {
+    if (node_boundaries.size() < 2 || node_boundaries.front() != 0 ||
+        node_boundaries.back() != num_nodes ||
+        !std::is_sorted(node_boundaries.begin(), node_boundaries.end())) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "node boundaries must go from 0 to {} in non-decreasing order",
+          num_nodes);
+    }
+    return node_boundaries;
+  };
+
+  return MakeSliceArgs(handle, partition_id, given);
+}
+
+katana::Result<std::vector<katana::RDGSlice::SliceArg>>
+katana::RDGSlice::MakeSliceArgs(
+    RDGHandle handle, uint32_t partition_id,
+    const BoundariesFunc& compute_boundaries) {
+  const RDGManifest& manifest = handle.impl_->rdg_manifest();
+  auto part_header = KATANA_CHECKED(
+      RDGPartHeader::Make(manifest.PartitionFileName(partition_id)));
+  RDGCore core(std::move(part_header));
+  KATANA_CHECKED(core.MakeTopologyManager(manifest.dir()));
+
+  katana::RDGTopology shadow = katana::RDGTopology::MakeShadowCSR();
+  katana::RDGTopology* topo =
+      KATANA_CHECKED(core.topology_manager().GetTopology(shadow));
+  katana::URI topo_path = manifest.dir().Join(topo->path());
+  auto [num_nodes, num_edges] =
+      KATANA_CHECKED(read_sliceable_topology_header(topo_path));
+
+  // out_indices[n] is one past the last edge of node n
+  katana::FileView out_indices_view;
+  KATANA_CHECKED(out_indices_view.Bind(
+      topo_path.string(), kTopologyHeaderSize,
+      kTopologyHeaderSize + num_nodes * sizeof(uint64_t), true));
+  const auto* out_indices = out_indices_view.ptr<uint64_t>();
+  std::function<uint64_t(uint64_t)> edges_before =
+      [out_indices](uint64_t node) -> uint64_t {
+    return node == 0 ? 0 : out_indices[node - 1];
+  };
+
+  std::vector<uint64_t> boundaries =
+      KATANA_CHECKED(compute_boundaries(num_nodes, num_edges, edges_before));
+
+  std::vector<SliceArg> slice_args;
+  for (size_t i = 0; i + 1 < boundaries.size(); ++i) {
+    uint64_t node_begin = boundaries[i];
+    uint64_t node_end = boundaries[i + 1];
+    uint64_t edge_begin = edges_before(node_begin);
+    uint64_t edge_end = edges_before(node_end);
+    uint64_t topo_off = kTopologyHeaderSize + node_begin * sizeof(uint64_t);
+    uint64_t dests_off = kTopologyHeaderSize + num_nodes * sizeof(uint64_t);
+    slice_args.emplace_back(SliceArg{
+        .node_range = std::make_pair(node_begin, node_end),
+        .edge_range = std::make_pair(edge_begin, edge_end),
+        .topo_off = topo_off,
+        .topo_size = dests_off + edge_end * sizeof(uint32_t) - topo_off,
+    });
+  }
+
+  return slice_args;
+}
+
 katana::Result<std::pair<std::vector<size_t>, std::vector<size_t>>>
 katana::RDGSlice::GetPerPartitionCounts(RDGHandle handle) {
   katana::URI part_0_part_file =
@@ -1,7 +1,10 @@
 #include "katana/RDGTopology.h"
 
+#include <algorithm>
+#include <future>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 
@@ -11,6 +14,7 @@
 #include "PartitionTopologyMetadata.h"
 #include "RDGPartHeader.h"
 #include "katana/EntityTypeManager.h"
+#include "katana/Env.h"
 #include "katana/ErrorCode.h"
 #include "katana/FaultTest.h"
 #include "katana/FileFrame.h"
@@ -22,6 +26,128 @@
 #include "katana/config.h"
 #include "katana/tsuba.h"
 
+namespace {
+
+/// Little endian base 128, 7 bits per byte with the high bit set on all but
+/// the last byte
+void
+AppendVarint(uint64_t val, std::vector<uint8_t>* out) {
+  while (val >= 0x80) {
+    out->emplace_back(static_cast<uint8_t>(val | 0x80));
+    val >>= 7;
+  }
+  out->emplace_back(static_cast<uint8_t>(val));
+}
+
+/// \returns the position after the decoded value, or nullptr if the value
+/// runs past end
+const uint8_t*
+ReadVarint(const uint8_t* pos, const uint8_t* end, uint64_t* val) {
+  uint64_t result = 0;
+  for (uint32_t shift = 0; pos < end && shift < 64; shift += 7) {
+    uint8_t byte = *pos++;
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *val = result;
+      return pos;
+    }
+  }
+  return nullptr;
+}
+
+/// An array encoded as varint deltas from the previous entry, restarting from
+/// zero every block_size entries. Zigzag encoding maps negative deltas to
+/// small unsigned values for arrays that are not sorted
+struct DeltaEncoding {
+  std::vector<uint64_t> block_offsets;
+  std::vector<uint8_t> bytes;
+};
+
+template <typename T>
+DeltaEncoding
+EncodeDeltas(const T* vals, uint64_t size, uint64_t block_size, bool zigzag) {
+  DeltaEncoding enc;
+  enc.block_offsets.reserve((size + block_size - 1) / block_size);
+  // most deltas fit in a couple of bytes
+  enc.bytes.reserve(size * 2);
+
+  int64_t prev = 0;
+  for (uint64_t i = 0; i < size; ++i) {
+    if (i % block_size == 0) {
+      enc.block_offsets.emplace_back(enc.bytes.size());
+      prev = 0;
+    }
+    int64_t delta = static_cast<int64_t>(vals[i]) - prev;
+    prev = static_cast<int64_t>(vals[i]);
+    uint64_t encoded = zigzag ? (static_cast<uint64_t>(delta) << 1) ^
+                                    static_cast<uint64_t>(delta >> 63)
+                              : static_cast<uint64_t>(delta);
+    AppendVarint(encoded, &enc.bytes);
+  }
+  return enc;
+}
+
+/// Decode an array written by EncodeDeltas into out, whose values must all
+/// be less than limit. Blocks are independent, so large arrays are decoded by
+/// several threads
+template <typename T>
+katana::Result<void>
+DecodeDeltas(
+    const uint8_t* bytes, uint64_t num_bytes, const uint64_t* block_offsets,
+    uint64_t size, uint64_t block_size, bool zigzag, uint64_t limit, T* out) {
+  uint64_t num_blocks = (size + block_size - 1) / block_size;
+
+  auto decode_blocks = [=](uint64_t begin, uint64_t end) -> bool {
+    for (uint64_t b = begin; b < end; ++b) {
+      uint64_t block_end =
+          b + 1 < num_blocks ? block_offsets[b + 1] : num_bytes;
+      if (block_offsets[b] > block_end || block_end > num_bytes) {
+        return false;
+      }
+      const uint8_t* pos = bytes + block_offsets[b];
+      const uint8_t* stop = bytes + block_end;
+      int64_t prev = 0;
+      for (uint64_t i = b * block_size, n = std::min(size, i + block_size);
+           i < n; ++i) {
+        uint64_t encoded = 0;
+        pos = ReadVarint(pos, stop, &encoded);
+        if (pos == nullptr) {
+          return false;
+        }
+        int64_t delta = zigzag ? static_cast<int64_t>(encoded >> 1) ^
+                                     -static_cast<int64_t>(encoded & 1)
+                               : static_cast<int64_t>(encoded);
+        prev += delta;
+        if (prev < 0 || static_cast<uint64_t>(prev) >= limit) {
+          return false;
+        }
+        out[i] = static_cast<T>(prev);
+      }
+    }
+    return true;
+  };
+
+  uint64_t num_tasks = std::min<uint64_t>(
+      std::max(std::thread::hardware_concurrency(), 1U), num_blocks);
+  std::vector<std::future<bool>> tasks;
+  for (uint64_t t = 1; t < num_tasks; ++t) {
+    tasks.emplace_back(std::async(
+        std::launch::async, decode_blocks, num_blocks * t / num_tasks,
+        num_blocks * (t + 1) / num_tasks));
+  }
+  bool ok = decode_blocks(0, num_blocks / std::max<uint64_t>(num_tasks, 1));
+  for (auto& task : tasks) {
+    ok = task.get() && ok;
+  }
+  if (!ok) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "corrupt compressed topology");
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
 std::string
 katana::RDGTopology::path() const {
   if (metadata_entry_valid()) {
@@ -107,6 +233,12 @@ katana::RDGTopology::Bind(
 
 katana::Result<void>
 katana::RDGTopology::Map() {
+  if (file_store_partial_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "topology bound by section must be unbound before it is mapped");
+  }
+
   if (file_store_mapped_) {
     return katana::ResultSuccess();
   }
@@ -127,10 +259,11 @@ katana::RDGTopology::Map() {
         file_storage_.size(), min_size);
   }
 
-  if (data[0] != 1) {
+  if (data[0] != kUncompressedVersion && data[0] != kCompressedVersion) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument,
-        "first entry in the topology data array must be 1, is {}", data[0]);
+        "first entry in the topology data array must be 1 or 2, is {}",
+        data[0]);
   }
 
   // ensure the data file matches the metadata
@@ -141,8 +274,6 @@ katana::RDGTopology::Map() {
       num_edges_ == data[3], "expected {} edges, found {} edges", num_edges_,
       data[3]);
 
-  adj_indices_ = &data[4];
-
   //TODO(emcginnis): this cursor stuff is gross and easy to mess up.
   // Could introduce a byte iterator, with all usual iterator input stuff.
   // Iterator is initialized with what byte alignment we would like to keep
@@ -150,22 +281,30 @@ katana::RDGTopology::Map() {
   // as well as something like
   // AdvanceBy<T> which advances the cursor in the iterator by sizeof(T)
   // all of the padding math then gets wrapped up in the iterator
-  const uint64_t* cursor = adj_indices_;
+  const uint64_t* cursor = &data[4];
   const uint64_t magic = (num_nodes_ + num_edges_);
+  bool compressed = data[0] == kCompressedVersion;
+
+  if (compressed) {
+    cursor = KATANA_CHECKED(MapCompressed(
+        cursor, data + file_storage_.size() / sizeof(uint64_t)));
+  } else {
+    adj_indices_ = cursor;
+
+    uint64_t adj_indices_size = num_nodes_;
+    // EdgeTypeAwareTopologies have a larger adj_indices array than usual topologies
+    if (topology_state_ ==
+        katana::RDGTopology::TopologyKind::kEdgeTypeAwareTopology) {
+      adj_indices_size =
+          std::max(num_nodes_, num_nodes_ * edge_condensed_type_id_map_size_);
+    }
 
-  uint64_t adj_indices_size = num_nodes_;
-  // EdgeTypeAwareTopologies have a larger adj_indices array than usual topologies
-  if (topology_state_ ==
-      katana::RDGTopology::TopologyKind::kEdgeTypeAwareTopology) {
-    adj_indices_size =
-        std::max(num_nodes_, num_nodes_ * edge_condensed_type_id_map_size_);
-  }
-
-  cursor += adj_indices_size;
+    cursor += adj_indices_size;
 
-  dests_ = reinterpret_cast<const uint32_t*>(cursor);
+    dests_ = reinterpret_cast<const uint32_t*>(cursor);
 
-  cursor += (num_edges_ / 2 + num_edges_ % 2);
+    cursor += (num_edges_ / 2 + num_edges_ % 2);
+  }
 
   if (metadata_entry_->edge_index_to_property_index_map_present_) {
     KATANA_LOG_VASSERT(
@@ -211,7 +350,9 @@ katana::RDGTopology::Map() {
          FileFrame::calculate_padding_bytes(num_nodes_, sizeof(uint64_t)));
   }
 
-  size_t expected_size = GetGraphSize();
+  // the compressed sections are smaller than GetGraphSize assumes
+  size_t expected_size =
+      compressed ? (cursor - data) * sizeof(uint64_t) : GetGraphSize();
   if (file_storage_.size() < expected_size) {
     return KATANA_ERROR(
         katana::ErrorCode::InvalidArgument,
@@ -233,6 +374,199 @@ katana::RDGTopology::Map() {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::RDGTopology::BindSections(const katana::URI& metadata_dir) {
+  if (topology_state_ ==
+      katana::RDGTopology::TopologyKind::kEdgeTypeAwareTopology) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "EdgeTypeAwareTopologies cannot be bound by section");
+  }
+
+  KATANA_CHECKED(unbind_file_storage());
+  const uint64_t header_size = adj_indices_offset * sizeof(uint64_t);
+  KATANA_CHECKED(Bind(metadata_dir, 0, header_size, true));
+
+  if (file_storage_.size() < header_size) {
+    KATANA_CHECKED(unbind_file_storage());
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "file_storage size {} is less than the header size {}",
+        file_storage_.size(), header_size);
+  }
+
+  const auto* data = file_storage_.ptr<uint64_t>();
+  if (data[version_num_offset] != kUncompressedVersion) {
+    uint64_t version = data[version_num_offset];
+    KATANA_CHECKED(unbind_file_storage());
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "only uncompressed topology files can be bound by section, found "
+        "version {}",
+        version);
+  }
+
+  KATANA_LOG_VASSERT(
+      num_nodes_ == data[num_nodes_offset_],
+      "expected {} nodes, found {} nodes", num_nodes_, data[num_nodes_offset_]);
+  KATANA_LOG_VASSERT(
+      num_edges_ == data[num_edges_offset_],
+      "expected {} edges, found {} edges", num_edges_, data[num_edges_offset_]);
+
+  // same layout as Map, but only the magic numbers are read
+  const uint64_t* cursor = &data[adj_indices_offset];
+  const uint64_t magic = (num_nodes_ + num_edges_);
+
+  adj_indices_ = cursor;
+  cursor += num_nodes_;
+  dests_ = reinterpret_cast<const uint32_t*>(cursor);
+  cursor += (num_edges_ / 2 + num_edges_ % 2);
+
+  if (metadata_entry_->edge_index_to_property_index_map_present_) {
+    KATANA_CHECKED(FillBytes(cursor, sizeof(uint64_t)));
+    KATANA_LOG_VASSERT(
+        *cursor == magic, "expected magic number = {}, found {}", magic,
+        *cursor);
+    cursor += 1;
+    edge_index_to_property_index_map_ = cursor;
+    cursor += num_edges_;
+  }
+
+  if (metadata_entry_->node_index_to_property_index_map_present_) {
+    KATANA_CHECKED(FillBytes(cursor, sizeof(uint64_t)));
+    KATANA_LOG_VASSERT(
+        *cursor == magic, "expected magic number = {}, found {}", magic,
+        *cursor);
+    cursor += 1;
+    node_index_to_property_index_map_ = cursor;
+    cursor += num_nodes_;
+  }
+
+  if (file_storage_.size() < (cursor - data) * sizeof(uint64_t)) {
+    KATANA_CHECKED(unbind_file_storage());
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "file_view size: {} is too small for {} nodes and {} edges",
+        file_storage_.size(), num_nodes_, num_edges_);
+  }
+
+  file_store_mapped_ = true;
+  file_store_partial_ = true;
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::RDGTopology::FillNodes(
+    uint64_t begin, uint64_t end, bool property_maps) {
+  if (!file_store_partial_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "topology was not bound by section");
+  }
+  if (begin > end || end > num_nodes_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "node range [{}, {}) out of bounds {}",
+        begin, end, num_nodes_);
+  }
+  if (begin == end) {
+    return katana::ResultSuccess();
+  }
+
+  uint64_t adj_begin = begin > 0 ? begin - 1 : 0;
+  KATANA_CHECKED(FillBytes(
+      adj_indices_ + adj_begin, (end - adj_begin) * sizeof(uint64_t)));
+  if (property_maps && node_index_to_property_index_map_ != nullptr) {
+    KATANA_CHECKED(FillBytes(
+        node_index_to_property_index_map_ + begin,
+        (end - begin) * sizeof(uint64_t)));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::RDGTopology::FillEdges(
+    uint64_t begin, uint64_t end, bool property_maps) {
+  if (!file_store_partial_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "topology was not bound by section");
+  }
+  if (begin > end || end > num_edges_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "edge range [{}, {}) out of bounds {}",
+        begin, end, num_edges_);
+  }
+  if (begin == end) {
+    return katana::ResultSuccess();
+  }
+
+  KATANA_CHECKED(
+      FillBytes(dests_ + begin, (end - begin) * sizeof(uint32_t)));
+  if (property_maps && edge_index_to_property_index_map_ != nullptr) {
+    KATANA_CHECKED(FillBytes(
+        edge_index_to_property_index_map_ + begin,
+        (end - begin) * sizeof(uint64_t)));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::RDGTopology::ReleaseNodes(uint64_t begin, uint64_t end) {
+  if (!file_store_partial_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "topology was not bound by section");
+  }
+  if (begin > end || end > num_nodes_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "node range [{}, {}) out of bounds {}",
+        begin, end, num_nodes_);
+  }
+
+  KATANA_CHECKED(
+      ReleaseBytes(adj_indices_ + begin, (end - begin) * sizeof(uint64_t)));
+  if (node_index_to_property_index_map_ != nullptr) {
+    KATANA_CHECKED(ReleaseBytes(
+        node_index_to_property_index_map_ + begin,
+        (end - begin) * sizeof(uint64_t)));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::RDGTopology::ReleaseEdges(uint64_t begin, uint64_t end) {
+  if (!file_store_partial_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "topology was not bound by section");
+  }
+  if (begin > end || end > num_edges_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "edge range [{}, {}) out of bounds {}",
+        begin, end, num_edges_);
+  }
+
+  KATANA_CHECKED(
+      ReleaseBytes(dests_ + begin, (end - begin) * sizeof(uint32_t)));
+  if (edge_index_to_property_index_map_ != nullptr) {
+    KATANA_CHECKED(ReleaseBytes(
+        edge_index_to_property_index_map_ + begin,
+        (end - begin) * sizeof(uint64_t)));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::RDGTopology::FillBytes(const void* start, uint64_t size) {
+  uint64_t offset = static_cast<const uint8_t*>(start) -
+                    file_storage_.ptr<uint8_t>();
+  return file_storage_.Fill(offset, offset + size, true);
+}
+
+katana::Result<void>
+katana::RDGTopology::ReleaseBytes(const void* start, uint64_t size) {
+  uint64_t offset = static_cast<const uint8_t*>(start) -
+                    file_storage_.ptr<uint8_t>();
+  return file_storage_.Release(offset, offset + size);
+}
+
 katana::Result<void>
 katana::RDGTopology::MapMetadataExtract(
     uint64_t num_nodes, uint64_t num_edges, bool storage_valid) {
@@ -256,7 +590,7 @@ katana::RDGTopology::MapMetadataExtract(
     return katana::ErrorCode::InvalidArgument;
   }
 
-  if (data[0] != 1) {
+  if (data[0] != kUncompressedVersion && data[0] != kCompressedVersion) {
     return katana::ErrorCode::InvalidArgument;
   }
 
@@ -291,6 +625,140 @@ katana::RDGTopology::MapMetadataExtract(
   return katana::ResultSuccess();
 }
 
+katana::Result<const uint64_t*>
+katana::RDGTopology::MapCompressed(
+    const uint64_t* cursor, const uint64_t* end) {
+  auto blocks = [](uint64_t size) {
+    return size / kCompressedBlockSize + (size % kCompressedBlockSize != 0);
+  };
+  // sections are written with FileFrame::PaddedWrite
+  auto words = [](uint64_t bytes) {
+    return bytes / sizeof(uint64_t) + (bytes % sizeof(uint64_t) != 0);
+  };
+  auto truncated = [&]() {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "compressed topology file is truncated");
+  };
+  auto remaining = [&]() { return static_cast<uint64_t>(end - cursor); };
+
+  // StoreCompressed writes the adj_indices that the topology holds, which
+  // for an EdgeTypeAwareTopology is one per node and edge type
+  uint64_t stored_adj_indices_size = num_nodes_;
+  uint64_t adj_indices_size = num_nodes_;
+  if (topology_state_ == TopologyKind::kEdgeTypeAwareTopology) {
+    stored_adj_indices_size = num_nodes_ * edge_condensed_type_id_map_size_;
+    adj_indices_size = std::max(num_nodes_, stored_adj_indices_size);
+  }
+
+  if (cursor > end || remaining() < 2) {
+    return truncated();
+  }
+  if (cursor[0] != stored_adj_indices_size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "compressed topology has {} adj_indices, expected {}", cursor[0],
+        stored_adj_indices_size);
+  }
+  uint64_t adj_bytes = cursor[1];
+  cursor += 2;
+  if (remaining() < blocks(stored_adj_indices_size)) {
+    return truncated();
+  }
+  const uint64_t* adj_block_offsets = cursor;
+  cursor += blocks(stored_adj_indices_size);
+
+  if (remaining() < 1) {
+    return truncated();
+  }
+  uint64_t dests_bytes = cursor[0];
+  cursor += 1;
+  if (remaining() < blocks(num_edges_)) {
+    return truncated();
+  }
+  const uint64_t* dests_block_offsets = cursor;
+  cursor += blocks(num_edges_);
+
+  if (remaining() < words(adj_bytes)) {
+    return truncated();
+  }
+  const auto* adj_data = reinterpret_cast<const uint8_t*>(cursor);
+  cursor += words(adj_bytes);
+
+  if (remaining() < words(dests_bytes)) {
+    return truncated();
+  }
+  const auto* dests_data = reinterpret_cast<const uint8_t*>(cursor);
+  cursor += words(dests_bytes);
+
+  // The whole topology is decoded here rather than on first access, since
+  // GraphTopology copies adj_indices and dests out of an RDGTopology as
+  // soon as it is loaded anyway
+  decoded_adj_indices_.resize(adj_indices_size);
+  KATANA_CHECKED_CONTEXT(
+      DecodeDeltas(
+          adj_data, adj_bytes, adj_block_offsets, stored_adj_indices_size,
+          kCompressedBlockSize, false, num_edges_ + 1,
+          decoded_adj_indices_.data()),
+      "decoding adj_indices");
+  // Readers of a topology without edge types expect one index per node
+  std::fill(
+      decoded_adj_indices_.begin() + stored_adj_indices_size,
+      decoded_adj_indices_.end(), num_edges_);
+
+  decoded_dests_.resize(num_edges_);
+  KATANA_CHECKED_CONTEXT(
+      DecodeDeltas(
+          dests_data, dests_bytes, dests_block_offsets, num_edges_,
+          kCompressedBlockSize, true, num_nodes_, decoded_dests_.data()),
+      "decoding dests");
+
+  adj_indices_ = decoded_adj_indices_.data();
+  dests_ = decoded_dests_.data();
+  return cursor;
+}
+
+katana::Result<void>
+katana::RDGTopology::StoreCompressed(
+    FileFrame* ff, uint64_t adj_indices_size) const {
+  KATANA_LOG_VASSERT(
+      adj_indices_ != nullptr || adj_indices_size == 0,
+      "Cannot store an RDGTopology with nodes and null adj_indices");
+  KATANA_LOG_VASSERT(
+      dests_ != nullptr || num_edges_ == 0,
+      "Cannot store an RDGTopology with null dests_");
+
+  DeltaEncoding adj = EncodeDeltas(
+      adj_indices_, adj_indices_size, kCompressedBlockSize, false);
+  DeltaEncoding dests =
+      EncodeDeltas(dests_, num_edges_, kCompressedBlockSize, true);
+
+  KATANA_LOG_DEBUG(
+      "Storing compressed RDGTopology: adj_indices {} -> {} bytes, dests {} "
+      "-> {} bytes",
+      adj_indices_size * sizeof(uint64_t), adj.bytes.size(),
+      num_edges_ * sizeof(uint32_t), dests.bytes.size());
+
+  uint64_t adj_header[2] = {adj_indices_size, adj.bytes.size()};
+  KATANA_CHECKED(ff->Write(adj_header, sizeof(adj_header)));
+  KATANA_CHECKED(ff->Write(
+      adj.block_offsets.data(), adj.block_offsets.size() * sizeof(uint64_t)));
+
+  uint64_t dests_bytes = dests.bytes.size();
+  KATANA_CHECKED(ff->Write(&dests_bytes, sizeof(dests_bytes)));
+  KATANA_CHECKED(ff->Write(
+      dests.block_offsets.data(),
+      dests.block_offsets.size() * sizeof(uint64_t)));
+
+  KATANA_CHECKED_CONTEXT(
+      ff->PaddedWrite(adj.bytes.data(), adj.bytes.size(), sizeof(uint64_t)),
+      "Failed to write compressed adj_indices to file frame");
+  KATANA_CHECKED_CONTEXT(
+      ff->PaddedWrite(
+          dests.bytes.data(), dests.bytes.size(), sizeof(uint64_t)),
+      "Failed to write compressed dests to file frame");
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::RDGTopology::DoStore(
     RDGHandle handle, const katana::URI& current_rdg_dir,
@@ -305,16 +773,38 @@ katana::RDGTopology::DoStore(
         "EdgeSortKind={}, NodeSortKind={}",
         topology_state_, transpose_state_, edge_sort_state_, node_sort_state_);
 
+    //TODO: emcginnis need different naming schemes for the optional topologies?
+    // add "epi_npi_eti_nti" to name?
+    katana::URI path_uri = MakeTopologyFileName(handle);
+
+    // upload parts while later sections are written rather than holding a
+    // copy of the whole topology
     auto ff = std::make_unique<katana::FileFrame>();
     KATANA_CHECKED(ff->Init());
+    ff->Bind(path_uri.string());
+    KATANA_CHECKED(ff->StartUpload());
 
-    uint64_t data[4] = {1, 0, num_nodes_, num_edges_};
+    bool compress = false;
+    katana::GetEnv("KATANA_TOPOLOGY_COMPRESSION", &compress);
+
+    uint64_t data[4] = {
+        compress ? kCompressedVersion : kUncompressedVersion, 0, num_nodes_,
+        num_edges_};
     arrow::Status aro_sts = ff->Write(&data, 4 * sizeof(uint64_t));
     if (!aro_sts.ok()) {
       return katana::ArrowToKatana(aro_sts.code());
     }
 
-    if (num_nodes_) {
+    if (compress) {
+      uint64_t adj_indices_size = num_nodes_;
+      if (topology_state_ ==
+          katana::RDGTopology::TopologyKind::kEdgeTypeAwareTopology) {
+        adj_indices_size = num_nodes_ * edge_condensed_type_id_map_size_;
+      }
+      KATANA_CHECKED(StoreCompressed(ff.get(), adj_indices_size));
+    }
+
+    if (!compress && num_nodes_) {
       if (edge_condensed_type_id_map_size_ > 0) {
         KATANA_LOG_VASSERT(
             adj_indices_ != nullptr,
@@ -343,7 +833,7 @@ katana::RDGTopology::DoStore(
       }
     }
 
-    if (num_edges_) {
+    if (!compress && num_edges_) {
       KATANA_LOG_VASSERT(
           dests_ != nullptr, "Cannot store an RDGTopology with null dests_");
       const auto* raw = dests_;
@@ -452,10 +942,6 @@ katana::RDGTopology::DoStore(
           "Failed to write node_condensed_type_id_map to file frame");
     }
 
-    //TODO: emcginnis need different naming schemes for the optional topologies?
-    // add "epi_npi_eti_nti" to name?
-    katana::URI path_uri = MakeTopologyFileName(handle);
-    ff->Bind(path_uri.string());
     TSUBA_PTP(internal::FaultSensitivity::Normal);
     write_group->StartStore(std::move(ff));
     TSUBA_PTP(internal::FaultSensitivity::Normal);
@@ -476,6 +962,7 @@ katana::RDGTopology::DoStore(
         node_condensed_type_id_map_size_,
         (node_condensed_type_id_map_ != nullptr), topology_state_,
         transpose_state_, edge_sort_state_, node_sort_state_);
+    metadata_entry_->edge_sort_property_ = edge_sort_property_;
   }
 
   else if (path().empty()) {
@@ -541,7 +1028,8 @@ katana::RDGTopology::Equals(const RDGTopology& other) const {
       topology_state_ == other.topology_state_ &&
       transpose_state_ == other.transpose_state_ &&
       edge_sort_state_ == other.edge_sort_state_ &&
-      node_sort_state_ == other.node_sort_state_);
+      node_sort_state_ == other.node_sort_state_ &&
+      edge_sort_property_ == other.edge_sort_property_);
 }
 
 katana::RDGTopology
@@ -549,13 +1037,15 @@ katana::RDGTopology::MakeShadow(
     katana::RDGTopology::TopologyKind topology_state,
     katana::RDGTopology::TransposeKind transpose_state,
     katana::RDGTopology::EdgeSortKind edge_sort_state,
-    katana::RDGTopology::NodeSortKind node_sort_state) {
+    katana::RDGTopology::NodeSortKind node_sort_state,
+    const std::string& edge_sort_property) {
   RDGTopology topo = RDGTopology();
 
   topo.topology_state_ = topology_state;
   topo.transpose_state_ = transpose_state;
   topo.edge_sort_state_ = edge_sort_state;
   topo.node_sort_state_ = node_sort_state;
+  topo.edge_sort_property_ = edge_sort_property;
   return RDGTopology(std::move(topo));
 }
 
@@ -706,6 +1196,7 @@ katana::RDGTopology::Make(katana::PartitionTopologyMetadataEntry* entry) {
   topo.transpose_state_ = topo.metadata_entry_->transpose_state_;
   topo.edge_sort_state_ = topo.metadata_entry_->edge_sort_state_;
   topo.node_sort_state_ = topo.metadata_entry_->node_sort_state_;
+  topo.edge_sort_property_ = topo.metadata_entry_->edge_sort_property_;
   topo.edge_condensed_type_id_map_size_ =
       topo.metadata_entry_->edge_condensed_type_id_map_size_;
   topo.node_condensed_type_id_map_size_ =
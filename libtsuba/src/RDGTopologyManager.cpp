@@ -26,6 +26,8 @@ katana::RDGTopologyManager::GetTopology(const katana::RDGTopology& shadow) {
          shadow.transpose_state() == RDGTopology::TransposeKind::kAny) &&
         shadow.edge_sort_state() == topology_set_.at(i).edge_sort_state() &&
         shadow.node_sort_state() == topology_set_.at(i).node_sort_state() &&
+        shadow.edge_sort_property() ==
+            topology_set_.at(i).edge_sort_property() &&
         !topology_set_.at(i).invalid()) {
       KATANA_LOG_DEBUG(
           "Found topology matching shadow, num_topologies_ = {}",
@@ -2,6 +2,7 @@
 #define KATANA_LIBTSUBA_RDGTOPOLOGYMANAGER_H_
 
 #include <cstddef>
+#include <string>
 
 #include "PartitionTopologyMetadata.h"
 #include "RDGPartHeader.h"
@@ -37,6 +38,29 @@ public:
     return;
   }
 
+  /// mark every topology but the CSR superseded, e.g. after the edges of the
+  /// graph changed, so it is neither found nor stored again
+  void InvalidateDerivedTopologies() {
+    for (size_t i = 0; i < num_topologies_; i++) {
+      if (topology_set_.at(i).topology_state() !=
+          RDGTopology::TopologyKind::kCSR) {
+        topology_set_.at(i).set_invalid();
+      }
+    }
+  }
+
+  /// mark the topologies sorted by the edge property name superseded, e.g.
+  /// after the property changed, so they are neither found nor stored again
+  void InvalidateTopologiesSortedBy(const std::string& name) {
+    for (size_t i = 0; i < num_topologies_; i++) {
+      if (topology_set_.at(i).edge_sort_state() ==
+              RDGTopology::EdgeSortKind::kSortedByEdgeProperty &&
+          topology_set_.at(i).edge_sort_property() == name) {
+        topology_set_.at(i).set_invalid();
+      }
+    }
+  }
+
   /// add a RDGTopology to the manager
   void Append(RDGTopology topo) {
     KATANA_LOG_VASSERT(
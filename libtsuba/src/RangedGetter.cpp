@@ -0,0 +1,354 @@
+#include "katana/RangedGetter.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "katana/Logging.h"
+
+namespace {
+
+/// Weight of the latest part in the typical part latency
+constexpr double kLatencyWeight = 0.2;
+
+katana::CopyableResult<void>
+MakeError(
+    katana::ErrorInfo&& error, const std::string& uri, uint64_t start,
+    uint64_t size) {
+  return katana::CopyableErrorInfo{error.WithContext(
+      "getting {} bytes at {} of {}", size, start, uri)};
+}
+
+}  // namespace
+
+struct katana::RangedGetter::Part {
+  uint64_t offset;
+  uint64_t size;
+  /// A request for the part succeeded, or the part is given up on
+  bool done{false};
+  bool hedged{false};
+  uint32_t attempts_in_flight{0};
+  /// When the first request for the part started
+  std::chrono::steady_clock::time_point start;
+};
+
+struct katana::RangedGetter::Call {
+  std::string uri;
+  uint64_t start;
+  uint8_t* buf;
+  bool hedging;
+  std::vector<Part> parts;
+  size_t unresolved;
+  bool failed{false};
+  katana::CopyableResult<void> result{katana::CopyableResultSuccess()};
+  std::promise<katana::CopyableResult<void>> promise;
+};
+
+katana::RangedGetter::RangedGetter(GetRangeFn get_range, const Options& options)
+    : get_range_(std::move(get_range)),
+      options_(options),
+      concurrency_(std::clamp(
+          options.initial_concurrency, options.min_concurrency,
+          options.max_concurrency)),
+      window_start_(std::chrono::steady_clock::now()) {
+  KATANA_LOG_VASSERT(
+      options_.part_size > 0 && options_.max_attempts > 0 &&
+          options_.min_concurrency > 0 &&
+          options_.min_concurrency <= options_.max_concurrency,
+      "invalid ranged getter options");
+  for (uint32_t i = 0; i < options_.max_concurrency; ++i) {
+    workers_.emplace_back([this] { Work(); });
+  }
+  if (options_.hedge_multiple > 0) {
+    monitor_ = std::thread([this] { Monitor(); });
+  }
+}
+
+katana::RangedGetter::~RangedGetter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  work_cv_.notify_all();
+  monitor_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  if (monitor_.joinable()) {
+    monitor_.join();
+  }
+}
+
+katana::Result<void>
+katana::RangedGetter::Get(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  if (auto res = GetAsync(uri, start, size, result_buf).get(); !res) {
+    return res.error();
+  }
+  return katana::ResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+katana::RangedGetter::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  auto call = std::make_shared<Call>();
+  call->uri = uri;
+  call->start = start;
+  call->buf = result_buf;
+  call->hedging = options_.hedge_multiple > 0;
+  for (uint64_t off = 0; off < size; off += options_.part_size) {
+    call->parts.emplace_back(
+        Part{off, std::min(options_.part_size, size - off)});
+  }
+  call->unresolved = call->parts.size();
+  auto future = call->promise.get_future();
+  if (call->parts.empty()) {
+    call->promise.set_value(katana::CopyableResultSuccess());
+    return future;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Time spent idle says nothing about how many requests to have in flight
+    if (active_ == 0 && queue_.empty()) {
+      window_start_ = std::chrono::steady_clock::now();
+      window_bytes_ = 0;
+      window_parts_ = 0;
+    }
+    for (size_t i = 0; i < call->parts.size(); ++i) {
+      queue_.emplace_back(Attempt{call, i, false});
+    }
+  }
+  work_cv_.notify_all();
+  return future;
+}
+
+katana::RangedGetter::Stats
+katana::RangedGetter::GetStats() const {
+  return Stats{
+      parts_.load(std::memory_order_relaxed),
+      retries_.load(std::memory_order_relaxed),
+      hedges_.load(std::memory_order_relaxed),
+      hedge_wins_.load(std::memory_order_relaxed),
+  };
+}
+
+void
+katana::RangedGetter::Work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    // Hedges go ahead of the concurrency limit since they are for requests
+    // that hold a slot without making progress
+    work_cv_.wait(lock, [this] {
+      return (stopping_ && queue_.empty()) ||
+             (!queue_.empty() &&
+              (stopping_ || queue_.front().is_hedge ||
+               active_ < concurrency_.load(std::memory_order_relaxed)));
+    });
+    if (queue_.empty()) {
+      return;
+    }
+    Attempt attempt = std::move(queue_.front());
+    queue_.pop_front();
+    Call& call = *attempt.call;
+    Part& part = call.parts[attempt.part];
+    if (part.done) {
+      continue;
+    }
+    if (call.failed && part.attempts_in_flight == 0) {
+      // Give up on the rest of a failed get
+      part.done = true;
+      if (--call.unresolved == 0) {
+        lock.unlock();
+        call.promise.set_value(call.result);
+        lock.lock();
+      }
+      continue;
+    }
+    ++active_;
+    ++part.attempts_in_flight;
+    if (!attempt.is_hedge) {
+      part.start = std::chrono::steady_clock::now();
+      in_flight_.emplace_back(attempt);
+    }
+    lock.unlock();
+    Run(attempt);
+    lock.lock();
+    --active_;
+    work_cv_.notify_one();
+  }
+}
+
+void
+katana::RangedGetter::Monitor() {
+  auto interval = std::max(
+      std::chrono::milliseconds(1), options_.min_hedge_delay / 4);
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    monitor_cv_.wait_for(lock, interval);
+    if (typical_latency_ == 0) {
+      continue;
+    }
+    auto threshold = std::max<std::chrono::steady_clock::duration>(
+        options_.min_hedge_delay,
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(
+                options_.hedge_multiple * typical_latency_)));
+    auto now = std::chrono::steady_clock::now();
+    bool hedged = false;
+    for (const auto& attempt : in_flight_) {
+      Part& part = attempt.call->parts[attempt.part];
+      if (part.done || part.hedged || attempt.call->failed ||
+          now - part.start < threshold) {
+        continue;
+      }
+      part.hedged = true;
+      hedges_.fetch_add(1, std::memory_order_relaxed);
+      queue_.emplace_front(Attempt{attempt.call, attempt.part, true});
+      hedged = true;
+    }
+    if (hedged) {
+      work_cv_.notify_all();
+    }
+  }
+}
+
+void
+katana::RangedGetter::Run(const Attempt& attempt) {
+  const Call& call = *attempt.call;
+  const Part& part = call.parts[attempt.part];
+  // With hedging, two requests for a part may be in flight, so each reads
+  // into a buffer of its own and the winner is copied into the result
+  std::unique_ptr<uint8_t[]> buf;
+  uint8_t* target = call.buf + part.offset;
+  if (call.hedging) {
+    buf = std::make_unique<uint8_t[]>(part.size);
+    target = buf.get();
+  }
+  auto start = std::chrono::steady_clock::now();
+  auto res = Request(attempt, target);
+  Finish(
+      attempt, std::move(res), std::move(buf),
+      std::chrono::steady_clock::now() - start);
+}
+
+katana::Result<void>
+katana::RangedGetter::Request(const Attempt& attempt, uint8_t* buf) {
+  const Call& call = *attempt.call;
+  const Part& part = call.parts[attempt.part];
+  auto backoff = options_.retry_backoff;
+  for (uint32_t i = 1;; ++i) {
+    auto res = get_range_(call.uri, call.start + part.offset, part.size, buf);
+    if (res || i == options_.max_attempts) {
+      return res;
+    }
+    retries_.fetch_add(1, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Adapt(0, true);
+    }
+    std::this_thread::sleep_for(backoff);
+    backoff *= 2;
+  }
+}
+
+void
+katana::RangedGetter::Finish(
+    const Attempt& attempt, katana::Result<void> res,
+    std::unique_ptr<uint8_t[]> buf,
+    std::chrono::steady_clock::duration latency) {
+  Call& call = *attempt.call;
+  Part& part = call.parts[attempt.part];
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  --part.attempts_in_flight;
+  if (!attempt.is_hedge) {
+    auto it = std::find_if(
+        in_flight_.begin(), in_flight_.end(), [&](const Attempt& a) {
+          return a.call == attempt.call && a.part == attempt.part;
+        });
+    KATANA_LOG_DEBUG_ASSERT(it != in_flight_.end());
+    *it = std::move(in_flight_.back());
+    in_flight_.pop_back();
+  }
+  if (part.done) {
+    // The other request for the part won
+    return;
+  }
+  if (!res) {
+    if (part.attempts_in_flight > 0) {
+      // Leave the part to the other request
+      return;
+    }
+    part.done = true;
+    if (!call.failed) {
+      call.failed = true;
+      call.result = MakeError(
+          std::move(res.error()), call.uri, call.start + part.offset,
+          part.size);
+    }
+  } else {
+    part.done = true;
+    parts_.fetch_add(1, std::memory_order_relaxed);
+    if (attempt.is_hedge) {
+      hedge_wins_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      double seconds = std::chrono::duration<double>(latency).count();
+      typical_latency_ = typical_latency_ == 0
+                             ? seconds
+                             : kLatencyWeight * seconds +
+                                   (1 - kLatencyWeight) * typical_latency_;
+    }
+    Adapt(part.size, false);
+    if (buf) {
+      lock.unlock();
+      std::memcpy(call.buf + part.offset, buf.get(), part.size);
+      lock.lock();
+    }
+  }
+  if (--call.unresolved == 0) {
+    lock.unlock();
+    call.promise.set_value(call.result);
+  }
+}
+
+void
+katana::RangedGetter::Adapt(uint64_t part_bytes, bool failed) {
+  uint32_t concurrency = concurrency_.load(std::memory_order_relaxed);
+  auto now = std::chrono::steady_clock::now();
+  if (failed) {
+    // Requests failing, e.g., because of throttling, mean back off hard
+    concurrency = std::max(options_.min_concurrency, concurrency / 2);
+    concurrency_.store(concurrency, std::memory_order_relaxed);
+    direction_ = 1;
+    last_throughput_ = 0;
+    window_start_ = now;
+    window_bytes_ = 0;
+    window_parts_ = 0;
+    return;
+  }
+
+  window_bytes_ += part_bytes;
+  // A window is about one round of requests at the current concurrency
+  if (++window_parts_ < concurrency) {
+    return;
+  }
+  double seconds = std::chrono::duration<double>(now - window_start_).count();
+  double throughput = seconds > 0 ? window_bytes_ / seconds : 0;
+  // Hill climb: keep going while throughput improves, otherwise turn back
+  if (last_throughput_ > 0 && throughput < last_throughput_) {
+    direction_ = -direction_;
+  }
+  int64_t step = std::max<uint32_t>(1, concurrency / 8);
+  concurrency = std::clamp<int64_t>(
+      concurrency + direction_ * step, options_.min_concurrency,
+      options_.max_concurrency);
+  concurrency_.store(concurrency, std::memory_order_relaxed);
+  last_throughput_ = throughput;
+  window_start_ = now;
+  window_bytes_ = 0;
+  window_parts_ = 0;
+  // More requests may be allowed now
+  work_cv_.notify_all();
+}
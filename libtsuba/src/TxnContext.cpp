@@ -11,7 +11,8 @@ katana::TxnContext::Commit() {
       URI manifest_file = info.second.manifest_file;
       KATANA_LOG_DEBUG_ASSERT(!manifest_file.empty());
       KATANA_CHECKED(katana::OneHostOnly([&]() -> katana::Result<void> {
-        std::string curr_s = info.second.rdg_manifest.ToJsonString();
+        std::string curr_s =
+            KATANA_CHECKED(info.second.rdg_manifest.Serialize());
         KATANA_CHECKED_CONTEXT(
             katana::FileStore(
                 manifest_file.string(),
@@ -1,6 +1,9 @@
 #include "katana/WriteGroup.h"
 
+#include <algorithm>
+
 #include "GlobalState.h"
+#include "katana/Env.h"
 #include "katana/Random.h"
 #include "katana/Result.h"
 
@@ -13,6 +16,14 @@ constexpr uint32_t kTagLen = 12;
 
 }  // namespace
 
+katana::WriteGroup::WriteGroup(std::string tag)
+    : tag_(std::move(tag)), max_outstanding_size_(kMaxOutstandingSize) {
+  if (int mbs = 0;
+      katana::GetEnv("KATANA_WRITE_GROUP_MAX_INFLIGHT_MB", &mbs) && mbs > 0) {
+    max_outstanding_size_ = static_cast<uint64_t>(mbs) << 20;
+  }
+}
+
 Result<std::unique_ptr<katana::WriteGroup>>
 katana::WriteGroup::Make() {
   // Don't use `OneHostOnly` because we can skip its broadcast
@@ -29,28 +40,49 @@ katana::WriteGroup::Finish() {
   return async_op_group_.Finish();
 }
 
+void
+katana::WriteGroup::WaitForRoom(uint64_t size) {
+  // an op larger than the bound still runs, just on its own
+  size = std::min(size, max_outstanding_size_);
+  if (size == 0) {
+    return;
+  }
+  while (outstanding_size_ + size > max_outstanding_size_) {
+    if (!async_op_group_.FinishOne()) {
+      KATANA_LOG_ERROR("outstanding_size should be zero if we couldn't drain");
+      break;
+    }
+  }
+}
+
 void
 katana::WriteGroup::AddOp(
     std::future<katana::CopyableResult<void>> future, std::string file,
     uint64_t accounted_size) {
-  if (accounted_size > kMaxOutstandingSize) {
-    accounted_size = kMaxOutstandingSize;
-  }
-  if (accounted_size > 0) {
-    while (outstanding_size_ + accounted_size > kMaxOutstandingSize) {
-      if (!async_op_group_.FinishOne()) {
-        KATANA_LOG_ERROR(
-            "outstanding_size should be zero if we couldn't drain");
-        break;
-      }
-    }
+  accounted_size = std::min(accounted_size, max_outstanding_size_);
+  if (accounted_size == 0) {
+    async_op_group_.AddOp(
+        std::move(future), std::move(file),
+        []() { return katana::CopyableResultSuccess(); });
+    return;
   }
-  async_op_group_.AddOp(
-      std::move(future), std::move(file),
-      [wg = this, accounted_size]() -> katana::CopyableResult<void> {
+
+  WaitForRoom(accounted_size);
+  outstanding_size_ += accounted_size;
+
+  // release the accounted size whether or not the op succeeds; on_complete
+  // only runs on success
+  auto released = std::async(
+      std::launch::deferred,
+      [wg = this, accounted_size,
+       future = std::move(future)]() mutable -> katana::CopyableResult<void> {
+        auto res = future.get();
         wg->outstanding_size_ -= accounted_size;
-        return katana::CopyableResultSuccess();
+        return res;
       });
+  async_op_group_.AddOp(
+      std::move(released), std::move(file),
+      []() { return katana::CopyableResultSuccess(); });
 }
 
 // shared pointer because FileFrames are often held that way due do the way
@@ -62,7 +94,9 @@ katana::WriteGroup::StartStore(std::shared_ptr<katana::FileFrame> ff) {
 
   // wrap future to hold onto FileFrame, but free it as soon as possible
   auto future = std::async(std::launch::async, [ff = std::move(ff)]() mutable {
-    return ff->PersistAsync().get();
+    auto res = ff->PersistAsync().get();
+    ff.reset();
+    return res;
   });
   AddOp(std::move(future), file, size);
 }
@@ -9,6 +9,7 @@
 #include <sys/mman.h>
 
 #include <cassert>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <mutex>
@@ -17,32 +18,106 @@
 #include "GlobalState.h"
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
+#include "katana/Metrics.h"
 #include "katana/Platform.h"
 #include "katana/Result.h"
 
+namespace {
+
+/// Storage metrics of reads or writes; see Metrics.h. Only synchronous
+/// requests are timed since the futures of asynchronous ones cannot be
+/// watched without waiting on them.
+class StorageMetrics {
+public:
+  explicit StorageMetrics(const std::string& op)
+      : requests_(katana::MetricsRegistry::Get().GetCounter(
+            "katana_storage_requests_total", "Requests to storage",
+            {{"op", op}})),
+        bytes_(katana::MetricsRegistry::Get().GetCounter(
+            "katana_storage_bytes_total", "Bytes requested from storage",
+            {{"op", op}})),
+        errors_(katana::MetricsRegistry::Get().GetCounter(
+            "katana_storage_errors_total",
+            "Synchronous requests to storage that failed", {{"op", op}})),
+        latency_(katana::MetricsRegistry::Get().GetHistogram(
+            "katana_storage_request_seconds",
+            "Latency of synchronous requests to storage",
+            katana::LatencyBuckets(), {{"op", op}})) {}
+
+  void Count(uint64_t size) {
+    requests_.Add();
+    bytes_.Add(size);
+  }
+
+  template <typename F>
+  katana::Result<void> Time(uint64_t size, F&& request) {
+    Count(size);
+    auto start = std::chrono::steady_clock::now();
+    katana::Result<void> res = request();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    latency_.Observe(elapsed.count());
+    if (!res) {
+      errors_.Add();
+    }
+    return res;
+  }
+
+private:
+  katana::Counter& requests_;
+  katana::Counter& bytes_;
+  katana::Counter& errors_;
+  katana::Histogram& latency_;
+};
+
+StorageMetrics&
+ReadMetrics() {
+  static StorageMetrics metrics("read");
+  return metrics;
+}
+
+StorageMetrics&
+WriteMetrics() {
+  static StorageMetrics metrics("write");
+  return metrics;
+}
+
+}  // namespace
+
 katana::Result<void>
 katana::FileStore(const std::string& uri, const void* data, uint64_t size) {
-  return FS(uri)->PutMultiSync(uri, static_cast<const uint8_t*>(data), size);
+  return WriteMetrics().Time(size, [&]() -> Result<void> {
+    return FS(uri)->PutMultiSync(uri, static_cast<const uint8_t*>(data), size);
+  });
 }
 
 std::future<katana::CopyableResult<void>>
 katana::FileStoreAsync(
     const std::string& uri, const void* data, uint64_t size) {
+  WriteMetrics().Count(size);
   return FS(uri)->PutAsync(uri, static_cast<const uint8_t*>(data), size);
 }
 
+katana::Result<std::unique_ptr<katana::FileUpload>>
+katana::FileCreateUpload(const std::string& uri) {
+  return FS(uri)->CreateUpload(uri);
+}
+
 katana::Result<void>
 katana::FileGet(
     const std::string& uri, void* result_buffer, uint64_t begin,
     uint64_t size) {
-  return FS(uri)->GetMultiSync(
-      uri, begin, size, static_cast<uint8_t*>(result_buffer));
+  return ReadMetrics().Time(size, [&]() -> Result<void> {
+    return FS(uri)->GetMultiSync(
+        uri, begin, size, static_cast<uint8_t*>(result_buffer));
+  });
 }
 
 std::future<katana::CopyableResult<void>>
 katana::FileGetAsync(
     const std::string& uri, void* result_buffer, uint64_t begin,
     uint64_t size) {
+  ReadMetrics().Count(size);
   return FS(uri)->GetAsync(
       uri, begin, size, static_cast<uint8_t*>(result_buffer));
 }
@@ -55,7 +130,8 @@ katana::FileRemoteCopy(
   auto dest_fs = FS(dest_uri);
 
   if (source_fs != dest_fs) {
-    KATANA_LOG_ERROR("cannot copy between different back-ends");
+    // callers fall back to copying through memory
+    KATANA_LOG_DEBUG("cannot copy between different back-ends");
     return ErrorCode::NotImplemented;
   }
 
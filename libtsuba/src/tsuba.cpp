@@ -110,7 +110,13 @@ katana::Create(const katana::URI& uri) {
 
   katana::CommBackend* comm = Comm();
   if (comm->Rank == 0) {
-    std::string s = manifest.ToJsonString();
+    auto s_res = manifest.Serialize();
+    if (!s_res) {
+      comm->NotifyFailure();
+      return s_res.error().WithContext(
+          "failed to serialize RDG file: {}", uri.string());
+    }
+    std::string s = std::move(s_res.value());
     if (auto res = katana::FileStore(
             katana::RDGManifest::FileName(
                 uri, katana::kDefaultRDGViewType, manifest.version())
@@ -313,14 +319,14 @@ katana::CopyRDG(
     rdg_manifest.set_version(1);
     rdg_manifest.set_prev_version(1);
 
-    auto rdg_manifest_json = rdg_manifest.ToJsonString();
+    auto rdg_manifest_str = KATANA_CHECKED(rdg_manifest.Serialize());
     KATANA_CHECKED(katana::FileStore(
         dst_file_uri.string(),
-        reinterpret_cast<const uint8_t*>(rdg_manifest_json.data()),
-        rdg_manifest_json.size()));
+        reinterpret_cast<const uint8_t*>(rdg_manifest_str.data()),
+        rdg_manifest_str.size()));
 
     scope.span().SetTags(
-        {{"uri", dst_file_uri.string()}, {"size", rdg_manifest_json.size()}});
+        {{"uri", dst_file_uri.string()}, {"size", rdg_manifest_str.size()}});
   }
 
   return katana::ResultSuccess();
@@ -423,13 +429,13 @@ katana::WriteRDGManifest(const std::string& rdg_dir, uint32_t num_hosts) {
   // Write out the manifest file
   // Using view_specifier in case something ever changes in the future where out-of-core import
   // will be able to partition a graph, etc.
-  auto manifest_json = manifest.ToJsonString();
+  auto manifest_str = KATANA_CHECKED(manifest.Serialize());
   KATANA_CHECKED(katana::FileStore(
       katana::RDGManifest::FileName(
           rdg_dir_uri, manifest.view_specifier(), manifest.version())
           .string(),
-      reinterpret_cast<const uint8_t*>(manifest_json.data()),
-      manifest_json.size()));
+      reinterpret_cast<const uint8_t*>(manifest_str.data()),
+      manifest_str.size()));
   return katana::ResultSuccess();
 }
 
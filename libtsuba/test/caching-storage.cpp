@@ -0,0 +1,270 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "CachingStorage.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/file.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr uint64_t kBlockBytes = 4096;
+
+/// An in-memory stand-in for a remote object store that counts its reads
+class FakeStorage : public katana::FileStorage {
+public:
+  FakeStorage() : FileStorage("fake://") {}
+
+  void Set(const std::string& uri, std::vector<uint8_t> data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& object = objects_[uri];
+    object.data = std::move(data);
+    object.etag = std::to_string(++version_);
+  }
+
+  uint64_t gets() const { return gets_; }
+
+  katana::Result<void> Init() override { return katana::ResultSuccess(); }
+  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+
+  katana::Result<void> Stat(
+      const std::string& uri, katana::StatBuf* s_buf) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = objects_.find(uri);
+    if (it == objects_.end()) {
+      return KATANA_ERROR(katana::ErrorCode::NotFound, "no {}", uri);
+    }
+    s_buf->size = it->second.data.size();
+    s_buf->etag = it->second.etag;
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    ++gets_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = objects_.find(uri);
+    if (it == objects_.end()) {
+      return KATANA_ERROR(katana::ErrorCode::NotFound, "no {}", uri);
+    }
+    if (start + size > it->second.data.size()) {
+      return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "out of range");
+    }
+    std::memcpy(result_buf, it->second.data.data() + start, size);
+    return katana::ResultSuccess();
+  }
+
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    return std::async(
+        std::launch::async, [=]() -> katana::CopyableResult<void> {
+          if (auto res = GetMultiSync(uri, start, size, result_buf); !res) {
+            return katana::CopyableErrorInfo{res.error()};
+          }
+          return katana::CopyableResultSuccess();
+        });
+  }
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    Set(uri, std::vector<uint8_t>(data, data + size));
+    return katana::ResultSuccess();
+  }
+
+  std::future<katana::CopyableResult<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    Set(uri, std::vector<uint8_t>(data, data + size));
+    return std::async(std::launch::deferred, [] {
+      return katana::CopyableResult<void>(katana::CopyableResultSuccess());
+    });
+  }
+
+  katana::Result<void> RemoteCopy(
+      const std::string&, const std::string&, uint64_t, uint64_t) override {
+    return katana::ErrorCode::NotImplemented;
+  }
+
+  std::future<katana::CopyableResult<void>> ListAsync(
+      const std::string&, std::vector<std::string>*,
+      std::vector<uint64_t>*) override {
+    return std::async(std::launch::deferred, [] {
+      return katana::CopyableResult<void>(katana::ErrorCode::NotImplemented);
+    });
+  }
+
+  katana::Result<void> Delete(
+      const std::string&, const std::unordered_set<std::string>&) override {
+    return katana::ErrorCode::NotImplemented;
+  }
+
+private:
+  struct Object {
+    std::vector<uint8_t> data;
+    std::string etag;
+  };
+
+  std::mutex mutex_;
+  std::map<std::string, Object> objects_;
+  uint64_t version_{0};
+  std::atomic<uint64_t> gets_{0};
+};
+
+std::vector<uint8_t>
+MakeData(size_t size, uint8_t seed) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(i * 13 + seed);
+  }
+  return data;
+}
+
+katana::CachingStorage::Options
+MakeOptions(const std::string& dir) {
+  katana::CachingStorage::Options options;
+  options.dir = dir;
+  options.block_size = kBlockBytes;
+  return options;
+}
+
+std::vector<uint8_t>
+Get(katana::FileStorage* storage, const std::string& uri, uint64_t start,
+    uint64_t size) {
+  std::vector<uint8_t> buf(size);
+  auto res = storage->GetMultiSync(uri, start, size, buf.data());
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  return buf;
+}
+
+std::vector<uint8_t>
+Slice(const std::vector<uint8_t>& data, uint64_t start, uint64_t size) {
+  return std::vector<uint8_t>(
+      data.begin() + start, data.begin() + start + size);
+}
+
+void
+TestReadThrough(const std::string& dir) {
+  FakeStorage remote;
+  auto data = MakeData(10 * kBlockBytes + 100, 1);
+  remote.Set("fake://bucket/a", data);
+
+  katana::CachingStorage cache(&remote, MakeOptions(dir));
+  KATANA_LOG_ASSERT(cache.Init());
+  KATANA_LOG_ASSERT(cache.uri_scheme() == remote.uri_scheme());
+
+  KATANA_LOG_ASSERT(Get(&cache, "fake://bucket/a", 0, data.size()) == data);
+  uint64_t first_gets = remote.gets();
+  KATANA_LOG_ASSERT(first_gets == 11);
+  KATANA_LOG_ASSERT(cache.used_bytes() == data.size());
+
+  // Everything is cached now, at any alignment
+  KATANA_LOG_ASSERT(Get(&cache, "fake://bucket/a", 0, data.size()) == data);
+  KATANA_LOG_ASSERT(
+      Get(&cache, "fake://bucket/a", kBlockBytes - 5, 2 * kBlockBytes) ==
+      Slice(data, kBlockBytes - 5, 2 * kBlockBytes));
+  std::vector<uint8_t> buf(3 * kBlockBytes);
+  auto future = cache.GetAsync("fake://bucket/a", 17, buf.size(), buf.data());
+  KATANA_LOG_ASSERT(future.get());
+  KATANA_LOG_ASSERT(buf == Slice(data, 17, buf.size()));
+  KATANA_LOG_ASSERT(remote.gets() == first_gets);
+
+  // Another cache of the same directory, like another process, shares it
+  katana::CachingStorage other(&remote, MakeOptions(dir));
+  KATANA_LOG_ASSERT(other.Init());
+  KATANA_LOG_ASSERT(other.used_bytes() == data.size());
+  KATANA_LOG_ASSERT(Get(&other, "fake://bucket/a", 0, data.size()) == data);
+  KATANA_LOG_ASSERT(remote.gets() == first_gets);
+
+  // A new version of the object is not read stale
+  auto new_data = MakeData(data.size(), 2);
+  KATANA_LOG_ASSERT(
+      cache.PutMultiSync("fake://bucket/a", new_data.data(), new_data.size()));
+  KATANA_LOG_ASSERT(
+      Get(&cache, "fake://bucket/a", 0, new_data.size()) == new_data);
+  KATANA_LOG_ASSERT(remote.gets() > first_gets);
+}
+
+void
+TestPartialBlocks(const std::string& dir) {
+  FakeStorage remote;
+  auto data = MakeData(4 * kBlockBytes, 3);
+  remote.Set("fake://bucket/b", data);
+  katana::CachingStorage cache(&remote, MakeOptions(dir));
+  KATANA_LOG_ASSERT(cache.Init());
+
+  // A small read caches its whole block
+  std::vector<uint8_t> buf(10);
+  auto future = cache.GetAsync("fake://bucket/b", 100, buf.size(), buf.data());
+  KATANA_LOG_ASSERT(future.get());
+  KATANA_LOG_ASSERT(buf == Slice(data, 100, buf.size()));
+  KATANA_LOG_ASSERT(remote.gets() == 1);
+  KATANA_LOG_ASSERT(
+      Get(&cache, "fake://bucket/b", 0, kBlockBytes) ==
+      Slice(data, 0, kBlockBytes));
+  KATANA_LOG_ASSERT(remote.gets() == 1);
+
+  // Errors of the remote storage come through
+  std::vector<uint8_t> past_end(kBlockBytes);
+  KATANA_LOG_ASSERT(!cache.GetMultiSync(
+      "fake://bucket/b", 4 * kBlockBytes - 1, past_end.size(),
+      past_end.data()));
+  KATANA_LOG_ASSERT(!cache.GetMultiSync(
+      "fake://bucket/missing", 0, past_end.size(), past_end.data()));
+}
+
+void
+TestEviction(const std::string& dir) {
+  FakeStorage remote;
+  auto options = MakeOptions(dir);
+  options.capacity_bytes = 8 * kBlockBytes;
+  katana::CachingStorage cache(&remote, options);
+  KATANA_LOG_ASSERT(cache.Init());
+
+  for (int i = 0; i < 10; ++i) {
+    std::string uri = "fake://bucket/" + std::to_string(i);
+    auto data = MakeData(2 * kBlockBytes, i);
+    remote.Set(uri, data);
+    KATANA_LOG_ASSERT(Get(&cache, uri, 0, data.size()) == data);
+    KATANA_LOG_ASSERT(cache.used_bytes() <= options.capacity_bytes);
+    // Blocks are ordered by modification time, which is coarse
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+
+  // The most recently used object is still cached
+  uint64_t gets = remote.gets();
+  Get(&cache, "fake://bucket/9", 0, 2 * kBlockBytes);
+  KATANA_LOG_ASSERT(remote.gets() == gets);
+  // The first one was evicted
+  Get(&cache, "fake://bucket/0", 0, 2 * kBlockBytes);
+  KATANA_LOG_ASSERT(remote.gets() > gets);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("missing argument: <temp dir>");
+  }
+  std::string dir = argv[1];
+  fs::remove_all(dir);
+
+  TestReadThrough(dir + "/read-through");
+  TestPartialBlocks(dir + "/partial-blocks");
+  TestEviction(dir + "/eviction");
+
+  fs::remove_all(dir);
+  return 0;
+}
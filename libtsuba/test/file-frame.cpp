@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/FileFrame.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/file.h"
+#include "katana/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr uint64_t kPartSize = katana::kBlockSize * 2;
+
+std::vector<uint8_t>
+MakeData(uint64_t size) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 31 + i / 256);
+  }
+  return data;
+}
+
+katana::Result<std::vector<uint8_t>>
+ReadBack(const std::string& uri) {
+  katana::StatBuf stat;
+  KATANA_CHECKED(katana::FileStat(uri, &stat));
+  std::vector<uint8_t> contents(stat.size);
+  KATANA_CHECKED(katana::FileGet(uri, contents.data(), 0, contents.size()));
+  return contents;
+}
+
+/// Write data in pieces of piece_size bytes, so that writes straddle parts,
+/// fill them exactly and span several of them
+katana::Result<void>
+TestUpload(const katana::URI& dir, uint64_t size, uint64_t piece_size) {
+  std::string uri =
+      dir.Join(fmt::format("upload_{}_{}", size, piece_size)).string();
+  std::vector<uint8_t> data = MakeData(size);
+
+  katana::FileFrame ff;
+  KATANA_CHECKED(ff.Init());
+  ff.Bind(uri);
+  KATANA_CHECKED(ff.StartUpload(kPartSize));
+  for (uint64_t i = 0; i < size; i += piece_size) {
+    uint64_t n = std::min(piece_size, size - i);
+    KATANA_CHECKED(ff.Write(data.data() + i, n));
+    KATANA_LOG_ASSERT(ff.Tell().ValueOrDie() == static_cast<int64_t>(i + n));
+  }
+  // the buffer holds two parts at most
+  KATANA_LOG_ASSERT(ff.map_size() <= 2 * kPartSize);
+  KATANA_LOG_ASSERT(!ff.SetCursor(0));
+
+  KATANA_CHECKED(ff.Persist());
+  std::vector<uint8_t> contents = KATANA_CHECKED(ReadBack(uri));
+  KATANA_LOG_VASSERT(
+      contents == data, "{} bytes written in pieces of {} stored wrong", size,
+      piece_size);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAbort(const katana::URI& dir) {
+  std::string uri = dir.Join("aborted").string();
+  std::vector<uint8_t> data = MakeData(kPartSize * 3);
+  {
+    katana::FileFrame ff;
+    KATANA_CHECKED(ff.Init());
+    ff.Bind(uri);
+    KATANA_CHECKED(ff.StartUpload(kPartSize));
+    KATANA_CHECKED(ff.Write(data.data(), data.size()));
+  }
+  // nothing is stored by a frame destroyed before it is persisted, not even
+  // the parts it uploaded
+  katana::StatBuf stat;
+  KATANA_LOG_ASSERT(!katana::FileStat(uri, &stat));
+  KATANA_LOG_ASSERT(fs::is_empty(dir.path()));
+
+  katana::FileFrame ff;
+  KATANA_CHECKED(ff.Init());
+  ff.Bind(uri);
+  KATANA_LOG_ASSERT(!ff.StartUpload(kPartSize + 1));
+  KATANA_CHECKED(ff.Write(data.data(), 1));
+  KATANA_LOG_ASSERT(!ff.StartUpload(kPartSize));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& path) {
+  auto dir = KATANA_CHECKED(katana::URI::MakeFromFile(path));
+  auto abort_dir = dir.Join("abort");
+  if (boost::system::error_code err;
+      !fs::create_directories(abort_dir.path(), err)) {
+    if (err) {
+      return KATANA_ERROR(
+          std::error_code(err.value(), err.category()),
+          "creating directories: {}", err.message());
+    }
+  }
+
+  KATANA_CHECKED_CONTEXT(TestUpload(dir, 0, 1), "TestUpload empty");
+  KATANA_CHECKED_CONTEXT(TestUpload(dir, 100, 7), "TestUpload one part");
+  KATANA_CHECKED_CONTEXT(
+      TestUpload(dir, kPartSize * 5, kPartSize), "TestUpload whole parts");
+  KATANA_CHECKED_CONTEXT(
+      TestUpload(dir, kPartSize * 5 + 123, 1000), "TestUpload small writes");
+  KATANA_CHECKED_CONTEXT(
+      TestUpload(dir, kPartSize * 7 + 5, kPartSize * 3 + 1),
+      "TestUpload large writes");
+  KATANA_CHECKED_CONTEXT(TestAbort(abort_dir), "TestAbort");
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = katana::InitTsuba(); !init_good) {
+    KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
+  }
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} <empty dir>", argv[0]);
+  }
+
+  auto res = TestAll(argv[1]);
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = katana::FiniTsuba(); !fini_good) {
+    KATANA_LOG_FATAL("katana::FiniTsuba: {}", fini_good.error());
+  }
+
+  return 0;
+}
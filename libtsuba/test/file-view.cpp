@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include <boost/filesystem.hpp>
 
 #include "katana/FileView.h"
@@ -31,9 +35,74 @@ TestEmpty(const std::string& path) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+TestMapMode(const std::string& path, katana::FileView::MapMode mode) {
+  auto uri = KATANA_CHECKED(katana::URI::MakeFromFile(path));
+  auto data_uri = uri.Join("data_file");
+
+  std::vector<uint64_t> data(UINT64_C(1) << 18);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = i * 31;
+  }
+  KATANA_CHECKED(katana::FileStore(data_uri.string(), data));
+
+  katana::FileView fv(mode);
+  KATANA_CHECKED(fv.Bind(data_uri.string(), true));
+
+  KATANA_LOG_ASSERT(fv.size() == data.size() * sizeof(uint64_t));
+  KATANA_LOG_ASSERT(
+      fv.file_mapped() == (mode != katana::FileView::MapMode::kCopy));
+  KATANA_LOG_ASSERT(
+      std::memcmp(fv.ptr<uint64_t>(), data.data(), fv.size()) == 0);
+
+  // Read through the arrow::io::RandomAccessFile interface as ParquetReader
+  // does
+  KATANA_CHECKED(fv.Seek(sizeof(uint64_t) * 7));
+  uint64_t val{};
+  auto nbytes = KATANA_CHECKED(fv.Read(sizeof(val), &val));
+  KATANA_LOG_ASSERT(nbytes == sizeof(val));
+  KATANA_LOG_ASSERT(val == data[7]);
+
+  // Scan sequentially in small reads so that readahead kicks in
+  KATANA_CHECKED(fv.Seek(0));
+  for (size_t i = 0; i < data.size(); i += 1000) {
+    std::vector<uint64_t> buf(std::min<size_t>(1000, data.size() - i));
+    nbytes = KATANA_CHECKED(fv.Read(buf.size() * sizeof(uint64_t), buf.data()));
+    KATANA_LOG_ASSERT(nbytes == static_cast<int64_t>(buf.size() * 8));
+    KATANA_LOG_ASSERT(std::equal(buf.begin(), buf.end(), data.begin() + i));
+  }
+
+  // Release a region and read it again, filling it first without resolving
+  // the way a prefetch does
+  uint64_t half = fv.size() / 2;
+  KATANA_CHECKED(fv.Release(0, half));
+  KATANA_CHECKED(fv.Fill(0, half, false));
+  KATANA_CHECKED(fv.Fill(0, half, true));
+  KATANA_LOG_ASSERT(std::memcmp(fv.ptr<uint64_t>(), data.data(), half) == 0);
+
+  // Pages only partly in the released range are kept
+  KATANA_CHECKED(fv.Release(sizeof(uint64_t), fv.size()));
+  KATANA_LOG_ASSERT(fv.ptr<uint64_t>()[1] == data[1]);
+  KATANA_CHECKED(fv.Fill(0, fv.size(), true));
+  KATANA_LOG_ASSERT(
+      std::memcmp(fv.ptr<uint64_t>(), data.data(), fv.size()) == 0);
+
+  KATANA_CHECKED(fv.Unbind());
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& path) {
   KATANA_CHECKED_CONTEXT(TestEmpty(path), "TestEmpty");
+  KATANA_CHECKED_CONTEXT(
+      TestMapMode(path, katana::FileView::MapMode::kCopy), "TestMapMode copy");
+  KATANA_CHECKED_CONTEXT(
+      TestMapMode(path, katana::FileView::MapMode::kMapPrivate),
+      "TestMapMode private");
+  KATANA_CHECKED_CONTEXT(
+      TestMapMode(path, katana::FileView::MapMode::kMapShared),
+      "TestMapMode shared");
 
   return katana::ResultSuccess();
 }
@@ -1,9 +1,11 @@
 #include <arrow/chunked_array.h>
+#include <arrow/compute/cast.h>
 #include <arrow/type_fwd.h>
 
 #include "katana/ParquetReader.h"
 #include "katana/ParquetWriter.h"
 #include "katana/Result.h"
+#include "katana/WriteGroup.h"
 #include "katana/tsuba.h"
 
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
@@ -38,10 +40,131 @@ TestLargeStringRoundTrip(const std::string& dir) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+TestDictionaryRoundTrip(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::URI::Make(dir)).Join("dictionary.parquet");
+
+  arrow::LargeStringBuilder builder;
+  for (int i = 0; i < 1000; ++i) {
+    if (i % 10 == 0) {
+      KATANA_CHECKED(builder.AppendNull());
+    } else {
+      KATANA_CHECKED(builder.Append(fmt::format("label-{}", i % 7)));
+    }
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_CHECKED(builder.Finish(&array));
+  auto expected = std::make_shared<arrow::ChunkedArray>(array);
+
+  auto writer =
+      KATANA_CHECKED(katana::ParquetWriter::Make(expected, "test-array"));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  auto opts = katana::ParquetReader::ReadOpts::Defaults();
+  opts.read_strings_as_dictionary = true;
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make(opts));
+  auto table = KATANA_CHECKED(reader->ReadTable(uri));
+
+  KATANA_LOG_ASSERT(table->num_columns() == 1);
+  const auto& column = table->column(0);
+  KATANA_LOG_ASSERT(column->type()->id() == arrow::Type::DICTIONARY);
+  for (const auto& chunk : column->chunks()) {
+    KATANA_LOG_ASSERT(
+        static_cast<const arrow::DictionaryArray&>(*chunk)
+            .dictionary()
+            ->length() <= 7);
+  }
+
+  arrow::Datum decoded =
+      KATANA_CHECKED(arrow::compute::Cast(column, arrow::utf8()));
+  decoded = KATANA_CHECKED(arrow::compute::Cast(decoded, arrow::large_utf8()));
+  KATANA_LOG_ASSERT(decoded.chunked_array()->Equals(*expected));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestStreamingRoundTrip(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::URI::Make(dir)).Join("streaming.parquet");
+
+  constexpr int64_t kNumRows = 1 << 20;
+  arrow::Int64Builder builder;
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    KATANA_CHECKED(builder.Append(i));
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_CHECKED(builder.Finish(&array));
+
+  // 8MB of data in 1MB parts, with room for only one part in flight
+  katana::ParquetWriter::WriteOpts opts;
+  opts.mbs_per_part = 1;
+  opts.max_inflight_mbs = 1;
+  auto writer = KATANA_CHECKED(katana::ParquetWriter::Make(
+      std::make_shared<arrow::ChunkedArray>(array), "test-array", opts));
+
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
+  auto table = KATANA_CHECKED(reader->ReadTable(uri));
+
+  KATANA_LOG_ASSERT(table->num_columns() == 1);
+  KATANA_LOG_ASSERT(table->num_rows() == kNumRows);
+  KATANA_LOG_ASSERT(table->column(0)->Equals(arrow::ChunkedArray(array)));
+
+  // a slice that spans parts
+  constexpr int64_t kSliceRows = kNumRows / 2;
+  auto slice = KATANA_CHECKED(reader->ReadTable(
+      uri, katana::ParquetReader::Slice{.offset = 100, .length = kSliceRows}));
+  KATANA_LOG_ASSERT(slice->num_rows() == kSliceRows);
+  KATANA_LOG_ASSERT(slice->column(0)->Equals(
+      arrow::ChunkedArray(array->Slice(100, kSliceRows))));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestBoundedWriteGroup(const std::string& dir) {
+  auto base = KATANA_CHECKED(katana::URI::Make(dir));
+
+  constexpr int64_t kNumRows = 1 << 17;
+  constexpr int kNumFiles = 8;
+  arrow::Int64Builder builder;
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    KATANA_CHECKED(builder.Append(i));
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_CHECKED(builder.Finish(&array));
+  auto chunked = std::make_shared<arrow::ChunkedArray>(array);
+
+  // each 1MB file has to wait for the one before it to finish
+  auto wg = KATANA_CHECKED(katana::WriteGroup::Make());
+  wg->set_max_outstanding_size(1 << 20);
+  for (int i = 0; i < kNumFiles; ++i) {
+    auto writer =
+        KATANA_CHECKED(katana::ParquetWriter::Make(chunked, "test-array"));
+    KATANA_CHECKED(writer->WriteToUri(
+        base.Join(fmt::format("bounded_{}.parquet", i)), wg.get()));
+  }
+  KATANA_CHECKED(wg->Finish());
+
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
+  for (int i = 0; i < kNumFiles; ++i) {
+    auto table = KATANA_CHECKED(
+        reader->ReadTable(base.Join(fmt::format("bounded_{}.parquet", i))));
+    KATANA_LOG_ASSERT(table->column(0)->Equals(*chunked));
+  }
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& dir) {
   KATANA_CHECKED_CONTEXT(
       TestLargeStringRoundTrip(dir), "TestLargeStringRoundTrip");
+  KATANA_CHECKED_CONTEXT(
+      TestDictionaryRoundTrip(dir), "TestDictionaryRoundTrip");
+  KATANA_CHECKED_CONTEXT(TestStreamingRoundTrip(dir), "TestStreamingRoundTrip");
+  KATANA_CHECKED_CONTEXT(TestBoundedWriteGroup(dir), "TestBoundedWriteGroup");
 
   return katana::ResultSuccess();
 }
@@ -0,0 +1,213 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/RangedGetter.h"
+#include "katana/Result.h"
+
+namespace {
+
+constexpr uint64_t kPartSize = 64 << 10;
+
+std::vector<uint8_t>
+MakeObject(size_t size) {
+  std::vector<uint8_t> object(size);
+  for (size_t i = 0; i < size; ++i) {
+    object[i] = static_cast<uint8_t>(i * 7 + i / 251);
+  }
+  return object;
+}
+
+/// A fake object store holding one object
+class FakeStore {
+public:
+  explicit FakeStore(size_t size) : object_(MakeObject(size)) {}
+
+  katana::Result<void> Get(uint64_t start, uint64_t size, uint8_t* buf) {
+    if (start + size > object_.size()) {
+      return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "out of range");
+    }
+    std::memcpy(buf, object_.data() + start, size);
+    return katana::ResultSuccess();
+  }
+
+  katana::RangedGetter::GetRangeFn Fn() {
+    return [this](const std::string&, uint64_t start, uint64_t size,
+                  uint8_t* buf) { return Get(start, size, buf); };
+  }
+
+  bool Matches(const std::vector<uint8_t>& buf, uint64_t start) const {
+    return std::memcmp(buf.data(), object_.data() + start, buf.size()) == 0;
+  }
+
+private:
+  std::vector<uint8_t> object_;
+};
+
+void
+TestGet() {
+  FakeStore store(10 * kPartSize + 123);
+  katana::RangedGetter::Options options;
+  options.part_size = kPartSize;
+  katana::RangedGetter getter(store.Fn(), options);
+
+  std::vector<uint8_t> buf(10 * kPartSize);
+  auto res = getter.Get("obj", 123, buf.size(), buf.data());
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(store.Matches(buf, 123));
+  KATANA_LOG_ASSERT(getter.GetStats().parts == 10);
+
+  // Many gets in flight at once share the getter
+  std::vector<std::vector<uint8_t>> bufs(8, std::vector<uint8_t>(kPartSize));
+  std::vector<std::future<katana::CopyableResult<void>>> futures;
+  for (size_t i = 0; i < bufs.size(); ++i) {
+    futures.emplace_back(getter.GetAsync(
+        "obj", i * 1000, bufs[i].size() - i, bufs[i].data()));
+  }
+  for (size_t i = 0; i < bufs.size(); ++i) {
+    auto async_res = futures[i].get();
+    KATANA_LOG_VASSERT(async_res, "{}", async_res.error());
+    bufs[i].resize(bufs[i].size() - i);
+    KATANA_LOG_ASSERT(store.Matches(bufs[i], i * 1000));
+  }
+
+  KATANA_LOG_ASSERT(getter.Get("obj", 0, 0, nullptr));
+  KATANA_LOG_ASSERT(getter.concurrency() >= options.min_concurrency);
+  KATANA_LOG_ASSERT(getter.concurrency() <= options.max_concurrency);
+}
+
+void
+TestRetry() {
+  FakeStore store(16 * kPartSize);
+  std::vector<std::atomic<uint32_t>> attempts(16);
+  katana::RangedGetter::Options options;
+  options.part_size = kPartSize;
+  options.retry_backoff = std::chrono::milliseconds(1);
+  katana::RangedGetter getter(
+      [&](const std::string&, uint64_t start, uint64_t size,
+          uint8_t* buf) -> katana::Result<void> {
+        // The first request for each part fails, like a flaky endpoint
+        if (attempts[start / kPartSize]++ == 0) {
+          return KATANA_ERROR(katana::ErrorCode::HTTPError, "flaky");
+        }
+        return store.Get(start, size, buf);
+      },
+      options);
+
+  std::vector<uint8_t> buf(16 * kPartSize);
+  auto res = getter.Get("obj", 0, buf.size(), buf.data());
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(store.Matches(buf, 0));
+  KATANA_LOG_ASSERT(getter.GetStats().retries > 0);
+}
+
+void
+TestFailure() {
+  FakeStore store(16 * kPartSize);
+  katana::RangedGetter::Options options;
+  options.part_size = kPartSize;
+  options.retry_backoff = std::chrono::milliseconds(1);
+  katana::RangedGetter getter(
+      [&](const std::string&, uint64_t start, uint64_t size,
+          uint8_t* buf) -> katana::Result<void> {
+        if (start == 3 * kPartSize) {
+          return KATANA_ERROR(katana::ErrorCode::NotFound, "missing");
+        }
+        return store.Get(start, size, buf);
+      },
+      options);
+
+  std::vector<uint8_t> buf(16 * kPartSize);
+  auto res = getter.Get("obj", 0, buf.size(), buf.data());
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(res.error() == katana::ErrorCode::NotFound);
+
+  // The getter is still usable
+  std::vector<uint8_t> small(kPartSize);
+  KATANA_LOG_ASSERT(getter.Get("obj", 0, small.size(), small.data()));
+  KATANA_LOG_ASSERT(store.Matches(small, 0));
+}
+
+void
+TestHedge() {
+  constexpr auto kSlow = std::chrono::seconds(1);
+  FakeStore store(32 * kPartSize);
+  std::atomic<bool> stalled{false};
+  katana::RangedGetter::Options options;
+  options.part_size = kPartSize;
+  options.min_hedge_delay = std::chrono::milliseconds(20);
+  katana::RangedGetter getter(
+      [&](const std::string&, uint64_t start, uint64_t size,
+          uint8_t* buf) -> katana::Result<void> {
+        // One request of the last part stalls, like a request stuck on a
+        // slow server
+        if (start == 31 * kPartSize && !stalled.exchange(true)) {
+          std::this_thread::sleep_for(kSlow);
+        } else {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return store.Get(start, size, buf);
+      },
+      options);
+
+  std::vector<uint8_t> buf(32 * kPartSize);
+  auto start = std::chrono::steady_clock::now();
+  auto res = getter.Get("obj", 0, buf.size(), buf.data());
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(store.Matches(buf, 0));
+  KATANA_LOG_ASSERT(elapsed < kSlow);
+  auto stats = getter.GetStats();
+  KATANA_LOG_ASSERT(stats.hedges >= 1 && stats.hedge_wins >= 1);
+}
+
+void
+TestThrottle() {
+  constexpr uint32_t kLimit = 4;
+  FakeStore store(64 * kPartSize);
+  std::atomic<uint32_t> in_flight{0};
+  katana::RangedGetter::Options options;
+  options.part_size = kPartSize;
+  options.initial_concurrency = 32;
+  options.retry_backoff = std::chrono::milliseconds(1);
+  options.max_attempts = 10;
+  options.hedge_multiple = 0;
+  katana::RangedGetter getter(
+      [&](const std::string&, uint64_t start, uint64_t size,
+          uint8_t* buf) -> katana::Result<void> {
+        // The store turns away requests beyond its limit
+        if (++in_flight > kLimit) {
+          --in_flight;
+          return KATANA_ERROR(katana::ErrorCode::HTTPError, "slow down");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        auto res = store.Get(start, size, buf);
+        --in_flight;
+        return res;
+      },
+      options);
+
+  std::vector<uint8_t> buf(64 * kPartSize);
+  auto res = getter.Get("obj", 0, buf.size(), buf.data());
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(store.Matches(buf, 0));
+  KATANA_LOG_ASSERT(getter.concurrency() < options.initial_concurrency);
+}
+
+}  // namespace
+
+int
+main() {
+  TestGet();
+  TestRetry();
+  TestFailure();
+  TestHedge();
+  TestThrottle();
+  return 0;
+}
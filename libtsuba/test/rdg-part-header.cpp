@@ -1,4 +1,5 @@
 #include "RDGPartHeader.h"
+#include "katana/JSON.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
 #include "katana/tsuba.h"
@@ -75,9 +76,44 @@ TestPropInfoLists(const std::string& path_to_header) {
   return katana::ResultSuccess();
 }
 
+// The binary encoding of a header must parse back to the same header, and
+// JsonParseAny must accept both encodings
+katana::Result<void>
+TestBinaryRoundTrip(const std::string& path_to_header) {
+  katana::URI path_to_header_uri =
+      KATANA_CHECKED(katana::URI::Make(path_to_header));
+  katana::RDGPartHeader header =
+      KATANA_CHECKED(katana::RDGPartHeader::Make(path_to_header_uri));
+
+  std::string text = KATANA_CHECKED(katana::JsonDump(header));
+  std::string binary = KATANA_CHECKED(katana::JsonDumpBinary(header));
+  KATANA_LOG_ASSERT(!katana::IsJsonBinary(text));
+  KATANA_LOG_ASSERT(katana::IsJsonBinary(binary));
+  KATANA_LOG_ASSERT(binary.size() < text.size());
+
+  katana::RDGPartHeader from_text;
+  KATANA_CHECKED(katana::JsonParseAny(text, &from_text));
+  katana::RDGPartHeader from_binary;
+  KATANA_CHECKED(katana::JsonParseAny(binary, &from_binary));
+
+  std::string text_again = KATANA_CHECKED(katana::JsonDump(from_text));
+  std::string binary_again = KATANA_CHECKED(katana::JsonDump(from_binary));
+  KATANA_LOG_ASSERT(binary_again == text_again);
+  KATANA_LOG_ASSERT(from_binary.edge_prop_info_list().size() == 1);
+  KATANA_LOG_ASSERT(from_binary.find_edge_prop_info("value"));
+
+  // a truncated binary header is an error, not a crash
+  std::string truncated = binary.substr(0, binary.size() / 2);
+  katana::RDGPartHeader from_truncated;
+  KATANA_LOG_ASSERT(!katana::JsonParseAny(truncated, &from_truncated));
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& path_to_header) {
   KATANA_CHECKED(TestPropInfoLists(path_to_header));
+  KATANA_CHECKED(TestBinaryRoundTrip(path_to_header));
   return katana::ResultSuccess();
 }
 
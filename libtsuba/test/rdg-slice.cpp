@@ -101,10 +101,74 @@ TestPropertyLoading(const katana::URI& path_to_manifest) {
   return katana::ResultSuccess();
 }
 
+// This test tests that slices made together from balanced slice args are
+// contiguous and that each slice gets its own range of every property
+katana::Result<void>
+TestMakeMany(const katana::URI& path_to_manifest) {
+  katana::RDGManifest manifest =
+      KATANA_CHECKED(katana::FindManifest(path_to_manifest));
+  katana::RDGHandle rdg_handle =
+      KATANA_CHECKED(katana::Open(std::move(manifest), katana::kReadOnly));
+  katana::RDGFile handle(rdg_handle);
+
+  constexpr uint32_t kNumSlices = 3;
+  std::vector<katana::RDGSlice::SliceArg> slice_args = KATANA_CHECKED(
+      katana::RDGSlice::ComputeSliceArgs(rdg_handle, kNumSlices));
+  KATANA_LOG_ASSERT(slice_args.size() == kNumSlices);
+
+  std::vector<katana::RDGSlice> rdg_slices =
+      KATANA_CHECKED(katana::RDGSlice::MakeMany(rdg_handle, slice_args));
+  KATANA_LOG_ASSERT(rdg_slices.size() == kNumSlices);
+
+  uint64_t next_node = 0;
+  uint64_t next_edge = 0;
+  for (uint32_t i = 0; i < kNumSlices; ++i) {
+    const katana::RDGSlice::SliceArg& arg = slice_args[i];
+    KATANA_LOG_ASSERT(arg.node_range.first == next_node);
+    KATANA_LOG_ASSERT(arg.edge_range.first == next_edge);
+    next_node = arg.node_range.second;
+    next_edge = arg.edge_range.second;
+
+    const katana::RDGSlice& rdg_slice = rdg_slices[i];
+    KATANA_LOG_ASSERT(
+        rdg_slice.node_properties()->num_rows() ==
+        static_cast<int64_t>(arg.node_range.second - arg.node_range.first));
+    KATANA_LOG_ASSERT(
+        rdg_slice.edge_properties()->num_rows() ==
+        static_cast<int64_t>(arg.edge_range.second - arg.edge_range.first));
+    KATANA_LOG_ASSERT(
+        rdg_slice.node_properties()->num_columns() ==
+        rdg_slice.full_node_schema()->num_fields());
+  }
+  KATANA_LOG_ASSERT(next_node > 0 && next_edge > 0);
+
+  // The same slices from their node boundaries
+  std::vector<uint64_t> boundaries{0};
+  for (const auto& arg : slice_args) {
+    boundaries.emplace_back(arg.node_range.second);
+  }
+  std::vector<katana::RDGSlice::SliceArg> given_args = KATANA_CHECKED(
+      katana::RDGSlice::ComputeSliceArgs(rdg_handle, boundaries));
+  KATANA_LOG_ASSERT(given_args.size() == kNumSlices);
+  for (uint32_t i = 0; i < kNumSlices; ++i) {
+    KATANA_LOG_ASSERT(given_args[i].node_range == slice_args[i].node_range);
+    KATANA_LOG_ASSERT(given_args[i].edge_range == slice_args[i].edge_range);
+    KATANA_LOG_ASSERT(given_args[i].topo_off == slice_args[i].topo_off);
+    KATANA_LOG_ASSERT(given_args[i].topo_size == slice_args[i].topo_size);
+  }
+
+  boundaries.back() += 1;
+  KATANA_LOG_ASSERT(
+      !katana::RDGSlice::ComputeSliceArgs(rdg_handle, boundaries));
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& path_to_manifest) {
   katana::URI uri = KATANA_CHECKED(katana::URI::Make(path_to_manifest));
   KATANA_CHECKED(TestPropertyLoading(uri));
+  KATANA_CHECKED(TestMakeMany(uri));
   return katana::ResultSuccess();
 }
 }  // namespace
@@ -108,6 +108,19 @@ ValidateLSHIndex(katana::RDKLSHIndexPrimitive& index) {
   KATANA_LOG_ASSERT(index.hash_structure() == GenerateHashes());
   KATANA_LOG_ASSERT(index.fingerprints() == GenerateFingerprints());
   KATANA_LOG_ASSERT(index.smiles() == GenerateSmiles());
+
+  // The packed arrays are read in place.
+  auto ids = index.Find(128 + 2 * 64 + 5, 5);
+  KATANA_LOG_ASSERT(
+      std::vector<uint64_t>(ids.begin(), ids.end()) ==
+      std::vector<uint64_t>({2, 5, 7}));
+  KATANA_LOG_ASSERT(index.Find(0, 5).empty());
+  KATANA_LOG_ASSERT(index.Find(128, 1).empty());
+  KATANA_LOG_ASSERT(index.fingerprint_size(3) == 3);
+  KATANA_LOG_ASSERT(index.fingerprint_words(3).size() == 1);
+  KATANA_LOG_ASSERT(index.fingerprint_words(3)[0] == 0b111);
+  KATANA_LOG_ASSERT(index.fingerprint_words(0).empty());
+  KATANA_LOG_ASSERT(index.smile(1) == "smile2");
 }
 
 void
@@ -117,4 +130,22 @@ ValidateSubstructIndex(katana::RDKSubstructureIndexPrimitive& index) {
   KATANA_LOG_ASSERT(index.index() == GenerateIndices());
   KATANA_LOG_ASSERT(index.fingerprints() == GenerateFingerprints());
   KATANA_LOG_ASSERT(index.smiles() == GenerateSmiles());
+
+  // The packed arrays are read in place.
+  KATANA_LOG_ASSERT(index.index_entry(3).size() == 64);
+  KATANA_LOG_ASSERT(index.index_entry(3)[4] == 7);
+  KATANA_LOG_ASSERT(index.fingerprint_size(2) == 2);
+  KATANA_LOG_ASSERT(index.fingerprint_words(2)[0] == 0b11);
+  KATANA_LOG_ASSERT(index.smile(3) == "smile4");
+
+  katana::DynamicBitset query;
+  query.resize(2);
+  query.set(0);
+  query.set(1);
+  KATANA_LOG_ASSERT(
+      index.ScreenSubstructures(query) == std::vector<uint64_t>({2, 3}));
+  auto similarities = index.TanimotoSimilarities(query);
+  KATANA_LOG_ASSERT(similarities);
+  KATANA_LOG_ASSERT(
+      similarities.value() == std::vector<double>({0, 0.5, 1, 2.0 / 3}));
 }
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "katana/EntityTypeManager.h"
 #include "katana/Logging.h"
 
@@ -67,8 +69,39 @@ ValidateConstructor() {
   }
 }
 
+void
+HasTypeTable() {
+  katana::EntityTypeManager mgr;
+  auto alice =
+      mgr.GetOrAddNonAtomicEntityTypeFromStrings(katana::TypeNameSet{"alice"});
+  auto alice_baker = mgr.GetOrAddNonAtomicEntityTypeFromStrings(
+      katana::TypeNameSet{"alice", "baker"});
+  auto charlie = mgr.GetOrAddNonAtomicEntityTypeFromStrings(
+      katana::TypeNameSet{"charlie"});
+  KATANA_LOG_ASSERT(alice && alice_baker && charlie);
+
+  std::vector<uint8_t> table = mgr.MakeHasTypeTable(alice.value());
+  KATANA_LOG_ASSERT(table.size() == mgr.GetNumEntityTypes());
+  for (size_t id = 0; id < table.size(); ++id) {
+    KATANA_LOG_ASSERT(
+        static_cast<bool>(table[id]) == mgr.IsSubtypeOf(alice.value(), id));
+  }
+  KATANA_LOG_ASSERT(table[alice.value()] == 1);
+  KATANA_LOG_ASSERT(table[alice_baker.value()] == 1);
+  KATANA_LOG_ASSERT(table[charlie.value()] == 0);
+  KATANA_LOG_ASSERT(table[katana::kUnknownEntityType] == 0);
+
+  // every type has the unknown type
+  std::vector<uint8_t> unknown =
+      mgr.MakeHasTypeTable(katana::kUnknownEntityType);
+  KATANA_LOG_ASSERT(
+      std::count(unknown.begin(), unknown.end(), 1) ==
+      static_cast<int64_t>(unknown.size()));
+}
+
 int
 main() {
   CreateEntityTypeIDs();
   ValidateConstructor();
+  HasTypeTable();
 }
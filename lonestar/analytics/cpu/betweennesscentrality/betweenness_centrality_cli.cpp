@@ -61,14 +61,31 @@ static cll::opt<BetweennessCentralityPlan::Algorithm> algo(
         clEnumValN(
             BetweennessCentralityPlan::kLevel, "Level",
             "Level parallel algorithm"),
-        // clEnumValN(BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
+        clEnumValN(
+            BetweennessCentralityPlan::kAsynchronous, "Async",
+            "Asynchronous worklist algorithm"),
         clEnumValN(
             BetweennessCentralityPlan::kOuter, "Outer",
-            "Outer parallel algorithm")
+            "Outer parallel algorithm"),
+        clEnumValN(
+            BetweennessCentralityPlan::kApproximate, "Approximate",
+            "Sample sources until within -epsilon with probability "
+            "1 - delta")
         // clEnumValN(BetweennessCentralityPlan::kAutoAlgo, "Auto", "Auto: choose among the algorithms automatically")
         ),
     cll::init(BetweennessCentralityPlan::kLevel));
 
+static cll::opt<double> epsilon(
+    "epsilon",
+    cll::desc("Error bound of Approximate as a fraction of n * (n - 1) "
+              "(default value 0.01)"),
+    cll::init(BetweennessCentralityPlan::kDefaultEpsilon));
+static cll::opt<double> delta(
+    "delta",
+    cll::desc("Probability that Approximate exceeds -epsilon (default value "
+              "0.1)"),
+    cll::init(BetweennessCentralityPlan::kDefaultDelta));
+
 static cll::opt<bool> thread_spin(
     "threadSpin",
     cll::desc("If enabled, threads busy-wait for work rather than use "
@@ -117,6 +134,9 @@ main(int argc, char** argv) {
 
   BetweennessCentralityPlan plan =
       BetweennessCentralityPlan::FromAlgorithm(algo);
+  if (algo == BetweennessCentralityPlan::kApproximate) {
+    plan = BetweennessCentralityPlan::Approximate(epsilon, delta);
+  }
 
   BetweennessCentralitySources sources = kBetweennessCentralityAllNodes;
   uint32_t num_sources = pg_projected_view->NumNodes();
@@ -157,6 +177,12 @@ main(int argc, char** argv) {
   } else {
     sources = num_sources;
   }
+  if (algo == BetweennessCentralityPlan::kApproximate) {
+    // Sources are sampled; -numberOfSources only caps their number
+    sources = numberOfSources.getNumOccurrences()
+                  ? BetweennessCentralitySources{uint32_t{numberOfSources}}
+                  : kBetweennessCentralityAllNodes;
+  }
 
   std::cout << "Running betweenness-centrality on " << num_sources
             << " sources\n";
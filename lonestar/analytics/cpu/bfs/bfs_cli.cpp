@@ -76,6 +76,13 @@ static cll::opt<bool> thread_spin(
               "condition variable (default false)"),
     cll::init(false));
 
+static cll::opt<uint32_t> multiSourceBatch(
+    "multiSourceBatch",
+    cll::desc("If set, run the BFS of all sources together in batches of "
+              "this many searches (a multiple of 64 up to 512) with "
+              "MultiSourceBfs (default value 0)"),
+    cll::init(0));
+
 static cll::opt<BfsPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm (default value SyncDO):"),
     cll::values(
@@ -170,6 +177,23 @@ main(int argc, char** argv) {
         std::istream_iterator<uint32_t>{});
   }
   uint32_t num_sources = startNodes.size();
+
+  if (multiSourceBatch) {
+    std::cout << "Running multi-source BFS for " << num_sources
+              << " sources\n";
+    katana::TxnContext txn_ctx;
+    auto stats_result = MultiSourceBfs(
+        pg_projected_view.get(), startNodes, "reach", &txn_ctx,
+        MultiSourceBfsPlan::BitParallel(multiSourceBatch));
+    if (!stats_result) {
+      KATANA_LOG_FATAL(
+          "Failed to run multi-source bfs {}", stats_result.error());
+    }
+    stats_result.value().Print();
+    totalTime.stop();
+    return 0;
+  }
+
   std::cout << "Running BFS for " << num_sources << " sources\n";
 
   for (auto start_node : startNodes) {
@@ -45,8 +45,10 @@ static cll::opt<CdlpPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm (default value Synchronous):"),
     cll::values(
         clEnumValN(
-            CdlpPlan::kSynchronous, "Synchronous",
-            "Synchronous algorithm")/*,
+            CdlpPlan::kSynchronous, "Synchronous", "Synchronous algorithm"),
+        clEnumValN(
+            CdlpPlan::kFrontier, "Frontier",
+            "Synchronous algorithm over the nodes near changed labels")/*,
 
 		/// TODO (Yasin): Asynchronous Algorithm will be implemented later after Synchronous
 		/// is done for both shared and distributed versions.
@@ -61,6 +63,8 @@ AlgorithmName(CdlpPlan::Algorithm algorithm) {
   switch (algorithm) {
   case CdlpPlan::kSynchronous:
     return "Synchronous";
+  case CdlpPlan::kFrontier:
+    return "Frontier";
   /// TODO (Yasin): Asynchronous Algorithm will be implemented later after Synchronous
   /// is done for both shared and distributed versions.
   /*
@@ -114,6 +118,9 @@ main(int argc, char** argv) {
   case CdlpPlan::kSynchronous:
     plan = CdlpPlan::Synchronous();
     break;
+  case CdlpPlan::kFrontier:
+    plan = CdlpPlan::Frontier();
+    break;
   /// TODO (Yasin): Asynchronous Algorithm will be implemented later after Synchronous
   /// is done for both shared and distributed versions.
   /*
@@ -127,15 +134,16 @@ main(int argc, char** argv) {
   }
 
   katana::TxnContext txn_ctx;
+  std::vector<uint64_t> changed_per_iteration;
   auto pg_result = Cdlp(
       pg_projected_view.get(), property_name, maxIterations, &txn_ctx,
-      symmetricGraph, plan);
+      symmetricGraph, plan, &changed_per_iteration);
   if (!pg_result) {
     KATANA_LOG_FATAL("Failed to run Cdlp: {}", pg_result.error());
   }
 
-  auto stats_result =
-      CdlpStatistics::Compute(pg_projected_view.get(), property_name);
+  auto stats_result = CdlpStatistics::Compute(
+      pg_projected_view.get(), property_name, changed_per_iteration);
   if (!stats_result) {
     KATANA_LOG_FATAL(
         "Failed to compute Cdlp statistics: {}", stats_result.error());
@@ -44,6 +44,22 @@ static cll::opt<unsigned int> report_node(
     "reportNode",
     cll::desc("Node to report the similarity of (default value 1)"),
     cll::init(1));
+static cll::opt<bool> similarity_join(
+    "similarityJoin",
+    cll::desc(
+        "Instead of comparing to the base node, find all pairs of similar "
+        "nodes (default value false)"),
+    cll::init(false));
+static cll::opt<double> join_threshold(
+    "joinThreshold",
+    cll::desc("Minimum similarity of the pairs of the similarity join"),
+    cll::init(katana::analytics::JaccardSimilarityJoinPlan::kDefaultThreshold));
+static cll::opt<unsigned int> join_top_k(
+    "joinTopK",
+    cll::desc(
+        "Number of most similar nodes to keep per node in the similarity "
+        "join; 0 keeps all pairs (default value 0)"),
+    cll::init(0));
 
 using NodeValue = katana::PODProperty<double>;
 
@@ -82,6 +98,24 @@ main(int argc, char** argv) {
             << pg_projected_view->topology().NumNodes() << " nodes, "
             << pg_projected_view->topology().NumEdges() << " edges\n";
 
+  if (similarity_join) {
+    auto plan = join_top_k > 0
+                    ? katana::analytics::JaccardSimilarityJoinPlan::TopK(
+                          join_top_k, join_threshold)
+                    : katana::analytics::JaccardSimilarityJoinPlan::
+                          PrefixFilter(join_threshold);
+    auto join_result = katana::analytics::JaccardSimilarityJoin(
+        pg_projected_view.get(), plan);
+    if (!join_result) {
+      KATANA_LOG_FATAL(
+          "Jaccard similarity join failed: {}", join_result.error());
+    }
+    std::cout << "Found " << join_result.value()->num_rows()
+              << " similar pairs\n";
+    totalTime.stop();
+    return 0;
+  }
+
   if (base_node >= pg_projected_view->topology().NumNodes() ||
       report_node >= pg_projected_view->topology().NumNodes()) {
     std::cerr << "failed to set report: " << report_node
@@ -47,8 +47,10 @@ static cll::opt<KCorePlan::Algorithm> algo(
         clEnumValN(
             KCorePlan::kSynchronous, "Synchronous", "Synchronous algorithm"),
         clEnumValN(
-            KCorePlan::kAsynchronous, "Asynchronous",
-            "Asynchronous algorithm")),
+            KCorePlan::kAsynchronous, "Asynchronous", "Asynchronous algorithm"),
+        clEnumValN(
+            KCorePlan::kBucketDecomposition, "BucketDecomposition",
+            "Core numbers of all nodes by bucketed peeling")),
     cll::init(KCorePlan::kSynchronous));
 
 //! Required k specification for k-core.
@@ -65,6 +67,8 @@ AlgorithmName(KCorePlan::Algorithm algorithm) {
     return "Synchronous";
   case KCorePlan::kAsynchronous:
     return "Asynchronous";
+  case KCorePlan::kBucketDecomposition:
+    return "BucketDecomposition";
   default:
     return "Unknown";
   }
@@ -115,6 +119,9 @@ main(int argc, char** argv) {
   case KCorePlan::kAsynchronous:
     plan = KCorePlan::Asynchronous();
     break;
+  case KCorePlan::kBucketDecomposition:
+    plan = KCorePlan::BucketDecomposition();
+    break;
   default:
     KATANA_LOG_FATAL("Invalid algorithm");
   }
@@ -50,7 +50,11 @@ static cll::opt<KTrussPlan::Algorithm> algo(
             KTrussPlan::kBsp, "Bsp", "Bulk-synchronous parallel (default)"),
         clEnumValN(
             KTrussPlan::kBspCoreThenTruss, "BspCoreThenTruss",
-            "Compute k-1 core and then k-truss")),
+            "Compute k-1 core and then k-truss"),
+        clEnumValN(
+            KTrussPlan::kBucketDecomposition, "BucketDecomposition",
+            "Compute the trussness of all edges and keep those of at least "
+            "k")),
     cll::init(KTrussPlan::kBsp));
 
 std::string
@@ -62,6 +66,8 @@ AlgorithmName(KTrussPlan::Algorithm algorithm) {
     return "BspJacobi";
   case KTrussPlan::kBspCoreThenTruss:
     return "BspCoreThenTruss";
+  case KTrussPlan::kBucketDecomposition:
+    return "BucketDecomposition";
   default:
     return "Unknown";
   }
@@ -118,6 +124,9 @@ main(int argc, char** argv) {
   case KTrussPlan::kBspCoreThenTruss:
     plan = KTrussPlan::BspCoreThenTruss();
     break;
+  case KTrussPlan::kBucketDecomposition:
+    plan = KTrussPlan::BucketDecomposition();
+    break;
   default:
     KATANA_LOG_FATAL("Invalid algorithm");
   }
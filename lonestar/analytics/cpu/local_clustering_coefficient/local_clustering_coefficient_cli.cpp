@@ -40,8 +40,16 @@ static cll::opt<LocalClusteringCoefficientPlan::Algorithm> algo(
         LocalClusteringCoefficientPlan::kOrderedCountPerThread,
         "orderedCountPerThread",
         "Ordered Simple Count using PerThreadStorage (default)")),
+    cll::values(clEnumValN(
+        LocalClusteringCoefficientPlan::kWedgeSampling, "wedgeSampling",
+        "Estimate from sampled wedges")),
     cll::init(LocalClusteringCoefficientPlan::kOrderedCountPerThread));
 
+static cll::opt<uint32_t> numSamples(
+    "numSamples",
+    cll::desc("Number of wedges sampled per node by wedgeSampling"),
+    cll::init(LocalClusteringCoefficientPlan::kDefaultNumSamples));
+
 static cll::opt<bool> relabel(
     "relabel",
     cll::desc("Relabel nodes of the graph (default value of false => "
@@ -96,6 +104,9 @@ main(int argc, char** argv) {
     plan =
         LocalClusteringCoefficientPlan::OrderedCountPerThread(relabeling_flag);
     break;
+  case LocalClusteringCoefficientPlan::kWedgeSampling:
+    plan = LocalClusteringCoefficientPlan::WedgeSampling(numSamples);
+    break;
   default:
     std::cerr << "Unknown algo: " << algo << "\n";
   }
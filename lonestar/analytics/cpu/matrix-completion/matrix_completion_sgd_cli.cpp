@@ -102,9 +102,15 @@ static cll::opt<bool> useDetInit(
 
 static cll::opt<MatrixCompletionPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm:"),
-    cll::values(clEnumValN(
-        MatrixCompletionPlan::kSGDByItems, "sgdByItems",
-        "Simple SGD on Items")),
+    cll::values(
+        clEnumValN(
+            MatrixCompletionPlan::kSGDByItems, "sgdByItems",
+            "Simple SGD on Items"),
+        clEnumValN(
+            MatrixCompletionPlan::kSGDTiled, "sgdTiled",
+            "SGD on strata of tiles of items by users"),
+        clEnumValN(
+            MatrixCompletionPlan::kALS, "als", "Alternating least squares")),
     cll::init(MatrixCompletionPlan::kSGDByItems));
 /*
  * Commandline options for different learning functions
@@ -154,6 +160,16 @@ main(int argc, char** argv) {
         maxUpdates, updatesPerEdge, fixedRounds, useExactError, useDetInit,
         learningRateFunction);
     break;
+  case MatrixCompletionPlan::kSGDTiled:
+    plan = MatrixCompletionPlan::SGDTiled(
+        learningRate, decayRate, lambda, tolerance, useSameLatentVector,
+        maxUpdates, fixedRounds, useDetInit, learningRateFunction);
+    break;
+  case MatrixCompletionPlan::kALS:
+    plan = MatrixCompletionPlan::ALS(
+        lambda, tolerance, useSameLatentVector, maxUpdates, fixedRounds,
+        useDetInit);
+    break;
   default:
     KATANA_LOG_FATAL("invalid algorithm");
   }
@@ -59,6 +59,12 @@ static cll::opt<bool> useCycleDetection(
               "(default false)"),
     cll::init(false));
 
+static cll::opt<bool> useStealing(
+    "useStealing",
+    cll::desc("Use the work-stealing deque worklist instead of "
+              "PerSocketChunkFIFO (parallel only) (default false)"),
+    cll::init(false));
+
 static cll::opt<unsigned> THRESHOLD_LS(
     "lsThreshold",
     cll::desc("Determines how many constraints to "
@@ -742,20 +748,28 @@ public:
     processLoadStore<katana::DoAll>(loadStoreConstraints, updates);
 
     while (!updates.empty()) {
-      katana::for_each(
-          katana::iterate(updates),
-          [this](unsigned req, auto& ctx) {
-            for (auto dst = this->outgoingEdges[req].begin();
-                 dst != this->outgoingEdges[req].end(); dst++) {
-              unsigned newPtsTo = this->propagate(req, *dst);
-
-              if (newPtsTo)
-                ctx.push(this->ocd.getFinalRepresentative(*dst));
-            }
-          },
-          katana::loopname("PointsToMainUpdateLoop"),
-          katana::disable_conflict_detection(),
-          katana::wl<katana::PerSocketChunkFIFO<8>>());
+      auto propagateUpdates = [this](unsigned req, auto& ctx) {
+        for (auto dst = this->outgoingEdges[req].begin();
+             dst != this->outgoingEdges[req].end(); dst++) {
+          unsigned newPtsTo = this->propagate(req, *dst);
+
+          if (newPtsTo)
+            ctx.push(this->ocd.getFinalRepresentative(*dst));
+        }
+      };
+      if (useStealing) {
+        katana::for_each(
+            katana::iterate(updates), propagateUpdates,
+            katana::loopname("PointsToMainUpdateLoop"),
+            katana::disable_conflict_detection(),
+            katana::wl<katana::StealingDeque<8>>());
+      } else {
+        katana::for_each(
+            katana::iterate(updates), propagateUpdates,
+            katana::loopname("PointsToMainUpdateLoop"),
+            katana::disable_conflict_detection(),
+            katana::wl<katana::PerSocketChunkFIFO<8>>());
+      }
 
       katana::gDebug("No of points-to facts computed = ", countPointsToFacts());
 
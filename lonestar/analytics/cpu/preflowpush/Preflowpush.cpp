@@ -47,6 +47,11 @@ static cll::opt<uint32_t> sinkID(
     "sinkNode", cll::desc("Sink node"), cll::Required);
 static cll::opt<bool> useHLOrder(
     "useHLOrder", cll::desc("Use HL ordering heuristic"), cll::init(false));
+static cll::opt<bool> useStealing(
+    "useStealing",
+    cll::desc("Use the work-stealing deque worklist instead of "
+              "PerSocketChunkFIFO (non-deterministic only)"),
+    cll::init(false));
 static cll::opt<bool> useUnitCapacity(
     "useUnitCapacity", cll::desc("Assume all capacities are unit"),
     cll::init(false));
@@ -497,6 +502,7 @@ struct PreflowPush {
     };
 
     typedef katana::PerSocketChunkFIFO<16> Chunk;
+    typedef katana::StealingDeque<16> StealingChunk;
     typedef katana::OrderedByIntegerMetric<decltype(obimIndexer), Chunk> OBIM;
 
     katana::InsertBag<GNode> initial;
@@ -510,6 +516,8 @@ struct PreflowPush {
       case nondet:
         if (useHLOrder) {
           nonDetDischarge(initial, counter, katana::wl<OBIM>(obimIndexer));
+        } else if (useStealing) {
+          nonDetDischarge(initial, counter, katana::wl<StealingChunk>());
         } else {
           nonDetDischarge(initial, counter, katana::wl<Chunk>());
         }
@@ -65,6 +65,17 @@ static cll::opt<double> forwardProbability(
 static cll::opt<double> numberOfWalks(
     "numberOfWalks", cll::desc("Number of walks per node"), cll::init(1));
 
+static cll::opt<uint64_t> seed(
+    "seed", cll::desc("Seed of the random numbers (only for Node2Vec)"),
+    cll::init(RandomWalksPlan::kDefaultSeed));
+
+static cll::opt<uint64_t> walksPerBatch(
+    "walksPerBatch",
+    cll::desc(
+        "If not 0, stream the walks to outputFile as a Parquet table in "
+        "batches of this many walks (only for Node2Vec)"),
+    cll::init(0));
+
 static cll::opt<uint32_t> numberOfEdgeTypes(
     "numberOfEdgeTypes", cll::desc("Number of edge types (only for Edge2Vec)"),
     cll::init(1));
@@ -128,7 +139,8 @@ main(int argc, char** argv) {
   switch (algo) {
   case RandomWalksPlan::kNode2Vec:
     plan = RandomWalksPlan::Node2Vec(
-        walkLength, numberOfWalks, backwardProbability, forwardProbability);
+        walkLength, numberOfWalks, backwardProbability, forwardProbability,
+        seed);
     break;
   case RandomWalksPlan::kEdge2Vec:
     plan = RandomWalksPlan::Edge2Vec(
@@ -139,6 +151,22 @@ main(int argc, char** argv) {
     KATANA_LOG_FATAL("Invalid algorithm");
   }
 
+  if (walksPerBatch > 0) {
+    std::string output_file = outputLocation + "/" + outputFile;
+    auto uri_res = katana::URI::Make(output_file);
+    if (!uri_res) {
+      KATANA_LOG_FATAL(
+          "output file {} error: {}", output_file, uri_res.error());
+    }
+    katana::gInfo("Streaming random walks to a Parquet table: ", output_file);
+    if (auto r = RandomWalksToParquet(
+            pg.get(), uri_res.value(), walksPerBatch, "", plan);
+        !r) {
+      KATANA_LOG_FATAL("Failed to run RandomWalks: {}", r.error());
+    }
+    return 0;
+  }
+
   auto walks_result = RandomWalks(pg.get(), plan);
   if (!walks_result) {
     KATANA_LOG_FATAL("Failed to run RandomWalks: {}", walks_result.error());
@@ -49,9 +49,9 @@ static cll::opt<Algo> algo(
 
 typedef int EdgeData;
 
-struct Node : public katana::UnionFindNode<Node> {
+struct Node {
+  //! lightest edge leaving the component, if this node is its root
   std::atomic<EdgeData*> lightest;
-  Node() : katana::UnionFindNode<Node>(const_cast<Node*>(this)) {}
 };
 
 typedef katana::LC_CSR_Graph<Node, EdgeData>::with_numa_alloc<
@@ -59,12 +59,6 @@ typedef katana::LC_CSR_Graph<Node, EdgeData>::with_numa_alloc<
 
 typedef Graph::GraphNode GNode;
 
-std::ostream&
-operator<<(std::ostream& os, const Node& n) {
-  os << "[id: " << &n << ", c: " << n.find() << "]";
-  return os;
-}
-
 struct Edge {
   GNode src;
   GNode dst;
@@ -89,6 +83,7 @@ struct ParallelAlgo {
   typedef katana::InsertBag<WorkItem> WL;
 
   Graph graph;
+  katana::UnionFind<GNode> components;
 
   WL wls[3];
   WL* current;
@@ -107,7 +102,6 @@ struct ParallelAlgo {
   static void findLightest(
       ParallelAlgo* self, const GNode& src, int cur, Context& ctx,
       Pending& pending) {
-    Node& sdata = self->graph.getData(src, katana::MethodFlag::UNPROTECTED);
     Graph::edge_iterator ii =
         self->graph.edge_begin(src, katana::MethodFlag::UNPROTECTED);
     Graph::edge_iterator ei =
@@ -117,19 +111,18 @@ struct ParallelAlgo {
 
     for (; ii != ei; ++ii, ++cur) {
       GNode dst = self->graph.getEdgeDst(ii);
-      Node& ddata = self->graph.getData(dst, katana::MethodFlag::UNPROTECTED);
       EdgeData& weight = self->graph.getEdgeData(ii);
       if (useLimit && weight > self->limit) {
         pending.push(WorkItem(src, dst, &weight, cur));
         return;
       }
-      Node* rep;
-      if ((rep = sdata.findAndCompress()) != ddata.findAndCompress()) {
-        // const EdgeData& weight = self->graph.getEdgeData(ii);
+      GNode rep;
+      if ((rep = self->components.Find(src)) != self->components.Find(dst)) {
+        Node& rdata = self->graph.getData(rep, katana::MethodFlag::UNPROTECTED);
         EdgeData* old;
         ctx.push(WorkItem(src, dst, &weight, cur));
-        while (weight < *(old = rep->lightest)) {
-          if (rep->lightest.compare_exchange_strong(old, &weight))
+        while (weight < *(old = rdata.lightest)) {
+          if (rdata.lightest.compare_exchange_strong(old, &weight))
             break;
         }
         return;
@@ -179,18 +172,18 @@ struct ParallelAlgo {
     template <typename Context, typename Pending>
     void operator()(const WorkItem& item, Context&, Pending&) const {
       GNode src = item.edge.src;
-      Node& sdata = self->graph.getData(src, katana::MethodFlag::UNPROTECTED);
-      Node* rep = sdata.findAndCompress();
-      int cur = item.cur;
+      Node& rdata = self->graph.getData(
+          self->components.Find(src), katana::MethodFlag::UNPROTECTED);
 
-      if (rep->lightest == item.edge.weight) {
+      if (rdata.lightest == item.edge.weight) {
         GNode dst = item.edge.dst;
-        Node& ddata = self->graph.getData(dst, katana::MethodFlag::UNPROTECTED);
-        if ((rep = sdata.merge(&ddata))) {
-          rep->lightest = &self->inf;
+        if (self->components.Union(src, dst)) {
+          GNode merged = self->components.Find(src);
+          Node& mdata =
+              self->graph.getData(merged, katana::MethodFlag::UNPROTECTED);
+          mdata.lightest = &self->inf;
           self->mst.push(Edge(src, dst, item.edge.weight));
         }
-        ++cur;
       }
     }
   };
@@ -279,8 +272,7 @@ struct ParallelAlgo {
     katana::GAccumulator<unsigned> roots;
 
     katana::do_all(katana::iterate(graph), [&roots, this](const GNode& n) {
-      const auto& data = graph.getData(n, katana::MethodFlag::UNPROTECTED);
-      if (data.isRep())
+      if (components.IsRoot(n))
         roots += 1;
     });
 
@@ -324,12 +316,10 @@ struct ParallelAlgo {
 
   bool verify() {
     auto is_bad_graph = [this](const GNode& n) {
-      Node& me = graph.getData(n);
       for (auto ii : graph.edges(n)) {
         GNode dst = graph.getEdgeDst(ii);
-        Node& data = graph.getData(dst);
-        if (me.findAndCompress() != data.findAndCompress()) {
-          std::cerr << "not in same component: " << me << " and " << data
+        if (!components.SameSet(n, dst)) {
+          std::cerr << "not in same component: " << n << " and " << dst
                     << "\n";
           return true;
         }
@@ -338,8 +328,7 @@ struct ParallelAlgo {
     };
 
     auto is_bad_mst = [this](const Edge& e) {
-      return graph.getData(e.src).findAndCompress() !=
-             graph.getData(e.dst).findAndCompress();
+      return !components.SameSet(e.src, e.dst);
     };
 
     if (katana::ParallelSTL::find_if(
@@ -363,6 +352,7 @@ struct ParallelAlgo {
       std::swap(symGraph, origGraph);
 
     katana::readGraph(graph, symGraph);
+    components.Reset(graph.size());
 
     katana::StatTimer Tsort("InitializeSortTime");
     Tsort.start();
@@ -40,9 +40,20 @@ static cll::opt<TriangleCountPlan::Algorithm> algo(
             TriangleCountPlan::kEdgeIteration, "edgeiterator", "Edge Iterator"),
         clEnumValN(
             TriangleCountPlan::kOrderedCount, "orderedCount",
-            "Ordered Simple Count (default)")),
+            "Ordered Simple Count (default)"),
+        clEnumValN(
+            TriangleCountPlan::kEdgeSampling, "edgeSampling",
+            "Estimate from sampled edges"),
+        clEnumValN(
+            TriangleCountPlan::kWedgeSampling, "wedgeSampling",
+            "Estimate from sampled wedges")),
     cll::init(TriangleCountPlan::kOrderedCount));
 
+static cll::opt<uint64_t> numSamples(
+    "numSamples",
+    cll::desc("Number of edges or wedges sampled by the sampling algorithms"),
+    cll::init(TriangleCountPlan::kDefaultNumSamples));
+
 static cll::opt<bool> relabel(
     "relabel",
     cll::desc("Relabel nodes of the graph (default value of false => "
@@ -100,18 +111,39 @@ main(int argc, char** argv) {
     plan = TriangleCountPlan::OrderedCount(relabeling_flag);
     break;
 
+  case TriangleCountPlan::kEdgeSampling:
+    plan = TriangleCountPlan::EdgeSampling(numSamples);
+    break;
+
+  case TriangleCountPlan::kWedgeSampling:
+    plan = TriangleCountPlan::WedgeSampling(numSamples);
+    break;
+
   default:
     std::cerr << "Unknown algo: " << algo << "\n";
   }
 
-  auto num_triangles_result = TriangleCount(pg_projected_view.get(), plan);
-  if (!num_triangles_result) {
-    KATANA_LOG_FATAL(
-        "failed to run algorithm: {}", num_triangles_result.error());
+  if (algo == TriangleCountPlan::kEdgeSampling ||
+      algo == TriangleCountPlan::kWedgeSampling) {
+    auto estimate_result =
+        EstimateTriangleCount(pg_projected_view.get(), plan);
+    if (!estimate_result) {
+      KATANA_LOG_FATAL("failed to run algorithm: {}", estimate_result.error());
+    }
+    auto estimate = estimate_result.value();
+    std::cout << "NumTriangles: " << estimate.estimate << " ("
+              << plan.confidence() * 100 << "% confidence interval ["
+              << estimate.lower << ", " << estimate.upper << "])\n";
+  } else {
+    auto num_triangles_result = TriangleCount(pg_projected_view.get(), plan);
+    if (!num_triangles_result) {
+      KATANA_LOG_FATAL(
+          "failed to run algorithm: {}", num_triangles_result.error());
+    }
+    auto num_triangles = num_triangles_result.value();
+
+    std::cout << "NumTriangles: " << num_triangles << "\n";
   }
-  auto num_triangles = num_triangles_result.value();
-
-  std::cout << "NumTriangles: " << num_triangles << "\n";
 
   totalTime.stop();
 
@@ -1,79 +1,110 @@
-from collections import OrderedDict
-
 import metagraph as mg
 import networkx as nx
 import numpy as np
 import pyarrow
 from metagraph import translator
 from metagraph.plugins.networkx.types import NetworkXGraph
+from metagraph.plugins.scipy.types import ScipyGraph
 from scipy.sparse import csr_matrix
 
-from katana.local.import_data import from_csr
+from katana.local.import_data import from_csr, from_edge_list_arrays
 
 from .types import KatanaGraph
 
+WEIGHT_PROP_NAME = "value_from_translator"
 
-@translator
-def networkx_to_katanagraph(x: NetworkXGraph, **props) -> KatanaGraph:
-    aprops = NetworkXGraph.Type.compute_abstract_properties(x, {"node_dtype", "node_type", "edge_type", "is_directed"})
-    is_weighted = aprops["edge_type"] == "map"
-    # get the edge list directly from the NetworkX Graph
-    elist_raw = list(x.value.edges(data=True))
-    # sort the eddge list and node list
-    if aprops["is_directed"]:
-        elist = sorted(elist_raw, key=lambda each: (each[0], each[1]))
+
+def _csr_to_katanagraph(matrix, node_list, is_weighted, is_directed) -> KatanaGraph:
+    """
+    Build a Katana graph from a CSR matrix with the bulk (array) builders, whose rows and columns are the positions of
+    the nodes in ``node_list``; None means the nodes are 0 to n - 1.
+    """
+    matrix = csr_matrix(matrix)
+    matrix.sort_indices()
+    weights = matrix.data
+    if node_list is None or np.array_equal(node_list, np.arange(len(node_list))):
+        # the CSR arrays are the topology, with the first 0 of indptr excluded
+        pg = from_csr(matrix.indptr[1:].astype(np.uint64), matrix.indices.astype(np.uint32))
+        if is_weighted:
+            pg.add_edge_property(pyarrow.table({WEIGHT_PROP_NAME: weights}))
     else:
-        inv_elist = [(each[1], each[0], each[2]) for each in elist_raw]
-        elist = sorted(elist_raw + inv_elist, key=lambda each: (each[0], each[1]))
-    nlist = sorted(list(x.value.nodes(data=True)), key=lambda each: each[0])
-    # build the CSR format from the edge list (weight, (src, dst))
-    row = np.array([each_edge[0] for each_edge in elist])
-    col = np.array([each_edge[1] for each_edge in elist])
-    data = np.array([each_edge[2]["weight"] for each_edge in elist])
-    csr = csr_matrix((data, (row, col)), shape=(len(nlist), len(nlist)))
-    # call the katana api to build a Graph (unweighted) from the CSR format
-    # noting that the first 0 in csr.indptr is excluded
-    pg = from_csr(csr.indptr[1:], csr.indices)
-    # add the edge weight as a new property
-    t = pyarrow.table(dict(value_from_translator=data))
-    pg.add_edge_property(t)
-    # use the metagraph's Graph warpper to wrap the katana.local.Graph
+        node_list = np.asarray(node_list)
+        sources = node_list[np.repeat(np.arange(matrix.shape[0]), np.diff(matrix.indptr))]
+        # the builder reorders the weights with the edges
+        pg = from_edge_list_arrays(
+            sources, node_list[matrix.indices], {WEIGHT_PROP_NAME: weights} if is_weighted else None
+        )
     return KatanaGraph(
         pg_graph=pg,
         is_weighted=is_weighted,
-        edge_weight_prop_name="value_from_translator",
-        is_directed=aprops["is_directed"],
+        edge_weight_prop_name=WEIGHT_PROP_NAME,
+        is_directed=is_directed,
         node_weight_index=0,
+        edge_dtype="float" if weights.dtype.kind == "f" else "int",
     )
 
 
+def _katanagraph_to_csr(x: KatanaGraph) -> csr_matrix:
+    """
+    :return: the topology (and weights) of ``x`` as a canonical CSR matrix. The index arrays start as views of the
+        graph topology; making the matrix canonical, sorted without duplicates, is vectorized in SciPy.
+    """
+    pg = x.value
+    topology = pg.topology_arrays()
+    indptr = np.concatenate(([0], topology["adj_indices"]))
+    if x.is_weighted:
+        weights = pg.get_edge_property(x.edge_weight_prop_name).to_numpy()
+        data = weights[topology["edge_property_indices"]]
+    else:
+        data = np.ones(len(topology["dests"]), dtype=np.bool_)
+    n = pg.num_nodes()
+    matrix = csr_matrix((data, topology["dests"], indptr), shape=(n, n))
+    canonical = matrix.copy()
+    canonical.sum_duplicates()
+    if canonical.nnz != matrix.nnz:
+        raise ValueError("metagraph does not support graph with duplicated edges")
+    return canonical
+
+
+@translator
+def scipy_to_katanagraph(x: ScipyGraph, **props) -> KatanaGraph:
+    aprops = ScipyGraph.Type.compute_abstract_properties(x, {"edge_type", "is_directed"})
+    return _csr_to_katanagraph(x.value, x.node_list, aprops["edge_type"] == "map", aprops["is_directed"])
+
+
+@translator
+def katanagraph_to_scipy(x: KatanaGraph, **props) -> ScipyGraph:
+    matrix = _katanagraph_to_csr(x)
+    aprops = {"is_directed": x.is_directed, "edge_type": "map" if x.is_weighted else "set"}
+    return ScipyGraph(matrix, None, aprops=aprops)
+
+
+@translator
+def networkx_to_katanagraph(x: NetworkXGraph, **props) -> KatanaGraph:
+    aprops = NetworkXGraph.Type.compute_abstract_properties(x, {"node_dtype", "node_type", "edge_type", "is_directed"})
+    is_weighted = aprops["edge_type"] == "map"
+    nlist = sorted(x.value.nodes())
+    # an undirected graph gives a symmetric matrix, the symmetric edges that stand for an undirected edge in Katana
+    to_scipy = getattr(nx, "to_scipy_sparse_array", None) or nx.to_scipy_sparse_matrix
+    matrix = to_scipy(x.value, nodelist=nlist, weight="weight", format="csr")
+    return _csr_to_katanagraph(matrix, None, is_weighted, aprops["is_directed"])
+
+
 @translator
 def katanagraph_to_networkx(x: KatanaGraph, **props) -> NetworkXGraph:
     pg = x.value
-    dest_list = [dest for src in pg.nodes() for dest in [pg.get_edge_dst(e) for e in pg.out_edge_ids(src)]]
-    for src in pg.nodes():
-        if len(pg.out_edge_ids(src)) == 0:
-            if src not in dest_list:
-                raise ValueError("NetworkX does not support graph with isolated nodes")
-    edge_dict_count = {
-        (src, dest): 0 for src in pg.nodes() for dest in [pg.get_edge_dst(e) for e in pg.out_edge_ids(src)]
-    }
-    for src in pg.nodes():
-        for dest in [pg.get_edge_dst(e) for e in pg.out_edge_ids(src)]:
-            edge_dict_count[(src, dest)] += 1
-            if edge_dict_count[(src, dest)] > 1:
-                raise ValueError("NetworkX does not support graph with duplicated edges")
-    elist = []
-    edge_weights = pg.get_edge_property(x.edge_weight_prop_name).to_pandas()
-    if isinstance(edge_weights[0], np.int64):
-        elist = [(nid, pg.get_edge_dst(j), int(edge_weights[j])) for nid in pg.nodes() for j in pg.out_edge_ids(nid)]
-    elif isinstance(edge_weights[0], pyarrow.lib.Int64Scalar):
-        elist = [(nid, pg.get_edge_dst(j), edge_weights[j].as_py()) for nid in pg.nodes() for j in pg.out_edge_ids(nid)]
-        # TODO(pengfei): add more type conversion support: like np.float64 -> float??
-    elist = list(OrderedDict.fromkeys(elist))
+    topology = pg.topology_arrays()
+    degrees = np.diff(np.concatenate(([0], topology["adj_indices"])))
+    in_degrees = np.bincount(topology["dests"], minlength=pg.num_nodes())
+    if np.any((degrees == 0) & (in_degrees == 0)):
+        raise ValueError("NetworkX does not support graph with isolated nodes")
+    matrix = _katanagraph_to_csr(x).tocoo()
     if x.is_directed:
         graph = nx.DiGraph()
     else:
         graph = nx.Graph()
-    graph.add_weighted_edges_from(elist)
+    if x.is_weighted:
+        graph.add_weighted_edges_from(zip(matrix.row.tolist(), matrix.col.tolist(), matrix.data.tolist()))
+    else:
+        graph.add_edges_from(zip(matrix.row.tolist(), matrix.col.tolist()))
     return mg.wrappers.Graph.NetworkXGraph(graph)
@@ -85,3 +85,23 @@ def test_compare_edge_count(nx_from_kg_di_8_12, katanagraph_cleaned_8_12_di):
                 edge_dict_count[(src, dest)] += 1
     assert sum([edge_dict_count[i] for i in edge_dict_count]) == katanagraph_cleaned_8_12_di.value.num_edges()
     assert len(list(nx_from_kg_di_8_12.value.edges(data=True))) == katanagraph_cleaned_8_12_di.value.num_edges()
+
+
+def test_scipy_round_trip(katanagraph_cleaned_8_12_di):
+    sg = mg.translate(katanagraph_cleaned_8_12_di, mg.wrappers.Graph.ScipyGraph)
+    matrix = sg.value
+    assert matrix.shape == (8, 8)
+    assert matrix.nnz == 12
+    assert matrix[0, 4] == 7
+    assert matrix[5, 7] == 6
+    kg = mg.translate(sg, mg.wrappers.Graph.KatanaGraph)
+    assert kg.value.num_nodes() == 8
+    assert kg.value.num_edges() == 12
+    assert [kg.value.get_edge_dst(i) for i in kg.value.out_edge_ids(2)] == [4, 5, 6]
+    assert kg.value.get_edge_property("value_from_translator").to_pylist() == [4, 2, 7, 3, 5, 5, 2, 8, 1, 4, 4, 6]
+
+
+def test_scipy_undirected(katanagraph_cleaned_8_12_ud):
+    sg = mg.translate(katanagraph_cleaned_8_12_ud, mg.wrappers.Graph.ScipyGraph)
+    assert sg.value.nnz == 24
+    assert (sg.value != sg.value.T).nnz == 0
@@ -29,7 +29,7 @@ from katana.plugin import installed_plugins
 
 try:
     import katana.globals
-    from katana.globals import get_active_threads, set_active_threads, set_busy_wait
+    from katana.globals import ThreadGroup, get_active_threads, set_active_threads, set_busy_wait
 
     __version__ = katana.globals.get_version()
 
@@ -59,6 +59,7 @@ __all__ = [
     "get_active_threads",
     "set_active_threads",
     "set_busy_wait",
+    "ThreadGroup",
     "DataFrame",
 ]
 
@@ -0,0 +1,23 @@
+"""
+:py:mod:`katana.benchmark` runs the analytics algorithms end to end, with every plan of each algorithm, on a fixed set
+of generated and real graphs and at several thread counts. Each run reports its time, GTEPS (graph edges divided by
+the run time, in billions per second), peak resident set size and graph load time as JSON, so results can be compared
+between releases.
+
+The suite can be invoked from the command-line by running (with the Katana library installed):
+
+.. code-block:: sh
+
+   python -m katana.benchmark --threads 1 8 --output results.json
+
+Use ``--list`` to see the available datasets and algorithms and ``--help`` to get more information about the
+command.
+
+The generated datasets follow the GAP benchmark suite: ``kron`` is a Kronecker (Graph500 R-MAT) graph and ``urand`` is
+a uniform random graph, both symmetric with an average degree of 32 and integer edge weights in [1, 255]. The real
+datasets are RDGs from the Katana test datasets.
+"""
+
+from .suite import ALGORITHMS, DATASETS, Algorithm, Dataset, run_one, run_suite
+
+__all__ = ["ALGORITHMS", "DATASETS", "Algorithm", "Dataset", "run_one", "run_suite"]
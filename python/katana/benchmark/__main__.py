@@ -0,0 +1,65 @@
+import argparse
+import json
+import os
+import sys
+from pathlib import Path
+
+from katana.benchmark import ALGORITHMS, DATASETS, run_one, run_suite
+from katana.benchmark.suite import DEFAULT_SCALE
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        prog=f"{Path(sys.executable).name} -m katana.benchmark",
+        description="""
+        Run the analytics benchmark suite and output its results as JSON.
+        """,
+    )
+
+    parser.add_argument(
+        "--datasets", help="The datasets to run on (default: all).", nargs="+", choices=DATASETS, default=None
+    )
+    parser.add_argument(
+        "--algorithms", help="The algorithms to run (default: all).", nargs="+", choices=ALGORITHMS, default=None
+    )
+    parser.add_argument(
+        "--threads",
+        help="The thread counts to run at (default: 1 and the number of CPUs).",
+        nargs="+",
+        type=int,
+        default=sorted({1, os.cpu_count() or 1}),
+    )
+    parser.add_argument("--repetitions", help="The number of runs of each plan.", type=int, default=3)
+    parser.add_argument(
+        "--scale", help="The log2 of the number of nodes of generated datasets.", type=int, default=DEFAULT_SCALE
+    )
+    parser.add_argument("--output", help="Output the results to the given path instead of stdout.", default=None)
+    parser.add_argument("--list", help="List the datasets, algorithms and plans and exit.", action="store_true")
+    parser.add_argument("--run-one", help=argparse.SUPPRESS, default=None)
+
+    args = parser.parse_args()
+
+    if args.run_one:
+        # A single run in its own process, see run_suite
+        json.dump(run_one(**json.loads(args.run_one)), sys.stdout)
+        sys.exit(0)
+
+    if args.list:
+        print("Datasets:", " ".join(DATASETS))
+        for algorithm in ALGORITHMS.values():
+            print(f"{algorithm.name}:", " ".join(algorithm.plans))
+        sys.exit(0)
+
+    results = run_suite(
+        datasets=args.datasets,
+        algorithms=args.algorithms,
+        threads=args.threads,
+        repetitions=args.repetitions,
+        scale=args.scale,
+        log=sys.stderr,
+    )
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+    else:
+        json.dump(results, sys.stdout, indent=2)
+        print()
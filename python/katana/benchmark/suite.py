@@ -0,0 +1,477 @@
+import json
+import resource
+import subprocess
+import sys
+from dataclasses import dataclass
+from typing import Any, Callable, Dict, Iterable, List, Optional
+
+import numpy as np
+import pyarrow
+
+from katana import set_active_threads
+from katana.example_data import get_rdg_dataset
+from katana.local import Graph, analytics
+from katana.local.import_data import from_csr
+from katana.timer import Timer
+
+__all__ = ["Dataset", "Algorithm", "DATASETS", "ALGORITHMS", "run_one", "run_suite"]
+
+WEIGHT_PROPERTY_NAME = "value"
+OUTPUT_PROPERTY_NAME = "benchmark_output"
+
+# The average undirected degree of the generated graphs, as in GAP
+EDGE_FACTOR = 16
+DEFAULT_SCALE = 16
+
+
+@dataclass(frozen=True)
+class Dataset:
+    """
+    A graph the suite runs on.
+
+    :ivar load: Load or generate the graph, given the scale of generated graphs.
+    :ivar symmetric: True if every edge of the graph has a reverse edge.
+    :ivar weight_property_name: The edge property algorithms that need weights use, or None if the graph has none.
+    """
+
+    name: str
+    load: Callable[[int], Graph]
+    symmetric: bool
+    weight_property_name: Optional[str] = WEIGHT_PROPERTY_NAME
+
+
+@dataclass(frozen=True)
+class Algorithm:
+    """
+    An algorithm the suite runs, with every plan of it.
+
+    :ivar plans: The plans to run, by name, each made by calling it.
+    :ivar run: Run the algorithm on a graph of a dataset with a plan and a source node, for algorithms that start from
+        one, writing its output, if any, to ``OUTPUT_PROPERTY_NAME``.
+    :ivar setup: Prepare a graph before the algorithms run on it, e.g., sort its edges; not timed.
+    :ivar needs_symmetric: True if the algorithm only runs on symmetric graphs.
+    :ivar needs_weights: True if the algorithm needs an edge weight property.
+    """
+
+    name: str
+    plans: Dict[str, Callable[[], Any]]
+    run: Callable[[Graph, Dataset, Any, int], Any]
+    setup: Optional[Callable[[Graph, str], None]] = None
+    needs_symmetric: bool = False
+    needs_weights: bool = False
+
+    def runs_on(self, dataset: Dataset) -> bool:
+        return (dataset.symmetric or not self.needs_symmetric) and (
+            dataset.weight_property_name is not None or not self.needs_weights
+        )
+
+
+def _symmetric_graph(sources: np.ndarray, destinations: np.ndarray, num_nodes: int, rng) -> Graph:
+    """
+    Build a symmetric graph from an edge list, without self loops or duplicate edges, with random weights in
+    [1, 255]. This is how GAP builds its undirected graphs.
+    """
+    keep = sources != destinations
+    sources, destinations = sources[keep], destinations[keep]
+    keys = np.unique(
+        np.concatenate(
+            [
+                (sources.astype(np.uint64) << np.uint64(32)) | destinations,
+                (destinations.astype(np.uint64) << np.uint64(32)) | sources,
+            ]
+        )
+    )
+    sources = (keys >> np.uint64(32)).astype(np.uint32)
+    destinations = (keys & np.uint64(0xFFFFFFFF)).astype(np.uint32)
+    edge_indices = np.cumsum(np.bincount(sources, minlength=num_nodes)).astype(np.uint64)
+    graph = from_csr(edge_indices, destinations)
+    weights = rng.integers(1, 256, size=len(destinations), dtype=np.uint32)
+    graph.add_edge_property(pyarrow.table({WEIGHT_PROPERTY_NAME: weights}))
+    return graph
+
+
+def generate_kronecker(scale: int, seed: int = 0) -> Graph:
+    """
+    Generate a Kronecker graph of ``2 ** scale`` nodes with the Graph500 R-MAT parameters (A, B, C) = (0.57, 0.19,
+    0.19), like the GAP ``kron`` graph.
+    """
+    a, b, c = 0.57, 0.19, 0.19
+    rng = np.random.default_rng(seed)
+    num_nodes = 1 << scale
+    num_edges = EDGE_FACTOR * num_nodes
+    sources = np.zeros(num_edges, dtype=np.uint32)
+    destinations = np.zeros(num_edges, dtype=np.uint32)
+    for bit in range(scale):
+        r = rng.random(num_edges)
+        sources |= (r >= a + b).astype(np.uint32) << np.uint32(bit)
+        destinations |= (((r >= a) & (r < a + b)) | (r >= a + b + c)).astype(np.uint32) << np.uint32(bit)
+    # Permute the node IDs so that the high degree nodes are not clustered at the start
+    permutation = rng.permutation(num_nodes).astype(np.uint32)
+    return _symmetric_graph(permutation[sources], permutation[destinations], num_nodes, rng)
+
+
+def generate_uniform(scale: int, seed: int = 0) -> Graph:
+    """
+    Generate a uniform random graph of ``2 ** scale`` nodes, like the GAP ``urand`` graph.
+    """
+    rng = np.random.default_rng(seed)
+    num_nodes = 1 << scale
+    num_edges = EDGE_FACTOR * num_nodes
+    sources = rng.integers(0, num_nodes, size=num_edges, dtype=np.uint32)
+    destinations = rng.integers(0, num_nodes, size=num_edges, dtype=np.uint32)
+    return _symmetric_graph(sources, destinations, num_nodes, rng)
+
+
+def _rdg(name: str) -> Callable[[int], Graph]:
+    def load(scale):
+        _ = scale
+        return Graph(get_rdg_dataset(name))
+
+    return load
+
+
+DATASETS: Dict[str, Dataset] = {
+    d.name: d
+    for d in [
+        Dataset("kron", generate_kronecker, symmetric=True),
+        Dataset("urand", generate_uniform, symmetric=True),
+        Dataset("rmat10", _rdg("rmat10"), symmetric=False),
+        Dataset("rmat10_symmetric", _rdg("rmat10_symmetric"), symmetric=True),
+        Dataset(
+            "rmat15_cleaned_symmetric", _rdg("rmat15_cleaned_symmetric"), symmetric=True, weight_property_name=None
+        ),
+        Dataset("ldbc_003", _rdg("ldbc_003"), symmetric=False, weight_property_name="workFrom"),
+    ]
+}
+
+
+def _source_node(graph: Graph) -> int:
+    """
+    :return: The node of highest out degree, which GAP-style traversals start from so that they reach the bulk of the
+        graph.
+    """
+    edge_indices = np.asarray(graph.topology_arrays()["adj_indices"])
+    return int(np.argmax(np.diff(edge_indices, prepend=np.uint64(0))))
+
+
+def _sort_edges(graph: Graph, plan_name: str):
+    _ = plan_name
+    analytics.sort_all_edges_by_dest(graph)
+
+
+ALGORITHMS: Dict[str, Algorithm] = {
+    a.name: a
+    for a in [
+        Algorithm(
+            "bfs",
+            {
+                "asynchronous": analytics.BfsPlan.asynchronous,
+                "asynchronous_tile": analytics.BfsPlan.asynchronous_tile,
+                "synchronous": analytics.BfsPlan.synchronous,
+                "synchronous_tile": analytics.BfsPlan.synchronous_tile,
+                "synchronous_direction_opt": analytics.BfsPlan.synchronous_direction_opt,
+            },
+            lambda g, d, p, s: analytics.bfs(g, s, OUTPUT_PROPERTY_NAME, p),
+        ),
+        Algorithm(
+            "sssp",
+            {
+                "delta_tile": analytics.SsspPlan.delta_tile,
+                "delta_step": analytics.SsspPlan.delta_step,
+                "delta_step_barrier": analytics.SsspPlan.delta_step_barrier,
+                "delta_step_fusion": analytics.SsspPlan.delta_step_fusion,
+                "delta_step_adaptive": analytics.SsspPlan.delta_step_adaptive,
+                "multi_queue": analytics.SsspPlan.multi_queue,
+                "serial_delta_tile": analytics.SsspPlan.serial_delta_tile,
+                "serial_delta": analytics.SsspPlan.serial_delta,
+                "dijkstra_tile": analytics.SsspPlan.dijkstra_tile,
+                "dijkstra": analytics.SsspPlan.dijkstra,
+            },
+            lambda g, d, p, s: analytics.sssp(g, s, d.weight_property_name, OUTPUT_PROPERTY_NAME, p),
+            needs_weights=True,
+        ),
+        Algorithm(
+            "ksssp",
+            {
+                "delta_tile": analytics.KssspPlan.delta_tile,
+                "delta_step": analytics.KssspPlan.delta_step,
+                "delta_step_barrier": analytics.KssspPlan.delta_step_barrier,
+            },
+            lambda g, d, p, s: analytics.ksssp(g, d.weight_property_name, s, g.num_nodes() - 1, 4, d.symmetric, p),
+            needs_weights=True,
+        ),
+        Algorithm(
+            "point_to_point_shortest_path",
+            {
+                "bidirectional_dijkstra": analytics.PointToPointShortestPathPlan.bidirectional_dijkstra,
+                "bidirectional_bfs": analytics.PointToPointShortestPathPlan.bidirectional_bfs,
+            },
+            lambda g, d, p, s: analytics.point_to_point_shortest_paths(
+                g, [(s, n) for n in range(0, g.num_nodes(), max(1, g.num_nodes() // 64))], d.weight_property_name, p
+            ),
+            needs_weights=True,
+        ),
+        Algorithm(
+            "connected_components",
+            {
+                "serial": analytics.ConnectedComponentsPlan.serial,
+                "label_prop": analytics.ConnectedComponentsPlan.label_prop,
+                "synchronous": analytics.ConnectedComponentsPlan.synchronous,
+                "asynchronous": analytics.ConnectedComponentsPlan.asynchronous,
+                "edge_asynchronous": analytics.ConnectedComponentsPlan.edge_asynchronous,
+                "edge_tiled_asynchronous": analytics.ConnectedComponentsPlan.edge_tiled_asynchronous,
+                "blocked_asynchronous": analytics.ConnectedComponentsPlan.blocked_asynchronous,
+                "afforest": analytics.ConnectedComponentsPlan.afforest,
+                "edge_afforest": analytics.ConnectedComponentsPlan.edge_afforest,
+                "edge_tiled_afforest": analytics.ConnectedComponentsPlan.edge_tiled_afforest,
+            },
+            lambda g, d, p, s: analytics.connected_components(g, OUTPUT_PROPERTY_NAME, d.symmetric, p),
+        ),
+        Algorithm(
+            "pagerank",
+            {
+                "pull_topological": analytics.PagerankPlan.pull_topological,
+                "pull_residual": analytics.PagerankPlan.pull_residual,
+                "push_asynchronous": analytics.PagerankPlan.push_asynchronous,
+                "push_synchronous": analytics.PagerankPlan.push_synchronous,
+            },
+            lambda g, d, p, s: analytics.pagerank(g, OUTPUT_PROPERTY_NAME, p),
+        ),
+        Algorithm(
+            "betweenness_centrality",
+            {
+                "outer": analytics.BetweennessCentralityPlan.outer,
+                "level": analytics.BetweennessCentralityPlan.level,
+            },
+            lambda g, d, p, s: analytics.betweenness_centrality(g, OUTPUT_PROPERTY_NAME, 16, p),
+        ),
+        Algorithm(
+            "cdlp",
+            {"synchronous": analytics.CdlpPlan.synchronous, "frontier": analytics.CdlpPlan.frontier},
+            lambda g, d, p, s: analytics.cdlp(g, OUTPUT_PROPERTY_NAME, 10, d.symmetric, p),
+        ),
+        Algorithm(
+            "independent_set",
+            {
+                "serial": analytics.IndependentSetPlan.serial,
+                "pull": analytics.IndependentSetPlan.pull,
+                "priority": analytics.IndependentSetPlan.priority,
+                "edge_tiled_priority": analytics.IndependentSetPlan.edge_tiled_priority,
+            },
+            lambda g, d, p, s: analytics.independent_set(g, OUTPUT_PROPERTY_NAME, p),
+            needs_symmetric=True,
+        ),
+        Algorithm(
+            "jaccard",
+            {"sorted": analytics.JaccardPlan.sorted, "unsorted": analytics.JaccardPlan.unsorted},
+            lambda g, d, p, s: analytics.jaccard(g, s, OUTPUT_PROPERTY_NAME, p),
+            setup=_sort_edges,
+        ),
+        Algorithm(
+            "k_core",
+            {
+                "synchronous": analytics.KCorePlan.synchronous,
+                "asynchronous": analytics.KCorePlan.asynchronous,
+                "bucket_decomposition": analytics.KCorePlan.bucket_decomposition,
+            },
+            lambda g, d, p, s: analytics.k_core(g, 10, OUTPUT_PROPERTY_NAME, d.symmetric, p),
+        ),
+        Algorithm(
+            "k_truss",
+            {
+                "bsp": analytics.KTrussPlan.bsp,
+                "bsp_jacobi": analytics.KTrussPlan.bsp_jacobi,
+                "bsp_core_then_truss": analytics.KTrussPlan.bsp_core_then_truss,
+                "bucket_decomposition": analytics.KTrussPlan.bucket_decomposition,
+            },
+            lambda g, d, p, s: analytics.k_truss(g, 5, OUTPUT_PROPERTY_NAME, p),
+            needs_symmetric=True,
+        ),
+        Algorithm(
+            "local_clustering_coefficient",
+            {
+                "ordered_count_atomics": analytics.LocalClusteringCoefficientPlan.ordered_count_atomics,
+                "ordered_count_per_thread": analytics.LocalClusteringCoefficientPlan.ordered_count_per_thread,
+                "wedge_sampling": analytics.LocalClusteringCoefficientPlan.wedge_sampling,
+            },
+            lambda g, d, p, s: analytics.local_clustering_coefficient(g, OUTPUT_PROPERTY_NAME, p),
+            needs_symmetric=True,
+        ),
+        Algorithm(
+            "louvain_clustering",
+            {
+                "do_all": analytics.LouvainClusteringPlan.do_all,
+                "deterministic": analytics.LouvainClusteringPlan.deterministic,
+            },
+            lambda g, d, p, s: analytics.louvain_clustering(
+                g, d.weight_property_name, OUTPUT_PROPERTY_NAME, d.symmetric, p
+            ),
+            needs_weights=True,
+        ),
+        Algorithm(
+            "leiden_clustering",
+            {
+                "do_all": analytics.LeidenClusteringPlan.do_all,
+                "deterministic": analytics.LeidenClusteringPlan.deterministic,
+            },
+            lambda g, d, p, s: analytics.leiden_clustering(
+                g, d.weight_property_name, OUTPUT_PROPERTY_NAME, d.symmetric, p
+            ),
+            needs_weights=True,
+        ),
+        Algorithm(
+            "triangle_count",
+            {
+                "node_iteration": analytics.TriangleCountPlan.node_iteration,
+                "edge_iteration": analytics.TriangleCountPlan.edge_iteration,
+                "ordered_count": analytics.TriangleCountPlan.ordered_count,
+                "edge_sampling": analytics.TriangleCountPlan.edge_sampling,
+                "wedge_sampling": analytics.TriangleCountPlan.wedge_sampling,
+            },
+            lambda g, d, p, s: analytics.triangle_count(g, p),
+            needs_symmetric=True,
+        ),
+        Algorithm(
+            "neighbor_sampling",
+            {"uniform": analytics.NeighborSamplingPlan.uniform},
+            lambda g, d, p, s: analytics.neighbor_sampling(g, range(min(1024, g.num_nodes())), [10, 10], p),
+        ),
+        Algorithm(
+            "subgraph_extraction",
+            {"node_set": analytics.SubGraphExtractionPlan.node_set},
+            lambda g, d, p, s: analytics.subgraph_extraction(g, list(range(0, g.num_nodes(), 2)), p),
+            setup=_sort_edges,
+        ),
+    ]
+}
+
+
+def _peak_rss_bytes() -> int:
+    # ru_maxrss is in KiB on Linux
+    return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss * 1024
+
+
+def _remove_output(graph: Graph):
+    if OUTPUT_PROPERTY_NAME in graph.loaded_node_schema().names:
+        graph.remove_node_property(OUTPUT_PROPERTY_NAME)
+
+
+def run_one(
+    dataset_name: str,
+    algorithm_name: str,
+    plan_name: str,
+    threads: int,
+    repetitions: int = 1,
+    scale: int = DEFAULT_SCALE,
+) -> List[Dict[str, Any]]:
+    """
+    Run one plan of an algorithm on a dataset in this process.
+
+    The peak RSS of the results is that of this process, so to measure the runs on their own, :py:func:`run_suite`
+    calls this in a new process for each dataset, plan and thread count.
+
+    :return: A result for each repetition.
+    """
+    dataset = DATASETS[dataset_name]
+    algorithm = ALGORITHMS[algorithm_name]
+    set_active_threads(threads)
+
+    load_timer = Timer()
+    with load_timer:
+        graph = dataset.load(scale)
+    if algorithm.setup:
+        algorithm.setup(graph, plan_name)
+    source = _source_node(graph)
+
+    results = []
+    for repetition in range(repetitions):
+        plan = algorithm.plans[plan_name]()
+        _remove_output(graph)
+        timer = Timer()
+        with timer:
+            algorithm.run(graph, dataset, plan, source)
+        time = timer.get_sec()
+        results.append(
+            dict(
+                dataset=dataset_name,
+                algorithm=algorithm_name,
+                plan=plan_name,
+                threads=threads,
+                repetition=repetition,
+                num_nodes=graph.num_nodes(),
+                num_edges=graph.num_edges(),
+                load_time=load_timer.get_sec(),
+                time=time,
+                gteps=graph.num_edges() / time / 1e9 if time > 0 else None,
+                peak_rss=_peak_rss_bytes(),
+            )
+        )
+    return results
+
+
+def run_suite(
+    datasets: Iterable[str] = None,
+    algorithms: Iterable[str] = None,
+    threads: Iterable[int] = (1,),
+    repetitions: int = 3,
+    scale: int = DEFAULT_SCALE,
+    log=None,
+) -> List[Dict[str, Any]]:
+    """
+    Run every plan of the algorithms on the datasets at each thread count, each dataset, plan and thread count in a
+    new process so that its peak RSS and load time are its own.
+
+    Runs that fail, e.g., because a plan does not support a graph, are reported with an ``error`` instead of times.
+
+    :param datasets: The names of the datasets in :py:data:`DATASETS` to run on, or None for all of them.
+    :param algorithms: The names of the algorithms in :py:data:`ALGORITHMS` to run, or None for all of them.
+    :param threads: The thread counts to run at.
+    :param repetitions: The number of times to run each plan on a loaded graph.
+    :param scale: The log2 of the number of nodes of the generated datasets.
+    :param log: A file to report progress to, e.g., ``sys.stderr``, or None.
+    :return: The results of the runs, as dicts.
+    """
+    results = []
+    for dataset_name in datasets or DATASETS:
+        for algorithm_name in algorithms or ALGORITHMS:
+            algorithm = ALGORITHMS[algorithm_name]
+            if not algorithm.runs_on(DATASETS[dataset_name]):
+                continue
+            for plan_name in algorithm.plans:
+                for num_threads in threads:
+                    if log:
+                        print(f"{dataset_name} {algorithm_name} {plan_name} threads={num_threads}", file=log)
+                    results.extend(
+                        _run_in_subprocess(dataset_name, algorithm_name, plan_name, num_threads, repetitions, scale)
+                    )
+    return results
+
+
+def _run_in_subprocess(dataset_name, algorithm_name, plan_name, threads, repetitions, scale):
+    arguments = dict(
+        dataset_name=dataset_name,
+        algorithm_name=algorithm_name,
+        plan_name=plan_name,
+        threads=threads,
+        repetitions=repetitions,
+        scale=scale,
+    )
+    process = subprocess.run(
+        [sys.executable, "-m", "katana.benchmark", "--run-one", json.dumps(arguments)],
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        check=False,
+        text=True,
+    )
+    if process.returncode == 0:
+        return json.loads(process.stdout)
+    error = process.stderr.strip().splitlines()
+    return [
+        dict(
+            dataset=dataset_name,
+            algorithm=algorithm_name,
+            plan=plan_name,
+            threads=threads,
+            error=error[-1] if error else f"exited with {process.returncode}",
+        )
+    ]
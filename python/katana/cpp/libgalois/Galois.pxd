@@ -1,3 +1,4 @@
+from libcpp.memory cimport unique_ptr
 from libcpp.string cimport string
 
 from ..libstd cimport CPPAuto
@@ -15,6 +16,15 @@ cdef extern from "katana/Threads.h" namespace "katana" nogil:
     unsigned int setActiveThreads(unsigned int)
     unsigned int getActiveThreads()
 
+cdef extern from "katana/ThreadGroup.h" namespace "katana" nogil:
+    cppclass ThreadGroup:
+        @staticmethod
+        unique_ptr[ThreadGroup] Make(unsigned num_threads)
+        unsigned size()
+
+    cppclass ThreadGroupScope "katana::ThreadGroup::Scope":
+        ThreadGroupScope(ThreadGroup* group)
+
 cdef extern from "katana/Galois.h" namespace "katana" nogil:
     cppclass UserContext[T]:
         void push(...)
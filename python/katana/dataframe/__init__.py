@@ -1,6 +1,6 @@
 from abc import ABC, abstractmethod
 from collections.abc import Sized
-from typing import Any, Callable, Dict, Optional, Sequence, Union
+from typing import Any, Callable, Dict, Iterator, Optional, Sequence, Union
 
 import numpy
 import pandas
@@ -99,13 +99,19 @@ class LazyDataFrame(DataFrame):
 
     def _get_column(self, item: str):
         col_data = self._data[item]
-        indexes = slice(self._offset, self._offset + self._length, self._stride)
+        indexes = slice(self._offset, self._offset + self._length * self._stride, self._stride)
         if isinstance(col_data, LazyDataAccessor):
             col_data = col_data.array(indexes)
+        elif isinstance(col_data, (numpy.ndarray, range)):
+            col_data = col_data[indexes]
+        elif isinstance(col_data, pandas.Series):
+            col_data = col_data.iloc[indexes].reset_index(drop=True)
+        elif isinstance(col_data, (pyarrow.Array, pyarrow.ChunkedArray)):
+            # Only convert the rows in this frame
+            col_data = col_data.slice(self._offset, self._length * self._stride).to_pandas()
+            col_data = col_data.iloc[:: self._stride].reset_index(drop=True)
         if isinstance(col_data, (numpy.ndarray, pandas.Series, range)):
             return col_data
-        if isinstance(col_data, (pyarrow.Array,)):
-            return col_data.to_pandas()
         data = numpy.empty(len(self), dtype=self.dtypes[item])
         data[:] = col_data
         return data
@@ -116,6 +122,19 @@ class LazyDataFrame(DataFrame):
             data[col_name] = self._get_column(col_name)
         return pandas.DataFrame(data)
 
+    def iter_pandas(self, batch_size: int = 1 << 20) -> Iterator[pandas.DataFrame]:
+        """
+        Convert this frame to pandas a batch of rows at a time, so that only one batch is in memory at once. Columns
+        read lazily (e.g., from storage) only read the rows of the current batch.
+
+        :param batch_size: The number of rows in each frame, except maybe the last.
+        :return: An iterator over `pandas.DataFrame` of consecutive rows of this frame.
+        """
+        if batch_size <= 0:
+            raise ValueError(batch_size)
+        for start in range(0, len(self), batch_size):
+            yield self._get_rows(slice(start, min(start + batch_size, len(self)))).to_pandas()
+
     @property
     def dtypes(self) -> dict:
         return dict(zip(self._data.keys(), self._dtypes))
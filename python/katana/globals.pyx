@@ -1,9 +1,13 @@
+import threading
+
 from katana.cpp.libgalois.Galois cimport GetThreadPool
+from katana.cpp.libgalois.Galois cimport ThreadGroup as CThreadGroup
+from katana.cpp.libgalois.Galois cimport ThreadGroupScope
 from katana.cpp.libgalois.Galois cimport getActiveThreads as c_getActiveTheads
 from katana.cpp.libgalois.Galois cimport getVersion as c_getVersion
 from katana.cpp.libgalois.Galois cimport setActiveThreads as c_setActiveThreads
 
-__all__ = ["get_active_threads", "set_active_threads", "set_busy_wait", "get_version"]
+__all__ = ["get_active_threads", "set_active_threads", "set_busy_wait", "get_version", "ThreadGroup"]
 
 
 def get_active_threads():
@@ -38,3 +42,62 @@ def set_busy_wait(n = None):
 
 def get_version():
     return str(c_getVersion(), encoding="ASCII")
+
+
+cdef class ThreadGroup:
+    """
+    A set of Katana threads set aside to run the loops of one Python thread.
+
+    Loops release the GIL while they run (numba compiled operators run entirely without it; plain Python callables
+    take it back for each call), so several Python threads can run loops at once. Without groups those loops still
+    take turns on the single thread pool. Inside ``with group:``, the loops of the calling thread run on the threads
+    of the group instead, at the same time as loops on other groups and on the rest of the pool::
+
+        group = ThreadGroup(4)
+        with group:
+            do_all(range(n), operator(data))
+
+    Groups must be made while no loop runs. Their threads are not used by other loops until the group is garbage
+    collected.
+
+    :param num_threads: The number of threads in the group.
+    :raises RuntimeError: If fewer than `num_threads` threads are free. The first thread never joins a group.
+    """
+
+    cdef CThreadGroup* group
+    cdef ThreadGroupScope* scope
+    cdef object owner
+
+    def __init__(self, unsigned num_threads):
+        if num_threads == 0:
+            raise ValueError("a thread group needs at least one thread")
+        with nogil:
+            self.group = CThreadGroup.Make(num_threads).release()
+        if self.group == NULL:
+            raise RuntimeError(f"fewer than {num_threads} threads are free for a thread group")
+
+    def __dealloc__(self):
+        # A scope left open by a thread that died pins the group
+        if self.scope == NULL:
+            del self.group
+
+    @property
+    def size(self):
+        """
+        :return: The number of threads in the group.
+        """
+        return self.group.size()
+
+    def __enter__(self):
+        if self.scope != NULL:
+            raise RuntimeError("thread group is already in use")
+        self.scope = new ThreadGroupScope(self.group)
+        self.owner = threading.get_ident()
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        if self.owner != threading.get_ident():
+            raise RuntimeError("thread group must be left by the thread that entered it")
+        del self.scope
+        self.scope = NULL
+        self.owner = None
@@ -12,17 +12,20 @@ from katana.local.barrier import Barrier, SimpleBarrier, get_fast_barrier
 from katana.local.datastructures import AllocationPolicy, InsertBag, NUMAArray
 from katana.local.dynamic_bitset import DynamicBitset
 from katana.local.entity_type_array import EntityTypeArray
+from katana.local.property_view import PropertyView
 from katana.local_native import (
     AtomicEntityType,
     EntityType,
     EntityTypeManager,
     Graph,
+    GraphLoad,
     ReduceAnd,
     ReduceMax,
     ReduceMin,
     ReduceOr,
     ReduceSum,
     TxnContext,
+    property_bytes_copied,
 )
 from katana.native_interfacing.numpy_atomic import atomic_add, atomic_max, atomic_min, atomic_sub
 
@@ -37,6 +40,7 @@ __all__ = [
     "InsertBag",
     "NUMAArray",
     "Graph",
+    "GraphLoad",
     "TxnContext",
     "SimpleBarrier",
     "atomic_add",
@@ -50,6 +54,10 @@ __all__ = [
     "AtomicEntityType",
     "EntityTypeManager",
     "EntityTypeArray",
+    "PropertyView",
+    "property_bytes_copied",
 ]
 
 Graph.out_edges = graph_adds.out_edges
+Graph.node_property_view = graph_adds.node_property_view
+Graph.edge_property_view = graph_adds.edge_property_view
@@ -0,0 +1,135 @@
+import operator
+
+import numpy as np
+from numba import typeof, types
+from numba.core import cgutils
+from numba.extending import (
+    NativeValue,
+    make_attribute_wrapper,
+    models,
+    overload,
+    overload_method,
+    register_model,
+    typeof_impl,
+    unbox,
+)
+
+from katana.local.property_view import PropertyView
+
+
+class PropertyViewType(types.Type):
+    """
+    The Numba type of a :py:class:`~katana.local.property_view.PropertyView`, parameterized by the array types of its
+    values and validity, which carry its element type and whether it can be written.
+    """
+
+    def __init__(self, values_type, validity_type):
+        self.values_type = values_type
+        self.validity_type = validity_type
+        super().__init__(name=f"PropertyView[{values_type}]")
+
+    @property
+    def key(self):
+        return (self.values_type, self.validity_type)
+
+    @property
+    def dtype(self):
+        return self.values_type.dtype
+
+
+@typeof_impl.register(PropertyView)
+def typeof_PropertyView(val, c):
+    _ = c
+    return PropertyViewType(typeof(val.values), typeof(val.validity))
+
+
+@register_model(PropertyViewType)
+class PropertyViewModel(models.StructModel):
+    def __init__(self, dmm, fe_type):
+        members = [
+            ("values", fe_type.values_type),
+            ("validity", fe_type.validity_type),
+            ("offset", types.int64),
+            ("null_count", types.int64),
+        ]
+        models.StructModel.__init__(self, dmm, fe_type, members)
+
+
+for _attr in ("values", "validity", "offset", "null_count"):
+    make_attribute_wrapper(PropertyViewType, _attr, _attr)
+
+
+@unbox(PropertyViewType)
+def unbox_PropertyView(typ, obj, c):
+    view = cgutils.create_struct_proxy(typ)(c.context, c.builder)
+    is_error = cgutils.false_bit
+    for name, member_type in (
+        ("values", typ.values_type),
+        ("validity", typ.validity_type),
+        ("offset", types.int64),
+        ("null_count", types.int64),
+    ):
+        attr = c.pyapi.object_getattr_string(obj, name)
+        native = c.unbox(member_type, attr)
+        c.pyapi.decref(attr)
+        setattr(view, name, native.value)
+        is_error = c.builder.or_(is_error, native.is_error)
+    return NativeValue(view._getvalue(), is_error=is_error)
+
+
+@overload(len)
+def overload_PropertyView_len(self):
+    if isinstance(self, PropertyViewType):
+
+        def impl(self):
+            return len(self.values)
+
+        return impl
+    return None
+
+
+@overload(operator.getitem)
+def overload_PropertyView_getitem(self, i):
+    if isinstance(self, PropertyViewType) and isinstance(i, types.Integer):
+
+        def impl(self, i):
+            return self.values[i]
+
+        return impl
+    return None
+
+
+@overload(operator.setitem)
+def overload_PropertyView_setitem(self, i, v):
+    if isinstance(self, PropertyViewType) and isinstance(i, types.Integer) and self.values_type.mutable:
+
+        def impl(self, i, v):
+            self.values[i] = v
+
+        return impl
+    return None
+
+
+@overload_method(PropertyViewType, "is_valid")
+def overload_PropertyView_is_valid(self, i):
+    _ = self
+    _ = i
+
+    def impl(self, i):
+        if self.null_count == 0:
+            return True
+        j = np.int64(i) + self.offset
+        return (self.validity[j >> 3] >> (j & 7)) & 1 != 0
+
+    return impl
+
+
+@overload_method(PropertyViewType, "is_null")
+def overload_PropertyView_is_null(self, i):
+    _ = self
+    _ = i
+
+    def impl(self, i):
+        return not self.is_valid(i)
+
+    return impl
@@ -25,16 +25,26 @@ Algorithms
 
 .. automodule:: katana.local.analytics._bfs
 
+.. automodule:: katana.local.analytics._bipartite_matching
+
 .. automodule:: katana.local.analytics._cdlp
 
+.. automodule:: katana.local.analytics._clique_count
+
 .. automodule:: katana.local.analytics._connected_components
 
+.. automodule:: katana.local.analytics._graph_coloring
+
+.. automodule:: katana.local.analytics._group_by
+
 .. automodule:: katana.local.analytics._independent_set
 
 .. automodule:: katana.local.analytics._louvain_clustering
 
 .. automodule:: katana.local.analytics._local_clustering_coefficient
 
+.. automodule:: katana.local.analytics._neighbor_sampling
+
 .. automodule:: katana.local.analytics._subgraph_extraction
 
 .. automodule:: katana.local.analytics._jaccard
@@ -45,14 +55,26 @@ Algorithms
 
 .. automodule:: katana.local.analytics._ksssp
 
+.. automodule:: katana.local.analytics._k_shortest_simple_paths
+
+.. automodule:: katana.local.analytics._max_flow
+
+.. automodule:: katana.local.analytics._minimum_spanning_forest
+
+.. automodule:: katana.local.analytics._motif_count
+
 .. automodule:: katana.local.analytics._pagerank
 
+.. automodule:: katana.local.analytics._point_to_point_shortest_path
+
 .. automodule:: katana.local.analytics._sssp
 
 .. automodule:: katana.local.analytics._triangle_count
 
 .. automodule:: katana.local.analytics._wrappers
 
+.. automodule:: katana.local.analytics.batch
+
 """
 
 
@@ -61,23 +83,64 @@ from katana.local.analytics._betweenness_centrality import (
     BetweennessCentralityStatistics,
     betweenness_centrality,
 )
-from katana.local.analytics._bfs import BfsPlan, BfsStatistics, bfs, bfs_assert_valid
+from katana.local.analytics._bfs import (
+    BfsPlan,
+    BfsStatistics,
+    MultiSourceBfsPlan,
+    MultiSourceBfsStatistics,
+    bfs,
+    bfs_assert_valid,
+    bfs_task,
+    multi_source_bfs,
+    multi_source_bfs_assert_valid,
+)
+from katana.local.analytics._bipartite_matching import (
+    BipartiteMatchingPlan,
+    BipartiteMatchingStatistics,
+    bipartite_matching,
+    bipartite_matching_assert_valid,
+)
 from katana.local.analytics._cdlp import CdlpPlan, CdlpStatistics, cdlp
+from katana.local.analytics._clique_count import CliqueCountPlan, clique_count
 from katana.local.analytics._connected_components import (
     ConnectedComponentsPlan,
     ConnectedComponentsStatistics,
     connected_components,
     connected_components_assert_valid,
+    connected_components_task,
 )
+from katana.local.analytics._graph_coloring import (
+    GraphColoringPlan,
+    GraphColoringStatistics,
+    graph_coloring,
+    graph_coloring_assert_valid,
+)
+from katana.local.analytics._group_by import GroupByFunction, GroupByPlan, group_by
 from katana.local.analytics._independent_set import (
     IndependentSetPlan,
     IndependentSetStatistics,
     independent_set,
     independent_set_assert_valid,
 )
-from katana.local.analytics._jaccard import JaccardPlan, JaccardStatistics, jaccard, jaccard_assert_valid
-from katana.local.analytics._k_core import KCorePlan, KCoreStatistics, k_core, k_core_assert_valid
-from katana.local.analytics._k_truss import KTrussPlan, KTrussStatistics, k_truss, k_truss_assert_valid
+from katana.local.analytics._jaccard import (
+    JaccardPlan,
+    JaccardSimilarityJoinPlan,
+    JaccardStatistics,
+    jaccard,
+    jaccard_assert_valid,
+    jaccard_similarity_join,
+    jaccard_similarity_join_assert_valid,
+    jaccard_task,
+)
+from katana.local.analytics._k_core import KCorePlan, KCoreStatistics, k_core, k_core_assert_valid, k_core_decomposition
+from katana.local.analytics._k_shortest_simple_paths import KShortestSimplePathsPlan, k_shortest_simple_paths
+from katana.local.analytics._k_truss import (
+    KTrussPlan,
+    KTrussStatistics,
+    k_truss,
+    k_truss_assert_valid,
+    k_truss_decomposition,
+)
 from katana.local.analytics._ksssp import KssspPlan, ksssp
 from katana.local.analytics._leiden_clustering import (
     LeidenClusteringPlan,
@@ -95,9 +158,43 @@ from katana.local.analytics._louvain_clustering import (
     louvain_clustering,
     louvain_clustering_assert_valid,
 )
-from katana.local.analytics._pagerank import PagerankPlan, PagerankStatistics, pagerank, pagerank_assert_valid
-from katana.local.analytics._sssp import SsspPlan, SsspStatistics, sssp, sssp_assert_valid
+from katana.local.analytics._max_flow import MaxFlowPlan, MaxFlowStatistics, max_flow, max_flow_assert_valid
+from katana.local.analytics._minimum_spanning_forest import (
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
+)
+from katana.local.analytics._motif_count import MotifCountPlan, MotifCounts, motif_count
+from katana.local.analytics._neighbor_sampling import NeighborSampleBlock, NeighborSamplingPlan, neighbor_sampling
+from katana.local.analytics._pagerank import (
+    PagerankPlan,
+    PagerankStatistics,
+    PersonalizedPagerankPlan,
+    pagerank,
+    pagerank_assert_valid,
+    pagerank_task,
+    personalized_pagerank,
+    personalized_pagerank_assert_valid,
+)
+from katana.local.analytics._point_to_point_shortest_path import (
+    PointToPointShortestPathPlan,
+    point_to_point_shortest_paths,
+    shortest_path_landmarks,
+)
+from katana.local.analytics._sssp import (
+    MultiSourceSsspPlan,
+    MultiSourceSsspStatistics,
+    SsspPlan,
+    SsspStatistics,
+    multi_source_sssp,
+    multi_source_sssp_assert_valid,
+    sssp,
+    sssp_assert_valid,
+    sssp_task,
+)
 from katana.local.analytics._subgraph_extraction import SubGraphExtractionPlan, subgraph_extraction
-from katana.local.analytics._triangle_count import TriangleCountPlan, triangle_count
+from katana.local.analytics._triangle_count import TriangleCountPlan, estimate_triangle_count, triangle_count
 from katana.local.analytics._wrappers import find_edge_sorted_by_dest, sort_all_edges_by_dest, sort_nodes_by_degree
+from katana.local.analytics.batch import AnalyticsTask, run_batch
 from katana.local.analytics.plan import Architecture, Plan, Statistics
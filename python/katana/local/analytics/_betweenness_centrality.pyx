@@ -14,7 +14,7 @@ Betweenness Centrality
 
 """
 
-from libc.stdint cimport uint32_t
+from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
 from libcpp.vector cimport vector
 
@@ -39,8 +39,13 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         enum Algorithm:
             kOuter "katana::analytics::BetweennessCentralityPlan::kOuter"
             kLevel "katana::analytics::BetweennessCentralityPlan::kLevel"
+            kApproximate "katana::analytics::BetweennessCentralityPlan::kApproximate"
+            kAsynchronous "katana::analytics::BetweennessCentralityPlan::kAsynchronous"
 
         _BetweennessCentralityPlan.Algorithm algorithm() const
+        double epsilon() const
+        double delta() const
+        uint64_t seed() const
 
         BetweennessCentralityPlan()
 
@@ -49,6 +54,10 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         @staticmethod
         _BetweennessCentralityPlan Outer()
         @staticmethod
+        _BetweennessCentralityPlan Asynchronous()
+        @staticmethod
+        _BetweennessCentralityPlan Approximate(double epsilon, double delta, uint64_t seed)
+        @staticmethod
         _BetweennessCentralityPlan FromAlgorithm(_BetweennessCentralityPlan.Algorithm algo)
 
     BetweennessCentralitySources kBetweennessCentralityAllNodes;
@@ -87,6 +96,8 @@ class _BetweennessCentralityAlgorithm(Enum):
     """
     Outer = _BetweennessCentralityPlan.Algorithm.kOuter
     Level = _BetweennessCentralityPlan.Algorithm.kLevel
+    Approximate = _BetweennessCentralityPlan.Algorithm.kApproximate
+    Asynchronous = _BetweennessCentralityPlan.Algorithm.kAsynchronous
 
 
 cdef class BetweennessCentralityPlan(Plan):
@@ -113,6 +124,18 @@ cdef class BetweennessCentralityPlan(Plan):
     def algorithm(self) -> _BetweennessCentralityAlgorithm:
         return _BetweennessCentralityAlgorithm(self.underlying_.algorithm())
 
+    @property
+    def epsilon(self) -> float:
+        return self.underlying_.epsilon()
+
+    @property
+    def delta(self) -> float:
+        return self.underlying_.delta()
+
+    @property
+    def seed(self) -> int:
+        return self.underlying_.seed()
+
     @staticmethod
     def outer():
         """
@@ -127,6 +150,22 @@ cdef class BetweennessCentralityPlan(Plan):
         """
         return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Level())
 
+    @staticmethod
+    def asynchronous():
+        """
+        Process each source with worklists along its shortest path DAG instead of levels, which avoids a barrier per
+        level on graphs of high diameter.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Asynchronous())
+
+    @staticmethod
+    def approximate(double epsilon = 0.01, double delta = 0.1, uint64_t seed = 0):
+        """
+        Estimate from the dependencies of randomly sampled sources. With probability at least 1 - delta, every
+        estimate is within epsilon * n * (n - 1) of the exact centrality.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Approximate(epsilon, delta, seed))
+
 
 def betweenness_centrality(pg, str output_property_name, sources = None,
              BetweennessCentralityPlan plan = BetweennessCentralityPlan(),
@@ -10,15 +10,29 @@ Breadth-first Search
 
 .. autofunction:: katana.local.analytics.bfs
 
+.. autofunction:: katana.local.analytics.bfs_task
+
 .. autoclass:: katana.local.analytics.BfsStatistics
 
 
 .. autofunction:: katana.local.analytics.bfs_assert_valid
+
+
+.. autoclass:: katana.local.analytics.MultiSourceBfsPlan
+
+
+.. autofunction:: katana.local.analytics.multi_source_bfs
+
+.. autoclass:: katana.local.analytics.MultiSourceBfsStatistics
+
+
+.. autofunction:: katana.local.analytics.multi_source_bfs_assert_valid
 """
 
 from libc.stddef cimport ptrdiff_t
 from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 
 from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
@@ -28,6 +42,7 @@ from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_r
 from katana.local import Graph, TxnContext
 
 from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.batch cimport AnalyticsTask
 from katana.local.analytics.plan cimport Plan, _Plan
 
 from enum import Enum
@@ -47,6 +62,9 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
         uint32_t alpha() const
         uint32_t beta() const
 
+        _BfsPlan()
+        _BfsPlan(const _PropertyGraph * pg)
+
         @staticmethod
         _BfsPlan AsynchronousTile(ptrdiff_t edge_tile_size)
 
@@ -84,6 +102,36 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
         Result[_BfsStatistics] Compute(_PropertyGraph* pg,
                                        string property_name);
 
+    cppclass _MultiSourceBfsPlan "katana::analytics::MultiSourceBfsPlan" (_Plan):
+        enum Algorithm:
+            kBitParallel "katana::analytics::MultiSourceBfsPlan::kBitParallel"
+
+        _MultiSourceBfsPlan.Algorithm algorithm() const
+        uint32_t batch_size() const
+
+        _MultiSourceBfsPlan()
+
+        @staticmethod
+        _MultiSourceBfsPlan BitParallel(uint32_t batch_size)
+
+    uint32_t kDefaultBatchSize "katana::analytics::MultiSourceBfsPlan::kDefaultBatchSize"
+
+    cppclass _MultiSourceBfsStatistics "katana::analytics::MultiSourceBfsStatistics":
+        vector[uint64_t] n_reached_nodes
+        vector[uint64_t] level_sums
+        vector[uint32_t] max_levels
+
+        double Closeness(size_t i) const
+
+        void Print(ostream os)
+
+    Result[_MultiSourceBfsStatistics] MultiSourceBfs(_PropertyGraph* pg, const vector[uint32_t]& sources,
+                                                     string output_property_name, CTxnContext* txn_ctx,
+                                                     _MultiSourceBfsPlan plan)
+
+    Result[void] MultiSourceBfsAssertValid(_PropertyGraph* pg, const vector[uint32_t]& sources,
+                                           string property_name)
+
 class _BfsAlgorithm(Enum):
     """
     :see: :py:class:`~katana.local.analytics.BfsPlan` constructors for algorithm documentation.
@@ -114,6 +162,15 @@ cdef class BfsPlan(Plan):
         f.underlying_ = u
         return f
 
+    def __init__(self, graph = None):
+        """
+        Construct a plan optimized for `graph` using heuristics, or using default parameter values.
+        """
+        if graph is None:
+            self.underlying_ = _BfsPlan()
+        else:
+            self.underlying_ = _BfsPlan(underlying_property_graph(graph))
+
     Algorithm = _BfsAlgorithm
 
     @property
@@ -197,6 +254,36 @@ def bfs(pg, uint32_t start_node, str output_property_name, BfsPlan plan = BfsPla
     with nogil:
         handle_result_void(Bfs(underlying_property_graph(pg), start_node, output_property_name_cstr, underlying_txn_context(txn_ctx), plan.underlying_))
 
+cdef cppclass _BfsArguments:
+    uint32_t start_node
+    string output_property_name
+    _BfsPlan plan
+
+
+cdef int _run_bfs(void* arguments, _PropertyGraph* pg, CTxnContext* txn_ctx) nogil except 0:
+    cdef _BfsArguments* args = <_BfsArguments*>arguments
+    return handle_result_void(Bfs(pg, args.start_node, args.output_property_name, txn_ctx, args.plan))
+
+
+cdef class _BfsTask(AnalyticsTask):
+    cdef _BfsArguments arguments_
+
+
+def bfs_task(uint32_t start_node, str output_property_name, BfsPlan plan = BfsPlan()) -> AnalyticsTask:
+    """
+    Create a task for :py:func:`~katana.local.analytics.run_batch` which runs :py:func:`bfs` with these
+    arguments.
+    """
+    cdef _BfsTask task = _BfsTask.__new__(_BfsTask)
+    task.arguments_.start_node = start_node
+    task.arguments_.output_property_name = output_property_name.encode("utf-8")
+    task.arguments_.plan = plan.underlying_
+    task.output_property_name = output_property_name
+    task.function = _run_bfs
+    task.arguments = &task.arguments_
+    return task
+
+
 def bfs_assert_valid(pg, uint32_t start_node, str property_name):
     """
     Raise an exception if the BFS results in `pg` appear to be incorrect. This is not an
@@ -240,3 +327,146 @@ cdef class BfsStatistics:
         cdef ostringstream ss
         self.underlying.Print(ss)
         return str(ss.str(), "ascii")
+
+
+class _MultiSourceBfsAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.MultiSourceBfsPlan` constructors for algorithm documentation.
+    """
+    BitParallel = _MultiSourceBfsPlan.Algorithm.kBitParallel
+
+
+cdef class MultiSourceBfsPlan(Plan):
+    """
+    A computational :ref:`Plan` for Breadth-First Search from many sources at once.
+    """
+    cdef:
+        _MultiSourceBfsPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    @staticmethod
+    cdef MultiSourceBfsPlan make(_MultiSourceBfsPlan u):
+        f = <MultiSourceBfsPlan>MultiSourceBfsPlan.__new__(MultiSourceBfsPlan)
+        f.underlying_ = u
+        return f
+
+    Algorithm = _MultiSourceBfsAlgorithm
+
+    @property
+    def algorithm(self) -> _MultiSourceBfsAlgorithm:
+        return _MultiSourceBfsAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def batch_size(self) -> int:
+        """
+        The number of searches run at a time.
+        """
+        return self.underlying_.batch_size()
+
+    @staticmethod
+    def bit_parallel(uint32_t batch_size=kDefaultBatchSize):
+        """
+        Run `batch_size` searches at a time, a multiple of 64 up to 512, which share each scan of the edges of a node.
+        """
+        return MultiSourceBfsPlan.make(_MultiSourceBfsPlan.BitParallel(batch_size))
+
+
+cdef _MultiSourceBfsStatistics handle_result_MultiSourceBfsStatistics(
+        Result[_MultiSourceBfsStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MultiSourceBfsStatistics:
+    """
+    The :ref:`statistics` of the searches of a :py:func:`multi_source_bfs`, in the order of their sources.
+    """
+    cdef _MultiSourceBfsStatistics underlying
+
+    @staticmethod
+    cdef MultiSourceBfsStatistics make(_MultiSourceBfsStatistics u):
+        f = <MultiSourceBfsStatistics>MultiSourceBfsStatistics.__new__(MultiSourceBfsStatistics)
+        f.underlying = u
+        return f
+
+    @property
+    def n_reached_nodes(self):
+        """
+        For each source, the number of nodes it reaches, including itself.
+
+        :rtype: list[int]
+        """
+        return self.underlying.n_reached_nodes
+
+    @property
+    def level_sums(self):
+        """
+        For each source, the sum of the levels of the nodes it reaches.
+
+        :rtype: list[int]
+        """
+        return self.underlying.level_sums
+
+    @property
+    def max_levels(self):
+        """
+        For each source, the largest level of a node it reaches.
+
+        :rtype: list[int]
+        """
+        return self.underlying.max_levels
+
+    def closeness(self, size_t i) -> float:
+        """
+        The closeness centrality of source `i` within the nodes it reaches.
+        """
+        return self.underlying.Closeness(i)
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
+
+
+def multi_source_bfs(pg, sources, str output_property_name, MultiSourceBfsPlan plan = MultiSourceBfsPlan(), *,
+                     txn_ctx = None) -> MultiSourceBfsStatistics:
+    """
+    Compute a Breadth-First Search from each node of `sources`. The number of searches that reach each node is
+    written to the property `output_property_name`.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type sources: list[int]
+    :param sources: The source nodes.
+    :type output_property_name: str
+    :param output_property_name: The output property to write reach counts into. This property must not already exist.
+    :type plan: MultiSourceBfsPlan
+    :param plan: The execution plan to use.
+    :param txn_ctx: The transaction context for passing read write sets.
+    :returns: The levels of the nodes reached by each search.
+    """
+    cdef vector[uint32_t] c_sources = sources
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    cdef _MultiSourceBfsStatistics stats
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        stats = handle_result_MultiSourceBfsStatistics(MultiSourceBfs(
+            underlying_property_graph(pg), c_sources, output_property_name_str, underlying_txn_context(txn_ctx),
+            plan.underlying_))
+    return MultiSourceBfsStatistics.make(stats)
+
+
+def multi_source_bfs_assert_valid(pg, sources, str property_name):
+    """
+    Raise an exception if the reach counts of :py:func:`multi_source_bfs` from `sources` in `pg` are incorrect.
+
+    :raises: AssertionError
+    """
+    cdef vector[uint32_t] c_sources = sources
+    cdef string property_name_str = bytes(property_name, "utf-8")
+    with nogil:
+        handle_result_assert(MultiSourceBfsAssertValid(underlying_property_graph(pg), c_sources, property_name_str))
@@ -0,0 +1,195 @@
+"""
+Bipartite Matching
+------------------
+
+.. autoclass:: katana.local.analytics.BipartiteMatchingPlan
+
+
+.. autoclass:: katana.local.analytics._bipartite_matching._BipartiteMatchingPlanAlgorithm
+
+
+.. autofunction:: katana.local.analytics.bipartite_matching
+
+.. autoclass:: katana.local.analytics.BipartiteMatchingStatistics
+
+
+.. autofunction:: katana.local.analytics.bipartite_matching_assert_valid
+"""
+from libc.stdint cimport uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from katana.local import Graph, TxnContext
+
+from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/bipartite_matching/bipartite_matching.h" namespace "katana::analytics" nogil:
+    cppclass _BipartiteMatchingPlan "katana::analytics::BipartiteMatchingPlan" (_Plan):
+        enum Algorithm:
+            kPothenFan "katana::analytics::BipartiteMatchingPlan::kPothenFan"
+
+        _BipartiteMatchingPlan.Algorithm algorithm() const
+
+        BipartiteMatchingPlan()
+
+        @staticmethod
+        _BipartiteMatchingPlan PothenFan()
+
+    Result[void] BipartiteMatching(_PropertyGraph* pg, string left_node_type, string output_property_name,
+                                   CTxnContext* txn_ctx, _BipartiteMatchingPlan plan)
+
+    Result[void] BipartiteMatchingAssertValid(_PropertyGraph* pg, string left_node_type, string output_property_name)
+
+    cppclass _BipartiteMatchingStatistics "katana::analytics::BipartiteMatchingStatistics":
+        uint64_t num_left_nodes
+        uint64_t num_right_nodes
+        uint64_t num_matched
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_BipartiteMatchingStatistics] Compute(_PropertyGraph* pg, string left_node_type,
+                                                     string output_property_name)
+
+
+class _BipartiteMatchingPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.BipartiteMatchingPlan` constructors for algorithm documentation.
+    """
+    PothenFan = _BipartiteMatchingPlan.Algorithm.kPothenFan
+
+
+cdef class BipartiteMatchingPlan(Plan):
+    """
+    A computational :ref:`Plan` for maximum bipartite matchings.
+
+    Static methods construct BipartiteMatchingPlans.
+    """
+    cdef:
+        _BipartiteMatchingPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _BipartiteMatchingPlanAlgorithm
+
+    @staticmethod
+    cdef BipartiteMatchingPlan make(_BipartiteMatchingPlan u):
+        f = <BipartiteMatchingPlan>BipartiteMatchingPlan.__new__(BipartiteMatchingPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> BipartiteMatchingPlan.Algorithm:
+        return self.underlying_.algorithm()
+
+    @staticmethod
+    def pothen_fan() -> BipartiteMatchingPlan:
+        """
+        A greedy initial matching followed by phases of parallel depth first searches for augmenting paths from every
+        unmatched left node, with lookahead and alternating search directions. The searches of a phase claim right
+        nodes atomically, so their paths are disjoint and are augmented without locks.
+        """
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.PothenFan())
+
+
+def bipartite_matching(pg, str left_node_type, str output_property_name,
+                       BipartiteMatchingPlan plan = BipartiteMatchingPlan(), *, txn_ctx = None):
+    """
+    Compute a maximum matching of the bipartite graph whose left nodes are the nodes of `pg` with the node type
+    `left_node_type` and whose right nodes are all other nodes. Edges in either direction between a left and a right
+    node may be matched; edges between two nodes of the same side are ignored.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type left_node_type: str
+    :param left_node_type: The name of the node type of the left nodes.
+    :type output_property_name: str
+    :param output_property_name: The uint32 output node property holding the partner of each node, or the largest
+        uint32 for unmatched nodes. This property must not already exist.
+    :type plan: BipartiteMatchingPlan
+    :param plan: The execution plan to use.
+    :param txn_ctx: The transaction context for passing read write sets.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_rdg_dataset
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_rdg_dataset("ldbc_003"))
+        from katana.analytics import bipartite_matching, BipartiteMatchingStatistics
+        bipartite_matching(graph, "Person", "partner")
+        stats = BipartiteMatchingStatistics(graph, "Person", "partner")
+        print("Matched pairs:", stats.num_matched)
+
+    """
+    cdef string left_node_type_str = bytes(left_node_type, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        handle_result_void(BipartiteMatching(underlying_property_graph(pg), left_node_type_str,
+                                             output_property_name_str, underlying_txn_context(txn_ctx),
+                                             plan.underlying_))
+
+
+def bipartite_matching_assert_valid(pg, str left_node_type, str output_property_name):
+    """
+    Raise an exception if the partners in `output_property_name` are not mutual, do not join a left and a right node by
+    an edge, or leave an augmenting path.
+
+    :raises: AssertionError
+    """
+    cdef string left_node_type_str = bytes(left_node_type, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_assert(BipartiteMatchingAssertValid(underlying_property_graph(pg), left_node_type_str,
+                                                          output_property_name_str))
+
+
+cdef _BipartiteMatchingStatistics handle_result_BipartiteMatchingStatistics(
+        Result[_BipartiteMatchingStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class BipartiteMatchingStatistics:
+    """
+    Compute the :ref:`statistics` of a bipartite matching result.
+    """
+    cdef _BipartiteMatchingStatistics underlying
+
+    def __init__(self, pg, str left_node_type, str output_property_name):
+        cdef string left_node_type_str = bytes(left_node_type, "utf-8")
+        cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_BipartiteMatchingStatistics(_BipartiteMatchingStatistics.Compute(
+                underlying_property_graph(pg), left_node_type_str, output_property_name_str))
+
+    @property
+    def num_left_nodes(self) -> uint64_t:
+        return self.underlying.num_left_nodes
+
+    @property
+    def num_right_nodes(self) -> uint64_t:
+        return self.underlying.num_right_nodes
+
+    @property
+    def num_matched(self) -> uint64_t:
+        return self.underlying.num_matched
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -43,6 +43,7 @@ cdef extern from "katana/analytics/cdlp/cdlp.h" namespace "katana::analytics" no
     cppclass _CdlpPlan "katana::analytics::CdlpPlan"(_Plan):
         enum Algorithm:
             kSynchronous "katana::analytics::CdlpPlan::kSynchronous"
+            kFrontier "katana::analytics::CdlpPlan::kFrontier"
             #kAsynchronous "katana::analytics::CdlpPlan::kAsynchronous"
 
         _CdlpPlan.Algorithm algorithm() const
@@ -52,6 +53,9 @@ cdef extern from "katana/analytics/cdlp/cdlp.h" namespace "katana::analytics" no
         @staticmethod
         _CdlpPlan Synchronous()
 
+        @staticmethod
+        _CdlpPlan Frontier()
+
         #@staticmethod
         #_CdlpPlan Asynchronous()
 
@@ -77,6 +81,7 @@ class _CdlpPlanAlgorithm(Enum):
     :see: :py:class:`~katana.local.analytics.CdlpPlan` constructors for algorithm documentation.
     """
     Synchronous = _CdlpPlan.Algorithm.kSynchronous
+    Frontier = _CdlpPlan.Algorithm.kFrontier
     #Asynchronous = _CdlpPlan.Algorithm.kAsynchronous
 
 
@@ -113,6 +118,15 @@ cdef class CdlpPlan(Plan):
         """
         return CdlpPlan.make(_CdlpPlan.Synchronous())
 
+    @staticmethod
+    def frontier() -> CdlpPlan:
+        """
+        The synchronous algorithm, but each iteration only revisits the nodes with a neighbor whose
+        label changed in the iteration before. It finds the same communities as
+        :py:meth:`synchronous` in less time once most labels have settled.
+        """
+        return CdlpPlan.make(_CdlpPlan.Frontier())
+
     #@staticmethod
     #def asynchronous() -> CdlpPlan:
         #"""
@@ -0,0 +1,144 @@
+"""
+Clique Counting
+---------------
+
+.. autoclass:: katana.local.analytics.CliqueCountPlan
+
+
+.. autoclass:: katana.local.analytics._clique_count._CliqueCountPlanAlgorithm
+
+
+.. autofunction:: katana.local.analytics.clique_count
+
+.. [Danisch] Maximilien Danisch, Oana Balalau, and Mauro Sozio. Listing k-cliques in Sparse Real-World Graphs.
+    WWW 2018.
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, raise_error_code
+
+from katana.local import Graph, TxnContext
+
+from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/clique_count/clique_count.h" namespace "katana::analytics" nogil:
+    cppclass _CliqueCountPlan "katana::analytics::CliqueCountPlan" (_Plan):
+        enum Algorithm:
+            kOrderedListing "katana::analytics::CliqueCountPlan::kOrderedListing"
+
+        _CliqueCountPlan.Algorithm algorithm() const
+        uint32_t hub_degree() const
+
+        CliqueCountPlan()
+
+        @staticmethod
+        _CliqueCountPlan OrderedListing(uint32_t hub_degree)
+
+    uint32_t kMaxCliqueSize "katana::analytics::CliqueCountPlan::kMaxCliqueSize"
+    uint32_t kDefaultHubDegree "katana::analytics::CliqueCountPlan::kDefaultHubDegree"
+
+    Result[uint64_t] CliqueCount(_PropertyGraph* pg, uint32_t clique_size, _CliqueCountPlan plan)
+
+    Result[uint64_t] CliqueCount(_PropertyGraph* pg, uint32_t clique_size, string output_property_name,
+                                 CTxnContext* txn_ctx, _CliqueCountPlan plan)
+
+
+class _CliqueCountPlanAlgorithm(Enum):
+    OrderedListing = _CliqueCountPlan.Algorithm.kOrderedListing
+
+
+cdef class CliqueCountPlan(Plan):
+    """
+    A computational :ref:`Plan` for Clique Counting.
+
+    Static methods construct CliqueCountPlans.
+    """
+    cdef:
+        _CliqueCountPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _CliqueCountPlanAlgorithm
+
+    max_clique_size = kMaxCliqueSize
+
+    @staticmethod
+    cdef CliqueCountPlan make(_CliqueCountPlan u):
+        f = <CliqueCountPlan>CliqueCountPlan.__new__(CliqueCountPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _CliqueCountPlanAlgorithm:
+        return _CliqueCountPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def hub_degree(self) -> int:
+        """
+        The number of smaller neighbors from which the cliques of each neighbor of a node are listed by a separate
+        task.
+
+        :rtype: int
+        """
+        return self.underlying_.hub_degree()
+
+    @staticmethod
+    def ordered_listing(uint32_t hub_degree = kDefaultHubDegree):
+        """
+        List the cliques from their largest node in the orientation of the graph by degree that the ordered count of
+        triangles uses, intersecting the smaller neighbors of the nodes of each clique [Danisch]_.
+
+        :type hub_degree: int
+        :param hub_degree: Nodes with at least this many smaller neighbors have the cliques of each neighbor listed
+            by a task of its own.
+        """
+        return CliqueCountPlan.make(_CliqueCountPlan.OrderedListing(hub_degree))
+
+    def __str__(self):
+        return "CliqueCountPlan({}, {})".format(self.algorithm.name, self.hub_degree)
+
+
+cdef uint64_t handle_result_int(Result[uint64_t] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def clique_count(pg, uint32_t clique_size, str output_property_name = None,
+                 CliqueCountPlan plan = CliqueCountPlan(), *, txn_ctx = None) -> int:
+    """
+    Count the cliques of `clique_size` nodes in `pg`, which must be symmetric. Self loops and parallel edges are
+    ignored.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type clique_size: int
+    :param clique_size: The number of nodes of the cliques, from 2 to ``CliqueCountPlan.max_clique_size``.
+    :type output_property_name: Optional[str]
+    :param output_property_name: If given, a new uint64 node property with the number of cliques each node is in.
+    :type plan: CliqueCountPlan
+    :param plan: The execution plan to use.
+    :return: The number of cliques found.
+    """
+    cdef string output_property_name_str
+    cdef CTxnContext* c_txn_ctx
+    if output_property_name is None:
+        with nogil:
+            v = handle_result_int(CliqueCount(underlying_property_graph(pg), clique_size, plan.underlying_))
+        return v
+    output_property_name_str = bytes(output_property_name, "utf-8")
+    txn_ctx = txn_ctx or TxnContext()
+    c_txn_ctx = underlying_txn_context(txn_ctx)
+    with nogil:
+        v = handle_result_int(CliqueCount(underlying_property_graph(pg), clique_size, output_property_name_str,
+                                          c_txn_ctx, plan.underlying_))
+    return v
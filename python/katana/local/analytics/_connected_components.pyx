@@ -16,6 +16,8 @@ Connected Components
 
 .. autofunction:: katana.local.analytics.connected_components
 
+.. autofunction:: katana.local.analytics.connected_components_task
+
 .. autoclass:: katana.local.analytics.ConnectedComponentsStatistics
 
 """
@@ -32,6 +34,7 @@ from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_r
 from katana.local import Graph, TxnContext
 
 from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.batch cimport AnalyticsTask
 from katana.local.analytics.plan cimport Plan, _Plan
 
 from enum import Enum
@@ -56,7 +59,8 @@ cdef extern from "katana/analytics/connected_components/connected_components.h"
         uint32_t neighbor_sample_size() const
         uint32_t component_sample_frequency() const
 
-        ConnectedComponentsPlan()
+        _ConnectedComponentsPlan()
+        _ConnectedComponentsPlan(const _PropertyGraph * pg)
 
         @staticmethod
         _ConnectedComponentsPlan Serial()
@@ -147,6 +151,15 @@ cdef class ConnectedComponentsPlan(Plan):
         f.underlying_ = u
         return f
 
+    def __init__(self, graph = None):
+        """
+        Construct a plan optimized for `graph` using heuristics, or using default parameter values.
+        """
+        if graph is None:
+            self.underlying_ = _ConnectedComponentsPlan()
+        else:
+            self.underlying_ = _ConnectedComponentsPlan(underlying_property_graph(graph))
+
     @property
     def algorithm(self) -> _ConnectedComponentsPlanAlgorithm:
         return self.underlying_.algorithm()
@@ -248,7 +261,9 @@ cdef class ConnectedComponentsPlan(Plan):
 def connected_components(pg, str output_property_name, bool is_symmetric = False,
                          ConnectedComponentsPlan plan = ConnectedComponentsPlan(), *, txn_ctx = None) -> int:
     """
-    Compute the Connected-components for `pg`. `pg` must be symmetric.
+    Compute the Connected-components for `pg`. Unless `is_symmetric`, these are the weakly connected components;
+    the afforest and label_prop plans compute them from the out-edges and the transposed topology without an
+    undirected view.
 
     :type pg: katana.local.Graph
     :param pg: The graph to analyze.
@@ -284,6 +299,37 @@ def connected_components(pg, str output_property_name, bool is_symmetric = False
         v = handle_result_void(ConnectedComponents(underlying_property_graph(pg), output_property_name_str, underlying_txn_context(txn_ctx), is_symmetric, plan.underlying_))
     return v
 
+cdef cppclass _ConnectedComponentsArguments:
+    string output_property_name
+    bool is_symmetric
+    _ConnectedComponentsPlan plan
+
+
+cdef int _run_connected_components(void* arguments, _PropertyGraph* pg, CTxnContext* txn_ctx) nogil except 0:
+    cdef _ConnectedComponentsArguments* args = <_ConnectedComponentsArguments*>arguments
+    return handle_result_void(ConnectedComponents(pg, args.output_property_name, txn_ctx, args.is_symmetric, args.plan))
+
+
+cdef class _ConnectedComponentsTask(AnalyticsTask):
+    cdef _ConnectedComponentsArguments arguments_
+
+
+def connected_components_task(str output_property_name, bool is_symmetric = False,
+                              ConnectedComponentsPlan plan = ConnectedComponentsPlan()) -> AnalyticsTask:
+    """
+    Create a task for :py:func:`~katana.local.analytics.run_batch` which runs :py:func:`connected_components` with these
+    arguments.
+    """
+    cdef _ConnectedComponentsTask task = _ConnectedComponentsTask.__new__(_ConnectedComponentsTask)
+    task.arguments_.is_symmetric = is_symmetric
+    task.arguments_.output_property_name = output_property_name.encode("utf-8")
+    task.arguments_.plan = plan.underlying_
+    task.output_property_name = output_property_name
+    task.function = _run_connected_components
+    task.arguments = &task.arguments_
+    return task
+
+
 def connected_components_assert_valid(pg, str output_property_name):
     """
     Raise an exception if the Connected Components results in `pg` with the given parameters appear to be incorrect.
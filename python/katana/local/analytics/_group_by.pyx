@@ -0,0 +1,145 @@
+"""
+Group By
+--------
+
+.. autoclass:: katana.local.analytics.GroupByPlan
+
+
+.. autoclass:: katana.local.analytics.GroupByFunction
+
+
+.. autofunction:: katana.local.analytics.group_by
+"""
+from libcpp cimport bool
+from libcpp.memory cimport shared_ptr
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+from pyarrow.lib cimport CTable, pyarrow_wrap_table
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, raise_error_code
+from katana.local._graph cimport underlying_property_graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/group_by/group_by.h" namespace "katana::analytics" nogil:
+    cppclass _GroupByPlan "katana::analytics::GroupByPlan" (_Plan):
+        enum Algorithm:
+            kHash "katana::analytics::GroupByPlan::kHash"
+
+        _GroupByPlan.Algorithm algorithm() const
+
+        # GroupByPlan()
+
+        @staticmethod
+        _GroupByPlan Hash()
+
+    cppclass _GroupByAggregate "katana::analytics::GroupByAggregate":
+        enum Function:
+            kCount "katana::analytics::GroupByAggregate::kCount"
+            kSum "katana::analytics::GroupByAggregate::kSum"
+            kMin "katana::analytics::GroupByAggregate::kMin"
+            kMax "katana::analytics::GroupByAggregate::kMax"
+            kMean "katana::analytics::GroupByAggregate::kMean"
+
+        _GroupByAggregate.Function function
+        string property_name
+
+    Result[shared_ptr[CTable]] GroupBy(_PropertyGraph* pg, const string& key_property_name,
+                                      const vector[_GroupByAggregate]& aggregates, bool cut_metrics,
+                                      _GroupByPlan plan)
+
+
+class _GroupByPlanAlgorithm(Enum):
+    Hash = _GroupByPlan.Algorithm.kHash
+
+
+class GroupByFunction(Enum):
+    """
+    The aggregate functions of :py:func:`group_by`. ``Count`` counts the values that are not null.
+    """
+
+    Count = _GroupByAggregate.Function.kCount
+    Sum = _GroupByAggregate.Function.kSum
+    Min = _GroupByAggregate.Function.kMin
+    Max = _GroupByAggregate.Function.kMax
+    Mean = _GroupByAggregate.Function.kMean
+
+
+cdef class GroupByPlan(Plan):
+    """
+    A computational :ref:`Plan` for grouping nodes by a key property and aggregating the groups.
+
+    Static methods construct GroupByPlans. The constructor will select a reasonable default plan.
+    """
+    cdef:
+        _GroupByPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _GroupByPlanAlgorithm
+
+    @staticmethod
+    cdef GroupByPlan make(_GroupByPlan u):
+        f = <GroupByPlan>GroupByPlan.__new__(GroupByPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> Algorithm:
+        return _GroupByPlanAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def hash() -> GroupByPlan:
+        """
+        Aggregate in a hash table per thread and merge the tables at the end.
+        """
+        return GroupByPlan.make(_GroupByPlan.Hash())
+
+
+cdef _GroupByAggregate make_aggregate(aggregate) except *:
+    function, property_name = aggregate
+    if isinstance(function, str):
+        function = GroupByFunction[function.capitalize()]
+    cdef _GroupByAggregate a
+    a.function = <_GroupByAggregate.Function><int>GroupByFunction(function).value
+    a.property_name = bytes(property_name, "utf-8")
+    return a
+
+
+cdef shared_ptr[CTable] handle_result_table(Result[shared_ptr[CTable]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def group_by(pg, key_property_name, aggregates=(), GroupByPlan plan = GroupByPlan(), *, cut_metrics=False):
+    """
+    Group the nodes by the value of an integer node property, e.g., the communities of
+    :py:func:`~katana.local.analytics.louvain_clustering`, and aggregate each group in parallel. Nodes whose key is null
+    are in no group.
+
+    :param pg: The graph to process.
+    :param key_property_name: The node property to group by.
+    :param aggregates: Pairs of a :py:class:`GroupByFunction`, or its name (e.g., ``"sum"``), and the numeric node
+        property it aggregates. Null values are skipped.
+    :param cut_metrics: Also compute the metrics of each group as a cut of the graph along out-edges:
+        ``internal_edges``, ``cut_edges``, ``volume`` (the sum of the out-degrees of the group) and ``conductance``.
+    :return: A ``pyarrow.Table`` with a row for each group in order of key: the key, ``count``, the number of nodes in
+        the group, a column ``<function>_<property>`` for each aggregate and the cut metrics.
+    """
+    cdef string c_key = bytes(key_property_name, "utf-8")
+    cdef vector[_GroupByAggregate] c_aggregates
+    for aggregate in aggregates:
+        c_aggregates.push_back(make_aggregate(aggregate))
+    cdef bool c_cut_metrics = cut_metrics
+    cdef shared_ptr[CTable] result
+    with nogil:
+        result = handle_result_table(
+            GroupBy(underlying_property_graph(pg), c_key, c_aggregates, c_cut_metrics, plan.underlying_)
+        )
+    return pyarrow_wrap_table(result)
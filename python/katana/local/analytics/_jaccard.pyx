@@ -10,13 +10,26 @@ Jaccard Similarity
 
 .. autofunction:: katana.local.analytics.jaccard
 
+.. autofunction:: katana.local.analytics.jaccard_task
+
 .. autoclass:: katana.local.analytics.JaccardStatistics
 
 
 .. autofunction:: katana.local.analytics.jaccard_assert_valid
+
+.. autoclass:: katana.local.analytics.JaccardSimilarityJoinPlan
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.jaccard_similarity_join
+
+.. autofunction:: katana.local.analytics.jaccard_similarity_join_assert_valid
 """
 
+from libc.stdint cimport uint32_t
+from libcpp.memory cimport shared_ptr
 from libcpp.string cimport string
+from pyarrow.lib cimport CTable, pyarrow_unwrap_table, pyarrow_wrap_table
 
 from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
@@ -26,6 +39,7 @@ from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_r
 from katana.local import Graph, TxnContext
 
 from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.batch cimport AnalyticsTask
 from katana.local.analytics.plan cimport Plan, _Plan
 
 from enum import Enum
@@ -64,6 +78,29 @@ cdef extern from "katana/analytics/jaccard/jaccard.h" namespace "katana::analyti
         Result[_JaccardStatistics] Compute(_PropertyGraph* pg, size_t compare_node,
             string output_property_name)
 
+    cppclass _JaccardSimilarityJoinPlan "katana::analytics::JaccardSimilarityJoinPlan" (_Plan):
+        enum Algorithm:
+            kPrefixFilter "katana::analytics::JaccardSimilarityJoinPlan::kPrefixFilter"
+
+        _JaccardSimilarityJoinPlan.Algorithm algorithm() const
+        double threshold() const
+        uint32_t top_k() const
+
+        _JaccardSimilarityJoinPlan()
+
+        @staticmethod
+        _JaccardSimilarityJoinPlan PrefixFilter(double threshold)
+
+        @staticmethod
+        _JaccardSimilarityJoinPlan TopK(uint32_t top_k, double threshold)
+
+    double kDefaultThreshold "katana::analytics::JaccardSimilarityJoinPlan::kDefaultThreshold"
+
+    Result[shared_ptr[CTable]] JaccardSimilarityJoin(_PropertyGraph* pg, _JaccardSimilarityJoinPlan plan)
+
+    Result[void] JaccardSimilarityJoinAssertValid(_PropertyGraph* pg, const shared_ptr[CTable]& result,
+        _JaccardSimilarityJoinPlan plan)
+
 
 class _JaccardEdgeSorting(Enum):
     """
@@ -174,6 +211,36 @@ def jaccard(pg, size_t compare_node, str output_property_name,
         handle_result_void(Jaccard(underlying_property_graph(pg), compare_node, output_property_name_cstr, underlying_txn_context(txn_ctx), plan.underlying_))
 
 
+cdef cppclass _JaccardArguments:
+    size_t compare_node
+    string output_property_name
+    _JaccardPlan plan
+
+
+cdef int _run_jaccard(void* arguments, _PropertyGraph* pg, CTxnContext* txn_ctx) nogil except 0:
+    cdef _JaccardArguments* args = <_JaccardArguments*>arguments
+    return handle_result_void(Jaccard(pg, args.compare_node, args.output_property_name, txn_ctx, args.plan))
+
+
+cdef class _JaccardTask(AnalyticsTask):
+    cdef _JaccardArguments arguments_
+
+
+def jaccard_task(size_t compare_node, str output_property_name, JaccardPlan plan = JaccardPlan()) -> AnalyticsTask:
+    """
+    Create a task for :py:func:`~katana.local.analytics.run_batch` which runs :py:func:`jaccard` with these
+    arguments.
+    """
+    cdef _JaccardTask task = _JaccardTask.__new__(_JaccardTask)
+    task.arguments_.compare_node = compare_node
+    task.arguments_.output_property_name = output_property_name.encode("utf-8")
+    task.arguments_.plan = plan.underlying_
+    task.output_property_name = output_property_name
+    task.function = _run_jaccard
+    task.arguments = &task.arguments_
+    return task
+
+
 def jaccard_assert_valid(pg, size_t compare_node, str output_property_name):
     """
     Raise an exception if the Jaccard Similarity results in `pg` are invalid. This is not an exhaustive check, just a
@@ -225,3 +292,103 @@ cdef class JaccardStatistics:
         cdef ostringstream ss
         self.underlying.Print(ss)
         return str(ss.str(), "ascii")
+
+
+class _JaccardSimilarityJoinAlgorithm(Enum):
+    """
+    The algorithms available for the Jaccard similarity join.
+
+    :see: :py:class:`~katana.local.analytics.JaccardSimilarityJoinPlan` constructors for algorithm documentation.
+    """
+    PrefixFilter = _JaccardSimilarityJoinPlan.Algorithm.kPrefixFilter
+
+
+cdef class JaccardSimilarityJoinPlan(Plan):
+    """
+    A computational :ref:`Plan` for the Jaccard similarity join of all pairs of nodes.
+
+    Static methods construct JaccardSimilarityJoinPlans.
+    """
+    cdef:
+        _JaccardSimilarityJoinPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _JaccardSimilarityJoinAlgorithm
+
+    @staticmethod
+    cdef JaccardSimilarityJoinPlan make(_JaccardSimilarityJoinPlan u):
+        f = <JaccardSimilarityJoinPlan>JaccardSimilarityJoinPlan.__new__(JaccardSimilarityJoinPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _JaccardSimilarityJoinAlgorithm:
+        return _JaccardSimilarityJoinAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def threshold(self) -> float:
+        """
+        Pairs with a similarity below threshold are pruned.
+        """
+        return self.underlying_.threshold()
+
+    @property
+    def top_k(self) -> int:
+        """
+        The number of most similar nodes to keep per node; 0 keeps all pairs.
+        """
+        return self.underlying_.top_k()
+
+    @staticmethod
+    def prefix_filter(double threshold = kDefaultThreshold) -> JaccardSimilarityJoinPlan:
+        """
+        Find every pair of nodes with a similarity of at least threshold. Higher thresholds prune more candidates.
+        """
+        return JaccardSimilarityJoinPlan.make(_JaccardSimilarityJoinPlan.PrefixFilter(threshold))
+
+    @staticmethod
+    def top_k_similar(uint32_t top_k, double threshold = kDefaultThreshold) -> JaccardSimilarityJoinPlan:
+        """
+        Find the top_k most similar nodes of each node among those with a similarity of at least threshold.
+        """
+        return JaccardSimilarityJoinPlan.make(_JaccardSimilarityJoinPlan.TopK(top_k, threshold))
+
+
+cdef shared_ptr[CTable] handle_result_table(Result[shared_ptr[CTable]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def jaccard_similarity_join(pg, JaccardSimilarityJoinPlan plan = JaccardSimilarityJoinPlan()):
+    """
+    Compute the Jaccard similarity of the out-neighbor sets of all pairs of nodes whose similarity is at least the
+    threshold of the plan.
+
+    :param pg: The graph to analyze.
+    :param plan: The execution plan to use.
+    :return: A ``pyarrow.Table`` with the columns ``source``, ``destination`` and ``similarity``. Without a top_k,
+        each pair appears once with source < destination, ordered by source and destination. With a top_k, each node
+        has a row for each of its top_k most similar other nodes, ordered by source, then decreasing similarity.
+    """
+    cdef shared_ptr[CTable] result
+    with nogil:
+        result = handle_result_table(JaccardSimilarityJoin(underlying_property_graph(pg), plan.underlying_))
+    return pyarrow_wrap_table(result)
+
+
+def jaccard_similarity_join_assert_valid(pg, result, JaccardSimilarityJoinPlan plan = JaccardSimilarityJoinPlan()):
+    """
+    Raise an exception if `result` is not the result of :py:func:`jaccard_similarity_join` on `pg` with `plan`. The
+    expected rows are recomputed by brute force, so this is expensive on large graphs.
+
+    :raises: AssertionError
+    """
+    cdef shared_ptr[CTable] c_result = pyarrow_unwrap_table(result)
+    with nogil:
+        handle_result_assert(
+            JaccardSimilarityJoinAssertValid(underlying_property_graph(pg), c_result, plan.underlying_)
+        )
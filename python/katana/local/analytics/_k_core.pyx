@@ -10,6 +10,8 @@ k-Core
 
 .. autofunction:: katana.local.analytics.k_core
 
+.. autofunction:: katana.local.analytics.k_core_decomposition
+
 .. autoclass:: katana.local.analytics.KCoreStatistics
 
 
@@ -37,6 +39,7 @@ cdef extern from "katana/analytics/k_core/k_core.h" namespace "katana::analytics
         enum Algorithm:
             kSynchronous "katana::analytics::KCorePlan::kSynchronous"
             kAsynchronous "katana::analytics::KCorePlan::kAsynchronous"
+            kBucketDecomposition "katana::analytics::KCorePlan::kBucketDecomposition"
 
         _KCorePlan.Algorithm algorithm() const
 
@@ -46,9 +49,13 @@ cdef extern from "katana/analytics/k_core/k_core.h" namespace "katana::analytics
         _KCorePlan Synchronous()
         @staticmethod
         _KCorePlan Asynchronous()
+        @staticmethod
+        _KCorePlan BucketDecomposition()
 
     Result[void] KCore(_PropertyGraph* pg, uint32_t k_core_number, string output_property_name, CTxnContext* txn_ctx, bool is_symmetric, _KCorePlan plan)
 
+    Result[void] KCoreDecomposition(_PropertyGraph* pg, string output_property_name, CTxnContext* txn_ctx, bool is_symmetric, _KCorePlan plan)
+
 
     Result[void] KCoreAssertValid(_PropertyGraph* pg, uint32_t k_core_number, string output_property_name)
 
@@ -67,6 +74,7 @@ class _KCorePlanAlgorithm(Enum):
     """
     Synchronous = _KCorePlan.Algorithm.kSynchronous
     Asynchronous = _KCorePlan.Algorithm.kAsynchronous
+    BucketDecomposition = _KCorePlan.Algorithm.kBucketDecomposition
 
 
 cdef class KCorePlan(Plan):
@@ -105,6 +113,13 @@ cdef class KCorePlan(Plan):
         Asynchronous
         """
         return KCorePlan.make(_KCorePlan.Asynchronous())
+    @staticmethod
+    def bucket_decomposition() -> KCorePlan:
+        """
+        Core numbers of all nodes by peeling nodes a level at a time from parallel buckets of nodes by degree
+        (Julienne). This is the only plan of :py:func:`k_core_decomposition`.
+        """
+        return KCorePlan.make(_KCorePlan.BucketDecomposition())
 
 
 def k_core(pg, uint32_t k_core_number, str output_property_name, bool is_symmetric = False, KCorePlan plan = KCorePlan(), *, txn_ctx = None) -> int:
@@ -144,6 +159,28 @@ def k_core(pg, uint32_t k_core_number, str output_property_name, bool is_symmetr
     return v
 
 
+def k_core_decomposition(pg, str output_property_name, bool is_symmetric = False, KCorePlan plan = KCorePlan.bucket_decomposition(), *, txn_ctx = None) -> int:
+    """
+    Compute the core number of each node of pg, the largest k such that the node is in the k-core. The pg must be
+    symmetric.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The uint32 output property holding the core number of each node.
+        This property must not already exist.
+    :param is_symmetric: The bool flag to indicate if graph is symmetric.
+    :type plan: KCorePlan
+    :param plan: The execution plan to use. Must be :py:meth:`KCorePlan.bucket_decomposition`.
+    :param txn_ctx: The transaction context for passing read write sets.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        v = handle_result_void(KCoreDecomposition(underlying_property_graph(pg), output_property_name_str, underlying_txn_context(txn_ctx), is_symmetric, plan.underlying_))
+    return v
+
+
 def k_core_assert_valid(pg, uint32_t k_core_number, str output_property_name):
     """
     Raise an exception if the k-core results in `pg` are invalid. This is not an exhaustive check, just a sanity check.
@@ -0,0 +1,114 @@
+"""
+K Shortest Simple Paths
+-----------------------
+
+.. autoclass:: katana.local.analytics.KShortestSimplePathsPlan
+
+
+.. autofunction:: katana.local.analytics.k_shortest_simple_paths
+"""
+from libc.stdint cimport uint32_t
+from libcpp.memory cimport shared_ptr
+from libcpp.string cimport string
+from pyarrow.lib cimport CTable, pyarrow_wrap_table
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, raise_error_code
+from katana.local._graph cimport underlying_property_graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/k_shortest_simple_paths/k_shortest_simple_paths.h" namespace "katana::analytics" nogil:
+    cppclass _KShortestSimplePathsPlan "katana::analytics::KShortestSimplePathsPlan" (_Plan):
+        enum Algorithm:
+            kYen "katana::analytics::KShortestSimplePathsPlan::kYen"
+
+        _KShortestSimplePathsPlan.Algorithm algorithm() const
+
+        # KShortestSimplePathsPlan()
+
+        @staticmethod
+        _KShortestSimplePathsPlan Yen()
+
+    Result[shared_ptr[CTable]] KShortestSimplePaths(_PropertyGraph* pg, uint32_t source, uint32_t target,
+                                                    uint32_t num_paths, const string& edge_weight_property_name,
+                                                    _KShortestSimplePathsPlan plan)
+
+
+class _KShortestSimplePathsPlanAlgorithm(Enum):
+    Yen = _KShortestSimplePathsPlan.Algorithm.kYen
+
+
+cdef class KShortestSimplePathsPlan(Plan):
+    """
+    A computational :ref:`Plan` for finding the shortest simple paths between two nodes.
+
+    Static methods construct KShortestSimplePathsPlans. The constructor will select a reasonable default plan.
+    """
+    cdef:
+        _KShortestSimplePathsPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _KShortestSimplePathsPlanAlgorithm
+
+    @staticmethod
+    cdef KShortestSimplePathsPlan make(_KShortestSimplePathsPlan u):
+        f = <KShortestSimplePathsPlan>KShortestSimplePathsPlan.__new__(KShortestSimplePathsPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> Algorithm:
+        return _KShortestSimplePathsPlanAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def yen() -> KShortestSimplePathsPlan:
+        """
+        Find each path from the paths found before it, by a search from each of its nodes that avoids the paths found
+        so far. The searches of a path are bidirectional Dijkstra searches run in parallel.
+        """
+        return KShortestSimplePathsPlan.make(_KShortestSimplePathsPlan.Yen())
+
+
+cdef shared_ptr[CTable] handle_result_table(Result[shared_ptr[CTable]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def k_shortest_simple_paths(
+    pg,
+    uint32_t source,
+    uint32_t target,
+    uint32_t num_paths,
+    str edge_weight_property_name = "",
+    KShortestSimplePathsPlan plan = KShortestSimplePathsPlan(),
+):
+    """
+    Find the `num_paths` shortest paths from `source` to `target` that visit no node twice, shortest first and ties
+    broken by the sequence of nodes. Fewer are found if there are fewer simple paths.
+
+    :param pg: The graph to analyze.
+    :param source: The first node of each path.
+    :param target: The last node of each path.
+    :param num_paths: The number of paths to find.
+    :param edge_weight_property_name: The non-negative numeric edge weights, or all 1 if empty. Edges whose weight is
+        null are left out of every path.
+    :param plan: The execution plan to use.
+    :return: A ``pyarrow.Table`` with a row for each path, in order: its ``length`` and its ``nodes``.
+    """
+    cdef string c_edge_weight_property_name = bytes(edge_weight_property_name, "utf-8")
+    cdef shared_ptr[CTable] result
+    with nogil:
+        result = handle_result_table(
+            KShortestSimplePaths(
+                underlying_property_graph(pg), source, target, num_paths, c_edge_weight_property_name,
+                plan.underlying_
+            )
+        )
+    return pyarrow_wrap_table(result)
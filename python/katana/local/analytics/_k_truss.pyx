@@ -12,6 +12,8 @@ The k-Truss is a maximal connected subgraph in which all edges are part of at le
 
 .. autofunction:: katana.local.analytics.k_truss
 
+.. autofunction:: katana.local.analytics.k_truss_decomposition
+
 .. autoclass:: katana.local.analytics.KTrussStatistics
 
 
@@ -39,6 +41,7 @@ cdef extern from "katana/analytics/k_truss/k_truss.h" namespace "katana::analyti
             kBsp "katana::analytics::KTrussPlan::kBsp"
             kBspJacobi "katana::analytics::KTrussPlan::kBspJacobi"
             kBspCoreThenTruss "katana::analytics::KTrussPlan::kBspCoreThenTruss"
+            kBucketDecomposition "katana::analytics::KTrussPlan::kBucketDecomposition"
 
         _KTrussPlan.Algorithm algorithm() const
 
@@ -50,9 +53,13 @@ cdef extern from "katana/analytics/k_truss/k_truss.h" namespace "katana::analyti
         _KTrussPlan BspJacobi()
         @staticmethod
         _KTrussPlan BspCoreThenTruss()
+        @staticmethod
+        _KTrussPlan BucketDecomposition()
 
     Result[void] KTruss(CTxnContext* txn_ctx, _PropertyGraph* pg, uint32_t k_truss_number, string output_property_name, _KTrussPlan plan)
 
+    Result[void] KTrussDecomposition(CTxnContext* txn_ctx, _PropertyGraph* pg, string output_property_name, _KTrussPlan plan)
+
     Result[void] KTrussAssertValid(_PropertyGraph* pg, uint32_t k_truss_number,
                                    string output_property_name)
 
@@ -73,6 +80,7 @@ class _KTrussPlanAlgorithm(Enum):
     Bsp = _KTrussPlan.Algorithm.kBsp
     BspJacobi = _KTrussPlan.Algorithm.kBspJacobi
     BspCoreThenTruss = _KTrussPlan.Algorithm.kBspCoreThenTruss
+    BucketDecomposition = _KTrussPlan.Algorithm.kBucketDecomposition
 
 
 cdef class KTrussPlan(Plan):
@@ -120,6 +128,14 @@ cdef class KTrussPlan(Plan):
         """
         return KTrussPlan.make(_KTrussPlan.BspCoreThenTruss())
 
+    @staticmethod
+    def bucket_decomposition() -> KTrussPlan:
+        """
+        Trussness of all edges by peeling edges a support level at a time from parallel buckets of edges by
+        support. This is the only plan of :py:func:`k_truss_decomposition`.
+        """
+        return KTrussPlan.make(_KTrussPlan.BucketDecomposition())
+
 
 def k_truss(pg, uint32_t k_truss_number, str output_property_name, KTrussPlan plan = KTrussPlan(), *, txn_ctx = None) -> int:
     """
@@ -157,6 +173,27 @@ def k_truss(pg, uint32_t k_truss_number, str output_property_name, KTrussPlan pl
     return v
 
 
+def k_truss_decomposition(pg, str output_property_name, KTrussPlan plan = KTrussPlan.bucket_decomposition(), *, txn_ctx = None) -> int:
+    """
+    Compute the trussness of each edge of pg, the largest k such that the edge is in the k-truss, so that the k-truss
+    for any k is the edges of trussness at least k. `pg` must be symmetric.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The uint32 output edge property holding the trussness of each edge.
+        This property must not already exist.
+    :type plan: KTrussPlan
+    :param plan: The execution plan to use. Must be :py:meth:`KTrussPlan.bucket_decomposition`.
+    :param txn_ctx: The transaction context for passing read write sets.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        v = handle_result_void(KTrussDecomposition(underlying_txn_context(txn_ctx), underlying_property_graph(pg), output_property_name_str, plan.underlying_))
+    return v
+
+
 def k_truss_assert_valid(pg, uint32_t k_truss_number, str output_property_name):
     """
     Raise an exception if the k-truss results in `pg` are invalid. This is not an exhaustive check, just a sanity check.
@@ -10,6 +10,7 @@ Local Clustering Coefficient
 
 .. autofunction:: katana.local.analytics.local_clustering_coefficient
 """
+from libc.stdint cimport uint32_t, uint64_t
 from libcpp cimport bool
 from libcpp.string cimport string
 
@@ -32,6 +33,7 @@ cdef extern from "katana/analytics/local_clustering_coefficient/local_clustering
         enum Algorithm:
             kOrderedCountAtomics "katana::analytics::LocalClusteringCoefficientPlan::kOrderedCountAtomics"
             kOrderedCountPerThread "katana::analytics::LocalClusteringCoefficientPlan::kOrderedCountPerThread"
+            kWedgeSampling "katana::analytics::LocalClusteringCoefficientPlan::kWedgeSampling"
 
         enum Relabeling:
             kRelabel "katana::analytics::LocalClusteringCoefficientPlan::kRelabel"
@@ -41,6 +43,8 @@ cdef extern from "katana/analytics/local_clustering_coefficient/local_clustering
         _LocalClusteringCoefficientPlan.Algorithm algorithm() const
         _LocalClusteringCoefficientPlan.Relabeling relabeling() const
         bool edges_sorted() const
+        uint32_t num_samples() const
+        uint64_t seed() const
 
         # LocalClusteringCoefficientPlan()
 
@@ -54,9 +58,13 @@ cdef extern from "katana/analytics/local_clustering_coefficient/local_clustering
                 bool edges_sorted,
                 _LocalClusteringCoefficientPlan.Relabeling relabeling
             )
+        @staticmethod
+        _LocalClusteringCoefficientPlan WedgeSampling(uint32_t num_samples, uint64_t seed)
 
     _LocalClusteringCoefficientPlan.Relabeling kDefaultRelabeling "katana::analytics::LocalClusteringCoefficientPlan::kDefaultRelabeling"
     bool kDefaultEdgesSorted "katana::analytics::LocalClusteringCoefficientPlan::kDefaultEdgesSorted"
+    uint32_t kDefaultNumSamples "katana::analytics::LocalClusteringCoefficientPlan::kDefaultNumSamples"
+    uint64_t kDefaultSeed "katana::analytics::LocalClusteringCoefficientPlan::kDefaultSeed"
 
     Result[void] LocalClusteringCoefficient(_PropertyGraph* pfg, const string& output_property_name, CTxnContext* txn_ctx, _LocalClusteringCoefficientPlan plan)
 
@@ -67,6 +75,7 @@ class _LocalClusteringCoefficientPlanAlgorithm(Enum):
     """
     OrderedCountAtomics = _LocalClusteringCoefficientPlan.Algorithm.kOrderedCountAtomics
     OrderedCountPerThread = _LocalClusteringCoefficientPlan.Algorithm.kOrderedCountPerThread
+    WedgeSampling = _LocalClusteringCoefficientPlan.Algorithm.kWedgeSampling
 
 
 cdef _relabeling_to_python(v):
@@ -152,6 +161,19 @@ cdef class LocalClusteringCoefficientPlan(Plan):
         return LocalClusteringCoefficientPlan.make(_LocalClusteringCoefficientPlan.OrderedCountPerThread(
              edges_sorted, _relabeling_from_python(relabeling)))
 
+    @staticmethod
+    def wedge_sampling(uint32_t num_samples = kDefaultNumSamples, uint64_t seed = kDefaultSeed):
+        """
+        Estimate the coefficient of each node as the fraction of `num_samples` uniformly sampled wedges (pairs of
+        neighbors) centered at the node that are closed by an edge, which has a standard error of at most
+        0.5 / sqrt(num_samples). Nodes with at most `num_samples` wedges are computed exactly. The graph must not have
+        self loops or parallel edges.
+
+        :param num_samples: The number of wedges to sample at each node.
+        :param seed: The seed of the samples.
+        """
+        return LocalClusteringCoefficientPlan.make(_LocalClusteringCoefficientPlan.WedgeSampling(num_samples, seed))
+
 
 def local_clustering_coefficient(pg, str output_property_name, LocalClusteringCoefficientPlan plan = LocalClusteringCoefficientPlan(), *, txn_ctx = None):
     cdef string output_property_name_str = bytes(output_property_name, "utf-8")
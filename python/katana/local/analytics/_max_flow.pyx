@@ -0,0 +1,208 @@
+"""
+Maximum Flow
+------------
+
+.. autoclass:: katana.local.analytics.MaxFlowPlan
+
+
+.. autoclass:: katana.local.analytics._max_flow._MaxFlowPlanAlgorithm
+
+
+.. autofunction:: katana.local.analytics.max_flow
+
+.. autoclass:: katana.local.analytics.MaxFlowStatistics
+
+
+.. autofunction:: katana.local.analytics.max_flow_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp cimport bool
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from katana.local import Graph, TxnContext
+
+from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/max_flow/max_flow.h" namespace "katana::analytics" nogil:
+    cppclass _MaxFlowPlan "katana::analytics::MaxFlowPlan" (_Plan):
+        enum Algorithm:
+            kPreflowPush "katana::analytics::MaxFlowPlan::kPreflowPush"
+
+        _MaxFlowPlan.Algorithm algorithm() const
+        uint32_t global_relabel_interval() const
+        bool gap_heuristic() const
+
+        MaxFlowPlan()
+
+        @staticmethod
+        _MaxFlowPlan PreflowPush(uint32_t global_relabel_interval, bool gap_heuristic)
+
+    uint32_t kDefaultGlobalRelabelInterval "katana::analytics::MaxFlowPlan::kDefaultGlobalRelabelInterval"
+    bool kDefaultGapHeuristic "katana::analytics::MaxFlowPlan::kDefaultGapHeuristic"
+
+    Result[void] MaxFlow(_PropertyGraph* pg, uint32_t source, uint32_t sink, string capacity_property_name,
+                         string output_property_name, CTxnContext* txn_ctx, _MaxFlowPlan plan)
+
+    Result[void] MaxFlowAssertValid(_PropertyGraph* pg, uint32_t source, uint32_t sink, string capacity_property_name,
+                                    string output_property_name)
+
+    cppclass _MaxFlowStatistics "katana::analytics::MaxFlowStatistics":
+        uint64_t flow_value
+        uint64_t saturated_edges
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MaxFlowStatistics] Compute(_PropertyGraph* pg, uint32_t source, uint32_t sink,
+                                           string capacity_property_name, string output_property_name)
+
+
+class _MaxFlowPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.MaxFlowPlan` constructors for algorithm documentation.
+    """
+    PreflowPush = _MaxFlowPlan.Algorithm.kPreflowPush
+
+
+cdef class MaxFlowPlan(Plan):
+    """
+    A computational :ref:`Plan` for maximum flows.
+
+    Static methods construct MaxFlowPlans.
+    """
+    cdef:
+        _MaxFlowPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MaxFlowPlanAlgorithm
+
+    @staticmethod
+    cdef MaxFlowPlan make(_MaxFlowPlan u):
+        f = <MaxFlowPlan>MaxFlowPlan.__new__(MaxFlowPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> MaxFlowPlan.Algorithm:
+        return self.underlying_.algorithm()
+
+    @property
+    def global_relabel_interval(self) -> int:
+        return self.underlying_.global_relabel_interval()
+
+    @property
+    def gap_heuristic(self) -> bool:
+        return self.underlying_.gap_heuristic()
+
+    @staticmethod
+    def preflow_push(global_relabel_interval=kDefaultGlobalRelabelInterval,
+                     gap_heuristic=kDefaultGapHeuristic) -> MaxFlowPlan:
+        """
+        Parallel preflow-push: active nodes push their excess flow to lower neighbors in parallel without locks and are
+        relabeled when none are left. Every `global_relabel_interval` work, or a work in proportion to the size of the
+        graph if it is 0, a parallel breadth first search from the sink resets the heights to residual distances. With
+        `gap_heuristic`, heights that empty out lift the nodes above them out of reach of the sink.
+        """
+        return MaxFlowPlan.make(_MaxFlowPlan.PreflowPush(global_relabel_interval, gap_heuristic))
+
+
+def max_flow(pg, uint32_t source, uint32_t sink, str capacity_property_name, str output_property_name,
+             MaxFlowPlan plan = MaxFlowPlan(), *, txn_ctx = None):
+    """
+    Compute a maximum flow from `source` to `sink` in `pg`.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type source: Node ID
+    :param source: The node flow leaves.
+    :type sink: Node ID
+    :param sink: The node flow enters.
+    :type capacity_property_name: str
+    :param capacity_property_name: The input property containing edge capacities, a 32- or 64-bit signed or unsigned
+        int. Capacities may not be negative. If empty, every edge has capacity 1.
+    :type output_property_name: str
+    :param output_property_name: The uint64 output edge property holding the flow on each edge. This property must not
+        already exist.
+    :type plan: MaxFlowPlan
+    :param plan: The execution plan to use.
+    :param txn_ctx: The transaction context for passing read write sets.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_rdg_dataset
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_rdg_dataset("ldbc_003"))
+        from katana.analytics import max_flow, MaxFlowStatistics
+        max_flow(graph, 0, 100, "", "flow")
+        stats = MaxFlowStatistics(graph, 0, 100, "", "flow")
+        print("Flow value:", stats.flow_value)
+
+    """
+    cdef string capacity_property_name_str = bytes(capacity_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        handle_result_void(MaxFlow(underlying_property_graph(pg), source, sink, capacity_property_name_str,
+                                   output_property_name_str, underlying_txn_context(txn_ctx), plan.underlying_))
+
+
+def max_flow_assert_valid(pg, uint32_t source, uint32_t sink, str capacity_property_name, str output_property_name):
+    """
+    Raise an exception if the flow in `output_property_name` exceeds a capacity, is not conserved at a node other than
+    `source` and `sink`, or leaves an augmenting path from `source` to `sink`.
+
+    :raises: AssertionError
+    """
+    cdef string capacity_property_name_str = bytes(capacity_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_assert(MaxFlowAssertValid(underlying_property_graph(pg), source, sink,
+                                                capacity_property_name_str, output_property_name_str))
+
+
+cdef _MaxFlowStatistics handle_result_MaxFlowStatistics(Result[_MaxFlowStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MaxFlowStatistics:
+    """
+    Compute the :ref:`statistics` of a maximum flow result.
+    """
+    cdef _MaxFlowStatistics underlying
+
+    def __init__(self, pg, uint32_t source, uint32_t sink, str capacity_property_name, str output_property_name):
+        cdef string capacity_property_name_str = bytes(capacity_property_name, "utf-8")
+        cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_MaxFlowStatistics(_MaxFlowStatistics.Compute(
+                underlying_property_graph(pg), source, sink, capacity_property_name_str, output_property_name_str))
+
+    @property
+    def flow_value(self) -> uint64_t:
+        return self.underlying.flow_value
+
+    @property
+    def saturated_edges(self) -> uint64_t:
+        return self.underlying.saturated_edges
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,212 @@
+"""
+Minimum Spanning Forest
+-----------------------
+
+.. autoclass:: katana.local.analytics.MinimumSpanningForestPlan
+
+
+.. autoclass:: katana.local.analytics._minimum_spanning_forest._MinimumSpanningForestPlanAlgorithm
+
+
+.. autofunction:: katana.local.analytics.minimum_spanning_forest
+
+.. autoclass:: katana.local.analytics.MinimumSpanningForestStatistics
+
+
+.. autofunction:: katana.local.analytics.minimum_spanning_forest_assert_valid
+"""
+from libc.stdint cimport uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from katana.local import Graph, TxnContext
+
+from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h" namespace "katana::analytics" nogil:
+    cppclass _MinimumSpanningForestPlan "katana::analytics::MinimumSpanningForestPlan" (_Plan):
+        enum Algorithm:
+            kBoruvka "katana::analytics::MinimumSpanningForestPlan::kBoruvka"
+            kFilterKruskal "katana::analytics::MinimumSpanningForestPlan::kFilterKruskal"
+
+        _MinimumSpanningForestPlan.Algorithm algorithm() const
+        uint64_t base_case_edges() const
+
+        MinimumSpanningForestPlan()
+
+        @staticmethod
+        _MinimumSpanningForestPlan Boruvka()
+        @staticmethod
+        _MinimumSpanningForestPlan FilterKruskal(uint64_t base_case_edges)
+
+    uint64_t kDefaultBaseCaseEdges "katana::analytics::MinimumSpanningForestPlan::kDefaultBaseCaseEdges"
+
+    Result[void] MinimumSpanningForest(_PropertyGraph* pg, string edge_weight_property_name, string output_property_name, CTxnContext* txn_ctx, _MinimumSpanningForestPlan plan)
+
+    Result[void] MinimumSpanningForestAssertValid(_PropertyGraph* pg, string edge_weight_property_name, string output_property_name)
+
+    cppclass _MinimumSpanningForestStatistics "katana::analytics::MinimumSpanningForestStatistics":
+        uint64_t num_trees
+        uint64_t num_edges
+        double total_weight
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MinimumSpanningForestStatistics] Compute(_PropertyGraph* pg, string edge_weight_property_name, string output_property_name)
+
+
+class _MinimumSpanningForestPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.MinimumSpanningForestPlan` constructors for algorithm documentation.
+    """
+    Boruvka = _MinimumSpanningForestPlan.Algorithm.kBoruvka
+    FilterKruskal = _MinimumSpanningForestPlan.Algorithm.kFilterKruskal
+
+
+cdef class MinimumSpanningForestPlan(Plan):
+    """
+    A computational :ref:`Plan` for minimum spanning forests.
+
+    Static methods construct MinimumSpanningForestPlans.
+    """
+    cdef:
+        _MinimumSpanningForestPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MinimumSpanningForestPlanAlgorithm
+
+    @staticmethod
+    cdef MinimumSpanningForestPlan make(_MinimumSpanningForestPlan u):
+        f = <MinimumSpanningForestPlan>MinimumSpanningForestPlan.__new__(MinimumSpanningForestPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> MinimumSpanningForestPlan.Algorithm:
+        return self.underlying_.algorithm()
+
+    @property
+    def base_case_edges(self) -> int:
+        return self.underlying_.base_case_edges()
+
+    @staticmethod
+    def boruvka() -> MinimumSpanningForestPlan:
+        """
+        Parallel Boruvka: every component picks its lightest edge to another component in parallel and the components
+        are merged along those edges, until no edges join two components.
+        """
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.Boruvka())
+
+    @staticmethod
+    def filter_kruskal(base_case_edges=kDefaultBaseCaseEdges) -> MinimumSpanningForestPlan:
+        """
+        Filter-Kruskal: edges are split in parallel around a pivot weight, the light half is solved first and the heavy
+        half is filtered of edges within components before it is solved. Edge sets of at most `base_case_edges` edges
+        are sorted and scanned by Kruskal's algorithm.
+        """
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.FilterKruskal(base_case_edges))
+
+
+def minimum_spanning_forest(pg, str edge_weight_property_name, str output_property_name,
+                            MinimumSpanningForestPlan plan = MinimumSpanningForestPlan(), *, txn_ctx = None):
+    """
+    Compute a minimum spanning forest of `pg` taken as undirected. Edges of equal weight are ordered by their ids, so
+    the forest is unique. Of the two directions of an undirected edge only one is taken.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The input property containing edge weights. If empty, every edge weighs 1.
+    :type output_property_name: str
+    :param output_property_name: The uint8 output edge property, 1 for the edges of the forest and 0 otherwise. This
+        property must not already exist.
+    :type plan: MinimumSpanningForestPlan
+    :param plan: The execution plan to use.
+    :param txn_ctx: The transaction context for passing read write sets.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_rdg_dataset
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_rdg_dataset("ldbc_003"))
+        from katana.analytics import minimum_spanning_forest, MinimumSpanningForestStatistics
+        minimum_spanning_forest(graph, "workFrom", "in_forest")
+        stats = MinimumSpanningForestStatistics(graph, "workFrom", "in_forest")
+        print("Trees:", stats.num_trees)
+
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        handle_result_void(MinimumSpanningForest(underlying_property_graph(pg), edge_weight_property_name_str,
+                                                 output_property_name_str, underlying_txn_context(txn_ctx),
+                                                 plan.underlying_))
+
+
+def minimum_spanning_forest_assert_valid(pg, str edge_weight_property_name, str output_property_name):
+    """
+    Raise an exception if the forest in `output_property_name` has a cycle, does not span the components of `pg` or
+    weighs more than a forest found by sequential Kruskal's algorithm.
+
+    :raises: AssertionError
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_assert(MinimumSpanningForestAssertValid(underlying_property_graph(pg),
+                                                              edge_weight_property_name_str,
+                                                              output_property_name_str))
+
+
+cdef _MinimumSpanningForestStatistics handle_result_MinimumSpanningForestStatistics(
+        Result[_MinimumSpanningForestStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MinimumSpanningForestStatistics:
+    """
+    Compute the :ref:`statistics` of a minimum spanning forest result.
+    """
+    cdef _MinimumSpanningForestStatistics underlying
+
+    def __init__(self, pg, str edge_weight_property_name, str output_property_name):
+        cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+        cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+        with nogil:
+            self.underlying = handle_result_MinimumSpanningForestStatistics(_MinimumSpanningForestStatistics.Compute(
+                underlying_property_graph(pg), edge_weight_property_name_str, output_property_name_str))
+
+    @property
+    def num_trees(self) -> uint64_t:
+        return self.underlying.num_trees
+
+    @property
+    def num_edges(self) -> uint64_t:
+        return self.underlying.num_edges
+
+    @property
+    def total_weight(self) -> float:
+        return self.underlying.total_weight
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
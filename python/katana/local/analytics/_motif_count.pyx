@@ -0,0 +1,174 @@
+"""
+Motif Counting
+--------------
+
+.. autoclass:: katana.local.analytics.MotifCountPlan
+
+
+.. autoclass:: katana.local.analytics._motif_count._MotifCountPlanAlgorithm
+
+
+.. autoclass:: katana.local.analytics.MotifCounts
+
+
+.. autofunction:: katana.local.analytics.motif_count
+
+.. [Ortmann] Mark Ortmann and Ulrik Brandes. Efficient Orbit-Aware Triad and Quad Census in Directed and Undirected
+    Graphs. Applied Network Science 2017.
+"""
+from libc.stdint cimport uint64_t
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, raise_error_code
+
+from katana.local import Graph
+
+from katana.local._graph cimport underlying_property_graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/motif_count/motif_count.h" namespace "katana::analytics" nogil:
+    cppclass _MotifCountPlan "katana::analytics::MotifCountPlan" (_Plan):
+        enum Algorithm:
+            kEdgeCentric "katana::analytics::MotifCountPlan::kEdgeCentric"
+
+        _MotifCountPlan.Algorithm algorithm() const
+
+        MotifCountPlan()
+
+        @staticmethod
+        _MotifCountPlan EdgeCentric()
+
+    cppclass _MotifCounts "katana::analytics::MotifCounts":
+        uint64_t triangles
+        uint64_t open_wedges
+        uint64_t paths
+        uint64_t three_stars
+        uint64_t four_cycles
+        uint64_t tailed_triangles
+        uint64_t diamonds
+        uint64_t four_cliques
+
+    Result[_MotifCounts] MotifCount(_PropertyGraph* pg, _MotifCountPlan plan)
+
+
+class _MotifCountPlanAlgorithm(Enum):
+    EdgeCentric = _MotifCountPlan.Algorithm.kEdgeCentric
+
+
+cdef class MotifCountPlan(Plan):
+    """
+    A computational :ref:`Plan` for Motif Counting.
+
+    Static methods construct MotifCountPlans.
+    """
+    cdef:
+        _MotifCountPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MotifCountPlanAlgorithm
+
+    @staticmethod
+    cdef MotifCountPlan make(_MotifCountPlan u):
+        f = <MotifCountPlan>MotifCountPlan.__new__(MotifCountPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _MotifCountPlanAlgorithm:
+        return _MotifCountPlanAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def edge_centric():
+        """
+        Count the motifs from the triangles through each edge and the wedges of each node, turning counts of
+        subgraphs into counts of induced subgraphs [Ortmann]_.
+        """
+        return MotifCountPlan.make(_MotifCountPlan.EdgeCentric())
+
+    def __str__(self):
+        return "MotifCountPlan({})".format(self.algorithm.name)
+
+
+cdef class MotifCounts:
+    """
+    The number of connected induced subgraphs of 3 and 4 nodes of a graph of each shape.
+    """
+    cdef _MotifCounts underlying
+
+    @property
+    def triangles(self) -> int:
+        return self.underlying.triangles
+
+    @property
+    def open_wedges(self) -> int:
+        """
+        Paths of 3 nodes whose ends are not adjacent.
+        """
+        return self.underlying.open_wedges
+
+    @property
+    def paths(self) -> int:
+        """
+        Paths of 4 nodes.
+        """
+        return self.underlying.paths
+
+    @property
+    def three_stars(self) -> int:
+        """
+        A node and 3 neighbors.
+        """
+        return self.underlying.three_stars
+
+    @property
+    def four_cycles(self) -> int:
+        return self.underlying.four_cycles
+
+    @property
+    def tailed_triangles(self) -> int:
+        """
+        A triangle and an edge from one of its nodes.
+        """
+        return self.underlying.tailed_triangles
+
+    @property
+    def diamonds(self) -> int:
+        """
+        A 4-clique without an edge.
+        """
+        return self.underlying.diamonds
+
+    @property
+    def four_cliques(self) -> int:
+        return self.underlying.four_cliques
+
+
+cdef _MotifCounts handle_result_motif_counts(Result[_MotifCounts] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def motif_count(pg, MotifCountPlan plan = MotifCountPlan()) -> MotifCounts:
+    """
+    Count the connected induced subgraphs of 3 and 4 nodes of `pg` by shape. The graph must be symmetric, without self
+    loops or parallel edges.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type plan: MotifCountPlan
+    :param plan: The execution plan to use.
+    :rtype: MotifCounts
+    """
+    cdef _MotifCounts c
+    cdef MotifCounts counts = MotifCounts()
+    with nogil:
+        c = handle_result_motif_counts(MotifCount(underlying_property_graph(pg), plan.underlying_))
+    counts.underlying = c
+    return counts
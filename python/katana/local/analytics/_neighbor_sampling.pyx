@@ -0,0 +1,239 @@
+"""
+Neighbor Sampling
+-----------------
+
+.. autoclass:: katana.local.analytics.NeighborSamplingPlan
+
+
+.. autoclass:: katana.local.analytics.NeighborSampleBlock
+
+
+.. autofunction:: katana.local.analytics.neighbor_sampling
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.memory cimport shared_ptr
+from libcpp.pair cimport pair
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+from pyarrow.lib cimport CArray, CTable, CUInt32Array, CUInt64Array, pyarrow_wrap_array, pyarrow_wrap_table
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, raise_error_code
+from katana.local._graph cimport underlying_property_graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+from typing import NamedTuple
+
+
+cdef extern from "katana/analytics/neighbor_sampling/neighbor_sampling.h" namespace "katana::analytics" nogil:
+    cppclass _NeighborSamplingPlan "katana::analytics::NeighborSamplingPlan" (_Plan):
+        enum Algorithm:
+            kUniform "katana::analytics::NeighborSamplingPlan::kUniform"
+            kWeighted "katana::analytics::NeighborSamplingPlan::kWeighted"
+
+        enum EdgeDirection:
+            kInEdges "katana::analytics::NeighborSamplingPlan::kInEdges"
+            kOutEdges "katana::analytics::NeighborSamplingPlan::kOutEdges"
+
+        _NeighborSamplingPlan.Algorithm algorithm() const
+        _NeighborSamplingPlan.EdgeDirection edge_direction() const
+        const string& edge_weight_property_name() const
+        uint64_t seed() const
+
+        # NeighborSamplingPlan()
+
+        @staticmethod
+        _NeighborSamplingPlan Uniform(_NeighborSamplingPlan.EdgeDirection edge_direction, uint64_t seed)
+
+        @staticmethod
+        _NeighborSamplingPlan Weighted(
+            const string& edge_weight_property_name, _NeighborSamplingPlan.EdgeDirection edge_direction,
+            uint64_t seed)
+
+    uint64_t kDefaultSeed "katana::analytics::NeighborSamplingPlan::kDefaultSeed"
+
+    cppclass _NeighborSamplingFanout "katana::analytics::NeighborSamplingFanout":
+        uint32_t fanout
+        vector[pair[string, uint32_t]] edge_type_fanouts
+
+    uint32_t kAllNeighbors "katana::analytics::NeighborSamplingFanout::kAll"
+
+    cppclass _NeighborSampleBlock "katana::analytics::NeighborSampleBlock":
+        uint64_t num_dst
+        uint64_t num_src
+        shared_ptr[CUInt64Array] indptr
+        shared_ptr[CUInt32Array] indices
+        shared_ptr[CUInt64Array] edge_ids
+
+    cppclass _NeighborSample "katana::analytics::NeighborSample":
+        shared_ptr[CUInt32Array] nodes
+        vector[_NeighborSampleBlock] blocks
+        shared_ptr[CTable] node_features
+
+    Result[_NeighborSample] NeighborSampling(_PropertyGraph* pg, const vector[uint32_t]& seeds,
+                                             const vector[_NeighborSamplingFanout]& fanouts,
+                                             const vector[string]& node_feature_properties,
+                                             _NeighborSamplingPlan plan)
+
+
+class _NeighborSamplingPlanAlgorithm(Enum):
+    Uniform = _NeighborSamplingPlan.Algorithm.kUniform
+    Weighted = _NeighborSamplingPlan.Algorithm.kWeighted
+
+
+class _NeighborSamplingPlanEdgeDirection(Enum):
+    InEdges = _NeighborSamplingPlan.EdgeDirection.kInEdges
+    OutEdges = _NeighborSamplingPlan.EdgeDirection.kOutEdges
+
+
+cdef _NeighborSamplingPlan.EdgeDirection to_edge_direction(edge_direction) except *:
+    if _NeighborSamplingPlanEdgeDirection(edge_direction) == _NeighborSamplingPlanEdgeDirection.OutEdges:
+        return _NeighborSamplingPlan.EdgeDirection.kOutEdges
+    return _NeighborSamplingPlan.EdgeDirection.kInEdges
+
+
+cdef class NeighborSamplingPlan(Plan):
+    """
+    A computational :ref:`Plan` for sampling the k-hop neighborhoods of seed nodes.
+
+    Static methods construct NeighborSamplingPlans. The constructor will select a reasonable default plan.
+    """
+    cdef:
+        _NeighborSamplingPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _NeighborSamplingPlanAlgorithm
+    EdgeDirection = _NeighborSamplingPlanEdgeDirection
+
+    @staticmethod
+    cdef NeighborSamplingPlan make(_NeighborSamplingPlan u):
+        f = <NeighborSamplingPlan>NeighborSamplingPlan.__new__(NeighborSamplingPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> Algorithm:
+        return _NeighborSamplingPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def edge_direction(self) -> EdgeDirection:
+        return _NeighborSamplingPlanEdgeDirection(self.underlying_.edge_direction())
+
+    @property
+    def edge_weight_property_name(self) -> str:
+        return bytes(self.underlying_.edge_weight_property_name()).decode("utf-8")
+
+    @property
+    def seed(self) -> int:
+        return self.underlying_.seed()
+
+    @staticmethod
+    def uniform(
+        edge_direction=_NeighborSamplingPlanEdgeDirection.InEdges, uint64_t seed=kDefaultSeed
+    ) -> NeighborSamplingPlan:
+        """
+        Sample neighbors uniformly, without replacement.
+
+        :param edge_direction: Sample along the in-edges or the out-edges of nodes.
+        :param seed: The seed of the random numbers.
+        """
+        return NeighborSamplingPlan.make(_NeighborSamplingPlan.Uniform(to_edge_direction(edge_direction), seed))
+
+    @staticmethod
+    def weighted(
+        edge_weight_property_name,
+        edge_direction=_NeighborSamplingPlanEdgeDirection.InEdges,
+        uint64_t seed=kDefaultSeed,
+    ) -> NeighborSamplingPlan:
+        """
+        Sample neighbors without replacement in proportion to the weights of their edges. Edges whose weight is null
+        or not positive are never sampled.
+
+        :param edge_weight_property_name: The numeric edge property holding the weights.
+        :param edge_direction: Sample along the in-edges or the out-edges of nodes.
+        :param seed: The seed of the random numbers.
+        """
+        return NeighborSamplingPlan.make(
+            _NeighborSamplingPlan.Weighted(
+                bytes(edge_weight_property_name, "utf-8"),
+                to_edge_direction(edge_direction),
+                seed,
+            )
+        )
+
+
+class NeighborSampleBlock(NamedTuple):
+    """
+    The edges sampled in one hop as a CSR matrix. The edges of destination ``i`` are
+    ``indices[indptr[i]:indptr[i + 1]]``; destinations and sources are indices into the sampled nodes. The sources
+    begin with the destinations.
+    """
+
+    num_dst: int
+    num_src: int
+    indptr: object
+    indices: object
+    edge_ids: object
+
+
+cdef _NeighborSamplingFanout make_fanout(fanout) except *:
+    cdef _NeighborSamplingFanout f
+    if fanout is None:
+        f.fanout = kAllNeighbors
+    elif isinstance(fanout, dict):
+        for name, count in fanout.items():
+            f.edge_type_fanouts.push_back(pair[string, uint32_t](bytes(name, "utf-8"), count))
+    else:
+        f.fanout = fanout
+    return f
+
+
+cdef _NeighborSample handle_result_neighbor_sample(Result[_NeighborSample] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def neighbor_sampling(pg, seeds, fanouts, NeighborSamplingPlan plan = NeighborSamplingPlan(), *, node_features=()):
+    """
+    Sample the k-hop neighborhoods of the seeds as a mini-batch for a graph neural network, one hop for each fanout.
+    Hop ``h`` samples the neighbors of all nodes sampled before it.
+
+    :param pg: The graph to sample.
+    :param seeds: The distinct nodes to sample the neighborhoods of.
+    :param fanouts: For each hop, the number of neighbors sampled for each node: an int, None to take all
+        neighbors, or a dict from edge type names to the number of neighbors sampled along edges of each type.
+    :param node_features: The names of the node properties gathered for the sampled nodes.
+    :return: The sampled nodes as a ``pyarrow.UInt32Array`` (the seeds first, then the nodes reached in each hop), a
+        :py:class:`NeighborSampleBlock` for each hop, and a ``pyarrow.Table`` of the features of the sampled nodes.
+    """
+    cdef vector[uint32_t] c_seeds = [<uint32_t>n for n in seeds]
+    cdef vector[_NeighborSamplingFanout] c_fanouts
+    for fanout in fanouts:
+        c_fanouts.push_back(make_fanout(fanout))
+    cdef vector[string] c_features = [bytes(p, "utf-8") for p in node_features]
+    cdef _NeighborSample sample
+    with nogil:
+        sample = handle_result_neighbor_sample(
+            NeighborSampling(underlying_property_graph(pg), c_seeds, c_fanouts, c_features, plan.underlying_)
+        )
+    blocks = []
+    for i in range(sample.blocks.size()):
+        blocks.append(
+            NeighborSampleBlock(
+                sample.blocks[i].num_dst,
+                sample.blocks[i].num_src,
+                pyarrow_wrap_array(<shared_ptr[CArray]>sample.blocks[i].indptr),
+                pyarrow_wrap_array(<shared_ptr[CArray]>sample.blocks[i].indices),
+                pyarrow_wrap_array(<shared_ptr[CArray]>sample.blocks[i].edge_ids),
+            )
+        )
+    return (
+        pyarrow_wrap_array(<shared_ptr[CArray]>sample.nodes),
+        blocks,
+        pyarrow_wrap_table(sample.node_features),
+    )
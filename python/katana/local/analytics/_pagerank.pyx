@@ -14,12 +14,24 @@ Page Rank
 
 .. autofunction:: katana.local.analytics.pagerank
 
+.. autofunction:: katana.local.analytics.pagerank_task
+
 .. autoclass:: katana.local.analytics.PagerankStatistics
 
 
 .. autofunction:: katana.local.analytics.pagerank_assert_valid
+
+
+.. autoclass:: katana.local.analytics.PersonalizedPagerankPlan
+
+
+.. autofunction:: katana.local.analytics.personalized_pagerank
+
+.. autofunction:: katana.local.analytics.personalized_pagerank_assert_valid
 """
+from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 
 from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
@@ -29,6 +41,7 @@ from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_r
 from katana.local import Graph, TxnContext
 
 from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.batch cimport AnalyticsTask
 from katana.local.analytics.plan cimport Plan, _Plan
 
 from enum import Enum
@@ -50,7 +63,8 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
         float alpha() const
         float initial_residual() const
 
-        PagerankPlan()
+        _PagerankPlan()
+        _PagerankPlan(const _PropertyGraph * pg)
 
         @staticmethod
         _PagerankPlan PullTopological(float tolerance, unsigned int max_iterations, float alpha)
@@ -79,6 +93,37 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
         @staticmethod
         Result[_PagerankStatistics] Compute(_PropertyGraph* pg, string output_property_name)
 
+    cppclass _PersonalizedPagerankPlan "katana::analytics::PersonalizedPagerankPlan" (_Plan):
+        enum Algorithm:
+            kForwardPush "katana::analytics::PersonalizedPagerankPlan::kForwardPush"
+            kMonteCarlo "katana::analytics::PersonalizedPagerankPlan::kMonteCarlo"
+
+        _PersonalizedPagerankPlan.Algorithm algorithm() const
+        double epsilon() const
+        uint32_t num_walks() const
+        double alpha() const
+        uint32_t top_k() const
+        uint64_t seed() const
+
+        _PersonalizedPagerankPlan()
+
+        @staticmethod
+        _PersonalizedPagerankPlan ForwardPush(double epsilon, double alpha, uint32_t top_k)
+        @staticmethod
+        _PersonalizedPagerankPlan MonteCarlo(uint32_t num_walks, double alpha, uint32_t top_k, uint64_t seed)
+
+    double kDefaultEpsilon "katana::analytics::PersonalizedPagerankPlan::kDefaultEpsilon"
+    uint32_t kDefaultNumWalks "katana::analytics::PersonalizedPagerankPlan::kDefaultNumWalks"
+    uint32_t kDefaultTopK "katana::analytics::PersonalizedPagerankPlan::kDefaultTopK"
+    uint64_t kDefaultSeed "katana::analytics::PersonalizedPagerankPlan::kDefaultSeed"
+
+    Result[void] PersonalizedPagerank(_PropertyGraph* pg, const vector[uint32_t]& seeds, string output_property_name,
+                                      CTxnContext* txn_ctx, _PersonalizedPagerankPlan plan)
+
+    Result[void] PersonalizedPagerankAssertValid(_PropertyGraph* pg, const vector[uint32_t]& seeds,
+                                                 string output_property_name, _PersonalizedPagerankPlan plan,
+                                                 double tolerance)
+
 
 class _PagerankPlanAlgorithm(Enum):
     PullTopological = _PagerankPlan.Algorithm.kPullTopological
@@ -107,6 +152,15 @@ cdef class PagerankPlan(Plan):
         f.underlying_ = u
         return f
 
+    def __init__(self, graph = None):
+        """
+        Construct a plan optimized for `graph` using heuristics, or using default parameter values.
+        """
+        if graph is None:
+            self.underlying_ = _PagerankPlan()
+        else:
+            self.underlying_ = _PagerankPlan(underlying_property_graph(graph))
+
     @property
     def algorithm(self) -> _PagerankPlanAlgorithm:
         return _PagerankPlanAlgorithm(self.underlying_.algorithm())
@@ -205,6 +259,34 @@ def pagerank(pg, str output_property_name, PagerankPlan plan = PagerankPlan(), *
         handle_result_void(Pagerank(underlying_property_graph(pg), output_property_name_cstr, underlying_txn_context(txn_ctx), plan.underlying_))
 
 
+cdef cppclass _PagerankArguments:
+    string output_property_name
+    _PagerankPlan plan
+
+
+cdef int _run_pagerank(void* arguments, _PropertyGraph* pg, CTxnContext* txn_ctx) nogil except 0:
+    cdef _PagerankArguments* args = <_PagerankArguments*>arguments
+    return handle_result_void(Pagerank(pg, args.output_property_name, txn_ctx, args.plan))
+
+
+cdef class _PagerankTask(AnalyticsTask):
+    cdef _PagerankArguments arguments_
+
+
+def pagerank_task(str output_property_name, PagerankPlan plan = PagerankPlan()) -> AnalyticsTask:
+    """
+    Create a task for :py:func:`~katana.local.analytics.run_batch` which runs :py:func:`pagerank` with these
+    arguments.
+    """
+    cdef _PagerankTask task = _PagerankTask.__new__(_PagerankTask)
+    task.arguments_.output_property_name = output_property_name.encode("utf-8")
+    task.arguments_.plan = plan.underlying_
+    task.output_property_name = output_property_name
+    task.function = _run_pagerank
+    task.arguments = &task.arguments_
+    return task
+
+
 def pagerank_assert_valid(pg, str output_property_name):
     """
     Raise an exception if the pagerank results in `pg` are invalid. This is not an exhaustive check, just a sanity check.
@@ -255,3 +337,109 @@ cdef class PagerankStatistics:
         cdef ostringstream ss
         self.underlying.Print(ss)
         return str(ss.str(), "ascii")
+
+
+class _PersonalizedPagerankPlanAlgorithm(Enum):
+    ForwardPush = _PersonalizedPagerankPlan.Algorithm.kForwardPush
+    MonteCarlo = _PersonalizedPagerankPlan.Algorithm.kMonteCarlo
+
+
+cdef class PersonalizedPagerankPlan(Plan):
+    """
+    A computational :ref:`Plan` for Personalized Page Rank from each of many seeds. Each seed is computed locally,
+    touching only the nodes near it, and seeds are computed in parallel.
+    """
+    cdef:
+        _PersonalizedPagerankPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    @staticmethod
+    cdef PersonalizedPagerankPlan make(_PersonalizedPagerankPlan u):
+        f = <PersonalizedPagerankPlan>PersonalizedPagerankPlan.__new__(PersonalizedPagerankPlan)
+        f.underlying_ = u
+        return f
+
+    Algorithm = _PersonalizedPagerankPlanAlgorithm
+
+    @property
+    def algorithm(self) -> _PersonalizedPagerankPlanAlgorithm:
+        return _PersonalizedPagerankPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def epsilon(self) -> float:
+        return self.underlying_.epsilon()
+
+    @property
+    def num_walks(self) -> int:
+        return self.underlying_.num_walks()
+
+    @property
+    def alpha(self) -> float:
+        return self.underlying_.alpha()
+
+    @property
+    def top_k(self) -> int:
+        return self.underlying_.top_k()
+
+    @property
+    def seed(self) -> int:
+        return self.underlying_.seed()
+
+    @staticmethod
+    def forward_push(double epsilon = kDefaultEpsilon, double alpha = kDefaultAlpha,
+                     uint32_t top_k = kDefaultTopK) -> PersonalizedPagerankPlan:
+        """
+        Local forward push: move the residual of a node into its rank and push it to its out-neighbors until every
+        residual is below `epsilon` times the out-degree.
+        """
+        return PersonalizedPagerankPlan.make(_PersonalizedPagerankPlan.ForwardPush(epsilon, alpha, top_k))
+
+    @staticmethod
+    def monte_carlo(uint32_t num_walks = kDefaultNumWalks, double alpha = kDefaultAlpha,
+                    uint32_t top_k = kDefaultTopK, uint64_t seed = kDefaultSeed) -> PersonalizedPagerankPlan:
+        """
+        Estimate the rank of each node as the fraction of `num_walks` random walks from the seed that end there.
+        """
+        return PersonalizedPagerankPlan.make(_PersonalizedPagerankPlan.MonteCarlo(num_walks, alpha, top_k, seed))
+
+
+def personalized_pagerank(pg, seeds, str output_property_name,
+                          PersonalizedPagerankPlan plan = PersonalizedPagerankPlan(), *, txn_ctx = None):
+    """
+    Compute the Personalized Page Rank of each node of `seeds` and keep its `top_k` highest ranked nodes. The node IDs
+    and ranks are written, in decreasing rank, to the list properties `output_property_name` + "_nodes" and
+    `output_property_name` + "_ranks". The lists of nodes that are not seeds are empty.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type seeds: list[int]
+    :param seeds: The seed nodes.
+    :type output_property_name: str
+    :param output_property_name: The prefix of the output properties. These properties must not already exist.
+    :type plan: PersonalizedPagerankPlan
+    :param plan: The execution plan to use.
+    :param txn_ctx: The transaction context for passing read write sets.
+    """
+    cdef vector[uint32_t] c_seeds = seeds
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        handle_result_void(PersonalizedPagerank(underlying_property_graph(pg), c_seeds, output_property_name_str,
+                                                underlying_txn_context(txn_ctx), plan.underlying_))
+
+
+def personalized_pagerank_assert_valid(pg, seeds, str output_property_name, PersonalizedPagerankPlan plan,
+                                       double tolerance):
+    """
+    Raise an exception if the results of :py:func:`personalized_pagerank` from `seeds` with `plan` are not within
+    `tolerance` of the exact ranks or miss nodes that rank higher.
+
+    :raises: AssertionError
+    """
+    cdef vector[uint32_t] c_seeds = seeds
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_assert(PersonalizedPagerankAssertValid(underlying_property_graph(pg), c_seeds,
+                                                             output_property_name_str, plan.underlying_, tolerance))
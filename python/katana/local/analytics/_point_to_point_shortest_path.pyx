@@ -0,0 +1,192 @@
+"""
+Point-to-Point Shortest Path
+----------------------------
+
+.. autoclass:: katana.local.analytics.PointToPointShortestPathPlan
+
+
+.. autofunction:: katana.local.analytics.shortest_path_landmarks
+
+
+.. autofunction:: katana.local.analytics.point_to_point_shortest_paths
+"""
+from libc.stdint cimport uint32_t
+from libcpp.pair cimport pair
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, raise_error_code
+
+from katana.local import TxnContext
+
+from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/point_to_point_shortest_path/point_to_point_shortest_path.h" namespace "katana::analytics" nogil:
+    cppclass _PointToPointShortestPathPlan "katana::analytics::PointToPointShortestPathPlan" (_Plan):
+        enum Algorithm:
+            kBidirectionalDijkstra "katana::analytics::PointToPointShortestPathPlan::kBidirectionalDijkstra"
+            kBidirectionalBfs "katana::analytics::PointToPointShortestPathPlan::kBidirectionalBfs"
+            kAlt "katana::analytics::PointToPointShortestPathPlan::kAlt"
+
+        _PointToPointShortestPathPlan.Algorithm algorithm() const
+        const string& landmark_property_prefix() const
+        uint32_t num_landmarks() const
+
+        # PointToPointShortestPathPlan()
+
+        @staticmethod
+        _PointToPointShortestPathPlan BidirectionalDijkstra()
+
+        @staticmethod
+        _PointToPointShortestPathPlan BidirectionalBfs()
+
+        @staticmethod
+        _PointToPointShortestPathPlan Alt(const string& landmark_property_prefix, uint32_t num_landmarks)
+
+    Result[vector[uint32_t]] ShortestPathLandmarks(_PropertyGraph* pg, const string& edge_weight_property_name,
+                                                   uint32_t num_landmarks, const string& output_property_prefix,
+                                                   CTxnContext* txn_ctx)
+
+    Result[vector[double]] PointToPointShortestPaths(_PropertyGraph* pg,
+                                                     const vector[pair[uint32_t, uint32_t]]& queries,
+                                                     const string& edge_weight_property_name,
+                                                     _PointToPointShortestPathPlan plan)
+
+
+class _PointToPointShortestPathPlanAlgorithm(Enum):
+    BidirectionalDijkstra = _PointToPointShortestPathPlan.Algorithm.kBidirectionalDijkstra
+    BidirectionalBfs = _PointToPointShortestPathPlan.Algorithm.kBidirectionalBfs
+    Alt = _PointToPointShortestPathPlan.Algorithm.kAlt
+
+
+cdef class PointToPointShortestPathPlan(Plan):
+    """
+    A computational :ref:`Plan` for shortest path queries between pairs of nodes.
+
+    Static methods construct PointToPointShortestPathPlans. The constructor will select a reasonable default plan.
+    """
+    cdef:
+        _PointToPointShortestPathPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _PointToPointShortestPathPlanAlgorithm
+
+    @staticmethod
+    cdef PointToPointShortestPathPlan make(_PointToPointShortestPathPlan u):
+        f = <PointToPointShortestPathPlan>PointToPointShortestPathPlan.__new__(PointToPointShortestPathPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> Algorithm:
+        return _PointToPointShortestPathPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def landmark_property_prefix(self) -> str:
+        return bytes(self.underlying_.landmark_property_prefix()).decode("utf-8")
+
+    @property
+    def num_landmarks(self) -> int:
+        return self.underlying_.num_landmarks()
+
+    @staticmethod
+    def bidirectional_dijkstra() -> PointToPointShortestPathPlan:
+        """
+        Dijkstra from the source along out-edges and from the target along in-edges until the two searches meet.
+        """
+        return PointToPointShortestPathPlan.make(_PointToPointShortestPathPlan.BidirectionalDijkstra())
+
+    @staticmethod
+    def bidirectional_bfs() -> PointToPointShortestPathPlan:
+        """
+        Breadth-first search from both ends, counting hops and ignoring the edge weights.
+        """
+        return PointToPointShortestPathPlan.make(_PointToPointShortestPathPlan.BidirectionalBfs())
+
+    @staticmethod
+    def alt(landmark_property_prefix, uint32_t num_landmarks) -> PointToPointShortestPathPlan:
+        """
+        Bidirectional Dijkstra guided by lower bounds from landmark distances.
+
+        :param landmark_property_prefix: The prefix of the properties stored by :py:func:`shortest_path_landmarks`,
+            computed with the same edge weights as the queries.
+        :param num_landmarks: The number of landmarks stored.
+        """
+        return PointToPointShortestPathPlan.make(
+            _PointToPointShortestPathPlan.Alt(bytes(landmark_property_prefix, "utf-8"), num_landmarks)
+        )
+
+
+cdef vector[uint32_t] handle_result_landmarks(Result[vector[uint32_t]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef vector[double] handle_result_distances(Result[vector[double]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def shortest_path_landmarks(
+    pg, str edge_weight_property_name, uint32_t num_landmarks, str output_property_prefix, *, txn_ctx=None
+):
+    """
+    Choose landmarks for :py:meth:`PointToPointShortestPathPlan.alt` and store the distances from and to each
+    landmark ``i`` as node properties named ``output_property_prefix + "_from_" + str(i)`` and
+    ``output_property_prefix + "_to_" + str(i)``. These properties must not already exist.
+
+    :param pg: The graph.
+    :param edge_weight_property_name: The non-negative edge weights, or all 1 if empty.
+    :param num_landmarks: The number of landmarks.
+    :param output_property_prefix: The prefix of the distance properties.
+    :param txn_ctx: The transaction context for passing read write sets.
+    :return: The landmarks, in order.
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_prefix_str = bytes(output_property_prefix, "utf-8")
+    cdef vector[uint32_t] landmarks
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        landmarks = handle_result_landmarks(
+            ShortestPathLandmarks(underlying_property_graph(pg), edge_weight_property_name_str, num_landmarks,
+                                  output_property_prefix_str, underlying_txn_context(txn_ctx))
+        )
+    return landmarks
+
+
+def point_to_point_shortest_paths(
+    pg, queries, str edge_weight_property_name, PointToPointShortestPathPlan plan = PointToPointShortestPathPlan()
+):
+    """
+    Compute the length of a shortest path for each (source, target) pair in ``queries``, answering the queries in
+    parallel.
+
+    :param pg: The graph.
+    :param queries: The (source, target) pairs.
+    :param edge_weight_property_name: The non-negative edge weights, or all 1 if empty.
+    :param plan: The execution plan to use.
+    :return: The shortest path length of each query, in order, or infinity where the target is unreachable.
+    """
+    cdef vector[pair[uint32_t, uint32_t]] c_queries
+    for source, target in queries:
+        c_queries.push_back(pair[uint32_t, uint32_t](source, target))
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef vector[double] distances
+    with nogil:
+        distances = handle_result_distances(
+            PointToPointShortestPaths(underlying_property_graph(pg), c_queries, edge_weight_property_name_str,
+                                      plan.underlying_)
+        )
+    return distances
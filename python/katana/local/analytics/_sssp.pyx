@@ -10,16 +10,30 @@ Single-Source Shortest Path
 
 .. autofunction:: katana.local.analytics.sssp
 
+.. autofunction:: katana.local.analytics.sssp_task
+
 .. autoclass:: katana.local.analytics.SsspStatistics
 
 
 .. autofunction:: katana.local.analytics.sssp_assert_valid
+
+
+.. autoclass:: katana.local.analytics.MultiSourceSsspPlan
+
+
+.. autofunction:: katana.local.analytics.multi_source_sssp
+
+.. autoclass:: katana.local.analytics.MultiSourceSsspStatistics
+
+
+.. autofunction:: katana.local.analytics.multi_source_sssp_assert_valid
 """
 from enum import Enum
 
 from libc.stddef cimport ptrdiff_t
-from libc.stdint cimport uint64_t
+from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 
 from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
@@ -29,6 +43,7 @@ from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_r
 from katana.local import Graph, TxnContext
 
 from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.batch cimport AnalyticsTask
 from katana.local.analytics.plan cimport Plan, Statistics, _Plan
 
 
@@ -39,6 +54,8 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
             kDeltaStep "katana::analytics::SsspPlan::kDeltaStep"
             kDeltaStepBarrier "katana::analytics::SsspPlan::kDeltaStepBarrier"
             kDeltaStepFusion "katana::analytics::SsspPlan::kDeltaStepFusion"
+            kDeltaStepAdaptive "katana::analytics::SsspPlan::kDeltaStepAdaptive"
+            kMultiQueue "katana::analytics::SsspPlan::kMultiQueue"
             kSerialDeltaTile "katana::analytics::SsspPlan::kSerialDeltaTile"
             kSerialDelta "katana::analytics::SsspPlan::kSerialDelta"
             kDijkstraTile "katana::analytics::SsspPlan::kDijkstraTile"
@@ -63,6 +80,10 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
         @staticmethod
         _SsspPlan DeltaStepFusion(unsigned delta)
         @staticmethod
+        _SsspPlan DeltaStepAdaptive(unsigned delta)
+        @staticmethod
+        _SsspPlan MultiQueue()
+        @staticmethod
         _SsspPlan SerialDeltaTile(unsigned delta, ptrdiff_t edge_tile_size)
         @staticmethod
         _SsspPlan SerialDelta(unsigned delta)
@@ -94,6 +115,35 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
         @staticmethod
         Result[_SsspStatistics] Compute(_PropertyGraph* pg, string output_property_name);
 
+    cppclass _MultiSourceSsspPlan "katana::analytics::MultiSourceSsspPlan" (_Plan):
+        enum Algorithm:
+            kBatchedDeltaStep "katana::analytics::MultiSourceSsspPlan::kBatchedDeltaStep"
+
+        _MultiSourceSsspPlan.Algorithm algorithm() const
+        unsigned delta() const
+        uint32_t batch_size() const
+
+        _MultiSourceSsspPlan()
+
+        @staticmethod
+        _MultiSourceSsspPlan BatchedDeltaStep(unsigned delta, uint32_t batch_size)
+
+    uint32_t kDefaultBatchSize "katana::analytics::MultiSourceSsspPlan::kDefaultBatchSize"
+
+    cppclass _MultiSourceSsspStatistics "katana::analytics::MultiSourceSsspStatistics":
+        vector[uint64_t] n_reached_nodes
+        vector[double] distance_sums
+        vector[double] max_distances
+
+        void Print(ostream os)
+
+    Result[_MultiSourceSsspStatistics] MultiSourceSssp(
+        _PropertyGraph* pg, const vector[uint32_t]& sources, const string& edge_weight_property_name,
+        const string& output_property_name, CTxnContext* txn_ctx, _MultiSourceSsspPlan plan)
+
+    Result[void] MultiSourceSsspAssertValid(_PropertyGraph* pg, const vector[uint32_t]& sources,
+                                            const string& property_name)
+
 
 class _SsspAlgorithm(Enum):
     """
@@ -105,6 +155,8 @@ class _SsspAlgorithm(Enum):
     DeltaStep = _SsspPlan.Algorithm.kDeltaStep
     DeltaStepBarrier = _SsspPlan.Algorithm.kDeltaStepBarrier
     DeltaStepFusion = _SsspPlan.Algorithm.kDeltaStepFusion
+    DeltaStepAdaptive = _SsspPlan.Algorithm.kDeltaStepAdaptive
+    MultiQueue = _SsspPlan.Algorithm.kMultiQueue
     SerialDeltaTile = _SsspPlan.Algorithm.kSerialDeltaTile
     SerialDelta = _SsspPlan.Algorithm.kSerialDelta
     DijkstraTile = _SsspPlan.Algorithm.kDijkstraTile
@@ -198,6 +250,20 @@ cdef class SsspPlan(Plan):
         """
         return SsspPlan.make(_SsspPlan.DeltaStepFusion(delta))
 
+    @staticmethod
+    def delta_step_adaptive(unsigned delta = kDefaultDelta) -> SsspPlan:
+        """
+        Delta stepping whose bucket width starts at 2^delta and adapts to the work in each bucket
+        """
+        return SsspPlan.make(_SsspPlan.DeltaStepAdaptive(delta))
+
+    @staticmethod
+    def multi_queue() -> SsspPlan:
+        """
+        Relaxed concurrent priority queue (no delta)
+        """
+        return SsspPlan.make(_SsspPlan.MultiQueue())
+
     @staticmethod
     def serial_delta_tile(unsigned delta = kDefaultDelta, ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) -> SsspPlan:
         """
@@ -284,6 +350,40 @@ def sssp(pg, size_t start_node, str edge_weight_property_name, str output_proper
         handle_result_void(Sssp(underlying_property_graph(pg), start_node, edge_weight_property_name_str,
                                 output_property_name_str, underlying_txn_context(txn_ctx), plan.underlying_))
 
+cdef cppclass _SsspArguments:
+    size_t start_node
+    string edge_weight_property_name
+    string output_property_name
+    _SsspPlan plan
+
+
+cdef int _run_sssp(void* arguments, _PropertyGraph* pg, CTxnContext* txn_ctx) nogil except 0:
+    cdef _SsspArguments* args = <_SsspArguments*>arguments
+    return handle_result_void(
+        Sssp(pg, args.start_node, args.edge_weight_property_name, args.output_property_name, txn_ctx, args.plan))
+
+
+cdef class _SsspTask(AnalyticsTask):
+    cdef _SsspArguments arguments_
+
+
+def sssp_task(size_t start_node, str edge_weight_property_name, str output_property_name,
+              SsspPlan plan = SsspPlan()) -> AnalyticsTask:
+    """
+    Create a task for :py:func:`~katana.local.analytics.run_batch` which runs :py:func:`sssp` with these
+    arguments.
+    """
+    cdef _SsspTask task = _SsspTask.__new__(_SsspTask)
+    task.arguments_.start_node = start_node
+    task.arguments_.edge_weight_property_name = edge_weight_property_name.encode("utf-8")
+    task.arguments_.output_property_name = output_property_name.encode("utf-8")
+    task.arguments_.plan = plan.underlying_
+    task.output_property_name = output_property_name
+    task.function = _run_sssp
+    task.arguments = &task.arguments_
+    return task
+
+
 def sssp_assert_valid(pg, size_t start_node, str edge_weight_property_name, str output_property_name, txn_ctx = None):
     """
     Raise an exception if the SSSP results in `pg` with the given parameters appear to be incorrect. This is not an
@@ -351,3 +451,151 @@ cdef class SsspStatistics(Statistics):
         cdef ostringstream ss
         self.underlying.Print(ss)
         return str(ss.str(), "ascii")
+
+
+class _MultiSourceSsspAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.MultiSourceSsspPlan` constructors for algorithm documentation.
+    """
+    BatchedDeltaStep = _MultiSourceSsspPlan.Algorithm.kBatchedDeltaStep
+
+
+cdef class MultiSourceSsspPlan(Plan):
+    """
+    A computational :ref:`Plan` for Single-Source Shortest Path from many sources at once.
+    """
+    cdef:
+        _MultiSourceSsspPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    @staticmethod
+    cdef MultiSourceSsspPlan make(_MultiSourceSsspPlan u):
+        f = <MultiSourceSsspPlan>MultiSourceSsspPlan.__new__(MultiSourceSsspPlan)
+        f.underlying_ = u
+        return f
+
+    Algorithm = _MultiSourceSsspAlgorithm
+
+    @property
+    def algorithm(self) -> _MultiSourceSsspAlgorithm:
+        return _MultiSourceSsspAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def delta(self) -> int:
+        """
+        The exponent of the delta step size (2 based).
+        """
+        return self.underlying_.delta()
+
+    @property
+    def batch_size(self) -> int:
+        """
+        The number of searches run at a time.
+        """
+        return self.underlying_.batch_size()
+
+    @staticmethod
+    def batched_delta_step(unsigned delta = kDefaultDelta, uint32_t batch_size = kDefaultBatchSize):
+        """
+        Delta stepping of `batch_size` searches at a time, a multiple of 64 up to 512, which share each scan of the
+        edges of a node.
+        """
+        return MultiSourceSsspPlan.make(_MultiSourceSsspPlan.BatchedDeltaStep(delta, batch_size))
+
+
+cdef _MultiSourceSsspStatistics handle_result_MultiSourceSsspStatistics(
+        Result[_MultiSourceSsspStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MultiSourceSsspStatistics:
+    """
+    The :ref:`statistics` of the searches of a :py:func:`multi_source_sssp`, in the order of their sources.
+    """
+    cdef _MultiSourceSsspStatistics underlying
+
+    @staticmethod
+    cdef MultiSourceSsspStatistics make(_MultiSourceSsspStatistics u):
+        f = <MultiSourceSsspStatistics>MultiSourceSsspStatistics.__new__(MultiSourceSsspStatistics)
+        f.underlying = u
+        return f
+
+    @property
+    def n_reached_nodes(self):
+        """
+        For each source, the number of nodes it reaches, including itself.
+
+        :rtype: list[int]
+        """
+        return self.underlying.n_reached_nodes
+
+    @property
+    def distance_sums(self):
+        """
+        For each source, the sum of the distances of the nodes it reaches.
+
+        :rtype: list[float]
+        """
+        return self.underlying.distance_sums
+
+    @property
+    def max_distances(self):
+        """
+        For each source, the largest distance of a node it reaches.
+
+        :rtype: list[float]
+        """
+        return self.underlying.max_distances
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
+
+
+def multi_source_sssp(pg, sources, str edge_weight_property_name, str output_property_name,
+                      MultiSourceSsspPlan plan = MultiSourceSsspPlan(), *, txn_ctx = None) -> MultiSourceSsspStatistics:
+    """
+    Compute the Single-Source Shortest Path from each node of `sources`. The number of searches that reach each node
+    is written to the property `output_property_name`.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type sources: list[int]
+    :param sources: The source nodes.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The input property containing edge weights, or "" for weights of 1.
+    :type output_property_name: str
+    :param output_property_name: The output property to write reach counts into. This property must not already exist.
+    :type plan: MultiSourceSsspPlan
+    :param plan: The execution plan to use.
+    :param txn_ctx: The transaction context for passing read write sets.
+    :returns: The distances of the nodes reached by each search.
+    """
+    cdef vector[uint32_t] c_sources = sources
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    cdef _MultiSourceSsspStatistics stats
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        stats = handle_result_MultiSourceSsspStatistics(MultiSourceSssp(
+            underlying_property_graph(pg), c_sources, edge_weight_property_name_str, output_property_name_str,
+            underlying_txn_context(txn_ctx), plan.underlying_))
+    return MultiSourceSsspStatistics.make(stats)
+
+
+def multi_source_sssp_assert_valid(pg, sources, str property_name):
+    """
+    Raise an exception if the reach counts of :py:func:`multi_source_sssp` from `sources` in `pg` are incorrect.
+
+    :raises: AssertionError
+    """
+    cdef vector[uint32_t] c_sources = sources
+    cdef string property_name_str = bytes(property_name, "utf-8")
+    with nogil:
+        handle_result_assert(MultiSourceSsspAssertValid(underlying_property_graph(pg), c_sources, property_name_str))
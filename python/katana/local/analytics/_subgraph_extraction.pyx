@@ -9,13 +9,15 @@ Subgraph Extraction
 """
 from libc.stdint cimport uint32_t, uintptr_t
 from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 from pyarrow.lib cimport to_shared
 
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
 from katana.cpp.libsupport.result cimport Result, raise_error_code
 from katana.local import Graph, TxnContext
-from katana.local._graph cimport underlying_property_graph
+from katana.local._graph cimport underlying_property_graph, underlying_txn_context
 from katana.local.analytics.plan cimport Plan, _Plan
 
 from enum import Enum
@@ -34,7 +36,10 @@ cdef extern from "katana/analytics/subgraph_extraction/subgraph_extraction.h" na
         _SubGraphExtractionPlan NodeSet(
             )
 
-    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[uint32_t]& node_vec, _SubGraphExtractionPlan plan)
+    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[uint32_t]& node_vec,
+                                                          const vector[string]& node_properties_to_copy,
+                                                          const vector[string]& edge_properties_to_copy,
+                                                          CTxnContext* txn_ctx, _SubGraphExtractionPlan plan)
 
 
 class _SubGraphExtractionPlanAlgorithm(Enum):
@@ -80,12 +85,23 @@ cdef shared_ptr[_PropertyGraph] handle_result_property_graph(Result[unique_ptr[_
     return to_shared(res.value())
 
 
-def subgraph_extraction(pg, node_vec, SubGraphExtractionPlan plan = SubGraphExtractionPlan()) -> Graph:
+def subgraph_extraction(pg, node_vec, SubGraphExtractionPlan plan = SubGraphExtractionPlan(), *,
+                        node_properties=(), edge_properties=(), txn_ctx=None) -> Graph:
     """
     Given a set of node ids, this algorithm constructs a new sub-graph which contains all nodes in the set and edges
     between them.
+
+    :param node_properties: The names of the node properties to copy into the sub-graph.
+    :param edge_properties: The names of the edge properties to copy into the sub-graph.
+    :param txn_ctx: The transaction context for passing read write sets.
     """
     cdef vector[uint32_t] vec = [<uint32_t>n for n in node_vec]
+    cdef vector[string] node_props = [bytes(p, "utf-8") for p in node_properties]
+    cdef vector[string] edge_props = [bytes(p, "utf-8") for p in edge_properties]
+    txn_ctx = txn_ctx or TxnContext()
+    cdef CTxnContext* c_txn_ctx = underlying_txn_context(txn_ctx)
     with nogil:
-        v = handle_result_property_graph(SubGraphExtraction(underlying_property_graph(pg), vec, plan.underlying_))
+        v = handle_result_property_graph(
+            SubGraphExtraction(underlying_property_graph(pg), vec, node_props, edge_props, c_txn_ctx, plan.underlying_)
+        )
     return Graph._make_from_address_shared(<uintptr_t>&v)
@@ -12,6 +12,12 @@ Triangle Counting
 
 
 .. autofunction:: katana.local.analytics.triangle_count
+
+.. autofunction:: katana.local.analytics.estimate_triangle_count
+
+.. [Seshadhri] C. Seshadhri, Ali Pinar, and Tamara G. Kolda. Wedge Sampling for
+    Computing Clustering Coefficients and Triangle Counts on Large Graphs.
+    Statistical Analysis and Data Mining 7(4). 2014.
 """
 from libc.stdint cimport uint64_t
 from libcpp cimport bool
@@ -31,6 +37,8 @@ cdef extern from "katana/analytics/triangle_count/triangle_count.h" namespace "k
             kNodeIteration "katana::analytics::TriangleCountPlan::kNodeIteration"
             kEdgeIteration "katana::analytics::TriangleCountPlan::kEdgeIteration"
             kOrderedCount "katana::analytics::TriangleCountPlan::kOrderedCount"
+            kEdgeSampling "katana::analytics::TriangleCountPlan::kEdgeSampling"
+            kWedgeSampling "katana::analytics::TriangleCountPlan::kWedgeSampling"
 
         enum Relabeling:
             kRelabel "katana::analytics::TriangleCountPlan::kRelabel"
@@ -40,6 +48,9 @@ cdef extern from "katana/analytics/triangle_count/triangle_count.h" namespace "k
         _TriangleCountPlan.Algorithm algorithm() const
         _TriangleCountPlan.Relabeling relabeling() const
         bool edges_sorted() const
+        uint64_t num_samples() const
+        double confidence() const
+        uint64_t seed() const
 
         TriangleCountPlan()
 
@@ -49,18 +60,35 @@ cdef extern from "katana/analytics/triangle_count/triangle_count.h" namespace "k
         _TriangleCountPlan EdgeIteration(bool edges_sorted, _TriangleCountPlan.Relabeling relabeling)
         @staticmethod
         _TriangleCountPlan OrderedCount(bool edges_sorted, _TriangleCountPlan.Relabeling relabeling)
+        @staticmethod
+        _TriangleCountPlan EdgeSampling(uint64_t num_samples, double confidence, uint64_t seed)
+        @staticmethod
+        _TriangleCountPlan WedgeSampling(uint64_t num_samples, double confidence, uint64_t seed)
 
 
     _TriangleCountPlan.Relabeling kDefaultRelabeling "katana::analytics::TriangleCountPlan::kDefaultRelabeling"
     bool kDefaultEdgeSorted "katana::analytics::TriangleCountPlan::kDefaultEdgeSorted"
+    uint64_t kDefaultNumSamples "katana::analytics::TriangleCountPlan::kDefaultNumSamples"
+    double kDefaultConfidence "katana::analytics::TriangleCountPlan::kDefaultConfidence"
+    uint64_t kDefaultSeed "katana::analytics::TriangleCountPlan::kDefaultSeed"
+
+    cppclass _TriangleCountEstimate "katana::analytics::TriangleCountEstimate":
+        double estimate
+        double lower
+        double upper
+        uint64_t num_samples
 
     Result[uint64_t] TriangleCount(_PropertyGraph* pg, _TriangleCountPlan plan)
 
+    Result[_TriangleCountEstimate] EstimateTriangleCount(_PropertyGraph* pg, _TriangleCountPlan plan)
+
 
 class _TriangleCountPlanAlgorithm(Enum):
     NodeIteration = _TriangleCountPlan.Algorithm.kNodeIteration
     EdgeIteration = _TriangleCountPlan.Algorithm.kEdgeIteration
     OrderedCount = _TriangleCountPlan.Algorithm.kOrderedCount
+    EdgeSampling = _TriangleCountPlan.Algorithm.kEdgeSampling
+    WedgeSampling = _TriangleCountPlan.Algorithm.kWedgeSampling
 
 
 cdef _relabeling_to_python(v):
@@ -123,6 +151,33 @@ cdef class TriangleCountPlan(Plan):
         """
         return _relabeling_to_python(self.underlying_.relabeling())
 
+    @property
+    def num_samples(self) -> int:
+        """
+        The number of edges or wedges sampled by the sampling algorithms.
+
+        :rtype: int
+        """
+        return self.underlying_.num_samples()
+
+    @property
+    def confidence(self) -> float:
+        """
+        The confidence level of the interval of the sampling algorithms.
+
+        :rtype: float
+        """
+        return self.underlying_.confidence()
+
+    @property
+    def seed(self) -> int:
+        """
+        The seed of the samples of the sampling algorithms.
+
+        :rtype: int
+        """
+        return self.underlying_.seed()
+
     @staticmethod
     def node_iteration(bool edges_sorted = kDefaultEdgeSorted,
                        relabeling = _relabeling_to_python(kDefaultRelabeling)):
@@ -167,6 +222,38 @@ cdef class TriangleCountPlan(Plan):
         return TriangleCountPlan.make(_TriangleCountPlan.OrderedCount(
             edges_sorted, _relabeling_from_python(relabeling)))
 
+    @staticmethod
+    def edge_sampling(uint64_t num_samples = kDefaultNumSamples, double confidence = kDefaultConfidence,
+                      uint64_t seed = kDefaultSeed):
+        """
+        Estimate the count from the common neighbors of the endpoints of uniformly sampled edges. The graph must not
+        have self loops or parallel edges.
+
+        :type num_samples: int
+        :param num_samples: The number of edges to sample.
+        :type confidence: float
+        :param confidence: The confidence level of the interval reported by :py:func:`estimate_triangle_count`.
+        :type seed: int
+        :param seed: The seed of the samples.
+        """
+        return TriangleCountPlan.make(_TriangleCountPlan.EdgeSampling(num_samples, confidence, seed))
+
+    @staticmethod
+    def wedge_sampling(uint64_t num_samples = kDefaultNumSamples, double confidence = kDefaultConfidence,
+                       uint64_t seed = kDefaultSeed):
+        """
+        Estimate the count from the fraction of uniformly sampled wedges that are closed [Seshadhri]_. The graph must
+        not have self loops or parallel edges.
+
+        :type num_samples: int
+        :param num_samples: The number of wedges to sample.
+        :type confidence: float
+        :param confidence: The confidence level of the interval reported by :py:func:`estimate_triangle_count`.
+        :type seed: int
+        :param seed: The seed of the samples.
+        """
+        return TriangleCountPlan.make(_TriangleCountPlan.WedgeSampling(num_samples, confidence, seed))
+
     def __str__(self):
         return "TriangleCountPlan({}, {}, {})".format(self.algorithm.name, self.edges_sorted, self.relabeling)
 
@@ -204,3 +291,27 @@ def triangle_count(pg,  TriangleCountPlan plan = TriangleCountPlan()) -> int:
     with nogil:
         v = handle_result_int(TriangleCount(underlying_property_graph(pg), plan.underlying_))
     return v
+
+
+cdef _TriangleCountEstimate handle_result_estimate(Result[_TriangleCountEstimate] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def estimate_triangle_count(pg, TriangleCountPlan plan = TriangleCountPlan()):
+    """
+    Count or, with a sampling plan, estimate the triangles in `pg`.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type plan: TriangleCountPlan
+    :param plan: The execution plan to use.
+    :return: The estimate and the lower and upper ends of its confidence interval at ``plan.confidence``, which are
+        the count itself for exact plans.
+    :rtype: Tuple[float, float, float]
+    """
+    with nogil:
+        v = handle_result_estimate(EstimateTriangleCount(underlying_property_graph(pg), plan.underlying_))
+    return v.estimate, v.lower, v.upper
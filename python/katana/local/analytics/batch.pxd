@@ -0,0 +1,12 @@
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+
+
+# Runs a task, raising its error, if any, like handle_result_void
+ctypedef int (*TaskFunction)(void* arguments, _PropertyGraph* pg, CTxnContext* txn_ctx) nogil except 0
+
+
+cdef class AnalyticsTask:
+    cdef TaskFunction function
+    cdef void* arguments
+    cdef readonly str output_property_name
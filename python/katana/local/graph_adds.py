@@ -1,9 +1,10 @@
-from typing import Optional, Sequence, Union
+from typing import Callable, Optional, Sequence, Union
 
 import numpy
 
 import katana.local._graph_numba
 from katana.dataframe import DataFrame, LazyDataFrame
+from katana.local.property_view import PropertyView
 from katana.local_native import Graph, GraphBaseEdgeDestAccessor, GraphBaseEdgeSourceAccessor
 
 
@@ -33,15 +34,27 @@ def out_edges(
 
     Getting an edges source is an O(log(N)) operation to avoid storing an O(E) table of edge sources.
 
+    Edge properties that are not loaded stay unloaded: the frame reads only the rows it uses from storage (see
+    :py:meth:`~katana.local.Graph.read_edge_property_rows`), so :py:meth:`~katana.dataframe.LazyDataFrame.iter_pandas`
+    can stream a property too large to load.
+
     This operation may copy some or all of the underlying data to create the resulting dataframe. If `nodes`, is
     contiguous and compact (just a starting node and an ending node with stride 1) data will not be copied.
     """
-    property_pyarrow_columns = {
-        name: self.get_edge_property(name)
-        for name in self.loaded_edge_schema().names
-        if properties is None or name in properties
-    }
-    property_types = tuple(a.type.to_pandas_dtype() for a in property_pyarrow_columns.values())
+    loaded_names = set(self.loaded_edge_schema().names)
+    property_pyarrow_columns = {}
+    property_types = []
+    for field in self.full_edge_schema():
+        if properties is not None and field.name not in properties:
+            continue
+        if field.name in loaded_names:
+            property_pyarrow_columns[field.name] = self.get_edge_property(field.name)
+        else:
+            # Unloaded properties stay unloaded; only the rows the frame touches are read
+            property_pyarrow_columns[field.name] = StoredPropertyRows(
+                self.read_edge_property_rows, field.name, self.num_edges()
+            )
+        property_types.append(field.type.to_pandas_dtype())
     dtypes = (numpy.uint64, numpy.uint32, numpy.uint32, *property_types)
 
     if isinstance(nodes, int):
@@ -76,13 +89,89 @@ def out_edges(
             raise ValueError("Node indexes require a copy, which is not allowed.")
         output_len = sum(len(self.out_edge_ids(i)) for i in nodes)
         column_arrays = _build_edge_arrays(self, nodes, output_len)
-        columns = {k: v.to_pandas()[column_arrays["id"]] for k, v in property_pyarrow_columns.items()}
+        columns = {k: _take(v, column_arrays["id"]) for k, v in property_pyarrow_columns.items()}
         columns.update(column_arrays)
         return LazyDataFrame(columns, dtypes, offset=0, length=output_len)
 
     raise ValueError()
 
 
+class StoredPropertyRows:
+    """
+    A `LazyDataAccessor` over the rows of a property that reads them from storage as they are used, so the property
+    need not be loaded. Single rows are read a chunk of `chunk_rows` rows at a time and the last chunk is kept, so
+    nearby cells do not each go to storage.
+
+    :param read_rows: Reads rows of a property, e.g., `Graph.read_edge_property_rows`.
+    :param name: The name of the property.
+    :param length: The number of rows of the property.
+    """
+
+    chunk_rows = 1 << 16
+
+    def __init__(self, read_rows: Callable, name: str, length: int):
+        self._read_rows = read_rows
+        self._name = name
+        self._length = length
+        self._chunk_start = None
+        self._chunk = None
+
+    def __len__(self):
+        return self._length
+
+    def __getitem__(self, i):
+        if not 0 <= i < self._length:
+            raise IndexError(i)
+        start = i - i % self.chunk_rows
+        if self._chunk_start != start:
+            self._chunk = self._read_rows(self._name, start, min(start + self.chunk_rows, self._length))
+            self._chunk_start = start
+        return self._chunk[i - start].as_py()
+
+    def array(self, items: slice):
+        start, stop, step = items.indices(self._length)
+        if stop <= start:
+            return self._read_rows(self._name, 0, 0).to_pandas()
+        # Only read up to the last selected row
+        stop = start + (stop - 1 - start) // step * step + 1
+        rows = self._read_rows(self._name, start, stop).to_pandas()
+        return rows.iloc[::step].reset_index(drop=True)
+
+    def take(self, indices: numpy.ndarray):
+        """
+        :return: The rows at indices, reading only the range of rows that covers them.
+        """
+        if len(indices) == 0:
+            return self._read_rows(self._name, 0, 0).to_pandas()
+        start = int(indices.min())
+        rows = self._read_rows(self._name, start, int(indices.max()) + 1).to_pandas()
+        return rows.iloc[indices - start].reset_index(drop=True)
+
+
+def node_property_view(self: Graph, prop: str) -> PropertyView:
+    """
+    :param prop: The name of a node property of an integer or floating point type.
+    :returns: a typed view of the property, which Numba compiled operators index directly, without calls into Arrow.
+        The view shares the property buffers with the graph.
+    """
+    return PropertyView(self.get_node_property(prop))
+
+
+def edge_property_view(self: Graph, prop: str) -> PropertyView:
+    """
+    :param prop: The name of an edge property of an integer or floating point type.
+    :returns: a typed view of the property, which Numba compiled operators index directly, without calls into Arrow.
+        The view shares the property buffers with the graph.
+    """
+    return PropertyView(self.get_edge_property(prop))
+
+
+def _take(column, indices):
+    if isinstance(column, StoredPropertyRows):
+        return column.take(indices)
+    return column.to_pandas()[indices]
+
+
 def _build_edge_views(self):
     return dict(
         id=range(0, self.num_edges()), source=GraphBaseEdgeSourceAccessor(self), dest=GraphBaseEdgeDestAccessor(self),
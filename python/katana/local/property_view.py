@@ -0,0 +1,90 @@
+import numpy as np
+import pyarrow
+
+__all__ = ["PropertyView"]
+
+
+class PropertyView:
+    """
+    A typed view of a primitive property, the Python counterpart of the C++ ``katana::PODPropertyView``.
+
+    The view shares the buffers of the property: its values are a NumPy array over the Arrow data buffer and its
+    validity is the Arrow null bitmap. In Numba compiled code, indexing a view compiles to a load from the data buffer
+    with no call back into Arrow, so operators get the same access to properties as the C++ analytics.
+
+    .. code-block:: Python
+
+        dists = graph.node_property_view("dist")
+
+        @do_all_operator()
+        def relax(dists, n):
+            if dists.is_valid(n):
+                dists[n] = min(dists[n], 0)
+
+    A view can only be written if the property buffers are mutable; views of read-only buffers are typed as read-only
+    in Numba, so writes to them fail to compile. A view must not outlive the property it was made from, e.g., across a
+    call to ``remove_node_property``, since it does not keep the property loaded.
+    """
+
+    def __init__(self, array):
+        """
+        :param array: A property of the graph, as a single-chunk :py:class:`pyarrow.ChunkedArray` or an
+            :py:class:`pyarrow.Array`, of an integer or floating point type.
+        """
+        if isinstance(array, pyarrow.ChunkedArray):
+            if array.num_chunks != 1:
+                raise ValueError(f"property views need properties in one chunk, this one has {array.num_chunks}")
+            array = array.chunk(0)
+        if not (pyarrow.types.is_integer(array.type) or pyarrow.types.is_floating(array.type)):
+            raise ValueError(f"property views need integer or floating point properties, not {array.type}")
+        validity, data = array.buffers()
+        dtype = np.dtype(array.type.to_pandas_dtype())
+        if data is None:
+            self.values = np.empty(0, dtype=dtype)
+        else:
+            self.values = np.frombuffer(data, dtype=dtype, count=array.offset + len(array))[array.offset :]
+        if validity is None or array.null_count == 0:
+            self.validity = np.empty(0, dtype=np.uint8)
+            self.null_count = 0
+        else:
+            self.validity = np.frombuffer(validity, dtype=np.uint8)
+            self.null_count = array.null_count
+        self.offset = array.offset
+        self._array = array
+
+    def __len__(self):
+        return len(self.values)
+
+    def __getitem__(self, i):
+        return self.values[i]
+
+    def __setitem__(self, i, v):
+        self.values[i] = v
+
+    def is_valid(self, i) -> bool:
+        """
+        :return: True if element ``i`` is not null.
+        """
+        if self.null_count == 0:
+            return True
+        i += self.offset
+        return bool((self.validity[i >> 3] >> (i & 7)) & 1)
+
+    def is_null(self, i) -> bool:
+        """
+        :return: True if element ``i`` is null.
+        """
+        return not self.is_valid(i)
+
+    def to_pyarrow(self) -> pyarrow.Array:
+        """
+        :return: The array this view shares its buffers with.
+        """
+        return self._array
+
+    def __repr__(self):
+        return f"<PropertyView {self._array.type} of {len(self)}>"
+
+
+# Register the Numba type of views
+import katana.local._property_view_numba  # pylint: disable=wrong-import-position
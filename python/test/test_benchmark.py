@@ -0,0 +1,33 @@
+from katana.benchmark import ALGORITHMS, DATASETS, run_one, run_suite
+from katana.benchmark.suite import generate_kronecker, generate_uniform
+
+
+def test_generate():
+    for generate in (generate_kronecker, generate_uniform):
+        graph = generate(8)
+        assert graph.num_nodes() == 256
+        assert graph.num_edges() > 0
+        assert "value" in graph.loaded_edge_schema().names
+
+
+def test_runs_on():
+    assert ALGORITHMS["bfs"].runs_on(DATASETS["ldbc_003"])
+    assert not ALGORITHMS["triangle_count"].runs_on(DATASETS["ldbc_003"])
+    assert not ALGORITHMS["sssp"].runs_on(DATASETS["rmat15_cleaned_symmetric"])
+
+
+def test_run_one():
+    results = run_one("kron", "bfs", "synchronous", threads=1, repetitions=2, scale=8)
+    assert [r["repetition"] for r in results] == [0, 1]
+    for result in results:
+        assert result["num_nodes"] == 256
+        assert result["time"] >= 0
+        assert result["load_time"] > 0
+        assert result["peak_rss"] > 0
+
+
+def test_run_suite():
+    results = run_suite(datasets=["kron"], algorithms=["connected_components"], threads=[1, 2], repetitions=1, scale=8)
+    assert len(results) == 2 * len(ALGORITHMS["connected_components"].plans)
+    assert all("error" not in r for r in results)
+    assert {r["threads"] for r in results} == {1, 2}
@@ -11,46 +11,101 @@ from katana.local import Graph
 from katana.local.analytics import (
     BetweennessCentralityPlan,
     BetweennessCentralityStatistics,
+    BfsPlan,
     BfsStatistics,
+    BipartiteMatchingPlan,
+    BipartiteMatchingStatistics,
+    CdlpPlan,
+    CliqueCountPlan,
     CdlpStatistics,
+    ConnectedComponentsPlan,
     ConnectedComponentsStatistics,
+    GraphColoringPlan,
+    GraphColoringStatistics,
     IndependentSetPlan,
     IndependentSetStatistics,
     JaccardPlan,
+    JaccardSimilarityJoinPlan,
     JaccardStatistics,
+    KCorePlan,
     KCoreStatistics,
+    KShortestSimplePathsPlan,
+    KTrussPlan,
     KTrussStatistics,
     LeidenClusteringStatistics,
     LouvainClusteringStatistics,
+    MaxFlowPlan,
+    MaxFlowStatistics,
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
+    MultiSourceBfsPlan,
+    MultiSourceSsspPlan,
+    NeighborSamplingPlan,
+    PagerankPlan,
     PagerankStatistics,
+    PersonalizedPagerankPlan,
+    PointToPointShortestPathPlan,
+    SsspPlan,
     SsspStatistics,
     TriangleCountPlan,
     betweenness_centrality,
     bfs,
     bfs_assert_valid,
+    bfs_task,
+    bipartite_matching,
+    bipartite_matching_assert_valid,
     cdlp,
+    clique_count,
     connected_components,
     connected_components_assert_valid,
+    connected_components_task,
+    estimate_triangle_count,
     find_edge_sorted_by_dest,
+    graph_coloring,
+    graph_coloring_assert_valid,
+    group_by,
     independent_set,
     independent_set_assert_valid,
     jaccard,
     jaccard_assert_valid,
+    jaccard_similarity_join,
+    jaccard_similarity_join_assert_valid,
+    jaccard_task,
     k_core,
     k_core_assert_valid,
+    k_core_decomposition,
+    k_shortest_simple_paths,
     k_truss,
     k_truss_assert_valid,
+    k_truss_decomposition,
     leiden_clustering,
     leiden_clustering_assert_valid,
     local_clustering_coefficient,
     louvain_clustering,
     louvain_clustering_assert_valid,
+    max_flow,
+    max_flow_assert_valid,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
+    motif_count,
+    multi_source_bfs,
+    multi_source_bfs_assert_valid,
+    multi_source_sssp,
+    multi_source_sssp_assert_valid,
+    neighbor_sampling,
     pagerank,
     pagerank_assert_valid,
+    pagerank_task,
+    personalized_pagerank,
+    personalized_pagerank_assert_valid,
+    point_to_point_shortest_paths,
+    run_batch,
+    shortest_path_landmarks,
     sort_all_edges_by_dest,
     sort_nodes_by_degree,
     sssp,
     sssp_assert_valid,
+    sssp_task,
     subgraph_extraction,
     triangle_count,
 )
@@ -153,6 +208,137 @@ def test_sssp(graph: Graph):
     verify_sssp(graph, start_node, property_name)
 
 
+def test_multi_source_bfs(graph: Graph):
+    sources = [0, 1, 2, 100, 1000]
+
+    stats = multi_source_bfs(graph, sources, "Reach", MultiSourceBfsPlan.bit_parallel(64))
+
+    multi_source_bfs_assert_valid(graph, sources, "Reach")
+
+    with raises(AssertionError):
+        multi_source_bfs_assert_valid(graph, sources[1:], "Reach")
+
+    for i, source in enumerate(sources):
+        bfs(graph, source, f"Bfs{i}")
+        assert stats.n_reached_nodes[i] == BfsStatistics(graph, f"Bfs{i}").n_reached_nodes
+
+
+def test_multi_source_sssp(graph: Graph):
+    sources = [0, 1, 2, 100, 1000]
+    weight_name = "workFrom"
+
+    plan = MultiSourceSsspPlan.batched_delta_step(batch_size=64)
+    stats = multi_source_sssp(graph, sources, weight_name, "Reach", plan)
+
+    multi_source_sssp_assert_valid(graph, sources, "Reach")
+
+    for i, source in enumerate(sources):
+        sssp(graph, source, weight_name, f"Sssp{i}")
+        single = SsspStatistics(graph, f"Sssp{i}")
+        assert stats.n_reached_nodes[i] == single.n_reached_nodes
+        assert stats.max_distances[i] == approx(single.max_distance)
+
+
+def test_bipartite_matching(graph: Graph):
+    bipartite_matching(graph, "Person", "partner", BipartiteMatchingPlan.pothen_fan())
+    bipartite_matching_assert_valid(graph, "Person", "partner")
+    stats = BipartiteMatchingStatistics(graph, "Person", "partner")
+    print(stats)
+
+    assert stats.num_left_nodes + stats.num_right_nodes == graph.num_nodes()
+    assert 0 < stats.num_matched <= stats.num_left_nodes
+    partners = graph.get_node_property("partner").to_numpy()
+    assert (partners != np.iinfo(np.uint32).max).sum() == 2 * stats.num_matched
+
+
+def test_max_flow(graph: Graph):
+    source = 0
+    sink = graph.num_nodes() - 1
+
+    max_flow(graph, source, sink, "", "flow")
+    max_flow_assert_valid(graph, source, sink, "", "flow")
+    stats = MaxFlowStatistics(graph, source, sink, "", "flow")
+    print(stats)
+
+    max_flow(graph, source, sink, "", "other_flow", MaxFlowPlan.preflow_push(100, False))
+    max_flow_assert_valid(graph, source, sink, "", "other_flow")
+    other_stats = MaxFlowStatistics(graph, source, sink, "", "other_flow")
+
+    assert other_stats.flow_value == stats.flow_value
+    assert stats.saturated_edges >= stats.flow_value
+
+
+def test_minimum_spanning_forest(graph: Graph):
+    weight_name = "workFrom"
+
+    minimum_spanning_forest(graph, weight_name, "boruvka", MinimumSpanningForestPlan.boruvka())
+    minimum_spanning_forest_assert_valid(graph, weight_name, "boruvka")
+    boruvka_stats = MinimumSpanningForestStatistics(graph, weight_name, "boruvka")
+    print(boruvka_stats)
+
+    assert boruvka_stats.num_trees + boruvka_stats.num_edges == graph.num_nodes()
+    assert graph.get_edge_property("boruvka").to_numpy().sum() == boruvka_stats.num_edges
+
+    minimum_spanning_forest(graph, weight_name, "filter_kruskal", MinimumSpanningForestPlan.filter_kruskal(100))
+    minimum_spanning_forest_assert_valid(graph, weight_name, "filter_kruskal")
+    stats = MinimumSpanningForestStatistics(graph, weight_name, "filter_kruskal")
+
+    assert stats.num_trees == boruvka_stats.num_trees
+    assert stats.total_weight == approx(boruvka_stats.total_weight)
+
+
+def test_point_to_point_shortest_paths(graph: Graph):
+    weight_name = "workFrom"
+    sssp(graph, 0, weight_name, "sssp_distance")
+    expected = graph.get_node_property("sssp_distance").to_numpy()
+    queries = [(0, target) for target in range(0, graph.num_nodes(), 7)]
+
+    landmarks = shortest_path_landmarks(graph, weight_name, 4, "landmark")
+    assert len(set(landmarks)) == 4
+    assert graph.get_node_property("landmark_from_0")[landmarks[0]].as_py() == 0
+
+    plans = [PointToPointShortestPathPlan.bidirectional_dijkstra(), PointToPointShortestPathPlan.alt("landmark", 4)]
+    for plan in plans:
+        distances = point_to_point_shortest_paths(graph, queries, weight_name, plan)
+        reached = [d for d in distances if d != float("inf")]
+        for (_, target), distance in zip(queries, distances):
+            if distance == float("inf"):
+                assert expected[target] > max(reached)
+            else:
+                assert distance == expected[target]
+
+    hops = point_to_point_shortest_paths(graph, queries, "", PointToPointShortestPathPlan.bidirectional_bfs())
+    assert hops == point_to_point_shortest_paths(graph, queries, "")
+
+    with raises(GaloisError):
+        point_to_point_shortest_paths(graph, [(0, graph.num_nodes())], weight_name)
+
+
+def test_k_shortest_simple_paths(graph: Graph):
+    weight_name = "workFrom"
+    sssp(graph, 0, weight_name, "sssp_distance")
+    expected = graph.get_node_property("sssp_distance").to_numpy()
+    target = next(n for n in range(1, graph.num_nodes()) if 0 < expected[n] < float("inf"))
+
+    paths = k_shortest_simple_paths(graph, 0, target, 8, weight_name, KShortestSimplePathsPlan.yen())
+    lengths = paths.column("length").to_pylist()
+    node_lists = paths.column("nodes").to_pylist()
+    assert 0 < len(lengths) <= 8
+    assert lengths[0] == expected[target]
+    assert lengths == sorted(lengths)
+    assert len(set(map(tuple, node_lists))) == len(node_lists)
+    for nodes in node_lists:
+        assert nodes[0] == 0 and nodes[-1] == target
+        assert len(set(nodes)) == len(nodes)
+        for src, dst in zip(nodes, nodes[1:]):
+            assert dst in [graph.get_edge_dst(e) for e in graph.out_edge_ids(src)]
+
+    assert k_shortest_simple_paths(graph, 0, 0, 8).num_rows == 1
+
+    with raises(GaloisError):
+        k_shortest_simple_paths(graph, 0, graph.num_nodes(), 8)
+
+
 def test_jaccard(graph: Graph):
     property_name = "NewProp"
     compare_node = 0
@@ -194,6 +380,41 @@ def test_jaccard_sorted(graph: Graph):
     assert similarities[2812] == approx(0.0)
 
 
+def test_jaccard_similarity_join(graph: Graph):
+    plan = JaccardSimilarityJoinPlan.prefix_filter(0.5)
+    assert plan.threshold == 0.5
+    assert plan.top_k == 0
+
+    result = jaccard_similarity_join(graph, plan)
+
+    assert result.column_names == ["source", "destination", "similarity"]
+    assert result.num_rows > 0
+    sources = result.column("source").to_numpy()
+    destinations = result.column("destination").to_numpy()
+    assert np.all(sources < destinations)
+    assert np.all(result.column("similarity").to_numpy() >= 0.5)
+    jaccard_similarity_join_assert_valid(graph, result, plan)
+
+    with raises(AssertionError):
+        jaccard_similarity_join_assert_valid(graph, result.slice(1), plan)
+
+
+def test_jaccard_similarity_join_top_k(graph: Graph):
+    plan = JaccardSimilarityJoinPlan.top_k_similar(3, 0.2)
+    assert plan.top_k == 3
+
+    result = jaccard_similarity_join(graph, plan)
+
+    assert result.num_rows > 0
+    _, counts = np.unique(result.column("source").to_numpy(), return_counts=True)
+    assert np.all(counts <= 3)
+    jaccard_similarity_join_assert_valid(graph, result, plan)
+
+    # The rows of the join without a top_k are not the top_k rows
+    with raises(AssertionError):
+        jaccard_similarity_join_assert_valid(graph, jaccard_similarity_join(graph), plan)
+
+
 def test_pagerank(graph: Graph):
     property_name = "NewProp"
 
@@ -213,6 +434,41 @@ def test_pagerank(graph: Graph):
     assert stats.average_rank == approx(0.5215466022491455, abs=0.001)
 
 
+def test_personalized_pagerank(graph: Graph):
+    seeds = [0, 1, 100]
+
+    plan = PersonalizedPagerankPlan.forward_push(top_k=5)
+    assert plan.algorithm == PersonalizedPagerankPlan.Algorithm.ForwardPush
+    personalized_pagerank(graph, seeds, "Push", plan)
+    personalized_pagerank_assert_valid(graph, seeds, "Push", plan, 0.01)
+
+    nodes = graph.get_node_property("Push_nodes")
+    ranks = graph.get_node_property("Push_ranks")
+    assert 0 < len(nodes[0].as_py()) <= 5
+    assert len(ranks[0].as_py()) == len(nodes[0].as_py())
+    assert nodes[2].as_py() == []
+
+    with raises(AssertionError):
+        personalized_pagerank_assert_valid(graph, [0, 1], "Push", plan, 0.01)
+
+    walks = PersonalizedPagerankPlan.monte_carlo(20000, top_k=5, seed=1)
+    personalized_pagerank(graph, seeds, "Walks", walks)
+    personalized_pagerank_assert_valid(graph, seeds, "Walks", walks, 0.02)
+
+
+def test_plans_from_graph(graph: Graph):
+    bfs(graph, 0, "BfsProp", BfsPlan(graph))
+    bfs_assert_valid(graph, 0, "BfsProp")
+
+    sssp(graph, 0, "workFrom", "SsspProp", SsspPlan(graph))
+    sssp_assert_valid(graph, 0, "workFrom", "SsspProp")
+
+    pagerank(graph, "PagerankProp", PagerankPlan(graph))
+    pagerank_assert_valid(graph, "PagerankProp")
+
+    assert ConnectedComponentsPlan(graph).algorithm in ConnectedComponentsPlan.Algorithm
+
+
 def test_betweenness_centrality_outer(graph: Graph):
     property_name = "NewProp"
 
@@ -247,6 +503,42 @@ def test_betweenness_centrality_level(graph: Graph):
     assert stats.average_centrality == approx(0.000534295046236366)
 
 
+def test_betweenness_centrality_approximate(graph: Graph):
+    epsilon = 0.05
+    plan = BetweennessCentralityPlan.approximate(epsilon, 0.1, 3)
+    assert plan.algorithm == BetweennessCentralityPlan.Algorithm.Approximate
+    assert plan.epsilon == approx(epsilon)
+    assert plan.delta == approx(0.1)
+    assert plan.seed == 3
+
+    betweenness_centrality(graph, "exact", None, BetweennessCentralityPlan.level())
+    betweenness_centrality(graph, "estimate", None, plan)
+
+    exact = graph.get_node_property("exact").to_numpy()
+    estimate = graph.get_node_property("estimate").to_numpy()
+    n = graph.num_nodes()
+    assert np.abs(estimate - exact).max() <= epsilon * n * (n - 1)
+    assert BetweennessCentralityStatistics(graph, "estimate").min_centrality >= 0
+
+    # The same seed samples the same sources
+    betweenness_centrality(graph, "again", None, plan)
+    assert graph.get_node_property("again").to_numpy() == approx(estimate)
+
+    # An int caps the number of samples; a list of sources is an error
+    betweenness_centrality(graph, "capped", 4, plan)
+    with raises(GaloisError):
+        betweenness_centrality(graph, "listed", [0, 1], plan)
+
+
+def test_betweenness_centrality_asynchronous(graph: Graph):
+    betweenness_centrality(graph, "level", 16, BetweennessCentralityPlan.level())
+    betweenness_centrality(graph, "async", 16, BetweennessCentralityPlan.asynchronous())
+
+    level = graph.get_node_property("level").to_numpy()
+    asynchronous = graph.get_node_property("async").to_numpy()
+    assert asynchronous == approx(level, rel=1e-4)
+
+
 def test_triangle_count():
     graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
     original_first_edge_list = [graph.get_edge_dst(e) for e in graph.out_edge_ids(0)]
@@ -274,6 +566,41 @@ def test_triangle_count_presorted():
     assert n == 282617
 
 
+def test_triangle_count_sampling():
+    graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
+    for plan in [TriangleCountPlan.edge_sampling(), TriangleCountPlan.wedge_sampling()]:
+        estimate, lower, upper = estimate_triangle_count(graph, plan)
+        assert lower <= estimate <= upper
+        assert estimate == approx(282617, rel=0.1)
+        assert triangle_count(graph, plan) == round(estimate)
+
+    assert estimate_triangle_count(graph) == (282617, 282617, 282617)
+
+
+def test_clique_count():
+    graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
+    assert clique_count(graph, 3) == 282617
+
+    n = clique_count(graph, 4)
+    assert clique_count(graph, 4, plan=CliqueCountPlan.ordered_listing(hub_degree=8)) == n
+
+    assert clique_count(graph, 4, "output") == n
+    assert np.sum(graph.get_node_property("output").to_numpy()) == 4 * n
+
+    with raises(GaloisError):
+        clique_count(graph, CliqueCountPlan.max_clique_size + 1)
+
+
+def test_motif_count():
+    graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
+    counts = motif_count(graph)
+    assert counts.triangles == 282617
+    assert counts.four_cliques == clique_count(graph, 4)
+
+    degrees = np.array([len(graph.out_edge_ids(n)) for n in range(graph.num_nodes())], dtype=np.uint64)
+    assert counts.open_wedges + 3 * counts.triangles == np.sum(degrees * (degrees - 1) // 2)
+
+
 def test_independent_set():
     graph = Graph(get_rdg_dataset("rmat10_symmetric"))
 
@@ -290,6 +617,24 @@ def test_independent_set():
     independent_set_assert_valid(graph, "output2")
 
 
+def test_graph_coloring():
+    graph = Graph(get_rdg_dataset("rmat10_symmetric"))
+    max_degree = max(len(graph.out_edge_ids(n)) for n in range(graph.num_nodes()))
+
+    graph_coloring(graph, "output")
+    graph_coloring_assert_valid(graph, "output")
+    stats = GraphColoringStatistics(graph, "output")
+    assert 0 < stats.num_colors <= max_degree + 1
+
+    # The Jones-Plassmann coloring does not depend on the schedule
+    graph_coloring(graph, "output2", GraphColoringPlan.jones_plassmann())
+    assert graph.get_node_property("output2") == graph.get_node_property("output")
+
+    graph_coloring(graph, "output3", GraphColoringPlan.speculative())
+    graph_coloring_assert_valid(graph, "output3")
+    assert 0 < GraphColoringStatistics(graph, "output3").num_colors <= max_degree + 1
+
+
 def test_cdlp():
     graph = Graph(get_rdg_dataset("rmat10"))
     cdlp(graph, "output", 10, False)
@@ -307,6 +652,14 @@ def test_cdlp():
     assert stats.largest_community_size == 956
     assert stats.largest_community_ratio == approx(0.933594)
 
+    graph = Graph(get_rdg_dataset("rmat10_symmetric"))
+    cdlp(graph, "output", 10, True, CdlpPlan.frontier())
+    stats = CdlpStatistics(graph, "output")
+    assert stats.total_communities == 69
+    assert stats.total_non_trivial_communities == 1
+    assert stats.largest_community_size == 956
+    assert stats.largest_community_ratio == approx(0.933594)
+
 
 def test_connected_components():
     graph = Graph(get_rdg_dataset("rmat10_symmetric"))
@@ -338,6 +691,15 @@ def test_connected_components():
     assert stats.largest_component_size == stats_sym.largest_component_size
     assert stats.largest_component_ratio == stats_sym.largest_component_ratio
 
+    connected_components(graph, "output_label_prop", False, ConnectedComponentsPlan.label_prop())
+
+    stats = ConnectedComponentsStatistics(graph, "output_label_prop")
+
+    assert stats.total_components == stats_sym.total_components
+    assert stats.largest_component_size == stats_sym.largest_component_size
+
+    connected_components_assert_valid(graph, "output_label_prop")
+
 
 def test_k_core():
     graph = Graph(get_rdg_dataset("rmat10_symmetric"))
@@ -364,6 +726,21 @@ def test_k_core():
     assert stats.number_of_nodes_in_kcore == stats_sym.number_of_nodes_in_kcore
 
 
+def test_k_core_decomposition():
+    graph = Graph(get_rdg_dataset("rmat10_symmetric"))
+
+    k_core_decomposition(graph, "core_number", True)
+    core_numbers = graph.get_node_property("core_number").to_numpy()
+
+    assert (core_numbers >= 10).sum() == 438
+
+    k_core(graph, 10, "output_bucket", True, KCorePlan.bucket_decomposition())
+
+    stats = KCoreStatistics(graph, 10, "output_bucket")
+
+    assert stats.number_of_nodes_in_kcore == 438
+
+
 def test_k_truss():
     graph = Graph(get_rdg_dataset("rmat10_symmetric"))
 
@@ -376,6 +753,22 @@ def test_k_truss():
     k_truss_assert_valid(graph, 10, "output")
 
 
+def test_k_truss_decomposition():
+    graph = Graph(get_rdg_dataset("rmat10_symmetric"))
+
+    k_truss_decomposition(graph, "trussness")
+    trussness = graph.get_edge_property("trussness").to_numpy()
+    assert trussness.min() >= 2
+
+    k_truss(graph, 10, "output_bucket", KTrussPlan.bucket_decomposition())
+    stats = KTrussStatistics(graph, 10, "output_bucket")
+    assert stats.number_of_edges_left == 13339
+    k_truss_assert_valid(graph, 10, "output_bucket")
+
+    # KTrussStatistics counts each symmetric pair of edges once
+    assert (trussness >= 10).sum() == 2 * stats.number_of_edges_left
+
+
 def test_k_truss_fail():
     graph = Graph(get_rdg_dataset("rmat10_symmetric"))
 
@@ -468,6 +861,86 @@ def test_subgraph_extraction():
         assert [pg.get_edge_dst(e) for e in pg.out_edge_ids(i)] == expected_edges[i]
 
 
+def test_subgraph_extraction_properties():
+    graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
+    sort_all_edges_by_dest(graph)
+    graph.add_node_property(table({"original_id": np.arange(graph.num_nodes(), dtype=np.uint32)}))
+    graph.add_edge_property(table({"original_edge": np.arange(graph.num_edges(), dtype=np.uint64)}))
+    nodes = [120, 1, 11, 3, 1]
+
+    pg = subgraph_extraction(graph, nodes, node_properties=["original_id"], edge_properties=["original_edge"])
+
+    assert pg.num_nodes() == 4
+    assert pg.num_edges() == 6
+    assert list(pg.get_node_property("original_id").to_numpy()) == [120, 1, 11, 3]
+    original_edges = pg.get_edge_property("original_edge").to_numpy()
+    assert len(set(original_edges)) == pg.num_edges()
+
+
+def test_neighbor_sampling():
+    graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
+    graph.add_node_property(table({"original_id": np.arange(graph.num_nodes(), dtype=np.uint32)}))
+    seeds = [1, 3, 11, 120]
+
+    nodes, blocks, features = neighbor_sampling(
+        graph, seeds, [5, 3], NeighborSamplingPlan.uniform(seed=3), node_features=["original_id"]
+    )
+
+    nodes = nodes.to_numpy()
+    assert list(nodes[: len(seeds)]) == seeds
+    assert len(set(nodes)) == len(nodes)
+    assert list(features.column("original_id").to_numpy()) == list(nodes)
+    assert [block.num_dst for block in blocks] == [len(seeds), blocks[0].num_src]
+    assert blocks[-1].num_src == len(nodes)
+    for block in blocks:
+        indptr = block.indptr.to_numpy()
+        indices = block.indices.to_numpy()
+        for i in range(block.num_dst):
+            # The graph is symmetric, so in-neighbors are out-neighbors.
+            edges = graph.out_edge_ids(nodes[i])
+            neighbors = {graph.get_edge_dst(e) for e in edges}
+            sampled = nodes[indices[indptr[i] : indptr[i + 1]]]
+            assert len(sampled) == min(len(edges), 5 if block is blocks[0] else 3)
+            assert set(sampled) <= neighbors
+
+    again, _, _ = neighbor_sampling(graph, seeds, [5, 3], NeighborSamplingPlan.uniform(seed=3))
+    assert list(again.to_numpy()) == list(nodes)
+
+    with raises(GaloisError):
+        neighbor_sampling(graph, [1, 1], [5])
+
+
+def test_group_by():
+    graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
+    num_nodes = graph.num_nodes()
+    community = np.arange(num_nodes, dtype=np.uint64) % 7
+    weight = np.arange(num_nodes, dtype=np.float64)
+    graph.add_node_property(table({"community": community, "weight": weight}))
+
+    groups = group_by(
+        graph, "community", [("sum", "weight"), ("max", "weight"), ("mean", "weight")], cut_metrics=True
+    )
+
+    assert list(groups.column("community").to_numpy()) == list(range(7))
+    assert groups.column("count").to_numpy().sum() == num_nodes
+    for row, key in enumerate(range(7)):
+        members = weight[community == key]
+        assert groups.column("count")[row].as_py() == len(members)
+        assert groups.column("sum_weight")[row].as_py() == approx(members.sum())
+        assert groups.column("max_weight")[row].as_py() == members.max()
+        assert groups.column("mean_weight")[row].as_py() == approx(members.mean())
+    internal = groups.column("internal_edges").to_numpy()
+    cut = groups.column("cut_edges").to_numpy()
+    volume = groups.column("volume").to_numpy()
+    assert list(internal + cut) == list(volume)
+    assert volume.sum() == graph.num_edges()
+    conductance = groups.column("conductance").to_numpy()
+    assert list(conductance) == approx(list(cut / np.minimum(volume, volume.sum() - volume)))
+
+    with raises(GaloisError):
+        group_by(graph, "weight")
+
+
 def test_busy_wait(graph: Graph):
     set_busy_wait()
     property_name = "NewProp"
@@ -489,3 +962,33 @@ def test_busy_wait(graph: Graph):
     # Verify with numba implementation of verifier as well
     verify_bfs(graph, start_node, property_name)
     set_busy_wait(0)
+
+
+def test_run_batch(graph: Graph):
+    start_node = 0
+    tasks = [
+        bfs_task(start_node, "BfsProp"),
+        sssp_task(start_node, "workFrom", "SsspProp"),
+        connected_components_task("CcProp"),
+        pagerank_task("PagerankProp"),
+        jaccard_task(start_node, "JaccardProp"),
+    ]
+    run_batch(graph, tasks)
+
+    assert graph.loaded_node_schema().names[-5:] == ["BfsProp", "SsspProp", "CcProp", "PagerankProp", "JaccardProp"]
+    bfs_assert_valid(graph, start_node, "BfsProp")
+    sssp_assert_valid(graph, start_node, "workFrom", "SsspProp")
+    connected_components_assert_valid(graph, "CcProp")
+    pagerank_assert_valid(graph, "PagerankProp")
+    jaccard_assert_valid(graph, start_node, "JaccardProp")
+
+
+def test_run_batch_all_or_nothing(graph: Graph):
+    num_node_properties = len(graph.loaded_node_schema())
+
+    with raises(ValueError):
+        run_batch(graph, [pagerank_task("Rank"), bfs_task(0, "Rank")])
+    with raises(GaloisError):
+        run_batch(graph, [pagerank_task("Rank"), sssp_task(0, "NoSuchWeight", "Dist")])
+
+    assert len(graph.loaded_node_schema()) == num_node_properties
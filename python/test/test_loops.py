@@ -1,3 +1,5 @@
+import threading
+import time
 import weakref
 from functools import partial
 from threading import Lock
@@ -10,12 +12,14 @@ from numba import from_dtype
 from katana import (
     OrderedByIntegerMetric,
     PerSocketChunkFIFO,
+    ThreadGroup,
     do_all,
     do_all_operator,
     for_each,
     for_each_operator,
     obim_metric,
 )
+from katana.local import atomic_add
 
 simple_modes = [
     pytest.param(dict(steal=True), id="steal=True"),
@@ -275,3 +279,63 @@ def test_closure_memory_management():
     assert w() is not None
     del c
     assert w() is None
+
+
+def test_do_all_releases_gil():
+    @do_all_operator()
+    def wait_for_flag(state, i):
+        # pylint: disable=unused-argument
+        atomic_add(state, 0, 1)
+        # Bounded, so that a loop holding the GIL fails instead of hanging
+        for _ in range(1 << 30):
+            if atomic_add(state, 1, 0) != 0:
+                state[2] = 1
+                return
+
+    # started, flag, seen
+    state = np.zeros(3, dtype=np.int64)
+    worker = threading.Thread(target=do_all, args=(range(1), wait_for_flag(state)))
+    worker.start()
+    # The main thread only sees the loop start while it runs if the loop released the GIL
+    while state[0] == 0:
+        time.sleep(0.001)
+    state[1] = 1
+    worker.join()
+    assert state[2] == 1
+
+
+def test_do_all_thread_groups():
+    try:
+        groups = [ThreadGroup(1), ThreadGroup(1)]
+    except RuntimeError:
+        pytest.skip("too few threads for two thread groups")
+
+    @do_all_operator()
+    def f(out, i):
+        out[i] = i + 1
+
+    outs = [np.zeros(1000, dtype=int) for _ in groups]
+
+    def run(group, out):
+        with group:
+            do_all(range(len(out)), f(out), steal=True)
+
+    workers = [threading.Thread(target=run, args=args) for args in zip(groups, outs)]
+    for worker in workers:
+        worker.start()
+    for worker in workers:
+        worker.join()
+    for out in outs:
+        assert np.array_equal(out, np.arange(1, 1001))
+    assert [group.size for group in groups] == [1, 1]
+
+
+def test_thread_group_reentry():
+    try:
+        group = ThreadGroup(1)
+    except RuntimeError:
+        pytest.skip("too few threads for a thread group")
+    with group:
+        with pytest.raises(RuntimeError):
+            with group:
+                pass
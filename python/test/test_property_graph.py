@@ -1,3 +1,4 @@
+from concurrent.futures import CancelledError
 from tempfile import NamedTemporaryFile, TemporaryDirectory
 
 import numpy as np
@@ -6,7 +7,8 @@ import pyarrow
 import pytest
 
 from katana import do_all, do_all_operator
-from katana.local import Graph
+from katana.example_data import get_rdg_dataset
+from katana.local import Graph, property_bytes_copied
 
 
 def test_load(graph):
@@ -46,6 +48,62 @@ def test_get_edge_dst(graph):
     assert graph.get_edge_dst(1) == 8014
 
 
+def test_topology_arrays(graph):
+    arrays = graph.topology_arrays()
+    assert len(arrays["adj_indices"]) == graph.num_nodes()
+    assert len(arrays["dests"]) == graph.num_edges()
+    assert arrays["dests"][0] == graph.get_edge_dst(0)
+    assert arrays["adj_indices"][26352] - arrays["adj_indices"][26351] == graph.out_degree(26352)
+    assert len(arrays["edge_property_indices"]) == graph.num_edges()
+    assert len(arrays["node_property_indices"]) == graph.num_nodes()
+    assert not arrays["dests"].flags.writeable
+    assert np.sum(np.diff(arrays["adj_indices"], prepend=0)) == graph.num_edges()
+
+    in_arrays = graph.topology_arrays(transposed=True)
+    assert in_arrays["adj_indices"][28007] - in_arrays["adj_indices"][28006] == graph.in_degree(28007)
+    assert in_arrays["dests"][0] == graph.in_edge_src(0)
+
+    # The arrays outlive the topologies they view
+    graph.unload_topologies()
+    assert arrays["dests"][0] == 8014
+    assert len(in_arrays["dests"]) == 43072
+
+
+def test_memory_usage(graph):
+    usage = graph.memory_usage()
+    assert usage["topology"] >= graph.num_nodes() * 8 + graph.num_edges() * 4
+    assert not usage["views"]
+    assert usage["total"] >= usage["topology"] + sum(usage["node_properties"].values())
+
+    graph.topology_arrays(transposed=True)
+    assert graph.memory_usage()["views"]
+
+
+def test_edge_lookup_batch(graph):
+    srcs = np.array([0, 1, 0, 8014], dtype=np.uint32)
+    dsts = np.array([8014, 8014, 1, 0], dtype=np.uint32)
+    found = graph.has_edge_batch(srcs, dsts)
+    assert list(found) == [graph.has_edge(s, d) for s, d in zip(srcs, dsts)]
+    assert list(found[:2]) == [True, True]
+
+    indptr, edge_ids = graph.find_all_edge_ids_batch(srcs, dsts)
+    assert len(indptr) == len(srcs) + 1
+    for i, (s, d) in enumerate(zip(srcs, dsts)):
+        assert list(edge_ids[indptr[i] : indptr[i + 1]]) == list(graph.find_all_edge_ids(s, d))
+
+    likes = graph.edge_types.atomic_types["LIKES"]
+    typed = graph.has_edge_batch(srcs, dsts, likes)
+    assert list(typed) == [graph.has_edge(s, d, likes) for s, d in zip(srcs, dsts)]
+
+    edges = np.arange(0, graph.num_edges(), 1000, dtype=np.uint64)
+    assert list(graph.get_edge_src_batch(edges)) == [graph.get_edge_src(e) for e in edges]
+
+    with pytest.raises(ValueError):
+        graph.has_edge_batch(srcs, dsts[:2])
+    with pytest.raises(ValueError):
+        graph.get_edge_src_batch(np.array([graph.num_edges()], dtype=np.uint64))
+
+
 def test_edge_data_frame(graph):
     edges = graph.out_edges()
     assert len(edges.columns) == 6
@@ -111,6 +169,94 @@ def test_edge_data_frame_to_pandas(graph):
     assert edges["source"][0] == 0
 
 
+def test_edge_data_frame_unloaded_property(graph):
+    loaded = graph.get_edge_property("classYear").to_pandas()
+    graph.unload_edge_property("classYear")
+
+    rows = graph.read_edge_property_rows("classYear", 100, 200)
+    assert rows.to_pandas().equals(loaded[100:200].reset_index(drop=True))
+    assert "classYear" not in graph.loaded_edge_schema().names
+
+    edges = graph.out_edges(properties={"classYear"})
+    row = int(loaded.first_valid_index())
+    assert edges.at[row, "classYear"] == loaded[row]
+    assert edges[10:20]["classYear"].equals(loaded[10:20].reset_index(drop=True))
+    batches = list(edges.iter_pandas(batch_size=10000))
+    assert len(batches) == 5
+    assert pandas.concat(batches, ignore_index=True)["classYear"].equals(loaded)
+    assert "classYear" not in graph.loaded_edge_schema().names
+
+
+def test_export_attach_shared(graph):
+    with TemporaryDirectory() as tmpdir:
+        path = f"{tmpdir}/graph"
+        graph.export_shared(path)
+        with pytest.raises(Exception):
+            graph.export_shared(path)
+        shared = Graph.attach_shared(path)
+    assert shared.num_nodes() == graph.num_nodes()
+    assert shared.num_edges() == graph.num_edges()
+    assert np.array_equal(shared.topology_arrays()["dests"], graph.topology_arrays()["dests"])
+    assert shared.loaded_node_schema().names == graph.loaded_node_schema().names
+    assert shared.get_node_property(0).equals(graph.get_node_property(0))
+    assert shared.get_edge_property(0).equals(graph.get_edge_property(0))
+
+    # The arrays keep the topology mapped after the graph and its files are gone
+    arrays = shared.topology_arrays()
+    del shared
+    assert np.array_equal(arrays["dests"], graph.topology_arrays()["dests"])
+    assert np.array_equal(arrays["adj_indices"], graph.topology_arrays()["adj_indices"])
+
+
+def test_load_async():
+    load = Graph.load_async(get_rdg_dataset("ldbc_003"))
+    graph = load.result()
+    assert load.done()
+    assert graph.num_nodes() == 29946
+    progress = load.progress
+    assert progress["properties_total"] > 0
+    assert progress["properties_loaded"] == progress["properties_total"]
+    assert progress["bytes_loaded"] > 0
+
+
+def test_load_async_with_loops():
+    load = Graph.load_async(get_rdg_dataset("ldbc_003"))
+
+    @do_all_operator()
+    def f(out, i):
+        out[i] += 1
+
+    # The loops of this thread run while the load runs its own
+    out = np.zeros(1000, dtype=int)
+    rounds = 0
+    while rounds < 10 or not load.done():
+        do_all(range(len(out)), f(out), steal=True)
+        rounds += 1
+    assert np.array_equal(out, np.full(len(out), rounds))
+    assert load.result().num_nodes() == 29946
+
+
+def test_load_async_cancel():
+    load = Graph.load_async(get_rdg_dataset("ldbc_003"))
+    load.cancel()
+    # the load may have finished before it was cancelled
+    try:
+        graph = load.result()
+        assert graph.num_nodes() == 29946
+    except CancelledError:
+        pass
+    assert load.done()
+
+
+def test_load_properties_async(graph):
+    graph.unload_edge_property("classYear")
+    assert "classYear" not in graph.loaded_edge_schema().names
+    load = graph.load_properties_async(node_properties=[], edge_properties=["classYear"])
+    assert load.result() is graph
+    assert "classYear" in graph.loaded_edge_schema().names
+    assert load.progress["properties_loaded"] == 1
+
+
 def test_reachable_from_10(graph):
     reachable = []
     for eid in graph.out_edge_ids(10):
@@ -164,6 +310,22 @@ def test_add_node_property_dataframe(graph):
     assert graph.get_node_property("new_prop").combine_chunks() == pyarrow.array(range(graph.num_nodes()))
 
 
+def test_add_node_property_zero_copy(graph):
+    values = np.arange(graph.num_nodes(), dtype=np.int64)
+    copied = property_bytes_copied()
+    graph.add_node_property(numpy_prop=values, may_copy=False)
+    graph.add_node_property({"dict_prop": values}, may_copy=False)
+    graph.add_node_property(arrow_prop=pyarrow.array(values), may_copy=False)
+    assert property_bytes_copied() == copied
+    assert graph.get_node_property("numpy_prop").combine_chunks() == pyarrow.array(values)
+
+    with pytest.raises(ValueError):
+        graph.add_node_property(list_prop=list(range(graph.num_nodes())), may_copy=False)
+    assert "list_prop" not in graph.loaded_node_schema().names
+    graph.add_node_property(list_prop=list(range(graph.num_nodes())))
+    assert property_bytes_copied() > copied
+
+
 def test_upsert_node_property(graph):
     prop = graph.loaded_node_schema().names[0]
     t = pyarrow.table({prop: range(graph.num_nodes())})
@@ -172,6 +334,29 @@ def test_upsert_node_property(graph):
     assert graph.get_node_property(prop).combine_chunks() == pyarrow.array(range(graph.num_nodes()))
 
 
+def test_node_vector_index(graph):
+    rng = np.random.default_rng(0)
+    vectors = rng.standard_normal((graph.num_nodes(), 8), dtype=np.float32)
+    embedding = pyarrow.FixedSizeListArray.from_arrays(pyarrow.array(vectors.ravel()), 8)
+    graph.add_node_property(pyarrow.table(dict(embedding=embedding)))
+
+    index = graph.get_node_vector_index("embedding", num_lists=16)
+    assert graph.has_node_vector_index("embedding")
+    assert len(index) == graph.num_nodes()
+    assert index.dimension == 8
+    assert index.num_lists == 16
+
+    # An exact search finds each query vector itself first
+    ids, distances = index.search(vectors[:10], k=3, num_probes=index.num_lists)
+    assert ids.shape == (10, 3)
+    assert (ids[:, 0] == np.arange(10)).all()
+    assert (distances[:, 0] == 0).all()
+    assert (np.diff(distances, axis=1) >= 0).all()
+
+    graph.delete_node_vector_index("embedding")
+    assert not graph.has_node_vector_index("embedding")
+
+
 def test_get_edge_property(graph):
     prop1 = graph.get_edge_property("creationDate")
     assert not prop1[10].as_py()
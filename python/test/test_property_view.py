@@ -0,0 +1,63 @@
+import numba
+import numpy as np
+import pyarrow
+import pytest
+
+from katana.local import PropertyView
+
+
+def test_edge_property_view(graph):
+    view = graph.edge_property_view("workFrom")
+    prop = graph.get_edge_property("workFrom").to_numpy(zero_copy_only=False)
+    assert len(view) == graph.num_edges()
+
+    @numba.njit()
+    def count_valid(view):
+        n = 0
+        for i in range(len(view)):
+            if view.is_valid(i):
+                n += 1
+        return n
+
+    assert count_valid(view) == graph.num_edges() - graph.get_edge_property("workFrom").null_count
+    valid = [i for i in range(len(view)) if view.is_valid(i)]
+    assert all(view[i] == prop[i] for i in valid[:100])
+
+
+def test_property_view_nulls():
+    array = pyarrow.array([1.5, None, 2.5, None, 4.0], type=pyarrow.float64()).slice(1)
+    view = PropertyView(array)
+
+    @numba.njit()
+    def sum_valid(view):
+        total = 0.0
+        for i in range(len(view)):
+            if not view.is_null(i):
+                total += view[i]
+        return total
+
+    assert sum_valid(view) == 6.5
+    assert [view.is_valid(i) for i in range(len(view))] == [False, True, False, True]
+
+
+def test_property_view_write():
+    size = 10
+    data = pyarrow.py_buffer(bytearray(8 * size))
+    array = pyarrow.Array.from_buffers(pyarrow.int64(), size, [None, data])
+    view = PropertyView(array)
+
+    @numba.njit()
+    def fill(view):
+        for i in range(len(view)):
+            view[i] = i * i
+
+    fill(view)
+    assert array.to_pylist() == [i * i for i in range(size)]
+    assert np.array_equal(view.values, np.arange(size) ** 2)
+
+
+def test_property_view_unsupported():
+    with pytest.raises(ValueError):
+        PropertyView(pyarrow.array(["a", "b"]))
+    with pytest.raises(ValueError):
+        PropertyView(pyarrow.chunked_array([[1, 2], [3]]))
@@ -32,13 +32,13 @@
 #include <regex>
 #include <vector>
 
-#include <boost/iostreams/filter/gzip.hpp>
-#include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/mpl/if.hpp>
 
+#include "katana/CompressedInput.h"
 #include "katana/FileGraph.h"
 #include "katana/NUMAArray.h"
 #include "katana/OfflineGraph.h"
+#include "katana/SharedMemSys.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
@@ -238,20 +238,31 @@ go_edgesSorted(std::istream& input, uint64_t numNodes) {
 
 int
 main(int argc, char** argv) {
+  katana::SharedMemSys sys;
   llvm::cl::ParseCommandLineOptions(argc, argv);
   std::cout << "Data will be " << (useSmallData ? 4 : 8) << " Bytes\n";
 
-  std::ifstream infile(inputFilename, std::ios_base::in);
+  // gzip and zstd inputs are decompressed as they are read, in parallel if
+  // they are block compressed (bgzip or seekable zstd)
+  katana::DecompressingIfstream infile(inputFilename);
   if (!infile) {
-    std::cout << "Failed to open " << inputFilename << "\n";
+    std::cout << "Failed to open " << inputFilename << ": " << *infile.error()
+              << "\n";
     return 1;
   }
+  std::cout << "Input compression: "
+            << katana::InputCompressionName(infile.compression()) << "\n";
 
   if (numNodes > 0 && edgesSorted) {
     go_edgesSorted(infile, numNodes);
   } else {
     go(infile);
   }
+  if (infile.error()) {
+    std::cout << "Failed to read " << inputFilename << ": " << *infile.error()
+              << "\n";
+    return 1;
+  }
 
   return 0;
 }
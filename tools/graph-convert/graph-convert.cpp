@@ -21,12 +21,16 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <deque>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <numeric>
+#include <optional>
 #include <random>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -34,6 +38,7 @@
 #include <llvm/Support/CommandLine.h>
 
 #include "katana/CSRTopology.h"
+#include "katana/CompressedInput.h"
 #include "katana/ErrorCode.h"
 #include "katana/FileGraph.h"
 #include "katana/Galois.h"
@@ -86,6 +91,7 @@ enum ConvertMode {
   gr2totem,
   gr2neo4j,
   gr2kg,
+  edgelist2kg,
   mtx2gr,
   nodelist2gr,
   pbbs2gr,
@@ -203,6 +209,10 @@ static cll::opt<ConvertMode> convertMode(
         clEnumVal(gr2neo4j, "Convert binary gr to a vertex/edge csv for neo4j"),
         clEnumVal(
             gr2kg, "Convert binary gr to a property graph for katana graph"),
+        clEnumVal(
+            edgelist2kg,
+            "Convert edge list to a property graph for katana graph out of "
+            "core"),
         clEnumVal(mtx2gr, "Convert matrix market format to binary gr"),
         clEnumVal(nodelist2gr, "Convert node list to binary gr"),
         clEnumVal(pbbs2gr, "Convert pbbs graph to binary gr"),
@@ -228,6 +238,14 @@ static cll::opt<int> minValue(
     cll::init(1));
 static cll::opt<size_t> maxDegree(
     "maxDegree", cll::desc("maximum degree to keep"), cll::init(2 * 1024));
+static cll::opt<uint64_t> memoryBudget(
+    "memoryBudget",
+    cll::desc("memory budget in MiB for the edges that edgelist2kg sorts at "
+              "once"),
+    cll::init(1024));
+static cll::opt<std::string> tempDir(
+    "tempDir", cll::desc("directory for the temporary files of edgelist2kg"),
+    cll::init("/tmp"));
 
 struct Conversion {};
 struct HasOnlyVoidSpecialization {};
@@ -375,7 +393,7 @@ outputPermutation(const T& perm) {
 }
 
 void
-skipLine(std::ifstream& infile) {
+skipLine(std::istream& infile) {
   infile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 }
 
@@ -399,7 +417,7 @@ convertEdgelist(
 
   Writer p;
   EdgeData edgeData;
-  std::ifstream infile(infilename.c_str());
+  katana::DecompressingIfstream infile(infilename);
 
   size_t numNodes = 0;
   size_t numEdges = 0;
@@ -463,6 +481,9 @@ convertEdgelist(
     }
   }
 
+  if (infile.error()) {
+    KATANA_LOG_FATAL("failed to read {}: {}", infilename, *infile.error());
+  }
   if (skippedLine) {
     katana::gWarn(
         "ignored at least one line (line ", *skippedLine,
@@ -3044,6 +3065,229 @@ struct Gr2Kg : public Conversion {
   }
 };
 
+/**
+ * Edgelist2Kg converts an edge list (src dst per line) to a property graph
+ * without holding its edges in memory. Edges are partitioned by source range
+ * into temporary bucket files whose edges fit in the memory budget; each
+ * bucket is counting sorted by source and its destinations are streamed to
+ * a CSR file, which becomes the topology of the property graph as in gr2kg.
+ * Only the out-degrees of the nodes stay in memory during the conversion.
+ * The out-edges of each node keep their order in the edge list.
+ */
+struct Edgelist2Kg : public HasOnlyVoidSpecialization {
+  using Node = uint32_t;
+  using SrcDst = std::pair<Node, Node>;
+
+  /// Edges of a bucket are buffered in blocks of this many edges before
+  /// they are appended to its file
+  static constexpr size_t kBucketBufferEdges = 1 << 12;
+
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    auto res = Convert(infilename, outfilename);
+    for (const std::string& path : temp_files_) {
+      std::remove(path.c_str());
+    }
+    if (!res) {
+      KATANA_LOG_FATAL("failed to convert {}: {}", infilename, res.error());
+    }
+  }
+
+private:
+  /// Call fn with the source and destination of each edge in the edge list
+  template <typename Fn>
+  static katana::Result<void> ForEachEdge(
+      const std::string& infilename, bool warn, const Fn& fn) {
+    katana::DecompressingIfstream infile(infilename);
+    if (!infile) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "cannot open {}: {}", infilename,
+          *infile.error());
+    }
+    std::optional<size_t> skippedLine;
+    std::string line;
+    for (size_t lineNumber = 0; std::getline(infile, line); ++lineNumber) {
+      std::stringstream iss(line);
+      uint64_t src;
+      uint64_t dst;
+      if (!(iss >> src >> dst)) {
+        skippedLine = lineNumber;
+        continue;
+      }
+      if (src > std::numeric_limits<Node>::max() ||
+          dst > std::numeric_limits<Node>::max()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "node id on line {} does not fit in 32 bits", lineNumber);
+      }
+      fn(src, dst);
+    }
+    if (infile.error()) {
+      return katana::ErrorInfo(*infile.error());
+    }
+    if (infile.bad()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::LocalStorageError, "failed to read {}",
+          infilename);
+    }
+    if (skippedLine && warn) {
+      katana::gWarn(
+          "ignored at least one line (line ", *skippedLine,
+          ") because it did not match the expected format\n");
+    }
+    return katana::ResultSuccess();
+  }
+
+  static katana::Result<void> Write(
+      std::ofstream& out, const void* data, size_t size) {
+    out.write(static_cast<const char*>(data), size);
+    if (!out) {
+      return KATANA_ERROR(
+          katana::ErrorCode::LocalStorageError, "failed to write {} bytes",
+          size);
+    }
+    return katana::ResultSuccess();
+  }
+
+  /// Append edges to the file of a bucket
+  katana::Result<void> Flush(
+      const std::string& path, std::vector<SrcDst>* buffer) {
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    KATANA_CHECKED_CONTEXT(
+        Write(out, buffer->data(), buffer->size() * sizeof(SrcDst)),
+        "bucket {}", path);
+    buffer->clear();
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> Convert(
+      const std::string& infilename, const std::string& outfilename) {
+    // Count the out-degrees of the nodes
+    std::vector<uint64_t> out_indexes;
+    uint64_t num_edges = 0;
+    auto count = [&](uint64_t src, uint64_t dst) {
+      uint64_t num_nodes = std::max(src, dst) + 1;
+      if (out_indexes.size() < num_nodes) {
+        out_indexes.resize(num_nodes);
+      }
+      ++out_indexes[src];
+      ++num_edges;
+    };
+    KATANA_CHECKED(ForEachEdge(infilename, true, count));
+    std::partial_sum(
+        out_indexes.begin(), out_indexes.end(), out_indexes.begin());
+    uint64_t num_nodes = out_indexes.size();
+    auto edge_begin = [&](uint64_t src) -> uint64_t {
+      return src == 0 ? 0 : out_indexes[src - 1];
+    };
+
+    // Split the sources into ranges whose edges fit in the budget; while a
+    // bucket is sorted each of its edges takes a pair and a destination.
+    // Nodes with more edges than the budget get a bucket of their own.
+    uint64_t budget_edges = std::max<uint64_t>(
+        1, (memoryBudget << 20) / (sizeof(SrcDst) + sizeof(Node)));
+    std::vector<uint64_t> bucket_starts{0};
+    for (uint64_t src = 0; src < num_nodes; ++src) {
+      if (src > bucket_starts.back() &&
+          out_indexes[src] - edge_begin(bucket_starts.back()) >
+              budget_edges) {
+        bucket_starts.emplace_back(src);
+      }
+    }
+    bucket_starts.emplace_back(num_nodes);
+    size_t num_buckets = bucket_starts.size() - 1;
+    katana::gPrint(
+        "sorting ", num_edges, " edges in ", num_buckets, " buckets\n");
+
+    katana::URI temp_uri =
+        KATANA_CHECKED(katana::URI::MakeRand(tempDir + "/edgelist2kg"));
+    const std::string& prefix = temp_uri.path();
+    std::vector<std::string> bucket_paths;
+    for (size_t b = 0; b < num_buckets; ++b) {
+      bucket_paths.emplace_back(fmt::format("{}.bucket{}", prefix, b));
+      temp_files_.emplace_back(bucket_paths.back());
+    }
+
+    // Partition the edges into buckets
+    std::vector<std::vector<SrcDst>> buffers(num_buckets);
+    katana::Result<void> flushed = katana::ResultSuccess();
+    auto partition = [&](uint64_t src, uint64_t dst) {
+      size_t b = std::upper_bound(
+                     bucket_starts.begin(), bucket_starts.end() - 1, src) -
+                 bucket_starts.begin() - 1;
+      buffers[b].emplace_back(src, dst);
+      if (buffers[b].size() == kBucketBufferEdges && flushed) {
+        flushed = Flush(bucket_paths[b], &buffers[b]);
+      }
+    };
+    KATANA_CHECKED(ForEachEdge(infilename, false, partition));
+    KATANA_CHECKED(flushed);
+    for (size_t b = 0; b < num_buckets; ++b) {
+      KATANA_CHECKED(Flush(bucket_paths[b], &buffers[b]));
+    }
+    buffers.clear();
+
+    // Stream the CSR: the header, the out indexes and then the destinations
+    // of each bucket in order of source
+    std::string csr_path = prefix + ".gr";
+    temp_files_.emplace_back(csr_path);
+    std::ofstream csr(csr_path, std::ios::binary);
+    katana::CSRTopologyHeader header;
+    header.version = 1;
+    header.num_nodes = num_nodes;
+    header.num_edges = num_edges;
+    KATANA_CHECKED(Write(csr, &header, sizeof(header)));
+    KATANA_CHECKED(Write(
+        csr, out_indexes.data(), out_indexes.size() * sizeof(uint64_t)));
+
+    std::vector<SrcDst> edges;
+    std::vector<Node> dests;
+    std::vector<uint64_t> next;
+    for (size_t b = 0; b < num_buckets; ++b) {
+      uint64_t first = bucket_starts[b];
+      uint64_t last = bucket_starts[b + 1];
+      uint64_t bucket_begin = edge_begin(first);
+      uint64_t bucket_edges = edge_begin(last) - bucket_begin;
+
+      edges.resize(bucket_edges);
+      std::ifstream in(bucket_paths[b], std::ios::binary);
+      in.read(
+          reinterpret_cast<char*>(edges.data()),
+          bucket_edges * sizeof(SrcDst));
+      if (static_cast<uint64_t>(in.gcount()) !=
+          bucket_edges * sizeof(SrcDst)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::LocalStorageError, "failed to read bucket {}",
+            bucket_paths[b]);
+      }
+      in.close();
+      std::remove(bucket_paths[b].c_str());
+
+      next.resize(last - first);
+      for (uint64_t src = first; src < last; ++src) {
+        next[src - first] = edge_begin(src) - bucket_begin;
+      }
+      dests.resize(bucket_edges);
+      for (const SrcDst& edge : edges) {
+        dests[next[edge.first - first]++] = edge.second;
+      }
+      KATANA_CHECKED(Write(csr, dests.data(), dests.size() * sizeof(Node)));
+    }
+    uint64_t dests_size = num_edges * sizeof(Node);
+    uint64_t padding = katana::AlignUp<uint64_t>(dests_size) - dests_size;
+    uint64_t zero = 0;
+    KATANA_CHECKED(Write(csr, &zero, padding));
+    csr.close();
+
+    KATANA_CHECKED(Gr2Kg().OutOfCoreConvert(csr_path, outfilename));
+    printStatus(num_nodes, num_edges);
+    return katana::ResultSuccess();
+  }
+
+  std::vector<std::string> temp_files_;
+};
+
+
 /**
  * METIS format (1-indexed). See METIS 4.10 manual, section 4.5.
  *  % comment prefix
@@ -3425,6 +3669,9 @@ main(int argc, char** argv) {
   case gr2kg:
     convert<Gr2Kg>();
     break;
+  case edgelist2kg:
+    convert<Edgelist2Kg>();
+    break;
   case mtx2gr:
     convert<Mtx2Gr>();
     break;
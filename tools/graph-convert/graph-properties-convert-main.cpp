@@ -59,6 +59,11 @@ cll::opt<int> chunk_size(
               "it can be decreased to improve memory usage when "
               "converting large inputs"),
     cll::init(25000));
+cll::opt<int> batch_size(
+    "batch-size",
+    cll::desc("Number of rows or documents that each parallel read of a "
+              "MySQL table or MongoDB collection fetches"),
+    cll::init(100000));
 cll::opt<std::string> mapping(
     "mapping",
     cll::desc("File in graphml format with a schema mapping for the database"),
@@ -194,8 +199,8 @@ ParseMongoDB([[maybe_unused]] katana::TxnContext* txn_ctx) {
     katana::GenerateMappingMongoDB(input_uri, output_uri);
   } else {
     if (auto r = katana::WritePropertyGraph(
-            katana::ConvertMongoDB(input_uri, mapping, chunk_size), output_uri,
-            txn_ctx);
+            katana::ConvertMongoDB(input_uri, mapping, chunk_size, batch_size),
+            output_uri, txn_ctx);
         !r) {
       KATANA_LOG_FATAL("Failed to write property graph: {}", r.error());
     }
@@ -219,7 +224,7 @@ ParseMysql([[maybe_unused]] katana::TxnContext* txn_ctx) {
 
     if (auto r = katana::WritePropertyGraph(
             katana::ConvertMysql(
-                input_filename, mapping, chunk_size, host, user),
+                input_filename, mapping, chunk_size, batch_size, host, user),
             output_uri, txn_ctx);
         !r) {
       KATANA_LOG_FATAL("Failed to write property graph: {}", r.error());
@@ -251,6 +256,9 @@ main(int argc, char** argv) {
   if (chunk_size <= 0) {
     chunk_size = 25000;
   }
+  if (batch_size <= 0) {
+    batch_size = 100000;
+  }
 
   katana::TxnContext txn_ctx;
   if (export_graphml) {
@@ -8,9 +8,11 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
 #include <optional>
 #include <random>
 #include <sstream>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -50,6 +52,16 @@ struct bson_value_t_wrapper {
   bson_value_t val;
 };
 
+using BsonPtr = std::unique_ptr<bson_t, decltype(&bson_destroy)>;
+
+/// A query for part of a collection; the parts of a collection partition
+/// its documents
+struct CollectionPart {
+  std::string coll_name;
+  bool is_edge;
+  BsonPtr filter;
+};
+
 /******************************/
 /* Functions for parsing data */
 /******************************/
@@ -544,31 +556,125 @@ GetCollectionNames(mongoc_database_t* database) {
   return coll_names;
 }
 
+// mongoc_init() should be called before this function
+mongoc_client_pool_t*
+GetMongoClientPool(const char* uri_string, size_t max_clients) {
+  bson_error_t error;
+  mongoc_uri_t* uri = mongoc_uri_new_with_error(uri_string, &error);
+  if (!uri) {
+    KATANA_LOG_FATAL(
+        "Failed to parse URI: {}\n"
+        "Error message: {}\n",
+        uri_string, error.message);
+  }
+  mongoc_client_pool_t* pool = mongoc_client_pool_new(uri);
+  if (!pool) {
+    KATANA_LOG_FATAL("Could not create a client pool for URI: {}", uri_string);
+  }
+  mongoc_client_pool_set_appname(pool, "graph-properties-convert");
+  mongoc_client_pool_max_size(pool, max_clients);
+  mongoc_uri_destroy(uri);
+
+  return pool;
+}
+
 template <typename T>
 void
-QueryEntireCollection(
-    mongoc_database_t* database, const bson_t** document,
-    const std::string& coll_name, T document_op) {
+QueryCollection(
+    mongoc_database_t* database, const std::string& coll_name,
+    const bson_t* filter, const bson_t* opts, T document_op) {
   bson_error_t error;
   auto collection = mongoc_database_get_collection(database, coll_name.c_str());
-  bson_t filter;
-  bson_init(&filter);
   auto cursor =
-      mongoc_collection_find_with_opts(collection, &filter, nullptr, nullptr);
+      mongoc_collection_find_with_opts(collection, filter, opts, nullptr);
 
-  while (mongoc_cursor_next(cursor, document)) {
-    document_op();
+  const bson_t* document = nullptr;
+  while (mongoc_cursor_next(cursor, &document)) {
+    document_op(document);
   }
   if (mongoc_cursor_error(cursor, &error)) {
     KATANA_LOG_ERROR(
         "An error occurred with a mongodb cursor: {}", error.message);
   }
 
-  bson_destroy(&filter);
   mongoc_cursor_destroy(cursor);
   mongoc_collection_destroy(collection);
 }
 
+/// Split a collection into ranges of _id with about batch_size documents
+/// each, found with one $bucketAuto aggregation, so that separate cursors
+/// can read them at the same time
+std::vector<BsonPtr>
+PartitionCollection(
+    mongoc_database_t* database, const std::string& coll_name,
+    size_t batch_size) {
+  std::vector<BsonPtr> filters;
+  auto collection = mongoc_database_get_collection(database, coll_name.c_str());
+  bson_error_t error;
+  int64_t count = mongoc_collection_estimated_document_count(
+      collection, nullptr, nullptr, nullptr, &error);
+
+  // the smallest _id of each range
+  std::vector<bson_value_t> starts;
+  if (count > 0 && static_cast<uint64_t>(count) > batch_size) {
+    int32_t num_buckets = static_cast<int32_t>(std::min<uint64_t>(
+        (count + batch_size - 1) / batch_size,
+        std::numeric_limits<int32_t>::max()));
+    bson_t* pipeline = BCON_NEW(
+        "pipeline", "[", "{", "$bucketAuto", "{", "groupBy", BCON_UTF8("$_id"),
+        "buckets", BCON_INT32(num_buckets), "}", "}", "]");
+    bson_t* opts = BCON_NEW("allowDiskUse", BCON_BOOL(true));
+    auto buckets = mongoc_collection_aggregate(
+        collection, MONGOC_QUERY_NONE, pipeline, opts, nullptr);
+    bson_destroy(opts);
+    bson_destroy(pipeline);
+
+    const bson_t* bucket;
+    while (mongoc_cursor_next(buckets, &bucket)) {
+      bson_iter_t iter;
+      bson_iter_t bounds;
+      if (bson_iter_init_find(&iter, bucket, "_id") &&
+          bson_iter_recurse(&iter, &bounds) &&
+          bson_iter_find(&bounds, "min")) {
+        starts.emplace_back();
+        bson_value_copy(bson_iter_value(&bounds), &starts.back());
+      }
+    }
+    if (mongoc_cursor_error(buckets, &error)) {
+      KATANA_LOG_WARN(
+          "could not partition {}, reading it whole: {}", coll_name,
+          error.message);
+      for (auto& start : starts) {
+        bson_value_destroy(&start);
+      }
+      starts.clear();
+    }
+    mongoc_cursor_destroy(buckets);
+  }
+  mongoc_collection_destroy(collection);
+
+  if (starts.size() < 2) {
+    filters.emplace_back(bson_new(), &bson_destroy);
+  }
+  for (size_t i = 0; starts.size() >= 2 && i < starts.size(); ++i) {
+    // the first and last ranges are open so that every _id is covered
+    filters.emplace_back(bson_new(), &bson_destroy);
+    bson_t range;
+    BSON_APPEND_DOCUMENT_BEGIN(filters.back().get(), "_id", &range);
+    if (i > 0) {
+      BSON_APPEND_VALUE(&range, "$gte", &starts[i]);
+    }
+    if (i + 1 < starts.size()) {
+      BSON_APPEND_VALUE(&range, "$lt", &starts[i + 1]);
+    }
+    bson_append_document_end(filters.back().get(), &range);
+  }
+  for (auto& start : starts) {
+    bson_value_destroy(&start);
+  }
+  return filters;
+}
+
 /***************************************/
 /* Functions for MongoDB preprocessing */
 /***************************************/
@@ -1111,47 +1217,97 @@ katana::GenerateMappingMongoDB(
 
 katana::GraphComponents
 katana::ConvertMongoDB(
-    const std::string& db_name, const std::string& mapping, size_t chunk_size) {
+    const std::string& db_name, const std::string& mapping, size_t chunk_size,
+    size_t batch_size) {
   const char* uri_string = "mongodb://localhost:27017";
-  const bson_t* document = nullptr;
-
-  katana::PropertyGraphBuilder builder{chunk_size};
+  batch_size = std::max<size_t>(1, batch_size);
   katana::setActiveThreads(1000);
 
   mongoc_init();
-  MongoClient client_wrapper{GetMongoClient(uri_string)};
+  mongoc_client_pool_t* pool =
+      GetMongoClientPool(uri_string, katana::getActiveThreads());
+  mongoc_client_t* client = mongoc_client_pool_pop(pool);
   mongoc_database_t* database =
-      mongoc_client_get_database(client_wrapper.client, db_name.c_str());
+      mongoc_client_get_database(client, db_name.c_str());
   std::vector<std::string> coll_names = GetCollectionNames(database);
 
   // get input on node/edge mappings, label names, property names and
   // values
   std::vector<std::string> nodes;
   std::vector<std::string> edges;
+  std::vector<LabelRule> rules;
+  std::vector<PropertyKey> keys;
   if (!mapping.empty()) {
-    auto res =
-        katana::graphml::ProcessSchemaMapping(&builder, mapping, coll_names);
-    nodes = res.first;
-    edges = res.second;
+    std::tie(rules, keys) = katana::graphml::ProcessSchemaMapping(mapping);
+    for (const LabelRule& rule : rules) {
+      bool is_collection =
+          std::find(coll_names.begin(), coll_names.end(), rule.id) !=
+          coll_names.end();
+      if (is_collection && rule.for_node) {
+        nodes.emplace_back(rule.id);
+      } else if (is_collection && rule.for_edge) {
+        edges.emplace_back(rule.id);
+      }
+    }
   } else {
     auto res = GetUserInput(database, coll_names);
     nodes = res.first;
     edges = res.second;
   }
 
-  // add all edges first
-  for (auto coll_name : edges) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      katana::HandleEdgeDocumentMongoDB(&builder, document, coll_name);
-    });
-  }
-  // then add all nodes
-  for (auto coll_name : nodes) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      katana::HandleNodeDocumentMongoDB(&builder, document, coll_name);
-    });
-  }
+  // add all edges first, then all nodes
+  std::vector<CollectionPart> parts;
+  auto add_parts = [&](const std::vector<std::string>& colls, bool is_edge) {
+    for (const std::string& coll_name : colls) {
+      for (BsonPtr& filter :
+           PartitionCollection(database, coll_name, batch_size)) {
+        parts.emplace_back(
+            CollectionPart{coll_name, is_edge, std::move(filter)});
+      }
+    }
+  };
+  add_parts(edges, true);
+  add_parts(nodes, false);
+  mongoc_database_destroy(database);
+  mongoc_client_pool_push(pool, client);
+
+  // Each part is read by its own cursor into its own shard
+  katana::ShardedPropertyGraphBuilder builder{
+      std::max<size_t>(1, parts.size()), chunk_size};
+  BsonPtr opts{
+      BCON_NEW("batchSize", BCON_INT64(static_cast<int64_t>(batch_size))),
+      &bson_destroy};
+  katana::do_all(
+      katana::iterate(size_t{0}, parts.size()),
+      [&](size_t i) {
+        katana::PropertyGraphBuilder& shard = builder.shard(i);
+        for (const LabelRule& rule : rules) {
+          shard.AddLabelBuilder(rule);
+        }
+        for (const PropertyKey& key : keys) {
+          shard.AddBuilder(key);
+        }
+        const CollectionPart& part = parts[i];
+        mongoc_client_t* part_client = mongoc_client_pool_pop(pool);
+        mongoc_database_t* part_database =
+            mongoc_client_get_database(part_client, db_name.c_str());
+        QueryCollection(
+            part_database, part.coll_name, part.filter.get(), opts.get(),
+            [&](const bson_t* document) {
+              if (part.is_edge) {
+                katana::HandleEdgeDocumentMongoDB(
+                    &shard, document, part.coll_name);
+              } else {
+                katana::HandleNodeDocumentMongoDB(
+                    &shard, document, part.coll_name);
+              }
+            });
+        mongoc_database_destroy(part_database);
+        mongoc_client_pool_push(pool, part_client);
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("ReadMongoDB"));
 
+  mongoc_client_pool_destroy(pool);
   mongoc_cleanup();
   if (auto r = builder.Finish(); !r) {
     KATANA_LOG_FATAL("Failed to construct graph: {}", r.error());
@@ -15,9 +15,11 @@ void HandleEdgeDocumentMongoDB(
     PropertyGraphBuilder*, const bson_t* doc,
     const std::string& collection_name);
 
+/// Convert a database with parallel reads: collections are read in ranges
+/// of _id of about batch_size documents, each with its own cursor.
 GraphComponents ConvertMongoDB(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size);
+    const size_t chunk_size, const size_t batch_size);
 void GenerateMappingMongoDB(
     const std::string& db_name, const std::string& outfile);
 
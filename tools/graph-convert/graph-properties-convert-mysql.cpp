@@ -67,6 +67,8 @@ struct TableData {
   std::string name;
   bool is_node;
   int64_t primary_key_index;
+  std::string primary_key_name;
+  bool primary_key_is_integer;
   std::vector<Relationship> out_references;
   std::vector<Relationship> in_references;
   std::vector<std::string> field_names;
@@ -77,6 +79,7 @@ struct TableData {
       : name(std::move(name_)),
         is_node(true),
         primary_key_index(-1),
+        primary_key_is_integer(false),
         out_references(std::vector<Relationship>{}),
         in_references(std::vector<Relationship>{}),
         field_names(std::vector<std::string>{}),
@@ -193,6 +196,20 @@ ExtractTypeMysql(enum_field_types type) {
   }
 }
 
+bool
+IsIntegerTypeMysql(enum_field_types type) {
+  switch (type) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+    return true;
+  default:
+    return false;
+  }
+}
+
 std::string
 GenerateFetchForeignKeyQuery(const std::string& table) {
   return std::string{
@@ -220,6 +237,22 @@ GenerateFetchTableQuery(const std::string& table) {
   return std::string{"SELECT * FROM " + table + ";"};
 }
 
+std::string
+GenerateFetchKeyRangeQuery(const std::string& table, const std::string& key) {
+  return std::string{
+      "SELECT MIN(" + key + "), MAX(" + key + "), COUNT(*) FROM " + table +
+      ";"};
+}
+
+std::string
+GenerateFetchTableRangeQuery(
+    const std::string& table, const std::string& key, int64_t first,
+    int64_t last) {
+  return fmt::format(
+      "SELECT * FROM {} WHERE {} >= {} AND {} <= {};", table, key, first, key,
+      last);
+}
+
 std::vector<std::string>
 FetchTableNames(MYSQL* con) {
   std::vector<std::string> table_names;
@@ -256,11 +289,87 @@ RunQuery(MYSQL* con, const std::string& query) {
   return MysqlRes(mysql_use_result(con));
 }
 
+MYSQL*
+Connect(
+    const std::string& db_name, const std::string& host,
+    const std::string& user, const std::string& password) {
+  MYSQL* con = mysql_init(NULL);
+  if (con == nullptr) {
+    KATANA_LOG_FATAL("mysql_init() failed");
+  }
+  if (mysql_real_connect(
+          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
+          NULL, 0) == NULL) {
+    KATANA_LOG_FATAL(
+        "Could not establish mysql connection: {}", mysql_error(con));
+  }
+  return con;
+}
+
+/// A query for part of a table; the parts of a table partition its rows
+struct TablePart {
+  const TableData* table_data;
+  std::string query;
+};
+
+/// Split tables with an integer primary key into ranges of keys holding
+/// about batch_size rows each, so that separate connections can stream
+/// them at the same time. Other tables are read whole.
+std::vector<TablePart>
+PartitionTables(
+    MYSQL* con, const std::unordered_map<std::string, TableData>& table_data,
+    size_t batch_size) {
+  std::vector<TablePart> parts;
+  for (const auto& [name, data] : table_data) {
+    std::optional<std::pair<int64_t, int64_t>> key_range;
+    uint64_t num_rows = 0;
+    if (data.primary_key_is_integer) {
+      MysqlRes range = RunQuery(
+          con, GenerateFetchKeyRangeQuery(name, data.primary_key_name));
+      MYSQL_ROW row = mysql_fetch_row(range.res);
+      // empty tables have a NULL minimum
+      if (row != nullptr && row[0] != NULL && row[1] != NULL) {
+        try {
+          key_range = std::make_pair(
+              boost::lexical_cast<int64_t>(row[0]),
+              boost::lexical_cast<int64_t>(row[1]));
+          num_rows = boost::lexical_cast<uint64_t>(row[2]);
+        } catch (const boost::bad_lexical_cast&) {
+          // unsigned keys past the range of int64_t are read whole
+          key_range.reset();
+        }
+      }
+      ExhaustResultSet(&range);
+    }
+    if (!key_range || num_rows <= batch_size) {
+      parts.emplace_back(TablePart{&data, GenerateFetchTableQuery(name)});
+      continue;
+    }
+
+    uint64_t num_parts = (num_rows + batch_size - 1) / batch_size;
+    uint64_t span = static_cast<uint64_t>(key_range->second) -
+                    static_cast<uint64_t>(key_range->first);
+    uint64_t width = span / num_parts + 1;
+    for (uint64_t offset = 0; offset <= span; offset += width) {
+      uint64_t last = span - offset < width ? span : offset + width - 1;
+      parts.emplace_back(TablePart{
+          &data, GenerateFetchTableRangeQuery(
+                     name, data.primary_key_name,
+                     static_cast<int64_t>(key_range->first + offset),
+                     static_cast<int64_t>(key_range->first + last))});
+      if (last == span) {
+        break;
+      }
+    }
+  }
+  return parts;
+}
+
 void
 AddNodeTable(
     katana::PropertyGraphBuilder* builder, MYSQL* con,
-    const TableData& table_data) {
-  MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
+    const TableData& table_data, const std::string& query) {
+  MysqlRes table = RunQuery(con, query);
   MYSQL_ROW row;
 
   while ((row = mysql_fetch_row(table.res))) {
@@ -312,8 +421,8 @@ AddNodeTable(
 void
 AddEdgeTable(
     katana::PropertyGraphBuilder* builder, MYSQL* con,
-    const TableData& table_data) {
-  MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
+    const TableData& table_data, const std::string& query) {
+  MysqlRes table = RunQuery(con, query);
   MYSQL_ROW row;
 
   while ((row = mysql_fetch_row(table.res))) {
@@ -642,6 +751,9 @@ PreprocessFields(
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
       table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.primary_key_name = key.id;
+      table_iter->second.primary_key_is_integer =
+          IsIntegerTypeMysql(field->type);
     } else if (
         table_iter->second.ignore_list.find(key.id) ==
         table_iter->second.ignore_list.end()) {
@@ -675,6 +787,9 @@ PreprocessFields(
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
       table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.primary_key_name = key.id;
+      table_iter->second.primary_key_is_integer =
+          IsIntegerTypeMysql(field->type);
     } else if (
         table_iter->second.ignore_list.find(key.id) !=
         table_iter->second.ignore_list.end()) {
@@ -692,8 +807,8 @@ PreprocessFields(
 
 std::unordered_map<std::string, TableData>
 PreprocessTables(
-    MYSQL* con, katana::PropertyGraphBuilder* builder,
-    const std::vector<std::string>& table_names) {
+    MYSQL* con, const std::vector<std::string>& table_names,
+    std::vector<LabelRule>* rules, std::vector<PropertyKey>* keys) {
   std::unordered_map<std::string, TableData> table_data;
   std::map<std::string, PropertyKey> node_fields;
   std::map<std::string, PropertyKey> edge_fields;
@@ -718,22 +833,20 @@ PreprocessTables(
     ExhaustResultSet(&table_row);
   }
   for (auto [name, data] : table_data) {
-    LabelRule rule{name, data.is_node, !data.is_node, name};
-    builder->AddLabelBuilder(rule);
+    rules->emplace_back(name, data.is_node, !data.is_node, name);
   }
   for (auto iter : node_fields) {
-    builder->AddBuilder(iter.second);
+    keys->emplace_back(iter.second);
   }
   for (auto iter : edge_fields) {
-    builder->AddBuilder(iter.second);
+    keys->emplace_back(iter.second);
   }
   return table_data;
 }
 
 std::unordered_map<std::string, TableData>
 PreprocessTables(
-    MYSQL* con, katana::PropertyGraphBuilder* builder,
-    const std::vector<std::string>& table_names,
+    MYSQL* con, const std::vector<std::string>& table_names,
     const std::vector<LabelRule>& rules, const std::vector<PropertyKey>& keys) {
   std::unordered_map<std::string, TableData> table_data;
 
@@ -755,12 +868,6 @@ PreprocessTables(
     }
     ExhaustResultSet(&table_row);
   }
-  for (auto rule : rules) {
-    builder->AddLabelBuilder(rule);
-  }
-  for (auto key : keys) {
-    builder->AddBuilder(key);
-  }
   return table_data;
 }
 
@@ -859,39 +966,61 @@ GetMappingInput(
 GraphComponents
 katana::ConvertMysql(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size, const std::string& host, const std::string& user) {
-  katana::PropertyGraphBuilder builder{chunk_size};
+    const size_t chunk_size, const size_t batch_size, const std::string& host,
+    const std::string& user) {
   std::string password{getpass("MySQL Password: ")};
 
-  MYSQL* con = mysql_init(NULL);
-  if (con == nullptr) {
-    KATANA_LOG_FATAL("mysql_init() failed");
-  }
-  if (mysql_real_connect(
-          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
-          NULL, 0) == NULL) {
-    KATANA_LOG_FATAL(
-        "Could not establish mysql connection: {}", mysql_error(con));
-  }
+  MYSQL* con = Connect(db_name, host, user, password);
   std::vector<std::string> table_names = FetchTableNames(con);
   std::unordered_map<std::string, TableData> table_data;
+  std::vector<LabelRule> rules;
+  std::vector<PropertyKey> keys;
   if (!mapping.empty()) {
     auto res = katana::graphml::ProcessSchemaMapping(mapping);
-    std::vector<LabelRule> rules = res.first;
-    std::vector<PropertyKey> keys = res.second;
-    table_data = PreprocessTables(con, &builder, table_names, rules, keys);
+    rules = res.first;
+    keys = res.second;
+    table_data = PreprocessTables(con, table_names, rules, keys);
   } else {
-    table_data = PreprocessTables(con, &builder, table_names);
+    table_data = PreprocessTables(con, table_names, &rules, &keys);
   }
+  std::vector<TablePart> parts =
+      PartitionTables(con, table_data, std::max<size_t>(1, batch_size));
+  mysql_close(con);
 
-  for (auto table : table_data) {
-    if (table.second.is_node) {
-      AddNodeTable(&builder, con, table.second);
-    } else {
-      AddEdgeTable(&builder, con, table.second);
+  // Each part is streamed into its own shard over the connection of the
+  // thread reading it
+  katana::ShardedPropertyGraphBuilder builder{
+      std::max<size_t>(1, parts.size()), chunk_size};
+  std::vector<MYSQL*> connections(katana::getActiveThreads(), nullptr);
+  katana::do_all(
+      katana::iterate(size_t{0}, parts.size()),
+      [&](size_t i) {
+        MYSQL*& thread_con = connections[katana::ThreadPool::getTID()];
+        if (thread_con == nullptr) {
+          mysql_thread_init();
+          thread_con = Connect(db_name, host, user, password);
+        }
+        katana::PropertyGraphBuilder& shard = builder.shard(i);
+        for (const auto& rule : rules) {
+          shard.AddLabelBuilder(rule);
+        }
+        for (const auto& key : keys) {
+          shard.AddBuilder(key);
+        }
+        const TablePart& part = parts[i];
+        if (part.table_data->is_node) {
+          AddNodeTable(&shard, thread_con, *part.table_data, part.query);
+        } else {
+          AddEdgeTable(&shard, thread_con, *part.table_data, part.query);
+        }
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("ReadMysql"));
+  for (MYSQL* thread_con : connections) {
+    if (thread_con != nullptr) {
+      mysql_close(thread_con);
     }
   }
-  mysql_close(con);
+
   auto out_result = builder.Finish();
   if (!out_result) {
     KATANA_LOG_FATAL("Failed to construct graph: {}", out_result.error());
@@ -907,16 +1036,7 @@ katana::GenerateMappingMysql(
     const std::string& host, const std::string& user) {
   std::string password{getpass("MySQL Password: ")};
 
-  MYSQL* con = mysql_init(NULL);
-  if (con == nullptr) {
-    KATANA_LOG_FATAL("mysql_init() failed");
-  }
-  if (mysql_real_connect(
-          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
-          NULL, 0) == NULL) {
-    KATANA_LOG_FATAL(
-        "Could not establish mysql connection: {}", mysql_error(con));
-  }
+  MYSQL* con = Connect(db_name, host, user, password);
   std::vector<std::string> table_names = FetchTableNames(con);
 
   // get user input on node/edge mappings, label names, property names and
@@ -5,9 +5,13 @@
 
 namespace katana {
 
+/// Convert a database with parallel reads: tables with an integer primary
+/// key are read in ranges of about batch_size rows, each over its own
+/// connection.
 GraphComponents ConvertMysql(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size, const std::string& host, const std::string& user);
+    const size_t chunk_size, const size_t batch_size, const std::string& host,
+    const std::string& user);
 void GenerateMappingMysql(
     const std::string& db_name, const std::string& outfile,
     const std::string& host, const std::string& user);
@@ -43,6 +43,10 @@ static cll::opt<ConvertTest> test_type(
 static cll::opt<int> chunk_size(
     "chunkSize", cll::desc("Chunk size for in memory arrow representation"),
     cll::init(25000));
+static cll::opt<size_t> num_pieces(
+    "numPieces",
+    cll::desc("Number of pieces to parse GraphML files in (default: pick)"),
+    cll::init(0));
 
 namespace {
 
@@ -1272,7 +1276,9 @@ main(int argc, char** argv) {
 
   switch (fileType) {
   case katana::SourceDatabase::kNeo4j:
-    if (auto r = katana::ConvertGraphML(input_filename, chunk_size, true); !r) {
+    if (auto r = katana::ConvertGraphML(
+            input_filename, chunk_size, true, num_pieces);
+        !r) {
       KATANA_LOG_FATAL(": {}", r.error());
     } else {
       graph = std::move(r.value());
@@ -0,0 +1,233 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Timer.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/URI.h"
+#include "katana/gIO.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+/* usage: ./graph-generate -generator=rmat -scale=26 <output-rdg>
+ *
+ * generates a random graph in parallel and writes it as an RDG. The same
+ * parameters and seed generate the same graph on any number of threads, so
+ * benchmarks can be repeated on generated graphs.
+ */
+
+enum class Generator { kRmat, kKronecker, kLfr };
+
+static cll::opt<std::string> outputFilename(
+    cll::Positional, cll::desc("<output rdg>"), cll::Required);
+static cll::opt<Generator> generator(
+    "generator", cll::desc("Random graph model:"),
+    cll::values(
+        clEnumValN(
+            Generator::kRmat, "rmat", "R-MAT with 2^scale nodes (Graph500)"),
+        clEnumValN(
+            Generator::kKronecker, "kronecker",
+            "Stochastic Kronecker graph of an initiator matrix"),
+        clEnumValN(
+            Generator::kLfr, "lfr",
+            "LFR benchmark with planted communities, which are written as "
+            "the node property \"community\"")),
+    cll::Required);
+static cll::opt<unsigned> numThreads(
+    "t", cll::desc("Number of threads (default: all)"), cll::init(0));
+static cll::opt<uint64_t> seed(
+    "seed", cll::desc("Seed of the random graph"), cll::init(0));
+static cll::opt<bool> symmetric(
+    "symmetric", cll::desc("Add the reverse of every edge"), cll::init(false));
+static cll::opt<bool> removeSelfLoops(
+    "removeSelfLoops", cll::desc("Drop edges from a node to itself"),
+    cll::init(false));
+static cll::opt<bool> removeMultiEdges(
+    "removeMultiEdges",
+    cll::desc("Keep one of the edges with the same endpoints"),
+    cll::init(false));
+static cll::opt<bool> noScramble(
+    "noScramble",
+    cll::desc("Do not relabel nodes with a random permutation"),
+    cll::init(false));
+
+static cll::opt<uint32_t> scale(
+    "scale", cll::desc("rmat: log2 of the number of nodes"), cll::init(16));
+static cll::opt<uint64_t> edgeFactor(
+    "edgeFactor", cll::desc("rmat: edges per node"), cll::init(16));
+static cll::opt<double> rmatA(
+    "a", cll::desc("rmat: probability of the top left quadrant"),
+    cll::init(0.57));
+static cll::opt<double> rmatB(
+    "b", cll::desc("rmat: probability of the top right quadrant"),
+    cll::init(0.19));
+static cll::opt<double> rmatC(
+    "c", cll::desc("rmat: probability of the bottom left quadrant"),
+    cll::init(0.19));
+
+static cll::list<double> initiator(
+    "initiator",
+    cll::desc("kronecker: weights of the k x k initiator, row by row"),
+    cll::CommaSeparated);
+static cll::opt<uint32_t> levels(
+    "levels", cll::desc("kronecker: Kronecker power of the initiator"),
+    cll::init(10));
+static cll::opt<uint64_t> numEdges(
+    "numEdges", cll::desc("kronecker: number of edges"), cll::init(0));
+
+static cll::opt<uint32_t> numNodes(
+    "numNodes", cll::desc("lfr: number of nodes"), cll::init(1 << 16));
+static cll::opt<double> degreeExponent(
+    "degreeExponent", cll::desc("lfr: power law exponent of degrees"),
+    cll::init(2));
+static cll::opt<uint32_t> minDegree(
+    "minDegree", cll::desc("lfr: minimum degree"), cll::init(5));
+static cll::opt<uint32_t> maxDegree(
+    "maxDegree", cll::desc("lfr: maximum degree"), cll::init(50));
+static cll::opt<double> communityExponent(
+    "communityExponent",
+    cll::desc("lfr: power law exponent of community sizes"), cll::init(1));
+static cll::opt<uint32_t> minCommunity(
+    "minCommunity", cll::desc("lfr: minimum community size"), cll::init(20));
+static cll::opt<uint32_t> maxCommunity(
+    "maxCommunity", cll::desc("lfr: maximum community size"), cll::init(100));
+static cll::opt<double> mixing(
+    "mixing",
+    cll::desc("lfr: fraction of the edges of a node leaving its community"),
+    cll::init(0.1));
+
+static cll::opt<uint32_t> numNodeProperties(
+    "numNodeProperties",
+    cll::desc("Random int64 node properties rand_0, rand_1, ..."),
+    cll::init(0));
+static cll::opt<uint32_t> numEdgeProperties(
+    "numEdgeProperties",
+    cll::desc("Random int64 edge properties rand_0, rand_1, ..."),
+    cll::init(0));
+static cll::opt<int64_t> maxPropertyValue(
+    "maxPropertyValue",
+    cll::desc("Random properties are uniform in [1, maxPropertyValue]"),
+    cll::init(100));
+
+namespace {
+
+using Node = katana::PropertyGraph::Node;
+using Edge = katana::PropertyGraph::Edge;
+
+/// The finalizer of SplitMix64, which makes the value of a property a
+/// function of the seed, the property and the id alone
+uint64_t
+Mix(uint64_t x) {
+  x += UINT64_C(0x9e3779b97f4a7c15);
+  x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+
+int64_t
+RandomValue(uint64_t property, uint64_t id) {
+  uint64_t hash = Mix(Mix(seed ^ Mix(property)) + id);
+  return 1 + static_cast<int64_t>(hash % maxPropertyValue);
+}
+
+katana::Result<katana::GraphTopology>
+GenerateTopology(katana::NUMAArray<uint32_t>* communities) {
+  katana::RandomTopologyOptions options;
+  options.seed = seed;
+  options.symmetric = symmetric;
+  options.remove_self_loops = removeSelfLoops;
+  options.remove_multi_edges = removeMultiEdges;
+  options.scramble_ids = !noScramble;
+
+  switch (generator) {
+  case Generator::kRmat:
+    return katana::CreateRmatTopology(
+        scale, edgeFactor, options, rmatA, rmatB, rmatC);
+  case Generator::kKronecker:
+    return katana::CreateKroneckerTopology(
+        std::vector<double>(initiator.begin(), initiator.end()), levels,
+        numEdges, options);
+  case Generator::kLfr: {
+    katana::LfrParameters params;
+    params.num_nodes = numNodes;
+    params.degree_exponent = degreeExponent;
+    params.min_degree = minDegree;
+    params.max_degree = maxDegree;
+    params.community_exponent = communityExponent;
+    params.min_community = minCommunity;
+    params.max_community = maxCommunity;
+    params.mixing = mixing;
+    return katana::CreateLfrTopology(params, options, communities);
+  }
+  }
+  return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "unknown generator");
+}
+
+katana::Result<void>
+Generate() {
+  if (maxPropertyValue < 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "maxPropertyValue {} is not positive", maxPropertyValue);
+  }
+  katana::URI output_uri = KATANA_CHECKED(katana::URI::Make(outputFilename));
+
+  katana::Timer timer;
+  timer.start();
+  katana::NUMAArray<uint32_t> communities;
+  katana::GraphTopology topology =
+      KATANA_CHECKED(GenerateTopology(&communities));
+  timer.stop();
+  katana::gInfo(
+      "Generated ", topology.NumNodes(), " nodes and ", topology.NumEdges(),
+      " edges in ", timer.get(), " ms");
+
+  std::unique_ptr<katana::PropertyGraph> pg =
+      KATANA_CHECKED(katana::PropertyGraph::Make(std::move(topology)));
+  katana::TxnContext txn_ctx;
+  if (generator == Generator::kLfr) {
+    KATANA_CHECKED(katana::AddNodeProperties(
+        pg.get(), &txn_ctx,
+        katana::PropertyGenerator(
+            "community", [&communities](Node n) { return communities[n]; })));
+  }
+  for (uint32_t i = 0; i < numNodeProperties; ++i) {
+    KATANA_CHECKED(katana::AddNodeProperties(
+        pg.get(), &txn_ctx,
+        katana::PropertyGenerator(
+            fmt::format("rand_{}", i),
+            [i](Node n) { return RandomValue(2 * i, n); })));
+  }
+  for (uint32_t i = 0; i < numEdgeProperties; ++i) {
+    KATANA_CHECKED(katana::AddEdgeProperties(
+        pg.get(), &txn_ctx,
+        katana::PropertyGenerator(
+            fmt::format("rand_{}", i),
+            [i](Edge e) { return RandomValue(2 * i + 1, e); })));
+  }
+
+  return pg->Write(output_uri, "graph-generate", &txn_ctx);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys G;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(
+      numThreads ? numThreads : katana::GetThreadPool().getMaxThreads());
+
+  if (auto res = Generate(); !res) {
+    KATANA_LOG_FATAL("failed to generate {}: {}", outputFilename, res.error());
+  }
+  return 0;
+}
@@ -17,9 +17,25 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <vector>
+
+#include <arrow/api.h>
+
 #include "katana/BufferedGraph.h"
+#include "katana/CSRTopology.h"
+#include "katana/ErrorCode.h"
 #include "katana/FileGraph.h"
+#include "katana/Galois.h"
+#include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
+#include "katana/TakeRows.h"
+#include "katana/URI.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
@@ -30,6 +46,22 @@ static cll::opt<std::string> mappingFilename(
     cll::Positional, cll::desc("<mapping file>"), cll::Required);
 static cll::opt<std::string> outputFilename(
     cll::Positional, cll::desc("<output file>"), cll::Required);
+static cll::opt<bool> outOfCore(
+    "outOfCore",
+    cll::desc("Relabel through temporary bucket files instead of in memory"),
+    cll::init(false));
+static cll::opt<bool> rdg(
+    "rdg",
+    cll::desc("Input and output are RDGs, whose topology is relabeled out of "
+              "core and whose properties are permuted with their nodes and "
+              "edges"),
+    cll::init(false));
+static cll::opt<uint64_t> memoryBudget(
+    "memoryBudget",
+    cll::desc("Memory budget in MiB for the edges sorted at once out of core"),
+    cll::init(1024));
+static cll::opt<std::string> tempDir(
+    "tempDir", cll::desc("Directory for temporary files"), cll::init("/tmp"));
 
 using Writer = katana::FileGraphWriter;
 
@@ -73,11 +105,384 @@ createNodeMap() {
   return remapper;
 }
 
+/**
+ * The out-of-core relabeling keeps only per-node arrays in memory; edges go
+ * through temporary bucket files.
+ */
+namespace ooc {
+
+using Node = uint32_t;
+constexpr Node kUnmapped = std::numeric_limits<Node>::max();
+
+/// An edge on its way to the remapped graph; old_edge is its property row in
+/// the input graph
+struct Record {
+  Node src;
+  Node dst;
+  uint64_t old_edge;
+};
+
+/// Edges of a bucket are buffered in blocks of this many edges before they
+/// are appended to its file
+constexpr size_t kBucketBufferEdges = 1 << 12;
+
+/// The mapping file in both directions: line n holds the old id of new node
+/// n, in any order. Nodes that are not listed are dropped and no listed node
+/// may have an edge to them.
+struct NodeMap {
+  std::vector<Node> new_to_old;
+  std::vector<Node> old_to_new;
+};
+
+katana::Result<NodeMap>
+ReadNodeMap(const std::string& filename, uint64_t num_old_nodes) {
+  std::ifstream map_file(filename);
+  if (!map_file) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "cannot open {}", filename);
+  }
+  NodeMap map;
+  map.old_to_new.assign(num_old_nodes, kUnmapped);
+  uint64_t old_id;
+  while (map_file >> old_id) {
+    if (old_id >= num_old_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "node {} on line {} is not in the graph", old_id,
+          map.new_to_old.size());
+    }
+    if (map.old_to_new[old_id] != kUnmapped) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "node {} is mapped twice",
+          old_id);
+    }
+    map.old_to_new[old_id] = map.new_to_old.size();
+    map.new_to_old.emplace_back(old_id);
+  }
+  if (!map_file.eof()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "failed to read {}", filename);
+  }
+  return map;
+}
+
+katana::Result<void>
+Write(std::ofstream& out, const void* data, size_t size) {
+  out.write(static_cast<const char*>(data), size);
+  if (!out) {
+    return KATANA_ERROR(
+        katana::ErrorCode::LocalStorageError, "failed to write {} bytes",
+        size);
+  }
+  return katana::ResultSuccess();
+}
+
+/// Removes the temporary files it names when it goes out of scope
+struct TempFiles {
+  std::vector<std::string> paths;
+  ~TempFiles() {
+    for (const std::string& path : paths) {
+      std::remove(path.c_str());
+    }
+  }
+};
+
+/// Relabel the graph whose edges for_each_out_edge(old, fn) visits, calling
+/// fn(dst, old_edge) for each out-edge of old, and stream its CSR to
+/// csr_path. Edges are scattered into buckets of new source ranges that fit
+/// the memory budget and each bucket is counting sorted, so edges keep
+/// their order within each node. If new_to_old_edges is not null it is
+/// filled with the input property row of each output edge.
+template <typename DegreeFn, typename EdgesFn>
+katana::Result<void>
+Remap(
+    const NodeMap& map, const DegreeFn& out_degree,
+    const EdgesFn& for_each_out_edge, const std::string& csr_path,
+    katana::NUMAArray<uint64_t>* new_to_old_edges) {
+  uint64_t num_nodes = map.new_to_old.size();
+  std::vector<uint64_t> out_indexes(num_nodes);
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    out_indexes[n] = out_degree(map.new_to_old[n]);
+  }
+  std::partial_sum(
+      out_indexes.begin(), out_indexes.end(), out_indexes.begin());
+  uint64_t num_edges = num_nodes == 0 ? 0 : out_indexes[num_nodes - 1];
+  auto edge_begin = [&](uint64_t src) -> uint64_t {
+    return src == 0 ? 0 : out_indexes[src - 1];
+  };
+
+  // Split the new sources into ranges whose edges fit in the budget; while
+  // a bucket is sorted each of its edges takes a record and a destination.
+  uint64_t budget_edges = std::max<uint64_t>(
+      1, (memoryBudget << 20) / (sizeof(Record) + sizeof(Node)));
+  std::vector<uint64_t> bucket_starts{0};
+  for (uint64_t src = 0; src < num_nodes; ++src) {
+    if (src > bucket_starts.back() &&
+        out_indexes[src] - edge_begin(bucket_starts.back()) > budget_edges) {
+      bucket_starts.emplace_back(src);
+    }
+  }
+  bucket_starts.emplace_back(num_nodes);
+  size_t num_buckets = bucket_starts.size() - 1;
+  katana::gInfo("Remapping ", num_edges, " edges in ", num_buckets, " buckets");
+
+  TempFiles temp_files;
+  katana::URI temp_uri =
+      KATANA_CHECKED(katana::URI::MakeRand(tempDir + "/graph-remap"));
+  for (size_t b = 0; b < num_buckets; ++b) {
+    temp_files.paths.emplace_back(
+        fmt::format("{}.bucket{}", temp_uri.path(), b));
+  }
+  auto flush = [&](size_t b,
+                   std::vector<Record>* buffer) -> katana::Result<void> {
+    std::ofstream out(temp_files.paths[b], std::ios::binary | std::ios::app);
+    KATANA_CHECKED_CONTEXT(
+        Write(out, buffer->data(), buffer->size() * sizeof(Record)),
+        "bucket {}", temp_files.paths[b]);
+    buffer->clear();
+    return katana::ResultSuccess();
+  };
+
+  // Scatter the edges of the mapped nodes, in input order, to the buckets of
+  // their new sources
+  std::vector<std::vector<Record>> buffers(num_buckets);
+  std::optional<katana::CopyableErrorInfo> error;
+  for (uint64_t src = 0; src < num_nodes && !error; ++src) {
+    size_t b = std::upper_bound(
+                   bucket_starts.begin(), bucket_starts.end() - 1, src) -
+               bucket_starts.begin() - 1;
+    for_each_out_edge(map.new_to_old[src], [&](Node dst, uint64_t old_edge) {
+      Node new_dst = map.old_to_new[dst];
+      if (new_dst == kUnmapped && !error) {
+        error = KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "node {} has an edge to unmapped node {}", map.new_to_old[src],
+            dst);
+      }
+      buffers[b].emplace_back(
+          Record{static_cast<Node>(src), new_dst, old_edge});
+      if (buffers[b].size() == kBucketBufferEdges && !error) {
+        if (auto res = flush(b, &buffers[b]); !res) {
+          error = res.error();
+        }
+      }
+    });
+  }
+  if (error) {
+    return error->WithContext("scattering edges");
+  }
+  for (size_t b = 0; b < num_buckets; ++b) {
+    KATANA_CHECKED(flush(b, &buffers[b]));
+  }
+  buffers.clear();
+
+  // Stream the CSR: the header, the out indexes and then the destinations
+  // of each bucket in order of source
+  std::ofstream csr(csr_path, std::ios::binary);
+  katana::CSRTopologyHeader header;
+  header.version = 1;
+  header.num_nodes = num_nodes;
+  header.num_edges = num_edges;
+  KATANA_CHECKED(Write(csr, &header, sizeof(header)));
+  KATANA_CHECKED(
+      Write(csr, out_indexes.data(), out_indexes.size() * sizeof(uint64_t)));
+  if (new_to_old_edges) {
+    new_to_old_edges->allocateBlocked(num_edges);
+  }
+
+  std::vector<Record> records;
+  std::vector<Node> dests;
+  std::vector<uint64_t> next;
+  for (size_t b = 0; b < num_buckets; ++b) {
+    uint64_t first = bucket_starts[b];
+    uint64_t last = bucket_starts[b + 1];
+    uint64_t bucket_begin = edge_begin(first);
+    uint64_t bucket_edges = edge_begin(last) - bucket_begin;
+
+    records.resize(bucket_edges);
+    std::ifstream in(temp_files.paths[b], std::ios::binary);
+    in.read(
+        reinterpret_cast<char*>(records.data()),
+        bucket_edges * sizeof(Record));
+    if (static_cast<uint64_t>(in.gcount()) != bucket_edges * sizeof(Record)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::LocalStorageError, "failed to read bucket {}",
+          temp_files.paths[b]);
+    }
+    in.close();
+    std::remove(temp_files.paths[b].c_str());
+
+    next.resize(last - first);
+    for (uint64_t src = first; src < last; ++src) {
+      next[src - first] = edge_begin(src) - bucket_begin;
+    }
+    dests.resize(bucket_edges);
+    for (const Record& record : records) {
+      uint64_t e = next[record.src - first]++;
+      dests[e] = record.dst;
+      if (new_to_old_edges) {
+        (*new_to_old_edges)[bucket_begin + e] = record.old_edge;
+      }
+    }
+    KATANA_CHECKED(Write(csr, dests.data(), dests.size() * sizeof(Node)));
+  }
+  uint64_t dests_size = num_edges * sizeof(Node);
+  uint64_t padding = katana::AlignUp<uint64_t>(dests_size) - dests_size;
+  uint64_t zero = 0;
+  KATANA_CHECKED(Write(csr, &zero, padding));
+  return katana::ResultSuccess();
+}
+
+/// Relabel a .gr file; the input is memory mapped and read once in order of
+/// source
+katana::Result<void>
+RemapFile() {
+  katana::FileGraph graph;
+  graph.fromFile(inputFilename);
+  if (graph.size() > std::numeric_limits<Node>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} has too many nodes",
+        inputFilename);
+  }
+  NodeMap map = KATANA_CHECKED(ReadNodeMap(mappingFilename, graph.size()));
+  katana::gInfo("Remapping ", map.new_to_old.size(), " nodes");
+
+  auto out_degree = [&](Node old) {
+    return *graph.edge_end(old) - *graph.edge_begin(old);
+  };
+  auto for_each_out_edge = [&](Node old, const auto& fn) {
+    for (auto e = graph.edge_begin(old); e != graph.edge_end(old); ++e) {
+      fn(graph.getEdgeDst(e), *e);
+    }
+  };
+  return Remap(map, out_degree, for_each_out_edge, outputFilename, nullptr);
+}
+
+/// \returns a table of one property with its rows taken in a new order
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeRows(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const std::shared_ptr<arrow::Field>& field,
+    const katana::NUMAArray<uint64_t>& rows) {
+  auto taken = KATANA_CHECKED(katana::TakeRows(column, rows));
+  return arrow::Table::Make(arrow::schema({field}), {taken});
+}
+
+/// Relabel an RDG. The topology is relabeled out of core like a .gr file and
+/// node and edge properties are permuted one property at a time, along with
+/// the entity types of nodes and edges.
+katana::Result<void>
+RemapRDG() {
+  katana::TxnContext txn_ctx;
+  katana::URI input_uri = KATANA_CHECKED(katana::URI::Make(inputFilename));
+  katana::URI output_uri = KATANA_CHECKED(katana::URI::Make(outputFilename));
+  katana::RDGLoadOptions opts;
+  opts.lazy_load_properties = true;
+  std::unique_ptr<katana::PropertyGraph> in =
+      KATANA_CHECKED(katana::PropertyGraph::Make(input_uri, &txn_ctx, opts));
+  const katana::GraphTopology& topology = in->topology();
+  if (topology.NumNodes() > std::numeric_limits<Node>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} has too many nodes",
+        inputFilename);
+  }
+  NodeMap map =
+      KATANA_CHECKED(ReadNodeMap(mappingFilename, topology.NumNodes()));
+  uint64_t num_nodes = map.new_to_old.size();
+  katana::gInfo("Remapping ", num_nodes, " nodes");
+
+  auto out_degree = [&](Node old) { return topology.OutDegree(old); };
+  auto for_each_out_edge = [&](Node old, const auto& fn) {
+    for (auto e : topology.OutEdges(old)) {
+      fn(topology.OutEdgeDst(e), in->GetEdgePropertyIndexFromOutEdge(e));
+    }
+  };
+  TempFiles temp_files;
+  katana::URI temp_uri =
+      KATANA_CHECKED(katana::URI::MakeRand(tempDir + "/graph-remap"));
+  std::string csr_path = temp_uri.path() + ".gr";
+  temp_files.paths.emplace_back(csr_path);
+  katana::NUMAArray<uint64_t> new_to_old_edges;
+  KATANA_CHECKED(Remap(
+      map, out_degree, for_each_out_edge, csr_path, &new_to_old_edges));
+  uint64_t num_edges = new_to_old_edges.size();
+
+  katana::NUMAArray<uint64_t> new_to_old_nodes;
+  new_to_old_nodes.allocateBlocked(num_nodes);
+  katana::PropertyGraph::EntityTypeIDArray node_types;
+  node_types.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        new_to_old_nodes[n] = in->GetNodePropertyIndex(map.new_to_old[n]);
+        node_types[n] = in->GetTypeOfNode(map.new_to_old[n]);
+      },
+      katana::no_stats());
+  katana::PropertyGraph::EntityTypeIDArray edge_types;
+  edge_types.allocateBlocked(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        edge_types[e] =
+            in->GetTypeOfEdgeFromPropertyIndex(new_to_old_edges[e]);
+      },
+      katana::no_stats());
+
+  // The output topology is read back from the CSR file
+  katana::NUMAArray<katana::GraphTopology::Edge> adj_indices;
+  adj_indices.allocateBlocked(num_nodes);
+  katana::NUMAArray<katana::GraphTopology::Node> dests;
+  dests.allocateBlocked(num_edges);
+  std::ifstream csr(csr_path, std::ios::binary);
+  csr.seekg(sizeof(katana::CSRTopologyHeader));
+  csr.read(
+      reinterpret_cast<char*>(adj_indices.data()),
+      num_nodes * sizeof(uint64_t));
+  csr.read(reinterpret_cast<char*>(dests.data()), num_edges * sizeof(Node));
+  if (!csr) {
+    return KATANA_ERROR(
+        katana::ErrorCode::LocalStorageError, "failed to read {}", csr_path);
+  }
+  csr.close();
+
+  std::unique_ptr<katana::PropertyGraph> out =
+      KATANA_CHECKED(katana::PropertyGraph::Make(
+          katana::GraphTopology(std::move(adj_indices), std::move(dests)),
+          std::move(node_types), std::move(edge_types),
+          katana::EntityTypeManager(in->GetNodeTypeManager()),
+          katana::EntityTypeManager(in->GetEdgeTypeManager())));
+
+  for (const auto& field : in->full_node_schema()->fields()) {
+    auto column = KATANA_CHECKED(in->GetNodeProperty(field->name()));
+    auto table = KATANA_CHECKED(TakeRows(column, field, new_to_old_nodes));
+    KATANA_CHECKED(out->AddNodeProperties(table, &txn_ctx));
+    KATANA_CHECKED(in->UnloadNodeProperty(field->name()));
+  }
+  for (const auto& field : in->full_edge_schema()->fields()) {
+    auto column = KATANA_CHECKED(in->GetEdgeProperty(field->name()));
+    auto table = KATANA_CHECKED(TakeRows(column, field, new_to_old_edges));
+    KATANA_CHECKED(out->AddEdgeProperties(table, &txn_ctx));
+    KATANA_CHECKED(in->UnloadEdgeProperty(field->name()));
+  }
+
+  return out->Write(output_uri, "graph-remap", &txn_ctx);
+}
+
+}  // namespace ooc
+
 int
 main(int argc, char** argv) {
   katana::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
 
+  if (outOfCore || rdg) {
+    auto res = rdg ? ooc::RemapRDG() : ooc::RemapFile();
+    if (!res) {
+      KATANA_LOG_FATAL("failed to remap {}: {}", inputFilename, res.error());
+    }
+    return 0;
+  }
+
   std::map<uint32_t, uint32_t> remapper = createNodeMap();
 
   katana::gInfo("Loading graph to remap");
@@ -17,13 +17,24 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <utility>
 #include <vector>
 
+#include "katana/FileGraph.h"
 #include "katana/Galois.h"
-#include "katana/LCGraph.h"
-#include "katana/OfflineGraph.h"
+#include "katana/HyperLogLog.h"
+#include "katana/JSON.h"
+#include "katana/KLLSketch.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/SharedMemSys.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
@@ -36,7 +47,10 @@ enum StatMode {
   indegreehist,
   sortedlogoffsethist,
   sparsityPattern,
-  summary
+  summary,
+  distinctNeighbors,
+  approxDiameter,
+  degreeQuantiles
 };
 
 static cll::opt<std::string> inputfilename(
@@ -56,48 +70,135 @@ static cll::list<StatMode> statModeList(
             sparsityPattern,
             "Pattern of non-zeros when graph is "
             "interpreted as a sparse matrix"),
-        clEnumVal(summary, "Graph summary")));
+        clEnumVal(summary, "Graph summary"),
+        clEnumVal(
+            distinctNeighbors,
+            "Estimated distinct destinations and distinct edges "
+            "(HyperLogLog)"),
+        clEnumVal(
+            approxDiameter,
+            "Lower bound of the diameter by double-sweep BFS"),
+        clEnumVal(degreeQuantiles, "Estimated degree quantiles (KLL)")));
 static cll::opt<int> numBins(
     "numBins", cll::desc("Number of bins"), cll::init(-1));
 static cll::opt<int> columns(
     "columns", cll::desc("Columns for sparsity"), cll::init(80));
+static cll::opt<unsigned> numThreads(
+    "t", cll::desc("Number of threads (default: all)"), cll::init(0));
+static cll::opt<std::string> jsonOutput(
+    "jsonOutput", cll::desc("Also write the stats to this JSON file"),
+    cll::init(""));
+static cll::opt<uint32_t> sketchPrecision(
+    "sketchPrecision",
+    cll::desc("Precision of HyperLogLog sketches (4 to 18)"),
+    cll::init(katana::HyperLogLog::kDefaultPrecision));
+static cll::opt<uint32_t> quantileK(
+    "quantileK", cll::desc("Accuracy parameter k of KLL sketches"),
+    cll::init(katana::KLLSketch<uint64_t>::kDefaultK));
+static cll::opt<unsigned> numSweeps(
+    "numSweeps", cll::desc("Double sweeps of approxDiameter"),
+    cll::init(2));
 
-typedef katana::OfflineGraph Graph;
+typedef katana::FileGraph Graph;
 typedef Graph::GraphNode GNode;
+typedef nlohmann::ordered_json Report;
+typedef std::map<uint64_t, uint64_t> Histogram;
+
+uint64_t
+getDegree(Graph& graph, GNode n) {
+  return std::distance(graph.edge_begin(n), graph.edge_end(n));
+}
+
+auto
+iterateNodes(Graph& graph) {
+  return katana::iterate(uint64_t{0}, uint64_t{graph.size()});
+}
+
+Histogram
+mergeHistograms(katana::PerThreadStorage<Histogram>& hists) {
+  Histogram merged;
+  for (unsigned i = 0; i < hists.size(); ++i) {
+    for (auto p : *hists.getRemote(i)) {
+      merged[p.first] += p.second;
+    }
+  }
+  return merged;
+}
+
+/// \returns the number of in-edges of each node
+katana::NUMAArray<uint64_t>
+getInDegrees(Graph& graph) {
+  katana::NUMAArray<uint64_t> inv;
+  inv.allocateBlocked(graph.size());
+  katana::ParallelSTL::fill(inv.begin(), inv.end(), uint64_t{0});
+  katana::do_all(
+      iterateNodes(graph),
+      [&](GNode src) {
+        for (auto jj : graph.edges(src)) {
+          __atomic_fetch_add(&inv[graph.getEdgeDst(jj)], 1, __ATOMIC_RELAXED);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return inv;
+}
+
+/// \returns the first node of the highest degree, and its degree
+std::pair<GNode, uint64_t>
+getMaxDegreeNode(Graph& graph) {
+  katana::GReduceMax<uint64_t> maxDegree;
+  katana::do_all(
+      iterateNodes(graph),
+      [&](GNode n) { maxDegree.update(getDegree(graph, n)); },
+      katana::no_stats());
+  uint64_t degree = maxDegree.reduce();
+  katana::GReduceMin<uint64_t> firstNode;
+  katana::do_all(
+      iterateNodes(graph),
+      [&](GNode n) {
+        if (getDegree(graph, n) == degree) {
+          firstNode.update(n);
+        }
+      },
+      katana::no_stats());
+  return std::make_pair(graph.size() ? firstNode.reduce() : 0, degree);
+}
 
 void
-doSummary(Graph& graph) {
+doSummary(Graph& graph, Report* report) {
   std::cout << "NumNodes: " << graph.size() << "\n";
   std::cout << "NumEdges: " << graph.sizeEdges() << "\n";
   std::cout << "SizeofEdge: " << graph.edgeSize() << "\n";
+  (*report)["num_nodes"] = graph.size();
+  (*report)["num_edges"] = graph.sizeEdges();
+  (*report)["edge_size"] = graph.edgeSize();
 }
 
 void
-doDegrees(Graph& graph) {
+doDegrees(Graph& graph, Report* report) {
+  *report = Report::array();
   for (auto n : graph) {
-    std::cout << graph.edges(n).size() << "\n";
+    uint64_t degree = getDegree(graph, n);
+    std::cout << degree << "\n";
+    report->push_back(degree);
   }
 }
 
 void
-findMaxDegreeNode(Graph& graph) {
-  uint64_t nodeID = 0;
-  size_t MaxDegree = 0;
-  uint64_t MaxDegreeNode = 0;
-  for (auto n : graph) {
-    size_t degree = graph.edges(n).size();
-    if (MaxDegree < degree) {
-      MaxDegree = degree;
-      MaxDegreeNode = nodeID;
-    }
-    ++nodeID;
-  }
+findMaxDegreeNode(Graph& graph, Report* report) {
+  auto [MaxDegreeNode, MaxDegree] = getMaxDegreeNode(graph);
   std::cout << "MaxDegreeNode : " << MaxDegreeNode
             << " , MaxDegree : " << MaxDegree << "\n";
+  (*report)["node"] = MaxDegreeNode;
+  (*report)["degree"] = MaxDegree;
 }
 
 void
-printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
+printHistogram(const std::string& name, Histogram& hists, Report* report) {
+  *report = Report::array();
+  if (hists.empty()) {
+    std::cout << name << "Bin,Start,End,Count\n";
+    return;
+  }
   auto max = hists.rbegin()->first;
   if (numBins <= 0) {
     std::cout << name << "Bin,Start,End,Count\n";
@@ -109,6 +210,11 @@ printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
         std::cout << "0\n";
       }
     }
+    // empty bins are left out of reports, which may have billions of bins
+    for (auto p : hists) {
+      report->push_back(
+          {{"start", p.first}, {"end", p.first + 1}, {"count", p.second}});
+    }
   } else {
     std::vector<uint64_t> bins(numBins);
     auto bwidth = (max + 1) / numBins;
@@ -123,6 +229,10 @@ printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
     for (unsigned x = 0; x < bins.size(); ++x) {
       std::cout << x << ',' << x * bwidth << ',' << (x * bwidth + bwidth) << ','
                 << bins[x] << '\n';
+      report->push_back(
+          {{"start", x * bwidth},
+           {"end", x * bwidth + bwidth},
+           {"count", bins[x]}});
     }
   }
 }
@@ -132,42 +242,47 @@ doSparsityPattern(
     Graph& graph, std::function<void(unsigned, unsigned, bool)> printFn) {
   unsigned blockSize = (graph.size() + columns - 1) / columns;
 
+  std::vector<std::vector<bool>> rows(columns);
+  katana::do_all(
+      katana::iterate(0, static_cast<int>(columns)),
+      [&](int i) {
+        std::vector<bool>& row = rows[i];
+        row.resize(columns);
+        auto p = katana::block_range(graph.begin(), graph.end(), i, columns);
+        for (auto ii = p.first, ei = p.second; ii != ei; ++ii) {
+          for (auto jj : graph.edges(*ii)) {
+            row[graph.getEdgeDst(jj) / blockSize] = true;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
   for (int i = 0; i < columns; ++i) {
-    std::vector<bool> row(columns);
-    auto p = katana::block_range(graph.begin(), graph.end(), i, columns);
-    for (auto ii = p.first, ei = p.second; ii != ei; ++ii) {
-      for (auto jj : graph.edges(*ii)) {
-        row[graph.getEdgeDst(jj) / blockSize] = true;
-      }
-    }
     for (int x = 0; x < columns; ++x) {
-      printFn(x, i, row[x]);
+      printFn(x, i, rows[i][x]);
     }
   }
 }
 
 void
-doDegreeHistogram(Graph& graph) {
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    ++hist[graph.edges(ii).size()];
-  }
-  printHistogram("Degree", hist);
+doDegreeHistogram(Graph& graph, Report* report) {
+  katana::PerThreadStorage<Histogram> hists;
+  katana::do_all(
+      iterateNodes(graph),
+      [&](GNode ii) { ++(*hists.getLocal())[getDegree(graph, ii)]; },
+      katana::no_stats());
+  Histogram hist = mergeHistograms(hists);
+  printHistogram("Degree", hist, report);
 }
 
 void
-doInDegreeHistogram(Graph& graph) {
-  std::vector<uint64_t> inv(graph.size());
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++inv[graph.getEdgeDst(jj)];
-    }
-  }
-  for (uint64_t n : inv) {
-    ++hist[n];
-  }
-  printHistogram("InDegree", hist);
+doInDegreeHistogram(Graph& graph, Report* report) {
+  katana::NUMAArray<uint64_t> inv = getInDegrees(graph);
+  katana::PerThreadStorage<Histogram> hists;
+  katana::do_all(
+      katana::iterate(inv), [&](uint64_t n) { ++(*hists.getLocal())[n]; },
+      katana::no_stats());
+  Histogram hist = mergeHistograms(hists);
+  printHistogram("InDegree", hist, report);
 }
 
 struct EdgeComp {
@@ -241,37 +356,181 @@ doSortedLogOffsetHistogram([[maybe_unused]] Graph& graph) {
 }
 
 void
-doDestinationHistogram(Graph& graph) {
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++hist[graph.getEdgeDst(jj)];
+doDestinationHistogram(Graph& graph, Report* report) {
+  katana::NUMAArray<uint64_t> inv = getInDegrees(graph);
+  Histogram hist;
+  for (uint64_t n = 0; n < inv.size(); ++n) {
+    if (inv[n]) {
+      hist.emplace_hint(hist.end(), n, inv[n]);
+    }
+  }
+  printHistogram("DestinationBin", hist, report);
+}
+
+void
+doDistinctNeighbors(Graph& graph, Report* report) {
+  katana::PerThreadStorage<katana::HyperLogLog> destinations(sketchPrecision);
+  katana::PerThreadStorage<katana::HyperLogLog> edges(sketchPrecision);
+  katana::do_all(
+      iterateNodes(graph),
+      [&](GNode src) {
+        uint64_t srcHash = katana::HyperLogLog::Hash(src);
+        for (auto jj : graph.edges(src)) {
+          GNode dst = graph.getEdgeDst(jj);
+          destinations.getLocal()->Insert(katana::HyperLogLog::Hash(dst));
+          edges.getLocal()->Insert(katana::HyperLogLog::Hash(srcHash + dst));
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::HyperLogLog distinctDestinations(sketchPrecision);
+  katana::HyperLogLog distinctEdges(sketchPrecision);
+  for (unsigned i = 0; i < destinations.size(); ++i) {
+    distinctDestinations.Merge(*destinations.getRemote(i));
+    distinctEdges.Merge(*edges.getRemote(i));
+  }
+  uint64_t numDestinations = std::llround(distinctDestinations.Estimate());
+  uint64_t numEdges = std::llround(distinctEdges.Estimate());
+  double average = graph.size() ? static_cast<double>(numEdges) / graph.size()
+                                : 0;
+  std::cout << "DistinctDestinations: " << numDestinations << "\n";
+  std::cout << "DistinctEdges: " << numEdges << "\n";
+  std::cout << "AvgDistinctNeighbors: " << average << "\n";
+  (*report)["distinct_destinations"] = numDestinations;
+  (*report)["distinct_edges"] = numEdges;
+  (*report)["avg_distinct_neighbors"] = average;
+  (*report)["precision"] = distinctEdges.precision();
+}
+
+void
+doDegreeQuantiles(Graph& graph, Report* report) {
+  katana::PerThreadStorage<katana::KLLSketch<uint64_t>> sketches(quantileK);
+  katana::do_all(
+      iterateNodes(graph),
+      [&](GNode n) { sketches.getLocal()->Insert(getDegree(graph, n)); },
+      katana::no_stats());
+  katana::KLLSketch<uint64_t> merged(quantileK);
+  for (unsigned i = 0; i < sketches.size(); ++i) {
+    merged.Merge(*sketches.getRemote(i));
+  }
+
+  (*report)["k"] = unsigned{quantileK};
+  (*report)["quantiles"] = Report::array();
+  if (merged.empty()) {
+    return;
+  }
+  std::cout << "Quantile,Degree\n";
+  for (double q : {0.0, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0}) {
+    uint64_t degree = merged.Quantile(q);
+    std::cout << q << ',' << degree << '\n';
+    (*report)["quantiles"].push_back({{"quantile", q}, {"degree", degree}});
+  }
+}
+
+constexpr uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+
+/// Breadth first search along out-edges
+///
+/// \returns the node of the last level with the smallest id, and the
+/// number of levels after the first: the eccentricity of the source
+std::pair<GNode, uint32_t>
+getFarthestNode(Graph& graph, GNode source, katana::NUMAArray<uint32_t>* dist) {
+  katana::ParallelSTL::fill(dist->begin(), dist->end(), kUnvisited);
+  (*dist)[source] = 0;
+  std::vector<GNode> frontier{source};
+  uint32_t level = 0;
+  while (true) {
+    katana::InsertBag<GNode> next;
+    katana::do_all(
+        katana::iterate(frontier),
+        [&](GNode src) {
+          for (auto jj : graph.edges(src)) {
+            GNode dst = graph.getEdgeDst(jj);
+            uint32_t unvisited = kUnvisited;
+            if ((*dist)[dst] == kUnvisited &&
+                __atomic_compare_exchange_n(
+                    &(*dist)[dst], &unvisited, level + 1, false,
+                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+              next.push(dst);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    if (next.empty()) {
+      break;
+    }
+    frontier.assign(next.begin(), next.end());
+    ++level;
+  }
+  return std::make_pair(
+      *std::min_element(frontier.begin(), frontier.end()), level);
+}
+
+/// Each double sweep searches from a node, and again from the farthest node
+/// it found; the eccentricities are lower bounds of the diameter, and the
+/// bound of two sweeps is often the diameter. The first sweep starts from a
+/// node of the highest degree, and each later one from the end of the
+/// previous one.
+void
+doApproxDiameter(Graph& graph, Report* report) {
+  (*report)["sweeps"] = unsigned{numSweeps};
+  if (graph.size() == 0) {
+    (*report)["lower_bound"] = 0;
+    return;
+  }
+  katana::NUMAArray<uint32_t> dist;
+  dist.allocateBlocked(graph.size());
+
+  GNode start = getMaxDegreeNode(graph).first;
+  uint32_t bound = 0;
+  std::pair<GNode, GNode> endpoints{start, start};
+  for (unsigned i = 0; i < numSweeps; ++i) {
+    auto [first, firstEccentricity] = getFarthestNode(graph, start, &dist);
+    auto [second, eccentricity] = getFarthestNode(graph, first, &dist);
+    if (firstEccentricity > bound) {
+      bound = firstEccentricity;
+      endpoints = std::make_pair(start, first);
     }
+    if (eccentricity > bound) {
+      bound = eccentricity;
+      endpoints = std::make_pair(first, second);
+    }
+    start = second;
   }
-  printHistogram("DestinationBin", hist);
+  std::cout << "DiameterLowerBound: " << bound << " , From : "
+            << endpoints.first << " , To : " << endpoints.second << "\n";
+  (*report)["lower_bound"] = bound;
+  (*report)["from"] = endpoints.first;
+  (*report)["to"] = endpoints.second;
 }
 
 int
 main(int argc, char** argv) {
+  katana::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(
+      numThreads ? numThreads : katana::GetThreadPool().getMaxThreads());
   try {
-    Graph graph(inputfilename);
+    Graph graph;
+    graph.fromFile(inputfilename);
+    Report report;
+    report["graph"] = std::string(inputfilename);
     for (unsigned i = 0; i != statModeList.size(); ++i) {
       switch (statModeList[i]) {
       case degreehist:
-        doDegreeHistogram(graph);
+        doDegreeHistogram(graph, &report["degreehist"]);
         break;
       case degrees:
-        doDegrees(graph);
+        doDegrees(graph, &report["degrees"]);
         break;
       case maxDegreeNode:
-        findMaxDegreeNode(graph);
+        findMaxDegreeNode(graph, &report["maxDegreeNode"]);
         break;
       case dsthist:
-        doDestinationHistogram(graph);
+        doDestinationHistogram(graph, &report["dsthist"]);
         break;
       case indegreehist:
-        doInDegreeHistogram(graph);
+        doInDegreeHistogram(graph, &report["indegreehist"]);
         break;
       case sortedlogoffsethist:
         doSortedLogOffsetHistogram(graph);
@@ -289,13 +548,35 @@ main(int argc, char** argv) {
         break;
       }
       case summary:
-        doSummary(graph);
+        doSummary(graph, &report["summary"]);
+        break;
+      case distinctNeighbors:
+        doDistinctNeighbors(graph, &report["distinctNeighbors"]);
+        break;
+      case approxDiameter:
+        doApproxDiameter(graph, &report["approxDiameter"]);
+        break;
+      case degreeQuantiles:
+        doDegreeQuantiles(graph, &report["degreeQuantiles"]);
         break;
       default:
         std::cerr << "Unknown stat requested\n";
         break;
       }
     }
+    if (!jsonOutput.empty()) {
+      auto json = katana::JsonDump(report);
+      if (!json) {
+        std::cerr << "failed to write stats: " << json.error() << "\n";
+        return 1;
+      }
+      std::ofstream out(jsonOutput);
+      out << json.value() << "\n";
+      if (!out) {
+        std::cerr << "failed to write " << jsonOutput << "\n";
+        return 1;
+      }
+    }
     return 0;
   } catch (...) {
     std::cerr << "failed\n";
@@ -0,0 +1,54 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "katana/BinaryTracer.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> inputFilename(
+    cll::Positional, cll::desc("<binary trace>"), cll::Required);
+static cll::opt<std::string> outputFilename(
+    cll::Positional,
+    cll::desc("<chrome trace, loadable by Perfetto and chrome://tracing>"),
+    cll::Required);
+
+katana::Result<void>
+Convert() {
+  std::ifstream input(inputFilename, std::ios_base::binary);
+  if (!input) {
+    return KATANA_ERROR(
+        katana::ErrorCode::LocalStorageError, "opening {}", inputFilename);
+  }
+  std::stringstream trace;
+  trace << input.rdbuf();
+
+  auto chrome_trace = KATANA_CHECKED_CONTEXT(
+      katana::BinaryTracer::ToChromeTrace(trace.str()), "converting {}",
+      inputFilename);
+
+  std::ofstream output(
+      outputFilename, std::ios_base::binary | std::ios_base::trunc);
+  output << chrome_trace;
+  if (!output) {
+    return KATANA_ERROR(
+        katana::ErrorCode::LocalStorageError, "writing {}", outputFilename);
+  }
+  return katana::ResultSuccess();
+}
+
+int
+main(int argc, char** argv) {
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv, "Convert a BinaryTracer trace to a Chrome trace\n");
+
+  if (auto res = Convert(); !res) {
+    KATANA_LOG_FATAL("{}", res.error());
+  }
+  return 0;
+}